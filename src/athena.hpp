@@ -14,6 +14,9 @@
 #include <Kokkos_DualView.hpp>
 #include <Kokkos_Macros.hpp>
 #include "config.hpp"
+#include "globals.hpp"
+#include "utils/kernel_profiler.hpp"
+#include "utils/kernel_tuning.hpp"
 
 //----------------------------------------------------------------------------------------
 // type alias that allows code to run with either floats or doubles
@@ -34,12 +37,23 @@ using Real = double;
 
 #endif // SINGLE_PRECISION_ENABLED
 
+// precision of arithmetic in (nonrelativistic hydro HLLE/HLLC) Riemann solvers.  With
+// mixed precision, reconstructed states are converted to float on load, and fluxes are
+// converted back to Real when stored, so conserved variables are always updated in Real.
+#if MIXED_PRECISION_ENABLED
+using FluxReal = float;
+#else
+using FluxReal = Real;
+#endif // MIXED_PRECISION_ENABLED
+
 //----------------------------------------------------------------------------------------
 // general purpose macros (never modified)
 
-// number of bits needed to store MeshBlock local ID in each rank in an integer.  Thus
-// maximum number of MBs per rank is 2^(NUM_BITS_LID).  Limit is set by MPI tag limit
+// minimum number of bits used to store MeshBlock local ID in MPI tags.  The number
+// actually used (global_variable::nbits_lid) is set from MPI_TAG_UB of the MPI library,
+// leaving NUM_BITS_BUFID bits for the buffer ID, and sets maximum number of MBs per rank
 #define NUM_BITS_LID 14
+#define NUM_BITS_BUFID 6
 
 #define SQR(x) ( (x)*(x) )
 #define SIGN(x) ( ((x) < 0.0) ? -1.0 : 1.0 )
@@ -55,11 +69,27 @@ enum BFieldIndex {IBX=0, IBY=1, IBZ=2, NMAG=3};
 // array indices for metric matrices in GR
 enum MetricIndex {I00=0, I01=1, I02=2, I03=3, I11=4, I12=5, I13=6, I22=7, I23=8, I33=9,
                   NMETRIC=10};
+// array indices for M1 radiation variables: energy density, flux
+enum M1Index {IRE=0, IRF1=1, IRF2=2, IRF3=3};
 // array indices for particle arrays
 enum ParticlesIndex {PGID=0, PTAG=1, IPX=0, IPVX=1, IPY=2, IPVY=3, IPZ=4, IPVZ=5};
 
 // integer constants to specify spatial reconstruction methods
-enum ReconstructionMethod {dc, plm, ppm4, ppmx, wenoz};
+enum ReconstructionMethod {dc, plm, ppm4, ppmx, wenoz, mp5};
+
+// returns true if Hydro/MHD flux kernels are compiled for a reconstruction method, as set
+// by Athena_RECONSTRUCTION in CMakeLists.txt
+inline bool ReconstructionEnabled(const ReconstructionMethod method) {
+  switch (method) {
+    case ReconstructionMethod::dc:    return RECON_DC_ENABLED;
+    case ReconstructionMethod::plm:   return RECON_PLM_ENABLED;
+    case ReconstructionMethod::ppm4:  return RECON_PPM4_ENABLED;
+    case ReconstructionMethod::ppmx:  return RECON_PPMX_ENABLED;
+    case ReconstructionMethod::wenoz: return RECON_WENOZ_ENABLED;
+    case ReconstructionMethod::mp5:   return RECON_MP5_ENABLED;
+    default: return false;
+  }
+}
 
 // constants that enumerate time evolution options
 enum TimeEvolution {tstatic, kinematic, dynamic};
@@ -86,9 +116,12 @@ struct MHDCons1D {
 //----------------------------------------------------------------------------------------
 // define default Kokkos execution and memory spaces
 
+// All buffer packing kernels run on DevExeSpace(), so DevExeSpace().fence() (rather than
+// a global Kokkos::fence()) is sufficient before posting MPI sends of packed buffers.
 using DevExeSpace = Kokkos::DefaultExecutionSpace;
 using DevMemSpace = Kokkos::DefaultExecutionSpace::memory_space;
 using HostMemSpace = Kokkos::HostSpace;
+using PinnedMemSpace = Kokkos::SharedHostPinnedSpace;   // page-locked host memory
 using ScratchMemSpace = DevExeSpace::scratch_memory_space;
 using LayoutWrapper = Kokkos::LayoutRight;                // increments last index fastest
 using TeamMember_t = Kokkos::TeamPolicy<>::member_type;   // for Kokkos thread teams
@@ -138,6 +171,16 @@ using ScrArray1D = Kokkos::View<T *, LayoutWrapper, ScratchMemSpace,
 template <typename T>
 using ScrArray2D = Kokkos::View<T **, LayoutWrapper, ScratchMemSpace,
                                      Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+template <typename T>
+using ScrArray4D = Kokkos::View<T ****, LayoutWrapper, ScratchMemSpace,
+                                     Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+
+// rounds length of the innermost (i) dimension of scratch arrays up to a multiple of the
+// SIMD width (set by Athena_SIMD_WIDTH in CMakeLists.txt), so that every variable in a
+// ScrArray2D(n,i) starts at the same offset within a SIMD vector
+inline int SimdPadded(const int n) {
+  return ((n + SIMD_WIDTH - 1)/SIMD_WIDTH)*SIMD_WIDTH;
+}
 
 //----------------------------------------------------------------------------------------
 // struct for storing face-centered (area-averaged) variables, e.g. magnetic field
@@ -209,7 +252,8 @@ struct DvceEdgeFld4D {
 // These wrappers implement a variety of parallel execution strategies, including
 // 1D-range, and thread teams for use with inner vector threads. Experiments in K-Athena
 // and Parthenon indicate that 1D-range policy is generally faster than multidimensional
-// MD-range policy, so the latter is not used.
+// MD-range policy, so the latter is only used for kernels given a tile size in the
+// <kernel_tuning> block of the input file (see utils/kernel_tuning.hpp).
 //------------------------------
 // 1D loop using Kokkos 1D Range
 template <typename Function>
@@ -217,6 +261,7 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
                     const int &il, const int &iu, const Function &function) {
   // compute total number of elements and call Kokkos::parallel_for()
   const int ni = iu - il + 1;
+  kernel_profiler::SetIterations(ni);
   Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, ni),
   KOKKOS_LAMBDA(const int &idx) {
     // compute i indices of thread and call function
@@ -235,6 +280,7 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
   const int nj = ju - jl + 1;
   const int ni = iu - il + 1;
   const int nji  = nj * ni;
+  kernel_profiler::SetIterations(nji);
   Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, nji),
   KOKKOS_LAMBDA(const int &idx) {
     // compute j,i indices of thread and call function
@@ -257,6 +303,15 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
   const int ni = iu - il + 1;
   const int nkji = nk * nj * ni;
   const int nji  = nj * ni;
+  kernel_profiler::SetIterations(nkji);
+  const kernel_tuning::KernelConfig *kc = kernel_tuning::Find(name);
+  if (kc != nullptr && kc->Tiled()) {
+    Kokkos::MDRangePolicy<DevExeSpace, Kokkos::Rank<3>> policy(exec_space,
+        {kl, jl, il}, {ku+1, ju+1, iu+1}, {kc->tile[0], kc->tile[1], kc->tile[2]});
+    Kokkos::parallel_for(name, policy,
+    KOKKOS_LAMBDA(const int k, const int j, const int i) {function(k, j, i);});
+    return;
+  }
   Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, nkji),
   KOKKOS_LAMBDA(const int &idx) {
     // compute k,j,i indices of thread and call function
@@ -284,6 +339,18 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
   const int nnkji = nn * nk * nj * ni;
   const int nkji  = nk * nj * ni;
   const int nji   = nj * ni;
+  kernel_profiler::SetIterations(nnkji);
+  const kernel_tuning::KernelConfig *kc = kernel_tuning::Find(name);
+  if (kc != nullptr && kc->Tiled()) {
+    Kokkos::MDRangePolicy<DevExeSpace, Kokkos::Rank<4>> policy(exec_space,
+        {nl, kl, jl, il}, {nu+1, ku+1, ju+1, iu+1},
+        {1, kc->tile[0], kc->tile[1], kc->tile[2]});
+    Kokkos::parallel_for(name, policy,
+    KOKKOS_LAMBDA(const int n, const int k, const int j, const int i) {
+      function(n, k, j, i);
+    });
+    return;
+  }
   Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, nnkji),
   KOKKOS_LAMBDA(const int &idx) {
     // compute n,k,j,i indices of thread and call function
@@ -316,6 +383,18 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
   const int nnkji  = nn * nk * nj * ni;
   const int nkji   = nk * nj * ni;
   const int nji    = nj * ni;
+  kernel_profiler::SetIterations(nmnkji);
+  const kernel_tuning::KernelConfig *kc = kernel_tuning::Find(name);
+  if (kc != nullptr && kc->Tiled()) {
+    Kokkos::MDRangePolicy<DevExeSpace, Kokkos::Rank<5>> policy(exec_space,
+        {ml, nl, kl, jl, il}, {mu+1, nu+1, ku+1, ju+1, iu+1},
+        {1, 1, kc->tile[0], kc->tile[1], kc->tile[2]});
+    Kokkos::parallel_for(name, policy,
+    KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
+      function(m, n, k, j, i);
+    });
+    return;
+  }
   Kokkos::parallel_for(name, Kokkos::RangePolicy<>(exec_space, 0, nmnkji),
   KOKKOS_LAMBDA(const int &idx) {
     // compute m,n,k,j,i indices of thread and call function
@@ -332,6 +411,34 @@ inline void par_for(const std::string &name, DevExeSpace exec_space,
   });
 }
 
+//------------------------------------------
+// team policy of outer parallel loops, with league size n and team size set for this
+// kernel in <kernel_tuning>, else by <job>/team_size (or Kokkos::AUTO if 0)
+inline Kokkos::TeamPolicy<> OuterTeamPolicy(const std::string &name,
+                                            DevExeSpace exec_space, const int n) {
+  const kernel_tuning::KernelConfig *kc = kernel_tuning::Find(name);
+  if (kc != nullptr && kc->team_size > 0) {
+    return Kokkos::TeamPolicy<>(exec_space, n, kc->team_size);
+  }
+  if (global_variable::team_size > 0) {
+    return Kokkos::TeamPolicy<>(exec_space, n, global_variable::team_size);
+  }
+  return Kokkos::TeamPolicy<>(exec_space, n, Kokkos::AUTO);
+}
+
+//------------------------------------------
+// scratch level in which scr_size bytes of team scratch fit, starting from
+// <job>/scratch_level and falling back to level 1 (global memory on GPUs), or -1 if the
+// size exceeds the maximum of both levels
+inline int FittingScratchLevel(const size_t scr_size) {
+  for (int lev=global_variable::scratch_level; lev<=1; ++lev) {
+    if (scr_size <= static_cast<size_t>(Kokkos::TeamPolicy<>::scratch_size_max(lev))) {
+      return lev;
+    }
+  }
+  return -1;
+}
+
 //------------------------------------------
 // 1D outer parallel loop using Kokkos Teams
 template <typename Function>
@@ -339,7 +446,8 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
                           size_t scr_size, const int scr_level,
                           const int kl, const int ku, const Function &function) {
   const int nk = ku - kl + 1;
-  Kokkos::TeamPolicy<> policy(exec_space, nk, Kokkos::AUTO);
+  Kokkos::TeamPolicy<> policy = OuterTeamPolicy(name, exec_space, nk);
+  kernel_profiler::SetIterations(nk);
   Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
   KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int k = tmember.league_rank() + kl;
@@ -357,7 +465,8 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
   const int nk = ku - kl + 1;
   const int nj = ju - jl + 1;
   const int nkj = nk*nj;
-  Kokkos::TeamPolicy<> policy(exec_space, nkj, Kokkos::AUTO);
+  Kokkos::TeamPolicy<> policy = OuterTeamPolicy(name, exec_space, nkj);
+  kernel_profiler::SetIterations(nkj);
   Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
   KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int k = tmember.league_rank()/nj + kl;
@@ -378,7 +487,8 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
   const int nj = ju - jl + 1;
   const int nkj  = nk*nj;
   const int nnkj = nn*nk*nj;
-  Kokkos::TeamPolicy<> policy(exec_space, nnkj, Kokkos::AUTO);
+  Kokkos::TeamPolicy<> policy = OuterTeamPolicy(name, exec_space, nnkj);
+  kernel_profiler::SetIterations(nnkj);
   Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
   KOKKOS_LAMBDA(TeamMember_t tmember) {
     int n = (tmember.league_rank())/nkj;
@@ -405,7 +515,8 @@ inline void par_for_outer(const std::string &name, DevExeSpace exec_space,
   const int nkj   = nk*nj;
   const int nnkj  = nn*nk*nj;
   const int nmnkj = nm*nn*nk*nj;
-  Kokkos::TeamPolicy<> policy(exec_space, nmnkj, Kokkos::AUTO);
+  Kokkos::TeamPolicy<> policy = OuterTeamPolicy(name, exec_space, nmnkj);
+  kernel_profiler::SetIterations(nmnkj);
   Kokkos::parallel_for(name, policy.set_scratch_size(scr_level,Kokkos::PerTeam(scr_size)),
   KOKKOS_LAMBDA(TeamMember_t tmember) {
     int m = (tmember.league_rank())/nnkj;
@@ -429,6 +540,8 @@ KOKKOS_INLINE_FUNCTION void par_for_inner(TeamMember_t tmember, const int il,con
 }
 
 #define NREDUCTION_VARIABLES 20
+// Number of bins in histograms of C2P iteration counts
+#define NC2PHIST 6
 //----------------------------------------------------------------------------------------
 //! \struct summed_array_type
 // Following code is copied from Kokkos wiki pages on building custom reducers.  It allows
@@ -465,8 +578,25 @@ struct array_type {
 };
 // Number of reductions templated by (NHISTORY_VARIABLES)
 typedef array_type<Real,(NREDUCTION_VARIABLES)> GlobalSum;  // simplifies code below
+// Histogram of C2P iteration counts, summed over cells
+typedef array_type<int,(NC2PHIST)> C2PHist;
 } // namespace array_sum
 
+//----------------------------------------------------------------------------------------
+//! \fn int C2PHistBin()
+//! \brief bin of the histogram of C2P iteration counts.  Bin 0 holds [0,2) iterations,
+//! bin n holds [2^n, 2^(n+1)), and the last bin holds everything above.
+
+KOKKOS_INLINE_FUNCTION
+int C2PHistBin(int iter) {
+  int bin = 0;
+  while (iter >= 2 && bin < NC2PHIST-1) {
+    iter >>= 1;
+    bin++;
+  }
+  return bin;
+}
+
 namespace Kokkos { //reduction identity must be defined in Kokkos namespace
 template<>
 struct reduction_identity< array_sum::GlobalSum > {
@@ -474,6 +604,12 @@ struct reduction_identity< array_sum::GlobalSum > {
     return array_sum::GlobalSum();
   }
 };
+template<>
+struct reduction_identity< array_sum::C2PHist > {
+  KOKKOS_FORCEINLINE_FUNCTION static array_sum::C2PHist sum() {
+    return array_sum::C2PHist();
+  }
+};
 }
 
 #endif // ATHENA_HPP_
@@ -299,11 +299,11 @@ class AthenaScratchTensor<T, sym, ndim, 1> {
   (AthenaScratchTensor<T, sym, ndim, 1> const &) = default;
 
   KOKKOS_INLINE_FUNCTION
-  Real operator()(int const a) const {
+  T operator()(int const a) const {
     return data_[a];
   }
   KOKKOS_INLINE_FUNCTION
-  Real & operator()(int const a) {
+  T & operator()(int const a) {
     return data_[a];
   }
   KOKKOS_INLINE_FUNCTION
@@ -314,7 +314,7 @@ class AthenaScratchTensor<T, sym, ndim, 1> {
   }
 
  private:
-  Real data_[3];
+  T data_[3];
 };
 
 //----------------------------------------------------------------------------------------
@@ -335,11 +335,11 @@ class AthenaScratchTensor<T, sym, ndim, 2> {
     return idxmap_[a][b];
   }
   KOKKOS_INLINE_FUNCTION
-  Real operator()(int const a, int const b) const {
+  T operator()(int const a, int const b) const {
     return data_[idxmap_[a][b]];
   }
   KOKKOS_INLINE_FUNCTION
-  Real & operator()(int const a, int const b) {
+  T & operator()(int const a, int const b) {
     return data_[idxmap_[a][b]];
   }
   KOKKOS_INLINE_FUNCTION
@@ -350,7 +350,7 @@ class AthenaScratchTensor<T, sym, ndim, 2> {
   }
 
  private:
-  Real data_[9];
+  T data_[9];
   int idxmap_[3][3];
   int ndof_;
 };
@@ -398,11 +398,11 @@ class AthenaScratchTensor<T, sym, ndim, 3> {
     return idxmap_[a][b][c];
   }
   KOKKOS_INLINE_FUNCTION
-  Real operator()(int const a, int const b, int const c) const {
+  T operator()(int const a, int const b, int const c) const {
     return data_[idxmap_[a][b][c]];
   }
   KOKKOS_INLINE_FUNCTION
-  Real & operator()(int const a, int const b, int const c) {
+  T & operator()(int const a, int const b, int const c) {
     return data_[idxmap_[a][b][c]];
   }
   KOKKOS_INLINE_FUNCTION
@@ -413,7 +413,7 @@ class AthenaScratchTensor<T, sym, ndim, 3> {
   }
 
  private:
-  Real data_[27];
+  T data_[27];
   int idxmap_[3][3][3];
   int ndof_;
 };
@@ -471,12 +471,12 @@ class AthenaScratchTensor<T, sym, ndim, 4> {
     return idxmap_[a][b][c][d];
   }
   KOKKOS_INLINE_FUNCTION
-  Real operator()(int const a, int const b,
+  T operator()(int const a, int const b,
                   int const c, int const d) const {
     return data_[idxmap_[a][b][c][d]];
   }
   KOKKOS_INLINE_FUNCTION
-  Real & operator()(int const a, int const b,
+  T & operator()(int const a, int const b,
                     int const c, int const d) {
     return data_[idxmap_[a][b][c][d]];
   }
@@ -488,7 +488,7 @@ class AthenaScratchTensor<T, sym, ndim, 4> {
   }
 
  private:
-  Real data_[81];
+  T data_[81];
   int idxmap_[3][3][3][3];
   int ndof_;
 };
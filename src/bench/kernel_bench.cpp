@@ -0,0 +1,631 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file kernel_bench.cpp
+//! \brief Standalone micro-benchmarks (target athena_kernel_bench, built with
+//! -D Athena_KERNEL_BENCH=ON) of the inline reconstruction, Riemann solver and C2P
+//! functions in reconstruct/, hydro/rsolvers/, mhd/rsolvers/ and eos/, so that changes to
+//! a single kernel can be measured without running a full problem.
+//!
+//! Each function is called over rows ("pencils") of nx cells of smooth synthetic data in
+//! team kernels laid out as in the flux calculations, and results are written to device
+//! arrays so that they cannot be optimized away.  For every kernel the throughput (cells
+//! per second) and the compulsory memory traffic (bytes read and written per cell) are
+//! reported, from which the achieved bandwidth follows.  Usage:
+//!   athena_kernel_bench [-n nx] [-p npencil] [-r nrepeat]
+//! runs each kernel nrepeat times (after one warm-up) over npencil x npencil rows.
+//!
+//! The SR C2P kernels invert a jet-like state instead (a beam with Lorentz factor 7
+//! along x1 in a static ambient medium, with shear layer and waves), with each of the
+//! c2p_strategy options, starting the warm and Newton solves from slightly perturbed
+//! primitives as from the previous stage.  For these the mean number of iterations and
+//! the fraction of cells that need the bracketed fallback are also reported.
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/coordinates.hpp"
+#include "eos/eos.hpp"
+#include "eos/ideal_c2p_hyd.hpp"
+#include "eos/ideal_c2p_mhd.hpp"
+#include "reconstruct/plm.hpp"
+#include "reconstruct/ppm.hpp"
+#include "reconstruct/wenoz.hpp"
+#include "reconstruct/mp5.hpp"
+#include "hydro/rsolvers/llf_hyd.hpp"
+#include "hydro/rsolvers/hlle_hyd.hpp"
+#include "hydro/rsolvers/hllc_hyd.hpp"
+#include "hydro/rsolvers/roe_hyd.hpp"
+#include "mhd/rsolvers/llf_mhd.hpp"
+#include "mhd/rsolvers/hlle_mhd.hpp"
+#include "mhd/rsolvers/hlld_mhd.hpp"
+
+namespace {
+enum class BenchRecon {plm, ppm4, ppmx, wenoz, mp5};
+enum class BenchRSolver {llf, hlle, hllc, roe};
+enum class BenchMHDRSolver {llf, hlle, hlld};
+enum class BenchC2PStrategy {bracket, warm, newton};
+
+// synthetic data and work arrays shared by all benchmarks
+struct BenchData {
+  int nx, npen, nrep;
+  int ng = 3;                        // enough ghost cells for MP5
+  int ncells1, is, ie;
+  EOS_Data eos;
+  RegionIndcs indcs;
+  DualArray1D<RegionSize> size;
+  CoordData coord;
+  DvceArray5D<Real> w, bcc;          // cell-centered primitives and magnetic field
+  DvceArray5D<Real> wl, wr, bl, br;  // reconstructed L/R states on x1-faces
+  DvceArray4D<Real> bx, ey, ez;      // face-centered field and electric fields
+  DvceArray5D<Real> flx, u, wout;
+  DvceArray5D<Real> wsr_old, usr, usr_mhd;  // SR jet: old primitives, conserved
+  DvceArray4D<int> niter;            // iterations used in SR C2P
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void TimeKernel()
+//! \brief Runs launch() nrep times after one warm-up and prints cells/s, bytes/cell and
+//! achieved bandwidth.
+
+template <typename Launch>
+void TimeKernel(const std::string &name, const BenchData &bd, const double nbytes,
+                Launch launch) {
+  launch();
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  for (int r=0; r<bd.nrep; ++r) {launch();}
+  Kokkos::fence();
+  double t = timer.seconds()/static_cast<double>(bd.nrep);
+  double ncells = static_cast<double>(bd.nx)*bd.npen*bd.npen;
+  std::cout << std::left << std::setw(16) << name << std::right << std::scientific
+            << std::setprecision(3) << std::setw(14) << ncells/t << std::fixed
+            << std::setprecision(1) << std::setw(12) << nbytes << std::setw(12)
+            << 1.0e-9*nbytes*ncells/t << std::endl;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BenchReconstruct()
+//! \brief Reconstructs L/R states of all primitives in x1 with the method selected by the
+//! template parameter, and stores them in wl/wr (later used by the Riemann solvers).
+
+template <BenchRecon method_>
+void BenchReconstruct(const std::string &name, BenchData &bd) {
+  const int nvar = bd.w.extent_int(1);
+  const int ncells1 = bd.ncells1;
+  const int il = bd.is, iu = bd.ie+1;
+  const int npen = bd.npen;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, ncells1) * 2;
+  int scr_level = global_variable::scratch_level;
+  auto eos = bd.eos;
+  auto w_ = bd.w;
+  auto wl_ = bd.wl, wr_ = bd.wr;
+  TimeKernel(name, bd, 3.0*nvar*sizeof(Real), [&]() {
+    par_for_outer("kb_recon",DevExeSpace(), scr_size, scr_level, 0, 0, 0, npen-1,
+                  0, npen-1,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray2D<Real> ql(member.team_scratch(scr_level), nvar, ncells1);
+      ScrArray2D<Real> qr(member.team_scratch(scr_level), nvar, ncells1);
+      if constexpr (method_ == BenchRecon::plm) {
+        PiecewiseLinearX1(member, m, k, j, il-1, iu, w_, ql, qr);
+      } else if constexpr (method_ == BenchRecon::ppm4) {
+        PiecewiseParabolicX1(member, eos, false, true, m, k, j, il-1, iu, w_, ql, qr);
+      } else if constexpr (method_ == BenchRecon::ppmx) {
+        PiecewiseParabolicX1(member, eos, true, true, m, k, j, il-1, iu, w_, ql, qr);
+      } else if constexpr (method_ == BenchRecon::wenoz) {
+        WENOZX1(member, eos, true, m, k, j, il-1, iu, w_, ql, qr);
+      } else if constexpr (method_ == BenchRecon::mp5) {
+        MP5X1(member, eos, true, m, k, j, il-1, iu, w_, ql, qr);
+      }
+      member.team_barrier();
+      for (int n=0; n<nvar; ++n) {
+        par_for_inner(member, il, iu, [&](const int i) {
+          wl_(m,n,k,j,i) = ql(n,i);
+          wr_(m,n,k,j,i) = qr(n,i);
+        });
+      }
+    });
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BenchRiemann()
+//! \brief Computes hydro fluxes on x1-faces from the L/R states in wl/wr with the solver
+//! selected by the template parameter.
+
+template <BenchRSolver rsolver_>
+void BenchRiemann(const std::string &name, BenchData &bd) {
+  const int nvar = bd.wl.extent_int(1);
+  const int ncells1 = bd.ncells1;
+  const int il = bd.is, iu = bd.ie+1;
+  const int npen = bd.npen;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, ncells1) * 2;
+  int scr_level = global_variable::scratch_level;
+  auto eos_ = bd.eos;
+  auto indcs_ = bd.indcs;
+  auto size_ = bd.size;
+  auto coord_ = bd.coord;
+  auto wl_ = bd.wl, wr_ = bd.wr;
+  auto flx_ = bd.flx;
+  TimeKernel(name, bd, 3.0*nvar*sizeof(Real), [&]() {
+    par_for_outer("kb_rsolver",DevExeSpace(), scr_size, scr_level, 0, 0, 0, npen-1,
+                  0, npen-1,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray2D<Real> wl(member.team_scratch(scr_level), nvar, ncells1);
+      ScrArray2D<Real> wr(member.team_scratch(scr_level), nvar, ncells1);
+      for (int n=0; n<nvar; ++n) {
+        par_for_inner(member, il, iu, [&](const int i) {
+          wl(n,i) = wl_(m,n,k,j,i);
+          wr(n,i) = wr_(m,n,k,j,i);
+        });
+      }
+      member.team_barrier();
+      // NOTE(@pdmullen): Capture variables prior to if constexpr. Required for cuda 11.6+
+      auto eos = eos_;
+      auto indcs = indcs_;
+      auto size = size_;
+      auto coord = coord_;
+      auto flx = flx_;
+      if constexpr (rsolver_ == BenchRSolver::llf) {
+        hydro::LLF(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx);
+      } else if constexpr (rsolver_ == BenchRSolver::hlle) {
+        hydro::HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx);
+      } else if constexpr (rsolver_ == BenchRSolver::hllc) {
+        hydro::HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx);
+      } else if constexpr (rsolver_ == BenchRSolver::roe) {
+        hydro::Roe(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx);
+      }
+    });
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BenchMHDRiemann()
+//! \brief Computes MHD fluxes and electric fields on x1-faces from the L/R states in
+//! wl/wr and bl/br with the solver selected by the template parameter.
+
+template <BenchMHDRSolver rsolver_>
+void BenchMHDRiemann(const std::string &name, BenchData &bd) {
+  const int nvar = bd.wl.extent_int(1);
+  const int ncells1 = bd.ncells1;
+  const int il = bd.is, iu = bd.ie+1;
+  const int npen = bd.npen;
+  size_t scr_size = (ScrArray2D<Real>::shmem_size(nvar, ncells1) +
+                     ScrArray2D<Real>::shmem_size(3, ncells1)) * 2;
+  int scr_level = global_variable::scratch_level;
+  auto eos_ = bd.eos;
+  auto indcs_ = bd.indcs;
+  auto size_ = bd.size;
+  auto coord_ = bd.coord;
+  auto wl_ = bd.wl, wr_ = bd.wr, bl_ = bd.bl, br_ = bd.br;
+  auto bx_ = bd.bx, ey_ = bd.ey, ez_ = bd.ez;
+  auto flx_ = bd.flx;
+  // reads: L/R states (nvar + 2 transverse fields) and normal field; writes: flux, E
+  double nbytes = (2.0*(nvar + 2) + 1.0 + nvar + 2.0)*sizeof(Real);
+  TimeKernel(name, bd, nbytes, [&]() {
+    par_for_outer("kb_mhd_rsolver",DevExeSpace(), scr_size, scr_level, 0, 0, 0, npen-1,
+                  0, npen-1,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray2D<Real> wl(member.team_scratch(scr_level), nvar, ncells1);
+      ScrArray2D<Real> wr(member.team_scratch(scr_level), nvar, ncells1);
+      ScrArray2D<Real> bl(member.team_scratch(scr_level), 3, ncells1);
+      ScrArray2D<Real> br(member.team_scratch(scr_level), 3, ncells1);
+      for (int n=0; n<nvar; ++n) {
+        par_for_inner(member, il, iu, [&](const int i) {
+          wl(n,i) = wl_(m,n,k,j,i);
+          wr(n,i) = wr_(m,n,k,j,i);
+        });
+      }
+      for (int n=IBY; n<=IBZ; ++n) {
+        par_for_inner(member, il, iu, [&](const int i) {
+          bl(n,i) = bl_(m,n,k,j,i);
+          br(n,i) = br_(m,n,k,j,i);
+        });
+      }
+      member.team_barrier();
+      auto eos = eos_;
+      auto indcs = indcs_;
+      auto size = size_;
+      auto coord = coord_;
+      auto bx = bx_;
+      auto flx = flx_;
+      auto ey = ey_;
+      auto ez = ez_;
+      if constexpr (rsolver_ == BenchMHDRSolver::llf) {
+        mhd::LLF(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+      } else if constexpr (rsolver_ == BenchMHDRSolver::hlle) {
+        mhd::HLLE(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+      } else if constexpr (rsolver_ == BenchMHDRSolver::hlld) {
+        mhd::HLLD(member,eos,indcs,size,coord,m,k,j,il,iu,IVX,wl,wr,bl,br,bx,flx,ey,ez);
+      }
+    });
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BenchC2P()
+//! \brief Inverts conserved variables in u (computed from w) to primitives in wout with
+//! the non-relativistic ideal gas hydro (mhd=false) or MHD (mhd=true) C2P.
+
+void BenchC2P(const std::string &name, BenchData &bd, const bool mhd) {
+  const int is = bd.is, ie = bd.ie;
+  const int npen = bd.npen;
+  auto eos = bd.eos;
+  auto u_ = bd.u, w_ = bd.wout, bcc_ = bd.bcc;
+  double nbytes = ((mhd)? 13.0 : 10.0)*sizeof(Real);
+  TimeKernel(name, bd, nbytes, [&]() {
+    par_for("kb_c2p", DevExeSpace(), 0, 0, 0, npen-1, 0, npen-1, is, ie,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      HydPrim1D w;
+      bool dfloor_used=false, efloor_used=false, tfloor_used=false;
+      if (mhd) {
+        MHDCons1D u;
+        u.d  = u_(m,IDN,k,j,i);
+        u.mx = u_(m,IM1,k,j,i);
+        u.my = u_(m,IM2,k,j,i);
+        u.mz = u_(m,IM3,k,j,i);
+        u.bx = bcc_(m,IBX,k,j,i);
+        u.by = bcc_(m,IBY,k,j,i);
+        u.bz = bcc_(m,IBZ,k,j,i);
+        u.e  = u_(m,IEN,k,j,i) + 0.5*(SQR(u.bx) + SQR(u.by) + SQR(u.bz));
+        SingleC2P_IdealMHD(u, eos, w, dfloor_used, efloor_used, tfloor_used);
+      } else {
+        HydCons1D u;
+        u.d  = u_(m,IDN,k,j,i);
+        u.mx = u_(m,IM1,k,j,i);
+        u.my = u_(m,IM2,k,j,i);
+        u.mz = u_(m,IM3,k,j,i);
+        u.e  = u_(m,IEN,k,j,i);
+        SingleC2P_IdealHyd(u, eos, w, dfloor_used, efloor_used, tfloor_used);
+      }
+      w_(m,IDN,k,j,i) = w.d;
+      w_(m,IVX,k,j,i) = w.vx;
+      w_(m,IVY,k,j,i) = w.vy;
+      w_(m,IVZ,k,j,i) = w.vz;
+      w_(m,IEN,k,j,i) = w.e;
+    });
+  });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BenchSRC2P()
+//! \brief Inverts SR conserved variables in usr (mhd=false) or usr_mhd (mhd=true) to
+//! primitives in wout with the given strategy, then prints the mean number of iterations
+//! and the fraction of cells not converged by the Newton iterations alone.
+
+void BenchSRC2P(const std::string &name, BenchData &bd, const bool mhd,
+                const BenchC2PStrategy strategy) {
+  const int is = bd.is, ie = bd.ie;
+  const int npen = bd.npen;
+  auto eos = bd.eos;
+  const int newton_iter = (strategy == BenchC2PStrategy::newton)? eos.c2p_newton_iter : 0;
+  const bool guess = (strategy != BenchC2PStrategy::bracket);
+  auto u_ = (mhd)? bd.usr_mhd : bd.usr;
+  auto w_ = bd.wout, bcc_ = bd.bcc, wold_ = bd.wsr_old;
+  auto niter_ = bd.niter;
+  double nbytes = ((mhd)? 13.0 : 10.0)*sizeof(Real) + sizeof(int);
+  if (guess) {nbytes += 5.0*sizeof(Real);}
+  TimeKernel(name, bd, nbytes, [&]() {
+    par_for("kb_src2p", DevExeSpace(), 0, 0, 0, npen-1, 0, npen-1, is, ie,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      HydPrim1D w_old;
+      Real lor_old = 1.0;
+      if (guess) {
+        w_old.d  = wold_(m,IDN,k,j,i);
+        w_old.vx = wold_(m,IVX,k,j,i);
+        w_old.vy = wold_(m,IVY,k,j,i);
+        w_old.vz = wold_(m,IVZ,k,j,i);
+        w_old.e  = wold_(m,IEN,k,j,i);
+        lor_old = sqrt(1.0 + SQR(w_old.vx) + SQR(w_old.vy) + SQR(w_old.vz));
+      }
+      HydPrim1D w;
+      bool dfloor_used=false, efloor_used=false, c2p_failure=false;
+      int iter_used=0;
+      if (mhd) {
+        MHDCons1D u;
+        u.d  = u_(m,IDN,k,j,i);
+        u.mx = u_(m,IM1,k,j,i);
+        u.my = u_(m,IM2,k,j,i);
+        u.mz = u_(m,IM3,k,j,i);
+        u.e  = u_(m,IEN,k,j,i);
+        u.bx = bcc_(m,IBX,k,j,i);
+        u.by = bcc_(m,IBY,k,j,i);
+        u.bz = bcc_(m,IBZ,k,j,i);
+        Real s2 = SQR(u.mx) + SQR(u.my) + SQR(u.mz);
+        Real b2 = SQR(u.bx) + SQR(u.by) + SQR(u.bz);
+        Real rpar = (u.bx*u.mx +  u.by*u.my +  u.bz*u.mz)/u.d;
+        Real mu_guess = (guess)? C2PGuessMu_IdealSRMHD(w_old, lor_old, eos) : 0.0;
+        SingleC2P_IdealSRMHD(u, eos, s2, b2, rpar, w, dfloor_used, efloor_used,
+                             c2p_failure, iter_used, eos.c2p_max_iter, mu_guess,
+                             newton_iter);
+      } else {
+        HydCons1D u;
+        u.d  = u_(m,IDN,k,j,i);
+        u.mx = u_(m,IM1,k,j,i);
+        u.my = u_(m,IM2,k,j,i);
+        u.mz = u_(m,IM3,k,j,i);
+        u.e  = u_(m,IEN,k,j,i);
+        Real s2 = SQR(u.mx) + SQR(u.my) + SQR(u.mz);
+        Real z_guess = (guess)? sqrt(SQR(lor_old) - 1.0) : -1.0;
+        SingleC2P_IdealSRHyd(u, eos, s2, w, dfloor_used, efloor_used, c2p_failure,
+                             iter_used, newton_iter, z_guess);
+      }
+      w_(m,IDN,k,j,i) = w.d;
+      w_(m,IVX,k,j,i) = w.vx;
+      w_(m,IVY,k,j,i) = w.vy;
+      w_(m,IVZ,k,j,i) = w.vz;
+      w_(m,IEN,k,j,i) = w.e;
+      niter_(m,k,j,i) = iter_used;
+    });
+  });
+
+  int nx = bd.nx;
+  int nkji = npen*npen*nx;
+  int sum_iter = 0, nfallback = 0;
+  Kokkos::parallel_reduce("kb_src2p_iter",Kokkos::RangePolicy<>(DevExeSpace(), 0, nkji),
+  KOKKOS_LAMBDA(const int &idx, int &sum_it, int &sum_fb) {
+    int k = idx/(npen*nx);
+    int j = (idx - k*npen*nx)/nx;
+    int i = (idx - k*npen*nx - j*nx) + is;
+    int it = niter_(0,k,j,i);
+    sum_it += it;
+    if (it > newton_iter) {sum_fb++;}
+  }, Kokkos::Sum<int>(sum_iter), Kokkos::Sum<int>(nfallback));
+  std::cout << "  mean iterations " << std::setprecision(2)
+            << static_cast<double>(sum_iter)/nkji;
+  if (newton_iter > 0) {
+    std::cout << ", fallback fraction " << std::scientific
+              << static_cast<double>(nfallback)/nkji;
+  }
+  std::cout << std::endl;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void InitBenchData()
+//! \brief Allocates arrays and fills them with smooth waves in all variables (including
+//! a mild density jump per pencil so limiters are exercised), and total energy in u.
+
+void InitBenchData(BenchData &bd) {
+  bd.ncells1 = SimdPadded(bd.nx + 2*bd.ng);
+  bd.is = bd.ng;
+  bd.ie = bd.ng + bd.nx - 1;
+  const int nc1 = bd.ncells1, np = bd.npen;
+
+  bd.eos.gamma = 5.0/3.0;
+  bd.eos.iso_cs = 1.0;
+  bd.eos.is_ideal = true;
+  bd.eos.use_e = true;
+  bd.eos.use_t = false;
+  bd.eos.dfloor = 1.0e-10;
+  bd.eos.pfloor = 1.0e-13;
+  bd.eos.tfloor = 1.0e-13;
+  bd.eos.sfloor = 1.0e-13;
+  bd.eos.gamma_max = 20.0;
+  bd.eos.c2p_max_iter = 25;
+  bd.eos.c2p_fast_iter = 0;
+  bd.eos.c2p_warm = false;
+  bd.eos.c2p_warm_width = 1.0e-2;
+  bd.eos.c2p_newton = false;
+  bd.eos.c2p_newton_iter = 5;
+  bd.eos.masked_rs = false;
+
+  bd.indcs.ng = bd.ng;
+  bd.indcs.nx1 = bd.nx, bd.indcs.nx2 = np, bd.indcs.nx3 = np;
+  bd.indcs.is = bd.is, bd.indcs.ie = bd.ie;
+  bd.indcs.js = 0, bd.indcs.je = np-1;
+  bd.indcs.ks = 0, bd.indcs.ke = np-1;
+  Kokkos::realloc(bd.size, 1);
+  bd.size.h_view(0).x1min = 0.0, bd.size.h_view(0).x1max = 1.0;
+  bd.size.h_view(0).x2min = 0.0, bd.size.h_view(0).x2max = 1.0;
+  bd.size.h_view(0).x3min = 0.0, bd.size.h_view(0).x3max = 1.0;
+  bd.size.h_view(0).dx1 = 1.0/bd.nx;
+  bd.size.h_view(0).dx2 = 1.0/np;
+  bd.size.h_view(0).dx3 = 1.0/np;
+  bd.size.h_view(0).idx1 = bd.nx;
+  bd.size.h_view(0).idx2 = np;
+  bd.size.h_view(0).idx3 = np;
+  bd.size.template modify<HostMemSpace>();
+  bd.size.template sync<DevExeSpace>();
+  bd.coord.is_minkowski = true;
+  bd.coord.bh_spin = 0.0;
+  bd.coord.bh_excise = false;
+
+  Kokkos::realloc(bd.w, 1, 5, np, np, nc1);
+  Kokkos::realloc(bd.bcc, 1, 3, np, np, nc1);
+  Kokkos::realloc(bd.wl, 1, 5, np, np, nc1);
+  Kokkos::realloc(bd.wr, 1, 5, np, np, nc1);
+  Kokkos::realloc(bd.bl, 1, 3, np, np, nc1);
+  Kokkos::realloc(bd.br, 1, 3, np, np, nc1);
+  Kokkos::realloc(bd.bx, 1, np, np, nc1+1);
+  Kokkos::realloc(bd.ey, 1, np, np, nc1+1);
+  Kokkos::realloc(bd.ez, 1, np, np, nc1+1);
+  Kokkos::realloc(bd.flx, 1, 5, np, np, nc1+1);
+  Kokkos::realloc(bd.u, 1, 5, np, np, nc1);
+  Kokkos::realloc(bd.wout, 1, 5, np, np, nc1);
+  Kokkos::realloc(bd.wsr_old, 1, 5, np, np, nc1);
+  Kokkos::realloc(bd.usr, 1, 5, np, np, nc1);
+  Kokkos::realloc(bd.usr_mhd, 1, 5, np, np, nc1);
+  Kokkos::realloc(bd.niter, 1, np, np, nc1);
+
+  const Real gm1 = bd.eos.gamma - 1.0;
+  const Real dx = 2.0*M_PI/bd.nx;
+  const int is = bd.is;
+  auto w_ = bd.w, bcc_ = bd.bcc, u_ = bd.u, bx_ = bd.bx;
+  par_for("kb_init", DevExeSpace(), 0, 0, 0, np-1, 0, np-1, 0, nc1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real x = (i - is + 0.5)*dx + 0.1*j + 0.2*k;
+    Real d = 1.0 + 0.2*sin(x) + ((i - is > (j + k) % 16 + 8)? 0.5 : 0.0);
+    Real p = 1.0 + 0.1*cos(x);
+    w_(m,IDN,k,j,i) = d;
+    w_(m,IVX,k,j,i) = 0.3*sin(x);
+    w_(m,IVY,k,j,i) = 0.2*cos(x);
+    w_(m,IVZ,k,j,i) = 0.1*sin(2.0*x);
+    w_(m,IEN,k,j,i) = p/gm1;
+    bcc_(m,IBX,k,j,i) = 0.5;
+    bcc_(m,IBY,k,j,i) = 0.3*cos(x);
+    bcc_(m,IBZ,k,j,i) = 0.3*sin(x);
+    bx_(m,k,j,i) = 0.5;
+    HydPrim1D w;
+    w.d = d;
+    w.vx = w_(m,IVX,k,j,i);
+    w.vy = w_(m,IVY,k,j,i);
+    w.vz = w_(m,IVZ,k,j,i);
+    w.e = w_(m,IEN,k,j,i);
+    HydCons1D u;
+    SingleP2C_IdealHyd(w, u);
+    u_(m,IDN,k,j,i) = u.d;
+    u_(m,IM1,k,j,i) = u.mx;
+    u_(m,IM2,k,j,i) = u.my;
+    u_(m,IM3,k,j,i) = u.mz;
+    u_(m,IEN,k,j,i) = u.e;
+  });
+
+  // SR jet: beam of radius 0.25 (in units of x2-x3 extent) with Lorentz factor 7 and
+  // density 0.01 in pressure equilibrium with ambient medium of density 1.  Primitives
+  // of previous stage are perturbed by 1e-3.
+  const Real gam = bd.eos.gamma;
+  auto wold_ = bd.wsr_old, usr_ = bd.usr, usrm_ = bd.usr_mhd;
+  par_for("kb_init_sr", DevExeSpace(), 0, 0, 0, np-1, 0, np-1, 0, nc1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real x = (i - is + 0.5)*dx;
+    Real rad = sqrt(SQR((j + 0.5)/np - 0.5) + SQR((k + 0.5)/np - 0.5));
+    Real beam = 0.5*(1.0 - tanh((rad - 0.25)/0.02));
+    MHDPrim1D w;
+    w.d  = 1.0 - 0.99*beam;
+    w.vx = sqrt(48.0)*beam*(1.0 + 0.05*sin(x));
+    w.vy = 0.05*cos(x + 0.1*j);
+    w.vz = 0.05*sin(x + 0.1*k);
+    w.e  = 1.0e-3*(1.0 + 0.1*cos(x))/gm1;
+    w.bx = bcc_(m,IBX,k,j,i);
+    w.by = bcc_(m,IBY,k,j,i);
+    w.bz = bcc_(m,IBZ,k,j,i);
+    Real pert = 1.0 + 1.0e-3*sin(7.0*x);
+    wold_(m,IDN,k,j,i) = w.d*pert;
+    wold_(m,IVX,k,j,i) = w.vx*pert;
+    wold_(m,IVY,k,j,i) = w.vy*pert;
+    wold_(m,IVZ,k,j,i) = w.vz*pert;
+    wold_(m,IEN,k,j,i) = w.e/pert;
+    HydPrim1D wh;
+    wh.d = w.d, wh.vx = w.vx, wh.vy = w.vy, wh.vz = w.vz, wh.e = w.e;
+    HydCons1D u;
+    SingleP2C_IdealSRHyd(wh, gam, u);
+    usr_(m,IDN,k,j,i) = u.d;
+    usr_(m,IM1,k,j,i) = u.mx;
+    usr_(m,IM2,k,j,i) = u.my;
+    usr_(m,IM3,k,j,i) = u.mz;
+    usr_(m,IEN,k,j,i) = u.e;
+    SingleP2C_IdealSRMHD(w, gam, u);
+    usrm_(m,IDN,k,j,i) = u.d;
+    usrm_(m,IM1,k,j,i) = u.mx;
+    usrm_(m,IM2,k,j,i) = u.my;
+    usrm_(m,IM3,k,j,i) = u.mz;
+    usrm_(m,IEN,k,j,i) = u.e;
+  });
+
+  // L/R states of transverse field for MHD solvers
+  const int ncells1 = nc1, il = bd.is, iu = bd.ie+1;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(3, nc1) * 2;
+  int scr_level = global_variable::scratch_level;
+  auto bl_ = bd.bl, br_ = bd.br;
+  par_for_outer("kb_init_b",DevExeSpace(), scr_size, scr_level, 0, 0, 0, np-1, 0, np-1,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> ql(member.team_scratch(scr_level), 3, ncells1);
+    ScrArray2D<Real> qr(member.team_scratch(scr_level), 3, ncells1);
+    PiecewiseLinearX1(member, m, k, j, il-1, iu, bcc_, ql, qr);
+    member.team_barrier();
+    for (int n=0; n<3; ++n) {
+      par_for_inner(member, il, iu, [&](const int i) {
+        bl_(m,n,k,j,i) = ql(n,i);
+        br_(m,n,k,j,i) = qr(n,i);
+      });
+    }
+  });
+  Kokkos::fence();
+}
+
+void Usage(const char *name) {
+  std::cout << "Usage: " << name << " [-n nx] [-p npencil] [-r nrepeat]" << std::endl
+            << "  -n nx        cells per pencil (default 256)" << std::endl
+            << "  -p npencil   pencils in each of x2 and x3 (default 64)" << std::endl
+            << "  -r nrepeat   timed repetitions of each kernel (default 20)"
+            << std::endl;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn int main()
+//! \brief Parses command line, runs all benchmarks and prints a table of results
+
+int main(int argc, char *argv[]) {
+  BenchData bd;
+  bd.nx = 256, bd.npen = 64, bd.nrep = 20;
+  for (int n=1; n<argc; ++n) {
+    if (std::strcmp(argv[n], "-h") == 0) {
+      Usage(argv[0]);
+      return 0;
+    }
+    if (n+1 >= argc || (std::strcmp(argv[n], "-n") != 0 &&
+        std::strcmp(argv[n], "-p") != 0 && std::strcmp(argv[n], "-r") != 0)) {
+      Usage(argv[0]);
+      exit(EXIT_FAILURE);
+    }
+    int val = std::atoi(argv[n+1]);
+    if (val < 1) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Argument of " << argv[n] << " must be a positive integer"
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (argv[n][1] == 'n') {bd.nx = val;}
+    if (argv[n][1] == 'p') {bd.npen = val;}
+    if (argv[n][1] == 'r') {bd.nrep = val;}
+    ++n;
+  }
+  global_variable::my_rank = 0;
+  global_variable::nranks = 1;
+
+  Kokkos::initialize(argc, argv);
+  {
+    InitBenchData(bd);
+    std::cout << "Kernel micro-benchmarks: " << bd.npen << "x" << bd.npen
+              << " pencils of " << bd.nx << " cells, " << bd.nrep << " repetitions, "
+              << "sizeof(Real)=" << sizeof(Real) << std::endl;
+    std::cout << std::left << std::setw(16) << "kernel" << std::right << std::setw(14)
+              << "cells/s" << std::setw(12) << "bytes/cell" << std::setw(12) << "GB/s"
+              << std::endl;
+
+    BenchReconstruct<BenchRecon::plm>("recon_plm", bd);
+    BenchReconstruct<BenchRecon::ppm4>("recon_ppm4", bd);
+    BenchReconstruct<BenchRecon::ppmx>("recon_ppmx", bd);
+    BenchReconstruct<BenchRecon::wenoz>("recon_wenoz", bd);
+    BenchReconstruct<BenchRecon::mp5>("recon_mp5", bd);
+
+    // Riemann solvers use the (last computed) MP5 states
+    BenchRiemann<BenchRSolver::llf>("hydro_llf", bd);
+    BenchRiemann<BenchRSolver::hlle>("hydro_hlle", bd);
+    BenchRiemann<BenchRSolver::hllc>("hydro_hllc", bd);
+    BenchRiemann<BenchRSolver::roe>("hydro_roe", bd);
+    BenchMHDRiemann<BenchMHDRSolver::llf>("mhd_llf", bd);
+    BenchMHDRiemann<BenchMHDRSolver::hlle>("mhd_hlle", bd);
+    BenchMHDRiemann<BenchMHDRSolver::hlld>("mhd_hlld", bd);
+
+    BenchC2P("c2p_hydro", bd, false);
+    BenchC2P("c2p_mhd", bd, true);
+    BenchSRC2P("c2p_srhyd", bd, false, BenchC2PStrategy::bracket);
+    BenchSRC2P("c2p_srhyd_newton", bd, false, BenchC2PStrategy::newton);
+    BenchSRC2P("c2p_srmhd", bd, true, BenchC2PStrategy::bracket);
+    BenchSRC2P("c2p_srmhd_warm", bd, true, BenchC2PStrategy::warm);
+    BenchSRC2P("c2p_srmhd_newton", bd, true, BenchC2PStrategy::newton);
+  }
+  Kokkos::finalize();
+  return 0;
+}
@@ -9,7 +9,9 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <string>
 #include <utility>
+#include <vector>
 #include <algorithm> // max
 
 #include "athena.hpp"
@@ -17,6 +19,7 @@
 #include "parameter_input.hpp"
 #include "mesh/nghbr_index.hpp"
 #include "mesh/mesh.hpp"
+#include "utils/memory_registry.hpp"
 #include "particles/particles.hpp"
 #include "bvals.hpp"
 
@@ -28,9 +31,53 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
   is_z4c_(z4c),
   u_in("uin",1,1),
   b_in("bin",1,1),
-  i_in("iin",1,1) {
+  i_in("iin",1,1),
+  nmb_req_(std::max((pp->nmb_thispack), (pp->pmesh->nmb_maxperrank))),
+  nregrid_req_(-1),
+  vars_stat_(comm_stats::vars_cc),
+  flux_stat_(comm_stats::flux_cc),
+  vars_wait_t0_(-1.0),
+  flux_wait_t0_(-1.0),
+  persist_nmsg_(0),
+  persist_nbytes_(0),
+  prol_list_("prol_list",1),
+  fill_list_("fill_list",1),
+  nprol_(0),
+  nfill_(0),
+  fcor_send_list_("fcor_send_list",1),
+  fcor_recv_list_("fcor_recv_list",1),
+  ecor_recv_list_("ecor_recv_list",1),
+  fine_mb_list_("fine_mb_list",1),
+  nfcor_send_(0),
+  nfcor_recv_(0),
+  necor_recv_(0),
+  nfine_mb_(0),
+  nregrid_lev_(-1),
+#if MPI_PARALLEL_ENABLED
+  agg_send_map_("agg_smap",1,1),
+  agg_recv_map_("agg_rmap",1,1),
+  agg_sendbuf_("agg_sbuf",1),
+  agg_recvbuf_("agg_rbuf",1),
+  shm_flags_(nullptr),
+  shm_epoch_(0),
+  nregrid_shm_(-1),
+  shm_send_map_("shm_smap",1,1),
+  shm_send_ptr_("shm_sptr",1),
+  lowp_node_local_("lowp_nlocal",1),
+#endif
+  nregrid_agg_(-1) {
   // allocate vector of status flags and MPI requests (if needed)
   int nnghbr = pmy_pack->pmb->nnghbr;
+  persistent_mpi = pin->GetOrAddBoolean("mesh", "persistent_mpi", false);
+  aggregate_mpi = pin->GetOrAddBoolean("mesh", "aggregate_mpi", false);
+  shm_halo = pin->GetOrAddBoolean("mesh", "shm_halo", false);
+  host_staged_mpi = pin->GetOrAddBoolean("mesh", "host_staged_mpi", false);
+  staging_chunk = pin->GetOrAddInteger("mesh", "staging_chunk", 262144);
+  lowp_vars = false;
+  halo_depth = pp->pmesh->mb_indcs.ng;
+  vars_version = 0;
+  exch_version_ = 0;
+  exch_nregrid_ = -1;
 
   // sendbuf and recvbuf are fixed-length [56-element] arrays
   // Initialize some of the data in appropriate elements based on dimensionality of
@@ -38,7 +85,7 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
   for (int n=0; n<nnghbr; ++n) {
 #if MPI_PARALLEL_ENABLED
     // allocate vector of MPI requests (if needed)
-    int nmb = std::max((pmy_pack->nmb_thispack), (pmy_pack->pmesh->nmb_maxperrank));
+    int nmb = nmb_req_;
     sendbuf[n].vars_req = new MPI_Request[nmb];
     sendbuf[n].flux_req = new MPI_Request[nmb];
     recvbuf[n].vars_req = new MPI_Request[nmb];
@@ -57,15 +104,34 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
     sendbuf[n].ifine_ndat = 0;
     sendbuf[n].iflxs_ndat = 0;
     sendbuf[n].iflxc_ndat = 0;
+    sendbuf[n].isame_nskip = 0;
     recvbuf[n].isame_ndat = 0;
     recvbuf[n].isame_z4c_ndat = 0;
     recvbuf[n].icoar_ndat = 0;
     recvbuf[n].ifine_ndat = 0;
     recvbuf[n].iflxs_ndat = 0;
     recvbuf[n].iflxc_ndat = 0;
+    recvbuf[n].isame_nskip = 0;
   }
 
 #if MPI_PARALLEL_ENABLED
+  // staging through host memory is only needed if device memory is not host accessible.
+  // It is applied to the aggregated messages sent to each rank, so implies aggregate_mpi
+  if (Kokkos::SpaceAccessibility<HostMemSpace, DevMemSpace>::accessible) {
+    host_staged_mpi = false;
+  }
+  if (host_staged_mpi) {
+    if (staging_chunk < 1) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mesh>/staging_chunk=" << staging_chunk
+                << " must be positive" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    aggregate_mpi = true;
+    // two instances, so that copying one chunk overlaps posting sends of previous one
+    stg_exec_ = Kokkos::Experimental::partition_space(DevExeSpace(), 1, 1);
+  }
+
   // create unique communicators for variables and fluxes in this BoundaryValues object
   MPI_Comm_dup(MPI_COMM_WORLD, &comm_vars);
   MPI_Comm_dup(MPI_COMM_WORLD, &comm_flux);
@@ -77,6 +143,9 @@ MeshBoundaryValues::MeshBoundaryValues(MeshBlockPack *pp, ParameterInput *pin, b
 
 MeshBoundaryValues::~MeshBoundaryValues() {
 #if MPI_PARALLEL_ENABLED
+  FreePersistentRequests();
+  FreeAggregation();
+  FreeShmTransport();
   int nnghbr = pmy_pack->pmb->nnghbr;
   for (int n=0; n<nnghbr; ++n) {
     delete [] sendbuf[n].vars_req;
@@ -87,6 +156,105 @@ MeshBoundaryValues::~MeshBoundaryValues() {
 #endif
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValues::InitLevelLists
+//! \brief Builds compact lists of the buffers that border a change in level, so that
+//! prolongation kernels (and the restriction of same-level ghost zones into the coarse
+//! array that feeds their stencils) only launch teams for these buffers.  Buffers of
+//! MeshBlocks whose neighbors are all at the same level are skipped entirely.  Also
+//! builds the lists of fine/coarse interfaces (faces, plus edges for fluxes of FC vars)
+//! used by the flux-correction pack/unpack kernels and their MPI calls.  Called
+//! whenever Mesh::nregrid changes.
+
+void MeshBoundaryValues::InitLevelLists() {
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mblev = pmy_pack->pmb->mb_lev;
+
+  std::vector<int> prol, fill, fsend, frecv, erecv, finemb;
+  for (int m=0; m<nmb; ++m) {
+    bool has_coarser = false, has_finer = false;
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid < 0) continue;
+      // fluxes of CC vars are corrected only on faces, of FC vars on faces and edges
+      bool face = (n<16) || ((n>=24) && (n<32));
+      if (nghbr.h_view(m,n).lev < mblev.h_view(m)) {
+        prol.push_back(m*nnghbr + n);
+        if (face) {fsend.push_back(m*nnghbr + n);}
+        has_coarser = true;
+      } else if (nghbr.h_view(m,n).lev > mblev.h_view(m)) {
+        if (face) {frecv.push_back(m*nnghbr + n);}
+        if (n<48) {erecv.push_back(m*nnghbr + n);}
+        has_finer = true;
+      }
+    }
+    if (has_finer) {finemb.push_back(m);}
+    if (!(has_coarser)) continue;
+    for (int n=0; n<nnghbr; ++n) {
+      if ((nghbr.h_view(m,n).gid >= 0) && (nghbr.h_view(m,n).lev == mblev.h_view(m))) {
+        fill.push_back(m*nnghbr + n);
+      }
+    }
+  }
+  // lists only grow, so device storage is reused across regrids
+  auto copy_list = [](const std::vector<int> &l, DualArray1D<int> &list, int &nlist) {
+    nlist = static_cast<int>(l.size());
+    if (list.extent_int(0) < nlist) {Kokkos::realloc(list, nlist);}
+    for (int e=0; e<nlist; ++e) {list.h_view(e) = l[e];}
+    list.template modify<HostMemSpace>();
+    list.template sync<DevExeSpace>();
+  };
+  copy_list(prol, prol_list_, nprol_);
+  copy_list(fill, fill_list_, nfill_);
+  copy_list(fsend, fcor_send_list_, nfcor_send_);
+  copy_list(frecv, fcor_recv_list_, nfcor_recv_);
+  copy_list(erecv, ecor_recv_list_, necor_recv_);
+  copy_list(finemb, fine_mb_list_, nfine_mb_);
+  nregrid_lev_ = pmy_pack->pmesh->nregrid;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int MeshBoundaryValues::StencilHaloDepth
+//! \brief Returns number of ghost zones read by reconstruction stencils of the physics
+//! module in input block, so that only these are exchanged with <block>/trim_halo=true.
+//! Shearing box remaps and SMR/AMR use all ghost zones, so no trimming is done for them.
+
+int MeshBoundaryValues::StencilHaloDepth(ParameterInput *pin, const std::string &block) {
+  int ng = pmy_pack->pmesh->mb_indcs.ng;
+  if (pmy_pack->pmesh->multilevel || pin->DoesBlockExist("shearing_box")) {return ng;}
+
+  // fourth-order fluxes apply transverse corrections to face states, which need all
+  // ghost zones (at least 4)
+  if (pin->DoesParameterExist(block, "fourth_order") &&
+      pin->GetBoolean(block, "fourth_order")) {
+    return ng;
+  }
+
+  auto recon_depth = [](const std::string &xorder) {
+    if (xorder.compare("dc") == 0) {
+      return 1;
+    } else if (xorder.compare("ppm4") == 0 || xorder.compare("ppmx") == 0 ||
+               xorder.compare("wenoz") == 0 || xorder.compare("wenoz_hybrid") == 0 ||
+               xorder.compare("mp5") == 0) {
+      return 3;
+    }
+    return 2;
+  };
+  std::string xorder = pin->GetOrAddString(block, "reconstruct", "plm");
+  int depth = recon_depth(xorder);
+  // passive scalars may use a different (wider) reconstruction
+  if (pin->DoesParameterExist(block, "scalar_reconstruct")) {
+    depth = std::max(depth, recon_depth(pin->GetString(block, "scalar_reconstruct")));
+  }
+  // FOFC recomputes fluxes from a stencil one cell wider
+  if (pin->DoesParameterExist(block, "fofc") && pin->GetBoolean(block, "fofc")) {
+    depth++;
+  }
+  return std::min(depth, ng);
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBoundaryValues::InitializeBuffers
 //! \brief initialize each element of send/recv MeshBoundaryBuffers fixed-length arrays
@@ -97,6 +265,7 @@ MeshBoundaryValues::~MeshBoundaryValues() {
 //! virtual functions that only get instantiated when the derived classes are constructed
 
 void MeshBoundaryValues::InitializeBuffers(const int nvar) {
+  memory_registry::Scope mem_scope("bvals");
   // allocate memory for inflow BCs (but only if domain not strictly periodic)
   if (!(pmy_pack->pmesh->strictly_periodic)) {
     Kokkos::realloc(u_in, nvar, 6);
@@ -104,6 +273,28 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
     Kokkos::realloc(i_in, nvar, 6);
   }
 
+  // single-precision messages only needed with MPI when Real is double, and are not yet
+  // implemented for aggregated messages
+#if MPI_PARALLEL_ENABLED
+  if (lowp_vars && (sizeof(Real) == sizeof(float))) {lowp_vars = false;}
+  if (lowp_vars && aggregate_mpi) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "lowp_halo cannot be used with <mesh>/aggregate_mpi, "
+                << "using full precision messages" << std::endl;
+    }
+    lowp_vars = false;
+  }
+#else
+  lowp_vars = false;
+#endif
+
+  // fine/coarse boundaries always need all ghost zones for prolongation/restriction
+  int ng = pmy_pack->pmesh->mb_indcs.ng;
+  if ((halo_depth < 1) || (halo_depth > ng) || (pmy_pack->pmesh->multilevel)) {
+    halo_depth = ng;
+  }
+
   // set number of subblocks in x2- and x3-dirs
   int nfx = 1, nfy = 1, nfz = 1;
   if (pmy_pack->pmesh->multilevel) {
@@ -122,8 +313,8 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
         int indx = NeighborIndex(n,0,0,fy,fz);
         InitSendIndices(sendbuf[indx],n, 0, 0, fy, fz);
         InitRecvIndices(recvbuf[indx],n, 0, 0, fy, fz);
-        sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
-        recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
+        sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
+        recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
         indx++;
       }
     }
@@ -138,8 +329,8 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
           int indx = NeighborIndex(0,m,0,fx,fz);
           InitSendIndices(sendbuf[indx],0, m, 0, fx, fz);
           InitRecvIndices(recvbuf[indx],0, m, 0, fx, fz);
-          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
-          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
+          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
+          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
           indx++;
         }
       }
@@ -152,8 +343,8 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
           int indx = NeighborIndex(n,m,0,fz,0);
           InitSendIndices(sendbuf[indx],n, m, 0, fz, 0);
           InitRecvIndices(recvbuf[indx],n, m, 0, fz, 0);
-          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
-          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
+          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
+          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
           indx++;
         }
       }
@@ -169,8 +360,8 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
           int indx = NeighborIndex(0,0,l,fx,fy);
           InitSendIndices(sendbuf[indx],0, 0, l, fx, fy);
           InitRecvIndices(recvbuf[indx],0, 0, l, fx, fy);
-          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
-          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
+          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
+          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
           indx++;
         }
       }
@@ -183,8 +374,8 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
           int indx = NeighborIndex(n,0,l,fy,0);
           InitSendIndices(sendbuf[indx],n, 0, l, fy, 0);
           InitRecvIndices(recvbuf[indx],n, 0, l, fy, 0);
-          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
-          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
+          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
+          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
           indx++;
         }
       }
@@ -197,8 +388,8 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
           int indx = NeighborIndex(0,m,l,fx,0);
           InitSendIndices(sendbuf[indx],0, m, l, fx, 0);
           InitRecvIndices(recvbuf[indx],0, m, l, fx, 0);
-          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
-          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
+          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
+          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
           indx++;
         }
       }
@@ -211,13 +402,16 @@ void MeshBoundaryValues::InitializeBuffers(const int nvar) {
           int indx = NeighborIndex(n,m,l,0,0);
           InitSendIndices(sendbuf[indx],n, m, l, 0, 0);
           InitRecvIndices(recvbuf[indx],n, m, l, 0, 0);
-          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
-          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_);
+          sendbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
+          recvbuf[indx].AllocateBuffers(nmb, nvar, is_z4c_, lowp_vars);
         }
       }
     }
   }
 
+  // move recv buffers into shared memory visible to other ranks on same node
+  if (shm_halo) {InitShmTransport();}
+
   return;
 }
 
@@ -233,14 +427,9 @@ particles::ParticlesBoundaryValues::ParticlesBoundaryValues(
     prtcl_isendbuf("isend",1),
     prtcl_irecvbuf("irecv",1),
 #endif
-    pmy_part(pp) {
+    pmy_part(pp),
+    wait_t0_(-1.0) {
 #if MPI_PARALLEL_ENABLED
-  // Guess that no more than 10% of particles will be communicated to set size of buffer
-  int npart = pmy_part->nprtcl_thispack;
-
-  //resize vectors over number of ranks
-  nsends_eachrank.resize(global_variable::nranks);
-
   // create unique communicator for particles
   MPI_Comm_dup(MPI_COMM_WORLD, &mpi_comm_part);
 #endif
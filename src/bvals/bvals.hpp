@@ -20,12 +20,16 @@ enum class BoundaryFlag {undef=-1,block, reflect, inflow, outflow, diode, user,
                          shear_periodic, vacuum};
 
 #include <algorithm>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "coordinates/coordinates.hpp"
 #include "tasklist/task_list.hpp"
+#include "bvals/comm_stats.hpp"
 //#include "particles/particles.hpp"
 
 // Forward declarations
@@ -37,11 +41,11 @@ class Particles;
 //----------------------------------------------------------------------------------------
 //! \fn int CreateBvals_MPI_Tag(int lid, int bufid)
 //! \brief calculate an MPI tag for boundary buffer communications.  Note maximum size of
-//! lid that can be encoded is set by (NUM_BITS_LID) macro.
+//! lid that can be encoded is 2^(global_variable::nbits_lid), set from MPI_TAG_UB.
 //! The convention in Athena++ is lid and bufid are both for the *receiving* process.
 //! The MPI standard requires signed int tag, with MPI_TAG_UB>=2^15-1 = 32,767 (inclusive)
 static int CreateBvals_MPI_Tag(int lid, int bufid) {
-  return (bufid << (NUM_BITS_LID)) | lid;
+  return (bufid << (global_variable::nbits_lid)) | lid;
 }
 
 //----------------------------------------------------------------------------------------
@@ -74,9 +78,14 @@ struct MeshBoundaryBuffer {
 
   // Maximum number of data elements (bie-bis+1) across 3 components of above
   int isame_ndat, isame_z4c_ndat, icoar_ndat, ifine_ndat, iflxs_ndat, iflxc_ndat;
+  // number of data elements (all variables) not sent in same level buffer with a
+  // directional halo (see MeshBoundaryValuesCC::SetDirectionalHalo)
+  int isame_nskip;
 
   // 2D Views that store buffer data on device, dimensioned (nmb, ndata)
   DvceArray2D<Real> vars, flux;
+  // single-precision copy of vars used only for MPI messages (with lowp_vars)
+  DvceArray2D<float> vars_lowp;
 
 #if MPI_PARALLEL_ENABLED
   // vectors of length (number of MBs) to hold MPI requests
@@ -85,18 +94,117 @@ struct MeshBoundaryBuffer {
 #endif
 
   // function to allocate memory for buffers for variables and their fluxes
-  // Must only be called after BufferIndcs above are initialized
-  void AllocateBuffers(int nmb, int nvars, bool is_z4c) {
+  // Must only be called after BufferIndcs above are initialized.  Buffers are always
+  // packed before they are read, so they are not zero-filled on allocation.
+  void AllocateBuffers(int nmb, int nvars, bool is_z4c, bool lowp=false) {
     // With Z4c, buffers may contain BOTH same and coarse data
     if (is_z4c) {
       int nmax = std::max(isame_z4c_ndat, std::max(icoar_ndat, ifine_ndat) );
-      Kokkos::realloc(vars, nmb, (nvars*nmax));
+      Kokkos::realloc(Kokkos::WithoutInitializing, vars, nmb, (nvars*nmax));
     } else {
       int nmax = std::max(isame_ndat, std::max(icoar_ndat, ifine_ndat) );
-      Kokkos::realloc(vars, nmb, (nvars*nmax));
+      Kokkos::realloc(Kokkos::WithoutInitializing, vars, nmb, (nvars*nmax));
+    }
+    if (lowp) {
+      Kokkos::realloc(Kokkos::WithoutInitializing, vars_lowp, nmb, vars.extent_int(1));
     }
     int nmax = std::max(iflxs_ndat, iflxc_ndat);
-    Kokkos::realloc(flux, nmb, (nvars*nmax));
+    Kokkos::realloc(Kokkos::WithoutInitializing, flux, nmb, (nvars*nmax));
+  }
+
+  // pointer to vars of MeshBlock m in MPI messages, in single precision if lowp
+  void *MPIVarsPtr(int m, bool lowp) {
+    if (lowp) {return Kokkos::subview(vars_lowp, m, Kokkos::ALL).data();}
+    return Kokkos::subview(vars, m, Kokkos::ALL).data();
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct AggregateEntry
+//! \brief location of one MeshBoundaryBuffer within an aggregated MPI message.  Entries
+//! in each message are sorted by (rank, tag) where the tag (from CreateBvals_MPI_Tag)
+//! encodes the local ID and buffer index of the *receiving* MeshBlock, so that the sender
+//! and receiver arrive at the same layout independently.
+
+struct AggregateEntry {
+  int rank, tag;   // rank of neighbor, and tag of buffer
+  int m, n;        // index of local MeshBlock and buffer
+  int ndat;        // amount of data in buffer
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct BufferDescriptor
+//! \brief flattened description of one boundary buffer of one MeshBlock, precomputed once
+//! per mesh change so that pack/unpack kernels are branch-free gathers and scatters over
+//! a compact list containing only buffers with neighbors.
+
+struct BufferDescriptor {
+  int m, n;            // index of MeshBlock and buffer whose cells are packed/unpacked
+  int il, jl, kl;      // starting indices of cells
+  int ni, nj, nk;      // number of cells in each direction
+  int dm, dn;          // indices of MeshBlock and buffer of destination data
+  int coarse;          // 1 if data are read from/written to coarsened array
+  int local;           // 1 if destination is recv buffer on this rank (packing only)
+  int dir;             // direction data travel with directional halo (else -1)
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn int DirectionalLayout()
+//! \brief With a directional halo, variables flagged for the direction of travel d.dir
+//! (0,1,...,5 = +x1,-x1,...,-x3) of a same-level face buffer are sent with ndrop fewer
+//! layers of cells, omitting those farthest from the face shared with the neighbor.
+//! dvar(t,v) is the number of flagged variables before v for direction t.  Restricts the
+//! range of cells in d to those sent for variable v, and returns offset of v in buffer.
+
+template <typename ViewType>
+KOKKOS_INLINE_FUNCTION
+int DirectionalLayout(BufferDescriptor &d, const int v, const int ndrop,
+                      const ViewType &dvar) {
+  const int ncell = d.ni*d.nj*d.nk;
+  if (d.dir < 0) {return v*ncell;}
+  const int dim = d.dir/2;
+  const int nlayer = (dim == 0)? d.ni : ((dim == 1)? d.nj : d.nk);
+  const int nprev = dvar(d.dir, v);
+  if (dvar(d.dir, v+1) > nprev) {
+    // farthest layers have the lowest indices when data travel in + direction
+    const int shift = (d.dir % 2 == 0)? ndrop : 0;
+    if (dim == 0) {
+      d.il += shift;  d.ni -= ndrop;
+    } else if (dim == 1) {
+      d.jl += shift;  d.nj -= ndrop;
+    } else {
+      d.kl += shift;  d.nk -= ndrop;
+    }
+  }
+  return v*ncell - nprev*ndrop*(ncell/nlayer);
+}
+
+//----------------------------------------------------------------------------------------
+//! \struct CCFieldList
+//! \brief list of cell-centered arrays (and their coarsened counterparts) that are packed
+//! into the same boundary buffers, so that all are sent in one message per neighbor and
+//! packed/unpacked in one kernel.  Variables of field f occupy indices
+//! [voff[f], voff[f+1]) of the combined buffer.
+
+struct CCFieldList {
+  static constexpr int nmax = 4;
+  int nfld = 0;
+  int voff[nmax+1] = {0};
+  DvceArray5D<Real> a[nmax], ca[nmax];
+
+  void Add(const DvceArray5D<Real> &x, const DvceArray5D<Real> &cx) {
+    a[nfld] = x;
+    ca[nfld] = cx;
+    voff[nfld+1] = voff[nfld] + x.extent_int(1);
+    nfld++;
+  }
+  int nvar() const {return voff[nfld];}
+  // index of field containing variable v of combined buffer
+  KOKKOS_INLINE_FUNCTION
+  int Field(const int v) const {
+    int f = 0;
+    while ((f < nfld-1) && (v >= voff[f+1])) {f++;}
+    return f;
   }
 };
 
@@ -124,13 +232,65 @@ class MeshBoundaryValues {
   // unique MPI communicators for each case (variables/fluxes)
   MPI_Comm comm_vars, comm_flux;
 #endif
+  // use persistent MPI requests (created once per regrid) for communication of vars
+  bool persistent_mpi;
+  // aggregate all vars sent between each pair of ranks into a single message
+  bool aggregate_mpi;
+  // write vars directly into recv buffers of ranks on same node using shared memory
+  bool shm_halo;
+  // stage aggregated messages through pinned host buffers (for MPI that cannot access
+  // device memory), copied in chunks of at most staging_chunk values
+  bool host_staged_mpi;
+  int staging_chunk;
+  // send vars over MPI in single precision (set before InitializeBuffers is called)
+  bool lowp_vars;
+  // number of ghost zones exchanged with neighbors at same level (set before
+  // InitializeBuffers is called, default is all ng ghost zones)
+  int halo_depth;
+  // version of variables, incremented by owning module each time it modifies them.
+  // Modules whose variables are fixed skip exchanges when VarsExchanged() is true, i.e.
+  // neither the version nor the grid has changed since the last completed exchange.
+  int vars_version;
+  bool VarsExchanged() const {
+    return (vars_version == exch_version_) && (exch_nregrid_ == pmy_pack->pmesh->nregrid);
+  }
+  void MarkVarsExchanged() {
+    exch_version_ = vars_version;
+    exch_nregrid_ = pmy_pack->pmesh->nregrid;
+  }
 
   //functions
   virtual void InitSendIndices(MeshBoundaryBuffer &buf,int x,int y,int z,int a,int b)=0;
   virtual void InitRecvIndices(MeshBoundaryBuffer &buf,int x,int y,int z,int a,int b)=0;
   void InitializeBuffers(const int nvar);
+  int StencilHaloDepth(ParameterInput *pin, const std::string &block);
 
   TaskStatus InitRecv(const int nvar);
+  void InitPersistentRequests(const int nvar);
+  void FreePersistentRequests();
+  TaskStatus StartPersistentSends();
+  void InitAggregation(const int nvar);
+  void FreeAggregation();
+  TaskStatus InitAggregateRecv(const int nvar);
+  TaskStatus PackAndSendAggregate();
+  TaskStatus RecvAndUnpackAggregate();
+  TaskStatus ClearAggregateRecv();
+  TaskStatus ClearAggregateSend();
+  void PackLowPrecision(const int nvar);
+  void UnpackLowPrecision(const int nvar);
+  void InitShmTransport();
+  void FreeShmTransport();
+  void InitShmExchange(const int nvar);
+  void ShmPostRecv(const int nvar);
+  bool ShmPeersReady();
+  void ShmSend();
+  bool ShmRecvComplete();
+#if MPI_PARALLEL_ENABLED
+  // true if rank is on same node, and so data is exchanged through shared memory
+  bool IsNodeLocal(const int rank) const {
+    return (shm_halo && (shm_flags_ != nullptr) && (shm_node_rank_[rank] >= 0));
+  }
+#endif
   virtual TaskStatus InitFluxRecv(const int nvar)=0;
   TaskStatus ClearRecv();
   TaskStatus ClearSend();
@@ -149,6 +309,74 @@ class MeshBoundaryValues {
   // many types (Hydro, MHD, Radiation, Z4c, etc.)
   MeshBlockPack* pmy_pack;
   bool is_z4c_;   // flag to denote if this BoundaryValues is for Z4c module
+  int nmb_req_;      // length of arrays of MPI requests in each MeshBoundaryBuffer
+  int nregrid_req_;  // value of Mesh::nregrid when persistent requests created (or -1)
+  int nregrid_agg_;  // value of Mesh::nregrid when aggregated messages built (or -1)
+  int exch_version_; // vars_version at last completed exchange
+  int exch_nregrid_; // value of Mesh::nregrid at last completed exchange (or -1)
+  // type of exchange of vars/fluxes in communication statistics, and time at which
+  // receives were first found pending (or -1)
+  comm_stats::Exchange vars_stat_, flux_stat_;
+  double vars_wait_t0_, flux_wait_t0_;
+  // number of messages and bytes sent by persistent sends (set with requests)
+  std::uint64_t persist_nmsg_, persist_nbytes_;
+  int VarsDataSize(const MeshBoundaryBuffer &buf, const int m, const int n,
+                   const int nvars);
+  // compact lists of buffers at fine/coarse boundaries, stored as (m*nnghbr + n)
+  DualArray1D<int> prol_list_;  // buffers with neighbor at coarser level
+  DualArray1D<int> fill_list_;  // same-level buffers of MBs with a coarser neighbor
+  int nprol_, nfill_;
+  // compact lists of fine/coarse interfaces for flux correction, stored as (m*nnghbr+n)
+  DualArray1D<int> fcor_send_list_;  // faces with neighbor at coarser level
+  DualArray1D<int> fcor_recv_list_;  // faces with neighbor at finer level
+  DualArray1D<int> ecor_recv_list_;  // faces and edges with neighbor at finer level
+  DualArray1D<int> fine_mb_list_;    // MBs with at least one neighbor at finer level
+  int nfcor_send_, nfcor_recv_, necor_recv_, nfine_mb_;
+  int nregrid_lev_;  // value of Mesh::nregrid when lists built (or -1)
+  void InitLevelLists();
+  void UpdateLevelLists() {
+    if (nregrid_lev_ != pmy_pack->pmesh->nregrid) {InitLevelLists();}
+  }
+
+#if MPI_PARALLEL_ENABLED
+  // data for aggregated messages: one per neighboring rank, with offsets of each
+  // message in contiguous buffers, and (m, n, offset, ndat) of each buffer in messages
+  std::vector<int> agg_send_rank_, agg_recv_rank_;
+  std::vector<int> agg_send_off_, agg_recv_off_;
+  DualArray2D<int> agg_send_map_, agg_recv_map_;
+  DvceArray1D<Real> agg_sendbuf_, agg_recvbuf_;
+  std::vector<MPI_Request> agg_send_req_, agg_recv_req_;
+  // with host_staged_mpi, MPI uses pinned host copies of the aggregated buffers, which
+  // are copied to/from the device on separate execution space instances (streams)
+  Kokkos::View<Real*, PinnedMemSpace> stg_sendbuf_, stg_recvbuf_;
+  std::vector<DevExeSpace> stg_exec_;
+  std::vector<int> stg_recv_done_;      // flags: message from each rank copied to device
+  Real *AggSendData() {
+    return host_staged_mpi ? stg_sendbuf_.data() : agg_sendbuf_.data();
+  }
+  Real *AggRecvData() {
+    return host_staged_mpi ? stg_recvbuf_.data() : agg_recvbuf_.data();
+  }
+
+  // data for exchange through shared memory with ranks on same node.  Recv buffers of
+  // vars are stored in a shared window (win_data_), followed in a second window
+  // (win_flag_) by two flags per recv buffer: epoch at which buffer is ready to be
+  // written, and epoch of the data last written into it by the neighbor.
+  MPI_Comm comm_node_;
+  MPI_Win win_data_, win_flag_;
+  int *shm_flags_;                      // flags of this rank [2*nmb_req_*nnghbr]
+  int shm_epoch_;                       // # of exchanges since last regrid
+  int nregrid_shm_;                     // value of Mesh::nregrid when tables built
+  std::vector<int> shm_node_rank_;      // rank in comm_node_ of each rank (or -1)
+  std::vector<int> shm_nmb_req_;        // nmb_req_ of each rank in comm_node_
+  std::vector<int> shm_buf_off_;        // offset of each recv buffer in win_data_
+  DualArray2D<int> shm_send_map_;       // (m, n, ndat) of each buffer sent via shm
+  DualArray1D<Real*> shm_send_ptr_;     // address of recv buffer on neighbor
+  std::vector<volatile int*> shm_send_ready_, shm_send_data_;  // flags on neighbor
+  std::vector<volatile int*> shm_recv_ready_, shm_recv_data_;  // flags on this rank
+
+  DualArray1D<int> lowp_node_local_;    // 1 for ranks whose data is not single precision
+#endif
 };
 
 //----------------------------------------------------------------------------------------
@@ -159,14 +387,23 @@ class MeshBoundaryValuesCC : public MeshBoundaryValues {
  public:
   MeshBoundaryValuesCC(MeshBlockPack *ppack, ParameterInput *pin, bool z4c);
 
+  // If true, values in ghost zones are added to the active cells of neighbors they
+  // overlap (e.g. for deposits of particles), instead of active cells being copied into
+  // ghost zones of neighbors.  Only neighbors at the same level are supported.
+  bool sum_mode = false;
+
   //functions
   void InitSendIndices(MeshBoundaryBuffer &b,int o1,int o2,int o3,int f1,int f2) override;
   void InitRecvIndices(MeshBoundaryBuffer &b,int o1,int o2,int o3,int f1,int f2) override;
   TaskStatus InitFluxRecv(const int nvar) override;
+  void SetDirectionalHalo(const std::vector<int> &flags, const int nkeep);
 
   // functions to communicate CC data
   TaskStatus PackAndSendCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca);
   TaskStatus RecvAndUnpackCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca);
+  // functions to communicate several CC arrays in the same buffers
+  TaskStatus PackAndSendCC(const CCFieldList &flds);
+  TaskStatus RecvAndUnpackCC(const CCFieldList &flds);
   // functions to communicate fluxes of CC data
   TaskStatus PackAndSendFluxCC(DvceFaceFld5D<Real> &flx);
   TaskStatus RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx);
@@ -181,6 +418,17 @@ class MeshBoundaryValuesCC : public MeshBoundaryValues {
                              DvceArray5D<Real> &prim);
   void PrimToConsFineBndry(const DvceArray5D<Real> &prim, const DvceFaceFld4D<Real> &b,
                            DvceArray5D<Real> &cons);
+
+ protected:
+  // descriptor tables of pack/unpack operations, rebuilt when mesh changes
+  DualArray1D<BufferDescriptor> send_desc_, recv_desc_;
+  int ndesc_;         // number of entries in descriptor tables
+  int nregrid_desc_;  // value of Mesh::nregrid when descriptor tables built (or -1)
+  void InitBufferDescriptors();
+  // directional halo: number of flagged variables before each variable (for each
+  // direction of travel), and number of layers not sent for flagged variables
+  DualArray2D<int> dir_vars_;
+  int dir_ndrop_;
 };
 
 //----------------------------------------------------------------------------------------
@@ -219,16 +467,6 @@ struct ParticleLocationData {
   int dest_rank;    // rank of target MeshBlock
 };
 
-// Custom operators to sort ParticleLocationData array by dest_rank or prtcl_indx
-struct {
-  bool operator()(ParticleLocationData a, ParticleLocationData b)
-    const { return a.dest_rank < b.dest_rank; }
-} SortByRank;
-struct {
-  bool operator()(ParticleLocationData a, ParticleLocationData b)
-    const { return a.prtcl_indx < b.prtcl_indx; }
-} SortByIndex;
-
 //----------------------------------------------------------------------------------------
 //! \struct ParticleMessageData
 //! \brief Data describing MPI messages containing particles
@@ -257,14 +495,16 @@ class ParticlesBoundaryValues {
   // Data needed to count number of messages and particles to send between ranks
   int nsends; // number of MPI sends to neighboring ranks on this rank
   int nrecvs; // number of MPI recvs from neighboring ranks on this rank
-  std::vector<int> nsends_eachrank;                // length nranks
+  std::vector<int> nghbr_ranks;   // ranks containing neighbors of MBs on this rank
+  std::vector<int> nsend_nghbr;   // number of particles sent to each neighboring rank
+  std::vector<int> nrecv_nghbr;   // number of particles recv from each neighboring rank
   std::vector<ParticleMessageData> sends_thisrank; // length nsends
   std::vector<ParticleMessageData> recvs_thisrank; // length nrecvs
-  std::vector<ParticleMessageData> sends_allranks; // length ncounts summed over ranks
 
 #if MPI_PARALLEL_ENABLED
   DvceArray1D<Real> prtcl_rsendbuf, prtcl_rrecvbuf;
   DvceArray1D<int>  prtcl_isendbuf, prtcl_irecvbuf;
+  DvceArray1D<int>  prtcl_holes;    // indices of sent particles, sorted
   std::vector<MPI_Request> rrecv_req, rsend_req;  // vectors of requests for Reals
   std::vector<MPI_Request> irecv_req, isend_req;  // vectors of requests for ints
   MPI_Comm mpi_comm_part;                       // unique MPI communicators for particles
@@ -281,6 +521,7 @@ class ParticlesBoundaryValues {
 
  protected:
   particles::Particles* pmy_part;
+  double wait_t0_;  // time at which receives were first found pending (or -1)
 };
 } // namespace particles
 
@@ -0,0 +1,391 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file bvals_agg.cpp
+//! \brief functions to aggregate boundary buffers of Mesh variables that are sent between
+//! the same pair of ranks into a single MPI message.  Generic, so they work for both CC
+//! and FC variables.
+//!
+//! With aggregation, PackAndSendCC/FC() still pack data for neighbors on other ranks into
+//! sendbuf[n].vars(m,...).  All such buffers are then gathered by a single kernel into
+//! one contiguous device buffer, ordered by destination rank, and one message is sent to
+//! each neighboring rank.  On receipt, a single kernel scatters each message back into
+//! recvbuf[n].vars(m,...) using an offset table, after which the usual unpack kernels
+//! in RecvAndUnpackCC/FC() are used.
+//!
+//! With <mesh>/host_staged_mpi (for MPI libraries that cannot access device memory),
+//! messages are sent from and received into pinned host copies of the aggregated
+//! buffers.  Copies are split into chunks of at most staging_chunk values, issued in
+//! turn on two execution space instances, so that each send is posted as soon as its
+//! last chunk reaches the host while the following chunks are still being copied, and
+//! each received message is copied to the device as soon as it arrives.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/memory_registry.hpp"
+#include "bvals.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::InitAggregation
+//! \brief Builds the layout of the aggregated messages sent to and received from each
+//! neighboring rank.  The layout only changes when the grid changes, so it is rebuilt
+//! only after each regrid (tracked by Mesh::nregrid).
+
+void MeshBoundaryValues::InitAggregation(const int nvars) {
+#if MPI_PARALLEL_ENABLED
+  memory_registry::Scope mem_scope("bvals");
+  FreeAggregation();
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+
+  // list all buffers communicated with other ranks
+  std::vector<AggregateEntry> send_list, recv_list;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0) {
+        int drank = nghbr.h_view(m,n).rank;
+        if ((drank != global_variable::my_rank) && !(IsNodeLocal(drank))) {
+          // tags use local ID and buffer index of *receiving* MeshBlock
+          int dn = nghbr.h_view(m,n).dest;
+          int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
+          AggregateEntry sentry = {drank, CreateBvals_MPI_Tag(lid, dn), m, n,
+                                   VarsDataSize(sendbuf[n], m, n, nvars)};
+          AggregateEntry rentry = {drank, CreateBvals_MPI_Tag(m, n), m, n,
+                                   VarsDataSize(recvbuf[n], m, n, nvars)};
+          send_list.push_back(sentry);
+          recv_list.push_back(rentry);
+        }
+      }
+    }
+  }
+
+  // sort by (rank, tag) so sender and receiver agree on layout of each message
+  auto by_rank_tag = [](const AggregateEntry &a, const AggregateEntry &b) {
+    return (a.rank < b.rank) || ((a.rank == b.rank) && (a.tag < b.tag));
+  };
+  std::sort(send_list.begin(), send_list.end(), by_rank_tag);
+  std::sort(recv_list.begin(), recv_list.end(), by_rank_tag);
+
+  // build offset tables of each buffer, and start of each message, in aggregated buffers
+  auto build_tables = [](const std::vector<AggregateEntry> &list, DualArray2D<int> &map,
+                         std::vector<int> &ranks, std::vector<int> &offs) {
+    Kokkos::realloc(map, std::max(static_cast<int>(list.size()), 1), 4);
+    int offset = 0;
+    for (std::size_t i=0; i<list.size(); ++i) {
+      if (ranks.empty() || (list[i].rank != ranks.back())) {
+        ranks.push_back(list[i].rank);
+        offs.push_back(offset);
+      }
+      map.h_view(i,0) = list[i].m;
+      map.h_view(i,1) = list[i].n;
+      map.h_view(i,2) = offset;
+      map.h_view(i,3) = list[i].ndat;
+      offset += list[i].ndat;
+    }
+    offs.push_back(offset);  // total size stored in last element
+    map.template modify<HostMemSpace>();
+    map.template sync<DevExeSpace>();
+  };
+  build_tables(send_list, agg_send_map_, agg_send_rank_, agg_send_off_);
+  build_tables(recv_list, agg_recv_map_, agg_recv_rank_, agg_recv_off_);
+  Kokkos::realloc(agg_sendbuf_, std::max(agg_send_off_.back(), 1));
+  Kokkos::realloc(agg_recvbuf_, std::max(agg_recv_off_.back(), 1));
+  if (host_staged_mpi) {
+    Kokkos::realloc(stg_sendbuf_, std::max(agg_send_off_.back(), 1));
+    Kokkos::realloc(stg_recvbuf_, std::max(agg_recv_off_.back(), 1));
+  }
+
+  // one request per message; create persistent requests if requested
+  int nsend = agg_send_rank_.size();
+  int nrecv = agg_recv_rank_.size();
+  agg_send_req_.assign(nsend, MPI_REQUEST_NULL);
+  agg_recv_req_.assign(nrecv, MPI_REQUEST_NULL);
+  stg_recv_done_.assign(nrecv, 0);
+  if (persistent_mpi) {
+    bool no_errors=true;
+    for (int i=0; i<nsend; ++i) {
+      int ierr = MPI_Send_init(AggSendData() + agg_send_off_[i],
+                               (agg_send_off_[i+1] - agg_send_off_[i]), MPI_ATHENA_REAL,
+                               agg_send_rank_[i], 0, comm_vars, &(agg_send_req_[i]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+    for (int i=0; i<nrecv; ++i) {
+      int ierr = MPI_Recv_init(AggRecvData() + agg_recv_off_[i],
+                               (agg_recv_off_[i+1] - agg_recv_off_[i]), MPI_ATHENA_REAL,
+                               agg_recv_rank_[i], 0, comm_vars, &(agg_recv_req_[i]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+    // Quit if MPI error detected
+    if (!(no_errors)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "MPI error in creating persistent requests" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  nregrid_agg_ = pmy_pack->pmesh->nregrid;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::FreeAggregation
+//! \brief Frees any persistent requests, and clears layout, of aggregated messages
+
+void MeshBoundaryValues::FreeAggregation() {
+#if MPI_PARALLEL_ENABLED
+  if (nregrid_agg_ < 0) return;
+  for (auto &req : agg_send_req_) {
+    if (req != MPI_REQUEST_NULL) {MPI_Request_free(&req);}
+  }
+  for (auto &req : agg_recv_req_) {
+    if (req != MPI_REQUEST_NULL) {MPI_Request_free(&req);}
+  }
+  agg_send_req_.clear();
+  agg_recv_req_.clear();
+  agg_send_rank_.clear();
+  agg_recv_rank_.clear();
+  agg_send_off_.clear();
+  agg_recv_off_.clear();
+  stg_recv_done_.clear();
+  nregrid_agg_ = -1;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::InitAggregateRecv
+//! \brief Posts (or starts) one non-blocking receive from each neighboring rank.  Called
+//! from InitRecv() in place of posting a receive for each buffer.
+
+TaskStatus MeshBoundaryValues::InitAggregateRecv(const int nvars) {
+#if MPI_PARALLEL_ENABLED
+  if (nregrid_agg_ != pmy_pack->pmesh->nregrid) {InitAggregation(nvars);}
+
+  bool no_errors=true;
+  int nrecv = agg_recv_rank_.size();
+  stg_recv_done_.assign(nrecv, 0);
+  if (persistent_mpi) {
+    if (nrecv > 0) {
+      int ierr = MPI_Startall(nrecv, agg_recv_req_.data());
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+  } else {
+    for (int i=0; i<nrecv; ++i) {
+      int ierr = MPI_Irecv(AggRecvData() + agg_recv_off_[i],
+                           (agg_recv_off_[i+1] - agg_recv_off_[i]), MPI_ATHENA_REAL,
+                           agg_recv_rank_[i], 0, comm_vars, &(agg_recv_req_[i]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in posting aggregated receives" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::PackAndSendAggregate
+//! \brief Gathers all send buffers for MeshBlocks on other ranks into contiguous buffer,
+//! and sends one message to each neighboring rank.  Called from PackAndSendCC/FC() after
+//! the send buffers have been packed.
+
+TaskStatus MeshBoundaryValues::PackAndSendAggregate() {
+#if MPI_PARALLEL_ENABLED
+  int nbuf = agg_send_off_.size() > 1 ? agg_send_map_.extent_int(0) : 0;
+  if (nbuf > 0) {
+    auto &sbuf = sendbuf;
+    auto &map = agg_send_map_;
+    auto &abuf = agg_sendbuf_;
+    Kokkos::TeamPolicy<> policy(DevExeSpace(), nbuf, Kokkos::AUTO);
+    Kokkos::parallel_for("AggSendBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+      const int p = tmember.league_rank();
+      const int m = map.d_view(p,0);
+      const int n = map.d_view(p,1);
+      const int off = map.d_view(p,2);
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, map.d_view(p,3)),
+      [&](const int i) {
+        abuf(off + i) = sbuf[n].vars(m,i);
+      });
+    });
+    DevExeSpace().fence();
+  }
+
+  bool no_errors=true;
+  int nsend = agg_send_rank_.size();
+  auto post_send = [&](const int i) {
+    int ierr;
+    if (persistent_mpi) {
+      ierr = MPI_Start(&(agg_send_req_[i]));
+    } else {
+      ierr = MPI_Isend(AggSendData() + agg_send_off_[i],
+                       (agg_send_off_[i+1] - agg_send_off_[i]), MPI_ATHENA_REAL,
+                       agg_send_rank_[i], 0, comm_vars, &(agg_send_req_[i]));
+    }
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+  };
+  if (host_staged_mpi) {
+    // Copy chunks to host in turn on each instance.  Before an instance is reused, it is
+    // fenced; since chunks are fenced in the order issued, all data up to the end of
+    // that chunk is then on the host, and sends of all completed messages are posted.
+    int nslot = stg_exec_.size();
+    std::vector<int> slot_end(nslot, -1);   // end of chunk pending on each instance
+    int islot = 0, nposted = 0;
+    auto retire = [&](const int s) {
+      if (slot_end[s] < 0) {return;}
+      stg_exec_[s].fence();
+      while ((nposted < nsend) && (agg_send_off_[nposted+1] <= slot_end[s])) {
+        post_send(nposted++);
+      }
+      slot_end[s] = -1;
+    };
+    for (int c=0; c<agg_send_off_[nsend]; c+=staging_chunk) {
+      int cend = std::min(c + staging_chunk, agg_send_off_[nsend]);
+      retire(islot);
+      auto range = std::make_pair(c, cend);
+      Kokkos::deep_copy(stg_exec_[islot], Kokkos::subview(stg_sendbuf_, range),
+                        Kokkos::subview(agg_sendbuf_, range));
+      slot_end[islot] = cend;
+      islot = (islot + 1) % nslot;
+    }
+    for (int s=0; s<nslot; ++s) {retire((islot + s) % nslot);}
+  } else if (persistent_mpi) {
+    if (nsend > 0) {
+      int ierr = MPI_Startall(nsend, agg_send_req_.data());
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+    }
+  } else {
+    for (int i=0; i<nsend; ++i) {post_send(i);}
+  }
+  if (nsend > 0) {
+    comm_stats::AddSend(vars_stat_, nsend, agg_send_off_[nsend]*sizeof(Real));
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in posting aggregated sends" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::RecvAndUnpackAggregate
+//! \brief Tests whether all aggregated messages have been received, and if so scatters
+//! them into the recv buffers of each MeshBlock.  Called from RecvAndUnpackCC/FC() before
+//! the recv buffers are unpacked.
+
+TaskStatus MeshBoundaryValues::RecvAndUnpackAggregate() {
+#if MPI_PARALLEL_ENABLED
+  int nrecv = agg_recv_rank_.size();
+  if (nrecv == 0) {return TaskStatus::complete;}
+
+  int test;
+  int ierr = MPI_SUCCESS;
+  if (host_staged_mpi) {
+    // copy each message to device in chunks as soon as it has arrived, while waiting for
+    // the remaining messages
+    test = 1;
+    int nslot = stg_exec_.size();
+    int islot = 0;
+    for (int i=0; i<nrecv; ++i) {
+      if (stg_recv_done_[i]) {continue;}
+      int flag;
+      ierr = MPI_Test(&(agg_recv_req_[i]), &flag, MPI_STATUS_IGNORE);
+      if (ierr != MPI_SUCCESS) {break;}
+      if (!(static_cast<bool>(flag))) {
+        test = 0;
+        continue;
+      }
+      for (int c=agg_recv_off_[i]; c<agg_recv_off_[i+1]; c+=staging_chunk) {
+        auto range = std::make_pair(c, std::min(c + staging_chunk, agg_recv_off_[i+1]));
+        Kokkos::deep_copy(stg_exec_[islot], Kokkos::subview(agg_recvbuf_, range),
+                          Kokkos::subview(stg_recvbuf_, range));
+        islot = (islot + 1) % nslot;
+      }
+      stg_recv_done_[i] = 1;
+    }
+  } else {
+    ierr = MPI_Testall(nrecv, agg_recv_req_.data(), &test, MPI_STATUSES_IGNORE);
+  }
+  if (ierr != MPI_SUCCESS) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in testing aggregated receives" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (!(static_cast<bool>(test))) {return TaskStatus::incomplete;}
+  if (host_staged_mpi) {
+    // wait for copies of all messages to device before scattering them
+    for (auto &exec : stg_exec_) {exec.fence();}
+  }
+
+  auto &rbuf = recvbuf;
+  auto &map = agg_recv_map_;
+  auto &abuf = agg_recvbuf_;
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), map.extent_int(0), Kokkos::AUTO);
+  Kokkos::parallel_for("AggRecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int p = tmember.league_rank();
+    const int m = map.d_view(p,0);
+    const int n = map.d_view(p,1);
+    const int off = map.d_view(p,2);
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, map.d_view(p,3)),
+    [&](const int i) {
+      rbuf[n].vars(m,i) = abuf(off + i);
+    });
+  });
+#endif
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::ClearAggregateRecv
+//! \brief Waits for all aggregated receives to complete
+
+TaskStatus MeshBoundaryValues::ClearAggregateRecv() {
+#if MPI_PARALLEL_ENABLED
+  int nrecv = agg_recv_req_.size();
+  if (nrecv > 0) {
+    int ierr = MPI_Waitall(nrecv, agg_recv_req_.data(), MPI_STATUSES_IGNORE);
+    if (ierr != MPI_SUCCESS) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "MPI error in clearing aggregated receives" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+#endif
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::ClearAggregateSend
+//! \brief Waits for all aggregated sends to complete
+
+TaskStatus MeshBoundaryValues::ClearAggregateSend() {
+#if MPI_PARALLEL_ENABLED
+  int nsend = agg_send_req_.size();
+  if (nsend > 0) {
+    int ierr = MPI_Waitall(nsend, agg_send_req_.data(), MPI_STATUSES_IGNORE);
+    if (ierr != MPI_SUCCESS) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "MPI error in clearing aggregated sends" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+#endif
+  return TaskStatus::complete;
+}
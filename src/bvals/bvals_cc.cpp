@@ -8,13 +8,16 @@
 //! Mesh variables.
 //! Prolongation of CC variables  occurs in ProlongateCC() function called from task list
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "parameter_input.hpp"
+#include "mesh/nghbr_index.hpp"
 #include "mesh/mesh.hpp"
 #include "bvals.hpp"
 
@@ -23,7 +26,172 @@
 
 MeshBoundaryValuesCC::MeshBoundaryValuesCC(MeshBlockPack *pp, ParameterInput *pin,
                                            bool z4c) :
-  MeshBoundaryValues(pp, pin, z4c) {
+  MeshBoundaryValues(pp, pin, z4c),
+  send_desc_("send_desc",1),
+  recv_desc_("recv_desc",1),
+  ndesc_(0),
+  nregrid_desc_(-1),
+  dir_vars_("dir_vars",1,1),
+  dir_ndrop_(0) {
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int FaceTravelDirection()
+//! \brief Returns direction (0,1,...,5 = +x1,-x1,...,-x3) in which data in send buffer n
+//! travel if n is a same-level face buffer, or -1 for edges and corners.  Data in recv
+//! buffer n travel in the opposite direction.
+
+namespace {
+int FaceTravelDirection(const int n) {
+  for (int d=0; d<3; ++d) {
+    if (n == NeighborIndex((d == 0), (d == 1), (d == 2), 0, 0)) {return 2*d;}
+    if (n == NeighborIndex(-(d == 0), -(d == 1), -(d == 2), 0, 0)) {return 2*d + 1;}
+  }
+  return -1;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesCC::SetDirectionalHalo()
+//! \brief Enables a directional halo, in which variables only read on one side of each
+//! face by the stencils of the physics (e.g. radiation intensities, which are upwinded
+//! along their direction) are sent with fewer layers of ghost zones across same-level
+//! faces.  flags[t*nvar + v] is 1 if variable v only needs the nkeep layers closest to
+//! the face when data travel in direction t (0,1,...,5 = +x1,-x1,...,-x3), and must be
+//! the same on all ranks.  Edges and corners, neighbors at other levels, and Z4c/sum
+//! mode buffers are unchanged.  Must be called after InitializeBuffers().
+
+void MeshBoundaryValuesCC::SetDirectionalHalo(const std::vector<int> &flags,
+                                              const int nkeep) {
+  if (pmy_pack->pmesh->multilevel || is_z4c_ || sum_mode) {return;}
+  int ndrop = halo_depth - std::max(nkeep, 0);
+  if (ndrop <= 0) {return;}
+  int nvar = static_cast<int>(flags.size())/6;
+
+  Kokkos::realloc(dir_vars_, 6, nvar+1);
+  int nflag[6];
+  for (int t=0; t<6; ++t) {
+    dir_vars_.h_view(t,0) = 0;
+    for (int v=0; v<nvar; ++v) {
+      dir_vars_.h_view(t,v+1) = dir_vars_.h_view(t,v) + ((flags[t*nvar + v] != 0)? 1 : 0);
+    }
+    nflag[t] = dir_vars_.h_view(t,nvar);
+  }
+  dir_vars_.template modify<HostMemSpace>();
+  dir_vars_.template sync<DevExeSpace>();
+  dir_ndrop_ = ndrop;
+
+  // same-level buffers have halo_depth layers normal to face
+  for (int n=0; n<56; ++n) {
+    int t = FaceTravelDirection(n);
+    if (t < 0) continue;
+    sendbuf[n].isame_nskip = nflag[t]*ndrop*(sendbuf[n].isame_ndat/halo_depth);
+    recvbuf[n].isame_nskip = nflag[t^1]*ndrop*(recvbuf[n].isame_ndat/halo_depth);
+  }
+  nregrid_desc_ = -1;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesCC::InitBufferDescriptors()
+//! \brief Builds tables describing every buffer to be packed and unpacked, containing
+//! only buffers with neighbors.  Level of the neighbor determines which indices are used
+//! and whether data come from the coarsened array, so this is done once here rather than
+//! in every team of the pack/unpack kernels.  Called whenever Mesh::nregrid changes.
+
+void MeshBoundaryValuesCC::InitBufferDescriptors() {
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int my_rank = global_variable::my_rank;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mblev = pmy_pack->pmb->mb_lev;
+  int mbgid0 = pmy_pack->pmb->mb_gid.h_view(0);
+
+  int ndesc = 0;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0) {ndesc++;}
+    }
+  }
+  // tables only grow, so device storage is reused across regrids
+  if (send_desc_.extent_int(0) < ndesc) {
+    Kokkos::realloc(send_desc_, ndesc);
+    Kokkos::realloc(recv_desc_, ndesc);
+  }
+
+  int idesc = 0;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid < 0) continue;
+      // coarser/same/finer level neighbor uses coar/same/fine indices
+      MeshBufferIndcs sidx, ridx;
+      if (sum_mode && nghbr.h_view(m,n).lev != mblev.h_view(m)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Summing ghost zones into neighbors is only "
+                  << "supported for neighbors at the same level" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (nghbr.h_view(m,n).lev < mblev.h_view(m)) {
+        sidx = sendbuf[n].icoar[0];
+        ridx = recvbuf[n].icoar[0];
+      } else if (nghbr.h_view(m,n).lev == mblev.h_view(m)) {
+        sidx = sendbuf[n].isame[0];
+        ridx = recvbuf[n].isame[0];
+      } else {
+        sidx = sendbuf[n].ifine[0];
+        ridx = recvbuf[n].ifine[0];
+      }
+      // in sum mode, ghost zones are sent and added into active cells normally sent
+      if (sum_mode) {std::swap(sidx, ridx);}
+      int coarse = (nghbr.h_view(m,n).lev < mblev.h_view(m)) ? 1 : 0;
+      int local = (nghbr.h_view(m,n).rank == my_rank) ? 1 : 0;
+      // direction of travel of data in same-level face buffers with directional halo
+      int dir = -1;
+      if ((dir_ndrop_ > 0) && (nghbr.h_view(m,n).lev == mblev.h_view(m))) {
+        dir = FaceTravelDirection(n);
+      }
+
+      BufferDescriptor &sd = send_desc_.h_view(idesc);
+      sd.m = m;
+      sd.n = n;
+      sd.il = sidx.bis;
+      sd.jl = sidx.bjs;
+      sd.kl = sidx.bks;
+      sd.ni = sidx.bie - sidx.bis + 1;
+      sd.nj = sidx.bje - sidx.bjs + 1;
+      sd.nk = sidx.bke - sidx.bks + 1;
+      sd.coarse = coarse;
+      sd.local = local;
+      sd.dir = dir;
+      // MB IDs are stored sequentially in MeshBlockPacks, so index of destination MB on
+      // this rank equals (target_id - first_id).  Otherwise data go into send buffer.
+      sd.dm = (local == 1) ? (nghbr.h_view(m,n).gid - mbgid0) : m;
+      sd.dn = (local == 1) ? nghbr.h_view(m,n).dest : n;
+
+      BufferDescriptor &rd = recv_desc_.h_view(idesc);
+      rd.m = m;
+      rd.n = n;
+      rd.il = ridx.bis;
+      rd.jl = ridx.bjs;
+      rd.kl = ridx.bks;
+      rd.ni = ridx.bie - ridx.bis + 1;
+      rd.nj = ridx.bje - ridx.bjs + 1;
+      rd.nk = ridx.bke - ridx.bks + 1;
+      rd.coarse = coarse;
+      rd.local = local;
+      rd.dir = (dir < 0)? -1 : (dir ^ 1);
+      rd.dm = m;
+      rd.dn = n;
+      idesc++;
+    }
+  }
+  send_desc_.template modify<HostMemSpace>();
+  send_desc_.template sync<DevExeSpace>();
+  recv_desc_.template modify<HostMemSpace>();
+  recv_desc_.template sync<DevExeSpace>();
+  ndesc_ = ndesc;
+  nregrid_desc_ = pmy_pack->pmesh->nregrid;
+  return;
 }
 
 //----------------------------------------------------------------------------------------
@@ -40,10 +208,22 @@ MeshBoundaryValuesCC::MeshBoundaryValuesCC(MeshBlockPack *pp, ParameterInput *pi
 
 TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
                                                DvceArray5D<Real> &ca) {
+  CCFieldList flds;
+  flds.Add(a, ca);
+  return PackAndSendCC(flds);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBoundaryValuesCC::PackAndSendCC()
+//! \brief Pack all cell-centered arrays in list into the same boundary buffers and send
+//! to neighbors, so that one kernel and one message per neighbor is used for all arrays.
+//! Buffers must be initialized with total number of variables in list.
+
+TaskStatus MeshBoundaryValuesCC::PackAndSendCC(const CCFieldList &flds) {
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
-  int nvar = a.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
+  int nvar = flds.nvar();
 
   {int my_rank = global_variable::my_rank;
   auto &nghbr = pmy_pack->pmb->nghbr;
@@ -53,105 +233,56 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
   auto &rbuf = recvbuf;
   auto &is_z4c = is_z4c_;
   auto &multilevel = pmy_pack->pmesh->multilevel;
-  // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
-  int nmnv = nmb*nnghbr*nvar;
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), nmnv, Kokkos::AUTO);
-  Kokkos::parallel_for("SendBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr*nvar);
-    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
-
-    // only load buffers when neighbor exists
-    if (nghbr.d_view(m,n).gid >= 0) {
-      // if neighbor is at coarser level, use coar indices to pack buffer
-      int il, iu, jl, ju, kl, ku;
-      if (nghbr.d_view(m,n).lev < mblev.d_view(m)) {
-        il = sbuf[n].icoar[0].bis;
-        iu = sbuf[n].icoar[0].bie;
-        jl = sbuf[n].icoar[0].bjs;
-        ju = sbuf[n].icoar[0].bje;
-        kl = sbuf[n].icoar[0].bks;
-        ku = sbuf[n].icoar[0].bke;
-      // if neighbor is at same level, use same indices to pack buffer
-      } else if (nghbr.d_view(m,n).lev == mblev.d_view(m)) {
-        il = sbuf[n].isame[0].bis;
-        iu = sbuf[n].isame[0].bie;
-        jl = sbuf[n].isame[0].bjs;
-        ju = sbuf[n].isame[0].bje;
-        kl = sbuf[n].isame[0].bks;
-        ku = sbuf[n].isame[0].bke;
-      // if neighbor is at finer level, use fine indices to pack buffer
-      } else {
-        il = sbuf[n].ifine[0].bis;
-        iu = sbuf[n].ifine[0].bie;
-        jl = sbuf[n].ifine[0].bjs;
-        ju = sbuf[n].ifine[0].bje;
-        kl = sbuf[n].ifine[0].bks;
-        ku = sbuf[n].ifine[0].bke;
-      }
-      int ni = iu - il + 1;
-      int nj = ju - jl + 1;
-      int nk = ku - kl + 1;
-      int nkj  = nk*nj;
-
-      // indices of recv'ing (destination) MB and buffer: MB IDs are stored sequentially
-      // in MeshBlockPacks, so array index equals (target_id - first_id)
-      int dm = nghbr.d_view(m,n).gid - mbgid.d_view(0);
-      int dn = nghbr.d_view(m,n).dest;
-
-      // Middle loop over k,j
-      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
-        int k = idx / nj;
-        int j = (idx - k * nj) + jl;
-        k += kl;
-
-        // Inner (vector) loop over i
-        // copy directly into recv buffer if MeshBlocks on same rank
-
-        if (nghbr.d_view(m,n).rank == my_rank) {
-          // if neighbor is at same or finer level, load data from u0
-          if (nghbr.d_view(m,n).lev >= mblev.d_view(m)) {
-            Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
-            [&](const int i) {
-              rbuf[dn].vars(dm, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) = a(m,v,k,j,i);
-            });
-            tmember.team_barrier();
-          // if neighbor is at coarser level, load data from coarse_u0
-          } else {
-            Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
-            [&](const int i) {
-              rbuf[dn].vars(dm, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) = ca(m,v,k,j,i);
-            });
-            tmember.team_barrier();
-          }
-
-        // else copy into send buffer for MPI communication below
-
-        } else {
-          // if neighbor is at same or finer level, load data from u0
-          if (nghbr.d_view(m,n).lev >= mblev.d_view(m)) {
-            Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
-            [&](const int i) {
-              sbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) = a(m,v,k,j,i);
-            });
-            tmember.team_barrier();
-          // if neighbor is at coarser level, load data from coarse_u0
-          } else {
-            Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
-            [&](const int i) {
-              sbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) = ca(m,v,k,j,i);
-            });
-            tmember.team_barrier();
-          }
-        }
+  // rebuild descriptor tables of buffers to be packed after mesh changes
+  if (nregrid_desc_ != pmy_pack->pmesh->nregrid) {InitBufferDescriptors();}
+  auto &desc = send_desc_;
+  int ndesc = ndesc_;
+  auto &dvar = dir_vars_;
+  int ndrop = dir_ndrop_;
+
+  // Outer loop over (# of buffers with neighbors)*(# of variables)
+  if (ndesc*nvar > 0) {
+  Kokkos::TeamPolicy<> dpolicy(DevExeSpace(), (ndesc*nvar), Kokkos::AUTO);
+  Kokkos::parallel_for("SendBuff", dpolicy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int e = (tmember.league_rank())/nvar;
+    const int v = (tmember.league_rank()) - e*nvar;
+    // array in list containing variable v, and index of v within it
+    const int f = flds.Field(v);
+    const int vf = v - flds.voff[f];
+    BufferDescriptor d = desc.d_view(e);
+    const int voff = DirectionalLayout(d, v, ndrop, dvar.d_view);
+    // load data from coarse array if neighbor is at coarser level, and copy directly
+    // into recv buffer if MeshBlocks on same rank (else into send buffer for MPI)
+    const DvceArray5D<Real> &src = (d.coarse == 1) ? flds.ca[f] : flds.a[f];
+    const DvceArray2D<Real> &dst = (d.local == 1) ? rbuf[d.dn].vars : sbuf[d.dn].vars;
+
+    // Middle loop over k,j
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, (d.nk*d.nj)),
+    [&](const int idx) {
+      const int k = idx / d.nj;
+      const int j = idx - k*d.nj;
+      const int boff = voff + d.ni*(j + d.nj*k);
+      // Inner (vector) loop over i
+      Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,d.ni), [&](const int i) {
+        dst(d.dm, boff + i) = src(d.m, vf, d.kl + k, d.jl + j, d.il + i);
       });
-    } // end if-neighbor-exists block
+    });
   }); // end par_for_outer
+  }
 
+  // With Z4c and SMR/AMR, coarse data is also sent to neighbors at same level
+  if (is_z4c && multilevel) {
+  // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
   Kokkos::parallel_for("SendBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int m = (tmember.league_rank())/(nnghbr*nvar);
     const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
     const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+    // array in list containing variable v, and index of v within it
+    const int f = flds.Field(v);
+    const int vf = v - flds.voff[f];
+    auto &af = flds.a[f];
+    auto &caf = flds.ca[f];
 
     // only load buffers when neighbor exists
     if (nghbr.d_view(m,n).gid >= 0) {
@@ -188,7 +319,8 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
             // load data from coarse_u0
             Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
             [&](const int i) {
-              rbuf[dn].vars(dm,ndat+ (i-il + ni*(j-jl + nj*(k-kl + nk*v))))=ca(m,v,k,j,i);
+              rbuf[dn].vars(dm,ndat+ (i-il + ni*(j-jl + nj*(k-kl + nk*v)))) =
+                caf(m,vf,k,j,i);
             });
             tmember.team_barrier();
 
@@ -197,7 +329,8 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
             // load data from coarse_u0
             Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
             [&](const int i) {
-              sbuf[n].vars(m,ndat+ (i-il + ni*(j-jl + nj*(k-kl + nk*v))) )=ca(m,v,k,j,i);
+              sbuf[n].vars(m,ndat+ (i-il + ni*(j-jl + nj*(k-kl + nk*v))) ) =
+                caf(m,vf,k,j,i);
             });
             tmember.team_barrier();
           }
@@ -206,11 +339,15 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
     } // end if-neighbor-exists block
   }); // end par_for_outer
   }
+  }
 
 #if MPI_PARALLEL_ENABLED
   // Send boundary buffer to neighboring MeshBlocks using MPI
-  Kokkos::fence();
-  auto &is_z4c = is_z4c_;
+  DevExeSpace().fence();
+  if (shm_halo) {ShmSend();}
+  if (lowp_vars) {PackLowPrecision(nvar);}
+  if (aggregate_mpi) {return PackAndSendAggregate();}
+  if (persistent_mpi) {return StartPersistentSends();}
   int my_rank = global_variable::my_rank;
   auto &nghbr = pmy_pack->pmb->nghbr;
   bool no_errors=true;
@@ -220,29 +357,21 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
         // index and rank of destination Neighbor
         int dn = nghbr.h_view(m,n).dest;
         int drank = nghbr.h_view(m,n).rank;
-        if (drank != my_rank) {
+        if ((drank != my_rank) && !(IsNodeLocal(drank))) {
           // create tag using local ID and buffer index of *receiving* MeshBlock
           int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
           int tag = CreateBvals_MPI_Tag(lid, dn);
 
           // get ptr to send buffer when neighbor is at coarser/same/fine level
-          int data_size = nvar;
-          if ( nghbr.h_view(m,n).lev < pmy_pack->pmb->mb_lev.h_view(m) ) {
-            data_size *= sendbuf[n].icoar_ndat;
-          } else if ( nghbr.h_view(m,n).lev == pmy_pack->pmb->mb_lev.h_view(m) ) {
-            if (is_z4c) {
-              data_size *= sendbuf[n].isame_z4c_ndat;
-            } else {
-              data_size *= sendbuf[n].isame_ndat;
-            }
-          } else {
-            data_size *= sendbuf[n].ifine_ndat;
-          }
-          auto send_ptr = Kokkos::subview(sendbuf[n].vars, m, Kokkos::ALL);
+          int data_size = VarsDataSize(sendbuf[n], m, n, nvar);
+          void *send_ptr = sendbuf[n].MPIVarsPtr(m, lowp_vars);
+          MPI_Datatype dtype = lowp_vars ? MPI_FLOAT : MPI_ATHENA_REAL;
 
-          int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+          int ierr = MPI_Isend(send_ptr, data_size, dtype, drank, tag,
                                comm_vars, &(sendbuf[n].vars_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          comm_stats::AddSend(vars_stat_, 1,
+                              data_size*(lowp_vars? sizeof(float) : sizeof(Real)));
         }
       }
     }
@@ -263,6 +392,16 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendCC(DvceArray5D<Real> &a,
 
 TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
                                                  DvceArray5D<Real> &ca) {
+  CCFieldList flds;
+  flds.Add(a, ca);
+  return RecvAndUnpackCC(flds);
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn void RecvBuffers()
+// \brief Unpack boundary buffers containing all cell-centered arrays in list
+
+TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(const CCFieldList &flds) {
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
@@ -273,6 +412,21 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
 #if MPI_PARALLEL_ENABLED
   //----- STEP 1: check that recv boundary buffer communications have all completed
 
+  // Buffers from neighbors on same node are written directly into recv buffers
+  if (shm_halo && !(ShmRecvComplete())) {
+    comm_stats::RecvPending(vars_wait_t0_);
+    return TaskStatus::incomplete;
+  }
+
+  // With aggregation, scatter messages from each rank into recv buffers once all have
+  // completed.  Requests of individual buffers are then all MPI_REQUEST_NULL.
+  if (aggregate_mpi) {
+    if (RecvAndUnpackAggregate() == TaskStatus::incomplete) {
+      comm_stats::RecvPending(vars_wait_t0_);
+      return TaskStatus::incomplete;
+    }
+  }
+
   bool bflag = false;
   bool no_errors=true;
   for (int m=0; m<nmb; ++m) {
@@ -297,85 +451,75 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
     std::exit(EXIT_FAILURE);
   }
   // exit if recv boundary buffer communications have not completed
-  if (bflag) {return TaskStatus::incomplete;}
+  if (bflag) {
+    comm_stats::RecvPending(vars_wait_t0_);
+    return TaskStatus::incomplete;
+  }
+  comm_stats::RecvComplete(vars_stat_, vars_wait_t0_);
+  if (lowp_vars) {UnpackLowPrecision(flds.nvar());}
 #endif
 
   //----- STEP 2: buffers have all completed, so unpack
 
-  int nvar = a.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
+  int nvar = flds.nvar();
   auto &mblev = pmy_pack->pmb->mb_lev;
 
-  // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
-  Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr*nvar);
-    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
-
-    // only unpack buffers when neighbor exists
-    if (nghbr.d_view(m,n).gid >= 0) {
-      int il, iu, jl, ju, kl, ku;
-      // if neighbor is at coarser level, use coar indices to unpack buffer
-      if (nghbr.d_view(m,n).lev < mblev.d_view(m)) {
-        il = rbuf[n].icoar[0].bis;
-        iu = rbuf[n].icoar[0].bie;
-        jl = rbuf[n].icoar[0].bjs;
-        ju = rbuf[n].icoar[0].bje;
-        kl = rbuf[n].icoar[0].bks;
-        ku = rbuf[n].icoar[0].bke;
-      // if neighbor is at same level, use same indices to unpack buffer
-      } else if (nghbr.d_view(m,n).lev == mblev.d_view(m)) {
-        il = rbuf[n].isame[0].bis;
-        iu = rbuf[n].isame[0].bie;
-        jl = rbuf[n].isame[0].bjs;
-        ju = rbuf[n].isame[0].bje;
-        kl = rbuf[n].isame[0].bks;
-        ku = rbuf[n].isame[0].bke;
-      // if neighbor is at finer level, use fine indices to unpack buffer
-      } else {
-        il = rbuf[n].ifine[0].bis;
-        iu = rbuf[n].ifine[0].bie;
-        jl = rbuf[n].ifine[0].bjs;
-        ju = rbuf[n].ifine[0].bje;
-        kl = rbuf[n].ifine[0].bks;
-        ku = rbuf[n].ifine[0].bke;
-      }
-      int ni = iu - il + 1;
-      int nj = ju - jl + 1;
-      int nk = ku - kl + 1;
-      int nkj  = nk*nj;
-
-      // Middle loop over k,j
-      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nkj), [&](const int idx) {
-        int k = idx / nj;
-        int j = (idx - k * nj) + jl;
-        k += kl;
-
-        // if neighbor is at same or finer level, load data directly into u0
-        if (nghbr.d_view(m,n).lev >= mblev.d_view(m)) {
-          Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
-          [&](const int i) {
-            a(m,v,k,j,i) = rbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) );
-          });
-          tmember.team_barrier();
-
-        // if neighbor is at coarser level, load data into coarse_u0
+  // rebuild descriptor tables of buffers to be unpacked after mesh changes
+  if (nregrid_desc_ != pmy_pack->pmesh->nregrid) {InitBufferDescriptors();}
+  auto &desc = recv_desc_;
+  int ndesc = ndesc_;
+  const bool sum = sum_mode;
+  auto &dvar = dir_vars_;
+  int ndrop = dir_ndrop_;
+
+  // Outer loop over (# of buffers with neighbors)*(# of variables)
+  if (ndesc*nvar > 0) {
+  Kokkos::TeamPolicy<> dpolicy(DevExeSpace(), (ndesc*nvar), Kokkos::AUTO);
+  Kokkos::parallel_for("RecvBuff", dpolicy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int e = (tmember.league_rank())/nvar;
+    const int v = (tmember.league_rank()) - e*nvar;
+    // array in list containing variable v, and index of v within it
+    const int f = flds.Field(v);
+    const int vf = v - flds.voff[f];
+    BufferDescriptor d = desc.d_view(e);
+    const int voff = DirectionalLayout(d, v, ndrop, dvar.d_view);
+    // if neighbor is at coarser level, load data into coarse array
+    const DvceArray5D<Real> &dst = (d.coarse == 1) ? flds.ca[f] : flds.a[f];
+    const DvceArray2D<Real> &src = rbuf[d.n].vars;
+
+    // Middle loop over k,j
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, (d.nk*d.nj)),
+    [&](const int idx) {
+      const int k = idx / d.nj;
+      const int j = idx - k*d.nj;
+      const int boff = voff + d.ni*(j + d.nj*k);
+      // Inner (vector) loop over i
+      Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,d.ni), [&](const int i) {
+        if (sum) {
+          // buffers of different neighbors can overlap at edges and corners
+          Kokkos::atomic_add(&dst(d.m, vf, d.kl + k, d.jl + j, d.il + i),
+                             src(d.m, boff + i));
         } else {
-          Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
-          [&](const int i) {
-            ca(m,v,k,j,i) = rbuf[n].vars(m, (i-il + ni*(j-jl + nj*(k-kl + nk*v))) );
-          });
-          tmember.team_barrier();
+          dst(d.m, vf, d.kl + k, d.jl + j, d.il + i) = src(d.m, boff + i);
         }
       });
-    }  // end if-neighbor-exists block
+    });
   });  // end par_for_outer
+  }
 
+  // With Z4c and SMR/AMR, coarse data is also sent to neighbors at same level
+  if (is_z4c && multilevel) {
   // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
   Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
     const int m = (tmember.league_rank())/(nnghbr*nvar);
     const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
     const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+    // array in list containing variable v, and index of v within it
+    const int f = flds.Field(v);
+    const int vf = v - flds.voff[f];
+    auto &af = flds.a[f];
+    auto &caf = flds.ca[f];
     // only unpack buffers when neighbor exists
     if (nghbr.d_view(m,n).gid >= 0) {
       int il, iu, jl, ju, kl, ku;
@@ -403,13 +547,15 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
           // load data into coarse_u0
           Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember,il,iu+1),
           [&](const int i) {
-            ca(m,v,k,j,i) = rbuf[n].vars(m,ndat + (i-il + ni*(j-jl + nj*(k-kl + nk*v))) );
+            caf(m,vf,k,j,i) =
+              rbuf[n].vars(m,ndat + (i-il + ni*(j-jl + nj*(k-kl + nk*v))) );
           });
           tmember.team_barrier();
         });
       }
     }  // end if-neighbor-exists block
   });  // end par_for_outer
+  }
 
   return TaskStatus::complete;
 }
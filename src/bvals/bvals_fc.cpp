@@ -24,6 +24,8 @@
 
 MeshBoundaryValuesFC::MeshBoundaryValuesFC(MeshBlockPack *pp, ParameterInput *pin) :
   MeshBoundaryValues(pp, pin, false) {
+  vars_stat_ = comm_stats::vars_fc;
+  flux_stat_ = comm_stats::flux_fc;
 }
 
 //----------------------------------------------------------------------------------------
@@ -188,7 +190,10 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
 
 #if MPI_PARALLEL_ENABLED
   // Send boundary buffer to neighboring MeshBlocks using MPI
-  Kokkos::fence();
+  DevExeSpace().fence();
+  if (shm_halo) {ShmSend();}
+  if (aggregate_mpi) {return PackAndSendAggregate();}
+  if (persistent_mpi) {return StartPersistentSends();}
   int my_rank = global_variable::my_rank;
   auto &nghbr = pmy_pack->pmb->nghbr;
   bool no_errors=true;
@@ -198,7 +203,7 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
         // index and rank of destination Neighbor
         int dn = nghbr.h_view(m,n).dest;
         int drank = nghbr.h_view(m,n).rank;
-        if (drank != my_rank) {
+        if ((drank != my_rank) && !(IsNodeLocal(drank))) {
           // create tag using local ID and buffer index of *receiving* MeshBlock
           int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
           int tag = CreateBvals_MPI_Tag(lid, dn);
@@ -217,6 +222,7 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
           int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
                                comm_vars, &(sendbuf[n].vars_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          comm_stats::AddSend(vars_stat_, 1, data_size*sizeof(Real));
         }
       }
     }
@@ -245,6 +251,21 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b,
 #if MPI_PARALLEL_ENABLED
   //----- STEP 1: check that recv boundary buffer communications have all completed
 
+  // Buffers from neighbors on same node are written directly into recv buffers
+  if (shm_halo && !(ShmRecvComplete())) {
+    comm_stats::RecvPending(vars_wait_t0_);
+    return TaskStatus::incomplete;
+  }
+
+  // With aggregation, scatter messages from each rank into recv buffers once all have
+  // completed.  Requests of individual buffers are then all MPI_REQUEST_NULL.
+  if (aggregate_mpi) {
+    if (RecvAndUnpackAggregate() == TaskStatus::incomplete) {
+      comm_stats::RecvPending(vars_wait_t0_);
+      return TaskStatus::incomplete;
+    }
+  }
+
   bool bflag = false;
   bool no_errors=true;
   for (int m=0; m<nmb; ++m) {
@@ -269,7 +290,11 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b,
     std::exit(EXIT_FAILURE);
   }
   // exit if recv boundary buffer communications have not completed
-  if (bflag) {return TaskStatus::incomplete;}
+  if (bflag) {
+    comm_stats::RecvPending(vars_wait_t0_);
+    return TaskStatus::incomplete;
+  }
+  comm_stats::RecvComplete(vars_stat_, vars_wait_t0_);
 #endif
 
   //----- STEP 2: buffers have all completed, so unpack 3-components of field
@@ -0,0 +1,112 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file bvals_lowp.cpp
+//! \brief functions to convert boundary buffers of cell-centered Mesh variables to and
+//! from single precision, so that MPI messages containing ghost zones are half the size
+//! when Real is double.  Enabled for each physics module with the lowp_halo parameter.
+//!
+//! Ghost zones are only used in reconstruction stencils, so the loss of precision is
+//! acceptable for many applications.  Fluxes used for flux correction, and face-centered
+//! fields, are always communicated at full precision since conservation and div(B)=0
+//! depend on them.  Data copied between MeshBlocks on the same rank (or node, with
+//! shm_halo) are never converted.
+
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::PackLowPrecision
+//! \brief Converts packed send buffers for MeshBlocks on other ranks to single precision.
+//! Called from PackAndSendCC() after the send buffers are packed, before MPI sends.
+
+void MeshBoundaryValues::PackLowPrecision(const int nvar) {
+#if MPI_PARALLEL_ENABLED
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int my_rank = global_variable::my_rank;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mblev = pmy_pack->pmb->mb_lev;
+  auto &sbuf = sendbuf;
+  auto &is_z4c = is_z4c_;
+
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
+  Kokkos::parallel_for("LowpSendBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int m = (tmember.league_rank())/nnghbr;
+    const int n = (tmember.league_rank()) - m*nnghbr;
+    if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).rank != my_rank)) {
+      int ndat = nvar;
+      if (nghbr.d_view(m,n).lev < mblev.d_view(m)) {
+        ndat *= sbuf[n].icoar_ndat;
+      } else if (nghbr.d_view(m,n).lev == mblev.d_view(m)) {
+        ndat *= (is_z4c)? sbuf[n].isame_z4c_ndat : sbuf[n].isame_ndat;
+      } else {
+        ndat *= sbuf[n].ifine_ndat;
+      }
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, ndat), [&](const int i) {
+        sbuf[n].vars_lowp(m,i) = static_cast<float>(sbuf[n].vars(m,i));
+      });
+    }
+  });
+  DevExeSpace().fence();
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::UnpackLowPrecision
+//! \brief Converts single precision recv buffers for MeshBlocks on other ranks back to
+//! Real.  Called from RecvAndUnpackCC() once all receives have completed.
+
+void MeshBoundaryValues::UnpackLowPrecision(const int nvar) {
+#if MPI_PARALLEL_ENABLED
+  int nmb = pmy_pack->nmb_thispack;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  int my_rank = global_variable::my_rank;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mblev = pmy_pack->pmb->mb_lev;
+  auto &rbuf = recvbuf;
+  auto &is_z4c = is_z4c_;
+  // ranks on same node write directly into recv buffers at full precision, so flag
+  // them to be skipped (built once on first call)
+  auto &node_local = lowp_node_local_;
+  if (node_local.extent_int(0) != global_variable::nranks) {
+    Kokkos::realloc(node_local, global_variable::nranks);
+    for (int r=0; r<global_variable::nranks; ++r) {
+      node_local.h_view(r) = IsNodeLocal(r) ? 1 : 0;
+    }
+    node_local.template modify<HostMemSpace>();
+    node_local.template sync<DevExeSpace>();
+  }
+
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
+  Kokkos::parallel_for("LowpRecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int m = (tmember.league_rank())/nnghbr;
+    const int n = (tmember.league_rank()) - m*nnghbr;
+    if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).rank != my_rank) &&
+        (node_local.d_view(nghbr.d_view(m,n).rank) == 0)) {
+      int ndat = nvar;
+      if (nghbr.d_view(m,n).lev < mblev.d_view(m)) {
+        ndat *= rbuf[n].icoar_ndat;
+      } else if (nghbr.d_view(m,n).lev == mblev.d_view(m)) {
+        ndat *= (is_z4c)? rbuf[n].isame_z4c_ndat : rbuf[n].isame_ndat;
+      } else {
+        ndat *= rbuf[n].ifine_ndat;
+      }
+      Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, ndat), [&](const int i) {
+        rbuf[n].vars(m,i) = static_cast<Real>(rbuf[n].vars_lowp(m,i));
+      });
+    }
+  });
+#endif
+  return;
+}
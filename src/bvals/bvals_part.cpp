@@ -4,7 +4,11 @@
 // Licensed under the 3-clause BSD License, see LICENSE file for details
 //========================================================================================
 //! \file bvals_part.cpp
-//! \brief
+//! \brief functions to communicate particles that move between MeshBlocks on different
+//! ranks.  Lists of particles to send are sorted by destination rank on the device, and
+//! the number of particles exchanged is shared only with ranks that contain neighbors of
+//! MeshBlocks on this rank, so the cost scales with the number of particles sent rather
+//! than with the number of ranks.
 
 #include <cstdlib>
 #include <iostream>
@@ -12,7 +16,6 @@
 #include <vector>
 #include <algorithm>
 #include <Kokkos_Core.hpp>
-#include <Kokkos_StdAlgorithms.hpp>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -60,12 +63,18 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
   auto myrank = global_variable::my_rank;
   auto &nghbr = pmy_part->pmy_pack->pmb->nghbr;
   auto &psendl = sendlist;
-  int counter=0;
-  int *pcounter = &counter;
+  // counter must be in device memory, since it is incremented inside kernel
+  DvceArray1D<int> counter("nsend_counter",1);
+  int *pcounter = counter.data();
   bool &multi_d = pmy_part->pmy_pack->pmesh->multi_d;
   bool &three_d = pmy_part->pmy_pack->pmesh->three_d;
 
-  Kokkos::realloc(sendlist, static_cast<int>(0.1*npart));
+  // Guess that no more than 10% of particles will be communicated to set size of list,
+  // which is only reallocated when it must grow
+  int nsend_max = static_cast<int>(0.1*npart) + 1;
+  if (sendlist.extent_int(0) < nsend_max) {
+    Kokkos::realloc(sendlist, nsend_max);
+  }
   par_for("part_update",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
     int m = pi(PGID,p) - gids;
     int mylevel = mblev.d_view(m);
@@ -170,75 +179,119 @@ TaskStatus ParticlesBoundaryValues::SetNewPrtclGID() {
       }
     }
   });
-  nprtcl_send = counter;
-  Kokkos::resize(sendlist, nprtcl_send);
-  // sync sendlist device array with host
-  sendlist.template modify<DevExeSpace>();
-  sendlist.template sync<HostMemSpace>();
+  auto h_counter = Kokkos::create_mirror_view_and_copy(HostMemSpace(), counter);
+  nprtcl_send = h_counter(0);
 
   return TaskStatus::complete;
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void ParticlesBoundaryValues::CountSendsAndRecvs()
-//! \brief
+//! \brief Sorts sendlist by destination rank on the device, and exchanges the number of
+//! particles to be sent with each neighboring rank.  Since particles only move into
+//! neighboring MeshBlocks, and the neighbor relation is symmetric, the only ranks that
+//! can send particles to this rank are those containing neighbors of its MeshBlocks.
 
 TaskStatus ParticlesBoundaryValues::CountSendsAndRecvs() {
 #if MPI_PARALLEL_ENABLED
-  // Sort sendlist on host by destrank.
-  namespace KE = Kokkos::Experimental;
-  std::sort(KE::begin(sendlist.h_view), KE::end(sendlist.h_view), SortByRank);
-  // sync sendlist host array with device.  This results in sorted array on device
-  sendlist.template modify<HostMemSpace>();
-  sendlist.template sync<DevExeSpace>();
+  // find sorted list of ranks (other than this rank) containing neighbors
+  int &myrank = global_variable::my_rank;
+  int nmb = pmy_part->pmy_pack->nmb_thispack;
+  int nnghbr = pmy_part->pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_part->pmy_pack->pmb->nghbr;
+  nghbr_ranks.clear();
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0 && nghbr.h_view(m,n).rank != myrank) {
+        nghbr_ranks.push_back(nghbr.h_view(m,n).rank);
+      }
+    }
+  }
+  std::sort(nghbr_ranks.begin(), nghbr_ranks.end());
+  nghbr_ranks.erase(std::unique(nghbr_ranks.begin(), nghbr_ranks.end()),
+                    nghbr_ranks.end());
+  int nnr = nghbr_ranks.size();
+  nsend_nghbr.assign(nnr, 0);
+
+  // Counting sort of sendlist on device by destination rank.  Only the number of
+  // particles sent to each neighboring rank is copied to the host.
+  if (nprtcl_send > 0) {
+    DvceArray1D<int> d_ranks("nghbr_ranks", nnr);
+    auto h_ranks = Kokkos::create_mirror_view(d_ranks);
+    for (int r=0; r<nnr; ++r) {h_ranks(r) = nghbr_ranks[r];}
+    Kokkos::deep_copy(d_ranks, h_ranks);
+
+    DvceArray1D<int> d_count("nsend_nghbr", nnr);
+    DvceArray1D<int> d_rindx("rank_indx", nprtcl_send);
+    auto &slist = sendlist;
+    par_for("pcount",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
+      // binary search for index of destination rank in list of neighboring ranks
+      int r = slist.d_view(n).dest_rank;
+      int lo = 0, hi = nnr-1;
+      while (lo < hi) {
+        int mid = (lo + hi)/2;
+        if (d_ranks(mid) < r) {lo = mid + 1;} else {hi = mid;}
+      }
+      d_rindx(n) = lo;
+      Kokkos::atomic_increment(&d_count(lo));
+    });
+    auto h_count = Kokkos::create_mirror_view_and_copy(HostMemSpace(), d_count);
+
+    // offset of first particle sent to each rank, used as cursor in scatter
+    auto h_cursor = Kokkos::create_mirror_view(d_count);
+    int nsum = 0;
+    for (int r=0; r<nnr; ++r) {
+      nsend_nghbr[r] = h_count(r);
+      h_cursor(r) = nsum;
+      nsum += h_count(r);
+    }
+    Kokkos::deep_copy(d_count, h_cursor);
+    DvceArray1D<ParticleLocationData> sorted("sorted_sendlist", nprtcl_send);
+    par_for("psort",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
+      int q = Kokkos::atomic_fetch_add(&d_count(d_rindx(n)), 1);
+      sorted(q) = slist.d_view(n);
+    });
+    Kokkos::deep_copy(Kokkos::subview(sendlist.d_view, std::make_pair(0, nprtcl_send)),
+                      sorted);
+  }
 
   // load STL::vector of ParticleMessageData with <sendrank, recvrank, nprtcls> for sends
-  // from this rank. Length will be nsends; initially this length is unknown
+  // from this rank, in order of destination rank
   sends_thisrank.clear();
-  if (nprtcl_send > 0) {
-    int &myrank = global_variable::my_rank;
-    int rank = sendlist.h_view(0).dest_rank;
-    int nprtcl = 1;
-
-    for (int n=1; n<nprtcl_send; ++n) {
-      if (sendlist.h_view(n).dest_rank == rank) {
-        ++nprtcl;
-      } else {
-        sends_thisrank.emplace_back(ParticleMessageData(myrank,rank,nprtcl));
-        rank = sendlist.h_view(n).dest_rank;
-        nprtcl = 1;
-      }
+  for (int r=0; r<nnr; ++r) {
+    if (nsend_nghbr[r] > 0) {
+      sends_thisrank.emplace_back(ParticleMessageData(myrank,nghbr_ranks[r],
+                                                      nsend_nghbr[r]));
     }
-    sends_thisrank.emplace_back(ParticleMessageData(myrank,rank,nprtcl));
   }
   nsends = sends_thisrank.size();
 
-  // Share number of ranks to send to amongst all ranks
-  nsends_eachrank[global_variable::my_rank] = nsends;
-  MPI_Allgather(&nsends, 1, MPI_INT, nsends_eachrank.data(), 1, MPI_INT, mpi_comm_part);
-
-  // Now share ParticleMessageData amongst all ranks
-  // First create vector of starting indices in full vector
-  std::vector<int> nsends_displ;
-  nsends_displ.resize(global_variable::nranks);
-  nsends_displ[0] = 0;
-  for (int n=1; n<(global_variable::nranks); ++n) {
-    nsends_displ[n] = nsends_displ[n-1] + nsends_eachrank[n-1];
+  // Exchange number of particles sent with each neighboring rank (tag 2, since tags 0
+  // and 1 are used for particle data)
+  nrecv_nghbr.assign(nnr, 0);
+  std::vector<MPI_Request> req(2*nnr, MPI_REQUEST_NULL);
+  bool no_errors=true;
+  for (int r=0; r<nnr; ++r) {
+    int ierr = MPI_Irecv(&(nrecv_nghbr[r]), 1, MPI_INT, nghbr_ranks[r], 2,
+                         mpi_comm_part, &(req[r]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
   }
-  int nsends_allranks = nsends_displ[global_variable::nranks - 1] +
-                        nsends_eachrank[global_variable::nranks - 1];
-  // Load ParticleMessageData on this rank into full vector
-  sends_allranks.resize(nsends_allranks, ParticleMessageData(0,0,0));
-  for (int n=0; n<nsends_eachrank[global_variable::my_rank]; ++n) {
-    sends_allranks[n + nsends_displ[global_variable::my_rank]] = sends_thisrank[n];
+  for (int r=0; r<nnr; ++r) {
+    int ierr = MPI_Isend(&(nsend_nghbr[r]), 1, MPI_INT, nghbr_ranks[r], 2,
+                         mpi_comm_part, &(req[nnr+r]));
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+  }
+  if (nnr > 0) {
+    int ierr = MPI_Waitall(2*nnr, req.data(), MPI_STATUSES_IGNORE);
+    if (ierr != MPI_SUCCESS) {no_errors=false;}
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "MPI error in exchanging number of particles sent"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
   }
-
-  // Share tuples using MPI derived data type for tuple of 3*int
-  MPI_Datatype mpi_ituple;
-  MPI_Type_contiguous(3, MPI_INT, &mpi_ituple);
-  MPI_Allgatherv(MPI_IN_PLACE, nsends_eachrank[global_variable::my_rank],
-                   mpi_ituple, sends_allranks.data(), nsends_eachrank.data(),
-                   nsends_displ.data(), mpi_ituple, mpi_comm_part);
 #endif
   return TaskStatus::complete;
 }
@@ -253,10 +306,11 @@ TaskStatus ParticlesBoundaryValues::InitPrtclRecv() {
   // receives // on this rank. Length will be nrecvs, initially this length is unknown
   recvs_thisrank.clear();
 
-  int nsends_allranks = sends_allranks.size();
-  for (int n=0; n<nsends_allranks; ++n) {
-    if (sends_allranks[n].recvrank == global_variable::my_rank) {
-      recvs_thisrank.emplace_back(sends_allranks[n]);
+  int nnr = nghbr_ranks.size();
+  for (int r=0; r<nnr; ++r) {
+    if (nrecv_nghbr[r] > 0) {
+      recvs_thisrank.emplace_back(ParticleMessageData(nghbr_ranks[r],
+                                  global_variable::my_rank, nrecv_nghbr[r]));
     }
   }
   nrecvs = recvs_thisrank.size();
@@ -360,7 +414,7 @@ TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
     });
 
     // Post non-blocking sends
-    Kokkos::fence();
+    DevExeSpace().fence();
     rsend_req.clear();
     isend_req.clear();
     for (int n=0; n<nsends; ++n) {
@@ -382,6 +436,7 @@ TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
       int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
                            mpi_comm_part, &(rsend_req[n]));
       if (ierr != MPI_SUCCESS) {no_errors=false;}
+      comm_stats::AddSend(comm_stats::particles, 1, data_size*sizeof(Real));
       data_start += data_size;
     }
     // Send ints
@@ -398,6 +453,7 @@ TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
       int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_INT, drank, tag,
                            mpi_comm_part, &(isend_req[n]));
       if (ierr != MPI_SUCCESS) {no_errors=false;}
+      comm_stats::AddSend(comm_stats::particles, 1, data_size*sizeof(int));
       data_start += data_size;
     }
   }
@@ -418,19 +474,9 @@ TaskStatus ParticlesBoundaryValues::PackAndSendPrtcls() {
 
 TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
 #if MPI_PARALLEL_ENABLED
-  // Sort sendlist on host by index in particle array
-  namespace KE = Kokkos::Experimental;
-  std::sort(KE::begin(sendlist.h_view), KE::end(sendlist.h_view), SortByIndex);
-  // sync sendlist host array with device.  This results in sorted array on device
-  sendlist.template modify<HostMemSpace>();
-  sendlist.template sync<DevExeSpace>();
-
-  // increase size of particle arrays if needed
+  // increase capacity of particle arrays if needed
   int new_npart = pmy_part->nprtcl_thispack + (nprtcl_recv - nprtcl_send);
-  if (nprtcl_recv > nprtcl_send) {
-    Kokkos::resize(pmy_part->prtcl_idata, pmy_part->nidata, new_npart);
-    Kokkos::resize(pmy_part->prtcl_rdata, pmy_part->nrdata, new_npart);
-  }
+  pmy_part->ReserveCapacity(new_npart);
 
   // check that particle communications have all completed
   bool bflag = false;
@@ -456,9 +502,38 @@ TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
     std::exit(EXIT_FAILURE);
   }
   // exit if particle communications have not completed
-  if (bflag) {return TaskStatus::incomplete;}
+  if (bflag) {
+    comm_stats::RecvPending(wait_t0_);
+    return TaskStatus::incomplete;
+  }
+  comm_stats::RecvComplete(comm_stats::particles, wait_t0_);
 
-  // unpack particles into positions of sent particles
+  // Holes left by sent particles below new_npart are stored (in any order) in
+  // prtcl_holes, and holes in the tail [new_npart, npart) of the arrays are flagged.  All
+  // work below is proportional to the number of particles sent and received.
+  int npart = pmy_part->nprtcl_thispack;
+  int nremain = nprtcl_send - nprtcl_recv;
+  int ntail = (nremain > 0)? nremain : 0;
+  DvceArray1D<int> tail_hole("prtcl_tail_hole", ntail);
+  if (prtcl_holes.extent_int(0) < nprtcl_send) {
+    Kokkos::realloc(prtcl_holes, nprtcl_send);
+  }
+  auto &holes = prtcl_holes;
+  if (nprtcl_send > 0) {
+    auto &slist = sendlist;
+    DvceArray1D<int> counter("nhole_counter",1);
+    par_for("phole",DevExeSpace(),0,(nprtcl_send-1), KOKKOS_LAMBDA(const int n) {
+      int p = slist.d_view(n).prtcl_indx;
+      if (p < new_npart) {
+        holes(Kokkos::atomic_fetch_add(&counter(0),1)) = p;
+      } else {
+        tail_hole(p - new_npart) = 1;
+      }
+    });
+  }
+
+  // unpack particles into positions of sent particles.  Since at most ntail holes are
+  // in the tail, there are always at least nprtcl_recv holes below new_npart.
   if (nprtcl_recv > 0) {
     int nrdata = pmy_part->nrdata;
     int nidata = pmy_part->nidata;
@@ -466,13 +541,13 @@ TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
     auto &pi = pmy_part->prtcl_idata;
     auto &rrecvbuf = prtcl_rrecvbuf;
     auto &irecvbuf = prtcl_irecvbuf;
-    int &npart = pmy_part->nprtcl_thispack;
+    int nsend = nprtcl_send;
     par_for("punpack",DevExeSpace(),0,(nprtcl_recv-1), KOKKOS_LAMBDA(const int n) {
       int p;
-      if (n < nprtcl_send) {
-        p = sendlist.d_view(n).prtcl_indx; // place particles in holes created by sends
+      if (n < nsend) {
+        p = holes(n);                  // place particles in holes created by sends
       } else {
-        p = npart + (n - nprtcl_send);     // place particle at end of arrays
+        p = npart + (n - nsend);       // place particle at end of arrays
       }
       for (int i=0; i<nidata; ++i) {
         pi(i,p) = irecvbuf(nidata*n + i);
@@ -485,40 +560,33 @@ TaskStatus ParticlesBoundaryValues::RecvAndUnpackPrtcls() {
 
   // At this point have filled npart_recv holes in particle arrays from sends
   // If (nprtcl_recv < nprtcl_send), have to move particles from end of arrays to fill
-  // remaining holes
-  int nremain = nprtcl_send - nprtcl_recv;
+  // remaining holes below new_npart, whose number equals the number of particles in the
+  // tail [new_npart, npart) that are not holes.  Capacity is retained, so that arrays are
+  // not reallocated when particles arrive in later cycles.
   if (nremain > 0) {
-    int &npart = pmy_part->nprtcl_thispack;
-    int i_last_hole = nprtcl_send-1;
-    int i_next_hole = nprtcl_recv;
-    for (int n=1; n<=nremain; ++n) {
-      int nend = npart-n;
-      if (nend > sendlist.h_view(i_last_hole).prtcl_indx) {
-        // copy particle from end into hole
-        int next_hole = sendlist.h_view(i_next_hole).prtcl_indx;
-        auto rdest = Kokkos::subview(pmy_part->prtcl_rdata, Kokkos::ALL, next_hole);
-        auto rsrc  = Kokkos::subview(pmy_part->prtcl_rdata, Kokkos::ALL, nend);
-        Kokkos::deep_copy(rdest, rsrc);
-        auto idest = Kokkos::subview(pmy_part->prtcl_idata, Kokkos::ALL, next_hole);
-        auto isrc  = Kokkos::subview(pmy_part->prtcl_idata, Kokkos::ALL, nend);
-        Kokkos::deep_copy(idest, isrc);
-        i_next_hole += 1;
-      } else {
-        // this index contains a hole, so do nothing except find new index of last hole
-        i_last_hole -= 1;
+    int nrdata = pmy_part->nrdata;
+    int nidata = pmy_part->nidata;
+    auto &pr = pmy_part->prtcl_rdata;
+    auto &pi = pmy_part->prtcl_idata;
+    int nrecv = nprtcl_recv;
+    Kokkos::parallel_scan("pfill", Kokkos::RangePolicy<>(DevExeSpace(), 0, ntail),
+    KOKKOS_LAMBDA(const int t, int &psum, const bool final) {
+      if (tail_hole(t) == 0) {
+        if (final) {
+          int p = holes(nrecv + psum);
+          int q = new_npart + t;
+          for (int i=0; i<nidata; ++i) {pi(i,p) = pi(i,q);}
+          for (int i=0; i<nrdata; ++i) {pr(i,p) = pr(i,q);}
+        }
+        psum += 1;
       }
-    }
-
-    // shrink size of particle data arrays
-    Kokkos::resize(pmy_part->prtcl_idata, pmy_part->nidata, new_npart);
-    Kokkos::resize(pmy_part->prtcl_rdata, pmy_part->nrdata, new_npart);
+    });
   }
 
-  // Update nparticles_thisrank.  Update cost array (use npart_thismb[nmb]?)
+  // Update nparticles_thisrank.  Counts on other ranks are only gathered when needed,
+  // see Mesh::GatherParticleCounts()
   pmy_part->nprtcl_thispack = new_npart;
   pmy_part->pmy_pack->pmesh->nprtcl_thisrank = new_npart;
-  MPI_Allgather(&new_npart,1,MPI_INT,(pmy_part->pmy_pack->pmesh->nprtcl_eachrank),1,
-                MPI_INT,MPI_COMM_WORLD);
 #endif
   return TaskStatus::complete;
 }
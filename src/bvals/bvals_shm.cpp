@@ -0,0 +1,296 @@
+//========================================================================================
+// Athena++ astrophysical MHD code
+// Copyright(C) 2014 James M. Stone <jmstone@princeton.edu> and other code contributors
+// Licensed under the 3-clause BSD License, see LICENSE file for details
+//========================================================================================
+//! \file bvals_shm.cpp
+//! \brief functions to exchange boundary buffers of Mesh variables with ranks on the same
+//! node through MPI-3 shared memory windows, rather than MPI messages.  Generic, so they
+//! work for both CC and FC variables.
+//!
+//! Recv buffers of vars on every rank are allocated in a shared window.  After
+//! PackAndSendCC/FC() pack the send buffers, a single kernel copies the buffers for
+//! neighbors on the same node directly into their recv buffers, and a flag is set in the
+//! neighbor's window.  Two flags are stored for each recv buffer.  The receiver sets the
+//! "ready" flag to the current epoch (count of exchanges since last regrid) in InitRecv()
+//! once the buffer can be overwritten, and the sender sets the "data" flag to the epoch
+//! once the data is written.  Only ranks on other nodes still use MPI messages.
+//!
+//! Shared windows are only accessible on the host, so this is only used when the device
+//! memory space is host memory (e.g. Serial and OpenMP builds).
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "bvals.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::InitShmTransport
+//! \brief Creates communicator of ranks on same node, and shared windows for recv buffers
+//! and flags.  Must be called after recv buffers are allocated, and is collective over
+//! ranks on the node.
+
+void MeshBoundaryValues::InitShmTransport() {
+#if MPI_PARALLEL_ENABLED
+  if (!(std::is_same<DevMemSpace, HostMemSpace>::value)) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mesh>/shm_halo requires device memory on host, "
+                << "using MPI messages between all ranks" << std::endl;
+    }
+    shm_halo = false;
+    return;
+  }
+  int nnghbr = pmy_pack->pmb->nnghbr;
+
+  // find rank on node of every rank (or -1 if on another node)
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                      &comm_node_);
+  int nranks = global_variable::nranks;
+  std::vector<int> world_ranks(nranks);
+  for (int i=0; i<nranks; ++i) {world_ranks[i] = i;}
+  shm_node_rank_.resize(nranks);
+  MPI_Group world_group, node_group;
+  MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+  MPI_Comm_group(comm_node_, &node_group);
+  MPI_Group_translate_ranks(world_group, nranks, world_ranks.data(), node_group,
+                            shm_node_rank_.data());
+  MPI_Group_free(&world_group);
+  MPI_Group_free(&node_group);
+  for (auto &r : shm_node_rank_) {
+    if (r == MPI_UNDEFINED) {r = -1;}
+  }
+  // data is copied directly, not through shared memory, between MBs on this rank
+  shm_node_rank_[global_variable::my_rank] = -1;
+
+  // number of MBs in recv buffers may differ between ranks, so gather
+  int nnode;
+  MPI_Comm_size(comm_node_, &nnode);
+  shm_nmb_req_.resize(nnode);
+  MPI_Allgather(&nmb_req_, 1, MPI_INT, shm_nmb_req_.data(), 1, MPI_INT, comm_node_);
+
+  // offsets of recv buffers in window (same for all ranks, except for factor nmb_req_)
+  shm_buf_off_.resize(nnghbr+1);
+  shm_buf_off_[0] = 0;
+  for (int n=0; n<nnghbr; ++n) {
+    shm_buf_off_[n+1] = shm_buf_off_[n] + recvbuf[n].vars.extent_int(1);
+  }
+
+  // allocate shared windows, and move recv buffers into them
+  Real *pdata;
+  MPI_Aint data_size = static_cast<MPI_Aint>(nmb_req_)*shm_buf_off_[nnghbr]*sizeof(Real);
+  MPI_Win_allocate_shared(data_size, sizeof(Real), MPI_INFO_NULL, comm_node_, &pdata,
+                          &win_data_);
+  for (int n=0; n<nnghbr; ++n) {
+    recvbuf[n].vars = DvceArray2D<Real>(pdata + nmb_req_*shm_buf_off_[n], nmb_req_,
+                                        recvbuf[n].vars.extent_int(1));
+  }
+  MPI_Aint flag_size = static_cast<MPI_Aint>(2*nmb_req_*nnghbr)*sizeof(int);
+  MPI_Win_allocate_shared(flag_size, sizeof(int), MPI_INFO_NULL, comm_node_,
+                          &shm_flags_, &win_flag_);
+  for (int i=0; i<2*nmb_req_*nnghbr; ++i) {shm_flags_[i] = 0;}
+
+  // start passive target epoch on windows so that MPI_Win_sync can be used as barrier
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, win_data_);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, win_flag_);
+  MPI_Barrier(comm_node_);
+#else
+  shm_halo = false;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::FreeShmTransport
+//! \brief Frees shared windows and communicator.  Collective over all ranks on the node.
+
+void MeshBoundaryValues::FreeShmTransport() {
+#if MPI_PARALLEL_ENABLED
+  if (!(shm_halo) || (shm_flags_ == nullptr)) return;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  // recv buffers are views of window memory, so must be released before freeing window
+  for (int n=0; n<nnghbr; ++n) {recvbuf[n].vars = DvceArray2D<Real>();}
+  MPI_Win_unlock_all(win_data_);
+  MPI_Win_unlock_all(win_flag_);
+  MPI_Win_free(&win_data_);
+  MPI_Win_free(&win_flag_);
+  MPI_Comm_free(&comm_node_);
+  shm_flags_ = nullptr;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::InitShmExchange
+//! \brief Builds table of buffers sent to ranks on same node, with address of the recv
+//! buffer and flags on the neighbor.  Rebuilt only after each regrid (tracked by
+//! Mesh::nregrid), when all flags are reset.  Collective over all ranks on the node.
+
+void MeshBoundaryValues::InitShmExchange(const int nvars) {
+#if MPI_PARALLEL_ENABLED
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  int nflag = nmb_req_*nnghbr;
+
+  // no neighbor can be reading or writing flags once all ranks reach first barrier
+  MPI_Barrier(comm_node_);
+  for (int i=0; i<2*nflag; ++i) {shm_flags_[i] = 0;}
+  shm_epoch_ = 0;
+
+  shm_send_ready_.clear();
+  shm_send_data_.clear();
+  shm_recv_ready_.clear();
+  shm_recv_data_.clear();
+  std::vector<int> send_m, send_n, send_ndat;
+  std::vector<Real*> send_ptr;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if ((nghbr.h_view(m,n).gid >= 0) && IsNodeLocal(nghbr.h_view(m,n).rank)) {
+        int drank = nghbr.h_view(m,n).rank;
+        int nrank = shm_node_rank_[drank];
+        // index of recv'ing MB and buffer on neighbor
+        int dm = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
+        int dn = nghbr.h_view(m,n).dest;
+
+        MPI_Aint size;
+        int disp_unit;
+        Real *pdata;
+        int *pflag;
+        MPI_Win_shared_query(win_data_, nrank, &size, &disp_unit, &pdata);
+        MPI_Win_shared_query(win_flag_, nrank, &size, &disp_unit, &pflag);
+        int dnmb = shm_nmb_req_[nrank];
+        int ndat = shm_buf_off_[dn+1] - shm_buf_off_[dn];
+        send_m.push_back(m);
+        send_n.push_back(n);
+        send_ndat.push_back(VarsDataSize(sendbuf[n], m, n, nvars));
+        send_ptr.push_back(pdata + dnmb*shm_buf_off_[dn] + dm*ndat);
+        shm_send_ready_.push_back(pflag + (dm*nnghbr + dn));
+        shm_send_data_.push_back(pflag + (dnmb*nnghbr + dm*nnghbr + dn));
+
+        // buffers are symmetric, so also receive from this neighbor
+        shm_recv_ready_.push_back(shm_flags_ + (m*nnghbr + n));
+        shm_recv_data_.push_back(shm_flags_ + (nflag + m*nnghbr + n));
+      }
+    }
+  }
+
+  int nsend = send_m.size();
+  Kokkos::realloc(shm_send_map_, std::max(nsend, 1), 3);
+  Kokkos::realloc(shm_send_ptr_, std::max(nsend, 1));
+  for (int i=0; i<nsend; ++i) {
+    shm_send_map_.h_view(i,0) = send_m[i];
+    shm_send_map_.h_view(i,1) = send_n[i];
+    shm_send_map_.h_view(i,2) = send_ndat[i];
+    shm_send_ptr_.h_view(i) = send_ptr[i];
+  }
+  shm_send_map_.template modify<HostMemSpace>();
+  shm_send_map_.template sync<DevExeSpace>();
+  shm_send_ptr_.template modify<HostMemSpace>();
+  shm_send_ptr_.template sync<DevExeSpace>();
+
+  // flags on all ranks are reset before any are set for first exchange
+  MPI_Win_sync(win_flag_);
+  MPI_Barrier(comm_node_);
+  nregrid_shm_ = pmy_pack->pmesh->nregrid;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::ShmPostRecv
+//! \brief Marks recv buffers for neighbors on same node as ready to be written for the
+//! next exchange.  Called from InitRecv().
+
+void MeshBoundaryValues::ShmPostRecv(const int nvars) {
+#if MPI_PARALLEL_ENABLED
+  if (nregrid_shm_ != pmy_pack->pmesh->nregrid) {InitShmExchange(nvars);}
+  shm_epoch_++;
+  // unpack of previous exchange must have finished before buffers are overwritten
+  DevExeSpace().fence();
+  MPI_Win_sync(win_data_);
+  for (auto &flag : shm_recv_ready_) {*flag = shm_epoch_;}
+  MPI_Win_sync(win_flag_);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  bool MeshBoundaryValues::ShmPeersReady
+//! \brief Returns true once all neighbors on same node are ready to receive data for
+//! this exchange.
+
+bool MeshBoundaryValues::ShmPeersReady() {
+#if MPI_PARALLEL_ENABLED
+  MPI_Win_sync(win_flag_);
+  for (auto &flag : shm_send_ready_) {
+    if (*flag < shm_epoch_) {return false;}
+  }
+#endif
+  return true;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::ShmSend
+//! \brief Copies packed send buffers for neighbors on same node directly into their recv
+//! buffers, and sets the data flags.  Called from PackAndSendCC/FC() after the send
+//! buffers are packed.
+//!
+//! Waits until neighbors have posted their recv for this exchange.  This cannot deadlock
+//! since a neighbor reaches InitRecv() for this exchange once it has finished the
+//! previous exchange, which only depends on data this rank has already sent.
+
+void MeshBoundaryValues::ShmSend() {
+#if MPI_PARALLEL_ENABLED
+  int nsend = shm_send_ready_.size();
+  if (nsend == 0) return;
+  while (!(ShmPeersReady())) {std::this_thread::yield();}
+
+  auto &sbuf = sendbuf;
+  auto &map = shm_send_map_;
+  auto &ptr = shm_send_ptr_;
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nsend, Kokkos::AUTO);
+  Kokkos::parallel_for("ShmSendBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int p = tmember.league_rank();
+    const int m = map.d_view(p,0);
+    const int n = map.d_view(p,1);
+    Real *dst = ptr.d_view(p);
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, map.d_view(p,2)),
+    [&](const int i) {
+      dst[i] = sbuf[n].vars(m,i);
+    });
+  });
+  DevExeSpace().fence();
+
+  // data must be visible to neighbors before flags are set
+  MPI_Win_sync(win_data_);
+  for (auto &flag : shm_send_data_) {*flag = shm_epoch_;}
+  MPI_Win_sync(win_flag_);
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  bool MeshBoundaryValues::ShmRecvComplete
+//! \brief Returns true once all neighbors on same node have written data for this
+//! exchange.  Called at start of RecvAndUnpackCC/FC(), and in ClearRecv().
+
+bool MeshBoundaryValues::ShmRecvComplete() {
+#if MPI_PARALLEL_ENABLED
+  MPI_Win_sync(win_flag_);
+  for (auto &flag : shm_recv_data_) {
+    if (*flag < shm_epoch_) {return false;}
+  }
+  MPI_Win_sync(win_data_);
+#endif
+  return true;
+}
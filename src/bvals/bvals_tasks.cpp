@@ -16,6 +16,7 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <thread>
 #include <utility>
 
 #include "athena.hpp"
@@ -34,6 +35,35 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
   int &nnghbr = pmy_pack->pmb->nnghbr;
   auto &nghbr = pmy_pack->pmb->nghbr;
 
+  // Buffers from ranks on same node are written directly into shared memory
+  if (shm_halo) {ShmPostRecv(nvars);}
+
+  // With aggregation, post one receive per neighboring rank instead of per buffer
+  if (aggregate_mpi) {return InitAggregateRecv(nvars);}
+
+  // With persistent requests, (re)create them if the grid has changed since they were
+  // last built, then simply start all receives
+  if (persistent_mpi) {
+    if (nregrid_req_ != pmy_pack->pmesh->nregrid) {InitPersistentRequests(nvars);}
+    bool no_errors=true;
+    for (int m=0; m<nmb; ++m) {
+      for (int n=0; n<nnghbr; ++n) {
+        if ( (nghbr.h_view(m,n).gid >= 0) &&
+             (nghbr.h_view(m,n).rank != global_variable::my_rank) &&
+             !(IsNodeLocal(nghbr.h_view(m,n).rank)) ) {
+          int ierr = MPI_Start(&(recvbuf[n].vars_req[m]));
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+        }
+      }
+    }
+    if (!(no_errors)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "MPI error in starting persistent receives" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    return TaskStatus::complete;
+  }
+
   // Initialize communications of variables
   bool no_errors=true;
   for (int m=0; m<nmb; ++m) {
@@ -43,27 +73,17 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
         int drank = nghbr.h_view(m,n).rank;
 
         // post non-blocking receive if neighboring MeshBlock on a different rank
-        if (drank != global_variable::my_rank) {
+        if ((drank != global_variable::my_rank) && !(IsNodeLocal(drank))) {
           // create tag using local ID and buffer index of *receiving* MeshBlock
           int tag = CreateBvals_MPI_Tag(m, n);
 
           // calculate amount of data to be passed, get pointer to variables
-          int data_size = nvars;
-          if ( nghbr.h_view(m,n).lev < pmy_pack->pmb->mb_lev.h_view(m) ) {
-            data_size *= recvbuf[n].icoar_ndat;
-          } else if ( nghbr.h_view(m,n).lev == pmy_pack->pmb->mb_lev.h_view(m) ) {
-            if (is_z4c_) {
-              data_size *= recvbuf[n].isame_z4c_ndat;
-            } else {
-              data_size *= recvbuf[n].isame_ndat;
-            }
-          } else {
-            data_size *= recvbuf[n].ifine_ndat;
-          }
-          auto recv_ptr = Kokkos::subview(recvbuf[n].vars, m, Kokkos::ALL);
+          int data_size = VarsDataSize(recvbuf[n], m, n, nvars);
+          void *recv_ptr = recvbuf[n].MPIVarsPtr(m, lowp_vars);
+          MPI_Datatype dtype = lowp_vars ? MPI_FLOAT : MPI_ATHENA_REAL;
 
           // Post non-blocking receive for this buffer on this MeshBlock
-          int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+          int ierr = MPI_Irecv(recv_ptr, data_size, dtype, drank, tag,
                                comm_vars, &(recvbuf[n].vars_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
         }
@@ -80,6 +100,142 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn  int MeshBoundaryValues::VarsDataSize
+//! \brief Returns amount of data in vars buffer n of MeshBlock m, which depends on level
+//! of neighbor (and on direction, with a directional halo).  Same for send and recv
+//! buffers, since they are symmetric.
+
+int MeshBoundaryValues::VarsDataSize(const MeshBoundaryBuffer &buf, const int m,
+                                     const int n, const int nvars) {
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  int data_size = nvars;
+  if (nghbr.h_view(m,n).lev < pmy_pack->pmb->mb_lev.h_view(m)) {
+    data_size *= buf.icoar_ndat;
+  } else if (nghbr.h_view(m,n).lev == pmy_pack->pmb->mb_lev.h_view(m)) {
+    if (is_z4c_) {
+      data_size *= buf.isame_z4c_ndat;
+    } else {
+      data_size = data_size*buf.isame_ndat - buf.isame_nskip;
+    }
+  } else {
+    data_size *= buf.ifine_ndat;
+  }
+  return data_size;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::InitPersistentRequests
+//! \brief Creates persistent MPI requests (MPI_Send_init/MPI_Recv_init) for all sends and
+//! receives of vars between MeshBlocks on different ranks.  Buffer addresses and sizes
+//! only change when the grid changes, so requests are rebuilt only after each regrid
+//! (tracked by Mesh::nregrid).  Any existing requests must be inactive when called.
+
+void MeshBoundaryValues::InitPersistentRequests(const int nvars) {
+#if MPI_PARALLEL_ENABLED
+  FreePersistentRequests();
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+
+  bool no_errors=true;
+  persist_nmsg_ = 0;
+  persist_nbytes_ = 0;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if (nghbr.h_view(m,n).gid >= 0) {
+        int drank = nghbr.h_view(m,n).rank;
+        if ((drank != global_variable::my_rank) && !(IsNodeLocal(drank))) {
+          int send_size = VarsDataSize(sendbuf[n], m, n, nvars);
+          int recv_size = VarsDataSize(recvbuf[n], m, n, nvars);
+          persist_nmsg_++;
+          persist_nbytes_ += send_size*(lowp_vars? sizeof(float) : sizeof(Real));
+
+          // send tag uses local ID and buffer index of *receiving* MeshBlock
+          int dn = nghbr.h_view(m,n).dest;
+          int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
+          MPI_Datatype dtype = lowp_vars ? MPI_FLOAT : MPI_ATHENA_REAL;
+          int ierr = MPI_Send_init(sendbuf[n].MPIVarsPtr(m, lowp_vars), send_size, dtype,
+                                   drank, CreateBvals_MPI_Tag(lid, dn), comm_vars,
+                                   &(sendbuf[n].vars_req[m]));
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+
+          ierr = MPI_Recv_init(recvbuf[n].MPIVarsPtr(m, lowp_vars), recv_size, dtype,
+                               drank, CreateBvals_MPI_Tag(m, n), comm_vars,
+                               &(recvbuf[n].vars_req[m]));
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+        }
+      }
+    }
+  }
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in creating persistent requests" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  nregrid_req_ = pmy_pack->pmesh->nregrid;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::FreePersistentRequests
+//! \brief Frees any persistent MPI requests for vars.  Loops over full length of request
+//! arrays since neighbors may have changed since requests were created.
+
+void MeshBoundaryValues::FreePersistentRequests() {
+#if MPI_PARALLEL_ENABLED
+  if (nregrid_req_ < 0) return;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  for (int n=0; n<nnghbr; ++n) {
+    for (int m=0; m<nmb_req_; ++m) {
+      if (sendbuf[n].vars_req[m] != MPI_REQUEST_NULL) {
+        MPI_Request_free(&(sendbuf[n].vars_req[m]));
+      }
+      if (recvbuf[n].vars_req[m] != MPI_REQUEST_NULL) {
+        MPI_Request_free(&(recvbuf[n].vars_req[m]));
+      }
+    }
+  }
+  nregrid_req_ = -1;
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MeshBoundaryValues::StartPersistentSends
+//! \brief Starts all persistent sends of vars.  Called from PackAndSendCC/FC() in place
+//! of posting MPI_Isend, after send buffers have been packed.
+
+TaskStatus MeshBoundaryValues::StartPersistentSends() {
+#if MPI_PARALLEL_ENABLED
+  int &nmb = pmy_pack->nmb_thispack;
+  int &nnghbr = pmy_pack->pmb->nnghbr;
+  auto &nghbr = pmy_pack->pmb->nghbr;
+
+  bool no_errors=true;
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
+      if ( (nghbr.h_view(m,n).gid >= 0) &&
+           (nghbr.h_view(m,n).rank != global_variable::my_rank) &&
+           !(IsNodeLocal(nghbr.h_view(m,n).rank)) ) {
+        int ierr = MPI_Start(&(sendbuf[n].vars_req[m]));
+        if (ierr != MPI_SUCCESS) {no_errors=false;}
+      }
+    }
+  }
+  comm_stats::AddSend(vars_stat_, persist_nmsg_, persist_nbytes_);
+  // Quit if MPI error detected
+  if (!(no_errors)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+       << std::endl << "MPI error in starting persistent sends" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+#endif
+  return TaskStatus::complete;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn  void MeshBoundaryValues::ClearRecv
 //! \brief Waits for all MPI receives associated with communcation of boundary variables
@@ -87,6 +243,11 @@ TaskStatus MeshBoundaryValues::InitRecv(const int nvars) {
 
 TaskStatus MeshBoundaryValues::ClearRecv() {
 #if MPI_PARALLEL_ENABLED
+  // wait for neighbors on same node to write data into recv buffers
+  if (shm_halo) {
+    while (!(ShmRecvComplete())) {std::this_thread::yield();}
+  }
+  if (aggregate_mpi) {return ClearAggregateRecv();}
   bool no_errors=true;
   int &nmb = pmy_pack->nmb_thispack;
   int &nnghbr = pmy_pack->pmb->nnghbr;
@@ -119,6 +280,7 @@ TaskStatus MeshBoundaryValues::ClearRecv() {
 
 TaskStatus MeshBoundaryValues::ClearSend() {
 #if MPI_PARALLEL_ENABLED
+  if (aggregate_mpi) {return ClearAggregateSend();}
   bool no_errors=true;
   int &nmb = pmy_pack->nmb_thispack;
   int &nnghbr = pmy_pack->pmb->nnghbr;
@@ -0,0 +1,120 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file comm_stats.cpp
+//! \brief implements accumulation of per-cycle communication counters, and report of
+//! their spread over ranks.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "comm_stats.hpp"
+
+namespace comm_stats {
+
+bool enabled = false;
+Counters cycle[nexchange];
+double idle = 0.0;
+
+namespace {
+// quantities reported for each exchange (and idle time): messages, MB and wait time per
+// cycle averaged since last report, and the largest wait time in any single cycle
+constexpr int nq = 4;
+constexpr int nrow = nexchange + 1;
+const char *row_name[nrow] = {"vars_cc", "vars_fc", "flux_cc", "flux_fc", "particles",
+                              "amr", "idle"};
+Counters total[nexchange];     // counters summed since last report
+double max_wait[nexchange];    // largest wait in a single cycle since last report
+double total_idle = 0.0, max_idle = 0.0;
+int ncycle_acc = 0;
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void EndCycle()
+//! \brief adds counters of current cycle to totals since last report, and resets them.
+
+void EndCycle() {
+  for (int x=0; x<nexchange; ++x) {
+    total[x].nmsg += cycle[x].nmsg;
+    total[x].nbytes += cycle[x].nbytes;
+    total[x].wait += cycle[x].wait;
+    max_wait[x] = std::max(max_wait[x], cycle[x].wait);
+    cycle[x] = Counters();
+  }
+  total_idle += idle;
+  max_idle = std::max(max_idle, idle);
+  idle = 0.0;
+  ncycle_acc++;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Report()
+//! \brief prints min/avg/max over ranks of the communication counters per cycle since
+//! the last report, and ratio of max to avg wait time (imbalance).  Must be called by
+//! all ranks.
+
+void Report(const int ncycle) {
+  if (ncycle_acc == 0) {return;}
+  double val[nrow*nq], vmin[nrow*nq], vmax[nrow*nq], vsum[nrow*nq];
+  double ncyc = static_cast<double>(ncycle_acc);
+  for (int x=0; x<nexchange; ++x) {
+    val[nq*x    ] = static_cast<double>(total[x].nmsg)/ncyc;
+    val[nq*x + 1] = 1.0e-6*static_cast<double>(total[x].nbytes)/ncyc;
+    val[nq*x + 2] = 1.0e3*total[x].wait/ncyc;
+    val[nq*x + 3] = 1.0e3*max_wait[x];
+  }
+  val[nq*nexchange    ] = 0.0;
+  val[nq*nexchange + 1] = 0.0;
+  val[nq*nexchange + 2] = 1.0e3*total_idle/ncyc;
+  val[nq*nexchange + 3] = 1.0e3*max_idle;
+#if MPI_PARALLEL_ENABLED
+  MPI_Reduce(val, vmin, nrow*nq, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+  MPI_Reduce(val, vmax, nrow*nq, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  MPI_Reduce(val, vsum, nrow*nq, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#else
+  std::copy(val, val + nrow*nq, vmin);
+  std::copy(val, val + nrow*nq, vmax);
+  std::copy(val, val + nrow*nq, vsum);
+#endif
+
+  if (global_variable::my_rank == 0) {
+    double nr = static_cast<double>(global_variable::nranks);
+    std::cout << std::endl << "Communication per cycle over " << ncycle_acc
+              << " cycles ending at cycle=" << ncycle << " (min/avg/max over ranks)"
+              << std::endl << std::left << std::setw(10) << "exchange" << std::right
+              << std::setw(24) << "messages" << std::setw(30) << "MB"
+              << std::setw(30) << "wait (ms)" << std::setw(11) << "max wait"
+              << std::setw(8) << "imbal" << std::endl;
+    for (int r=0; r<nrow; ++r) {
+      // skip exchanges that did not occur on any rank
+      if (vmax[nq*r] == 0.0 && vmax[nq*r + 2] == 0.0) {continue;}
+      std::cout << std::left << std::setw(10) << row_name[r] << std::right
+                << std::fixed << std::setprecision(1);
+      for (int q=0; q<3; ++q) {
+        int iq = nq*r + q;
+        if (q > 0) {std::cout << std::scientific << std::setprecision(2);}
+        std::cout << std::setw(q == 0? 8 : 10) << vmin[iq] << std::setw(q == 0? 8 : 10)
+                  << vsum[iq]/nr << std::setw(q == 0? 8 : 10) << vmax[iq];
+      }
+      double avg_wait = vsum[nq*r + 2]/nr;
+      std::cout << std::setw(11) << vmax[nq*r + 3] << std::fixed << std::setprecision(2)
+                << std::setw(8) << ((avg_wait > 0.0)? vmax[nq*r + 2]/avg_wait : 1.0)
+                << std::endl;
+    }
+  }
+
+  for (int x=0; x<nexchange; ++x) {
+    total[x] = Counters();
+    max_wait[x] = 0.0;
+  }
+  total_idle = 0.0;
+  max_idle = 0.0;
+  ncycle_acc = 0;
+}
+
+} // namespace comm_stats
@@ -0,0 +1,62 @@
+#ifndef BVALS_COMM_STATS_HPP_
+#define BVALS_COMM_STATS_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file comm_stats.hpp
+//! \brief Lightweight counters of MPI messages, bytes sent, and time spent waiting for
+//! messages, for each type of exchange between ranks.  Counters are accumulated every
+//! cycle, and when enabled with <time>/comm_stats=true the spread of these over all ranks
+//! is reported every ndiag cycles (see Driver::Execute()).
+//!
+//! Wait time of a receive is measured from the first test which finds messages still
+//! pending, to the test which finds all have arrived.  Other tasks may execute in this
+//! interval, so it measures latency not hidden by other work in the same task list.  The
+//! time the Driver is idle (no task can make progress) is counted separately.
+
+#include <chrono>
+#include <cstdint>
+
+namespace comm_stats {
+
+// types of exchanges between ranks
+enum Exchange {vars_cc=0, vars_fc, flux_cc, flux_fc, particles, amr, nexchange};
+
+struct Counters {
+  std::uint64_t nmsg = 0, nbytes = 0;  // messages sent, and bytes in these messages
+  double wait = 0.0;                   // time (s) waiting for receives to complete
+};
+
+extern bool enabled;
+extern Counters cycle[nexchange];  // counters for current cycle
+extern double idle;                // time (s) Driver was idle in current cycle
+
+inline double Now() {
+  return std::chrono::duration<double>(
+         std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline void AddSend(const Exchange x, const std::uint64_t nmsg, const std::uint64_t nb) {
+  cycle[x].nmsg += nmsg;
+  cycle[x].nbytes += nb;
+}
+
+// t0 stores the time at which receives were first found to be pending (< 0 otherwise)
+inline void RecvPending(double &t0) {
+  if (enabled && t0 < 0.0) {t0 = Now();}
+}
+inline void RecvComplete(const Exchange x, double &t0) {
+  if (t0 >= 0.0) {
+    cycle[x].wait += Now() - t0;
+    t0 = -1.0;
+  }
+}
+
+void EndCycle();
+void Report(const int ncycle);
+
+} // namespace comm_stats
+
+#endif // BVALS_COMM_STATS_HPP_
@@ -22,13 +22,17 @@
 //! into boundary buffers and send to neighbors for flux-correction step.  These fluxes
 //! (e.g. for the conserved hydro variables) live at cell faces.
 //!
-//! This routine packs ALL the buffers on ALL the faces simultaneously for ALL the
-//! MeshBlocks. Buffer data are then sent (via MPI) or copied directly for periodic or
-//! block boundaries.
+//! This routine packs the buffers on all faces with a neighbor at a coarser level (from
+//! the compact list built when the mesh changes) simultaneously for all MeshBlocks.
+//! Buffer data are then sent (via MPI) or copied directly for periodic or block
+//! boundaries.  Returns immediately if no MeshBlock borders a coarser level.
 
 TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
+  UpdateLevelLists();
+  if (nfcor_send_ == 0) {return TaskStatus::complete;}
+  auto &slist = fcor_send_list_;
+
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
   int nvar = flx.x1f.extent_int(1);  // TODO(@user): 2nd idx from L of in arr must be NVAR
 
@@ -45,12 +49,13 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
   auto &one_d = pmy_pack->pmesh->one_d;
   auto &two_d = pmy_pack->pmesh->two_d;
 
-  // Outer loop over (# of MeshBlocks)*(# of neighbors)*(# of variables)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
-  Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr*nvar);
-    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+  // Outer loop over (# of faces with coarser neighbor)*(# of variables)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nfcor_send_*nvar), Kokkos::AUTO);
+  Kokkos::parallel_for("SendFluxCC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int e = (tmember.league_rank())/nvar;
+    const int v = (tmember.league_rank()) - e*nvar;
+    const int m = slist.d_view(e)/nnghbr;
+    const int n = slist.d_view(e) - m*nnghbr;
 
     // Note send buffer flux indices are for the coarse mesh
     int il = sbuf[n].iflux_coar[0].bis;
@@ -157,31 +162,28 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
 #if MPI_PARALLEL_ENABLED
   // Send boundary buffer to neighboring MeshBlocks using MPI
   // Sends only occur to neighbors on FACES at a COARSER level
-  Kokkos::fence();
+  DevExeSpace().fence();
   bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if ( (nghbr.h_view(m,n).gid >=0) &&
-           (nghbr.h_view(m,n).lev < mblev.h_view(m)) &&
-           ((n<16) || ((n>=24) && (n<32))) ) {
-        // index and rank of destination Neighbor
-        int dn = nghbr.h_view(m,n).dest;
-        int drank = nghbr.h_view(m,n).rank;
-
-        if (drank != my_rank) {
-          // create tag using local ID and buffer index of *receiving* MeshBlock
-          int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
-          int tag = CreateBvals_MPI_Tag(lid, dn);
-
-          // get ptr to send buffer for fluxes
-          int data_size = nvar*(sendbuf[n].iflxc_ndat);
-          auto send_ptr = Kokkos::subview(sendbuf[n].flux, m, Kokkos::ALL);
-
-          int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
-                               comm_flux, &(sendbuf[n].flux_req[m]));
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
-        }
-      }
+  for (int e=0; e<nfcor_send_; ++e) {
+    int m = slist.h_view(e)/nnghbr;
+    int n = slist.h_view(e) - m*nnghbr;
+    // index and rank of destination Neighbor
+    int dn = nghbr.h_view(m,n).dest;
+    int drank = nghbr.h_view(m,n).rank;
+
+    if (drank != my_rank) {
+      // create tag using local ID and buffer index of *receiving* MeshBlock
+      int lid = nghbr.h_view(m,n).gid - pmy_pack->pmesh->gids_eachrank[drank];
+      int tag = CreateBvals_MPI_Tag(lid, dn);
+
+      // get ptr to send buffer for fluxes
+      int data_size = nvar*(sendbuf[n].iflxc_ndat);
+      auto send_ptr = Kokkos::subview(sendbuf[n].flux, m, Kokkos::ALL);
+
+      int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+                           comm_flux, &(sendbuf[n].flux_req[m]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+      comm_stats::AddSend(flux_stat_, 1, data_size*sizeof(Real));
     }
   }
   // Quit if MPI error detected
@@ -196,11 +198,16 @@ TaskStatus MeshBoundaryValuesCC::PackAndSendFluxCC(DvceFaceFld5D<Real> &flx) {
 
 //----------------------------------------------------------------------------------------
 //! \fn void RecvBuffers()
-//! \brief Unpack boundary buffers for flux correction of CC variables.
+//! \brief Unpack boundary buffers for flux correction of CC variables.  Only faces with
+//! a neighbor at a finer level (from the compact list built when the mesh changes) are
+//! tested and unpacked.
 
 TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
+  UpdateLevelLists();
+  if (nfcor_recv_ == 0) {return TaskStatus::complete;}
+  auto &rlist = fcor_recv_list_;
+
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &mblev = pmy_pack->pmb->mb_lev;
@@ -211,19 +218,15 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
 
   bool bflag = false;
   bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      if ( (nghbr.h_view(m,n).gid >=0) &&
-           (nghbr.h_view(m,n).lev > mblev.h_view(m)) &&
-           ((n<16) || ((n>=24) && (n<32))) ) {
-        if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
-          int test;
-          int ierr = MPI_Test(&(rbuf[n].flux_req[m]), &test, MPI_STATUS_IGNORE);
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
-          if (!(static_cast<bool>(test))) {
-            bflag = true;
-          }
-        }
+  for (int e=0; e<nfcor_recv_; ++e) {
+    int m = rlist.h_view(e)/nnghbr;
+    int n = rlist.h_view(e) - m*nnghbr;
+    if (nghbr.h_view(m,n).rank != global_variable::my_rank) {
+      int test;
+      int ierr = MPI_Test(&(rbuf[n].flux_req[m]), &test, MPI_STATUS_IGNORE);
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+      if (!(static_cast<bool>(test))) {
+        bflag = true;
       }
     }
   }
@@ -235,19 +238,24 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
     std::exit(EXIT_FAILURE);
   }
   // exit if recv boundary buffer communications have not completed
-  if (bflag) {return TaskStatus::incomplete;}
+  if (bflag) {
+    comm_stats::RecvPending(flux_wait_t0_);
+    return TaskStatus::incomplete;
+  }
+  comm_stats::RecvComplete(flux_stat_, flux_wait_t0_);
 #endif
 
   //----- STEP 2: buffers have all completed, so unpack
 
   int nvar = flx.x1f.extent_int(1); // TODO(@user): 2nd idx from L of in arr must be NVAR
 
-  // Outer loop over (# of MeshBlocks)*(# of neighbors)*(# of variables)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr*nvar), Kokkos::AUTO);
-  Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr*nvar);
-    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+  // Outer loop over (# of faces with finer neighbor)*(# of variables)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nfcor_recv_*nvar), Kokkos::AUTO);
+  Kokkos::parallel_for("RecvFluxCC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+    const int e = (tmember.league_rank())/nvar;
+    const int v = (tmember.league_rank()) - e*nvar;
+    const int m = rlist.d_view(e)/nnghbr;
+    const int n = rlist.d_view(e) - m*nnghbr;
 
     // Recv buffer flux indices are for the regular mesh
     int il = rbuf[n].iflux_coar[0].bis;
@@ -307,37 +315,35 @@ TaskStatus MeshBoundaryValuesCC::RecvAndUnpackFluxCC(DvceFaceFld5D<Real> &flx) {
 
 TaskStatus MeshBoundaryValuesCC::InitFluxRecv(const int nvars) {
 #if MPI_PARALLEL_ENABLED
-  int &nmb = pmy_pack->nmb_thispack;
   int &nnghbr = pmy_pack->pmb->nnghbr;
   auto &nghbr = pmy_pack->pmb->nghbr;
 
+  // only post receives for neighbors on FACES at FINER level
+  // this is the only thing different from BoundaryValuesFC::InitRecvFlux()
+  UpdateLevelLists();
+  auto &rlist = fcor_recv_list_;
+
   // Initialize communications of fluxes
   bool no_errors=true;
-  for (int m=0; m<nmb; ++m) {
-    for (int n=0; n<nnghbr; ++n) {
-      // only post receives for neighbors on FACES at FINER level
-      // this is the only thing different from BoundaryValuesFC::InitRecvFlux()
-      if ( (nghbr.h_view(m,n).gid >=0) &&
-           (nghbr.h_view(m,n).lev > pmy_pack->pmb->mb_lev.h_view(m)) &&
-           ((n<16) || ((n>=24) && (n<32))) ) {
-        // rank of destination buffer
-        int drank = nghbr.h_view(m,n).rank;
-
-        // post non-blocking receive if neighboring MeshBlock on a different rank
-        if (drank != global_variable::my_rank) {
-          // create tag using local ID and buffer index of *receiving* MeshBlock
-          int tag = CreateBvals_MPI_Tag(m, n);
-
-          // calculate amount of data to be passed, get pointer to variables
-          int data_size = nvars*(recvbuf[n].iflxc_ndat);
-          auto recv_ptr = Kokkos::subview(recvbuf[n].flux, m, Kokkos::ALL);
-
-          // Post non-blocking receive for this buffer on this MeshBlock
-          int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
-                               comm_flux, &(recvbuf[n].flux_req[m]));
-          if (ierr != MPI_SUCCESS) {no_errors=false;}
-        }
-      }
+  for (int e=0; e<nfcor_recv_; ++e) {
+    int m = rlist.h_view(e)/nnghbr;
+    int n = rlist.h_view(e) - m*nnghbr;
+    // rank of destination buffer
+    int drank = nghbr.h_view(m,n).rank;
+
+    // post non-blocking receive if neighboring MeshBlock on a different rank
+    if (drank != global_variable::my_rank) {
+      // create tag using local ID and buffer index of *receiving* MeshBlock
+      int tag = CreateBvals_MPI_Tag(m, n);
+
+      // calculate amount of data to be passed, get pointer to variables
+      int data_size = nvars*(recvbuf[n].iflxc_ndat);
+      auto recv_ptr = Kokkos::subview(recvbuf[n].flux, m, Kokkos::ALL);
+
+      // Post non-blocking receive for this buffer on this MeshBlock
+      int ierr = MPI_Irecv(recv_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
+                           comm_flux, &(recvbuf[n].flux_req[m]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
     }
   }
   // Quit if MPI error detected
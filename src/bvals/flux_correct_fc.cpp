@@ -328,7 +328,7 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFluxFC(DvceEdgeFld4D<Real> &flx) {
 #if MPI_PARALLEL_ENABLED
   // Send boundary buffer to neighboring MeshBlocks using MPI
   // Sends only occur to neighbors on FACES and EDGES at COARSER or SAME level
-  Kokkos::fence();
+  DevExeSpace().fence();
   bool no_errors=true;
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<nnghbr; ++n) {
@@ -356,6 +356,7 @@ TaskStatus MeshBoundaryValuesFC::PackAndSendFluxFC(DvceEdgeFld4D<Real> &flx) {
           int ierr = MPI_Isend(send_ptr.data(), data_size, MPI_ATHENA_REAL, drank, tag,
                                comm_flux, &(sendbuf[n].flux_req[m]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          comm_stats::AddSend(flux_stat_, 1, data_size*sizeof(Real));
         }
       }
     }
@@ -413,7 +414,11 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFluxFC(DvceEdgeFld4D<Real> &flx) {
     std::exit(EXIT_FAILURE);
   }
   // exit if recv boundary buffer communications have not completed
-  if (bflag) {return TaskStatus::incomplete;}
+  if (bflag) {
+    comm_stats::RecvPending(flux_wait_t0_);
+    return TaskStatus::incomplete;
+  }
+  comm_stats::RecvComplete(flux_stat_, flux_wait_t0_);
 #endif
 
   //----- STEP 2: buffers have all completed, so unpack and perform appropriate averaging
@@ -429,8 +434,10 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFluxFC(DvceEdgeFld4D<Real> &flx) {
   SumBoundaryFluxes(flx, true, nflx);
 
   // Zero EMFs at boundary that overlap with finer MeshBlocks (only use fine fluxes there)
-  // Then unpack and sum fluxes from finer levels
-  if (pmy_pack->pmesh->multilevel) {
+  // Then unpack and sum fluxes from finer levels.  Skipped when no MeshBlock on this
+  // rank borders a finer level.
+  UpdateLevelLists();
+  if (pmy_pack->pmesh->multilevel && (nfine_mb_ > 0)) {
     ZeroFluxesAtBoundaryWithFiner(flx, nflx);
     SumBoundaryFluxes(flx, false, nflx);
   }
@@ -445,13 +452,16 @@ TaskStatus MeshBoundaryValuesFC::RecvAndUnpackFluxFC(DvceEdgeFld4D<Real> &flx) {
 //! \fn  void MeshBoundaryValuesFC::SumBoundaryFluxes
 //! \brief Sums boundary buffer fluxes from neighboring MeshBlocks at the same level into
 //! flux (e.g. EMF) array if input argument 'same_level=true', or sums boundary buffer
-//! fluxes from neighboring MeshBlocks at a finer level into flux array otherwise.
+//! fluxes from neighboring MeshBlocks at a finer level into flux array otherwise.  In
+//! the latter case only MeshBlocks with a finer neighbor (from the compact list built
+//! when the mesh changes) are included.
 
 void MeshBoundaryValuesFC::SumBoundaryFluxes(DvceEdgeFld4D<Real> &flx,
                                              const bool same_level,
                                              DvceArray2D<int> &nflx) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
+  int nmb = (same_level)? pmy_pack->nmb_thispack : nfine_mb_;
+  auto &mlist = fine_mb_list_;
   int nnghbr = pmy_pack->pmb->nnghbr;
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &rbuf = recvbuf;
@@ -461,7 +471,8 @@ void MeshBoundaryValuesFC::SumBoundaryFluxes(DvceEdgeFld4D<Real> &flx,
   // Outer loop over (# of MeshBlocks)*(3 field components)
   Kokkos::TeamPolicy<> policy(DevExeSpace(), (3*nmb), Kokkos::AUTO);
   Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = tmember.league_rank()/3;
+    const int e = tmember.league_rank()/3;
+    const int m = (same_level)? e : mlist.d_view(e);
     const int v = tmember.league_rank()%3;
 
     // scalar loop over neighbors (except corners) to prevent race condition in sums
@@ -647,23 +658,27 @@ void MeshBoundaryValuesFC::SumBoundaryFluxes(DvceEdgeFld4D<Real> &flx,
 //! \fn  void MeshBoundaryValuesFC::ZeroFluxesAtBoundaryWithFiner
 //! \brief Zeroes out fluxes of face-centered variables (e.g. EMFs) at boundaries with
 //! MeshBlocks at a finer level, so that boundary buffer fluxes from finer level can be
-//! summed (averaged) in place.
+//! summed (averaged) in place.  Only faces and edges with a finer neighbor (from the
+//! compact list built when the mesh changes) are included.
 
 void MeshBoundaryValuesFC::ZeroFluxesAtBoundaryWithFiner(DvceEdgeFld4D<Real> &flx,
                                                          DvceArray2D<int> &nflx) {
+  if (necor_recv_ == 0) return;
+  auto &elist = ecor_recv_list_;
+
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &rbuf = recvbuf;
   auto &mblev = pmy_pack->pmb->mb_lev;
 
-  // Outer loop over (# of MeshBlocks)*(# of neighbors)*(3 field components)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (3*nmb*nnghbr), Kokkos::AUTO);
+  // Outer loop over (# of faces/edges with finer neighbor)*(3 field components)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (3*necor_recv_), Kokkos::AUTO);
   Kokkos::parallel_for("RecvBuff", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(3*nnghbr);
-    const int n = (tmember.league_rank() - m*(3*nnghbr))/3;
-    const int v = (tmember.league_rank() - m*(3*nnghbr) - 3*n);
+    const int e = (tmember.league_rank())/3;
+    const int v = (tmember.league_rank()) - 3*e;
+    const int m = elist.d_view(e)/nnghbr;
+    const int n = elist.d_view(e) - m*nnghbr;
 
     // only zero EMFs when neighbor exists and is at finer level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev > mblev.d_view(m))) {
@@ -35,7 +35,6 @@
 void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
                                                  DvceArray5D<Real> &prim) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
 
   auto &nghbr = pmy_pack->pmb->nghbr;
@@ -53,11 +52,16 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
 
-  // Outer loop over (# of MeshBlocks)*(# of buffers)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
+  // only buffers with neighbors at coarser level are converted
+  UpdateLevelLists();
+  if (nprol_ == 0) return;
+  auto &plist = prol_list_;
+
+  // Outer loop over (# of buffers at fine/coarse boundaries)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nprol_, Kokkos::AUTO);
   Kokkos::parallel_for("Prol_C2P_CC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = tmember.league_rank()/nnghbr;
-    const int n = tmember.league_rank() - m*nnghbr;
+    const int m = plist.d_view(tmember.league_rank())/nnghbr;
+    const int n = plist.d_view(tmember.league_rank()) - m*nnghbr;
 
     // only convert coarse vars when neighbor exists and is at coarser level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
@@ -190,7 +194,6 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
 void MeshBoundaryValuesCC::PrimToConsFineBndry(const DvceArray5D<Real> &prim,
                                                DvceArray5D<Real> &cons) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
 
   auto &nghbr = pmy_pack->pmb->nghbr;
@@ -208,11 +211,16 @@ void MeshBoundaryValuesCC::PrimToConsFineBndry(const DvceArray5D<Real> &prim,
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
 
-  // Outer loop over (# of MeshBlocks)*(# of buffers)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
+  // only buffers with neighbors at coarser level are converted
+  UpdateLevelLists();
+  if (nprol_ == 0) return;
+  auto &plist = prol_list_;
+
+  // Outer loop over (# of buffers at fine/coarse boundaries)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nprol_, Kokkos::AUTO);
   Kokkos::parallel_for("ProlCC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = tmember.league_rank()/nnghbr;
-    const int n = tmember.league_rank() - m*nnghbr;
+    const int m = plist.d_view(tmember.league_rank())/nnghbr;
+    const int n = plist.d_view(tmember.league_rank()) - m*nnghbr;
 
     // only prolongate when neighbor exists and is at coarser level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
@@ -303,7 +311,6 @@ void MeshBoundaryValuesCC::PrimToConsFineBndry(const DvceArray5D<Real> &prim,
 void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
                                  const DvceFaceFld4D<Real> &b, DvceArray5D<Real> &prim) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
 
   auto &nghbr = pmy_pack->pmb->nghbr;
@@ -321,11 +328,16 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
   int &nmhd  = pmy_pack->pmhd->nmhd;
   int &nscal = pmy_pack->pmhd->nscalars;
 
-  // Outer loop over (# of MeshBlocks)*(# of buffers)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
+  // only buffers with neighbors at coarser level are converted
+  UpdateLevelLists();
+  if (nprol_ == 0) return;
+  auto &plist = prol_list_;
+
+  // Outer loop over (# of buffers at fine/coarse boundaries)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nprol_, Kokkos::AUTO);
   Kokkos::parallel_for("ProlCC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = tmember.league_rank()/nnghbr;
-    const int n = tmember.league_rank() - m*nnghbr;
+    const int m = plist.d_view(tmember.league_rank())/nnghbr;
+    const int n = plist.d_view(tmember.league_rank()) - m*nnghbr;
 
     // only convert coarse vars when neighbor exists and is at coarser level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
@@ -465,7 +477,6 @@ void MeshBoundaryValuesCC::ConsToPrimCoarseBndry(const DvceArray5D<Real> &cons,
 void MeshBoundaryValuesCC::PrimToConsFineBndry(const DvceArray5D<Real> &prim,
                                const DvceFaceFld4D<Real> &b, DvceArray5D<Real> &cons) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
 
   auto &nghbr = pmy_pack->pmb->nghbr;
@@ -483,11 +494,16 @@ void MeshBoundaryValuesCC::PrimToConsFineBndry(const DvceArray5D<Real> &prim,
   int &nmhd  = pmy_pack->pmhd->nmhd;
   int &nscal = pmy_pack->pmhd->nscalars;
 
-  // Outer loop over (# of MeshBlocks)*(# of buffers)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nmb*nnghbr), Kokkos::AUTO);
+  // only buffers with neighbors at coarser level are converted
+  UpdateLevelLists();
+  if (nprol_ == 0) return;
+  auto &plist = prol_list_;
+
+  // Outer loop over (# of buffers at fine/coarse boundaries)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nprol_, Kokkos::AUTO);
   Kokkos::parallel_for("ProlCC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = tmember.league_rank()/nnghbr;
-    const int n = tmember.league_rank() - m*nnghbr;
+    const int m = plist.d_view(tmember.league_rank())/nnghbr;
+    const int n = plist.d_view(tmember.league_rank()) - m*nnghbr;
 
     // only prolongate when neighbor exists and is at coarser level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
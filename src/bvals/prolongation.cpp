@@ -30,12 +30,10 @@ void MeshBoundaryValuesCC::FillCoarseInBndryCC(DvceArray5D<Real> &a,
                                                DvceArray5D<Real> &ca,
                                                bool is_z4c) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
   //bool not_z4c = (pmbp->pz4c == nullptr)? true : false;
 
   int nvar = a.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
-  int nmnv = nmb*nnghbr*nvar;
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &mblev = pmy_pack->pmb->mb_lev;
   auto &rbuf = recvbuf;
@@ -54,16 +52,20 @@ void MeshBoundaryValuesCC::FillCoarseInBndryCC(DvceArray5D<Real> &a,
   // coarser level and the other the same level is filled properly.
   // (Only needed in multidimensions)
 
-  if (multi_d) {
+  // Only MeshBlocks with a coarser neighbor need data in coarse array
+  UpdateLevelLists();
+  if (multi_d && (nfill_ > 0)) {
     auto &cis = indcs.cis;
     auto &cjs = indcs.cjs;
     auto &cks = indcs.cks;
-    // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
-    Kokkos::TeamPolicy<> policy(DevExeSpace(), nmnv, Kokkos::AUTO);
+    auto &flist = fill_list_;
+    // Outer loop over (# of same-level buffers in list)*(# of variables)
+    Kokkos::TeamPolicy<> policy(DevExeSpace(), (nfill_*nvar), Kokkos::AUTO);
     Kokkos::parallel_for("ProlCCSame", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-      const int m = (tmember.league_rank())/(nnghbr*nvar);
-      const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-      const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+      const int e = (tmember.league_rank())/nvar;
+      const int v = (tmember.league_rank()) - e*nvar;
+      const int m = flist.d_view(e)/nnghbr;
+      const int n = flist.d_view(e) - m*nnghbr;
 
       // only restrict when neighbor exists and is at SAME level
       if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev == mblev.d_view(m))) {
@@ -134,32 +136,74 @@ void MeshBoundaryValuesCC::FillCoarseInBndryCC(DvceArray5D<Real> &a,
 void MeshBoundaryValuesCC::ProlongateCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca,
     bool is_z4c) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
 
   // ptr to z4c, which requires different prolongation/restriction scheme
   //bool not_z4c = (pmbp->pz4c == nullptr)? true : false;
 
   int nvar = a.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
-  int nmnv = nmb*nnghbr*nvar;
   auto &nghbr = pmy_pack->pmb->nghbr;
   auto &mblev = pmy_pack->pmb->mb_lev;
   auto &rbuf = recvbuf;
   auto &indcs  = pmy_pack->pmesh->mb_indcs;
   const bool multi_d = pmy_pack->pmesh->multi_d;
   const bool three_d = pmy_pack->pmesh->three_d;
-  auto &nx1 = indcs.nx1;
-  auto &nx2 = indcs.nx2;
-  auto &nx3 = indcs.nx3;
-  auto& prolong_2nd = pmy_pack->pmesh->pmr->weights.prolong_2nd;
-  auto& prolong_4th = pmy_pack->pmesh->pmr->weights.prolong_4th;
-
-  // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), nmnv, Kokkos::AUTO);
+
+  // only buffers with neighbors at coarser level are prolongated
+  UpdateLevelLists();
+  if (nprol_ == 0) return;
+  auto &plist = prol_list_;
+
+  // High-order prolongation for Z4c: outer loop over buffers, with vector lanes over
+  // the (many) variables so the stencil geometry is computed once per coarse cell
+  if (is_z4c) {
+    const int ng = indcs.ng;
+    auto &wghts = pmy_pack->pmesh->pmr->weights;
+    ProlongWeights<2> wt2(wghts.prolong_2nd);
+    ProlongWeights<4> wt4(wghts.prolong_4th);
+    Kokkos::TeamPolicy<> zpolicy(DevExeSpace(), nprol_, Kokkos::AUTO, Kokkos::AUTO);
+    Kokkos::parallel_for("ProlCCVars", zpolicy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+      const int e = tmember.league_rank();
+      const int m = plist.d_view(e)/nnghbr;
+      const int n = plist.d_view(e) - m*nnghbr;
+
+      // only prolongate when neighbor exists and is at coarser level
+      if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
+        int il = rbuf[n].iprol[0].bis;
+        int jl = rbuf[n].iprol[0].bjs;
+        int kl = rbuf[n].iprol[0].bks;
+        const int ni = rbuf[n].iprol[0].bie - il + 1;
+        const int nj = rbuf[n].iprol[0].bje - jl + 1;
+        const int nk = rbuf[n].iprol[0].bke - kl + 1;
+        const int nji  = nj*ni;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nk*nji),
+        [&](const int idx) {
+          int k = idx/nji;
+          int j = (idx - k*nji)/ni;
+          int i = (idx - k*nji - j*ni) + il;
+          j += jl;
+          k += kl;
+          int fi = (i - indcs.cis)*2 + indcs.is;
+          int fj = (j - indcs.cjs)*2 + indcs.js;
+          int fk = (k - indcs.cks)*2 + indcs.ks;
+          if (ng == 2) {
+            HighOrderProlongCCVars<2>(tmember,m,nvar,k,j,i,fk,fj,fi,ca,a,wt2);
+          } else if (ng == 4) {
+            HighOrderProlongCCVars<4>(tmember,m,nvar,k,j,i,fk,fj,fi,ca,a,wt4);
+          }
+        });
+      }
+    });
+    return;
+  }
+
+  // Outer loop over (# of buffers at fine/coarse boundaries)*(# of variables)
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (nprol_*nvar), Kokkos::AUTO);
   Kokkos::parallel_for("ProlCC", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr*nvar);
-    const int n = (tmember.league_rank() - m*(nnghbr*nvar))/nvar;
-    const int v = (tmember.league_rank() - m*(nnghbr*nvar) - n*nvar);
+    const int e = (tmember.league_rank())/nvar;
+    const int v = (tmember.league_rank()) - e*nvar;
+    const int m = plist.d_view(e)/nnghbr;
+    const int n = plist.d_view(e) - m*nnghbr;
 
     // only prolongate when neighbor exists and is at coarser level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
@@ -190,18 +234,7 @@ void MeshBoundaryValuesCC::ProlongateCC(DvceArray5D<Real> &a, DvceArray5D<Real>
         int fj = (j - indcs.cjs)*2 + indcs.js;
         int fk = (k - indcs.cks)*2 + indcs.ks;
         // call inlined prolongation operator for CC variables
-        if (!is_z4c) {
-          ProlongCC(m,v,k,j,i,fk,fj,fi,multi_d,three_d,ca,a);
-        } else {
-          switch (indcs.ng) {
-            case 2: HighOrderProlongCC<2>(m,v,k,j,i,fk,fj,fi,nx1,nx2,nx3,
-                                          ca,a,prolong_2nd);
-                    break;
-            case 4: HighOrderProlongCC<4>(m,v,k,j,i,fk,fj,fi,nx1,nx2,nx3,
-                                          ca,a,prolong_4th);
-                    break;
-          }
-        }
+        ProlongCC(m,v,k,j,i,fk,fj,fi,multi_d,three_d,ca,a);
       });
       tmember.team_barrier();
     }
@@ -219,7 +252,6 @@ void MeshBoundaryValuesCC::ProlongateCC(DvceArray5D<Real> &a, DvceArray5D<Real>
 void MeshBoundaryValuesFC::FillCoarseInBndryFC(DvceFaceFld4D<Real> &b,
                                            DvceFaceFld4D<Real> &cb) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
 
   auto &nghbr = pmy_pack->pmb->nghbr;
@@ -231,18 +263,21 @@ void MeshBoundaryValuesFC::FillCoarseInBndryFC(DvceFaceFld4D<Real> &b,
   // Restrict data into coarse array in any boundary filled with data from the same
   // level. (Only needed in multidimensions)
 
-  if (multi_d) {
-    int nmnv = 3*nmb*nnghbr;
+  // Only MeshBlocks with a coarser neighbor need data in coarse array
+  UpdateLevelLists();
+  if (multi_d && (nfill_ > 0)) {
     auto &rbuf = recvbuf;
     auto &cis = indcs.cis;
     auto &cjs = indcs.cjs;
     auto &cks = indcs.cks;
-    // Outer loop over (# of MeshBlocks)*(# of buffers)*(# of variables)
-    Kokkos::TeamPolicy<> policy(DevExeSpace(), nmnv, Kokkos::AUTO);
+    auto &flist = fill_list_;
+    // Outer loop over (# of same-level buffers in list)*(three field components)
+    Kokkos::TeamPolicy<> policy(DevExeSpace(), (3*nfill_), Kokkos::AUTO);
     Kokkos::parallel_for("ProlFCSame", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-      const int m = (tmember.league_rank())/(3*nnghbr);
-      const int n = (tmember.league_rank() - m*(3*nnghbr))/3;
-      const int v = (tmember.league_rank() - m*(3*nnghbr) - 3*n);
+      const int e = (tmember.league_rank())/3;
+      const int v = (tmember.league_rank()) - 3*e;
+      const int m = flist.d_view(e)/nnghbr;
+      const int n = flist.d_view(e) - m*nnghbr;
 
       // only restrict when neighbor exists and is at SAME level
       if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev == mblev.d_view(m))) {
@@ -314,7 +349,6 @@ void MeshBoundaryValuesFC::FillCoarseInBndryFC(DvceFaceFld4D<Real> &b,
 
 void MeshBoundaryValuesFC::ProlongateFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb) {
   // create local references for variables in kernel
-  int nmb = pmy_pack->nmb_thispack;
   int nnghbr = pmy_pack->pmb->nnghbr;
 
   auto &nghbr = pmy_pack->pmb->nghbr;
@@ -327,14 +361,19 @@ void MeshBoundaryValuesFC::ProlongateFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Re
   // Code here is based on MeshRefinement::ProlongateSharedFieldX1/2/3() and
   // MeshRefinement::ProlongateInternalField() in C++ version
 
-  // Outer loop over (# of MeshBlocks)*(# of buffers)*(three field components)
-  {int nmnv = 3*nmb*nnghbr;
-  auto &rbuf = recvbuf;
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), nmnv, Kokkos::AUTO);
+  // only buffers with neighbors at coarser level are prolongated
+  UpdateLevelLists();
+  if (nprol_ == 0) return;
+  auto &plist = prol_list_;
+
+  // Outer loop over (# of buffers at fine/coarse boundaries)*(three field components)
+  {auto &rbuf = recvbuf;
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), (3*nprol_), Kokkos::AUTO);
   Kokkos::parallel_for("ProFC-2d-shared", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(3*nnghbr);
-    const int n = (tmember.league_rank() - m*(3*nnghbr))/3;
-    const int v = (tmember.league_rank() - m*(3*nnghbr) - 3*n);
+    const int e = (tmember.league_rank())/3;
+    const int v = (tmember.league_rank()) - 3*e;
+    const int m = plist.d_view(e)/nnghbr;
+    const int n = plist.d_view(e) - m*nnghbr;
 
     // only prolongate when neighbor exists and is at coarser level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
@@ -381,14 +420,13 @@ void MeshBoundaryValuesFC::ProlongateFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Re
   // Note prolongation at shared coarse/fine cell edges must be completed first as
   // interpolation formulae use these values.
 
-  // Outer loop over (# of MeshBlocks)*(# of buffers)
-  {int nmn = nmb*nnghbr;
-  bool &one_d = pmy_pack->pmesh->one_d;
+  // Outer loop over (# of buffers at fine/coarse boundaries)
+  {bool &one_d = pmy_pack->pmesh->one_d;
   auto &rbuf = recvbuf;
-  Kokkos::TeamPolicy<> policy(DevExeSpace(), nmn, Kokkos::AUTO);
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), nprol_, Kokkos::AUTO);
   Kokkos::parallel_for("ProFC-2d-int", policy, KOKKOS_LAMBDA(TeamMember_t tmember) {
-    const int m = (tmember.league_rank())/(nnghbr);
-    const int n = (tmember.league_rank() - m*(nnghbr));
+    const int m = plist.d_view(tmember.league_rank())/nnghbr;
+    const int n = plist.d_view(tmember.league_rank()) - m*nnghbr;
 
     // only prolongate when neighbor exists and is at coarser level
     if ((nghbr.d_view(m,n).gid >= 0) && (nghbr.d_view(m,n).lev < mblev.d_view(m))) {
@@ -15,6 +15,7 @@
 #include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "coordinates/adm.hpp"
+#include "coordinates/coordinates.hpp"
 
 // #define SMALL_NUMBER 1.0e-5
 
@@ -378,5 +379,141 @@ void ComputeMetricDerivatives(Real x, Real y, Real z, bool minkowski, Real a,
   return;
 }
 
+//----------------------------------------------------------------------------------------
+// Functions to store/load the metric in the optional cache in CoordData.  Components are
+// stored with mu<=nu: 10 components of g_{mu nu} followed by 10 of g^{mu nu}, and for the
+// derivatives 10 components each of d_x1 g_{mu nu}, d_x2 g_{mu nu}, d_x3 g_{mu nu}.
+
+static constexpr int NMETRIC_CACHE = 20;
+static constexpr int NMETRIC_DERIV_CACHE = 30;
+
+//----------------------------------------------------------------------------------------
+//! \fn void StoreMetricAndInverse
+//! \brief stores metric and inverse metric at one location in cache array g
+
+KOKKOS_INLINE_FUNCTION
+void StoreMetricAndInverse(const DvceArray5D<Real> &g, const int m, const int k,
+                           const int j, const int i, Real glower[][4], Real gupper[][4]) {
+  int n = 0;
+  for (int a=0; a<4; ++a) {
+    for (int b=a; b<4; ++b) {
+      g(m,n   ,k,j,i) = glower[a][b];
+      g(m,n+10,k,j,i) = gupper[a][b];
+      ++n;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LoadMetricAndInverse
+//! \brief loads metric and inverse metric at one location from cache array g
+
+KOKKOS_INLINE_FUNCTION
+void LoadMetricAndInverse(const DvceArray5D<Real> &g, const int m, const int k,
+                          const int j, const int i, Real glower[][4], Real gupper[][4]) {
+  int n = 0;
+  for (int a=0; a<4; ++a) {
+    for (int b=a; b<4; ++b) {
+      glower[a][b] = g(m,n   ,k,j,i);
+      gupper[a][b] = g(m,n+10,k,j,i);
+      glower[b][a] = glower[a][b];
+      gupper[b][a] = gupper[a][b];
+      ++n;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void StoreMetricDerivatives
+//! \brief stores derivatives of metric at one location in cache array dg
+
+KOKKOS_INLINE_FUNCTION
+void StoreMetricDerivatives(const DvceArray5D<Real> &dg, const int m, const int k,
+                            const int j, const int i,
+                            Real dg_dx1[][4], Real dg_dx2[][4], Real dg_dx3[][4]) {
+  int n = 0;
+  for (int a=0; a<4; ++a) {
+    for (int b=a; b<4; ++b) {
+      dg(m,n   ,k,j,i) = dg_dx1[a][b];
+      dg(m,n+10,k,j,i) = dg_dx2[a][b];
+      dg(m,n+20,k,j,i) = dg_dx3[a][b];
+      ++n;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LoadMetricDerivatives
+//! \brief loads derivatives of metric at one location from cache array dg
+
+KOKKOS_INLINE_FUNCTION
+void LoadMetricDerivatives(const DvceArray5D<Real> &dg, const int m, const int k,
+                           const int j, const int i,
+                           Real dg_dx1[][4], Real dg_dx2[][4], Real dg_dx3[][4]) {
+  int n = 0;
+  for (int a=0; a<4; ++a) {
+    for (int b=a; b<4; ++b) {
+      dg_dx1[a][b] = dg(m,n   ,k,j,i);
+      dg_dx2[a][b] = dg(m,n+10,k,j,i);
+      dg_dx3[a][b] = dg(m,n+20,k,j,i);
+      dg_dx1[b][a] = dg_dx1[a][b];
+      dg_dx2[b][a] = dg_dx2[a][b];
+      dg_dx3[b][a] = dg_dx3[a][b];
+      ++n;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CellMetricAndInverse
+//! \brief returns metric and inverse metric at the center of cell (m,k,j,i), located at
+//! (x,y,z), either from the cache or by computing it, depending on coord.metric_cache_cc
+
+KOKKOS_INLINE_FUNCTION
+void CellMetricAndInverse(const CoordData &coord, const int m, const int k, const int j,
+                          const int i, Real x, Real y, Real z,
+                          Real glower[][4], Real gupper[][4]) {
+  if (coord.metric_cache_cc) {
+    LoadMetricAndInverse(coord.gcc, m, k, j, i, glower, gupper);
+  } else {
+    ComputeMetricAndInverse(x, y, z, coord.is_minkowski, coord.bh_spin, glower, gupper);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CellMetricDerivatives
+//! \brief returns derivatives of metric at the center of cell (m,k,j,i), located at
+//! (x,y,z), either from the cache or by computing them
+
+KOKKOS_INLINE_FUNCTION
+void CellMetricDerivatives(const CoordData &coord, const int m, const int k, const int j,
+                           const int i, Real x, Real y, Real z,
+                           Real dg_dx1[][4], Real dg_dx2[][4], Real dg_dx3[][4]) {
+  if (coord.metric_cache_cc) {
+    LoadMetricDerivatives(coord.dgcc, m, k, j, i, dg_dx1, dg_dx2, dg_dx3);
+  } else {
+    ComputeMetricDerivatives(x, y, z, coord.is_minkowski, coord.bh_spin,
+                             dg_dx1, dg_dx2, dg_dx3);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void FaceMetricAndInverse
+//! \brief returns metric and inverse metric at the left face of cell (m,k,j,i) normal to
+//! direction ivx (IVX, IVY, IVZ), located at (x,y,z), either from the cache or by
+//! computing it, depending on coord.metric_cache_fc
+
+KOKKOS_INLINE_FUNCTION
+void FaceMetricAndInverse(const CoordData &coord, const int ivx, const int m, const int k,
+                          const int j, const int i, Real x, Real y, Real z,
+                          Real glower[][4], Real gupper[][4]) {
+  if (coord.metric_cache_fc) {
+    const DvceArray5D<Real> &g = (ivx == IVX)? coord.gx1f :
+                                ((ivx == IVY)? coord.gx2f : coord.gx3f);
+    LoadMetricAndInverse(g, m, k, j, i, glower, gupper);
+  } else {
+    ComputeMetricAndInverse(x, y, z, coord.is_minkowski, coord.bh_spin, glower, gupper);
+  }
+}
 
 #endif // COORDINATES_CARTESIAN_KS_HPP_
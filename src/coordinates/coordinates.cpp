@@ -5,10 +5,12 @@
 //========================================================================================
 //! \file coordinates.cpp
 //! \brief
+#include <algorithm>
 #include <iostream> // cout
 #include <string>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "mesh/mesh.hpp"
 #include "eos/eos.hpp"
 #include "cartesian_ks.hpp"
@@ -40,6 +42,10 @@ Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
     std::exit(EXIT_FAILURE);
   }
 
+  // metric cache is off unless requested below
+  coord_data.metric_cache_cc = false;
+  coord_data.metric_cache_fc = false;
+
   // Read properties of metric and excision from input file for GR.
   if (is_general_relativistic || is_dynamical_relativistic) {
     coord_data.is_minkowski = pin->GetOrAddBoolean("coord","minkowski",false);
@@ -70,6 +76,10 @@ Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
         } else if (emethod.compare("lapse") == 0) {
           coord_data.excision_scheme = ExcisionScheme::lapse;
           coord_data.excise_lapse = pin->GetOrAddReal("coord","excise_lapse", 0.25);
+        } else if (emethod.compare("horizon") == 0) {
+          coord_data.excision_scheme = ExcisionScheme::horizon;
+          coord_data.excise_horizon_frac =
+            pin->GetOrAddReal("coord","excise_horizon_frac", 0.8);
         } else {
           std::cout << "### FATAL ERROR in " << __FILE__ << " at line "
                     << __LINE__ << std::endl
@@ -78,19 +88,130 @@ Coordinates::Coordinates(ParameterInput *pin, MeshBlockPack *ppack) :
         }
       }
 
-      // boolean masks allocation
-      int nmb = ppack->nmb_thispack;
+      // boolean masks allocation (sized for max number of MBs so AMR can reuse them)
+      int nmb = std::max((ppack->nmb_thispack), (ppack->pmesh->nmb_maxperrank));
       auto &indcs = pmy_pack->pmesh->mb_indcs;
       int ncells1 = indcs.nx1 + 2*(indcs.ng);
       int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
       int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
       Kokkos::realloc(excision_floor, nmb, ncells3, ncells2, ncells1);
       Kokkos::realloc(excision_flux, nmb, ncells3, ncells2, ncells1);
+      // optionally skip MBs entirely inside the excision region.  With the lapse and
+      // horizon schemes, MBs are marked each time the masks are updated.
+      skip_excised_mb = pin->GetOrAddBoolean("coord","skip_excised_mb",false);
+      if (skip_excised_mb && pin->DoesBlockExist("radiation") &&
+          global_variable::my_rank == 0) {
+        std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<coord>/skip_excised_mb only freezes Hydro/MHD in "
+                  << "fully excised MeshBlocks, Radiation is still evolved there"
+                  << std::endl;
+      }
       if (coord_data.excision_scheme == ExcisionScheme::fixed) {
         SetExcisionMasks(excision_floor, excision_flux);
+        if (skip_excised_mb) {MarkExcisedMeshBlocks();}
       }
     }
   }
+
+  // Optionally cache the stationary metric of GR, trading memory for FLOPs in kernels.
+  // Options are "none", "cell" (metric, inverse and derivatives at cell centers, 50
+  // values per cell), and "all" (also metric and inverse at faces, 110 values per cell).
+  if (is_general_relativistic) {
+    std::string cache = pin->GetOrAddString("coord","metric_cache","none");
+    if (cache.compare("none") == 0) {
+      // metric computed in kernels where needed
+    } else if (cache.compare("cell") == 0) {
+      coord_data.metric_cache_cc = true;
+    } else if (cache.compare("all") == 0) {
+      coord_data.metric_cache_cc = true;
+      coord_data.metric_cache_fc = true;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<coord>/metric_cache = '" << cache << "' not "
+                << "recognized, must be 'none', 'cell', or 'all'" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (coord_data.metric_cache_cc) {SetMetricCache();}
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::SetMetricCache()
+//! \brief Allocates and fills the cache of the (stationary) GR metric over all cells of
+//! all MBs in the pack (including ghost zones), at cell centers and optionally at faces.
+//! Called on construction and whenever the MeshBlocks in the pack change with AMR.
+
+void Coordinates::SetMetricCache() {
+  if (!(coord_data.metric_cache_cc)) {return;}
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  // sized for max number of MBs so AMR can reuse the storage
+  int nmb = std::max((pmy_pack->nmb_thispack), (pmy_pack->pmesh->nmb_maxperrank));
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  if (static_cast<int>(coord_data.gcc.extent(0)) < nmb) {
+    Kokkos::realloc(coord_data.gcc, nmb, NMETRIC_CACHE, ncells3, ncells2, ncells1);
+    Kokkos::realloc(coord_data.dgcc, nmb, NMETRIC_DERIV_CACHE, ncells3, ncells2, ncells1);
+    if (coord_data.metric_cache_fc) {
+      Kokkos::realloc(coord_data.gx1f, nmb, NMETRIC_CACHE, ncells3, ncells2, ncells1+1);
+      Kokkos::realloc(coord_data.gx2f, nmb, NMETRIC_CACHE, ncells3, ncells2+1, ncells1);
+      Kokkos::realloc(coord_data.gx3f, nmb, NMETRIC_CACHE, ncells3+1, ncells2, ncells1);
+    }
+  }
+
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &flat = coord_data.is_minkowski;
+  auto &spin = coord_data.bh_spin;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  auto gcc_ = coord_data.gcc;
+  auto dgcc_ = coord_data.dgcc;
+  par_for("metric_cc", DevExeSpace(), 0, nmb1, 0, ncells3-1, 0, ncells2-1, 0, ncells1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real x1v = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real x2v = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real x3v = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real glower[4][4], gupper[4][4];
+    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    StoreMetricAndInverse(gcc_, m, k, j, i, glower, gupper);
+    Real dg_dx1[4][4], dg_dx2[4][4], dg_dx3[4][4];
+    ComputeMetricDerivatives(x1v, x2v, x3v, flat, spin, dg_dx1, dg_dx2, dg_dx3);
+    StoreMetricDerivatives(dgcc_, m, k, j, i, dg_dx1, dg_dx2, dg_dx3);
+  });
+  if (!(coord_data.metric_cache_fc)) {return;}
+
+  auto gx1f_ = coord_data.gx1f;
+  par_for("metric_x1f", DevExeSpace(), 0, nmb1, 0, ncells3-1, 0, ncells2-1, 0, ncells1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real x1f = LeftEdgeX  (i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real x2v = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real x3v = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real glower[4][4], gupper[4][4];
+    ComputeMetricAndInverse(x1f, x2v, x3v, flat, spin, glower, gupper);
+    StoreMetricAndInverse(gx1f_, m, k, j, i, glower, gupper);
+  });
+  auto gx2f_ = coord_data.gx2f;
+  par_for("metric_x2f", DevExeSpace(), 0, nmb1, 0, ncells3-1, 0, ncells2, 0, ncells1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real x1v = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real x2f = LeftEdgeX  (j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real x3v = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real glower[4][4], gupper[4][4];
+    ComputeMetricAndInverse(x1v, x2f, x3v, flat, spin, glower, gupper);
+    StoreMetricAndInverse(gx2f_, m, k, j, i, glower, gupper);
+  });
+  auto gx3f_ = coord_data.gx3f;
+  par_for("metric_x3f", DevExeSpace(), 0, nmb1, 0, ncells3, 0, ncells2-1, 0, ncells1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real x1v = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+    Real x2v = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+    Real x3f = LeftEdgeX  (k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+    Real glower[4][4], gupper[4][4];
+    ComputeMetricAndInverse(x1v, x2v, x3f, flat, spin, glower, gupper);
+    StoreMetricAndInverse(gx3f_, m, k, j, i, glower, gupper);
+  });
+  return;
 }
 
 //----------------------------------------------------------------------------------------
@@ -105,8 +226,7 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim, const EOS_Data &e
   int js = indcs.js; int je = indcs.je;
   int ks = indcs.ks; int ke = indcs.ke;
   auto &size = pmy_pack->pmb->mb_size;
-  auto &flat = coord_data.is_minkowski;
-  auto &spin = coord_data.bh_spin;
+  auto &coord = coord_data;
 
   Real gamma_prime = eos.gamma / (eos.gamma - 1.0);
 
@@ -127,7 +247,7 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim, const EOS_Data &e
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    CellMetricAndInverse(coord, m, k, j, i, x1v, x2v, x3v, glower, gupper);
 
     // Extract primitives
     const Real &rho  = prim(m,IDN,k,j,i);
@@ -164,7 +284,7 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim, const EOS_Data &e
 
     // compute derivates of metric.
     Real dg_dx1[4][4], dg_dx2[4][4], dg_dx3[4][4];
-    ComputeMetricDerivatives(x1v, x2v, x3v, flat, spin, dg_dx1, dg_dx2, dg_dx3);
+    CellMetricDerivatives(coord, m, k, j, i, x1v, x2v, x3v, dg_dx1, dg_dx2, dg_dx3);
 
     // Calculate source terms, exploiting symmetries
     Real s_1 = 0.0, s_2 = 0.0, s_3 = 0.0;
@@ -228,8 +348,7 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim,
   int js = indcs.js; int je = indcs.je;
   int ks = indcs.ks; int ke = indcs.ke;
   auto &size = pmy_pack->pmb->mb_size;
-  auto &flat = coord_data.is_minkowski;
-  auto &spin = coord_data.bh_spin;
+  auto &coord = coord_data;
 
   Real gamma_prime = eos.gamma / (eos.gamma - 1.0);
 
@@ -250,7 +369,7 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim,
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    CellMetricAndInverse(coord, m, k, j, i, x1v, x2v, x3v, glower, gupper);
 
     // Extract primitives
     const Real &rho  = prim(m,IDN,k,j,i);
@@ -308,7 +427,7 @@ void Coordinates::CoordSrcTerms(const DvceArray5D<Real> &prim,
 
     // compute derivates of metric.
     Real dg_dx1[4][4], dg_dx2[4][4], dg_dx3[4][4];
-    ComputeMetricDerivatives(x1v, x2v, x3v, flat, spin, dg_dx1, dg_dx2, dg_dx3);
+    CellMetricDerivatives(coord, m, k, j, i, x1v, x2v, x3v, dg_dx1, dg_dx2, dg_dx3);
 
     // Calculate source terms
     Real s_1 = 0.0, s_2 = 0.0, s_3 = 0.0;
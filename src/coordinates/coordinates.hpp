@@ -11,6 +11,8 @@
 //! computing positions.  In GR, also provides inline metric functions (currently only
 //! Cartesian Kerr-Schild)
 
+#include <vector>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
@@ -21,7 +23,8 @@ struct EOS_Data;
 // Enumerator for the excision method
 enum class ExcisionScheme {
   fixed,
-  lapse
+  lapse,
+  horizon
 };
 
 //----------------------------------------------------------------------------------------
@@ -41,6 +44,13 @@ struct CoordData {
   Real flux_excise_r;              // reduce to first-order inside this radius
   ExcisionScheme excision_scheme;  // excision method
   Real excise_lapse;               // if excision_scheme = lapse, excise under this lapse
+  Real excise_horizon_frac;        // if excision_scheme = horizon, excise within this
+                                   // fraction of the minimum radius of each horizon
+  // optional cache of the (stationary) metric, filled by Coordinates::SetMetricCache()
+  bool metric_cache_cc;            // use cached metric and derivatives at cell centers
+  bool metric_cache_fc;            // use cached metric at cell faces
+  DvceArray5D<Real> gcc, dgcc;     // metric/inverse and derivatives at cell centers
+  DvceArray5D<Real> gx1f, gx2f, gx3f;  // metric/inverse at x1-, x2-, x3-faces
 };
 
 //----------------------------------------------------------------------------------------
@@ -63,6 +73,11 @@ class Coordinates {
   // excision masks
   DvceArray4D<bool> excision_floor;  // cell-centered mask for C2P flooring about horizon
   DvceArray4D<bool> excision_flux;   // cell-centered mask for FOFC about horizon
+  bool skip_excised_mb = false;      // do not update MBs that are entirely excised
+  // (x,y,z,r) of each sphere excised with excision_scheme = horizon, set by the
+  // apparent horizon finders of z4c (at most kMaxExcisionSpheres are used)
+  static constexpr int kMaxExcisionSpheres = 4;
+  std::vector<Real> excision_spheres;
 
   // functions
   void CoordSrcTerms(const DvceArray5D<Real> &w0, const EOS_Data &eos, const Real dt,
@@ -70,8 +85,11 @@ class Coordinates {
   void CoordSrcTerms(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc,
                      const EOS_Data &eos, const Real dt, DvceArray5D<Real> &u0);
   void SetExcisionMasks(DvceArray4D<bool> &floor, DvceArray4D<bool> &flux);
+  void SetMetricCache();
 
   void UpdateExcisionMasks();
+  void ResetExcisionMasks();
+  void MarkExcisedMeshBlocks();
 
  private:
   MeshBlockPack* pmy_pack;
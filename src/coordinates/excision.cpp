@@ -8,8 +8,12 @@
 
 #include <float.h>
 
+#include <algorithm>
+
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
 #include "coordinates.hpp"
 #include "cell_locations.hpp"
 #include "coordinates/adm.hpp"
@@ -187,5 +191,140 @@ void Coordinates::UpdateExcisionMasks() {
       floor(m,k,j,i) = excise;
       flux(m,k,j,i) = excise;
     });
+  } else if (coord_data.excision_scheme == ExcisionScheme::horizon) {
+    // capture variables for kernel
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    int is = indcs.is; int js = indcs.js; int ks = indcs.ks;
+    int &ng = indcs.ng;
+    int n1 = indcs.nx1 + 2*ng;
+    int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+    int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+    int nmb1 = pmy_pack->nmb_thispack - 1;
+    auto &size = pmy_pack->pmb->mb_size;
+    auto &floor = excision_floor;
+    auto &flux = excision_flux;
+
+    // spheres inside the apparent horizons found by z4c
+    int nsph = std::min(static_cast<int>(excision_spheres.size())/4,
+                        kMaxExcisionSpheres);
+    Real sph[4*kMaxExcisionSpheres];
+    for (int n=0; n<4*nsph; ++n) {sph[n] = excision_spheres[n];}
+
+    par_for("set_excision", DevExeSpace(), 0, nmb1, 0, (n3-1), 0, (n2-1), 0, (n1-1),
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real x1v = CellCenterX(i-is, indcs.nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+      Real x2v = CellCenterX(j-js, indcs.nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+      Real x3v = CellCenterX(k-ks, indcs.nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+      bool excise = false;
+      for (int s=0; s<nsph; ++s) {
+        Real r2 = SQR(x1v - sph[4*s]) + SQR(x2v - sph[4*s+1]) + SQR(x3v - sph[4*s+2]);
+        excise = excise || (r2 < SQR(sph[4*s+3]));
+      }
+      floor(m,k,j,i) = excise;
+      flux(m,k,j,i) = excise;
+    });
+  }
+  if (skip_excised_mb && (coord_data.excision_scheme != ExcisionScheme::fixed)) {
+    MarkExcisedMeshBlocks();
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::ResetExcisionMasks()
+//! \brief Resets excision masks after the MeshBlocks in the pack change with AMR, in
+//! place of constructing new Coordinates.  Fixed masks are recomputed, lapse- and
+//! horizon-based masks are cleared until the next call to UpdateExcisionMasks().
+
+void Coordinates::ResetExcisionMasks() {
+  if (!(is_general_relativistic || is_dynamical_relativistic) ||
+      !(coord_data.bh_excise)) {
+    return;
+  }
+  Kokkos::deep_copy(excision_floor, false);
+  Kokkos::deep_copy(excision_flux, false);
+  if (coord_data.excision_scheme == ExcisionScheme::fixed) {
+    SetExcisionMasks(excision_floor, excision_flux);
+    if (skip_excised_mb) {MarkExcisedMeshBlocks();}
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Coordinates::MarkExcisedMeshBlocks()
+//! \brief Marks MBs in which every cell (including ghost zones) is masked for flooring by
+//! the excision as inactive, so Hydro/MHD/DynGRMHD fluxes, updates and C2P skip them.
+//! The state inside these MBs is then frozen at its floor values until they are
+//! reactivated by a later update of the (lapse or horizon) masks.  Radiation (and z4c)
+//! are still evolved in all MBs.
+//!
+//! Fluxes of inactive MBs are not computed, but are still sent in the flux correction
+//! step: to coarser neighbors, which replace their own fluxes with them, and for EMFs
+//! also to neighbors at the same level, which average them with their own.  So MBs with
+//! a coarser neighbor are left active, and the fluxes and EMFs of inactive MBs are zeroed
+//! rather than left at values from before they were marked.  Same-level neighbors then
+//! only average a zero EMF into edges bordering cells that are masked for flooring
+//! (since they lie in the ghost zones of the inactive MB).
+
+void Coordinates::MarkExcisedMeshBlocks() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  const int nji = n2*n1;
+  const int nkji = n3*n2*n1;
+  int nmb = pmy_pack->nmb_thispack;
+  auto &floor = excision_floor;
+
+  // count cells in each MB that are not excised
+  DvceArray1D<int> nactive("nactive", nmb);
+  par_for_outer("excised_mb", DevExeSpace(), 0, 0, 0, (nmb-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+    int team_sum = 0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+    [=](const int idx, int &sum) {
+      int k = (idx)/nji;
+      int j = (idx - k*nji)/n1;
+      int i = (idx - k*nji - j*n1);
+      if (!(floor(m,k,j,i))) {sum += 1;}
+    }, team_sum);
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {nactive(m) = team_sum;});
+  });
+
+  auto h_nactive = Kokkos::create_mirror_view_and_copy(HostMemSpace(), nactive);
+  auto &nghbr = pmy_pack->pmb->nghbr;
+  auto &mblev = pmy_pack->pmb->mb_lev;
+  int nnghbr = pmy_pack->pmb->nnghbr;
+  HostArray1D<bool> active("active", nmb);
+  for (int m=0; m<nmb; ++m) {
+    active(m) = (h_nactive(m) > 0);
+    for (int n=0; n<nnghbr; ++n) {
+      if ((nghbr.h_view(m,n).gid >= 0) && (nghbr.h_view(m,n).lev < mblev.h_view(m))) {
+        active(m) = true;
+      }
+    }
+  }
+  pmy_pack->pmb->SetActiveMeshBlocks(active);
+
+  // zero fluxes and EMFs sent by inactive MBs in the flux correction step (physics
+  // modules do not yet exist when called from the Coordinates constructor)
+  for (int m=0; m<nmb; ++m) {
+    if (active(m)) continue;
+    auto all = Kokkos::ALL;
+    if (pmy_pack->phydro != nullptr) {
+      auto &flx = pmy_pack->phydro->uflx;
+      Kokkos::deep_copy(Kokkos::subview(flx.x1f, m, all, all, all, all), 0.0);
+      Kokkos::deep_copy(Kokkos::subview(flx.x2f, m, all, all, all, all), 0.0);
+      Kokkos::deep_copy(Kokkos::subview(flx.x3f, m, all, all, all, all), 0.0);
+    }
+    if (pmy_pack->pmhd != nullptr) {
+      auto &flx = pmy_pack->pmhd->uflx;
+      Kokkos::deep_copy(Kokkos::subview(flx.x1f, m, all, all, all, all), 0.0);
+      Kokkos::deep_copy(Kokkos::subview(flx.x2f, m, all, all, all, all), 0.0);
+      Kokkos::deep_copy(Kokkos::subview(flx.x3f, m, all, all, all, all), 0.0);
+      auto &efld = pmy_pack->pmhd->efld;
+      Kokkos::deep_copy(Kokkos::subview(efld.x1e, m, all, all, all), 0.0);
+      Kokkos::deep_copy(Kokkos::subview(efld.x2e, m, all, all, all), 0.0);
+      Kokkos::deep_copy(Kokkos::subview(efld.x3e, m, all, all, all), 0.0);
+    }
   }
 }
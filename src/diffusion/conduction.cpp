@@ -5,7 +5,8 @@
 //========================================================================================
 //! \file conduction.cpp
 //! \brief Implements functions for Conduction class. This includes isotropic thermal
-//! conduction, in which heat flux is proportional to negative local temperature gradient.
+//! conduction, in which heat flux is proportional to negative local temperature gradient,
+//! and anisotropic (Braginskii) conduction along magnetic field lines in MHD.
 //! Conduction may be added to Hydro and/or MHD independently.
 
 #include <float.h>
@@ -81,6 +82,13 @@ Conduction::Conduction(std::string block, MeshBlockPack *pp, ParameterInput *pin
   kappa_ceiling = pin->GetOrAddReal(block,"cond_ceiling",
                   static_cast<Real>(std::numeric_limits<float>::max()));
   sat_hflux = pin->GetOrAddBoolean(block,"sat_hflux",false);
+  kappa_aniso = pin->GetOrAddReal(block,"aniso_conductivity",0.0);
+  if ((kappa_aniso > 0.0) && (block.compare("mhd") != 0)) {
+    std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+              << "Anisotropic conduction requires a magnetic field, and can only be "
+              << "used in the <mhd> block" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -104,6 +112,21 @@ void Conduction::AddHeatFlux(const DvceArray5D<Real> &w0, const EOS_Data &eos,
   }
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void AddHeatFlux()
+//! \brief Adds isotropic and anisotropic heat fluxes to face-centered fluxes of
+//! conserved variables in MHD.  Only the energy flux is modified, so the same function
+//! can be used for the flux of the main integrator or of a super-time-stepping stage.
+
+void Conduction::AddHeatFlux(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
+  const EOS_Data &eos, DvceFaceFld5D<Real> &flx) {
+  AddHeatFlux(w0, eos, flx);
+  if (kappa_aniso > 0.0) {
+    AnisotropicHeatFlux(w0, bcc0, eos, flx);
+  }
+  return;
+}
 //----------------------------------------------------------------------------------------
 //! \fn void IsotropicHeatFlux()
 //! \brief Adds isotropic heat flux to face-centered fluxes of conserved variables
@@ -399,6 +422,141 @@ void Conduction::TempDependentHeatFlux(const DvceArray5D<Real> &w0, const EOS_Da
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void AnisotropicHeatFlux()
+//! \brief Adds anisotropic heat flux q = -kappa_aniso b (b.grad T), where b is the unit
+//! vector along the magnetic field, to face-centered fluxes of conserved variables.
+//! Transverse temperature gradients at each face are limited with the monotonized
+//! (van Leer) average of Sharma & Hammett (2007), JCP 227, 123, so that heat cannot flow
+//! from cold to hot cells.
+//!
+//! Fluxes in all three directions are computed in a single kernel.  Each team loads the
+//! temperature in the 3x3 pencils (k-1:k+1, j-1:j+1), and the cell-centered field in the
+//! pencils (k,j), (k,j-1), (k-1,j) into scratch memory, and then computes the x1-flux at
+//! faces (k,j,i-1/2), the x2-flux at faces (k,j-1/2,i), and the x3-flux at faces
+//! (k-1/2,j,i).  Teams are launched over ks:ke+1 and js:je+1 to cover the upper faces.
+
+void Conduction::AnisotropicHeatFlux(const DvceArray5D<Real> &w0,
+  const DvceArray5D<Real> &bcc0, const EOS_Data &eos, DvceFaceFld5D<Real> &flx) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  auto size = pmy_pack->pmb->mb_size;
+  const bool &use_e = eos.use_e;
+  const bool multi_d = pmy_pack->pmesh->multi_d;
+  const bool three_d = pmy_pack->pmesh->three_d;
+  Real gm1 = eos.gamma-1.0;
+  Real kappa_ = kappa_aniso;
+  // offsets of neighboring pencils in x2/x3 (zero in lower dimensions, in which case
+  // transverse differences vanish identically)
+  const int dj = (multi_d)? 1 : 0;
+  const int dk = (three_d)? 1 : 0;
+  int ju = (multi_d)? je+1 : je;
+  int ku = (three_d)? ke+1 : ke;
+  auto &flx1 = flx.x1f;
+  auto &flx2 = flx.x2f;
+  auto &flx3 = flx.x3f;
+
+  int scr_level = 0;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(9, ncells1) * 2;
+
+  par_for_outer("conduct_aniso", DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ku,
+                js, ju,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    // temperature in pencil (k+dk*(r/3-1), j+dj*(r%3-1)), so that row 4 is (k,j)
+    ScrArray2D<Real> temp(member.team_scratch(scr_level), 9, ncells1);
+    // B in pencils (k,j) [rows 0-2], (k,j-1) [rows 3-5], and (k-1,j) [rows 6-8]
+    ScrArray2D<Real> bfld(member.team_scratch(scr_level), 9, ncells1);
+
+    for (int r=0; r<9; ++r) {
+      const int kk = k + dk*(r/3 - 1);
+      const int jj = j + dj*(r%3 - 1);
+      par_for_inner(member, is-1, ie+1, [&](const int i) {
+        if (use_e) {
+          temp(r,i) = w0(m,IEN,kk,jj,i)/w0(m,IDN,kk,jj,i)*gm1;
+        } else {
+          temp(r,i) = w0(m,ITM,kk,jj,i);
+        }
+      });
+    }
+    for (int r=0; r<3; ++r) {
+      const int kk = (r == 2)? k-dk : k;
+      const int jj = (r == 1)? j-dj : j;
+      par_for_inner(member, is-1, ie+1, [&](const int i) {
+        bfld(3*r  ,i) = bcc0(m,IBX,kk,jj,i);
+        bfld(3*r+1,i) = bcc0(m,IBY,kk,jj,i);
+        bfld(3*r+2,i) = bcc0(m,IBZ,kk,jj,i);
+      });
+    }
+    member.team_barrier();
+
+    const Real dx1 = size.d_view(m).dx1;
+    const Real dx2 = size.d_view(m).dx2;
+    const Real dx3 = size.d_view(m).dx3;
+
+    // x1-fluxes at faces (k,j,i-1/2)
+    if (k <= ke && j <= je) {
+      par_for_inner(member, is, ie+1, [&](const int i) {
+        Real bx = 0.5*(bfld(0,i-1) + bfld(0,i));
+        Real by = 0.5*(bfld(1,i-1) + bfld(1,i));
+        Real bz = 0.5*(bfld(2,i-1) + bfld(2,i));
+        Real bsq = bx*bx + by*by + bz*bz;
+        if (bsq > 0.0) {
+          Real dtdx1 = (temp(4,i) - temp(4,i-1))/dx1;
+          Real dtdx2 = VL4Limiter(temp(5,i) - temp(4,i), temp(4,i) - temp(3,i),
+                                  temp(5,i-1) - temp(4,i-1),
+                                  temp(4,i-1) - temp(3,i-1))/dx2;
+          Real dtdx3 = VL4Limiter(temp(7,i) - temp(4,i), temp(4,i) - temp(1,i),
+                                  temp(7,i-1) - temp(4,i-1),
+                                  temp(4,i-1) - temp(1,i-1))/dx3;
+          flx1(m,IEN,k,j,i) -= kappa_*bx*(bx*dtdx1 + by*dtdx2 + bz*dtdx3)/bsq;
+        }
+      });
+    }
+
+    // x2-fluxes at faces (k,j-1/2,i)
+    if (multi_d && k <= ke) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        Real bx = 0.5*(bfld(3,i) + bfld(0,i));
+        Real by = 0.5*(bfld(4,i) + bfld(1,i));
+        Real bz = 0.5*(bfld(5,i) + bfld(2,i));
+        Real bsq = bx*bx + by*by + bz*bz;
+        if (bsq > 0.0) {
+          Real dtdx1 = VL4Limiter(temp(4,i+1) - temp(4,i), temp(4,i) - temp(4,i-1),
+                                  temp(3,i+1) - temp(3,i), temp(3,i) - temp(3,i-1))/dx1;
+          Real dtdx2 = (temp(4,i) - temp(3,i))/dx2;
+          Real dtdx3 = VL4Limiter(temp(7,i) - temp(4,i), temp(4,i) - temp(1,i),
+                                  temp(6,i) - temp(3,i), temp(3,i) - temp(0,i))/dx3;
+          flx2(m,IEN,k,j,i) -= kappa_*by*(bx*dtdx1 + by*dtdx2 + bz*dtdx3)/bsq;
+        }
+      });
+    }
+
+    // x3-fluxes at faces (k-1/2,j,i)
+    if (three_d && j <= je) {
+      par_for_inner(member, is, ie, [&](const int i) {
+        Real bx = 0.5*(bfld(6,i) + bfld(0,i));
+        Real by = 0.5*(bfld(7,i) + bfld(1,i));
+        Real bz = 0.5*(bfld(8,i) + bfld(2,i));
+        Real bsq = bx*bx + by*by + bz*bz;
+        if (bsq > 0.0) {
+          Real dtdx1 = VL4Limiter(temp(4,i+1) - temp(4,i), temp(4,i) - temp(4,i-1),
+                                  temp(1,i+1) - temp(1,i), temp(1,i) - temp(1,i-1))/dx1;
+          Real dtdx2 = VL4Limiter(temp(5,i) - temp(4,i), temp(4,i) - temp(3,i),
+                                  temp(2,i) - temp(1,i), temp(1,i) - temp(0,i))/dx2;
+          Real dtdx3 = (temp(4,i) - temp(1,i))/dx3;
+          flx3(m,IEN,k,j,i) -= kappa_*bz*(bx*dtdx1 + by*dtdx2 + bz*dtdx3)/bsq;
+        }
+      });
+    }
+  });
+
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Conduction::NewTimeStep()
 //! \brief Compute new time step for thermal conduction.
@@ -424,6 +582,7 @@ void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
   Real kappa0 = kappa;
   bool tdepkappa = tdep_kappa;
   Real kappaceil = kappa_ceiling;
+  Real kappaaniso = kappa_aniso;
   Real fac;
   if (pmy_pack->pmesh->three_d) {
     fac = 1.0/6.0;
@@ -460,6 +619,8 @@ void Conduction::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
       }
       kappa_ = KappaTemp(temp*temp_unit,kappaceil)/kappa_unit;
     }
+    // diffusion along the field is limited by the same condition as isotropic case
+    kappa_ += kappaaniso;
 
     min_dt = fmin(min_dt, SQR(size.d_view(m).dx1)/kappa_*w0_(m,IDN,k,j,i)/gm1);
     if (multi_d) {
@@ -7,7 +7,9 @@
 //========================================================================================
 //! \file conduction.hpp
 //! \brief Contains data and functions that implement various formulations for conduction.
-//  Currently only isotropic conduction implemented
+//  Isotropic conduction (with constant or temperature-dependent conductivity) is
+//  implemented for Hydro and MHD, and anisotropic (Braginskii) conduction along the
+//  magnetic field for MHD only.
 
 #include <string>
 
@@ -29,14 +31,19 @@ class Conduction {
   bool tdep_kappa;    // temperature-dependent conductivity
   Real kappa_ceiling; // ceiling of thermal conductivity
   bool sat_hflux;     // saturtion of heat flux
+  Real kappa_aniso;   // conductivity parallel to magnetic field (MHD only)
 
   // function to add heat fluxes to Hydro and/or MHD fluxes
   void AddHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
                    DvceFaceFld5D<Real> &f);
+  void AddHeatFlux(const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc,
+                   const EOS_Data &eos, DvceFaceFld5D<Real> &f);
   void IsotropicHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
                          DvceFaceFld5D<Real> &f);
   void TempDependentHeatFlux(const DvceArray5D<Real> &w, const EOS_Data &eos,
                              DvceFaceFld5D<Real> &f);
+  void AnisotropicHeatFlux(const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc,
+                           const EOS_Data &eos, DvceFaceFld5D<Real> &f);
   void NewTimeStep(const DvceArray5D<Real> &w, const EOS_Data &eos_data);
 
  private:
@@ -15,13 +15,14 @@
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "resistivity.hpp"
-#include "current_density.hpp"
 
 //----------------------------------------------------------------------------------------
 // ctor: also calls Resistivity base class constructor
 
 Resistivity::Resistivity(MeshBlockPack *pp, ParameterInput *pin) :
-  pmy_pack(pp) {
+  pmy_pack(pp),
+  jcurr("jcurr",1,1,1,1),
+  jcurr_valid(false) {
   // Read parameters for Ohmic diffusion (if any)
   eta_ohm = pin->GetReal("mhd","ohmic_resistivity");
 
@@ -41,6 +42,16 @@ Resistivity::Resistivity(MeshBlockPack *pp, ParameterInput *pin) :
     if (pp->pmesh->multi_d) {dtnew = std::min(dtnew,fac*SQR(size.h_view(m).dx2)/eta_ohm);}
     if (pp->pmesh->three_d) {dtnew = std::min(dtnew,fac*SQR(size.h_view(m).dx3)/eta_ohm);}
   }
+
+  // allocate edge-centered current density, with same dimensions as E-field in MHD
+  int nmb = std::max((pp->nmb_thispack), (pp->pmesh->nmb_maxperrank));
+  auto &indcs = pp->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  Kokkos::realloc(jcurr.x1e, nmb, ncells3+1, ncells2+1, ncells1);
+  Kokkos::realloc(jcurr.x2e, nmb, ncells3+1, ncells2, ncells1+1);
+  Kokkos::realloc(jcurr.x3e, nmb, ncells3, ncells2+1, ncells1+1);
 }
 
 //----------------------------------------------------------------------------------------
@@ -49,113 +60,143 @@ Resistivity::Resistivity(MeshBlockPack *pp, ParameterInput *pin) :
 Resistivity::~Resistivity() {
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn CalculateCurrent()
+//  \brief Calculates the three components of the current density J = Curl(B) at cell
+//  edges, where each component of J is centered identically to the edge-electric-field
+//  (see current_density.hpp).  J is stored in jcurr and shared by all resistive terms
+//  in a stage: it is computed once from b0 before the fluxes are calculated, and then
+//  used for both the resistive energy flux and the resistive E-field in CornerE.
+//  Derivatives in directions that are not resolved are omitted, so in 1D/2D the values
+//  at ke+1 (and je+1) are those given by the upper face-centered fields.
+
+void Resistivity::CalculateCurrent(const DvceFaceFld4D<Real> &b0) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nmb = pmy_pack->nmb_thispack;
+  const bool multi_d = pmy_pack->pmesh->multi_d;
+  const bool three_d = pmy_pack->pmesh->three_d;
+  // J2 is centered at j (no edge at je+1 in 1D), and J3 at k (no edge at ke+1 in 2D)
+  int ju2 = (multi_d)? je+1 : je;
+  int ku3 = (three_d)? ke+1 : ke;
+
+  // reallocate if number of MeshBlocks in pack has grown (e.g. with AMR)
+  if (jcurr.x1e.extent_int(0) < nmb) {
+    Kokkos::realloc(jcurr.x1e, nmb, jcurr.x1e.extent(1), jcurr.x1e.extent(2),
+                    jcurr.x1e.extent(3));
+    Kokkos::realloc(jcurr.x2e, nmb, jcurr.x2e.extent(1), jcurr.x2e.extent(2),
+                    jcurr.x2e.extent(3));
+    Kokkos::realloc(jcurr.x3e, nmb, jcurr.x3e.extent(1), jcurr.x3e.extent(2),
+                    jcurr.x3e.extent(3));
+  }
+  auto j1 = jcurr.x1e;
+  auto j2 = jcurr.x2e;
+  auto j3 = jcurr.x3e;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+
+  par_for("curr", DevExeSpace(), 0, (nmb-1), ks, ke+1, js, je+1, is, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real dx1 = mbsize.d_view(m).dx1;
+    Real dx2 = mbsize.d_view(m).dx2;
+    Real dx3 = mbsize.d_view(m).dx3;
+    Real cur1 = 0.0;
+    if (multi_d) {
+      cur1 += (b0.x3f(m,k,j,i) - b0.x3f(m,k,j-1,i))/dx2;
+    }
+    if (three_d) {
+      cur1 -= (b0.x2f(m,k,j,i) - b0.x2f(m,k-1,j,i))/dx3;
+    }
+    j1(m,k,j,i) = cur1;
+
+    if (j <= ju2) {
+      Real cur2 = -(b0.x3f(m,k,j,i) - b0.x3f(m,k,j,i-1))/dx1;
+      if (three_d) {
+        cur2 += (b0.x1f(m,k,j,i) - b0.x1f(m,k-1,j,i))/dx3;
+      }
+      j2(m,k,j,i) = cur2;
+    }
+
+    if (k <= ku3) {
+      Real cur3 = (b0.x2f(m,k,j,i) - b0.x2f(m,k,j,i-1))/dx1;
+      if (multi_d) {
+        cur3 -= (b0.x1f(m,k,j,i) - b0.x1f(m,k,j-1,i))/dx2;
+      }
+      j3(m,k,j,i) = cur3;
+    }
+  });
+  jcurr_valid = true;
+
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn OhmicEField()
 //  \brief Adds electric field from Ohmic resistivity to corner-centered electric field
 //  Using Ohm's Law to compute the electric field:  E + (v x B) = \eta J, then
 //    E_{inductive} = - (v x B)  [computed in the MHD Riemann solver]
 //    E_{resistive} = \eta J     [computed in this function]
+//  The current stored in jcurr during the flux calculation of this stage is used if
+//  available, otherwise it is computed here from b0.
 
 void Resistivity::OhmicEField(const DvceFaceFld4D<Real> &b0, DvceEdgeFld4D<Real> &efld) {
+  if (!(jcurr_valid)) {CalculateCurrent(b0);}
+  jcurr_valid = false;   // b0 will be updated by CT after E-field is used
+
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
   int ks = indcs.ks, ke = indcs.ke;
-  int ncells1 = indcs.nx1 + 2*(indcs.ng);
   int nmb1 = pmy_pack->nmb_thispack - 1;
 
+  // capture class variables for the kernels
+  auto e1 = efld.x1e;
+  auto e2 = efld.x2e;
+  auto e3 = efld.x3e;
+  auto j1 = jcurr.x1e;
+  auto j2 = jcurr.x2e;
+  auto j3 = jcurr.x3e;
+  auto eta_o = eta_ohm;
+
   //---- 1-D problem:
   //  copy face-centered E-fields to edges and return.
   //  Note e2[is:ie+1,js:je,  ks:ke+1]
   //       e3[is:ie+1,js:je+1,ks:ke  ]
 
   if (pmy_pack->pmesh->one_d) {
-    // capture class variables for the kernels
-    auto e2 = efld.x2e;
-    auto e3 = efld.x3e;
-    auto &mbsize = pmy_pack->pmb->mb_size;
-    auto eta_o = eta_ohm;
-
-    int scr_level = 0;
-    size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1) * 3;
-
-    par_for_outer("ohm1", DevExeSpace(), scr_size, scr_level, 0, nmb1,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m) {
-      ScrArray1D<Real> j1(member.team_scratch(scr_level), ncells1);
-      ScrArray1D<Real> j2(member.team_scratch(scr_level), ncells1);
-      ScrArray1D<Real> j3(member.team_scratch(scr_level), ncells1);
-
-      CurrentDensity(member, m, ks, js, is, ie+1, b0, mbsize.d_view(m), j1, j2, j3);
-
+    par_for("ohm1", DevExeSpace(), 0, nmb1, is, ie+1,
+    KOKKOS_LAMBDA(const int m, const int i) {
       // Add E_{resistive} = \eta J to corner-centered electric fields
-      par_for_inner(member, is, ie+1, [&](const int i) {
-        e2(m,ks,  js  ,i) += eta_o*j2(i);
-        e2(m,ke+1,js  ,i) += eta_o*j2(i);
-        e3(m,ks  ,js  ,i) += eta_o*j3(i);
-        e3(m,ks  ,je+1,i) += eta_o*j3(i);
-      });
+      e2(m,ks,  js  ,i) += eta_o*j2(m,ks,js,i);
+      e2(m,ke+1,js  ,i) += eta_o*j2(m,ks,js,i);
+      e3(m,ks  ,js  ,i) += eta_o*j3(m,ks,js,i);
+      e3(m,ks  ,je+1,i) += eta_o*j3(m,ks,js,i);
     });
     return;
   }
 
   //---- 2-D problem:
   if (pmy_pack->pmesh->two_d) {
-    // capture class variables for the kernels
-    auto e1 = efld.x1e;
-    auto e2 = efld.x2e;
-    auto e3 = efld.x3e;
-    auto &mbsize = pmy_pack->pmb->mb_size;
-    auto eta_o = eta_ohm;
-
-    int scr_level = 0;
-    size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1) * 3;
-
-    par_for_outer("ohm2", DevExeSpace(), scr_size, scr_level, 0, nmb1, js, je+1,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int j) {
-      ScrArray1D<Real> j1(member.team_scratch(scr_level), ncells1);
-      ScrArray1D<Real> j2(member.team_scratch(scr_level), ncells1);
-      ScrArray1D<Real> j3(member.team_scratch(scr_level), ncells1);
-
-      CurrentDensity(member, m, ks, j, is, ie+1, b0, mbsize.d_view(m), j1, j2, j3);
-
+    par_for("ohm2", DevExeSpace(), 0, nmb1, js, je+1, is, ie+1,
+    KOKKOS_LAMBDA(const int m, const int j, const int i) {
       // Add E_{resistive} = \eta J to corner-centered electric fields
-      par_for_inner(member, is, ie+1, [&](const int i) {
-        e1(m,ks,  j,i) += eta_o*j1(i);
-        e1(m,ke+1,j,i) += eta_o*j1(i);
-        e2(m,ks,  j,i) += eta_o*j2(i);
-        e2(m,ke+1,j,i) += eta_o*j2(i);
-        e3(m,ks  ,j,i) += eta_o*j3(i);
-      });
+      e1(m,ks,  j,i) += eta_o*j1(m,ks,j,i);
+      e1(m,ke+1,j,i) += eta_o*j1(m,ks,j,i);
+      e2(m,ks,  j,i) += eta_o*j2(m,ks,j,i);
+      e2(m,ke+1,j,i) += eta_o*j2(m,ks,j,i);
+      e3(m,ks  ,j,i) += eta_o*j3(m,ks,j,i);
     });
     return;
   }
 
   //---- 3-D problem:
-
-  // capture class variables for the kernels
-  auto e1 = efld.x1e;
-  auto e2 = efld.x2e;
-  auto e3 = efld.x3e;
-  auto &mbsize = pmy_pack->pmb->mb_size;
-  auto eta_o = eta_ohm;
-
-  int scr_level = 0;
-  size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1) * 3;
-
-  par_for_outer("ohm3", DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ke+1, js, je+1,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
-    ScrArray1D<Real> j1(member.team_scratch(scr_level), ncells1);
-    ScrArray1D<Real> j2(member.team_scratch(scr_level), ncells1);
-    ScrArray1D<Real> j3(member.team_scratch(scr_level), ncells1);
-
-    CurrentDensity(member, m, k, j, is, ie+1, b0, mbsize.d_view(m), j1, j2, j3);
-
+  par_for("ohm3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je+1, is, ie+1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
     // Add E_{resistive} = \eta J to corner-centered electric fields
-    par_for_inner(member, is, ie+1, [&](const int i) {
-      e1(m,k,j,i) += eta_o*j1(i);
-      e2(m,k,j,i) += eta_o*j2(i);
-      e3(m,k,j,i) += eta_o*j3(i);
-    });
+    e1(m,k,j,i) += eta_o*j1(m,k,j,i);
+    e2(m,k,j,i) += eta_o*j2(m,k,j,i);
+    e3(m,k,j,i) += eta_o*j3(m,k,j,i);
   });
 
   return;
@@ -165,6 +206,7 @@ void Resistivity::OhmicEField(const DvceFaceFld4D<Real> &b0, DvceEdgeFld4D<Real>
 //! \fn OhmicEnergyFlux()
 //  \brief Adds Poynting flux from Ohmic resistivity to energy flux
 //  Total energy equation is dE/dt = - Div(F) where F = (E X B) = \eta (J X B)
+//  Uses the edge-centered current density stored in jcurr.
 
 
 void Resistivity::OhmicEnergyFlux(const DvceFaceFld4D<Real> &b,
@@ -174,10 +216,13 @@ void Resistivity::OhmicEnergyFlux(const DvceFaceFld4D<Real> &b,
   int js = indcs.js, je = indcs.je;
   int ks = indcs.ks, ke = indcs.ke;
   int nmb1 = pmy_pack->nmb_thispack - 1;
-  auto size = pmy_pack->pmb->mb_size;
-  bool &multi_d = pmy_pack->pmesh->multi_d;
-  bool &three_d = pmy_pack->pmesh->three_d;
   Real qa = 0.25*eta_ohm;
+  // current density at edges; the flux is the first term evaluated in each stage, so
+  // J is computed here and then reused for the E-field in CornerE
+  CalculateCurrent(b);
+  auto j1 = jcurr.x1e;
+  auto j2 = jcurr.x2e;
+  auto j3 = jcurr.x3e;
 
   //------------------------------
   // energy fluxes in x1-direction
@@ -185,20 +230,10 @@ void Resistivity::OhmicEnergyFlux(const DvceFaceFld4D<Real> &b,
   auto &flx1 = flx.x1f;
   par_for("ohm_heat1", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie+1,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    Real j2k   = -(b.x3f(m,k  ,j,i) - b.x3f(m,k  ,j,i-1))/size.d_view(m).dx1;
-    Real j2kp1 = -(b.x3f(m,k+1,j,i) - b.x3f(m,k+1,j,i-1))/size.d_view(m).dx1;
-
-    Real j3j   = (b.x2f(m,k,j  ,i) - b.x2f(m,k,j  ,i-1))/size.d_view(m).dx1;
-    Real j3jp1 = (b.x2f(m,k,j+1,i) - b.x2f(m,k,j+1,i-1))/size.d_view(m).dx1;
-
-    if (multi_d) {
-      j3j   -= (b.x1f(m,k,j  ,i) - b.x1f(m,k,j-1,i))/size.d_view(m).dx2;
-      j3jp1 -= (b.x1f(m,k,j+1,i) - b.x1f(m,k,j  ,i))/size.d_view(m).dx2;
-    }
-    if (three_d) {
-      j2k   += (b.x1f(m,k  ,j,i) - b.x1f(m,k-1,j,i))/size.d_view(m).dx3;
-      j2kp1 += (b.x1f(m,k+1,j,i) - b.x1f(m,k  ,j,i))/size.d_view(m).dx3;
-    }
+    Real j2k   = j2(m,k  ,j  ,i);
+    Real j2kp1 = j2(m,k+1,j  ,i);
+    Real j3j   = j3(m,k  ,j  ,i);
+    Real j3jp1 = j3(m,k  ,j+1,i);
 
     // flx1 = (E X B)_{1} =  ((\eta J) X B)_{1} = \eta (J2*B3 - J3*B2)
     flx1(m,IEN,k,j,i) += qa*(j2k  *(b.x3f(m,k  ,j  ,i) + b.x3f(m,k  ,j  ,i-1)) +
@@ -214,18 +249,10 @@ void Resistivity::OhmicEnergyFlux(const DvceFaceFld4D<Real> &b,
   auto &flx2 = flx.x2f;
   par_for("ohm_heat2", DevExeSpace(), 0, nmb1, ks, ke, js, je+1, is, ie,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    Real j1k   = (b.x3f(m,k  ,j,i) - b.x3f(m,k  ,j-1,i))/size.d_view(m).dx2;
-    Real j1kp1 = (b.x3f(m,k+1,j,i) - b.x3f(m,k+1,j-1,i))/size.d_view(m).dx2;
-
-    Real j3i   = (b.x2f(m,k,j,i  ) - b.x2f(m,k,j  ,i-1))/size.d_view(m).dx1
-               - (b.x1f(m,k,j,i  ) - b.x1f(m,k,j-1,i  ))/size.d_view(m).dx2;
-    Real j3ip1 = (b.x2f(m,k,j,i+1) - b.x2f(m,k,j  ,i  ))/size.d_view(m).dx1
-               - (b.x1f(m,k,j,i+1) - b.x1f(m,k,j-1,i+1))/size.d_view(m).dx2;
-
-    if (three_d) {
-      j1k   -= (b.x2f(m,k  ,j,i) - b.x2f(m,k-1,j,i))/size.d_view(m).dx3;
-      j1kp1 -= (b.x2f(m,k+1,j,i) - b.x2f(m,k  ,j,i))/size.d_view(m).dx3;
-    }
+    Real j1k   = j1(m,k  ,j,i  );
+    Real j1kp1 = j1(m,k+1,j,i  );
+    Real j3i   = j3(m,k  ,j,i  );
+    Real j3ip1 = j3(m,k  ,j,i+1);
 
     // E2 = \eta (J X B)_{2} = \eta (J3*B1 - J1*B3)
     flx2(m,IEN,k,j,i) += qa*(j3i  *(b.x1f(m,k  ,j,i  ) + b.x1f(m,k  ,j-1,i  )) +
@@ -241,15 +268,10 @@ void Resistivity::OhmicEnergyFlux(const DvceFaceFld4D<Real> &b,
   auto &flx3 = flx.x3f;
   par_for("ohm_heat3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    Real j1j   = (b.x3f(m,k,j  ,i) - b.x3f(m,k  ,j-1,i))/size.d_view(m).dx2
-               - (b.x2f(m,k,j  ,i) - b.x2f(m,k-1,j  ,i))/size.d_view(m).dx3;
-    Real j1jp1 = (b.x3f(m,k,j+1,i) - b.x3f(m,k  ,j  ,i))/size.d_view(m).dx2
-               - (b.x2f(m,k,j+1,i) - b.x2f(m,k-1,j+1,i))/size.d_view(m).dx3;
-
-    Real j2i   = -(b.x3f(m,k,j,i  ) - b.x3f(m,k  ,j,i-1))/size.d_view(m).dx1
-                + (b.x1f(m,k,j,i  ) - b.x1f(m,k-1,j,i  ))/size.d_view(m).dx3;
-    Real j2ip1 = -(b.x3f(m,k,j,i+1) - b.x3f(m,k  ,j,i  ))/size.d_view(m).dx1
-                + (b.x1f(m,k,j,i+1) - b.x1f(m,k-1,j,i+1))/size.d_view(m).dx3;
+    Real j1j   = j1(m,k,j  ,i  );
+    Real j1jp1 = j1(m,k,j+1,i  );
+    Real j2i   = j2(m,k,j  ,i  );
+    Real j2ip1 = j2(m,k,j  ,i+1);
 
     // E2 = \eta (J X B)_{2} = \eta (J1*B2 - J2*B1)
     flx3(m,IEN,k,j,i) += qa*(j1j  *(b.x2f(m,k,j  ,i  ) + b.x2f(m,k-1,j  ,i  )) +
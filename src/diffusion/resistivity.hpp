@@ -25,13 +25,16 @@ class Resistivity {
   // data
   Real dtnew;
   Real eta_ohm;
+  DvceEdgeFld4D<Real> jcurr;  // edge-centered current density, computed once per stage
 
-  // functions to add resistive E-Field and energy flux
+  // functions to compute current, and add resistive E-Field and energy flux
+  void CalculateCurrent(const DvceFaceFld4D<Real> &b0);
   void OhmicEField(const DvceFaceFld4D<Real> &b0, DvceEdgeFld4D<Real> &efld);
   void OhmicEnergyFlux(const DvceFaceFld4D<Real> &b, DvceFaceFld5D<Real> &flx);
 
  private:
   MeshBlockPack* pmy_pack;
+  bool jcurr_valid;   // true if jcurr is computed from current b0 in this stage
 };
 
 #endif // DIFFUSION_RESISTIVITY_HPP_
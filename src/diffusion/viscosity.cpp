@@ -59,6 +59,14 @@ Viscosity::~Viscosity() {
 //----------------------------------------------------------------------------------------
 //! \fn void AddIsoViscousFlux
 //  \brief Adds viscous fluxes to face-centered fluxes of conserved variables
+//
+//  Fluxes in all three directions are computed in a single kernel.  Each team loads the
+//  velocity in the 3x3 pencils (k-1:k+1, j-1:j+1) into scratch memory once, and then
+//  computes the x1-flux at faces (k,j,i-1/2), the x2-flux at faces (k,j-1/2,i), and the
+//  x3-flux at faces (k-1/2,j,i), so that each velocity is read from w0 only once for all
+//  directions.  Teams are launched over ks:ke+1 and js:je+1 to cover the upper faces.
+//  The velocity in pencil (k+dk,j+dj) is stored in rows 9*n + 3*(dk+1) + (dj+1) of the
+//  scratch array, where n=(0,1,2) for (vx,vy,vz).
 
 void Viscosity::IsotropicViscousFlux(const DvceArray5D<Real> &w0, const Real nu_iso,
   const EOS_Data &eos, DvceFaceFld5D<Real> &flx) {
@@ -69,149 +77,155 @@ void Viscosity::IsotropicViscousFlux(const DvceArray5D<Real> &w0, const Real nu_
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
   int nmb1 = pmy_pack->nmb_thispack - 1;
   auto size = pmy_pack->pmb->mb_size;
-  bool &multi_d = pmy_pack->pmesh->multi_d;
-  bool &three_d = pmy_pack->pmesh->three_d;
-
-  //--------------------------------------------------------------------------------------
-  // fluxes in x1-direction
+  const bool multi_d = pmy_pack->pmesh->multi_d;
+  const bool three_d = pmy_pack->pmesh->three_d;
+  const bool is_ideal = eos.is_ideal;
+  // offsets of neighboring pencils in x2/x3 (zero in lower dimensions)
+  const int dj = (multi_d)? 1 : 0;
+  const int dk = (three_d)? 1 : 0;
+  int ju = (multi_d)? je+1 : je;
+  int ku = (three_d)? ke+1 : ke;
+  auto flx1 = flx.x1f;
+  auto flx2 = flx.x2f;
+  auto flx3 = flx.x3f;
 
   int scr_level = 0;
-  size_t scr_size = (ScrArray1D<Real>::shmem_size(ncells1)) * 3;
-  auto flx1 = flx.x1f;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(27, ncells1) +
+                    ScrArray1D<Real>::shmem_size(ncells1) * 3;
 
-  par_for_outer("visc1",DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ke, js, je,
+  par_for_outer("visc",DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ku, js, ju,
   KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> v(member.team_scratch(scr_level), 27, ncells1);
     ScrArray1D<Real> fvx(member.team_scratch(scr_level), ncells1);
     ScrArray1D<Real> fvy(member.team_scratch(scr_level), ncells1);
     ScrArray1D<Real> fvz(member.team_scratch(scr_level), ncells1);
 
-    // Add [2(dVx/dx)-(2/3)dVx/dx, dVy/dx, dVz/dx]
-    par_for_inner(member, is, ie+1, [&](const int i) {
-      fvx(i) = 4.0*(w0(m,IVX,k,j,i) - w0(m,IVX,k,j,i-1))/(3.0*size.d_view(m).dx1);
-      fvy(i) =     (w0(m,IVY,k,j,i) - w0(m,IVY,k,j,i-1))/size.d_view(m).dx1;
-      fvz(i) =     (w0(m,IVZ,k,j,i) - w0(m,IVZ,k,j,i-1))/size.d_view(m).dx1;
-    });
-
-    // In 2D/3D Add [(-2/3)dVy/dy, dVx/dy, 0]
-    if (multi_d) {
-      par_for_inner(member, is, ie+1, [&](const int i) {
-        fvx(i) -= ((w0(m,IVY,k,j+1,i) + w0(m,IVY,k,j+1,i-1)) -
-                   (w0(m,IVY,k,j-1,i) + w0(m,IVY,k,j-1,i-1)))/(6.0*size.d_view(m).dx2);
-        fvy(i) += ((w0(m,IVX,k,j+1,i) + w0(m,IVX,k,j+1,i-1)) -
-                   (w0(m,IVX,k,j-1,i) + w0(m,IVX,k,j-1,i-1)))/(4.0*size.d_view(m).dx2);
+    for (int r=0; r<9; ++r) {
+      const int kk = k + dk*(r/3 - 1);
+      const int jj = j + dj*(r%3 - 1);
+      par_for_inner(member, is-1, ie+1, [&](const int i) {
+        v(r   ,i) = w0(m,IVX,kk,jj,i);
+        v(r+9 ,i) = w0(m,IVY,kk,jj,i);
+        v(r+18,i) = w0(m,IVZ,kk,jj,i);
       });
     }
+    member.team_barrier();
+
+    const Real dx1 = size.d_view(m).dx1;
+    const Real dx2 = size.d_view(m).dx2;
+    const Real dx3 = size.d_view(m).dx3;
+    // rows of (vx,vy,vz) in pencils (k,j), (k,j-1), (k,j+1), (k-1,j), (k+1,j), etc.
+    constexpr int c = 4, jm = 3, jp = 5, km = 1, kp = 7, kmjm = 0, kmjp = 2, kpjm = 6;
+    constexpr int vx = 0, vy = 9, vz = 18;
+
+    //------------------------------------------------------------------------------------
+    // fluxes in x1-direction
 
-    // In 3D Add [(-2/3)dVz/dz, 0,  dVx/dz]
-    if (three_d) {
+    if (k <= ke && j <= je) {
+      // Add [2(dVx/dx)-(2/3)dVx/dx, dVy/dx, dVz/dx]
       par_for_inner(member, is, ie+1, [&](const int i) {
-        fvx(i) -= ((w0(m,IVZ,k+1,j,i) + w0(m,IVZ,k+1,j,i-1)) -
-                   (w0(m,IVZ,k-1,j,i) + w0(m,IVZ,k-1,j,i-1)))/(6.0*size.d_view(m).dx3);
-        fvz(i) += ((w0(m,IVX,k+1,j,i) + w0(m,IVX,k+1,j,i-1)) -
-                   (w0(m,IVX,k-1,j,i) + w0(m,IVX,k-1,j,i-1)))/(4.0*size.d_view(m).dx3);
+        fvx(i) = 4.0*(v(vx+c,i) - v(vx+c,i-1))/(3.0*dx1);
+        fvy(i) =     (v(vy+c,i) - v(vy+c,i-1))/dx1;
+        fvz(i) =     (v(vz+c,i) - v(vz+c,i-1))/dx1;
       });
-    }
 
-    // Sum viscous fluxes into fluxes of conserved variables; including energy fluxes
-    par_for_inner(member, is, ie+1, [&](const int i) {
-      Real nud = 0.5*nu_iso*(w0(m,IDN,k,j,i) + w0(m,IDN,k,j,i-1));
-      flx1(m,IVX,k,j,i) -= nud*fvx(i);
-      flx1(m,IVY,k,j,i) -= nud*fvy(i);
-      flx1(m,IVZ,k,j,i) -= nud*fvz(i);
-      if (eos.is_ideal) {
-        flx1(m,IEN,k,j,i) -= 0.5*nud*((w0(m,IVX,k,j,i-1) + w0(m,IVX,k,j,i))*fvx(i) +
-                                      (w0(m,IVY,k,j,i-1) + w0(m,IVY,k,j,i))*fvy(i) +
-                                      (w0(m,IVZ,k,j,i-1) + w0(m,IVZ,k,j,i))*fvz(i));
+      // In 2D/3D Add [(-2/3)dVy/dy, dVx/dy, 0]
+      if (multi_d) {
+        par_for_inner(member, is, ie+1, [&](const int i) {
+          fvx(i) -= ((v(vy+jp,i) + v(vy+jp,i-1)) - (v(vy+jm,i) + v(vy+jm,i-1)))/(6.0*dx2);
+          fvy(i) += ((v(vx+jp,i) + v(vx+jp,i-1)) - (v(vx+jm,i) + v(vx+jm,i-1)))/(4.0*dx2);
+        });
       }
-    });
-  });
-  if (pmy_pack->pmesh->one_d) {return;}
 
-  //--------------------------------------------------------------------------------------
-  // fluxes in x2-direction
+      // In 3D Add [(-2/3)dVz/dz, 0,  dVx/dz]
+      if (three_d) {
+        par_for_inner(member, is, ie+1, [&](const int i) {
+          fvx(i) -= ((v(vz+kp,i) + v(vz+kp,i-1)) - (v(vz+km,i) + v(vz+km,i-1)))/(6.0*dx3);
+          fvz(i) += ((v(vx+kp,i) + v(vx+kp,i-1)) - (v(vx+km,i) + v(vx+km,i-1)))/(4.0*dx3);
+        });
+      }
 
-  auto flx2 = flx.x2f;
+      // Sum viscous fluxes into fluxes of conserved variables; including energy fluxes
+      par_for_inner(member, is, ie+1, [&](const int i) {
+        Real nud = 0.5*nu_iso*(w0(m,IDN,k,j,i) + w0(m,IDN,k,j,i-1));
+        flx1(m,IVX,k,j,i) -= nud*fvx(i);
+        flx1(m,IVY,k,j,i) -= nud*fvy(i);
+        flx1(m,IVZ,k,j,i) -= nud*fvz(i);
+        if (is_ideal) {
+          flx1(m,IEN,k,j,i) -= 0.5*nud*((v(vx+c,i-1) + v(vx+c,i))*fvx(i) +
+                                        (v(vy+c,i-1) + v(vy+c,i))*fvy(i) +
+                                        (v(vz+c,i-1) + v(vz+c,i))*fvz(i));
+        }
+      });
+    }
+    if (!(multi_d)) return;
+    member.team_barrier();
 
-  par_for_outer("visc2",DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ke, js, je+1,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
-    ScrArray1D<Real> fvx(member.team_scratch(scr_level), ncells1);
-    ScrArray1D<Real> fvy(member.team_scratch(scr_level), ncells1);
-    ScrArray1D<Real> fvz(member.team_scratch(scr_level), ncells1);
+    //------------------------------------------------------------------------------------
+    // fluxes in x2-direction
 
-    // Add [(dVx/dy+dVy/dx), 2(dVy/dy)-(2/3)(dVx/dx+dVy/dy), dVz/dy]
-    par_for_inner(member, is, ie, [&](const int i) {
-      fvx(i) = (w0(m,IVX,k,j,i  ) - w0(m,IVX,k,j-1,i  ))/size.d_view(m).dx2 +
-              ((w0(m,IVY,k,j,i+1) + w0(m,IVY,k,j-1,i+1)) -
-               (w0(m,IVY,k,j,i-1) + w0(m,IVY,k,j-1,i-1)))/(4.0*size.d_view(m).dx1);
-      fvy(i) = (w0(m,IVY,k,j,i) - w0(m,IVY,k,j-1,i))*4.0/(3.0*size.d_view(m).dx2) -
-              ((w0(m,IVX,k,j,i+1) + w0(m,IVX,k,j-1,i+1)) -
-               (w0(m,IVX,k,j,i-1) + w0(m,IVX,k,j-1,i-1)))/(6.0*size.d_view(m).dx1);
-      fvz(i) = (w0(m,IVZ,k,j,i  ) - w0(m,IVZ,k,j-1,i  ))/size.d_view(m).dx2;
-    });
-
-    // In 3D Add [0, (-2/3)dVz/dz, dVy/dz]
-    if (three_d) {
+    if (k <= ke) {
+      // Add [(dVx/dy+dVy/dx), 2(dVy/dy)-(2/3)(dVx/dx+dVy/dy), dVz/dy]
       par_for_inner(member, is, ie, [&](const int i) {
-        fvy(i) -= ((w0(m,IVZ,k+1,j,i) + w0(m,IVZ,k+1,j-1,i)) -
-                   (w0(m,IVZ,k-1,j,i) + w0(m,IVZ,k-1,j-1,i)))/(6.0*size.d_view(m).dx3);
-        fvz(i) += ((w0(m,IVY,k+1,j,i) + w0(m,IVY,k+1,j-1,i)) -
-                   (w0(m,IVY,k-1,j,i) + w0(m,IVY,k-1,j-1,i)))/(4.0*size.d_view(m).dx3);
+        fvx(i) = (v(vx+c,i) - v(vx+jm,i))/dx2 +
+                ((v(vy+c,i+1) + v(vy+jm,i+1)) - (v(vy+c,i-1) + v(vy+jm,i-1)))/(4.0*dx1);
+        fvy(i) = (v(vy+c,i) - v(vy+jm,i))*4.0/(3.0*dx2) -
+                ((v(vx+c,i+1) + v(vx+jm,i+1)) - (v(vx+c,i-1) + v(vx+jm,i-1)))/(6.0*dx1);
+        fvz(i) = (v(vz+c,i) - v(vz+jm,i))/dx2;
       });
-    }
 
-    // Sum viscous fluxes into fluxes of conserved variables; including energy fluxes
-    par_for_inner(member, is, ie, [&](const int i) {
-      Real nud = 0.5*nu_iso*(w0(m,IDN,k,j,i) + w0(m,IDN,k,j-1,i));
-      flx2(m,IVX,k,j,i) -= nud*fvx(i);
-      flx2(m,IVY,k,j,i) -= nud*fvy(i);
-      flx2(m,IVZ,k,j,i) -= nud*fvz(i);
-      if (eos.is_ideal) {
-        flx2(m,IEN,k,j,i) -= 0.5*nud*((w0(m,IVX,k,j-1,i) + w0(m,IVX,k,j,i))*fvx(i) +
-                                      (w0(m,IVY,k,j-1,i) + w0(m,IVY,k,j,i))*fvy(i) +
-                                      (w0(m,IVZ,k,j-1,i) + w0(m,IVZ,k,j,i))*fvz(i));
+      // In 3D Add [0, (-2/3)dVz/dz, dVy/dz]
+      if (three_d) {
+        par_for_inner(member, is, ie, [&](const int i) {
+          fvy(i) -= ((v(vz+kp,i) + v(vz+kpjm,i)) - (v(vz+km,i) + v(vz+kmjm,i)))/(6.0*dx3);
+          fvz(i) += ((v(vy+kp,i) + v(vy+kpjm,i)) - (v(vy+km,i) + v(vy+kmjm,i)))/(4.0*dx3);
+        });
       }
-    });
-  });
-  if (pmy_pack->pmesh->two_d) {return;}
 
-  //--------------------------------------------------------------------------------------
-  // fluxes in x3-direction
+      // Sum viscous fluxes into fluxes of conserved variables; including energy fluxes
+      par_for_inner(member, is, ie, [&](const int i) {
+        Real nud = 0.5*nu_iso*(w0(m,IDN,k,j,i) + w0(m,IDN,k,j-1,i));
+        flx2(m,IVX,k,j,i) -= nud*fvx(i);
+        flx2(m,IVY,k,j,i) -= nud*fvy(i);
+        flx2(m,IVZ,k,j,i) -= nud*fvz(i);
+        if (is_ideal) {
+          flx2(m,IEN,k,j,i) -= 0.5*nud*((v(vx+jm,i) + v(vx+c,i))*fvx(i) +
+                                        (v(vy+jm,i) + v(vy+c,i))*fvy(i) +
+                                        (v(vz+jm,i) + v(vz+c,i))*fvz(i));
+        }
+      });
+    }
+    if (!(three_d)) return;
+    member.team_barrier();
 
-  auto flx3 = flx.x3f;
+    //------------------------------------------------------------------------------------
+    // fluxes in x3-direction
 
-  par_for_outer("visc3",DevExeSpace(), scr_size, scr_level, 0, nmb1, ks, ke+1, js, je,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
-    ScrArray1D<Real> fvx(member.team_scratch(scr_level), ncells1);
-    ScrArray1D<Real> fvy(member.team_scratch(scr_level), ncells1);
-    ScrArray1D<Real> fvz(member.team_scratch(scr_level), ncells1);
+    if (j <= je) {
+      // Add [(dVx/dz+dVz/dx), (dVy/dz+dVz/dy), 2(dVz/dz)-(2/3)(dVx/dx+dVy/dy+dVz/dz)]
+      par_for_inner(member, is, ie, [&](const int i) {
+        fvx(i) = (v(vx+c,i) - v(vx+km,i))/dx3 +
+                ((v(vz+c,i+1) + v(vz+km,i+1)) - (v(vz+c,i-1) + v(vz+km,i-1)))/(4.0*dx1);
+        fvy(i) = (v(vy+c,i) - v(vy+km,i))/dx3 +
+                ((v(vz+jp,i) + v(vz+kmjp,i)) - (v(vz+jm,i) + v(vz+kmjm,i)))/(4.0*dx2);
+        fvz(i) = (v(vz+c,i) - v(vz+km,i))*4.0/(3.0*dx3) -
+                ((v(vx+c,i+1) + v(vx+km,i+1)) - (v(vx+c,i-1) + v(vx+km,i-1)))/(6.0*dx1) -
+                ((v(vy+jp,i) + v(vy+kmjp,i)) - (v(vy+jm,i) + v(vy+kmjm,i)))/(6.0*dx2);
+      });
 
-    // Add [(dVx/dz+dVz/dx), (dVy/dz+dVz/dy), 2(dVz/dz)-(2/3)(dVx/dx+dVy/dy+dVz/dz)]
-    par_for_inner(member, is, ie, [&](const int i) {
-      fvx(i) = (w0(m,IVX,k,j,i  ) - w0(m,IVX,k-1,j,i  ))/size.d_view(m).dx3 +
-              ((w0(m,IVZ,k,j,i+1) + w0(m,IVZ,k-1,j,i+1)) -
-               (w0(m,IVZ,k,j,i-1) + w0(m,IVZ,k-1,j,i-1)))/(4.0*size.d_view(m).dx1);
-      fvy(i) = (w0(m,IVY,k,j,i  ) - w0(m,IVY,k-1,j,i  ))/size.d_view(m).dx3 +
-              ((w0(m,IVZ,k,j+1,i) + w0(m,IVZ,k-1,j+1,i)) -
-               (w0(m,IVZ,k,j-1,i) + w0(m,IVZ,k-1,j-1,i)))/(4.0*size.d_view(m).dx2);
-      fvz(i) = (w0(m,IVZ,k,j,i) - w0(m,IVZ,k-1,j,i))*4.0/(3.0*size.d_view(m).dx3) -
-              ((w0(m,IVX,k,j,i+1) + w0(m,IVX,k-1,j,i+1)) -
-               (w0(m,IVX,k,j,i-1) + w0(m,IVX,k-1,j,i-1)))/(6.0*size.d_view(m).dx1) -
-              ((w0(m,IVY,k,j+1,i) + w0(m,IVY,k-1,j+1,i)) -
-               (w0(m,IVY,k,j-1,i) + w0(m,IVY,k-1,j-1,i)))/(6.0*size.d_view(m).dx2);
-    });
-
-    // Sum viscous fluxes into fluxes of conserved variables; including energy fluxes
-    par_for_inner(member, is, ie, [&](const int i) {
-      Real nud = 0.5*nu_iso*(w0(m,IDN,k,j,i) + w0(m,IDN,k-1,j,i));
-      flx3(m,IVX,k,j,i) -= nud*fvx(i);
-      flx3(m,IVY,k,j,i) -= nud*fvy(i);
-      flx3(m,IVZ,k,j,i) -= nud*fvz(i);
-      if (eos.is_ideal) {
-        flx3(m,IEN,k,j,i) -= 0.5*nud*((w0(m,IVX,k-1,j,i) + w0(m,IVX,k,j,i))*fvx(i) +
-                                      (w0(m,IVY,k-1,j,i) + w0(m,IVY,k,j,i))*fvy(i) +
-                                      (w0(m,IVZ,k-1,j,i) + w0(m,IVZ,k,j,i))*fvz(i));
-      }
-    });
+      // Sum viscous fluxes into fluxes of conserved variables; including energy fluxes
+      par_for_inner(member, is, ie, [&](const int i) {
+        Real nud = 0.5*nu_iso*(w0(m,IDN,k,j,i) + w0(m,IDN,k-1,j,i));
+        flx3(m,IVX,k,j,i) -= nud*fvx(i);
+        flx3(m,IVY,k,j,i) -= nud*fvy(i);
+        flx3(m,IVZ,k,j,i) -= nud*fvz(i);
+        if (is_ideal) {
+          flx3(m,IEN,k,j,i) -= 0.5*nud*((v(vx+km,i) + v(vx+c,i))*fvx(i) +
+                                        (v(vy+km,i) + v(vy+c,i))*fvy(i) +
+                                        (v(vz+km,i) + v(vz+c,i))*fvz(i));
+        }
+      });
+    }
   });
 
   return;
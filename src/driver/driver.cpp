@@ -6,16 +6,24 @@
 //! \file driver.cpp
 //  \brief implementation of functions in class Driver
 
+#include <sys/resource.h>  // getrusage()
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <iomanip>    // std::setprecision()
 #include <limits>
 #include <algorithm>
 #include <string> // string
+#include <thread> // this_thread::yield
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
+#include "bvals/comm_stats.hpp"
+#include "utils/memory_registry.hpp"
 #include "outputs/outputs.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
@@ -23,12 +31,30 @@
 #include "dyn_grmhd/dyn_grmhd.hpp"
 #include "ion-neutral/ion-neutral.hpp"
 #include "radiation/radiation.hpp"
+#include "srcterms/srcterms.hpp"
 #include "driver.hpp"
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
 #endif
 
+namespace {
+// phases of each cycle timed in the cycle log.  All three STS TaskLists are one phase.
+enum CyclePhase {before_ti=0, before_stagen, stagen, after_stagen, sts, after_ti,
+                 outputs, amr, new_dt, nphase};
+const char *phase_label[nphase] = {"t_before_ti", "t_before_stagen", "t_stagen",
+    "t_after_stagen", "t_sts", "t_after_ti", "t_outputs", "t_amr", "t_new_dt"};
+
+int CyclePhaseOf(const std::string &tl) {
+  if (tl.compare("before_timeintegrator") == 0) {return before_ti;}
+  if (tl.compare("before_stagen") == 0) {return before_stagen;}
+  if (tl.compare("stagen") == 0) {return stagen;}
+  if (tl.compare("after_stagen") == 0) {return after_stagen;}
+  if (tl.compare("after_timeintegrator") == 0) {return after_ti;}
+  return sts;
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 // constructor, initializes data structures and parameters
 //
@@ -62,6 +88,11 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
   nmb_updated_(0),
   npart_updated_(0),
   lb_efficiency_(0),
+  task_timers_(false),
+  cycle_log_header_(false),
+  phase_time_(nphase, 0.0),
+  nmb_sent_last_(0),
+  nimex_exceed_(0),
   pwall_clock_(ptimer),
   wall_time(wtlim),
   impl_src("ru",1,1,1,1,1,1) {
@@ -81,12 +112,31 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
     }
   } // extra brace to limit scope of string
 
+  // intermediate stage (u1) only updated with delta by low-storage 2S integrators
+  low_storage = false;
+  for (int n=0; n<10; ++n) {delta[n] = 0.0;}
+  imex_adaptive = false;
+  imex_err = 0.0;
+
   // read <time> parameters controlling driver if run requires time-evolution
   if (time_evolution != TimeEvolution::tstatic) {
     integrator = pin->GetOrAddString("time", "integrator", "rk2");
     tlim = pin->GetReal("time", "tlim");
     nlim = pin->GetOrAddInteger("time", "nlim", -1);
     ndiag = pin->GetOrAddInteger("time", "ndiag", 1);
+    task_timers_ = pin->GetOrAddBoolean("time", "task_timers", false);
+    // benchmark runs write a JSON summary at the end of the run, including task timers
+    bench_file_ = pin->GetOrAddString("time", "benchmark_file", "");
+    if (!(bench_file_.empty())) {task_timers_ = true;}
+    // report spread over ranks of communication counters every ndiag cycles
+    comm_stats::enabled = pin->GetOrAddBoolean("time", "comm_stats", false);
+    // append time spent in each phase of every cycle to file basename.cycle.log
+    if (pin->GetOrAddBoolean("time", "cycle_log", false)) {
+      cycle_log_file_ = pin->GetString("job", "basename") + ".cycle.log";
+    }
+    // run host-only tasks (e.g. writing tracker data) on a background thread.  Also
+    // started by the first asynchronous output (<output>/async=true).
+    if (pin->GetOrAddBoolean("job", "host_tasks", false)) {host_tasks.Start();}
 
     if (integrator == "rk1") {
       // RK1: first-order Runge-Kutta / the forward Euler (FE) method
@@ -134,6 +184,7 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
       // Refer to Colella (2011) for linear stability analysis of constant coeff.
       nimp_stages = 0;
       nexp_stages = 4;
+      low_storage = true;
 
       // Colella (2011) eq 101; 1st order flux is most severe constraint
       cfl_limit = 1.3925;
@@ -158,6 +209,32 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
       delta[1] = 0.217683334308543;
       delta[2] = 1.065841341361089;
       delta[3] = 0.0;
+    } else if (integrator == "ssprk104") {
+      // SSPRK (10,4): Ketcheson (2008) Pseudocode 3, written in 2S form
+      // Explicit ten-stage, fourth-order SSPRK using only two registers (u0, u1).
+      // Stages 1-4 and 6-9 are forward Euler steps of dt/6.  Stage 5 also forms
+      // u0 = 3/5 u^n + 2/5 u^(5), stage 6 sets u1 = u^n - 9/5 u0 = -2 q2 with
+      // q2 = (u^n + 9 u^(5))/25, and stage 10 forms u^{n+1} = q2 + 3/5 u^(9) + dt/10 F.
+      nimp_stages = 0;
+      nexp_stages = 10;
+      low_storage = true;
+      cfl_limit = 6.0;  // c_eff = c/nstages = 0.6 (Ketcheson (2008), Table 1)
+      for (int n=0; n<10; ++n) {
+        gam0[n] = 1.0;
+        gam1[n] = 0.0;
+        beta[n] = 1.0/6.0;
+      }
+      delta[0] = 1.0;
+
+      gam0[4] = 0.4;
+      gam1[4] = 0.6;
+      beta[4] = 1.0/15.0;
+
+      delta[5] = -1.8;
+
+      gam0[9] = 0.6;
+      gam1[9] = -0.5;
+      beta[9] = 0.1;
     } else if (integrator == "imex2") {
       // IMEX-SSP2(3,2,2): Pareschi & Russo (2005) Table III.
       // two-stage explicit, three-stage implicit, second-order ImEx
@@ -258,9 +335,22 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
          << std::endl << "integrator=" << integrator << " not implemented. "
-         << "Valid choices are [rk1,rk2,rk3,imex2,imex3]." << std::endl;
+         << "Valid choices are [rk1,rk2,rk3,rk4,ssprk104,imex2,imex3,imex+]."
+         << std::endl;
       exit(EXIT_FAILURE);
     }
+
+    // error control of stiff source terms (only meaningful for ImEx integrators)
+    if (nimp_stages > 0) {
+      imex_adaptive = pin->GetOrAddBoolean("time", "imex_adaptive", false);
+      imex_rtol = pin->GetOrAddReal("time", "imex_rtol", 1.0e-3);
+      imex_atol = pin->GetOrAddReal("time", "imex_atol", 1.0e-8);
+    }
+  } else {
+    // static problems (e.g. post-processing of restart files) make nstatic passes over
+    // the "static" TaskList, with outputs every dcycle passes
+    nstatic = pin->GetOrAddInteger("time", "nstatic", 1);
+    ndiag = pin->GetOrAddInteger("time", "ndiag", 1);
   }
 }
 
@@ -271,21 +361,41 @@ Driver::Driver(ParameterInput *pin, Mesh *pmesh, Real wtlim, Kokkos::Timer* ptim
 //! these tasks are to be performed, e.g. which stage of a multi-stage RK integrator.
 
 void Driver::ExecuteTaskList(Mesh *pm, std::string tl, int stage) {
+  Kokkos::Profiling::pushRegion(tl);
+  Kokkos::Timer phase_timer;
   MeshBlockPack* pmbp = pm->pmb_pack;
   for (int p=0; p<(pm->nmb_packs_thisrank); ++p) {
     if (!(pmbp->tl_map[tl]->Empty())) {pmbp->tl_map[tl]->Reset();}
   }
   int npack_left = (pm->nmb_packs_thisrank);
+  double idle_t0 = -1.0;
   while (npack_left > 0) {
+    bool progress = false;
     if (pmbp->tl_map[tl]->Empty()) {
       npack_left--;
+      progress = true;
     } else {
       if (!pmbp->tl_map[tl]->IsComplete()) {
         auto status = pmbp->tl_map[tl]->DoAvailable(this, stage);
         if (status == TaskListStatus::complete) { npack_left--; }
+        if (status != TaskListStatus::stuck) { progress = true; }
       }
     }
+    // all remaining tasks are waiting (e.g. on MPI), so release the host core rather
+    // than immediately polling again
+    if (!progress) {
+      if (comm_stats::enabled && idle_t0 < 0.0) {idle_t0 = comm_stats::Now();}
+      std::this_thread::yield();
+    } else if (idle_t0 >= 0.0) {
+      comm_stats::idle += comm_stats::Now() - idle_t0;
+      idle_t0 = -1.0;
+    }
   }
+  if (!(cycle_log_file_.empty())) {
+    Kokkos::fence();
+    phase_time_[CyclePhaseOf(tl)] += phase_timer.seconds();
+  }
+  Kokkos::Profiling::popRegion();
   return;
 }
 
@@ -295,6 +405,7 @@ void Driver::ExecuteTaskList(Mesh *pm, std::string tl, int stage) {
 //  outputting ICs, and computing initial time step
 
 void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool res_flag) {
+  memory_registry::Scope mem_scope("driver");
   //---- Step 1.  Set conserved variables in ghost zones for all physics
   InitBoundaryValuesAndPrimitives(pmesh);
 
@@ -331,15 +442,50 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
   //---- Step 4.  Initialize various counters, timers, etc.
   run_time_.reset();
   nmb_updated_ = 0;
+  if (pmesh->cost_model.measured) {
+    for (auto &it : pmesh->pmb_pack->tl_map) {it.second->SetTiming(true);}
+  }
+  if (task_timers_) {
+    for (auto &it : pmesh->pmb_pack->tl_map) {it.second->SetTaskTimers(true);}
+  }
+  // built-in kernel profiler, with optional peak memory bandwidth (GB/s) of the device
+  if (pin->GetOrAddBoolean("job", "kernel_profiler", false)) {
+    kernel_profiler::Enable(pin->GetOrAddReal("job", "peak_bandwidth", 0.0));
+  }
 
   // allocate memory for stiff source terms with ImEx integrators
-  // only implemented for ion-neutral two fluid for now
+  // only implemented for ion-neutral two fluid, and implicit ISM cooling, for now
   ion_neutral::IonNeutral *pionn = pmesh->pmb_pack->pionn;
-  if (pionn != nullptr) {
+  hydro::Hydro *phyd = pmesh->pmb_pack->phydro;
+  bool imex_cooling = (phyd != nullptr) && (phyd->psrc != nullptr) &&
+                      (phyd->psrc->ism_cooling_imex);
+  if (imex_cooling && (nimp_stages == 0 || pionn != nullptr)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "ism_cooling_method=implicit can only be run with ImEx "
+        << "integrators, and not with IonNeutral MHD" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if ((phyd != nullptr) && (phyd->sts_integrator != STS_Integrator::none) &&
+      (pionn != nullptr)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<hydro>/sts_integrator cannot be used with IonNeutral MHD"
+        << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (imex_cooling) {
+    int nmb = std::max((pmesh->pmb_pack->nmb_thispack), (pmesh->nmb_maxperrank));
+    auto &indcs = pmesh->mb_indcs;
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(impl_src, nimp_stages, nmb, 1, ncells3, ncells2, ncells1);
+  }
+  // the local (operator-split) drag update needs no storage for stiff source terms
+  if (pionn != nullptr && !(pionn->local_drag)) {
     if (nimp_stages == 0) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "IonNetral MHD can only be run with ImEx integrators."
-          << std::endl;
+          << std::endl << "IonNetral MHD can only be run with ImEx integrators, "
+          << "unless <ion-neutral>/local_drag=true" << std::endl;
       std::exit(EXIT_FAILURE);
     }
     int nmb = std::max((pmesh->pmb_pack->nmb_thispack), (pmesh->nmb_maxperrank));
@@ -350,6 +496,10 @@ void Driver::Initialize(Mesh *pmesh, ParameterInput *pin, Outputs *pout, bool re
     Kokkos::realloc(impl_src, nimp_stages, nmb, 8, ncells3, ncells2, ncells1);
   }
 
+  // device memory of each module, with optional memory of device (GB) to estimate the
+  // maximum number of MeshBlocks per device
+  memory_registry::Report("at startup", pmesh->pmb_pack->nmb_thispack,
+                          pin->GetOrAddReal("job", "device_memory", 0.0));
   return;
 }
 
@@ -366,7 +516,43 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
   }
 
   if (time_evolution == TimeEvolution::tstatic) {
-    // TODO(@user): add work for time static problems here
+    // Data is frozen: each pass runs the "static" TaskList (filled by physics modules or
+    // the problem generator, e.g. steady-state radiation or tracing particles through
+    // fixed fields) and any enrolled user function, then writes outputs with dcycle>0.
+    // Derived quantities are computed on the device by the outputs themselves.
+    Real elapsed_time = -1.;
+    if (wall_time > 0.) {
+      elapsed_time = UpdateWallClock();
+    }
+    for (int pass=1; (pass<=nstatic) && (elapsed_time < wall_time); ++pass) {
+      if (global_variable::my_rank == 0 && (pmesh->ncycle % ndiag == 0)) {
+        std::cout << "elapsed=" << std::scientific << std::setprecision(6)
+                  << pwall_clock_->seconds() << " static pass=" << pass << std::endl;
+      }
+      ExecuteTaskList(pmesh, "static", pass);
+      if (pmesh->pgen->user_static_func != nullptr) {
+        (pmesh->pgen->user_static_func)(pmesh, pass);
+      }
+      pmesh->ncycle++;
+      nmb_updated_ += pmesh->nmb_total;
+
+      // stream outputs (only those set by cycle; time does not advance)
+      for (auto &out : pout->pout_list) {
+        memory_registry::Scope mem_scope("outputs");
+        int &dcycle_ = out->out_params.dcycle;
+        if ((dcycle_ > 0) && ((pmesh->ncycle)%(dcycle_) == 0)) {
+          if (out->out_params.async) {
+            pout->WriteOutputAsync(out, pmesh, pin, host_tasks);
+          } else {
+            out->LoadOutputData(pmesh);
+            out->WriteOutputFile(pmesh, pin);
+          }
+        }
+      }
+      if (wall_time > 0.) {
+        elapsed_time = UpdateWallClock();
+      }
+    }
   } else {
     Real elapsed_time = -1.;
     if (wall_time > 0.) {
@@ -375,9 +561,16 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
     while ((pmesh->time < tlim) && (pmesh->ncycle < nlim || nlim < 0) &&
            (elapsed_time < wall_time)) {
       if (global_variable::my_rank == 0) {OutputCycleDiagnostics(pmesh);}
+      if (task_timers_ && (pmesh->ncycle > 0) && (pmesh->ncycle % ndiag == 0)) {
+        OutputTaskTimers(pmesh);
+      }
+      if (comm_stats::enabled && (pmesh->ncycle > 0) && (pmesh->ncycle % ndiag == 0)) {
+        comm_stats::Report(pmesh->ncycle);
+      }
 
       // Execute TaskLists
       // Work before time integrator indicated by "0" in stage
+      imex_err = 0.0;
       ExecuteTaskList(pmesh, "before_timeintegrator", 0);
 
       // time-integrator tasks for each stage of integrator
@@ -387,15 +580,39 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
         ExecuteTaskList(pmesh, "after_stagen", stage);
       }
 
+      // super-time-stepping of diffusion terms over the full timestep in nsts sub-stages,
+      // operator split from the time integrator.  Sub-stage index passed as stage.
+      if (pmesh->pmb_pack->phydro != nullptr) {
+        int nsts = pmesh->pmb_pack->phydro->SetSTSStages(pmesh->dt, pmesh->dt_sts);
+        for (int sts=1; sts<=nsts; ++sts) {
+          ExecuteTaskList(pmesh, "before_sts", sts);
+          ExecuteTaskList(pmesh, "sts", sts);
+          ExecuteTaskList(pmesh, "after_sts", sts);
+        }
+      }
+
       // Work after time integrator indicated by "1" in stage
       ExecuteTaskList(pmesh, "after_timeintegrator", 1);
+      if (imex_adaptive) {ImExStepControl(pmesh);}
+      // start reduction of new timestep over ranks, completed after outputs and AMR
+      pmesh->StartNewTimeStep();
+
+      // accumulate measured cost (time spent in tasks) of MeshBlocks on this rank
+      if (pmesh->cost_model.measured) {
+        double tbusy = 0.0;
+        for (auto &it : pmesh->pmb_pack->tl_map) {
+          tbusy += it.second->BusyTime();
+          it.second->ResetBusyTime();
+        }
+        pmesh->UpdateMeasuredCost(tbusy);
+      }
 
       // Work outside of TaskLists:
       // increment time, ncycle, etc.
       pmesh->time = pmesh->time + pmesh->dt;
       pmesh->ncycle++;
       nmb_updated_ += pmesh->nmb_total;
-      npart_updated_ += pmesh->nprtcl_total;
+      npart_updated_ += pmesh->nprtcl_thisrank;   // summed over ranks in Finalize()
       // load balancing efficiency
       if (global_variable::nranks > 1) {
         int minnmb = std::numeric_limits<int>::max();
@@ -407,7 +624,15 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
       }
 
       // Test for/make outputs
+      Kokkos::Profiling::pushRegion("Outputs");
+      Kokkos::Timer phase_timer;
       for (auto &out : pout->pout_list) {
+        memory_registry::Scope mem_scope("outputs");
+        // add data to time-averaged outputs between output times
+        if ((out->out_params.accumulate_dcycle > 0) &&
+            ((pmesh->ncycle)%(out->out_params.accumulate_dcycle) == 0)) {
+          out->AccumulateOutputData(pmesh);
+        }
         // compare at floating point (32-bit) precision to reduce effect of round off
         float time_32 = static_cast<float>(pmesh->time);
         float next_32 = static_cast<float>(out->out_params.last_time+out->out_params.dt);
@@ -416,15 +641,54 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
 
         if (((out->out_params.dt > 0.0) && ((time_32 >= next_32) && (time_32<tlim_32))) ||
             ((dcycle_ > 0) && ((pmesh->ncycle)%(dcycle_) == 0)) ) {
-          out->LoadOutputData(pmesh);
-          out->WriteOutputFile(pmesh, pin);
+          if (out->out_params.async) {
+            pout->WriteOutputAsync(out, pmesh, pin, host_tasks);
+          } else {
+            out->LoadOutputData(pmesh);
+            out->WriteOutputFile(pmesh, pin);
+          }
         }
       }
+      Kokkos::Profiling::popRegion();
+      bool cycle_log = !(cycle_log_file_.empty());
+      if (cycle_log) {
+        Kokkos::fence();
+        phase_time_[outputs] += phase_timer.seconds();
+        phase_timer.reset();
+      }
 
       // AMR
-      if (pmesh->adaptive) {pmesh->pmr->AdaptiveMeshRefinement(this, pin);}
-      // compute new timestep AFTER all Meshblocks refined/derefined
-      pmesh->NewTimeStep(tlim);
+      Kokkos::Profiling::pushRegion("MeshRefinement");
+      int nregrid = pmesh->nregrid;
+      int ncreated = (pmesh->pmr != nullptr)? pmesh->pmr->nmb_created : 0;
+      int ndeleted = (pmesh->pmr != nullptr)? pmesh->pmr->nmb_deleted : 0;
+      {
+        memory_registry::Scope mem_scope("amr");
+        if (pmesh->adaptive) {pmesh->pmr->AdaptiveMeshRefinement(this, pin);}
+        // incremental rebalancing of MBs between neighboring ranks (if load imbalanced)
+        if (pmesh->rebalance) {pmesh->pmr->IncrementalRebalance(this, pin);}
+      }
+      Kokkos::Profiling::popRegion();
+      if (cycle_log) {
+        Kokkos::fence();
+        phase_time_[amr] += phase_timer.seconds();
+      }
+      if (memory_registry::enabled && (pmesh->nregrid != nregrid)) {
+        memory_registry::Report("after regrid at cycle=" + std::to_string(pmesh->ncycle),
+                                pmesh->pmb_pack->nmb_thispack,
+                                pin->GetOrAddReal("job", "device_memory", 0.0));
+      }
+      // complete new timestep, recomputed if Meshblocks were refined/derefined/moved
+      phase_timer.reset();
+      if (pmesh->nregrid != nregrid) {pmesh->StartNewTimeStep();}
+      pmesh->FinishNewTimeStep(tlim);
+      if (cycle_log) {
+        Kokkos::fence();
+        phase_time_[new_dt] += phase_timer.seconds();
+        OutputCycleLog(pmesh, ncreated, ndeleted);
+      }
+      // communication counters include AMR and load balancing in this cycle
+      comm_stats::EndCycle();
 
       // Update wall clock time if needed.
       if (wall_time > 0.) {
@@ -441,8 +705,10 @@ void Driver::Execute(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
 //!  and printing diagnostic messages
 
 void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
-  // cycle through output Types and load data / write files
-  //  This design allows for asynchronous outputs to implemented in the future.
+  // wait for host tasks and asynchronous outputs to finish, then cycle through output
+  // Types and load data / write files
+  host_tasks.Wait();
+  pout->FinishAsyncOutputs();
   for (auto &out : pout->pout_list) {
     out->LoadOutputData(pmesh);
     out->WriteOutputFile(pmesh, pin);
@@ -458,10 +724,15 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
   if (time_evolution != TimeEvolution::tstatic) {
 #if MPI_PARALLEL_ENABLED
     // Collect number of MeshBlocks communicated during load balancing across all ranks
-    if (pmesh->adaptive) {
+    if (pmesh->adaptive || pmesh->rebalance) {
       MPI_Allreduce(MPI_IN_PLACE, &(pmesh->pmr->nmb_sent_thisrank), 1, MPI_INT, MPI_SUM,
                     MPI_COMM_WORLD);
     }
+    // particles updated on each rank are only counted locally during the run
+    if (pmesh->pmb_pack->ppart != nullptr) {
+      MPI_Allreduce(MPI_IN_PLACE, &npart_updated_, 1, MPI_UINT64_T, MPI_SUM,
+                    MPI_COMM_WORLD);
+    }
 #endif
     if (global_variable::my_rank == 0) {
       // Print diagnostic messages related to the end of the simulation
@@ -485,6 +756,13 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
         std::cout << pmesh->pmr->nmb_sent_thisrank << " communicated for load balancing, "
           <<"load balancing efficiency = " << (lb_efficiency_/pmesh->ncycle) << std::endl;
 #endif
+      } else if (pmesh->rebalance) {
+        std::cout << std::endl << pmesh->pmr->nmb_sent_thisrank << " MeshBlocks "
+          << "communicated for incremental rebalancing" << std::endl;
+      }
+      if (imex_adaptive) {
+        std::cout << std::endl << nimex_exceed_ << " cycles exceeded error tolerance of "
+          << "stiff source terms" << std::endl;
       }
 
       // Calculate and print the zone-cycles/cpu-second
@@ -499,6 +777,12 @@ void Driver::Finalize(Mesh *pmesh, ParameterInput *pin, Outputs *pout) {
       std::cout << "zone-cycles/cpu_second = " << zcps << std::endl;
       std::cout << "particle-updates/cpu_second = " << pups << std::endl;
     }
+    if (task_timers_) {OutputTaskTimers(pmesh);}
+    if (!(bench_file_.empty())) {OutputBenchmark(pmesh, pin, exe_time);}
+    kernel_profiler::Report();
+  } else if (global_variable::my_rank == 0) {
+    std::cout << std::endl << "Terminating static problem at cycle=" << pmesh->ncycle
+              << std::endl << "cpu time used  = " << exe_time << std::endl;
   }
   return;
 }
@@ -520,7 +804,256 @@ void Driver::OutputCycleDiagnostics(Mesh *pm) {
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn Driver::UpdateWallClock()
+//! \fn Driver::ImExStepControl()
+//! \brief Sets the limit on the next timestep from the error estimate of stiff source
+//! terms in the step just taken.  Each ImEx source term adds to imex_err in its last
+//! stage the embedded estimate dt*|R(U^last) - R(U^1)|/(atol + rtol*|U|), i.e. the
+//! difference between the ImEx update and a first-order update with the stiff source
+//! frozen at its first implicit stage, normalized so that 1 is the tolerance.  Since it
+//! is O(dt^2), the next step is scaled by 0.9/sqrt(err), limited to [0.2,5].  Steps
+//! with err > 1 are not repeated, but reduce the next step and are counted.
+//! Must be called by all ranks.
+
+void Driver::ImExStepControl(Mesh *pm) {
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &imex_err, 1, MPI_ATHENA_REAL, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  Real fac = 0.9/std::sqrt(std::max(imex_err, static_cast<Real>(1.0e-10)));
+  fac = std::min(std::max(fac, static_cast<Real>(0.2)), static_cast<Real>(5.0));
+  pm->dt_imex = fac*(pm->dt);
+  if (imex_err > 1.0) {
+    nimex_exceed_++;
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Error estimate of stiff source terms = " << imex_err
+                << " exceeds tolerance in cycle " << pm->ncycle << ", next dt limited "
+                << "to " << pm->dt_imex << std::endl;
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::OutputCycleLog()
+//! \brief Appends one line to the cycle log with the time spent in each phase of the
+//! cycle just completed (maximum over ranks), the number of regrids so far, and the
+//! number of MeshBlocks created, deleted and migrated between ranks in this cycle.
+//! Arguments are values of the (cumulative) AMR counters before AMR in this cycle.
+//! Must be called by all ranks.
+
+void Driver::OutputCycleLog(Mesh *pm, int ncreated, int ndeleted) {
+  int nsent = 0;
+  if (pm->pmr != nullptr) {
+    nsent = pm->pmr->nmb_sent_thisrank - nmb_sent_last_;
+    nmb_sent_last_ = pm->pmr->nmb_sent_thisrank;
+    ncreated = pm->pmr->nmb_created - ncreated;
+    ndeleted = pm->pmr->nmb_deleted - ndeleted;
+  } else {
+    ncreated = 0;
+    ndeleted = 0;
+  }
+#if MPI_PARALLEL_ENABLED
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, phase_time_.data(), nphase, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, &nsent, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(phase_time_.data(), nullptr, nphase, MPI_DOUBLE, MPI_MAX, 0,
+               MPI_COMM_WORLD);
+    MPI_Reduce(&nsent, nullptr, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  }
+#endif
+
+  if (global_variable::my_rank == 0) {
+    FILE *pfile;
+    if ((pfile = std::fopen(cycle_log_file_.c_str(),"a")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << cycle_log_file_ << "' could not be opened"
+        << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (!(cycle_log_header_)) {
+      int iout = 1;
+      std::fprintf(pfile,"# Athena++ cycle log (times in seconds, max over ranks)\n");
+      std::fprintf(pfile,"#  [%d]=cycle     ", iout++);
+      std::fprintf(pfile,"[%d]=time      ", iout++);
+      std::fprintf(pfile,"[%d]=dt        ", iout++);
+      for (int n=0; n<nphase; ++n) {
+        std::fprintf(pfile,"[%d]=%-15s ", iout++, phase_label[n]);
+      }
+      std::fprintf(pfile,"[%d]=nregrid   ", iout++);
+      std::fprintf(pfile,"[%d]=ncreated  ", iout++);
+      std::fprintf(pfile,"[%d]=ndeleted  ", iout++);
+      std::fprintf(pfile,"[%d]=nmigrated\n", iout++);
+      cycle_log_header_ = true;
+    }
+    std::fprintf(pfile, "%12d %e %e", pm->ncycle, pm->time, pm->dt);
+    for (int n=0; n<nphase; ++n) {
+      std::fprintf(pfile, " %e", phase_time_[n]);
+    }
+    std::fprintf(pfile, " %d %d %d %d\n", pm->nregrid, ncreated, ndeleted, nsent);
+    std::fclose(pfile);
+  }
+  std::fill(phase_time_.begin(), phase_time_.end(), 0.0);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::ReduceTaskTimers()
+//! \brief Collects timers of every task in all TaskLists since start of run, and reduces
+//! device times across ranks.  Must be called by all ranks.
+
+void Driver::ReduceTaskTimers(Mesh *pm, TaskTimerSummary &ts) {
+  for (auto &it : pm->pmb_pack->tl_map) {
+    for (auto &task : it.second->Tasks()) {
+      ts.names.push_back(it.first + "/" + task.GetName());
+      ts.ncall.push_back(task.NumCalls());
+      ts.thost.push_back(task.HostTime());
+      ts.tdvce.push_back(task.DeviceTime());
+    }
+  }
+  int ntask = ts.names.size();
+  ts.tmin = ts.tdvce;
+  ts.tavg = ts.tdvce;
+  struct DoubleInt {double val; int rank;};  // layout matches MPI_DOUBLE_INT
+  std::vector<DoubleInt> tmax_loc(ntask);
+  for (int n=0; n<ntask; ++n) {
+    tmax_loc[n].val = ts.tdvce[n];
+    tmax_loc[n].rank = global_variable::my_rank;
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, ts.tmin.data(), ntask, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, ts.tavg.data(), ntask, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, tmax_loc.data(), ntask, MPI_DOUBLE_INT, MPI_MAXLOC,
+                MPI_COMM_WORLD);
+#endif
+  ts.tmax.resize(ntask);
+  ts.rank_max.resize(ntask);
+  for (int n=0; n<ntask; ++n) {
+    ts.tavg[n] /= static_cast<double>(global_variable::nranks);
+    ts.tmax[n] = tmax_loc[n].val;
+    ts.rank_max[n] = tmax_loc[n].rank;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::OutputTaskTimers()
+//! \brief Prints table of time spent in each task of every TaskList since start of run:
+//! number of calls, host and (fenced) device time on rank 0, and min/avg/max of device
+//! time across ranks with rank of max.  Must be called by all ranks.
+
+void Driver::OutputTaskTimers(Mesh *pm) {
+  TaskTimerSummary ts;
+  ReduceTaskTimers(pm, ts);
+
+  if (global_variable::my_rank == 0) {
+    int ntask = ts.names.size();
+    double ttot = 0.0;
+    for (int n=0; n<ntask; ++n) {ttot += ts.tdvce[n];}
+    std::cout << std::endl << "Task timers (seconds) at cycle=" << pm->ncycle
+              << ", rank 0 total=" << std::scientific << std::setprecision(3) << ttot
+              << std::endl << std::left << std::setw(40) << "tasklist/task"
+              << std::right << std::setw(9) << "calls" << std::setw(11) << "host"
+              << std::setw(11) << "device" << std::setw(11) << "min" << std::setw(11)
+              << "avg" << std::setw(11) << "max" << std::setw(7) << "rank" << std::endl;
+    for (int n=0; n<ntask; ++n) {
+      std::cout << std::left << std::setw(40) << ts.names[n] << std::right
+                << std::setw(9) << ts.ncall[n] << std::setw(11) << ts.thost[n]
+                << std::setw(11) << ts.tdvce[n] << std::setw(11) << ts.tmin[n]
+                << std::setw(11) << ts.tavg[n] << std::setw(11) << ts.tmax[n]
+                << std::setw(7) << ts.rank_max[n] << std::endl;
+    }
+    std::cout << std::endl;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Driver::OutputBenchmark()
+//! \brief Writes machine-readable (JSON) summary of the performance of this run to the
+//! file <time>/benchmark_file: throughput, high-water mark of resident host memory,
+//! fraction of time spent in communication tasks, I/O bandwidth, and per-task timers.
+//! Must be called by all ranks.
+//!
+//! The communication fraction is the time spent in tasks that send, receive, or clear
+//! boundary/flux buffers (including polling for MPI messages that have not arrived),
+//! averaged over ranks and divided by the run time.  I/O bandwidth counts all data
+//! written through IOWrapper (binary, restart, and particle outputs).
+
+void Driver::OutputBenchmark(Mesh *pm, ParameterInput *pin, double exe_time) {
+  TaskTimerSummary ts;
+  ReduceTaskTimers(pm, ts);
+  int ntask = ts.names.size();
+  double tcomm = 0.0;
+  for (int n=0; n<ntask; ++n) {
+    const std::string &name = ts.names[n];
+    if (name.find("Send") != std::string::npos || name.find("Recv") != std::string::npos
+        || name.find("Clear") != std::string::npos) {
+      tcomm += ts.tavg[n];
+    }
+  }
+
+  // high-water mark of resident memory (ru_maxrss is in kB on Linux, bytes on macOS)
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+  double hwm_max = static_cast<double>(usage.ru_maxrss);
+#else
+  double hwm_max = 1024.0*static_cast<double>(usage.ru_maxrss);
+#endif
+  double hwm_sum = hwm_max;
+  double io_bytes = static_cast<double>(IOWrapper::bytes_written.load());
+  double io_time = 1.0e-9*static_cast<double>(IOWrapper::write_nsec.load());
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &hwm_max, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &hwm_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &io_bytes, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &io_time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  if (global_variable::my_rank != 0) {return;}
+
+  std::uint64_t zonecycles = nmb_updated_ *
+                             static_cast<uint64_t>(pm->NumberOfMeshBlockCells());
+  std::ofstream fout(bench_file_);
+  if (!(fout.is_open())) {
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Could not open benchmark file '" << bench_file_ << "'" << std::endl;
+    return;
+  }
+  fout << std::setprecision(8);
+  fout << "{" << std::endl
+       << "  \"basename\": \"" << pin->GetString("job","basename") << "\"," << std::endl
+       << "  \"nranks\": " << global_variable::nranks << "," << std::endl
+       << "  \"meshblock\": [" << pm->mb_indcs.nx1 << ", " << pm->mb_indcs.nx2 << ", "
+       << pm->mb_indcs.nx3 << "]," << std::endl
+       << "  \"nmb_total\": " << pm->nmb_total << "," << std::endl
+       << "  \"ncycle\": " << pm->ncycle << "," << std::endl
+       << "  \"run_time\": " << exe_time << "," << std::endl
+       << "  \"zone_cycles_per_second\": "
+       << static_cast<double>(zonecycles)/exe_time << "," << std::endl
+       << "  \"particle_updates_per_second\": "
+       << static_cast<double>(npart_updated_)/exe_time << "," << std::endl
+       << "  \"memory_hwm_bytes\": {\"max\": " << hwm_max << ", \"sum\": " << hwm_sum
+       << "}," << std::endl
+       << "  \"comm_fraction\": " << tcomm/exe_time << "," << std::endl
+       << "  \"io\": {\"bytes\": " << io_bytes << ", \"seconds\": " << io_time
+       << ", \"bandwidth\": " << ((io_time > 0.0)? io_bytes/io_time : 0.0) << "},"
+       << std::endl
+       << "  \"tasks\": [" << std::endl;
+  for (int n=0; n<ntask; ++n) {
+    fout << "    {\"name\": \"" << ts.names[n] << "\", \"calls\": " << ts.ncall[n]
+         << ", \"host\": " << ts.thost[n] << ", \"device_min\": " << ts.tmin[n]
+         << ", \"device_avg\": " << ts.tavg[n] << ", \"device_max\": " << ts.tmax[n]
+         << "}" << ((n < ntask-1)? "," : "") << std::endl;
+  }
+  fout << "  ]" << std::endl << "}" << std::endl;
+  std::cout << "Benchmark results written to '" << bench_file_ << "'" << std::endl;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real Driver::UpdateWallClock()
 //! \brief Update and sync the wall clock across all MPI ranks. This is necessary because
 //! the different MPI ranks may 1) initialize their timers at slightly different times,
 //! and 2) may reach the end of a loop to update their timers at slightly different times.
@@ -15,11 +15,24 @@
 #include <ctime>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "parameter_input.hpp"
+#include "driver/host_tasks.hpp"
 #include "outputs/outputs.hpp"
 #include "pgen/pgen.hpp"
 
+//----------------------------------------------------------------------------------------
+//! \struct TaskTimerSummary
+//! \brief per-task timers of all TaskLists: number of calls and host and device time on
+//! this rank, and min/avg/max of device time across ranks (with rank of max).
+
+struct TaskTimerSummary {
+  std::vector<std::string> names;
+  std::vector<int> ncall, rank_max;
+  std::vector<double> thost, tdvce, tmin, tavg, tmax;
+};
+
 //----------------------------------------------------------------------------------------
 //! \class Driver
 
@@ -36,16 +49,24 @@ class Driver {
   Real tlim;      // stopping time
   int nlim;       // cycle-limit
   int ndiag;      // cycles between output of diagnostic information
+  int nstatic;    // number of passes over "static" TaskList (static problems only)
   // variables for various SSP and ImEx RK integrators
   std::string integrator;          // integrator name (rk1, rk2, rk3)
   int nimp_stages;                 // number of implicit stages (ImEx only)
   int nexp_stages;                 // number of explicit stages (both SSP-RK and ImEx)
-  Real gam0[4], gam1[4], beta[4];  // weights and fractional timestep per explicit stage
-  Real delta[4];                   // weights for updating the intermediate stage (u1)
+  Real gam0[10], gam1[10], beta[10]; // weights and fractional timestep per explicit stage
+  Real delta[10];                  // weights for updating the intermediate stage (u1)
+  bool low_storage;                // u1 += delta*u0 at start of each stage (2S methods)
   Real a_twid[4][4], a_impl;       // matrix elements for implicit stages in ImEx
   Real cfl_limit;                  // maximum CFL number for integrator
+  // error control of stiff source terms in ImEx integrators
+  bool imex_adaptive;              // limit dt with error estimate of stiff sources
+  Real imex_rtol, imex_atol;       // relative and absolute tolerances
+  Real imex_err;                   // max normalized error estimate in this cycle
   Kokkos::Timer* pwall_clock_;     // timer for tracking the wall clock
   Real wall_time;
+  // host-only tasks (asynchronous outputs, diagnostics) run on a background thread
+  HostTaskQueue host_tasks;
 
   // functions
   void ExecuteTaskList(Mesh *pm, std::string tl, int stage);
@@ -59,7 +80,19 @@ class Driver {
   std::uint64_t nmb_updated_;   // running total of MB updated during run
   std::uint64_t npart_updated_; // running total of particles updated during run
   float lb_efficiency_;         // measure of how efficient was load balancing
+  bool task_timers_;            // enables per-task timers in all TaskLists
+  std::string bench_file_;      // name of JSON file with benchmark results (if any)
+  std::string cycle_log_file_;  // name of per-cycle log of time in each phase (if any)
+  bool cycle_log_header_;       // true once header of cycle log has been written
+  std::vector<double> phase_time_;  // time in each phase of current cycle on this rank
+  int nmb_sent_last_;           // MBs sent by load balancing on this rank at last log
+  int nimex_exceed_;            // # of cycles in which imex_err exceeded 1
   void OutputCycleDiagnostics(Mesh *pm);
+  void ReduceTaskTimers(Mesh *pm, TaskTimerSummary &ts);
+  void OutputTaskTimers(Mesh *pm);
+  void OutputBenchmark(Mesh *pm, ParameterInput *pin, double exe_time);
+  void OutputCycleLog(Mesh *pm, int ncreated, int ndeleted);
+  void ImExStepControl(Mesh *pm);
   Real UpdateWallClock();
 };
 #endif // DRIVER_DRIVER_HPP_
@@ -0,0 +1,85 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file host_tasks.cpp
+//! \brief implements HostTaskQueue, see host_tasks.hpp
+
+#include <utility>
+
+#include "host_tasks.hpp"
+
+//----------------------------------------------------------------------------------------
+// destructor: runs all remaining tasks, then stops background thread
+
+HostTaskQueue::~HostTaskQueue() {
+  if (worker_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HostTaskQueue::Start()
+//! \brief Starts background thread.  Called by the Driver with <job>/host_tasks=true,
+//! and by Outputs when the first output is written asynchronously.
+
+void HostTaskQueue::Start() {
+  if (!(worker_.joinable())) {
+    worker_ = std::thread(&HostTaskQueue::WorkerLoop, this);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HostTaskQueue::Enqueue()
+//! \brief Queues task to be run by background thread, or runs it now if not started.
+
+void HostTaskQueue::Enqueue(std::function<void()> task) {
+  if (!(worker_.joinable())) {
+    task();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(task));
+    nflight_++;
+  }
+  cv_.notify_all();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HostTaskQueue::Wait()
+//! \brief Blocks until all queued tasks have been run.
+
+void HostTaskQueue::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this]{return nflight_ == 0;});
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HostTaskQueue::WorkerLoop()
+//! \brief Function run by background thread.  Runs queued tasks in order.
+
+void HostTaskQueue::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]{return stop_ || !queue_.empty();});
+      if (queue_.empty()) {return;}
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    task();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      nflight_--;
+    }
+    cv_.notify_all();
+  }
+}
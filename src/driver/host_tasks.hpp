@@ -0,0 +1,49 @@
+#ifndef DRIVER_HOST_TASKS_HPP_
+#define DRIVER_HOST_TASKS_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file host_tasks.hpp
+//! \brief HostTaskQueue: runs host-only tasks (writing outputs and diagnostics from
+//! snapshots of data) on a background thread, so they run on otherwise idle CPU cores
+//! while the time loop launches the next kernels.  Tasks are run one at a time in the
+//! order queued, since tasks may append to the same files or make MPI calls (over a
+//! duplicate communicator) that must be made in the same order on all ranks.  A task
+//! must only access data it owns, since the mesh continues to be evolved while it runs.
+//! Until Start() is called, Enqueue() runs tasks immediately on the calling thread.
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+//----------------------------------------------------------------------------------------
+//! \class HostTaskQueue
+
+class HostTaskQueue {
+ public:
+  HostTaskQueue() = default;
+  ~HostTaskQueue();
+  HostTaskQueue(const HostTaskQueue&) = delete;
+  HostTaskQueue &operator=(const HostTaskQueue&) = delete;
+
+  void Start();                                // start background thread (if not running)
+  bool Running() const {return worker_.joinable();}
+  void Enqueue(std::function<void()> task);    // queue task, or run it if not started
+  void Wait();                                 // block until all queued tasks are done
+
+ private:
+  void WorkerLoop();
+
+  std::thread worker_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> queue_;
+  int nflight_ = 0;      // number of tasks queued or running
+  bool stop_ = false;
+};
+
+#endif // DRIVER_HOST_TASKS_HPP_
@@ -9,6 +9,7 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -28,6 +29,7 @@
 #include "tasklist/numerical_relativity.hpp"
 
 #include "eos/primitive_solver_hyd.hpp"
+#include "dyn_grmhd/rsolvers/flux_dyn_grmhd.hpp"
 #include "eos/primitive-solver/idealgas.hpp"
 #include "eos/primitive-solver/piecewise_polytrope.hpp"
 #include "eos/primitive-solver/reset_floor.hpp"
@@ -94,7 +96,9 @@ DynGRMHD* BuildDynGRMHD(MeshBlockPack *ppack, ParameterInput *pin) {
   return dyn_gr;
 }
 
-DynGRMHD::DynGRMHD(MeshBlockPack *pp, ParameterInput *pin) : pmy_pack(pp) {
+DynGRMHD::DynGRMHD(MeshBlockPack *pp, ParameterInput *pin) :
+    face_metric("face_metric",1,1,1,1,1),
+    pmy_pack(pp) {
   std::string rsolver = pin->GetString("mhd", "rsolver");
   if (rsolver.compare("llf") == 0) {
     rsolver_method = DynGRMHD_RSolver::llf_dyngr;
@@ -122,11 +126,80 @@ DynGRMHD::DynGRMHD(MeshBlockPack *pp, ParameterInput *pin) : pmy_pack(pp) {
   dmp_M = pin->GetOrAddReal("mhd", "dmp_M", 1.2);
 
   fixed_evolution = pin->GetOrAddBoolean("mhd", "fixed", false);
+  pmy_pack->pmhd->fixed_fields = fixed_evolution;
+  c2p_tmunu = pin->GetOrAddBoolean("mhd", "c2p_tmunu", false);
+
+  // allocate cache of metric quantities at faces
+  {
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    int nmb = std::max((pmy_pack->nmb_thispack), (pmy_pack->pmesh->nmb_maxperrank));
+    Kokkos::realloc(face_metric.x1f, nmb, NFACEMETRIC, ncells3, ncells2, ncells1+1);
+    Kokkos::realloc(face_metric.x2f, nmb, NFACEMETRIC, ncells3, ncells2+1, ncells1);
+    Kokkos::realloc(face_metric.x3f, nmb, NFACEMETRIC, ncells3+1, ncells2, ncells1);
+  }
 }
 
 DynGRMHD::~DynGRMHD() {
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void DynGRMHD::UpdateFaceMetric()
+//! \brief Interpolates the metric, shift and lapse to all faces and stores them together
+//! with sqrt(det g) and g^{ii}, so that the Riemann solvers in CalcFluxes and FOFC do not
+//! repeat the interpolation and determinant at every face. The ADM variables only change
+//! in Z4c::Z4cToADM() (which clears face_metric_current) or when the mesh is regridded,
+//! so with a fixed metric the cache is filled only once.
+
+void DynGRMHD::UpdateFaceMetric() {
+  if (face_metric_current && face_metric_nregrid == pmy_pack->pmesh->nregrid) {
+    return;
+  }
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  int nmb = pmy_pack->nmb_thispack;
+  auto &adm = pmy_pack->padm->adm;
+
+  // interface i lives between cells i and i-1, so the first face is skipped
+  auto &fmet1 = face_metric.x1f;
+  par_for("face_metric_x1", DevExeSpace(), 0, nmb-1, 0, ncells3-1, 0, ncells2-1,
+          1, ncells1-1,
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real g3d[NSPMETRIC], beta_u[3], alpha;
+    adm::Face1Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+    StoreFaceMetric<IVX>(fmet1, m, k, j, i, g3d, beta_u, alpha);
+  });
+
+  if (pmy_pack->pmesh->multi_d) {
+    auto &fmet2 = face_metric.x2f;
+    par_for("face_metric_x2", DevExeSpace(), 0, nmb-1, 0, ncells3-1, 1, ncells2-1,
+            0, ncells1-1,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real g3d[NSPMETRIC], beta_u[3], alpha;
+      adm::Face2Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      StoreFaceMetric<IVY>(fmet2, m, k, j, i, g3d, beta_u, alpha);
+    });
+  }
+
+  if (pmy_pack->pmesh->three_d) {
+    auto &fmet3 = face_metric.x3f;
+    par_for("face_metric_x3", DevExeSpace(), 0, nmb-1, 1, ncells3-1, 0, ncells2-1,
+            0, ncells1-1,
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real g3d[NSPMETRIC], beta_u[3], alpha;
+      adm::Face3Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      StoreFaceMetric<IVZ>(fmet3, m, k, j, i, g3d, beta_u, alpha);
+    });
+  }
+
+  face_metric_current = true;
+  face_metric_nregrid = pmy_pack->pmesh->nregrid;
+}
+
 template<class EOSPolicy, class ErrorPolicy>
 void DynGRMHDPS<EOSPolicy, ErrorPolicy>::QueueDynGRMHDTasks() {
   using namespace mhd;  // NOLINT(build/namespaces)
@@ -175,9 +248,16 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::QueueDynGRMHDTasks() {
   pnr->QueueTask(&MHD::MHDSrcTerms, pmhd, MHD_AddSrc, "MHD_AddSrc", Task_Run,
                  {MHD_ExplRK});
   pnr->QueueTask(&MHD::RestrictU, pmhd, MHD_RestU, "MHD_RestU", Task_Run, {MHD_AddSrc});
-  pnr->QueueTask(&MHD::SendU, pmhd, MHD_SendU, "MHD_SendU", Task_Run, {MHD_RestU});
-  pnr->QueueTask(&MHD::RecvU, pmhd, MHD_RecvU, "MHD_RecvU", Task_Run, {MHD_SendU});
-  pnr->QueueTask(&MHD::CornerE, pmhd, MHD_EField, "MHD_EField", Task_Run, {MHD_RecvU});
+  if (pz4c != nullptr && pz4c->coalesce_halo) {
+    // conserved variables are communicated together with the Z4c variables
+    pnr->QueueTask(&MHD::CornerE, pmhd, MHD_EField, "MHD_EField", Task_Run,
+                   {Z4c_RecvU});
+  } else {
+    pnr->QueueTask(&MHD::SendU, pmhd, MHD_SendU, "MHD_SendU", Task_Run, {MHD_RestU});
+    pnr->QueueTask(&MHD::RecvU, pmhd, MHD_RecvU, "MHD_RecvU", Task_Run, {MHD_SendU});
+    pnr->QueueTask(&MHD::CornerE, pmhd, MHD_EField, "MHD_EField", Task_Run,
+                   {MHD_RecvU});
+  }
   pnr->QueueTask(&MHD::SendE, pmhd, MHD_SendE, "MHD_SendE", Task_Run, {MHD_EField});
   pnr->QueueTask(&MHD::RecvE, pmhd, MHD_RecvE, "MHD_RecvE", Task_Run, {MHD_SendE});
   pnr->QueueTask(&MHD::CT, pmhd, MHD_CT, "MHD_CT", Task_Run, {MHD_RecvE});
@@ -255,8 +335,15 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::ConToPrim(Driver *pdrive, int sta
   int n1m1 = indcs.nx1 + 2*ng - 1;
   int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
   int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  // Optionally compute the stress-energy tensor needed by the next stage in the same
+  // kernel, so that SetTmunu can be skipped.
+  bool set_tmunu = c2p_tmunu && (pmy_pack->ptmunu != nullptr);
   eos.ConsToPrim(pmy_pack->pmhd->u0, pmy_pack->pmhd->b0, pmy_pack->pmhd->bcc0,
-                 pmy_pack->pmhd->w0, 0, n1m1, 0, n2m1, 0, n3m1, false);
+                 pmy_pack->pmhd->w0, 0, n1m1, 0, n2m1, 0, n3m1, false, set_tmunu);
+  // C2P skips inactive MBs, so Tmunu must still be set there by SetTmunu
+  tmunu_current = set_tmunu &&
+                  (pmy_pack->pmb->nmb_active == pmy_pack->nmb_thispack);
+  tmunu_nregrid = pmy_pack->pmesh->nregrid;
   return TaskStatus::complete;
 }
 
@@ -354,10 +441,17 @@ TaskStatus DynGRMHD::ApplyPhysicalBCs(Driver *pdrive, int stage) {
 //! \fn  TaskStatus DynGRMHD::SetTmunu(Driver *pdrive, int stage)
 //! \brief Add the perfect fluid contribution to the stress-energy tensor. This is assumed
 //!  to be the first contribution, so it sets the values rather than adding.
+//!  With <mhd>/c2p_tmunu = true, the task is skipped if ConToPrim already computed
+//!  Tmunu from the current primitives (and the mesh has not been regridded since).
 TaskStatus DynGRMHD::SetTmunu(Driver *pdrive, int stage) {
   if (fixed_evolution) {
     return TaskStatus::complete;
   }
+  if (pdrive != nullptr && tmunu_current &&
+      tmunu_nregrid == pmy_pack->pmesh->nregrid) {
+    tmunu_current = false;
+    return TaskStatus::complete;
+  }
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   //auto &size  = pmy_pack->pmb->mb_size;
   int &is = indcs.is; int &ie = indcs.ie;
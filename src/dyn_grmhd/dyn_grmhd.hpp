@@ -92,6 +92,13 @@ class DynGRMHD {
   virtual void AddCoordTerms(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &bcc0,
                              const Real dt, DvceArray5D<Real> &u0, int nghost) = 0;
 
+  // Metric, shift, lapse, sqrt(det g) and g^{ii} interpolated to faces. Filled by
+  // UpdateFaceMetric() and shared by the Riemann solvers in CalcFluxes and FOFC.
+  DvceFaceFld5D<Real> face_metric;
+  bool face_metric_current = false;  // false once the ADM variables have changed
+  int face_metric_nregrid = -1;      // value of Mesh::nregrid when cache was filled
+  void UpdateFaceMetric();
+
   // DynGRMHD policies
   DynGRMHD_RSolver rsolver_method;
   DynGRMHD_RSolver fofc_method;
@@ -104,6 +111,9 @@ class DynGRMHD {
   bool enforce_maximum;     // enforce local maximum principle during FOFC
   Real dmp_M;               // threshold multiplier for discrete maximum principle.
   bool fixed_evolution;     // Disable mhd evolution
+  bool c2p_tmunu;           // compute Tmunu in ConToPrim instead of in SetTmunu
+  bool tmunu_current = false;  // Tmunu was set by ConToPrim for the current prims
+  int tmunu_nregrid = -1;      // value of Mesh::nregrid when ConToPrim set Tmunu
 };
 
 template<class EOSPolicy, class ErrorPolicy>
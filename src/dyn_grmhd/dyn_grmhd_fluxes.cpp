@@ -45,13 +45,14 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
 
   int nhyd = pmy_pack->pmhd->nmhd;
   int nvars = pmy_pack->pmhd->nmhd + pmy_pack->pmhd->nscalars;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
+  // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+  int nmba1 = pmy_pack->pmb->nmb_active - 1;
+  auto &mbact = pmy_pack->pmb->mb_active;
   const auto recon_method_ = pmy_pack->pmhd->recon_method;
   auto size_ = pmy_pack->pmb->mb_size;
   auto coord_ = pmy_pack->pcoord->coord_data;
   auto &w0_ = pmy_pack->pmhd->w0;
   auto &b0_ = pmy_pack->pmhd->bcc0;
-  auto &adm = pmy_pack->padm->adm;
   auto &eos_ = pmy_pack->pmhd->peos->eos_data;
   auto &dyn_eos_ = eos;
   auto &use_fofc = pmy_pack->pmhd->use_fofc;
@@ -64,6 +65,9 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     return TaskStatus::complete;
   }
 
+  // Interpolate the metric to faces, unless it has not changed since the last call
+  UpdateFaceMetric();
+
   //--------------------------------------------------------------------------------------
   // i-direction
 
@@ -74,6 +78,7 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
   auto &e31_ = pmy_pack->pmhd->e3x1;
   auto &e21_ = pmy_pack->pmhd->e2x1;
   auto &bx_  = pmy_pack->pmhd->b0.x1f;
+  auto &fmet1_ = face_metric.x1f;
 
   // set the loop limits for 1D/2D/3D problems
   int jl, ju, kl, ku;
@@ -88,8 +93,9 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
   if (use_fofc) { il = is-1, iu = ie+2; }
 
   par_for_outer("dyngrflux_x1",DevExeSpace(), scr_size, scr_level,
-      0, nmb1, kl, ku, jl, ju,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      0, nmba1, kl, ku, jl, ju,
+  KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k, const int j) {
+    const int m = mbact.d_view(mm);
     ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
     ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
     ScrArray2D<Real> bl(member.team_scratch(scr_level), 3, ncells1);
@@ -133,15 +139,15 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     auto &e21 = e21_;
     auto &nhyd_ = nhyd;
     auto nscal_ = nvars - nhyd;
-    auto &adm_ = adm;
+    auto &fmet1 = fmet1_;
     //int il = is; int iu = ie+1;
     if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
       LLF_DYNGR<IVX>(member, dyn_eos, indcs, size, coord, m, k, j, il, iu,
-                wl, wr, bl, br, bx, nhyd_, nscal_, adm_,
+                wl, wr, bl, br, bx, nhyd_, nscal_, fmet1,
                 flx1, e31, e21);
     } else if constexpr (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
       HLLE_DYNGR<IVX>(member, dyn_eos, indcs, size, coord, m, k, j, il, iu,
-                wl, wr, bl, br, bx, nhyd_, nscal_, adm_,
+                wl, wr, bl, br, bx, nhyd_, nscal_, fmet1,
                 flx1, e31, e21);
     }
     member.team_barrier();
@@ -171,6 +177,7 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     auto &by_ = pmy_pack->pmhd->b0.x2f;
     auto &e12_ = pmy_pack->pmhd->e1x2;
     auto &e32_ = pmy_pack->pmhd->e3x2;
+    auto &fmet2_ = face_metric.x2f;
 
     // set the loop limits for 2D/3D problems
     if (pmy_pack->pmesh->two_d) {
@@ -181,8 +188,9 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     jl = js-1, ju = je+1;
     if (use_fofc) { jl = js-2, ju = je+2; }
 
-    par_for_outer("dyngrflux_x2",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+    par_for_outer("dyngrflux_x2",DevExeSpace(), scr_size, scr_level, 0, nmba1, kl, ku,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k) {
+      const int m = mbact.d_view(mm);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -245,15 +253,15 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
         auto &e32  = e32_;
         auto &nhyd_ = nhyd;
         auto nscal_ = nvars - nhyd;
-        auto &adm_ = adm;
+        auto &fmet2 = fmet2_;
         //int il = is; int iu = ie;
         if (j>(jl)) {
           if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
             LLF_DYNGR<IVY>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, by, nhyd_, nscal_, adm_, flx2, e12, e32);
+                      wl, wr, bl, br, by, nhyd_, nscal_, fmet2, flx2, e12, e32);
           } else if constexpr (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
             HLLE_DYNGR<IVY>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, by, nhyd_, nscal_, adm_, flx2, e12, e32);
+                      wl, wr, bl, br, by, nhyd_, nscal_, fmet2, flx2, e12, e32);
           }
         }
         member.team_barrier();
@@ -285,12 +293,14 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
     auto &bz_   = pmy_pack->pmhd->b0.x3f;
     auto &e23_  = pmy_pack->pmhd->e2x3;
     auto &e13_  = pmy_pack->pmhd->e1x3;
+    auto &fmet3_ = face_metric.x3f;
 
     kl = ks-1, ku = ke+1;
     if (use_fofc) { kl = ks-2, ku = ke+2; }
 
-    par_for_outer("dyngrflux_x3",DevExeSpace(), scr_size, scr_level, 0, nmb1, js-1, je+1,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int j) {
+    par_for_outer("dyngrflux_x3",DevExeSpace(), scr_size, scr_level, 0, nmba1, js-1, je+1,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int j) {
+      const int m = mbact.d_view(mm);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -351,17 +361,17 @@ TaskStatus DynGRMHDPS<EOSPolicy, ErrorPolicy>::CalcFluxes(Driver *pdriver, int s
         auto &bz   = bz_;
         auto &e23  = e23_;
         auto &e13  = e13_;
-        auto &adm_ = adm;
+        auto &fmet3 = fmet3_;
         auto &nhyd_ = nhyd;
         auto nscal_ = nvars - nhyd;
         //int il = is; int iu = ie;
         if (k>(kl)) {
           if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
             LLF_DYNGR<IVZ>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, bz, nhyd_, nscal_, adm_, flx3, e23, e13);
+                      wl, wr, bl, br, bz, nhyd_, nscal_, fmet3, flx3, e23, e13);
           } else if constexpr (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
             HLLE_DYNGR<IVZ>(member, dyn_eos, indcs, size, coord, m, k, j, is-1, ie+1,
-                      wl, wr, bl, br, bz, nhyd_, nscal_, adm_, flx3, e23, e13);
+                      wl, wr, bl, br, bz, nhyd_, nscal_, fmet3, flx3, e23, e13);
           }
         }
         member.team_barrier();
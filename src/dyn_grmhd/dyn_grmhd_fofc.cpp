@@ -43,7 +43,9 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
   bool &multi_d = pmy_pack->pmesh->multi_d;
   bool &three_d = pmy_pack->pmesh->three_d;
 
-  int nmb = pmy_pack->nmb_thispack;
+  // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+  int nmba = pmy_pack->pmb->nmb_active;
+  auto &mbact = pmy_pack->pmb->mb_active;
   auto flx1 = pmy_pack->pmhd->uflx.x1f;
   auto flx2 = pmy_pack->pmhd->uflx.x2f;
   auto flx3 = pmy_pack->pmhd->uflx.x3f;
@@ -65,6 +67,17 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
     Real &gam1 = pdriver->gam1[stage-1];
     Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
 
+    // estimates of updated conserved variables and fields are only needed in this
+    // function, so they are stored in slots 0 and 1 of the MeshBlockPack scratch arena
+    int nmb = pmy_pack->nmb_thispack;
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    pmy_pack->pmhd->utest = pmy_pack->scratch.Get5D(0, nmb, nmhd_+nscal_, ncells3,
+                                                    ncells2, ncells1);
+    pmy_pack->pmhd->bcctest = pmy_pack->scratch.Get5D(1, nmb, 3, ncells3, ncells2,
+                                                      ncells1);
+
     auto &u0_ = pmy_pack->pmhd->u0;
     auto &u1_ = pmy_pack->pmhd->u1;
     auto &utest_ = pmy_pack->pmhd->utest;
@@ -83,8 +96,9 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
     if (three_d) { kl = ks-1, ku = ke+1, kadd = 1; }
 
     // Estimate updated conserved variables and cell-centered fields
-    par_for("FOFC-newu", DevExeSpace(), 0, nmb-1, kl, ku, jl, ju, il, iu,
-    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    par_for("FOFC-newu", DevExeSpace(), 0, nmba-1, kl, ku, jl, ju, il, iu,
+    KOKKOS_LAMBDA(const int mm, const int k, const int j, const int i) {
+      const int m = mbact.d_view(mm);
       Real dtodx1 = beta_dt/size.d_view(m).dx1;
       Real dtodx2 = beta_dt/size.d_view(m).dx2;
       Real dtodx3 = beta_dt/size.d_view(m).dx3;
@@ -157,7 +171,9 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
   auto &excision_flux_ = pmy_pack->pcoord->excision_flux;
   auto &w0_ = pmy_pack->pmhd->w0;
   auto &b0_ = pmy_pack->pmhd->b0;
-  auto &adm = pmy_pack->padm->adm;
+  auto &fmet1_ = face_metric.x1f;
+  auto &fmet2_ = face_metric.x2f;
+  auto &fmet3_ = face_metric.x3f;
 
   // Index bounds
   int il = is-1, iu = ie+1, jl = js, ju = je, kl = ks, ku = ke;
@@ -166,8 +182,9 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
 
   // Replace fluxes with first-order LLF fluxes at i,j,k faces for any cell where FOFC
   // and/or excision is used (if GR+excising)
-  par_for("FOFC-flx", DevExeSpace(), 0, nmb-1, kl, ku, jl, ju, il, iu,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  par_for("FOFC-flx", DevExeSpace(), 0, nmba-1, kl, ku, jl, ju, il, iu,
+  KOKKOS_LAMBDA(const int mm, const int k, const int j, const int i) {
+    const int m = mbact.d_view(mm);
     // Check for FOFC flag
     bool fofc_flag = false;
     if (use_fofc_) { fofc_flag = fofc_(m,k,j,i); }
@@ -188,17 +205,17 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
       bli[IBX] = bri[IBX] = b0_.x1f(m, k, j, i);
 
       // Compute the metric terms at i-1/2
-      Real g3d[NSPMETRIC], beta_u[3], alpha;
-      adm::Face1Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      Real g3d[NSPMETRIC], beta_u[3], alpha, sdetg, gii;
+      LoadFaceMetric(fmet1_, m, k, j, i, g3d, beta_u, alpha, sdetg, gii);
 
       // compute new 1st-order LLF flux at i-face
       Real flux[NCONS], bflux[NMAG];
       if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
         SingleStateLLF_DYNGR<IVX>(eos_, wli, wri, bli, bri, nmhd_, nscal_,
-                                  g3d, beta_u, alpha, flux, bflux);
+                                  g3d, beta_u, alpha, sdetg, gii, flux, bflux);
       } else if (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
         SingleStateHLLE_DYNGR<IVX>(eos_, wli, wri, bli, bri, nmhd_, nscal_,
-                                  g3d, beta_u, alpha, flux, bflux);
+                                  g3d, beta_u, alpha, sdetg, gii, flux, bflux);
       }
 
       // Store 1st-order fluxes at i-1/2
@@ -226,15 +243,15 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
         blj[IBY] = brj[IBY] = b0_.x2f(m, k, j, i);
 
         // Compute the metric terms at j-1/2
-        adm::Face2Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+        LoadFaceMetric(fmet2_, m, k, j, i, g3d, beta_u, alpha, sdetg, gii);
 
         // Compute new 1st-order LLF flux at j-face
         if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
           SingleStateLLF_DYNGR<IVY>(eos_, wlj, wrj, blj, brj, nmhd_, nscal_,
-                                    g3d, beta_u, alpha, flux, bflux);
+                                    g3d, beta_u, alpha, sdetg, gii, flux, bflux);
         } else if (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
           SingleStateHLLE_DYNGR<IVY>(eos_, wlj, wrj, blj, brj, nmhd_, nscal_,
-                                    g3d, beta_u, alpha, flux, bflux);
+                                    g3d, beta_u, alpha, sdetg, gii, flux, bflux);
         }
 
         // Store 1st-order fluxes at j-1/2
@@ -263,15 +280,15 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
         bmk[IBZ] = bpk[IBZ] = b0_.x3f(m, k, j, i);
 
         // Compute the metric terms at k-1/2
-        adm::Face3Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+        LoadFaceMetric(fmet3_, m, k, j, i, g3d, beta_u, alpha, sdetg, gii);
 
         // Compute new 1st-order LLF flux at k-face
         if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
           SingleStateLLF_DYNGR<IVZ>(eos_, wmk, wpk, bmk, bpk, nmhd_, nscal_,
-                                    g3d, beta_u, alpha, flux, bflux);
+                                    g3d, beta_u, alpha, sdetg, gii, flux, bflux);
         } else if (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
           SingleStateHLLE_DYNGR<IVZ>(eos_, wmk, wpk, bmk, bpk, nmhd_, nscal_,
-                                    g3d, beta_u, alpha, flux, bflux);
+                                    g3d, beta_u, alpha, sdetg, gii, flux, bflux);
         }
 
         // Store 1st-order fluxes at k-1/2
@@ -293,8 +310,9 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
 
   // Replace fluxes with first-order LLF fluxes at i+1,j+1,k+1 faces for any cell where
   // FOFC and/or excision is used (if GR+excising)
-  par_for("FOFC-flx", DevExeSpace(), 0, nmb-1, kl, ku, jl, ju, il, iu,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+  par_for("FOFC-flx", DevExeSpace(), 0, nmba-1, kl, ku, jl, ju, il, iu,
+  KOKKOS_LAMBDA(const int mm, const int k, const int j, const int i) {
+    const int m = mbact.d_view(mm);
     // Check for FOFC flag
     bool fofc_flag = false;
     if (use_fofc_) { fofc_flag = fofc_(m,k,j,i); }
@@ -315,17 +333,17 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
       bli[IBX] = bri[IBX] = b0_.x1f(m, k, j, i+1);
 
       // Compute the metric terms at i+1/2
-      Real g3d[NSPMETRIC], beta_u[3], alpha;
-      adm::Face1Metric(m, k, j, i+1, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
+      Real g3d[NSPMETRIC], beta_u[3], alpha, sdetg, gii;
+      LoadFaceMetric(fmet1_, m, k, j, i+1, g3d, beta_u, alpha, sdetg, gii);
 
       // compute new 1st-order LLF flux at (i+1)-face
       Real flux[NCONS], bflux[NMAG];
       if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
         SingleStateLLF_DYNGR<IVX>(eos_, wli, wri, bli, bri, nmhd_, nscal_,
-                             g3d, beta_u, alpha, flux, bflux);
+                             g3d, beta_u, alpha, sdetg, gii, flux, bflux);
       } else if (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
         SingleStateLLF_DYNGR<IVX>(eos_, wli, wri, bli, bri, nmhd_, nscal_,
-                             g3d, beta_u, alpha, flux, bflux);
+                             g3d, beta_u, alpha, sdetg, gii, flux, bflux);
       }
 
       // Store 1st-order fluxes at i+1/2
@@ -353,16 +371,15 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
         blj[IBY] = brj[IBY] = b0_.x2f(m, k, j+1, i);
 
         // Compute the metric terms at j+1/2
-        adm::Face2Metric(m, k, j+1, i, adm.g_dd, adm.beta_u, adm.alpha,
-                         g3d, beta_u, alpha);
+        LoadFaceMetric(fmet2_, m, k, j+1, i, g3d, beta_u, alpha, sdetg, gii);
 
         // Compute new 1st-order LLF flux at j-face
         if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
           SingleStateLLF_DYNGR<IVY>(eos_, wlj, wrj, blj, brj, nmhd_, nscal_,
-                                    g3d, beta_u, alpha, flux, bflux);
+                                    g3d, beta_u, alpha, sdetg, gii, flux, bflux);
         } else if (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
           SingleStateHLLE_DYNGR<IVY>(eos_, wlj, wrj, blj, brj, nmhd_, nscal_,
-                                    g3d, beta_u, alpha, flux, bflux);
+                                    g3d, beta_u, alpha, sdetg, gii, flux, bflux);
         }
 
         // Store 1st-order fluxes at j+1/2
@@ -391,16 +408,15 @@ void DynGRMHDPS<EOSPolicy, ErrorPolicy>::FOFC(Driver *pdriver, int stage) {
         bmk[IBZ] = bpk[IBZ] = b0_.x3f(m, k+1, j, i);
 
         // Compute the metric terms at k+1/2
-        adm::Face3Metric(m, k+1, j, i, adm.g_dd, adm.beta_u, adm.alpha,
-                         g3d, beta_u, alpha);
+        LoadFaceMetric(fmet3_, m, k+1, j, i, g3d, beta_u, alpha, sdetg, gii);
 
         // Compute new 1st-order LLF flux at k-face
         if constexpr (rsolver_method_ == DynGRMHD_RSolver::llf_dyngr) {
           SingleStateLLF_DYNGR<IVZ>(eos_, wmk, wpk, bmk, bpk, nmhd_, nscal_,
-                                    g3d, beta_u, alpha, flux, bflux);
+                                    g3d, beta_u, alpha, sdetg, gii, flux, bflux);
         } else if (rsolver_method_ == DynGRMHD_RSolver::hlle_dyngr) {
           SingleStateHLLE_DYNGR<IVZ>(eos_, wmk, wpk, bmk, bpk, nmhd_, nscal_,
-                                    g3d, beta_u, alpha, flux, bflux);
+                                    g3d, beta_u, alpha, sdetg, gii, flux, bflux);
         }
 
         // Store 1st-order fluxes at k+1/2
@@ -15,6 +15,59 @@
 
 namespace dyngr {
 
+// Components of the face-centered metric cache (DynGRMHD::face_metric). The 3-metric
+// occupies the first NSPMETRIC components, in the same order as g3d.
+enum FaceMetricIndex {FM_BETAX=NSPMETRIC, FM_BETAY, FM_BETAZ, FM_ALPHA, FM_SDETG, FM_GII,
+                      NFACEMETRIC};
+
+//----------------------------------------------------------------------------------------
+//! \fn void StoreFaceMetric
+//! \brief stores the metric, shift and lapse at a face in the cache, together with
+//! sqrt(det g) and the component g^{ii} of the inverse metric normal to the face.
+
+template<int ivx>
+KOKKOS_INLINE_FUNCTION
+void StoreFaceMetric(const DvceArray5D<Real> &fmet,
+                     const int m, const int k, const int j, const int i,
+                     const Real g3d[NSPMETRIC], const Real beta_u[3], const Real alpha) {
+  constexpr int diag[3] = {S11, S22, S33};
+  constexpr int offdiag[3] = {S23, S13, S12};
+  constexpr int offidx = offdiag[ivx - IVX];
+  constexpr int idxy = diag[(ivx - IVX + 1) % 3];
+  constexpr int idxz = diag[(ivx - IVX + 2) % 3];
+
+  Real detg = Primitive::GetDeterminant(g3d);
+  for (int n = 0; n < NSPMETRIC; ++n) {
+    fmet(m, n, k, j, i) = g3d[n];
+  }
+  fmet(m, FM_BETAX, k, j, i) = beta_u[0];
+  fmet(m, FM_BETAY, k, j, i) = beta_u[1];
+  fmet(m, FM_BETAZ, k, j, i) = beta_u[2];
+  fmet(m, FM_ALPHA, k, j, i) = alpha;
+  fmet(m, FM_SDETG, k, j, i) = sqrt(detg);
+  fmet(m, FM_GII, k, j, i) = (g3d[idxy]*g3d[idxz] - g3d[offidx]*g3d[offidx])/detg;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LoadFaceMetric
+//! \brief reads the metric quantities at a face from the cache filled by StoreFaceMetric
+
+KOKKOS_INLINE_FUNCTION
+void LoadFaceMetric(const DvceArray5D<Real> &fmet,
+                    const int m, const int k, const int j, const int i,
+                    Real g3d[NSPMETRIC], Real beta_u[3], Real &alpha,
+                    Real &sdetg, Real &gii) {
+  for (int n = 0; n < NSPMETRIC; ++n) {
+    g3d[n] = fmet(m, n, k, j, i);
+  }
+  beta_u[0] = fmet(m, FM_BETAX, k, j, i);
+  beta_u[1] = fmet(m, FM_BETAY, k, j, i);
+  beta_u[2] = fmet(m, FM_BETAZ, k, j, i);
+  alpha = fmet(m, FM_ALPHA, k, j, i);
+  sdetg = fmet(m, FM_SDETG, k, j, i);
+  gii = fmet(m, FM_GII, k, j, i);
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void SingleStateFlux
 //! \brief inline function for calculating GRMHD fluxes
@@ -30,20 +30,13 @@ KOKKOS_INLINE_FUNCTION
 void SingleStateLLF_DYNGR(const PrimitiveSolverHydro<EOSPolicy, ErrorPolicy>& eos,
     Real prim_l[NPRIM], Real prim_r[NPRIM], Real Bu_l[NPRIM], Real Bu_r[NPRIM],
     const int nmhd, const int nscal,
-    Real g3d[NSPMETRIC], Real beta_u[3], Real alpha,
+    Real g3d[NSPMETRIC], Real beta_u[3], Real alpha, Real sdetg, Real gii,
     Real flux[NCONS], Real bflux[NMAG]) {
   constexpr int iby = ((ivx - IVX) + 1)%3;
   constexpr int ibz = ((ivx - IVX) + 2)%3;
 
-  constexpr int diag[3] = {S11, S22, S33};
-  constexpr int offdiag[3] = {S23, S13, S12};
-  constexpr int offidx = offdiag[ivx - IVX];
-  constexpr int idxy = diag[(ivx - IVX + 1) % 3];
-  constexpr int idxz = diag[(ivx - IVX + 2) % 3];
-
   constexpr int pvx = PVX + (ivx - IVX);
 
-  Real sdetg = sqrt(Primitive::GetDeterminant(g3d));
   Real isdetg = 1.0/sdetg;
 
   // Undensitize the magnetic field before calculating the conserved variables
@@ -63,7 +56,6 @@ void SingleStateLLF_DYNGR(const PrimitiveSolverHydro<EOSPolicy, ErrorPolicy>& eo
 
   // Calculate the magnetosonic speeds for both states
   Real lambda_pl, lambda_pr, lambda_ml, lambda_mr;
-  Real gii = (g3d[idxy]*g3d[idxz] - g3d[offidx]*g3d[offidx])*(isdetg*isdetg);
   eos.GetGRFastMagnetosonicSpeeds(lambda_pl, lambda_ml, prim_l, bsql,
                                   g3d, beta_u, alpha, gii, pvx);
   eos.GetGRFastMagnetosonicSpeeds(lambda_pr, lambda_mr, prim_r, bsqr,
@@ -105,33 +97,20 @@ void LLF_DYNGR(TeamMember_t const &member,
      const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr,
      const ScrArray2D<Real> &bl, const ScrArray2D<Real> &br, const DvceArray4D<Real> &bx,
      const int& nhyd, const int& nscal,
-     const adm::ADM::ADM_vars& adm,
+     const DvceArray5D<Real> &fmet,
      DvceArray5D<Real> flx, DvceArray4D<Real> ey, DvceArray4D<Real> ez) {
   par_for_inner(member, il, iu, [&](const int i) {
     constexpr int ibx = ivx - IVX;
     constexpr int iby = ((ivx - IVX) + 1)%3;
     constexpr int ibz = ((ivx - IVX) + 2)%3;
 
-    constexpr int diag[3] = {S11, S22, S33};
-    constexpr int offdiag[3] = {S23, S13, S12};
-    constexpr int offidx = offdiag[ivx - IVX];
-    constexpr int idxy = diag[(ivx - IVX + 1) % 3];
-    constexpr int idxz = diag[(ivx - IVX + 2) % 3];
-
     constexpr int pvx = PVX + (ivx - IVX);
 
+    // Metric quantities at the face, precomputed by DynGRMHD::UpdateFaceMetric()
     Real g3d[NSPMETRIC];
     Real beta_u[3];
-    Real alpha;
-    if constexpr (ivx == IVX) {
-      adm::Face1Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
-    } else if (ivx == IVY) {
-      adm::Face2Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
-    } else if (ivx == IVZ) {
-      adm::Face3Metric(m, k, j, i, adm.g_dd, adm.beta_u, adm.alpha, g3d, beta_u, alpha);
-    }
-
-    Real sdetg = sqrt(Primitive::GetDeterminant(g3d));
+    Real alpha, sdetg, gii;
+    LoadFaceMetric(fmet, m, k, j, i, g3d, beta_u, alpha, sdetg, gii);
     Real isdetg = 1.0/sdetg;
 
     // Extract left and right primitives
@@ -186,7 +165,6 @@ void LLF_DYNGR(TeamMember_t const &member,
 
     // Calculate the magnetosonic speeds for both states
     Real lambda_pl, lambda_pr, lambda_ml, lambda_mr;
-    Real gii = (g3d[idxy]*g3d[idxz] - g3d[offidx]*g3d[offidx])*(isdetg*isdetg);
     eos.GetGRFastMagnetosonicSpeeds(lambda_pl, lambda_ml, prim_l, bsql,
                                     g3d, beta_u, alpha, gii, pvx);
     eos.GetGRFastMagnetosonicSpeeds(lambda_pr, lambda_mr, prim_r, bsqr,
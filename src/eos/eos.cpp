@@ -7,6 +7,8 @@
 //! \brief implements constructor and some fns for EquationOfState abstract base class
 
 #include <float.h>
+#include <cstdlib>
+#include <iostream>
 #include <string>
 
 #include "athena.hpp"
@@ -23,6 +25,24 @@ EquationOfState::EquationOfState(std::string bk, MeshBlockPack* pp, ParameterInp
   eos_data.pfloor = pin->GetOrAddReal(bk,"pfloor",(FLT_MIN));
   eos_data.tfloor = pin->GetOrAddReal(bk,"tfloor",(FLT_MIN));
   eos_data.sfloor = pin->GetOrAddReal(bk,"sfloor",(FLT_MIN));
+  eos_data.c2p_max_iter = pin->GetOrAddInteger(bk,"c2p_max_iter",25);
+  eos_data.c2p_fast_iter = pin->GetOrAddInteger(bk,"c2p_fast_iter",0);
+  std::string c2p_strategy = pin->GetOrAddString(bk,"c2p_strategy","bracket");
+  eos_data.c2p_warm = false;
+  eos_data.c2p_newton = false;
+  if (c2p_strategy.compare("warm") == 0) {
+    eos_data.c2p_warm = true;
+  } else if (c2p_strategy.compare("newton") == 0) {
+    eos_data.c2p_newton = true;
+  } else if (c2p_strategy.compare("bracket") != 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<" << bk << ">/c2p_strategy = '" << c2p_strategy
+              << "' not implemented" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  eos_data.c2p_warm_width = pin->GetOrAddReal(bk,"c2p_warm_width",1.0e-3);
+  eos_data.c2p_newton_iter = pin->GetOrAddInteger(bk,"c2p_newton_iter",5);
+  eos_data.masked_rs = pin->GetOrAddBoolean(bk,"masked_rsolver",false);
 }
 
 //----------------------------------------------------------------------------------------
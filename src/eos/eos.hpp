@@ -31,6 +31,13 @@ struct EOS_Data {
   bool use_e, use_t; // use internal energy density (e) or temperature (t) as primitive
   Real dfloor, pfloor, tfloor, sfloor;  // density, pressure, temperature, entropy floors
   Real gamma_max;    // ceiling on Lorentz factor in SR/GR
+  int c2p_max_iter;  // maximum number of iterations in relativistic MHD C2P
+  int c2p_fast_iter; // iterations in fast first pass of two-pass C2P (0 to disable)
+  bool c2p_warm;     // start relativistic MHD C2P from the previous primitives
+  Real c2p_warm_width;  // relative half-width of the initial bracket in warm start
+  bool c2p_newton;   // start SR hydro/MHD C2P with fixed number of Newton iterations
+  int c2p_newton_iter;  // number of Newton iterations before bracketed fallback
+  bool masked_rs;    // select wave regions in HLLC/HLLD solvers without branches
 
   // IDEAL GAS PRESSURE: converts primitive variable (either internal energy density e
   // or temperature e/d) into pressure.
@@ -202,6 +209,24 @@ class EquationOfState {
 
   MeshBlockPack* pmy_pack;
   EOS_Data eos_data;
+  // when true, ConsToPrim also returns the minimum dx/(|v|+Cs) over active cells in each
+  // direction in c2p_dt (nonrelativistic hydro only), so no separate reduction is needed
+  bool c2p_newdt = false;
+  Real c2p_dt[3];
+  // queue of cells (and its length) that did not converge in fast first pass of
+  // two-pass relativistic MHD C2P, and are retried with the full number of iterations
+  DvceArray1D<int> c2p_retry;
+  DvceArray1D<int> c2p_nretry;
+  // with <hydro>/floor_map=true, bitmask of floors applied in each cell (1=density,
+  // 2=energy, 4=temperature) since the last output of "hydro_floors" or regrid
+  // (nonrelativistic ideal gas hydro only)
+  bool floor_map_enabled = false;
+  DvceArray4D<int> floor_map;
+  int floor_map_nregrid = 0;
+  // when true, bcc passed to (MHD) ConsToPrim already holds the averages of the face
+  // fields in the cells converted (set by MHD::CT with <mhd>/ct_bcc), so faces are not
+  // read again
+  bool bcc_current = false;
 
   // virtual functions to convert cons to prim in either Hydro or MHD (depending on
   // arguments), overwritten in derived eos classes
@@ -100,15 +100,43 @@ Real EquationC22(Real z, Real &u_d, Real q, Real r, EOS_Data eos) {
   return (z - r/h); // (C22)
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Real EquationC22Deriv()
+//! \brief Same as EquationC22(), but also returns the derivative df/dz used in the
+//! Newton iterations of SingleC2P_IdealSRHyd().  eps is evaluated in the same
+//! cancellation-free form of (C16), and since z^2/(1+w) = w-1 its derivative is
+//! d(eps)/dz = (1+q)z/w - r, which is zero where the floor on eps applies.
+
+KOKKOS_INLINE_FUNCTION
+Real EquationC22Deriv(Real z, Real &u_d, Real q, Real r, EOS_Data eos, Real &df) {
+  Real const gm1 = eos.gamma - 1.0;
+  Real const w = sqrt(1.0 + z*z);         // (C15)
+  Real const wd = u_d/w;                  // (C15)
+  Real eps = w*q - z*r + (z*z)/(1.0 + w); // (C16)
+  Real epsmin = fmax(eos.pfloor/(wd*gm1), eos.sfloor*pow(wd, gm1)/gm1);
+  Real deps = (eps > epsmin)? ((1.0 + q)*z/w - r) : 0.0;
+  eps = fmax(eps, epsmin);                // (C18)
+  Real const h = 1.0 + eos.gamma*eps;     // (C1) & (C21)
+  df = 1.0 + r*eos.gamma*deps/(h*h);
+  return (z - r/h); // (C22)
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void SingleC2P_IdealSRHyd()
 //! \brief Converts single state of conserved variables into primitive variables for
 //! special relativistic hydrodynamics with an ideal gas EOS.
+//! If newton_iter > 0, exactly newton_iter Newton iterations on eq. C22 are taken first,
+//! starting from z_guess = |u^i| (e.g. of the previous stage) if z_guess >= 0, or else
+//! from z = r/h(zp), i.e. one fixed-point step of (C22) from the upper bracket zp (the
+//! zero-pressure limit).  Iterates are clamped to the bracket and the loop has no early
+//! exit, so threads do not diverge.  Only if the result has not converged is the root
+//! found with the false position method below.
 
 KOKKOS_INLINE_FUNCTION
 void SingleC2P_IdealSRHyd(HydCons1D &u, const EOS_Data &eos, const Real s2, HydPrim1D &w,
                           bool &dfloor_used, bool &efloor_used, bool &c2p_failure,
-                          int &iter_used) {
+                          int &iter_used, const int newton_iter = 0,
+                          const Real z_guess = -1.0) {
   // Parameters
   const int max_iterations = 25;
   const Real tol = 1.0e-12;
@@ -145,13 +173,32 @@ void SingleC2P_IdealSRHyd(HydCons1D &u, const EOS_Data &eos, const Real s2, HydP
   Real fm = EquationC22(zm, u.d, q, r, eos);
   Real fp = EquationC22(zp, u.d, q, r, eos);
 
+  // Newton iterations.  Convergence is tested with f at the start of the last step,
+  // which the step itself only reduces further, relative to z since round-off limits
+  // the accuracy of f for z >> 1.
+  bool newton = false;
+  Real z = 0.5*(zm + zp);
+  if (newton_iter > 0) {
+    z = (z_guess >= 0.0)? z_guess : (zp - fp);
+    z = fmin(fmax(z, zm), zp);
+    Real f = 1.0, df;
+    for (int n=0; n<newton_iter; ++n) {
+      f = EquationC22Deriv(z, u.d, q, r, eos, df);
+      z = fmin(fmax(z - f/df, zm), zp);
+    }
+    newton = (fabs(f) < tol*fmax(1.0, z));
+  }
+
   // For simplicity on the GPU, find roots using the false position method
   int iterations = max_iterations;
-  // If bracket within tolerances, don't bother doing any iterations
-  if ((fabs(zm-zp) < tol) || ((fabs(fm) + fabs(fp)) < 2.0*tol)) {
+  // If bracket within tolerances, or root found by Newton iterations, don't bother
+  // doing any iterations
+  if (newton) {
     iterations = -1;
+  } else if ((fabs(zm-zp) < tol) || ((fabs(fm) + fabs(fp)) < 2.0*tol)) {
+    iterations = -1;
+    z = 0.5*(zm + zp);
   }
-  Real z = 0.5*(zm + zp);
 
   for (iter_used=0; iter_used < iterations; ++iter_used) {
     z =  (zm*fp - zp*fm)/(fp-fm);  // linear interpolation to point f(z)=0
@@ -189,6 +236,7 @@ void SingleC2P_IdealSRHyd(HydCons1D &u, const EOS_Data &eos, const Real s2, HydP
     c2p_failure = true;
     return;
   }
+  if (newton_iter > 0) {iter_used += newton_iter;}
 
   // iterations ended, compute primitives from resulting value of z
   Real const lor = sqrt(1.0 + z*z);  // (C15)
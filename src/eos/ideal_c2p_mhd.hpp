@@ -117,18 +117,78 @@ Real Equation44(const Real mu, const Real b2, const Real rpar, const Real r, con
   return mu - 1./(h/w + rbar*mu);                  // (45)
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Real Equation44Deriv()
+//! \brief Same as Equation44(), but also returns the derivative df/dmu used in the
+//! Newton iterations of SingleC2P_IdealSRMHD(), and in valid whether mu lies below the
+//! upper bracket (mu^2 rbar < 1), where eq. 44 has a unique root.
+
+KOKKOS_INLINE_FUNCTION
+Real Equation44Deriv(const Real mu, const Real b2, const Real rpar, const Real r,
+                     const Real q, const Real u_d, EOS_Data eos, Real &df, bool &valid) {
+  Real const x = 1./(1.+mu*b2);                    // (26)
+  Real const dx = -b2*x*x;
+  Real rbar = (x*x*r*r + mu*x*(1.+x)*rpar*rpar);   // (38)
+  Real drbar = 2.*x*dx*r*r + rpar*rpar*(x*(1.+x) + mu*dx*(1.+2.*x));
+  Real qbar = q - 0.5*b2 - 0.5*(mu*mu*(b2*rbar- rpar*rpar)); // (31)
+  Real dqbar = -mu*(b2*rbar - rpar*rpar) - 0.5*mu*mu*b2*drbar;
+  Real a = mu*mu*rbar;
+  Real da = 2.*mu*rbar + mu*mu*drbar;
+  valid = (a < 1.);
+  Real z2 = (a/(fabs(1.- a)));                     // (32)
+  Real dz2 = da/SQR(1.- a);
+  Real w = sqrt(1.+z2);
+  Real dw = 0.5*dz2/w;
+  Real const wd = u_d/w;                           // (34)
+  Real eps = w*(qbar - mu*rbar) + z2/(w+1.);
+  Real const gm1 = eos.gamma - 1.0;
+  Real epsmin = fmax(eos.pfloor/(wd*gm1), eos.sfloor*pow(wd, gm1)/gm1);
+  // z2/(w+1) = w-1, so d(eps)/dmu follows directly; zero where the floor applies
+  Real deps = (eps > epsmin)? (dw*(qbar - mu*rbar + 1.) + w*(dqbar - rbar - mu*drbar))
+                            : 0.0;
+  eps = fmax(eps, epsmin);
+  Real const h = 1.0 + eos.gamma*eps;              // (43)
+  Real g = h/w + rbar*mu;
+  Real dg = eos.gamma*deps/w - h*dw/(w*w) + drbar*mu + rbar;
+  df = 1. + dg/(g*g);
+  return mu - 1./g;                                // (45)
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real C2PGuessMu_IdealSRMHD()
+//! \brief Estimate of mu = 1/(h W) in SingleC2P_IdealSRMHD() from a primitive state with
+//! Lorentz factor lor, e.g. the state from the previous stage.  Returns 0 (no guess) if
+//! the state is not physical.
+
+KOKKOS_INLINE_FUNCTION
+Real C2PGuessMu_IdealSRMHD(const HydPrim1D &w, const Real lor, const EOS_Data &eos) {
+  if (!(w.d > 0.0) || !(w.e > 0.0) || !(lor >= 1.0)) {return 0.0;}
+  Real h = 1.0 + eos.gamma*w.e/w.d;  // (43)
+  return 1.0/(h*lor);
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void SingleC2P_IdealSRMHD()
 //! \brief Converts single state of conserved variables into primitive variables for
 //! special relativistic MHD with an ideal gas EOS. Note input CONSERVED state contains
 //! cell-centered magnetic fields, but PRIMITIVE state returned via arguments does not.
+//! If mu_guess > 0 (see C2PGuessMu_IdealSRMHD()), the root is first searched for in a
+//! narrow bracket around it, falling back to the full bracket if that does not contain
+//! the root.
+//! If newton_iter > 0, exactly newton_iter Newton iterations on eq. 44 are taken before
+//! any of this, starting from mu_guess if mu_guess > 0, or else from 1/(1+q) (exact for
+//! a cold, static and unmagnetized state).  Iterates are clamped to (0,1] and the loop
+//! has no early exit, so threads do not diverge.  The bracketed solve is only used if
+//! the result has not converged, and is skipped entirely if max_iterations = 0, in
+//! which case c2p_failure is returned so that the caller can retry the cell later.
 
 KOKKOS_INLINE_FUNCTION
 void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, Real rpar,
                           HydPrim1D &w, bool &dfloor_used, bool &efloor_used,
-                          bool &c2p_failure, int &max_iter) {
+                          bool &c2p_failure, int &max_iter,
+                          const int max_iterations = 25, const Real mu_guess = 0.0,
+                          const int newton_iter = 0) {
   // Parameters
-  const int max_iterations = 25;
   const Real tol = 1.0e-12;
   const Real gm1 = eos.gamma - 1.0;
 
@@ -156,53 +216,101 @@ void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, R
   b2 /= u.d;
   rpar *= isqrtd;
 
-  // Need to find initial bracket. Requires separate solve
-  Real zm=0.;
-  Real zp=1.; // This is the lowest specific enthalpy admitted by the EOS
-
-  // Evaluate master function (eq 49) at bracket values
-  Real fm = Equation49(zm, b2, rpar, r, q);
-  Real fp = Equation49(zp, b2, rpar, r, q);
+  // Newton iterations.  The root is accepted only if it lies below the upper bracket,
+  // and convergence is tested with f at the start of the last step.
+  Real zm, zp, fm, fp;
+  bool newton = false;
+  if (newton_iter > 0) {
+    Real mu = (mu_guess > 0.0)? mu_guess : 1.0/(1.0 + q);
+    mu = fmin(fmax(mu, tol), 1.0);
+    Real f = 1.0, df;
+    bool valid = false;
+    for (int n=0; n<newton_iter; ++n) {
+      f = Equation44Deriv(mu, b2, rpar, r, q, u.d, eos, df, valid);
+      mu = fmin(fmax(mu - f/df, tol), 1.0);
+    }
+    newton = valid && (fabs(f) < tol);
+    if (newton) {
+      zm = mu;
+      zp = mu;
+      fm = f;
+      fp = f;
+    } else if (max_iterations == 0) {
+      w.d = eos.dfloor;
+      w.e = eos.pfloor/gm1;
+      w.vx = 0.0;
+      w.vy = 0.0;
+      w.vz = 0.0;
+      c2p_failure = true;
+      return;
+    }
+  }
 
-  // For simplicity on the GPU, find roots using the false position method
-  int iterations = max_iterations;
-  // If bracket within tolerances, don't bother doing any iterations
-  if ((fabs(zm-zp) < tol) || ((fabs(fm) + fabs(fp)) < 2.0*tol)) {
-    iterations = -1;
+  // Warm start: try a narrow bracket around the guess for mu.  It must lie below the
+  // upper bound found from eq 49 below (where eq 49 changes sign), in which eq 44 has
+  // a unique root.
+  bool warm = newton;
+  if (mu_guess > 0.0 && !(newton)) {
+    zm = mu_guess*(1.0 - eos.c2p_warm_width);
+    zp = mu_guess*(1.0 + eos.c2p_warm_width);
+    if (Equation49(zp, b2, rpar, r, q) <= 0.0) {
+      fm = Equation44(zm, b2, rpar, r, q, u.d, eos);
+      fp = Equation44(zp, b2, rpar, r, q, u.d, eos);
+      warm = (fm*fp <= 0.0);
+    }
   }
-  Real z = 0.5*(zm + zp);
 
+  int iterations;
+  Real z;
   int iter;
-  for (iter=0; iter<iterations; ++iter) {
-    z =  (zm*fp - zp*fm)/(fp-fm);  // linear interpolation to point f(z)=0
-    Real f = Equation49(z, b2, rpar, r, q);
-    // Quit if convergence reached
-    // NOTE(@ermost): both z and f are of order unity
-    if ((fabs(zm-zp) < tol) || (fabs(f) < tol)) {
-      break;
+  if (!(warm)) {
+    // Need to find initial bracket. Requires separate solve
+    zm=0.;
+    zp=1.; // This is the lowest specific enthalpy admitted by the EOS
+
+    // Evaluate master function (eq 49) at bracket values
+    fm = Equation49(zm, b2, rpar, r, q);
+    fp = Equation49(zp, b2, rpar, r, q);
+
+    // For simplicity on the GPU, find roots using the false position method
+    iterations = max_iterations;
+    // If bracket within tolerances, don't bother doing any iterations
+    if ((fabs(zm-zp) < tol) || ((fabs(fm) + fabs(fp)) < 2.0*tol)) {
+      iterations = -1;
     }
-    // assign zm-->zp if root bracketed by [z,zp]
-    if (f*fp < 0.0) {
-      zm = zp;
-      fm = fp;
-      zp = z;
-      fp = f;
-    } else {  // assign zp-->z if root bracketed by [zm,z]
-      fm = 0.5*fm; // 1/2 comes from "Illinois algorithm" to accelerate convergence
-      zp = z;
-      fp = f;
+    z = 0.5*(zm + zp);
+
+    for (iter=0; iter<iterations; ++iter) {
+      z =  (zm*fp - zp*fm)/(fp-fm);  // linear interpolation to point f(z)=0
+      Real f = Equation49(z, b2, rpar, r, q);
+      // Quit if convergence reached
+      // NOTE(@ermost): both z and f are of order unity
+      if ((fabs(zm-zp) < tol) || (fabs(f) < tol)) {
+        break;
+      }
+      // assign zm-->zp if root bracketed by [z,zp]
+      if (f*fp < 0.0) {
+        zm = zp;
+        fm = fp;
+        zp = z;
+        fp = f;
+      } else {  // assign zp-->z if root bracketed by [zm,z]
+        fm = 0.5*fm; // 1/2 comes from "Illinois algorithm" to accelerate convergence
+        zp = z;
+        fp = f;
+      }
     }
-  }
-  max_iter = (iter > max_iter) ? iter : max_iter;
+    max_iter = (iter > max_iter) ? iter : max_iter;
 
-  // Found brackets. Now find solution in bounded interval, again using the
-  // false position method
-  zm= 0.;
-  zp= z;
+    // Found brackets. Now find solution in bounded interval, again using the
+    // false position method
+    zm= 0.;
+    zp= z;
 
-  // Evaluate master function (eq 44) at bracket values
-  fm = Equation44(zm, b2, rpar, r, q, u.d, eos);
-  fp = Equation44(zp, b2, rpar, r, q, u.d, eos);
+    // Evaluate master function (eq 44) at bracket values
+    fm = Equation44(zm, b2, rpar, r, q, u.d, eos);
+    fp = Equation44(zp, b2, rpar, r, q, u.d, eos);
+  }
 
   iterations = max_iterations;
   if ((fabs(zm-zp) < tol) || ((fabs(fm) + fabs(fp)) < 2.0*tol)) {
@@ -236,7 +344,7 @@ void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, R
   // failure and return floored density, pressure, and primitive velocities. Future
   // development may trigger averaging of (successfully inverted) neighbors in the event
   // of a C2P failure.
-  if (max_iter==max_iterations) {
+  if (!(newton) && max_iter==max_iterations) {
     w.d = eos.dfloor;
     w.e = eos.pfloor/gm1;
     w.vx = 0.0;
@@ -245,6 +353,7 @@ void SingleC2P_IdealSRMHD(MHDCons1D &u, const EOS_Data &eos, Real s2, Real b2, R
     c2p_failure = true;
     return;
   }
+  if (newton_iter > 0) {max_iter += newton_iter;}
 
   // iterations ended, compute primitives from resulting value of z
   Real &mu = z;
@@ -51,13 +51,15 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   auto eos = eos_data;
   Real gm1 = eos_data.gamma - 1.0;
 
-  auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
-  auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  auto &coord = pmy_pack->pcoord->coord_data;
   auto &use_excise = pmy_pack->pcoord->coord_data.bh_excise;
   auto &excision_floor_ = pmy_pack->pcoord->excision_floor;
   auto &excision_flux_ = pmy_pack->pcoord->excision_flux;
   auto &dexcise_ = pmy_pack->pcoord->coord_data.dexcise;
   auto &pexcise_ = pmy_pack->pcoord->coord_data.pexcise;
+  // work recorded for measured cost model used in load balancing
+  bool track_work = pmy_pack->pmesh->cost_model.measured && !(only_testfloors);
+  auto &work_eachmb_ = pmy_pack->pmesh->cost_model.work_eachmb;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
@@ -96,7 +98,7 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    CellMetricAndInverse(coord, m, k, j, i, x1v, x2v, x3v, glower, gupper);
 
     HydPrim1D w;
     bool dfloor_used=false, efloor_used=false;
@@ -160,6 +162,9 @@ void IdealGRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
       if (vceiling_used) {sumv++;}
       if (c2p_failure) {sumf++;}
       max_it = (iter_used > max_it) ? iter_used : max_it;
+      if (track_work) {
+        Kokkos::atomic_add(&work_eachmb_(m), static_cast<float>(iter_used));
+      }
 
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
@@ -211,8 +216,7 @@ void IdealGRHydro::PrimToCons(const DvceArray5D<Real> &prim, DvceArray5D<Real> &
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &js = indcs.js, &ks = indcs.ks;
   auto &size = pmy_pack->pmb->mb_size;
-  auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
-  auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  auto &coord = pmy_pack->pcoord->coord_data;
   int &nhyd  = pmy_pack->phydro->nhydro;
   int &nscal = pmy_pack->phydro->nscalars;
   int &nmb = pmy_pack->nmb_thispack;
@@ -234,7 +238,7 @@ void IdealGRHydro::PrimToCons(const DvceArray5D<Real> &prim, DvceArray5D<Real> &
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    CellMetricAndInverse(coord, m, k, j, i, x1v, x2v, x3v, glower, gupper);
 
     // Load single state of primitive variables
     HydPrim1D w;
@@ -47,173 +47,239 @@ void IdealGRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &
   int &nscal = pmy_pack->pmhd->nscalars;
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->pmhd->fofc;
+  const bool use_bcc = only_testfloors || bcc_current;
   auto eos = eos_data;
   Real gm1 = eos_data.gamma - 1.0;
 
-  auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
-  auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  auto &coord = pmy_pack->pcoord->coord_data;
   auto &use_excise = pmy_pack->pcoord->coord_data.bh_excise;
   auto &excision_floor_ = pmy_pack->pcoord->excision_floor;
   auto &excision_flux_ = pmy_pack->pcoord->excision_flux;
   auto &dexcise_ = pmy_pack->pcoord->coord_data.dexcise;
   auto &pexcise_ = pmy_pack->pcoord->coord_data.pexcise;
+  // work recorded for measured cost model used in load balancing
+  bool track_work = pmy_pack->pmesh->cost_model.measured && !(only_testfloors);
+  auto &work_eachmb_ = pmy_pack->pmesh->cost_model.work_eachmb;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
   const int nkji = (ku - kl + 1)*nji;
   const int nmkji = nmb*nkji;
 
-  int nfloord_=0, nfloore_=0, nceilv_=0, nfail_=0, maxit_=0;
-  Kokkos::parallel_reduce("grmhd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumv, int &sumf, int &max_it) {
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/ni;
-    int i = (idx - m*nkji - k*nji - j*ni) + il;
-    j += jl;
-    k += kl;
-
-    // load single state conserved variables
-    MHDCons1D u;
-    u.d  = cons(m,IDN,k,j,i);
-    u.mx = cons(m,IM1,k,j,i);
-    u.my = cons(m,IM2,k,j,i);
-    u.mz = cons(m,IM3,k,j,i);
-    u.e  = cons(m,IEN,k,j,i);
-
-    // load cell-centered fields into conserved state
-    // use input CC fields if only testing floors with FOFC
-    if (only_testfloors) {
-      u.bx = bcc(m,IBX,k,j,i);
-      u.by = bcc(m,IBY,k,j,i);
-      u.bz = bcc(m,IBZ,k,j,i);
-    // else use simple linear average of face-centered fields
-    } else {
-      u.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
-      u.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
-      u.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
-    }
-
-    // Extract components of metric
-    Real &x1min = size.d_view(m).x1min;
-    Real &x1max = size.d_view(m).x1max;
-    Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
-
-    Real &x2min = size.d_view(m).x2min;
-    Real &x2max = size.d_view(m).x2max;
-    Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
-
-    Real &x3min = size.d_view(m).x3min;
-    Real &x3max = size.d_view(m).x3max;
-    Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+  // With <mhd>/c2p_fast_iter > 0, C2P is done in two passes.  The first pass over all
+  // cells uses only c2p_fast_iter iterations, and cells that fail to converge are
+  // compacted into a queue which the second pass solves with the full c2p_max_iter
+  // iterations.  This prevents the few cells that need many iterations (e.g. near the
+  // atmosphere) from stalling whole warps on GPUs.
+  const bool two_pass = (eos_data.c2p_fast_iter > 0) && !(only_testfloors);
+  if (two_pass) {
+    if (c2p_retry.extent_int(0) < nmkji) {Kokkos::realloc(c2p_retry, nmkji);}
+    if (c2p_nretry.extent_int(0) < 1) {Kokkos::realloc(c2p_nretry, 1);}
+    Kokkos::deep_copy(c2p_nretry, 0);
+  }
+  auto &retry_ = c2p_retry;
+  auto &nretry_ = c2p_nretry;
 
-    Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
-
-    HydPrim1D w;
-    bool dfloor_used=false, efloor_used=false;
-    bool vceiling_used=false, c2p_failure=false;
-    int iter_used=0;
-
-    // Only execute cons2prim if outside excised region
-    bool excised = false;
-    if (use_excise) {
-      if (excision_floor_(m,k,j,i)) {
-        w.d = dexcise_;
-        w.vx = 0.0;
-        w.vy = 0.0;
-        w.vz = 0.0;
-        w.e = pexcise_/gm1;
-        excised = true;
+  int nfloord_=0, nfloore_=0, nceilv_=0, nfail_=0, maxit_=0;
+  int nhist_[NC2PHIST] = {0};
+  int nwork = nmkji;
+  for (int pass=0; pass<(two_pass? 2 : 1); ++pass) {
+    const bool fast = two_pass && (pass == 0);
+    const bool retry = (pass == 1);
+    const int max_iter = (fast)? eos.c2p_fast_iter : eos.c2p_max_iter;
+    int nd=0, ne=0, nv=0, nf=0, mi=0, nq=0;
+    array_sum::C2PHist hst;
+    Kokkos::parallel_reduce("grmhd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nwork),
+    KOKKOS_LAMBDA(const int &n, int &sumd, int &sume, int &sumv, int &sumf, int &max_it,
+                  int &sumq, array_sum::C2PHist &hist) {
+      const int idx = (retry)? retry_(n) : n;
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/ni;
+      int i = (idx - m*nkji - k*nji - j*ni) + il;
+      j += jl;
+      k += kl;
+
+      // load single state conserved variables
+      MHDCons1D u;
+      u.d  = cons(m,IDN,k,j,i);
+      u.mx = cons(m,IM1,k,j,i);
+      u.my = cons(m,IM2,k,j,i);
+      u.mz = cons(m,IM3,k,j,i);
+      u.e  = cons(m,IEN,k,j,i);
+
+      // load cell-centered fields into conserved state
+      // use input CC fields if only testing floors with FOFC, or if set in CT
+      if (use_bcc) {
+        u.bx = bcc(m,IBX,k,j,i);
+        u.by = bcc(m,IBY,k,j,i);
+        u.bz = bcc(m,IBZ,k,j,i);
+      // else use simple linear average of face-centered fields
+      } else {
+        u.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
+        u.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
+        u.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
       }
-      if (only_testfloors) {
-        if (excision_flux_(m,k,j,i)) {
+
+      // Extract components of metric
+      Real &x1min = size.d_view(m).x1min;
+      Real &x1max = size.d_view(m).x1max;
+      Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+      Real &x2min = size.d_view(m).x2min;
+      Real &x2max = size.d_view(m).x2max;
+      Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+
+      Real &x3min = size.d_view(m).x3min;
+      Real &x3max = size.d_view(m).x3max;
+      Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+
+      Real glower[4][4], gupper[4][4];
+      CellMetricAndInverse(coord, m, k, j, i, x1v, x2v, x3v, glower, gupper);
+
+      HydPrim1D w;
+      bool dfloor_used=false, efloor_used=false;
+      bool vceiling_used=false, c2p_failure=false;
+      int iter_used=0;
+
+      // Only execute cons2prim if outside excised region
+      bool excised = false;
+      if (use_excise) {
+        if (excision_floor_(m,k,j,i)) {
+          w.d = dexcise_;
+          w.vx = 0.0;
+          w.vy = 0.0;
+          w.vz = 0.0;
+          w.e = pexcise_/gm1;
           excised = true;
         }
+        if (only_testfloors) {
+          if (excision_flux_(m,k,j,i)) {
+            excised = true;
+          }
+        }
       }
-    }
 
-    if (!(excised)) {
-      // calculate SR conserved quantities
-      MHDCons1D u_sr;
-      Real s2, b2, rpar;
-      TransformToSRMHD(u,glower,gupper,s2,b2,rpar,u_sr);
-
-      // call c2p function
-      // (inline function in ideal_c2p_mhd.hpp file)
-      SingleC2P_IdealSRMHD(u_sr, eos, s2, b2, rpar, w,
-                           dfloor_used, efloor_used, c2p_failure, iter_used);
-
-      // apply velocity ceiling if necessary
-      Real tmp = glower[1][1]*SQR(w.vx)
-               + glower[2][2]*SQR(w.vy)
-               + glower[3][3]*SQR(w.vz)
-               + 2.0*glower[1][2]*w.vx*w.vy + 2.0*glower[1][3]*w.vx*w.vz
-               + 2.0*glower[2][3]*w.vy*w.vz;
-      Real lor = sqrt(1.0+tmp);
-      if (lor > eos.gamma_max) {
-        vceiling_used = true;
-        Real factor = sqrt((SQR(eos.gamma_max)-1.0)/(SQR(lor)-1.0));
-        w.vx *= factor;
-        w.vy *= factor;
-        w.vz *= factor;
-      }
-    }
+      if (!(excised)) {
+        // calculate SR conserved quantities
+        MHDCons1D u_sr;
+        Real s2, b2, rpar;
+        TransformToSRMHD(u,glower,gupper,s2,b2,rpar,u_sr);
+
+        // with c2p_strategy = warm, start from the primitives of the previous stage
+        Real mu_guess = 0.0;
+        if (eos.c2p_warm) {
+          HydPrim1D w_old;
+          w_old.d  = prim(m,IDN,k,j,i);
+          w_old.vx = prim(m,IVX,k,j,i);
+          w_old.vy = prim(m,IVY,k,j,i);
+          w_old.vz = prim(m,IVZ,k,j,i);
+          w_old.e  = prim(m,IEN,k,j,i);
+          Real usq = glower[1][1]*SQR(w_old.vx) + glower[2][2]*SQR(w_old.vy)
+                   + glower[3][3]*SQR(w_old.vz)
+                   + 2.0*glower[1][2]*w_old.vx*w_old.vy
+                   + 2.0*glower[1][3]*w_old.vx*w_old.vz
+                   + 2.0*glower[2][3]*w_old.vy*w_old.vz;
+          mu_guess = C2PGuessMu_IdealSRMHD(w_old, sqrt(1.0 + usq), eos);
+        }
 
-    // set FOFC flag and quit loop if this function called only to check floors
-    if (only_testfloors) {
-      if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
-        fofc_(m,k,j,i) = true;
-        sumd++;  // use dfloor as counter for when either is true
+        // call c2p function
+        // (inline function in ideal_c2p_mhd.hpp file)
+        SingleC2P_IdealSRMHD(u_sr, eos, s2, b2, rpar, w, dfloor_used, efloor_used,
+                             c2p_failure, iter_used, max_iter, mu_guess);
+
+        // apply velocity ceiling if necessary
+        Real tmp = glower[1][1]*SQR(w.vx)
+                 + glower[2][2]*SQR(w.vy)
+                 + glower[3][3]*SQR(w.vz)
+                 + 2.0*glower[1][2]*w.vx*w.vy + 2.0*glower[1][3]*w.vx*w.vz
+                 + 2.0*glower[2][3]*w.vy*w.vz;
+        Real lor = sqrt(1.0+tmp);
+        if (lor > eos.gamma_max) {
+          vceiling_used = true;
+          Real factor = sqrt((SQR(eos.gamma_max)-1.0)/(SQR(lor)-1.0));
+          w.vx *= factor;
+          w.vy *= factor;
+          w.vz *= factor;
+        }
       }
-    } else {
-      if (dfloor_used) {sumd++;}
-      if (efloor_used) {sume++;}
-      if (vceiling_used) {sumv++;}
-      if (c2p_failure) {sumf++;}
-      max_it = (iter_used > max_it) ? iter_used : max_it;
-
-      // store primitive state in 3D array
-      prim(m,IDN,k,j,i) = w.d;
-      prim(m,IVX,k,j,i) = w.vx;
-      prim(m,IVY,k,j,i) = w.vy;
-      prim(m,IVZ,k,j,i) = w.vz;
-      prim(m,IEN,k,j,i) = w.e;
-
-      // store cell-centered fields in 3D array
-      bcc(m,IBX,k,j,i) = u.bx;
-      bcc(m,IBY,k,j,i) = u.by;
-      bcc(m,IBZ,k,j,i) = u.bz;
-
-      // reset conserved variables if floor, ceiling, failure, or excision encountered
-      if (dfloor_used || efloor_used || vceiling_used || c2p_failure || excised) {
-        MHDPrim1D w_in;
-        w_in.d  = w.d;
-        w_in.vx = w.vx;
-        w_in.vy = w.vy;
-        w_in.vz = w.vz;
-        w_in.e  = w.e;
-        w_in.bx = u.bx;
-        w_in.by = u.by;
-        w_in.bz = u.bz;
-
-        HydCons1D u_out;
-        SingleP2C_IdealGRMHD(glower, gupper, w_in, eos.gamma, u_out);
-        cons(m,IDN,k,j,i) = u_out.d;
-        cons(m,IM1,k,j,i) = u_out.mx;
-        cons(m,IM2,k,j,i) = u_out.my;
-        cons(m,IM3,k,j,i) = u_out.mz;
-        cons(m,IEN,k,j,i) = u_out.e;
-        u.d = u_out.d;  // (needed if there are scalars below)
+
+      // in fast first pass, add unconverged cells to retry queue and leave them unchanged
+      if (fast && c2p_failure) {
+        retry_(Kokkos::atomic_fetch_add(&nretry_(0), 1)) = idx;
+        sumq++;
+        return;
       }
 
-      // convert scalars (if any)
-      for (int n=nmhd; n<(nmhd+nscal); ++n) {
-        prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+      // set FOFC flag and quit loop if this function called only to check floors
+      if (only_testfloors) {
+        if (dfloor_used || efloor_used || vceiling_used || c2p_failure) {
+          fofc_(m,k,j,i) = true;
+          sumd++;  // use dfloor as counter for when either is true
+        }
+      } else {
+        if (dfloor_used) {sumd++;}
+        if (efloor_used) {sume++;}
+        if (vceiling_used) {sumv++;}
+        if (c2p_failure) {sumf++;}
+        max_it = (iter_used > max_it) ? iter_used : max_it;
+        if (!(excised)) {hist.the_array[C2PHistBin(iter_used)]++;}
+        if (track_work) {
+          Kokkos::atomic_add(&work_eachmb_(m), static_cast<float>(iter_used));
+        }
+
+        // store primitive state in 3D array
+        prim(m,IDN,k,j,i) = w.d;
+        prim(m,IVX,k,j,i) = w.vx;
+        prim(m,IVY,k,j,i) = w.vy;
+        prim(m,IVZ,k,j,i) = w.vz;
+        prim(m,IEN,k,j,i) = w.e;
+
+        // store cell-centered fields in 3D array
+        bcc(m,IBX,k,j,i) = u.bx;
+        bcc(m,IBY,k,j,i) = u.by;
+        bcc(m,IBZ,k,j,i) = u.bz;
+
+        // reset conserved variables if floor, ceiling, failure, or excision encountered
+        if (dfloor_used || efloor_used || vceiling_used || c2p_failure || excised) {
+          MHDPrim1D w_in;
+          w_in.d  = w.d;
+          w_in.vx = w.vx;
+          w_in.vy = w.vy;
+          w_in.vz = w.vz;
+          w_in.e  = w.e;
+          w_in.bx = u.bx;
+          w_in.by = u.by;
+          w_in.bz = u.bz;
+
+          HydCons1D u_out;
+          SingleP2C_IdealGRMHD(glower, gupper, w_in, eos.gamma, u_out);
+          cons(m,IDN,k,j,i) = u_out.d;
+          cons(m,IM1,k,j,i) = u_out.mx;
+          cons(m,IM2,k,j,i) = u_out.my;
+          cons(m,IM3,k,j,i) = u_out.mz;
+          cons(m,IEN,k,j,i) = u_out.e;
+          u.d = u_out.d;  // (needed if there are scalars below)
+        }
+
+        // convert scalars (if any)
+        for (int n=nmhd; n<(nmhd+nscal); ++n) {
+          prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
+        }
       }
-    }
-  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nceilv_),
-     Kokkos::Sum<int>(nfail_), Kokkos::Max<int>(maxit_));
+    }, Kokkos::Sum<int>(nd), Kokkos::Sum<int>(ne), Kokkos::Sum<int>(nv),
+       Kokkos::Sum<int>(nf), Kokkos::Max<int>(mi), Kokkos::Sum<int>(nq),
+       Kokkos::Sum<array_sum::C2PHist>(hst));
+    nfloord_ += nd;
+    nfloore_ += ne;
+    nceilv_  += nv;
+    nfail_   += nf;
+    maxit_ = (mi > maxit_)? mi : maxit_;
+    for (int h=0; h<NC2PHIST; ++h) {nhist_[h] += hst.the_array[h];}
+    // only cells in retry queue are processed in second pass
+    nwork = nq;
+    if (nwork == 0) {break;}
+  }
 
   // store appropriate counters
   if (only_testfloors) {
@@ -224,6 +290,9 @@ void IdealGRMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &
     pmy_pack->pmesh->ecounter.neos_vceil  += nceilv_;
     pmy_pack->pmesh->ecounter.neos_fail   += nfail_;
     pmy_pack->pmesh->ecounter.maxit_c2p = maxit_;
+    for (int h=0; h<NC2PHIST; ++h) {
+      pmy_pack->pmesh->ecounter.nc2p_hist[h] += nhist_[h];
+    }
   }
 
   return;
@@ -240,8 +309,7 @@ void IdealGRMHD::PrimToCons(const DvceArray5D<Real> &prim, const DvceArray5D<Rea
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &js = indcs.js, &ks = indcs.ks;
   auto &size = pmy_pack->pmb->mb_size;
-  auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
-  auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  auto &coord = pmy_pack->pcoord->coord_data;
   int &nmhd  = pmy_pack->pmhd->nmhd;
   int &nscal = pmy_pack->pmhd->nscalars;
   int &nmb = pmy_pack->nmb_thispack;
@@ -263,7 +331,7 @@ void IdealGRMHD::PrimToCons(const DvceArray5D<Real> &prim, const DvceArray5D<Rea
     Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    CellMetricAndInverse(coord, m, k, j, i, x1v, x2v, x3v, glower, gupper);
 
     // Load single state of primitive variables
     MHDPrim1D w;
@@ -6,7 +6,11 @@
 //! \file ideal_hyd.cpp
 //! \brief derived class that implements ideal gas EOS in nonrelativistic hydro
 
+#include <algorithm>
+#include <limits>
+
 #include "athena.hpp"
+#include "mesh/mesh.hpp"
 #include "hydro/hydro.hpp"
 #include "eos/eos.hpp"
 #include "eos/ideal_c2p_hyd.hpp"
@@ -21,6 +25,17 @@ IdealHydro::IdealHydro(MeshBlockPack *pp, ParameterInput *pin) :
   eos_data.iso_cs = 0.0;
   eos_data.use_e = true;  // ideal gas EOS always uses internal energy
   eos_data.use_t = false;
+
+  // optional map of cells in which floors were applied, output as "hydro_floors"
+  floor_map_enabled = pin->GetOrAddBoolean("hydro","floor_map",false);
+  if (floor_map_enabled) {
+    auto &indcs = pp->pmesh->mb_indcs;
+    int nmb = std::max((pp->nmb_thispack), (pp->pmesh->nmb_maxperrank));
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(floor_map, nmb, ncells3, ncells2, ncells1);
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -37,15 +52,33 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   int &nmb = pmy_pack->nmb_thispack;
   auto &eos = eos_data;
   auto &fofc_ = pmy_pack->phydro->fofc;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  bool newdt = c2p_newdt && !(only_testfloors);
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
   const int nkji = (ku - kl + 1)*nji;
   const int nmkji = nmb*nkji;
 
+  // map of floors is stale after MBs are refined/redistributed
+  bool use_map = floor_map_enabled && !(only_testfloors);
+  auto &fmap_ = floor_map;
+  if (use_map && (floor_map_nregrid != pmy_pack->pmesh->nregrid)) {
+    Kokkos::deep_copy(floor_map, 0);
+    floor_map_nregrid = pmy_pack->pmesh->nregrid;
+  }
+
   int nfloord_=0, nfloore_=0, nfloort_=0;
+  Real dt1 = std::numeric_limits<float>::max();
+  Real dt2 = std::numeric_limits<float>::max();
+  Real dt3 = std::numeric_limits<float>::max();
   Kokkos::parallel_reduce("hyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumt) {
+  KOKKOS_LAMBDA(const int &idx, int &sumd, int &sume, int &sumt,
+                Real &min_dt1, Real &min_dt2, Real &min_dt3) {
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
     int j = (idx - m*nkji - k*nji)/ni;
@@ -87,6 +120,10 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
         cons(m,IEN,k,j,i) = u.e;
         sumt++;
       }
+      if (use_map && (dfloor_used || efloor_used || tfloor_used)) {
+        fmap_(m,k,j,i) |= (dfloor_used? 1 : 0) | (efloor_used? 2 : 0) |
+                          (tfloor_used? 4 : 0);
+      }
       // store primitive state in 3D array
       prim(m,IDN,k,j,i) = w.d;
       prim(m,IVX,k,j,i) = w.vx;
@@ -101,8 +138,24 @@ void IdealHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
         }
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
+      // find smallest dx/(v +/- Cs) in each direction over active cells, using same
+      // expressions as in Hydro::NewTimeStep()
+      if (newdt && (i >= is) && (i <= ie) && (j >= js) && (j <= je) &&
+          (k >= ks) && (k <= ke)) {
+        Real p = eos.IdealGasPressure(w.e);
+        Real cs = eos.IdealHydroSoundSpeed(w.d, p);
+        min_dt1 = fmin((mbsize.d_view(m).dx1/(fabs(w.vx) + cs)), min_dt1);
+        min_dt2 = fmin((mbsize.d_view(m).dx2/(fabs(w.vy) + cs)), min_dt2);
+        min_dt3 = fmin((mbsize.d_view(m).dx3/(fabs(w.vz) + cs)), min_dt3);
+      }
     }
-  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nfloort_));
+  }, Kokkos::Sum<int>(nfloord_), Kokkos::Sum<int>(nfloore_), Kokkos::Sum<int>(nfloort_),
+     Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2), Kokkos::Min<Real>(dt3));
+  if (newdt) {
+    c2p_dt[0] = dt1;
+    c2p_dt[1] = dt2;
+    c2p_dt[2] = dt3;
+  }
 
   // store appropriate counters
   if (only_testfloors) {
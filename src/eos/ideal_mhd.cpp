@@ -38,6 +38,7 @@ void IdealMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
   int &nmb = pmy_pack->nmb_thispack;
   auto &eos = eos_data;
   auto &fofc_ = pmy_pack->pmhd->fofc;
+  const bool use_bcc = only_testfloors || bcc_current;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
@@ -63,8 +64,8 @@ void IdealMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &b,
     u.e  = cons(m,IEN,k,j,i);
 
     // load cell-centered fields into conserved state
-    // use input CC fields if only testing floors with FOFC
-    if (only_testfloors) {
+    // use input CC fields if only testing floors with FOFC, or if set in CT
+    if (use_bcc) {
       u.bx = bcc(m,IBX,k,j,i);
       u.by = bcc(m,IBY,k,j,i);
       u.bz = bcc(m,IBZ,k,j,i);
@@ -33,7 +33,9 @@ IdealSRHydro::IdealSRHydro(MeshBlockPack *pp, ParameterInput *pin) :
 //! \brief Converts conserved into primitive variables for an ideal gas in SR hydro.
 //! Implementation follows Wolfgang Kastaun's algorithm described in Appendix C of
 //! Galeazzi et al., PhysRevD, 88, 064009 (2013).  Roots of "master function" (eq. C22)
-//! found by false position method.
+//! found by false position method.  With <hydro>/c2p_strategy = newton, a fixed number
+//! (c2p_newton_iter) of Newton iterations starting from the 4-velocity of the previous
+//! stage are taken first, and only cells that have not converged fall back to it.
 //!
 //! In SR hydrodynamics, the conserved variables are: (D, E - D, m^i), where
 //!    D = \gamma \rho is the density in the lab frame,
@@ -61,6 +63,7 @@ void IdealSRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->phydro->fofc;
   auto eos = eos_data;
+  const int newton_iter = (eos_data.c2p_newton)? eos_data.c2p_newton_iter : 0;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
@@ -94,8 +97,14 @@ void IdealSRHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &prim,
     bool dfloor_used=false, efloor_used=false;
     bool vceiling_used=false, c2p_failure=false;
     int iter_used=0;
-    SingleC2P_IdealSRHyd(u, eos, s2, w,
-                         dfloor_used, efloor_used, c2p_failure, iter_used);
+    // with c2p_strategy = newton, start from |u^i| of the previous stage
+    Real z_guess = -1.0;
+    if (newton_iter > 0) {
+      z_guess = sqrt(SQR(prim(m,IVX,k,j,i)) + SQR(prim(m,IVY,k,j,i)) +
+                     SQR(prim(m,IVZ,k,j,i)));
+    }
+    SingleC2P_IdealSRHyd(u, eos, s2, w, dfloor_used, efloor_used, c2p_failure,
+                         iter_used, newton_iter, z_guess);
     // apply velocity ceiling if necessary
     Real lor = sqrt(1.0+SQR(w.vx)+SQR(w.vy)+SQR(w.vz));
     if (lor > eos.gamma_max) {
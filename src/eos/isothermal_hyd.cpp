@@ -6,6 +6,8 @@
 //! \file isothermal_hyd.cpp
 //! \brief derived class that implements isothermal EOS for nonrelativistic hydro
 
+#include <limits>
+
 #include "athena.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
@@ -74,6 +76,13 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->phydro->fofc;
   Real dfloor = eos_data.dfloor;
+  Real cs = eos_data.iso_cs;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  bool newdt = c2p_newdt && !(only_testfloors);
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
@@ -81,8 +90,11 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
   const int nmkji = nmb*nkji;
 
   int nfloord_=0;
+  Real dt1 = std::numeric_limits<float>::max();
+  Real dt2 = std::numeric_limits<float>::max();
+  Real dt3 = std::numeric_limits<float>::max();
   Kokkos::parallel_reduce("isohyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-  KOKKOS_LAMBDA(const int &idx, int &sumd) {
+  KOKKOS_LAMBDA(const int &idx, int &sumd, Real &min_dt1, Real &min_dt2, Real &min_dt3) {
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
     int j = (idx - m*nkji - k*nji)/ni;
@@ -120,8 +132,22 @@ void IsothermalHydro::ConsToPrim(DvceArray5D<Real> &cons, DvceArray5D<Real> &pri
       for (int n=nhyd; n<(nhyd+nscal); ++n) {
         prim(m,n,k,j,i) = cons(m,n,k,j,i)/u.d;
       }
+      // find smallest dx/(v +/- Cs) in each direction over active cells, using same
+      // expressions as in Hydro::NewTimeStep()
+      if (newdt && (i >= is) && (i <= ie) && (j >= js) && (j <= je) &&
+          (k >= ks) && (k <= ke)) {
+        min_dt1 = fmin((mbsize.d_view(m).dx1/(fabs(w.vx) + cs)), min_dt1);
+        min_dt2 = fmin((mbsize.d_view(m).dx2/(fabs(w.vy) + cs)), min_dt2);
+        min_dt3 = fmin((mbsize.d_view(m).dx3/(fabs(w.vz) + cs)), min_dt3);
+      }
     }
-  }, Kokkos::Sum<int>(nfloord_));
+  }, Kokkos::Sum<int>(nfloord_), Kokkos::Min<Real>(dt1), Kokkos::Min<Real>(dt2),
+     Kokkos::Min<Real>(dt3));
+  if (newdt) {
+    c2p_dt[0] = dt1;
+    c2p_dt[1] = dt2;
+    c2p_dt[2] = dt3;
+  }
 
   // store appropriate counters
   if (only_testfloors) {
@@ -77,6 +77,7 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
   int &nmb = pmy_pack->nmb_thispack;
   auto &fofc_ = pmy_pack->pmhd->fofc;
   Real dfloor = eos_data.dfloor;
+  const bool use_bcc = bcc_current;
 
   const int ni   = (iu - il + 1);
   const int nji  = (ju - jl + 1)*ni;
@@ -101,10 +102,16 @@ void IsothermalMHD::ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real
     u.mz = cons(m,IM3,k,j,i);
 
     // load cell-centered fields into conserved state
-    // (simple linear average of face-centered fields)
-    u.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
-    u.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
-    u.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
+    // use input CC fields if set in CT, else simple linear average of face fields
+    if (use_bcc) {
+      u.bx = bcc(m,IBX,k,j,i);
+      u.by = bcc(m,IBY,k,j,i);
+      u.bz = bcc(m,IBZ,k,j,i);
+    } else {
+      u.bx = 0.5*(b.x1f(m,k,j,i) + b.x1f(m,k,j,i+1));
+      u.by = 0.5*(b.x2f(m,k,j,i) + b.x2f(m,k,j+1,i));
+      u.bz = 0.5*(b.x3f(m,k,j,i) + b.x3f(m,k+1,j,i));
+    }
 
     // call c2p function
     HydPrim1D w;
@@ -14,14 +14,18 @@
 #include <iostream>
 #include <cstddef>
 #include <string>
+#include <vector>
 
 #include "eos_compose.hpp"
 #include "utils/tr_table.hpp"
 
 using namespace Primitive; // NOLINT
 
-void EOSCompOSE::ReadTableFromFile(std::string fname) {
+void EOSCompOSE::ReadTableFromFile(std::string fname, bool interleaved,
+                                   TableStorage storage) {
   if (m_initialized==false) {
+    m_interleaved = interleaved;
+    m_storage = storage;
     TableReader::Table table;
     auto read_result = table.ReadTable(fname);
     if (read_result.error != TableReader::ReadResult::SUCCESS) {
@@ -46,13 +50,28 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
     Kokkos::realloc(m_log_nb, m_nn);
     Kokkos::realloc(m_yq,     m_ny);
     Kokkos::realloc(m_log_t,  m_nt);
-    Kokkos::realloc(m_table, ECNVARS, m_nn, m_ny, m_nt);
+    // The table is only allocated on the device in the precision it is stored in
+    int nt0 = m_interleaved ? m_nn : ECNVARS;
+    int nt1 = m_interleaved ? m_ny : m_nn;
+    int nt2 = m_interleaved ? m_nt : m_ny;
+    int nt3 = m_interleaved ? ECNVARS : m_nt;
+    if (m_storage == ECSTORE_FLOAT) {
+      Kokkos::realloc(m_table_f, nt0, nt1, nt2, nt3);
+    } else if (m_storage == ECSTORE_LOG16) {
+      Kokkos::realloc(m_table_h, nt0, nt1, nt2, nt3);
+    } else {
+      Kokkos::realloc(m_table, nt0, nt1, nt2, nt3);
+    }
 
     // Create host storage to read into
     HostArray1D<Real>::HostMirror host_log_nb = create_mirror_view(m_log_nb);
     HostArray1D<Real>::HostMirror host_yq =     create_mirror_view(m_yq);
     HostArray1D<Real>::HostMirror host_log_t =  create_mirror_view(m_log_t);
-    HostArray4D<Real>::HostMirror host_table =  create_mirror_view(m_table);
+    HostArray4D<Real> host_table("host EoS table", nt0, nt1, nt2, nt3);
+    // host table entry of variable iv at node (in,iy,it), for either layout
+    auto table_entry = [&](int iv, int in, int iy, int it) -> Real& {
+      return m_interleaved ? host_table(in,iy,it,iv) : host_table(iv,in,iy,it);
+    };
 
     { // read nb
       Real * table_nb = table["nb"];
@@ -90,7 +109,7 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
         for (size_t iy=0; iy<m_ny; ++iy) {
           for (size_t it=0; it<m_nt; ++it) {
             size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECLOGP,in,iy,it) = log(table_Q1[iflat]) + host_log_nb(in);
+            table_entry(ECLOGP,in,iy,it) = log(table_Q1[iflat]) + host_log_nb(in);
           }
         }
       }
@@ -102,7 +121,7 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
         for (size_t iy=0; iy<m_ny; ++iy) {
           for (size_t it=0; it<m_nt; ++it) {
             size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECENT,in,iy,it) = table_Q2[iflat];
+            table_entry(ECENT,in,iy,it) = table_Q2[iflat];
           }
         }
       }
@@ -114,7 +133,7 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
         for (size_t iy=0; iy<m_ny; ++iy) {
           for (size_t it=0; it<m_nt; ++it) {
             size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECMUB,in,iy,it) = (table_Q3[iflat]+1)*mb;
+            table_entry(ECMUB,in,iy,it) = (table_Q3[iflat]+1)*mb;
           }
         }
       }
@@ -126,7 +145,7 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
         for (size_t iy=0; iy<m_ny; ++iy) {
           for (size_t it=0; it<m_nt; ++it) {
             size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECMUB,in,iy,it) = table_Q4[iflat]*mb;
+            table_entry(ECMUB,in,iy,it) = table_Q4[iflat]*mb;
           }
         }
       }
@@ -138,7 +157,7 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
         for (size_t iy=0; iy<m_ny; ++iy) {
           for (size_t it=0; it<m_nt; ++it) {
             size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECMUL,in,iy,it) = table_Q5[iflat]*mb;
+            table_entry(ECMUL,in,iy,it) = table_Q5[iflat]*mb;
           }
         }
       }
@@ -150,7 +169,8 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
         for (size_t iy=0; iy<m_ny; ++iy) {
           for (size_t it=0; it<m_nt; ++it) {
             size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECLOGE,in,iy,it) = log(mb*(table_Q7[iflat] + 1)) + host_log_nb(in);
+            table_entry(ECLOGE,in,iy,it) = log(mb*(table_Q7[iflat] + 1)) +
+                                           host_log_nb(in);
           }
         }
       }
@@ -162,7 +182,7 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
         for (size_t iy=0; iy<m_ny; ++iy) {
           for (size_t it=0; it<m_nt; ++it) {
             size_t iflat = it + m_nt*(iy + m_ny*in);
-            host_table(ECCS,in,iy,it) = sqrt(table_cs2[iflat]);
+            table_entry(ECCS,in,iy,it) = sqrt(table_cs2[iflat]);
           }
         }
       }
@@ -172,7 +192,73 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
     Kokkos::deep_copy(m_log_nb, host_log_nb);
     Kokkos::deep_copy(m_yq,     host_yq);
     Kokkos::deep_copy(m_log_t,  host_log_t);
-    Kokkos::deep_copy(m_table,  host_table);
+    if (m_storage == ECSTORE_FLOAT) {
+      HostArray4D<float>::HostMirror host_table_f = create_mirror_view(m_table_f);
+      for (int i0 = 0; i0 < nt0; ++i0) {
+        for (int i1 = 0; i1 < nt1; ++i1) {
+          for (int i2 = 0; i2 < nt2; ++i2) {
+            for (int i3 = 0; i3 < nt3; ++i3) {
+              host_table_f(i0,i1,i2,i3) = static_cast<float>(host_table(i0,i1,i2,i3));
+            }
+          }
+        }
+      }
+      Kokkos::deep_copy(m_table_f, host_table_f);
+    } else if (m_storage == ECSTORE_LOG16) {
+      // Positive variables are encoded in log, with a floor relative to their maximum
+      const Real rel_floor = 1.0e-12;
+      Real vmax_lin[ECNVARS];
+      for (int iv = 0; iv < ECNVARS; ++iv) {
+        m_enc_log[iv] = (iv == ECENT || iv == ECCS);
+        vmax_lin[iv] = -std::numeric_limits<Real>::max();
+        for (int in = 0; in < m_nn; ++in) {
+          for (int iy = 0; iy < m_ny; ++iy) {
+            for (int it = 0; it < m_nt; ++it) {
+              vmax_lin[iv] = fmax(vmax_lin[iv], table_entry(iv,in,iy,it));
+            }
+          }
+        }
+      }
+      auto encoded = [&](int iv, Real v) {
+        return m_enc_log[iv] ? log(fmax(v, rel_floor*vmax_lin[iv])) : v;
+      };
+      for (int iv = 0; iv < ECNVARS; ++iv) {
+        Real ymin = std::numeric_limits<Real>::max();
+        Real ymax = -std::numeric_limits<Real>::max();
+        for (int in = 0; in < m_nn; ++in) {
+          for (int iy = 0; iy < m_ny; ++iy) {
+            for (int it = 0; it < m_nt; ++it) {
+              Real y = encoded(iv, table_entry(iv,in,iy,it));
+              ymin = fmin(ymin, y);
+              ymax = fmax(ymax, y);
+            }
+          }
+        }
+        m_enc_min[iv] = ymin;
+        m_enc_scale[iv] = (ymax - ymin)/UINT16_MAX;
+      }
+      HostArray4D<uint16_t>::HostMirror host_table_h = create_mirror_view(m_table_h);
+      for (int iv = 0; iv < ECNVARS; ++iv) {
+        for (int in = 0; in < m_nn; ++in) {
+          for (int iy = 0; iy < m_ny; ++iy) {
+            for (int it = 0; it < m_nt; ++it) {
+              Real code = 0.0;
+              if (m_enc_scale[iv] > 0) {
+                code = (encoded(iv, table_entry(iv,in,iy,it)) - m_enc_min[iv])/
+                       m_enc_scale[iv];
+              }
+              code = fmin(fmax(round(code), 0.0), static_cast<Real>(UINT16_MAX));
+              uint16_t &entry = m_interleaved ? host_table_h(in,iy,it,iv)
+                                              : host_table_h(iv,in,iy,it);
+              entry = static_cast<uint16_t>(code);
+            }
+          }
+        }
+      }
+      Kokkos::deep_copy(m_table_h, host_table_h);
+    } else {
+      Kokkos::deep_copy(m_table, host_table);
+    }
 
     m_initialized = true;
 
@@ -184,8 +270,8 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
         for (int iy = 0; iy < m_ny; ++iy) {
           // This would use GPU memory, and we are currently on the CPU, so Enthalpy is
           // hardcoded
-          Real e = exp(host_table(ECLOGE,in,iy,it));
-          Real p = exp(host_table(ECLOGP,in,iy,it));
+          Real e = exp(table_entry(ECLOGE,in,iy,it));
+          Real p = exp(table_entry(ECLOGP,in,iy,it));
           Real h = (e + p) / nb;
           m_min_h = fmin(m_min_h, h);
         }
@@ -193,3 +279,116 @@ void EOSCompOSE::ReadTableFromFile(std::string fname) {
     }
   } // if (m_initialized==false)
 }
+
+void EOSCompOSE::BuildInverseTables(int ninv) {
+  assert(m_initialized);
+  assert(ninv >= 2);
+  m_ninv = ninv;
+
+  Kokkos::realloc(m_inv_table, 2, m_nn, m_ny, m_ninv);
+  Kokkos::realloc(m_inv_lim,   2, m_nn, m_ny, 2);
+
+  auto host_log_t = Kokkos::create_mirror_view_and_copy(HostMemSpace(), m_log_t);
+  auto host_table = Kokkos::create_mirror_view_and_copy(HostMemSpace(), m_table);
+  auto host_table_f = Kokkos::create_mirror_view_and_copy(HostMemSpace(), m_table_f);
+  auto host_table_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), m_table_h);
+  // host value of variable iv at node (in,iy,it), for any layout and precision
+  auto table_value = [&](int iv, int in, int iy, int it) -> Real {
+    int i0 = m_interleaved ? in : iv;
+    int i1 = m_interleaved ? iy : in;
+    int i2 = m_interleaved ? it : iy;
+    int i3 = m_interleaved ? iv : it;
+    if (m_storage == ECSTORE_FLOAT) {
+      return host_table_f(i0,i1,i2,i3);
+    } else if (m_storage == ECSTORE_LOG16) {
+      return decode16(iv, host_table_h(i0,i1,i2,i3));
+    }
+    return host_table(i0,i1,i2,i3);
+  };
+  HostArray4D<Real>::HostMirror host_inv_table = create_mirror_view(m_inv_table);
+  HostArray4D<Real>::HostMirror host_inv_lim =   create_mirror_view(m_inv_lim);
+
+  const int ivs[2] = {ECLOGE, ECLOGP};
+  std::vector<Real> col(m_nt);
+  for (int ii = 0; ii < 2; ++ii) {
+    for (int in = 0; in < m_nn; ++in) {
+      for (int iy = 0; iy < m_ny; ++iy) {
+        Real vmin = std::numeric_limits<Real>::max();
+        Real vmax = -std::numeric_limits<Real>::max();
+        for (int it = 0; it < m_nt; ++it) {
+          col[it] = table_value(ivs[ii], in, iy, it);
+          vmin = fmin(vmin, col[it]);
+          vmax = fmax(vmax, col[it]);
+        }
+        Real dv = (vmax - vmin)/(m_ninv - 1);
+        host_inv_lim(ii,in,iy,0) = vmin;
+        host_inv_lim(ii,in,iy,1) = (dv > 0) ? 1.0/dv : 0.0;
+
+        // Invert the piecewise linear column, starting each search from the cell of the
+        // previous point since the column is monotonic almost everywhere.
+        int ic = 0;
+        for (int ix = 0; ix < m_ninv; ++ix) {
+          Real x = vmin + ix*dv;
+          auto has_root = [&](int it) {
+            return (col[it] - x)*(col[it+1] - x) <= 0;
+          };
+          if (!has_root(ic)) {
+            int it = ic + 1;
+            while (it < m_nt - 1 && !has_root(it)) ++it;
+            if (it == m_nt - 1) {
+              it = 0;
+              while (it < m_nt - 2 && !has_root(it)) ++it;
+            }
+            ic = it;
+          }
+          Real lt;
+          if (col[ic+1] == col[ic]) {
+            lt = host_log_t(ic);
+          } else {
+            lt = host_log_t(ic) + (x - col[ic])*(host_log_t(ic+1) - host_log_t(ic))/
+                                  (col[ic+1] - col[ic]);
+          }
+          host_inv_table(ii,in,iy,ix) = lt;
+        }
+      }
+    }
+  }
+
+  Kokkos::deep_copy(m_inv_table, host_inv_table);
+  Kokkos::deep_copy(m_inv_lim,   host_inv_lim);
+  m_use_inv = true;
+}
+
+void EOSCompOSE::CompareToRealTable(std::string fname, int nsample, Real *max_err,
+                                    Real *rms_err) const {
+  assert(m_initialized);
+  EOSCompOSE ref;
+  ref.ReadTableFromFile(fname, m_interleaved, ECSTORE_REAL);
+
+  EOSCompOSE eos = *this;
+  int nn = m_nn, ny = m_ny, nt = m_nt;
+  for (int iv = 0; iv < ECNVARS; ++iv) {
+    Real err_max = 0.0, err_sum = 0.0;
+    Kokkos::parallel_reduce("compose_accuracy", Kokkos::RangePolicy<>(DevExeSpace(),
+    0, nsample), KOKKOS_LAMBDA(const int k, Real &emax, Real &esum) {
+      // Pseudo-random point in the table, from a hash of the sample index
+      Real u[3];
+      for (int d = 0; d < 3; ++d) {
+        uint32_t h = static_cast<uint32_t>(3*k + d) + 0x9e3779b9U;
+        h ^= h >> 16; h *= 0x7feb352dU;
+        h ^= h >> 15; h *= 0x846ca68bU;
+        h ^= h >> 16;
+        u[d] = h/4294967296.0;
+      }
+      Real log_n = eos.m_log_nb(0) + u[0]*(nn - 1)/eos.m_id_log_nb;
+      Real yq    = eos.m_yq(0)     + u[1]*(ny - 1)/eos.m_id_yq;
+      Real log_t = eos.m_log_t(0)  + u[2]*(nt - 1)/eos.m_id_log_t;
+      Real err = fabs(eos.eval_at_lnty(iv, log_n, log_t, yq) -
+                      ref.eval_at_lnty(iv, log_n, log_t, yq));
+      emax = fmax(emax, err);
+      esum += err*err;
+    }, Kokkos::Max<Real>(err_max), Kokkos::Sum<Real>(err_sum));
+    max_err[iv] = err_max;
+    rms_err[iv] = sqrt(err_sum/nsample);
+  }
+}
@@ -14,7 +14,22 @@
 
 ///  \warning This code assumes the table to be uniformly spaced in
 ///           log nb, log t, and yq
-
+///
+///  The table is stored either with the variable index outermost, m_table(iv,in,iy,it),
+///  or interleaved, m_table(in,iy,it,iv), so that all variables at a node of the table
+///  are adjacent in memory and lookups of several variables load one record per corner.
+///
+///  Optionally, inverse tables log T(n, Yq, log e) and log T(n, Yq, log P) are built
+///  when the table is loaded.  For each (n, Yq) node they are uniform in log e (log P)
+///  between the values at the ends of the temperature axis, so that TemperatureFromE
+///  and TemperatureFromP become an interpolation followed by one Newton step in the
+///  forward table, instead of a search along the temperature axis.
+///
+///  To save memory the table can also be stored in single precision, or with 16 bits per
+///  entry, linear between the extrema of each variable (in log for the positive
+///  variables ECENT and ECCS).  Interpolation is always done in Real.
+
+#include <cstdint>
 #include <string>
 #include <limits>
 
@@ -38,16 +53,35 @@ class EOSCompOSE : public EOSPolicyInterface {
     ECNVARS = 7
   };
 
+  enum TableStorage {
+    ECSTORE_REAL  = 0,  //! Real
+    ECSTORE_FLOAT = 1,  //! float
+    ECSTORE_LOG16 = 2   //! 16 bit integers, linear or logarithmic in each variable
+  };
+
  protected:
   /// Constructor
   EOSCompOSE() :
       m_log_nb("log nb",1),
       m_log_t("log T",1),
       m_yq("yq",1),
-      m_table("EoS table",1,1,1,1) {
+      m_table("EoS table",1,1,1,1),
+      m_table_f("EoS table (float)",1,1,1,1),
+      m_table_h("EoS table (16 bit)",1,1,1,1),
+      m_inv_table("EoS inverse table",1,1,1,1),
+      m_inv_lim("EoS inverse table limits",1,1,1,1) {
     n_species = 1;
     eos_units = MakeNuclear();
     m_initialized = false;
+    m_interleaved = false;
+    m_use_inv = false;
+    m_storage = ECSTORE_REAL;
+    for (int iv = 0; iv < ECNVARS; ++iv) {
+      m_enc_min[iv] = 0.0;
+      m_enc_scale[iv] = 0.0;
+      m_enc_log[iv] = false;
+    }
+    m_ninv = 0;
 
     // These will be set properly when the table is read
     m_id_log_nb = std::numeric_limits<Real>::quiet_NaN();
@@ -111,9 +145,11 @@ class EOSCompOSE : public EOSPolicyInterface {
 
   /// Calculate the enthalpy per baryon using.
   KOKKOS_INLINE_FUNCTION Real Enthalpy(Real n, Real T, Real *Y) const {
-    Real const P = Pressure(n, T, Y);
-    Real const e = Energy(n, T, Y);
-    return (P + e)/n;
+    assert (m_initialized);
+    const int iv[2] = {ECLOGP, ECLOGE};
+    Real var[2];
+    eval_at_lnty_multi<2>(iv, var, log(n), log(T), Y[0]);
+    return (exp(var[0]) + exp(var[1]))/n;
   }
 
   /// Calculate the sound speed.
@@ -174,8 +210,19 @@ class EOSCompOSE : public EOSPolicyInterface {
   }
 
  public:
-  /// Reads the table file.
-  void ReadTableFromFile(std::string fname);
+  /// Reads the table file, storing variables interleaved at each node if requested,
+  /// with the given precision.
+  void ReadTableFromFile(std::string fname, bool interleaved = false,
+                         TableStorage storage = ECSTORE_REAL);
+
+  /// Compares lookups of each variable at nsample states in the table against the
+  /// table in fname read in Real. Fills max_err and rms_err (size ECNVARS) with the
+  /// absolute errors, which are relative errors for ECLOGP and ECLOGE.
+  void CompareToRealTable(std::string fname, int nsample, Real *max_err,
+                          Real *rms_err) const;
+
+  /// Builds the inverse tables for temperature with ninv points along log e and log P.
+  void BuildInverseTables(int ninv);
 
   /// Get the raw number density
   KOKKOS_INLINE_FUNCTION DvceArray1D<Real> const GetRawLogNumberDensity() const {
@@ -190,16 +237,35 @@ class EOSCompOSE : public EOSPolicyInterface {
   KOKKOS_INLINE_FUNCTION DvceArray1D<Real> const GetRawLogTemperature() const {
     return m_log_t;
   }
-  /// Get the raw table data
+  /// Get the raw table data (indexed as given by IsInterleaved()), only allocated for
+  /// ECSTORE_REAL
   KOKKOS_INLINE_FUNCTION DvceArray4D<Real> const GetRawTable() const {
     return m_table;
   }
 
+  /// Check if variables are interleaved at each node of the raw table
+  KOKKOS_INLINE_FUNCTION bool IsInterleaved() const {
+    return m_interleaved;
+  }
+
   // Indexing used to access the data
   KOKKOS_INLINE_FUNCTION ptrdiff_t index(int iv, int in, int iy, int it) const {
+    if (m_interleaved) {
+      return iv + ECNVARS*(it + m_nt*(iy + m_ny*in));
+    }
     return it + m_nt*(iy + m_ny*(in + m_nn*iv));
   }
 
+  /// Get the precision in which the table is stored
+  KOKKOS_INLINE_FUNCTION TableStorage GetTableStorage() const {
+    return m_storage;
+  }
+
+  /// Check if the inverse tables for temperature are used
+  KOKKOS_INLINE_FUNCTION bool UsesInverseTables() const {
+    return m_use_inv;
+  }
+
   /// Check if the EOS has been initialized properly.
   KOKKOS_INLINE_FUNCTION bool IsInitialized() const {
     return m_initialized;
@@ -231,6 +297,16 @@ class EOSCompOSE : public EOSPolicyInterface {
   /// Low level evaluation function, not intended for outside use
   KOKKOS_INLINE_FUNCTION Real eval_at_lnty(int iv, Real log_n, Real log_t, Real yq)
       const {
+    const int ivs[1] = {iv};
+    Real var[1];
+    eval_at_lnty_multi<1>(ivs, var, log_n, log_t, yq);
+    return var[0];
+  }
+  /// Low level evaluation of NV variables at the same point, not intended for outside
+  /// use.  All variables at a corner of the cell are loaded together.
+  template <int NV>
+  KOKKOS_INLINE_FUNCTION void eval_at_lnty_multi(const int *iv, Real *var, Real log_n,
+                                                 Real log_t, Real yq) const {
     int in, iy, it;
     Real wn0, wn1, wy0, wy1, wt0, wt1;
 
@@ -238,15 +314,46 @@ class EOSCompOSE : public EOSPolicyInterface {
     weight_idx_yq(&wy0, &wy1, &iy, yq);
     weight_idx_lt(&wt0, &wt1, &it, log_t);
 
-    return
-      wn0 * (wy0 * (wt0 * m_table(iv, in+0, iy+0, it+0)   +
-                    wt1 * m_table(iv, in+0, iy+0, it+1))  +
-             wy1 * (wt0 * m_table(iv, in+0, iy+1, it+0)   +
-                    wt1 * m_table(iv, in+0, iy+1, it+1))) +
-      wn1 * (wy0 * (wt0 * m_table(iv, in+1, iy+0, it+0)   +
-                    wt1 * m_table(iv, in+1, iy+0, it+1))  +
-             wy1 * (wt0 * m_table(iv, in+1, iy+1, it+0)   +
-                    wt1 * m_table(iv, in+1, iy+1, it+1)));
+    // values at the corners, ordered as (dn, dy, dt)
+    Real c[8][NV];
+    for (int dn = 0; dn < 2; ++dn) {
+      for (int dy = 0; dy < 2; ++dy) {
+        for (int dt = 0; dt < 2; ++dt) {
+          for (int v = 0; v < NV; ++v) {
+            c[4*dn + 2*dy + dt][v] = table_at(iv[v], in+dn, iy+dy, it+dt);
+          }
+        }
+      }
+    }
+    for (int v = 0; v < NV; ++v) {
+      var[v] =
+        wn0 * (wy0 * (wt0 * c[0][v]   +
+                      wt1 * c[1][v])  +
+               wy1 * (wt0 * c[2][v]   +
+                      wt1 * c[3][v])) +
+        wn1 * (wy0 * (wt0 * c[4][v]   +
+                      wt1 * c[5][v])  +
+               wy1 * (wt0 * c[6][v]   +
+                      wt1 * c[7][v]));
+    }
+    return;
+  }
+
+  /// Value of variable iv at a node of the table, for either layout
+  KOKKOS_INLINE_FUNCTION Real table_at(int iv, int in, int iy, int it) const {
+    if (m_storage == ECSTORE_FLOAT) {
+      return m_interleaved ? m_table_f(in, iy, it, iv) : m_table_f(iv, in, iy, it);
+    } else if (m_storage == ECSTORE_LOG16) {
+      return decode16(iv, m_interleaved ? m_table_h(in, iy, it, iv)
+                                        : m_table_h(iv, in, iy, it));
+    }
+    return m_interleaved ? m_table(in, iy, it, iv) : m_table(iv, in, iy, it);
+  }
+
+  /// Value of variable iv from its 16 bit code
+  KOKKOS_INLINE_FUNCTION Real decode16(int iv, uint16_t code) const {
+    Real y = m_enc_min[iv] + code*m_enc_scale[iv];
+    return m_enc_log[iv] ? exp(y) : y;
   }
 
   /// Evaluate interpolation weight for density
@@ -274,7 +381,6 @@ class EOSCompOSE : public EOSPolicyInterface {
     return;
   }
 
-  // TODO(PH)
   /// Low level function, not intended for outside use
   KOKKOS_INLINE_FUNCTION Real temperature_from_var(int iv, Real var, Real n, Real Yq)
       const {
@@ -285,14 +391,46 @@ class EOSCompOSE : public EOSPolicyInterface {
 
     auto f = [=](int it){
       Real var_pt =
-        wn0 * (wy0 * m_table(iv, in+0, iy+0, it)  +
-               wy1 * m_table(iv, in+0, iy+1, it)) +
-        wn1 * (wy0 * m_table(iv, in+1, iy+0, it)  +
-               wy1 * m_table(iv, in+1, iy+1, it));
+        wn0 * (wy0 * table_at(iv, in+0, iy+0, it)  +
+               wy1 * table_at(iv, in+0, iy+1, it)) +
+        wn1 * (wy0 * table_at(iv, in+1, iy+0, it)  +
+               wy1 * table_at(iv, in+1, iy+1, it));
 
       return var - var_pt;
     };
 
+    if (m_use_inv) {
+      // Guess from the inverse table, interpolated between the four (n, Yq) nodes
+      int ii = (iv == ECLOGE) ? 0 : 1;
+      Real lt_c[2][2];
+      for (int dn = 0; dn < 2; ++dn) {
+        for (int dy = 0; dy < 2; ++dy) {
+          Real x = (var - m_inv_lim(ii, in+dn, iy+dy, 0))*m_inv_lim(ii, in+dn, iy+dy, 1);
+          x = fmin(fmax(x, 0.0), static_cast<Real>(m_ninv - 1));
+          int ix = (x < m_ninv - 1) ? static_cast<int>(x) : m_ninv - 2;
+          Real wx = x - ix;
+          lt_c[dn][dy] = (1.0 - wx)*m_inv_table(ii, in+dn, iy+dy, ix) +
+                         wx*m_inv_table(ii, in+dn, iy+dy, ix+1);
+        }
+      }
+      Real lt0 = wn0 * (wy0 * lt_c[0][0] + wy1 * lt_c[0][1]) +
+                 wn1 * (wy0 * lt_c[1][0] + wy1 * lt_c[1][1]);
+
+      // One Newton step in the temperature cell of the guess. The forward table is
+      // linear in log T within a cell, so this is exact if the root lies in the cell.
+      int it = (lt0 - m_log_t(0))*m_id_log_t;
+      it = (it < 0) ? 0 : ((it > m_nt - 2) ? m_nt - 2 : it);
+      Real flo = f(it);
+      Real fhi = f(it+1);
+      if (flo*fhi <= 0) {
+        if (flo == fhi) {
+          return exp(m_log_t(it));
+        }
+        return exp(m_log_t(it) - flo*(m_log_t(it+1) - m_log_t(it))/(fhi - flo));
+      }
+      // Otherwise fall back to the search along the whole temperature axis
+    }
+
     int ilo = 0;
     int ihi = m_nt-1;
     Real flo = f(ilo);
@@ -360,12 +498,29 @@ class EOSCompOSE : public EOSPolicyInterface {
   // bool to protect against access of uninitialised table and prevent repeated reading
   // of table
   bool m_initialized;
+  // true if variables are interleaved at each node, m_table(in,iy,it,iv)
+  bool m_interleaved;
+  // true if the inverse tables are used to find the temperature
+  bool m_use_inv;
+  // Number of points along log e (log P) in the inverse tables
+  int m_ninv;
+  // Precision of the table storage
+  TableStorage m_storage;
+  // Decoding of 16 bit storage: value (or its log) = m_enc_min + code*m_enc_scale
+  Real m_enc_min[ECNVARS], m_enc_scale[ECNVARS];
+  bool m_enc_log[ECNVARS];
 
   // Table storage on DEVICE.
   DvceArray1D<Real> m_log_nb;
   DvceArray1D<Real> m_yq;
   DvceArray1D<Real> m_log_t;
   DvceArray4D<Real> m_table;
+  DvceArray4D<float> m_table_f;
+  DvceArray4D<uint16_t> m_table_h;
+  // log T at uniform log e (0) and log P (1), m_inv_table(ii,in,iy,ix)
+  DvceArray4D<Real> m_inv_table;
+  // lower end and inverse spacing of the inverse tables, m_inv_lim(ii,in,iy,0/1)
+  DvceArray4D<Real> m_inv_lim;
 };
 
 }; // namespace Primitive
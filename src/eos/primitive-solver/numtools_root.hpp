@@ -42,13 +42,75 @@ class Root {
   KOKKOS_INLINE_FUNCTION
   bool FalsePosition(Functor&& f, Real &lb, Real &ub, Real& x, Real tol,
                      Types ... args) const {
+    // Get our initial bracket.
+    Real flb = f(lb, args...);
+    Real fub = f(ub, args...);
+    unsigned int nevals = 2;
+    return FalsePositionFrom(f, lb, ub, flb, fub, x, tol, nevals, args...);
+  }
+
+  //! \brief Find the root of a functor f using false position, starting from a guess.
+  //
+  // As FalsePosition, but the narrow bracket [x0(1 - w), x0(1 + w)] around the guess
+  // x0, clipped to [lb, ub], is tried first. If it does not contain the root, the
+  // search continues in the part of [lb, ub] on the side of the root. If x0 is not in
+  // (lb, ub), the search starts from [lb, ub].
+  //
+  // \param[in]  x0      The guess for the root.
+  // \param[in]  w       The relative half-width of the bracket around the guess.
+  // \param[out] nevals  The number of evaluations of f.
+  template<class Functor, class ... Types>
+  KOKKOS_INLINE_FUNCTION
+  bool FalsePositionGuess(Functor&& f, Real &lb, Real &ub, Real& x, Real x0, Real w,
+                          Real tol, unsigned int &nevals, Types ... args) const {
+    Real flb, fub;
+    if (x0 > lb && x0 < ub) {
+      Real a = fmax(lb, x0*(1.0 - w));
+      Real b = fmin(ub, x0*(1.0 + w));
+      Real fa = f(a, args...);
+      Real fb = f(b, args...);
+      nevals = 2;
+      if (fa*fb <= 0) {
+        lb = a;
+        ub = b;
+        flb = fa;
+        fub = fb;
+      } else {
+        // The guess was off, so the root is in [lb, a] or [b, ub].
+        flb = f(lb, args...);
+        nevals++;
+        if (flb*fa <= 0) {
+          ub = a;
+          fub = fa;
+        } else {
+          fub = f(ub, args...);
+          nevals++;
+          lb = b;
+          flb = fb;
+        }
+      }
+    } else {
+      flb = f(lb, args...);
+      fub = f(ub, args...);
+      nevals = 2;
+    }
+    return FalsePositionFrom(f, lb, ub, flb, fub, x, tol, nevals, args...);
+  }
+
+  //! \brief The iterations of false position, given f at the bounds of the bracket.
+  //
+  // \param[in]     flb     f at the lower bound.
+  // \param[in]     fub     f at the upper bound.
+  // \param[in,out] nevals  The number of evaluations of f, incremented for each
+  //                        iteration.
+  template<class Functor, class ... Types>
+  KOKKOS_INLINE_FUNCTION
+  bool FalsePositionFrom(Functor&& f, Real &lb, Real &ub, Real flb, Real fub, Real& x,
+                         Real tol, unsigned int &nevals, Types ... args) const {
     int side = 0;
     Real ftest;
     unsigned int count = 0;
     //last_count = 0;
-    // Get our initial bracket.
-    Real flb = f(lb, args...);
-    Real fub = f(ub, args...);
     Real xold;
     x = lb;
     // If one of the bounds is already within tolerance of the root, we have the root.
@@ -69,6 +131,7 @@ class Root {
       count++;
       // Calculate f at the prospective root.
       ftest = f(x,args...);
+      nevals++;
       if (fabs((x-xold)/x) <= tol) {
         return true;
       }
@@ -41,6 +41,10 @@ class PiecewisePolytrope : public EOSPolicyInterface {
   Real gamma_pieces[MAX_PIECES];
   Real pressure_pieces[MAX_PIECES];
   Real eps_pieces[MAX_PIECES];
+  /// Lower density and cold pressure bounds of pieces 1..MAX_PIECES-1, padded with
+  /// DBL_MAX beyond n_pieces so that the pieces can be found without branches.
+  Real density_bounds[MAX_PIECES-1];
+  Real pressure_bounds[MAX_PIECES-1];
   Real gamma_thermal;
   bool initialized;
 
@@ -98,7 +102,8 @@ class PiecewisePolytrope : public EOSPolicyInterface {
   /// Calculate the enthalpy per baryon using the ideal gas law.
   KOKKOS_INLINE_FUNCTION Real Enthalpy(Real n, Real T, Real *Y) const {
     int p = FindPiece(n);
-    return (GetColdEnergy(n, p) + GetColdPressure(n, p))/n +
+    Real P_cold = GetColdPressure(n, p);
+    return (ColdEnergyFromPressure(n, P_cold, p) + P_cold)/n +
            gamma_thermal/(gamma_thermal - 1.0)*T;
   }
 
@@ -112,10 +117,9 @@ class PiecewisePolytrope : public EOSPolicyInterface {
     int p = FindPiece(n);
     Real rho = n*mb;
 
-    Real h_cold = (GetColdEnergy(n, p) + GetColdPressure(n, p))/rho;
-    Real h_th = gamma_thermal/(gamma_thermal - 1.0)*T/mb;
-
     Real P_cold = GetColdPressure(n, p);
+    Real h_cold = (ColdEnergyFromPressure(n, P_cold, p) + P_cold)/rho;
+    Real h_th = gamma_thermal/(gamma_thermal - 1.0)*T/mb;
 
     Real csq_cold_w = gamma_pieces[p]*P_cold/rho;
     Real csq_th_w = (gamma_thermal - 1.0)*h_th;
@@ -211,6 +215,7 @@ class PiecewisePolytrope : public EOSPolicyInterface {
     density_pieces[0] = densities[1]/mb;
     gamma_pieces[0] = gammas[0];
     pressure_pieces[0] = P0;
+    eps_pieces[0] = 0.0;
 
     for (int i = 1; i < n; i++) {
       density_pieces[i] = densities[i]/mb;
@@ -225,6 +230,12 @@ class PiecewisePolytrope : public EOSPolicyInterface {
                       (1.0/(gammas[i-1] - 1.0) - 1.0/(gammas[i] - 1.0));
     }
 
+    // Bounds of the pieces used by FindPiece and GetDensityFromColdPressure
+    for (int i = 0; i < MAX_PIECES-1; i++) {
+      density_bounds[i] = (i < n-1) ? density_pieces[i+1] : DBL_MAX;
+      pressure_bounds[i] = (i < n-1) ? pressure_pieces[i+1] : DBL_MAX;
+    }
+
     // Because we're adding in a finite-temperature component via the ideal gas,
     // the only restriction on our temperature is that it needs to be nonnegative.
     min_T = 0.0;
@@ -260,20 +271,26 @@ class PiecewisePolytrope : public EOSPolicyInterface {
     return gamma_thermal;
   }
 
-  /// Find the index of the piece that the density aligns with.
+  /// Find the index of the piece that the density aligns with.  The bounds are strictly
+  /// increasing, so the index is the number of bounds not above n.  The fixed-length
+  /// loop is unrolled into a branch-free sum.
   KOKKOS_INLINE_FUNCTION int FindPiece(Real n) const {
     // WARNING: assumes the EOS is initialized!
-    for (int i = 0; i < n_pieces-1; ++i) {
-      if (n < density_pieces[i+1]) {
-        return i;
-      }
+    int p = 0;
+    for (int i = 0; i < MAX_PIECES-1; ++i) {
+      p += (n >= density_bounds[i]);
     }
-    return n_pieces - 1;
+    return p;
   }
 
   /// Polytropic Energy Density
   KOKKOS_INLINE_FUNCTION Real GetColdEnergy(Real n, int p) const {
-    return mb*n*(1.0 + eps_pieces[p]) + GetColdPressure(n, p)/(gamma_pieces[p] - 1.0);
+    return ColdEnergyFromPressure(n, GetColdPressure(n, p), p);
+  }
+
+  /// Polytropic Energy Density, given the cold pressure of piece p at this density
+  KOKKOS_INLINE_FUNCTION Real ColdEnergyFromPressure(Real n, Real P_cold, int p) const {
+    return mb*n*(1.0 + eps_pieces[p]) + P_cold/(gamma_pieces[p] - 1.0);
   }
 
   /// Polytropic Pressure
@@ -283,12 +300,9 @@ class PiecewisePolytrope : public EOSPolicyInterface {
 
   /// Inverse of GetColdPressure
   KOKKOS_INLINE_FUNCTION Real GetDensityFromColdPressure(Real p) const {
-    int ip = n_pieces - 1;
-    for (int i = 0; i < n_pieces-1; ++i) {
-      if (p < pressure_pieces[i+1]) {
-        ip = i;
-        break;
-      }
+    int ip = 0;
+    for (int i = 0; i < MAX_PIECES-1; ++i) {
+      ip += (p >= pressure_bounds[i]);
     }
     return density_pieces[ip]*pow((p/pressure_pieces[ip]), 1.0/gamma_pieces[ip]);
   }
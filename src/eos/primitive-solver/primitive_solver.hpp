@@ -201,12 +201,15 @@ class PrimitiveSolver {
 
  public:
   Real tol;
+  /// Relative half-width of the initial bracket around a guess for mu in ConToPrim
+  Real warm_width;
 
   /// Constructor
   //PrimitiveSolver(EOS<EOSPolicy, ErrorPolicy> *eos) : peos(eos) {
   PrimitiveSolver() {
     //root = NumTools::Root();
     tol = 1e-15;
+    warm_width = 1e-3;
     root.iterations = 30;
   }
 
@@ -215,16 +218,33 @@ class PrimitiveSolver {
 
   //! \brief Get the primitive variables from the conserved variables.
   //
-  //  \param[out]    prim  The array of primitive variables
-  //  \param[in,out] cons  The array of conserved variables
-  //  \param[in,out] bu    The magnetic field
-  //  \param[in]     g3d   The 3x3 spatial metric
-  //  \param[in]     g3u   The 3x3 inverse spatial metric
+  //  The template parameters select specialised versions of the solver: NSPECIES >= 0
+  //  fixes the number of particle species at compile time (-1 takes it from the EOS),
+  //  and MAGNETIZED = false assumes that the magnetic field is exactly zero.
+  //
+  //  \param[out]    prim     The array of primitive variables
+  //  \param[in,out] cons     The array of conserved variables
+  //  \param[in,out] bu       The magnetic field
+  //  \param[in]     g3d      The 3x3 spatial metric
+  //  \param[in]     g3u      The 3x3 inverse spatial metric
+  //  \param[in]     mu_guess A guess for the root mu (see GuessMu), or 0 for none
   //
   //  \return information about the solve
+  template<int NSPECIES = -1, bool MAGNETIZED = true>
   KOKKOS_INLINE_FUNCTION
   SolverResult ConToPrim(Real prim[NPRIM], Real cons[NCONS], Real b[NMAG],
-                         Real g3d[NSPMETRIC], Real g3u[NSPMETRIC]) const;
+                         Real g3d[NSPMETRIC], Real g3u[NSPMETRIC],
+                         Real mu_guess = 0.0) const;
+
+  //! \brief Estimate the root mu = 1/(hW) of ConToPrim from a set of primitive
+  //  variables, e.g. those of the previous step.
+  //
+  //  \param[in] prim  The array of primitive variables
+  //  \param[in] g3d   The 3x3 spatial metric
+  //
+  //  \return the estimate of mu, or 0 if prim is not physical
+  KOKKOS_INLINE_FUNCTION
+  Real GuessMu(const Real prim[NPRIM], Real g3d[NSPMETRIC]) const;
 
   //! \brief Get the conserved variables from the primitive variables.
   //
@@ -362,9 +382,11 @@ Error PrimitiveSolver<EOSPolicy, ErrorPolicy>::CheckDensityValid(Real& mul, Real
 
 // ConToPrim {{{
 template<typename EOSPolicy, typename ErrorPolicy>
+template<int NSPECIES, bool MAGNETIZED>
 KOKKOS_INLINE_FUNCTION
 SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM],
-      Real cons[NCONS], Real b[NMAG], Real g3d[NSPMETRIC], Real g3u[NSPMETRIC]) const {
+      Real cons[NCONS], Real b[NMAG], Real g3d[NSPMETRIC], Real g3u[NSPMETRIC],
+      Real mu_guess) const {
   SolverResult solver_result{Error::SUCCESS, 0, false, false, false};
 
   // Extract the undensitized conserved variables.
@@ -373,7 +395,7 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
   Real tau = cons[CTA];
   Real B_u[3] = {b[IBX], b[IBY], b[IBZ]};
   // Extract the particle fractions.
-  const int n_species = eos.GetNSpecies();
+  const int n_species = (NSPECIES >= 0) ? NSPECIES : eos.GetNSpecies();
   Real Y[MAX_SPECIES] = {0.0};
   for (int s = 0; s < n_species; s++) {
     Y[s] = cons[CYD + s]/cons[CDN];
@@ -383,7 +405,8 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
 
   // Check the conserved variables for consistency and do whatever
   // the EOSPolicy wants us to.
-  bool floored = eos.ApplyConservedFloor(D, S_d, tau, Y, SquareVector(B_u, g3d));
+  bool floored = eos.ApplyConservedFloor(D, S_d, tau, Y,
+                                         MAGNETIZED ? SquareVector(B_u, g3d) : 0.0);
   solver_result.cons_floor = floored;
   if (floored && eos.IsConservedFlooringFailure()) {
     HandleFailure(prim, cons, b, g3d);
@@ -392,15 +415,18 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
   }
 
   // Calculate some utility quantities.
-  Real sqrtD = sqrt(D);
-  Real b_u[3] = {B_u[0]/sqrtD, B_u[1]/sqrtD, B_u[2]/sqrtD};
+  Real b_u[3] = {0.0, 0.0, 0.0};
+  if constexpr (MAGNETIZED) {
+    Real sqrtD = sqrt(D);
+    b_u[0] = B_u[0]/sqrtD; b_u[1] = B_u[1]/sqrtD; b_u[2] = B_u[2]/sqrtD;
+  }
   Real r_d[3] = {S_d[0]/D, S_d[1]/D, S_d[2]/D};
   Real r_u[3];
   RaiseForm(r_u, r_d, g3u);
   Real rsqr   = Contract(r_u, r_d);
-  Real rb     = Contract(b_u, r_d);
+  Real rb     = MAGNETIZED ? Contract(b_u, r_d) : 0.0;
   Real rbsqr  = rb*rb;
-  Real bsqr   = SquareVector(b_u, g3d);
+  Real bsqr   = MAGNETIZED ? SquareVector(b_u, g3d) : 0.0;
   Real q      = tau/D;
 
   // Make sure there are no NaNs at this point.
@@ -420,7 +446,10 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
   }
 
   // Make sure that the magnetic field is physical.
-  Error error = eos.DoMagnetizationResponse(bsqr, b_u);
+  Error error = Error::SUCCESS;
+  if constexpr (MAGNETIZED) {
+    error = eos.DoMagnetizationResponse(bsqr, b_u);
+  }
   if (error == Error::MAG_TOO_BIG) {
     HandleFailure(prim, cons, b, g3d);
     solver_result.error = Error::MAG_TOO_BIG;
@@ -480,7 +509,11 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
   Real mul = 0.0;
   Real muh = 1.0/min_h;
   // Check if a tighter upper bound exists.
-  if (rsqr > min_h*min_h) {
+  if (!MAGNETIZED && rsqr > min_h*min_h) {
+    // Without a magnetic field, the upper bound is 1/sqrt(h_min^2 + r^2). It is
+    // perturbed upward as below.
+    muh = (1. + 1e-10)/sqrt(min_h*min_h + rsqr);
+  } else if (rsqr > min_h*min_h) {
     Real mu = 0.0;
     // We don't need the bound to be that tight, so we reduce
     // the accuracy of the root solve for speed reasons.
@@ -512,13 +545,14 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
   }
 
 
-  // Do the root solve.
+  // Do the root solve, starting from a narrow bracket around mu_guess if given.
   Real n, P, T, mu;
-  bool result = root.FalsePosition(RootFunction, mul, muh, mu, tol,
-                                   D, q, bsqr, rsqr, rbsqr, Y, &eos, &n, &T, &P);
-  // WARNING: the reported number of iterations is not thread-safe and should only be
-  // trusted on single-thread benchmarks.
-  solver_result.iterations = root.iterations;
+  unsigned int nevals = 0;
+  bool result = root.FalsePositionGuess(RootFunction, mul, muh, mu, mu_guess, warm_width,
+                                        tol, nevals,
+                                        D, q, bsqr, rsqr, rbsqr, Y, &eos, &n, &T, &P);
+  // The number of evaluations of the root function
+  solver_result.iterations = nevals;
   if (!result) {
     HandleFailure(prim, cons, b, g3d);
     solver_result.error = Error::NO_SOLUTION;
@@ -573,6 +607,31 @@ SolverResult PrimitiveSolver<EOSPolicy, ErrorPolicy>::ConToPrim(Real prim[NPRIM]
 }
 // }}}
 
+// GuessMu {{{
+template<typename EOSPolicy, typename ErrorPolicy>
+KOKKOS_INLINE_FUNCTION
+Real PrimitiveSolver<EOSPolicy, ErrorPolicy>::GuessMu(const Real prim[NPRIM],
+      Real g3d[NSPMETRIC]) const {
+  Real n = prim[PRH];
+  Real P = prim[PPR];
+  if (!(n > 0.0) || !(P > 0.0)) {
+    return 0.0;
+  }
+  // Keep the state inside the EOS before evaluating it.
+  Real Y[MAX_SPECIES] = {0.0};
+  for (int s = 0; s < eos.GetNSpecies(); s++) {
+    Y[s] = prim[PYF + s];
+  }
+  eos.ApplySpeciesLimits(Y);
+  eos.ApplyDensityLimits(n);
+  eos.ApplyPressureLimits(P, n, Y);
+  Real T = eos.GetTemperatureFromP(n, P, Y);
+  Real Wv_u[3] = {prim[PVX], prim[PVY], prim[PVZ]};
+  Real W = sqrt(1.0 + SquareVector(Wv_u, g3d));
+  return 1.0/(eos.GetEnthalpy(n, T, Y)*W);
+}
+// }}}
+
 // PrimToCon {{{
 template<typename EOSPolicy, typename ErrorPolicy>
 KOKKOS_INLINE_FUNCTION
@@ -37,6 +37,7 @@
 #include "mhd/mhd.hpp"
 #include "coordinates/coordinates.hpp"
 #include "coordinates/cell_locations.hpp"
+#include "z4c/tmunu.hpp"
 
 template<class EOSPolicy, class ErrorPolicy>
 class PrimitiveSolverHydro {
@@ -79,7 +80,58 @@ class PrimitiveSolverHydro {
 
       // Get table filename, then read the table,
       std::string fname = pin->GetString(block, "table");
-      ps.GetEOSMutable().ReadTableFromFile(fname);
+      std::string layout = pin->GetOrAddString(block, "table_layout", "variable");
+      if (layout.compare("variable") != 0 && layout.compare("interleaved") != 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Unknown table_layout " << layout << " requested."
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::string precision = pin->GetOrAddString(block, "table_precision", "real");
+      Primitive::EOSCompOSE::TableStorage storage;
+      if (!precision.compare("real")) {
+        storage = Primitive::EOSCompOSE::ECSTORE_REAL;
+      } else if (!precision.compare("float")) {
+        storage = Primitive::EOSCompOSE::ECSTORE_FLOAT;
+      } else if (!precision.compare("log16")) {
+        storage = Primitive::EOSCompOSE::ECSTORE_LOG16;
+      } else {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Unknown table_precision " << precision
+                  << " requested." << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      ps.GetEOSMutable().ReadTableFromFile(fname, !(layout.compare("interleaved")),
+                                           storage);
+
+      // Optionally report the error of the reduced precision table against Real
+      int nsample = pin->GetOrAddInteger(block, "table_accuracy_samples", 0);
+      if (nsample > 0 && storage != Primitive::EOSCompOSE::ECSTORE_REAL) {
+        Real max_err[Primitive::EOSCompOSE::ECNVARS];
+        Real rms_err[Primitive::EOSCompOSE::ECNVARS];
+        ps.GetEOS().CompareToRealTable(fname, nsample, max_err, rms_err);
+        if (global_variable::my_rank == 0) {
+          const char *names[Primitive::EOSCompOSE::ECNVARS] =
+              {"log P", "entropy", "mu_b", "mu_q", "mu_l", "log e", "c_s"};
+          std::cout << "CompOSE table stored as " << precision << ", errors at "
+                    << nsample << " states:" << std::endl;
+          for (int iv = 0; iv < Primitive::EOSCompOSE::ECNVARS; ++iv) {
+            std::cout << "  " << names[iv] << ": max " << max_err[iv]
+                      << ", rms " << rms_err[iv] << std::endl;
+          }
+        }
+      }
+
+      // Optionally build inverse tables to find the temperature from e and P
+      if (pin->GetOrAddBoolean(block, "inverse_tables", false)) {
+        int ninv = pin->GetOrAddInteger(block, "inverse_table_size", 256);
+        if (ninv < 2) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                    << std::endl << "inverse_table_size must be at least 2." << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+        ps.GetEOSMutable().BuildInverseTables(ninv);
+      }
 
       // Ensure table was read properly
       assert(ps.GetEOSMutable().IsInitialized());
@@ -91,6 +143,12 @@ class PrimitiveSolverHydro {
   MeshBlockPack* pmy_pack;
   unsigned int nerrs;
   unsigned int errcap;
+  // use the specialisations of the primitive solver for the number of species and for
+  // MeshBlocks without magnetic field
+  bool c2p_specialize;
+  DvceArray1D<bool> unmagnetized_mb;
+  // start the primitive solver from the primitives of the previous stage
+  bool c2p_warm;
 
   PrimitiveSolverHydro(std::string block, MeshBlockPack *pp, ParameterInput *pin) :
 //        pmy_pack(pp), ps{&eos} {
@@ -103,6 +161,19 @@ class PrimitiveSolverHydro {
     ps.tol = pin->GetOrAddReal(block, "c2p_tol", 1e-15);
     ps.GetRootSolverMutable().iterations = pin->GetOrAddInteger(block, "c2p_iter", 50);
     errcap = pin->GetOrAddInteger(block, "c2perrs", 1000);
+    c2p_specialize = pin->GetOrAddBoolean(block, "c2p_specialize", true);
+    std::string c2p_strategy = pin->GetOrAddString(block, "c2p_strategy", "bracket");
+    if (!c2p_strategy.compare("bracket")) {
+      c2p_warm = false;
+    } else if (!c2p_strategy.compare("warm")) {
+      c2p_warm = true;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Unknown c2p_strategy " << c2p_strategy << " requested."
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    ps.warm_width = pin->GetOrAddReal(block, "c2p_warm_width", 1e-3);
 
     // Calculate maximum allowed velocity
     Real Wmax = pin->GetOrAddReal(block, "gamma_max", 50.0);
@@ -272,7 +343,31 @@ class PrimitiveSolverHydro {
   void ConsToPrim(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &bfc,
                   DvceArray5D<Real> &bcc0, DvceArray5D<Real> &prim,
                   const int il, const int iu, const int jl, const int ju,
-                  const int kl, const int ku, bool floors_only=false) {
+                  const int kl, const int ku, bool floors_only=false,
+                  bool set_tmunu=false) {
+    // Dispatch to a primitive solver with the number of species fixed at compile time
+    int nspecies = c2p_specialize ? ps.GetEOS().GetNSpecies() : -1;
+    if (nspecies == 0) {
+      ConsToPrimSpecialized<0>(cons, bfc, bcc0, prim, il, iu, jl, ju, kl, ku,
+                               floors_only, set_tmunu);
+    } else if (nspecies == 1) {
+      ConsToPrimSpecialized<1>(cons, bfc, bcc0, prim, il, iu, jl, ju, kl, ku,
+                               floors_only, set_tmunu);
+    } else {
+      ConsToPrimSpecialized<-1>(cons, bfc, bcc0, prim, il, iu, jl, ju, kl, ku,
+                                floors_only, set_tmunu);
+    }
+  }
+
+  // ConsToPrim for NSPECIES species (-1 if not known at compile time). This must be
+  // public, since it launches a device lambda. With set_tmunu, the stress-energy tensor
+  // in the interior is also computed from the new primitives (see DynGRMHD::SetTmunu).
+  template<int NSPECIES>
+  void ConsToPrimSpecialized(DvceArray5D<Real> &cons, const DvceFaceFld4D<Real> &bfc,
+                             DvceArray5D<Real> &bcc0, DvceArray5D<Real> &prim,
+                             const int il, const int iu, const int jl, const int ju,
+                             const int kl, const int ku, bool floors_only,
+                             bool set_tmunu) {
     int &nhyd = pmy_pack->pmhd->nmhd;
     int &nscal = pmy_pack->pmhd->nscalars;
     int &nmb = pmy_pack->nmb_thispack;
@@ -284,15 +379,29 @@ class PrimitiveSolverHydro {
     auto &excision_flux_ = pmy_pack->pcoord->excision_flux;
     auto &dexcise_ = pmy_pack->pcoord->coord_data.dexcise;
     auto &pexcise_ = pmy_pack->pcoord->coord_data.pexcise;
+    // work recorded for measured cost model used in load balancing
+    bool track_work = pmy_pack->pmesh->cost_model.measured && !(floors_only);
+    auto &work_eachmb_ = pmy_pack->pmesh->cost_model.work_eachmb;
 
     auto &adm  = pmy_pack->padm->adm;
     auto &eos_ = ps.GetEOS();
     auto &ps_  = ps;
 
+    // Stress-energy tensor, only written in the interior when requested
+    const bool tmunu_ = set_tmunu && !(floors_only) && (pmy_pack->ptmunu != nullptr);
+    Tmunu::Tmunu_vars tmunu;
+    if (tmunu_) tmunu = pmy_pack->ptmunu->tmunu;
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    const int is = indcs.is, ie = indcs.ie;
+    const int js = indcs.js, je = indcs.je;
+    const int ks = indcs.ks, ke = indcs.ke;
+
     const int ni = (iu - il + 1);
     const int nji = (ju - jl + 1)*ni;
     const int nkji = (ku - kl + 1)*nji;
-    const int nmkji = nmb*nkji;
+    // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+    auto &mbact = pmy_pack->pmb->mb_active;
+    const int nmkji = (pmy_pack->pmb->nmb_active)*nkji;
 
     const int rank = global_variable::my_rank;
     const int nerrs_ = nerrs;
@@ -309,17 +418,47 @@ class PrimitiveSolverHydro {
       ps.GetEOSMutable().SetConservedFloorFailure(true);
     }
 
+    // Find the MeshBlocks in which the magnetic field vanishes, which can use the
+    // unmagnetized primitive solver.
+    const bool specialize = c2p_specialize;
+    auto &unmag_ = unmagnetized_mb;
+    if (specialize) {
+      if (unmagnetized_mb.extent_int(0) != nmb) {
+        Kokkos::realloc(unmagnetized_mb, nmb);
+      }
+      Kokkos::deep_copy(unmagnetized_mb, true);
+      par_for("pshyd_bscan", DevExeSpace(), 0, (nmb-1), kl, ku, jl, ju, il, iu,
+      KOKKOS_LAMBDA(int m, int k, int j, int i) {
+        bool zero;
+        if (floors_only) {
+          zero = (bcc0(m, IBX, k, j, i) == 0.0 && bcc0(m, IBY, k, j, i) == 0.0 &&
+                  bcc0(m, IBZ, k, j, i) == 0.0);
+        } else {
+          zero = (bfc.x1f(m,k,j,i) == 0.0 && bfc.x1f(m,k,j,i+1) == 0.0 &&
+                  bfc.x2f(m,k,j,i) == 0.0 && bfc.x2f(m,k,j+1,i) == 0.0 &&
+                  bfc.x3f(m,k,j,i) == 0.0 && bfc.x3f(m,k+1,j,i) == 0.0);
+        }
+        if (!zero) {
+          unmag_(m) = false;
+        }
+      });
+    }
+
+    const bool warm = c2p_warm;
+
     // FIXME(JMF): We can short-circuit the primitive solve if FOFC is already enabled
     // due to a maximum principle violation.
     int count_errs=0;
+    array_sum::C2PHist count_hist;
     Kokkos::parallel_reduce("pshyd_c2p",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
-    KOKKOS_LAMBDA(const int &idx, int &sumerrs) {
-      int m = (idx)/nkji;
-      int k = (idx - m*nkji)/nji;
-      int j = (idx - m*nkji - k*nji)/ni;
-      int i = (idx - m*nkji - k*nji - j*ni) + il;
+    KOKKOS_LAMBDA(const int &idx, int &sumerrs, array_sum::C2PHist &hist) {
+      int mm = (idx)/nkji;
+      int k = (idx - mm*nkji)/nji;
+      int j = (idx - mm*nkji - k*nji)/ni;
+      int i = (idx - mm*nkji - k*nji - j*ni) + il;
       j += jl;
       k += kl;
+      int m = mbact.d_view(mm);
 
       // Add in a short circuit where FOFC is guaranteed.
       if (floors_only && fofc_(m, k, j, i)) {
@@ -373,33 +512,49 @@ class PrimitiveSolverHydro {
         b3u[IBZ] = bcc0(m, IBZ, k, j, i)*isdetg;
       }
 
+      // With c2p_strategy = warm, guess the root from the primitives of the previous
+      // stage.
+      Real mu_guess = 0.0;
+      if (warm) {
+        prim_pt[PRH] = prim(m, IDN, k, j, i)/mb;
+        prim_pt[PVX] = prim(m, IVX, k, j, i);
+        prim_pt[PVY] = prim(m, IVY, k, j, i);
+        prim_pt[PVZ] = prim(m, IVZ, k, j, i);
+        prim_pt[PPR] = prim(m, IPR, k, j, i);
+        for (int n = 0; n < nscal; n++) {
+          prim_pt[PYF + n] = prim(m, nhyd + n, k, j, i);
+        }
+        mu_guess = ps_.GuessMu(prim_pt, g3d);
+      }
+
       // If we're in an excised region, set the primitives to some default value.
       Primitive::SolverResult result;
-      if (excise) {
-        if (excision_floor_(m,k,j,i)) {
-          prim_pt[PRH] = dexcise_/mb;
-          prim_pt[PVX] = 0.0;
-          prim_pt[PVY] = 0.0;
-          prim_pt[PVZ] = 0.0;
-          prim_pt[PPR] = pexcise_;
-          for (int n = 0; n < nscal; n++) {
-            // FIXME: Particle abundances should probably be set to a
-            // default inside an excised region.
-            prim_pt[PYF + n] = cons_pt[CYD]/cons_pt[CDN];
-          }
-          prim_pt[PTM] =
-            eos_.GetTemperatureFromP(prim_pt[PRH], prim_pt[PPR], &prim_pt[PYF]);
-          result.error = Primitive::Error::SUCCESS;
-          result.iterations = 0;
-          result.cons_floor = false;
-          result.prim_floor = false;
-          result.cons_adjusted = true;
-          ps_.PrimToCon(prim_pt, cons_pt, b3u, g3d);
-        } else {
-          result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u);
+      bool excised = excise && excision_floor_(m,k,j,i);
+      if (excised) {
+        prim_pt[PRH] = dexcise_/mb;
+        prim_pt[PVX] = 0.0;
+        prim_pt[PVY] = 0.0;
+        prim_pt[PVZ] = 0.0;
+        prim_pt[PPR] = pexcise_;
+        for (int n = 0; n < nscal; n++) {
+          // FIXME: Particle abundances should probably be set to a
+          // default inside an excised region.
+          prim_pt[PYF + n] = cons_pt[CYD]/cons_pt[CDN];
         }
+        prim_pt[PTM] =
+          eos_.GetTemperatureFromP(prim_pt[PRH], prim_pt[PPR], &prim_pt[PYF]);
+        result.error = Primitive::Error::SUCCESS;
+        result.iterations = 0;
+        result.cons_floor = false;
+        result.prim_floor = false;
+        result.cons_adjusted = true;
+        ps_.PrimToCon(prim_pt, cons_pt, b3u, g3d);
+      } else if (specialize && unmag_(m)) {
+        result = ps_.template ConToPrim<NSPECIES, false>(prim_pt, cons_pt, b3u, g3d, g3u,
+                                                         mu_guess);
       } else {
-        result = ps_.ConToPrim(prim_pt, cons_pt, b3u, g3d, g3u);
+        result = ps_.template ConToPrim<NSPECIES, true>(prim_pt, cons_pt, b3u, g3d, g3u,
+                                                        mu_guess);
       }
 
       if (result.error != Primitive::Error::SUCCESS && floors_only) {
@@ -446,6 +601,12 @@ class PrimitiveSolverHydro {
                    nerrs_ + sumerrs,rank);
           }
         }
+        if (!excised) {
+          hist.the_array[C2PHistBin(result.iterations)]++;
+        }
+        if (track_work) {
+          Kokkos::atomic_add(&work_eachmb_(m), static_cast<float>(result.iterations));
+        }
         // Regardless of failure, we need to copy the primitives.
         prim(m, IDN, k, j, i) = prim_pt[PRH]*mb;
         prim(m, IVX, k, j, i) = prim_pt[PVX];
@@ -494,14 +655,52 @@ class PrimitiveSolverHydro {
             cons(m, nhyd + n, k, j, i) = cons_pt[CYD + n]*sdetg;
           }
         }
+
+        // Perfect fluid contribution to the stress-energy tensor, computed from the
+        // (undensitized) variables of this cell rather than rereading w0, u0 and the
+        // metric in DynGRMHD::SetTmunu.
+        if (tmunu_ && i >= is && i <= ie && j >= js && j <= je && k >= ks && k <= ke) {
+          const Real *cons_t = (result.cons_floor || result.cons_adjusted) ?
+                               cons_pt : cons_pt_old;
+          const int imap[3][3] = {{S11, S12, S13}, {S12, S22, S23}, {S13, S23, S33}};
+          Real v_d[3] = {0.0}, B_d[3] = {0.0};
+          Real iW = 0.0;
+          for (int a = 0; a < 3; ++a) {
+            for (int b = 0; b < 3; ++b) {
+              v_d[a] += prim_pt[PVX + b]*g3d[imap[a][b]];
+              iW += prim_pt[PVX + a]*prim_pt[PVX + b]*g3d[imap[a][b]];
+              B_d[a] += b3u[b]*g3d[imap[a][b]];
+            }
+          }
+          iW = 1.0/sqrt(1.0 + iW);
+          Real Bv = 0.0, Bsq = 0.0;
+          for (int a = 0; a < 3; ++a) {
+            Bv += b3u[a]*v_d[a];
+            Bsq += b3u[a]*B_d[a];
+          }
+          Real bsq = (Bsq + Bv*Bv)*(iW*iW);
+
+          tmunu.E(m, k, j, i) = cons_t[CTA] + cons_t[CDN];
+          for (int a = 0; a < 3; ++a) {
+            tmunu.S_d(m, a, k, j, i) = cons_t[CSX + a];
+            for (int b = a; b < 3; ++b) {
+              tmunu.S_dd(m, a, b, k, j, i) = cons_t[CSX + a]*v_d[b]*iW
+                    - (B_d[a] + Bv*v_d[a])*SQR(iW)*B_d[b]
+                    + (prim_pt[PPR] + 0.5*bsq)*g3d[imap[a][b]];
+            }
+          }
+        }
       }
-    }, Kokkos::Sum<int>(count_errs));
+    }, Kokkos::Sum<int>(count_errs), Kokkos::Sum<array_sum::C2PHist>(count_hist));
 
     if (floors_only) {
       ps.GetEOSMutable().SetPrimitiveFloorFailure(prim_failure);
       ps.GetEOSMutable().SetConservedFloorFailure(cons_failure);
     } else {
       nerrs += count_errs;
+      for (int h = 0; h < NC2PHIST; h++) {
+        pmy_pack->pmesh->ecounter.nc2p_hist[h] += count_hist.the_array[h];
+      }
     }
   }
 
@@ -9,6 +9,7 @@
 // C/C++ headers
 #include <float.h>
 #include <iostream>
+#include <vector>
 
 // AthenaK headers
 #include "athena.hpp"
@@ -668,3 +669,50 @@ void GeodesicGrid::GreatCircleParam(Real zeta1, Real zeta2, Real psi1, Real psi2
   apar = sqrt(SQR(atilde)+SQR(btilde));
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void GeodesicGrid::AngleTransferMap
+//! \brief maps angles of this grid onto those of a coarser grid pcoarse, for transfer of
+//! intensities between angular resolutions.  Each angle is assigned to the coarse angle
+//! whose center is nearest (i.e. the coarse Voronoi cell containing its center), stored
+//! in parent.  The angles assigned to coarse angle nc are stored in
+//! child_index(child_offset(nc)...child_offset(nc+1)-1).
+
+void GeodesicGrid::AngleTransferMap(GeodesicGrid *pcoarse, DualArray1D<int> &parent,
+                                    DualArray1D<int> &child_offset,
+                                    DualArray1D<int> &child_index) {
+  int nc = pcoarse->nangles;
+  Kokkos::realloc(parent, nangles);
+  Kokkos::realloc(child_offset, nc+1);
+  Kokkos::realloc(child_index, nangles);
+  for (int c=0; c<=nc; ++c) {child_offset.h_view(c) = 0;}
+  for (int n=0; n<nangles; ++n) {
+    int nearest = 0;
+    Real maxdot = -2.0;
+    for (int c=0; c<nc; ++c) {
+      Real dot = (cart_pos.h_view(n,0)*pcoarse->cart_pos.h_view(c,0) +
+                  cart_pos.h_view(n,1)*pcoarse->cart_pos.h_view(c,1) +
+                  cart_pos.h_view(n,2)*pcoarse->cart_pos.h_view(c,2));
+      if (dot > maxdot) {
+        maxdot = dot;
+        nearest = c;
+      }
+    }
+    parent.h_view(n) = nearest;
+    child_offset.h_view(nearest+1) += 1;
+  }
+  for (int c=0; c<nc; ++c) {child_offset.h_view(c+1) += child_offset.h_view(c);}
+  std::vector<int> cursor(nc);
+  for (int c=0; c<nc; ++c) {cursor[c] = child_offset.h_view(c);}
+  for (int n=0; n<nangles; ++n) {
+    child_index.h_view(cursor[parent.h_view(n)]++) = n;
+  }
+
+  parent.template modify<HostMemSpace>();
+  parent.template sync<DevExeSpace>();
+  child_offset.template modify<HostMemSpace>();
+  child_offset.template sync<DevExeSpace>();
+  child_index.template modify<HostMemSpace>();
+  child_index.template sync<DevExeSpace>();
+  return;
+}
@@ -42,6 +42,8 @@ class GeodesicGrid {
   void RotateGrid(Real znew, Real pnew);
   void UnitFluxDir(Real zv, Real pv, Real zf, Real pf, Real& dz, Real& dp);
   void GreatCircleParam(Real z1, Real z2, Real p1, Real p2, Real& apar, Real& psi0);
+  void AngleTransferMap(GeodesicGrid *pcoarse, DualArray1D<int> &parent,
+                        DualArray1D<int> &child_offset, DualArray1D<int> &child_index);
 
  private:
   int nlevel;       // level of the geodesic mesh (==0 is 1 angle per octant for testing)
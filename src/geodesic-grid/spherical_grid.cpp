@@ -10,6 +10,8 @@
 #include <cmath>
 #include <iostream>
 #include <list>
+#include <utility>
+#include <vector>
 
 // AthenaK headers
 #include "athena.hpp"
@@ -30,7 +32,9 @@ SphericalGrid::SphericalGrid(MeshBlockPack *ppack, int nlev, Real rad):
     interp_coord("interp_coord",1,1),
     interp_indcs("interp_indcs",1,1),
     interp_wghts("interp_wghts",1,1,1),
-    interp_vals("interp_vals",1,1) {
+    interp_vals("interp_vals",1,1),
+    nregrid_stencil(-1),
+    nbuild_stencil(0) {
   // reallocate and set interpolation coordinates, indices, and weights
   int &ng = pmy_pack->pmesh->mb_indcs.ng;
   Kokkos::realloc(interp_coord,nangles,3);
@@ -39,8 +43,7 @@ SphericalGrid::SphericalGrid(MeshBlockPack *ppack, int nlev, Real rad):
 
   // Call functions to prepare SphericalGrid object for interpolation
   SetInterpolationCoordinates();
-  SetInterpolationIndices();
-  SetInterpolationWeights();
+  UpdateStencils();
 
   return;
 }
@@ -66,17 +69,17 @@ void SphericalGrid::SetInterpolationCoordinates() {
       Real &spin = pmy_pack->pcoord->coord_data.bh_spin;
       Real &theta = polar_pos.h_view(n,0);
       Real &phi = polar_pos.h_view(n,1);
-      interp_coord.h_view(n,0) = (radius*cos(phi)-spin*sin(phi))*sin(theta);
-      interp_coord.h_view(n,1) = (radius*sin(phi)+spin*cos(phi))*sin(theta);
-      interp_coord.h_view(n,2) = radius*cos(theta);
+      interp_coord.h_view(n,0) = center[0] + (radius*cos(phi)-spin*sin(phi))*sin(theta);
+      interp_coord.h_view(n,1) = center[1] + (radius*sin(phi)+spin*cos(phi))*sin(theta);
+      interp_coord.h_view(n,2) = center[2] + radius*cos(theta);
     }
   } else {
     for (int n=0; n<nangles; ++n) {
       Real &theta = polar_pos.h_view(n,0);
       Real &phi = polar_pos.h_view(n,1);
-      interp_coord.h_view(n,0) = radius*cos(phi)*sin(theta);
-      interp_coord.h_view(n,1) = radius*sin(phi)*sin(theta);
-      interp_coord.h_view(n,2) = radius*cos(theta);
+      interp_coord.h_view(n,0) = center[0] + radius*cos(phi)*sin(theta);
+      interp_coord.h_view(n,1) = center[1] + radius*sin(phi)*sin(theta);
+      interp_coord.h_view(n,2) = center[2] + radius*cos(theta);
     }
   }
 
@@ -87,6 +90,33 @@ void SphericalGrid::SetInterpolationCoordinates() {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void SphericalGrid::SetCenter
+//! \brief move center of sphere, so that stencils are rebuilt at next interpolation
+
+void SphericalGrid::SetCenter(Real x1, Real x2, Real x3) {
+  center[0] = x1;
+  center[1] = x2;
+  center[2] = x3;
+  SetInterpolationCoordinates();
+  nregrid_stencil = -1;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool SphericalGrid::UpdateStencils
+//! \brief rebuild interpolation indices and weights, only if MeshBlocks were refined or
+//! redistributed (Mesh::nregrid changed) or the sphere moved since they were last built
+
+bool SphericalGrid::UpdateStencils() {
+  if (nregrid_stencil == pmy_pack->pmesh->nregrid) {return false;}
+  SetInterpolationIndices();
+  SetInterpolationWeights();
+  nregrid_stencil = pmy_pack->pmesh->nregrid;
+  nbuild_stencil++;
+  return true;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void SphericalGrid::SetInterpolationIndices
 //! \brief determine which MeshBlocks and MeshBlock zones therein will be used in
@@ -99,45 +129,46 @@ void SphericalGrid::SetInterpolationIndices() {
 
   auto &rcoord = interp_coord;
   auto &iindcs = interp_indcs;
-  for (int n=0; n<=nang1; ++n) {
+  par_for("sph_indcs",DevExeSpace(),0,nang1,
+  KOKKOS_LAMBDA(int n) {
     // indices default to -1 if angle does not reside in this MeshBlockPack
-    iindcs.h_view(n,0) = -1;
-    iindcs.h_view(n,1) = -1;
-    iindcs.h_view(n,2) = -1;
-    iindcs.h_view(n,3) = -1;
+    iindcs.d_view(n,0) = -1;
+    iindcs.d_view(n,1) = -1;
+    iindcs.d_view(n,2) = -1;
+    iindcs.d_view(n,3) = -1;
+    Real x0 = rcoord.d_view(n,0);
+    Real y0 = rcoord.d_view(n,1);
+    Real z0 = rcoord.d_view(n,2);
     for (int m=0; m<=nmb1; ++m) {
       // extract MeshBlock bounds
-      Real &x1min = size.h_view(m).x1min;
-      Real &x1max = size.h_view(m).x1max;
-      Real &x2min = size.h_view(m).x2min;
-      Real &x2max = size.h_view(m).x2max;
-      Real &x3min = size.h_view(m).x3min;
-      Real &x3max = size.h_view(m).x3max;
+      Real &x1min = size.d_view(m).x1min;
+      Real &x1max = size.d_view(m).x1max;
+      Real &x2min = size.d_view(m).x2min;
+      Real &x2max = size.d_view(m).x2max;
+      Real &x3min = size.d_view(m).x3min;
+      Real &x3max = size.d_view(m).x3max;
 
       // extract MeshBlock grid cell spacings
-      Real &dx1 = size.h_view(m).dx1;
-      Real &dx2 = size.h_view(m).dx2;
-      Real &dx3 = size.h_view(m).dx3;
+      Real &dx1 = size.d_view(m).dx1;
+      Real &dx2 = size.d_view(m).dx2;
+      Real &dx3 = size.d_view(m).dx3;
 
       // save MeshBlock and zone indicies for nearest position to spherical patch center
       // if this angle position resides in this MeshBlock
-      if ((rcoord.h_view(n,0) >= x1min && rcoord.h_view(n,0) <= x1max) &&
-          (rcoord.h_view(n,1) >= x2min && rcoord.h_view(n,1) <= x2max) &&
-          (rcoord.h_view(n,2) >= x3min && rcoord.h_view(n,2) <= x3max)) {
-        iindcs.h_view(n,0) = m;
-        iindcs.h_view(n,1) = static_cast<int>(std::floor((rcoord.h_view(n,0)-
-                                                          (x1min+dx1/2.0))/dx1));
-        iindcs.h_view(n,2) = static_cast<int>(std::floor((rcoord.h_view(n,1)-
-                                                          (x2min+dx2/2.0))/dx2));
-        iindcs.h_view(n,3) = static_cast<int>(std::floor((rcoord.h_view(n,2)-
-                                                          (x3min+dx3/2.0))/dx3));
+      if ((x0 >= x1min && x0 <= x1max) &&
+          (y0 >= x2min && y0 <= x2max) &&
+          (z0 >= x3min && z0 <= x3max)) {
+        iindcs.d_view(n,0) = m;
+        iindcs.d_view(n,1) = static_cast<int>(floor((x0-(x1min+dx1/2.0))/dx1));
+        iindcs.d_view(n,2) = static_cast<int>(floor((y0-(x2min+dx2/2.0))/dx2));
+        iindcs.d_view(n,3) = static_cast<int>(floor((z0-(x3min+dx3/2.0))/dx3));
       }
     }
-  }
+  });
 
   // sync dual arrays
-  interp_indcs.template modify<HostMemSpace>();
-  interp_indcs.template sync<DevExeSpace>();
+  interp_indcs.template modify<DevExeSpace>();
+  interp_indcs.template sync<HostMemSpace>();
 
   return;
 }
@@ -149,63 +180,111 @@ void SphericalGrid::SetInterpolationIndices() {
 void SphericalGrid::SetInterpolationWeights() {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   auto &size = pmy_pack->pmb->mb_size;
-  int &ng = indcs.ng;
+  int ng = indcs.ng;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int nang1 = nangles - 1;
 
+  auto &rcoord = interp_coord;
   auto &iindcs = interp_indcs;
   auto &iwghts = interp_wghts;
-  for (int n=0; n<nangles; ++n) {
+  par_for("sph_wghts",DevExeSpace(),0,nang1,
+  KOKKOS_LAMBDA(int n) {
     // extract indices
-    int &ii0 = iindcs.h_view(n,0);
-    int &ii1 = iindcs.h_view(n,1);
-    int &ii2 = iindcs.h_view(n,2);
-    int &ii3 = iindcs.h_view(n,3);
+    int ii0 = iindcs.d_view(n,0);
+    int ii1 = iindcs.d_view(n,1);
+    int ii2 = iindcs.d_view(n,2);
+    int ii3 = iindcs.d_view(n,3);
 
     if (ii0==-1) {  // angle not on this rank
       for (int i=0; i<2*ng; ++i) {
-        iwghts.h_view(n,i,0) = 0.0;
-        iwghts.h_view(n,i,1) = 0.0;
-        iwghts.h_view(n,i,2) = 0.0;
+        iwghts.d_view(n,i,0) = 0.0;
+        iwghts.d_view(n,i,1) = 0.0;
+        iwghts.d_view(n,i,2) = 0.0;
       }
     } else {
       // extract spherical grid positions
-      Real &x0 = interp_coord.h_view(n,0);
-      Real &y0 = interp_coord.h_view(n,1);
-      Real &z0 = interp_coord.h_view(n,2);
+      Real x0 = rcoord.d_view(n,0);
+      Real y0 = rcoord.d_view(n,1);
+      Real z0 = rcoord.d_view(n,2);
 
       // extract MeshBlock bounds
-      Real &x1min = size.h_view(ii0).x1min;
-      Real &x1max = size.h_view(ii0).x1max;
-      Real &x2min = size.h_view(ii0).x2min;
-      Real &x2max = size.h_view(ii0).x2max;
-      Real &x3min = size.h_view(ii0).x3min;
-      Real &x3max = size.h_view(ii0).x3max;
+      Real &x1min = size.d_view(ii0).x1min;
+      Real &x1max = size.d_view(ii0).x1max;
+      Real &x2min = size.d_view(ii0).x2min;
+      Real &x2max = size.d_view(ii0).x2max;
+      Real &x3min = size.d_view(ii0).x3min;
+      Real &x3max = size.d_view(ii0).x3max;
 
       // set interpolation weights
       for (int i=0; i<2*ng; ++i) {
-        iwghts.h_view(n,i,0) = 1.;
-        iwghts.h_view(n,i,1) = 1.;
-        iwghts.h_view(n,i,2) = 1.;
+        iwghts.d_view(n,i,0) = 1.;
+        iwghts.d_view(n,i,1) = 1.;
+        iwghts.d_view(n,i,2) = 1.;
         for (int j=0; j<2*ng; ++j) {
           if (j != i) {
-            Real x1vpi1 = CellCenterX(ii1-ng+i+1, indcs.nx1, x1min, x1max);
-            Real x1vpj1 = CellCenterX(ii1-ng+j+1, indcs.nx1, x1min, x1max);
-            iwghts.h_view(n,i,0) *= (x0-x1vpj1)/(x1vpi1-x1vpj1);
-            Real x2vpi1 = CellCenterX(ii2-ng+i+1, indcs.nx2, x2min, x2max);
-            Real x2vpj1 = CellCenterX(ii2-ng+j+1, indcs.nx2, x2min, x2max);
-            iwghts.h_view(n,i,1) *= (y0-x2vpj1)/(x2vpi1-x2vpj1);
-            Real x3vpi1 = CellCenterX(ii3-ng+i+1, indcs.nx3, x3min, x3max);
-            Real x3vpj1 = CellCenterX(ii3-ng+j+1, indcs.nx3, x3min, x3max);
-            iwghts.h_view(n,i,2) *= (z0-x3vpj1)/(x3vpi1-x3vpj1);
+            Real x1vpi1 = CellCenterX(ii1-ng+i+1, nx1, x1min, x1max);
+            Real x1vpj1 = CellCenterX(ii1-ng+j+1, nx1, x1min, x1max);
+            iwghts.d_view(n,i,0) *= (x0-x1vpj1)/(x1vpi1-x1vpj1);
+            Real x2vpi1 = CellCenterX(ii2-ng+i+1, nx2, x2min, x2max);
+            Real x2vpj1 = CellCenterX(ii2-ng+j+1, nx2, x2min, x2max);
+            iwghts.d_view(n,i,1) *= (y0-x2vpj1)/(x2vpi1-x2vpj1);
+            Real x3vpi1 = CellCenterX(ii3-ng+i+1, nx3, x3min, x3max);
+            Real x3vpj1 = CellCenterX(ii3-ng+j+1, nx3, x3min, x3max);
+            iwghts.d_view(n,i,2) *= (z0-x3vpj1)/(x3vpi1-x3vpj1);
           }
         }
       }
     }
-  }
+  });
 
   // sync dual arrays
-  interp_wghts.template modify<HostMemSpace>();
-  interp_wghts.template sync<DevExeSpace>();
+  interp_wghts.template modify<DevExeSpace>();
+  interp_wghts.template sync<HostMemSpace>();
+
+  return;
+}
 
+//----------------------------------------------------------------------------------------
+//! \fn void InterpolateWithStencils
+//! \brief interpolate nvars variables of val to npts points with the Lagrange stencils
+//! given by iindcs and iwghts, with one team per point, one thread per variable, and the
+//! sum over the (2*ng)^3 points of the stencil done by the vector lanes.
+
+static void InterpolateWithStencils(MeshBlockPack *ppack, const int npts, const int nvars,
+                                    const DvceArray2D<int> iindcs,
+                                    const DvceArray3D<Real> iwghts,
+                                    DvceArray2D<Real> ivals,
+                                    const DvceArray5D<Real> &val) {
+  auto &indcs = ppack->pmesh->mb_indcs;
+  int is = indcs.is; int js = indcs.js; int ks = indcs.ks;
+  int ng = indcs.ng;
+  const int nst = 2*ng;
+  const int nst3 = nst*nst*nst;
+
+  par_for_outer("int2sph",DevExeSpace(),0,0,0,(npts-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int n) {
+    int ii0 = iindcs(n,0);
+    int ii1 = iindcs(n,1);
+    int ii2 = iindcs(n,2);
+    int ii3 = iindcs(n,3);
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(tmember, nvars), [&](const int v) {
+      if (ii0==-1) {  // angle not on this rank
+        Kokkos::single(Kokkos::PerThread(tmember), [&]() {ivals(n,v) = 0.0;});
+      } else {
+        Real int_value = 0.0;
+        Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(tmember, nst3),
+        [=](const int idx, Real &sum) {
+          int k = idx/(nst*nst);
+          int j = (idx - k*nst*nst)/nst;
+          int i = idx - k*nst*nst - j*nst;
+          Real iwght = iwghts(n,i,0)*iwghts(n,j,1)*iwghts(n,k,2);
+          sum += iwght*val(ii0,v,ii3-(ng-k-ks)+1,ii2-(ng-j-js)+1,ii1-(ng-i-is)+1);
+        }, int_value);
+        Kokkos::single(Kokkos::PerThread(tmember), [&]() {ivals(n,v) = int_value;});
+      }
+    });
+  });
   return;
 }
 
@@ -214,51 +293,72 @@ void SphericalGrid::SetInterpolationWeights() {
 //! \brief interpolate Cartesian data to surface of sphere
 
 void SphericalGrid::InterpolateToSphere(int nvars, DvceArray5D<Real> &val) {
-  // reinitialize interpolation indices and weights if AMR
-  if (pmy_pack->pmesh->adaptive) {
-    SetInterpolationIndices();
-    SetInterpolationWeights();
+  // rebuild interpolation indices and weights if mesh changed or sphere moved
+  UpdateStencils();
+
+  // reallocate container
+  if (interp_vals.extent_int(0) != nangles || interp_vals.extent_int(1) != nvars) {
+    Kokkos::realloc(interp_vals,nangles,nvars);
   }
 
-  // capturing variables for kernel
-  auto &indcs = pmy_pack->pmesh->mb_indcs;
-  int &is = indcs.is; int &js = indcs.js; int &ks = indcs.ks;
-  int &ng = indcs.ng;
-  int nang1 = nangles - 1;
-  int nvar1 = nvars - 1;
+  InterpolateWithStencils(pmy_pack, nangles, nvars, interp_indcs.d_view,
+                          interp_wghts.d_view, interp_vals.d_view, val);
 
-  // reallocate container
-  Kokkos::realloc(interp_vals,nangles,nvars);
+  // sync dual arrays
+  interp_vals.template modify<DevExeSpace>();
+  interp_vals.template sync<HostMemSpace>();
 
-  auto &iindcs = interp_indcs;
-  auto &iwghts = interp_wghts;
-  auto &ivals = interp_vals;
-  par_for("int2sph",DevExeSpace(),0,nang1,0,nvar1,
-  KOKKOS_LAMBDA(int n, int v) {
-    int ii0 = iindcs.d_view(n,0);
-    int ii1 = iindcs.d_view(n,1);
-    int ii2 = iindcs.d_view(n,2);
-    int ii3 = iindcs.d_view(n,3);
+  return;
+}
 
-    if (ii0==-1) {  // angle not on this rank
-      ivals.d_view(n,v) = 0.0;
-    } else {
-      Real int_value = 0.0;
-      for (int i=0; i<2*ng; i++) {
-        for (int j=0; j<2*ng; j++) {
-          for (int k=0; k<2*ng; k++) {
-            Real iwght = iwghts.d_view(n,i,0)*iwghts.d_view(n,j,1)*iwghts.d_view(n,k,2);
-            int_value += iwght*val(ii0,v,ii3-(ng-k-ks)+1,ii2-(ng-j-js)+1,ii1-(ng-i-is)+1);
-          }
-        }
-      }
-      ivals.d_view(n,v) = int_value;
+//----------------------------------------------------------------------------------------
+// SphericalGridBatch constructor
+
+SphericalGridBatch::SphericalGridBatch(MeshBlockPack *ppack,
+                                       std::vector<SphericalGrid*> grids):
+    npoints(0),
+    interp_vals("batch_interp_vals",1,1),
+    pmy_pack(ppack),
+    grids_(grids),
+    interp_indcs("batch_interp_indcs",1,1),
+    interp_wghts("batch_interp_wghts",1,1,1) {
+  for (auto pgrid : grids_) {
+    offset.push_back(npoints);
+    npoints += pgrid->nangles;
+  }
+  int &ng = pmy_pack->pmesh->mb_indcs.ng;
+  Kokkos::realloc(interp_indcs,npoints,4);
+  Kokkos::realloc(interp_wghts,npoints,2*ng,3);
+  // stencils of all grids are copied at first interpolation
+  nbuild_copied_.assign(grids_.size(), -1);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SphericalGridBatch::InterpolateToSpheres
+//! \brief interpolate Cartesian data to the points of all grids in one kernel.  Stencils
+//! of each grid are copied into the concatenated arrays only when they were rebuilt.
+
+void SphericalGridBatch::InterpolateToSpheres(int nvars, DvceArray5D<Real> &val) {
+  for (std::size_t g=0; g<grids_.size(); ++g) {
+    grids_[g]->UpdateStencils();
+    if (nbuild_copied_[g] != grids_[g]->nbuild_stencil) {
+      nbuild_copied_[g] = grids_[g]->nbuild_stencil;
+      auto pts = std::make_pair(offset[g], offset[g] + grids_[g]->nangles);
+      Kokkos::deep_copy(Kokkos::subview(interp_indcs, pts, Kokkos::ALL),
+                        grids_[g]->interp_indcs.d_view);
+      Kokkos::deep_copy(Kokkos::subview(interp_wghts, pts, Kokkos::ALL, Kokkos::ALL),
+                        grids_[g]->interp_wghts.d_view);
     }
-  });
+  }
 
-  // sync dual arrays
+  // reallocate container
+  if (interp_vals.extent_int(0) != npoints || interp_vals.extent_int(1) != nvars) {
+    Kokkos::realloc(interp_vals,npoints,nvars);
+  }
+
+  InterpolateWithStencils(pmy_pack, npoints, nvars, interp_indcs, interp_wghts,
+                          interp_vals.d_view, val);
   interp_vals.template modify<DevExeSpace>();
-  interp_vals.template sync<HostMemSpace>();
 
   return;
 }
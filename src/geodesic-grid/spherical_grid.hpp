@@ -9,6 +9,8 @@
 //! \file spherical_grid.hpp
 //  \brief definitions for SphericalGrid class
 
+#include <vector>
+
 #include "athena.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 
@@ -25,17 +27,49 @@ class SphericalGrid: public GeodesicGrid {
     ~SphericalGrid();
 
     Real radius;  // const radius for SphericalGrid
+    Real center[3] = {0.0, 0.0, 0.0};  // center of sphere (moved with SetCenter)
     DualArray2D<Real> interp_coord;  // Cartesian coordinates for grid points
     DualArray2D<Real> interp_vals;   // container for data interpolated to sphere
     void InterpolateToSphere(int nvars, DvceArray5D<Real> &val);  // interpolate to sphere
+    void SetCenter(Real x1, Real x2, Real x3);  // move sphere
+    // (re)build interpolation stencils if the mesh changed or the sphere moved since they
+    // were last built, returns true if they were rebuilt
+    bool UpdateStencils();
 
  private:
+    friend class SphericalGridBatch;
     MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
     DualArray2D<int> interp_indcs;   // indices of MeshBlock and zones therein for interp
     DualArray3D<Real> interp_wghts;  // weights for interpolation
+    int nregrid_stencil;  // value of Mesh::nregrid when stencils built (or -1)
+    int nbuild_stencil;   // number of times stencils were built
     void SetInterpolationCoordinates();  // set indexing for interpolation
     void SetInterpolationIndices();      // set indexing for interpolation
     void SetInterpolationWeights();      // set weights for interpolation
 };
 
+//----------------------------------------------------------------------------------------
+//! \class SphericalGridBatch
+//! \brief Interpolates to the points of several SphericalGrids, concatenated in the order
+//! of the grids, for many variables in one kernel.  Interpolated values are left on the
+//! device in interp_vals, with the points of grid g starting at offset[g].
+
+class SphericalGridBatch {
+ public:
+    SphericalGridBatch(MeshBlockPack *ppack, std::vector<SphericalGrid*> grids);
+    ~SphericalGridBatch() = default;
+
+    int npoints;               // total number of points of all grids
+    std::vector<int> offset;   // index of first point of each grid
+    DualArray2D<Real> interp_vals;  // interpolated data (npoints, nvars)
+    void InterpolateToSpheres(int nvars, DvceArray5D<Real> &val);
+
+ private:
+    MeshBlockPack* pmy_pack;
+    std::vector<SphericalGrid*> grids_;
+    DvceArray2D<int> interp_indcs;   // concatenated indices of all grids
+    DvceArray3D<Real> interp_wghts;  // concatenated weights of all grids
+    std::vector<int> nbuild_copied_;  // SphericalGrid::nbuild_stencil when copied
+};
+
 #endif // GEODESIC_GRID_SPHERICAL_GRID_HPP_
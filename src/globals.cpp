@@ -16,4 +16,7 @@
 namespace global_variable {
 int my_rank;   // MPI rank of this process; set at start of main();
 int nranks;    // total number of MPI ranks; set at start of main();
+int team_size = 0;      // team size in par_for_outer (0: Kokkos::AUTO); set in main()
+int scratch_level = 0;  // scratch level used in flux kernels; set in main()
+int nbits_lid = NUM_BITS_LID;  // bits for MB local ID in MPI tags; set in main()
 }
@@ -10,6 +10,8 @@
 
 namespace global_variable {
 extern int my_rank, nranks;
+extern int team_size, scratch_level;
+extern int nbits_lid;
 }
 
 #endif // GLOBALS_HPP_
@@ -11,6 +11,7 @@
 #include <algorithm>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "eos/eos.hpp"
@@ -117,6 +118,10 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
 
   // allocate boundary buffers for conserved (cell-centered) variables
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
+  pbval_u->lowp_vars = pin->GetOrAddBoolean("hydro", "lowp_halo", false);
+  if (pin->GetOrAddBoolean("hydro", "trim_halo", false)) {
+    pbval_u->halo_depth = pbval_u->StencilHaloDepth(pin, "hydro");
+  }
   pbval_u->InitializeBuffers((nhydro+nscalars));
 
   // Orbital advection and shearing box BCs (if requested in input file)
@@ -132,6 +137,132 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
   if (evolution_t.compare("stationary") != 0) {
     // determine if FOFC is enabled
     use_fofc = pin->GetOrAddBoolean("hydro","fofc",false);
+    // determine if fourth-order fluxes are enabled (see CalculateFluxesFourthOrder())
+    fourth_order = pin->GetOrAddBoolean("hydro","fourth_order",false);
+    // determine if C2P in active cells overlaps communication of ghost zones
+    split_c2p = pin->GetOrAddBoolean("hydro","split_c2p",false);
+    // Fuse x1-flux and update kernels, optionally over sub-packs of MBs.  Only possible
+    // when the update of each MB depends only on its own fluxes (no flux correction at
+    // fine/coarse boundaries, and no diffusive fluxes or FOFC added after the RS).
+    bool fuse = pin->GetOrAddBoolean("hydro","fused_update",false);
+    // Optionally compute fluxes of passive scalars in separate kernels, over chunks of
+    // scalar_chunk scalars at a time, from the mass fluxes returned by the RS.
+    if (nscalars > 0) {
+      scalar_chunk = pin->GetOrAddInteger("hydro","scalar_chunk",0);
+    }
+    nmb_subpack = pin->GetOrAddInteger("hydro","nmb_subpack",0);
+    // Optionally compute fluxes over tiles in x2/x3 with primitives cached in scratch.
+    // Tiles must evenly divide MeshBlocks, and fluxes in ghost zones are not computed.
+    flux_tile = pin->GetOrAddInteger("hydro","flux_tile",0);
+    if (flux_tile > 0) {
+      auto &indcs = pmy_pack->pmesh->mb_indcs;
+      if ((indcs.nx2 > 1 && indcs.nx2 % flux_tile != 0) ||
+          (indcs.nx3 > 1 && indcs.nx3 % flux_tile != 0)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro>/flux_tile=" << flux_tile << " must evenly "
+                  << "divide the MeshBlock size in x2 and x3" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (use_fofc || scalar_chunk > 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro>/flux_tile cannot be used with FOFC or "
+                  << "<hydro>/scalar_chunk" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      // scratch per team is the tile with ghost zones plus three rows (see
+      // CalculateFluxesTiled()), which must fit in the scratch level used
+      bool &multi_d = pmy_pack->pmesh->multi_d;
+      bool &three_d = pmy_pack->pmesh->three_d;
+      int nvars = nhydro + nscalars;
+      int ncells1 = SimdPadded(indcs.nx1 + 2*indcs.ng);
+      int nbj = (multi_d)? (flux_tile + 2*indcs.ng) : 1;
+      int nbk = (three_d)? (flux_tile + 2*indcs.ng) : 1;
+      size_t scr_size = ScrArray4D<Real>::shmem_size(nvars, nbk, nbj, ncells1) +
+                        ScrArray2D<Real>::shmem_size(nvars, ncells1) * 3;
+      flux_tile_scr_level = FittingScratchLevel(scr_size);
+      if (flux_tile_scr_level < 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro>/flux_tile=" << flux_tile << " needs "
+                  << scr_size << " bytes of team scratch, more than is available at "
+                  << "scratch level 1.  Use a smaller flux_tile" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (flux_tile_scr_level != global_variable::scratch_level &&
+          global_variable::my_rank == 0) {
+        std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro>/flux_tile=" << flux_tile << " needs "
+                  << scr_size << " bytes of team scratch, more than is available at "
+                  << "<job>/scratch_level=" << global_variable::scratch_level
+                  << ", so scratch level " << flux_tile_scr_level << " is used"
+                  << std::endl;
+      }
+    }
+    if (fuse || nmb_subpack > 0) {
+      auto &coord = pmy_pack->pcoord;
+      // Monte Carlo tracers need x1-fluxes in uflx after the update
+      bool mc_tracers = pin->DoesParameterExist("particles","pusher") &&
+          (pin->GetString("particles","pusher").compare("lagrangian_mc") == 0);
+      fused_update = (flux_tile == 0) && (scalar_chunk == 0) && !(mc_tracers) &&
+                     !(pmy_pack->pmesh->multilevel) &&
+                     (pvisc == nullptr) && (pcond == nullptr) && !(use_fofc) &&
+                     !(fourth_order) &&
+                     !(coord->is_general_relativistic && coord->coord_data.bh_excise);
+    }
+    // Compute new timestep within C2P on last stage of each cycle, rather than with a
+    // separate reduction over w0.  Only for nonrelativistic hydrodynamic problems.
+    if (pin->GetOrAddBoolean("hydro","fused_newdt",false)) {
+      auto &coord = pmy_pack->pcoord;
+      fused_newdt = (evolution_t.compare("dynamic") == 0) &&
+                    !(coord->is_special_relativistic) &&
+                    !(coord->is_general_relativistic) &&
+                    !(coord->is_dynamical_relativistic);
+    }
+    // With FOFC, optionally flag cells during the RK update and store their indices in a
+    // compact list, so the LLF correction is only applied to flagged cells.  Only for
+    // nonrelativistic hydrodynamics on a uniform mesh, since corrected fluxes are not
+    // communicated to fine/coarse neighbors.
+    fofc_list = pin->GetOrAddBoolean("hydro","fofc_list",false);
+    if (fofc_list) {
+      auto &coord = pmy_pack->pcoord;
+      if (!(use_fofc) || pmy_pack->pmesh->multilevel ||
+          coord->is_special_relativistic || coord->is_general_relativistic ||
+          coord->is_dynamical_relativistic) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro>/fofc_list requires <hydro>/fofc=true, and "
+                  << "cannot be used with SMR/AMR or relativistic hydrodynamics"
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // Optionally integrate viscous and heat fluxes with RKL1/RKL2 super-time-stepping in
+    // separate task lists after the time integrator, so dt is not limited by diffusion
+    std::string sts = pin->GetOrAddString("hydro","sts_integrator","none");
+    if (sts.compare("rkl1") == 0) {
+      sts_integrator = STS_Integrator::rkl1;
+    } else if (sts.compare("rkl2") == 0) {
+      sts_integrator = STS_Integrator::rkl2;
+    } else if (sts.compare("none") != 0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<hydro>/sts_integrator = '" << sts << "' not implemented"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (sts_integrator != STS_Integrator::none) {
+      if ((pvisc == nullptr && pcond == nullptr) || psrc->shearing_box) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro>/sts_integrator requires viscosity or thermal "
+                  << "conduction, and cannot be used with shearing box" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      auto &indcs = pmy_pack->pmesh->mb_indcs;
+      int ncells1 = indcs.nx1 + 2*(indcs.ng);
+      int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+      int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+      Kokkos::realloc(u_sts0, nmb, nhydro, ncells3, ncells2, ncells1);
+      Kokkos::realloc(u_sts1, nmb, nhydro, ncells3, ncells2, ncells1);
+      Kokkos::realloc(m_sts0, nmb, nhydro, ncells3, ncells2, ncells1);
+    }
 
     // select reconstruction method (default PLM)
     std::string xorder = pin->GetOrAddString("hydro","reconstruct","plm");
@@ -149,7 +280,9 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
       }
     } else if (xorder.compare("ppm4") == 0 ||
                xorder.compare("ppmx") == 0 ||
-               xorder.compare("wenoz") == 0) {
+               xorder.compare("wenoz") == 0 ||
+               xorder.compare("wenoz_hybrid") == 0 ||
+               xorder.compare("mp5") == 0) {
       // check that nghost > 2
       auto &indcs = pmy_pack->pmesh->mb_indcs;
       if (indcs.ng < 3) {
@@ -158,7 +291,7 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
           << "but <mesh>/nghost=" << indcs.ng << std::endl;
         std::exit(EXIT_FAILURE);
       }
-      // check that nghost > 3 with PPM4(or PPMX or WENOZ)+FOFC
+      // check that nghost > 3 with PPM4(or PPMX or WENOZ or MP5)+FOFC
       if (use_fofc && indcs.ng < 4) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << "FOFC and " << xorder << " reconstruction requires at "
@@ -169,8 +302,10 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
         recon_method = ReconstructionMethod::ppm4;
       } else if (xorder.compare("ppmx") == 0) {
         recon_method = ReconstructionMethod::ppmx;
-      } else if (xorder.compare("wenoz") == 0) {
+      } else if (xorder.compare("wenoz") == 0 || xorder.compare("wenoz_hybrid") == 0) {
         recon_method = ReconstructionMethod::wenoz;
+      } else if (xorder.compare("mp5") == 0) {
+        recon_method = ReconstructionMethod::mp5;
       }
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
@@ -178,6 +313,108 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
                 << std::endl;
       std::exit(EXIT_FAILURE);
     }
+    if (!(ReconstructionEnabled(recon_method))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<hydro> reconstruct = '" << xorder << "' not compiled, "
+                << "add it to Athena_RECONSTRUCTION when configuring" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // reconstruction in characteristic variables (nonrelativistic ideal gas only)
+    char_recon = pin->GetOrAddBoolean("hydro","characteristic",false);
+    if (char_recon && (!(peos->eos_data.is_ideal) ||
+                       pmy_pack->pcoord->is_special_relativistic ||
+                       pmy_pack->pcoord->is_general_relativistic ||
+                       pmy_pack->pcoord->is_dynamical_relativistic)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<hydro> characteristic = true only implemented for "
+                << "nonrelativistic hydrodynamics with an ideal gas EOS" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // hybrid WENO-Z: linear 5th-order stencil in cells flagged smooth by a shock sensor
+    if (xorder.compare("wenoz_hybrid") == 0) {
+      hybrid_thresh = pin->GetOrAddReal("hydro","hybrid_threshold",0.02);
+      if (hybrid_thresh <= 0.0 || char_recon) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro> reconstruct = wenoz_hybrid requires "
+                  << "hybrid_threshold > 0, and cannot be used with characteristic = true"
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+
+    // fourth-order fluxes need an extra layer of ghost zones for the transverse
+    // corrections, and are computed in their own kernels (not fused or tiled)
+    if (fourth_order) {
+      auto &coord = pmy_pack->pcoord;
+      if (evolution_t.compare("dynamic") != 0 || coord->is_special_relativistic ||
+          coord->is_general_relativistic || coord->is_dynamical_relativistic ||
+          use_fofc || flux_tile > 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro> fourth_order = true only implemented for "
+                  << "nonrelativistic dynamic hydrodynamics, and cannot be used with "
+                  << "FOFC or <hydro>/flux_tile" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (pmy_pack->pmesh->mb_indcs.ng < 4) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro> fourth_order = true requires at least 4 "
+                  << "ghost zones, but <mesh>/nghost=" << pmy_pack->pmesh->mb_indcs.ng
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      std::string integ = pin->GetOrAddString("time","integrator","rk2");
+      if (global_variable::my_rank == 0 &&
+          (integ.compare("rk4") != 0 && integ.compare("ssprk104") != 0)) {
+        std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro> fourth_order = true with <time>/integrator = "
+                  << integ << ", error will be dominated by time integration unless a "
+                  << "fourth-order integrator (rk4, ssprk104) is used" << std::endl;
+      }
+    }
+
+    // select reconstruction method for scalars computed in separate kernels (default same
+    // as hydro).  Must not need more ghost zones than hydro reconstruction.
+    scalar_recon = recon_method;
+    if (scalar_chunk > 0) {
+      std::string sorder = pin->GetOrAddString("hydro","scalar_reconstruct",xorder);
+      if (sorder.compare("dc") == 0) {
+        scalar_recon = ReconstructionMethod::dc;
+      } else if (sorder.compare("plm") == 0) {
+        scalar_recon = ReconstructionMethod::plm;
+      } else if (sorder.compare("ppm4") == 0) {
+        scalar_recon = ReconstructionMethod::ppm4;
+      } else if (sorder.compare("ppmx") == 0) {
+        scalar_recon = ReconstructionMethod::ppmx;
+      } else if (sorder.compare("wenoz") == 0) {
+        scalar_recon = ReconstructionMethod::wenoz;
+      } else if (sorder.compare("mp5") == 0) {
+        scalar_recon = ReconstructionMethod::mp5;
+      } else {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro> scalar_reconstruct = '" << sorder
+                  << "' not implemented" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      bool high_order = (scalar_recon == ReconstructionMethod::ppm4 ||
+                         scalar_recon == ReconstructionMethod::ppmx ||
+                         scalar_recon == ReconstructionMethod::wenoz ||
+                         scalar_recon == ReconstructionMethod::mp5);
+      if (high_order && pmy_pack->pmesh->mb_indcs.ng < 3) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << sorder << " reconstruction requires at least 3 ghost zones, "
+          << "but <mesh>/nghost=" << pmy_pack->pmesh->mb_indcs.ng << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (!(ReconstructionEnabled(scalar_recon))) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<hydro> scalar_reconstruct = '" << sorder << "' not "
+                  << "compiled, add it to Athena_RECONSTRUCTION when configuring"
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
 
     // select Riemann solver (no default).  Test for compatibility of options
     std::string rsolver = pin->GetString("hydro","rsolver");
@@ -277,10 +514,30 @@ Hydro::Hydro(MeshBlockPack *ppack, ParameterInput *pin) :
       Kokkos::realloc(uflx.x2f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
       Kokkos::realloc(uflx.x3f, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
 
+      // compulsory memory traffic per row of flux and update kernels (kernel profiler)
+      int ndim = 1 + (ncells2 > 1) + (ncells3 > 1);
+      double flx_bytes = 2.0*(nhydro+nscalars)*ncells1*sizeof(Real);
+      kernel_profiler::SetBytesPerIteration("hflux_x1", flx_bytes);
+      kernel_profiler::SetBytesPerIteration("hflux_x2", flx_bytes);
+      kernel_profiler::SetBytesPerIteration("hflux_x3", flx_bytes);
+      kernel_profiler::SetBytesPerIteration("h_update",
+                                            (3.0 + ndim)*indcs.nx1*sizeof(Real));
+
+      // allocate cell-averaged primitives and face states used with fourth-order fluxes
+      if (fourth_order) {
+        Kokkos::realloc(w4,  nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+        Kokkos::realloc(wl4, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+        Kokkos::realloc(wr4, nmb, (nhydro+nscalars), ncells3, ncells2, ncells1);
+      }
+
       // allocate array of flags used with FOFC
       if (use_fofc) {
         Kokkos::realloc(fofc,  nmb, ncells3, ncells2, ncells1);
-        Kokkos::realloc(utest, nmb, nhydro, ncells3, ncells2, ncells1);
+        if (fofc_list) {
+          Kokkos::realloc(fofc_idx, nmb*ncells3*ncells2*ncells1);
+          Kokkos::realloc(fofc_nidx, 1);
+        }
+        // utest is taken from pmy_pack->scratch when needed in FOFC
       }
     }
   }
@@ -32,6 +32,9 @@ enum class Hydro_RSolver {advect, llf, hlle, hllc, roe,    // non-relativistic
                           llf_sr, hlle_sr, hllc_sr,        // SR
                           llf_gr, hlle_gr};                // GR
 
+// constants that enumerate super-time-stepping integrators for diffusion terms
+enum class STS_Integrator {none, rkl1, rkl2};
+
 //----------------------------------------------------------------------------------------
 //! \struct HydroTaskIDs
 //  \brief container to hold TaskIDs of all hydro tasks
@@ -53,10 +56,24 @@ struct HydroTaskIDs {
   TaskID recvu_shr;
   TaskID bcs;
   TaskID prol;
+  TaskID c2pa;
   TaskID c2p;
   TaskID newdt;
   TaskID csend;
   TaskID crecv;
+  TaskID sts_irecv;
+  TaskID sts_flux;
+  TaskID sts_sendf;
+  TaskID sts_recvf;
+  TaskID sts_updt;
+  TaskID sts_restu;
+  TaskID sts_sendu;
+  TaskID sts_recvu;
+  TaskID sts_bcs;
+  TaskID sts_prol;
+  TaskID sts_c2p;
+  TaskID sts_csend;
+  TaskID sts_crecv;
 };
 
 namespace hydro {
@@ -71,6 +88,8 @@ class Hydro {
 
   // data
   ReconstructionMethod recon_method;
+  bool char_recon = false;  // reconstruct in characteristic variables
+  Real hybrid_thresh = 0.0; // shock sensor threshold of hybrid WENO-Z (0: WENO-Z only)
   Hydro_RSolver rsolver_method;
   EquationOfState *peos;  // chosen EOS
 
@@ -102,7 +121,43 @@ class Hydro {
   // following used for FOFC
   DvceArray4D<bool> fofc;  // flag for each cell to indicate if FOFC is needed
   bool use_fofc = false;   // flag to enable FOFC
-  DvceArray5D<Real> utest;  // scratch array for FOFC
+  DvceArray5D<Real> utest;  // FOFC temporary (view into pack scratch arena)
+  // flag to find FOFC cells during RK update, and compact list (and length) of flagged
+  // cells to which the LLF correction is applied
+  bool fofc_list = false;
+  DvceArray1D<int> fofc_idx;
+  DvceArray1D<int> fofc_nidx;
+
+  // flag to overlap C2P in active cells with communication of ghost zones
+  bool split_c2p = false;
+  // flag set when U is communicated with radiation intensities in stage task lists
+  bool coalesced_u = false;
+  // flag to compute x1-fluxes in scratch and update u0 in the same kernel, and number of
+  // MBs in cache-sized sub-packs over which flux kernels are run (0 for all MBs at once).
+  // Sub-packs are intended for CPUs, on which they keep x2/x3-fluxes in cache.
+  bool fused_update = false;
+  int nmb_subpack = 0;
+  // size of tiles in x2/x3 over which all fluxes are computed from one copy of w0 in
+  // scratch (0 for separate sweeps in each direction), and scratch level used for them
+  int flux_tile = 0;
+  int flux_tile_scr_level = 0;
+  // flag to compute new timestep in the C2P kernel on the last stage of each cycle
+  bool fused_newdt = false;
+  // flag to compute fourth-order face-averaged fluxes, and cell-averaged primitives and
+  // face-averaged L/R states used to compute them (face states also store the corrected
+  // fluxes before they are copied into uflx)
+  bool fourth_order = false;
+  DvceArray5D<Real> w4, wl4, wr4;
+  // number of passive scalars per chunk in separate scalar flux kernels (0 to compute
+  // scalar fluxes with hydro fluxes), and reconstruction method used for scalars
+  int scalar_chunk = 0;
+  ReconstructionMethod scalar_recon;
+  // super-time-stepping (RKL1/RKL2) integrator for viscous and heat fluxes, number of
+  // STS sub-stages in current cycle, and registers for initial state Y0, state Y_{j-2},
+  // and divergence of diffusive fluxes of Y0
+  STS_Integrator sts_integrator = STS_Integrator::none;
+  int nsts = 0;
+  DvceArray5D<Real> u_sts0, u_sts1, m_sts0;
 
   // container to hold names of TaskIDs
   HydroTaskIDs id;
@@ -128,20 +183,48 @@ class Hydro {
   TaskStatus ApplyPhysicalBCs(Driver* pdrive, int stage);
   TaskStatus Prolongate(Driver* pdrive, int stage);
   TaskStatus ConToPrim(Driver *d, int stage);
+  TaskStatus ConToPrimActive(Driver *d, int stage);
+  TaskStatus ConToPrimGhost(Driver *d, int stage);
   TaskStatus NewTimeStep(Driver *d, int stage);
+  void SetNewTimeStepFromC2P();
   // ...in "after_stagen_tl" list
   TaskStatus ClearSend(Driver *d, int stage);
   TaskStatus ClearRecv(Driver *d, int stage);  // also in Driver::Initialize
-
-  // CalculateFluxes function templated over Riemann Solvers
+  // ...in "before_sts", "sts", and "after_sts" lists (stage is index of STS sub-stage)
+  int SetSTSStages(const Real dt, const Real dt_diff);
+  TaskStatus STSInitRecv(Driver *d, int stage);
+  TaskStatus STSFluxes(Driver *d, int stage);
+  TaskStatus STSUpdate(Driver *d, int stage);
+  TaskStatus STSConToPrim(Driver *d, int stage);
+  TaskStatus STSClearSend(Driver *d, int stage);
+  TaskStatus STSClearRecv(Driver *d, int stage);
+
+  // CalculateFluxes function templated over Riemann Solvers, which calls kernels that are
+  // also templated over reconstruction method
   template <Hydro_RSolver T>
-  void CalculateFluxes(Driver *d, int stage);
+  void CalculateFluxes(Driver *d, int stage, int mbas, int mbae);
+  template <Hydro_RSolver T, ReconstructionMethod R>
+  void CalculateFluxesRecon(Driver *d, int stage, int mbas, int mbae);
+  template <Hydro_RSolver T, ReconstructionMethod R>
+  void CalculateFluxesTiled(int mbas, int mbae);
+  template <Hydro_RSolver T, ReconstructionMethod R>
+  void CalculateFluxesFourthOrder(int mbas, int mbae);
+  // fluxes of passive scalars computed separately from mass fluxes, in chunks of scalars
+  void CalculateScalarFluxes(int mbas, int mbae);
+  template <ReconstructionMethod R>
+  void CalculateScalarFluxesRecon(int mbas, int mbae);
+  // explicit RK update over MBs with indices [mbas,mbae] in MeshBlock::mb_active
+  void ExpRKUpdate(Driver *d, int stage, int mbas, int mbae);
+  // explicit RK update that also flags cells for FOFC, returns number of flagged cells
+  int ExpRKUpdateFlagFOFC(Driver *d, int stage);
 
   // first-order flux correction
   void FOFC(Driver *d, int stage);
+  void FOFCList(Driver *d, int stage, int nflag);
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
+  bool dtnew_from_c2p_ = false;  // set when dtnew was computed in last call to C2P
 };
 
 } // namespace hydro
@@ -17,6 +17,8 @@
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
 #include "reconstruct/wenoz.hpp"
+#include "reconstruct/mp5.hpp"
+#include "reconstruct/characteristic.hpp"
 #include "hydro/rsolvers/advect_hyd.hpp"
 #include "hydro/rsolvers/llf_hyd.hpp"
 #include "hydro/rsolvers/hlle_hyd.hpp"
@@ -29,38 +31,176 @@
 #include "hydro/rsolvers/hlle_grhyd.hpp"
 
 namespace hydro {
+namespace {
+// Allows Riemann solvers, which index fluxes as flx(m,n,k,j,i), to write fluxes along a
+// single row of cells directly into a 2D (n,i) team scratch array.
+struct ScrRowFlux {
+  ScrArray2D<Real> a;
+  KOKKOS_INLINE_FUNCTION
+  Real& operator()(const int, const int n, const int, const int, const int i) const {
+    return a(n,i);
+  }
+};
+
+// Allows reconstruction functions, which index primitives as q(m,n,k,j,i), to read from a
+// tile of primitives stored in a 4D (n,k,j,i) team scratch array with origin (k0,j0).
+// Only extent 1 (number of variables) is queried by the reconstruction functions.
+struct ScrTile {
+  ScrArray4D<Real> a;
+  int k0, j0;
+  KOKKOS_INLINE_FUNCTION
+  Real& operator()(const int, const int n, const int k, const int j, const int i) const {
+    return a(n,k-k0,j-j0,i);
+  }
+  KOKKOS_INLINE_FUNCTION
+  int extent_int(const int r) const {return (r == 1)? a.extent_int(0) : 1;}
+};
+
+// Allows reconstruction functions, which index primitives as q(m,n,k,j,i) and loop over
+// extent 1, to read only the nvar variables in w0 starting at index n0.
+struct VarRange {
+  DvceArray5D<Real> a;
+  int n0, nvar;
+  KOKKOS_INLINE_FUNCTION
+  Real& operator()(const int m, const int n, const int k, const int j,
+                   const int i) const {
+    return a(m,n0+n,k,j,i);
+  }
+  KOKKOS_INLINE_FUNCTION
+  int extent_int(const int r) const {return (r == 1)? nvar : a.extent_int(r);}
+};
+
+// Calls the Riemann solver selected by the template parameter
+template <Hydro_RSolver rsolver_method_, typename FlxArray>
+KOKKOS_INLINE_FUNCTION
+void RiemannSolve(TeamMember_t const &member, const EOS_Data &eos,
+     const RegionIndcs &indcs,const DualArray1D<RegionSize> &size,const CoordData &coord,
+     const int m, const int k, const int j, const int il, const int iu, const int ivx,
+     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, const FlxArray &flx) {
+  if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
+    Advect(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
+    LLF(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
+    HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
+    HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
+    Roe(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
+    LLF_SR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
+    HLLE_SR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
+    HLLC_SR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
+    LLF_GR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
+    HLLE_GR(member, eos, indcs, size, coord, m, k, j, il, iu, ivx, wl, wr, flx);
+  }
+}
+
+// Reconstructs L/R states of cells [il,iu] in direction dir (1,2,3) with the method
+// selected by the template parameter, storing them as the X1/X2/X3 wrapper functions of
+// each method do.
+template <ReconstructionMethod recon_method_, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void ReconstructDir(TeamMember_t const &member, const EOS_Data &eos, const bool charac,
+     const int dir, const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
+  if (dir == 1) {
+    if (charac) {
+      CharacteristicX1<recon_method_>(member, eos, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+      DonorCellX1(member, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+      PiecewiseLinearX1(member, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                         recon_method_ == ReconstructionMethod::ppmx) {
+      PiecewiseParabolicX1(member, eos, extrema, true, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+      WENOZX1(member, eos, true, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+      MP5X1(member, eos, true, m, k, j, il, iu, q, ql, qr);
+    }
+  } else if (dir == 2) {
+    if (charac) {
+      CharacteristicX2<recon_method_>(member, eos, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+      DonorCellX2(member, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+      PiecewiseLinearX2(member, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                         recon_method_ == ReconstructionMethod::ppmx) {
+      PiecewiseParabolicX2(member, eos, extrema, true, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+      WENOZX2(member, eos, true, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+      MP5X2(member, eos, true, m, k, j, il, iu, q, ql, qr);
+    }
+  } else {
+    if (charac) {
+      CharacteristicX3<recon_method_>(member, eos, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+      DonorCellX3(member, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+      PiecewiseLinearX3(member, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                         recon_method_ == ReconstructionMethod::ppmx) {
+      PiecewiseParabolicX3(member, eos, extrema, true, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+      WENOZX3(member, eos, true, m, k, j, il, iu, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+      MP5X3(member, eos, true, m, k, j, il, iu, q, ql, qr);
+    }
+  }
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
-//! \fn void Hydro::CalculateFluxes
+//! \fn void Hydro::CalculateFluxesRecon
 //! \brief Calls reconstruction and Riemann solver functions to compute hydro fluxes
-//! Note this function is templated over RS for better performance on GPUs.
+//! in MBs with indices [mbas,mbae] in the list of active MBs (MeshBlock::mb_active).
+//! Note this function is templated over RS and reconstruction method for better
+//! performance on GPUs.
+
+template <Hydro_RSolver rsolver_method_, ReconstructionMethod recon_method_>
+void Hydro::CalculateFluxesRecon(Driver *pdriver, int stage, int mbas, int mbae) {
+  if (flux_tile > 0) {
+    CalculateFluxesTiled<rsolver_method_, recon_method_>(mbas, mbae);
+    return;
+  }
+  if (fourth_order) {
+    CalculateFluxesFourthOrder<rsolver_method_, recon_method_>(mbas, mbae);
+    return;
+  }
 
-template <Hydro_RSolver rsolver_method_>
-void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
   RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
   int is = indcs_.is, ie = indcs_.ie;
   int js = indcs_.js, je = indcs_.je;
   int ks = indcs_.ks, ke = indcs_.ke;
-  int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
+  int ncells1 = SimdPadded(indcs_.nx1 + 2*(indcs_.ng));  // length of scratch rows
 
   int &nhyd_  = nhydro;
-  int nvars = nhydro + nscalars;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-  const auto recon_method_ = recon_method;
-  bool extrema = false;
-  if (recon_method == ReconstructionMethod::ppmx) {
-    extrema = true;
-  }
+  // scalars are excluded from these kernels when computed in CalculateScalarFluxes()
+  int nvars = (scalar_chunk > 0)? nhydro : (nhydro + nscalars);
+  // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+  auto &mbact = pmy_pack->pmb->mb_active;
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
+  const bool charac = char_recon;
+  const Real hybrid_ = hybrid_thresh;
 
   auto &eos_ = peos->eos_data;
   auto &size_ = pmy_pack->pmb->mb_size;
   auto &coord_ = pmy_pack->pcoord->coord_data;
-  auto &w0_ = w0;
+  VarRange w0_{w0, 0, nvars};
 
   //--------------------------------------------------------------------------------------
   // i-direction
 
   size_t scr_size = ScrArray2D<Real>::shmem_size(nvars, ncells1) * 2;
-  int scr_level = 0;
+  int scr_level = global_variable::scratch_level;
   auto &flx1_ = uflx.x1f;
 
   // set the loop limits for 1D/2D/3D problems
@@ -74,75 +214,77 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
     }
   }
 
-  par_for_outer("hflux_x1",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku, jl, ju,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
-    ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
-    ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
+  // with fused flux and update kernels, x1-fluxes are computed at the end (see below)
+  if (!(fused_update)) {
+    par_for_outer("hflux_x1",DevExeSpace(), scr_size, scr_level, mbas, mbae, kl, ku,
+                  jl, ju,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k, const int j) {
+      const int m = mbact.d_view(mm);
+      ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
+      ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
 
-    // Reconstruct qR[i] and qL[i+1]
-    switch (recon_method_) {
-      case ReconstructionMethod::dc:
+      // Reconstruct qR[i] and qL[i+1]
+      if (charac) {
+        CharacteristicX1<recon_method_>(member, eos_, m, k, j, il-1, iu, w0_, wl, wr);
+      } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
         DonorCellX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        break;
-      case ReconstructionMethod::plm:
+      } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
         PiecewiseLinearX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        break;
-      case ReconstructionMethod::ppm4:
-      case ReconstructionMethod::ppmx:
+      } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                           recon_method_ == ReconstructionMethod::ppmx) {
         PiecewiseParabolicX1(member,eos_,extrema,true, m, k, j, il-1, iu, w0_, wl, wr);
-        break;
-      case ReconstructionMethod::wenoz:
-        WENOZX1(member, eos_, true, m, k, j, il-1, iu, w0_, wl, wr);
-        break;
-      default:
-        break;
-    }
-    // Sync all threads in the team so that scratch memory is consistent
-    member.team_barrier();
+      } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+        WENOZHybridX1(member, eos_, true, hybrid_, m, k, j, il-1, iu, w0_, w0_, wl, wr);
+      } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+        MP5X1(member, eos_, true, m, k, j, il-1, iu, w0_, wl, wr);
+      }
+      // Sync all threads in the team so that scratch memory is consistent
+      member.team_barrier();
 
-    // compute fluxes over [is,ie+1]
-    // NOTE(@pdmullen): Capture variables prior to if constexpr.  Required for cuda 11.6+.
-    auto eos = eos_;
-    auto indcs = indcs_;
-    auto size = size_;
-    auto coord = coord_;
-    auto flx1 = flx1_;
-    if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
-      Advect(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
-      LLF(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
-      HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
-      HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
-      Roe(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
-      LLF_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
-      HLLE_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
-      HLLC_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
-      LLF_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
-      HLLE_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
-    }
-    member.team_barrier();
+      // compute fluxes over [is,ie+1]
+      // NOTE(@pdmullen): Capture variables prior to if constexpr. Required for cuda 11.6+
+      auto eos = eos_;
+      auto indcs = indcs_;
+      auto size = size_;
+      auto coord = coord_;
+      auto flx1 = flx1_;
+      if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
+        Advect(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
+        LLF(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
+        HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
+        HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
+        Roe(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
+        LLF_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
+        HLLE_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
+        HLLC_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
+        LLF_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
+        HLLE_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      }
+      member.team_barrier();
 
-    // calculate fluxes of scalars (if any)
-    if (nvars > nhyd_) {
-      for (int n=nhyd_; n<nvars; ++n) {
-        par_for_inner(member, is, ie+1, [&](const int i) {
-          if (flx1_(m,IDN,k,j,i) >= 0.0) {
-            flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wl(n,i);
-          } else {
-            flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wr(n,i);
-          }
-        });
+      // calculate fluxes of scalars (if any)
+      if (nvars > nhyd_) {
+        for (int n=nhyd_; n<nvars; ++n) {
+          par_for_inner(member, is, ie+1, [&](const int i) {
+            if (flx1_(m,IDN,k,j,i) >= 0.0) {
+              flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wl(n,i);
+            } else {
+              flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wr(n,i);
+            }
+          });
+        }
       }
-    }
-  });
+    });
+  }
 
   //--------------------------------------------------------------------------------------
   // j-direction
@@ -162,8 +304,9 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
       }
     }
 
-    par_for_outer("hflux_x2",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+    par_for_outer("hflux_x2",DevExeSpace(), scr_size, scr_level, mbas, mbae, kl, ku,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k) {
+      const int m = mbact.d_view(mm);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -179,22 +322,20 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         }
 
         // Reconstruct qR[j] and qL[j+1]
-        switch (recon_method_) {
-          case ReconstructionMethod::dc:
-            DonorCellX2(member, m, k, j, il, iu, w0_, wl_jp1, wr);
-            break;
-          case ReconstructionMethod::plm:
-            PiecewiseLinearX2(member, m, k, j, il, iu, w0_, wl_jp1, wr);
-            break;
-          case ReconstructionMethod::ppm4:
-          case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX2(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_jp1, wr);
-            break;
-          case ReconstructionMethod::wenoz:
-            WENOZX2(member, eos_, true, m, k, j, il, iu, w0_, wl_jp1, wr);
-            break;
-          default:
-            break;
+        if (charac) {
+          CharacteristicX2<recon_method_>(member, eos_, m, k, j, il, iu, w0_, wl_jp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+          DonorCellX2(member, m, k, j, il, iu, w0_, wl_jp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+          PiecewiseLinearX2(member, m, k, j, il, iu, w0_, wl_jp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                             recon_method_ == ReconstructionMethod::ppmx) {
+          PiecewiseParabolicX2(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_jp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+          WENOZHybridX2(member, eos_, true, hybrid_, m, k, j, il, iu, w0_, w0_,
+                        wl_jp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+          MP5X2(member, eos_, true, m, k, j, il, iu, w0_, wl_jp1, wr);
         }
         member.team_barrier();
 
@@ -257,8 +398,9 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
     il = is, iu = ie, jl = js, ju = je, kl = ks-1, ku = ke+1;
     if (use_fofc) { il = is-1, iu = ie+1, jl = js-1, ju = je+1, kl = ks-2, ku = ke+2; }
 
-    par_for_outer("hflux_x3",DevExeSpace(), scr_size, scr_level, 0, nmb1, jl, ju,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int j) {
+    par_for_outer("hflux_x3",DevExeSpace(), scr_size, scr_level, mbas, mbae, jl, ju,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int j) {
+      const int m = mbact.d_view(mm);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -274,22 +416,20 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
         }
 
         // Reconstruct qR[k] and qL[k+1]
-        switch (recon_method_) {
-          case ReconstructionMethod::dc:
-            DonorCellX3(member, m, k, j, il, iu, w0_, wl_kp1, wr);
-            break;
-          case ReconstructionMethod::plm:
-            PiecewiseLinearX3(member, m, k, j, il, iu, w0_, wl_kp1, wr);
-            break;
-          case ReconstructionMethod::ppm4:
-          case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX3(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_kp1, wr);
-            break;
-          case ReconstructionMethod::wenoz:
-            WENOZX3(member, eos_, true, m, k, j, il, iu, w0_, wl_kp1, wr);
-            break;
-          default:
-            break;
+        if (charac) {
+          CharacteristicX3<recon_method_>(member, eos_, m, k, j, il, iu, w0_, wl_kp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+          DonorCellX3(member, m, k, j, il, iu, w0_, wl_kp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+          PiecewiseLinearX3(member, m, k, j, il, iu, w0_, wl_kp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                             recon_method_ == ReconstructionMethod::ppmx) {
+          PiecewiseParabolicX3(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_kp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+          WENOZHybridX3(member, eos_, true, hybrid_, m, k, j, il, iu, w0_, w0_,
+                        wl_kp1, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+          MP5X3(member, eos_, true, m, k, j, il, iu, w0_, wl_kp1, wr);
         }
         member.team_barrier();
 
@@ -341,19 +481,852 @@ void Hydro::CalculateFluxes(Driver *pdriver, int stage) {
     });
   }
 
+  //--------------------------------------------------------------------------------------
+  // i-direction fused with RK update.  x1-fluxes are computed into team scratch, and the
+  // divergence of the fluxes in all directions is added to u0 directly, so x1-fluxes are
+  // never written to (or read back from) global memory.  Only used when the update of
+  // each MB depends only on its own fluxes (see Hydro constructor).
+
+  if (fused_update) {
+    scr_size = ScrArray2D<Real>::shmem_size(nvars, ncells1) * 3;
+    Real &gam0 = pdriver->gam0[stage-1];
+    Real &gam1 = pdriver->gam1[stage-1];
+    Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+    bool &multi_d = pmy_pack->pmesh->multi_d;
+    bool &three_d = pmy_pack->pmesh->three_d;
+    auto u0_ = u0;
+    auto u1_ = u1;
+    auto &flx2_ = uflx.x2f;
+    auto &flx3_ = uflx.x3f;
+    il = is, iu = ie+1;
+
+    par_for_outer("hflux_x1_upd",DevExeSpace(), scr_size, scr_level, mbas, mbae, ks, ke,
+                  js, je,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k, const int j) {
+      const int m = mbact.d_view(mm);
+      ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
+      ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
+      ScrArray2D<Real> fx(member.team_scratch(scr_level), nvars, ncells1);
+
+      // Reconstruct qR[i] and qL[i+1]
+      if (charac) {
+        CharacteristicX1<recon_method_>(member, eos_, m, k, j, il-1, iu, w0_, wl, wr);
+      } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+        DonorCellX1(member, m, k, j, il-1, iu, w0_, wl, wr);
+      } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+        PiecewiseLinearX1(member, m, k, j, il-1, iu, w0_, wl, wr);
+      } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                           recon_method_ == ReconstructionMethod::ppmx) {
+        PiecewiseParabolicX1(member,eos_,extrema,true, m, k, j, il-1, iu, w0_, wl, wr);
+      } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+        WENOZHybridX1(member, eos_, true, hybrid_, m, k, j, il-1, iu, w0_, w0_, wl, wr);
+      } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+        MP5X1(member, eos_, true, m, k, j, il-1, iu, w0_, wl, wr);
+      }
+      // Sync all threads in the team so that scratch memory is consistent
+      member.team_barrier();
+
+      // compute fluxes over [is,ie+1] into scratch
+      // NOTE(@pdmullen): Capture variables prior to if constexpr. Required for cuda 11.6+
+      auto eos = eos_;
+      auto indcs = indcs_;
+      auto size = size_;
+      auto coord = coord_;
+      ScrRowFlux flx1{fx};
+      if constexpr (rsolver_method_ == Hydro_RSolver::advect) {
+        Advect(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::llf) {
+        LLF(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle) {
+        HLLE(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc) {
+        HLLC(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::roe) {
+        Roe(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_sr) {
+        LLF_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_sr) {
+        HLLE_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hllc_sr) {
+        HLLC_SR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::llf_gr) {
+        LLF_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      } else if constexpr (rsolver_method_ == Hydro_RSolver::hlle_gr) {
+        HLLE_GR(member, eos, indcs, size, coord, m, k, j, il, iu, IVX, wl, wr, flx1);
+      }
+      member.team_barrier();
+
+      // calculate fluxes of scalars (if any)
+      if (nvars > nhyd_) {
+        for (int n=nhyd_; n<nvars; ++n) {
+          par_for_inner(member, is, ie+1, [&](const int i) {
+            if (fx(IDN,i) >= 0.0) {
+              fx(n,i) = fx(IDN,i)*wl(n,i);
+            } else {
+              fx(n,i) = fx(IDN,i)*wr(n,i);
+            }
+          });
+        }
+        member.team_barrier();
+      }
+
+      // update conserved variables.  Flux differences are summed in the same order as in
+      // Hydro::ExpRKUpdate() so results are identical to the unfused kernels.
+      for (int n=0; n<nvars; ++n) {
+        par_for_inner(member, is, ie, [&](const int i) {
+          Real divf = (fx(n,i+1) - fx(n,i))/size_.d_view(m).dx1;
+          if (multi_d) {
+            divf += (flx2_(m,n,k,j+1,i) - flx2_(m,n,k,j,i))/size_.d_view(m).dx2;
+          }
+          if (three_d) {
+            divf += (flx3_(m,n,k+1,j,i) - flx3_(m,n,k,j,i))/size_.d_view(m).dx3;
+          }
+          u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(m,n,k,j,i) - beta_dt*divf;
+        });
+      }
+    });
+  }
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateFluxesTiled
+//! \brief Computes hydro fluxes in all directions over tiles of nx1 x flux_tile x
+//! flux_tile cells.  Primitives in each tile and its ghost zones are loaded into team
+//! scratch once, and then reconstruction in every direction reads from this copy rather
+//! than reloading w0 from global memory in three separate sweeps.  Most useful with wide
+//! stencils (PPM, WENOZ).  Not compatible with FOFC, which needs fluxes in ghost zones.
+//! Each team needs nvars*(flux_tile+2*ng)^2*ncells1 Reals of scratch in 3D (with one
+//! factor of flux_tile+2*ng in 2D) plus three rows of nvars*ncells1.  For nx1=32 in
+//! double precision with 48 KB of level-0 scratch on GPUs, flux_tile up to 16 fits in
+//! 2D, but in 3D only flux_tile=1 with nghost=2 fits.  Larger tiles use scratch level 1,
+//! which is selected in the Hydro constructor (which aborts if even that is too small).
+
+template <Hydro_RSolver rsolver_method_, ReconstructionMethod recon_method_>
+void Hydro::CalculateFluxesTiled(int mbas, int mbae) {
+  RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
+  int is = indcs_.is, ie = indcs_.ie;
+  int js = indcs_.js, je = indcs_.je;
+  int ks = indcs_.ks, ke = indcs_.ke;
+  int ng = indcs_.ng;
+  int nc1 = indcs_.nx1 + 2*ng;
+  int ncells1 = SimdPadded(nc1);  // length of scratch rows
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  int &nhyd_  = nhydro;
+  int nvars = nhydro + nscalars;
+  auto &mbact = pmy_pack->pmb->mb_active;
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
+  const bool charac = char_recon;
+  const Real hybrid_ = hybrid_thresh;
+
+  auto &eos_ = peos->eos_data;
+  auto &size_ = pmy_pack->pmb->mb_size;
+  auto &coord_ = pmy_pack->pcoord->coord_data;
+  auto &w0_ = w0;
+  auto &flx1_ = uflx.x1f;
+  auto &flx2_ = uflx.x2f;
+  auto &flx3_ = uflx.x3f;
+
+  // size of tiles, and number of ghost cells loaded on each side, in x2 and x3
+  int tj = (multi_d)? flux_tile : 1;
+  int tk = (three_d)? flux_tile : 1;
+  int gj = (multi_d)? ng : 0;
+  int gk = (three_d)? ng : 0;
+  int ntj = indcs_.nx2/tj;
+  int ntk = indcs_.nx3/tk;
+  int nbj = tj + 2*gj;
+  int nbk = tk + 2*gk;
+
+  size_t scr_size = ScrArray4D<Real>::shmem_size(nvars, nbk, nbj, ncells1) +
+                    ScrArray2D<Real>::shmem_size(nvars, ncells1) * 3;
+  int scr_level = flux_tile_scr_level;
+
+  par_for_outer("hflux_tile",DevExeSpace(), scr_size, scr_level, mbas, mbae, 0, (ntk-1),
+                0, (ntj-1),
+  KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int kt, const int jt) {
+    const int m = mbact.d_view(mm);
+    const int k0 = ks + kt*tk, k1 = k0 + tk - 1;
+    const int j0 = js + jt*tj, j1 = j0 + tj - 1;
+    ScrArray4D<Real> tile(member.team_scratch(scr_level), nvars, nbk, nbj, ncells1);
+    ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
+    ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
+
+    // load primitives in tile and its ghost zones into scratch
+    const int nji = nbj*nc1;
+    const int nkji = nbk*nji;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(member, nvars*nkji),
+    [&](const int idx) {
+      int n = idx/nkji;
+      int k = (idx - n*nkji)/nji;
+      int j = (idx - n*nkji - k*nji)/nc1;
+      int i = (idx - n*nkji - k*nji - j*nc1);
+      tile(n,k,j,i) = w0_(m,n,(k0-gk+k),(j0-gj+j),i);
+    });
+    member.team_barrier();
+    ScrTile q{tile, (k0-gk), (j0-gj)};
+
+    //---- i-direction: fluxes over [is,ie+1] in each row of the tile
+    for (int k=k0; k<=k1; ++k) {
+      for (int j=j0; j<=j1; ++j) {
+        auto wl = scr1;
+        auto wr = scr2;
+        if (charac) {
+          CharacteristicX1<recon_method_>(member, eos_, m, k, j, is-1, ie+1, q, wl, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+          DonorCellX1(member, m, k, j, is-1, ie+1, q, wl, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+          PiecewiseLinearX1(member, m, k, j, is-1, ie+1, q, wl, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                             recon_method_ == ReconstructionMethod::ppmx) {
+          PiecewiseParabolicX1(member,eos_,extrema,true,m,k,j,is-1,ie+1, q, wl, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+          WENOZHybridX1(member, eos_, true, hybrid_, m, k, j, is-1, ie+1, q, q, wl, wr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+          MP5X1(member, eos_, true, m, k, j, is-1, ie+1, q, wl, wr);
+        }
+        member.team_barrier();
+
+        RiemannSolve<rsolver_method_>(member, eos_, indcs_, size_, coord_, m, k, j,
+                                      is, ie+1, IVX, wl, wr, flx1_);
+        member.team_barrier();
+
+        // calculate fluxes of scalars (if any)
+        if (nvars > nhyd_) {
+          for (int n=nhyd_; n<nvars; ++n) {
+            par_for_inner(member, is, ie+1, [&](const int i) {
+              if (flx1_(m,IDN,k,j,i) >= 0.0) {
+                flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wl(n,i);
+              } else {
+                flx1_(m,n,k,j,i) = flx1_(m,IDN,k,j,i)*wr(n,i);
+              }
+            });
+          }
+        }
+        member.team_barrier();
+      }
+    }
+
+    //---- j-direction: fluxes over [j0,j1], plus je+1 in last tile
+    if (multi_d) {
+      int jl = j0-1, ju = (j1 == je)? (je+1) : j1;
+      for (int k=k0; k<=k1; ++k) {
+        for (int j=jl; j<=ju; ++j) {
+          // Permute scratch arrays.
+          auto wl     = scr1;
+          auto wl_jp1 = scr2;
+          auto wr     = scr3;
+          if ((j%2) == 0) {
+            wl     = scr2;
+            wl_jp1 = scr1;
+          }
+
+          // Reconstruct qR[j] and qL[j+1]
+          if (charac) {
+            CharacteristicX2<recon_method_>(member, eos_, m, k, j, is, ie, q, wl_jp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+            DonorCellX2(member, m, k, j, is, ie, q, wl_jp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+            PiecewiseLinearX2(member, m, k, j, is, ie, q, wl_jp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                               recon_method_ == ReconstructionMethod::ppmx) {
+            PiecewiseParabolicX2(member,eos_,extrema,true,m,k,j,is,ie, q, wl_jp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+            WENOZHybridX2(member, eos_, true, hybrid_, m, k, j, is, ie, q, q, wl_jp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+            MP5X2(member, eos_, true, m, k, j, is, ie, q, wl_jp1, wr);
+          }
+          member.team_barrier();
+
+          // compute fluxes at face j.  RS returns flux in input wr array
+          if (j>jl) {
+            RiemannSolve<rsolver_method_>(member, eos_, indcs_, size_, coord_, m, k, j,
+                                          is, ie, IVY, wl, wr, flx2_);
+            member.team_barrier();
+
+            // calculate fluxes of scalars (if any)
+            if (nvars > nhyd_) {
+              for (int n=nhyd_; n<nvars; ++n) {
+                par_for_inner(member, is, ie, [&](const int i) {
+                  if (flx2_(m,IDN,k,j,i) >= 0.0) {
+                    flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wl(n,i);
+                  } else {
+                    flx2_(m,n,k,j,i) = flx2_(m,IDN,k,j,i)*wr(n,i);
+                  }
+                });
+              }
+            }
+            member.team_barrier();
+          }
+        }
+      }
+    }
+
+    //---- k-direction: fluxes over [k0,k1], plus ke+1 in last tile
+    if (three_d) {
+      int kl = k0-1, ku = (k1 == ke)? (ke+1) : k1;
+      for (int j=j0; j<=j1; ++j) {
+        for (int k=kl; k<=ku; ++k) {
+          // Permute scratch arrays.
+          auto wl     = scr1;
+          auto wl_kp1 = scr2;
+          auto wr     = scr3;
+          if ((k%2) == 0) {
+            wl     = scr2;
+            wl_kp1 = scr1;
+          }
+
+          // Reconstruct qR[k] and qL[k+1]
+          if (charac) {
+            CharacteristicX3<recon_method_>(member, eos_, m, k, j, is, ie, q, wl_kp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+            DonorCellX3(member, m, k, j, is, ie, q, wl_kp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+            PiecewiseLinearX3(member, m, k, j, is, ie, q, wl_kp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                               recon_method_ == ReconstructionMethod::ppmx) {
+            PiecewiseParabolicX3(member,eos_,extrema,true,m,k,j,is,ie, q, wl_kp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+            WENOZHybridX3(member, eos_, true, hybrid_, m, k, j, is, ie, q, q, wl_kp1, wr);
+          } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+            MP5X3(member, eos_, true, m, k, j, is, ie, q, wl_kp1, wr);
+          }
+          member.team_barrier();
+
+          // compute fluxes at face k.  RS returns flux in input wr array
+          if (k>kl) {
+            RiemannSolve<rsolver_method_>(member, eos_, indcs_, size_, coord_, m, k, j,
+                                          is, ie, IVZ, wl, wr, flx3_);
+            member.team_barrier();
+
+            // calculate fluxes of scalars (if any)
+            if (nvars > nhyd_) {
+              for (int n=nhyd_; n<nvars; ++n) {
+                par_for_inner(member, is, ie, [&](const int i) {
+                  if (flx3_(m,IDN,k,j,i) >= 0.0) {
+                    flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wl(n,i);
+                  } else {
+                    flx3_(m,n,k,j,i) = flx3_(m,IDN,k,j,i)*wr(n,i);
+                  }
+                });
+              }
+            }
+            member.team_barrier();
+          }
+        }
+      }
+    }
+  });
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateFluxesFourthOrder
+//! \brief Computes fourth-order accurate face-averaged hydro fluxes, enabled with
+//! <hydro>/fourth_order=true, following the finite-volume method of McCorquodale &
+//! Colella (2011) as implemented by Felker & Stone (2018).  Used with high-order
+//! reconstruction (PPM, WENOZ, MP5) and a fourth-order integrator (rk4, ssprk104), so
+//! that smooth flows reach a given accuracy with fewer cells than second-order fluxes:
+//!  (1) cell-averaged primitives are computed from cell-averaged conserved variables,
+//!      w4 = W(u0 - h^2 Lap(u0)/24) + h^2 Lap(w0)/24 ,
+//!  (2) face-averaged L/R states are reconstructed from w4 and stored in wl4/wr4,
+//!  (3) face-centered states wl4 - h^2 Lap_t(wl4)/24 are passed to the Riemann solver,
+//!      where Lap_t is the Laplacian transverse to the face, giving face-centered fluxes,
+//!  (4) face-averaged fluxes are F + h^2 Lap_t(F)/24 .
+//! Steps (1) and (3) fall back to the averaged values where they would give negative
+//! density or energy.  Steps (3) and (4) need states and fluxes on transverse ghost
+//! faces, so at least 4 ghost zones are required.  SMR/AMR prolongation and source
+//! terms remain second-order.
+
+template <Hydro_RSolver rsolver_method_, ReconstructionMethod recon_method_>
+void Hydro::CalculateFluxesFourthOrder(int mbas, int mbae) {
+  RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
+  int is = indcs_.is, ie = indcs_.ie;
+  int js = indcs_.js, je = indcs_.je;
+  int ks = indcs_.ks, ke = indcs_.ke;
+  int ng = indcs_.ng;
+  int ncells1 = SimdPadded(indcs_.nx1 + 2*ng);  // length of scratch rows
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  int &nhyd_  = nhydro;
+  // scalars are excluded from these kernels when computed in CalculateScalarFluxes()
+  int nvars = (scalar_chunk > 0)? nhydro : (nhydro + nscalars);
+  auto &mbact = pmy_pack->pmb->mb_active;
+  const bool charac = char_recon;
+
+  auto &eos_ = peos->eos_data;
+  auto &size_ = pmy_pack->pmb->mb_size;
+  auto &coord_ = pmy_pack->pcoord->coord_data;
+  const bool ideal = eos_.is_ideal;
+  auto &u0_ = u0;
+  auto &w0_ = w0;
+  auto &w4_ = w4;
+  auto &wl4_ = wl4;
+  auto &wr4_ = wr4;
+  // offsets of neighbors in x2/x3, zero in 1D/2D so that second differences vanish
+  const int dj = multi_d? 1 : 0;
+  const int dk = three_d? 1 : 0;
+
+  //--------------------------------------------------------------------------------------
+  // (1) cell-averaged primitives in all but the outermost layer of ghost cells
+
+  par_for("hflux4_prim", DevExeSpace(), mbas, mbae, ks-dk*(ng-1), ke+dk*(ng-1),
+          js-dj*(ng-1), je+dj*(ng-1), is-ng+1, ie+ng-1,
+  KOKKOS_LAMBDA(const int mm, const int k, const int j, const int i) {
+    const int m = mbact.d_view(mm);
+    // h^2 Lap(a)/24, with second differences summed in each direction
+    auto lap = [&](const DvceArray5D<Real> &a, const int n) {
+      Real a0 = 2.0*a(m,n,k,j,i);
+      return ((a(m,n,k,j,i+1) + a(m,n,k,j,i-1) - a0) +
+              (a(m,n,k,j+dj,i) + a(m,n,k,j-dj,i) - a0) +
+              (a(m,n,k+dk,j,i) + a(m,n,k-dk,j,i) - a0))/24.0;
+    };
+    Real d_pt = u0_(m,IDN,k,j,i) - lap(u0_,IDN);
+    Real m1_pt = u0_(m,IM1,k,j,i) - lap(u0_,IM1);
+    Real m2_pt = u0_(m,IM2,k,j,i) - lap(u0_,IM2);
+    Real m3_pt = u0_(m,IM3,k,j,i) - lap(u0_,IM3);
+    Real e_pt = 1.0;
+    if (ideal && d_pt > 0.0) {
+      e_pt = u0_(m,IEN,k,j,i) - lap(u0_,IEN) -
+             0.5*(SQR(m1_pt) + SQR(m2_pt) + SQR(m3_pt))/d_pt;
+    }
+    bool ok = (d_pt > 0.0) && (e_pt > 0.0);
+    if (ok) {
+      w4_(m,IDN,k,j,i) = d_pt + lap(w0_,IDN);
+      w4_(m,IVX,k,j,i) = m1_pt/d_pt + lap(w0_,IVX);
+      w4_(m,IVY,k,j,i) = m2_pt/d_pt + lap(w0_,IVY);
+      w4_(m,IVZ,k,j,i) = m3_pt/d_pt + lap(w0_,IVZ);
+      if (ideal) {w4_(m,IEN,k,j,i) = e_pt + lap(w0_,IEN);}
+      for (int n=nhyd_; n<nvars; ++n) {
+        w4_(m,n,k,j,i) = (u0_(m,n,k,j,i) - lap(u0_,n))/d_pt + lap(w0_,n);
+      }
+      ok = (w4_(m,IDN,k,j,i) > 0.0) && (!(ideal) || w4_(m,IEN,k,j,i) > 0.0);
+    }
+    if (!(ok)) {
+      for (int n=0; n<nvars; ++n) {
+        w4_(m,n,k,j,i) = w0_(m,n,k,j,i);
+      }
+    }
+  });
+  VarRange w4v{w4, 0, nvars};
+
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvars, ncells1) * 2;
+  int scr_level = global_variable::scratch_level;
+
+  for (int dir=1; dir<=3; ++dir) {
+    if ((dir == 2 && !(multi_d)) || (dir == 3 && !(three_d))) {continue;}
+    auto &flx_ = (dir == 1)? uflx.x1f : ((dir == 2)? uflx.x2f : uflx.x3f);
+    const int ivx = (dir == 1)? IVX : ((dir == 2)? IVY : IVZ);
+    // offset normal to faces, and offsets in the two transverse directions
+    const int nj = (dir == 2)? 1 : 0, nk = (dir == 3)? 1 : 0;
+    const int t1i = (dir == 1)? 0 : 1, t1j = (dir == 1)? dj : 0;
+    const int t2j = (dir == 3)? 1 : 0, t2k = (dir == 3)? 0 : dk;
+    // h^2 Lap_t(a)/24 at face (k,j,i)
+    auto lapt = KOKKOS_LAMBDA(const DvceArray5D<Real> &a, const int m, const int n,
+                              const int k, const int j, const int i) {
+      Real a0 = 2.0*a(m,n,k,j,i);
+      return ((a(m,n,k,j+t1j,i+t1i) + a(m,n,k,j-t1j,i-t1i) - a0) +
+              (a(m,n,k+t2k,j+t2j,i) + a(m,n,k-t2k,j-t2j,i) - a0))/24.0;
+    };
+    // faces on which averaged fluxes are needed, extended by one layer of faces in the
+    // transverse directions for face-centered fluxes, and two layers for states
+    int il = is, iu = ie + (dir == 1), jl = js, ju = je + nj, kl = ks, ku = ke + nk;
+    int ext_i = t1i, ext_j = t1j + t2j, ext_k = t2k;
+
+    // (2) face-averaged L/R states, reconstructed over cells adjacent to faces
+    par_for_outer("hflux4_recon", DevExeSpace(), scr_size, scr_level, mbas, mbae,
+                  kl-2*ext_k-nk, ku+2*ext_k, jl-2*ext_j-nj, ju+2*ext_j,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k, const int j) {
+      const int m = mbact.d_view(mm);
+      ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
+      ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
+      // cells [il-1,iu] give both states on x1-faces [il,iu]
+      int ril = il - 2*ext_i - (dir == 1), riu = iu + 2*ext_i;
+      ReconstructDir<recon_method_>(member, eos_, charac, dir, m, k, j, ril, riu, w4v,
+                                    wl, wr);
+      member.team_barrier();
+      for (int n=0; n<nvars; ++n) {
+        par_for_inner(member, il-2*ext_i, iu+2*ext_i, [&](const int i) {
+          if (dir == 1) {
+            wl4_(m,n,k,j,i) = wl(n,i);
+            wr4_(m,n,k,j,i) = wr(n,i);
+          } else {
+            wl4_(m,n,k+nk,j+nj,i) = wl(n,i);
+            wr4_(m,n,k,j,i) = wr(n,i);
+          }
+        });
+      }
+    });
+
+    // (3) face-centered fluxes from face-centered states
+    par_for_outer("hflux4_rsolve", DevExeSpace(), scr_size, scr_level, mbas, mbae,
+                  kl-ext_k, ku+ext_k, jl-ext_j, ju+ext_j,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k, const int j) {
+      const int m = mbact.d_view(mm);
+      ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
+      ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
+      par_for_inner(member, il-ext_i, iu+ext_i, [&](const int i) {
+        for (int n=0; n<nvars; ++n) {
+          wl(n,i) = wl4_(m,n,k,j,i) - lapt(wl4_, m, n, k, j, i);
+          wr(n,i) = wr4_(m,n,k,j,i) - lapt(wr4_, m, n, k, j, i);
+        }
+        if (wl(IDN,i) <= 0.0 || (ideal && wl(IEN,i) <= 0.0)) {
+          for (int n=0; n<nvars; ++n) {wl(n,i) = wl4_(m,n,k,j,i);}
+        }
+        if (wr(IDN,i) <= 0.0 || (ideal && wr(IEN,i) <= 0.0)) {
+          for (int n=0; n<nvars; ++n) {wr(n,i) = wr4_(m,n,k,j,i);}
+        }
+      });
+      member.team_barrier();
+
+      // NOTE(@pdmullen): Capture variables prior to if constexpr. Required for cuda 11.6+
+      auto eos = eos_;
+      auto indcs = indcs_;
+      auto size = size_;
+      auto coord = coord_;
+      auto flx = flx_;
+      RiemannSolve<rsolver_method_>(member, eos, indcs, size, coord, m, k, j, il-ext_i,
+                                    iu+ext_i, ivx, wl, wr, flx);
+      member.team_barrier();
+
+      // calculate fluxes of scalars (if any)
+      for (int n=nhyd_; n<nvars; ++n) {
+        par_for_inner(member, il-ext_i, iu+ext_i, [&](const int i) {
+          if (flx(m,IDN,k,j,i) >= 0.0) {
+            flx(m,n,k,j,i) = flx(m,IDN,k,j,i)*wl(n,i);
+          } else {
+            flx(m,n,k,j,i) = flx(m,IDN,k,j,i)*wr(n,i);
+          }
+        });
+      }
+    });
+
+    // (4) face-averaged fluxes, stored in wl4 and then copied into uflx
+    par_for("hflux4_avg", DevExeSpace(), mbas, mbae, 0, (nvars-1), kl, ku, jl, ju,
+            il, iu,
+    KOKKOS_LAMBDA(const int mm, const int n, const int k, const int j, const int i) {
+      const int m = mbact.d_view(mm);
+      wl4_(m,n,k,j,i) = flx_(m,n,k,j,i) + lapt(flx_, m, n, k, j, i);
+    });
+    par_for("hflux4_copy", DevExeSpace(), mbas, mbae, 0, (nvars-1), kl, ku, jl, ju,
+            il, iu,
+    KOKKOS_LAMBDA(const int mm, const int n, const int k, const int j, const int i) {
+      const int m = mbact.d_view(mm);
+      flx_(m,n,k,j,i) = wl4_(m,n,k,j,i);
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateScalarFluxesRecon
+//! \brief Computes upwind fluxes of passive scalars from the mass fluxes already stored
+//! in uflx, in MBs with indices [mbas,mbae] in the list of active MBs.  Scalars are
+//! reconstructed in chunks of scalar_chunk variables, each handled by separate teams, so
+//! that scratch memory does not grow with the number of scalars.  The reconstruction
+//! method can differ from (e.g. be lower order than) that used for the hydro variables.
+
+template <ReconstructionMethod recon_method_>
+void Hydro::CalculateScalarFluxesRecon(int mbas, int mbae) {
+  RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
+  int is = indcs_.is, ie = indcs_.ie;
+  int js = indcs_.js, je = indcs_.je;
+  int ks = indcs_.ks, ke = indcs_.ke;
+  int ncells1 = SimdPadded(indcs_.nx1 + 2*(indcs_.ng));  // length of scratch rows
+
+  int nhyd_ = nhydro;
+  int nvars = nhydro + nscalars;
+  int nchunk = scalar_chunk;
+  int nchunks = (nscalars + nchunk - 1)/nchunk;
+  // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+  auto &mbact = pmy_pack->pmb->mb_active;
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
+  auto &eos_ = peos->eos_data;
+  auto &w0_ = w0;
+  const Real hybrid_ = hybrid_thresh;
+  int scr_level = global_variable::scratch_level;
+
+  //--------------------------------------------------------------------------------------
+  // i-direction
+
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nchunk, ncells1) * 2;
+  auto &flx1_ = uflx.x1f;
+  par_for_outer("hscalar_x1",DevExeSpace(), scr_size, scr_level, mbas, mbae,
+                0, (nchunks-1), ks, ke, js, je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int c, const int k,
+                const int j) {
+    const int m = mbact.d_view(mm);
+    const int n0 = nhyd_ + c*nchunk;
+    VarRange q{w0_, n0, ((n0 + nchunk <= nvars)? nchunk : (nvars - n0))};
+    ScrArray2D<Real> ql(member.team_scratch(scr_level), nchunk, ncells1);
+    ScrArray2D<Real> qr(member.team_scratch(scr_level), nchunk, ncells1);
+
+    // Reconstruct qR[i] and qL[i+1]
+    if constexpr (recon_method_ == ReconstructionMethod::dc) {
+      DonorCellX1(member, m, k, j, is-1, ie+1, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+      PiecewiseLinearX1(member, m, k, j, is-1, ie+1, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                         recon_method_ == ReconstructionMethod::ppmx) {
+      PiecewiseParabolicX1(member, eos_, extrema, false, m, k, j, is-1, ie+1, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+      WENOZHybridX1(member, eos_, false, hybrid_, m, k, j, is-1, ie+1, w0_, q, ql, qr);
+    } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+      MP5X1(member, eos_, false, m, k, j, is-1, ie+1, q, ql, qr);
+    }
+    member.team_barrier();
+
+    // upwind scalar fluxes using mass flux
+    for (int n=0; n<q.nvar; ++n) {
+      par_for_inner(member, is, ie+1, [&](const int i) {
+        if (flx1_(m,IDN,k,j,i) >= 0.0) {
+          flx1_(m,n0+n,k,j,i) = flx1_(m,IDN,k,j,i)*ql(n,i);
+        } else {
+          flx1_(m,n0+n,k,j,i) = flx1_(m,IDN,k,j,i)*qr(n,i);
+        }
+      });
+    }
+  });
+
+  //--------------------------------------------------------------------------------------
+  // j-direction
+
+  if (pmy_pack->pmesh->multi_d) {
+    scr_size = ScrArray2D<Real>::shmem_size(nchunk, ncells1) * 3;
+    auto &flx2_ = uflx.x2f;
+    par_for_outer("hscalar_x2",DevExeSpace(), scr_size, scr_level, mbas, mbae,
+                  0, (nchunks-1), ks, ke,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int c, const int k) {
+      const int m = mbact.d_view(mm);
+      const int n0 = nhyd_ + c*nchunk;
+      VarRange q{w0_, n0, ((n0 + nchunk <= nvars)? nchunk : (nvars - n0))};
+      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nchunk, ncells1);
+      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nchunk, ncells1);
+      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nchunk, ncells1);
+
+      for (int j=js-1; j<=je+1; ++j) {
+        // Permute scratch arrays.
+        auto ql     = scr1;
+        auto ql_jp1 = scr2;
+        auto qr     = scr3;
+        if ((j%2) == 0) {
+          ql     = scr2;
+          ql_jp1 = scr1;
+        }
+
+        // Reconstruct qR[j] and qL[j+1]
+        if constexpr (recon_method_ == ReconstructionMethod::dc) {
+          DonorCellX2(member, m, k, j, is, ie, q, ql_jp1, qr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+          PiecewiseLinearX2(member, m, k, j, is, ie, q, ql_jp1, qr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                             recon_method_ == ReconstructionMethod::ppmx) {
+          PiecewiseParabolicX2(member, eos_, extrema, false, m, k, j, is, ie, q, ql_jp1,
+                               qr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+          WENOZHybridX2(member, eos_, false, hybrid_, m, k, j, is, ie, w0_, q,
+                        ql_jp1, qr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+          MP5X2(member, eos_, false, m, k, j, is, ie, q, ql_jp1, qr);
+        }
+        member.team_barrier();
+
+        // upwind scalar fluxes over [js,je+1] using mass flux
+        if (j > js-1) {
+          for (int n=0; n<q.nvar; ++n) {
+            par_for_inner(member, is, ie, [&](const int i) {
+              if (flx2_(m,IDN,k,j,i) >= 0.0) {
+                flx2_(m,n0+n,k,j,i) = flx2_(m,IDN,k,j,i)*ql(n,i);
+              } else {
+                flx2_(m,n0+n,k,j,i) = flx2_(m,IDN,k,j,i)*qr(n,i);
+              }
+            });
+          }
+        }
+      } // end of loop over j
+    });
+  }
+
+  //--------------------------------------------------------------------------------------
+  // k-direction. Note order of k,j loops switched
+
+  if (pmy_pack->pmesh->three_d) {
+    scr_size = ScrArray2D<Real>::shmem_size(nchunk, ncells1) * 3;
+    auto &flx3_ = uflx.x3f;
+    par_for_outer("hscalar_x3",DevExeSpace(), scr_size, scr_level, mbas, mbae,
+                  0, (nchunks-1), js, je,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int c, const int j) {
+      const int m = mbact.d_view(mm);
+      const int n0 = nhyd_ + c*nchunk;
+      VarRange q{w0_, n0, ((n0 + nchunk <= nvars)? nchunk : (nvars - n0))};
+      ScrArray2D<Real> scr1(member.team_scratch(scr_level), nchunk, ncells1);
+      ScrArray2D<Real> scr2(member.team_scratch(scr_level), nchunk, ncells1);
+      ScrArray2D<Real> scr3(member.team_scratch(scr_level), nchunk, ncells1);
+
+      for (int k=ks-1; k<=ke+1; ++k) {
+        // Permute scratch arrays.
+        auto ql     = scr1;
+        auto ql_kp1 = scr2;
+        auto qr     = scr3;
+        if ((k%2) == 0) {
+          ql     = scr2;
+          ql_kp1 = scr1;
+        }
+
+        // Reconstruct qR[k] and qL[k+1]
+        if constexpr (recon_method_ == ReconstructionMethod::dc) {
+          DonorCellX3(member, m, k, j, is, ie, q, ql_kp1, qr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+          PiecewiseLinearX3(member, m, k, j, is, ie, q, ql_kp1, qr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                             recon_method_ == ReconstructionMethod::ppmx) {
+          PiecewiseParabolicX3(member, eos_, extrema, false, m, k, j, is, ie, q, ql_kp1,
+                               qr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+          WENOZHybridX3(member, eos_, false, hybrid_, m, k, j, is, ie, w0_, q,
+                        ql_kp1, qr);
+        } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+          MP5X3(member, eos_, false, m, k, j, is, ie, q, ql_kp1, qr);
+        }
+        member.team_barrier();
+
+        // upwind scalar fluxes over [ks,ke+1] using mass flux
+        if (k > ks-1) {
+          for (int n=0; n<q.nvar; ++n) {
+            par_for_inner(member, is, ie, [&](const int i) {
+              if (flx3_(m,IDN,k,j,i) >= 0.0) {
+                flx3_(m,n0+n,k,j,i) = flx3_(m,IDN,k,j,i)*ql(n,i);
+              } else {
+                flx3_(m,n0+n,k,j,i) = flx3_(m,IDN,k,j,i)*qr(n,i);
+              }
+            });
+          }
+        }
+      } // end of loop over k
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateScalarFluxes
+//! \brief Selects scalar flux kernels specialised at compile time for the reconstruction
+//! method used for scalars (<hydro>/scalar_reconstruct).
+
+void Hydro::CalculateScalarFluxes(int mbas, int mbae) {
+  switch (scalar_recon) {
+#if RECON_DC_ENABLED
+    case ReconstructionMethod::dc:
+      CalculateScalarFluxesRecon<ReconstructionMethod::dc>(mbas, mbae);
+      break;
+#endif
+#if RECON_PLM_ENABLED
+    case ReconstructionMethod::plm:
+      CalculateScalarFluxesRecon<ReconstructionMethod::plm>(mbas, mbae);
+      break;
+#endif
+#if RECON_PPM4_ENABLED
+    case ReconstructionMethod::ppm4:
+      CalculateScalarFluxesRecon<ReconstructionMethod::ppm4>(mbas, mbae);
+      break;
+#endif
+#if RECON_PPMX_ENABLED
+    case ReconstructionMethod::ppmx:
+      CalculateScalarFluxesRecon<ReconstructionMethod::ppmx>(mbas, mbae);
+      break;
+#endif
+#if RECON_WENOZ_ENABLED
+    case ReconstructionMethod::wenoz:
+      CalculateScalarFluxesRecon<ReconstructionMethod::wenoz>(mbas, mbae);
+      break;
+#endif
+#if RECON_MP5_ENABLED
+    case ReconstructionMethod::mp5:
+      CalculateScalarFluxesRecon<ReconstructionMethod::mp5>(mbas, mbae);
+      break;
+#endif
+    default:
+      break;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::CalculateFluxes
+//! \brief Selects flux kernels specialised at compile time for the reconstruction method,
+//! so that no switch over reconstruction methods is needed inside kernels.  Only methods
+//! enabled with Athena_RECONSTRUCTION in CMakeLists.txt are instantiated.
+
+template <Hydro_RSolver rsolver_method_>
+void Hydro::CalculateFluxes(Driver *pdriver, int stage, int mbas, int mbae) {
+  switch (recon_method) {
+#if RECON_DC_ENABLED
+    case ReconstructionMethod::dc:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::dc>(pdriver, stage,
+                                                                    mbas, mbae);
+      break;
+#endif
+#if RECON_PLM_ENABLED
+    case ReconstructionMethod::plm:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::plm>(pdriver, stage,
+                                                                    mbas, mbae);
+      break;
+#endif
+#if RECON_PPM4_ENABLED
+    case ReconstructionMethod::ppm4:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::ppm4>(pdriver, stage,
+                                                                    mbas, mbae);
+      break;
+#endif
+#if RECON_PPMX_ENABLED
+    case ReconstructionMethod::ppmx:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::ppmx>(pdriver, stage,
+                                                                    mbas, mbae);
+      break;
+#endif
+#if RECON_WENOZ_ENABLED
+    case ReconstructionMethod::wenoz:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::wenoz>(pdriver, stage,
+                                                                    mbas, mbae);
+      break;
+#endif
+#if RECON_MP5_ENABLED
+    case ReconstructionMethod::mp5:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::mp5>(pdriver, stage,
+                                                                    mbas, mbae);
+      break;
+#endif
+    default:
+      break;
+  }
   return;
 }
 
 // function definitions for each template parameter
-template void Hydro::CalculateFluxes<Hydro_RSolver::advect>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::llf>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hlle>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hllc>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::roe>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::llf_sr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hlle_sr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hllc_sr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::llf_gr>(Driver *pdriver, int stage);
-template void Hydro::CalculateFluxes<Hydro_RSolver::hlle_gr>(Driver *pdriver, int stage);
+template void Hydro::CalculateFluxes<Hydro_RSolver::advect>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
+template void Hydro::CalculateFluxes<Hydro_RSolver::llf>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
+template void Hydro::CalculateFluxes<Hydro_RSolver::hlle>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
+template void Hydro::CalculateFluxes<Hydro_RSolver::hllc>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
+template void Hydro::CalculateFluxes<Hydro_RSolver::roe>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
+template void Hydro::CalculateFluxes<Hydro_RSolver::llf_sr>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
+template void Hydro::CalculateFluxes<Hydro_RSolver::hlle_sr>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
+template void Hydro::CalculateFluxes<Hydro_RSolver::hllc_sr>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
+template void Hydro::CalculateFluxes<Hydro_RSolver::llf_gr>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
+template void Hydro::CalculateFluxes<Hydro_RSolver::hlle_gr>(Driver *pdriver, int stage,
+                                                       int mbas, int mbae);
 
 } // namespace hydro
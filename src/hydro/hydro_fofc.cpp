@@ -17,6 +17,56 @@
 #include "hydro.hpp"
 
 namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn void CorrectFaceFOFC
+//! \brief Replaces the flux of hydro variables on the face between cells (kl,jl,il) and
+//! (kr,jr,ir) in the direction of velocity component ivx with a first-order LLF flux, and
+//! corrects conserved variables in whichever of these cells are active by the change in
+//! flux.  Used with <hydro>/fofc_list, where u0 has already been updated with the
+//! original fluxes.
+
+KOKKOS_INLINE_FUNCTION
+void CorrectFaceFOFC(const DvceArray5D<Real> &w0, const DvceArray5D<Real> &u0,
+                     const DvceArray5D<Real> &flx, const EOS_Data &eos, const int m,
+                     const int kl, const int jl, const int il,
+                     const int kr, const int jr, const int ir, const int ivx,
+                     const bool left_active, const bool right_active, const Real dtodx) {
+  const int ivy = IVX + ((ivx - IVX) + 1)%3;
+  const int ivz = IVX + ((ivx - IVX) + 2)%3;
+
+  // load left and right states, permutting components of vectors
+  HydPrim1D wl, wr;
+  wl.d  = w0(m,IDN,kl,jl,il);
+  wl.vx = w0(m,ivx,kl,jl,il);
+  wl.vy = w0(m,ivy,kl,jl,il);
+  wl.vz = w0(m,ivz,kl,jl,il);
+  if (eos.is_ideal) {wl.e = w0(m,IEN,kl,jl,il);}
+  wr.d  = w0(m,IDN,kr,jr,ir);
+  wr.vx = w0(m,ivx,kr,jr,ir);
+  wr.vy = w0(m,ivy,kr,jr,ir);
+  wr.vz = w0(m,ivz,kr,jr,ir);
+  if (eos.is_ideal) {wr.e = w0(m,IEN,kr,jr,ir);}
+
+  // compute new 1st-order LLF flux
+  HydCons1D flux;
+  SingleStateLLF_Hyd(wl, wr, eos, flux);
+  Real fnew[5] = {flux.d, 0.0, 0.0, 0.0, flux.e};
+  fnew[ivx] = flux.mx;
+  fnew[ivy] = flux.my;
+  fnew[ivz] = flux.mz;
+
+  // store 1st-order fluxes (stored at index of right cell), and correct conserved
+  // variables by difference with original fluxes
+  int nhyd = (eos.is_ideal)? 5 : 4;
+  for (int n=0; n<nhyd; ++n) {
+    Real dflx = dtodx*(fnew[n] - flx(m,n,kr,jr,ir));
+    flx(m,n,kr,jr,ir) = fnew[n];
+    if (left_active)  {Kokkos::atomic_add(&u0(m,n,kl,jl,il), -dflx);}
+    if (right_active) {Kokkos::atomic_add(&u0(m,n,kr,jr,ir),  dflx);}
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void Hydro::FOFC
 //! \brief Implements first-order flux-correction (FOFC) algorithm for Hydro.  First an
@@ -47,6 +97,13 @@ void Hydro::FOFC(Driver *pdriver, int stage) {
     Real &gam1 = pdriver->gam1[stage-1];
     Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
 
+    // estimate of updated conserved variables is only needed in this function, so it
+    // is stored in slot 0 of the MeshBlockPack scratch arena
+    int ncells1 = nx1 + 2*(indcs.ng);
+    int ncells2 = (nx2 > 1)? (nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (nx3 > 1)? (nx3 + 2*(indcs.ng)) : 1;
+    utest = pmy_pack->scratch.Get5D(0, nmb, nhydro, ncells3, ncells2, ncells1);
+
     int &nhyd_ = nhydro;
     auto &u0_ = u0;
     auto &u1_ = u1;
@@ -368,4 +425,107 @@ void Hydro::FOFC(Driver *pdriver, int stage) {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Hydro::FOFCList
+//! \brief Implements FOFC over the compact list of nflag cells flagged during the RK
+//! update in ExpRKUpdateFlagFOFC(), so that the cost scales with the number of flagged
+//! cells rather than the size of the grid.  Since u0 has already been updated, each face
+//! of a flagged cell is corrected by the difference between the first-order LLF flux and
+//! the original flux.  A face shared by two flagged cells is corrected only once, by the
+//! cell on its right.  Flags are reset at the end.
+
+void Hydro::FOFCList(Driver *pdriver, int stage, int nflag) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  const int nji  = ncells2*ncells1;
+  const int nkji = ncells3*nji;
+
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto &size = pmy_pack->pmb->mb_size;
+  auto &eos = peos->eos_data;
+  auto &u0_ = u0;
+  auto &w0_ = w0;
+  auto &fofc_ = fofc;
+  auto &idx_ = fofc_idx;
+
+  par_for("FOFC-list", DevExeSpace(), 0, (nflag-1),
+  KOKKOS_LAMBDA(const int n) {
+    const int idx = idx_(n);
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/ncells1;
+    int i = (idx - m*nkji - k*nji - j*ncells1);
+    auto active = [&](const int kk, const int jj, const int ii) {
+      return ((kk >= ks) && (kk <= ke) && (jj >= js) && (jj <= je) &&
+              (ii >= is) && (ii <= ie));
+    };
+    bool act = active(k,j,i);
+
+    // replace x1-fluxes at i, and at i+1 unless cell i+1 is also flagged
+    Real dtodx = beta_dt/size.d_view(m).dx1;
+    bool actl = active(k,j,i-1);
+    if (actl || act) {
+      CorrectFaceFOFC(w0_, u0_, flx1, eos, m, k, j, i-1, k, j, i, IVX, actl, act, dtodx);
+    }
+    bool actr = active(k,j,i+1);
+    if ((act || actr) && !(fofc_(m,k,j,i+1))) {
+      CorrectFaceFOFC(w0_, u0_, flx1, eos, m, k, j, i, k, j, i+1, IVX, act, actr, dtodx);
+    }
+
+    // replace x2-fluxes at j, and at j+1 unless cell j+1 is also flagged
+    if (multi_d) {
+      dtodx = beta_dt/size.d_view(m).dx2;
+      actl = active(k,j-1,i);
+      if (actl || act) {
+        CorrectFaceFOFC(w0_, u0_, flx2, eos, m,
+                        k, j-1, i, k, j, i, IVY, actl, act, dtodx);
+      }
+      actr = active(k,j+1,i);
+      if ((act || actr) && !(fofc_(m,k,j+1,i))) {
+        CorrectFaceFOFC(w0_, u0_, flx2, eos, m,
+                        k, j, i, k, j+1, i, IVY, act, actr, dtodx);
+      }
+    }
+
+    // replace x3-fluxes at k, and at k+1 unless cell k+1 is also flagged
+    if (three_d) {
+      dtodx = beta_dt/size.d_view(m).dx3;
+      actl = active(k-1,j,i);
+      if (actl || act) {
+        CorrectFaceFOFC(w0_, u0_, flx3, eos, m,
+                        k-1, j, i, k, j, i, IVZ, actl, act, dtodx);
+      }
+      actr = active(k+1,j,i);
+      if ((act || actr) && !(fofc_(m,k+1,j,i))) {
+        CorrectFaceFOFC(w0_, u0_, flx3, eos, m,
+                        k, j, i, k+1, j, i, IVZ, act, actr, dtodx);
+      }
+    }
+  });
+
+  // reset FOFC flags of cells in list
+  par_for("FOFC-reset", DevExeSpace(), 0, (nflag-1),
+  KOKKOS_LAMBDA(const int n) {
+    const int idx = idx_(n);
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/ncells1;
+    int i = (idx - m*nkji - k*nji - j*ncells1);
+    fofc_(m,k,j,i) = false;
+  });
+
+  return;
+}
+
 } // namespace hydro
@@ -31,6 +31,16 @@ TaskStatus Hydro::NewTimeStep(Driver *pdrive, int stage) {
     return TaskStatus::complete; // only execute last stage
   }
 
+  // with fused_newdt, dtnew was already computed in C2P on this stage
+  if (dtnew_from_c2p_) {
+    dtnew_from_c2p_ = false;
+    if (pcond != nullptr) {
+      pcond->NewTimeStep(w0, peos->eos_data);
+    }
+    psrc->NewTimeStep(w0, peos->eos_data);
+    return TaskStatus::complete;
+  }
+
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, nx1 = indcs.nx1;
   int js = indcs.js, nx2 = indcs.nx2;
@@ -132,4 +142,21 @@ TaskStatus Hydro::NewTimeStep(Driver *pdrive, int stage) {
 
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+// \!fn void Hydro::SetNewTimeStepFromC2P()
+// \brief sets dtnew from minimum timesteps in each direction returned by last call to
+// ConsToPrim when EquationOfState::c2p_newdt was set, then resets that flag
+
+void Hydro::SetNewTimeStepFromC2P() {
+  if (!(peos->c2p_newdt)) {return;}
+  peos->c2p_newdt = false;
+
+  // compute minimum of dt1/dt2/dt3 for 1D/2D/3D problems
+  dtnew = peos->c2p_dt[0];
+  if (pmy_pack->pmesh->multi_d) { dtnew = std::min(dtnew, peos->c2p_dt[1]); }
+  if (pmy_pack->pmesh->three_d) { dtnew = std::min(dtnew, peos->c2p_dt[2]); }
+  dtnew_from_c2p_ = true;
+  return;
+}
 } // namespace hydro
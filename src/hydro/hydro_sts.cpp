@@ -0,0 +1,204 @@
+//========================================================================================
+// AthenaK astrophysical fluid dynamics and numerical relativity code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file hydro_sts.cpp
+//! \brief Super-time-stepping (STS) of viscous and heat fluxes in Hydro using the
+//! Runge-Kutta-Legendre RKL1 and RKL2 methods of Meyer, Balsara, & Aslam (2014), MNRAS
+//! 438, 3330.  Diffusion is operator split from the time integrator, and integrated over
+//! the full timestep dt in s sub-stages, where s is chosen so that the RKL stability
+//! limit exceeds dt.  Each sub-stage executes the "before_sts", "sts", and "after_sts"
+//! task lists, with the index of the sub-stage passed as the stage.
+
+#include <algorithm>
+#include <cmath>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "eos/eos.hpp"
+#include "diffusion/viscosity.hpp"
+#include "diffusion/conduction.hpp"
+#include "bvals/bvals.hpp"
+#include "hydro.hpp"
+
+namespace hydro {
+//----------------------------------------------------------------------------------------
+//! \fn  int Hydro::SetSTSStages
+//! \brief Sets (and returns) number of STS sub-stages needed to integrate diffusion over
+//! timestep dt stably, given the explicit diffusive timestep dt_diff.  Called by the
+//! Driver once per cycle, after the time integrator.
+
+int Hydro::SetSTSStages(const Real dt, const Real dt_diff) {
+  Real ratio = dt/dt_diff;
+  if (sts_integrator == STS_Integrator::rkl1) {
+    // RKL1 is stable for dt < dt_diff*(s^2 + s)/2
+    nsts = 1 + static_cast<int>(0.5*(-1.0 + std::sqrt(1.0 + 8.0*ratio)));
+  } else if (sts_integrator == STS_Integrator::rkl2) {
+    // RKL2 is stable for dt < dt_diff*(s^2 + s - 2)/4, use odd s for better damping
+    nsts = 1 + static_cast<int>(0.5*(-1.0 + std::sqrt(9.0 + 16.0*ratio)));
+    if (nsts % 2 == 0) {nsts += 1;}
+  } else {
+    nsts = 0;
+  }
+  return nsts;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::STSInitRecv
+//! \brief Wrapper task list function to post receives for U (and fluxes of U with
+//! SMR/AMR) in each STS sub-stage.
+
+TaskStatus Hydro::STSInitRecv(Driver *pdrive, int stage) {
+  TaskStatus tstat = pbval_u->InitRecv(nhydro+nscalars);
+  if (tstat != TaskStatus::complete) return tstat;
+  if (pmy_pack->pmesh->multilevel) {
+    tstat = pbval_u->InitFluxRecv(nhydro+nscalars);
+  }
+  return tstat;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::STSFluxes
+//! \brief Wrapper task list function that computes only the viscous and heat fluxes of
+//! conserved variables, for the STS sub-stage.
+
+TaskStatus Hydro::STSFluxes(Driver *pdrive, int stage) {
+  Kokkos::deep_copy(DevExeSpace(), uflx.x1f, 0.0);
+  if (pmy_pack->pmesh->multi_d) {Kokkos::deep_copy(DevExeSpace(), uflx.x2f, 0.0);}
+  if (pmy_pack->pmesh->three_d) {Kokkos::deep_copy(DevExeSpace(), uflx.x3f, 0.0);}
+
+  if (pvisc != nullptr) {
+    pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
+  }
+  if (pcond != nullptr) {
+    pcond->AddHeatFlux(w0, peos->eos_data, uflx);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Hydro::STSUpdate
+//! \brief Updates conserved variables in sub-stage j=stage of the RKL1/RKL2 integrator
+//!   Y_j = mu_j*Y_{j-1} + nu_j*Y_{j-2} + (1 - mu_j - nu_j)*Y_0
+//!         + mut_j*dt*L(Y_{j-1}) + gamt_j*dt*L(Y_0)
+//! where L(Y) = -div(F) of the diffusive fluxes.  For RKL1, (1-mu_j-nu_j) = gamt_j = 0.
+//! On the first sub-stage Y_0, Y_{j-2}, and L(Y_0) are stored in u_sts0, u_sts1, m_sts0.
+
+TaskStatus Hydro::STSUpdate(Driver *pdrive, int stage) {
+  // RKL coefficients of sub-stage j
+  const int jsts = stage;
+  const Real s = static_cast<Real>(nsts);
+  Real mu = 1.0, nu = 0.0, mut, gamt = 0.0;
+  if (sts_integrator == STS_Integrator::rkl1) {
+    Real w1 = 2.0/(s*s + s);
+    if (jsts > 1) {
+      mu = (2.0*jsts - 1.0)/jsts;
+      nu = (1.0 - jsts)/jsts;
+    }
+    mut = mu*w1;
+  } else {
+    auto b = [](const int jj) {
+      return (jj < 2)? (1.0/3.0) : (jj*jj + jj - 2.0)/(2.0*jj*(jj + 1.0));
+    };
+    Real w1 = 4.0/(s*s + s - 2.0);
+    if (jsts > 1) {
+      mu = (2.0*jsts - 1.0)/jsts*b(jsts)/b(jsts-1);
+      nu = -(jsts - 1.0)/jsts*b(jsts)/b(jsts-2);
+      mut = mu*w1;
+      gamt = -(1.0 - b(jsts-1))*mut;
+    } else {
+      mut = b(1)*w1;
+    }
+  }
+  const Real mu0 = 1.0 - mu - nu;
+  const Real dt = pmy_pack->pmesh->dt;
+  const bool first = (jsts == 1);
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto &mbact = pmy_pack->pmb->mb_active;
+  int nmba1 = pmy_pack->pmb->nmb_active - 1;
+  auto u0_ = u0;
+  auto y0_ = u_sts0;
+  auto y2_ = u_sts1;
+  auto m0_ = m_sts0;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+
+  par_for("h_sts_update", DevExeSpace(), 0, nmba1, 0, nhydro-1, ks, ke, js, je, is, ie,
+  KOKKOS_LAMBDA(int mm, int n, int k, int j, int i) {
+    const int m = mbact.d_view(mm);
+    // Fluxes must be summed in pairs to symmetrize round-off error in each dir
+    Real divf = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
+    if (multi_d) {
+      divf += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+    }
+    if (three_d) {
+      divf += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+    }
+    Real y1 = u0_(m,n,k,j,i);
+    if (first) {
+      y0_(m,n,k,j,i) = y1;
+      y2_(m,n,k,j,i) = y1;
+      m0_(m,n,k,j,i) = -divf;
+    }
+    u0_(m,n,k,j,i) = mu*y1 + nu*y2_(m,n,k,j,i) + mu0*y0_(m,n,k,j,i)
+                     - mut*dt*divf + gamt*dt*m0_(m,n,k,j,i);
+    y2_(m,n,k,j,i) = y1;
+  });
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::STSConToPrim
+//! \brief Wrapper task list function to call ConsToPrim over entire mesh (including gz)
+//! at the end of each STS sub-stage.  The new timestep is not computed.
+
+TaskStatus Hydro::STSConToPrim(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &ng = indcs.ng;
+  int n1m1 = indcs.nx1 + 2*ng - 1;
+  int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
+  int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  peos->c2p_newdt = false;
+  peos->ConsToPrim(u0, w0, false, 0, n1m1, 0, n2m1, 0, n3m1);
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::STSClearSend
+//! \brief Wrapper task list function that checks all MPI sends of U (and fluxes of U with
+//! SMR/AMR) in each STS sub-stage have completed.
+
+TaskStatus Hydro::STSClearSend(Driver *pdrive, int stage) {
+  TaskStatus tstat = pbval_u->ClearSend();
+  if (tstat != TaskStatus::complete) return tstat;
+  if (pmy_pack->pmesh->multilevel) {
+    tstat = pbval_u->ClearFluxSend();
+  }
+  return tstat;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::STSClearRecv
+//! \brief Wrapper task list function that checks all MPI receives of U (and fluxes of U
+//! with SMR/AMR) in each STS sub-stage have completed.
+
+TaskStatus Hydro::STSClearRecv(Driver *pdrive, int stage) {
+  TaskStatus tstat = pbval_u->ClearRecv();
+  if (tstat != TaskStatus::complete) return tstat;
+  if (pmy_pack->pmesh->multilevel) {
+    tstat = pbval_u->ClearFluxRecv();
+  }
+  return tstat;
+}
+
+} // namespace hydro
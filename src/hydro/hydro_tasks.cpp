@@ -6,6 +6,7 @@
 //! \file hydro_tasks.cpp
 //! \brief functions that control Hydro tasks stored in tasklists in MeshBlockPack
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -42,38 +43,100 @@ namespace hydro {
 //! are completed over ALL MeshBlocks for each stage, such as clearing all MPI calls, etc.
 //!
 //! In addition there are "before_timeintegrator" and "after_timeintegrator" task lists
-//! in the tl map, which are generally used for operator split tasks.
+//! in the tl map, which are generally used for operator split tasks, and "before_sts",
+//! "sts", and "after_sts" lists executed in each sub-stage of super-time-stepping.
 
 void Hydro::AssembleHydroTasks(std::map<std::string, std::shared_ptr<TaskList>> tl) {
   TaskID none(0);
 
   // assemble "before_stagen" task list
-  id.irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, this, none);
+  id.irecv = tl["before_stagen"]->AddTask(&Hydro::InitRecv, this, none,
+                                          "Hydro::InitRecv");
 
   // assemble "stagen" task list
-  id.copyu     = tl["stagen"]->AddTask(&Hydro::CopyCons, this, none);
-  id.flux      = tl["stagen"]->AddTask(&Hydro::Fluxes,this,id.copyu);
-  id.sendf     = tl["stagen"]->AddTask(&Hydro::SendFlux, this, id.flux);
-  id.recvf     = tl["stagen"]->AddTask(&Hydro::RecvFlux, this, id.sendf);
-  id.rkupdt    = tl["stagen"]->AddTask(&Hydro::RKUpdate, this, id.recvf);
-  id.srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, this, id.rkupdt);
-  id.sendu_oa  = tl["stagen"]->AddTask(&Hydro::SendU_OA, this, id.srctrms);
-  id.recvu_oa  = tl["stagen"]->AddTask(&Hydro::RecvU_OA, this, id.sendu_oa);
-  id.restu     = tl["stagen"]->AddTask(&Hydro::RestrictU, this, id.recvu_oa);
-  id.sendu     = tl["stagen"]->AddTask(&Hydro::SendU, this, id.restu);
-  id.recvu     = tl["stagen"]->AddTask(&Hydro::RecvU, this, id.sendu);
-  id.sendu_shr = tl["stagen"]->AddTask(&Hydro::SendU_Shr, this, id.recvu);
-  id.recvu_shr = tl["stagen"]->AddTask(&Hydro::RecvU_Shr, this, id.sendu_shr);
-  id.bcs       = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, this, id.recvu_shr);
-  id.prol      = tl["stagen"]->AddTask(&Hydro::Prolongate, this, id.bcs);
-  id.c2p       = tl["stagen"]->AddTask(&Hydro::ConToPrim, this, id.prol);
-  id.newdt     = tl["stagen"]->AddTask(&Hydro::NewTimeStep, this, id.c2p);
+  id.copyu     = tl["stagen"]->AddTask(&Hydro::CopyCons, this, none, "Hydro::CopyCons");
+  id.flux      = tl["stagen"]->AddTask(&Hydro::Fluxes, this, id.copyu, "Hydro::Fluxes");
+  id.sendf     = tl["stagen"]->AddTask(&Hydro::SendFlux, this, id.flux,
+                                       "Hydro::SendFlux");
+  id.recvf     = tl["stagen"]->AddTask(&Hydro::RecvFlux, this, id.sendf,
+                                       "Hydro::RecvFlux");
+  id.rkupdt    = tl["stagen"]->AddTask(&Hydro::RKUpdate, this, id.recvf,
+                                       "Hydro::RKUpdate");
+  id.srctrms   = tl["stagen"]->AddTask(&Hydro::HydroSrcTerms, this, id.rkupdt,
+                                       "Hydro::HydroSrcTerms");
+  id.sendu_oa  = tl["stagen"]->AddTask(&Hydro::SendU_OA, this, id.srctrms,
+                                       "Hydro::SendU_OA");
+  id.recvu_oa  = tl["stagen"]->AddTask(&Hydro::RecvU_OA, this, id.sendu_oa,
+                                       "Hydro::RecvU_OA");
+  id.restu     = tl["stagen"]->AddTask(&Hydro::RestrictU, this, id.recvu_oa,
+                                       "Hydro::RestrictU");
+  id.sendu     = tl["stagen"]->AddTask(&Hydro::SendU, this, id.restu, "Hydro::SendU");
+  if (split_c2p) {
+    // C2P in active cells overlaps with communication of U, and only ghost zones are
+    // converted once they have been received
+    id.c2pa      = tl["stagen"]->AddTask(&Hydro::ConToPrimActive, this, id.sendu,
+                                         "Hydro::ConToPrimActive");
+    id.recvu     = tl["stagen"]->AddTask(&Hydro::RecvU, this, id.c2pa, "Hydro::RecvU");
+  } else {
+    id.recvu     = tl["stagen"]->AddTask(&Hydro::RecvU, this, id.sendu, "Hydro::RecvU");
+  }
+  id.sendu_shr = tl["stagen"]->AddTask(&Hydro::SendU_Shr, this, id.recvu,
+                                       "Hydro::SendU_Shr");
+  id.recvu_shr = tl["stagen"]->AddTask(&Hydro::RecvU_Shr, this, id.sendu_shr,
+                                       "Hydro::RecvU_Shr");
+  id.bcs       = tl["stagen"]->AddTask(&Hydro::ApplyPhysicalBCs, this, id.recvu_shr,
+                                       "Hydro::ApplyPhysicalBCs");
+  id.prol      = tl["stagen"]->AddTask(&Hydro::Prolongate, this, id.bcs,
+                                       "Hydro::Prolongate");
+  if (split_c2p) {
+    id.c2p     = tl["stagen"]->AddTask(&Hydro::ConToPrimGhost, this, id.prol,
+                                       "Hydro::ConToPrimGhost");
+  } else {
+    id.c2p     = tl["stagen"]->AddTask(&Hydro::ConToPrim, this, id.prol,
+                                       "Hydro::ConToPrim");
+  }
+  id.newdt     = tl["stagen"]->AddTask(&Hydro::NewTimeStep, this, id.c2p,
+                                       "Hydro::NewTimeStep");
 
   // assemble "after_stagen" task list
-  id.csend = tl["after_stagen"]->AddTask(&Hydro::ClearSend, this, none);
+  id.csend = tl["after_stagen"]->AddTask(&Hydro::ClearSend, this, none,
+                                         "Hydro::ClearSend");
   // although RecvFlux/U functions check that all recvs complete, add ClearRecv to
   // task list anyways to catch potential bugs in MPI communication logic
-  id.crecv = tl["after_stagen"]->AddTask(&Hydro::ClearRecv, this, id.csend);
+  id.crecv = tl["after_stagen"]->AddTask(&Hydro::ClearRecv, this, id.csend,
+                                         "Hydro::ClearRecv");
+
+  // assemble "before_sts", "sts", and "after_sts" task lists for super-time-stepping of
+  // diffusion terms (only used with STS, see hydro_sts.cpp)
+  if (sts_integrator != STS_Integrator::none) {
+    id.sts_irecv = tl["before_sts"]->AddTask(&Hydro::STSInitRecv, this, none,
+                                             "Hydro::STSInitRecv");
+
+    id.sts_flux  = tl["sts"]->AddTask(&Hydro::STSFluxes, this, none, "Hydro::STSFluxes");
+    id.sts_sendf = tl["sts"]->AddTask(&Hydro::SendFlux, this, id.sts_flux,
+                                      "Hydro::SendFlux");
+    id.sts_recvf = tl["sts"]->AddTask(&Hydro::RecvFlux, this, id.sts_sendf,
+                                      "Hydro::RecvFlux");
+    id.sts_updt  = tl["sts"]->AddTask(&Hydro::STSUpdate, this, id.sts_recvf,
+                                      "Hydro::STSUpdate");
+    id.sts_restu = tl["sts"]->AddTask(&Hydro::RestrictU, this, id.sts_updt,
+                                      "Hydro::RestrictU");
+    id.sts_sendu = tl["sts"]->AddTask(&Hydro::SendU, this, id.sts_restu,
+                                      "Hydro::SendU");
+    id.sts_recvu = tl["sts"]->AddTask(&Hydro::RecvU, this, id.sts_sendu,
+                                      "Hydro::RecvU");
+    id.sts_bcs   = tl["sts"]->AddTask(&Hydro::ApplyPhysicalBCs, this, id.sts_recvu,
+                                      "Hydro::ApplyPhysicalBCs");
+    id.sts_prol  = tl["sts"]->AddTask(&Hydro::Prolongate, this, id.sts_bcs,
+                                      "Hydro::Prolongate");
+    id.sts_c2p   = tl["sts"]->AddTask(&Hydro::STSConToPrim, this, id.sts_prol,
+                                      "Hydro::STSConToPrim");
+
+    id.sts_csend = tl["after_sts"]->AddTask(&Hydro::STSClearSend, this, none,
+                                            "Hydro::STSClearSend");
+    id.sts_crecv = tl["after_sts"]->AddTask(&Hydro::STSClearRecv, this, id.sts_csend,
+                                            "Hydro::STSClearRecv");
+  }
 
   return;
 }
@@ -84,9 +147,12 @@ void Hydro::AssembleHydroTasks(std::map<std::string, std::shared_ptr<TaskList>>
 //! initialize all boundary receive status flags to waiting (with or without MPI).
 
 TaskStatus Hydro::InitRecv(Driver *pdrive, int stage) {
-  // post receives for U
-  TaskStatus tstat = pbval_u->InitRecv(nhydro+nscalars);
-  if (tstat != TaskStatus::complete) return tstat;
+  // post receives for U, unless U is received with radiation intensities
+  TaskStatus tstat = TaskStatus::complete;
+  if (!(coalesced_u) || (stage < 0)) {
+    tstat = pbval_u->InitRecv(nhydro+nscalars);
+    if (tstat != TaskStatus::complete) return tstat;
+  }
 
   // with SMR/AMR post receives for fluxes of U
   // do not post receives for fluxes when stage < 0 (i.e. ICs)
@@ -99,7 +165,7 @@ TaskStatus Hydro::InitRecv(Driver *pdrive, int stage) {
   // only execute when (shearing box defined) AND (last stage) AND (3D OR 2d_r_phi)
   if ((psrc->shearing_box) && (stage == pdrive->nexp_stages) &&
       (pmy_pack->pmesh->three_d || psrc->shearing_box_r_phi)) {
-    tstat = porb_u->InitRecv();
+    tstat = porb_u->InitRecv((psrc->qshear)*(psrc->omega0));
   }
   if (tstat != TaskStatus::complete) return tstat;
 
@@ -126,9 +192,22 @@ TaskStatus Hydro::InitRecv(Driver *pdrive, int stage) {
 TaskStatus Hydro::CopyCons(Driver *pdrive, int stage) {
   if (stage == 1) {
     Kokkos::deep_copy(DevExeSpace(), u1, u0);
+    // with implicit ISM cooling, execute first two implicit stages of ImEx integrator
+    // (nexp_stage = -1,0), then update primitives over entire mesh (including gz)
+    if (psrc->ism_cooling_imex) {
+      psrc->ISMCoolingImEx(pdrive, -1, peos->eos_data, u0);
+      psrc->ISMCoolingImEx(pdrive, 0, peos->eos_data, u0);
+      auto &indcs = pmy_pack->pmesh->mb_indcs;
+      int &ng = indcs.ng;
+      int n1m1 = indcs.nx1 + 2*ng - 1;
+      int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
+      int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+      peos->c2p_newdt = false;
+      peos->ConsToPrim(u0, w0, false, 0, n1m1, 0, n2m1, 0, n3m1);
+    }
   } else {
-    if (pdrive->integrator == "rk4") {
-      // parallel loop to update u1 with u0 at later stages, only for rk4
+    if (pdrive->low_storage && pdrive->delta[stage-1] != 0.0) {
+      // parallel loop to update u1 with u0 at later stages, only for 2S integrators
       auto &indcs = pmy_pack->pmesh->mb_indcs;
       int is = indcs.is, ie = indcs.ie;
       int js = indcs.js, je = indcs.je;
@@ -138,7 +217,7 @@ TaskStatus Hydro::CopyCons(Driver *pdrive, int stage) {
       auto &u0 = pmy_pack->phydro->u0;
       auto &u1 = pmy_pack->phydro->u1;
       Real &delta = pdrive->delta[stage-1];
-      par_for("rk4_copy_cons", DevExeSpace(),0, nmb1, 0, nvar-1, ks, ke, js, je, is, ie,
+      par_for("copy_cons_2s", DevExeSpace(),0, nmb1, 0, nvar-1, ks, ke, js, je, is, ie,
       KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
         u1(m,n,k,j,i) += delta*u0(m,n,k,j,i);
       });
@@ -153,40 +232,55 @@ TaskStatus Hydro::CopyCons(Driver *pdrive, int stage) {
 //! of conserved variables
 
 TaskStatus Hydro::Fluxes(Driver *pdrive, int stage) {
-  // select which calculate_flux function to call based on rsolver_method
-  if (rsolver_method == Hydro_RSolver::advect) {
-    CalculateFluxes<Hydro_RSolver::advect>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::llf) {
-    CalculateFluxes<Hydro_RSolver::llf>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hlle) {
-    CalculateFluxes<Hydro_RSolver::hlle>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hllc) {
-    CalculateFluxes<Hydro_RSolver::hllc>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::roe) {
-    CalculateFluxes<Hydro_RSolver::roe>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::llf_sr) {
-    CalculateFluxes<Hydro_RSolver::llf_sr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hlle_sr) {
-    CalculateFluxes<Hydro_RSolver::hlle_sr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hllc_sr) {
-    CalculateFluxes<Hydro_RSolver::hllc_sr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::llf_gr) {
-    CalculateFluxes<Hydro_RSolver::llf_gr>(pdrive, stage);
-  } else if (rsolver_method == Hydro_RSolver::hlle_gr) {
-    CalculateFluxes<Hydro_RSolver::hlle_gr>(pdrive, stage);
-  }
-
-  // Add viscous, heat-flux, etc fluxes
-  if (pvisc != nullptr) {
-    pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
-  }
-  if (pcond != nullptr) {
-    pcond->AddHeatFlux(w0, peos->eos_data, uflx);
-  }
-
-  // call FOFC if necessary
+  // With fused flux and update kernels (in which CalculateFluxes() also updates u0),
+  // loop over sub-packs of nmb_subpack MBs so that x2/x3-fluxes are still in cache when
+  // they are used in the update.  Otherwise compute fluxes over all active MBs at once.
+  int nmba = pmy_pack->pmb->nmb_active;
+  int nsub = (nmb_subpack > 0 && fused_update)? nmb_subpack : std::max(nmba, 1);
+  for (int mbas=0; mbas<nmba; mbas+=nsub) {
+    int mbae = std::min(mbas + nsub, nmba) - 1;
+    // select which calculate_flux function to call based on rsolver_method
+    if (rsolver_method == Hydro_RSolver::advect) {
+      CalculateFluxes<Hydro_RSolver::advect>(pdrive, stage, mbas, mbae);
+    } else if (rsolver_method == Hydro_RSolver::llf) {
+      CalculateFluxes<Hydro_RSolver::llf>(pdrive, stage, mbas, mbae);
+    } else if (rsolver_method == Hydro_RSolver::hlle) {
+      CalculateFluxes<Hydro_RSolver::hlle>(pdrive, stage, mbas, mbae);
+    } else if (rsolver_method == Hydro_RSolver::hllc) {
+      CalculateFluxes<Hydro_RSolver::hllc>(pdrive, stage, mbas, mbae);
+    } else if (rsolver_method == Hydro_RSolver::roe) {
+      CalculateFluxes<Hydro_RSolver::roe>(pdrive, stage, mbas, mbae);
+    } else if (rsolver_method == Hydro_RSolver::llf_sr) {
+      CalculateFluxes<Hydro_RSolver::llf_sr>(pdrive, stage, mbas, mbae);
+    } else if (rsolver_method == Hydro_RSolver::hlle_sr) {
+      CalculateFluxes<Hydro_RSolver::hlle_sr>(pdrive, stage, mbas, mbae);
+    } else if (rsolver_method == Hydro_RSolver::hllc_sr) {
+      CalculateFluxes<Hydro_RSolver::hllc_sr>(pdrive, stage, mbas, mbae);
+    } else if (rsolver_method == Hydro_RSolver::llf_gr) {
+      CalculateFluxes<Hydro_RSolver::llf_gr>(pdrive, stage, mbas, mbae);
+    } else if (rsolver_method == Hydro_RSolver::hlle_gr) {
+      CalculateFluxes<Hydro_RSolver::hlle_gr>(pdrive, stage, mbas, mbae);
+    }
+  }
+
+  // With scalars computed separately, compute scalar fluxes from mass fluxes
+  if (scalar_chunk > 0) {
+    CalculateScalarFluxes(0, nmba-1);
+  }
+
+  // Add viscous, heat-flux, etc fluxes (unless integrated with super-time-stepping)
+  if (sts_integrator == STS_Integrator::none) {
+    if (pvisc != nullptr) {
+      pvisc->IsotropicViscousFlux(w0, pvisc->nu_iso, peos->eos_data, uflx);
+    }
+    if (pcond != nullptr) {
+      pcond->AddHeatFlux(w0, peos->eos_data, uflx);
+    }
+  }
+
+  // call FOFC if necessary (with fofc_list, FOFC is applied in RKUpdate instead)
   if (use_fofc) {
-    FOFC(pdrive, stage);
+    if (!(fofc_list)) {FOFC(pdrive, stage);}
   } else if (pmy_pack->pcoord->is_general_relativistic) {
     if (pmy_pack->pcoord->coord_data.bh_excise) {
       FOFC(pdrive, stage);
@@ -235,10 +329,17 @@ TaskStatus Hydro::HydroSrcTerms(Driver *pdrive, int stage) {
 
   // Add source terms for various physics.  Must be computed from primitives.
   if (psrc->const_accel)  psrc->ConstantAccel(w0, peos->eos_data,  beta_dt, u0);
-  if (psrc->ism_cooling)  psrc->ISMCooling(w0, peos->eos_data, beta_dt, u0);
+  if (psrc->ism_cooling && !(psrc->ism_cooling_imex)) {
+    psrc->ISMCooling(w0, peos->eos_data, beta_dt, u0);
+  }
   if (psrc->rel_cooling)  psrc->RelCooling(w0, peos->eos_data, beta_dt, u0);
   if (psrc->shearing_box) psrc->ShearingBox(w0, peos->eos_data, beta_dt, u0);
 
+  // Implicit stage of ImEx integrator for stiff cooling, using partially updated u0
+  if (psrc->ism_cooling_imex) {
+    psrc->ISMCoolingImEx(pdrive, stage, peos->eos_data, u0);
+  }
+
   // Add coordinate source terms in GR.  Again, must be computed with only primitives.
   if (pmy_pack->pcoord->is_general_relativistic) {
     pmy_pack->pcoord->CoordSrcTerms(w0, peos->eos_data, beta_dt, u0);
@@ -289,7 +390,7 @@ TaskStatus Hydro::RecvU_OA(Driver *pdrive, int stage) {
 TaskStatus Hydro::RestrictU(Driver *pdrive, int stage) {
   // Only execute Mesh function with SMR/SMR
   if (pmy_pack->pmesh->multilevel) {
-    pmy_pack->pmesh->pmr->RestrictCC(u0, coarse_u0);
+    pmy_pack->pmesh->pmr->RestrictCCBndry(u0, coarse_u0);
   }
   return TaskStatus::complete;
 }
@@ -386,7 +487,51 @@ TaskStatus Hydro::ConToPrim(Driver *pdrive, int stage) {
   int n1m1 = indcs.nx1 + 2*ng - 1;
   int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
   int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  // with fused_newdt, compute new timestep in C2P on last stage
+  peos->c2p_newdt = fused_newdt && (stage == pdrive->nexp_stages);
   peos->ConsToPrim(u0, w0, false, 0, n1m1, 0, n2m1, 0, n3m1);
+  SetNewTimeStepFromC2P();
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::ConToPrimActive
+//! \brief Wrapper task list function to call ConsToPrim over active cells only.  Used
+//! with split_c2p, since active cells do not depend on ghost zones still being received
+
+TaskStatus Hydro::ConToPrimActive(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  peos->c2p_newdt = fused_newdt && (stage == pdrive->nexp_stages);
+  peos->ConsToPrim(u0, w0, false, indcs.is, indcs.ie, indcs.js, indcs.je,
+                   indcs.ks, indcs.ke);
+  SetNewTimeStepFromC2P();
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskList Hydro::ConToPrimGhost
+//! \brief Wrapper task list function to call ConsToPrim over ghost zones only, as up to
+//! six slabs surrounding the active cells.  Used with split_c2p after ConToPrimActive.
+
+TaskStatus Hydro::ConToPrimGhost(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &ng = indcs.ng;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int n1m1 = indcs.nx1 + 2*ng - 1;
+  int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
+  int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  peos->ConsToPrim(u0, w0, false, 0, is-1, 0, n2m1, 0, n3m1);
+  peos->ConsToPrim(u0, w0, false, ie+1, n1m1, 0, n2m1, 0, n3m1);
+  if (pmy_pack->pmesh->multi_d) {
+    peos->ConsToPrim(u0, w0, false, is, ie, 0, js-1, 0, n3m1);
+    peos->ConsToPrim(u0, w0, false, is, ie, je+1, n2m1, 0, n3m1);
+  }
+  if (pmy_pack->pmesh->three_d) {
+    peos->ConsToPrim(u0, w0, false, is, ie, js, je, 0, ks-1);
+    peos->ConsToPrim(u0, w0, false, is, ie, js, je, ke+1, n3m1);
+  }
   return TaskStatus::complete;
 }
 
@@ -400,9 +545,9 @@ TaskStatus Hydro::ConToPrim(Driver *pdrive, int stage) {
 //! If stage=(-4):              clears sends of                 U_Shr
 
 TaskStatus Hydro::ClearSend(Driver *pdrive, int stage) {
-  TaskStatus tstat;
-  // check sends of U complete
-  if ((stage >= 0) || (stage == -1)) {
+  TaskStatus tstat = TaskStatus::complete;
+  // check sends of U complete, unless U is sent with radiation intensities
+  if (((stage >= 0) && !(coalesced_u)) || (stage == -1)) {
     tstat = pbval_u->ClearSend();
     if (tstat != TaskStatus::complete) return tstat;
   }
@@ -443,9 +588,9 @@ TaskStatus Hydro::ClearSend(Driver *pdrive, int stage) {
 //! If stage=(-4):              clears recvs of                 U_Shr
 
 TaskStatus Hydro::ClearRecv(Driver *pdrive, int stage) {
-  TaskStatus tstat;
-  // check receives of U complete
-  if ((stage >= 0) || (stage == -1)) {
+  TaskStatus tstat = TaskStatus::complete;
+  // check receives of U complete, unless U is received with radiation intensities
+  if (((stage >= 0) && !(coalesced_u)) || (stage == -1)) {
     tstat = pbval_u->ClearRecv();
     if (tstat != TaskStatus::complete) return tstat;
   }
@@ -13,14 +13,39 @@
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
 #include "eos/eos.hpp"
+#include "eos/ideal_c2p_hyd.hpp"
 #include "hydro.hpp"
+#include "particles/particles.hpp"
 
 namespace hydro {
 //----------------------------------------------------------------------------------------
-//! \fn  void Hydro::Update
-//  \brief Explicit RK update including flux divergence terms
+//! \fn  void Hydro::RKUpdate
+//  \brief Task list wrapper for explicit RK update of all active MBs.  With fused flux
+//  and update kernels the update has already been done in CalculateFluxes().
 
 TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
+  if (fofc_list) {
+    int nflag = ExpRKUpdateFlagFOFC(pdriver, stage);
+    if (nflag > 0) {FOFCList(pdriver, stage, nflag);}
+  } else if (!(fused_update)) {
+    ExpRKUpdate(pdriver, stage, 0, pmy_pack->pmb->nmb_active - 1);
+  }
+  // Monte Carlo tracers are moved by the mass fluxes of the last stage, while they are
+  // still in uflx
+  auto ppart = pmy_pack->ppart;
+  if (ppart != nullptr && ppart->pusher == particles::ParticlesPusher::lagrangian_mc &&
+      stage == pdriver->nexp_stages) {
+    ppart->MonteCarloTracers(uflx, u0, pmy_pack->pmesh->dt);
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Hydro::ExpRKUpdate
+//  \brief Explicit RK update including flux divergence terms, for MBs with indices
+//  [mbas,mbae] in the list of active MBs
+
+void Hydro::ExpRKUpdate(Driver *pdriver, int stage, int mbas, int mbae) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
@@ -32,7 +57,8 @@ TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
   Real &gam0 = pdriver->gam0[stage-1];
   Real &gam1 = pdriver->gam1[stage-1];
   Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
-  int nmb1 = pmy_pack->nmb_thispack - 1;
+  // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+  auto &mbact = pmy_pack->pmb->mb_active;
   int nvar = nhydro + nscalars;
   auto u0_ = u0;
   auto u1_ = u1;
@@ -47,8 +73,11 @@ TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
   int scr_level = 0;
   size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
 
-  par_for_outer("h_update",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nvar-1,ks,ke,js,je,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int j) {
+  par_for_outer("h_update",DevExeSpace(),scr_size,scr_level,mbas,mbae,0,nvar-1,
+                ks,ke,js,je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int n, const int k,
+                const int j) {
+    const int m = mbact.d_view(mm);
     ScrArray1D<Real> divf(member.team_scratch(scr_level), ncells1);
 
     // compute dF1/dx1
@@ -79,6 +108,110 @@ TaskStatus Hydro::RKUpdate(Driver *pdriver, int stage) {
       u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(m,n,k,j,i) - beta_dt*divf(i);
     });
   });
-  return TaskStatus::complete;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  int Hydro::ExpRKUpdateFlagFOFC
+//  \brief Explicit RK update of all active MBs used with <hydro>/fofc_list.  The updated
+//  state in each active cell, and in the first layer of ghost cells that share a face
+//  with active cells, is also tested for whether floors will be needed in the conversion
+//  to primitives.  Such cells are flagged and their indices appended to a compact list,
+//  which replaces the full-grid estimate of the updated state in Hydro::FOFC(). The
+//  update of active cells is identical to that in ExpRKUpdate().  Returns the number of
+//  flagged cells.
+
+int Hydro::ExpRKUpdateFlagFOFC(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+  auto &mbact = pmy_pack->pmb->mb_active;
+  int nmba = pmy_pack->pmb->nmb_active;
+  int &nhyd_ = nhydro;
+  int nvar = nhydro + nscalars;
+  auto u0_ = u0;
+  auto u1_ = u1;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &eos = peos->eos_data;
+  auto &fofc_ = fofc;
+  auto &idx_ = fofc_idx;
+  auto &nidx_ = fofc_nidx;
+  Kokkos::deep_copy(fofc_nidx, 0);
+
+  // Index bounds, including first layer of ghost cells
+  int il = is-1, iu = ie+1, jl = js, ju = je, kl = ks, ku = ke;
+  if (multi_d) { jl = js-1, ju = je+1; }
+  if (three_d) { kl = ks-1, ku = ke+1; }
+
+  par_for_outer("h_update_fofc",DevExeSpace(),0,0,0,(nmba-1),kl,ku,jl,ju,
+  KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k, const int j) {
+    const int m = mbact.d_view(mm);
+    int nout_kj = ((k < ks) || (k > ke)) + ((j < js) || (j > je));
+
+    par_for_inner(member, il, iu, [&](const int i) {
+      int nout = nout_kj + ((i < is) || (i > ie));
+      // skip ghost cells that do not share a face with an active cell
+      if (nout > 1) return;
+
+      // update all variables in active cells, and estimate hydro variables in ghost cells
+      Real unew[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+      for (int n=0; n<((nout == 0)? nvar : nhyd_); ++n) {
+        // Fluxes must be summed in pairs to symmetrize round-off error in each dir
+        Real divf = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
+        if (multi_d) {
+          divf += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+        }
+        if (three_d) {
+          divf += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+        }
+        Real u = gam0*u0_(m,n,k,j,i) + gam1*u1_(m,n,k,j,i) - beta_dt*divf;
+        if (n < nhyd_) {unew[n] = u;}
+        if (nout == 0) {u0_(m,n,k,j,i) = u;}
+      }
+
+      // test whether conversion to primitives will require floors
+      HydCons1D u;
+      u.d  = unew[IDN];
+      u.mx = unew[IM1];
+      u.my = unew[IM2];
+      u.mz = unew[IM3];
+      bool flag = false;
+      if (eos.is_ideal) {
+        u.e = unew[IEN];
+        HydPrim1D w;
+        bool dfloor_used=false, efloor_used=false, tfloor_used=false;
+        SingleC2P_IdealHyd(u, eos, w, dfloor_used, efloor_used, tfloor_used);
+        flag = (dfloor_used || efloor_used || tfloor_used);
+      } else {
+        flag = (u.d < eos.dfloor);
+      }
+
+      // flag cell and append to list
+      if (flag) {
+        fofc_(m,k,j,i) = true;
+        idx_(Kokkos::atomic_fetch_add(&nidx_(0), 1)) =
+          ((m*ncells3 + k)*ncells2 + j)*ncells1 + i;
+      }
+    });
+  });
+
+  int nflag;
+  Kokkos::deep_copy(nflag, Kokkos::subview(fofc_nidx, 0));
+  pmy_pack->pmesh->ecounter.nfofc += nflag;
+  return nflag;
 }
 } // namespace hydro
@@ -24,50 +24,57 @@ namespace hydro {
 //! \fn void HLLC
 //! \brief The HLLC Riemann solver for ideal gas hydrodynamics (use HLLE for isothermal)
 
+template <typename FlxArray>
 KOKKOS_INLINE_FUNCTION
 void HLLC(TeamMember_t const &member, const EOS_Data &eos,
      const RegionIndcs &indcs,const DualArray1D<RegionSize> &size,const CoordData &coord,
      const int m, const int k, const int j, const int il, const int iu, const int ivx,
-     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, DvceArray5D<Real> flx) {
+     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, const FlxArray &flx) {
   int ivy = IVX + ((ivx-IVX)+1)%3;
   int ivz = IVX + ((ivx-IVX)+2)%3;
 
-  Real gm1 = eos.gamma - 1.0;
-  Real igm1 = 1.0/gm1;
-  Real alpha = ((eos.gamma) + 1.0)/(2.0*(eos.gamma));
+  // all arithmetic is done in FluxReal (see athena.hpp), including constants
+  const FluxReal zero = 0.0, quarter = 0.25, half = 0.5, one = 1.0, two = 2.0;
+  const FluxReal tiny = 1.0e-20;
+  FluxReal gamma = eos.gamma;
+  FluxReal gm1 = gamma - one;
+  FluxReal igm1 = one/gm1;
+  FluxReal alpha = (gamma + one)/(two*gamma);
 
   par_for_inner(member, il, iu, [&](const int i) {
-    //--- Step 1.  Create local references for L/R states (helps compiler vectorize)
+    //--- Step 1.  Load L/R states into local variables
 
-    Real &wl_idn = wl(IDN,i);
-    Real &wl_ivx = wl(ivx,i);
-    Real &wl_ivy = wl(ivy,i);
-    Real &wl_ivz = wl(ivz,i);
+    FluxReal wl_idn = wl(IDN,i);
+    FluxReal wl_ivx = wl(ivx,i);
+    FluxReal wl_ivy = wl(ivy,i);
+    FluxReal wl_ivz = wl(ivz,i);
 
-    Real &wr_idn = wr(IDN,i);
-    Real &wr_ivx = wr(ivx,i);
-    Real &wr_ivy = wr(ivy,i);
-    Real &wr_ivz = wr(ivz,i);
+    FluxReal wr_idn = wr(IDN,i);
+    FluxReal wr_ivx = wr(ivx,i);
+    FluxReal wr_ivy = wr(ivy,i);
+    FluxReal wr_ivz = wr(ivz,i);
 
-    Real wl_ipr, wr_ipr;
-    wl_ipr = eos.IdealGasPressure(wl(IEN,i));
-    wr_ipr = eos.IdealGasPressure(wr(IEN,i));
+    // same as eos.IdealGasPressure()
+    FluxReal wl_ipr, wr_ipr;
+    wl_ipr = gm1*static_cast<FluxReal>(wl(IEN,i));
+    wr_ipr = gm1*static_cast<FluxReal>(wr(IEN,i));
 
     //--- Step 2.  Compute middle state estimates with PVRS (Toro 10.5.2)
 
     // define 6 registers used below
-    Real qa,qb,qc,qd,qe,qf;
-    qa = eos.IdealHydroSoundSpeed(wl_idn, wl_ipr);
-    qb = eos.IdealHydroSoundSpeed(wr_idn, wr_ipr);
-    Real el = wl_ipr*igm1 + 0.5*wl_idn*(SQR(wl_ivx) + SQR(wl_ivy) + SQR(wl_ivz));
-    Real er = wr_ipr*igm1 + 0.5*wr_idn*(SQR(wr_ivx) + SQR(wr_ivy) + SQR(wr_ivz));
-    qc = 0.25*(wl_idn + wr_idn)*(qa + qb);  // average density * average sound speed
-    qd = 0.5 * (wl_ipr + wr_ipr + (wl_ivx - wr_ivx) * qc);  // P_mid
+    FluxReal qa,qb,qc,qd,qe,qf;
+    // same as eos.IdealHydroSoundSpeed()
+    qa = sqrt(gamma*wl_ipr/wl_idn);
+    qb = sqrt(gamma*wr_ipr/wr_idn);
+    FluxReal el = wl_ipr*igm1 + half*wl_idn*(SQR(wl_ivx) + SQR(wl_ivy) + SQR(wl_ivz));
+    FluxReal er = wr_ipr*igm1 + half*wr_idn*(SQR(wr_ivx) + SQR(wr_ivy) + SQR(wr_ivz));
+    qc = quarter*(wl_idn + wr_idn)*(qa + qb);  // average density * average sound speed
+    qd = half * (wl_ipr + wr_ipr + (wl_ivx - wr_ivx) * qc);  // P_mid
 
     //--- Step 3.  Compute sound speed in L,R
 
-    qe = (qd <= wl_ipr) ? 1.0 : sqrt(1.0 + alpha * ((qd / wl_ipr) - 1.0));  // ql
-    qf = (qd <= wr_ipr) ? 1.0 : sqrt(1.0 + alpha * ((qd / wr_ipr) - 1.0));  // qr
+    qe = (qd <= wl_ipr) ? one : sqrt(one + alpha * ((qd / wl_ipr) - one));  // ql
+    qf = (qd <= wr_ipr) ? one : sqrt(one + alpha * ((qd / wr_ipr) - one));  // qr
 
     //--- Step 4.  Compute the max/min wave speeds based on L/R
 
@@ -75,8 +82,8 @@ void HLLC(TeamMember_t const &member, const EOS_Data &eos,
     qd = wr_ivx + qb*qf;  // ar
 
     // following min/max set to TINY_NUMBER to fix bug found in converging supersonic flow
-    qa = qd > 0.0 ? qd : 1.0e-20;   // bp
-    qb = qc < 0.0 ? qc : -1.0e-20;  // bm
+    qa = qd > zero ? qd : tiny;   // bp
+    qb = qc < zero ? qc : -tiny;  // bm
 
     //--- Step 5. Compute the contact wave speed and pressure
 
@@ -86,44 +93,50 @@ void HLLC(TeamMember_t const &member, const EOS_Data &eos,
     qc = wl_ipr + qe*wl_idn*wl_ivx;  // tl
     qd = wr_ipr + qf*wr_idn*wr_ivx;  // tr
 
-    Real ml =   wl_idn*qe;
-    Real mr = -(wr_idn*qf);
+    FluxReal ml =   wl_idn*qe;
+    FluxReal mr = -(wr_idn*qf);
 
     // Determine the contact wave speed...
-    Real am = (qc - qd)/(ml + mr);
+    FluxReal am = (qc - qd)/(ml + mr);
     // ...and the pressure at the contact surface
-    Real cp = (ml*qd + mr*qc)/(ml + mr);
-    cp = cp > 0.0 ? cp : 0.0;
+    FluxReal cp = (ml*qd + mr*qc)/(ml + mr);
+    cp = cp > zero ? cp : zero;
 
     //--- Step 6. Compute L/R fluxes along the line bm (qb), bp (qa)
 
     qe = wl_idn*(wl_ivx - qb);
     qf = wr_idn*(wr_ivx - qa);
 
-    HydCons1D fl, fr;
-    fl.d  = qe;
-    fr.d  = qf;
+    FluxReal fl_d, fr_d, fl_mx, fr_mx, fl_my, fr_my, fl_mz, fr_mz, fl_e, fr_e;
+    fl_d  = qe;
+    fr_d  = qf;
 
-    fl.mx = qe*wl_ivx + wl_ipr;
-    fr.mx = qf*wr_ivx + wr_ipr;
+    fl_mx = qe*wl_ivx + wl_ipr;
+    fr_mx = qf*wr_ivx + wr_ipr;
 
-    fl.my = qe*wl_ivy;
-    fr.my = qf*wr_ivy;
+    fl_my = qe*wl_ivy;
+    fr_my = qf*wr_ivy;
 
-    fl.mz = qe*wl_ivz;
-    fr.mz = qf*wr_ivz;
+    fl_mz = qe*wl_ivz;
+    fr_mz = qf*wr_ivz;
 
-    fl.e  = el*(wl_ivx - qb) + wl_ipr*wl_ivx;
-    fr.e  = er*(wr_ivx - qa) + wr_ipr*wr_ivx;
+    fl_e  = el*(wl_ivx - qb) + wl_ipr*wl_ivx;
+    fr_e  = er*(wr_ivx - qa) + wr_ipr*wr_ivx;
 
     //--- Step 8. Compute flux weights or scales
 
-    if (am >= 0.0) {
+    if (eos.masked_rs) {
+      // same weights as below, using selects rather than branches
+      const bool cl = (am >= zero);
+      qc = (cl)?  am/(am - qb) : zero;
+      qd = (cl)?  zero : -am/(qa - am);
+      qe = (cl)? -qb/(am - qb) : qa/(qa - am);
+    } else if (am >= zero) {
       qc =  am/(am - qb);
-      qd = 0.0;
+      qd = zero;
       qe = -qb/(am - qb);
     } else {
-      qc =  0.0;
+      qc =  zero;
       qd = -am/(qa - am);
       qe =  qa/(qa - am);
     }
@@ -131,11 +144,11 @@ void HLLC(TeamMember_t const &member, const EOS_Data &eos,
     //--- Step 9. Compute the HLLC flux at interface, including weighted contribution
     // of the flux along the contact
 
-    flx(m,IDN,k,j,i) = qc*fl.d  + qd*fr.d;
-    flx(m,ivx,k,j,i) = qc*fl.mx + qd*fr.mx + qe*cp;
-    flx(m,ivy,k,j,i) = qc*fl.my + qd*fr.my;
-    flx(m,ivz,k,j,i) = qc*fl.mz + qd*fr.mz;
-    flx(m,IEN,k,j,i) = qc*fl.e  + qd*fr.e  + qe*cp*am;
+    flx(m,IDN,k,j,i) = qc*fl_d  + qd*fr_d;
+    flx(m,ivx,k,j,i) = qc*fl_mx + qd*fr_mx + qe*cp;
+    flx(m,ivy,k,j,i) = qc*fl_my + qd*fr_my;
+    flx(m,ivz,k,j,i) = qc*fl_mz + qd*fr_mz;
+    flx(m,IEN,k,j,i) = qc*fl_e  + qd*fr_e  + qe*cp*am;
   });
   return;
 }
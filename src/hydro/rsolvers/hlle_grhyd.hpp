@@ -22,16 +22,15 @@ namespace hydro {
 //! \fn void HLLE_GR
 //! \brief HLLE for GR hydrodynamics
 
+template <typename FlxArray>
 KOKKOS_INLINE_FUNCTION
 void HLLE_GR(TeamMember_t const &member, const EOS_Data &eos,
      const RegionIndcs &indcs,const DualArray1D<RegionSize> &size,const CoordData &coord,
      const int m, const int k, const int j, const int il, const int iu, const int ivx,
-     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, DvceArray5D<Real> flx) {
+     const ScrArray2D<Real> &wl, const ScrArray2D<Real> &wr, const FlxArray &flx) {
   int ivy = IVX + ((ivx-IVX)+1)%3;
   int ivz = IVX + ((ivx-IVX)+2)%3;
   const Real gamma_prime = eos.gamma/(eos.gamma - 1.0);
-  auto &flat = coord.is_minkowski;
-  auto &spin = coord.bh_spin;
 
   int is = indcs.is;
   int js = indcs.js;
@@ -75,7 +74,7 @@ void HLLE_GR(TeamMember_t const &member, const EOS_Data &eos,
       x3v = LeftEdgeX  (k-ks, indcs.nx3, x3min, x3max);
     }
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+    FaceMetricAndInverse(coord, ivx, m, k, j, i, x1v, x2v, x3v, glower, gupper);
 
     // Calculate 4-velocity in left state (contravariant compt)
     Real q = glower[ivx][ivx] * SQR(wl_ivx) + glower[ivy][ivy] * SQR(wl_ivy) +
@@ -28,5 +28,6 @@ IonNeutral::IonNeutral(MeshBlockPack *pp, ParameterInput *pin) :
   drag_coeff = pin->GetReal("ion-neutral","drag_coeff");
   ionization_coeff = pin->GetOrAddReal("ion-neutral","ionization_coeff",0.0);
   recombination_coeff = pin->GetOrAddReal("ion-neutral","recombination_coeff",0.0);
+  local_drag = pin->GetOrAddBoolean("ion-neutral","local_drag",false);
 }
 } // namespace ion_neutral
@@ -74,6 +74,9 @@ class IonNeutral {
   Real drag_coeff;       // ion-neutral coupling coefficient, gamma
   Real ionization_coeff;         // ionization rate, xi
   Real recombination_coeff;      // recombination rate, alpha
+  // if true, the stiff terms are integrated with a Strang-split local update instead
+  // of the ImEx stages, so that no stiff source terms need to be stored between stages
+  bool local_drag;
 
   // container to hold names of TaskIDs
   IonNeutralTaskIDs id;
@@ -82,6 +85,7 @@ class IonNeutral {
   void AssembleIonNeutralTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
   TaskStatus FirstTwoImpRK(Driver* pdrive, int stage);
   TaskStatus ImpRKUpdate(Driver* pdrive, int stage);
+  void LocalDragUpdate(Real dt);
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Hydro
@@ -6,6 +6,7 @@
 //! \file ion-neutral_tasks.cpp
 //  \brief
 
+#include <cmath>
 #include <map>
 #include <memory>
 #include <string>
@@ -97,6 +98,10 @@ TaskStatus IonNeutral::FirstTwoImpRK(Driver *pdrive, int stage) {
   mhd::MHD *pmhd = pmy_pack->pmhd;
   hydro::Hydro *phyd = pmy_pack->phydro;
 
+  // With the local drag update, first half of Strang-split step is applied before the
+  // conserved variables are copied, so that explicit stages start from updated state
+  if (local_drag) {LocalDragUpdate(0.5*(pmy_pack->pmesh->dt));}
+
   // copy conserved hydro and MHD variables
   Kokkos::deep_copy(DevExeSpace(), phyd->u1, phyd->u0);
   Kokkos::deep_copy(DevExeSpace(), pmhd->u1, pmhd->u0);
@@ -104,11 +109,13 @@ TaskStatus IonNeutral::FirstTwoImpRK(Driver *pdrive, int stage) {
   Kokkos::deep_copy(DevExeSpace(), pmhd->b1.x2f, pmhd->b0.x2f);
   Kokkos::deep_copy(DevExeSpace(), pmhd->b1.x3f, pmhd->b0.x3f);
 
-  // Solve implicit equations first time (nexp_stage = -1)
-  auto status = ImpRKUpdate(pdrive, -1);
+  if (!(local_drag)) {
+    // Solve implicit equations first time (nexp_stage = -1)
+    auto status = ImpRKUpdate(pdrive, -1);
 
-  // Solve implicit equations second time (nexp_stage = 0)
-  status = ImpRKUpdate(pdrive, 0);
+    // Solve implicit equations second time (nexp_stage = 0)
+    status = ImpRKUpdate(pdrive, 0);
+  }
 
   // update primitive variables for both hydro and MHD
   auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -144,6 +151,13 @@ TaskStatus IonNeutral::ImpRKUpdate(Driver *pdriver, int estage) {
   // estage <= 0 corresponds to first two fully implicit stages
   int istage = estage + 2;
 
+  // With the local drag update, second half of Strang-split step is applied after the
+  // last explicit stage; no stiff source terms are stored between stages
+  if (local_drag) {
+    if (estage == pdriver->nexp_stages) {LocalDragUpdate(0.5*(pmy_pack->pmesh->dt));}
+    return TaskStatus::complete;
+  }
+
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int n1 = indcs.nx1 + 2*indcs.ng;
   int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
@@ -181,6 +195,41 @@ TaskStatus IonNeutral::ImpRKUpdate(Driver *pdriver, int estage) {
     });
   }
 
+  // With error control, estimate error of stiff source terms after last stage as the
+  // change in R over the step, normalized by tolerances (see Driver::ImExStepControl())
+  if (pdriver->imex_adaptive && estage == pdriver->nexp_stages) {
+    int is = indcs.is, nx1 = indcs.nx1;
+    int js = indcs.js, nx2 = indcs.nx2;
+    int ks = indcs.ks, nx3 = indcs.nx3;
+    const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+    const int nkji = nx3*nx2*nx1;
+    const int nji  = nx2*nx1;
+    int sl = pdriver->nimp_stages - 1;
+    Real rtol = pdriver->imex_rtol, atol = pdriver->imex_atol;
+    Real dt = pmy_pack->pmesh->dt;
+    auto ui = pmhd->u0;
+    auto un = phyd->u0;
+    auto ru_ = pdriver->impl_src;
+    Real err = 0.0;
+    Kokkos::parallel_reduce("imex_err",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
+    KOKKOS_LAMBDA(const int &idx, Real &max_err) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      // conserved variable corresponding to each stiff source term (see above)
+      Real u[8] = {ui(m,IM1,k,j,i), ui(m,IM2,k,j,i), ui(m,IM3,k,j,i), un(m,IM1,k,j,i),
+                   un(m,IM2,k,j,i), un(m,IM3,k,j,i), ui(m,IDN,k,j,i), un(m,IDN,k,j,i)};
+      for (int n=0; n<8; ++n) {
+        Real e = dt*fabs(ru_(sl,m,n,k,j,i) - ru_(0,m,n,k,j,i))/(atol + rtol*fabs(u[n]));
+        max_err = fmax(e, max_err);
+      }
+    }, Kokkos::Max<Real>(err));
+    pdriver->imex_err = fmax(pdriver->imex_err, err);
+  }
+
   // Update ion/neutral momentum equations with analytic solution of implicit difference
   // equations for ion-neutral drag.
   // Only required for istage = (1,2,3,[4])
@@ -274,4 +323,58 @@ TaskStatus IonNeutral::ImpRKUpdate(Driver *pdriver, int estage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn  void IonNeutral::LocalDragUpdate
+//  \brief Integrates the ion-neutral source terms over an interval dt in each cell,
+//  independent of the ImEx stages.  Densities are updated with the same analytic
+//  backward-Euler solution used in ImpRKUpdate().  With the densities then held fixed,
+//  each momentum component obeys the 2x2 linear system
+//     d(m_i)/dt = (gamma rho_i + xi) (m_i + m_n) - k m_i,   m_i + m_n = const
+//  with k = gamma (rho_i + rho_n) + xi + alpha rho_i, which is solved exactly:
+//     m_i(dt) = m_i exp(-k dt) + (gamma rho_i + xi) (m_i + m_n) (1 - exp(-k dt))/k
+//  The update is stable for any dt and needs no storage beyond the conserved variables.
+
+void IonNeutral::LocalDragUpdate(Real dt) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int n1 = indcs.nx1 + 2*indcs.ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*indcs.ng) : 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+
+  Real drag = drag_coeff;
+  Real xi = ionization_coeff;
+  Real alpha = recombination_coeff;
+  Real xi_dt = xi*dt;
+  Real alpha_dt = alpha*dt;
+  auto ui = pmy_pack->pmhd->u0;
+  auto un = pmy_pack->phydro->u0;
+  par_for("ionn_local",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    Real rho_i = ui(m,IDN,k,j,i);
+    if (alpha_dt > 0) { // to avoid division by zero
+      Real d = 1./4./alpha_dt/alpha_dt + xi_dt/2./alpha_dt/alpha_dt
+               + xi_dt*xi_dt/4./alpha_dt/alpha_dt + ui(m,IDN,k,j,i)/alpha_dt +
+               xi_dt/alpha_dt * (ui(m,IDN,k,j,i)+un(m,IDN,k,j,i));
+      rho_i = -1./2./alpha_dt - xi_dt/2./alpha_dt + sqrt(d);
+    }
+    Real rho_n = ui(m,IDN,k,j,i) + un(m,IDN,k,j,i) - rho_i;
+    ui(m,IDN,k,j,i) = rho_i;
+    un(m,IDN,k,j,i) = rho_n;
+
+    Real rate = drag*(rho_i + rho_n) + xi + alpha*rho_i;
+    Real decay = exp(-rate*dt);
+    // (1 - exp(-k dt))/k, which tends to dt as k -> 0
+    Real relax = (rate*dt > 0.0)? -expm1(-rate*dt)/rate : dt;
+    Real gain = (drag*rho_i + xi)*relax;
+    for (int n=IM1; n<=IM3; ++n) {
+      Real sum = ui(m,n,k,j,i) + un(m,n,k,j,i);
+      Real u_i = ui(m,n,k,j,i)*decay + gain*sum;
+      ui(m,n,k,j,i) = u_i;
+      un(m,n,k,j,i) = sum - u_i;
+    }
+  });
+
+  return;
+}
+
 } // namespace ion_neutral
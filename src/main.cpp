@@ -24,7 +24,10 @@
 //========================================================================================
 
 // C/C++ headers
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include <memory>
@@ -38,6 +41,7 @@
 #include "mesh/mesh.hpp"
 #include "outputs/outputs.hpp"
 #include "driver/driver.hpp"
+#include "utils/memory_registry.hpp"
 
 // MPI/OpenMP headers
 #if MPI_PARALLEL_ENABLED
@@ -52,6 +56,52 @@
 #include <hip/hip_runtime.h>
 #endif
 
+#if MPI_PARALLEL_ENABLED && !(OPENMP_PARALLEL_ENABLED)
+//----------------------------------------------------------------------------------------
+//! \fn bool AsyncOutputsRequested(int argc, char *argv[])
+//! \brief Returns true if any <output> block sets async=true in the restart and/or input
+//! files named on the command line, including command line overrides.  Called before MPI
+//! is initialized (so files are read with plain streams by every rank), to request
+//! MPI_THREAD_MULTIPLE only when outputs are written from a background thread.  Returns
+//! true if a file cannot be opened here (e.g. node-local restart files), in which case
+//! errors are reported later when the file is read.
+
+static bool AsyncOutputsRequested(int argc, char *argv[]) {
+  std::string input_file, restart_file;
+  for (int i=1; i<argc-1; i++) {
+    if (std::strcmp(argv[i], "-i") == 0) {input_file.assign(argv[i+1]);}
+    if (std::strcmp(argv[i], "-r") == 0) {restart_file.assign(argv[i+1]);}
+  }
+  ParameterInput pin;
+  for (const std::string &fname : {restart_file, input_file}) {
+    if (fname.empty()) continue;
+    std::ifstream is(fname);
+    if (!(is.is_open())) return true;
+    pin.LoadFromStream(is);   // stops at <par_end> in restart files
+  }
+  // command line overrides of async parameters that exist in the files
+  for (int i=1; i<argc; i++) {
+    std::string arg(argv[i]);
+    std::size_t slash_posn = arg.find_first_of("/");
+    std::size_t equal_posn = arg.find_first_of("=");
+    if ((slash_posn == std::string::npos) || (equal_posn == std::string::npos)) continue;
+    std::string block = arg.substr(0, slash_posn);
+    if (arg.substr(slash_posn+1, equal_posn-slash_posn-1).compare("async") == 0 &&
+        pin.DoesParameterExist(block, "async")) {
+      pin.SetString(block, "async", arg.substr(equal_posn+1));
+    }
+  }
+  for (auto &b : pin.block) {
+    if (b.block_name.compare(0, 6, "output") == 0 &&
+        pin.DoesParameterExist(b.block_name, "async") &&
+        pin.GetBoolean(b.block_name, "async")) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif
+
 //----------------------------------------------------------------------------------------
 //! \fn int main(int argc, char *argv[])
 //! \brief Athena main program
@@ -90,7 +140,16 @@ int main(int argc, char *argv[]) {
     return(0);
   }
 #else  // no OpenMP
-  if (MPI_SUCCESS != MPI_Init(&argc, &argv)) {
+  // MPI_THREAD_MULTIPLE is requested only if outputs with async=true will write from a
+  // background thread.  Outputs check the level actually provided.
+  int mpi_status;
+  if (AsyncOutputsRequested(argc, argv)) {
+    int mpiprv;
+    mpi_status = MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mpiprv);
+  } else {
+    mpi_status = MPI_Init(&argc, &argv);
+  }
+  if (MPI_SUCCESS != mpi_status) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
               << "MPI Initialization failed." << std::endl;
     return(0);
@@ -111,6 +170,21 @@ int main(int argc, char *argv[]) {
     MPI_Finalize();
     return(0);
   }
+
+  // Number of bits for MeshBlock local IDs in MPI tags, from the largest tag supported
+  // by this MPI library (leaving NUM_BITS_BUFID bits for the buffer ID).  This sets the
+  // maximum number of MeshBlocks per rank.
+  {
+    void *tag_ub_ptr;
+    int flag;
+    MPI_Comm_get_attr(MPI_COMM_WORLD, MPI_TAG_UB, &tag_ub_ptr, &flag);
+    if (flag) {
+      int tag_ub = *static_cast<int*>(tag_ub_ptr);
+      int nbits_tag = 0;
+      while ((nbits_tag < 31) && ((tag_ub >> nbits_tag) > 0)) {nbits_tag++;}
+      global_variable::nbits_lid = std::max(NUM_BITS_LID, nbits_tag - NUM_BITS_BUFID);
+    }
+  }
 #else  // no MPI
   global_variable::my_rank = 0;
   global_variable::nranks  = 1;
@@ -230,8 +304,59 @@ int main(int argc, char *argv[]) {
 
   ParameterInput* pinput = new ParameterInput;
   IOWrapper infile, restartfile;
-  // read parameters from restart file
+  // read parameters from restart file.  If the shared restart file does not exist, each
+  // node reads its own node-local restart file (see restart.cpp), which requires the same
+  // number of ranks per node as when the files were written.
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm rst_comm = MPI_COMM_WORLD;
+#endif
+  // With an <id_cache> block in the input file, restart from the initial-data cache
+  // written by an earlier run with the same initial data if it exists, skipping the
+  // ProblemGenerator (see utils/id_cache.cpp).  Parameters in the input file override
+  // those in the cache file, exactly as when both -r and -i are specified.
+  bool id_cache_hit = false;
+  std::string id_cache_name;
+  if (!res_flag && iarg_flag) {
+    ParameterInput idpin;
+    IOWrapper idfile;
+    idfile.Open(input_file.c_str(), IOWrapper::FileMode::read);
+    idpin.LoadFromFile(idfile);
+    idfile.Close();
+    idpin.ModifyFromCmdline(argc, argv);
+    if (idpin.DoesBlockExist("id_cache")) {
+      id_cache_name = InitialDataCacheName(&idpin);
+      std::string fname = "rst/" + id_cache_name + ".00000.rst";
+      std::FILE *fp = std::fopen(fname.c_str(), "rb");
+      int found = (fp == nullptr)? 0 : 1;
+      if (fp != nullptr) {std::fclose(fp);}
+#if MPI_PARALLEL_ENABLED
+      MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+      if (found) {
+        res_flag = true;
+        id_cache_hit = true;
+        restart_file = fname;
+        if (global_variable::my_rank == 0) {
+          std::cout << "Initial data read from cache file '" << fname << "'" << std::endl;
+        }
+      }
+    }
+  }
   if (res_flag) {
+    std::FILE *fp = std::fopen(restart_file.c_str(), "rb");
+    int missing = (fp == nullptr)? 1 : 0;
+    if (fp != nullptr) {std::fclose(fp);}
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &missing, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (missing) {
+      int node_id;
+      NodeCommunicator(&rst_comm, &node_id);
+      restart_file = NodeLocalFileName(restart_file, node_id);
+      restartfile.SetCommunicator(rst_comm);
+    }
+#else
+    if (missing) {restart_file = NodeLocalFileName(restart_file, 0);}
+#endif
     restartfile.Open(restart_file.c_str(), IOWrapper::FileMode::read);
     pinput->LoadFromFile(restartfile);
   }
@@ -256,16 +381,68 @@ int main(int argc, char *argv[]) {
     return(0);
   }
 
+  // team size of outer parallel loops (0 for Kokkos::AUTO) and scratch level of flux
+  // kernels, as reported by tuning mode
+  global_variable::team_size = pinput->GetOrAddInteger("job", "team_size", 0);
+  global_variable::scratch_level = pinput->GetOrAddInteger("job", "scratch_level", 0);
+  // per-kernel overrides of execution policies (tile sizes and team sizes)
+  kernel_tuning::Initialize(pinput);
+
+  // In tuning mode, benchmark candidate configurations of the problem and quit
+  // (see utils/autotune.cpp)
+  if (pinput->GetOrAddBoolean("job", "autotune", false)) {
+    if (res_flag) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<job>/autotune cannot be used with restarts"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    Autotune(pinput);
+    delete pinput;
+    Kokkos::finalize();
+#if MPI_PARALLEL_ENABLED
+    MPI_Finalize();
+#endif
+    return(0);
+  }
+
+  // In ensemble mode, run each member of the ensemble in its own directory and quit
+  // (see utils/ensemble.cpp)
+  if (pinput->GetOrAddBoolean("job", "ensemble", false)) {
+    if (res_flag) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<job>/ensemble cannot be used with restarts"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    ChangeRunDir(run_dir);
+    RunEnsemble(pinput, wtlim, &timer);
+    delete pinput;
+    Kokkos::finalize();
+#if MPI_PARALLEL_ENABLED
+    MPI_Finalize();
+#endif
+    return(0);
+  }
+
   //--- Step 4. --------------------------------------------------------------------------
   // Construct Mesh.  Then build MeshBlockTree and add MeshBlockPack containing MeshBlocks
   // on this rank.  Latter cannot be performed in Mesh constructor since it requires
   // pointer to Mesh.
 
-  Mesh* pmesh = new Mesh(pinput);
-  if (!res_flag) {
-    pmesh->BuildTreeFromScratch(pinput);
-  } else {
-    pmesh->BuildTreeFromRestart(pinput, restartfile);
+  // record device memory of each module (reported by Driver), starting with the Mesh
+  if (pinput->GetOrAddBoolean("job", "memory_registry", false)) {
+    memory_registry::Enable();
+  }
+  Mesh* pmesh;
+  {
+    memory_registry::Scope mem_scope("mesh");
+    pmesh = new Mesh(pinput);
+    if (!res_flag) {
+      pmesh->BuildTreeFromScratch(pinput);
+    } else {
+      pmesh->BuildTreeFromRestart(pinput, restartfile);
+    }
   }
 
   //  If code was run with -m option, write mesh structure to file and quit.
@@ -287,13 +464,23 @@ int main(int argc, char *argv[]) {
   // is fully constructed.
 
   pmesh->AddCoordinatesAndPhysics(pinput);
-  if (!res_flag) {
-    // set ICs using ProblemGenerator constructor for new runs
-    pmesh->pgen = std::make_unique<ProblemGenerator>(pinput, pmesh);
-  } else {
-    // read ICs from restart file using ProblemGenerator constructor for restarts
-    pmesh->pgen = std::make_unique<ProblemGenerator>(pinput, pmesh, restartfile);
-    restartfile.Close();
+  {
+    memory_registry::Scope mem_scope("pgen");
+    if (!res_flag) {
+      // set ICs using ProblemGenerator constructor for new runs
+      pmesh->pgen = std::make_unique<ProblemGenerator>(pinput, pmesh);
+      // write initial-data cache for later runs
+      if (!(id_cache_name.empty())) {
+        WriteInitialDataCache(pinput, pmesh, id_cache_name);
+      }
+    } else {
+      // read ICs from restart file using ProblemGenerator constructor for restarts
+      pmesh->pgen = std::make_unique<ProblemGenerator>(pinput, pmesh, restartfile);
+      restartfile.Close();
+#if MPI_PARALLEL_ENABLED
+      if (rst_comm != MPI_COMM_WORLD) {MPI_Comm_free(&rst_comm);}
+#endif
+    }
   }
 
   //--- Step 6. --------------------------------------------------------------------------
@@ -302,7 +489,11 @@ int main(int argc, char *argv[]) {
 
   ChangeRunDir(run_dir);
   Driver* pdriver = new Driver(pinput, pmesh, wtlim, &timer);
-  Outputs* pout = new Outputs(pinput, pmesh);
+  Outputs* pout;
+  {
+    memory_registry::Scope mem_scope("outputs");
+    pout = new Outputs(pinput, pmesh);
+  }
 
   //--- Step 7. --------------------------------------------------------------------------
   // Execute Driver.
@@ -310,7 +501,8 @@ int main(int argc, char *argv[]) {
   //    2. TaskList(s) executed in Driver::Execute()
   //    3. Any final analysis or diagnostics run in Driver::Finalize()
 
-  pdriver->Initialize(pmesh, pinput, pout, res_flag);
+  // runs started from the initial-data cache write initial outputs like new runs
+  pdriver->Initialize(pmesh, pinput, pout, (res_flag && !(id_cache_hit)));
   pdriver->Execute(pmesh, pinput, pout);
   pdriver->Finalize(pmesh, pinput, pout);
 
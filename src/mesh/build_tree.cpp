@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <cinttypes>
+#include <cstring> // memcpy
 #include <limits> // numeric_limits<>
 #include <memory> // make_unique<>
 
@@ -238,8 +239,9 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
   gids_eachrank = new int[global_variable::nranks];
   nmb_eachrank = new int[global_variable::nranks];
 
-  // following returns LogicalLocation list sorted by Z-ordering, and total # of MBs
-  ptree->CreateZOrderedLLList(lloc_eachmb, nullptr, nmb_total);
+  // following returns LogicalLocation list sorted along space-filling curve (selected
+  // by <load_balancing>/ordering), and total # of MBs
+  ptree->CreateOrderedLLList(lloc_eachmb, nullptr, nmb_total);
 
 #if MPI_PARALLEL_ENABLED
   // check there is at least one MeshBlock per MPI rank
@@ -266,11 +268,15 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
   pmb_pack->AddMeshBlocks(pin);
   pmb_pack->pmb->SetNeighbors(ptree, rank_eachmb);
 
-  // Fix maximum number of MeshBlocks per rank with AMR
+  // Fix maximum number of MeshBlocks per rank with AMR, either given directly or by
+  // the memory of each device and of each MeshBlock
   nmb_maxperrank = nmb_thisrank;
   if (adaptive) {
-    if (pin->DoesParameterExist("mesh_refinement", "max_nmb_per_rank")) {
-      nmb_maxperrank = pin->GetReal("mesh_refinement", "max_nmb_per_rank");
+    int ncapacity = DeviceMeshBlockCapacity(pin);
+    if (pin->DoesParameterExist("mesh_refinement", "max_nmb_per_rank") ||
+        ncapacity > 0) {
+      nmb_maxperrank = pin->GetOrAddInteger("mesh_refinement", "max_nmb_per_rank",
+                                            ncapacity);
       if (nmb_maxperrank < nmb_thisrank) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << "On rank=" << global_variable::my_rank << " Root grid requires "
@@ -281,22 +287,42 @@ void Mesh::BuildTreeFromScratch(ParameterInput *pin) {
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
         << std::endl << "With AMR maximum number of MeshBlocks per rank must be "
-        << "specified in input file using <mesh_refinement>/max_nmb_per_rank"
-        << std::endl;
+        << "specified in input file using <mesh_refinement>/max_nmb_per_rank, or "
+        << "<job>/device_memory and <mesh_refinement>/meshblock_memory" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  // Reserve space for MBs moved between ranks by incremental rebalancing without AMR
+  if (rebalance && !adaptive) {
+    nmb_maxperrank = pin->GetOrAddInteger("load_balancing", "max_nmb_per_rank",
+                                          nmb_thisrank + 2*max_migrate);
+    if (nmb_maxperrank < nmb_thisrank) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "On rank=" << global_variable::my_rank << " Root grid requires "
+        << "more MeshBlocks (nmb_thisrank=" << nmb_thisrank << ") than specified by "
+        << "<load_balancing>/max_nmb_per_rank=" << nmb_maxperrank << std::endl;
       std::exit(EXIT_FAILURE);
     }
   }
 #if MPI_PARALLEL_ENABLED
-  if (nmb_maxperrank > (1 << (NUM_BITS_LID))) {
+  if (nmb_maxperrank > (1 << (global_variable::nbits_lid))) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
-      << "Maximum number of MeshBlocks per rank cannot exceed 2^(NUM_BITS_LID) due to MPI"
-      << " tag limits" << std::endl;
+      << "Maximum number of MeshBlocks per rank cannot exceed 2^"
+      << global_variable::nbits_lid << " due to MPI tag limit (MPI_TAG_UB) of MPI library"
+      << std::endl;
     std::exit(EXIT_FAILURE);
   }
 #endif
 
-  // Create new MeshRefinement object with either SMR or AMR (SMR needs Restrict fns)
-  if (multilevel) {
+  // allocate storage for work recorded in kernels with measured cost model
+  if (cost_model.measured) {
+    Kokkos::realloc(cost_model.work_eachmb, nmb_maxperrank);
+    ResetMeasuredCost();
+  }
+
+  // Create new MeshRefinement object with either SMR or AMR (SMR needs Restrict fns),
+  // or with incremental rebalancing (which uses the AMR load balancing functions)
+  if (multilevel || rebalance) {
     pmr = new MeshRefinement(this, pin);
   }
 
@@ -426,15 +452,29 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile) {
 
   // check the tree structure by making sure total # of MBs counted in tree same as the
   // number read from the restart file.
+  // Also check ordering of MBs in tree is same as in restart file.
   {
+    LogicalLocation *file_lloc = new LogicalLocation[nmb_total];
+    std::memcpy(file_lloc, lloc_eachmb, nmb_total*sizeof(LogicalLocation));
     int nnb;
-    ptree->CreateZOrderedLLList(lloc_eachmb, nullptr, nnb);
+    ptree->CreateOrderedLLList(lloc_eachmb, nullptr, nnb);
     if (nnb != nmb_total) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
         << std::endl << "Tree reconstruction failed. Total number of blocks in "
         << "reconstructed tree=" << nnb << ", number in file=" << nmb_total << std::endl;
       std::exit(EXIT_FAILURE);
     }
+    for (int i=0; i<nmb_total; i++) {
+      if (lloc_eachmb[i].lx1 != file_lloc[i].lx1 || lloc_eachmb[i].lx2 != file_lloc[i].lx2
+       || lloc_eachmb[i].lx3 != file_lloc[i].lx3 ||
+          lloc_eachmb[i].level != file_lloc[i].level) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Ordering of MeshBlocks in reconstructed tree differs from "
+          << "restart file. Check <load_balancing>/ordering is unchanged." << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+    delete [] file_lloc;
   }
 
 #ifdef MPI_PARALLEL_ENABLED
@@ -458,11 +498,15 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile) {
   pmb_pack->AddMeshBlocks(pin);
   pmb_pack->pmb->SetNeighbors(ptree, rank_eachmb);
 
-  // Fix maximum number of MeshBlocks per rank with AMR
+  // Fix maximum number of MeshBlocks per rank with AMR, either given directly or by
+  // the memory of each device and of each MeshBlock
   nmb_maxperrank = nmb_thisrank;
   if (adaptive) {
-    if (pin->DoesParameterExist("mesh_refinement", "max_nmb_per_rank")) {
-      nmb_maxperrank = pin->GetReal("mesh_refinement", "max_nmb_per_rank");
+    int ncapacity = DeviceMeshBlockCapacity(pin);
+    if (pin->DoesParameterExist("mesh_refinement", "max_nmb_per_rank") ||
+        ncapacity > 0) {
+      nmb_maxperrank = pin->GetOrAddInteger("mesh_refinement", "max_nmb_per_rank",
+                                            ncapacity);
       if (nmb_maxperrank < nmb_thisrank) {
         std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
           << std::endl << "On rank=" << global_variable::my_rank << " Root grid requires "
@@ -473,14 +517,33 @@ void Mesh::BuildTreeFromRestart(ParameterInput *pin, IOWrapper &resfile) {
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
         << std::endl << "With AMR maximum number of MeshBlocks per rank must be "
-        << "specified in input file using <mesh_refinement>/max_nmb_per_rank"
-        << std::endl;
+        << "specified in input file using <mesh_refinement>/max_nmb_per_rank, or "
+        << "<job>/device_memory and <mesh_refinement>/meshblock_memory" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  // Reserve space for MBs moved between ranks by incremental rebalancing without AMR
+  if (rebalance && !adaptive) {
+    nmb_maxperrank = pin->GetOrAddInteger("load_balancing", "max_nmb_per_rank",
+                                          nmb_thisrank + 2*max_migrate);
+    if (nmb_maxperrank < nmb_thisrank) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "On rank=" << global_variable::my_rank << " Root grid requires "
+        << "more MeshBlocks (nmb_thisrank=" << nmb_thisrank << ") than specified by "
+        << "<load_balancing>/max_nmb_per_rank=" << nmb_maxperrank << std::endl;
       std::exit(EXIT_FAILURE);
     }
   }
 
-  // Create new MeshRefinement object with either SMR or AMR (SMR needs Restrict fns)
-  if (multilevel) {
+  // allocate storage for work recorded in kernels with measured cost model
+  if (cost_model.measured) {
+    Kokkos::realloc(cost_model.work_eachmb, nmb_maxperrank);
+    ResetMeasuredCost();
+  }
+
+  // Create new MeshRefinement object with either SMR or AMR (SMR needs Restrict fns),
+  // or with incremental rebalancing (which uses the AMR load balancing functions)
+  if (multilevel || rebalance) {
     pmr = new MeshRefinement(this, pin);
   }
 
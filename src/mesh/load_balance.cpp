@@ -11,30 +11,106 @@
 #include <limits> // numeric_limits<>
 #include <algorithm> // max
 #include <utility> // make_pair
+#include <vector>
+#include <cmath>  // abs
 
 #include "athena.hpp"
 #include "globals.hpp"
 #include "mesh.hpp"
+#include "bvals/comm_stats.hpp"
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "z4c/z4c.hpp"
+#include "coordinates/coordinates.hpp"
+#include "particles/particles.hpp"
 
 #if MPI_PARALLEL_ENABLED
 #include <mpi.h>
 #endif
 
 //----------------------------------------------------------------------------------------
-//! \fn void Mesh::LoadBalance(double *clist, int *rlist, int *slist, int *nlist, int nb)
+//! \fn PrefixPartition()
+//! \brief Partitions the MBs with indices [bs,be) into nparts contiguous parts, where the
+//! cost of part p is proportional to wght[p].  Computes the prefix sum of costs, and cuts
+//! it at the nearest MB to each target cost.  If prev_cut != nullptr, the cut before
+//! each part p is moved to prev_cut[p] whenever the resulting cumulative cost is within
+//! tol*(target cost of part) of the target, which minimizes the number of MBs that move
+//! between parts.  Returns start index of each part in cut[] (with cut[0]=bs).
+
+namespace {
+void PrefixPartition(const float *clist, int bs, int be, int nparts, const float *wght,
+                     const int *prev_cut, float tol, int *cut) {
+  int nb = be - bs;
+  std::vector<double> psum(nb+1, 0.0);
+  for (int i=0; i<nb; ++i) {psum[i+1] = psum[i] + clist[bs+i];}
+  double wtot = 0.0;
+  for (int p=0; p<nparts; ++p) {wtot += wght[p];}
+
+  cut[0] = bs;
+  double wcum = 0.0;
+  int i = 0;
+  for (int p=1; p<nparts; ++p) {
+    wcum += wght[p-1];
+    double target = psum[nb]*wcum/wtot;
+    // find first index with prefix sum >= target, then choose nearest of i-1,i
+    while (i < nb && psum[i] < target) {i++;}
+    int icut = i;
+    if (i > 0 && (target - psum[i-1]) < (psum[i] - target)) {icut = i-1;}
+    // try to keep previous cut if within tolerance
+    if (prev_cut != nullptr) {
+      int iprev = prev_cut[p] - bs;
+      double tol_cost = tol*psum[nb]*wght[p-1]/wtot;
+      if (iprev > 0 && iprev < nb && std::abs(psum[iprev] - target) <= tol_cost) {
+        icut = iprev;
+      }
+    }
+    // every part must contain at least one MB
+    icut = std::max(icut, (cut[p-1] - bs) + 1);
+    icut = std::min(icut, nb - (nparts - p));
+    cut[p] = bs + icut;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn LimitPartition()
+//! \brief Moves the cuts between nparts contiguous parts of nb MBs (start index of each
+//! part in cut[], with cut[0]=0) by the least amount needed so that no part contains
+//! more than nmax MBs, while every part keeps at least one MB.  Cuts that already satisfy
+//! the bound are not changed, so the cost balance of the other parts is kept.  Requires
+//! nparts <= nb <= nparts*nmax.
+
+void LimitPartition(int nb, int nparts, int nmax, int *cut) {
+  cut[0] = 0;
+  for (int p=1; p<nparts; ++p) {
+    int lo = std::max(nb - (nparts - p)*nmax, cut[p-1] + 1);
+    int hi = std::min(nb - (nparts - p), cut[p-1] + nmax);
+    cut[p] = std::min(std::max(cut[p], lo), hi);
+  }
+  return;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb,
+//!                            const int *prev_slist)
 //! \brief Calculate distribution of MeshBlocks across ranks based on input cost list
 //! input: clist = cost of each MB (array of length nmbtotal)
 //!        nb = number of MeshBlocks
+//!        prev_slist = (optional) previous starting gid of MBs on each rank, mapped to
+//!                     gids in new list. Used by prefix/hierarchical partitioners to
+//!                     minimize migration of MBs.
 //! output: rlist = rank to which each MB is assigned (array of length nmbtotal)
 //!         slist = starting grid ID (gid) for MB on each rank (array of length nrank)
 //!         nlist = number of MBs on each rank (array of length nrank)
 //! With multiple ranks in MPI, this function is needed even on a uniform mesh and not
 //! just for SMR/AMR, which is why it is part of the Mesh and not MeshRefinement class.
+//! With all partitioners, MBs on each rank are contiguous along the space-filling curve,
+//! and with AMR no rank is assigned more than nmb_maxperrank MBs (the MBs for which
+//! memory is allocated on each device), once it is set.
 
-void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb) {
+void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb,
+                       const int *prev_slist) {
   float min_cost = std::numeric_limits<float>::max();
   float max_cost = 0.0, totalcost = 0.0;
   // find min/max and total cost in clist
@@ -43,37 +119,113 @@ void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb)
     min_cost = std::min(min_cost,clist[i]);
     max_cost = std::max(max_cost,clist[i]);
   }
+  int nranks = global_variable::nranks;
 
-  int j = (global_variable::nranks) - 1;
-  float targetcost = totalcost/global_variable::nranks;
-  float mycost = 0.0;
-  // create rank list from the end: the master MPI rank should have less load
-  for (int i=nb-1; i>=0; i--) {
-    if (targetcost == 0.0) {
+  if (partition_method == PartitionMethod::greedy || nranks == 1) {
+    int j = nranks - 1;
+    float targetcost = totalcost/nranks;
+    float mycost = 0.0;
+    // create rank list from the end: the master MPI rank should have less load
+    for (int i=nb-1; i>=0; i--) {
+      if (targetcost == 0.0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "There is at least one process which has no MeshBlock"
+                  << std::endl << "Decrease the number of processes or use smaller "
+                  << "MeshBlocks." << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      mycost += clist[i];
+      rlist[i] = j;
+      if (mycost >= targetcost && j>0) {
+        j--;
+        totalcost -= mycost;
+        mycost = 0.0;
+        targetcost = totalcost/(j+1);
+      }
+    }
+    slist[0] = 0;
+    j = 0;
+    for (int i=1; i<nb; i++) { // make the list of nbstart and nblocks
+      if (rlist[i] != rlist[i-1]) {
+        nlist[j] = i-slist[j];
+        slist[++j] = i;
+      }
+    }
+    nlist[j] = nb-slist[j];
+  } else {
+    if (nb < nranks) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                 << std::endl << "There is at least one process which has no MeshBlock"
                 << std::endl << "Decrease the number of processes or use smaller "
                 << "MeshBlocks." << std::endl;
       std::exit(EXIT_FAILURE);
     }
-    mycost += clist[i];
-    rlist[i] = j;
-    if (mycost >= targetcost && j>0) {
-      j--;
-      totalcost -= mycost;
-      mycost = 0.0;
-      targetcost = totalcost/(j+1);
+    std::vector<float> rwght(nranks, 1.0);
+    if (partition_method == PartitionMethod::hierarchical && nnodes > 1) {
+      // first partition over nodes (weighted by number of ranks on each node), then over
+      // ranks within each node. Ranks on each node are consecutive (see InitNodeLayout)
+      std::vector<float> nwght(nnodes);
+      std::vector<int> ncut(nnodes), nprev(nnodes), rank0(nnodes);
+      rank0[0] = 0;
+      for (int n=0; n<nnodes; ++n) {
+        nwght[n] = static_cast<float>(nranks_eachnode[n]);
+        if (n > 0) {rank0[n] = rank0[n-1] + nranks_eachnode[n-1];}
+        nprev[n] = (prev_slist != nullptr)? prev_slist[rank0[n]] : 0;
+      }
+      PrefixPartition(clist, 0, nb, nnodes, nwght.data(),
+                      ((prev_slist != nullptr)? nprev.data() : nullptr), migration_tol,
+                      ncut.data());
+      for (int n=0; n<nnodes; ++n) {
+        int bs = ncut[n];
+        int be = (n < nnodes-1)? ncut[n+1] : nb;
+        if (be - bs < nranks_eachnode[n]) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                    << std::endl << "Node " << n << " has fewer MeshBlocks than ranks."
+                    << std::endl << "Decrease the number of processes or use smaller "
+                    << "MeshBlocks." << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+        PrefixPartition(clist, bs, be, nranks_eachnode[n], &(rwght[rank0[n]]),
+                        ((prev_slist != nullptr)? &(prev_slist[rank0[n]]) : nullptr),
+                        migration_tol, &(slist[rank0[n]]));
+      }
+    } else {
+      PrefixPartition(clist, 0, nb, nranks, rwght.data(), prev_slist, migration_tol,
+                      slist);
+    }
+    for (int r=0; r<nranks; ++r) {
+      int be = (r < nranks-1)? slist[r+1] : nb;
+      nlist[r] = be - slist[r];
+      for (int i=slist[r]; i<be; ++i) {rlist[i] = r;}
     }
   }
-  slist[0] = 0;
-  j = 0;
-  for (int i=1; i<nb; i++) { // make the list of nbstart and nblocks
-    if (rlist[i] != rlist[i-1]) {
-      nlist[j] = i-slist[j];
-      slist[++j] = i;
+
+  // With AMR, device memory is allocated for <mesh_refinement>/max_nmb_per_rank MBs on
+  // every rank (once set), which is a hard bound on the number of MBs on each rank.  Move
+  // partition cuts where it is exceeded.
+  if (adaptive && nmb_maxperrank > 0 && nranks > 1) {
+    if (nb > nranks*nmb_maxperrank) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Number of MeshBlocks (" << nb << ") exceeds the number "
+                << "that fit in device memory on all ranks (" << nranks << " x "
+                << nmb_maxperrank << ")" << std::endl << "Increase "
+                << "<mesh_refinement>/max_nmb_per_rank or the number of processes"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    bool exceeded = false;
+    for (int r=0; r<nranks; ++r) {
+      if (nlist[r] > nmb_maxperrank) {exceeded = true;}
+    }
+    if (exceeded && nb >= nranks) {
+      LimitPartition(nb, nranks, nmb_maxperrank, slist);
+      for (int r=0; r<nranks; ++r) {
+        int be = (r < nranks-1)? slist[r+1] : nb;
+        nlist[r] = be - slist[r];
+        for (int i=slist[r]; i<be; ++i) {rlist[i] = r;}
+      }
     }
   }
-  nlist[j] = nb-slist[j];
 
 #if MPI_PARALLEL_ENABLED
   if (nb % global_variable::nranks != 0
@@ -86,6 +238,322 @@ void Mesh::LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb)
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::DiffusiveLoadBalance(float *clist, int *rlist, int *slist, int *nlist,
+//!                                     int nb)
+//! \brief Incrementally improves the current distribution of MeshBlocks across ranks
+//! (stored in gids_eachrank/nmb_eachrank) by shifting the boundaries between neighboring
+//! ranks along the space-filling curve.  In each of max_migrate passes, the MB at each
+//! boundary is moved from the more-loaded to the less-loaded rank whenever this reduces
+//! the maximum cost of the two ranks.  Thus at most max_migrate MBs cross each boundary,
+//! and only MBs at rank boundaries migrate (first-order diffusion of load).
+//! Input/output arrays are same as LoadBalance(); total number of MBs nb is unchanged.
+
+void Mesh::DiffusiveLoadBalance(float *clist, int *rlist, int *slist, int *nlist,
+                                int nb) {
+  int nranks = global_variable::nranks;
+  std::vector<float> rcost(nranks, 0.0);
+  for (int r=0; r<nranks; ++r) {
+    slist[r] = gids_eachrank[r];
+    nlist[r] = nmb_eachrank[r];
+    for (int i=slist[r]; i<slist[r]+nlist[r]; ++i) {rcost[r] += clist[i];}
+  }
+
+  for (int pass=0; pass<max_migrate; ++pass) {
+    bool moved = false;
+    for (int r=0; r<nranks-1; ++r) {
+      int b = slist[r+1];   // first MB on rank r+1
+      float cmax = std::max(rcost[r], rcost[r+1]);
+      if (rcost[r] > rcost[r+1] && nlist[r] > 1 && nlist[r+1] < nmb_maxperrank &&
+          std::max(rcost[r] - clist[b-1], rcost[r+1] + clist[b-1]) < cmax) {
+        // move last MB on rank r to rank r+1
+        rcost[r] -= clist[b-1];
+        rcost[r+1] += clist[b-1];
+        slist[r+1]--;
+        nlist[r]--;
+        nlist[r+1]++;
+        moved = true;
+      } else if (rcost[r+1] > rcost[r] && nlist[r+1] > 1 && nlist[r] < nmb_maxperrank &&
+          std::max(rcost[r] + clist[b], rcost[r+1] - clist[b]) < cmax) {
+        // move first MB on rank r+1 to rank r
+        rcost[r] += clist[b];
+        rcost[r+1] -= clist[b];
+        slist[r+1]++;
+        nlist[r]++;
+        nlist[r+1]--;
+        moved = true;
+      }
+    }
+    if (!moved) {break;}
+  }
+
+  for (int r=0; r<nranks; ++r) {
+    for (int i=slist[r]; i<slist[r]+nlist[r]; ++i) {rlist[i] = r;}
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int Mesh::DeviceMeshBlockCapacity(ParameterInput *pin)
+//! \brief Returns number of MeshBlocks that fit in the memory of each device, computed
+//! from the memory of the device <job>/device_memory (in GB), the fraction of it that may
+//! be used by MeshBlocks <mesh_refinement>/memory_fraction (default 0.8, the rest is left
+//! for particles, communication buffers, and outputs), and the device memory used by each
+//! MeshBlock <mesh_refinement>/meshblock_memory (in MiB, the "per MB" total reported with
+//! <job>/memory_registry=true).  Returns 0 if either memory is not set.
+
+int Mesh::DeviceMeshBlockCapacity(ParameterInput *pin) {
+  double device_gb = pin->GetOrAddReal("job", "device_memory", 0.0);
+  double mb_mib = pin->GetOrAddReal("mesh_refinement", "meshblock_memory", 0.0);
+  if (device_gb <= 0.0 || mb_mib <= 0.0) {return 0;}
+  double frac = pin->GetOrAddReal("mesh_refinement", "memory_fraction", 0.8);
+  return static_cast<int>(frac*device_gb*1.0e9/(mb_mib*1024.0*1024.0));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn float Mesh::LoadEfficiency()
+//! \brief Returns load balance efficiency of current distribution of MBs, defined as
+//! (mean cost per rank)/(maximum cost per rank) using cost_eachmb[].  Equal to one for
+//! perfect balance.
+
+float Mesh::LoadEfficiency() {
+  float max_cost = 0.0, totalcost = 0.0;
+  for (int r=0; r<global_variable::nranks; ++r) {
+    float rcost = 0.0;
+    for (int i=gids_eachrank[r]; i<gids_eachrank[r]+nmb_eachrank[r]; ++i) {
+      rcost += cost_eachmb[i];
+    }
+    totalcost += rcost;
+    max_cost = std::max(max_cost, rcost);
+  }
+  if (max_cost <= 0.0) {return 1.0;}
+  return totalcost/(static_cast<float>(global_variable::nranks)*max_cost);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::InitNodeLayout()
+//! \brief Finds number of ranks on each shared-memory node, used by hierarchical
+//! partitioner.  Requires ranks on each node to be numbered consecutively (the default
+//! placement for most MPI launchers); otherwise falls back to a flat prefix partition.
+
+void Mesh::InitNodeLayout() {
+  nnodes = 1;
+  delete [] nranks_eachnode;
+  nranks_eachnode = new int[1];
+  nranks_eachnode[0] = global_variable::nranks;
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, global_variable::my_rank,
+                      MPI_INFO_NULL, &node_comm);
+  int node_rank;
+  MPI_Comm_rank(node_comm, &node_rank);
+  // label each node by the lowest world rank on it
+  int node_label = global_variable::my_rank - node_rank;
+  MPI_Comm_free(&node_comm);
+  std::vector<int> label_eachrank(global_variable::nranks);
+  MPI_Allgather(&node_label, 1, MPI_INT, label_eachrank.data(), 1, MPI_INT,
+                MPI_COMM_WORLD);
+
+  std::vector<int> nrank_node;
+  bool consecutive = true;
+  for (int r=0; r<global_variable::nranks; ++r) {
+    if (r == 0 || label_eachrank[r] != label_eachrank[r-1]) {
+      if (label_eachrank[r] != r) {consecutive = false;}
+      nrank_node.push_back(1);
+    } else {
+      nrank_node.back()++;
+    }
+  }
+  if (!consecutive) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Ranks on each node are not numbered consecutively, hierarchical "
+                << "partitioner reduces to flat prefix partition." << std::endl;
+    }
+    return;
+  }
+  nnodes = nrank_node.size();
+  delete [] nranks_eachnode;
+  nranks_eachnode = new int[nnodes];
+  for (int n=0; n<nnodes; ++n) {nranks_eachnode[n] = nrank_node[n];}
+#endif
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn HostArray1D<int> CountParticlesEachMB()
+//! \brief Returns number of particles in each of the nmb MeshBlocks on this rank (with
+//! first gid mbs), counted on the device.
+
+namespace {
+HostArray1D<int> CountParticlesEachMB(particles::Particles *ppart, const int mbs,
+                                      const int nmb) {
+  DvceArray1D<int> npart("npart_eachmb", nmb);
+  auto &pi = ppart->prtcl_idata;
+  par_for("cost_npart", DevExeSpace(), 0, (ppart->nprtcl_thispack-1),
+  KOKKOS_LAMBDA(const int p) {
+    int m = pi(PGID,p) - mbs;
+    if (m >= 0 && m < nmb) {Kokkos::atomic_add(&npart(m), 1);}
+  });
+  return Kokkos::create_mirror_view_and_copy(HostMemSpace(), npart);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::UpdateMeasuredCost(const double tcycle)
+//! \brief Accumulates measured wall-clock time per cycle on this rank, and every
+//! ncycle_accum cycles distributes it over the MeshBlocks on this rank using per-block
+//! weights to update cost_eachmb[] for all MeshBlocks (on all ranks). The weight of each
+//! MB is
+//!   w = 1 + wght_c2p*(C2P iterations per cell) + wght_prtcl*(particles per cell)
+//!         + wght_excise*(fraction of cells excised)
+//! Costs are normalized so that the average cost of a MeshBlock is one. Updated costs
+//! are used by LoadBalance() with AMR and are stored in restart files.
+
+void Mesh::UpdateMeasuredCost(const double tcycle) {
+  cost_model.time_accum += tcycle;
+  cost_model.ncycle_count++;
+  if (cost_model.ncycle_count < cost_model.ncycle_accum) {return;}
+
+  int nmb = nmb_thisrank;
+  int mbs = gids_eachrank[global_variable::my_rank];
+  float ncells = static_cast<float>(NumberOfMeshBlockCells());
+  float ncyc = static_cast<float>(cost_model.ncycle_count);
+  HostArray1D<float> wght("cost_wght", nmb);
+
+  // work (e.g. C2P iterations) recorded inside kernels over accumulated cycles
+  auto work = Kokkos::create_mirror_view_and_copy(HostMemSpace(), cost_model.work_eachmb);
+  for (int m=0; m<nmb; ++m) {
+    wght(m) = 1.0 + cost_model.wght_c2p*work(m)/(ncells*ncyc);
+  }
+
+  // number of particles in each MB
+  particles::Particles *ppart = pmb_pack->ppart;
+  if (ppart != nullptr && cost_model.wght_prtcl != 0.0) {
+    auto npart_h = CountParticlesEachMB(ppart, mbs, nmb);
+    for (int m=0; m<nmb; ++m) {
+      wght(m) += cost_model.wght_prtcl*static_cast<float>(npart_h(m))/ncells;
+    }
+  }
+
+  // fraction of cells in each MB inside excised region
+  Coordinates *pcoord = pmb_pack->pcoord;
+  if (pcoord->coord_data.bh_excise && cost_model.wght_excise != 0.0) {
+    DvceArray1D<int> nexcise("nexcise_eachmb", nmb);
+    auto &indcs = mb_indcs;
+    int is = indcs.is, js = indcs.js, ks = indcs.ks;
+    int nx1 = indcs.nx1, nx2 = indcs.nx2;
+    const int nkji = indcs.nx3*nx2*nx1;
+    const int nji  = nx2*nx1;
+    auto &mask = pcoord->excision_floor;
+    par_for_outer("cost_excise", DevExeSpace(), 0, 0, 0, (nmb-1),
+    KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+      int team_nex = 0;
+      Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
+      [=](const int idx, int& nex) {
+        int k = (idx)/nji;
+        int j = (idx - k*nji)/nx1;
+        int i = (idx - k*nji - j*nx1) + is;
+        j += js;
+        k += ks;
+        if (mask(m,k,j,i)) {nex++;}
+      },Kokkos::Sum<int>(team_nex));
+      nexcise(m) = team_nex;
+    });
+    auto nexcise_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), nexcise);
+    for (int m=0; m<nmb; ++m) {
+      wght(m) += cost_model.wght_excise*static_cast<float>(nexcise_h(m))/ncells;
+    }
+  }
+
+  // distribute measured time over MBs on this rank in proportion to weights
+  float wsum = 0.0;
+  for (int m=0; m<nmb; ++m) {
+    wght(m) = std::max(wght(m), 0.01f);  // never allow (near) zero cost
+    wsum += wght(m);
+  }
+  float trank = static_cast<float>(cost_model.time_accum/cost_model.ncycle_count);
+  for (int m=0; m<nmb; ++m) {
+    cost_eachmb[mbs+m] = trank*wght(m)/wsum;
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allgatherv(MPI_IN_PLACE, nmb_eachrank[global_variable::my_rank], MPI_FLOAT,
+                 cost_eachmb, nmb_eachrank, gids_eachrank, MPI_FLOAT, MPI_COMM_WORLD);
+#endif
+
+  // normalize so average cost of a MeshBlock is one
+  float totalcost = 0.0;
+  for (int i=0; i<nmb_total; ++i) {totalcost += cost_eachmb[i];}
+  if (totalcost > 0.0) {
+    float norm = static_cast<float>(nmb_total)/totalcost;
+    for (int i=0; i<nmb_total; ++i) {cost_eachmb[i] *= norm;}
+  }
+
+  ResetMeasuredCost();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn float Mesh::ParticleImbalance()
+//! \brief Returns (maximum particles per rank)/(mean particles per rank), equal to one
+//! for perfect balance.  Also updates the number of particles on each rank stored in Mesh.
+
+float Mesh::ParticleImbalance() {
+  particles::Particles *ppart = pmb_pack->ppart;
+  if (ppart == nullptr) {return 1.0;}
+  nprtcl_thisrank = ppart->nprtcl_thispack;
+  GatherParticleCounts();
+  float max_npart = 0.0, total_npart = 0.0;
+  for (int r=0; r<global_variable::nranks; ++r) {
+    total_npart += static_cast<float>(nprtcl_eachrank[r]);
+    max_npart = std::max(max_npart, static_cast<float>(nprtcl_eachrank[r]));
+  }
+  if (total_npart <= 0.0) {return 1.0;}
+  return max_npart*static_cast<float>(global_variable::nranks)/total_npart;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::SetParticleCost()
+//! \brief Sets cost_eachmb[] of all MeshBlocks to 1 + wght_prtcl*(particles per cell),
+//! normalized so the average cost of a MeshBlock is one.  Used when rebalancing is
+//! triggered by particle imbalance without the measured cost model.
+
+void Mesh::SetParticleCost() {
+  particles::Particles *ppart = pmb_pack->ppart;
+  if (ppart == nullptr) {return;}
+  int nmb = nmb_thisrank;
+  int mbs = gids_eachrank[global_variable::my_rank];
+  float ncells = static_cast<float>(NumberOfMeshBlockCells());
+  auto npart_h = CountParticlesEachMB(ppart, mbs, nmb);
+  for (int m=0; m<nmb; ++m) {
+    float npart = static_cast<float>(npart_h(m));
+    cost_eachmb[mbs+m] = 1.0 + cost_model.wght_prtcl*npart/ncells;
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allgatherv(MPI_IN_PLACE, nmb_eachrank[global_variable::my_rank], MPI_FLOAT,
+                 cost_eachmb, nmb_eachrank, gids_eachrank, MPI_FLOAT, MPI_COMM_WORLD);
+#endif
+  float totalcost = 0.0;
+  for (int i=0; i<nmb_total; ++i) {totalcost += cost_eachmb[i];}
+  if (totalcost > 0.0) {
+    float norm = static_cast<float>(nmb_total)/totalcost;
+    for (int i=0; i<nmb_total; ++i) {cost_eachmb[i] *= norm;}
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Mesh::ResetMeasuredCost()
+//! \brief Zeroes accumulators of measured cost model.  Called after costs are updated,
+//! and whenever the MeshBlocks on this rank change (e.g. with AMR).
+
+void Mesh::ResetMeasuredCost() {
+  cost_model.time_accum = 0.0;
+  cost_model.ncycle_count = 0;
+  Kokkos::deep_copy(cost_model.work_eachmb, 0.0);
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::InitRecvAMR()
 //! \brief Allocates and initializes receive buffers, and posts non-blocking receives,
@@ -126,8 +594,8 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
   }
   if (nmb_recv == 0) return;  // nothing to do
 
-  // allocate array of recv buffers
-  Kokkos::realloc(recvbuf, nmb_recv);
+  // allocate array of recv buffers (only grows, so repeated regrids do not reallocate)
+  if (recvbuf.extent_int(0) < nmb_recv) {Kokkos::realloc(recvbuf, nmb_recv);}
   recv_req = new MPI_Request[nmb_recv];
   for (int n=0; n<nmb_recv; ++n) {
     recv_req[n] = MPI_REQUEST_NULL;
@@ -194,6 +662,7 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
           recvbuf.h_view(rb_idx).cnt   = ncc_tosend*(recvbuf.h_view(rb_idx).cntcc) +
                                          nfc_tosend*(recvbuf.h_view(rb_idx).cntfc);
           recvbuf.h_view(rb_idx).lid   = newm - nmbs;
+          recvbuf.h_view(rb_idx).rank  = pmy_mesh->rank_eachmb[oldm+l];
           recvbuf.h_view(rb_idx).use_coarse = false;
           if (rb_idx > 0) {
             recvbuf.h_view(rb_idx).offset = recvbuf.h_view((rb_idx-1)).offset +
@@ -217,6 +686,7 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
         recvbuf.h_view(rb_idx).cnt = ncc_tosend*(recvbuf.h_view(rb_idx).cntcc) +
                                      nfc_tosend*(recvbuf.h_view(rb_idx).cntfc);
         recvbuf.h_view(rb_idx).lid = newm - nmbs;
+        recvbuf.h_view(rb_idx).rank = pmy_mesh->rank_eachmb[oldm];
         recvbuf.h_view(rb_idx).use_coarse = false;
         if (rb_idx > 0) {
           recvbuf.h_view(rb_idx).offset = recvbuf.h_view((rb_idx-1)).offset +
@@ -242,6 +712,7 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
         recvbuf.h_view(rb_idx).cnt = ncc_tosend*(recvbuf.h_view(rb_idx).cntcc) +
                                      nfc_tosend*(recvbuf.h_view(rb_idx).cntfc);
         recvbuf.h_view(rb_idx).lid = newm - nmbs;
+        recvbuf.h_view(rb_idx).rank = pmy_mesh->rank_eachmb[oldm];
         recvbuf.h_view(rb_idx).use_coarse = true;
         if (rb_idx > 0) {
           recvbuf.h_view(rb_idx).offset = recvbuf.h_view((rb_idx-1)).offset +
@@ -258,7 +729,7 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
   recvbuf.template sync<DevExeSpace>();
   {
     int ndata = recvbuf.h_view((nmb_recv-1)).offset + recvbuf.h_view((nmb_recv-1)).cnt;
-    Kokkos::realloc(recv_data, ndata);
+    if (recv_data.extent_int(0) < ndata) {Kokkos::realloc(recv_data, ndata);}
   }
 
   // Step 3. (InitRecvAMR)
@@ -266,7 +737,25 @@ void MeshRefinement::InitRecvAMR(int nleaf) {
   // Receive requests will only be accessed on host, so no need to sync after this step.
   rb_idx = 0;   // recv buffer index
   bool no_errors=true;
-  for (int newm=nmbs; newm<=nmbe; newm++) {
+  if (aggregate_mpi) {
+    // Buffers from each rank are contiguous in recv_data and stored in the same order
+    // the sending rank packs them, since MBs on each rank are contiguous in gid and the
+    // old<->new gid maps are monotonic.  So post one receive per sending rank.
+    while (rb_idx < nmb_recv) {
+      int src = recvbuf.h_view(rb_idx).rank;
+      int vs = recvbuf.h_view(rb_idx).offset;
+      int cnt = 0;
+      int n = rb_idx;
+      for (; n<nmb_recv && recvbuf.h_view(n).rank == src; ++n) {
+        cnt += recvbuf.h_view(n).cnt;
+      }
+      int ierr = MPI_Irecv(recv_data.data() + vs, cnt, MPI_ATHENA_REAL, src, 0,
+                           amr_comm, &(recv_req[rb_idx]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+      rb_idx = n;
+    }
+  }
+  for (int newm=nmbs; newm<=nmbe && !(aggregate_mpi); newm++) {
     int oldm = newtoold[newm];
     LogicalLocation &old_lloc = pmy_mesh->lloc_eachmb[oldm];
     LogicalLocation &new_lloc = new_lloc_eachmb[newm];
@@ -376,8 +865,8 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
 
   if (nmb_send == 0) return;  // nothing to do
 
-  // allocate array of send buffers
-  Kokkos::realloc(sendbuf, nmb_send);
+  // allocate array of send buffers (only grows, so repeated regrids do not reallocate)
+  if (sendbuf.extent_int(0) < nmb_send) {Kokkos::realloc(sendbuf, nmb_send);}
   send_req = new MPI_Request[nmb_send];
   for (int n=0; n<nmb_send; ++n) {
     send_req[n] = MPI_REQUEST_NULL;
@@ -444,6 +933,7 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
           sendbuf.h_view(sb_idx).cnt   = ncc_tosend*(sendbuf.h_view(sb_idx).cntcc) +
                                          nfc_tosend*(sendbuf.h_view(sb_idx).cntfc);
           sendbuf.h_view(sb_idx).lid   = oldm - ombs;
+          sendbuf.h_view(sb_idx).rank  = new_rank_eachmb[newm+l];
           sendbuf.h_view(sb_idx).use_coarse = false;
           if (sb_idx > 0) {
             sendbuf.h_view(sb_idx).offset = sendbuf.h_view((sb_idx-1)).offset +
@@ -468,6 +958,7 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
           sendbuf.h_view(sb_idx).cnt = ncc_tosend*(sendbuf.h_view(sb_idx).cntcc) +
                                        nfc_tosend*(sendbuf.h_view(sb_idx).cntfc);
           sendbuf.h_view(sb_idx).lid = oldm - ombs;
+          sendbuf.h_view(sb_idx).rank = new_rank_eachmb[newm];
           sendbuf.h_view(sb_idx).use_coarse = false;
           if (sb_idx > 0) {
             sendbuf.h_view(sb_idx).offset = sendbuf.h_view((sb_idx-1)).offset +
@@ -494,6 +985,7 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
           sendbuf.h_view(sb_idx).cnt = ncc_tosend*(sendbuf.h_view(sb_idx).cntcc) +
                                        nfc_tosend*(sendbuf.h_view(sb_idx).cntfc);
           sendbuf.h_view(sb_idx).lid = oldm - ombs;
+          sendbuf.h_view(sb_idx).rank = new_rank_eachmb[newm];
           if (sb_idx > 0) {
             sendbuf.h_view(sb_idx).offset = sendbuf.h_view((sb_idx-1)).offset +
                                             sendbuf.h_view((sb_idx-1)).cnt;
@@ -510,7 +1002,7 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
   sendbuf.template sync<DevExeSpace>();
   {
     int ndata = sendbuf.h_view((nmb_send-1)).offset + sendbuf.h_view((nmb_send-1)).cnt;
-    Kokkos::realloc(send_data, ndata);
+    if (send_data.extent_int(0) < ndata) {Kokkos::realloc(send_data, ndata);}
   }
 
   // Step 3. (PackAndSendAMR)
@@ -538,10 +1030,27 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
   // Step 4. (PackAndSendAMR)
   // loop over old MBs on this rank, send data using MPI non-blocking sends
   // Send requests will only be accessed on host, so no need to sync after this step.
-  Kokkos::fence();
+  DevExeSpace().fence();
   bool no_errors=true;
   sb_idx = 0;     // send buffer index
-  for (int oldm=ombs; oldm<=ombe; oldm++) {
+  if (aggregate_mpi) {
+    // post one send per receiving rank, containing all buffers for that rank in order
+    while (sb_idx < nmb_send) {
+      int dest = sendbuf.h_view(sb_idx).rank;
+      int vs = sendbuf.h_view(sb_idx).offset;
+      int cnt = 0;
+      int n = sb_idx;
+      for (; n<nmb_send && sendbuf.h_view(n).rank == dest; ++n) {
+        cnt += sendbuf.h_view(n).cnt;
+      }
+      int ierr = MPI_Isend(send_data.data() + vs, cnt, MPI_ATHENA_REAL, dest, 0,
+                           amr_comm, &(send_req[sb_idx]));
+      if (ierr != MPI_SUCCESS) {no_errors=false;}
+      comm_stats::AddSend(comm_stats::amr, 1, cnt*sizeof(Real));
+      sb_idx = n;
+    }
+  }
+  for (int oldm=ombs; oldm<=ombe && !(aggregate_mpi); oldm++) {
     int newm = oldtonew[oldm];
     LogicalLocation &old_lloc = pmy_mesh->lloc_eachmb[oldm];
     LogicalLocation &new_lloc = new_lloc_eachmb[newm];
@@ -561,6 +1070,8 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
                      new_rank_eachmb[newm+l], tag, amr_comm,
                      &(send_req[sb_idx]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          comm_stats::AddSend(comm_stats::amr, 1,
+                              sendbuf.h_view(sb_idx).cnt*sizeof(Real));
           sb_idx++;
         }
       }
@@ -578,6 +1089,8 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
                      new_rank_eachmb[newm], tag, amr_comm,
                      &(send_req[sb_idx]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          comm_stats::AddSend(comm_stats::amr, 1,
+                              sendbuf.h_view(sb_idx).cnt*sizeof(Real));
           sb_idx++;
         }
       } else {                                  // old MB was de-refined
@@ -598,6 +1111,8 @@ void MeshRefinement::PackAndSendAMR(int nleaf) {
                      new_rank_eachmb[newm], tag, amr_comm,
                      &(send_req[sb_idx]));
           if (ierr != MPI_SUCCESS) {no_errors=false;}
+          comm_stats::AddSend(comm_stats::amr, 1,
+                              sendbuf.h_view(sb_idx).cnt*sizeof(Real));
           sb_idx++;
         }
       }
@@ -785,10 +1300,13 @@ void MeshRefinement::ClearRecvAndUnpackAMR() {
 #if MPI_PARALLEL_ENABLED
   // Wait for all receives to finish
   bool no_errors=true;
+  double wait_t0 = -1.0;
+  comm_stats::RecvPending(wait_t0);
   for (int n=0; n<nmb_recv; ++n) {
     int ierr = MPI_Wait(&(recv_req[n]), MPI_STATUS_IGNORE);
     if (ierr != MPI_SUCCESS) {no_errors=false;}
   }
+  comm_stats::RecvComplete(comm_stats::amr, wait_t0);
   // Quit if MPI error detected
   if (!(no_errors)) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
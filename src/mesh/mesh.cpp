@@ -49,9 +49,22 @@ Mesh::Mesh(ParameterInput *pin) :
   multi_d(false),
   strictly_periodic(true),
   nmb_packs_thisrank(1),
+  nmb_maxperrank(0),
+  nregrid(0),
   nprtcl_thisrank(0),
   nprtcl_total(0),
-  dtold(0.) {
+  dtold(0.),
+  dt_sts(std::numeric_limits<float>::max()),
+  dt_imex(std::numeric_limits<float>::max()),
+  block_ordering(BlockOrdering::morton),
+  partition_method(PartitionMethod::greedy),
+  migration_tol(0.05),
+  nnodes(1),
+  rebalance(false),
+  rebalance_threshold(0.9),
+  ncycle_rebalance(100),
+  max_migrate(2),
+  prtcl_imbalance(0.0) {
   // Set physical size and number of cells in mesh (root level)
   mesh_size.x1min = pin->GetReal("mesh", "x1min");
   mesh_size.x1max = pin->GetReal("mesh", "x1max");
@@ -175,6 +188,65 @@ Mesh::Mesh(ParameterInput *pin) :
   multilevel = (adaptive || pin->GetString("mesh_refinement","refinement") == "static")
     ?  true : false;
 
+  // read parameters controlling measured cost model used in load balancing (if any)
+  if (pin->DoesBlockExist("load_balancing")) {
+    cost_model.measured = pin->GetOrAddBoolean("load_balancing", "measured_cost", false);
+    cost_model.ncycle_accum = pin->GetOrAddInteger("load_balancing", "ncycle_cost", 10);
+    cost_model.wght_c2p = pin->GetOrAddReal("load_balancing", "c2p_weight", 0.1);
+    cost_model.wght_prtcl = pin->GetOrAddReal("load_balancing", "particle_weight", 1.0);
+    cost_model.wght_excise = pin->GetOrAddReal("load_balancing","excision_weight",-0.5);
+    if (cost_model.ncycle_accum < 1) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<load_balancing>/ncycle_cost must be >= 1" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // space-filling curve and partitioner.  Note ordering must not be changed between
+    // a run and its restarts, since it determines the gids of MBs in restart files.
+    std::string ordering = pin->GetOrAddString("load_balancing", "ordering", "morton");
+    if (ordering.compare("morton") == 0) {
+      block_ordering = BlockOrdering::morton;
+    } else if (ordering.compare("hilbert") == 0) {
+      block_ordering = BlockOrdering::hilbert;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<load_balancing>/ordering = '" << ordering
+                << "' not implemented. Valid choices are [morton,hilbert]" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    std::string partitioner = pin->GetOrAddString("load_balancing","partitioner","greedy");
+    if (partitioner.compare("greedy") == 0) {
+      partition_method = PartitionMethod::greedy;
+    } else if (partitioner.compare("prefix") == 0) {
+      partition_method = PartitionMethod::prefix;
+    } else if (partitioner.compare("hierarchical") == 0) {
+      partition_method = PartitionMethod::hierarchical;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<load_balancing>/partitioner = '" << partitioner
+                << "' not implemented. Valid choices are [greedy,prefix,hierarchical]"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    migration_tol = pin->GetOrAddReal("load_balancing", "migration_tol", 0.05);
+
+    // incremental rebalancing (shifts MBs between neighboring ranks between AMR steps)
+    rebalance = pin->GetOrAddBoolean("load_balancing", "rebalance", false);
+    rebalance_threshold = pin->GetOrAddReal("load_balancing", "rebalance_threshold", 0.9);
+    ncycle_rebalance = pin->GetOrAddInteger("load_balancing", "ncycle_rebalance", 100);
+    max_migrate = pin->GetOrAddInteger("load_balancing", "max_migrate", 2);
+    // (max particles per rank)/(mean particles per rank) that triggers rebalancing,
+    // with 0 (default) to only use LoadEfficiency()
+    prtcl_imbalance = pin->GetOrAddReal("load_balancing", "particle_imbalance", 0.0);
+    if (rebalance && (ncycle_rebalance < 1 || max_migrate < 1)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<load_balancing>/ncycle_rebalance and max_migrate must "
+                << "be >= 1" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  if (partition_method == PartitionMethod::hierarchical) {InitNodeLayout();}
+
   // FIXME: The shearing box is not currently compatible with SMR/AMR
   if (multilevel && pin->DoesBlockExist("shearing_box")) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
@@ -182,6 +254,12 @@ Mesh::Mesh(ParameterInput *pin) :
         << std::endl;
     std::exit(EXIT_FAILURE);
   }
+  if (rebalance && pin->DoesBlockExist("shearing_box")) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+        << "Shearing box is not currently compatible with <load_balancing>/rebalance"
+        << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
 
   // error check physical size of mesh (root level) from input file.
   if (mesh_size.x1max <= mesh_size.x1min) {
@@ -340,10 +418,9 @@ Mesh::~Mesh() {
   delete [] lloc_eachmb;
   delete [] gids_eachrank;
   delete [] nmb_eachrank;
+  delete [] nranks_eachnode;
   delete pmb_pack;
-  if (multilevel) {
-    delete pmr;
-  }
+  delete pmr;
 }
 
 //----------------------------------------------------------------------------------------
@@ -386,17 +463,17 @@ void Mesh::PrintMeshDiagnostics() {
   // if more than one rank: compute/output # of blocks and cost per rank
   if (global_variable::nranks > 1) {
     int nb_per_rank[global_variable::nranks];    // NOLINT(runtime/arrays)
-    int cost_per_rank[global_variable::nranks];  // NOLINT(runtime/arrays)
+    float cost_per_rank[global_variable::nranks];  // NOLINT(runtime/arrays)
     for (int i=0; i<global_variable::nranks; ++i) {
       nb_per_rank[i] = 0;
-      cost_per_rank[i] = 0;
+      cost_per_rank[i] = 0.0;
     }
     for (int i=0; i<nmb_total; i++) {
       nb_per_rank[rank_eachmb[i]]++;
       cost_per_rank[rank_eachmb[i]] += cost_eachmb[i];
     }
-    int mincost = std::numeric_limits<int>::max();
-    int maxcost = 0, totalcost = 0;
+    float mincost = std::numeric_limits<float>::max();
+    float maxcost = 0.0, totalcost = 0.0;
     for (int i=0; i<global_variable::nranks; ++i) {
       std::cout << "  Rank = " << i << ": " << nb_per_rank[i] <<" MeshBlocks, cost = "
                 << cost_per_rank[i] << std::endl;
@@ -408,9 +485,8 @@ void Mesh::PrintMeshDiagnostics() {
     // output normalized costs per rank
     std::cout << "Load Balancing:" << std::endl;
     std::cout << "  Maximum normalized cost = "
-      << static_cast<float>(maxcost)/static_cast<float>(mincost) << ", Average = "
-      << static_cast<float>(totalcost)/static_cast<float>(global_variable::nranks*mincost)
-      << std::endl;
+      << maxcost/mincost << ", Average = "
+      << totalcost/(static_cast<float>(global_variable::nranks)*mincost) << std::endl;
   }
 }
 
@@ -563,68 +639,112 @@ std::string Mesh::GetBoundaryString(BoundaryFlag input_flag) {
 
 //----------------------------------------------------------------------------------------
 // \fn Mesh::NewTimeStep()
+// \brief computes new timestep and waits for its reduction over all MPI ranks
 
 void Mesh::NewTimeStep(const Real tlim) {
-  // save old timestep
-  dtold = dt;
-  if (dt == std::numeric_limits<float>::max()) {
-    dtold = 0.;
-  }
+  StartNewTimeStep();
+  FinishNewTimeStep(tlim);
+  return;
+}
 
+//----------------------------------------------------------------------------------------
+// \fn Mesh::StartNewTimeStep()
+// \brief computes minimum timestep over MeshBlocks on this rank from the dtnew of each
+// physics module, and starts (non-blocking) reduction over all MPI ranks.  The Mesh dt is
+// not changed until FinishNewTimeStep(), so the reduction can overlap outputs and the AMR
+// check.  If called again before FinishNewTimeStep() (e.g. after MeshBlocks were
+// refined), the earlier reduction is discarded.
+
+void Mesh::StartNewTimeStep() {
+#if MPI_PARALLEL_ENABLED
+  if (dt_pending) {MPI_Wait(&dt_req, MPI_STATUS_IGNORE);}
+#endif
   // cycle over all MeshBlocks on this rank and find minimum dt
   // Requires at least ONE of the physics modules to be defined.
   // limit increase in timestep to 2x old value
-  dt = 2.0*dt;
+  Real &dtn = dt_new[0];
+  dtn = 2.0*dt;
+
+  // diffusion integrated with super-time-stepping does not limit dt, but sets dt_sts
+  // which determines the number of STS sub-stages
+  dt_new[1] = std::numeric_limits<float>::max();
 
   // Hydro timestep
   if (pmb_pack->phydro != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->dtnew) );
+    dtn = std::min(dtn, (cfl_no)*(pmb_pack->phydro->dtnew) );
+    Real &dt_diff = (pmb_pack->phydro->sts_integrator != STS_Integrator::none)?
+                    dt_new[1] : dtn;
     // viscosity timestep
     if (pmb_pack->phydro->pvisc != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->pvisc->dtnew) );
+      dt_diff = std::min(dt_diff, (cfl_no)*(pmb_pack->phydro->pvisc->dtnew) );
     }
     // thermal conduction timestep
     if (pmb_pack->phydro->pcond != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->pcond->dtnew) );
+      dt_diff = std::min(dt_diff, (cfl_no)*(pmb_pack->phydro->pcond->dtnew) );
     }
     // source terms timestep
-    dt = std::min(dt, (cfl_no)*(pmb_pack->phydro->psrc->dtnew) );
+    dtn = std::min(dtn, (cfl_no)*(pmb_pack->phydro->psrc->dtnew) );
   }
   // MHD timestep
   if (pmb_pack->pmhd != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->dtnew) );
+    dtn = std::min(dtn, (cfl_no)*(pmb_pack->pmhd->dtnew) );
     // viscosity timestep
     if (pmb_pack->pmhd->pvisc != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->pvisc->dtnew) );
+      dtn = std::min(dtn, (cfl_no)*(pmb_pack->pmhd->pvisc->dtnew) );
     }
     // resistivity timestep
     if (pmb_pack->pmhd->presist != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->presist->dtnew) );
+      dtn = std::min(dtn, (cfl_no)*(pmb_pack->pmhd->presist->dtnew) );
     }
     // thermal conduction timestep
     if (pmb_pack->pmhd->pcond != nullptr) {
-      dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->pcond->dtnew) );
+      dtn = std::min(dtn, (cfl_no)*(pmb_pack->pmhd->pcond->dtnew) );
     }
     // source terms timestep
-    dt = std::min(dt, (cfl_no)*(pmb_pack->pmhd->psrc->dtnew) );
+    dtn = std::min(dtn, (cfl_no)*(pmb_pack->pmhd->psrc->dtnew) );
   }
   // z4c timestep
   if (pmb_pack->pz4c != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->pz4c->dtnew) );
+    dtn = std::min(dtn, (cfl_no)*(pmb_pack->pz4c->dtnew) );
   }
   // Radiation timestep
   if (pmb_pack->prad != nullptr) {
-    dt = std::min(dt, (cfl_no)*(pmb_pack->prad->dtnew) );
+    dtn = std::min(dtn, (cfl_no)*(pmb_pack->prad->dtnew) );
   }
   // Particles timestep
   if (pmb_pack->ppart != nullptr) {
-    dt = std::min(dt, (pmb_pack->ppart->dtnew) );
+    dtn = std::min(dtn, (pmb_pack->ppart->dtnew) );
   }
+  // error control of stiff source terms (identical on all ranks, set by Driver)
+  dtn = std::min(dtn, dt_imex);
+
+#if MPI_PARALLEL_ENABLED
+  // get minimum (dt, dt_sts) over all MPI ranks
+  MPI_Iallreduce(MPI_IN_PLACE, dt_new, 2, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD,
+                 &dt_req);
+#endif
+  dt_pending = true;
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+// \fn Mesh::FinishNewTimeStep()
+// \brief completes reduction started by StartNewTimeStep() and sets new timestep
 
+void Mesh::FinishNewTimeStep(const Real tlim) {
+  if (!(dt_pending)) {StartNewTimeStep();}
 #if MPI_PARALLEL_ENABLED
-  // get minimum dt over all MPI ranks
-  MPI_Allreduce(MPI_IN_PLACE, &dt, 1, MPI_ATHENA_REAL, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Wait(&dt_req, MPI_STATUS_IGNORE);
 #endif
+  dt_pending = false;
+
+  // save old timestep
+  dtold = dt;
+  if (dt == std::numeric_limits<float>::max()) {
+    dtold = 0.;
+  }
+  dt = dt_new[0];
+  dt_sts = dt_new[1];
 
   // limit last time step to stop at tlim *exactly*
   if ( (time < tlim) && ((time + dt) > tlim) ) {dt = tlim - time;}
@@ -650,17 +770,28 @@ void Mesh::AddCoordinatesAndPhysics(ParameterInput *pinput) {
       nprtcl_thisrank += pmb_pack->ppart->nprtcl_thispack;
     }
     nprtcl_eachrank = new int[global_variable::nranks];
-    nprtcl_eachrank[global_variable::my_rank] = nprtcl_thisrank;
-#if MPI_PARALLEL_ENABLED
-    // Share number of particles on each rank with all ranks
-    MPI_Allgather(&nprtcl_thisrank,1,MPI_INT,nprtcl_eachrank,1,MPI_INT,MPI_COMM_WORLD);
-#endif
-    for (int n=0; n<global_variable::nranks; ++n) {
-      nprtcl_total += nprtcl_eachrank[n];
-    }
+    GatherParticleCounts();
     // Assign particle IDs
     if (pmb_pack->ppart != nullptr) {
       pmb_pack->ppart->CreateParticleTags(pinput);
     }
   }
 }
+
+//----------------------------------------------------------------------------------------
+// \fn Mesh::GatherParticleCounts()
+// \brief shares number of particles on this rank with all ranks, and updates total.
+// Particles only update the count of their own rank every cycle, so this is called only
+// where the counts of all ranks are needed (outputs, load balancing).
+
+void Mesh::GatherParticleCounts() {
+  nprtcl_eachrank[global_variable::my_rank] = nprtcl_thisrank;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allgather(&nprtcl_thisrank,1,MPI_INT,nprtcl_eachrank,1,MPI_INT,MPI_COMM_WORLD);
+#endif
+  nprtcl_total = 0;
+  for (int n=0; n<global_variable::nranks; ++n) {
+    nprtcl_total += nprtcl_eachrank[n];
+  }
+  return;
+}
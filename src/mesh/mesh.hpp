@@ -70,8 +70,49 @@ struct LogicalLocation {
 
 struct EventCounters {
   int nfofc, neos_dfloor, neos_efloor, neos_tfloor, neos_vceil, neos_fail, maxit_c2p;
+  int nrad_newton, nrad_fail, maxit_rad;  // implicit radiation source term solver
+  int nc2p_hist[NC2PHIST];                // histogram of C2P iterations, see C2PHistBin
   EventCounters() : nfofc(0), neos_dfloor(0), neos_efloor(0), neos_tfloor(0),
-                    neos_vceil(0), neos_fail(0), maxit_c2p(0) {}
+                    neos_vceil(0), neos_fail(0), maxit_c2p(0),
+                    nrad_newton(0), nrad_fail(0), maxit_rad(0) {
+    for (int n=0; n<NC2PHIST; ++n) {nc2p_hist[n] = 0;}
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \enum BlockOrdering
+//! \brief space-filling curve used to order MeshBlocks (and therefore assign gids)
+
+enum class BlockOrdering {morton, hilbert};
+
+//----------------------------------------------------------------------------------------
+//! \enum PartitionMethod
+//! \brief algorithm used to partition the ordered list of MeshBlocks across ranks
+//! greedy       = fill ranks from the end of list until cost exceeds average
+//! prefix       = cut prefix sum of costs at multiples of average cost, preferring the
+//!                previous cuts (if within tolerance) to minimize migration with AMR
+//! hierarchical = prefix partition first over nodes, then over ranks within each node
+
+enum class PartitionMethod {greedy, prefix, hierarchical};
+
+//----------------------------------------------------------------------------------------
+//! \struct CostModel
+//! \brief parameters and accumulators for the measured per-MeshBlock cost model used in
+//! load balancing.  The measured wall-clock time per cycle of each rank is distributed
+//! over its MeshBlocks using per-block weights, and accumulated over ncycle_accum cycles.
+
+struct CostModel {
+  bool measured;        // true if costs are measured (otherwise all MBs have equal cost)
+  int ncycle_accum;     // number of cycles over which measured costs are accumulated
+  int ncycle_count;     // number of cycles accumulated since costs were last updated
+  float wght_c2p;       // extra weight per C2P iteration (averaged over cells in MB)
+  float wght_prtcl;     // extra weight per particle (normalized by cells in MB)
+  float wght_excise;    // extra weight of fully excised MB (usually negative)
+  double time_accum;    // wall-clock time accumulated on this rank since last update
+  DvceArray1D<float> work_eachmb;  // work recorded inside kernels for each MB on rank
+  CostModel() : measured(false), ncycle_accum(10), ncycle_count(0), wght_c2p(0.1),
+                wght_prtcl(1.0), wght_excise(-0.5), time_accum(0.0),
+                work_eachmb("work_eachmb",1) {}
 };
 
 // Forward declarations required due to recursive definitions amongst mesh classes
@@ -120,6 +161,7 @@ class Mesh {
   int nmb_total;           // total number of MeshBlocks across all levels/ranks
   int nmb_thisrank;        // number of MeshBlocks on this MPI rank (local)
   int nmb_maxperrank;      // max allowed number of MBs per device (memory limit for AMR)
+  int nregrid;             // # of times MBs were refined/redistributed (neighbors reset)
 
   int root_level; // logical level of root (physical) grid (e.g. Fig. 3 of method paper)
   int max_level;  // logical level of maximum refinement grid in Mesh
@@ -139,8 +181,25 @@ class Mesh {
   int *nprtcl_eachrank;    // number of particles on each rank
 
   Real time, dt, dtold, cfl_no;
+  Real dt_sts;  // timestep limit of diffusion integrated with super-time-stepping
+  Real dt_imex; // timestep limit from error control of stiff source terms in ImEx
   int ncycle;
   EventCounters ecounter;
+  CostModel cost_model;
+
+  // parameters controlling ordering and partitioning of MeshBlocks across ranks
+  BlockOrdering block_ordering;     // space-filling curve used to order MBs
+  PartitionMethod partition_method; // partitioner used by LoadBalance()
+  float migration_tol;              // tolerance in cost to keep previous partition cuts
+  int nnodes;                       // number of (shared-memory) nodes
+  int *nranks_eachnode=nullptr;     // number of ranks on each node [nnodes]
+
+  // parameters controlling incremental (diffusive) rebalancing between AMR steps
+  bool rebalance;                   // true to enable incremental rebalancing
+  float rebalance_threshold;        // rebalance when LoadEfficiency() below this value
+  int ncycle_rebalance;             // # of cycles between checks of load imbalance
+  int max_migrate;                  // max # of MBs moved across each rank boundary
+  float prtcl_imbalance;            // also rebalance when ParticleImbalance() above this
 
   int nmb_packs_thisrank;                  // number of MBPacks on this rank
   MeshBlockPack* pmb_pack;                 // container for MeshBlocks on this rank
@@ -153,6 +212,15 @@ class Mesh {
   void PrintMeshDiagnostics();
   void WriteMeshStructure();
   void NewTimeStep(const Real tlim);
+  void StartNewTimeStep();
+  void FinishNewTimeStep(const Real tlim);
+  void GatherParticleCounts();
+  void UpdateMeasuredCost(const double tcycle);
+  void ResetMeasuredCost();
+  int DeviceMeshBlockCapacity(ParameterInput *pin);
+  float LoadEfficiency();
+  float ParticleImbalance();
+  void SetParticleCost();
   void AddCoordinatesAndPhysics(ParameterInput *pinput);
   BoundaryFlag GetBoundaryFlag(const std::string& input_string);
   std::string GetBoundaryString(BoundaryFlag input_flag);
@@ -175,6 +243,16 @@ class Mesh {
 
  private:
   std::unique_ptr<MeshBlockTree> ptree;  // pointer to root node in binary/quad/oct-tree
-  void LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb);
+  void LoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb,
+                   const int *prev_slist=nullptr);
+  void DiffusiveLoadBalance(float *clist, int *rlist, int *slist, int *nlist, int nb);
+  void InitNodeLayout();
+
+  // new timestep (dt, dt_sts) on this rank, reduced over all ranks by StartNewTimeStep()
+  Real dt_new[2];
+  bool dt_pending = false;
+#if MPI_PARALLEL_ENABLED
+  MPI_Request dt_req;
+#endif
 };
 #endif  // MESH_MESH_HPP_
@@ -14,6 +14,7 @@
 #include <cmath>     // abs
 #include <algorithm> // sort
 #include <utility>   // pair
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -23,6 +24,7 @@
 
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
+#include "particles/particles.hpp"
 #include "radiation/radiation.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
@@ -47,35 +49,62 @@ MeshRefinement::MeshRefinement(Mesh *pm, ParameterInput *pin) :
   ncyc_check_amr(1),
   refinement_interval(5),
   prolong_prims(false),
-  d_threshold_(0.0),
-  dd_threshold_(0.0),
-  dp_threshold_(0.0),
-  dv_threshold_(0.0),
-  check_cons_(false) {
+  refine_buffer(false),
+  aggregate_mpi(false),
+  chi_threshold_(0.0),
+  dcriteria_("refine_criteria",1),
+  deref_copies_("deref_copies",1),
+  move_copies_("move_copies",1),
+  refine_copies_("refine_copies",1) {
   if (pin->DoesBlockExist("mesh_refinement")) {
     // read interval (in cycles) between check of AMR and derefinement
+    bool set_ncheck = pin->DoesParameterExist("mesh_refinement", "ncycle_check");
     ncyc_check_amr = pin->GetOrAddReal("mesh_refinement", "ncycle_check", 1);
+    // With a buffer of refined MBs around flagged MBs, features need not be checked
+    // until they could cross the buffer.  Signals travel at most cfl_number cells per
+    // cycle, so unless set explicitly, check every half of a MB-crossing time.
+    refine_buffer = pin->GetOrAddBoolean("mesh_refinement", "refine_buffer", false);
+    if (refine_buffer && !(set_ncheck)) {
+      auto &indcs = pm->mb_indcs;
+      int nxmin = indcs.nx1;
+      if (pm->multi_d) {nxmin = std::min(nxmin, indcs.nx2);}
+      if (pm->three_d) {nxmin = std::min(nxmin, indcs.nx3);}
+      Real cfl = pin->GetReal("time", "cfl_number");
+      ncyc_check_amr = std::max(1, static_cast<int>(0.5*nxmin/cfl));
+      pin->SetInteger("mesh_refinement", "ncycle_check", ncyc_check_amr);
+    }
     refinement_interval = pin->GetOrAddReal("mesh_refinement", "refinement_interval", 5);
     // read prolongate primitives flag
     if (pin->DoesParameterExist("mesh_refinement", "prolong_primitives")) {
       prolong_prims = pin->GetBoolean("mesh_refinement", "prolong_primitives");
     }
-    // read refinement criteria thresholds
+    // aggregate all MeshBlocks migrating between each pair of ranks into one message
+    aggregate_mpi = pin->GetOrAddBoolean("mesh_refinement", "aggregate_mpi", false);
+    // read refinement criteria thresholds.  Gradient criteria derefine below 1/4 of
+    // threshold, as in Athena++
     if (pin->DoesParameterExist("mesh_refinement", "dens_max")) {
-      d_threshold_ = pin->GetReal("mesh_refinement", "dens_max");
-      check_cons_ = true;
+      Real thresh = pin->GetReal("mesh_refinement", "dens_max");
+      AddRefinementCriterion(RefineCriterion::max_value, IDN, false, thresh, thresh);
     }
     if (pin->DoesParameterExist("mesh_refinement", "ddens_max")) {
-      dd_threshold_ = pin->GetReal("mesh_refinement", "ddens_max");
-      check_cons_ = true;
+      Real thresh = pin->GetReal("mesh_refinement", "ddens_max");
+      AddRefinementCriterion(RefineCriterion::gradient, IDN, false, thresh, 0.25*thresh);
     }
     if (pin->DoesParameterExist("mesh_refinement", "dpres_max")) {
-      dp_threshold_ = pin->GetReal("mesh_refinement", "dpres_max");
-      check_cons_ = true;
+      Real thresh = pin->GetReal("mesh_refinement", "dpres_max");
+      AddRefinementCriterion(RefineCriterion::gradient, IEN, true, thresh, 0.25*thresh);
     }
     if (pin->DoesParameterExist("mesh_refinement", "dvel_max")) {
-      dd_threshold_ = pin->GetReal("mesh_refinement", "dvel_max");
-      check_cons_ = true;
+      Real thresh = pin->GetReal("mesh_refinement", "dvel_max");
+      AddRefinementCriterion(RefineCriterion::vorticity, 0, true, thresh, 0.25*thresh);
+    }
+    if (pin->DoesParameterExist("mesh_refinement", "curr_max")) {
+      Real thresh = pin->GetReal("mesh_refinement", "curr_max");
+      AddRefinementCriterion(RefineCriterion::current, 0, true, thresh, 0.25*thresh);
+    }
+    if (pin->DoesParameterExist("mesh_refinement", "lohner_dens_max")) {
+      Real thresh = pin->GetReal("mesh_refinement", "lohner_dens_max");
+      AddRefinementCriterion(RefineCriterion::lohner, IDN, false, thresh, 0.25*thresh);
     }
   }
 
@@ -120,12 +149,28 @@ MeshRefinement::~MeshRefinement() {
 //! \brief Simple driver function for adaptive mesh refinement
 
 void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin) {
+  // With Z4c moving boxes (and no other criteria), the mesh can only change after a
+  // compact object crosses a MeshBlock boundary, so criteria are not checked (and the
+  // tree is not updated) on other cycles.
+  z4c::Z4c_AMR *pbox = nullptr;
+  if ((pmy_mesh->pmb_pack->pz4c != nullptr) && criteria_.empty() &&
+      pmy_mesh->pmb_pack->pz4c->pamr->MovingBoxes()) {
+    pbox = pmy_mesh->pmb_pack->pz4c->pamr;
+    if (((pmy_mesh->ncycle)%(ncyc_check_amr) != 0) || !(pbox->BoxCheckNeeded(pmy_mesh))) {
+      for (int m=0; m<(pmy_mesh->nmb_total); ++m) {
+        ncyc_since_ref(m) += 1;
+      }
+      return;
+    }
+  }
+
   // first check refinement criteria
   CheckForRefinement(pmy_mesh->pmb_pack);
 
   // then update mesh tree if MeshBlock anywhere (on any rank) is flagged for refinement
   int nnew = 0, ndel = 0;
   UpdateMeshBlockTree(nnew, ndel);
+  if (pbox != nullptr) {pbox->BoxCheckDone(nnew != 0 || ndel != 0);}
 
   // Refine/derefine mesh and evolved data, set boundary conditions/timestep on new mesh
   if (nnew != 0 || ndel != 0) { // at least one (de)refinement flagged
@@ -152,28 +197,172 @@ void MeshRefinement::AdaptiveMeshRefinement(Driver *pdriver, ParameterInput *pin
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::IncrementalRebalance()
+//! \brief Driver function for incremental (diffusive) rebalancing between AMR steps.
+//! Every ncycle_rebalance cycles checks the load balance efficiency computed from the
+//! (measured) cost of each MB, and if it is below rebalance_threshold shifts a few MBs at
+//! the boundaries between neighboring ranks, rather than repartitioning the entire mesh.
+//! Works on uniform, SMR, and AMR grids.  Not yet implemented for radiation, which is not
+//! communicated by the AMR load balancing functions.  With particles, rebalancing is also
+//! triggered when ParticleImbalance() exceeds <load_balancing>/particle_imbalance, and
+//! particles are migrated to the new owners of their MeshBlocks.
+
+void MeshRefinement::IncrementalRebalance(Driver *pdriver, ParameterInput *pin) {
+  Mesh* pm = pmy_mesh;
+  MeshBlockPack* pmbp = pm->pmb_pack;
+  if (global_variable::nranks == 1 || (pm->ncycle % pm->ncycle_rebalance) != 0) {return;}
+  if (pmbp->prad != nullptr) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Incremental rebalancing not implemented with radiation,"
+                << " <load_balancing>/rebalance is disabled" << std::endl;
+    }
+    pm->rebalance = false;
+    return;
+  }
+  bool prtcl_trigger = (pmbp->ppart != nullptr && pm->prtcl_imbalance > 0.0 &&
+                        pm->ParticleImbalance() > pm->prtcl_imbalance);
+  if (!(prtcl_trigger) && pm->LoadEfficiency() >= pm->rebalance_threshold) {return;}
+  // without measured costs, particle counts are the only cost input
+  if (prtcl_trigger && !(pm->cost_model.measured)) {pm->SetParticleCost();}
+
+  // only MPI communication and copies of MBs that change rank, no (de)refinement
+  RedistAndRefineMeshBlocks(pin, 0, 0, true);
+  pdriver->InitBoundaryValuesAndPrimitives(pm);
+
+  if (pmbp->phydro != nullptr) {
+    (void) pmbp->phydro->NewTimeStep(pdriver, pdriver->nexp_stages);
+  }
+  if (pmbp->pmhd != nullptr) {
+    (void) pmbp->pmhd->NewTimeStep(pdriver, pdriver->nexp_stages);
+  }
+  if (pmbp->pz4c != nullptr) {
+    (void) pmbp->pz4c->NewTimeStep(pdriver, pdriver->nexp_stages);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::AddRefinementCriterion()
+//! \brief Adds a criterion to the list evaluated on the device by CheckForRefinement().
+//! Called for criteria specified in the input file, and can also be called by problem
+//! generators.  More complex conditions can be enrolled with the *user_ref_func pointer.
+
+void MeshRefinement::AddRefinementCriterion(RefineCriterion type, int var, bool prim,
+                                            Real refine_thresh, Real deref_thresh) {
+  RefinementCriterion crit;
+  crit.type = type;
+  crit.var = var;
+  crit.prim = prim;
+  crit.refine_thresh = refine_thresh;
+  crit.deref_thresh = deref_thresh;
+  criteria_.push_back(crit);
+
+  int ncrit = static_cast<int>(criteria_.size());
+  Kokkos::realloc(dcriteria_, ncrit);
+  for (int c=0; c<ncrit; ++c) {dcriteria_.h_view(c) = criteria_[c];}
+  dcriteria_.template modify<HostMemSpace>();
+  dcriteria_.template sync<DevExeSpace>();
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real RefinementEstimator()
+//! \brief Evaluates estimator for refinement criterion crit in cell (m,k,j,i).  Array a
+//! is either the conserved or primitive variables as selected by crit.prim, w is the
+//! primitive variables, and bcc is the cell-centered magnetic field (only used with MHD).
+
+namespace {
+KOKKOS_INLINE_FUNCTION
+Real RefinementEstimator(const RefinementCriterion &crit, const DvceArray5D<Real> &a,
+                         const DvceArray5D<Real> &w, const DvceArray5D<Real> &bcc,
+                         const bool multi_d, const bool three_d,
+                         const int m, const int k, const int j, const int i) {
+  switch (crit.type) {
+    case RefineCriterion::max_value:
+      return a(m,crit.var,k,j,i);
+    case RefineCriterion::gradient: {
+      const int n = crit.var;
+      Real d2 = SQR(a(m,n,k,j,i+1) - a(m,n,k,j,i-1));
+      if (multi_d) {d2 += SQR(a(m,n,k,j+1,i) - a(m,n,k,j-1,i));}
+      if (three_d) {d2 += SQR(a(m,n,k+1,j,i) - a(m,n,k-1,j,i));}
+      return sqrt(d2)/a(m,n,k,j,i);
+    }
+    case RefineCriterion::lohner: {
+      // ratio of second to first differences, with noise filter eps (Lohner 1987)
+      const int n = crit.var;
+      const Real eps = 0.01;
+      Real ac = a(m,n,k,j,i);
+      Real num = SQR(a(m,n,k,j,i+1) - 2.0*ac + a(m,n,k,j,i-1));
+      Real den = SQR(fabs(a(m,n,k,j,i+1) - ac) + fabs(ac - a(m,n,k,j,i-1)) +
+                     eps*(fabs(a(m,n,k,j,i+1)) + 2.0*fabs(ac) + fabs(a(m,n,k,j,i-1))));
+      if (multi_d) {
+        num += SQR(a(m,n,k,j+1,i) - 2.0*ac + a(m,n,k,j-1,i));
+        den += SQR(fabs(a(m,n,k,j+1,i) - ac) + fabs(ac - a(m,n,k,j-1,i)) +
+                   eps*(fabs(a(m,n,k,j+1,i)) + 2.0*fabs(ac) + fabs(a(m,n,k,j-1,i))));
+      }
+      if (three_d) {
+        num += SQR(a(m,n,k+1,j,i) - 2.0*ac + a(m,n,k-1,j,i));
+        den += SQR(fabs(a(m,n,k+1,j,i) - ac) + fabs(ac - a(m,n,k-1,j,i)) +
+                   eps*(fabs(a(m,n,k+1,j,i)) + 2.0*fabs(ac) + fabs(a(m,n,k-1,j,i))));
+      }
+      return (den > 0.0)? sqrt(num/den) : 0.0;
+    }
+    case RefineCriterion::vorticity:
+    case RefineCriterion::current: {
+      // undivided curl of velocity (or magnetic field) using centered differences
+      const bool is_v = (crit.type == RefineCriterion::vorticity);
+      const DvceArray5D<Real> &v = is_v? w : bcc;
+      const int n1 = is_v? IVX : IBX;
+      const int n2 = is_v? IVY : IBY;
+      const int n3 = is_v? IVZ : IBZ;
+      Real cx = 0.0, cy = 0.0, cz = 0.0;
+      cy -= v(m,n3,k,j,i+1) - v(m,n3,k,j,i-1);
+      cz += v(m,n2,k,j,i+1) - v(m,n2,k,j,i-1);
+      if (multi_d) {
+        cx += v(m,n3,k,j+1,i) - v(m,n3,k,j-1,i);
+        cz -= v(m,n1,k,j+1,i) - v(m,n1,k,j-1,i);
+      }
+      if (three_d) {
+        cx -= v(m,n2,k+1,j,i) - v(m,n2,k-1,j,i);
+        cy += v(m,n1,k+1,j,i) - v(m,n1,k-1,j,i);
+      }
+      Real curl = 0.5*sqrt(SQR(cx) + SQR(cy) + SQR(cz));
+      if (is_v) {return curl;}
+      Real bmag = sqrt(SQR(v(m,n1,k,j,i)) + SQR(v(m,n2,k,j,i)) + SQR(v(m,n3,k,j,i)));
+      return (bmag > 0.0)? curl/bmag : 0.0;
+    }
+    default:
+      return 0.0;
+  }
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------
 //! \fn bool MeshRefinement::CheckForRefinement()
 //! \brief Checks for refinement/de-refinement and sets refine_flag(m) for all
 //! MeshBlocks within a MeshBlockPack. Returns true if any MeshBlock needs to be refined.
-//! Default refinement conditions implemented are:
-//!   (1) density max above a threshold value (hydro/MHD)
-//!   (2) gradient of density above a threshold value (hydro/MHD)
-//!   (3) gradient of pressure above a threshold value (hydro/MHD)
-//!   TODO(@user) (4) shear of velocity above a threshold value (hydro/MHD)
-//!   TODO(@user) (5) current density above a threshold (MHD)
-//! These are controlled by input parameters in the <mesh_refinement> block.
+//! All criteria in the list built by AddRefinementCriterion() are evaluated in a single
+//! kernel, with one team reduction over the cells of each MeshBlock per criterion.
+//! Criteria that can be set in the <mesh_refinement> block of the input file are:
+//!   (1) dens_max: density max above a threshold value (hydro/MHD)
+//!   (2) ddens_max: gradient of density above a threshold value (hydro/MHD)
+//!   (3) dpres_max: gradient of pressure above a threshold value (hydro/MHD)
+//!   (4) dvel_max: vorticity above a threshold value (hydro/MHD)
+//!   (5) curr_max: current density relative to |B| above a threshold (MHD)
+//!   (6) lohner_dens_max: Lohner estimator of density above a threshold (hydro/MHD)
 //! User-defined refinement conditions can also be enrolled by setting the *usr_ref_func
 //! pointer in the problem generator.
 
 void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
-  // reallocate and zero refine_flag in host space and sync with device
-  Kokkos::realloc(refine_flag, pmy_mesh->nmb_total);
-  for (int m=0; m<(pmy_mesh->nmb_total); ++m) {
-    refine_flag.h_view(m) = 0;
+  // zero refine_flag on host and device (only reallocated if it grows)
+  if (refine_flag.extent_int(0) < pmy_mesh->nmb_total) {
+    Kokkos::realloc(refine_flag, pmy_mesh->nmb_total);
+  } else {
+    Kokkos::deep_copy(refine_flag.h_view, 0);
+    Kokkos::deep_copy(refine_flag.d_view, 0);
   }
-  refine_flag.template modify<HostMemSpace>();
-  refine_flag.template sync<DevExeSpace>();
 
   // increment cycle counter for each MB
   for (int m=0; m<(pmy_mesh->nmb_total); ++m) {
@@ -191,74 +380,43 @@ void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
 
-  // check (on device) Hydro/MHD refinement conditions for cons vars over all MeshBlocks
+  // check (on device) all refinement criteria for Hydro/MHD over all MeshBlocks
   auto refine_flag_ = refine_flag;
-  auto &dens_thresh  = d_threshold_;
-  auto &ddens_thresh = dd_threshold_;
-  auto &dpres_thresh = dp_threshold_;
   int nmb = pmbp->nmb_thispack;
   int mbs = pmy_mesh->gids_eachrank[global_variable::my_rank];
-  if (((pmbp->phydro != nullptr) || (pmbp->pmhd != nullptr)) && check_cons_) {
+  int ncrit = static_cast<int>(criteria_.size());
+  if (((pmbp->phydro != nullptr) || (pmbp->pmhd != nullptr)) && ncrit > 0) {
     auto &u0 = (pmbp->phydro != nullptr)? pmbp->phydro->u0 : pmbp->pmhd->u0;
     auto &w0 = (pmbp->phydro != nullptr)? pmbp->phydro->w0 : pmbp->pmhd->w0;
+    // cell-centered B only used with MHD, otherwise pass (unused) primitives
+    auto &bcc0 = (pmbp->pmhd != nullptr)? pmbp->pmhd->bcc0 : w0;
+    auto &crit = dcriteria_;
 
-    par_for_outer("ConsRefineCond",DevExeSpace(), 0, 0, 0, (nmb-1),
+    par_for_outer("RefineCriteria",DevExeSpace(), 0, 0, 0, (nmb-1),
     KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
-      // density threshold
-      if (dens_thresh!= 0.0) {
-        Real team_dmax=0.0;
+      bool refine = false, derefine = true;
+      for (int c=0; c<ncrit; ++c) {
+        const RefinementCriterion rc = crit.d_view(c);
+        auto &a = (rc.prim)? w0 : u0;
+        Real team_max = 0.0;
         Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real& dmax) {
+        [=](const int idx, Real& cmax) {
           int k = (idx)/nji;
           int j = (idx - k*nji)/nx1;
           int i = (idx - k*nji - j*nx1) + is;
           j += js;
           k += ks;
-          dmax = fmax(u0(m,IDN,k,j,i), dmax);
-        },Kokkos::Max<Real>(team_dmax));
-
-        if (team_dmax > dens_thresh) {refine_flag_.d_view(m+mbs) = 1;}
-        if (team_dmax < dens_thresh) {refine_flag_.d_view(m+mbs) = -1;}
-      }
+          cmax = fmax(RefinementEstimator(rc, a, w0, bcc0, multi_d, three_d, m, k, j, i),
+                      cmax);
+        },Kokkos::Max<Real>(team_max));
 
-      // density gradient threshold
-      if (ddens_thresh != 0.0) {
-        Real team_ddmax;
-        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real& ddmax) {
-          int k = (idx)/nji;
-          int j = (idx - k*nji)/nx1;
-          int i = (idx - k*nji - j*nx1) + is;
-          j += js;
-          k += ks;
-          Real d2 = SQR(u0(m,IDN,k,j,i+1) - u0(m,IDN,k,j,i-1));
-          if (multi_d) {d2 += SQR(u0(m,IDN,k,j+1,i) - u0(m,IDN,k,j-1,i));}
-          if (three_d) {d2 += SQR(u0(m,IDN,k+1,j,i) - u0(m,IDN,k-1,j,i));}
-          ddmax = fmax((sqrt(d2)/u0(m,IDN,k,j,i)), ddmax);
-        },Kokkos::Max<Real>(team_ddmax));
-
-        if (team_ddmax > ddens_thresh) {refine_flag_.d_view(m+mbs) = 1;}
-        if (team_ddmax < 0.25*ddens_thresh) {refine_flag_.d_view(m+mbs) = -1;}
+        if (team_max > rc.refine_thresh) {refine = true;}
+        if (team_max >= rc.deref_thresh) {derefine = false;}
       }
-
-      // pressure gradient threshold
-      if (dpres_thresh != 0.0) {
-        Real team_dpmax;
-        Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real& dpmax) {
-          int k = (idx)/nji;
-          int j = (idx - k*nji)/nx1;
-          int i = (idx - k*nji - j*nx1) + is;
-          j += js;
-          k += ks;
-          Real d2 = SQR(w0(m,IEN,k,j,i+1) - w0(m,IEN,k,j,i-1));
-          if (multi_d) {d2 += SQR(w0(m,IEN,k,j+1,i) - w0(m,IEN,k,j-1,i));}
-          if (three_d) {d2 += SQR(w0(m,IEN,k+1,j,i) - w0(m,IEN,k-1,j,i));}
-          dpmax = fmax((sqrt(d2)/w0(m,IEN,k,j,i)), dpmax);
-        },Kokkos::Max<Real>(team_dpmax));
-
-        if (team_dpmax > dpres_thresh) {refine_flag_.d_view(m+mbs) = 1;}
-        if (team_dpmax < 0.25*dpres_thresh) {refine_flag_.d_view(m+mbs) = -1;}
+      if (refine) {
+        refine_flag_.d_view(m+mbs) = 1;
+      } else if (derefine) {
+        refine_flag_.d_view(m+mbs) = -1;
       }
     });
   }
@@ -267,9 +425,12 @@ void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
   if (pmy_mesh->pgen->user_ref_func != nullptr) {
     pmy_mesh->pgen->user_ref_func(pmbp);
   }
-  // sync device array with host
-  refine_flag.template modify<DevExeSpace>();
-  refine_flag.template sync<HostMemSpace>();
+  // copy flags of MBs on this rank from device to host.  Only this segment of the array
+  // is ever set, so the remainder need not be synced.
+  auto flag_range = std::make_pair(mbs, mbs+nmb);
+  auto d_flag = Kokkos::subview(refine_flag.d_view, flag_range);
+  auto h_flag = Kokkos::subview(refine_flag.h_view, flag_range);
+  Kokkos::deep_copy(h_flag, d_flag);
 
   // Check (on host) for MeshBlocks at max/root level flagged for refine/derefine
   for (int m=0; m<nmb; ++m) {
@@ -285,15 +446,12 @@ void MeshRefinement::CheckForRefinement(MeshBlockPack* pmbp) {
   for (int m=0; m<nmb; ++m) {
     if (ncyc_since_ref(m+mbs) < refinement_interval) {refine_flag.h_view(m+mbs) = 0;}
   }
-#if MPI_PARALLEL_ENABLED
-  // Pass refine_flag between all ranks
-    MPI_Allgatherv(MPI_IN_PLACE, pmy_mesh->nmb_eachrank[global_variable::my_rank],
-                   MPI_INT, refine_flag.h_view.data(), pmy_mesh->nmb_eachrank,
-                   pmy_mesh->gids_eachrank, MPI_INT, MPI_COMM_WORLD);
-#endif
-  // sync host array with device
-  refine_flag.template modify<HostMemSpace>();
-  refine_flag.template sync<DevExeSpace>();
+  // Flags are only set for MBs on this rank.  They are not gathered over all ranks,
+  // since UpdateMeshBlockTree() only exchanges the locations of MBs that are flagged,
+  // and RedistAndRefineMeshBlocks() recomputes refine_flag for all MBs from the new tree.
+  // copy flags back to device, host and device views are now identical
+  Kokkos::deep_copy(d_flag, h_flag);
+  refine_flag.clear_sync_state();
 
   return;
 }
@@ -317,9 +475,53 @@ void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
     if (refine_flag.h_view(i+mbs) ==  1) nref_eachrank[global_variable::my_rank]++;
     if (refine_flag.h_view(i+mbs) == -1) nderef_eachrank[global_variable::my_rank]++;
   }
+
+  // With refine_buffer, also refine neighbors at the same or a coarser level of MBs
+  // flagged for refinement (neighbors may be on other ranks), so that features moving
+  // across MB boundaries remain within refined regions between checks
+  std::vector<LogicalLocation> llbuf;
+  if (refine_buffer) {
+    auto &nghbr = pmy_mesh->pmb_pack->pmb->nghbr;
+    auto &mblev = pmy_mesh->pmb_pack->pmb->mb_lev;
+    int nnghbr = pmy_mesh->pmb_pack->pmb->nnghbr;
+    int mbe = mbs + pmy_mesh->nmb_thisrank - 1;
+    for (int i=0; i<(pmy_mesh->nmb_thisrank); ++i) {
+      if (refine_flag.h_view(i+mbs) != 1) continue;
+      for (int n=0; n<nnghbr; ++n) {
+        int gid = nghbr.h_view(i,n).gid;
+        if (gid < 0 || nghbr.h_view(i,n).lev > mblev.h_view(i)) continue;
+        // skip neighbors on this rank that are already flagged
+        if (gid >= mbs && gid <= mbe && refine_flag.h_view(gid) == 1) continue;
+        llbuf.push_back(pmy_mesh->lloc_eachmb[gid]);
+      }
+    }
+    // remove duplicates (neighbors shared by several flagged MBs)
+    auto lloc_less = [](const LogicalLocation &a, const LogicalLocation &b) {
+      if (a.level != b.level) {return a.level < b.level;}
+      if (a.lx3 != b.lx3) {return a.lx3 < b.lx3;}
+      if (a.lx2 != b.lx2) {return a.lx2 < b.lx2;}
+      return a.lx1 < b.lx1;
+    };
+    auto lloc_equal = [](const LogicalLocation &a, const LogicalLocation &b) {
+      return (a.level == b.level) && (a.lx1 == b.lx1) && (a.lx2 == b.lx2) &&
+             (a.lx3 == b.lx3);
+    };
+    std::sort(llbuf.begin(), llbuf.end(), lloc_less);
+    llbuf.erase(std::unique(llbuf.begin(), llbuf.end(), lloc_equal), llbuf.end());
+    nref_eachrank[global_variable::my_rank] += static_cast<int>(llbuf.size());
+  }
 #if MPI_PARALLEL_ENABLED
-  MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, nref_eachrank,   1, MPI_INT, MPI_COMM_WORLD);
-  MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, nderef_eachrank, 1, MPI_INT, MPI_COMM_WORLD);
+  // gather (nref, nderef) of all ranks with a single collective
+  {
+    std::vector<int> ncount(2*global_variable::nranks);
+    ncount[2*global_variable::my_rank]   = nref_eachrank[global_variable::my_rank];
+    ncount[2*global_variable::my_rank+1] = nderef_eachrank[global_variable::my_rank];
+    MPI_Allgather(MPI_IN_PLACE, 2, MPI_INT, ncount.data(), 2, MPI_INT, MPI_COMM_WORLD);
+    for (int n=0; n<global_variable::nranks; ++n) {
+      nref_eachrank[n]   = ncount[2*n];
+      nderef_eachrank[n] = ncount[2*n+1];
+    }
+  }
 #endif
 
   // count the number of the blocks to be (de)refined over all ranks
@@ -363,6 +565,7 @@ void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
         llderef[ideref++] = pmy_mesh->lloc_eachmb[gid];
       }
     }
+    for (auto &lloc : llbuf) {llref[iref++] = lloc;}
   }
 #if MPI_PARALLEL_ENABLED
   // Now pass Logical Locations of MBs updated between all ranks.
@@ -381,45 +584,37 @@ void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
 #endif
 
   // Each rank now has a complete list of the LLs of MBs refined/derefined on other ranks
-  // calculate the list of the newly derefined blocks
+  // calculate the list of the newly derefined blocks.  Since children of every node are
+  // consecutive along the space-filling curve (for any ordering), a parent is derefined
+  // when nleaf consecutive entries in the (gid-ordered) list share the same parent.
   int ctnd = 0;
   if (tnderef >= nleaf) {
-    int lk = 0, lj = 0;
-    if (pmy_mesh->multi_d) lj = 1;
-    if (pmy_mesh->three_d) lk = 1;
-    for (int n=0; n<tnderef; n++) {
-      if ((llderef[n].lx1 & 1) == 0 &&
-          (llderef[n].lx2 & 1) == 0 &&
-          (llderef[n].lx3 & 1) == 0) {
-        int r = n, rr = 0;
-        for (std::int32_t k=0; k<=lk; k++) {
-          for (std::int32_t j=0; j<=lj; j++) {
-            for (std::int32_t i=0; i<=1; i++) {
-              if (r < tnderef) {
-                if ((llderef[n].lx1+i) == llderef[r].lx1 &&
-                    (llderef[n].lx2+j) == llderef[r].lx2 &&
-                    (llderef[n].lx3+k) == llderef[r].lx3 &&
-                     llderef[n].level  == llderef[r].level) {
-                  rr++;
-                }
-                r++;
-              }
-            }
-          }
-        }
-        if (rr == nleaf) {
-          cllderef[ctnd].lx1   = llderef[n].lx1 >> 1;
-          cllderef[ctnd].lx2   = llderef[n].lx2 >> 1;
-          cllderef[ctnd].lx3   = llderef[n].lx3 >> 1;
-          cllderef[ctnd].level = llderef[n].level - 1;
-          ctnd++;
+    int n = 0;
+    while (n <= tnderef - nleaf) {
+      int rr = 1;
+      for (int r=n+1; r<n+nleaf; r++) {
+        if ((llderef[n].lx1>>1) == (llderef[r].lx1>>1) &&
+            (llderef[n].lx2>>1) == (llderef[r].lx2>>1) &&
+            (llderef[n].lx3>>1) == (llderef[r].lx3>>1) &&
+             llderef[n].level   == llderef[r].level) {
+          rr++;
         }
       }
+      if (rr == nleaf) {
+        cllderef[ctnd].lx1   = llderef[n].lx1 >> 1;
+        cllderef[ctnd].lx2   = llderef[n].lx2 >> 1;
+        cllderef[ctnd].lx3   = llderef[n].lx3 >> 1;
+        cllderef[ctnd].level = llderef[n].level - 1;
+        ctnd++;
+        n += nleaf;
+      } else {
+        n++;
+      }
     }
   }
   // sort the lists by level
   if (ctnd > 1) {
-    std::sort(cllderef, &(cllderef[ctnd-1]), Mesh::GreaterLevel);
+    std::sort(cllderef, &(cllderef[ctnd]), Mesh::GreaterLevel);
   }
 
   if (tnderef >= nleaf) {
@@ -460,7 +655,8 @@ void MeshRefinement::UpdateMeshBlockTree(int &nnew, int &ndel) {
 //! required. It also requires rebuilding the MB data arrays, coordinates, and neighbors.
 //! Boundary values and primitives are set in calling function: AdaptiveMeshRefinement()
 
-void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, int ndel) {
+void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, int ndel,
+                                               bool incremental) {
   Mesh* pm = pmy_mesh;
   int old_nmb = pm->nmb_total;
   int new_nmb = old_nmb + nnew - ndel;
@@ -475,7 +671,7 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   new_lloc_eachmb = new LogicalLocation[new_nmb];
   newtoold = new int[new_nmb];
   int new_nmb_total;
-  pm->ptree->CreateZOrderedLLList(new_lloc_eachmb, newtoold, new_nmb_total);
+  pm->ptree->CreateOrderedLLList(new_lloc_eachmb, newtoold, new_nmb_total);
   if (new_nmb_total != new_nmb) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
         << "Number of MeshBlocks in new tree = " << new_nmb_total << " but expected "
@@ -505,17 +701,44 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   }
 
   // Step 3.
-  // Calculate new load balance. Initialize new cost array with the simplest estimate
-  // possible: all the blocks are equal
-  // TODO(@user): implement variable cost per MeshBlock as needed
+  // Calculate new load balance. With the measured cost model, cost of each new MB is
+  // estimated from old MBs: refined MBs inherit the cost of their parent (same number of
+  // cells), and derefined MBs are the average of their children. Otherwise all the
+  // blocks are equal.
   new_cost_eachmb = new float[new_nmb];
   new_rank_eachmb = new int[new_nmb];
   new_gids_eachrank = new int[global_variable::nranks];
   new_nmb_eachrank = new int[global_variable::nranks];
 
-  for (int i=0; i<new_nmb; i++) {new_cost_eachmb[i] = 1.0;}
-  pm->LoadBalance(new_cost_eachmb, new_rank_eachmb, new_gids_eachrank, new_nmb_eachrank,
-                  new_nmb_total);
+  if (pm->cost_model.measured) {
+    for (int n=0; n<new_nmb; n++) {
+      int oldm = newtoold[n];
+      if (pm->lloc_eachmb[oldm].level > new_lloc_eachmb[n].level) {  // derefined
+        float csum = 0.0;
+        for (int l=0; l<nleaf; l++) {csum += pm->cost_eachmb[oldm+l];}
+        new_cost_eachmb[n] = csum/static_cast<float>(nleaf);
+      } else {                                                      // same or refined
+        new_cost_eachmb[n] = pm->cost_eachmb[oldm];
+      }
+    }
+  } else {
+    for (int i=0; i<new_nmb; i++) {new_cost_eachmb[i] = 1.0;}
+  }
+  // map previous starting gid of each rank onto new list, so that partitioners can
+  // minimize the number of MBs that migrate between ranks
+  // (incremental rebalancing only shifts boundaries of the current partition instead)
+  if (incremental) {
+    pm->DiffusiveLoadBalance(new_cost_eachmb, new_rank_eachmb, new_gids_eachrank,
+                             new_nmb_eachrank, new_nmb_total);
+  } else {
+    int *prev_gids_eachrank = new int[global_variable::nranks];
+    for (int n=0; n<global_variable::nranks; n++) {
+      prev_gids_eachrank[n] = oldtonew[pm->gids_eachrank[n]];
+    }
+    pm->LoadBalance(new_cost_eachmb, new_rank_eachmb, new_gids_eachrank,
+                    new_nmb_eachrank, new_nmb_total, prev_gids_eachrank);
+    delete [] prev_gids_eachrank;
+  }
   if (new_nmb_eachrank[global_variable::my_rank] > pm->nmb_maxperrank) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
         << "Number of MeshBlocks in this rank on new tree = "
@@ -544,6 +767,21 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   refine_flag.template modify<HostMemSpace>();
   refine_flag.template sync<DevExeSpace>();
 
+  // Coarse arrays are only restricted near MB boundaries in the stage task lists (see
+  // RestrictCCBndry()), so restrict over whole MBs before data of derefined MBs is copied
+  // or sent from them.
+  if (ndel > 0) {
+    hydro::Hydro* phyd = pm->pmb_pack->phydro;
+    mhd::MHD* pmhd = pm->pmb_pack->pmhd;
+    z4c::Z4c* pz4c = pm->pmb_pack->pz4c;
+    if (phyd != nullptr) {RestrictCC(phyd->u0, phyd->coarse_u0);}
+    if (pmhd != nullptr) {
+      RestrictCC(pmhd->u0, pmhd->coarse_u0);
+      RestrictFC(pmhd->b0, pmhd->coarse_b0);
+    }
+    if (pz4c != nullptr) {RestrictCC(pz4c->u0, pz4c->coarse_u0, true);}
+  }
+
   // Step 4.
   // Allocate send/recv buffers for load balancing, post receives.
   // Pack send buffers for load blancing and send data
@@ -553,6 +791,10 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   nmb_sent_thisrank += nmb_send;
 #endif
 
+  // lists of MBs copied within this rank in Steps 5-7, each done with one kernel per
+  // array
+  SetRegridCopies(nleaf);
+
   // Step 5.
   // De-refine (restrict) evolved physics variables for MeshBlocks within this rank.
   // Simply copies data from coarse arrays in source MBs to appropriate octant of fine
@@ -667,11 +909,21 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   pm->pmb_pack->gide = pm->pmb_pack->gids + pm->nmb_eachrank[global_variable::my_rank]-1;
   pm->pmb_pack->nmb_thispack = pm->pmb_pack->gide - pm->pmb_pack->gids + 1;
 
-  delete (pm->pmb_pack->pmb);
-  delete (pm->pmb_pack->pcoord);
-  pm->pmb_pack->AddMeshBlocks(pin);
-  pm->pmb_pack->AddCoordinates(pin);
+  // reuse MeshBlock and Coordinates objects (and their device storage) for new MBs
+  // (neighbors are set first, since they are used to mark fully excised MBs)
+  pm->pmb_pack->pmb->SetMeshBlocks(pm->pmb_pack->gids, pm->pmb_pack->nmb_thispack);
   pm->pmb_pack->pmb->SetNeighbors(pm->ptree, pm->rank_eachmb);
+  pm->pmb_pack->pcoord->ResetExcisionMasks();
+  pm->pmb_pack->pcoord->SetMetricCache();
+  pm->nregrid++;
+
+  // particles keep their gids when MBs are only redistributed, so move them to new ranks
+  if (pm->pmb_pack->ppart != nullptr && nnew == 0 && ndel == 0) {
+    pm->pmb_pack->ppart->Migrate();
+  }
+
+  // work recorded for old MBs on this rank no longer valid
+  if (pm->cost_model.measured) {pm->ResetMeasuredCost();}
 
   // clean-up and return
   delete [] newtoold;
@@ -679,59 +931,111 @@ void MeshRefinement::RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, in
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::SetRegridCopies
+//! \brief Builds lists of the copies of MeshBlock data made on this rank during
+//! RedistAndRefineMeshBlocks(), so that each copy function below is a single kernel over
+//! all MBs (rather than a deep_copy of each MB), synced to the device once per regrid:
+//!   deref_copies_:  coarse arrays of the nleaf MBs of a derefined MB to octants of fine
+//!                   array of target MB (indices of old MBs)
+//!   move_copies_:   MBs that stay on this rank but change index within View
+//!   refine_copies_: octants of fine array of MB flagged for refinement to coarse arrays
+//!                   of the new MBs (indices of new MBs)
+//! Moves may overwrite the source of other moves, so sources that are also targets of a
+//! move are first copied to a temporary array (mtmp >= 0).
+
+void MeshRefinement::SetRegridCopies(int nleaf) {
+  int ombs = pmy_mesh->gids_eachrank[global_variable::my_rank];
+  int ombe = ombs + pmy_mesh->nmb_eachrank[global_variable::my_rank] - 1;
+  int nmbs = new_gids_eachrank[global_variable::my_rank];
+  int nmbe = nmbs + new_nmb_eachrank[global_variable::my_rank] - 1;
+  std::vector<RegridCopy> deref, move, refine;
+
+  // derefined MBs whose target stays on this rank, for source MBs on this rank
+  for (int oldm=ombs; oldm<=ombe; ++oldm) {
+    if ((refine_flag.h_view(oldm) < -1) &&
+        (new_rank_eachmb[oldtonew[oldm]] == global_variable::my_rank)) {
+      for (int l=0; l<nleaf && (oldm+l)<=ombe; l++) {
+        LogicalLocation &lloc = pmy_mesh->lloc_eachmb[oldm+l];
+        deref.push_back({(oldm-ombs+l), (oldm-ombs), -1, static_cast<int>(lloc.lx1 & 1),
+                         static_cast<int>(lloc.lx2 & 1), static_cast<int>(lloc.lx3 & 1)});
+      }
+    }
+  }
+
+  // MBs that stay on this rank but move within View.  Of derefined MBs (for which
+  // new[m] = new[m-1]) only the first, which holds the derefined data, is moved.
+  int nview = std::max(ombe - ombs, nmbe - nmbs) + 1;
+  std::vector<bool> is_target(nview, false);
+  for (int oldm=ombs; oldm<=ombe; ++oldm) {
+    int newm = oldtonew[oldm];
+    if (new_rank_eachmb[newm] != global_variable::my_rank) continue;
+    if ((oldm > ombs) && (newm == oldtonew[oldm-1])) continue;
+    int msrc = oldm - ombs;
+    int mdst = newm - nmbs;
+    if (mdst != msrc) {
+      move.push_back({msrc, mdst, -1, 0, 0, 0});
+      is_target[mdst] = true;
+    }
+  }
+  nmove_tmp_ = 0;
+  for (auto &cp : move) {
+    if (is_target[cp.msrc]) {cp.mtmp = nmove_tmp_++;}
+  }
+
+  // MBs flagged for refinement, when both old and new MB are on this rank
+  for (int newm=nmbs; newm<=nmbe; ++newm) {
+    int oldm = newtoold[newm];
+    if ((refine_flag.h_view(oldm) > 0) &&
+        (new_rank_eachmb[oldtonew[oldm]] == global_variable::my_rank)) {
+      LogicalLocation &lloc = new_lloc_eachmb[newm];
+      refine.push_back({(oldtonew[oldm]-nmbs), (newm-nmbs), -1,
+                        static_cast<int>(lloc.lx1 & 1), static_cast<int>(lloc.lx2 & 1),
+                        static_cast<int>(lloc.lx3 & 1)});
+    }
+  }
+
+  // copy lists to device
+  std::vector<RegridCopy> *lists[3] = {&deref, &move, &refine};
+  DualArray1D<RegridCopy> *dlists[3] = {&deref_copies_, &move_copies_, &refine_copies_};
+  for (int n=0; n<3; ++n) {
+    Kokkos::realloc(*dlists[n], lists[n]->size());
+    for (std::size_t c=0; c<lists[n]->size(); ++c) {
+      dlists[n]->h_view(c) = (*lists[n])[c];
+    }
+    dlists[n]->template modify<HostMemSpace>();
+    dlists[n]->template sync<DevExeSpace>();
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::DerefineCCSameRank
 //! \brief For any MeshBlock m flagged for derefinment (refine_flag = -nleaf), copies
 //! cell-centered variables in input coarse array for the nleaf MeshBlock indices that are
 //! immediately following to the appropriate quadrant of the MeshBlock m in the input
 //! fine array,overwriting any data located there.  Only operates on MBs on the same rank
+//! (listed in deref_copies_).
 
 void MeshRefinement::DerefineCCSameRank(DvceArray5D<Real> &a, DvceArray5D<Real> &ca) {
-  // nleaf = number of leaf MeshBlocks per refined block
-  int nleaf = 2;
-  if (pmy_mesh->two_d) nleaf = 4;
-  if (pmy_mesh->three_d) nleaf = 8;
-
+  int ncopy = deref_copies_.extent_int(0);
+  if (ncopy == 0) {return;}
+  int nvar = a.extent_int(1);
   auto &indcs = pmy_mesh->mb_indcs;
-  auto &is  = indcs.is,  &js  = indcs.js,  &ks  = indcs.ks;
-  auto &cis = indcs.cis, &cjs = indcs.cjs, &cks = indcs.cks;
-  auto &cie = indcs.cie, &cje = indcs.cje, &cke = indcs.cke;
-  auto &cnx1 = indcs.cnx1, &cnx2 = indcs.cnx2, &cnx3 = indcs.cnx3;
-
-  // Set indices of source (coarse) array
-  std::pair<int,int> isrc = std::make_pair(cis,cie+1);
-  std::pair<int,int> jsrc = std::make_pair(cjs,cje+1);
-  std::pair<int,int> ksrc = std::make_pair(cks,cke+1);
-
-  // loop over old MBs
-  int ombs = pmy_mesh->gids_eachrank[global_variable::my_rank];
-  int ombe = ombs + pmy_mesh->nmb_eachrank[global_variable::my_rank] - 1;
-  for (int oldm=ombs; oldm<=ombe; ++oldm) {
-    if (refine_flag.h_view(oldm) < -1) {  // only derefine if nleaf blocks flagged
-      int newm = oldtonew[oldm];
-      // only copy data if target MB stays on this rank
-      if (new_rank_eachmb[newm] == global_variable::my_rank) {
-        for (int l=0; l<nleaf; l++) {
-          // only move if source array on this rank
-          if ((oldm+l) <= ombe) {
-            LogicalLocation &lloc = pmy_mesh->lloc_eachmb[oldm+l];
-            int ox1 = ((lloc.lx1 & 1) == 1);
-            int ox2 = ((lloc.lx2 & 1) == 1);
-            int ox3 = ((lloc.lx3 & 1) == 1);
-            std::pair<int,int> idst = std::make_pair((is+ox1*cnx1),(is+(ox1+1)*cnx1));
-            std::pair<int,int> jdst = std::make_pair((js+ox2*cnx2),(js+(ox2+1)*cnx2));
-            std::pair<int,int> kdst = std::make_pair((ks+ox3*cnx3),(ks+(ox3+1)*cnx3));
-
-            // Copy data directly from coarse arrays in MBs to fine array in target MB
-            // use indices of old MBs since this function called before CopyL/R
-            auto src = Kokkos::subview(ca,(oldm-ombs+l),Kokkos::ALL,ksrc,jsrc,isrc);
-            auto dst = Kokkos::subview( a,(oldm-ombs  ),Kokkos::ALL,kdst,jdst,idst);
-            Kokkos::deep_copy(DevExeSpace(), dst, src);
-          }
-        }
-      }
-    }
-  }
+  int is  = indcs.is,  js  = indcs.js,  ks  = indcs.ks;
+  int cis = indcs.cis, cjs = indcs.cjs, cks = indcs.cks;
+  int cie = indcs.cie, cje = indcs.cje, cke = indcs.cke;
+  int cnx1 = indcs.cnx1, cnx2 = indcs.cnx2, cnx3 = indcs.cnx3;
+  auto &copies = deref_copies_;
+
+  // Copy data directly from coarse arrays in MBs to fine array in target MB
+  // use indices of old MBs since this function called before CopyCC
+  par_for("DerefineCC", DevExeSpace(), 0, (ncopy-1), 0, (nvar-1), cks, cke, cjs, cje,
+          cis, cie, KOKKOS_LAMBDA(int c, int n, int k, int j, int i) {
+    const RegridCopy cp = copies.d_view(c);
+    a(cp.mdst,n,(ks + cp.ox3*cnx3 + k - cks),(js + cp.ox2*cnx2 + j - cjs),
+      (is + cp.ox1*cnx1 + i - cis)) = ca(cp.msrc,n,k,j,i);
+  });
   return;
 }
 
@@ -740,107 +1044,56 @@ void MeshRefinement::DerefineCCSameRank(DvceArray5D<Real> &a, DvceArray5D<Real>
 //! \brief Same as DerefineCCSameRank, except for face-centered variables
 
 void MeshRefinement::DerefineFCSameRank(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb) {
-  // nleaf = number of leaf MeshBlocks per refined block
-  int nleaf = 2;
-  if (pmy_mesh->two_d) nleaf = 4;
-  if (pmy_mesh->three_d) nleaf = 8;
-
+  int ncopy = deref_copies_.extent_int(0);
+  if (ncopy == 0) {return;}
   auto &indcs = pmy_mesh->mb_indcs;
-  auto &is  = indcs.is,  &js  = indcs.js,  &ks  = indcs.ks;
-  auto &cis = indcs.cis, &cjs = indcs.cjs, &cks = indcs.cks;
-  auto &cie = indcs.cie, &cje = indcs.cje, &cke = indcs.cke;
-  auto &cnx1 = indcs.cnx1, &cnx2 = indcs.cnx2, &cnx3 = indcs.cnx3;
-
-  // Set indices of source (coarse) array
-  std::pair<int,int> isrc  = std::make_pair(cis,cie+1);
-  std::pair<int,int> isrc1 = std::make_pair(cis,cie+2);
-  std::pair<int,int> jsrc  = std::make_pair(cjs,cje+1);
-  std::pair<int,int> jsrc1 = std::make_pair(cjs,cje+2);
-  std::pair<int,int> ksrc  = std::make_pair(cks,cke+1);
-  std::pair<int,int> ksrc1 = std::make_pair(cks,cke+2);
-
-  // loop over old MBs
-  int ombs = pmy_mesh->gids_eachrank[global_variable::my_rank];
-  int ombe = ombs + pmy_mesh->nmb_eachrank[global_variable::my_rank] - 1;
-  for (int oldm=ombs; oldm<=ombe; ++oldm) {
-    if (refine_flag.h_view(oldm) < -1) {  // only derefine if nleaf blocks flagged
-      int newm = oldtonew[oldm];
-      // only copy data if target MB stays on this rank
-      if (new_rank_eachmb[newm] == global_variable::my_rank) {
-        for (int l=0; l<nleaf; l++) {
-          // only move if source array on this rank
-          if ((oldm+l) <= ombe) {
-            LogicalLocation &lloc = pmy_mesh->lloc_eachmb[oldm+l];
-            int ox1 = ((lloc.lx1 & 1) == 1);
-            int ox2 = ((lloc.lx2 & 1) == 1);
-            int ox3 = ((lloc.lx3 & 1) == 1);
-            std::pair<int,int> idst  = std::make_pair((is+ox1*cnx1),(is+(ox1+1)*cnx1  ));
-            std::pair<int,int> idst1 = std::make_pair((is+ox1*cnx1),(is+(ox1+1)*cnx1+1));
-            std::pair<int,int> jdst  = std::make_pair((js+ox2*cnx2),(js+(ox2+1)*cnx2  ));
-            std::pair<int,int> jdst1 = std::make_pair((js+ox2*cnx2),(js+(ox2+1)*cnx2+1));
-            std::pair<int,int> kdst  = std::make_pair((ks+ox3*cnx3),(ks+(ox3+1)*cnx3  ));
-            std::pair<int,int> kdst1 = std::make_pair((ks+ox3*cnx3),(ks+(ox3+1)*cnx3+1));
-
-            // Copy data directly from coarse arrays in MBs to fine array in target MB
-            // use indices of old MBs since this function called before CopyL/R
-            auto src1 = Kokkos::subview(cb.x1f,(oldm-ombs+l),ksrc,jsrc,isrc1);
-            auto dst1 = Kokkos::subview( b.x1f,(oldm-ombs  ),kdst,jdst,idst1);
-            Kokkos::deep_copy(DevExeSpace(), dst1, src1);
-            auto src2 = Kokkos::subview(cb.x2f,(oldm-ombs+l),ksrc,jsrc1,isrc);
-            auto dst2 = Kokkos::subview( b.x2f,(oldm-ombs  ),kdst,jdst1,idst);
-            Kokkos::deep_copy(DevExeSpace(), dst2, src2);
-            auto src3 = Kokkos::subview(cb.x3f,(oldm-ombs+l),ksrc1,jsrc,isrc);
-            auto dst3 = Kokkos::subview( b.x3f,(oldm-ombs  ),kdst1,jdst,idst);
-            Kokkos::deep_copy(DevExeSpace(), dst3, src3);
-          }
-        }
-      }
-    }
-  }
+  int is  = indcs.is,  js  = indcs.js,  ks  = indcs.ks;
+  int cis = indcs.cis, cjs = indcs.cjs, cks = indcs.cks;
+  int cie = indcs.cie, cje = indcs.cje, cke = indcs.cke;
+  int cnx1 = indcs.cnx1, cnx2 = indcs.cnx2, cnx3 = indcs.cnx3;
+  auto &copies = deref_copies_;
+
+  // all three components in one kernel, over range of largest index in each direction
+  par_for("DerefineFC", DevExeSpace(), 0, (ncopy-1), cks, cke+1, cjs, cje+1, cis, cie+1,
+  KOKKOS_LAMBDA(int c, int k, int j, int i) {
+    const RegridCopy cp = copies.d_view(c);
+    int fk = ks + cp.ox3*cnx3 + k - cks;
+    int fj = js + cp.ox2*cnx2 + j - cjs;
+    int fi = is + cp.ox1*cnx1 + i - cis;
+    if (k <= cke && j <= cje) {b.x1f(cp.mdst,fk,fj,fi) = cb.x1f(cp.msrc,k,j,i);}
+    if (k <= cke && i <= cie) {b.x2f(cp.mdst,fk,fj,fi) = cb.x2f(cp.msrc,k,j,i);}
+    if (j <= cje && i <= cie) {b.x3f(cp.mdst,fk,fj,fi) = cb.x3f(cp.msrc,k,j,i);}
+  });
   return;
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::CopyCC
 //! \brief Copy cell-centered variables to new MB index within View for MeshBlocks that
-//! stay within this rank
+//! stay within this rank (listed in move_copies_).  Sources that are overwritten by other
+//! moves are first copied to a temporary array.
 
 void MeshRefinement::CopyCC(DvceArray5D<Real> &a) {
-  int ombs = pmy_mesh->gids_eachrank[global_variable::my_rank];
-  int ombe = ombs + pmy_mesh->nmb_eachrank[global_variable::my_rank] - 1;
-
-  // Copy MBs for which (new gid) < (old gid) [Move L]
-  // loop over old MBs (note m=mbs cannot be moved)
-  for (int oldm=ombs+1; oldm<=ombe; ++oldm) {
-    int newm  = oldtonew[oldm];
-    int newm1 = oldtonew[oldm-1];
-    // only move data if target array on this rank
-    if (new_rank_eachmb[newm] != global_variable::my_rank) continue;
-    int msrc = oldm - ombs;
-    int mdst = newm - new_gids_eachrank[global_variable::my_rank];
-    // Only move MBs whose location in View moves L (mdst < msrc)
-    // Do not move MBs that have been de-refined (for which new[m] = new[m-1]).
-    if ( ((mdst - msrc) < 0) && (newm != newm1) ) {
-      auto src = Kokkos::subview(a,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst = Kokkos::subview(a,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst, src);
-    }
-  }
-
-  // Copy MBs for which (new gid) > (old gid) [Move R]
-  for (int oldm=ombe; oldm>=ombs; --oldm) {
-    int newm  = oldtonew[oldm];
-    // only move data if target array on this rank
-    if (new_rank_eachmb[newm] != global_variable::my_rank) continue;
-    int msrc = oldm - ombs;
-    int mdst = newm - new_gids_eachrank[global_variable::my_rank];
-    // Only move MBs whose location in View moves R (mdst > msrc)
-    if ((mdst - msrc) > 0) {
-      auto src = Kokkos::subview(a,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst = Kokkos::subview(a,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst, src);
-    }
+  int ncopy = move_copies_.extent_int(0);
+  if (ncopy == 0) {return;}
+  int nvar = a.extent_int(1);
+  int n3 = a.extent_int(2), n2 = a.extent_int(3), n1 = a.extent_int(4);
+  auto &copies = move_copies_;
+
+  DvceArray5D<Real> tmp(Kokkos::view_alloc(Kokkos::WithoutInitializing, "regrid_tmp"),
+                        std::max(nmove_tmp_, 1), nvar, n3, n2, n1);
+  if (nmove_tmp_ > 0) {
+    par_for("CopyCC-tmp", DevExeSpace(), 0, (ncopy-1), 0, (nvar-1), 0, (n3-1), 0, (n2-1),
+            0, (n1-1), KOKKOS_LAMBDA(int c, int n, int k, int j, int i) {
+      const RegridCopy cp = copies.d_view(c);
+      if (cp.mtmp >= 0) {tmp(cp.mtmp,n,k,j,i) = a(cp.msrc,n,k,j,i);}
+    });
   }
+  par_for("CopyCC", DevExeSpace(), 0, (ncopy-1), 0, (nvar-1), 0, (n3-1), 0, (n2-1),
+          0, (n1-1), KOKKOS_LAMBDA(int c, int n, int k, int j, int i) {
+    const RegridCopy cp = copies.d_view(c);
+    a(cp.mdst,n,k,j,i) = (cp.mtmp >= 0)? tmp(cp.mtmp,n,k,j,i) : a(cp.msrc,n,k,j,i);
+  });
   return;
 }
 
@@ -850,53 +1103,38 @@ void MeshRefinement::CopyCC(DvceArray5D<Real> &a) {
 //! stay within this rank
 
 void MeshRefinement::CopyFC(DvceFaceFld4D<Real> &b) {
-  int ombs = pmy_mesh->gids_eachrank[global_variable::my_rank];
-  int ombe = ombs + pmy_mesh->nmb_eachrank[global_variable::my_rank] - 1;
-
-  // Copy MBs for which (new gid) < (old gid) [Move L]
-  // loop over old MBs (note m=mbs cannot be moved)
-  for (int oldm=ombs+1; oldm<=ombe; ++oldm) {
-    int newm  = oldtonew[oldm];
-    int newm1 = oldtonew[oldm-1];
-    // only move data if target array on this rank
-    if (new_rank_eachmb[newm] != global_variable::my_rank) continue;
-    int msrc = oldm - ombs;
-    int mdst = newm - new_gids_eachrank[global_variable::my_rank];
-    // Only move MBs whose location in View moves L (mdst < msrc)
-    // Do not move MBs that have been de-refined (for which new[m] = new[m-1]).
-    if ( ((mdst - msrc) < 0) && (newm != newm1) ) {
-      auto src1 = Kokkos::subview(b.x1f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst1 = Kokkos::subview(b.x1f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst1, src1);
-      auto src2 = Kokkos::subview(b.x2f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst2 = Kokkos::subview(b.x2f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst2, src2);
-      auto src3 = Kokkos::subview(b.x3f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst3 = Kokkos::subview(b.x3f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst3, src3);
-    }
+  int ncopy = move_copies_.extent_int(0);
+  if (ncopy == 0) {return;}
+  // number of cells in each direction
+  int n3 = b.x1f.extent_int(1), n2 = b.x1f.extent_int(2), n1 = b.x2f.extent_int(3);
+  auto &copies = move_copies_;
+
+  DvceFaceFld4D<Real> tmp("regrid_tmp", std::max(nmove_tmp_, 1), n3, n2, n1);
+  if (nmove_tmp_ > 0) {
+    par_for("CopyFC-tmp", DevExeSpace(), 0, (ncopy-1), 0, n3, 0, n2, 0, n1,
+    KOKKOS_LAMBDA(int c, int k, int j, int i) {
+      const RegridCopy cp = copies.d_view(c);
+      if (cp.mtmp >= 0) {
+        if (k < n3 && j < n2) {tmp.x1f(cp.mtmp,k,j,i) = b.x1f(cp.msrc,k,j,i);}
+        if (k < n3 && i < n1) {tmp.x2f(cp.mtmp,k,j,i) = b.x2f(cp.msrc,k,j,i);}
+        if (j < n2 && i < n1) {tmp.x3f(cp.mtmp,k,j,i) = b.x3f(cp.msrc,k,j,i);}
+      }
+    });
   }
-
-  // Copy MBs for which (new gid) > (old gid) [Move R]
-  for (int oldm=ombe; oldm>=ombs; --oldm) {
-    int newm  = oldtonew[oldm];
-    // only move data if target array on this rank
-    if (new_rank_eachmb[newm] != global_variable::my_rank) continue;
-    int msrc = oldm - ombs;
-    int mdst = newm - new_gids_eachrank[global_variable::my_rank];
-    // Only move MBs whose location in View moves R (mdst > msrc)
-    if ((mdst - msrc) > 0) {
-      auto src1 = Kokkos::subview(b.x1f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst1 = Kokkos::subview(b.x1f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst1, src1);
-      auto src2 = Kokkos::subview(b.x2f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst2 = Kokkos::subview(b.x2f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst2, src2);
-      auto src3 = Kokkos::subview(b.x3f,msrc,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      auto dst3 = Kokkos::subview(b.x3f,mdst,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(DevExeSpace(), dst3, src3);
+  par_for("CopyFC", DevExeSpace(), 0, (ncopy-1), 0, n3, 0, n2, 0, n1,
+  KOKKOS_LAMBDA(int c, int k, int j, int i) {
+    const RegridCopy cp = copies.d_view(c);
+    const bool buf = (cp.mtmp >= 0);
+    if (k < n3 && j < n2) {
+      b.x1f(cp.mdst,k,j,i) = (buf)? tmp.x1f(cp.mtmp,k,j,i) : b.x1f(cp.msrc,k,j,i);
     }
-  }
+    if (k < n3 && i < n1) {
+      b.x2f(cp.mdst,k,j,i) = (buf)? tmp.x2f(cp.mtmp,k,j,i) : b.x2f(cp.msrc,k,j,i);
+    }
+    if (j < n2 && i < n1) {
+      b.x3f(cp.mdst,k,j,i) = (buf)? tmp.x3f(cp.mtmp,k,j,i) : b.x3f(cp.msrc,k,j,i);
+    }
+  });
   return;
 }
 
@@ -905,9 +1143,12 @@ void MeshRefinement::CopyFC(DvceFaceFld4D<Real> &b) {
 //! \brief For any MeshBlock m flagged for refinment (refine_flag = 1), copies
 //! cell-centered variables in octants of input fine array to the input coarse arrays at
 //! the nleaf-index locations that are immediately following (overwriting any data located
-//! there).  Only operates on MBs on the same rank.
+//! there).  Only operates on MBs on the same rank (listed in refine_copies_).
 
 void MeshRefinement::CopyForRefinementCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca) {
+  int ncopy = refine_copies_.extent_int(0);
+  if (ncopy == 0) {return;}
+  int nvar = a.extent_int(1);
   auto &indcs = pmy_mesh->mb_indcs;
   auto &ng = indcs.ng;
   int il = indcs.cis - ng, iu = indcs.cie + ng;
@@ -919,39 +1160,16 @@ void MeshRefinement::CopyForRefinementCC(DvceArray5D<Real> &a, DvceArray5D<Real>
   if (pmy_mesh->three_d) {
     kl -= ng; ku += ng;
   }
-  auto &cnx1 = indcs.cnx1, &cnx2 = indcs.cnx2, &cnx3 = indcs.cnx3;
-
-  // Set indices of destination (coarse) array
-  std::pair<int,int> idst = std::make_pair(il,iu+1);
-  std::pair<int,int> jdst = std::make_pair(jl,ju+1);
-  std::pair<int,int> kdst = std::make_pair(kl,ku+1);
-
-  // loop over new MBs on this rank
-  int nmbs = new_gids_eachrank[global_variable::my_rank];
-  int nmbe = nmbs + new_nmb_eachrank[global_variable::my_rank] - 1;
-  for (int newm=nmbs; newm<=nmbe; ++newm) {
-    int oldm = newtoold[newm];
-    if (refine_flag.h_view(oldm) > 0) {
-      // only copy if old and new location of MB on this rank
-      if ((new_rank_eachmb[oldtonew[oldm]] == global_variable::my_rank) &&
-          (new_rank_eachmb[newm] == global_variable::my_rank)) {
-        int msrc = oldtonew[oldm] - nmbs;
-        int mdst = newm - nmbs;
-        LogicalLocation &lloc = new_lloc_eachmb[newm];
-        int ox1 = ((lloc.lx1 & 1) == 1);
-        int ox2 = ((lloc.lx2 & 1) == 1);
-        int ox3 = ((lloc.lx3 & 1) == 1);
-        std::pair<int,int> isrc = std::make_pair((il + ox1*cnx1),(iu+1 + ox1*cnx1));
-        std::pair<int,int> jsrc = std::make_pair((jl + ox2*cnx2),(ju+1 + ox2*cnx2));
-        std::pair<int,int> ksrc = std::make_pair((kl + ox3*cnx3),(ku+1 + ox3*cnx3));
-
-        // copy data in MBs to be refined to coarse arrays in target MBs
-        auto src = Kokkos::subview( a,msrc,Kokkos::ALL,ksrc,jsrc,isrc);
-        auto dst = Kokkos::subview(ca,mdst,Kokkos::ALL,kdst,jdst,idst);
-        Kokkos::deep_copy(DevExeSpace(), dst, src);
-      }
-    }
-  }
+  int cnx1 = indcs.cnx1, cnx2 = indcs.cnx2, cnx3 = indcs.cnx3;
+  auto &copies = refine_copies_;
+
+  // copy data in MBs to be refined to coarse arrays in target MBs
+  par_for("CopyForRefCC", DevExeSpace(), 0, (ncopy-1), 0, (nvar-1), kl, ku, jl, ju,
+          il, iu, KOKKOS_LAMBDA(int c, int n, int k, int j, int i) {
+    const RegridCopy cp = copies.d_view(c);
+    ca(cp.mdst,n,k,j,i) = a(cp.msrc,n,(k + cp.ox3*cnx3),(j + cp.ox2*cnx2),
+                            (i + cp.ox1*cnx1));
+  });
   return;
 }
 
@@ -960,6 +1178,8 @@ void MeshRefinement::CopyForRefinementCC(DvceArray5D<Real> &a, DvceArray5D<Real>
 //! \brief Same as CopyForRefinementCC, but for face-centered arrays
 
 void MeshRefinement::CopyForRefinementFC(DvceFaceFld4D<Real> &b,DvceFaceFld4D<Real> &cb) {
+  int ncopy = refine_copies_.extent_int(0);
+  if (ncopy == 0) {return;}
   auto &indcs = pmy_mesh->mb_indcs;
   auto &ng = indcs.ng;
   int il = indcs.cis - ng, iu = indcs.cie + ng;
@@ -971,51 +1191,20 @@ void MeshRefinement::CopyForRefinementFC(DvceFaceFld4D<Real> &b,DvceFaceFld4D<Re
   if (pmy_mesh->three_d) {
     kl -= ng; ku += ng;
   }
-  auto &cnx1 = indcs.cnx1, &cnx2 = indcs.cnx2, &cnx3 = indcs.cnx3;
-
-  // Set indices of destination (coarse) array
-  std::pair<int,int> idst  = std::make_pair(il,iu+1);
-  std::pair<int,int> idst1 = std::make_pair(il,iu+2);
-  std::pair<int,int> jdst  = std::make_pair(jl,ju+1);
-  std::pair<int,int> jdst1 = std::make_pair(jl,ju+2);
-  std::pair<int,int> kdst  = std::make_pair(kl,ku+1);
-  std::pair<int,int> kdst1 = std::make_pair(kl,ku+2);
-
-  // loop over new MBs on this rank
-  int nmbs = new_gids_eachrank[global_variable::my_rank];
-  int nmbe = nmbs + new_nmb_eachrank[global_variable::my_rank] - 1;
-  for (int newm=nmbs; newm<=nmbe; ++newm) {
-    int oldm = newtoold[newm];
-    if (refine_flag.h_view(oldm) > 0) {
-      // only copy if old and new location of MB on this rank
-      if ((new_rank_eachmb[oldtonew[oldm]] == global_variable::my_rank) &&
-          (new_rank_eachmb[newm] == global_variable::my_rank)) {
-        int msrc = oldtonew[oldm] - nmbs;
-        int mdst = newm - nmbs;
-        LogicalLocation &lloc = new_lloc_eachmb[newm];
-        int ox1 = ((lloc.lx1 & 1) == 1);
-        int ox2 = ((lloc.lx2 & 1) == 1);
-        int ox3 = ((lloc.lx3 & 1) == 1);
-        std::pair<int,int> isrc  = std::make_pair((il + ox1*cnx1),(iu+1 + ox1*cnx1  ));
-        std::pair<int,int> isrc1 = std::make_pair((il + ox1*cnx1),(iu+1 + ox1*cnx1+1));
-        std::pair<int,int> jsrc  = std::make_pair((jl + ox2*cnx2),(ju+1 + ox2*cnx2  ));
-        std::pair<int,int> jsrc1 = std::make_pair((jl + ox2*cnx2),(ju+1 + ox2*cnx2+1));
-        std::pair<int,int> ksrc  = std::make_pair((kl + ox3*cnx3),(ku+1 + ox3*cnx3  ));
-        std::pair<int,int> ksrc1 = std::make_pair((kl + ox3*cnx3),(ku+1 + ox3*cnx3+1));
-
-        // copy data in MBs to be refined to coarse arrays in target MBs
-        auto src1 = Kokkos::subview( b.x1f,msrc,ksrc,jsrc,isrc1);
-        auto dst1 = Kokkos::subview(cb.x1f,mdst,kdst,jdst,idst1);
-        Kokkos::deep_copy(DevExeSpace(), dst1, src1);
-        auto src2 = Kokkos::subview( b.x2f,msrc,ksrc,jsrc1,isrc);
-        auto dst2 = Kokkos::subview(cb.x2f,mdst,kdst,jdst1,idst);
-        Kokkos::deep_copy(DevExeSpace(), dst2, src2);
-        auto src3 = Kokkos::subview( b.x3f,msrc,ksrc1,jsrc,isrc);
-        auto dst3 = Kokkos::subview(cb.x3f,mdst,kdst1,jdst,idst);
-        Kokkos::deep_copy(DevExeSpace(), dst3, src3);
-      }
-    }
-  }
+  int cnx1 = indcs.cnx1, cnx2 = indcs.cnx2, cnx3 = indcs.cnx3;
+  auto &copies = refine_copies_;
+
+  // all three components in one kernel, over range of largest index in each direction
+  par_for("CopyForRefFC", DevExeSpace(), 0, (ncopy-1), kl, ku+1, jl, ju+1, il, iu+1,
+  KOKKOS_LAMBDA(int c, int k, int j, int i) {
+    const RegridCopy cp = copies.d_view(c);
+    int fk = k + cp.ox3*cnx3;
+    int fj = j + cp.ox2*cnx2;
+    int fi = i + cp.ox1*cnx1;
+    if (k <= ku && j <= ju) {cb.x1f(cp.mdst,k,j,i) = b.x1f(cp.msrc,fk,fj,fi);}
+    if (k <= ku && i <= iu) {cb.x2f(cp.mdst,k,j,i) = b.x2f(cp.msrc,fk,fj,fi);}
+    if (j <= ju && i <= iu) {cb.x3f(cp.mdst,k,j,i) = b.x3f(cp.msrc,fk,fj,fi);}
+  });
   return;
 }
 
@@ -1034,16 +1223,46 @@ void MeshRefinement::RefineCC(DualArray1D<int> &n2o, DvceArray5D<Real> &a,
   auto &cis = indcs.cis, &cie = indcs.cie;
   auto &cjs = indcs.cjs, &cje = indcs.cje;
   auto &cks = indcs.cks, &cke = indcs.cke;
-  auto &nx1 = indcs.nx1;
-  auto &nx2 = indcs.nx2;
-  auto &nx3 = indcs.nx3;
-  auto& prolong_2nd = weights.prolong_2nd;
-  auto& prolong_4th = weights.prolong_4th;
 
   auto &refine_flag_ = refine_flag;
   bool &multi_d = pmy_mesh->multi_d;
   bool &three_d = pmy_mesh->three_d;
   auto &ngids_ = new_gids_eachrank[global_variable::my_rank];
+  const int ni = cie - cis + 1;
+  const int nj = cje - cjs + 1;
+  const int nk = cke - cks + 1;
+
+  // High-order prolongation for Z4c: outer loop over MeshBlocks, with vector lanes over
+  // the (many) variables so the stencil geometry is computed once per coarse cell
+  if (is_z4c) {
+    const int ng = indcs.ng;
+    ProlongWeights<2> wt2(weights.prolong_2nd);
+    ProlongWeights<4> wt4(weights.prolong_4th);
+    Kokkos::TeamPolicy<> zpolicy(DevExeSpace(), new_nmb, Kokkos::AUTO, Kokkos::AUTO);
+    Kokkos::parallel_for("RefineCCVars", zpolicy, KOKKOS_LAMBDA(TeamMember_t tmember) {
+      const int m = tmember.league_rank();
+      if (refine_flag_.d_view(n2o.d_view(m+ngids_)) > 0) {
+        const int nji  = nj*ni;
+        Kokkos::parallel_for(Kokkos::TeamThreadRange<>(tmember, nk*nji),
+        [&](const int idx) {
+          int k = (idx)/nji;
+          int j = (idx - k*nji)/ni;
+          int i = (idx - k*nji - j*ni) + cis;
+          k += cks;
+          j += cjs;
+          int fi = 2*i - cis;  // correct when cis=is
+          int fj = 2*j - cjs;  // correct when cjs=js
+          int fk = 2*k - cks;  // correct when cks=ks
+          if (ng == 2) {
+            HighOrderProlongCCVars<2>(tmember,m,nvar,k,j,i,fk,fj,fi,ca,a,wt2);
+          } else if (ng == 4) {
+            HighOrderProlongCCVars<4>(tmember,m,nvar,k,j,i,fk,fj,fi,ca,a,wt4);
+          }
+        });
+      }
+    });
+    return;
+  }
   // Outer loop over (# of MeshBlocks sent)*(# of variables)
   int nmv = new_nmb*nvar;
   Kokkos::TeamPolicy<> policy(DevExeSpace(), nmv, Kokkos::AUTO);
@@ -1052,9 +1271,6 @@ void MeshRefinement::RefineCC(DualArray1D<int> &n2o, DvceArray5D<Real> &a,
     const int v = (tmember.league_rank() - m*nvar);
 
     if (refine_flag_.d_view(n2o.d_view(m+ngids_)) > 0) {
-      const int ni = cie - cis + 1;
-      const int nj = cje - cjs + 1;
-      const int nk = cke - cks + 1;
       const int nkji = nk*nj*ni;
       const int nji  = nj*ni;
 
@@ -1072,18 +1288,7 @@ void MeshRefinement::RefineCC(DualArray1D<int> &n2o, DvceArray5D<Real> &a,
         int fk = 2*k - cks;  // correct when cks=ks
 
         // call inlined prolongation operator for CC variables
-        if (!is_z4c) {
-          ProlongCC(m,v,k,j,i,fk,fj,fi,multi_d,three_d,ca,a);
-        } else {
-          switch (indcs.ng) {
-            case 2: HighOrderProlongCC<2>(m,v,k,j,i,fk,fj,fi,nx1,nx2,nx3,
-                                          ca,a,prolong_2nd);
-                    break;
-            case 4: HighOrderProlongCC<4>(m,v,k,j,i,fk,fj,fi,nx1,nx2,nx3,
-                                          ca,a,prolong_4th);
-                    break;
-          }
-        }
+        ProlongCC(m,v,k,j,i,fk,fj,fi,multi_d,three_d,ca,a);
       });
     }
   });
@@ -1112,39 +1317,24 @@ void MeshRefinement::RefineFC(DualArray1D<int> &n2o, DvceFaceFld4D<Real> &b,
   bool &three_d = pmy_mesh->three_d;
   auto &ngids_ = new_gids_eachrank[global_variable::my_rank];
 
-  // Prolongate x1f
-  par_for("RefineFC1",DevExeSpace(), 0,(new_nmb-1), cks,cke, cjs,cje, cis,cie+1,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    if (refine_flag_.d_view(n2o.d_view(m+ngids_)) > 0) {
-      // fine indices refer to target array
-      int fi = (i - cis)*2 + is;                   // fine i
-      int fj = (multi_d)? ((j - cjs)*2 + js) : j;  // fine j
-      int fk = (three_d)? ((k - cks)*2 + ks) : k;  // fine k
-      ProlongFCSharedX1Face(m,k,j,i,fk,fj,fi,multi_d,three_d,cb.x1f,b.x1f);
-    }
-  });
-
-  // Prolongate x2f
-  par_for("RefineFC2",DevExeSpace(), 0,(new_nmb-1), cks,cke, cjs,cje+1, cis,cie,
-  KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
-    if (refine_flag_.d_view(n2o.d_view(m+ngids_)) > 0) {
-      // fine indices refer to target array
-      int fi = (i - cis)*2 + is;                   // fine i
-      int fj = (multi_d)? ((j - cjs)*2 + js) : j;  // fine j
-      int fk = (three_d)? ((k - cks)*2 + ks) : k;  // fine k
-      ProlongFCSharedX2Face(m,k,j,i,fk,fj,fi,three_d,cb.x2f,b.x2f);
-    }
-  });
-
-  // Prolongate x3f
-  par_for("RefineFC3",DevExeSpace(), 0,(new_nmb-1), cks,cke+1, cjs,cje, cis,cie,
+  // Prolongate x1f, x2f, and x3f in one kernel, over range of largest index in each
+  // direction
+  par_for("RefineFC",DevExeSpace(), 0,(new_nmb-1), cks,cke+1, cjs,cje+1, cis,cie+1,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
     if (refine_flag_.d_view(n2o.d_view(m+ngids_)) > 0) {
       // fine indices refer to target array
       int fi = (i - cis)*2 + is;                   // fine i
       int fj = (multi_d)? ((j - cjs)*2 + js) : j;  // fine j
       int fk = (three_d)? ((k - cks)*2 + ks) : k;  // fine k
-      ProlongFCSharedX3Face(m,k,j,i,fk,fj,fi,multi_d,cb.x3f,b.x3f);
+      if (k <= cke && j <= cje) {
+        ProlongFCSharedX1Face(m,k,j,i,fk,fj,fi,multi_d,three_d,cb.x1f,b.x1f);
+      }
+      if (k <= cke && i <= cie) {
+        ProlongFCSharedX2Face(m,k,j,i,fk,fj,fi,three_d,cb.x2f,b.x2f);
+      }
+      if (j <= cje && i <= cie) {
+        ProlongFCSharedX3Face(m,k,j,i,fk,fj,fi,multi_d,cb.x3f,b.x3f);
+      }
     }
   });
 
@@ -1178,13 +1368,44 @@ void MeshRefinement::RefineFC(DualArray1D<int> &n2o, DvceFaceFld4D<Real> &b,
 
 void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
     bool is_z4c) {
+  auto &indcs = pmy_mesh->mb_indcs;
+  int box[6] = {indcs.cks, indcs.cke, indcs.cjs, indcs.cje, indcs.cis, indcs.cie};
+  RestrictCCRegion(u, cu, is_z4c, box);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::RestrictCCBndry
+//!  \brief Restricts cell-centered variables to coarse mesh only in the ng coarse cells
+//! adjacent to each MeshBlock boundary.  These are the only cells packed into buffers
+//! sent to coarser (and, for Z4c, same level) neighbors, or used by prolongation
+//! stencils, so this is all that is needed in the stage task lists.  Coarse cells in
+//! the interior (needed for derefinement) are restricted at regrid time instead.
+
+void MeshRefinement::RestrictCCBndry(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
+    bool is_z4c) {
+  int box[6][6];
+  int nbox = CoarseShellBoxes(pmy_mesh->mb_indcs.ng, box);
+  for (int n=0; n<nbox; ++n) {
+    RestrictCCRegion(u, cu, is_z4c, box[n]);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::RestrictCCRegion
+//!  \brief Restricts cell-centered variables to coarse cells in box=(kl,ku,jl,ju,il,iu)
+
+void MeshRefinement::RestrictCCRegion(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
+    bool is_z4c, const int box[6]) {
   int nmb  = u.extent_int(0);  // TODO(@user): 1st index from L of in array must be NMB
   int nvar = u.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
 
   auto &indcs = pmy_mesh->mb_indcs;
-  auto &cis = indcs.cis, &cie = indcs.cie;
-  auto &cjs = indcs.cjs, &cje = indcs.cje;
-  auto &cks = indcs.cks, &cke = indcs.cke;
+  auto &cis = indcs.cis;
+  auto &cjs = indcs.cjs;
+  auto &cks = indcs.cks;
+  int kl = box[0], ku = box[1], jl = box[2], ju = box[3], il = box[4], iu = box[5];
   auto &nx1 = indcs.nx1;
   auto &nx2 = indcs.nx2;
   auto &nx3 = indcs.nx3;
@@ -1193,14 +1414,14 @@ void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
   auto& restrict_4th_edge = weights.restrict_4th_edge;
   // restrict in 1D
   if (pmy_mesh->one_d) {
-    par_for("restrictCC-1D",DevExeSpace(), 0,nmb-1, 0,nvar-1, cis,cie,
+    par_for("restrictCC-1D",DevExeSpace(), 0,nmb-1, 0,nvar-1, il,iu,
     KOKKOS_LAMBDA(const int m, const int n, const int i) {
       int finei = 2*i - cis;  // correct when cis=is
       cu(m,n,cks,cjs,i) = 0.5*(u(m,n,cks,cjs,finei) + u(m,n,cks,cjs,finei+1));
     });
   // restrict in 2D
   } else if (pmy_mesh->two_d) {
-    par_for("restrictCC-2D",DevExeSpace(), 0,nmb-1, 0,nvar-1, cjs,cje, cis,cie,
+    par_for("restrictCC-2D",DevExeSpace(), 0,nmb-1, 0,nvar-1, jl,ju, il,iu,
     KOKKOS_LAMBDA(const int m, const int n, const int j, const int i) {
       int finei = 2*i - cis;  // correct when cis=is
       int finej = 2*j - cjs;  // correct when cjs=js
@@ -1210,7 +1431,7 @@ void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
 
   // restrict in 3D
   } else {
-    par_for("restrictCC-3D",DevExeSpace(), 0,nmb-1, 0,nvar-1, cks,cke, cjs,cje, cis,cie,
+    par_for("restrictCC-3D",DevExeSpace(), 0,nmb-1, 0,nvar-1, kl,ku, jl,ju, il,iu,
     KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
       int finei = 2*i - cis;  // correct when cis=is
       int finej = 2*j - cjs;  // correct when cjs=js
@@ -1241,6 +1462,34 @@ void MeshRefinement::RestrictCC(DvceArray5D<Real> &u, DvceArray5D<Real> &cu,
 //! \brief Restricts face-centered variables to coarse mesh
 
 void MeshRefinement::RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb) {
+  auto &indcs = pmy_mesh->mb_indcs;
+  int box[6] = {indcs.cks, indcs.cke, indcs.cjs, indcs.cje, indcs.cis, indcs.cie};
+  RestrictFCRegion(b, cb, box);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::RestrictFCBndry
+//! \brief Restricts face-centered variables to coarse mesh only near MeshBlock
+//! boundaries (see RestrictCCBndry()).  One extra layer of cells is needed, since buffers
+//! sent to coarser neighbors include the face ng coarse cells from the boundary.
+
+void MeshRefinement::RestrictFCBndry(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb) {
+  int box[6][6];
+  int nbox = CoarseShellBoxes(pmy_mesh->mb_indcs.ng + 1, box);
+  for (int n=0; n<nbox; ++n) {
+    RestrictFCRegion(b, cb, box[n]);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshRefinement::RestrictFCRegion
+//! \brief Restricts face-centered variables on the faces of coarse cells in
+//! box=(kl,ku,jl,ju,il,iu), including the outer faces of the coarse active region.
+
+void MeshRefinement::RestrictFCRegion(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb,
+                                      const int box[6]) {
   int nmb  = b.x1f.extent_int(0);  // TODO(@user): 1st idx from L of in array must be NMB
 
   auto &cis = pmy_mesh->mb_indcs.cis;
@@ -1249,10 +1498,11 @@ void MeshRefinement::RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb)
   auto &cje = pmy_mesh->mb_indcs.cje;
   auto &cks = pmy_mesh->mb_indcs.cks;
   auto &cke = pmy_mesh->mb_indcs.cke;
+  int kl = box[0], ku = box[1], jl = box[2], ju = box[3], il = box[4], iu = box[5];
 
   // restrict in 1D
   if (pmy_mesh->one_d) {
-    par_for("restrictFC-1D",DevExeSpace(), 0,nmb-1, cis,cie,
+    par_for("restrictFC-1D",DevExeSpace(), 0,nmb-1, il,iu,
     KOKKOS_LAMBDA(const int m, const int i) {
       int finei = 2*i - cis;  // correct when cis=is
       // restrict B1
@@ -1272,7 +1522,7 @@ void MeshRefinement::RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb)
 
   // restrict in 2D
   } else if (pmy_mesh->two_d) {
-    par_for("restrictFC-2D",DevExeSpace(), 0,nmb-1, cjs,cje, cis,cie,
+    par_for("restrictFC-2D",DevExeSpace(), 0,nmb-1, jl,ju, il,iu,
     KOKKOS_LAMBDA(const int m, const int j, const int i) {
       int finei = 2*i - cis;  // correct when cis=is
       int finej = 2*j - cjs;  // correct when cjs=js
@@ -1297,7 +1547,7 @@ void MeshRefinement::RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb)
 
   // restrict in 3D
   } else {
-    par_for("restrictFC-3D",DevExeSpace(), 0,nmb-1, cks,cke, cjs,cje, cis,cie,
+    par_for("restrictFC-3D",DevExeSpace(), 0,nmb-1, kl,ku, jl,ju, il,iu,
     KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
       int finei = 2*i - cis;  // correct when cis=is
       int finej = 2*j - cjs;  // correct when cjs=js
@@ -1334,6 +1584,46 @@ void MeshRefinement::RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb)
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn int MeshRefinement::CoarseShellBoxes
+//! \brief Fills up to six boxes (kl,ku,jl,ju,il,iu) which together cover the coarse
+//! active cells within depth cells of the MeshBlock boundaries, and returns the number
+//! of boxes.  If the interior is empty, the whole coarse active region is one box.
+
+int MeshRefinement::CoarseShellBoxes(const int depth, int box[6][6]) {
+  auto &indcs = pmy_mesh->mb_indcs;
+  const bool &multi_d = pmy_mesh->multi_d;
+  const bool &three_d = pmy_mesh->three_d;
+  int kl = indcs.cks, ku = indcs.cke, jl = indcs.cjs, ju = indcs.cje;
+  int il = indcs.cis, iu = indcs.cie;
+  auto set_box = [&](int n, int k0, int k1, int j0, int j1, int i0, int i1) {
+    box[n][0] = k0; box[n][1] = k1; box[n][2] = j0; box[n][3] = j1;
+    box[n][4] = i0; box[n][5] = i1;
+  };
+  if ((indcs.cnx1 <= 2*depth) || (multi_d && indcs.cnx2 <= 2*depth) ||
+      (three_d && indcs.cnx3 <= 2*depth)) {
+    set_box(0, kl, ku, jl, ju, il, iu);
+    return 1;
+  }
+  int nbox = 0;
+  // x3-faces (full x1-x2 planes), then x2-faces and x1-faces of the remaining cells
+  if (three_d) {
+    set_box(nbox++, kl, kl+depth-1, jl, ju, il, iu);
+    set_box(nbox++, ku-depth+1, ku, jl, ju, il, iu);
+    kl += depth;
+    ku -= depth;
+  }
+  if (multi_d) {
+    set_box(nbox++, kl, ku, jl, jl+depth-1, il, iu);
+    set_box(nbox++, kl, ku, ju-depth+1, ju, il, iu);
+    jl += depth;
+    ju -= depth;
+  }
+  set_box(nbox++, kl, ku, jl, ju, il, il+depth-1);
+  set_box(nbox++, kl, ku, jl, ju, iu-depth+1, iu);
+  return nbox;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void MeshRefinement::InitInterpWghts()
 //! \brief interpolation weights for prolongation and restriction
@@ -8,14 +8,19 @@
 //! \file mesh_refinement.hpp
 //! \brief defines MeshRefinement class containing data and functions controlling SMR/AMR
 
+#include <vector>
+
+#include "globals.hpp"
+
 //----------------------------------------------------------------------------------------
 //! \fn int CreateAMR_MPI_Tag(int lid, int ox1, int ox2, int ox3)
 //! \brief calculate an MPI tag for AMR communications.  Note maximum size of
-//! lid that can be encoded is set by (NUM_BITS_LID) macro.
+//! lid that can be encoded is 2^(global_variable::nbits_lid), set from MPI_TAG_UB.
 //! The convention in Athena++ is lid is for the *receiving* process.
 //! The MPI standard requires signed int tag, with MPI_TAG_UB>=2^15-1 = 32,767 (inclusive)
 static int CreateAMR_MPI_Tag(int lid, int ox1, int ox2, int ox3) {
-  return (ox1<<(NUM_BITS_LID+2)) | (ox2<<(NUM_BITS_LID+1))| (ox3<<(NUM_BITS_LID)) | lid;
+  const int nb = global_variable::nbits_lid;
+  return (ox1<<(nb+2)) | (ox2<<(nb+1))| (ox3<<(nb)) | lid;
 }
 
 //----------------------------------------------------------------------------------------
@@ -30,10 +35,47 @@ struct AMRBuffer {
   int cnt;                   // total number of elements stored in buffer incl all vars
   int offset=0;              // starting index of data for this buffer
   int lid;                   // local ID (gid - gids) of MeshBlock on this rank
+  int rank;                  // rank of MeshBlock data is sent to/received from
   bool use_coarse=false;     // pack/unpack from coarse array when true
 };
 #endif
 
+//----------------------------------------------------------------------------------------
+//! \enum RefineCriterion
+//! \brief estimators that can be used as refinement criteria with AMR.  Gradients and
+//! derivatives are undivided differences, so thresholds are independent of resolution.
+//!   max_value: maximum of variable
+//!   gradient:  magnitude of gradient of variable, divided by variable
+//!   lohner:    Lohner (1987) normalized second derivative of variable
+//!   vorticity: magnitude of curl of fluid velocity
+//!   current:   magnitude of curl of cell-centered magnetic field, divided by |B|
+
+enum class RefineCriterion {max_value, gradient, lohner, vorticity, current};
+
+//----------------------------------------------------------------------------------------
+//! \struct RefinementCriterion
+//! \brief one entry in the list of criteria evaluated by CheckForRefinement().  A MB is
+//! flagged for refinement if any criterion exceeds refine_thresh somewhere in the MB, and
+//! for derefinement only if every criterion is below deref_thresh everywhere in the MB.
+
+struct RefinementCriterion {
+  RefineCriterion type;
+  int var;              // index of variable (ignored for vorticity and current)
+  bool prim;            // evaluate using primitive (w0) rather than conserved (u0) vars
+  Real refine_thresh;
+  Real deref_thresh;
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct RegridCopy
+//! \brief source and target index in View of one MB copied within a rank when the mesh is
+//! regridded, index in temporary array (or -1), and octant of MB in its parent.
+
+struct RegridCopy {
+  int msrc, mdst, mtmp;
+  int ox1, ox2, ox3;
+};
+
 //----------------------------------------------------------------------------------------
 //! \class MeshRefinement
 //! \brief data/functions associated with SMR/AMR
@@ -50,6 +92,8 @@ class MeshRefinement {
   int ncyc_check_amr;        // # of cycles between checking mesh for ref/derefinement
   int refinement_interval;   // # of cycles between allowing successive ref/derefinement
   bool prolong_prims;        // flag to enable prolongation of primitive vars
+  bool refine_buffer;        // also refine neighbors of MBs flagged for refinement
+  bool aggregate_mpi;        // send one message per rank pair during load balancing
 
   // following 2x Views are dimensioned [nmb_total]
   DualArray1D<int> refine_flag;    // refinement flag for each MeshBlock
@@ -93,10 +137,14 @@ class MeshRefinement {
 #endif
 
   // functions
+  void AddRefinementCriterion(RefineCriterion type, int var, bool prim,
+                              Real refine_thresh, Real deref_thresh);
   void CheckForRefinement(MeshBlockPack* pmbp);
   void AdaptiveMeshRefinement(Driver *pdrive, ParameterInput *pin);
   void UpdateMeshBlockTree(int &nnew, int &ndel);
-  void RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, int ndel);
+  void RedistAndRefineMeshBlocks(ParameterInput *pin, int nnew, int ndel,
+                                 bool incremental=false);
+  void IncrementalRebalance(Driver *pdrive, ParameterInput *pin);
 
   void DerefineCCSameRank(DvceArray5D<Real> &a, DvceArray5D<Real> &ca);
   void DerefineFCSameRank(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
@@ -113,6 +161,9 @@ class MeshRefinement {
 
   void RestrictCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca, bool is_z4c=false);
   void RestrictFC(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
+  // restriction only in coarse cells near MB boundaries, used in stage task lists
+  void RestrictCCBndry(DvceArray5D<Real> &a, DvceArray5D<Real> &ca, bool is_z4c=false);
+  void RestrictFCBndry(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb);
   void HighOrderRestrictCC(DvceArray5D<Real> &a, DvceArray5D<Real> &ca);
 
   // functions for load balancing (in file load_balance.cpp)
@@ -131,7 +182,19 @@ class MeshRefinement {
  private:
   // data
   Mesh *pmy_mesh;
-  Real d_threshold_, dd_threshold_, dp_threshold_, dv_threshold_, chi_threshold_;
-  bool check_cons_;
+  Real chi_threshold_;
+  std::vector<RefinementCriterion> criteria_;   // refinement criteria on host
+  DualArray1D<RefinementCriterion> dcriteria_;  // copy of criteria accessible on device
+  // MBs copied within this rank during regrid, see SetRegridCopies()
+  DualArray1D<RegridCopy> deref_copies_, move_copies_, refine_copies_;
+  int nmove_tmp_ = 0;   // number of moved MBs that are first copied to temporary array
+
+  // functions
+  void SetRegridCopies(int nleaf);
+  void RestrictCCRegion(DvceArray5D<Real> &a, DvceArray5D<Real> &ca, bool is_z4c,
+                        const int box[6]);
+  void RestrictFCRegion(DvceFaceFld4D<Real> &b, DvceFaceFld4D<Real> &cb,
+                        const int box[6]);
+  int CoarseShellBoxes(const int depth, int box[6][6]);
 };
 #endif // MESH_MESH_REFINEMENT_HPP_
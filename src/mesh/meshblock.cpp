@@ -6,6 +6,7 @@
 //! \file meshblock.cpp
 //  \brief implementation of constructor and functions in MeshBlock class
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
@@ -22,15 +23,37 @@
 // Initializes mb_gid, mb_lev, mb_size, mb_bcs arrays.  The nghbrs array is initialized
 // by SetNeighbors function called by BuildTree***() functions.
 
-MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
+MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb, bool by_level) :
   pmy_pack(ppack),
   mb_gid("mb_gid",nmb),
   mb_lev("mb_lev",nmb),
   mb_size("mbsize",nmb),
-  mb_bcs("mbbcs",nmb,6) {
+  mb_bcs("mbbcs",nmb,6),
+  mb_active("mbactive",nmb),
+  order_by_level(by_level) {
+  SetMeshBlocks(igids, nmb);
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn void MeshBlock::SetMeshBlocks()
+// \brief sets mb_gid, mb_lev, mb_size, mb_bcs arrays for the nmb MeshBlocks starting at
+// gid=igids.  Called by constructor, and after each regrid with AMR so the same object
+// (and device storage) is reused.  Arrays only grow, and are then sized to hold the
+// maximum number of MBs per rank so that subsequent regrids never reallocate them.
+
+void MeshBlock::SetMeshBlocks(int igids, int nmb) {
   Mesh* pm = pmy_pack->pmesh;
   auto &ms = pm->mesh_size;
 
+  if (mb_gid.extent_int(0) < nmb) {
+    int nmb_alloc = std::max(nmb, pm->nmb_maxperrank);
+    Kokkos::realloc(mb_gid, nmb_alloc);
+    Kokkos::realloc(mb_lev, nmb_alloc);
+    Kokkos::realloc(mb_size, nmb_alloc);
+    Kokkos::realloc(mb_bcs, nmb_alloc, 6);
+    Kokkos::realloc(mb_active, nmb_alloc);
+  }
+
   for (int m=0; m<nmb; ++m) {
     // initialize host array elements of gids, levels
     mb_gid.h_view(m) = igids + m;
@@ -131,6 +154,52 @@ MeshBlock::MeshBlock(MeshBlockPack* ppack, int igids, int nmb) :
   mb_lev.template sync<DevExeSpace>();
   mb_size.template sync<DevExeSpace>();
   mb_bcs.template sync<DevExeSpace>();
+
+  // all MBs are active until marked otherwise (e.g. when fully excised)
+  for (int m=0; m<nmb; ++m) {mb_active.h_view(m) = m;}
+  nmb_active = nmb;
+  SortActiveByLevel();
+  mb_active.template modify<HostMemSpace>();
+  mb_active.template sync<DevExeSpace>();
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn void MeshBlock::SetActiveMeshBlocks()
+// \brief builds compacted list of MBs for which active(m) is true.  Kernels in physics
+// modules that support inactive MBs loop over this list rather than all MBs in the pack,
+// so that data in inactive MBs (including their ghost zones) is left unchanged.
+
+void MeshBlock::SetActiveMeshBlocks(const HostArray1D<bool> &active) {
+  int nmb = pmy_pack->nmb_thispack;
+  nmb_active = 0;
+  for (int m=0; m<nmb; ++m) {
+    if (active(m)) {mb_active.h_view(nmb_active++) = m;}
+  }
+  SortActiveByLevel();
+  mb_active.template modify<HostMemSpace>();
+  mb_active.template sync<DevExeSpace>();
+}
+
+//----------------------------------------------------------------------------------------
+// \!fn void MeshBlock::SortActiveByLevel()
+// \brief with order_by_level, stable sorts host array of mb_active by level (so MBs on
+// each level stay in gid order) and sets offsets level_mbs of each physical level.  The
+// MBs themselves (and so gids_eachrank and all data arrays) keep their Morton order.
+
+void MeshBlock::SortActiveByLevel() {
+  if (!(order_by_level)) {return;}
+  Mesh* pm = pmy_pack->pmesh;
+  int nlev = pm->max_level - pm->root_level + 1;
+  auto first = mb_active.h_view.data();
+  auto &lev = mb_lev.h_view;
+  std::stable_sort(first, first + nmb_active, [&lev](const int a, const int b) {
+    return (lev(a) < lev(b));
+  });
+  level_mbs.assign(nlev + 1, 0);
+  for (int n=0; n<nmb_active; ++n) {
+    level_mbs[lev(mb_active.h_view(n)) - pm->root_level + 1]++;
+  }
+  for (int l=0; l<nlev; ++l) {level_mbs[l+1] += level_mbs[l];}
 }
 
 //----------------------------------------------------------------------------------------
@@ -149,13 +218,15 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
   if (pmy_pack->pmesh->two_d) {nnghbr = 24;}
   if (pmy_pack->pmesh->three_d) {nnghbr = 56;}
 
-  // allocate size of DualArrays
+  // allocate size of DualArrays (only grows, so regrids with AMR reuse storage)
   int nmb = pmy_pack->nmb_thispack;
-  Kokkos::realloc(nghbr, nmb, nnghbr);
+  if ((nghbr.extent_int(0) < nmb) || (nghbr.extent_int(1) != nnghbr)) {
+    Kokkos::realloc(nghbr, std::max(nmb, mb_gid.extent_int(0)), nnghbr);
+  }
 
   // Initialize host view elements of DualViews
-  for (int n=0; n<nnghbr; ++n) {
-    for (int m=0; m<nmb; ++m) {
+  for (int m=0; m<nmb; ++m) {
+    for (int n=0; n<nnghbr; ++n) {
       nghbr.h_view(m,n).gid   = -1;
       nghbr.h_view(m,n).lev   = -1;
       nghbr.h_view(m,n).rank  = -1;
@@ -171,8 +242,11 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
     if (pmy_pack->pmesh->three_d) nfz = 2;
   }
 
-  // Search MeshBlock tree and find neighbors
-  for (int b=0; b<nmb; ++b) {
+  // Search MeshBlock tree and find neighbors.  The tree is only read, and each MB writes
+  // only its own row of nghbr, so MBs are processed in parallel on the host.
+  Kokkos::parallel_for("SetNeighbors",
+  Kokkos::RangePolicy<>(Kokkos::DefaultHostExecutionSpace(), 0, nmb),
+  [&](const int b) {
     LogicalLocation lloc = pmy_pack->pmesh->lloc_eachmb[mb_gid.h_view(b)];
 
     // find location of this MeshBlock relative to XXXX
@@ -423,7 +497,7 @@ void MeshBlock::SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklis
         }
       }
     }  // end loop over three_d
-  }    // end loop over all MeshBlocks
+  });  // end loop over all MeshBlocks
 
   // For each DualArray: mark host views as modified, and then sync to device array
   nghbr.template modify<HostMemSpace>();
@@ -13,6 +13,7 @@
 //! containers called MashBlockPack.
 
 #include <memory>
+#include <vector>
 
 #include "bvals/bvals.hpp"
 #include "meshblock_pack.hpp"
@@ -28,7 +29,7 @@ class MeshBlock {
   friend class MeshBlockTree;
 
  public:
-  MeshBlock(MeshBlockPack *ppack, int igids, int nmb);
+  MeshBlock(MeshBlockPack *ppack, int igids, int nmb, bool by_level=false);
   ~MeshBlock() {}  // only default destructor needed
 
   // data
@@ -41,12 +42,26 @@ class MeshBlock {
   DualArray1D<RegionSize> mb_size;   // physical size of each MeshBlock
   DualArray2D<BoundaryFlag> mb_bcs;  // boundary conditions at 6 faces of each MeshBlock
   DualArray2D<NeighborBlock> nghbr;  // data on all (up to 56) neighbors for each MB
+  DualArray1D<int> mb_active;        // compacted list of indices of active MBs
+  int nmb_active;                    // number of active MBs (entries in mb_active)
 
-  // function to set data describing neighbors
+  // With <mesh>/pack_by_level=true, mb_active is sorted by (level, gid) and the active
+  // MBs on physical level l (=level-root_level) are entries [level_mbs[l],level_mbs[l+1])
+  // of mb_active, so kernels can be launched over a single level.  Otherwise level_mbs
+  // is empty and mb_active is in gid (Morton) order.
+  bool order_by_level;
+  std::vector<int> level_mbs;
+
+  // functions to set data describing MeshBlocks and their neighbors
+  void SetMeshBlocks(int igids, int nmb);
+  void SetActiveMeshBlocks(const HostArray1D<bool> &active);
   void SetNeighbors(std::unique_ptr<MeshBlockTree> &ptree, int *ranklist);
 
  private:
   // data
   MeshBlockPack* pmy_pack;
+
+  // functions
+  void SortActiveByLevel();
 };
 #endif // MESH_MESHBLOCK_HPP_
@@ -29,6 +29,7 @@
 #include "srcterms/turb_driver.hpp"
 #include "particles/particles.hpp"
 #include "units/units.hpp"
+#include "utils/memory_registry.hpp"
 #include "meshblock_pack.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -45,6 +46,10 @@ MeshBlockPack::MeshBlockPack(Mesh *pm, int igids, int igide) :
   tl_map.insert(std::make_pair("before_stagen",std::make_shared<TaskList>()));
   tl_map.insert(std::make_pair("stagen",std::make_shared<TaskList>()));
   tl_map.insert(std::make_pair("after_stagen",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("before_sts",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("sts",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("after_sts",std::make_shared<TaskList>()));
+  tl_map.insert(std::make_pair("static",std::make_shared<TaskList>()));
 }
 
 //----------------------------------------------------------------------------------------
@@ -73,7 +78,8 @@ MeshBlockPack::~MeshBlockPack() {
 //! Allows for passing of pointer to 'this' pack.
 
 void MeshBlockPack::AddMeshBlocks(ParameterInput *pin) {
-  pmb = new MeshBlock(this, gids, nmb_thispack);
+  bool by_level = pin->GetOrAddBoolean("mesh", "pack_by_level", false);
+  pmb = new MeshBlock(this, gids, nmb_thispack, by_level);
 }
 
 //----------------------------------------------------------------------------------------
@@ -83,6 +89,7 @@ void MeshBlockPack::AddMeshBlocks(ParameterInput *pin) {
 //! function, since latter uses data inside Coordinates class.
 
 void MeshBlockPack::AddCoordinates(ParameterInput *pin) {
+  memory_registry::Scope mem_scope("coordinates");
   pcoord = new Coordinates(pin, this);
 }
 
@@ -107,6 +114,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // Create Hydro physics module.  Create TaskLists only for single-fluid hydro
   // (Note TaskLists stored in MeshBlockPack)
   if (pin->DoesBlockExist("hydro")) {
+    memory_registry::Scope mem_scope("hydro");
     phydro = new hydro::Hydro(this, pin);
     nphysics++;
     if (!(pin->DoesBlockExist("mhd")) && !(pin->DoesBlockExist("radiation")) &&
@@ -120,6 +128,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (3) MHD
   // Create MHD physics module.  Create TaskLists only for single-fluid MHD
   if (pin->DoesBlockExist("mhd")) {
+    memory_registry::Scope mem_scope("mhd");
     pmhd = new mhd::MHD(this, pin);
     nphysics++;
     if (!(pin->DoesBlockExist("hydro")) && !(pin->DoesBlockExist("radiation")) &&
@@ -134,6 +143,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // Create Ion-Neutral physics module and TaskLists. Error if <hydro> and <mhd> are not
   // both defined as well.
   if (pin->DoesBlockExist("ion-neutral")) {
+    memory_registry::Scope mem_scope("ion-neutral");
     pionn = new ion_neutral::IonNeutral(this, pin);   // construct new MHD object
     if (pin->DoesBlockExist("hydro") && pin->DoesBlockExist("mhd") &&
         !(pin->DoesBlockExist("adm")) && !(pin->DoesBlockExist("z4c")) ) {
@@ -159,6 +169,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (5) RADIATION
   // Create radiation physics module.  Create tasklist.
   if (pin->DoesBlockExist("radiation")) {
+    memory_registry::Scope mem_scope("radiation");
     prad = new radiation::Radiation(this, pin);
     nphysics++;
     prad->AssembleRadTasks(tl_map);
@@ -173,6 +184,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // force and adding force to fluid are included in operator_split and stage_run
   // task lists respectively.
   if (pin->DoesBlockExist("turb_driving")) {
+    memory_registry::Scope mem_scope("turb_driving");
     pturb = new TurbulenceDriver(this, pin);
     pturb->IncludeInitializeModesTask(tl_map["before_timeintegrator"], none);
     pturb->IncludeAddForcingTask(tl_map["stagen"], none);
@@ -183,6 +195,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (7) Z4c and ADM
   // Create Z4c and ADM physics module.
   if (pin->DoesBlockExist("z4c")) {
+    memory_registry::Scope mem_scope("z4c");
     pz4c = new z4c::Z4c(this, pin);
     padm = new adm::ADM(this, pin);
     ptmunu = nullptr;
@@ -190,6 +203,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   } else {
     pz4c = nullptr;
     if (pin->DoesBlockExist("adm")) {
+      memory_registry::Scope mem_scope("adm");
       padm = new adm::ADM(this, pin);
     } else {
       padm = nullptr;
@@ -205,11 +219,13 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   }
   if ((pin->DoesBlockExist("z4c") || pin->DoesBlockExist("adm")) &&
       (pin->DoesBlockExist("mhd")) ) {
+    memory_registry::Scope mem_scope("dyn_grmhd");
     pdyngr = dyngr::BuildDynGRMHD(this, pin);
     ptmunu = new Tmunu(this, pin);
   }
 
   if (pz4c != nullptr || padm != nullptr) {
+    memory_registry::Scope mem_scope("numrel");
     pnr = new numrel::NumericalRelativity(this, pin);
     pnr->AssembleNumericalRelativityTasks(tl_map);
   }
@@ -217,6 +233,7 @@ void MeshBlockPack::AddPhysics(ParameterInput *pin) {
   // (8) PARTICLES
   // Create particles module.  Create tasklist.
   if (pin->DoesBlockExist("particles")) {
+    memory_registry::Scope mem_scope("particles");
     ppart = new particles::Particles(this, pin);
     ppart->AssembleTasks(tl_map);
     nphysics++;
@@ -17,6 +17,7 @@
 #include "coordinates/coordinates.hpp"
 #include "driver/driver.hpp"
 #include "tasklist/task_list.hpp"
+#include "utils/scratch_arena.hpp"
 
 // Forward declarations
 class MeshBlock;
@@ -76,6 +77,9 @@ class MeshBlockPack {
   // units (needed to convert code units to cgs for, e.g., cooling or radiation)
   units::Units *punit=nullptr;
 
+  // device memory for temporary arrays used within a single task (see scratch_arena.hpp)
+  ScratchArena scratch;
+
   // map for task lists which operate over all MeshBlocks in this MeshBlockPack
   std::map<std::string, std::shared_ptr<TaskList>> tl_map;
 
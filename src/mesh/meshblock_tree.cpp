@@ -6,10 +6,13 @@
 //! \file meshblock_tree.cpp
 //  \brief implementation of constructor and functions in the MeshBlockTree class
 
+#include <algorithm> // min, stable_sort
 #include <cstdint>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <utility>   // pair
+#include <vector>
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
@@ -254,6 +257,10 @@ void MeshBlockTree::Refine(int &nnew) {
 //! \brief destroy leaves and make this block a leaf
 
 void MeshBlockTree::Derefine(int &ndel) {
+  // cannot derefine if any leaf has been refined (e.g. as part of a refinement buffer)
+  for (int n=0; n<nleaf_; n++) {
+    if (pleaf_[n] == nullptr || pleaf_[n]->pleaf_ != nullptr) return;
+  }
   int s2=0, e2=0, s3=0, e3=0;
   if (pmesh_->multi_d) s2=-1, e2=1;
   if (pmesh_->three_d) s3=-1, e3=1;
@@ -295,7 +302,11 @@ void MeshBlockTree::Derefine(int &ndel) {
     }
   }
 
-  gid_ = pleaf_[0]->gid_; // now this is a leaf; inherit the first leaf's GID
+  // now this is a leaf; inherit the lowest GID of the leaves.  Leaves are consecutive
+  // along the space-filling curve, but with Hilbert ordering leaf 0 need not be first,
+  // and mesh_refinement.cpp assumes the derefined MB has the first leaf's old GID.
+  gid_ = pleaf_[0]->gid_;
+  for (int n=1; n<nleaf_; n++) {gid_ = std::min(gid_, pleaf_[n]->gid_);}
   for (int n=0; n<nleaf_; n++) {
     delete pleaf_[n];
   }
@@ -349,6 +360,129 @@ void MeshBlockTree::CreateZOrderedLLList(LogicalLocation *list, int *pglist, int
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::CollectLeaves(std::vector<MeshBlockTree*> &leaves)
+//! \brief Appends pointers to all leaf nodes below this node to input vector, in
+//! Z-order.
+
+void MeshBlockTree::CollectLeaves(std::vector<MeshBlockTree*> &leaves) {
+  if (pleaf_ == nullptr) {
+    leaves.push_back(this);
+  } else {
+    for (int n=0; n<nleaf_; n++) {
+      if (pleaf_[n] != nullptr) {pleaf_[n]->CollectLeaves(leaves);}
+    }
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn HilbertKey()
+//! \brief Returns position along Hilbert curve of point with integer coordinates x[]
+//! in ndim dimensions, each with nbits bits.  Uses the algorithm of J. Skilling (2004,
+//! AIP Conf. Proc. 707, 381) to transform the coordinates into the "transpose" of the
+//! Hilbert index, whose bits are then interleaved into a single 64-bit key.
+
+namespace {
+std::uint64_t HilbertKey(std::uint32_t x[3], int ndim, int nbits) {
+  std::uint32_t m = 1U << (nbits-1);
+  // inverse undo excess work
+  for (std::uint32_t q=m; q>1; q>>=1) {
+    std::uint32_t p = q - 1;
+    for (int i=0; i<ndim; ++i) {
+      if (x[i] & q) {
+        x[0] ^= p;                                 // invert
+      } else {
+        std::uint32_t t = (x[0] ^ x[i]) & p;       // exchange
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  // Gray encode
+  for (int i=1; i<ndim; ++i) {x[i] ^= x[i-1];}
+  std::uint32_t t = 0;
+  for (std::uint32_t q=m; q>1; q>>=1) {
+    if (x[ndim-1] & q) {t ^= q - 1;}
+  }
+  for (int i=0; i<ndim; ++i) {x[i] ^= t;}
+
+  // interleave bits of transpose into key, most significant bits first
+  std::uint64_t key = 0;
+  for (int b=nbits-1; b>=0; --b) {
+    for (int i=0; i<ndim; ++i) {
+      key = (key << 1) | static_cast<std::uint64_t>((x[i] >> b) & 1U);
+    }
+  }
+  return key;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::CreateHilbertOrderedLLList(LogicalLocation *list,
+//!                                                    int *pglist, int& count)
+//! \brief Same as CreateZOrderedLLList(), except MBs are sorted along a Hilbert curve.
+//! Each MB is assigned the Hilbert key of its lower corner on the finest level in the
+//! tree. Since every node of the tree spans a contiguous interval of the curve, children
+//! of every node remain consecutive in the list (as required for AMR), while consecutive
+//! MBs are always face neighbors on same level. Must be called from root of tree.
+
+void MeshBlockTree::CreateHilbertOrderedLLList(LogicalLocation *list, int *pglist,
+                                               int& count) {
+  std::vector<MeshBlockTree*> leaves;
+  CollectLeaves(leaves);
+
+  int ndim = 1;
+  if (pmesh_->two_d) {ndim = 2;}
+  if (pmesh_->three_d) {ndim = 3;}
+  int maxlev = 0;
+  for (auto &leaf : leaves) {maxlev = std::max(maxlev, leaf->lloc_.level);}
+  int nbits = std::max(maxlev, 1);
+
+  // Hilbert and Morton curves are identical in 1D, and keys must fit in 64 bits
+  if (ndim == 1 || ndim*nbits > 64) {
+    CreateZOrderedLLList(list, pglist, count);
+    return;
+  }
+
+  std::vector<std::pair<std::uint64_t, MeshBlockTree*>> keys;
+  keys.reserve(leaves.size());
+  for (auto &leaf : leaves) {
+    int shift = nbits - leaf->lloc_.level;
+    std::uint32_t x[3];
+    x[0] = static_cast<std::uint32_t>(leaf->lloc_.lx1) << shift;
+    x[1] = static_cast<std::uint32_t>(leaf->lloc_.lx2) << shift;
+    x[2] = static_cast<std::uint32_t>(leaf->lloc_.lx3) << shift;
+    keys.push_back(std::make_pair(HilbertKey(x, ndim, nbits), leaf));
+  }
+  std::stable_sort(keys.begin(), keys.end(),
+    [](const std::pair<std::uint64_t, MeshBlockTree*> &a,
+       const std::pair<std::uint64_t, MeshBlockTree*> &b) {return a.first < b.first;});
+
+  count = 0;
+  for (auto &k : keys) {
+    list[count] = k.second->lloc_;
+    if (pglist != nullptr) {pglist[count] = k.second->gid_;}
+    k.second->gid_ = count;
+    count++;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBlockTree::CreateOrderedLLList(LogicalLocation *list, int *pg, int& cnt)
+//! \brief Creates the Location list for tree sorted along space-filling curve selected
+//! by <load_balancing>/ordering in input file.  Should be called from root of tree.
+
+void MeshBlockTree::CreateOrderedLLList(LogicalLocation *list, int *pglist, int& count) {
+  if (pmesh_->block_ordering == BlockOrdering::hilbert) {
+    CreateHilbertOrderedLLList(list, pglist, count);
+  } else {
+    CreateZOrderedLLList(list, pglist, count);
+  }
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn MeshBlockTree* MeshBlockTree::FindNeighbor(LogicalLocation myloc,
 //!                                   int ox1, int ox2, int ox3, bool amrflag)
@@ -15,6 +15,8 @@
 //
 // Original version of this foundational class written c2015-2016 by K. Tomida.
 
+#include <vector>
+
 //--------------------------------------------------------------------------------------
 //! \class MeshBlockTree
 //  \brief Objects are nodes in a binary tree structure.  Thus, the class name does not
@@ -46,10 +48,14 @@ class MeshBlockTree {
   MeshBlockTree* FindMeshBlock(LogicalLocation tloc);
   void CountMeshBlocks(int& count);
   void CreateZOrderedLLList(LogicalLocation *list, int *pglist, int& count);
+  void CreateHilbertOrderedLLList(LogicalLocation *list, int *pglist, int& count);
+  void CreateOrderedLLList(LogicalLocation *list, int *pglist, int& count);
   MeshBlockTree* FindNeighbor(LogicalLocation myloc, int ox1, int ox2, int ox3,
                               bool amrflag=false);
 
  private:
+  void CollectLeaves(std::vector<MeshBlockTree*> &leaves);
+
   // data: note private variable names have trailing underscore for this class
   MeshBlockTree **pleaf_;  // 1D vector of pointers to leafs
   int gid_;                // grid ID
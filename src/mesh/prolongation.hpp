@@ -284,5 +284,66 @@ void HighOrderProlongCC(const int m, const int v, const int k, const int j, cons
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \struct ProlongWeights
+//! \brief Fixed-size copy of the Lagrange prolongation weights of InitInterpWghts().
+//! Captured by value in kernels, so on GPUs the weights are passed as kernel arguments
+//! and read from constant memory rather than loaded from a global View.
+
+template <int NGHOST>
+struct ProlongWeights {
+  Real w[NGHOST+1][NGHOST+1][NGHOST+1];
+  explicit ProlongWeights(const DualArray3D<Real> &weights) {
+    for (int k=0; k<NGHOST+1; k++) {
+      for (int j=0; j<NGHOST+1; j++) {
+        for (int i=0; i<NGHOST+1; i++) {
+          w[k][j][i] = weights.h_view(k,j,i);
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn HighOrderProlongCCVars()
+//! \brief high-order prolongation operator for all nvar cell-centered variables of coarse
+//! cell (k,j,i), called from within a team thread with vector lanes running over
+//! variables.  Each coarse value in the stencil is loaded once and contributes to all
+//! eight fine cells, with the same order of summation as HighOrderProlongCC().
+
+template <int NGHOST>
+KOKKOS_INLINE_FUNCTION
+void HighOrderProlongCCVars(TeamMember_t const &tmember, const int m, const int nvar,
+               const int k, const int j, const int i, const int fk, const int fj,
+               const int fi, const DvceArray5D<Real> &ca, const DvceArray5D<Real> &a,
+               const ProlongWeights<NGHOST> &wt) {
+  Kokkos::parallel_for(Kokkos::ThreadVectorRange(tmember, nvar), [&](const int v) {
+    Real f[2][2][2] = {{{0.0, 0.0}, {0.0, 0.0}}, {{0.0, 0.0}, {0.0, 0.0}}};
+    for (int kk=0; kk<NGHOST+1; kk++) {
+      for (int jj=0; jj<NGHOST+1; jj++) {
+        for (int ii=0; ii<NGHOST+1; ii++) {
+          Real c = ca(m,v,k-NGHOST/2+kk,j-NGHOST/2+jj,i-NGHOST/2+ii);
+          for (int ok=0; ok<2; ok++) {
+            for (int oj=0; oj<2; oj++) {
+              for (int oi=0; oi<2; oi++) {
+                f[ok][oj][oi] += wt.w[(ok)? NGHOST-kk : kk][(oj)? NGHOST-jj : jj]
+                                     [(oi)? NGHOST-ii : ii]*c;
+              }
+            }
+          }
+        }
+      }
+    }
+    for (int ok=0; ok<2; ok++) {
+      for (int oj=0; oj<2; oj++) {
+        for (int oi=0; oi<2; oi++) {
+          a(m,v,fk+ok,fj+oj,fi+oi) = f[ok][oj][oi];
+        }
+      }
+    }
+  });
+  return;
+}
+
 #endif // MESH_PROLONGATION_HPP_
 
@@ -11,6 +11,7 @@
 #include <algorithm>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "eos/eos.hpp"
@@ -107,7 +108,8 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
 
   // Thermal conduction (only constructed if needed)
   if (pin->DoesParameterExist("mhd","conductivity") ||
-      pin->DoesParameterExist("mhd","tdep_conductivity")) {
+      pin->DoesParameterExist("mhd","tdep_conductivity") ||
+      pin->DoesParameterExist("mhd","aniso_conductivity")) {
     pcond = new Conduction("mhd", ppack, pin);
   } else {
     pcond = nullptr;
@@ -152,7 +154,12 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
   }
 
   // allocate boundary buffers for conserved (cell-centered) and face-centered variables
+  // face-centered fields always communicated at full precision to preserve div(B)=0
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, false);
+  pbval_u->lowp_vars = pin->GetOrAddBoolean("mhd", "lowp_halo", false);
+  if (pin->GetOrAddBoolean("mhd", "trim_halo", false)) {
+    pbval_u->halo_depth = pbval_u->StencilHaloDepth(pin, "mhd");
+  }
   pbval_u->InitializeBuffers((nmhd+nscalars));
   pbval_b = new MeshBoundaryValuesFC(ppack, pin);
   pbval_b->InitializeBuffers(3);
@@ -174,6 +181,67 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
   if (evolution_t.compare("stationary") != 0) {
     // determine if FOFC is enabled
     use_fofc = pin->GetOrAddBoolean("mhd","fofc",false);
+    // determine if C2P in active cells overlaps communication of ghost zones
+    split_c2p = pin->GetOrAddBoolean("mhd","split_c2p",false);
+    if (split_c2p && pin->DoesBlockExist("shearing_box")) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mhd>/split_c2p is not compatible with shearing box"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    // Optionally fuse CornerE and CT over tiles in x2/x3.  Only for 3D nonrelativistic
+    // MHD without extra contributions to E (resistivity, shearing box).
+    ct_tile = pin->GetOrAddInteger("mhd","ct_tile",0);
+    if (ct_tile > 0) {
+      auto &indcs = pmy_pack->pmesh->mb_indcs;
+      auto &coord = pmy_pack->pcoord;
+      if (!(pmy_pack->pmesh->three_d) || (indcs.nx2 % ct_tile != 0) ||
+          (indcs.nx3 % ct_tile != 0)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<mhd>/ct_tile=" << ct_tile << " requires a 3D "
+                  << "problem, and must evenly divide the MeshBlock size in x2 and x3"
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (coord->is_special_relativistic || coord->is_general_relativistic ||
+          coord->is_dynamical_relativistic || (presist != nullptr) ||
+          pin->DoesBlockExist("shearing_box")) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<mhd>/ct_tile cannot be used with relativistic MHD, "
+                  << "resistivity, or shearing box" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      // scratch per team is cell-centered and edge E over the tile (see CornerECT()),
+      // which must fit in the scratch level used
+      int ncells1 = SimdPadded(indcs.nx1 + 2*(indcs.ng));
+      size_t scr_size = ScrArray4D<Real>::shmem_size(3, ct_tile+2, ct_tile+2, ncells1) +
+                        ScrArray4D<Real>::shmem_size(3, ct_tile+1, ct_tile+1, ncells1);
+      ct_tile_scr_level = FittingScratchLevel(scr_size);
+      if (ct_tile_scr_level < 0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<mhd>/ct_tile=" << ct_tile << " needs " << scr_size
+                  << " bytes of team scratch, more than is available at scratch level 1."
+                  << "  Use a smaller ct_tile" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      if (ct_tile_scr_level != global_variable::scratch_level &&
+          global_variable::my_rank == 0) {
+        std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<mhd>/ct_tile=" << ct_tile << " needs " << scr_size
+                  << " bytes of team scratch, more than is available at "
+                  << "<job>/scratch_level=" << global_variable::scratch_level
+                  << ", so scratch level " << ct_tile_scr_level << " is used"
+                  << std::endl;
+      }
+    }
+    // Optionally compute cell-centered B in active cells in CT, for C2P in active cells
+    ct_bcc = pin->GetOrAddBoolean("mhd","ct_bcc",false);
+    if (ct_bcc && (!(split_c2p) || ct_tile > 0)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mhd>/ct_bcc requires <mhd>/split_c2p=true, and cannot "
+                << "be used with <mhd>/ct_tile" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
 
     // select reconstruction method (default PLM)
     std::string xorder = pin->GetOrAddString("mhd","reconstruct","plm");
@@ -191,7 +259,8 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       }
     } else if (xorder.compare("ppm4") == 0 ||
                xorder.compare("ppmx") == 0 ||
-               xorder.compare("wenoz") == 0) {
+               xorder.compare("wenoz") == 0 ||
+               xorder.compare("wenoz_hybrid") == 0) {
       // check that nghost > 2
       auto &indcs = pmy_pack->pmesh->mb_indcs;
       if (indcs.ng < 3) {
@@ -211,15 +280,44 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
         recon_method = ReconstructionMethod::ppm4;
       } else if (xorder.compare("ppmx") == 0) {
         recon_method = ReconstructionMethod::ppmx;
-      } else if (xorder.compare("wenoz") == 0) {
+      } else if (xorder.compare("wenoz") == 0 || xorder.compare("wenoz_hybrid") == 0) {
         recon_method = ReconstructionMethod::wenoz;
       }
+      // hybrid WENO-Z: linear 5th-order stencil in cells flagged smooth by shock sensor
+      if (xorder.compare("wenoz_hybrid") == 0) {
+        hybrid_thresh = pin->GetOrAddReal("mhd","hybrid_threshold",0.02);
+        if (hybrid_thresh <= 0.0) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                    << std::endl << "<mhd>/hybrid_threshold must be > 0" << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+      }
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                 << std::endl << "<mhd>/recon = '" << xorder << "' not implemented"
                 << std::endl;
       std::exit(EXIT_FAILURE);
     }
+    if (!(ReconstructionEnabled(recon_method))) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mhd>/recon = '" << xorder << "' not compiled, "
+                << "add it to Athena_RECONSTRUCTION when configuring" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // reconstruction in characteristic variables (nonrelativistic ideal gas only)
+    char_recon = pin->GetOrAddBoolean("mhd","characteristic",false);
+    if (char_recon && (!(peos->eos_data.is_ideal) ||
+                       xorder.compare("wenoz_hybrid") == 0 ||
+                       pmy_pack->pcoord->is_special_relativistic ||
+                       pmy_pack->pcoord->is_general_relativistic ||
+                       pmy_pack->pcoord->is_dynamical_relativistic)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<mhd> characteristic = true only implemented for "
+                << "nonrelativistic MHD with an ideal gas EOS, and cannot be used with "
+                << "reconstruct = wenoz_hybrid" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
 
     // select Riemann solver (no default).  Test for compatibility of options
     std::string rsolver = pin->GetString("mhd","rsolver");
@@ -317,6 +415,16 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       Kokkos::realloc(efld.x2e, nmb, ncells3+1, ncells2, ncells1+1);
       Kokkos::realloc(efld.x3e, nmb, ncells3, ncells2+1, ncells1+1);
 
+      // compulsory memory traffic per row of flux and update kernels (kernel profiler):
+      // fluxes read w0 and bcc, and write fluxes and two face-centered E-fields
+      int ndim = 1 + (ncells2 > 1) + (ncells3 > 1);
+      double flx_bytes = (2.0*(nmhd+nscalars) + 5.0)*ncells1*sizeof(Real);
+      kernel_profiler::SetBytesPerIteration("mhd_flux1", flx_bytes);
+      kernel_profiler::SetBytesPerIteration("mhd_flux2", flx_bytes);
+      kernel_profiler::SetBytesPerIteration("mhd_flux3", flx_bytes);
+      kernel_profiler::SetBytesPerIteration("mhd_update",
+                                            (3.0 + ndim)*indcs.nx1*sizeof(Real));
+
       // allocate scratch arrays for face- and cell-centered E used in CornerE
       Kokkos::realloc(e3x1, nmb, ncells3, ncells2, ncells1);
       Kokkos::realloc(e2x1, nmb, ncells3, ncells2, ncells1);
@@ -324,16 +432,12 @@ MHD::MHD(MeshBlockPack *ppack, ParameterInput *pin) :
       Kokkos::realloc(e3x2, nmb, ncells3, ncells2, ncells1);
       Kokkos::realloc(e2x3, nmb, ncells3, ncells2, ncells1);
       Kokkos::realloc(e1x3, nmb, ncells3, ncells2, ncells1);
-      Kokkos::realloc(e1_cc, nmb, ncells3, ncells2, ncells1);
-      Kokkos::realloc(e2_cc, nmb, ncells3, ncells2, ncells1);
-      Kokkos::realloc(e3_cc, nmb, ncells3, ncells2, ncells1);
+      // e1_cc, e2_cc, e3_cc are taken from pmy_pack->scratch when needed in CornerE
 
       // allocate array of flags used with FOFC
+      // utest and bcctest are taken from pmy_pack->scratch when needed in FOFC
       if (use_fofc) {
-        int nvars = (pmy_pack->pcoord->is_dynamical_relativistic) ? nmhd+nscalars : nmhd;
         Kokkos::realloc(fofc,    nmb, ncells3, ncells2, ncells1);
-        Kokkos::realloc(utest,   nmb, nvars, ncells3, ncells2, ncells1);
-        Kokkos::realloc(bcctest, nmb, 3,    ncells3, ncells2, ncells1);
         Kokkos::deep_copy(fofc, false);
       }
     }
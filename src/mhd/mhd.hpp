@@ -74,6 +74,7 @@ struct MHDTaskIDs {
   TaskID recvb_shr;
   TaskID bcs;
   TaskID prol;
+  TaskID c2pa;
   TaskID c2p;
   TaskID newdt;
   TaskID csend;
@@ -92,6 +93,8 @@ class MHD {
 
   // data
   ReconstructionMethod recon_method;
+  Real hybrid_thresh = 0.0; // shock sensor threshold of hybrid WENO-Z (0: WENO-Z only)
+  bool char_recon = false;  // reconstruct in characteristic variables
   MHD_RSolver rsolver_method;
   EquationOfState *peos;   // chosen EOS
 
@@ -128,7 +131,7 @@ class MHD {
   DvceFaceFld4D<Real> b1;     // face-centered magnetic fields, second register
   DvceFaceFld5D<Real> uflx;   // fluxes of conserved quantities on cell faces
   DvceEdgeFld4D<Real> efld;   // edge-centered electric fields (fluxes of B)
-  // temporary variables used to store face-centered electric fields returned by RS
+  // cell-centered electric fields used in CornerE (views into pack scratch arena)
   DvceArray4D<Real> e3x1, e2x1;
   DvceArray4D<Real> e1x2, e3x2;
   DvceArray4D<Real> e2x3, e1x3;
@@ -143,6 +146,24 @@ class MHD {
   DvceArray4D<bool> fofc;  // flag for each cell to indicate if FOFC is needed
   bool use_fofc = false;   // flag to enable FOFC
 
+  // flag to overlap EMF/CT and C2P in active cells with communication of ghost zones
+  bool split_c2p = false;
+  // flag set when U is communicated with radiation intensities in stage task lists
+  bool coalesced_u = false;
+  // flag set when U and B are not evolved (<mhd>/fixed with dynamical GR), in which case
+  // updates of U and B are skipped, and so are their exchanges unless they have changed
+  bool fixed_fields = false;
+  // flag set by InitRecv when exchanges of U and B are skipped in this stage
+  bool skip_halo = false;
+  // size of tiles in x2/x3 over which the fused CornerE+CT kernel computes edge EMFs in
+  // scratch and updates interior faces (0 for separate CornerE and CT kernels), and
+  // scratch level used for them
+  int ct_tile = 0;
+  int ct_tile_scr_level = 0;
+  // with split_c2p, CT also stores the average of the updated faces in bcc0 in active
+  // cells, which ConToPrimActive then uses rather than averaging faces again
+  bool ct_bcc = false;
+
   // container to hold names of TaskIDs
   MHDTaskIDs id;
 
@@ -182,23 +203,30 @@ class MHD {
   TaskStatus ApplyPhysicalBCs(Driver* pdrive, int stage);
   TaskStatus Prolongate(Driver* pdrive, int stage);
   TaskStatus ConToPrim(Driver *d, int stage);
+  TaskStatus ConToPrimActive(Driver *d, int stage);
+  TaskStatus ConToPrimGhost(Driver *d, int stage);
   TaskStatus NewTimeStep(Driver *d, int stage);
   // ...in "after_stagen_tl" task list
   TaskStatus ClearSend(Driver *d, int stage);
   TaskStatus ClearRecv(Driver *d, int stage);  // also in Driver::Initialize
 
-  // CalculateFluxes function templated over Riemann Solvers
+  // CalculateFluxes function templated over Riemann Solvers, which calls kernels that are
+  // also templated over reconstruction method
   template <MHD_RSolver T>
   void CalculateFluxes(Driver *d, int stage);
+  template <MHD_RSolver T, ReconstructionMethod R>
+  void CalculateFluxesRecon(Driver *d, int stage);
 
   // first-order flux correction
   void FOFC(Driver *d, int stage);
+  // fused corner EMF and CT update of faces that do not touch MeshBlock boundary edges
+  void CornerECT(Driver *d, int stage);
 
-  DvceArray5D<Real> utest, bcctest;  // scratch arrays for FOFC
+  DvceArray5D<Real> utest, bcctest;  // FOFC temporaries (views into pack scratch arena)
 
  private:
   MeshBlockPack* pmy_pack;   // ptr to MeshBlockPack containing this MHD
-  // temporary variables used to store face-centered electric fields returned by RS
+  // cell-centered electric fields used in CornerE (views into pack scratch arena)
   DvceArray4D<Real> e1_cc, e2_cc, e3_cc;
 };
 
@@ -29,9 +29,11 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
   int js = indcs.js, je = indcs.je;
   int ks = indcs.ks, ke = indcs.ke;
   int nmb1 = pmy_pack->nmb_thispack - 1;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+  int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
   auto &size = pmy_pack->pmb->mb_size;
-  auto &flat = pmy_pack->pcoord->coord_data.is_minkowski;
-  auto &spin = pmy_pack->pcoord->coord_data.bh_spin;
+  auto &coord = pmy_pack->pcoord->coord_data;
 
   //---- 1-D problem:
   //  copy face-centered E-fields to edges and return.
@@ -58,6 +60,8 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
 
   if (pmy_pack->pmesh->two_d) {
     // Compute cell-centered E3 = -(v X B) = VyBx-VxBy
+    // (stored in slot 2 of the MeshBlockPack scratch arena, since only needed here)
+    e3_cc = pmy_pack->scratch.Get4D(2, nmb1+1, ncells3, ncells2, ncells1);
     auto w0_ = w0;
     auto bcc_ = bcc0;
     auto e3cc_ = e3_cc;
@@ -101,7 +105,7 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
         Real x3v = CellCenterX(0, indcs.nx3, x3min, x3max);
 
         Real glower[4][4], gupper[4][4];
-        ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+        CellMetricAndInverse(coord, m, ks, j, i, x1v, x2v, x3v, glower, gupper);
 
         const Real &ux = w0_(m,IVX,ks,j,i);
         const Real &uy = w0_(m,IVY,ks,j,i);
@@ -204,10 +208,20 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
   // Use GS07 algorithm to compute all three of E1, E2, and E3
 
   if (pmy_pack->pmesh->three_d) {
+    // with ct_tile, corner E and CT in interior of MBs computed in one tiled kernel
+    if (ct_tile > 0) {
+      CornerECT(pdriver, stage);
+      return TaskStatus::complete;
+    }
+
     // Compute cell-centered electric fields
     // E1=-(v X B)=VzBy-VyBz
     // E2=-(v X B)=VxBz-VzBx
     // E3=-(v X B)=VyBx-VxBy
+    // (stored in slots 0-2 of the MeshBlockPack scratch arena, since only needed here)
+    e1_cc = pmy_pack->scratch.Get4D(0, nmb1+1, ncells3, ncells2, ncells1);
+    e2_cc = pmy_pack->scratch.Get4D(1, nmb1+1, ncells3, ncells2, ncells1);
+    e3_cc = pmy_pack->scratch.Get4D(2, nmb1+1, ncells3, ncells2, ncells1);
     auto w0_ = w0;
     auto bcc_ = bcc0;
     auto e1cc_ = e1_cc;
@@ -258,7 +272,7 @@ TaskStatus MHD::CornerE(Driver *pdriver, int stage) {
         Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
 
         Real glower[4][4], gupper[4][4];
-        ComputeMetricAndInverse(x1v, x2v, x3v, flat, spin, glower, gupper);
+        CellMetricAndInverse(coord, m, k, j, i, x1v, x2v, x3v, glower, gupper);
 
         const Real &ux = w0_(m,IVX,k,j,i);
         const Real &uy = w0_(m,IVY,k,j,i);
@@ -11,6 +11,7 @@
 #include "mesh/mesh.hpp"
 #include "srcterms/srcterms.hpp"
 #include "driver/driver.hpp"
+#include "bvals/bvals.hpp"
 #include "mhd.hpp"
 
 namespace mhd {
@@ -21,11 +22,14 @@ namespace mhd {
 //  Temporal update uses multi-step SSP integrators, e.g. RK2, RK3
 
 TaskStatus MHD::CT(Driver *pdriver, int stage) {
+  if (fixed_fields) {return TaskStatus::complete;}
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
   int ks = indcs.ks, ke = indcs.ke;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
+  // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+  int nmba1 = pmy_pack->pmb->nmb_active - 1;
+  auto &mbact = pmy_pack->pmb->mb_active;
 
   // capture class variables for the kernels
   Real &gam0 = pdriver->gam0[stage-1];
@@ -37,13 +41,19 @@ TaskStatus MHD::CT(Driver *pdriver, int stage) {
   auto e2 = efld.x2e;
   auto e3 = efld.x3e;
   auto &mbsize = pmy_pack->pmb->mb_size;
+  // with ct_tile, only faces touching MeshBlock boundary edges (which may be changed by
+  // RecvE) are updated here, the rest were updated in CornerECT()
+  bool bface_only = (ct_tile > 0);
 
   //---- update B1 (only for 2D/3D problems)
   if (multi_d) {
     auto bx1f = b0.x1f;
     auto bx1f_old = b1.x1f;
-    par_for("CT-b1", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie+1,
-    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    par_for("CT-b1", DevExeSpace(), 0, nmba1, ks, ke, js, je, is, ie+1,
+    KOKKOS_LAMBDA(int mm, int k, int j, int i) {
+      if (bface_only && (i > is) && (i < ie+1) && (j > js) && (j < je) &&
+          (k > ks) && (k < ke)) {return;}
+      const int m = mbact.d_view(mm);
       bx1f(m,k,j,i) = gam0*bx1f(m,k,j,i) + gam1*bx1f_old(m,k,j,i);
       bx1f(m,k,j,i) -= beta_dt*(e3(m,k,j+1,i) - e3(m,k,j,i))/mbsize.d_view(m).dx2;
       if (three_d) {
@@ -55,8 +65,11 @@ TaskStatus MHD::CT(Driver *pdriver, int stage) {
   //---- update B2 (curl terms in 1D and 3D problems)
   auto bx2f = b0.x2f;
   auto bx2f_old = b1.x2f;
-  par_for("CT-b2", DevExeSpace(), 0, nmb1, ks, ke, js, je+1, is, ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+  par_for("CT-b2", DevExeSpace(), 0, nmba1, ks, ke, js, je+1, is, ie,
+  KOKKOS_LAMBDA(int mm, int k, int j, int i) {
+    if (bface_only && (j > js) && (j < je+1) && (i > is) && (i < ie) &&
+        (k > ks) && (k < ke)) {return;}
+    const int m = mbact.d_view(mm);
     bx2f(m,k,j,i) = gam0*bx2f(m,k,j,i) + gam1*bx2f_old(m,k,j,i);
     bx2f(m,k,j,i) += beta_dt*(e3(m,k,j,i+1) - e3(m,k,j,i))/mbsize.d_view(m).dx1;
     if (three_d) {
@@ -67,15 +80,266 @@ TaskStatus MHD::CT(Driver *pdriver, int stage) {
   //---- update B3 (curl terms in 1D and 2D/3D problems)
   auto bx3f = b0.x3f;
   auto bx3f_old = b1.x3f;
-  par_for("CT-b3", DevExeSpace(), 0, nmb1, ks, ke+1, js, je, is, ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    bx3f(m,k,j,i) = gam0*bx3f(m,k,j,i) + gam1*bx3f_old(m,k,j,i);
-    bx3f(m,k,j,i) -= beta_dt*(e2(m,k,j,i+1) - e2(m,k,j,i))/mbsize.d_view(m).dx1;
-    if (multi_d) {
-      bx3f(m,k,j,i) += beta_dt*(e1(m,k,j+1,i) - e1(m,k,j,i))/mbsize.d_view(m).dx2;
-    }
-  });
+  if (ct_bcc) {
+    // B1 and B2 are now final, so march up each column of x3-faces, keeping the updated
+    // B3 on both faces of each cell in registers, and store cell-centered B in active
+    // cells (as the simple linear average of faces also used in ConsToPrim)
+    auto bx1f = b0.x1f;
+    auto bcc = bcc0;
+    par_for("CT-b3-bcc", DevExeSpace(), 0, nmba1, js, je, is, ie,
+    KOKKOS_LAMBDA(int mm, int j, int i) {
+      const int m = mbact.d_view(mm);
+      Real b3l = 0.0;
+      for (int k=ks; k<=ke+1; ++k) {
+        Real b3r = gam0*bx3f(m,k,j,i) + gam1*bx3f_old(m,k,j,i);
+        b3r -= beta_dt*(e2(m,k,j,i+1) - e2(m,k,j,i))/mbsize.d_view(m).dx1;
+        if (multi_d) {
+          b3r += beta_dt*(e1(m,k,j+1,i) - e1(m,k,j,i))/mbsize.d_view(m).dx2;
+        }
+        bx3f(m,k,j,i) = b3r;
+        if (k > ks) {
+          bcc(m,IBX,k-1,j,i) = 0.5*(bx1f(m,k-1,j,i) + bx1f(m,k-1,j,i+1));
+          bcc(m,IBY,k-1,j,i) = 0.5*(bx2f(m,k-1,j,i) + bx2f(m,k-1,j+1,i));
+          bcc(m,IBZ,k-1,j,i) = 0.5*(b3l + b3r);
+        }
+        b3l = b3r;
+      }
+    });
+  } else {
+    par_for("CT-b3", DevExeSpace(), 0, nmba1, ks, ke+1, js, je, is, ie,
+    KOKKOS_LAMBDA(int mm, int k, int j, int i) {
+      if (bface_only && (k > ks) && (k < ke+1) && (i > is) && (i < ie) &&
+          (j > js) && (j < je)) {return;}
+      const int m = mbact.d_view(mm);
+      bx3f(m,k,j,i) = gam0*bx3f(m,k,j,i) + gam1*bx3f_old(m,k,j,i);
+      bx3f(m,k,j,i) -= beta_dt*(e2(m,k,j,i+1) - e2(m,k,j,i))/mbsize.d_view(m).dx1;
+      if (multi_d) {
+        bx3f(m,k,j,i) += beta_dt*(e1(m,k,j+1,i) - e1(m,k,j,i))/mbsize.d_view(m).dx2;
+      }
+    });
+  }
+  pbval_b->vars_version++;
 
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn  void MHD::CornerECT
+//  \brief Fused corner electric field and CT update for 3D nonrelativistic MHD, used when
+//  ct_tile > 0.  Each team handles a tile of nx1 x ct_tile x ct_tile cells: it computes
+//  cell-centered E in scratch, integrates E to edges using GS07 (same expressions as in
+//  MHD::CornerE()) into scratch, and then updates all faces in the tile whose edges are
+//  all interior to the MeshBlock.  Only edges on MeshBlock boundaries, which are needed
+//  by SendE/RecvE, are written to efld, and faces touching them are updated in MHD::CT.
+//  Each team needs 3*((ct_tile+2)^2 + (ct_tile+1)^2)*ncells1 Reals of scratch; for
+//  nx1=32 in double precision with 48 KB of level-0 scratch on GPUs, ct_tile up to 2
+//  fits, while larger tiles use scratch level 1 as selected in the MHD constructor.
+
+void MHD::CornerECT(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nc1 = indcs.nx1 + 2;                    // cells in [is-1,ie+1]
+  int ncells1 = SimdPadded(indcs.nx1 + 2*(indcs.ng));  // length of scratch rows
+  auto &mbact = pmy_pack->pmb->mb_active;
+  int nmba1 = pmy_pack->pmb->nmb_active - 1;
+
+  // capture class variables for the kernels
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto w0_ = w0;
+  auto bcc_ = bcc0;
+  auto e1 = efld.x1e;
+  auto e2 = efld.x2e;
+  auto e3 = efld.x3e;
+  auto e2x1_ = e2x1;
+  auto e3x1_ = e3x1;
+  auto e1x2_ = e1x2;
+  auto e3x2_ = e3x2;
+  auto e1x3_ = e1x3;
+  auto e2x3_ = e2x3;
+  auto flx1 = uflx.x1f;
+  auto flx2 = uflx.x2f;
+  auto flx3 = uflx.x3f;
+  auto bx1f = b0.x1f;
+  auto bx2f = b0.x2f;
+  auto bx3f = b0.x3f;
+  auto bx1f_old = b1.x1f;
+  auto bx2f_old = b1.x2f;
+  auto bx3f_old = b1.x3f;
+
+  const int nt = ct_tile;
+  const int ntj = indcs.nx2/nt;
+  const int ntk = indcs.nx3/nt;
+  size_t scr_size = ScrArray4D<Real>::shmem_size(3, nt+2, nt+2, ncells1) +
+                    ScrArray4D<Real>::shmem_size(3, nt+1, nt+1, ncells1);
+  int scr_level = ct_tile_scr_level;
+
+  par_for_outer("emf_ct", DevExeSpace(), scr_size, scr_level, 0, nmba1, 0, (ntk-1),
+                0, (ntj-1),
+  KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int kt, const int jt) {
+    const int m = mbact.d_view(mm);
+    const int k0 = ks + kt*nt;
+    const int j0 = js + jt*nt;
+    // cell-centered E over cells [k0-1,k0+nt] x [j0-1,j0+nt] x [is-1,ie+1], and edge E
+    // over edges [k0,k0+nt] x [j0,j0+nt] x [is,ie+1], indexed relative to tile
+    ScrArray4D<Real> ecc(member.team_scratch(scr_level), 3, nt+2, nt+2, ncells1);
+    ScrArray4D<Real> eg(member.team_scratch(scr_level), 3, nt+1, nt+1, ncells1);
+    const int ko = k0-1, jo = j0-1;
+
+    // E1=-(v X B)=VzBy-VyBz, E2=-(v X B)=VxBz-VzBx, E3=-(v X B)=VyBx-VxBy
+    const int nji = (nt+2)*nc1;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(member, (nt+2)*nji),
+    [&](const int idx) {
+      int k = idx/nji;
+      int j = (idx - k*nji)/nc1;
+      int i = (idx - k*nji - j*nc1) + is - 1;
+      int kg = k + ko, jg = j + jo;
+      ecc(0,k,j,i) = w0_(m,IVZ,kg,jg,i)*bcc_(m,IBY,kg,jg,i) -
+                     w0_(m,IVY,kg,jg,i)*bcc_(m,IBZ,kg,jg,i);
+      ecc(1,k,j,i) = w0_(m,IVX,kg,jg,i)*bcc_(m,IBZ,kg,jg,i) -
+                     w0_(m,IVZ,kg,jg,i)*bcc_(m,IBX,kg,jg,i);
+      ecc(2,k,j,i) = w0_(m,IVY,kg,jg,i)*bcc_(m,IBX,kg,jg,i) -
+                     w0_(m,IVX,kg,jg,i)*bcc_(m,IBY,kg,jg,i);
+    });
+    member.team_barrier();
+
+    // Integrate E1, E2, E3 to corners using SG07
+    const int ne1 = nc1 - 1;
+    const int neji = (nt+1)*ne1;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(member, (nt+1)*neji),
+    [&](const int idx) {
+      int kk = idx/neji;
+      int jj = (idx - kk*neji)/ne1;
+      int i = (idx - kk*neji - jj*ne1) + is;
+      int k = kk + k0, j = jj + j0;
+      // scratch indices of cells (k,j) and (k-1,j-1) around edge
+      int kc = k - ko, jc = j - jo;
+      // edges on MB boundaries are written to efld by the tile that owns them
+      bool own = ((kk < nt) || (k == ke+1)) && ((jj < nt) || (j == je+1));
+
+      // integrate E1 to corner (E1 not needed at i=ie+1)
+      if (i <= ie) {
+        Real e1_l3, e1_r3, e1_l2, e1_r2;
+        if (flx2(m,IDN,k-1,j,i) >= 0.0) {
+          e1_l3 = e1x3_(m,k,j-1,i) - ecc(0,kc-1,jc-1,i);
+        } else {
+          e1_l3 = e1x3_(m,k,j  ,i) - ecc(0,kc-1,jc  ,i);
+        }
+        if (flx2(m,IDN,k,j,i) >= 0.0) {
+          e1_r3 = e1x3_(m,k,j-1,i) - ecc(0,kc  ,jc-1,i);
+        } else {
+          e1_r3 = e1x3_(m,k,j  ,i) - ecc(0,kc  ,jc  ,i);
+        }
+        if (flx3(m,IDN,k,j-1,i) >= 0.0) {
+          e1_l2 = e1x2_(m,k-1,j,i) - ecc(0,kc-1,jc-1,i);
+        } else {
+          e1_l2 = e1x2_(m,k  ,j,i) - ecc(0,kc  ,jc-1,i);
+        }
+        if (flx3(m,IDN,k,j,i) >= 0.0) {
+          e1_r2 = e1x2_(m,k-1,j,i) - ecc(0,kc-1,jc  ,i);
+        } else {
+          e1_r2 = e1x2_(m,k  ,j,i) - ecc(0,kc  ,jc  ,i);
+        }
+        eg(0,kk,jj,i) = 0.25*(e1_l3 + e1_r3 + e1_l2 + e1_r2 +
+                e1x2_(m,k-1,j,i) + e1x2_(m,k,j,i) + e1x3_(m,k,j-1,i) + e1x3_(m,k,j,i));
+        if (own && ((j == js) || (j == je+1) || (k == ks) || (k == ke+1))) {
+          e1(m,k,j,i) = eg(0,kk,jj,i);
+        }
+      }
+
+      // integrate E2 to corner
+      Real e2_l3, e2_r3, e2_l1, e2_r1;
+      if (flx1(m,IDN,k-1,j,i) >= 0.0) {
+        e2_l3 = e2x3_(m,k,j,i-1) - ecc(1,kc-1,jc,i-1);
+      } else {
+        e2_l3 = e2x3_(m,k,j,i  ) - ecc(1,kc-1,jc,i  );
+      }
+      if (flx1(m,IDN,k,j,i) >= 0.0) {
+        e2_r3 = e2x3_(m,k,j,i-1) - ecc(1,kc  ,jc,i-1);
+      } else {
+        e2_r3 = e2x3_(m,k,j,i  ) - ecc(1,kc  ,jc,i  );
+      }
+      if (flx3(m,IDN,k,j,i-1) >= 0.0) {
+        e2_l1 = e2x1_(m,k-1,j,i) - ecc(1,kc-1,jc,i-1);
+      } else {
+        e2_l1 = e2x1_(m,k  ,j,i) - ecc(1,kc  ,jc,i-1);
+      }
+      if (flx3(m,IDN,k,j,i) >= 0.0) {
+        e2_r1 = e2x1_(m,k-1,j,i) - ecc(1,kc-1,jc,i  );
+      } else {
+        e2_r1 = e2x1_(m,k  ,j,i) - ecc(1,kc  ,jc,i  );
+      }
+      eg(1,kk,jj,i) = 0.25*(e2_l3 + e2_r3 + e2_l1 + e2_r1 +
+                e2x3_(m,k,j,i-1) + e2x3_(m,k,j,i) + e2x1_(m,k-1,j,i) + e2x1_(m,k,j,i));
+      if (own && (j <= je) && ((i == is) || (i == ie+1) || (k == ks) || (k == ke+1))) {
+        e2(m,k,j,i) = eg(1,kk,jj,i);
+      }
+
+      // integrate E3 to corner
+      Real e3_l2, e3_r2, e3_l1, e3_r1;
+      if (flx1(m,IDN,k,j-1,i) >= 0.0) {
+        e3_l2 = e3x2_(m,k,j,i-1) - ecc(2,kc,jc-1,i-1);
+      } else {
+        e3_l2 = e3x2_(m,k,j,i  ) - ecc(2,kc,jc-1,i  );
+      }
+      if (flx1(m,IDN,k,j,i) >= 0.0) {
+        e3_r2 = e3x2_(m,k,j,i-1) - ecc(2,kc,jc  ,i-1);
+      } else {
+        e3_r2 = e3x2_(m,k,j,i  ) - ecc(2,kc,jc  ,i  );
+      }
+      if (flx2(m,IDN,k,j,i-1) >= 0.0) {
+        e3_l1 = e3x1_(m,k,j-1,i) - ecc(2,kc,jc-1,i-1);
+      } else {
+        e3_l1 = e3x1_(m,k,j  ,i) - ecc(2,kc,jc  ,i-1);
+      }
+      if (flx2(m,IDN,k,j,i) >= 0.0) {
+        e3_r1 = e3x1_(m,k,j-1,i) - ecc(2,kc,jc-1,i  );
+      } else {
+        e3_r1 = e3x1_(m,k,j  ,i) - ecc(2,kc,jc  ,i  );
+      }
+      eg(2,kk,jj,i) = 0.25*(e3_l1 + e3_r1 + e3_l2 + e3_r2 +
+                e3x2_(m,k,j,i-1) + e3x2_(m,k,j,i) + e3x1_(m,k,j-1,i) + e3x1_(m,k,j,i));
+      if (own && (k <= ke) && ((i == is) || (i == ie+1) || (j == js) || (j == je+1))) {
+        e3(m,k,j,i) = eg(2,kk,jj,i);
+      }
+    });
+    member.team_barrier();
+
+    // CT update of faces in tile that do not touch MB boundary edges
+    const Real dx1 = mbsize.d_view(m).dx1;
+    const Real dx2 = mbsize.d_view(m).dx2;
+    const Real dx3 = mbsize.d_view(m).dx3;
+    const int nfji = nt*ne1;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange<>(member, nt*nfji),
+    [&](const int idx) {
+      int kk = idx/nfji;
+      int jj = (idx - kk*nfji)/ne1;
+      int i = (idx - kk*nfji - jj*ne1) + is;
+      int k = kk + k0, j = jj + j0;
+      bool kint = (k > ks) && (k < ke);
+      bool jint = (j > js) && (j < je);
+      if ((i > is) && (i <= ie) && jint && kint) {
+        bx1f(m,k,j,i) = gam0*bx1f(m,k,j,i) + gam1*bx1f_old(m,k,j,i);
+        bx1f(m,k,j,i) -= beta_dt*(eg(2,kk,jj+1,i) - eg(2,kk,jj,i))/dx2;
+        bx1f(m,k,j,i) += beta_dt*(eg(1,kk+1,jj,i) - eg(1,kk,jj,i))/dx3;
+      }
+      if ((i > is) && (i < ie) && (j > js) && kint) {
+        bx2f(m,k,j,i) = gam0*bx2f(m,k,j,i) + gam1*bx2f_old(m,k,j,i);
+        bx2f(m,k,j,i) += beta_dt*(eg(2,kk,jj,i+1) - eg(2,kk,jj,i))/dx1;
+        bx2f(m,k,j,i) -= beta_dt*(eg(0,kk+1,jj,i) - eg(0,kk,jj,i))/dx3;
+      }
+      if ((i > is) && (i < ie) && jint && (k > ks)) {
+        bx3f(m,k,j,i) = gam0*bx3f(m,k,j,i) + gam1*bx3f_old(m,k,j,i);
+        bx3f(m,k,j,i) -= beta_dt*(eg(1,kk,jj,i+1) - eg(1,kk,jj,i))/dx1;
+        bx3f(m,k,j,i) += beta_dt*(eg(0,kk,jj+1,i) - eg(0,kk,jj,i))/dx2;
+      }
+    });
+  });
+
+  return;
+}
 } // namespace mhd
@@ -19,6 +19,7 @@
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
 #include "reconstruct/wenoz.hpp"
+#include "reconstruct/characteristic.hpp"
 #include "mhd/rsolvers/advect_mhd.hpp"
 #include "mhd/rsolvers/llf_mhd.hpp"
 #include "mhd/rsolvers/hlle_mhd.hpp"
@@ -31,32 +32,33 @@
 
 namespace mhd {
 //----------------------------------------------------------------------------------------
-//! \fn void MHD::CalculateFlux
+//! \fn void MHD::CalculateFluxesRecon
 //! \brief Calculate fluxes of conserved variables, and face-centered area-averaged EMFs
 //! for evolution of magnetic field
-//! Note this function is templated over RS for better performance on GPUs.
+//! Note this function is templated over RS and reconstruction method for better
+//! performance on GPUs.
 
-template <MHD_RSolver rsolver_method_>
-void MHD::CalculateFluxes(Driver *pdriver, int stage) {
+template <MHD_RSolver rsolver_method_, ReconstructionMethod recon_method_>
+void MHD::CalculateFluxesRecon(Driver *pdriver, int stage) {
   RegionIndcs &indcs_ = pmy_pack->pmesh->mb_indcs;
   int is = indcs_.is, ie = indcs_.ie;
   int js = indcs_.js, je = indcs_.je;
   int ks = indcs_.ks, ke = indcs_.ke;
-  int ncells1 = indcs_.nx1 + 2*(indcs_.ng);
+  int ncells1 = SimdPadded(indcs_.nx1 + 2*(indcs_.ng));  // length of scratch rows
 
   int &nmhd_ = nmhd;
   int nvars = nmhd + nscalars;
-  int nmb1 = pmy_pack->nmb_thispack - 1;
-  const auto recon_method_ = recon_method;
-  bool extrema = false;
-  if (recon_method == ReconstructionMethod::ppmx) {
-    extrema = true;
-  }
+  // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+  int nmba1 = pmy_pack->pmb->nmb_active - 1;
+  auto &mbact = pmy_pack->pmb->mb_active;
+  constexpr bool extrema = (recon_method_ == ReconstructionMethod::ppmx);
 
   auto &eos_ = peos->eos_data;
   auto &size_ = pmy_pack->pmb->mb_size;
   auto &coord_ = pmy_pack->pcoord->coord_data;
   auto &w0_ = w0;
+  const Real hybrid_ = hybrid_thresh;
+  const bool charac = char_recon;
   auto &b0_ = bcc0;
 
   //--------------------------------------------------------------------------------------
@@ -64,7 +66,7 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
 
   size_t scr_size = (ScrArray2D<Real>::shmem_size(nvars, ncells1) +
                      ScrArray2D<Real>::shmem_size(3, ncells1)) * 2;
-  int scr_level = 0;
+  int scr_level = global_variable::scratch_level;
   auto &flx1_ = uflx.x1f;
   auto &e31_ = e3x1;
   auto &e21_ = e2x1;
@@ -82,34 +84,33 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
   int il = is, iu = ie+1;
   if (use_fofc) { il = is-1, iu = ie+2; }
 
-  par_for_outer("mhd_flux1",DevExeSpace(), scr_size, scr_level, 0, nmb1, kl, ku, jl, ju,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+  par_for_outer("mhd_flux1",DevExeSpace(), scr_size, scr_level, 0, nmba1, kl, ku, jl, ju,
+  KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k, const int j) {
+    const int m = mbact.d_view(mm);
     ScrArray2D<Real> wl(member.team_scratch(scr_level), nvars, ncells1);
     ScrArray2D<Real> wr(member.team_scratch(scr_level), nvars, ncells1);
     ScrArray2D<Real> bl(member.team_scratch(scr_level), 3, ncells1);
     ScrArray2D<Real> br(member.team_scratch(scr_level), 3, ncells1);
 
     // Reconstruct qR[i] and qL[i+1], for both W and Bcc
-    switch (recon_method_) {
-      case ReconstructionMethod::dc:
-        DonorCellX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        DonorCellX1(member, m, k, j, il-1, iu, b0_, bl, br);
-        break;
-      case ReconstructionMethod::plm:
-        PiecewiseLinearX1(member, m, k, j, il-1, iu, w0_, wl, wr);
-        PiecewiseLinearX1(member, m, k, j, il-1, iu, b0_, bl, br);
-        break;
-      case ReconstructionMethod::ppm4:
-      case ReconstructionMethod::ppmx:
-        PiecewiseParabolicX1(member,eos_,extrema,true,  m, k, j, il-1, iu, w0_, wl, wr);
-        PiecewiseParabolicX1(member,eos_,extrema,false, m, k, j, il-1, iu, b0_, bl, br);
-        break;
-      case ReconstructionMethod::wenoz:
-        WENOZX1(member, eos_, true,  m, k, j, il-1, iu, w0_, wl, wr);
-        WENOZX1(member, eos_, false, m, k, j, il-1, iu, b0_, bl, br);
-        break;
-      default:
-        break;
+    if (charac) {
+      CharacteristicMHDX1<recon_method_>(member, eos_, m, k, j, il-1, iu, w0_, b0_,
+                                         wl, wr, bl, br);
+    } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+      DonorCellX1(member, m, k, j, il-1, iu, w0_, wl, wr);
+      DonorCellX1(member, m, k, j, il-1, iu, b0_, bl, br);
+    } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+      PiecewiseLinearX1(member, m, k, j, il-1, iu, w0_, wl, wr);
+      PiecewiseLinearX1(member, m, k, j, il-1, iu, b0_, bl, br);
+    } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                         recon_method_ == ReconstructionMethod::ppmx) {
+      PiecewiseParabolicX1(member,eos_,extrema,true,  m, k, j, il-1, iu, w0_, wl, wr);
+      PiecewiseParabolicX1(member,eos_,extrema,false, m, k, j, il-1, iu, b0_, bl, br);
+    } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+      WENOZHybridX1(member, eos_, true, hybrid_, m, k, j, il-1, iu, w0_, b0_, w0_,
+                    wl, wr);
+      WENOZHybridX1(member, eos_, false, hybrid_, m, k, j, il-1, iu, w0_, b0_, b0_,
+                    bl, br);
     }
     // Sync all threads in the team so that scratch memory is consistent
     member.team_barrier();
@@ -179,8 +180,9 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
     jl = js-1, ju = je+1;
     if (use_fofc) { jl = js-2, ju = je+2; }
 
-    par_for_outer("mhd_flux2",DevExeSpace(),scr_size,scr_level,0,nmb1, kl, ku,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+    par_for_outer("mhd_flux2",DevExeSpace(),scr_size,scr_level,0,nmba1, kl, ku,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int k) {
+      const int m = mbact.d_view(mm);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -204,26 +206,24 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
         }
 
         // Reconstruct qR[j] and qL[j+1], for both W and Bcc
-        switch (recon_method_) {
-          case ReconstructionMethod::dc:
-            DonorCellX2(member, m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
-            DonorCellX2(member, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
-            break;
-          case ReconstructionMethod::plm:
-            PiecewiseLinearX2(member, m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
-            PiecewiseLinearX2(member, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
-            break;
-          case ReconstructionMethod::ppm4:
-          case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX2(member,eos_,extrema,true, m,k,j,is-1,ie+1,w0_,wl_jp1,wr);
-            PiecewiseParabolicX2(member,eos_,extrema,false,m,k,j,is-1,ie+1,b0_,bl_jp1,br);
-            break;
-          case ReconstructionMethod::wenoz:
-            WENOZX2(member, eos_, true,  m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
-            WENOZX2(member, eos_, false, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
-            break;
-          default:
-            break;
+        if (charac) {
+          CharacteristicMHDX2<recon_method_>(member, eos_, m, k, j, is-1, ie+1, w0_, b0_,
+                                             wl_jp1, wr, bl_jp1, br);
+        } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+          DonorCellX2(member, m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
+          DonorCellX2(member, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
+        } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+          PiecewiseLinearX2(member, m, k, j, is-1, ie+1, w0_, wl_jp1, wr);
+          PiecewiseLinearX2(member, m, k, j, is-1, ie+1, b0_, bl_jp1, br);
+        } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                             recon_method_ == ReconstructionMethod::ppmx) {
+          PiecewiseParabolicX2(member,eos_,extrema,true, m,k,j,is-1,ie+1,w0_,wl_jp1,wr);
+          PiecewiseParabolicX2(member,eos_,extrema,false,m,k,j,is-1,ie+1,b0_,bl_jp1,br);
+        } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+          WENOZHybridX2(member, eos_, true, hybrid_, m, k, j, is-1, ie+1, w0_, b0_, w0_,
+                        wl_jp1, wr);
+          WENOZHybridX2(member, eos_, false, hybrid_, m, k, j, is-1, ie+1, w0_, b0_, b0_,
+                        bl_jp1, br);
         }
         member.team_barrier();
 
@@ -299,8 +299,9 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
     kl = ks-1, ku = ke+1;
     if (use_fofc) { kl = ks-2, ku = ke+2; }
 
-    par_for_outer("mhd_flux3",DevExeSpace(), scr_size, scr_level, 0, nmb1, js-1, je+1,
-    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int j) {
+    par_for_outer("mhd_flux3",DevExeSpace(), scr_size, scr_level, 0, nmba1, js-1, je+1,
+    KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int j) {
+      const int m = mbact.d_view(mm);
       ScrArray2D<Real> scr1(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr2(member.team_scratch(scr_level), nvars, ncells1);
       ScrArray2D<Real> scr3(member.team_scratch(scr_level), nvars, ncells1);
@@ -324,26 +325,24 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
         }
 
         // Reconstruct qR[k] and qL[k+1], for both W and Bcc
-        switch (recon_method_) {
-          case ReconstructionMethod::dc:
-            DonorCellX3(member, m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
-            DonorCellX3(member, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
-            break;
-          case ReconstructionMethod::plm:
-            PiecewiseLinearX3(member, m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
-            PiecewiseLinearX3(member, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
-            break;
-          case ReconstructionMethod::ppm4:
-          case ReconstructionMethod::ppmx:
-            PiecewiseParabolicX3(member,eos_,extrema,true, m,k,j,is-1,ie+1,w0_,wl_kp1,wr);
-            PiecewiseParabolicX3(member,eos_,extrema,false,m,k,j,is-1,ie+1,b0_,bl_kp1,br);
-            break;
-          case ReconstructionMethod::wenoz:
-            WENOZX3(member, eos_, true,  m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
-            WENOZX3(member, eos_, false, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
-            break;
-          default:
-            break;
+        if (charac) {
+          CharacteristicMHDX3<recon_method_>(member, eos_, m, k, j, is-1, ie+1, w0_, b0_,
+                                             wl_kp1, wr, bl_kp1, br);
+        } else if constexpr (recon_method_ == ReconstructionMethod::dc) {
+          DonorCellX3(member, m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
+          DonorCellX3(member, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
+        } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+          PiecewiseLinearX3(member, m, k, j, is-1, ie+1, w0_, wl_kp1, wr);
+          PiecewiseLinearX3(member, m, k, j, is-1, ie+1, b0_, bl_kp1, br);
+        } else if constexpr (recon_method_ == ReconstructionMethod::ppm4 ||
+                             recon_method_ == ReconstructionMethod::ppmx) {
+          PiecewiseParabolicX3(member,eos_,extrema,true, m,k,j,is-1,ie+1,w0_,wl_kp1,wr);
+          PiecewiseParabolicX3(member,eos_,extrema,false,m,k,j,is-1,ie+1,b0_,bl_kp1,br);
+        } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+          WENOZHybridX3(member, eos_, true, hybrid_, m, k, j, is-1, ie+1, w0_, b0_, w0_,
+                        wl_kp1, wr);
+          WENOZHybridX3(member, eos_, false, hybrid_, m, k, j, is-1, ie+1, w0_, b0_, b0_,
+                        bl_kp1, br);
         }
         member.team_barrier();
 
@@ -407,6 +406,46 @@ void MHD::CalculateFluxes(Driver *pdriver, int stage) {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void MHD::CalculateFluxes
+//! \brief Selects flux kernels specialised at compile time for the reconstruction method,
+//! so that no switch over reconstruction methods is needed inside kernels.  Only methods
+//! enabled with Athena_RECONSTRUCTION in CMakeLists.txt are instantiated.
+
+template <MHD_RSolver rsolver_method_>
+void MHD::CalculateFluxes(Driver *pdriver, int stage) {
+  switch (recon_method) {
+#if RECON_DC_ENABLED
+    case ReconstructionMethod::dc:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::dc>(pdriver, stage);
+      break;
+#endif
+#if RECON_PLM_ENABLED
+    case ReconstructionMethod::plm:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::plm>(pdriver, stage);
+      break;
+#endif
+#if RECON_PPM4_ENABLED
+    case ReconstructionMethod::ppm4:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::ppm4>(pdriver, stage);
+      break;
+#endif
+#if RECON_PPMX_ENABLED
+    case ReconstructionMethod::ppmx:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::ppmx>(pdriver, stage);
+      break;
+#endif
+#if RECON_WENOZ_ENABLED
+    case ReconstructionMethod::wenoz:
+      CalculateFluxesRecon<rsolver_method_, ReconstructionMethod::wenoz>(pdriver, stage);
+      break;
+#endif
+    default:
+      break;
+  }
+  return;
+}
+
 // function definitions for each template parameter
 template void MHD::CalculateFluxes<MHD_RSolver::advect>(Driver *pdriver, int stage);
 template void MHD::CalculateFluxes<MHD_RSolver::llf>(Driver *pdriver, int stage);
@@ -55,6 +55,14 @@ void MHD::FOFC(Driver *pdriver, int stage) {
     Real &gam1 = pdriver->gam1[stage-1];
     Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
 
+    // estimates of updated conserved variables and fields are only needed in this
+    // function, so they are stored in slots 0 and 1 of the MeshBlockPack scratch arena
+    int ncells1 = nx1 + 2*(indcs.ng);
+    int ncells2 = (nx2 > 1)? (nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (nx3 > 1)? (nx3 + 2*(indcs.ng)) : 1;
+    utest = pmy_pack->scratch.Get5D(0, nmb, nmhd, ncells3, ncells2, ncells1);
+    bcctest = pmy_pack->scratch.Get5D(1, nmb, 3, ncells3, ncells2, ncells1);
+
     int &nmhd_ = nmhd;
     auto &u0_ = u0;
     auto &u1_ = u1;
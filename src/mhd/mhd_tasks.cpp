@@ -38,47 +38,91 @@ void MHD::AssembleMHDTasks(std::map<std::string, std::shared_ptr<TaskList>> tl)
   TaskID none(0);
 
   // assemble "before_timeintegrator" task list
-  id.savest = tl["before_timeintegrator"]->AddTask(&MHD::SaveMHDState, this, none);
+  id.savest = tl["before_timeintegrator"]->AddTask(&MHD::SaveMHDState, this, none,
+                                                   "MHD::SaveMHDState");
 
   // assemble "before_stagen" task list
-  id.irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, this, none);
+  id.irecv = tl["before_stagen"]->AddTask(&MHD::InitRecv, this, none, "MHD::InitRecv");
 
   // assemble "stagen" task list
-  id.copyu     = tl["stagen"]->AddTask(&MHD::CopyCons, this, none);
-  id.flux      = tl["stagen"]->AddTask(&MHD::Fluxes, this, id.copyu);
-  id.sendf     = tl["stagen"]->AddTask(&MHD::SendFlux, this, id.flux);
-  id.recvf     = tl["stagen"]->AddTask(&MHD::RecvFlux, this, id.sendf);
-  id.rkupdt    = tl["stagen"]->AddTask(&MHD::RKUpdate, this, id.recvf);
-  id.srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, this, id.rkupdt);
-  id.sendu_oa  = tl["stagen"]->AddTask(&MHD::SendU_OA, this, id.srctrms);
-  id.recvu_oa  = tl["stagen"]->AddTask(&MHD::RecvU_OA, this, id.sendu_oa);
-  id.restu     = tl["stagen"]->AddTask(&MHD::RestrictU, this, id.recvu_oa);
-  id.sendu     = tl["stagen"]->AddTask(&MHD::SendU, this, id.restu);
-  id.recvu     = tl["stagen"]->AddTask(&MHD::RecvU, this, id.sendu);
-  id.sendu_shr = tl["stagen"]->AddTask(&MHD::SendU_Shr, this, id.recvu);
-  id.recvu_shr = tl["stagen"]->AddTask(&MHD::RecvU_Shr, this, id.sendu_shr);
-  id.efld      = tl["stagen"]->AddTask(&MHD::CornerE, this, id.recvu_shr);
-  id.efldsrc   = tl["stagen"]->AddTask(&MHD::EFieldSrc, this, id.efld);
-  id.sende     = tl["stagen"]->AddTask(&MHD::SendE, this, id.efldsrc);
-  id.recve     = tl["stagen"]->AddTask(&MHD::RecvE, this, id.sende);
-  id.ct        = tl["stagen"]->AddTask(&MHD::CT, this, id.recve);
-  id.sendb_oa  = tl["stagen"]->AddTask(&MHD::SendB_OA, this, id.ct);
-  id.recvb_oa  = tl["stagen"]->AddTask(&MHD::RecvB_OA, this, id.sendb_oa);
-  id.restb     = tl["stagen"]->AddTask(&MHD::RestrictB, this, id.recvb_oa);
-  id.sendb     = tl["stagen"]->AddTask(&MHD::SendB, this, id.restb);
-  id.recvb     = tl["stagen"]->AddTask(&MHD::RecvB, this, id.sendb);
-  id.sendb_shr = tl["stagen"]->AddTask(&MHD::SendB_Shr, this, id.recvb);
-  id.recvb_shr = tl["stagen"]->AddTask(&MHD::RecvB_Shr, this, id.sendb_shr);
-  id.bcs       = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, this, id.recvb_shr);
-  id.prol      = tl["stagen"]->AddTask(&MHD::Prolongate, this, id.bcs);
-  id.c2p       = tl["stagen"]->AddTask(&MHD::ConToPrim, this, id.prol);
-  id.newdt     = tl["stagen"]->AddTask(&MHD::NewTimeStep, this, id.c2p);
+  id.copyu     = tl["stagen"]->AddTask(&MHD::CopyCons, this, none, "MHD::CopyCons");
+  id.flux      = tl["stagen"]->AddTask(&MHD::Fluxes, this, id.copyu, "MHD::Fluxes");
+  id.sendf     = tl["stagen"]->AddTask(&MHD::SendFlux, this, id.flux, "MHD::SendFlux");
+  id.recvf     = tl["stagen"]->AddTask(&MHD::RecvFlux, this, id.sendf, "MHD::RecvFlux");
+  id.rkupdt    = tl["stagen"]->AddTask(&MHD::RKUpdate, this, id.recvf, "MHD::RKUpdate");
+  id.srctrms   = tl["stagen"]->AddTask(&MHD::MHDSrcTerms, this, id.rkupdt,
+                                       "MHD::MHDSrcTerms");
+  id.sendu_oa  = tl["stagen"]->AddTask(&MHD::SendU_OA, this, id.srctrms, "MHD::SendU_OA");
+  id.recvu_oa  = tl["stagen"]->AddTask(&MHD::RecvU_OA, this, id.sendu_oa,
+                                       "MHD::RecvU_OA");
+  id.restu     = tl["stagen"]->AddTask(&MHD::RestrictU, this, id.recvu_oa,
+                                       "MHD::RestrictU");
+  id.sendu     = tl["stagen"]->AddTask(&MHD::SendU, this, id.restu, "MHD::SendU");
+  if (split_c2p) {
+    // EMFs, CT, and C2P in active cells do not depend on ghost zones of U, so they
+    // overlap with communication of U. Only ghost zones are converted once received.
+    id.efld      = tl["stagen"]->AddTask(&MHD::CornerE, this, id.sendu, "MHD::CornerE");
+    id.efldsrc   = tl["stagen"]->AddTask(&MHD::EFieldSrc, this, id.efld,
+                                         "MHD::EFieldSrc");
+    id.sende     = tl["stagen"]->AddTask(&MHD::SendE, this, id.efldsrc, "MHD::SendE");
+    id.recve     = tl["stagen"]->AddTask(&MHD::RecvE, this, id.sende, "MHD::RecvE");
+    id.ct        = tl["stagen"]->AddTask(&MHD::CT, this, id.recve, "MHD::CT");
+    id.sendb_oa  = tl["stagen"]->AddTask(&MHD::SendB_OA, this, id.ct, "MHD::SendB_OA");
+    id.recvb_oa  = tl["stagen"]->AddTask(&MHD::RecvB_OA, this, id.sendb_oa,
+                                         "MHD::RecvB_OA");
+    id.restb     = tl["stagen"]->AddTask(&MHD::RestrictB, this, id.recvb_oa,
+                                         "MHD::RestrictB");
+    id.sendb     = tl["stagen"]->AddTask(&MHD::SendB, this, id.restb, "MHD::SendB");
+    id.c2pa      = tl["stagen"]->AddTask(&MHD::ConToPrimActive, this, id.sendb,
+                                         "MHD::ConToPrimActive");
+    id.recvu     = tl["stagen"]->AddTask(&MHD::RecvU, this, id.c2pa, "MHD::RecvU");
+    id.sendu_shr = tl["stagen"]->AddTask(&MHD::SendU_Shr, this, id.recvu,
+                                         "MHD::SendU_Shr");
+    id.recvu_shr = tl["stagen"]->AddTask(&MHD::RecvU_Shr, this, id.sendu_shr,
+                                         "MHD::RecvU_Shr");
+    id.recvb     = tl["stagen"]->AddTask(&MHD::RecvB, this, id.recvu_shr, "MHD::RecvB");
+  } else {
+    id.recvu     = tl["stagen"]->AddTask(&MHD::RecvU, this, id.sendu, "MHD::RecvU");
+    id.sendu_shr = tl["stagen"]->AddTask(&MHD::SendU_Shr, this, id.recvu,
+                                         "MHD::SendU_Shr");
+    id.recvu_shr = tl["stagen"]->AddTask(&MHD::RecvU_Shr, this, id.sendu_shr,
+                                         "MHD::RecvU_Shr");
+    id.efld      = tl["stagen"]->AddTask(&MHD::CornerE, this, id.recvu_shr,
+                                         "MHD::CornerE");
+    id.efldsrc   = tl["stagen"]->AddTask(&MHD::EFieldSrc, this, id.efld,
+                                         "MHD::EFieldSrc");
+    id.sende     = tl["stagen"]->AddTask(&MHD::SendE, this, id.efldsrc, "MHD::SendE");
+    id.recve     = tl["stagen"]->AddTask(&MHD::RecvE, this, id.sende, "MHD::RecvE");
+    id.ct        = tl["stagen"]->AddTask(&MHD::CT, this, id.recve, "MHD::CT");
+    id.sendb_oa  = tl["stagen"]->AddTask(&MHD::SendB_OA, this, id.ct, "MHD::SendB_OA");
+    id.recvb_oa  = tl["stagen"]->AddTask(&MHD::RecvB_OA, this, id.sendb_oa,
+                                         "MHD::RecvB_OA");
+    id.restb     = tl["stagen"]->AddTask(&MHD::RestrictB, this, id.recvb_oa,
+                                         "MHD::RestrictB");
+    id.sendb     = tl["stagen"]->AddTask(&MHD::SendB, this, id.restb, "MHD::SendB");
+    id.recvb     = tl["stagen"]->AddTask(&MHD::RecvB, this, id.sendb, "MHD::RecvB");
+  }
+  id.sendb_shr = tl["stagen"]->AddTask(&MHD::SendB_Shr, this, id.recvb, "MHD::SendB_Shr");
+  id.recvb_shr = tl["stagen"]->AddTask(&MHD::RecvB_Shr, this, id.sendb_shr,
+                                       "MHD::RecvB_Shr");
+  id.bcs       = tl["stagen"]->AddTask(&MHD::ApplyPhysicalBCs, this, id.recvb_shr,
+                                       "MHD::ApplyPhysicalBCs");
+  id.prol      = tl["stagen"]->AddTask(&MHD::Prolongate, this, id.bcs, "MHD::Prolongate");
+  if (split_c2p) {
+    id.c2p     = tl["stagen"]->AddTask(&MHD::ConToPrimGhost, this, id.prol,
+                                       "MHD::ConToPrimGhost");
+  } else {
+    id.c2p     = tl["stagen"]->AddTask(&MHD::ConToPrim, this, id.prol, "MHD::ConToPrim");
+  }
+  id.newdt     = tl["stagen"]->AddTask(&MHD::NewTimeStep, this, id.c2p,
+                                       "MHD::NewTimeStep");
 
   // assemble "after_stagen" task list
-  id.csend = tl["after_stagen"]->AddTask(&MHD::ClearSend, this, none);
+  id.csend = tl["after_stagen"]->AddTask(&MHD::ClearSend, this, none, "MHD::ClearSend");
   // although RecvFlux/U/E/B functions check that all recvs complete, add ClearRecv to
   // task list anyways to catch potential bugs in MPI communication logic
-  id.crecv = tl["after_stagen"]->AddTask(&MHD::ClearRecv, this, id.csend);
+  id.crecv = tl["after_stagen"]->AddTask(&MHD::ClearRecv, this, id.csend,
+                                         "MHD::ClearRecv");
 
   return;
 }
@@ -104,12 +148,21 @@ TaskStatus MHD::SaveMHDState(Driver *pdrive, int stage) {
 //! face-centered fields AND their fluxes (with SMR/AMR).
 
 TaskStatus MHD::InitRecv(Driver *pdrive, int stage) {
-  // post receives for U
-  TaskStatus tstat = pbval_u->InitRecv(nmhd+nscalars);
-  if (tstat != TaskStatus::complete) return tstat;
+  // with fixed U and B, skip their exchange in this stage if they have not changed since
+  // they were last exchanged.  The same on all ranks, since versions change together.
+  skip_halo = fixed_fields && (stage >= 0) && pbval_u->VarsExchanged() &&
+              pbval_b->VarsExchanged();
+  // post receives for U, unless U is received with radiation intensities
+  TaskStatus tstat = TaskStatus::complete;
+  if ((!(coalesced_u) || (stage < 0)) && !(skip_halo)) {
+    tstat = pbval_u->InitRecv(nmhd+nscalars);
+    if (tstat != TaskStatus::complete) return tstat;
+  }
   // post receives for B
-  tstat = pbval_b->InitRecv(3);
-  if (tstat != TaskStatus::complete) return tstat;
+  if (!(skip_halo)) {
+    tstat = pbval_b->InitRecv(3);
+    if (tstat != TaskStatus::complete) return tstat;
+  }
 
   // with SMR/AMR post receives for fluxes of U, always post receives for fluxes of B
   // do not post receives for fluxes when stage < 0 (i.e. ICs)
@@ -128,9 +181,9 @@ TaskStatus MHD::InitRecv(Driver *pdrive, int stage) {
   // only execute when (shearing box defined) AND (last stage) AND (3D OR 2d_r_phi)
   if ((psrc->shearing_box) && (stage == pdrive->nexp_stages) &&
       (pmy_pack->pmesh->three_d || psrc->shearing_box_r_phi)) {
-    tstat = porb_u->InitRecv();
+    tstat = porb_u->InitRecv((psrc->qshear)*(psrc->omega0));
     if (tstat != TaskStatus::complete) return tstat;
-    tstat = porb_b->InitRecv();
+    tstat = porb_b->InitRecv((psrc->qshear)*(psrc->omega0));
     if (tstat != TaskStatus::complete) return tstat;
   }
 
@@ -154,14 +207,38 @@ TaskStatus MHD::InitRecv(Driver *pdrive, int stage) {
 
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::CopyCons
-//! \brief Simple task list function that copies u0 --> u1, and b0 --> b1 in first stage
+//! \brief Simple task list function that copies u0 --> u1, and b0 --> b1 in first stage.
+//! At later stages of low-storage (2S) integrators, updates u1 and b1 with u0 and b0.
 
 TaskStatus MHD::CopyCons(Driver *pdrive, int stage) {
+  if (fixed_fields) {return TaskStatus::complete;}
   if (stage == 1) {
     Kokkos::deep_copy(DevExeSpace(), u1, u0);
     Kokkos::deep_copy(DevExeSpace(), b1.x1f, b0.x1f);
     Kokkos::deep_copy(DevExeSpace(), b1.x2f, b0.x2f);
     Kokkos::deep_copy(DevExeSpace(), b1.x3f, b0.x3f);
+  } else if (pdrive->low_storage && pdrive->delta[stage-1] != 0.0) {
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    int is = indcs.is, ie = indcs.ie;
+    int js = indcs.js, je = indcs.je;
+    int ks = indcs.ks, ke = indcs.ke;
+    int nmb1 = pmy_pack->nmb_thispack - 1;
+    int nvar = nmhd + nscalars;
+    auto &u0_ = u0;
+    auto &u1_ = u1;
+    Real delta = pdrive->delta[stage-1];
+    par_for("mhd_copy_cons_2s", DevExeSpace(),0, nmb1, 0, nvar-1, ks, ke, js, je, is, ie,
+    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      u1_(m,n,k,j,i) += delta*u0_(m,n,k,j,i);
+    });
+    auto &b0_ = b0;
+    auto &b1_ = b1;
+    par_for("mhd_copy_b_2s", DevExeSpace(),0, nmb1, ks, ke+1, js, je+1, is, ie+1,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      if (i <= ie && j <= je) {b1_.x3f(m,k,j,i) += delta*b0_.x3f(m,k,j,i);}
+      if (i <= ie && k <= ke) {b1_.x2f(m,k,j,i) += delta*b0_.x2f(m,k,j,i);}
+      if (j <= je && k <= ke) {b1_.x1f(m,k,j,i) += delta*b0_.x1f(m,k,j,i);}
+    });
   }
   return TaskStatus::complete;
 }
@@ -199,7 +276,7 @@ TaskStatus MHD::Fluxes(Driver *pdrive, int stage) {
     presist->OhmicEnergyFlux(b0, uflx);
   }
   if (pcond != nullptr) {
-    pcond->AddHeatFlux(w0, peos->eos_data, uflx);
+    pcond->AddHeatFlux(w0, bcc0, peos->eos_data, uflx);
   }
 
   // call FOFC if necessary
@@ -249,6 +326,7 @@ TaskStatus MHD::RecvFlux(Driver *pdrive, int stage) {
 //! variables (u0) have already been partially updated when this fn called.
 
 TaskStatus MHD::MHDSrcTerms(Driver *pdrive, int stage) {
+  if (fixed_fields) {return TaskStatus::complete;}
   Real beta_dt = (pdrive->beta[stage-1])*(pmy_pack->pmesh->dt);
 
   // Add source terms for various physics
@@ -269,6 +347,7 @@ TaskStatus MHD::MHDSrcTerms(Driver *pdrive, int stage) {
   if (pmy_pack->pmesh->pgen->user_srcs) {
     (pmy_pack->pmesh->pgen->user_srcs_func)(pmy_pack->pmesh, beta_dt);
   }
+  pbval_u->vars_version++;
 
   return TaskStatus::complete;
 }
@@ -307,9 +386,10 @@ TaskStatus MHD::RecvU_OA(Driver *pdrive, int stage) {
 //! \brief Wrapper task list function to restrict conserved vars
 
 TaskStatus MHD::RestrictU(Driver *pdrive, int stage) {
+  if (skip_halo) {return TaskStatus::complete;}
   // Only execute Mesh function with SMR/AMR
   if (pmy_pack->pmesh->multilevel) {
-    pmy_pack->pmesh->pmr->RestrictCC(u0, coarse_u0);
+    pmy_pack->pmesh->pmr->RestrictCCBndry(u0, coarse_u0);
   }
   return TaskStatus::complete;
 }
@@ -319,6 +399,7 @@ TaskStatus MHD::RestrictU(Driver *pdrive, int stage) {
 //! \brief Wrapper task list function to pack/send cell-centered conserved variables
 
 TaskStatus MHD::SendU(Driver *pdrive, int stage) {
+  if (skip_halo) {return TaskStatus::complete;}
   TaskStatus tstat = pbval_u->PackAndSendCC(u0, coarse_u0);
   return tstat;
 }
@@ -328,7 +409,9 @@ TaskStatus MHD::SendU(Driver *pdrive, int stage) {
 //! \brief Wrapper task list function to receive/unpack cell-centered conserved variables
 
 TaskStatus MHD::RecvU(Driver *pdrive, int stage) {
+  if (skip_halo) {return TaskStatus::complete;}
   TaskStatus tstat = pbval_u->RecvAndUnpackCC(u0, coarse_u0);
+  if (tstat == TaskStatus::complete) {pbval_u->MarkVarsExchanged();}
   return tstat;
 }
 
@@ -429,6 +512,7 @@ TaskStatus MHD::RecvB_OA(Driver *pdrive, int stage) {
 //! \brief Wrapper task list function to pack/send face-centered magnetic fields
 
 TaskStatus MHD::SendB(Driver *pdrive, int stage) {
+  if (skip_halo) {return TaskStatus::complete;}
   TaskStatus tstat = pbval_b->PackAndSendFC(b0, coarse_b0);
   return tstat;
 }
@@ -438,7 +522,9 @@ TaskStatus MHD::SendB(Driver *pdrive, int stage) {
 //! \brief Wrapper task list function to recv/unpack face-centered magnetic fields
 
 TaskStatus MHD::RecvB(Driver *pdrive, int stage) {
+  if (skip_halo) {return TaskStatus::complete;}
   TaskStatus tstat = pbval_b->RecvAndUnpackFC(b0, coarse_b0);
+  if (tstat == TaskStatus::complete) {pbval_b->MarkVarsExchanged();}
   return tstat;
 }
 
@@ -495,7 +581,8 @@ TaskStatus MHD::ApplyPhysicalBCs(Driver *pdrive, int stage) {
 //! at fine/coarse bundaries with SMR/AMR
 
 TaskStatus MHD::Prolongate(Driver *pdrive, int stage) {
-  if (pmy_pack->pmesh->multilevel) {  // only prolongate with SMR/AMR
+  // only prolongate with SMR/AMR, and if U and B were exchanged in this stage
+  if (pmy_pack->pmesh->multilevel && !(skip_halo)) {
     pbval_u->FillCoarseInBndryCC(u0, coarse_u0);
     pbval_b->FillCoarseInBndryFC(b0, coarse_b0);
     if (pmy_pack->pmesh->pmr->prolong_prims) {
@@ -525,6 +612,48 @@ TaskStatus MHD::ConToPrim(Driver *pdrive, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::ConToPrimActive
+//! \brief Wrapper task list function to call ConsToPrim over active cells only.  Used
+//! with split_c2p after CT, since active cells do not depend on ghost zones of U or B.
+//! With ct_bcc, bcc0 in active cells was already set by CT.
+
+TaskStatus MHD::ConToPrimActive(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  peos->bcc_current = ct_bcc && !(fixed_fields);
+  peos->ConsToPrim(u0, b0, w0, bcc0, false, indcs.is, indcs.ie, indcs.js, indcs.je,
+                   indcs.ks, indcs.ke);
+  peos->bcc_current = false;
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus MHD::ConToPrimGhost
+//! \brief Wrapper task list function to call ConsToPrim over ghost zones only, as up to
+//! six slabs surrounding the active cells.  Used with split_c2p after ConToPrimActive.
+
+TaskStatus MHD::ConToPrimGhost(Driver *pdrive, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &ng = indcs.ng;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int n1m1 = indcs.nx1 + 2*ng - 1;
+  int n2m1 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng - 1) : 0;
+  int n3m1 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng - 1) : 0;
+  peos->ConsToPrim(u0, b0, w0, bcc0, false, 0, is-1, 0, n2m1, 0, n3m1);
+  peos->ConsToPrim(u0, b0, w0, bcc0, false, ie+1, n1m1, 0, n2m1, 0, n3m1);
+  if (pmy_pack->pmesh->multi_d) {
+    peos->ConsToPrim(u0, b0, w0, bcc0, false, is, ie, 0, js-1, 0, n3m1);
+    peos->ConsToPrim(u0, b0, w0, bcc0, false, is, ie, je+1, n2m1, 0, n3m1);
+  }
+  if (pmy_pack->pmesh->three_d) {
+    peos->ConsToPrim(u0, b0, w0, bcc0, false, is, ie, js, je, 0, ks-1);
+    peos->ConsToPrim(u0, b0, w0, bcc0, false, is, ie, js, je, ke+1, n3m1);
+  }
+  return TaskStatus::complete;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus MHD::ClearSend
 //! \brief Wrapper task list function that checks all MPI sends have completed. Used in
@@ -536,10 +665,12 @@ TaskStatus MHD::ConToPrim(Driver *pdrive, int stage) {
 
 TaskStatus MHD::ClearSend(Driver *pdrive, int stage) {
   TaskStatus tstat;
-  if ((stage >= 0) || (stage == -1)) {
-    // check sends of U complete
-    TaskStatus tstat = pbval_u->ClearSend();
-    if (tstat != TaskStatus::complete) return tstat;
+  if (((stage >= 0) || (stage == -1)) && !(skip_halo)) {
+    // check sends of U complete, unless U is sent with radiation intensities
+    if (!(coalesced_u) || (stage == -1)) {
+      tstat = pbval_u->ClearSend();
+      if (tstat != TaskStatus::complete) return tstat;
+    }
     // check sends of B complete
     tstat = pbval_b->ClearSend();
     if (tstat != TaskStatus::complete) return tstat;
@@ -592,10 +723,12 @@ TaskStatus MHD::ClearSend(Driver *pdrive, int stage) {
 
 TaskStatus MHD::ClearRecv(Driver *pdrive, int stage) {
   TaskStatus tstat;
-  if ((stage >= 0) || (stage == -1)) {
-    // check receives of U complete
-    tstat = pbval_u->ClearRecv();
-    if (tstat != TaskStatus::complete) return tstat;
+  if (((stage >= 0) || (stage == -1)) && !(skip_halo)) {
+    // check receives of U complete, unless U is received with radiation intensities
+    if (!(coalesced_u) || (stage == -1)) {
+      tstat = pbval_u->ClearRecv();
+      if (tstat != TaskStatus::complete) return tstat;
+    }
     // check receives of B complete
     tstat = pbval_b->ClearRecv();
     if (tstat != TaskStatus::complete) return tstat;
@@ -642,9 +775,10 @@ TaskStatus MHD::ClearRecv(Driver *pdrive, int stage) {
 //! \brief Wrapper function that restricts face-centered variables (magnetic field)
 
 TaskStatus MHD::RestrictB(Driver *pdrive, int stage) {
+  if (skip_halo) {return TaskStatus::complete;}
   // Only execute Mesh function with SMR/AMR
   if (pmy_pack->pmesh->multilevel) {
-    pmy_pack->pmesh->pmr->RestrictFC(b0, coarse_b0);
+    pmy_pack->pmesh->pmr->RestrictFCBndry(b0, coarse_b0);
   }
   return TaskStatus::complete;
 }
@@ -13,7 +13,9 @@
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
 #include "eos/eos.hpp"
+#include "bvals/bvals.hpp"
 #include "mhd.hpp"
+#include "particles/particles.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
 
 namespace mhd {
@@ -22,6 +24,7 @@ namespace mhd {
 //  \brief Explicit RK update including flux divergence terms
 
 TaskStatus MHD::RKUpdate(Driver *pdriver, int stage) {
+  if (fixed_fields) {return TaskStatus::complete;}
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
@@ -33,7 +36,9 @@ TaskStatus MHD::RKUpdate(Driver *pdriver, int stage) {
   Real &gam0 = pdriver->gam0[stage-1];
   Real &gam1 = pdriver->gam1[stage-1];
   Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
-  int nmb1 = pmy_pack->nmb_thispack - 1;
+  // only loop over active MBs (see MeshBlock::SetActiveMeshBlocks())
+  int nmba1 = pmy_pack->pmb->nmb_active - 1;
+  auto &mbact = pmy_pack->pmb->mb_active;
   int nv1 = nmhd + nscalars - 1;
   auto u0_ = u0;
   auto u1_ = u1;
@@ -48,8 +53,10 @@ TaskStatus MHD::RKUpdate(Driver *pdriver, int stage) {
   int scr_level = 0;
   size_t scr_size = ScrArray1D<Real>::shmem_size(ncells1);
 
-  par_for_outer("mhd_update",DevExeSpace(),scr_size,scr_level,0,nmb1,0,nv1,ks,ke,js,je,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int j) {
+  par_for_outer("mhd_update",DevExeSpace(),scr_size,scr_level,0,nmba1,0,nv1,ks,ke,js,je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int mm, const int n, const int k,
+                const int j) {
+    const int m = mbact.d_view(mm);
     ScrArray1D<Real> divf(member.team_scratch(scr_level), ncells1);
 
     // compute dF1/dx1
@@ -80,6 +87,14 @@ TaskStatus MHD::RKUpdate(Driver *pdriver, int stage) {
       u0_(m,n,k,j,i) = gam0*u0_(m,n,k,j,i) + gam1*u1_(m,n,k,j,i) - beta_dt*divf(i);
     });
   });
+  // Monte Carlo tracers are moved by the mass fluxes of the last stage, while they are
+  // still in uflx
+  auto ppart = pmy_pack->ppart;
+  if (ppart != nullptr && ppart->pusher == particles::ParticlesPusher::lagrangian_mc &&
+      stage == pdriver->nexp_stages) {
+    ppart->MonteCarloTracers(uflx, u0, pmy_pack->pmesh->dt);
+  }
+  pbval_u->vars_version++;
   return TaskStatus::complete;
 }
 } // namespace mhd
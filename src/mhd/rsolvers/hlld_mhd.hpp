@@ -16,6 +16,41 @@ namespace mhd {
 
 #define HLLD_SMALL_NUMBER 1.0e-4
 
+//----------------------------------------------------------------------------------------
+//! \fn Real HLLDRegion()
+//! \brief Returns one component of the adiabatic HLLD flux in the wave region selected by
+//! c0=(S_L>=0), c4=(S_R<=0), c1=(S*_L>=0), c2=(S_M>=0), c3=(S*_R>0), given the L/R fluxes
+//! and the jumps across each wave.  Uses selects rather than branches, so that the same
+//! instructions execute for every cell (and the loop vectorizes with masks on CPUs), and
+//! sums in the same order as the branching version so results are identical.
+
+KOKKOS_INLINE_FUNCTION
+Real HLLDRegion(const bool c0, const bool c4, const bool c1, const bool c2, const bool c3,
+                const Real fl, const Real fr, const Real ulst, const Real uldst,
+                const Real urst, const Real urdst) {
+  Real fls = fl + ulst;
+  Real frs = fr + urst;
+  Real f = (c3)? (frs + urdst) : frs;
+  f = (c2)? (fls + uldst) : f;
+  f = (c1)? fls : f;
+  f = (c4)? fr : f;
+  return (c0)? fl : f;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real HLLDIsoRegion()
+//! \brief Isothermal version of HLLDRegion(), given fluxes in each of the five regions.
+
+KOKKOS_INLINE_FUNCTION
+Real HLLDIsoRegion(const bool c0, const bool c4, const bool c1, const bool c3,
+                   const Real fl, const Real fr, const Real fls, const Real frs,
+                   const Real fcst) {
+  Real f = (c3)? frs : fcst;
+  f = (c1)? fls : f;
+  f = (c4)? fr : f;
+  return (c0)? fl : f;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn
 
@@ -30,13 +65,14 @@ void HLLD(TeamMember_t const &member, const EOS_Data &eos,
   int ivz = IVX + ((ivx-IVX)+2)%3;
   int iby = ((ivx-IVX) + 1)%3;
   int ibz = ((ivx-IVX) + 2)%3;
-  Real spd[5];         // signal speeds, left to right
 
   //------------------------ ADIABATIC HLLD solver ---------------------------------------
   if (eos.is_ideal) {
     Real gm1 = eos.gamma - 1.0;
     Real igm1 = 1.0/gm1;
     par_for_inner(member, il, iu, [&](const int i) {
+      Real spd[5];         // signal speeds, left to right
+
       //--- Step 1.  Create local references for L/R states (helps compiler vectorize)
 
       Real &wl_idn=wl(IDN,i);
@@ -289,7 +325,25 @@ void HLLD(TeamMember_t const &member, const EOS_Data &eos,
       urst.by = spd[4] * (urst.by - ur.by);
       urst.bz = spd[4] * (urst.bz - ur.bz);
 
-      if (spd[0] >= 0.0) {
+      if (eos.masked_rs) {
+        // select flux in same order as below, without branches
+        const bool c0 = (spd[0] >= 0.0), c4 = (spd[4] <= 0.0), c1 = (spd[1] >= 0.0);
+        const bool c2 = (spd[2] >= 0.0), c3 = (spd[3] > 0.0);
+        flxi.d  = HLLDRegion(c0,c4,c1,c2,c3, fl.d,  fr.d,  ulst.d,  uldst.d,  urst.d,
+                             urdst.d);
+        flxi.mx = HLLDRegion(c0,c4,c1,c2,c3, fl.mx, fr.mx, ulst.mx, uldst.mx, urst.mx,
+                             urdst.mx);
+        flxi.my = HLLDRegion(c0,c4,c1,c2,c3, fl.my, fr.my, ulst.my, uldst.my, urst.my,
+                             urdst.my);
+        flxi.mz = HLLDRegion(c0,c4,c1,c2,c3, fl.mz, fr.mz, ulst.mz, uldst.mz, urst.mz,
+                             urdst.mz);
+        flxi.e  = HLLDRegion(c0,c4,c1,c2,c3, fl.e,  fr.e,  ulst.e,  uldst.e,  urst.e,
+                             urdst.e);
+        flxi.by = HLLDRegion(c0,c4,c1,c2,c3, fl.by, fr.by, ulst.by, uldst.by, urst.by,
+                             urdst.by);
+        flxi.bz = HLLDRegion(c0,c4,c1,c2,c3, fl.bz, fr.bz, ulst.bz, uldst.bz, urst.bz,
+                             urdst.bz);
+      } else if (spd[0] >= 0.0) {
         // return Fl if flow is supersonic
         flxi.d = fl.d;
         flxi.mx = fl.mx;
@@ -359,6 +413,8 @@ void HLLD(TeamMember_t const &member, const EOS_Data &eos,
     auto &dfloor_ = eos.dfloor;
     Real iso_cs = eos.iso_cs;
     par_for_inner(member, il, iu, [&](const int i) {
+      Real spd[5];         // signal speeds, left to right
+
       //--- Step 1.  Load L/R states into local variables
 
       Real &wl_idn=wl(IDN,i);
@@ -504,7 +560,33 @@ void HLLD(TeamMember_t const &member, const EOS_Data &eos,
 
       //--- Step 6.  Compute flux
 
-      if (spd[0] >= 0.0) {
+      if (eos.masked_rs) {
+        // select flux in same order as below, without branches
+        const bool c0 = (spd[0] >= 0.0), c4 = (spd[4] <= 0.0), c1 = (spd[1] >= 0.0);
+        const bool c3 = (spd[3] <= 0.0);
+        flxi.d  = HLLDIsoRegion(c0,c4,c1,c3, fl.d,  fr.d,
+                                fl.d  + spd[0]*(ulst.d  - ul.d),
+                                fr.d  + spd[4]*(urst.d  - ur.d),  dhll*ustar);
+        flxi.mx = HLLDIsoRegion(c0,c4,c1,c3, fl.mx, fr.mx,
+                                fl.mx + spd[0]*(ulst.mx - ul.mx),
+                                fr.mx + spd[4]*(urst.mx - ur.mx), fmxhll);
+        flxi.my = HLLDIsoRegion(c0,c4,c1,c3, fl.my, fr.my,
+                                fl.my + spd[0]*(ulst.my - ul.my),
+                                fr.my + spd[4]*(urst.my - ur.my),
+                                ucst.my*ustar - bxi*ucst.by);
+        flxi.mz = HLLDIsoRegion(c0,c4,c1,c3, fl.mz, fr.mz,
+                                fl.mz + spd[0]*(ulst.mz - ul.mz),
+                                fr.mz + spd[4]*(urst.mz - ur.mz),
+                                ucst.mz*ustar - bxi*ucst.bz);
+        flxi.by = HLLDIsoRegion(c0,c4,c1,c3, fl.by, fr.by,
+                                fl.by + spd[0]*(ulst.by - ul.by),
+                                fr.by + spd[4]*(urst.by - ur.by),
+                                ucst.by*ustar - bxi*ucst.my/ucst.d);
+        flxi.bz = HLLDIsoRegion(c0,c4,c1,c3, fl.bz, fr.bz,
+                                fl.bz + spd[0]*(ulst.bz - ul.bz),
+                                fr.bz + spd[4]*(urst.bz - ur.bz),
+                                ucst.bz*ustar - bxi*ucst.mz/ucst.d);
+      } else if (spd[0] >= 0.0) {
         // return Fl if flow is supersonic, eqn. (38a) of Mignone
         flxi.d  = fl.d;
         flxi.mx = fl.mx;
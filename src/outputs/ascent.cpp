@@ -0,0 +1,184 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file ascent.cpp
+//! \brief in-situ visualization and analysis with Ascent.  At each output time the
+//! variables selected in the <output> block are published to Ascent as a Conduit mesh
+//! blueprint, with one uniform domain (including ghost zones, which are flagged by the
+//! "ascent_ghosts" field) per MeshBlock.  Fields are passed zero-copy as external
+//! pointers into the device arrays (u0, w0, bcc0, or derived variables), so with a GPU
+//! build of Ascent images and extracts are generated on the device without host staging.
+//!
+//! Scenes, pipelines, and extracts are defined by the Ascent actions file, set by
+//! actions_file in the <output> block (default "ascent_actions.yaml").  Outputs are made
+//! on the usual dt/dcycle schedule, for example:
+//!   <output5>
+//!   file_type    = ascent
+//!   variable     = hydro_w
+//!   dt           = 0.01
+//!   actions_file = slices.yaml
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+#if ASCENT_OUTPUT_ENABLED
+
+#include <ascent.hpp>
+#include <conduit.hpp>
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor, and opens Ascent
+
+AscentOutput::AscentOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+  conduit::Node opts;
+  opts["actions_file"] = pin->GetOrAddString(op.block_name, "actions_file",
+                                             "ascent_actions.yaml");
+  opts["exceptions"] = "forward";
+#if MPI_PARALLEL_ENABLED
+  opts["mpi_comm"] = MPI_Comm_c2f(MPI_COMM_WORLD);
+#endif
+#if defined(KOKKOS_ENABLE_CUDA)
+  opts["runtime/vtkm/backend"] = "cuda";
+#elif defined(KOKKOS_ENABLE_OPENMP)
+  opts["runtime/vtkm/backend"] = "openmp";
+#else
+  opts["runtime/vtkm/backend"] = "serial";
+#endif
+  pascent_ = new ascent::Ascent();
+  pascent_->open(opts);
+
+  // flag ghost cells, which are the same on every MeshBlock
+  auto &indcs = pm->mb_indcs;
+  int n1 = indcs.nx1 + 2*indcs.ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*indcs.ng) : 1;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  Kokkos::realloc(ghosts_, n3, n2, n1);
+  auto &ghosts = ghosts_;
+  par_for("ascent_ghosts", DevExeSpace(), 0, (n3-1), 0, (n2-1), 0, (n1-1),
+  KOKKOS_LAMBDA(int k, int j, int i) {
+    ghosts(k,j,i) = (i < is || i > ie || j < js || j > je || k < ks || k > ke)? 1 : 0;
+  });
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor: closes Ascent
+
+AscentOutput::~AscentOutput() {
+  if (pascent_ != nullptr) {
+    pascent_->close();
+    delete pascent_;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void AscentOutput::LoadOutputData(Mesh *pm)
+//! \brief Data are used in place on the device, so only derived variables are computed.
+
+void AscentOutput::LoadOutputData(Mesh *pm) {
+  out_time = pm->time;
+  out_cycle = pm->ncycle;
+  if (out_params.contains_derived) {
+    ComputeDerivedVariable(out_params.variable, pm);
+  }
+  // ensure all kernels writing to output variables have completed
+  Kokkos::fence();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void AscentOutput::WriteOutputFile(Mesh *pm)
+//! \brief Publishes one blueprint domain per MeshBlock, then executes the actions read
+//! from actions_file.
+
+void AscentOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  auto &indcs = pm->mb_indcs;
+  int &ng = indcs.ng;
+  int n1 = indcs.nx1 + 2*ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*ng) : 1;
+  int ncells = n1*n2*n3;
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  auto &gids = pm->pmb_pack->pmb->mb_gid;
+
+  conduit::Node mesh;
+  for (int m=0; m<(pm->pmb_pack->nmb_thispack); ++m) {
+    char dname[20];
+    std::snprintf(dname, sizeof(dname), "domain_%07d", gids.h_view(m));
+    conduit::Node &dom = mesh[dname];
+    dom["state/cycle"] = out_cycle;
+    dom["state/time"] = static_cast<double>(out_time);
+    dom["state/domain_id"] = gids.h_view(m);
+
+    // uniform coordinates of cell faces, including ghost zones
+    dom["coordsets/coords/type"] = "uniform";
+    dom["coordsets/coords/dims/i"] = n1 + 1;
+    dom["coordsets/coords/origin/x"] =
+        static_cast<double>(size.h_view(m).x1min - ng*size.h_view(m).dx1);
+    dom["coordsets/coords/spacing/dx"] = static_cast<double>(size.h_view(m).dx1);
+    if (pm->multi_d) {
+      dom["coordsets/coords/dims/j"] = n2 + 1;
+      dom["coordsets/coords/origin/y"] =
+          static_cast<double>(size.h_view(m).x2min - ng*size.h_view(m).dx2);
+      dom["coordsets/coords/spacing/dy"] = static_cast<double>(size.h_view(m).dx2);
+    }
+    if (pm->three_d) {
+      dom["coordsets/coords/dims/k"] = n3 + 1;
+      dom["coordsets/coords/origin/z"] =
+          static_cast<double>(size.h_view(m).x3min - ng*size.h_view(m).dx3);
+      dom["coordsets/coords/spacing/dz"] = static_cast<double>(size.h_view(m).dx3);
+    }
+    dom["topologies/mesh/type"] = "uniform";
+    dom["topologies/mesh/coordset"] = "coords";
+
+    // fields point directly into (m,n) slices of device arrays, which are contiguous
+    for (auto &var : outvars) {
+      conduit::Node &fld = dom["fields/" + var.label];
+      fld["association"] = "element";
+      fld["topology"] = "mesh";
+      auto &data = *(var.data_ptr);
+      fld["values"].set_external(data.data() + (m*data.extent(1) + var.data_index)*ncells,
+                                 ncells);
+    }
+    conduit::Node &gfld = dom["fields/ascent_ghosts"];
+    gfld["association"] = "element";
+    gfld["topology"] = "mesh";
+    gfld["values"].set_external(ghosts_.data(), ncells);
+  }
+
+  try {
+    pascent_->publish(mesh);
+    conduit::Node actions;  // empty, so actions in actions_file are executed
+    pascent_->execute(actions);
+  } catch (conduit::Error &e) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Ascent failed for output block '" << out_params.block_name
+        << "': " << e.message() << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = out_time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
+
+#endif // ASCENT_OUTPUT_ENABLED
@@ -0,0 +1,349 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file athdf.cpp
+//! \brief writes output data in the "athdf" HDF5 format of Athena++, so files can be read
+//! directly by yt and vis/python/athena_read.py without first converting binary outputs
+//! with make_athdf.py.  The layout is identical to that written by bin_convert.py.  With
+//! MPI, all ranks write their MeshBlocks into one file using parallel HDF5.
+//!
+//! Variable datasets are chunked by MeshBlock, and can be compressed with the lossless
+//! shuffle+deflate filters by setting compression_level=1...9 in the <output> block.
+//! Compressed datasets are written with collective MPI-IO, which requires HDF5 >= 1.10.2.
+
+#include <sys/stat.h>  // mkdir
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+#if HDF5_OUTPUT_ENABLED
+
+#include <hdf5.h>
+
+#if SINGLE_PRECISION_ENABLED
+#define H5T_NATIVE_REAL H5T_NATIVE_FLOAT
+#else
+#define H5T_NATIVE_REAL H5T_NATIVE_DOUBLE
+#endif
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void WriteAttribute()
+//! \brief writes a 1D array attribute of n elements of given type to root group
+
+void WriteAttribute(hid_t file, const char *name, hid_t type, int n, const void *data) {
+  hsize_t dims = n;
+  hid_t space = H5Screate_simple(1, &dims, nullptr);
+  hid_t attr = H5Acreate2(file, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(attr, type, data);
+  H5Aclose(attr);
+  H5Sclose(space);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteStringAttribute()
+//! \brief writes an array of fixed length strings (or a scalar string if scalar=true) as
+//! attribute of root group, with length of strings set by the longest entry
+
+void WriteStringAttribute(hid_t file, const char *name,
+                          const std::vector<std::string> &strs, bool scalar=false) {
+  std::size_t len = 1;
+  for (auto &s : strs) {len = std::max(len, s.size());}
+  std::vector<char> buf(len*strs.size(), '\0');
+  for (std::size_t n=0; n<strs.size(); ++n) {
+    std::memcpy(&buf[n*len], strs[n].c_str(), strs[n].size());
+  }
+  hid_t type = H5Tcopy(H5T_C_S1);
+  H5Tset_size(type, len);
+  H5Tset_strpad(type, H5T_STR_NULLPAD);
+  hsize_t dims = strs.size();
+  hid_t space = scalar ? H5Screate(H5S_SCALAR) : H5Screate_simple(1, &dims, nullptr);
+  hid_t attr = H5Acreate2(file, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(attr, type, buf.data());
+  H5Aclose(attr);
+  H5Sclose(space);
+  H5Tclose(type);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteDataset()
+//! \brief creates dataset of rank ndim with global dimensions gdims, and writes local
+//! data of type mtype with dimensions ldims at offset moff in dimension dim_mb.  Every
+//! rank must call this function, even if it has no data.  Passing chunk!=nullptr chunks
+//! the dataset, and compression_level>0 adds shuffle+deflate filters.
+
+void WriteDataset(hid_t file, hid_t dxpl, const char *name, hid_t ftype, hid_t mtype,
+                  int ndim, const hsize_t *gdims, const hsize_t *ldims, int dim_mb,
+                  hsize_t moff, const void *data, const hsize_t *chunk,
+                  int compression_level) {
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  if (chunk != nullptr) {
+    H5Pset_chunk(dcpl, ndim, chunk);
+    if (compression_level > 0) {
+      H5Pset_shuffle(dcpl);
+      H5Pset_deflate(dcpl, compression_level);
+    }
+  }
+  hid_t fspace = H5Screate_simple(ndim, gdims, nullptr);
+  hid_t dset = H5Dcreate2(file, name, ftype, fspace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+
+  hid_t mspace = H5Screate_simple(ndim, ldims, nullptr);
+  if (ldims[dim_mb] > 0) {
+    std::vector<hsize_t> start(ndim, 0);
+    start[dim_mb] = moff;
+    H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start.data(), nullptr, ldims, nullptr);
+  } else {
+    H5Sselect_none(fspace);
+    H5Sselect_none(mspace);
+  }
+  H5Dwrite(dset, mtype, mspace, fspace, dxpl, data);
+
+  H5Sclose(mspace);
+  H5Dclose(dset);
+  H5Sclose(fspace);
+  H5Pclose(dcpl);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+MeshHDF5Output::MeshHDF5Output(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+  mkdir("athdf",0775);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshHDF5Output:::WriteOutputFile(Mesh *pm)
+//! \brief Writes all output MeshBlocks to one HDF5 file in athdf format.  Cell-centered
+//! magnetic fields (bcc1,bcc2,bcc3) are written to the "B" dataset, all other variables
+//! to the "uov" dataset, each with dims (nvar, nmb, nx3, nx2, nx1) in single precision.
+
+void MeshHDF5Output::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  // create filename: "athdf/file_basename" + "." + "file_id" + "." + XXXXX + ".athdf"
+  // where XXXXX = 5-digit file_number
+  std::string fname;
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+
+  fname.assign("athdf/");
+  fname.append(out_params.file_basename);
+  fname.append(".");
+  fname.append(out_params.file_id);
+  fname.append(".");
+  fname.append(number);
+  fname.append(".athdf");
+
+  // number of output MBs on this rank, total and offset of MBs on this rank in file
+  int nout_vars = outvars.size();
+  int nout_mbs = outmbs.size();
+  int nmb_total = std::accumulate(noutmbs.begin(), noutmbs.end(), 0);
+  int mb_offset = std::accumulate(noutmbs.begin(),
+                                  noutmbs.begin() + global_variable::my_rank, 0);
+  // number of cells output in each direction is same on every MB (and every rank with
+  // output MBs)
+  auto &indcs = pm->mb_indcs;
+  int nout1 = 0, nout2 = 0, nout3 = 0;
+  if (nout_mbs > 0) {
+    nout1 = outmbs[0].oie - outmbs[0].ois + 1;
+    nout2 = outmbs[0].oje - outmbs[0].ojs + 1;
+    nout3 = outmbs[0].oke - outmbs[0].oks + 1;
+  }
+#if MPI_PARALLEL_ENABLED
+  int nout[3] = {nout1, nout2, nout3};
+  MPI_Allreduce(MPI_IN_PLACE, nout, 3, MPI_INT, MPI_MAX, io_comm);
+  nout1 = nout[0]; nout2 = nout[1]; nout3 = nout[2];
+#endif
+  int cells = nout1*nout2*nout3;
+
+  // separate cell-centered magnetic field from other variables, keeping variable order
+  std::vector<int> uov_vars, b_vars;
+  for (int n=0; n<nout_vars; ++n) {
+    if (outvars[n].label.find("bcc") != std::string::npos) {
+      b_vars.push_back(n);
+    } else {
+      uov_vars.push_back(n);
+    }
+  }
+
+  // open file, using MPI-IO over io_comm with parallel HDF5
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+  // header (input file) may exceed 64 KiB limit of compact attribute storage
+  H5Pset_libver_bounds(fapl, H5F_LIBVER_V18, H5F_LIBVER_LATEST);
+#if MPI_PARALLEL_ENABLED
+  H5Pset_fapl_mpio(fapl, io_comm, MPI_INFO_NULL);
+  H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+#endif
+  hid_t file = H5Fcreate(fname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  if (file < 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Attributes.  Identical on all ranks, and written collectively.
+  {
+    std::vector<std::string> header;
+    std::stringstream ost;
+    pin->ParameterDump(ost);
+    std::string line;
+    while (std::getline(ost, line)) {header.push_back(line);}
+    WriteStringAttribute(file, "Header", header);
+  }
+  WriteAttribute(file, "Time", H5T_NATIVE_REAL, 1, &out_time);
+  WriteAttribute(file, "NumCycles", H5T_NATIVE_INT, 1, &out_cycle);
+  WriteStringAttribute(file, "Coordinates", {"cartesian"}, true);
+  WriteAttribute(file, "NumMeshBlocks", H5T_NATIVE_INT, 1, &nmb_total);
+  int max_level = pm->max_level - pm->root_level;
+  WriteAttribute(file, "MaxLevel", H5T_NATIVE_INT, 1, &max_level);
+  int mb_size[3] = {nout1, nout2, nout3};
+  WriteAttribute(file, "MeshBlockSize", H5T_NATIVE_INT, 3, mb_size);
+  int root_size[3] = {pm->mesh_indcs.nx1, pm->mesh_indcs.nx2, pm->mesh_indcs.nx3};
+  WriteAttribute(file, "RootGridSize", H5T_NATIVE_INT, 3, root_size);
+  Real root_x1[3] = {pm->mesh_size.x1min, pm->mesh_size.x1max, 1.0};
+  Real root_x2[3] = {pm->mesh_size.x2min, pm->mesh_size.x2max, 1.0};
+  Real root_x3[3] = {pm->mesh_size.x3min, pm->mesh_size.x3max, 1.0};
+  WriteAttribute(file, "RootGridX1", H5T_NATIVE_REAL, 3, root_x1);
+  WriteAttribute(file, "RootGridX2", H5T_NATIVE_REAL, 3, root_x2);
+  WriteAttribute(file, "RootGridX3", H5T_NATIVE_REAL, 3, root_x3);
+  {
+    std::vector<std::string> dset_names = {"uov"};
+    std::vector<int> dset_nvars = {static_cast<int>(uov_vars.size())};
+    if (b_vars.size() > 0) {
+      dset_names.push_back("B");
+      dset_nvars.push_back(b_vars.size());
+    }
+    std::vector<std::string> var_names;
+    for (int n : uov_vars) {var_names.push_back(outvars[n].label);}
+    for (int n : b_vars) {var_names.push_back(outvars[n].label);}
+    WriteStringAttribute(file, "DatasetNames", dset_names);
+    WriteAttribute(file, "NumVariables", H5T_NATIVE_INT, dset_nvars.size(),
+                   dset_nvars.data());
+    WriteStringAttribute(file, "VariableNames", var_names);
+  }
+
+  // Levels and logical locations of MBs
+  {
+    std::vector<int> levels(nout_mbs);
+    std::vector<int64_t> llocs(3*nout_mbs);
+    for (int m=0; m<nout_mbs; ++m) {
+      LogicalLocation loc = pm->lloc_eachmb[outmbs[m].mb_gid];
+      levels[m] = loc.level - pm->root_level;
+      llocs[3*m    ] = loc.lx1;
+      llocs[3*m + 1] = loc.lx2;
+      llocs[3*m + 2] = loc.lx3;
+    }
+    hsize_t gdims[2] = {static_cast<hsize_t>(nmb_total), 3};
+    hsize_t ldims[2] = {static_cast<hsize_t>(nout_mbs), 3};
+    WriteDataset(file, dxpl, "Levels", H5T_STD_I32BE, H5T_NATIVE_INT, 1, gdims, ldims,
+                 0, mb_offset, levels.data(), nullptr, 0);
+    WriteDataset(file, dxpl, "LogicalLocations", H5T_STD_I64BE, H5T_NATIVE_INT64, 2,
+                 gdims, ldims, 0, mb_offset, llocs.data(), nullptr, 0);
+  }
+
+  // Face and cell-center coordinates of output cells in each MB
+  {
+    int nout[3] = {nout1, nout2, nout3};
+    int nx[3] = {indcs.nx1, indcs.nx2, indcs.nx3};
+    int is[3] = {indcs.is, indcs.js, indcs.ks};
+    const char *fnames[3] = {"x1f", "x2f", "x3f"};
+    const char *vnames[3] = {"x1v", "x2v", "x3v"};
+    for (int d=0; d<3; ++d) {
+      std::vector<Real> xf(nout_mbs*(nout[d] + 1)), xv(nout_mbs*nout[d]);
+      for (int m=0; m<nout_mbs; ++m) {
+        Real xmin = (d == 0)? outmbs[m].x1min : ((d == 1)? outmbs[m].x2min :
+                                                             outmbs[m].x3min);
+        Real xmax = (d == 0)? outmbs[m].x1max : ((d == 1)? outmbs[m].x2max :
+                                                             outmbs[m].x3max);
+        int ois = (d == 0)? outmbs[m].ois : ((d == 1)? outmbs[m].ojs : outmbs[m].oks);
+        Real dx = (xmax - xmin)/static_cast<Real>(nx[d]);
+        for (int i=0; i<=nout[d]; ++i) {
+          xf[m*(nout[d] + 1) + i] = xmin + static_cast<Real>(ois + i - is[d])*dx;
+        }
+        for (int i=0; i<nout[d]; ++i) {
+          xv[m*nout[d] + i] = 0.5*(xf[m*(nout[d] + 1) + i] + xf[m*(nout[d] + 1) + i+1]);
+        }
+      }
+      hsize_t gdims[2] = {static_cast<hsize_t>(nmb_total),
+                          static_cast<hsize_t>(nout[d] + 1)};
+      hsize_t ldims[2] = {static_cast<hsize_t>(nout_mbs),
+                          static_cast<hsize_t>(nout[d] + 1)};
+      WriteDataset(file, dxpl, fnames[d], H5T_NATIVE_REAL, H5T_NATIVE_REAL, 2, gdims,
+                   ldims, 0, mb_offset, xf.data(), nullptr, 0);
+      gdims[1] -= 1;
+      ldims[1] -= 1;
+      WriteDataset(file, dxpl, vnames[d], H5T_NATIVE_REAL, H5T_NATIVE_REAL, 2, gdims,
+                   ldims, 0, mb_offset, xv.data(), nullptr, 0);
+    }
+  }
+
+  // Variables, converted to single precision and chunked by MeshBlock
+  {
+    std::vector<float> single_data;
+    const std::vector<int> *dvars[2] = {&uov_vars, &b_vars};
+    const char *dnames[2] = {"uov", "B"};
+    for (int d=0; d<2; ++d) {
+      int nvar = dvars[d]->size();
+      if (nvar == 0) {continue;}
+      single_data.resize(static_cast<std::size_t>(nvar)*nout_mbs*cells);
+      std::size_t cnt = 0;
+      for (int n : *dvars[d]) {
+        for (int m=0; m<nout_mbs; ++m) {
+          for (int k=0; k<nout3; ++k) {
+            for (int j=0; j<nout2; ++j) {
+              for (int i=0; i<nout1; ++i) {
+                single_data[cnt++] = static_cast<float>(outarray(n,m,k,j,i));
+              }
+            }
+          }
+        }
+      }
+      hsize_t gdims[5] = {static_cast<hsize_t>(nvar), static_cast<hsize_t>(nmb_total),
+          static_cast<hsize_t>(nout3), static_cast<hsize_t>(nout2),
+          static_cast<hsize_t>(nout1)};
+      hsize_t ldims[5] = {static_cast<hsize_t>(nvar), static_cast<hsize_t>(nout_mbs),
+          static_cast<hsize_t>(nout3), static_cast<hsize_t>(nout2),
+          static_cast<hsize_t>(nout1)};
+      hsize_t chunk[5] = {1, 1, static_cast<hsize_t>(nout3), static_cast<hsize_t>(nout2),
+          static_cast<hsize_t>(nout1)};
+      WriteDataset(file, dxpl, dnames[d], H5T_IEEE_F32LE, H5T_NATIVE_FLOAT, 5, gdims,
+                   ldims, 1, mb_offset, single_data.data(), chunk,
+                   out_params.compression_level);
+    }
+  }
+
+  // close the output file
+  H5Fclose(file);
+  H5Pclose(dxpl);
+  H5Pclose(fapl);
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = out_time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  return;
+}
+
+#endif // HDF5_OUTPUT_ENABLED
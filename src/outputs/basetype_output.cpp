@@ -159,6 +159,14 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
        << std::endl << "Input file is likely missing corresponding block" << std::endl;
     exit(EXIT_FAILURE);
   }
+  if ((ivar==152) && ((pm->pmb_pack->phydro == nullptr) ||
+                      !(pm->pmb_pack->phydro->peos->floor_map_enabled))) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+       << "Output of hydro_floors requested in <output> block '"
+       << out_params.block_name << "' but map of floors not enabled."
+       << std::endl << "Set <hydro>/floor_map=true (ideal gas hydro only)" << std::endl;
+    exit(EXIT_FAILURE);
+  }
 
   // Now load STL vector of output variables
   outvars.clear();
@@ -679,6 +687,12 @@ BaseTypeOutput::BaseTypeOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
     outvars.emplace_back("pdens",0,&(derived_var));
   }
 
+  // bitmask of floors applied in hydro C2P since last output
+  if (out_params.variable.compare("hydro_floors") == 0) {
+    out_params.contains_derived = true;
+    outvars.emplace_back("floors",0,&(derived_var));
+  }
+
   // initialize vector containing number of output MBs per rank
   noutmbs.assign(global_variable::nranks, 0);
 }
@@ -697,6 +711,16 @@ void BaseTypeOutput::LoadOutputData(Mesh *pm) {
   // So start with clean vector of output MeshBlock info, and re-compute
   outmbs.clear();
 
+  // in vacuum, ADM variables are only computed from the z4c variables when read
+  if (pm->pmb_pack->pz4c != nullptr) {
+    for (auto &ov : outvars) {
+      if (ov.data_ptr == &(pm->pmb_pack->padm->u_adm)) {
+        pm->pmb_pack->pz4c->UpdateADM();
+        break;
+      }
+    }
+  }
+
   // loop over all MeshBlocks
   // set size & starting indices of output arrays, adjusted accordingly if gz included
   auto &indcs = pm->mb_indcs;
@@ -782,43 +806,66 @@ void BaseTypeOutput::LoadOutputData(Mesh *pm) {
   int nout_mbs = outmbs.size();
   // note that while ois,oie,etc. can be different on each MB, the number of cells output
   // on each MeshBlock, i.e. (ois-ois+1), etc. is the same.
-  if (nout_mbs > 0) {
+  // With compression only quantized data are copied to host, so outarray is not used.
+  if (nout_mbs > 0 && !(out_params.compress)) {
     int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
     int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
     int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
     // NB: outarray stores all output data on Host
-    Kokkos::realloc(outarray, nout_vars, nout_mbs, nout3, nout2, nout1);
+    // With async outputs a new array is allocated, since the previous one may still be
+    // held by a snapshot being written by the background I/O thread
+    if (out_params.async) {
+      outarray = HostArray5D<Real>("outarray", nout_vars, nout_mbs, nout3, nout2, nout1);
+    } else {
+      Kokkos::realloc(outarray, nout_vars, nout_mbs, nout3, nout2, nout1);
+    }
   }
+  out_time = pm->time;
+  out_cycle = pm->ncycle;
 
-  // Calculate derived variables, if required
+  // Calculate derived variables, if required.  Skipped on ranks with no MeshBlocks
+  // selected for output (e.g. with slicing).
+  if (nout_mbs == 0) {return;}
   if (out_params.contains_derived) {
     ComputeDerivedVariable(out_params.variable, pm);
   }
 
-  // Now copy data to host (outarray) over all variables and MeshBlocks
+  // Gather data over all variables and MeshBlocks into device staging array (kept
+  // between outputs, and only reallocated when the number/size of output MBs changes),
+  // using one kernel per variable over all MBs.  Then copy to host (outarray) at once.
+  int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
+  int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
+  int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
+  if (d_outarray.extent_int(0) != nout_vars || d_outarray.extent_int(1) != nout_mbs ||
+      d_outarray.extent_int(2) != nout3 || d_outarray.extent_int(3) != nout2 ||
+      d_outarray.extent_int(4) != nout1) {
+    Kokkos::realloc(d_outarray, nout_vars, nout_mbs, nout3, nout2, nout1);
+  }
+  if (outmbs_indx.extent_int(0) != nout_mbs) {
+    Kokkos::realloc(outmbs_indx, nout_mbs, 4);
+  }
+  for (int m=0; m<nout_mbs; ++m) {
+    outmbs_indx.h_view(m,0) = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
+    outmbs_indx.h_view(m,1) = outmbs[m].ois;
+    outmbs_indx.h_view(m,2) = outmbs[m].ojs;
+    outmbs_indx.h_view(m,3) = outmbs[m].oks;
+  }
+  outmbs_indx.template modify<HostMemSpace>();
+  outmbs_indx.template sync<DevExeSpace>();
+
+  auto &d_out = d_outarray;
+  auto &mbindx = outmbs_indx;
   for (int n=0; n<nout_vars; ++n) {
-    for (int m=0; m<nout_mbs; ++m) {
-      int mbi = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
-      std::pair<int,int> irange = std::make_pair(outmbs[m].ois, outmbs[m].oie+1);
-      std::pair<int,int> jrange = std::make_pair(outmbs[m].ojs, outmbs[m].oje+1);
-      std::pair<int,int> krange = std::make_pair(outmbs[m].oks, outmbs[m].oke+1);
-      int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
-      int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
-      int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
-
-      // copy output variable to new device View
-      DvceArray3D<Real> d_output_var("d_out_var",nout3,nout2,nout1);
-      auto d_slice = Kokkos::subview(*(outvars[n].data_ptr), mbi, outvars[n].data_index,
-                                     krange,jrange,irange);
-      Kokkos::deep_copy(d_output_var,d_slice);
-
-      // copy new device View to host mirror View
-      DvceArray3D<Real>::HostMirror h_output_var = Kokkos::create_mirror(d_output_var);
-      Kokkos::deep_copy(h_output_var,d_output_var);
-
-      // copy host mirror to 5D host View containing all output variables
-      auto h_slice = Kokkos::subview(outarray,n,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL);
-      Kokkos::deep_copy(h_slice,h_output_var);
-    }
+    auto var = *(outvars[n].data_ptr);
+    int nv = outvars[n].data_index;
+    par_for("out_gather", DevExeSpace(), 0, nout_mbs-1, 0, nout3-1, 0, nout2-1,
+            0, nout1-1,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      d_out(n,m,k,j,i) = var(mbindx.d_view(m,0), nv, mbindx.d_view(m,3)+k,
+                             mbindx.d_view(m,2)+j, mbindx.d_view(m,1)+i);
+    });
+  }
+  if (!(out_params.compress)) {
+    Kokkos::deep_copy(outarray, d_outarray);
   }
 }
@@ -24,6 +24,7 @@
 #include "coordinates/cell_locations.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs.hpp"
+#include "file_layout.hpp"
 
 //----------------------------------------------------------------------------------------
 // Constructor: also calls BaseTypeOutput base class constructor
@@ -35,6 +36,23 @@ MeshBinaryOutput::MeshBinaryOutput(ParameterInput *pin, Mesh *pm, OutputParamete
   // set different stripe counts depending on whether mpiio is used in order to
   // achieve the best performance and not to crash the filesystem
   mkdir("bin",0775);
+  if (out_params.compress) {
+    std::vector<std::string> labels;
+    for (auto &var : outvars) {labels.push_back(var.label);}
+    SetCompressionTolerances(pin, labels);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBinaryOutput::LoadOutputData(Mesh *pm)
+//! \brief Loads data into d_outarray using BaseTypeOutput::LoadOutputData(), and with
+//! compression quantizes it on the device before copying to the host.
+
+void MeshBinaryOutput::LoadOutputData(Mesh *pm) {
+  BaseTypeOutput::LoadOutputData(pm);
+  if (out_params.compress && outmbs.size() > 0) {
+    QuantizeOutputData();
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -59,8 +77,19 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   fname.append(".");
   fname.append(number);
   fname.append(".bin");
+  // with subfiles, each group of subfile_ranks ranks writes a complete binary file of
+  // its MeshBlocks, named by appending ".sXXXXX" (5-digit index of group)
+  if (out_params.subfile_ranks > 0) {
+    char subnumber[8];
+    std::snprintf(subnumber, sizeof(subnumber), ".s%05d",
+                  io_root/out_params.subfile_ranks);
+    fname.append(subnumber);
+  }
 
   IOWrapper binfile;
+#if MPI_PARALLEL_ENABLED
+  binfile.SetCommunicator(io_comm);
+#endif
   std::size_t header_offset=0;
   binfile.Open(fname.c_str(), IOWrapper::FileMode::write);
 
@@ -71,20 +100,33 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // 4. Header (input file information)
   {
     std::stringstream msg;
-    msg << "Athena binary output version=1.1" << std::endl
+    // compressed files (version 1.2) have an additional "compression" line in preheader,
+    // and files with an index of MeshBlocks (version 1.3) a "block index" line
+    int npreheader = 5;
+    if (out_params.compress) {npreheader++;}
+    if (out_params.block_index) {npreheader++;}
+    msg << "Athena binary output version="
+        << ((out_params.block_index)? "1.3" : ((out_params.compress)? "1.2" : "1.1"))
+        << std::endl
         // preheader size includes "size of preheader" line up to "number of variables"
-        << "  size of preheader=5" << std::endl
-        << "  time=" << pm->time << std::endl
-        << "  cycle=" << pm->ncycle << std::endl
+        << "  size of preheader=" << npreheader << std::endl
+        << "  time=" << out_time << std::endl
+        << "  cycle=" << out_cycle << std::endl
         << "  size of location=" << sizeof(Real) << std::endl
-        << "  size of variable=" << sizeof(float) << std::endl
-        << "  number of variables=" << outvars.size() << std::endl
+        << "  size of variable=" << sizeof(float) << std::endl;
+    if (out_params.compress) {
+      msg << "  compression=quantized" << std::endl;
+    }
+    if (out_params.block_index) {
+      msg << "  block index=footer" << std::endl;
+    }
+    msg << "  number of variables=" << outvars.size() << std::endl
         << "  variables:  ";
     for (int n=0; n<outvars.size(); n++) {
       msg << outvars[n].label.c_str() << "  ";
     }
     msg << std::endl;
-    if (global_variable::my_rank == 0) {
+    if (global_variable::my_rank == io_root) {
       binfile.Write_any_type(msg.str().c_str(),msg.str().size(),"byte");
     }
     header_offset += msg.str().size();
@@ -96,7 +138,7 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     pin->ParameterDump(ost);
     std::string sbuf=ost.str();
     msg << "  header offset=" << sbuf.size()*sizeof(char)  << std::endl;
-    if (global_variable::my_rank == 0) {
+    if (global_variable::my_rank == io_root) {
       binfile.Write_any_type(msg.str().c_str(),msg.str().size(),"byte");
       binfile.Write_any_type(sbuf.c_str(),sbuf.size(),"byte");
     }
@@ -117,21 +159,29 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     cells = nout1*nout2*nout3;
   }
 
-  // ois, oie, ojs, oje, oks, oke + il1, il2, il3, level +
-  // x1min, x1max, x2min, x2max, x3min, x3max + data
-  std::size_t data_size = 10*sizeof(int32_t) + 6*sizeof(Real)
+  // header of MB (see file_layout.hpp) + data
+  std::size_t data_size = sizeof(file_layout::BinBlockHeader<Real>)
                         + (cells*nout_vars)*sizeof(float);
 
-  int ns_mbs = pm->gids_eachrank[global_variable::my_rank];
+  // index of first MB of this rank in file
+  int ns_mbs = pm->gids_eachrank[global_variable::my_rank] - pm->gids_eachrank[io_root];
   int nb_mbs = pm->nmb_eachrank[global_variable::my_rank];
 
+  // with compression the size of each MB depends on the number of bits used for each
+  // variable, so compute offset of each MB in data
+  std::vector<std::size_t> mb_offset(nout_mbs+1, 0);
+  for (int m=0; m<nout_mbs; ++m) {
+    mb_offset[m+1] = mb_offset[m] + ((out_params.compress)?
+        (sizeof(file_layout::BinBlockHeader<Real>) + CompressedDataSize(m)) : data_size);
+  }
+
   // allocate 1D vector of floats used to convert and output data
-  char *data = new char[nb_mbs*data_size];
+  char *data = new char[(out_params.compress)? mb_offset[nout_mbs] : nb_mbs*data_size];
   float *single_data = new float[cells];
 
   // Loop over MeshBlocks
   for (int m=0; m<nout_mbs; ++m) {
-    char *pdata=&(data[m*data_size]);
+    char *pdata=&(data[mb_offset[m]]);
     LogicalLocation loc = pm->lloc_eachmb[outmbs[m].mb_gid];
     int &ois = outmbs[m].ois;
     int &oie = outmbs[m].oie;
@@ -140,63 +190,19 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     int &oks = outmbs[m].oks;
     int &oke = outmbs[m].oke;
 
-    // output indexing for MB
-    int32_t nx = (int32_t)(ois);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(oie);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(ojs);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(oje);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(oks);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(oke);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-
-    // logical location lx1, lx2, lx3
-    nx = (int32_t)(loc.lx1);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(loc.lx2);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-    nx = (int32_t)(loc.lx3);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-
-    // physical refinement level
-    nx = (int32_t)(loc.level-pm->root_level);
-    memcpy(pdata,&(nx),sizeof(nx));
-    pdata+=sizeof(nx);
-
-    // coordinate location
-    Real xv = outmbs[m].x1min;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x1max;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x2min;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x2max;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x3min;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
-    xv = outmbs[m].x3max;
-    memcpy(pdata,&(xv),sizeof(xv));
-    pdata+=sizeof(xv);
+    // output indexing, logical location, physical level and coordinates of MB
+    file_layout::BinBlockHeader<Real> hdr = {ois, oie, ojs, oje, oks, oke,
+      loc.lx1, loc.lx2, loc.lx3, loc.level - pm->root_level, outmbs[m].x1min,
+      outmbs[m].x1max, outmbs[m].x2min, outmbs[m].x2max, outmbs[m].x3min,
+      outmbs[m].x3max};
+    memcpy(pdata, &hdr, sizeof(hdr));
+    pdata += sizeof(hdr);
 
     // output variables
+    if (out_params.compress) {
+      PackCompressedData(m, pdata);
+      continue;
+    }
     float tmp_data;
     for (int n=0; n<nout_vars; n++) {
       int cnt=0;
@@ -215,11 +221,14 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   }
 
   // now write binary data
-  if (bin_slice) {
+  if (out_params.compress) {
+    WriteCompressedData(binfile, data, mb_offset[nout_mbs], header_offset);
+  } else if (bin_slice) {
     std::vector<int> rank_offset(global_variable::nranks, 0);
     std::partial_sum(noutmbs.begin(),std::prev(noutmbs.end()),
                      std::next(rank_offset.begin()));
-    std::size_t myoffset=header_offset+data_size*rank_offset[global_variable::my_rank];
+    int nmb_before = rank_offset[global_variable::my_rank] - rank_offset[io_root];
+    std::size_t myoffset = header_offset + data_size*nmb_before;
     if (noutmbs_min > 0) {
       binfile.Write_any_type_at_all(data,(data_size*nout_mbs),myoffset,"byte");
     } else {
@@ -266,6 +275,10 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     }
   }
 
+  if (out_params.block_index) {
+    WriteBlockIndex(pm, binfile, header_offset, mb_offset, cells);
+  }
+
   // close the output file and clean up ptrs to data
   binfile.Close();
   delete [] data;
@@ -274,7 +287,7 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // increment counters
   out_params.file_number++;
   if (out_params.last_time < 0.0) {
-    out_params.last_time = pm->time;
+    out_params.last_time = out_time;
   } else {
     out_params.last_time += out_params.dt;
   }
@@ -283,3 +296,75 @@ void MeshBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
 
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshBinaryOutput::WriteBlockIndex()
+//! \brief Appends an index of all output MeshBlocks after their data, so that readers can
+//! seek to (or mmap) only the MeshBlocks and variables they need.  The index has one
+//! fixed-size entry per MeshBlock, in the same order as the data, each a BinIndexEntry
+//! followed by the byte offset in file of the data of each variable, and the index is
+//! followed by a BinIndexTrailer at the end of the file (see file_layout.hpp).
+//! With compression, the offset of each variable is that of its (vmin, step, nbits).
+
+void MeshBinaryOutput::WriteBlockIndex(Mesh *pm, IOWrapper &file,
+                                       std::size_t header_offset,
+                                       const std::vector<std::size_t> &mb_offset,
+                                       int cells) {
+  int nout_vars = outvars.size();
+  int nout_mbs = outmbs.size();
+  std::size_t entry_size = file_layout::BinIndexEntrySize<Real>(nout_vars);
+
+  // offset of data of this rank, and end of data of all ranks in file (data of each rank
+  // is written contiguously in order of rank)
+  std::uint64_t mysize = mb_offset[nout_mbs], myoffset = 0, total = mysize;
+  int io_end = global_variable::nranks;
+#if MPI_PARALLEL_ENABLED
+  MPI_Exscan(&mysize, &myoffset, 1, MPI_UINT64_T, MPI_SUM, io_comm);
+  if (global_variable::my_rank == io_root) {myoffset = 0;}
+  MPI_Allreduce(MPI_IN_PLACE, &total, 1, MPI_UINT64_T, MPI_SUM, io_comm);
+  MPI_Comm_size(io_comm, &io_end);
+  io_end += io_root;
+#endif
+  std::uint64_t index_offset = header_offset + total;
+  int nmb_before = std::accumulate(noutmbs.begin() + io_root,
+                                   noutmbs.begin() + global_variable::my_rank, 0);
+  std::uint64_t nmb_all = std::accumulate(noutmbs.begin() + io_root,
+                                          noutmbs.begin() + io_end, 0);
+
+  char *index = new char[nout_mbs*entry_size];
+  for (int m=0; m<nout_mbs; ++m) {
+    char *pdata = &(index[m*entry_size]);
+    LogicalLocation loc = pm->lloc_eachmb[outmbs[m].mb_gid];
+    std::uint64_t off = header_offset + myoffset + mb_offset[m];
+    file_layout::BinIndexEntry<Real> entry = {outmbs[m].mb_gid,
+      loc.level - pm->root_level, loc.lx1, loc.lx2, loc.lx3, 0, outmbs[m].x1min,
+      outmbs[m].x1max, outmbs[m].x2min, outmbs[m].x2max, outmbs[m].x3min,
+      outmbs[m].x3max, off};
+    memcpy(pdata, &entry, sizeof(entry));
+    pdata += sizeof(entry);
+    off += sizeof(file_layout::BinBlockHeader<Real>);
+    int nmb = (out_params.compress)? qarray.extent_int(1) : 0;
+    for (int n=0; n<nout_vars; ++n) {
+      memcpy(pdata, &off, sizeof(off));
+      pdata += sizeof(off);
+      if (out_params.compress) {
+        off += file_layout::kCompressedVarHeaderSize
+             + (static_cast<std::size_t>(q_nbits[n*nmb + m])*cells + 7)/8;
+      } else {
+        off += cells*sizeof(float);
+      }
+    }
+  }
+  std::size_t myindex = index_offset + nmb_before*entry_size;
+  file.Write_any_type_at_all(index, nout_mbs*entry_size, myindex, "byte");
+
+  if (global_variable::my_rank == io_root) {
+    file_layout::BinIndexTrailer trailer = {index_offset, nmb_all,
+                                            static_cast<std::uint64_t>(entry_size), {}};
+    memcpy(trailer.magic, file_layout::kBinIndexMagic, sizeof(trailer.magic));
+    file.Write_any_type_at(&trailer, sizeof(trailer), index_offset + nmb_all*entry_size,
+                           "byte");
+  }
+  delete [] index;
+  return;
+}
@@ -6,6 +6,12 @@
 //! \file coarsened_binary.cpp
 //! \brief writes output data in binary format, which simply consists of each MeshBlock
 //! written contiguously in order of "gid" in binary format.
+//!
+//! With pyramid_levels=N > 1, each output also writes the data coarsened by factors
+//! 2*cf, 4*cf, ..., 2^(N-1)*cf, each computed on the device by averaging 2x2x2 cells of
+//! the previous level (exact also for moments, which are averages of powers).  Each level
+//! is written to the usual directory for its coarsening factor, and a text index
+//! listing the files of all levels is written next to the finest level.
 
 #include <sys/stat.h>  // mkdir
 
@@ -32,16 +38,48 @@
 CoarsenedBinaryOutput::CoarsenedBinaryOutput(ParameterInput *pin, Mesh *pm,
                                              OutputParameters op) :
   BaseTypeOutput(pin, pm, op) {
-  // create directories for outputs
+  if (out_params.pyramid_levels < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "pyramid_levels=" << out_params.pyramid_levels << " in block '"
+        << out_params.block_name << "' must be at least 1" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (out_params.pyramid_levels > 1 && out_params.compress) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "pyramid_levels > 1 in block '" << out_params.block_name
+        << "' cannot be combined with compress=true" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // create directories for outputs (one for each level of pyramid)
   // useful for mpiio-based outputs because on some supercomputers you may need to
   // set different stripe counts depending on whether mpiio is used in order to
   // achieve the best performance and not to crash the filesystem
-  std::string dir_name;
-  dir_name.assign("cbin_");
-  dir_name.append(out_params.file_id);
-  dir_name.append("_");
-  dir_name.append(std::to_string(out_params.coarsen_factor));
-  mkdir(dir_name.c_str(),0775);
+  for (int l=0; l<out_params.pyramid_levels; ++l) {
+    std::string dir_name;
+    dir_name.assign("cbin_");
+    dir_name.append(out_params.file_id);
+    dir_name.append("_");
+    dir_name.append(std::to_string(out_params.coarsen_factor << l));
+    mkdir(dir_name.c_str(),0775);
+  }
+  d_pyramid_.resize(out_params.pyramid_levels - 1);
+  pyramid_.resize(out_params.pyramid_levels - 1);
+  if (out_params.compress) {
+    // with moments, tolerance of each moment can be set with e.g. tolerance_dens_2nd
+    std::vector<std::string> labels;
+    for (auto &var : outvars) {
+      if (out_params.compute_moments) {
+        for (auto suffix : {"_1st", "_2nd", "_3rd", "_4th"}) {
+          std::string key = "tolerance_" + var.label + suffix;
+          labels.push_back(pin->DoesParameterExist(out_params.block_name, key)?
+                           (var.label + suffix) : var.label);
+        }
+      } else {
+        labels.push_back(var.label);
+      }
+    }
+    SetCompressionTolerances(pin, labels);
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -137,23 +175,41 @@ void CoarsenedBinaryOutput::LoadOutputData(Mesh *pm) {
   noutmbs_max = *std::max_element(noutmbs.begin(), noutmbs.end());
 
   // get number of output vars and MBs, then realloc outarray (HostArray)
-  int nout_vars_with_moments;
-  if (out_params.compute_moments) {
-    nout_vars_with_moments = outvars.size() * 4;
-  } else {
-    nout_vars_with_moments = outvars.size();
-  }
+  int nmom = (out_params.compute_moments)? 4 : 1;
   int nout_vars = outvars.size();
   int nout_mbs = outmbs.size();
+  out_time = pm->time;
+  out_cycle = pm->ncycle;
+  if (nout_mbs == 0) {return;}
+
   // note that while ois,oie,etc. can be different on each MB, the number of cells output
   // on each MeshBlock, i.e. (ois-ois+1), etc. is the same.
-  if (nout_mbs > 0) {
-    int nout1 = ((outmbs[0].oie - outmbs[0].ois + 1)/out_params.coarsen_factor);
-    int nout2 = ((outmbs[0].oje - outmbs[0].ojs + 1)/out_params.coarsen_factor);
-    int nout3 = ((outmbs[0].oke - outmbs[0].oks + 1)/out_params.coarsen_factor);
-    // NB: outarray stores all output data on Host
-    // DBF: outarray is smaller by a factor of coarsen_factor in each dimension
-    Kokkos::realloc(outarray, nout_vars_with_moments, nout_mbs, nout3, nout2, nout1);
+  int cf = out_params.coarsen_factor;
+  int cf_max = cf << (out_params.pyramid_levels - 1);
+  int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
+  int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
+  int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
+  if (nout1 % cf_max != 0 || nout2 % cf_max != 0 || nout3 % cf_max != 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Size of output data " << nout1 << "x" << nout2 << "x" << nout3
+        << " in block '" << out_params.block_name << "' is not divisible by "
+        << "coarsening factor " << cf_max << " (coarsen_factor=" << cf
+        << ", pyramid_levels=" << out_params.pyramid_levels << ")" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // DBF: outarray is smaller by a factor of coarsen_factor in each dimension
+  int cnout1 = nout1/cf;
+  int cnout2 = nout2/cf;
+  int cnout3 = nout3/cf;
+  // NB: outarray stores all output data on Host.  With compression only quantized data
+  // are copied to host, so outarray is not used.
+  if (!(out_params.compress)) {
+    if (out_params.async) {
+      outarray = HostArray5D<Real>("outarray", nmom*nout_vars, nout_mbs, cnout3, cnout2,
+                                   cnout1);
+    } else {
+      Kokkos::realloc(outarray, nmom*nout_vars, nout_mbs, cnout3, cnout2, cnout1);
+    }
   }
 
   // Calculate derived variables, if required
@@ -161,134 +217,158 @@ void CoarsenedBinaryOutput::LoadOutputData(Mesh *pm) {
     ComputeDerivedVariable(out_params.variable, pm);
   }
 
-  // Now copy data to host (outarray) over all variables and MeshBlocks
+  // Gather and coarsen data over all MeshBlocks in one kernel per variable, writing
+  // averages (and higher moments) directly into the device staging array, so that only
+  // the coarsened data are copied to the host.  Each thread sums the cf^3 fine cells of
+  // one coarse cell, so no temporary arrays or atomics are needed.
+  if (d_outarray.extent_int(0) != nmom*nout_vars ||
+      d_outarray.extent_int(1) != nout_mbs ||
+      d_outarray.extent_int(2) != cnout3 || d_outarray.extent_int(3) != cnout2 ||
+      d_outarray.extent_int(4) != cnout1) {
+    Kokkos::realloc(d_outarray, nmom*nout_vars, nout_mbs, cnout3, cnout2, cnout1);
+  }
+  if (outmbs_indx.extent_int(0) != nout_mbs) {
+    Kokkos::realloc(outmbs_indx, nout_mbs, 4);
+  }
+  for (int m=0; m<nout_mbs; ++m) {
+    outmbs_indx.h_view(m,0) = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
+    outmbs_indx.h_view(m,1) = outmbs[m].ois;
+    outmbs_indx.h_view(m,2) = outmbs[m].ojs;
+    outmbs_indx.h_view(m,3) = outmbs[m].oks;
+  }
+  outmbs_indx.template modify<HostMemSpace>();
+  outmbs_indx.template sync<DevExeSpace>();
+
+  auto &d_out = d_outarray;
+  auto &mbindx = outmbs_indx;
+  Real norm = 1.0/static_cast<Real>(cf*cf*cf);
   for (int n=0; n<nout_vars; ++n) {
-    for (int m=0; m<nout_mbs; ++m) {
-      int mbi = pm->FindMeshBlockIndex(outmbs[m].mb_gid);
-      std::pair<int,int> irange = std::make_pair(outmbs[m].ois, outmbs[m].oie+1);
-      std::pair<int,int> jrange = std::make_pair(outmbs[m].ojs, outmbs[m].oje+1);
-      std::pair<int,int> krange = std::make_pair(outmbs[m].oks, outmbs[m].oke+1);
-      std::pair<int,int> moment_range;
-      if (out_params.compute_moments) {
-        moment_range = std::make_pair(n*4, n*4+4);
-      } else {
-        moment_range = std::make_pair(n, n+1);
-      }
-      int nout1 = (outmbs[0].oie - outmbs[0].ois + 1);
-      int nout2 = (outmbs[0].oje - outmbs[0].ojs + 1);
-      int nout3 = (outmbs[0].oke - outmbs[0].oks + 1);
-      int coarsened_nout1 = nout1/out_params.coarsen_factor;
-      int coarsened_nout2 = nout2/out_params.coarsen_factor;
-      int coarsened_nout3 = nout3/out_params.coarsen_factor;
-
-      // copy output variable to new device View
-      DvceArray3D<Real> d_output_var("d_out_var",nout3,nout2,nout1);
-      auto d_slice = Kokkos::subview(*(outvars[n].data_ptr), mbi, outvars[n].data_index,
-                                     krange,jrange,irange);
-      Kokkos::deep_copy(d_output_var,d_slice);
-      Kokkos::fence(); // Ensure complete copy
-
-
-      int number_of_moments = 1;
-      if (out_params.compute_moments) {
-        number_of_moments = 4;
+    auto var = *(outvars[n].data_ptr);
+    int nv = outvars[n].data_index;
+    int nn = nmom*n;
+    par_for("out_coarsen", DevExeSpace(), 0, nout_mbs-1, 0, cnout3-1, 0, cnout2-1,
+            0, cnout1-1,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      int mb = mbindx.d_view(m,0);
+      int fi = mbindx.d_view(m,1) + i*cf;
+      int fj = mbindx.d_view(m,2) + j*cf;
+      int fk = mbindx.d_view(m,3) + k*cf;
+      Real sum[4] = {0.0, 0.0, 0.0, 0.0};
+      for (int kk=0; kk<cf; ++kk) {
+        for (int jj=0; jj<cf; ++jj) {
+          for (int ii=0; ii<cf; ++ii) {
+            Real x = var(mb, nv, fk+kk, fj+jj, fi+ii);
+            Real xp = x;
+            for (int p=0; p<nmom; ++p) {
+              sum[p] += xp;
+              xp *= x;
+            }
+          }
+        }
       }
-      DvceArray4D<Real> d_output_var_coarsened("d_output_var_coarsened",
-        number_of_moments, coarsened_nout3, coarsened_nout2, coarsened_nout1);
-
-      // Coarsen the d_slice and store the result in d_output_var
-      // CoarsenVariable(d_output_var, d_output_var_coarsened, out_params.coarsen_factor);
-      int coarsen_factor = out_params.coarsen_factor;
-      int coarsen_factor_cubed = coarsen_factor * coarsen_factor * coarsen_factor;
-
-      if (nout1 % coarsen_factor != 0 || nout2 % coarsen_factor != 0
-                                      || nout3 % coarsen_factor != 0) {
-          std::cout << "Error: Full data dimensions are not divisible by coarsen_factor"
-          << std::endl;
-          exit(EXIT_FAILURE);
+      for (int p=0; p<nmom; ++p) {
+        d_out(nn+p,m,k,j,i) = sum[p]*norm;
       }
+    });
+  }
 
-      int total_iterations = coarsened_nout3
-        * coarsened_nout2 * coarsened_nout1 * coarsen_factor_cubed;
-
-      bool compute_moments = out_params.compute_moments;
-      Kokkos::parallel_for("coarsen_variable",
-       Kokkos::RangePolicy<DevExeSpace>(0, total_iterations),
-      KOKKOS_LAMBDA(const int idx) {
-        // Calculate the 3D indices for the coarsened data
-        int total_coarsened_elements = coarsened_nout1*coarsened_nout2*coarsened_nout3;
-        int k_c = (idx / (coarsened_nout2 * coarsened_nout1)) % coarsened_nout3;
-        int j_c = (idx / coarsened_nout1) % coarsened_nout2;
-        int i_c = idx % coarsened_nout1;
-
-        // Calculate the offset within the coarsen_factor_cubed cube
-        int offset = idx / total_coarsened_elements;
-        int kk = offset / (coarsen_factor * coarsen_factor);
-        int jj = (offset / coarsen_factor) % coarsen_factor;
-        int ii = offset % coarsen_factor;
-
-        // Calculate the corresponding indices in the full data
-        int k = k_c * coarsen_factor + kk;
-        int j = j_c * coarsen_factor + jj;
-        int i = i_c * coarsen_factor + ii;
-
-        // Perform the coarsening operation
-        if(k < nout3 && j < nout2 && i < nout1) {
-          Kokkos::atomic_add(&d_output_var_coarsened(0, k_c, j_c, i_c),
-            d_output_var(k, j, i));
-          if (compute_moments) {
-            Kokkos::atomic_add(&d_output_var_coarsened(1, k_c, j_c, i_c),
-              d_output_var(k, j, i)*d_output_var(k, j, i));
-            Kokkos::atomic_add(&d_output_var_coarsened(2, k_c, j_c, i_c),
-              d_output_var(k, j, i)*d_output_var(k, j, i)*d_output_var(k, j, i));
-            Kokkos::atomic_add(&d_output_var_coarsened(3, k_c, j_c, i_c),
-               d_output_var(k, j, i)*d_output_var(k, j, i)
-              *d_output_var(k, j, i)*d_output_var(k, j, i));
+  // Cascade coarser levels of pyramid, each from the previous level on the device
+  for (int l=1; l<out_params.pyramid_levels; ++l) {
+    auto src = (l == 1)? d_outarray : d_pyramid_[l-2];
+    auto &dst = d_pyramid_[l-1];
+    int n1 = cnout1 >> l, n2 = cnout2 >> l, n3 = cnout3 >> l;
+    if (dst.extent_int(0) != nmom*nout_vars || dst.extent_int(1) != nout_mbs ||
+        dst.extent_int(2) != n3 || dst.extent_int(3) != n2 || dst.extent_int(4) != n1) {
+      Kokkos::realloc(dst, nmom*nout_vars, nout_mbs, n3, n2, n1);
+    }
+    auto d_dst = dst;
+    par_for("out_pyramid", DevExeSpace(), 0, nmom*nout_vars-1, 0, nout_mbs-1,
+            0, n3-1, 0, n2-1, 0, n1-1,
+    KOKKOS_LAMBDA(int n, int m, int k, int j, int i) {
+      Real sum = 0.0;
+      for (int kk=0; kk<2; ++kk) {
+        for (int jj=0; jj<2; ++jj) {
+          for (int ii=0; ii<2; ++ii) {
+            sum += src(n, m, 2*k+kk, 2*j+jj, 2*i+ii);
           }
         }
-      });
-      // Normalize the coarsened data
-      int normalize_iterations = number_of_moments * coarsened_nout3
-                                * coarsened_nout2 * coarsened_nout1;
-      Kokkos::parallel_for("normalize_coarsened_variable",
-        Kokkos::RangePolicy<DevExeSpace>(0, normalize_iterations),
-      KOKKOS_LAMBDA(const int idx) {
-        int moment_idx = idx / (coarsened_nout3 * coarsened_nout2 * coarsened_nout1);
-        int k = (idx / (coarsened_nout2 * coarsened_nout1)) % coarsened_nout3;
-        int j = (idx / coarsened_nout1) % coarsened_nout2;
-        int i = idx % coarsened_nout1;
-
-        d_output_var_coarsened(moment_idx, k, j, i) /= coarsen_factor_cubed;
-      });
-
-
-      // Now, create a host mirror for the coarsened data.
-      DvceArray4D<Real>::HostMirror h_output_var = Kokkos::create_mirror(
-        d_output_var_coarsened
-      );
-
-      // Copy the coarsened data to the host mirror.
-      Kokkos::deep_copy(h_output_var, d_output_var_coarsened);
-      Kokkos::fence(); // Ensure complete copy before using h_output_var on the host
-
-      // copy host mirror to 5D host View containing all output variables
-      // if (out_params.compute_moments) {
-      auto h_slice = Kokkos::subview(outarray,
-        moment_range,m,Kokkos::ALL,Kokkos::ALL,Kokkos::ALL
-      );
-      Kokkos::deep_copy(h_slice,h_output_var);
+      }
+      d_dst(n,m,k,j,i) = 0.125*sum;
+    });
+    if (out_params.async) {
+      pyramid_[l-1] = HostArray5D<Real>("pyramid", nmom*nout_vars, nout_mbs, n3, n2, n1);
+    } else {
+      Kokkos::realloc(pyramid_[l-1], nmom*nout_vars, nout_mbs, n3, n2, n1);
+    }
+  }
+
+  if (out_params.compress) {
+    QuantizeOutputData();
+  } else {
+    Kokkos::deep_copy(outarray, d_outarray);
+    for (int l=1; l<out_params.pyramid_levels; ++l) {
+      Kokkos::deep_copy(pyramid_[l-1], d_pyramid_[l-1]);
     }
   }
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void CoarsenedBinaryOutput:::WriteOutputFile(Mesh *pm)
-//  \brief Cycles over all MeshBlocks and writes OutputData in Coarsenedbinary format
-//   All MeshBlocks are written to the same file.
+//  \brief Writes file of data coarsened by coarsen_factor and, for pyramid outputs, the
+//  files of each coarser level and an index of the files of all levels.
 
 void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
-  // check if slicing
+  int cf = out_params.coarsen_factor;
+  WriteCoarsenedFile(pm, pin, cf, outarray);
+  for (int l=1; l<out_params.pyramid_levels; ++l) {
+    WriteCoarsenedFile(pm, pin, cf << l, pyramid_[l-1]);
+  }
+
+  // index of pyramid: "cbin_"+"file_id"+"_"+"coarsening_factor"+"/file_basename"
+  // + "." + "file_id" + "." + XXXXX + ".pyr", listing the file of each level
+  if (out_params.pyramid_levels > 1 && global_variable::my_rank == 0) {
+    char number[6];
+    std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+    std::string fbase = out_params.file_basename + "." + out_params.file_id + "." +
+                        number;
+    std::string fname = "cbin_" + out_params.file_id + "_" + std::to_string(cf) + "/" +
+                        fbase + ".pyr";
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(),"w")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+         << std::endl << "Output file '" << fname << "' could not be opened" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    std::fprintf(pfile, "# Athena cbin pyramid at time=%e  cycle=%d\n", pm->time,
+                 pm->ncycle);
+    std::fprintf(pfile, "# levels=%d\n", out_params.pyramid_levels);
+    std::fprintf(pfile, "# [1]=level  [2]=coarsening_factor  [3]=file\n");
+    for (int l=0; l<out_params.pyramid_levels; ++l) {
+      std::fprintf(pfile, "%d %d cbin_%s_%d/%s.cbin\n", l, cf << l,
+                   out_params.file_id.c_str(), cf << l, fbase.c_str());
+    }
+    std::fclose(pfile);
+  }
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
 
+//----------------------------------------------------------------------------------------
+//! \fn void CoarsenedBinaryOutput::WriteCoarsenedFile()
+//  \brief Cycles over all MeshBlocks and writes data cdata coarsened by factor cf in
+//   Coarsenedbinary format.  All MeshBlocks are written to the same file.
+
+void CoarsenedBinaryOutput::WriteCoarsenedFile(Mesh *pm, ParameterInput *pin, int cf,
+                                               const HostArray5D<Real> &cdata) {
   // create filename: "cbin_"+"file_id"+"_"+"coarsening_factor"+"/file_basename"
   // + "." + "file_id" + "." + XXXXX + ".cbin"
   // where XXXXX = 5-digit file_number
@@ -299,7 +379,7 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   fname.assign("cbin_");
   fname.append(out_params.file_id);
   fname.append("_");
-  fname.append(std::to_string(out_params.coarsen_factor));
+  fname.append(std::to_string(cf));
   fname.append("/");
   fname.append(out_params.file_basename);
   fname.append(".");
@@ -323,16 +403,21 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // 3. List of variables in the file
   // 4. Header (input file information)
   {std::stringstream msg;
-  msg << "Athena binary output version=1.1" << std::endl
+  // compressed files (version 1.2) have an additional "compression" line in preheader
+  msg << "Athena binary output version=" << ((out_params.compress)? "1.2" : "1.1")
+      << std::endl
       // preheader size includes "size of preheader" line up to "number of variables"
-      << "  size of preheader=7" << std::endl
+      << "  size of preheader=" << ((out_params.compress)? 8 : 7) << std::endl
       << "  time=" << pm->time << std::endl
       << "  cycle=" << pm->ncycle << std::endl
       << "  number of moments=" << number_of_moments << std::endl
-      << "  coarsening factor=" << out_params.coarsen_factor << std::endl
+      << "  coarsening factor=" << cf << std::endl
       << "  size of location=" << sizeof(Real) << std::endl
-      << "  size of variable=" << sizeof(float) << std::endl
-      << "  number of variables=" << outvars.size()*number_of_moments << std::endl
+      << "  size of variable=" << sizeof(float) << std::endl;
+  if (out_params.compress) {
+    msg << "  compression=quantized" << std::endl;
+  }
+  msg << "  number of variables=" << outvars.size()*number_of_moments << std::endl
       << "  variables:  ";
   if (out_params.compute_moments) {
     // need to write the label for each of the 4 moments
@@ -373,9 +458,9 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     nout_vars *= 4;
   }
   int nout_mbs = outmbs.size();
-  int nout1 = ((outmbs[0].oie - outmbs[0].ois + 1)/out_params.coarsen_factor);
-  int nout2 = ((outmbs[0].oje - outmbs[0].ojs + 1)/out_params.coarsen_factor);
-  int nout3 = ((outmbs[0].oke - outmbs[0].oks + 1)/out_params.coarsen_factor);
+  int nout1 = ((outmbs[0].oie - outmbs[0].ois + 1)/cf);
+  int nout2 = ((outmbs[0].oje - outmbs[0].ojs + 1)/cf);
+  int nout3 = ((outmbs[0].oke - outmbs[0].oks + 1)/cf);
   int cells = nout1*nout2*nout3;
 
 
@@ -387,13 +472,21 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   int ns_mbs = pm->gids_eachrank[global_variable::my_rank];
   int nb_mbs = pm->nmb_eachrank[global_variable::my_rank];
 
+  // with compression the size of each MB depends on the number of bits used for each
+  // variable, so compute offset of each MB in data
+  std::vector<std::size_t> mb_offset(nout_mbs+1, 0);
+  for (int m=0; m<nout_mbs; ++m) {
+    mb_offset[m+1] = mb_offset[m] + ((out_params.compress)?
+        (10*sizeof(int32_t) + 6*sizeof(Real) + CompressedDataSize(m)) : data_size);
+  }
+
   // allocate 1D vector of floats used to convert and output data
-  char *data = new char[nb_mbs*data_size];
+  char *data = new char[(out_params.compress)? mb_offset[nout_mbs] : nb_mbs*data_size];
   float *single_data = new float[cells];
 
   // Loop over MeshBlocks
   for (int m=0; m<nout_mbs; ++m) {
-    char *pdata=&(data[m*data_size]);
+    char *pdata=&(data[mb_offset[m]]);
     LogicalLocation loc = pm->lloc_eachmb[outmbs[m].mb_gid];
     // of the starting indexes maybe I need to subtract of nghost,
     // divide by coarsen factor, and then add nghost back in
@@ -464,13 +557,17 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     pdata+=sizeof(xv);
 
     // output variables
+    if (out_params.compress) {
+      PackCompressedData(m, pdata);
+      continue;
+    }
     float tmp_data;
     for (int n=0; n<nout_vars; n++) {
       int cnt=0;
       for (int k=oks; k<=oke; k++) {
         for (int j=ojs; j<=oje; j++) {
           for (int i=ois; i<=oie; i++) {
-            tmp_data = static_cast<float>(outarray(n,m,k-oks,j-ojs,i-ois));
+            tmp_data = static_cast<float>(cdata(n,m,k-oks,j-ojs,i-ois));
             single_data[cnt] = tmp_data;
             cnt++;
           }
@@ -483,7 +580,9 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
 
   // now write Coarsenedbinary data
   // check if elements larger than 2^31
-  if (data_size*nb_mbs<=2147483648) {
+  if (out_params.compress) {
+    WriteCompressedData(cbinfile, data, mb_offset[nout_mbs], header_offset);
+  } else if (data_size*nb_mbs<=2147483648) {
     // now write Coarsenedbinary data in parallel
     std::size_t myoffset=header_offset+data_size*ns_mbs;
     cbinfile.Write_any_type_at_all(data,(data_size*nb_mbs),myoffset,"byte");
@@ -530,16 +629,5 @@ void CoarsenedBinaryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   cbinfile.Close();
   delete [] data;
   delete [] single_data;
-
-  // increment counters
-  out_params.file_number++;
-  if (out_params.last_time < 0.0) {
-    out_params.last_time = pm->time;
-  } else {
-    out_params.last_time += out_params.dt;
-  }
-  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
-  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
-
   return;
 }
@@ -0,0 +1,285 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file compressed_output.cpp
+//! \brief error-bounded lossy compression of cell-centered data in bin and cbin outputs,
+//! enabled with compress=true in the <output> block.
+//!
+//! Each variable on each MeshBlock is quantized on the device to unsigned integers
+//! q = nint((x - xmin)/step) with step = 2*tolerance, so that the reconstructed value
+//! xmin + q*step differs from x by at most the (absolute) tolerance of that variable.
+//! Only the integers are copied to the host, where they are bit-packed using the
+//! minimum number of bits needed to represent the range of q on that MeshBlock.  Each
+//! variable on each MeshBlock is then stored as
+//!   [double xmin][double step][int32 nbits][(nbits*cells+7)/8 bytes of packed q]
+//! with q packed least-significant-bit first.  Quantization is done in double precision
+//! (also when Real is float), so that the bound holds for up to 32 bits.  If a variable
+//! on a MeshBlock would need more than 32 bits, it is instead stored without loss as
+//! double[cells] with nbits = file_layout::kCompressedRawBits.  Tolerances are set with
+//! "tolerance" (default 1.0e-3), which can be overridden for each variable with
+//! "tolerance_<label>".
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "file_layout.hpp"
+#include "outputs.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void BaseTypeOutput::SetCompressionTolerances()
+//! \brief Sets absolute error bound of each output variable, given labels of variables
+//! in the order they are stored in d_outarray.  Called from constructor of output types.
+
+void BaseTypeOutput::SetCompressionTolerances(ParameterInput *pin,
+                                              const std::vector<std::string> &labels) {
+  Real tol = pin->GetOrAddReal(out_params.block_name, "tolerance", 1.0e-3);
+  out_tol.clear();
+  for (auto &label : labels) {
+    std::string key = "tolerance_" + label;
+    Real tol_n = (pin->DoesParameterExist(out_params.block_name, key))?
+                 pin->GetReal(out_params.block_name, key) : tol;
+    if (tol_n <= 0.0) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "compression tolerance of variable '" << label << "' in "
+          << "output block '" << out_params.block_name << "' must be > 0" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    out_tol.push_back(tol_n);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BaseTypeOutput::QuantizeOutputData()
+//! \brief Quantizes data in d_outarray(n,m,k,j,i) on the device, and copies quantized
+//! data to the host in qarray.  The minimum, step, and number of bits used for each
+//! variable on each MeshBlock are stored in q_min, q_step, q_nbits.  Data of variables
+//! stored unquantized is copied to the host in q_raw.
+
+void BaseTypeOutput::QuantizeOutputData() {
+  int nvar = d_outarray.extent_int(0);
+  int nmb  = d_outarray.extent_int(1);
+  int n3 = d_outarray.extent_int(2);
+  int n2 = d_outarray.extent_int(3);
+  int n1 = d_outarray.extent_int(4);
+  int ncells = n1*n2*n3;
+  int nn2 = n1*n2;
+
+  // find minimum and maximum of each variable on each MeshBlock
+  if (q_range.extent_int(0) != nvar || q_range.extent_int(1) != nmb) {
+    Kokkos::realloc(q_range, nvar, nmb, 3);
+  }
+  auto &d_out = d_outarray;
+  auto &range = q_range;
+  par_for_outer("out_qrange", DevExeSpace(), 0, 0, 0, (nvar-1), 0, (nmb-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int n, const int m) {
+    Real vmin, vmax;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, ncells),
+    [&](const int idx, Real &lmin) {
+      int k = idx/nn2;
+      int j = (idx - k*nn2)/n1;
+      int i = idx - k*nn2 - j*n1;
+      lmin = fmin(lmin, d_out(n,m,k,j,i));
+    }, Kokkos::Min<Real>(vmin));
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, ncells),
+    [&](const int idx, Real &lmax) {
+      int k = idx/nn2;
+      int j = (idx - k*nn2)/n1;
+      int i = idx - k*nn2 - j*n1;
+      lmax = fmax(lmax, d_out(n,m,k,j,i));
+    }, Kokkos::Max<Real>(vmax));
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+      range.d_view(n,m,0) = vmin;
+      range.d_view(n,m,1) = vmax;
+    });
+  });
+  range.template modify<DevExeSpace>();
+  range.template sync<HostMemSpace>();
+
+  // set step and number of bits on host.  Variables that would need more than 32 bits
+  // are stored unquantized (their quantized data is set to zero below).
+  const double qmax_limit = 4294967295.0;
+  q_min.assign(nvar*nmb, 0.0);
+  q_step.assign(nvar*nmb, 1.0);
+  q_nbits.assign(nvar*nmb, 0);
+  bool any_raw = false;
+  for (int n=0; n<nvar; ++n) {
+    for (int m=0; m<nmb; ++m) {
+      double vmin = range.h_view(n,m,0);
+      double width = range.h_view(n,m,1) - vmin;
+      double step = 2.0*out_tol[n];
+      double nq = std::floor(width/step + 0.5);
+      int nbits = 0;
+      if (nq > qmax_limit) {
+        nbits = file_layout::kCompressedRawBits;
+        step = 0.0;
+        nq = 0.0;
+        any_raw = true;
+      } else {
+        while (nbits < 32 && std::ldexp(1.0, nbits) <= nq) {nbits++;}
+      }
+      q_min[n*nmb + m] = vmin;
+      q_step[n*nmb + m] = step;
+      q_nbits[n*nmb + m] = nbits;
+      range.h_view(n,m,0) = vmin;
+      range.h_view(n,m,1) = (step > 0.0)? 1.0/step : 0.0;
+      range.h_view(n,m,2) = nq;
+    }
+  }
+  range.template modify<HostMemSpace>();
+  range.template sync<DevExeSpace>();
+
+  // copy data of variables stored unquantized to host
+  q_raw.clear();
+  q_raw_offset.assign(nvar*nmb, 0);
+  if (any_raw) {
+    for (int n=0; n<nvar; ++n) {
+      for (int m=0; m<nmb; ++m) {
+        if (q_nbits[n*nmb + m] != file_layout::kCompressedRawBits) {continue;}
+        q_raw_offset[n*nmb + m] = q_raw.size();
+        auto slice = Kokkos::subview(d_outarray, n, m, Kokkos::ALL, Kokkos::ALL,
+                                     Kokkos::ALL);
+        auto h_slice = Kokkos::create_mirror_view_and_copy(HostMemSpace(), slice);
+        for (int k=0; k<n3; ++k) {
+          for (int j=0; j<n2; ++j) {
+            for (int i=0; i<n1; ++i) {q_raw.push_back(h_slice(k,j,i));}
+          }
+        }
+      }
+    }
+  }
+
+  // quantize data on device, then copy to host.  As with outarray, a new host array is
+  // allocated with async outputs since the previous one may still be being written.
+  if (d_qarray.extent_int(0) != nvar || d_qarray.extent_int(1) != nmb ||
+      d_qarray.extent_int(2) != n3 || d_qarray.extent_int(3) != n2 ||
+      d_qarray.extent_int(4) != n1) {
+    Kokkos::realloc(d_qarray, nvar, nmb, n3, n2, n1);
+  }
+  if (out_params.async) {
+    qarray = HostArray5D<std::uint32_t>("qarray", nvar, nmb, n3, n2, n1);
+  } else {
+    Kokkos::realloc(qarray, nvar, nmb, n3, n2, n1);
+  }
+  auto &d_q = d_qarray;
+  par_for("out_quantize", DevExeSpace(), 0, (nvar-1), 0, (nmb-1), 0, (n3-1), 0, (n2-1),
+          0, (n1-1),
+  KOKKOS_LAMBDA(int n, int m, int k, int j, int i) {
+    double x = static_cast<double>(d_out(n,m,k,j,i));
+    double q = floor((x - range.d_view(n,m,0))*range.d_view(n,m,1) + 0.5);
+    q = fmin(fmax(q, 0.0), range.d_view(n,m,2));
+    d_q(n,m,k,j,i) = static_cast<std::uint32_t>(q);
+  });
+  Kokkos::deep_copy(qarray, d_qarray);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::size_t BaseTypeOutput::CompressedDataSize()
+//! \brief Returns number of bytes needed to store all compressed variables on output
+//! MeshBlock m.
+
+std::size_t BaseTypeOutput::CompressedDataSize(int m) {
+  int nvar = qarray.extent_int(0);
+  int nmb  = qarray.extent_int(1);
+  std::size_t ncells = qarray.extent(2)*qarray.extent(3)*qarray.extent(4);
+  std::size_t nbytes = 0;
+  for (int n=0; n<nvar; ++n) {
+    nbytes += 2*sizeof(double) + sizeof(int32_t)
+            + (q_nbits[n*nmb + m]*ncells + 7)/8;
+  }
+  return nbytes;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn std::size_t BaseTypeOutput::PackCompressedData()
+//! \brief Packs all compressed variables on output MeshBlock m into pdata, and returns
+//! number of bytes written.
+
+std::size_t BaseTypeOutput::PackCompressedData(int m, char *pdata) {
+  int nvar = qarray.extent_int(0);
+  int nmb  = qarray.extent_int(1);
+  std::size_t ncells = qarray.extent(2)*qarray.extent(3)*qarray.extent(4);
+  char *pstart = pdata;
+  for (int n=0; n<nvar; ++n) {
+    double vmin = q_min[n*nmb + m];
+    double step = q_step[n*nmb + m];
+    int32_t nbits = q_nbits[n*nmb + m];
+    memcpy(pdata, &(vmin), sizeof(vmin));
+    pdata += sizeof(vmin);
+    memcpy(pdata, &(step), sizeof(step));
+    pdata += sizeof(step);
+    memcpy(pdata, &(nbits), sizeof(nbits));
+    pdata += sizeof(nbits);
+    if (nbits == 0) {continue;}
+    if (nbits == file_layout::kCompressedRawBits) {
+      memcpy(pdata, &(q_raw[q_raw_offset[n*nmb + m]]), ncells*sizeof(double));
+      pdata += ncells*sizeof(double);
+      continue;
+    }
+
+    // (n,m) slice of LayoutRight qarray is contiguous
+    const std::uint32_t *q = &(qarray(n,m,0,0,0));
+    std::uint64_t acc = 0;
+    int nacc = 0;
+    for (std::size_t c=0; c<ncells; ++c) {
+      acc |= static_cast<std::uint64_t>(q[c]) << nacc;
+      nacc += nbits;
+      while (nacc >= 8) {
+        *pdata++ = static_cast<char>(acc & 0xff);
+        acc >>= 8;
+        nacc -= 8;
+      }
+    }
+    if (nacc > 0) {*pdata++ = static_cast<char>(acc & 0xff);}
+  }
+  return static_cast<std::size_t>(pdata - pstart);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BaseTypeOutput::WriteCompressedData()
+//! \brief Writes nbytes of compressed MeshBlock data stored on each rank contiguously in
+//! order of rank, starting at header_offset.  Since the size of the data differs between
+//! ranks, offsets are computed with a prefix sum.  Large writes are split into chunks
+//! smaller than 2^31 bytes, all written collectively.
+
+void BaseTypeOutput::WriteCompressedData(IOWrapper &file, const char *data,
+                                         std::size_t nbytes, std::size_t header_offset) {
+  const std::size_t max_chunk = 2147483647;
+  std::size_t myoffset = 0;
+  std::size_t nchunk = (nbytes + max_chunk - 1)/max_chunk;
+#if MPI_PARALLEL_ENABLED
+  std::uint64_t mysize = nbytes, prefix = 0;
+  MPI_Exscan(&mysize, &prefix, 1, MPI_UINT64_T, MPI_SUM, io_comm);
+  if (global_variable::my_rank == io_root) {prefix = 0;}
+  myoffset = static_cast<std::size_t>(prefix);
+  std::uint64_t nchunk_max = nchunk;
+  MPI_Allreduce(MPI_IN_PLACE, &nchunk_max, 1, MPI_UINT64_T, MPI_MAX, io_comm);
+  nchunk = static_cast<std::size_t>(nchunk_max);
+#endif
+  if (nchunk == 0) {nchunk = 1;}
+  std::size_t nwritten = 0;
+  for (std::size_t c=0; c<nchunk; ++c) {
+    std::size_t count = std::min(max_chunk, nbytes - nwritten);
+    std::size_t offset = header_offset + myoffset + nwritten;
+    if (file.Write_any_type_at_all(data + nwritten, count, offset, "byte") != count) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "compressed data not written correctly for output block '"
+          << out_params.block_name << "', file is broken." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    nwritten += count;
+  }
+  return;
+}
@@ -6,15 +6,19 @@
 //! \file derived_variables.cpp
 //! \brief Calculates various derived variables for outputs, storing them into the
 //! "derived_vars" device array located in BaseTypeOutput class.  Variables are only
-//! calculated over active zones (ghost zones excluded). Currently implemented are:
+//! calculated over active zones (ghost zones excluded).  Variables computed by one
+//! output are cached (by name) for the rest of the cycle, so other outputs of the same
+//! variable at that cycle copy them rather than recomputing.  Currently implemented are:
 //!   - z-component of vorticity Curl(v)_z  [non-relativistic]
 //!   - magnitude of vorticity Curl(v)^2  [non-relativistic]
 //!   - z-component of current density Jz  [non-relativistic]
 //!   - magnitude of current density J^2  [non-relativistic]
 
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>   // std::string, to_string()
+#include <utility>
 
 #include "athena.hpp"
 #include "parameter_input.hpp"
@@ -27,10 +31,24 @@
 #include "mhd/mhd.hpp"
 #include "radiation/radiation.hpp"
 #include "radiation/radiation_tetrad.hpp"
+#include "radiation/radiation_m1.hpp"
 #include "particles/particles.hpp"
 #include "outputs.hpp"
 #include "utils/current.hpp"
 
+namespace {
+// derived variables computed at the current cycle, shared by all outputs.  Each entry
+// holds (a reference to) the derived_var array of the output that computed it, and the
+// range of indices it was stored in.
+struct DerivedVarCacheEntry {
+  int ncycle;
+  Real time;
+  DvceArray5D<Real> data;
+  int index, nvar;
+};
+std::map<std::string, DerivedVarCacheEntry> derived_cache;
+} // namespace
+
 //----------------------------------------------------------------------------------------
 // BaseTypeOutput::ComputeDerivedVariable()
 
@@ -53,6 +71,33 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
   int &i_dv = out_params.i_derived;
   int &n_dv = out_params.n_derived;
 
+  // copy variable if it was already computed by another output at this cycle
+  auto cached = derived_cache.find(name);
+  if (cached != derived_cache.end() && cached->second.ncycle == pm->ncycle &&
+      cached->second.time == pm->time && i_dv + cached->second.nvar <= n_dv) {
+    auto &entry = cached->second;
+    if (derived_var.extent(4) <= 1)
+      Kokkos::realloc(derived_var, nmb, n_dv, n3, n2, n1);
+    if (entry.data.extent(0) == derived_var.extent(0) &&
+        entry.data.extent(2) == derived_var.extent(2) &&
+        entry.data.extent(3) == derived_var.extent(3) &&
+        entry.data.extent(4) == derived_var.extent(4)) {
+      // nothing to copy if this output computed the variable itself
+      if (entry.data.data() != derived_var.data() || entry.index != i_dv) {
+        auto dst = Kokkos::subview(derived_var, Kokkos::ALL,
+                                   std::make_pair(i_dv, i_dv + entry.nvar),
+                                   Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+        auto src = Kokkos::subview(entry.data, Kokkos::ALL,
+                                   std::make_pair(entry.index, entry.index + entry.nvar),
+                                   Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+        Kokkos::deep_copy(DevExeSpace(), dst, src);
+      }
+      i_dv = (i_dv + entry.nvar) % n_dv;
+      return;
+    }
+  }
+  int i_dv0 = i_dv;
+
   // temperature = pressure / density
   if (name.compare("temperature") == 0) {
     if (derived_var.extent(4) <= 1)
@@ -1000,8 +1045,87 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
     i_dv += 1; // increment derived variable index
   }
 
+  // radiation moments with the M1 method (flat spacetime), summed over frequency groups
+  if (name.compare(0, 3, "rad") == 0 && pm->pmb_pack->prad->is_m1_enabled) {
+    bool needs_coord_only = (name.compare("rad_coord") == 0);
+    bool needs_fluid_only = (name.compare("rad_fluid") == 0);
+    bool needs_both = !(needs_coord_only || needs_fluid_only);
+    int mom_var_size = (needs_both) ? 20 : 10;
+    int moments_offset = (needs_both) ? 10 : 0;
+    Kokkos::realloc(derived_var, nmb, mom_var_size, n3, n2, n1);
+    auto dv = derived_var;
+    int ngroups = pm->pmb_pack->prad->ngroups;
+    auto i0_ = pm->pmb_pack->prad->i0;
+
+    // Select either Hydro or MHD (if fluid enabled)
+    DvceArray5D<Real> w0_;
+    if (pm->pmb_pack->phydro != nullptr) {
+      w0_ = pm->pmb_pack->phydro->w0;
+    } else if (pm->pmb_pack->pmhd != nullptr) {
+      w0_ = pm->pmb_pack->pmhd->w0;
+    }
+
+    par_for("m1_moments",DevExeSpace(),0,(nmb-1),0,(n3-1),0,(n2-1),0,(n1-1),
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      // R^{\mu \nu} (coordinate frame) from E, F, and closure
+      Real moments_coord[4][4];
+      for (int a=0; a<4; ++a) {
+        for (int b=0; b<4; ++b) {moments_coord[a][b] = 0.0;}
+      }
+      for (int g=0; g<ngroups; ++g) {
+        Real e = i0_(m,IRE*ngroups+g,k,j,i);
+        Real f[3] = {i0_(m,IRF1*ngroups+g,k,j,i), i0_(m,IRF2*ngroups+g,k,j,i),
+                     i0_(m,IRF3*ngroups+g,k,j,i)};
+        Real p[3][3];
+        M1Closure(e, f, p);
+        moments_coord[0][0] += e;
+        for (int a=0; a<3; ++a) {
+          moments_coord[0][a+1] += f[a];
+          moments_coord[a+1][0] += f[a];
+          for (int b=0; b<3; ++b) {moments_coord[a+1][b+1] += p[a][b];}
+        }
+      }
+      if (needs_coord_only || needs_both) {
+        for (int n1=0, n12=0; n1<4; ++n1) {
+          for (int n2=n1; n2<4; ++n2, ++n12) {
+            dv(m,n12,k,j,i) = moments_coord[n1][n2];
+          }
+        }
+      }
+
+      // R^{\mu \nu} (fluid frame), with Lorentz boost by fluid velocity
+      if (needs_fluid_only || needs_both) {
+        Real uu[4];
+        uu[1] = w0_(m,IVX,k,j,i);
+        uu[2] = w0_(m,IVY,k,j,i);
+        uu[3] = w0_(m,IVZ,k,j,i);
+        uu[0] = sqrt(1.0 + SQR(uu[1]) + SQR(uu[2]) + SQR(uu[3]));
+        Real lambda[4][4];
+        lambda[0][0] = uu[0];
+        for (int a=1; a<4; ++a) {
+          lambda[0][a] = -uu[a];
+          lambda[a][0] = -uu[a];
+          for (int b=1; b<4; ++b) {
+            lambda[a][b] = uu[a]*uu[b]/(1.0 + uu[0]) + ((a == b)? 1.0 : 0.0);
+          }
+        }
+        for (int n1=0, n12=0; n1<4; ++n1) {
+          for (int n2=n1; n2<4; ++n2, ++n12) {
+            dv(m,moments_offset+n12,k,j,i) = 0.0;
+            for (int m1=0; m1<4; ++m1) {
+              for (int m2=0; m2<4; ++m2) {
+                dv(m,moments_offset+n12,k,j,i) += (lambda[n1][m1]*lambda[n2][m2]*
+                                                   moments_coord[m1][m2]);
+              }
+            }
+          }
+        }
+      }
+    });
+  }
+
   // radiation moments
-  if (name.compare(0, 3, "rad") == 0) {
+  if (name.compare(0, 3, "rad") == 0 && !(pm->pmb_pack->prad->is_m1_enabled)) {
     // Determine if coordinate and/or fluid frame moments required
     bool needs_coord_only = (name.compare("rad_coord") == 0);
     bool needs_fluid_only = (name.compare("rad_fluid") == 0);
@@ -1018,6 +1142,7 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
 
     // Radiation
     int nang1 = pm->pmb_pack->prad->prgeo->nangles - 1;
+    int ngroups = pm->pmb_pack->prad->ngroups;
     auto nh_c_ = pm->pmb_pack->prad->nh_c;
     auto tet_c_ = pm->pmb_pack->prad->tet_c;
     auto tetcov_c_ = pm->pmb_pack->prad->tetcov_c;
@@ -1065,8 +1190,10 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
               nmun2 += tet_c_   (m,d,n2,k,j,i)*nh_c_.d_view(n,d);
               n_0   += tetcov_c_(m,d,0, k,j,i)*nh_c_.d_view(n,d);
             }
-            dv(m,n12,k,j,i) += (nmun1*nmun2*(i0_(m,n,k,j,i)/(n0*n_0))*
-                                solid_angles_.d_view(n));
+            // moments are summed over frequency groups
+            Real isum = 0.0;
+            for (int g=0; g<ngroups; ++g) {isum += i0_(m,n*ngroups+g,k,j,i);}
+            dv(m,n12,k,j,i) += (nmun1*nmun2*(isum/(n0*n_0))*solid_angles_.d_view(n));
           }
         }
       }
@@ -1190,22 +1317,55 @@ void BaseTypeOutput::ComputeDerivedVariable(std::string name, Mesh *pm) {
     int &npart = pm->nprtcl_thisrank;
     int gids = pm->pmb_pack->gids;
 
-    par_for("pdens0", DevExeSpace(), 0, (nmb-1), ks, ke, js, je, is, ie,
+    auto ppart = pm->pmb_pack->ppart;
+    if (ppart->sorted) {
+      // particles sorted by cell, so density is size of segment of particles in cell
+      auto &offset = ppart->cell_offset;
+      int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+      par_for("pdens_sorted", DevExeSpace(), 0, (nmb-1), ks, ke, js, je, is, ie,
+      KOKKOS_LAMBDA(int m, int k, int j, int i) {
+        int n = ((m*nx3 + (k-ks))*nx2 + (j-js))*nx1 + (i-is);
+        pdens(m,0,k,j,i) = static_cast<Real>(offset(n+1) - offset(n));
+      });
+    } else {
+      par_for("pdens0", DevExeSpace(), 0, (nmb-1), ks, ke, js, je, is, ie,
+      KOKKOS_LAMBDA(int m, int k, int j, int i) {
+        pdens(m,0,k,j,i) = 0.0;
+      });
+
+      par_for("pdens", DevExeSpace(), 0, (npart-1),
+      KOKKOS_LAMBDA(const int p) {
+        int m = pi(PGID,p) - gids;
+        int ip = (pr(IPX,p) - size.d_view(m).x1min)/size.d_view(m).dx1 + is;
+        int jp = (pr(IPY,p) - size.d_view(m).x2min)/size.d_view(m).dx2 + js;
+        int kp = ks;
+        if (three_d) {
+          kp = (pr(IPZ,p) - size.d_view(m).x3min)/size.d_view(m).dx3 + ks;
+        }
+        Kokkos::atomic_add(&pdens(m,0,kp,jp,ip), 1.0);
+      });
+    }
+  }
+  // bitmask of floors applied in each cell since last output (see IdealHydro), which is
+  // then cleared so each output shows where floors were used since the previous one
+  if (name.compare("hydro_floors") == 0) {
+    Kokkos::realloc(derived_var, nmb, 1, n3, n2, n1);
+    auto dv = derived_var;
+    auto peos = pm->pmb_pack->phydro->peos;
+    if (peos->floor_map_nregrid != pm->nregrid) {
+      Kokkos::deep_copy(peos->floor_map, 0);
+      peos->floor_map_nregrid = pm->nregrid;
+    }
+    auto fmap = peos->floor_map;
+    par_for("hydro_floors", DevExeSpace(), 0, (nmb-1), 0, (n3-1), 0, (n2-1), 0, (n1-1),
     KOKKOS_LAMBDA(int m, int k, int j, int i) {
-      pdens(m,0,k,j,i) = 0.0;
-    });
-
-    par_for("pdens", DevExeSpace(), 0, (npart-1),
-    KOKKOS_LAMBDA(const int p) {
-      int m = pi(PGID,p) - gids;
-      int ip = (pr(IPX,p) - size.d_view(m).x1min)/size.d_view(m).dx1 + is;
-      int jp = (pr(IPY,p) - size.d_view(m).x2min)/size.d_view(m).dx2 + js;
-      int kp = ks;
-      if (three_d) {
-        kp = (pr(IPZ,p) - size.d_view(m).x3min)/size.d_view(m).dx3 + ks;
-      }
-      pdens(m,0,kp,jp,ip) += 1.0;
+      dv(m,0,k,j,i) = static_cast<Real>(fmap(m,k,j,i));
+      fmap(m,k,j,i) = 0;
     });
+  }
+    // cache variables stored at consecutive indices (others overwrite fixed indices)
+  if (i_dv > i_dv0) {
+    derived_cache[name] = {pm->ncycle, pm->time, derived_var, i_dv0, i_dv - i_dv0};
   }
   i_dv = i_dv % n_dv; // reset derived variable index
 }
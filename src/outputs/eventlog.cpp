@@ -8,6 +8,7 @@
 //! throughout the code to a log file.  Checks whether there is data to be written
 //! every time step, but only writes data if one or more counters are non-zero
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <iomanip>
@@ -20,6 +21,32 @@
 #include "mesh/mesh.hpp"
 #include "outputs.hpp"
 
+#if MPI_PARALLEL_ENABLED
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void EventCounterReduce()
+//! \brief MPI reduction operator over arrays of NCOUNTERS event counters, in which the
+//! maximum is taken of the iteration counters (maxit_c2p, maxit_rad), and all others
+//! (including the histogram of C2P iterations) are summed.  Used with a contiguous
+//! datatype of NCOUNTERS ints, so arrays are never split by MPI.
+
+constexpr int NCOUNTERS = 10 + NC2PHIST;
+constexpr int NSUMMED = 8 + NC2PHIST;  // counters [0,NSUMMED) are summed, rest are maxima
+void EventCounterReduce(void *invec, void *inoutvec, int *len, MPI_Datatype *dtype) {
+  int *in = static_cast<int*>(invec);
+  int *inout = static_cast<int*>(inoutvec);
+  for (int l=0; l<(*len); ++l) {
+    for (int n=0; n<NSUMMED; ++n) {
+      inout[l*NCOUNTERS + n] += in[l*NCOUNTERS + n];
+    }
+    for (int n=NSUMMED; n<NCOUNTERS; ++n) {
+      inout[l*NCOUNTERS + n] = std::max(inout[l*NCOUNTERS + n], in[l*NCOUNTERS + n]);
+    }
+  }
+}
+} // namespace
+#endif
+
 //----------------------------------------------------------------------------------------
 // ctor: also calls BaseTypeOutput base class constructor
 
@@ -34,21 +61,38 @@ EventLogOutput::EventLogOutput(ParameterInput *pin, Mesh *pm, OutputParameters o
 
 void EventLogOutput::LoadOutputData(Mesh *pm) {
 #if MPI_PARALLEL_ENABLED
-  // perform in-place sum or max over all MPI ranks, depending on counter
-  int* pdfloor = &(pm->ecounter.neos_dfloor);
-  int* pefloor = &(pm->ecounter.neos_efloor);
-  int* ptfloor = &(pm->ecounter.neos_tfloor);
-  int* pvceil  = &(pm->ecounter.neos_vceil);
-  int* pfail   = &(pm->ecounter.neos_fail);
-  int* pmaxit  = &(pm->ecounter.maxit_c2p);
-  int* pfofc   = &(pm->ecounter.nfofc);
-  MPI_Allreduce(MPI_IN_PLACE, pdfloor, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pefloor, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, ptfloor, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pvceil,  1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pfail,   1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pmaxit,  1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-  MPI_Allreduce(MPI_IN_PLACE, pfofc,   1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  // perform in-place sum or max over all MPI ranks, depending on counter, with a single
+  // reduction.  Datatype and operator are created on first call.
+  static MPI_Datatype counter_type = MPI_DATATYPE_NULL;
+  static MPI_Op counter_op = MPI_OP_NULL;
+  if (counter_type == MPI_DATATYPE_NULL) {
+    MPI_Type_contiguous(NCOUNTERS, MPI_INT, &counter_type);
+    MPI_Type_commit(&counter_type);
+    MPI_Op_create(&EventCounterReduce, 1, &counter_op);
+  }
+  int counters[NCOUNTERS] = {pm->ecounter.neos_dfloor, pm->ecounter.neos_efloor,
+                             pm->ecounter.neos_tfloor, pm->ecounter.neos_vceil,
+                             pm->ecounter.neos_fail,   pm->ecounter.nfofc,
+                             pm->ecounter.nrad_newton, pm->ecounter.nrad_fail};
+  for (int n=0; n<NC2PHIST; ++n) {
+    counters[8+n] = pm->ecounter.nc2p_hist[n];
+  }
+  counters[NSUMMED]   = pm->ecounter.maxit_c2p;
+  counters[NSUMMED+1] = pm->ecounter.maxit_rad;
+  MPI_Allreduce(MPI_IN_PLACE, counters, 1, counter_type, counter_op, MPI_COMM_WORLD);
+  pm->ecounter.neos_dfloor = counters[0];
+  pm->ecounter.neos_efloor = counters[1];
+  pm->ecounter.neos_tfloor = counters[2];
+  pm->ecounter.neos_vceil  = counters[3];
+  pm->ecounter.neos_fail   = counters[4];
+  pm->ecounter.nfofc       = counters[5];
+  pm->ecounter.nrad_newton = counters[6];
+  pm->ecounter.nrad_fail   = counters[7];
+  for (int n=0; n<NC2PHIST; ++n) {
+    pm->ecounter.nc2p_hist[n] = counters[8+n];
+  }
+  pm->ecounter.maxit_c2p   = counters[NSUMMED];
+  pm->ecounter.maxit_rad   = counters[NSUMMED+1];
 #endif
 
   // check if there is any data to be written
@@ -59,9 +103,14 @@ void EventLogOutput::LoadOutputData(Mesh *pm) {
       pm->ecounter.neos_vceil  > 0 ||
       pm->ecounter.neos_fail   > 0 ||
       pm->ecounter.nfofc > 0 ||
-      pm->ecounter.maxit_c2p > 0) {
+      pm->ecounter.maxit_c2p > 0 ||
+      pm->ecounter.nrad_newton > 0 ||
+      pm->ecounter.nrad_fail > 0) {
     no_output=false;
   }
+  for (int n=0; n<NC2PHIST; ++n) {
+    if (pm->ecounter.nc2p_hist[n] > 0) {no_output=false;}
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -91,7 +140,11 @@ void EventLogOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     if (!(header_written)) {
       std::fprintf(pfile,"# Athena event counter data\n");
       std::fprintf(pfile,"#  cycle eos_dfloor eos_efloor eos_tfloor eos_vceil");
-      std::fprintf(pfile," eos_fail c2p_it fofc");
+      std::fprintf(pfile," eos_fail c2p_it fofc rad_newton rad_fail rad_it");
+      // histogram of C2P iterations, labelled by the lower edge of each bin
+      for (int n=0; n<NC2PHIST; ++n) {
+        std::fprintf(pfile," c2p_h%d", (n == 0)? 0 : (1 << n));
+      }
       std::fprintf(pfile,"\n");  // terminate line
       header_written = true;
     }
@@ -106,6 +159,12 @@ void EventLogOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       std::fprintf(pfile, " %8d", pm->ecounter.neos_fail);
       std::fprintf(pfile, " %6d", pm->ecounter.maxit_c2p);
       std::fprintf(pfile, " %8d", pm->ecounter.nfofc);
+      std::fprintf(pfile, " %10d", pm->ecounter.nrad_newton);
+      std::fprintf(pfile, " %8d", pm->ecounter.nrad_fail);
+      std::fprintf(pfile, " %6d", pm->ecounter.maxit_rad);
+      for (int n=0; n<NC2PHIST; ++n) {
+        std::fprintf(pfile, " %10d", pm->ecounter.nc2p_hist[n]);
+      }
       std::fprintf(pfile,"\n"); // terminate line
     }
     std::fclose(pfile);
@@ -119,6 +178,10 @@ void EventLogOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   pm->ecounter.neos_fail = 0;
   pm->ecounter.maxit_c2p = 0;
   pm->ecounter.nfofc = 0;
+  pm->ecounter.nrad_newton = 0;
+  pm->ecounter.nrad_fail = 0;
+  pm->ecounter.maxit_rad = 0;
+  for (int n=0; n<NC2PHIST; ++n) {pm->ecounter.nc2p_hist[n] = 0;}
 
   // increment output time, clean up
   if (out_params.last_time < 0.0) {
@@ -0,0 +1,152 @@
+#ifndef OUTPUTS_FILE_LAYOUT_HPP_
+#define OUTPUTS_FILE_LAYOUT_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file file_layout.hpp
+//! \brief Layout of the binary records in bin and restart files.  Used both by the
+//! writers (binary.cpp, restart.cpp) and by the standalone reader library
+//! (file_reader.hpp), so this file must not depend on Kokkos, MPI, or config.hpp.
+//! Records containing floating-point values are templated on the type R of Real used by
+//! the code that wrote the file (recorded as "size of location" in bin files).
+//!
+//! bin files (version 1.1-1.3) consist of:
+//!   text preheader, "header offset=N" line, N bytes of input parameters
+//!   for each MeshBlock: BinBlockHeader<R>, then data of each variable as float[cells]
+//!     (or with compression, kCompressedVarHeaderSize bytes followed by packed bits)
+//!   optionally (version 1.3), an index of BinIndexEntry<R> records, each followed by
+//!     uint64 offsets of all variables, and a BinIndexTrailer at the end of the file
+//!
+//! restart files consist of:
+//!   input parameters ending with "<par_end>\n", RestartMeshHeader<R>,
+//!   RestartLocation[nmb_total], float cost[nmb_total], internal state of physics (z4c,
+//!   puncture trackers, turbulence RNG), uint64 data_size, then data_size bytes for each
+//!   MeshBlock in order of gid.  Delta and reduced restarts have an extended header
+//!   instead of data_size (see kRestartDeltaFixedSize and kRestartSoftMarker).
+
+#include <cstddef>
+#include <cstdint>
+
+namespace file_layout {
+
+//----------------------------------------------------------------------------------------
+// bin files
+
+//! \struct BinBlockHeader
+//! \brief header of each MeshBlock in bin files: output index range, logical location,
+//! physical level and bounding box.  No padding with R = float or double.
+template <typename R>
+struct BinBlockHeader {
+  std::int32_t ois, oie, ojs, oje, oks, oke;
+  std::int32_t lx1, lx2, lx3, level;
+  R x1min, x1max, x2min, x2max, x3min, x3max;
+};
+
+//! \struct BinIndexEntry
+//! \brief fixed part of each entry in the (optional) index of MeshBlocks in bin files.
+//! Each entry is followed by uint64 offset of the data of each of the nvar variables.
+template <typename R>
+struct BinIndexEntry {
+  std::int32_t gid, level, lx1, lx2, lx3, unused;
+  R x1min, x1max, x2min, x2max, x3min, x3max;
+  std::uint64_t block_offset;   // offset in file of BinBlockHeader of this MeshBlock
+};
+
+template <typename R>
+constexpr std::size_t BinIndexEntrySize(int nvar) {
+  return sizeof(BinIndexEntry<R>) + nvar*sizeof(std::uint64_t);
+}
+
+//! \struct BinIndexTrailer
+//! \brief last 32 bytes of bin files with an index of MeshBlocks
+struct BinIndexTrailer {
+  std::uint64_t index_offset;   // offset in file of first BinIndexEntry
+  std::uint64_t nblocks;        // number of entries
+  std::uint64_t entry_size;     // size of each entry (including variable offsets)
+  char magic[8];                // kBinIndexMagic (not null-terminated)
+};
+constexpr char kBinIndexMagic[9] = "ATHINDEX";
+
+// each compressed variable starts with double vmin, double step, int32 nbits (unpadded),
+// followed by (nbits*cells+7)/8 bytes of quantized values packed LSB first.  Variables
+// that would need more than 32 bits are stored unquantized as double[cells] instead,
+// flagged by nbits = kCompressedRawBits (so the size is given by the same formula).
+constexpr std::size_t kCompressedVarHeaderSize = 2*sizeof(double) + sizeof(std::int32_t);
+constexpr std::int32_t kCompressedRawBits = 64;
+
+static_assert(sizeof(BinBlockHeader<float>) == 10*4 + 6*4, "padding in BinBlockHeader");
+static_assert(sizeof(BinBlockHeader<double>) == 10*4 + 6*8, "padding in BinBlockHeader");
+static_assert(sizeof(BinIndexEntry<float>) == 6*4 + 6*4 + 8, "padding in BinIndexEntry");
+static_assert(sizeof(BinIndexEntry<double>) == 6*4 + 6*8 + 8, "padding in BinIndexEntry");
+static_assert(sizeof(BinIndexTrailer) == 32, "padding in BinIndexTrailer");
+
+//----------------------------------------------------------------------------------------
+// restart files
+
+constexpr char kParEnd[] = "<par_end>";
+
+//! \struct RestartRegionSize, RestartRegionIndcs, RestartLocation
+//! \brief copies of RegionSize, RegionIndcs and LogicalLocation (mesh.hpp), which are
+//! written to restart files as raw bytes.  restart.cpp checks that their sizes agree.
+template <typename R>
+struct RestartRegionSize {
+  R x1min, x2min, x3min;
+  R x1max, x2max, x3max;
+  R dx1, dx2, dx3;
+  R idx1, idx2, idx3;
+};
+
+struct RestartRegionIndcs {
+  int ng;
+  int nx1, nx2, nx3;
+  int is, ie, js, je, ks, ke;
+  int cnx1, cnx2, cnx3;
+  int cis, cie, cjs, cje, cks, cke;
+};
+
+struct RestartLocation {
+  std::int32_t lx1, lx2, lx3, level;
+};
+
+//! \struct RestartMeshHeader
+//! \brief Mesh information written after the input parameters.  Fields are written one
+//! after another without padding (RestartMeshHeaderSize() bytes), so they must be read
+//! field by field.
+template <typename R>
+struct RestartMeshHeader {
+  int nmb_total, root_level;
+  RestartRegionSize<R> mesh_size;
+  RestartRegionIndcs mesh_indcs, mb_indcs;
+  R time, dt;
+  int ncycle;
+};
+
+template <typename R>
+constexpr std::size_t RestartMeshHeaderSize() {
+  return 3*sizeof(int) + 2*sizeof(R) + sizeof(RestartRegionSize<R>) +
+         2*sizeof(RestartRegionIndcs);
+}
+
+// delta restarts write the following instead of data_size (all fields unpadded):
+//   uint64 0, uint64 data_size, uint64 offset of data in full file,
+//   int len, char[len] name of full file, int ndelta, int gid[ndelta]
+constexpr std::size_t kRestartDeltaFixedSize = 3*sizeof(std::uint64_t) + sizeof(int);
+
+// reduced ("soft") restarts, containing a subset of modules and/or values stored as
+// float, write the following instead of data_size (all fields unpadded):
+//   uint64 kRestartSoftMarker, uint64 data_size, int32 bytes per value, int32 modules
+// where modules is a bitwise OR of RestartModule flags.  Data of each MeshBlock is
+// stored in the same order as in full restarts, without the modules not written.
+constexpr std::uint64_t kRestartSoftMarker = ~static_cast<std::uint64_t>(0);
+constexpr std::size_t kRestartSoftHeaderSize = 2*sizeof(std::uint64_t) +
+                                              2*sizeof(std::int32_t);
+enum RestartModule : std::int32_t {
+  kRestartHydro = 1, kRestartMHD = 2, kRestartRad = 4, kRestartForce = 8,
+  kRestartZ4c = 16, kRestartADM = 32, kRestartAll = 63
+};
+
+} // namespace file_layout
+
+#endif // OUTPUTS_FILE_LAYOUT_HPP_
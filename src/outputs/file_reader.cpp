@@ -0,0 +1,523 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file file_reader.cpp
+//! \brief implements the standalone reader library for bin and restart files, see
+//! file_reader.hpp.  Compiled into library athena_reader, not into the athena executable.
+
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "outputs/file_reader.hpp"
+
+namespace file_reader {
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn T Load()
+//! \brief loads value of type T stored (possibly unaligned) at p
+
+template <typename T>
+T Load(const char *p) {
+  T val;
+  std::memcpy(&val, p, sizeof(T));
+  return val;
+}
+
+void Fatal(const std::string &fname, const std::string &msg) {
+  std::cout << "### FATAL ERROR in file_reader reading '" << fname << "'" << std::endl
+            << msg << std::endl;
+  std::exit(EXIT_FAILURE);
+}
+
+std::string Trim(const std::string &s) {
+  std::size_t first = s.find_first_not_of(" \t\r");
+  if (first == std::string::npos) {return "";}
+  return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// MappedFile constructor: maps whole file read-only
+
+MappedFile::MappedFile(const std::string &fname) : name_(fname) {
+  int fd = open(fname.c_str(), O_RDONLY);
+  if (fd < 0) {
+    Fatal(fname, "File could not be opened");
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    Fatal(fname, "Size of file could not be determined");
+  }
+  size_ = static_cast<std::size_t>(st.st_size);
+  if (size_ > 0) {
+    void *p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      close(fd);
+      Fatal(fname, "File could not be memory-mapped");
+    }
+    data_ = static_cast<const char*>(p);
+  }
+  close(fd);   // mapping stays valid after file is closed
+}
+
+MappedFile::~MappedFile() {
+  Unmap();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept :
+  name_(std::move(other.name_)), data_(other.data_), size_(other.size_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    Unmap();
+    name_ = std::move(other.name_);
+    data_ = other.data_;
+    size_ = other.size_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+void MappedFile::Unmap() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// BinFile constructor: parses text header, then reads index of MeshBlocks (if present)
+// or headers of all MeshBlocks
+
+BinFile::BinFile(const std::string &fname) : time(0.0), cycle(0), location_size(0),
+    compressed(false), indexed(false), file_(fname) {
+  const char *p = file_.data();
+  std::size_t pos = 0, size = file_.size();
+  auto next_line = [&]() {
+    std::size_t end = pos;
+    while (end < size && p[end] != '\n') {++end;}
+    if (end >= size) {Fatal(fname, "Unexpected end of file in header");}
+    std::string line(p + pos, end - pos);
+    pos = end + 1;
+    return line;
+  };
+  std::string line = next_line();
+  if (line.compare(0, 6, "Athena") != 0) {
+    Fatal(fname, "Not an Athena bin file");
+  }
+  version = Trim(line.substr(line.find('=') + 1));
+  if (version != "1.1" && version != "1.2" && version != "1.3") {
+    Fatal(fname, "Unsupported bin file version " + version);
+  }
+  // parse "key=value" lines up to "variables:" line
+  int nvar = -1;
+  while (true) {
+    line = next_line();
+    std::size_t eq = line.find('=');
+    if (eq == std::string::npos) {
+      std::istringstream is(line);
+      std::string v;
+      is >> v;                                // "variables:"
+      while (is >> v) {variables.push_back(v);}
+      break;
+    }
+    std::string key = Trim(line.substr(0, eq)), val = Trim(line.substr(eq + 1));
+    if (key == "time") {
+      time = std::stod(val);
+    } else if (key == "cycle") {
+      cycle = std::stoi(val);
+    } else if (key == "size of location") {
+      location_size = std::stoi(val);
+    } else if (key == "size of variable") {
+      if (std::stoi(val) != sizeof(float)) {Fatal(fname, "Unsupported variable size");}
+    } else if (key == "compression") {
+      compressed = (val == "quantized");
+    } else if (key == "block index") {
+      indexed = (val == "footer");
+    } else if (key == "number of variables") {
+      nvar = std::stoi(val);
+    }
+  }
+  if (nvar != static_cast<int>(variables.size())) {
+    Fatal(fname, "Number of variables does not match list of variables");
+  }
+  line = next_line();                         // "header offset=N"
+  std::size_t npar = std::stoul(line.substr(line.find('=') + 1));
+  if (pos + npar > size) {Fatal(fname, "Unexpected end of file in parameters");}
+  parameters.assign(p + pos, npar);
+  pos += npar;
+
+  std::size_t data_end = size;
+  file_layout::BinIndexTrailer trailer;
+  if (indexed) {
+    if (size < pos + sizeof(trailer)) {Fatal(fname, "Index of MeshBlocks is missing");}
+    trailer = Load<file_layout::BinIndexTrailer>(p + size - sizeof(trailer));
+    if (std::memcmp(trailer.magic, file_layout::kBinIndexMagic, 8) != 0) {
+      Fatal(fname, "Index of MeshBlocks is missing (file incomplete?)");
+    }
+    data_end = trailer.index_offset;
+  }
+  if (location_size == sizeof(float)) {
+    if (indexed) {
+      ReadIndex<float>(trailer.index_offset, trailer.nblocks, trailer.entry_size);
+    } else {
+      ScanBlocks<float>(pos, data_end);
+    }
+  } else if (location_size == sizeof(double)) {
+    if (indexed) {
+      ReadIndex<double>(trailer.index_offset, trailer.nblocks, trailer.entry_size);
+    } else {
+      ScanBlocks<double>(pos, data_end);
+    }
+  } else {
+    Fatal(fname, "Unsupported location size");
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BinFile::ReadBlockHeader()
+//! \brief reads BinBlockHeader at offset into blk
+
+template <typename R>
+void BinFile::ReadBlockHeader(std::size_t offset, BinBlock &blk) const {
+  if (offset + sizeof(file_layout::BinBlockHeader<R>) > file_.size()) {
+    Fatal(file_.name(), "Unexpected end of file in MeshBlock header");
+  }
+  auto h = Load<file_layout::BinBlockHeader<R>>(file_.data() + offset);
+  blk.ois = h.ois; blk.oie = h.oie;
+  blk.ojs = h.ojs; blk.oje = h.oje;
+  blk.oks = h.oks; blk.oke = h.oke;
+  blk.lx1 = h.lx1; blk.lx2 = h.lx2; blk.lx3 = h.lx3;
+  blk.level = h.level;
+  blk.x1min = h.x1min; blk.x1max = h.x1max;
+  blk.x2min = h.x2min; blk.x2max = h.x2max;
+  blk.x3min = h.x3min; blk.x3max = h.x3max;
+  blk.offset = offset;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BinFile::ReadIndex()
+//! \brief reads index of MeshBlocks at end of version 1.3 files
+
+template <typename R>
+void BinFile::ReadIndex(std::size_t index_offset, std::size_t nblocks,
+                        std::size_t entry_size) {
+  int nvar = variables.size();
+  if (entry_size != file_layout::BinIndexEntrySize<R>(nvar) ||
+      index_offset + nblocks*entry_size > file_.size()) {
+    Fatal(file_.name(), "Index of MeshBlocks is inconsistent with header");
+  }
+  blocks_.resize(nblocks);
+  for (std::size_t b=0; b<nblocks; ++b) {
+    const char *pe = file_.data() + index_offset + b*entry_size;
+    auto e = Load<file_layout::BinIndexEntry<R>>(pe);
+    BinBlock &blk = blocks_[b];
+    ReadBlockHeader<R>(e.block_offset, blk);
+    blk.gid = e.gid;
+    blk.var_offset.resize(nvar);
+    for (int n=0; n<nvar; ++n) {
+      blk.var_offset[n] = Load<std::uint64_t>(pe + sizeof(e) + n*sizeof(std::uint64_t));
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BinFile::ScanBlocks()
+//! \brief reads headers of all MeshBlocks stored in [data_offset, data_end), for files
+//! without an index
+
+template <typename R>
+void BinFile::ScanBlocks(std::size_t data_offset, std::size_t data_end) {
+  int nvar = variables.size();
+  std::size_t pos = data_offset;
+  while (pos < data_end) {
+    BinBlock blk;
+    ReadBlockHeader<R>(pos, blk);
+    blk.gid = blocks_.size();
+    std::size_t cells = static_cast<std::size_t>(blk.nx1())*blk.nx2()*blk.nx3();
+    pos += sizeof(file_layout::BinBlockHeader<R>);
+    blk.var_offset.resize(nvar);
+    for (int n=0; n<nvar; ++n) {
+      blk.var_offset[n] = pos;
+      if (compressed) {
+        if (pos + file_layout::kCompressedVarHeaderSize > data_end) {
+          Fatal(file_.name(), "Unexpected end of file in compressed data");
+        }
+        auto nbits = Load<std::int32_t>(file_.data() + pos + 2*sizeof(double));
+        pos += file_layout::kCompressedVarHeaderSize + (nbits*cells + 7)/8;
+      } else {
+        pos += cells*sizeof(float);
+      }
+    }
+    if (pos > data_end) {Fatal(file_.name(), "Unexpected end of file in MeshBlock data");}
+    blocks_.push_back(std::move(blk));
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int BinFile::VariableIndex()
+//! \brief returns index of variable with given name, or -1 if it is not in file
+
+int BinFile::VariableIndex(const std::string &name) const {
+  for (std::size_t n=0; n<variables.size(); ++n) {
+    if (variables[n] == name) {return static_cast<int>(n);}
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn ArrayView<float,3> BinFile::Variable()
+//! \brief returns zero-copy view of variable n on MeshBlock b
+
+ArrayView<float, 3> BinFile::Variable(int b, int n) const {
+  if (compressed) {
+    Fatal(file_.name(), "Compressed variables cannot be viewed, use ReadVariable()");
+  }
+  if (b < 0 || b >= nblocks() || n < 0 || n >= static_cast<int>(variables.size())) {
+    Fatal(file_.name(), "MeshBlock or variable index out of range");
+  }
+  const BinBlock &blk = blocks_[b];
+  return ArrayView<float, 3>(file_.data() + blk.var_offset[n],
+                             {blk.nx3(), blk.nx2(), blk.nx1()});
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BinFile::ReadVariable()
+//! \brief copies variable n on MeshBlock b into out, decoding quantized data of
+//! compressed files (values are vmin + q*step, q packed LSB first with nbits each, or
+//! doubles if nbits = kCompressedRawBits)
+
+void BinFile::ReadVariable(int b, int n, std::vector<float> &out) const {
+  if (!compressed) {
+    auto v = Variable(b, n);
+    out.resize(v.size());
+    v.CopyTo(out.data());
+    return;
+  }
+  if (b < 0 || b >= nblocks() || n < 0 || n >= static_cast<int>(variables.size())) {
+    Fatal(file_.name(), "MeshBlock or variable index out of range");
+  }
+  const BinBlock &blk = blocks_[b];
+  std::size_t cells = static_cast<std::size_t>(blk.nx1())*blk.nx2()*blk.nx3();
+  const char *p = file_.data() + blk.var_offset[n];
+  double vmin = Load<double>(p);
+  double step = Load<double>(p + sizeof(double));
+  int nbits = Load<std::int32_t>(p + 2*sizeof(double));
+  const unsigned char *q = reinterpret_cast<const unsigned char*>(
+                           p + file_layout::kCompressedVarHeaderSize);
+  out.resize(cells);
+  if (nbits == file_layout::kCompressedRawBits) {
+    for (std::size_t c=0; c<cells; ++c) {
+      out[c] = static_cast<float>(Load<double>(p + file_layout::kCompressedVarHeaderSize
+                                               + c*sizeof(double)));
+    }
+    return;
+  }
+  std::uint64_t acc = 0, mask = (nbits < 64)? ((std::uint64_t(1) << nbits) - 1) : ~0ULL;
+  int nacc = 0;
+  for (std::size_t c=0; c<cells; ++c) {
+    while (nacc < nbits) {
+      acc |= static_cast<std::uint64_t>(*q++) << nacc;
+      nacc += 8;
+    }
+    out[c] = static_cast<float>(vmin + static_cast<double>(acc & mask)*step);
+    if (nbits > 0) {
+      acc >>= nbits;
+      nacc -= nbits;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// RestartFile constructor: reads header, and for delta restarts maps the referenced full
+// restart.  Since the internal state of physics written before the data has a size that
+// depends on the physics, the start of the data is found as the only position where the
+// size of the data is consistent with the size of the file.
+
+RestartFile::RestartFile(const std::string &fname) : real_size(0), value_size(0),
+    modules(file_layout::kRestartAll), data_size(0), nout1(0), nout2(0), nout3(0),
+    delta(false), file_(fname), data_offset_(0), base_offset_(0) {
+  const char *p = file_.data();
+  std::size_t size = file_.size();
+  std::string head(p, std::min<std::size_t>(size, 1 << 20));
+  std::size_t loc = head.find(file_layout::kParEnd);
+  if (loc == std::string::npos) {
+    Fatal(fname, "<par_end> not found, not a restart file");
+  }
+  std::size_t offset = loc + std::strlen(file_layout::kParEnd) + 1;
+  parameters.assign(p, offset);
+  // try Real of both sizes
+  if (!ReadHeader<double>(offset) && !ReadHeader<float>(offset)) {
+    Fatal(fname, "Restart file is inconsistent (node-local file, or truncated?)");
+  }
+  auto &indcs = mesh.mb_indcs;
+  nout1 = indcs.nx1 + 2*indcs.ng;
+  nout2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
+  nout3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*indcs.ng) : 1;
+
+  if (delta) {
+    // name of full restart is relative to run directory, which is the parent of rst/
+    std::string dir = fname.substr(0, fname.find_last_of('/') + 1);
+    std::string cand[3] = {dir + "../" + base_name, base_name,
+                           dir + base_name.substr(base_name.find_last_of('/') + 1)};
+    for (auto &c : cand) {
+      if (access(c.c_str(), R_OK) == 0) {
+        base_ = MappedFile(c);
+        break;
+      }
+    }
+    if (base_.data() == nullptr) {
+      Fatal(fname, "Full restart '" + base_name + "' of delta restart not found");
+    }
+    if (base_offset_ + mesh.nmb_total*data_size > base_.size()) {
+      Fatal(fname, "Full restart '" + base_.name() + "' is too small");
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn bool RestartFile::ReadHeader()
+//! \brief reads Mesh header, locations and costs assuming Real of type R, then searches
+//! for the data.  Returns false if the file is inconsistent with this type of Real.
+
+template <typename R>
+bool RestartFile::ReadHeader(std::size_t offset) {
+  const char *p = file_.data();
+  std::size_t size = file_.size();
+  if (offset + file_layout::RestartMeshHeaderSize<R>() > size) {return false;}
+  const char *ph = p + offset;
+  mesh.nmb_total = Load<int>(ph);  ph += sizeof(int);
+  mesh.root_level = Load<int>(ph); ph += sizeof(int);
+  auto ms = Load<file_layout::RestartRegionSize<R>>(ph);
+  ph += sizeof(ms);
+  mesh.mesh_size = {ms.x1min, ms.x2min, ms.x3min, ms.x1max, ms.x2max, ms.x3max,
+                    ms.dx1, ms.dx2, ms.dx3, ms.idx1, ms.idx2, ms.idx3};
+  mesh.mesh_indcs = Load<file_layout::RestartRegionIndcs>(ph);
+  ph += sizeof(file_layout::RestartRegionIndcs);
+  mesh.mb_indcs = Load<file_layout::RestartRegionIndcs>(ph);
+  ph += sizeof(file_layout::RestartRegionIndcs);
+  mesh.time = Load<R>(ph); ph += sizeof(R);
+  mesh.dt = Load<R>(ph);   ph += sizeof(R);
+  mesh.ncycle = Load<int>(ph);
+  offset += file_layout::RestartMeshHeaderSize<R>();
+
+  std::size_t nmb = mesh.nmb_total;
+  if (mesh.nmb_total <= 0 || offset + nmb*(sizeof(file_layout::RestartLocation) +
+      sizeof(float)) > size) {return false;}
+  lloc.resize(nmb);
+  std::memcpy(lloc.data(), p + offset, nmb*sizeof(file_layout::RestartLocation));
+  offset += nmb*sizeof(file_layout::RestartLocation);
+  cost.resize(nmb);
+  std::memcpy(cost.data(), p + offset, nmb*sizeof(float));
+  offset += nmb*sizeof(float);
+
+  // search for data size (or delta header) consistent with size of file, at most 64 KB
+  // after costs.  Size of each MeshBlock must be a multiple of sizeof(R).
+  for (std::size_t pos=offset; pos + sizeof(std::uint64_t) <= size &&
+       pos <= offset + 65536; ++pos) {
+    auto ds = Load<std::uint64_t>(p + pos);
+    if (ds == file_layout::kRestartSoftMarker) {
+      // reduced restart
+      if (pos + file_layout::kRestartSoftHeaderSize > size) {continue;}
+      ds = Load<std::uint64_t>(p + pos + sizeof(std::uint64_t));
+      auto vsize = Load<std::int32_t>(p + pos + 2*sizeof(std::uint64_t));
+      auto mods = Load<std::int32_t>(p + pos + 2*sizeof(std::uint64_t) +
+                                     sizeof(std::int32_t));
+      std::size_t dstart = pos + file_layout::kRestartSoftHeaderSize;
+      if ((vsize != sizeof(float) && vsize != sizeof(double)) || ds % vsize != 0 ||
+          dstart + nmb*ds != size) {continue;}
+      data_size = ds;
+      data_offset_ = dstart;
+      real_size = sizeof(R);
+      value_size = vsize;
+      modules = mods;
+      return true;
+    }
+    if (ds > 0) {
+      if (ds % sizeof(R) == 0 && pos + sizeof(std::uint64_t) + nmb*ds == size) {
+        data_size = ds;
+        data_offset_ = pos + sizeof(std::uint64_t);
+        real_size = sizeof(R);
+        value_size = sizeof(R);
+        return true;
+      }
+      continue;
+    }
+    // delta restart
+    if (pos + file_layout::kRestartDeltaFixedSize > size) {continue;}
+    ds = Load<std::uint64_t>(p + pos + sizeof(std::uint64_t));
+    auto base_off = Load<std::uint64_t>(p + pos + 2*sizeof(std::uint64_t));
+    int len = Load<int>(p + pos + 3*sizeof(std::uint64_t));
+    std::size_t q = pos + file_layout::kRestartDeltaFixedSize;
+    if (ds == 0 || ds % sizeof(R) != 0 || len <= 0 || len > 4096 ||
+        q + len + sizeof(int) > size) {continue;}
+    int ndelta = Load<int>(p + q + len);
+    std::size_t dstart = q + len + sizeof(int) + ndelta*sizeof(int);
+    if (ndelta < 0 || ndelta > mesh.nmb_total || dstart + ndelta*ds != size) {continue;}
+    base_name.assign(p + q, len);
+    delta = true;
+    data_size = ds;
+    data_offset_ = dstart;
+    base_offset_ = base_off;
+    delta_slot_.assign(nmb, -1);
+    for (int n=0; n<ndelta; ++n) {
+      int gid = Load<int>(p + q + len + sizeof(int) + n*sizeof(int));
+      if (gid >= 0 && gid < mesh.nmb_total) {delta_slot_[gid] = n;}
+    }
+    real_size = sizeof(R);
+    value_size = sizeof(R);
+    return true;
+  }
+  return false;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn const char *RestartFile::BlockData()
+//! \brief returns pointer to data of MeshBlock gid (data_size bytes)
+
+const char *RestartFile::BlockData(int gid) const {
+  if (gid < 0 || gid >= mesh.nmb_total) {
+    Fatal(file_.name(), "MeshBlock gid out of range");
+  }
+  if (delta && delta_slot_[gid] < 0) {
+    return base_.data() + base_offset_ + gid*data_size;
+  }
+  int slot = (delta)? delta_slot_[gid] : gid;
+  return file_.data() + data_offset_ + slot*data_size;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartFile::CheckType()
+//! \brief checks that views of nreal values of size tsize fit in data of a MeshBlock
+
+void RestartFile::CheckType(std::size_t tsize, std::size_t nreal) const {
+  if (tsize != static_cast<std::size_t>(value_size)) {
+    Fatal(file_.name(), "Type of view does not match size of values in restart file ("
+          + std::to_string(value_size) + " bytes)");
+  }
+  if (nreal*tsize > data_size) {
+    Fatal(file_.name(), "View extends beyond data of MeshBlock");
+  }
+}
+
+} // namespace file_reader
@@ -0,0 +1,253 @@
+#ifndef OUTPUTS_FILE_READER_HPP_
+#define OUTPUTS_FILE_READER_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file file_reader.hpp
+//! \brief Standalone library (target athena_reader) for reading bin and restart files in
+//! analysis codes, built from the record layouts in file_layout.hpp used by the writers.
+//! Files are memory-mapped, and the data of each variable on each MeshBlock is returned
+//! as an ArrayView into the mapping, so only pages that are accessed are read from disk.
+//! e.g.
+//!   file_reader::BinFile bin("bin/Blast.prim.00010.bin");
+//!   int n = bin.VariableIndex("dens");
+//!   for (int b=0; b<bin.nblocks(); ++b) {
+//!     auto d = bin.Variable(b, n);            // d(k,j,i), no copy
+//!   }
+//! The library does not depend on Kokkos or MPI.  If Kokkos_Core.hpp is included before
+//! this file, HostView() and DeviceView() convert ArrayViews to Kokkos::Views.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "outputs/file_layout.hpp"
+
+namespace file_reader {
+
+//----------------------------------------------------------------------------------------
+//! \class MappedFile
+//! \brief read-only memory map of a whole file, unmapped on destruction
+
+class MappedFile {
+ public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string &fname);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile &operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  const char *data() const {return data_;}
+  std::size_t size() const {return size_;}
+  const std::string &name() const {return name_;}
+
+ private:
+  std::string name_;
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+  void Unmap();
+};
+
+//----------------------------------------------------------------------------------------
+//! \class ArrayView
+//! \brief zero-copy view of an N-dimensional array of T stored contiguously (LayoutRight,
+//! last index fastest) in a mapped file.  Data in files need not be aligned, so elements
+//! are loaded with memcpy (a plain load on all common platforms); data() can be used
+//! directly only if aligned() is true.
+
+template <typename T, int N>
+class ArrayView {
+ public:
+  ArrayView() = default;
+  ArrayView(const char *p, const std::array<int, N> &ext) : ptr_(p), ext_(ext) {}
+
+  int extent(int d) const {return ext_[d];}
+  std::size_t size() const {
+    std::size_t s = 1;
+    for (int d=0; d<N; ++d) {s *= static_cast<std::size_t>(ext_[d]);}
+    return s;
+  }
+  const char *bytes() const {return ptr_;}
+  bool aligned() const {
+    return (reinterpret_cast<std::uintptr_t>(ptr_) % alignof(T)) == 0;
+  }
+  const T *data() const {return reinterpret_cast<const T*>(ptr_);}
+
+  template <typename... I>
+  T operator()(I... idx) const {
+    static_assert(sizeof...(I) == N, "wrong number of indices to ArrayView");
+    std::size_t n = 0;
+    int d = 0;
+    for (auto i : {static_cast<std::size_t>(idx)...}) {n = n*ext_[d++] + i;}
+    T val;
+    std::memcpy(&val, ptr_ + n*sizeof(T), sizeof(T));
+    return val;
+  }
+  void CopyTo(T *dst) const {std::memcpy(dst, ptr_, size()*sizeof(T));}
+
+ private:
+  const char *ptr_ = nullptr;
+  std::array<int, N> ext_{};
+};
+
+//----------------------------------------------------------------------------------------
+//! \struct BinBlock
+//! \brief location and bounding box of a MeshBlock in a bin file, and offsets in the file
+//! of its data
+
+struct BinBlock {
+  int gid;                             // from index, else position of MeshBlock in file
+  int level, lx1, lx2, lx3;            // physical level and logical location
+  int ois, oie, ojs, oje, oks, oke;    // output index range (including ghost zones)
+  double x1min, x1max, x2min, x2max, x3min, x3max;
+  std::size_t offset;                  // offset of BinBlockHeader
+  std::vector<std::size_t> var_offset; // offset of data of each variable
+  int nx1() const {return oie - ois + 1;}
+  int nx2() const {return oje - ojs + 1;}
+  int nx3() const {return oke - oks + 1;}
+};
+
+//----------------------------------------------------------------------------------------
+//! \class BinFile
+//! \brief reader for bin files (versions 1.1-1.3).  With an index of MeshBlocks (version
+//! 1.3) only the index is read on construction, otherwise the headers of all MeshBlocks.
+
+class BinFile {
+ public:
+  explicit BinFile(const std::string &fname);
+
+  std::string version;
+  double time;
+  int cycle;
+  int location_size;                   // sizeof(Real) of code that wrote file
+  bool compressed, indexed;
+  std::vector<std::string> variables;
+  std::string parameters;              // input parameters of run
+
+  int nblocks() const {return static_cast<int>(blocks_.size());}
+  const BinBlock &block(int b) const {return blocks_[b];}
+  int VariableIndex(const std::string &name) const;   // -1 if not in file
+  // zero-copy view of variable n on MeshBlock b, indexed (k,j,i).  Not possible for
+  // compressed files, use ReadVariable() instead.
+  ArrayView<float, 3> Variable(int b, int n) const;
+  ArrayView<float, 3> Variable(int b, const std::string &name) const {
+    return Variable(b, VariableIndex(name));
+  }
+  // copies (and decompresses, if needed) variable n on MeshBlock b into out
+  void ReadVariable(int b, int n, std::vector<float> &out) const;
+
+ private:
+  MappedFile file_;
+  std::vector<BinBlock> blocks_;
+  template <typename R> void ReadIndex(std::size_t index_offset, std::size_t nblocks,
+                                       std::size_t entry_size);
+  template <typename R> void ScanBlocks(std::size_t data_offset, std::size_t data_end);
+  template <typename R> void ReadBlockHeader(std::size_t offset, BinBlock &blk) const;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class RestartFile
+//! \brief reader for restart files written to rst/ (full or delta restarts; node-local
+//! files are not supported).  The data of each MeshBlock is stored in order:
+//!   hydro u0 (nhydro+nscalars), mhd u0 (nmhd+nscalars), b0.x1f, b0.x2f, b0.x3f,
+//!   radiation i0, turbulence force (3), z4c u0 or adm u_adm
+//! for the physics enabled in parameters, with ghost zones (extents nout3,nout2,nout1).
+//! Reduced restarts contain only the given modules, possibly with values stored as float.
+//! CellVars() and FaceField() return views starting first values into this data.  For
+//! delta restarts, unchanged MeshBlocks are read from the referenced full restart.
+
+class RestartFile {
+ public:
+  explicit RestartFile(const std::string &fname);
+
+  std::string parameters;              // input parameters of run (including <par_end>)
+  int real_size;                       // sizeof(Real) of code that wrote file
+  int value_size;                      // bytes per value in data (4 with single prec.)
+  int modules;                         // file_layout::RestartModule flags of data
+  file_layout::RestartMeshHeader<double> mesh;
+  std::vector<file_layout::RestartLocation> lloc;
+  std::vector<float> cost;
+  std::size_t data_size;               // bytes of data of each MeshBlock
+  int nout1, nout2, nout3;
+  bool delta;
+  std::string base_name;               // full restart referenced by delta restart
+
+  int nmb_total() const {return mesh.nmb_total;}
+  const char *BlockData(int gid) const;
+  template <typename T>
+  ArrayView<T, 4> CellVars(int gid, std::size_t first, int nvar) const {
+    CheckType(sizeof(T), first + static_cast<std::size_t>(nvar)*nout1*nout2*nout3);
+    return ArrayView<T, 4>(BlockData(gid) + first*sizeof(T), {nvar, nout3, nout2, nout1});
+  }
+  template <typename T>
+  ArrayView<T, 3> FaceField(int gid, std::size_t first, int dir) const {
+    std::array<int, 3> ext = {nout3 + (dir == 3), nout2 + (dir == 2), nout1 + (dir == 1)};
+    CheckType(sizeof(T), first + static_cast<std::size_t>(ext[0])*ext[1]*ext[2]);
+    return ArrayView<T, 3>(BlockData(gid) + first*sizeof(T), ext);
+  }
+
+ private:
+  MappedFile file_, base_;
+  std::size_t data_offset_, base_offset_;
+  std::vector<int> delta_slot_;        // position of each gid in delta file, or -1
+  template <typename R> bool ReadHeader(std::size_t offset);
+  void CheckType(std::size_t tsize, std::size_t nreal) const;
+};
+
+#if defined(KOKKOS_VERSION)
+//----------------------------------------------------------------------------------------
+//! \fn HostView(), DeviceView()
+//! \brief Kokkos::Views of an ArrayView (N = 3 or 4).  HostView() wraps the mapped data
+//! without copying if it is aligned, DeviceView() copies it to the memory space of
+//! ExecSpace.
+
+template <typename T, int N> struct KokkosDataType {
+  using type = typename KokkosDataType<T, N-1>::type*;
+};
+template <typename T> struct KokkosDataType<T, 0> {using type = T;};
+
+template <typename T, int N>
+Kokkos::View<typename KokkosDataType<const T, N>::type, Kokkos::LayoutRight,
+             Kokkos::HostSpace> HostView(const ArrayView<T, N> &a) {
+  static_assert(N == 3 || N == 4, "HostView() only implemented for 3D and 4D arrays");
+  using ConstView = Kokkos::View<typename KokkosDataType<const T, N>::type,
+                                 Kokkos::LayoutRight, Kokkos::HostSpace>;
+  using View = Kokkos::View<typename KokkosDataType<T, N>::type, Kokkos::LayoutRight,
+                            Kokkos::HostSpace>;
+  if (a.aligned()) {
+    Kokkos::View<typename KokkosDataType<const T, N>::type, Kokkos::LayoutRight,
+                 Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>> u;
+    if constexpr (N == 3) {
+      u = decltype(u)(a.data(), a.extent(0), a.extent(1), a.extent(2));
+    } else {
+      u = decltype(u)(a.data(), a.extent(0), a.extent(1), a.extent(2), a.extent(3));
+    }
+    return ConstView(u);
+  }
+  View v;
+  if constexpr (N == 3) {
+    v = View("file_reader", a.extent(0), a.extent(1), a.extent(2));
+  } else {
+    v = View("file_reader", a.extent(0), a.extent(1), a.extent(2), a.extent(3));
+  }
+  a.CopyTo(v.data());
+  return ConstView(v);
+}
+
+template <typename ExecSpace = Kokkos::DefaultExecutionSpace, typename T, int N>
+auto DeviceView(const ArrayView<T, N> &a) {
+  return Kokkos::create_mirror_view_and_copy(typename ExecSpace::memory_space(),
+                                             HostView(a));
+}
+#endif // KOKKOS_VERSION
+
+} // namespace file_reader
+
+#endif // OUTPUTS_FILE_READER_HPP_
@@ -7,12 +7,14 @@
 //  \brief writes history output data, volume-averaged quantities that are output
 //         frequently in time to trace their evolution.
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -48,6 +50,8 @@ HistoryOutput::HistoryOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
   if (pm->pmb_pack->pz4c != nullptr) {
     hist_data.emplace_back(PhysicsModule::SpaceTimeDynamics);
   }
+  Kokkos::realloc(d_hsum, hist_data.size());
+  h_hsum = Kokkos::create_mirror_view(d_hsum);
 }
 
 //----------------------------------------------------------------------------------------
@@ -56,6 +60,9 @@ HistoryOutput::HistoryOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
 //  appropriate LoadXXXData() function for that physics
 
 void HistoryOutput::LoadOutputData(Mesh *pm) {
+  out_time = pm->time;
+  out_cycle = pm->ncycle;
+  out_dt = pm->dt;
   for (auto &data : hist_data) {
     if (data.physics == PhysicsModule::HydroDynamics) {
       LoadHydroHistoryData(&data, pm);
@@ -67,6 +74,27 @@ void HistoryOutput::LoadOutputData(Mesh *pm) {
       (pm->pgen->user_hist_func)(&data, pm);
     }
   }
+
+  // single copy of the device results of all built-in physics to hdata
+  Kokkos::deep_copy(h_hsum, d_hsum);
+  for (std::size_t ih=0; ih<hist_data.size(); ++ih) {
+    if (hist_data[ih].physics != PhysicsModule::UserDefined) {
+      for (int n=0; n<hist_data[ih].nhist; ++n) {
+        hist_data[ih].hdata[n] = h_hsum(ih).the_array[n];
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn BaseTypeOutput* HistoryOutput::Clone()
+//! \brief Returns copy of this output (with loaded data) to be written asynchronously.
+//! The copy writes any headers not yet written, so they are marked as written here.
+
+BaseTypeOutput* HistoryOutput::Clone() {
+  HistoryOutput *pcopy = new HistoryOutput(*this);
+  for (auto &data : hist_data) {data.header_written = true;}
+  return pcopy;
 }
 
 //----------------------------------------------------------------------------------------
@@ -108,7 +136,10 @@ void HistoryOutput::LoadHydroHistoryData(HistoryData *pdata, Mesh *pm) {
   const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
-  array_sum::GlobalSum sum_this_mb;
+  // reduce into device result for this physics without waiting for the kernel, results
+  // of all physics are copied to hdata at once in LoadOutputData()
+  Kokkos::View<array_sum::GlobalSum, DevMemSpace> sum_this_mb(
+      d_hsum.data() + (pdata - hist_data.data()));
   Kokkos::parallel_reduce("HistSums",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
   KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
     // compute n,k,j,i indices of thread
@@ -143,12 +174,7 @@ void HistoryOutput::LoadHydroHistoryData(HistoryData *pdata, Mesh *pm) {
 
     // sum into parallel reduce
     mb_sum += hvars;
-  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_mb));
-
-  // store data into hdata array
-  for (int n=0; n<pdata->nhist; ++n) {
-    pdata->hdata[n] = sum_this_mb.the_array[n];
-  }
+  }, Kokkos::Sum<array_sum::GlobalSum, DevMemSpace>(sum_this_mb));
 
   return;
 }
@@ -186,7 +212,10 @@ void HistoryOutput::LoadZ4cHistoryData(HistoryData *pdata, Mesh *pm) {
   const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
-  array_sum::GlobalSum sum_this_mb;
+  // reduce into device result for this physics without waiting for the kernel, results
+  // of all physics are copied to hdata at once in LoadOutputData()
+  Kokkos::View<array_sum::GlobalSum, DevMemSpace> sum_this_mb(
+      d_hsum.data() + (pdata - hist_data.data()));
   Kokkos::parallel_reduce("HistSums",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
   KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
     // compute n,k,j,i indices of thread
@@ -217,12 +246,7 @@ void HistoryOutput::LoadZ4cHistoryData(HistoryData *pdata, Mesh *pm) {
 
     // sum into parallel reduce
     mb_sum += hvars;
-  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_mb));
-
-  // store data into hdata array
-  for (int n=0; n<pdata->nhist; ++n) {
-    pdata->hdata[n] = sum_this_mb.the_array[n];
-  }
+  }, Kokkos::Sum<array_sum::GlobalSum, DevMemSpace>(sum_this_mb));
 
   return;
 }
@@ -272,7 +296,10 @@ void HistoryOutput::LoadMHDHistoryData(HistoryData *pdata, Mesh *pm) {
   const int nmkji = (pm->pmb_pack->nmb_thispack)*nx3*nx2*nx1;
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
-  array_sum::GlobalSum sum_this_mb;
+  // reduce into device result for this physics without waiting for the kernel, results
+  // of all physics are copied to hdata at once in LoadOutputData()
+  Kokkos::View<array_sum::GlobalSum, DevMemSpace> sum_this_mb(
+      d_hsum.data() + (pdata - hist_data.data()));
   Kokkos::parallel_reduce("HistSums",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
   KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
     // compute n,k,j,i indices of thread
@@ -312,13 +339,7 @@ void HistoryOutput::LoadMHDHistoryData(HistoryData *pdata, Mesh *pm) {
 
     // sum into parallel reduce
     mb_sum += hvars;
-  }, Kokkos::Sum<array_sum::GlobalSum>(sum_this_mb));
-  Kokkos::fence();
-
-  // store data into hdata array
-  for (int n=0; n<pdata->nhist; ++n) {
-    pdata->hdata[n] = sum_this_mb.the_array[n];
-  }
+  }, Kokkos::Sum<array_sum::GlobalSum, DevMemSpace>(sum_this_mb));
 
   return;
 }
@@ -328,18 +349,27 @@ void HistoryOutput::LoadMHDHistoryData(HistoryData *pdata, Mesh *pm) {
 //  \brief Cycles through hist_data vector and writes history file for each component
 
 void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
-  for (auto &data : hist_data) {
-    // first, perform in-place sum over all MPI ranks
+  // first, perform sum over all MPI ranks of data for all physics in one reduction
 #if MPI_PARALLEL_ENABLED
-    if (global_variable::my_rank == 0) {
-      MPI_Reduce(MPI_IN_PLACE, &(data.hdata[0]), data.nhist, MPI_ATHENA_REAL,
-         MPI_SUM, 0, MPI_COMM_WORLD);
-    } else {
-      MPI_Reduce(&(data.hdata[0]), &(data.hdata[0]), data.nhist,
-         MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+  std::vector<Real> hbuf;
+  for (auto &data : hist_data) {
+    hbuf.insert(hbuf.end(), data.hdata, data.hdata + data.nhist);
+  }
+  if (global_variable::my_rank == 0) {
+    MPI_Reduce(MPI_IN_PLACE, hbuf.data(), hbuf.size(), MPI_ATHENA_REAL,
+       MPI_SUM, 0, io_comm);
+    std::size_t ioff = 0;
+    for (auto &data : hist_data) {
+      std::copy(hbuf.begin() + ioff, hbuf.begin() + ioff + data.nhist, data.hdata);
+      ioff += data.nhist;
     }
+  } else {
+    MPI_Reduce(hbuf.data(), nullptr, hbuf.size(), MPI_ATHENA_REAL,
+       MPI_SUM, 0, io_comm);
+  }
 #endif
 
+  for (auto &data : hist_data) {
     // only the master rank writes the file
     if (global_variable::my_rank == 0) {
       // create filename: "file_basename" + ".physics" + ".hst"
@@ -385,8 +415,8 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       }
 
       // write history variables
-      std::fprintf(pfile, out_params.data_format.c_str(), pm->time);
-      std::fprintf(pfile, out_params.data_format.c_str(), pm->dt);
+      std::fprintf(pfile, out_params.data_format.c_str(), out_time);
+      std::fprintf(pfile, out_params.data_format.c_str(), out_dt);
       for (int n=0; n<data.nhist; ++n)
         std::fprintf(pfile, out_params.data_format.c_str(), data.hdata[n]);
       std::fprintf(pfile,"\n"); // terminate line
@@ -396,7 +426,7 @@ void HistoryOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
 
   // increment counters, clean up
   if (out_params.last_time < 0.0) {
-    out_params.last_time = pm->time;
+    out_params.last_time = out_time;
   } else {
     out_params.last_time += out_params.dt;
   }
@@ -6,6 +6,8 @@
 //! \file io_wrapper.cpp
 //! \brief functions that provide wrapper for MPI-IO versus serial input/output
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <iomanip>
@@ -17,6 +19,25 @@
 #include "athena.hpp"
 #include "io_wrapper.hpp"
 
+std::atomic<std::uint64_t> IOWrapper::bytes_written(0);
+std::atomic<std::uint64_t> IOWrapper::write_nsec(0);
+#if MPI_PARALLEL_ENABLED
+std::vector<std::pair<std::string, std::string>> IOWrapper::file_hints_;
+int IOWrapper::cb_ratio_ = 0;
+#endif
+
+//----------------------------------------------------------------------------------------
+//! \fn void IOWrapper::AddWriteStats()
+//! \brief adds number of bytes written and time spent since t0 to the running totals
+//! reported by benchmark runs.  Safe to call from the background I/O thread.
+
+void IOWrapper::AddWriteStats(std::chrono::steady_clock::time_point t0,
+                              std::uint64_t nbytes) {
+  auto dt = std::chrono::steady_clock::now() - t0;
+  bytes_written += nbytes;
+  write_nsec += std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count();
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn int IOWrapper::Open(const char* fname, FileMode rw)
 //! \brief wrapper for {MPI_File_open} versus {std::fopen} including error check
@@ -26,7 +47,9 @@ int IOWrapper::Open(const char* fname, FileMode rw) {
   // open file for reads
   if (rw == FileMode::read) {
 #if MPI_PARALLEL_ENABLED
-    int errcode = MPI_File_open(comm_, fname, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh_);
+    MPI_Info info = CreateFileInfo(comm_);
+    int errcode = MPI_File_open(comm_, fname, MPI_MODE_RDONLY, info, &fh_);
+    if (info != MPI_INFO_NULL) {MPI_Info_free(&info);}
     if (errcode != MPI_SUCCESS) {
       char msg[MPI_MAX_ERROR_STRING];
       int resultlen;
@@ -51,8 +74,10 @@ int IOWrapper::Open(const char* fname, FileMode rw) {
   } else if (rw == FileMode::write) {
 #if MPI_PARALLEL_ENABLED
     MPI_File_delete(fname, MPI_INFO_NULL); // truncation
+    MPI_Info info = CreateFileInfo(comm_);
     int errcode = MPI_File_open(comm_, fname, MPI_MODE_WRONLY | MPI_MODE_CREATE,
-                                MPI_INFO_NULL, &fh_);
+                                info, &fh_);
+    if (info != MPI_INFO_NULL) {MPI_Info_free(&info);}
     if (errcode != MPI_SUCCESS) {
       char msg[MPI_MAX_ERROR_STRING];
       int resultlen;
@@ -76,8 +101,10 @@ int IOWrapper::Open(const char* fname, FileMode rw) {
   // open file for append
   } else if (rw == FileMode::append) {
 #if MPI_PARALLEL_ENABLED
+    MPI_Info info = CreateFileInfo(comm_);
     int errcode = MPI_File_open(comm_, fname, MPI_MODE_WRONLY + MPI_MODE_APPEND,
-                                MPI_INFO_NULL, &fh_);
+                                info, &fh_);
+    if (info != MPI_INFO_NULL) {MPI_Info_free(&info);}
     if (errcode != MPI_SUCCESS) {
       char msg[MPI_MAX_ERROR_STRING];
       int resultlen;
@@ -287,6 +314,7 @@ std::size_t IOWrapper::Write_any_type(const void *buf, IOWrapperSizeT cnt,
     std::exit(EXIT_FAILURE);
   }
   // Now write data using MPI-IO
+  auto t0 = std::chrono::steady_clock::now();
   MPI_Status status;
   int errcode = MPI_File_write(fh_, buf, cnt, mpitype, &status);
   if (errcode != MPI_SUCCESS) {
@@ -296,8 +324,10 @@ std::size_t IOWrapper::Write_any_type(const void *buf, IOWrapperSizeT cnt,
     printf("%.*s\n", resultlen, msg);
     return 0;
   }
-  int nwrite;
+  int nwrite, tsize;
   if (MPI_Get_count(&status, mpitype, &nwrite) == MPI_UNDEFINED) {return 0;}
+  MPI_Type_size(mpitype, &tsize);
+  AddWriteStats(t0, static_cast<std::uint64_t>(nwrite)*tsize);
   return nwrite;
 #else
   // set appropriate datasize
@@ -318,7 +348,10 @@ std::size_t IOWrapper::Write_any_type(const void *buf, IOWrapperSizeT cnt,
     std::exit(EXIT_FAILURE);
   }
   // Write data using standard C functions
-  return std::fwrite(buf,datasize,cnt,fh_);
+  auto t0 = std::chrono::steady_clock::now();
+  std::size_t nwrite = std::fwrite(buf,datasize,cnt,fh_);
+  AddWriteStats(t0, nwrite*datasize);
+  return nwrite;
 #endif
 }
 
@@ -350,6 +383,7 @@ std::size_t IOWrapper::Write_any_type_at(const void *buf, IOWrapperSizeT cnt,
     std::exit(EXIT_FAILURE);
   }
   // Now write data using MPI-IO
+  auto t0 = std::chrono::steady_clock::now();
   MPI_Status status;
   int errcode = MPI_File_write_at(fh_, offset, buf, cnt, mpitype, &status);
   if (errcode != MPI_SUCCESS) {
@@ -359,8 +393,10 @@ std::size_t IOWrapper::Write_any_type_at(const void *buf, IOWrapperSizeT cnt,
     printf("%.*s\n", resultlen, msg);
     return 0;
   }
-  int nwrite;
+  int nwrite, tsize;
   if (MPI_Get_count(&status, mpitype, &nwrite) == MPI_UNDEFINED) {return 0;}
+  MPI_Type_size(mpitype, &tsize);
+  AddWriteStats(t0, static_cast<std::uint64_t>(nwrite)*tsize);
   return nwrite;
 #else
   // set appropriate datasize
@@ -381,8 +417,11 @@ std::size_t IOWrapper::Write_any_type_at(const void *buf, IOWrapperSizeT cnt,
     std::exit(EXIT_FAILURE);
   }
   // Write data using standard C functions
+  auto t0 = std::chrono::steady_clock::now();
   std::fseek(fh_, offset, SEEK_SET);
-  return std::fwrite(buf,datasize,cnt,fh_);
+  std::size_t nwrite = std::fwrite(buf,datasize,cnt,fh_);
+  AddWriteStats(t0, nwrite*datasize);
+  return nwrite;
 #endif
 }
 
@@ -414,6 +453,7 @@ std::size_t IOWrapper::Write_any_type_at_all(const void *buf, IOWrapperSizeT cnt
     std::exit(EXIT_FAILURE);
   }
   // Now write data using MPI-IO
+  auto t0 = std::chrono::steady_clock::now();
   MPI_Status status;
   int errcode = MPI_File_write_at_all(fh_, offset, buf, cnt, mpitype, &status);
   if (errcode != MPI_SUCCESS) {
@@ -423,8 +463,10 @@ std::size_t IOWrapper::Write_any_type_at_all(const void *buf, IOWrapperSizeT cnt
     printf("%.*s\n", resultlen, msg);
     return 0;
   }
-  int nwrite;
-  if (MPI_Get_count(&status,mpitype,&nwrite) == MPI_UNDEFINED) {return 0;}
+  int nwrite, tsize;
+  if (MPI_Get_count(&status, mpitype, &nwrite) == MPI_UNDEFINED) {return 0;}
+  MPI_Type_size(mpitype, &tsize);
+  AddWriteStats(t0, static_cast<std::uint64_t>(nwrite)*tsize);
   return nwrite;
 #else
   // set appropriate datasize
@@ -445,8 +487,11 @@ std::size_t IOWrapper::Write_any_type_at_all(const void *buf, IOWrapperSizeT cnt
     std::exit(EXIT_FAILURE);
   }
   // Write data using standard C functions
+  auto t0 = std::chrono::steady_clock::now();
   std::fseek(fh_, offset, SEEK_SET);
-  return std::fwrite(buf,datasize,cnt,fh_);
+  std::size_t nwrite = std::fwrite(buf,datasize,cnt,fh_);
+  AddWriteStats(t0, nwrite*datasize);
+  return nwrite;
 #endif
 }
 
@@ -487,3 +532,109 @@ IOWrapperSizeT IOWrapper::GetPosition() {
   return ftell(fh_);
 #endif
 }
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn void IOWrapper::SetCollectiveReadHints(int naggregators)
+//  \brief sets MPI-IO hints on open file to enable collective buffering (two-phase I/O)
+//  for collective reads, using naggregators aggregators (or the default if <= 0)
+
+void IOWrapper::SetCollectiveReadHints(int naggregators) {
+  MPI_Info info;
+  MPI_Info_create(&info);
+  MPI_Info_set(info, "romio_cb_read", "enable");
+  if (naggregators > 0) {
+    MPI_Info_set(info, "cb_nodes", std::to_string(naggregators).c_str());
+  }
+  MPI_File_set_info(fh_, info);
+  MPI_Info_free(&info);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void IOWrapper::SetFileHints(const std::string &hints, int cb_ratio)
+//  \brief sets MPI-IO hints used when opening files.  hints is a list of "key=value"
+//  pairs separated by spaces or commas (e.g. "striping_factor=16,striping_unit=4194304")
+//  that are passed unchanged to MPI_File_open.  With cb_ratio > 0, collective buffering
+//  of writes is enabled with one aggregator (cb_nodes) per cb_ratio ranks of each file.
+
+void IOWrapper::SetFileHints(const std::string &hints, int cb_ratio) {
+  file_hints_.clear();
+  std::string list = hints;
+  for (char &c : list) {
+    if (c == ',') {c = ' ';}
+  }
+  std::stringstream ss(list);
+  std::string pair;
+  while (ss >> pair) {
+    std::size_t eq = pair.find('=');
+    if (eq == std::string::npos || eq == 0 || eq == pair.size()-1) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "MPI-IO hint '" << pair << "' in <io>/mpiio_hints must "
+                << "be given as key=value" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    file_hints_.emplace_back(pair.substr(0, eq), pair.substr(eq+1));
+  }
+  cb_ratio_ = cb_ratio;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn MPI_Info IOWrapper::CreateFileInfo(MPI_Comm comm)
+//  \brief returns MPI_Info with hints set by SetFileHints() for a file opened over comm,
+//  or MPI_INFO_NULL if none are set.  Caller must free the returned MPI_Info.
+
+MPI_Info IOWrapper::CreateFileInfo(MPI_Comm comm) {
+  if (file_hints_.empty() && cb_ratio_ <= 0) {return MPI_INFO_NULL;}
+  MPI_Info info;
+  MPI_Info_create(&info);
+  for (auto &hint : file_hints_) {
+    MPI_Info_set(info, hint.first.c_str(), hint.second.c_str());
+  }
+  if (cb_ratio_ > 0) {
+    int nranks;
+    MPI_Comm_size(comm, &nranks);
+    int naggregators = std::max((nranks + cb_ratio_ - 1)/cb_ratio_, 1);
+    MPI_Info_set(info, "romio_cb_write", "enable");
+    MPI_Info_set(info, "cb_nodes", std::to_string(naggregators).c_str());
+  }
+  return info;
+}
+#endif
+
+//----------------------------------------------------------------------------------------
+//! \fn std::string NodeLocalFileName()
+//  \brief returns name of node-local restart file of node node_id, given the name of the
+//  shared restart file.
+
+std::string NodeLocalFileName(const std::string &fname, int node_id) {
+  char number[8];
+  std::snprintf(number, sizeof(number), ".n%05d", node_id);
+  return fname + std::string(number);
+}
+
+#if MPI_PARALLEL_ENABLED
+//----------------------------------------------------------------------------------------
+//! \fn void NodeCommunicator()
+//  \brief creates communicator of ranks sharing memory on this node, and returns index of
+//  the node, set by the ordering of the lowest rank on each node.  Must be called by all
+//  ranks.  Caller owns (and must free) the new communicator.
+
+void NodeCommunicator(MPI_Comm *pnode_comm, int *pnode_id) {
+  int my_rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, my_rank, MPI_INFO_NULL,
+                      pnode_comm);
+  int node_rank;
+  MPI_Comm_rank(*pnode_comm, &node_rank);
+  // rank of each node leader in communicator of leaders is index of node
+  MPI_Comm leader_comm;
+  MPI_Comm_split(MPI_COMM_WORLD, (node_rank == 0)? 0 : MPI_UNDEFINED, my_rank,
+                 &leader_comm);
+  *pnode_id = 0;
+  if (leader_comm != MPI_COMM_NULL) {
+    MPI_Comm_rank(leader_comm, pnode_id);
+    MPI_Comm_free(&leader_comm);
+  }
+  MPI_Bcast(pnode_id, 1, MPI_INT, 0, *pnode_comm);
+}
+#endif
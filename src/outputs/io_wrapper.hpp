@@ -8,8 +8,13 @@
 //! \file io_wrapper.hpp
 //  \brief defines a set of small wrapper functions for MPI versus serial outputs.
 
-#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
 #include "athena.hpp"
 
 #if MPI_PARALLEL_ENABLED
@@ -26,6 +31,11 @@ class IOWrapper {
 #if MPI_PARALLEL_ENABLED
   IOWrapper() : fh_(nullptr), comm_(MPI_COMM_WORLD) {}
   void SetCommunicator(MPI_Comm scomm) { comm_=scomm;}
+  MPI_Comm GetCommunicator() const {return comm_;}
+  void SetCollectiveReadHints(int naggregators);
+  // MPI-IO hints (set from <io> block) used by every MPI_File_open of IOWrapper files
+  static void SetFileHints(const std::string &hints, int cb_ratio);
+  static MPI_Info CreateFileInfo(MPI_Comm comm);
 #else
   IOWrapper() {fh_=nullptr;}
 #endif
@@ -52,10 +62,26 @@ class IOWrapper {
   int Seek(IOWrapperSizeT offset);
   IOWrapperSizeT GetPosition();
 
+  // running totals over all files of bytes written by this rank, and of time (in ns)
+  // spent in the Write functions.  Used to report I/O bandwidth in benchmark runs.
+  static std::atomic<std::uint64_t> bytes_written, write_nsec;
+
  private:
   IOWrapperFile fh_;
+  static void AddWriteStats(std::chrono::steady_clock::time_point t0,
+                            std::uint64_t nbytes);
 #if MPI_PARALLEL_ENABLED
   MPI_Comm comm_;
+  static std::vector<std::pair<std::string, std::string>> file_hints_;
+  static int cb_ratio_;    // number of ranks per collective buffering aggregator
 #endif
 };
+
+// Node-local (two-tier) restart files.  Each node writes one file, named by appending
+// ".nXXXXX" (5-digit node index) to the name of the shared restart file.
+std::string NodeLocalFileName(const std::string &fname, int node_id);
+#if MPI_PARALLEL_ENABLED
+void NodeCommunicator(MPI_Comm *pnode_comm, int *pnode_id);
+#endif
+
 #endif // OUTPUTS_IO_WRAPPER_HPP_
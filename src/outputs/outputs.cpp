@@ -18,7 +18,7 @@
 //! Required parameters that must be specified in an <output[n]> block are:
 //!   - variable  = [list of currently implemented strings for specifing output variables
 //!                  is defined at start of outputs.hpp file]
-//!   - file_type = tab,vtk,hst,bin,rst
+//!   - file_type = tab,vtk,vtkhdf,hst,bin,athdf,ascent,rst
 //!   - dt        = problem time between outputs
 //!
 //! EXAMPLE of an <output[n]> block for a TAB dump:
@@ -30,6 +30,14 @@
 //!   slice_x2    = 0.0       # slice at x2
 //!   slice_x3    = 0.0       # slice at x3
 //!
+//! MPI-IO can be tuned for the file system with an optional <io> block, used by all
+//! outputs written with IOWrapper (bin, cbin, rst, trk) and by vtk outputs:
+//!   <io>
+//!   mpiio_hints   = striping_factor=16,cb_buffer_size=16777216  # for MPI_File_open
+//!   cb_ratio      = 8     # one collective buffering aggregator per 8 ranks
+//!   subfile_ranks = 64    # write bin outputs to one file per 64 ranks
+//! subfile_ranks can also be set in each bin <output[n]> block.
+//!
 //! Each <output[n]> block will result in a new node being created in a linked list of
 //! BaseTypeOutput stored in the Outputs class.  During a simulation, outputs are made
 //! when the simulation time satisfies the criteria implemented in the Driver class.
@@ -39,18 +47,22 @@
 //! comment text: 'NEW_OUTPUT_TYPES'.
 //========================================================================================
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>    // strcmp
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <string>   // std::string, to_string()
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "outputs.hpp"
+#include "driver/host_tasks.hpp"
 
 //----------------------------------------------------------------------------------------
 // Outputs constructor
@@ -214,6 +226,35 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         }
       }
 
+      // Optionally write files in background thread, from snapshots of data taken when
+      // output is made.  Supported for binary mesh outputs on a static mesh (since files
+      // are written while the mesh continues to be evolved), and for history and tracked
+      // particle outputs, whose snapshots do not depend on the mesh.
+      opar.async = pin->GetOrAddBoolean(opar.block_name, "async", false);
+      if (opar.async) {
+        bool bin_ok = (opar.file_type.compare("bin") == 0) &&
+                      !(pm->adaptive) && !(pm->rebalance);
+        if (!(bin_ok) && opar.file_type.compare("hst") != 0 &&
+            opar.file_type.compare("trk") != 0) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "async=true in output block '" << opar.block_name
+              << "' is only supported for file_type=hst, trk, or bin (without AMR or "
+              << "load balancing)" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+#if MPI_PARALLEL_ENABLED
+        int provided;
+        MPI_Query_thread(&provided);
+        if (provided != MPI_THREAD_MULTIPLE) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "async=true in output block '" << opar.block_name
+              << "' requires an MPI library that supports MPI_THREAD_MULTIPLE"
+              << std::endl;
+          exit(EXIT_FAILURE);
+        }
+#endif
+      }
+
       // set optional data format string used in formatted writes
       opar.data_format = pin->GetOrAddString(opar.block_name, "data_format", "%12.5e");
       opar.data_format.insert(0, " "); // prepend with blank to separate columns
@@ -245,6 +286,8 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         opar.coarsen_factor = pin->GetInteger(opar.block_name,"coarsen_factor");
         opar.compute_moments = pin->GetOrAddBoolean(opar.block_name,
           "compute_moments", false);
+        opar.compress = pin->GetOrAddBoolean(opar.block_name, "compress", false);
+        opar.pyramid_levels = pin->GetOrAddInteger(opar.block_name, "pyramid_levels", 1);
         pnode = new CoarsenedBinaryOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
       } else if (opar.file_type.compare("pdf") == 0) {
@@ -253,6 +296,8 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         opar.nbin = pin->GetInteger(opar.block_name,"nbin");
         opar.logscale = pin->GetOrAddBoolean(opar.block_name,"logscale",true);
         opar.mass_weighted = pin->GetOrAddBoolean(opar.block_name,"mass_weighted",false);
+        opar.accumulate_dcycle = pin->GetOrAddInteger(opar.block_name,
+          "accumulate_dcycle",0);
         // check and set second variable option.
         if (pin->DoesParameterExist(opar.block_name,"variable_2")) {
           opar.variable_2 = pin->GetString(opar.block_name, "variable_2");
@@ -269,9 +314,64 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
         }
         pnode = new PDFOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("spec") == 0) {
+        opar.spec_kmax = pin->GetOrAddInteger(opar.block_name, "kmax", 16);
+        opar.helmholtz = pin->GetOrAddBoolean(opar.block_name, "helmholtz", false);
+        opar.spec_binary = pin->GetOrAddBoolean(opar.block_name, "binary", false);
+        pnode = new SpectrumOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("probe") == 0) {
+        pnode = new ProbeOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
       } else if (opar.file_type.compare("bin") == 0) {
+        opar.compress = pin->GetOrAddBoolean(opar.block_name, "compress", false);
+        opar.block_index = pin->GetOrAddBoolean(opar.block_name, "block_index", false);
+        opar.subfile_ranks = pin->GetOrAddInteger(opar.block_name, "subfile_ranks",
+                             pin->GetOrAddInteger("io", "subfile_ranks", 0));
         pnode = new MeshBinaryOutput(pin,pm,opar);
         pout_list.insert(pout_list.begin(),pnode);
+      } else if (opar.file_type.compare("ascent") == 0) {
+#if ASCENT_OUTPUT_ENABLED
+        pnode = new AscentOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+#else
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "file_type=ascent in output block '" << opar.block_name
+            << "' requires code to be configured with -D Athena_ENABLE_ASCENT=ON"
+            << std::endl;
+        exit(EXIT_FAILURE);
+#endif
+      } else if (opar.file_type.compare("athdf") == 0) {
+#if HDF5_OUTPUT_ENABLED
+        opar.compression_level = pin->GetOrAddInteger(opar.block_name,
+          "compression_level", 0);
+        if (opar.compression_level < 0 || opar.compression_level > 9) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "compression_level=" << opar.compression_level
+              << " in output block '" << opar.block_name << "' must be in [0,9]"
+              << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        pnode = new MeshHDF5Output(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+#else
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "file_type=athdf in output block '" << opar.block_name
+            << "' requires code to be configured with -D Athena_ENABLE_HDF5=ON"
+            << std::endl;
+        exit(EXIT_FAILURE);
+#endif
+      } else if (opar.file_type.compare("vtkhdf") == 0) {
+#if HDF5_OUTPUT_ENABLED
+        pnode = new MeshVTKHDFOutput(pin,pm,opar);
+        pout_list.insert(pout_list.begin(),pnode);
+#else
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "file_type=vtkhdf in output block '" << opar.block_name
+            << "' requires code to be configured with -D Athena_ENABLE_HDF5=ON"
+            << std::endl;
+        exit(EXIT_FAILURE);
+#endif
       } else if (opar.file_type.compare("rst") == 0) {
       // Add restarts to the tail end of BaseTypeOutput list, so file counters for other
       // output types are up-to-date in restart file
@@ -294,15 +394,131 @@ Outputs::Outputs(ParameterInput *pin, Mesh *pm) {
               << "input file" << std::endl;
     exit(EXIT_FAILURE);
   }
+
+  // outputs written asynchronously are written by the host task queue of the Driver.
+  // With MPI, files are written over a duplicate communicator so MPI-IO calls in the
+  // background thread cannot match collectives made by the main thread.
+  bool any_async = false;
+  for (BaseTypeOutput* pnode : pout_list) {
+    if (pnode->out_params.async) {any_async = true;}
+  }
+  if (any_async) {
+    max_async_ = pin->GetOrAddInteger("job", "max_async_outputs", 2);
+    max_async_ = std::max(max_async_, 1);
+#if MPI_PARALLEL_ENABLED
+    MPI_Comm_dup(MPI_COMM_WORLD, &async_comm_);
+    for (BaseTypeOutput* pnode : pout_list) {
+      if (pnode->out_params.async) {pnode->io_comm = async_comm_;}
+    }
+#endif
+  }
+
+#if MPI_PARALLEL_ENABLED
+  // MPI-IO hints used for all files written through IOWrapper
+  if (pin->DoesBlockExist("io")) {
+    IOWrapper::SetFileHints(pin->GetOrAddString("io", "mpiio_hints", ""),
+                            pin->GetOrAddInteger("io", "cb_ratio", 0));
+  }
+#endif
+
+  // outputs written to subfiles use a communicator of each group of subfile_ranks
+  // consecutive ranks, which hold consecutive MeshBlocks.  Must be split in the same
+  // order on all ranks.
+  for (BaseTypeOutput* pnode : pout_list) {
+    int nsub = pnode->out_params.subfile_ranks;
+    if (nsub > 0 && nsub < global_variable::nranks) {
+#if MPI_PARALLEL_ENABLED
+      MPI_Comm sub_comm;
+      int isub = global_variable::my_rank/nsub;
+      MPI_Comm_split(pnode->io_comm, isub, global_variable::my_rank, &sub_comm);
+      pnode->io_comm = sub_comm;
+      pnode->io_root = isub*nsub;
+      subfile_comms_.push_back(sub_comm);
+#endif
+    } else {
+      pnode->out_params.subfile_ranks = 0;
+    }
+  }
 }
 
 //----------------------------------------------------------------------------------------
 // destructor
 
 Outputs::~Outputs() {
+  // wait until all queued snapshots are written
+  FinishAsyncOutputs();
+#if MPI_PARALLEL_ENABLED
+  if (async_comm_ != MPI_COMM_NULL) {MPI_Comm_free(&async_comm_);}
+  for (auto &comm : subfile_comms_) {MPI_Comm_free(&comm);}
+#endif
+
   // Must manually delete memory assigned to each OutputType object stored in pout_list
   for (BaseTypeOutput* pnode : pout_list) {
     delete pnode;
   }
   pout_list.clear();
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void Outputs::WriteOutputAsync()
+//! \brief Loads output data (device to host) and queues a snapshot of the output and of
+//! the input parameters to be written by the host task queue, so the time loop can
+//! resume.  Blocks while max_async_outputs snapshots are already in flight.  Counters
+//! are updated here, since the snapshot is a copy of the output.
+
+void Outputs::WriteOutputAsync(BaseTypeOutput *pout, Mesh *pm, ParameterInput *pin,
+                               HostTaskQueue &tasks) {
+  {
+    std::unique_lock<std::mutex> lock(io_mutex_);
+    io_cv_.wait(lock, [this]{return nflight_ < max_async_;});
+  }
+
+  pout->LoadOutputData(pm);
+  BaseTypeOutput *psnap = pout->Clone();
+  ParameterInput *psnap_pin = new ParameterInput();
+  {
+    std::stringstream ost;
+    pin->ParameterDump(ost);
+    psnap_pin->LoadFromStream(ost);
+  }
+
+  // increment counters (history and tracked particle outputs have no file number)
+  auto &op = pout->out_params;
+  if (op.file_type.compare("hst") != 0 && op.file_type.compare("trk") != 0) {
+    op.file_number++;
+    pin->SetInteger(op.block_name, "file_number", op.file_number);
+  }
+  if (op.last_time < 0.0) {
+    op.last_time = pm->time;
+  } else {
+    op.last_time += op.dt;
+  }
+  pin->SetReal(op.block_name, "last_time", op.last_time);
+
+  {
+    std::lock_guard<std::mutex> lock(io_mutex_);
+    nflight_++;
+  }
+  tasks.Start();
+  tasks.Enqueue([this, psnap, psnap_pin, pm]() {
+    psnap->WriteOutputFile(pm, psnap_pin);
+    delete psnap;
+    delete psnap_pin;
+    {
+      std::lock_guard<std::mutex> lock(io_mutex_);
+      nflight_--;
+    }
+    io_cv_.notify_all();
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Outputs::FinishAsyncOutputs()
+//! \brief Blocks until all snapshots queued by WriteOutputAsync() are written.
+
+void Outputs::FinishAsyncOutputs() {
+  std::unique_lock<std::mutex> lock(io_mutex_);
+  io_cv_.wait(lock, [this]{return nflight_ == 0;});
+  return;
+}
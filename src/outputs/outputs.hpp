@@ -8,20 +8,27 @@
 //! \file outputs.hpp
 //  \brief provides classes to handle ALL types of data output
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Kokkos_ScatterView.hpp"
 
 #include "athena.hpp"
 #include "io_wrapper.hpp"
+#include "file_layout.hpp"
 
 #define NHISTORY_VARIABLES 12
 #if NHISTORY_VARIABLES > NREDUCTION_VARIABLES
     #error NHISTORY > NREDUCTION in outputs.hpp
 #endif
 
-#define NOUTPUT_CHOICES 152
+#define NOUTPUT_CHOICES 153
 // choices for output variables used in <ouput> blocks in input file
 // TO ADD MORE CHOICES:
 //   - add more strings to array below, change NOUTPUT_CHOICES above appropriately
@@ -96,13 +103,19 @@ static const char *var_choice[NOUTPUT_CHOICES] = {
   "tmunu",
 
   // Particles (150-151)
-  "prtcl_all", "prtcl_d"
+  "prtcl_all", "prtcl_d",
+
+  // map of floors applied in hydro C2P (152)
+  "hydro_floors"
 };
 
 
 // forward declarations
 class Mesh;
 class ParameterInput;
+class HostTaskQueue;
+class LagrangeInterpolator;
+namespace ascent {class Ascent;}
 
 //----------------------------------------------------------------------------------------
 //! \struct OutputParameters
@@ -132,6 +145,7 @@ struct OutputParameters {
   int coarsen_factor;
   bool compute_moments; // if true then will compute
   // <q>, <q^2>, <q^3>, <q^4> for each variable q
+  int pyramid_levels=1; // number of coarsening levels (coarsen_factor*2^l) per output
   // DBF parameters for PDF:
   // number of derived variables, index of current derived variable
   int n_derived=0, i_derived=0;
@@ -141,6 +155,16 @@ struct OutputParameters {
   int nbin=0, nbin2=0;
   bool logscale=true, logscale2=true;
   bool mass_weighted=false;
+  int accumulate_dcycle=0;  // cycles between samples of time-averaged PDFs (0=off)
+  bool async=false;  // write files from snapshots in background I/O thread
+  int compression_level=0;  // deflate level (0=none) of HDF5 outputs
+  bool compress=false;      // error-bounded lossy compression of bin and cbin outputs
+  bool block_index=false;   // append index of MeshBlocks to bin outputs
+  int subfile_ranks=0;      // write bin outputs to one file per subfile_ranks ranks
+  // parameters for power spectra:
+  int spec_kmax=16;         // largest wavenumber (in units of 2pi/L_x1)
+  bool helmholtz=false;     // split velocity spectrum into solenoidal/compressive parts
+  bool spec_binary=false;   // write spectra as raw binary values instead of text
 };
 
 //----------------------------------------------------------------------------------------
@@ -219,9 +243,22 @@ class BaseTypeOutput {
   // function which computes derived output variables like vorticity and current density
   void ComputeDerivedVariable(std::string name, Mesh *pm);
 
+  // time and cycle at which data in outarray were loaded
+  Real out_time;
+  int out_cycle;
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm io_comm = MPI_COMM_WORLD;  // communicator used for MPI-IO (dup with async)
+#endif
+  int io_root = 0;  // global rank of rank 0 of io_comm (nonzero only with subfiles)
+
   // virtual functions may be over-ridden in derived classes
   virtual void LoadOutputData(Mesh *pm);
   virtual void WriteOutputFile(Mesh *pm, ParameterInput *pin) = 0;
+  // adds current data to time-averaged outputs, called every accumulate_dcycle cycles
+  virtual void AccumulateOutputData(Mesh *pm) {}
+  // returns copy of this output (including loaded data) that can be written by the
+  // background I/O thread, or nullptr if this output type cannot be written async
+  virtual BaseTypeOutput* Clone() {return nullptr;}
 
   // Functions to detect big endian machine, and to byte-swap 32-bit words.  The vtk
   // legacy format requires data to be stored as big-endian.
@@ -243,6 +280,26 @@ class BaseTypeOutput {
   HostArray5D<Real> outarray_hyd, outarray_mhd, outarray_rad,
                     outarray_force, outarray_z4c, outarray_adm;
   HostFaceFld4D<Real> outfield;  // FC output field on host
+  // CC output data gathered on device before a single copy to outarray, and the index
+  // (in MeshBlockPack) and starting indices (ois, ojs, oks) of each output MB
+  DvceArray5D<Real> d_outarray;
+  DualArray2D<int> outmbs_indx;
+  // error-bounded lossy compression of data in d_outarray (bin/cbin with compress=true)
+  std::vector<Real> out_tol;          // absolute error bound of each output variable
+  std::vector<double> q_min, q_step;  // minimum and step of quantized data on each MB
+  std::vector<int> q_nbits;           // number of bits used for quantized data on each MB
+  std::vector<double> q_raw;          // data of variables on MBs stored unquantized
+  std::vector<std::size_t> q_raw_offset;  // offset in q_raw of each variable on each MB
+  DualArray3D<double> q_range;
+  DvceArray5D<std::uint32_t> d_qarray;
+  HostArray5D<std::uint32_t> qarray;
+  void SetCompressionTolerances(ParameterInput *pin,
+                                const std::vector<std::string> &labels);
+  void QuantizeOutputData();
+  std::size_t CompressedDataSize(int m);
+  std::size_t PackCompressedData(int m, char *pdata);
+  void WriteCompressedData(IOWrapper &file, const char *data, std::size_t nbytes,
+                           std::size_t header_offset);
   std::vector<int> noutmbs;   // with MPI, number of output MBs across all ranks
   int noutmbs_min;            // with MPI, minimum number of output MBs across all ranks
   int noutmbs_max;            // with MPI, maximum number of output MBs across all ranks
@@ -276,8 +333,14 @@ class HistoryOutput : public BaseTypeOutput {
 
   // vector of length [# of physics modules] containing hdata arrays
   std::vector<HistoryData> hist_data;
+  // device results of history sums of built-in physics, and host copy
+  DvceArray1D<array_sum::GlobalSum> d_hsum;
+  HostArray1D<array_sum::GlobalSum> h_hsum;
+
+  Real out_dt;   // timestep at which data in hist_data were loaded
 
   void LoadOutputData(Mesh *pm) override;
+  BaseTypeOutput* Clone() override;
   void LoadHydroHistoryData(HistoryData *pdata, Mesh *pm);
   void LoadMHDHistoryData(HistoryData *pdata, Mesh *pm);
   void LoadZ4cHistoryData(HistoryData *pdata, Mesh *pm);
@@ -297,6 +360,13 @@ class CoarsenedBinaryOutput : public BaseTypeOutput {
   //                            const int coarsen_factor);
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  // coarser levels l=1..pyramid_levels-1 of pyramid outputs, stored at index l-1
+  std::vector<DvceArray5D<Real>> d_pyramid_;
+  std::vector<HostArray5D<Real>> pyramid_;
+  void WriteCoarsenedFile(Mesh *pm, ParameterInput *pin, int cf,
+                          const HostArray5D<Real> &cdata);
 };
 
 //----------------------------------------------------------------------------------------
@@ -316,6 +386,11 @@ struct PDFData {
 
   DvceArray2D<Real> result_; // resulting histogram
   Kokkos::Experimental::ScatterView<Real **, LayoutWrapper> scatter_result;
+  // time-averaged PDFs: histogram weighted by time accumulated in result_ since the
+  // last output over accum_time, and time of last sample
+  Real accum_time=0.0, last_sample_time=-1.0;
+  // host buffers of (non-blocking) reduction of result_ over ranks
+  std::vector<Real> send_buf, recv_buf;
 
   PDFData(int dim, int nbinVal, int nbin2Val)
     : pdf_dimension(dim), nbin(nbinVal), nbin2(nbin2Val),
@@ -331,11 +406,65 @@ struct PDFData {
 class PDFOutput : public BaseTypeOutput {
  public:
   PDFOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~PDFOutput();
 
   PDFData pdf_data;
 
+  void BinData(Mesh *pm, Real weight);
+  void LoadOutputData(Mesh *pm) override;
+  void AccumulateOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+#if MPI_PARALLEL_ENABLED
+  MPI_Request reduce_req_ = MPI_REQUEST_NULL;
+#endif
+};
+
+//----------------------------------------------------------------------------------------
+//! \class SpectrumOutput
+//  \brief derived BaseTypeOutput class for shell-averaged power spectra
+
+class SpectrumOutput : public BaseTypeOutput {
+ public:
+  SpectrumOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~SpectrumOutput();
+
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  int ncomp_;                       // fields transformed: dens, vel (3), [B (3)]
+  int nx_[3];                       // number of cells in Mesh in each direction
+  int kmax_[3];                     // largest |wavenumber| in each direction
+  Real len_[3];                     // size of Mesh in each direction
+  DvceArray2D<Real> cos_[3], sin_[3];  // (wavenumber, global cell index) twiddles
+  DvceArray4D<Real> a1_re_, a1_im_;    // transform in x1 of one field (m,k,j,kx)
+  DvceArray4D<Real> a2_re_, a2_im_;    // transform in x1,x2 of one field (m,k,ky,kx)
+  DvceArray4D<Real> f_re_, f_im_;      // Fourier coefficients on this rank (n,kz,ky,kx)
+  std::vector<Real> send_buf_, recv_buf_;
+#if MPI_PARALLEL_ENABLED
+  MPI_Request reduce_req_ = MPI_REQUEST_NULL;
+#endif
+};
+
+//----------------------------------------------------------------------------------------
+//! \class ProbeOutput
+//  \brief derived BaseTypeOutput class for time series of variables at fixed points
+
+class ProbeOutput : public BaseTypeOutput {
+ public:
+  ProbeOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~ProbeOutput();
+
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  std::vector<Real> coords_;                       // coordinates of points, 3 per point
+  std::unique_ptr<LagrangeInterpolator> pinterp_;  // stencils of points on this rank
+  int nregrid_;                                    // Mesh::nregrid when stencils built
+  std::vector<Real> record_;                       // time, then values(point,variable)
 };
 
 //----------------------------------------------------------------------------------------
@@ -370,7 +499,49 @@ class ParticleVTKOutput : public BaseTypeOutput {
 class MeshBinaryOutput : public BaseTypeOutput {
  public:
   MeshBinaryOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+  BaseTypeOutput* Clone() override {return new MeshBinaryOutput(*this);}
+
+ private:
+  void WriteBlockIndex(Mesh *pm, IOWrapper &file, std::size_t header_offset,
+                       const std::vector<std::size_t> &mb_offset, int cells);
+};
+
+//----------------------------------------------------------------------------------------
+//! \class MeshHDF5Output
+//  \brief derived BaseTypeOutput class for mesh data in athdf (HDF5) format
+
+class MeshHDF5Output : public BaseTypeOutput {
+ public:
+  MeshHDF5Output(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class MeshVTKHDFOutput
+//  \brief derived BaseTypeOutput class for mesh data in VTKHDF (OverlappingAMR) format
+
+class MeshVTKHDFOutput : public BaseTypeOutput {
+ public:
+  MeshVTKHDFOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+};
+
+//----------------------------------------------------------------------------------------
+//! \class AscentOutput
+//  \brief derived BaseTypeOutput class that passes device data to Ascent for in-situ
+//  visualization and analysis, rather than writing files
+
+class AscentOutput : public BaseTypeOutput {
+ public:
+  AscentOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~AscentOutput();
+  void LoadOutputData(Mesh *pm) override;
+  void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+ private:
+  ascent::Ascent *pascent_ = nullptr;
+  DvceArray3D<int> ghosts_;  // flags ghost cells (=1) of MBs for Ascent
 };
 
 //----------------------------------------------------------------------------------------
@@ -380,8 +551,56 @@ class MeshBinaryOutput : public BaseTypeOutput {
 class RestartOutput : public BaseTypeOutput {
  public:
   RestartOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
+  ~RestartOutput();
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+
+ private:
+  // With local_dir set, each node writes its own restart file to node-local storage,
+  // which is then copied ("drained") to rst/ by a background thread.
+  struct DrainJob {
+    std::string src, dst;   // copy src to dst, or delete src if dst is empty
+  };
+  std::string local_dir_;              // directory on node-local storage, or empty
+  int nkeep_local_;                    // number of node-local restart files kept
+  bool drain_;                         // copy node-local files to rst/
+  int node_id_;                        // index of this node
+  bool hdr_rank_;                      // rank that writes header of its file
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm node_comm_ = MPI_COMM_NULL;
+#endif
+  std::deque<std::string> local_files_;  // node-local files written, oldest first
+  std::deque<DrainJob> drain_queue_;
+  std::thread drain_thread_;
+  std::mutex drain_mutex_;
+  std::condition_variable drain_cv_;
+  bool drain_stop_ = false;
+  void DrainLoop();
+
+  // With delta_interval > 1, only MeshBlocks whose data changed since the last full
+  // restart are written, except every delta_interval-th restart which is full.
+  int delta_interval_;                     // number of restarts per full restart
+  int ndelta_ = 0;                         // delta restarts since last full restart
+  int base_nregrid_ = -1;                  // Mesh::nregrid at last full restart
+  std::string base_fname_;                 // name of last full restart file
+  IOWrapperSizeT base_offset_ = 0;         // offset of MeshBlock data in that file
+  std::vector<std::uint64_t> base_hash_;   // hash of data of each MB in that file
+  void PackMeshBlock(Mesh *pm, int m, char *pdata, int modules=file_layout::kRestartAll,
+                     bool single=false);
+
+  // Reduced restarts (for analysis or approximate restarts) contain only the modules
+  // listed in <output>/modules, and store values as float with <output>/precision=single
+  int modules_;                            // file_layout::RestartModule flags
+  bool single_;                            // store values as float
+  void QueueLocalFile(const std::string &fname, const std::string &rname);
+
+  // With <output>/stream_nmb > 0, full restarts are written from device arrays in chunks
+  // of stream_nmb MeshBlocks staged through two pinned host buffers, instead of copying
+  // all data to host in LoadOutputData()
+  int stream_nmb_;
+  Kokkos::View<Real*, PinnedMemSpace> stream_buf_[2];
+  void WriteStreamed(Mesh *pm, IOWrapper &resfile, IOWrapperSizeT offset_myrank,
+                     IOWrapperSizeT data_size);
 };
 
 //----------------------------------------------------------------------------------------
@@ -409,6 +628,7 @@ class TrackedParticleOutput : public BaseTypeOutput {
   TrackedParticleOutput(ParameterInput *pin, Mesh *pm, OutputParameters oparams);
   void LoadOutputData(Mesh *pm) override;
   void WriteOutputFile(Mesh *pm, ParameterInput *pin) override;
+  BaseTypeOutput* Clone() override;
  protected:
   int ntrack;           // total number of tracked particles across all ranks
   int ntrack_thisrank;  // number of tracked particles this rank (guess)
@@ -430,6 +650,21 @@ class Outputs {
 
   // use vector of pointers to BaseTypeOutputs since it is an abstract base class
   std::vector<BaseTypeOutput*> pout_list;
+
+  // functions for outputs written asynchronously by the host task queue of the Driver
+  void WriteOutputAsync(BaseTypeOutput *pout, Mesh *pm, ParameterInput *pin,
+                        HostTaskQueue &tasks);
+  void FinishAsyncOutputs();
+
+ private:
+  std::mutex io_mutex_;
+  std::condition_variable io_cv_;
+  int max_async_ = 2;   // maximum number of snapshots in flight (queued or writing)
+  int nflight_ = 0;     // number of snapshots in flight
+#if MPI_PARALLEL_ENABLED
+  MPI_Comm async_comm_ = MPI_COMM_NULL;
+  std::vector<MPI_Comm> subfile_comms_;  // communicators of outputs with subfiles
+#endif
 };
 
 #endif // OUTPUTS_OUTPUTS_HPP_
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "athena.hpp"
 #include "globals.hpp"
@@ -154,11 +155,25 @@ PDFOutput::PDFOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
 
 
 //----------------------------------------------------------------------------------------
-//! \fn void PDFOutput::LoadOutputData()
-//  \brief Wrapper function that cycles through hist_data vector and calls
-//  appropriate LoadXXXData() function for that physics
+// Destructor: completes any reduction of the last output still in flight
 
-void PDFOutput::LoadOutputData(Mesh *pm) {
+PDFOutput::~PDFOutput() {
+#if MPI_PARALLEL_ENABLED
+  if (reduce_req_ != MPI_REQUEST_NULL) {
+    MPI_Wait(&reduce_req_, MPI_STATUS_IGNORE);
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PDFOutput::BinData()
+//  \brief Adds weight times the (volume or mass weighted) histogram of the current data
+//  on this rank into pdf_data.result_.  When the histogram fits into team scratch memory
+//  each team bins the cells of one (m,k) row of cells into team-private bins with
+//  scratch atomics, then merges non-empty bins into result_ with global atomics.
+//  Otherwise a ScatterView is used.  Variables are read in place from the device arrays.
+
+void PDFOutput::BinData(Mesh *pm, Real weight) {
   // Calculate derived variables, if required
   // if out_params.variable or out_params.variable_2 not a derived
   // then ComputeDerivedVariable does nothing, so this should be fine
@@ -195,40 +210,20 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
 
   // loop over all MeshBlocks in this pack
   auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
-  int is = indcs.is; int ie = indcs.ie;
-  int js = indcs.js; int je = indcs.je;
+  int is = indcs.is;
+  int js = indcs.js; int nx1 = indcs.nx1;
   int ks = indcs.ks; int ke = indcs.ke;
-
-  auto result  = pdf_data.result_;
-  auto scatter = pdf_data.scatter_result;
-
+  int nji = indcs.nx2*indcs.nx1;
   int nmb = pm->pmb_pack->nmb_thispack;
-  int nx1 = indcs.nx1 + 2*indcs.ng;
-  int nx2 = indcs.nx2 + 2*indcs.ng;
-  int nx3 = indcs.nx3 + 2*indcs.ng;
-
-  // Copy MeshBlock data from host to device
-  DvceArray5D<Real> outvars_device("outvars_device", outvars.size(), nmb, nx3, nx2, nx1);
-  for (std::size_t i = 0; i < outvars.size(); ++i) {
-      auto d_slice = Kokkos::subview(*(outvars[i].data_ptr),
-      Kokkos::ALL(), outvars[i].data_index, Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL());
-      auto d_target_slice = Kokkos::subview(outvars_device, i,
-      Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL(), Kokkos::ALL());
-      Kokkos::deep_copy(d_target_slice, d_slice);
-  }
-  Kokkos::fence();
-
-  //
 
-  // Reset ScatterView from previous output
-  scatter.reset();
-  // Also reset the histogram from previous call.
-  // Currently still required for consistent results between host and device backends, see
-  // https://github.com/kokkos/kokkos/issues/6363
-  Kokkos::deep_copy(result, 0);
-  Kokkos::fence();
+  // variables binned in x and (for 2d PDFs) y
+  auto xvar = *(outvars[0].data_ptr);
+  int xindx = outvars[0].data_index;
+  auto yvar = (pdf_data.pdf_dimension == 2)? *(outvars[1].data_ptr) : xvar;
+  int yindx = (pdf_data.pdf_dimension == 2)? outvars[1].data_index : xindx;
 
   // Capture the necessary data from pdf_data
+  auto result = pdf_data.result_;
   auto bins = pdf_data.bins;
   auto bins2 = pdf_data.bins2;
   auto step_size = pdf_data.step_size;
@@ -240,9 +235,10 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
   bool logscale2 = pdf_data.logscale2;
   bool mass_weighted = pdf_data.mass_weighted;
 
-  par_for("pdf", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    auto &x_val = outvars_device(0, m, k, j, i);
+  // returns (flattened) index of bin in result_ and weight of cell
+  auto find_bin = KOKKOS_LAMBDA(const int m, const int k, const int j, const int i,
+                                Real &w) -> int {
+    Real x_val = xvar(m, xindx, k, j, i);
     int x_bin = -1;
     // First handle edge cases explicitly
     if (x_val < bins(0)) {
@@ -253,15 +249,14 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
       if (logscale == false) {
         x_bin = static_cast<int>((x_val - bins(0)) / step_size) + 1;
       } else if (logscale == true) {
-        x_bin = static_cast<int>(std::log10(x_val / bins(0)) / step_size) + 1;
+        x_bin = static_cast<int>(log10(x_val / bins(0)) / step_size) + 1;
       }
     }
     // needs to be zero as for the 1D histogram we need 0 as first index of the 2D
     // result array
     int y_bin = 0;
     if (pdf_dimension == 2) {
-      auto &y_val = outvars_device(1, m, k, j, i);
-
+      Real y_val = yvar(m, yindx, k, j, i);
       y_bin = -1; // reset to impossible value
       // First handle edge cases explicitly
       if (y_val < bins2(0)) {
@@ -273,33 +268,130 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
         if (logscale2 == false) {
           y_bin = static_cast<int>((y_val - bins2(0)) / step_size2) + 1;
         } else if (logscale2 == true) {
-          y_bin = static_cast<int>(std::log10(y_val/bins2(0)) / step_size2) + 1;
+          y_bin = static_cast<int>(log10(y_val/bins2(0)) / step_size2) + 1;
         }
       }
     }
-    auto res = scatter.access();
-    Real weight = size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
-    weight *= mass_weighted == false
-              ? 1.0
-              : u0_(m, IDN, k, j, i);
-    res(y_bin, x_bin) += weight;
-  });
-
-  // "reduce" results from scatter view to original view.
-  // May be a no-op depending on backend.
-  Kokkos::Experimental::contribute(result, scatter); //.KokkosView()
-  // Kokkos::Experimental::contribute(result.KokkosView(), scatter);
-  Kokkos::fence(); // May not be required
-
-  // Now reduce over ranks
+    w = weight*size.d_view(m).dx1*size.d_view(m).dx2*size.d_view(m).dx3;
+    w *= mass_weighted == false
+         ? 1.0
+         : u0_(m, IDN, k, j, i);
+    return y_bin*(nbin_ + 2) + x_bin;
+  };
+
+  int ncolumn = nbin_ + 2;
+  int nbins_tot = result.extent_int(0)*ncolumn;
+  size_t scr_size = ScrArray1D<Real>::shmem_size(nbins_tot);
+  // limit is well below per-team scratch available on GPUs, to keep occupancy high
+  if (scr_size <= 16384) {
+    par_for_outer("pdf_team", DevExeSpace(), scr_size, 0, 0, (nmb-1), ks, ke,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k) {
+      ScrArray1D<Real> hist(member.team_scratch(0), nbins_tot);
+      par_for_inner(member, 0, (nbins_tot-1), [&](const int n) {
+        hist(n) = 0.0;
+      });
+      member.team_barrier();
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nji), [&](const int idx) {
+        int j = idx/nx1 + js;
+        int i = idx%nx1 + is;
+        Real w;
+        int n = find_bin(m, k, j, i, w);
+        Kokkos::atomic_add(&hist(n), w);
+      });
+      member.team_barrier();
+      par_for_inner(member, 0, (nbins_tot-1), [&](const int n) {
+        if (hist(n) != 0.0) {
+          Kokkos::atomic_add(&result(n/ncolumn, n%ncolumn), hist(n));
+        }
+      });
+    });
+  } else {
+    auto scatter = pdf_data.scatter_result;
+    // Reset ScatterView from previous call
+    scatter.reset();
+    int ie = indcs.ie, je = indcs.je;
+    par_for("pdf", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      Real w;
+      int n = find_bin(m, k, j, i, w);
+      auto res = scatter.access();
+      res(n/ncolumn, n%ncolumn) += w;
+    });
+    // "reduce" results from scatter view to original view.
+    // May be a no-op depending on backend.
+    Kokkos::Experimental::contribute(result, scatter);
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PDFOutput::AccumulateOutputData()
+//  \brief With accumulate_dcycle > 0, adds histogram of current data weighted by the time
+//  since the last sample, so that outputs are time-averaged PDFs.
+
+void PDFOutput::AccumulateOutputData(Mesh *pm) {
+  // first sample (at start or after an output) may coincide with the output itself
+  if (pdf_data.last_sample_time == pm->time) {return;}
+  Real dt_sample = (pdf_data.last_sample_time < 0.0)? pm->dt :
+                   (pm->time - pdf_data.last_sample_time);
+  BinData(pm, dt_sample);
+  pdf_data.accum_time += dt_sample;
+  pdf_data.last_sample_time = pm->time;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void PDFOutput::LoadOutputData()
+//  \brief Computes histogram of current data (or time-averaged histogram accumulated
+//  since last output), then starts a non-blocking sum over ranks to the master rank.
+//  Only the master rank waits for the sum to complete (in WriteOutputFile), all other
+//  ranks complete their part of the reduction before the next output.
+
+void PDFOutput::LoadOutputData(Mesh *pm) {
+  // complete the reduction of the previous output, before its buffers are reused
 #if MPI_PARALLEL_ENABLED
-  if (global_variable::my_rank == 0) {
-    MPI_Reduce(MPI_IN_PLACE, result.data(), result.size(),
-                                   MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+  if (reduce_req_ != MPI_REQUEST_NULL) {
+    MPI_Wait(&reduce_req_, MPI_STATUS_IGNORE);
+  }
+#endif
+
+  auto result = pdf_data.result_;
+  if (out_params.accumulate_dcycle > 0) {
+    // time average, or instantaneous PDF if no samples have been accumulated yet
+    if (pdf_data.accum_time > 0.0) {
+      Real norm = 1.0/pdf_data.accum_time;
+      par_for("pdf_norm", DevExeSpace(), 0, result.extent_int(0)-1,
+              0, result.extent_int(1)-1,
+      KOKKOS_LAMBDA(int n2, int n) {
+        result(n2,n) *= norm;
+      });
+    } else {
+      BinData(pm, 1.0);
+    }
   } else {
-    MPI_Reduce(result.data(), result.data(), result.size(),
-                                   MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD);
+    // Also reset the histogram from previous call.
+    // Currently still required for consistent results between host and device backends,
+    // see https://github.com/kokkos/kokkos/issues/6363
+    Kokkos::deep_copy(result, 0);
+    BinData(pm, 1.0);
   }
+
+  // copy to host, then reset accumulated PDF for next output
+  auto result_host = Kokkos::create_mirror_view_and_copy(HostMemSpace(), result);
+  pdf_data.send_buf.assign(result_host.data(), result_host.data() + result_host.size());
+  if (out_params.accumulate_dcycle > 0) {
+    Kokkos::deep_copy(result, 0);
+    pdf_data.accum_time = 0.0;
+    pdf_data.last_sample_time = pm->time;
+  }
+
+  // Now (start to) reduce over ranks
+  pdf_data.recv_buf.resize(pdf_data.send_buf.size());
+#if MPI_PARALLEL_ENABLED
+  MPI_Ireduce(pdf_data.send_buf.data(), pdf_data.recv_buf.data(),
+              pdf_data.send_buf.size(), MPI_ATHENA_REAL, MPI_SUM, 0, MPI_COMM_WORLD,
+              &reduce_req_);
+#else
+  pdf_data.recv_buf = pdf_data.send_buf;
 #endif
 }
 
@@ -308,8 +400,11 @@ void PDFOutput::LoadOutputData(Mesh *pm) {
 //  \brief Cycles through hist_data vector and writes history file for each component
 
 void PDFOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
-  // only the master rank writes the file
+  // only the master rank writes the file, once the reduction over ranks has completed
   if (global_variable::my_rank == 0) {
+#if MPI_PARALLEL_ENABLED
+    MPI_Wait(&reduce_req_, MPI_STATUS_IGNORE);
+#endif
     // Write header, if it has not been written already
     if (!(pdf_data.bins_written)) {
       // create filename: "pdf_"+"file_id"/file_basename" + ".bins.pdf"
@@ -387,12 +482,8 @@ void PDFOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
       exit(EXIT_FAILURE);
     }
 
-    // Create a host mirror of the pdf_data.result_ array
-    auto result_host = Kokkos::create_mirror_view(pdf_data.result_);
-
-    // Copy the data from the device to the host
-    Kokkos::deep_copy(result_host, pdf_data.result_);
-
+    // reduced histogram (nbin2+2, nbin+2) stored contiguously in recv_buf
+    auto &result_host = pdf_data.recv_buf;
     // write history variables
     std::fprintf(pfile, "# time= ");
     std::fprintf(pfile, out_params.data_format.c_str(), pm->time);
@@ -400,7 +491,8 @@ void PDFOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     int number_n2_bins = pdf_data.pdf_dimension == 2 ? pdf_data.nbin2+2 : 1;
     for (int n2=0; n2<number_n2_bins; ++n2) {
       for (int n=0; n<pdf_data.nbin+2; ++n) {
-        std::fprintf(pfile, out_params.data_format.c_str(), result_host(n2, n));
+        std::fprintf(pfile, out_params.data_format.c_str(),
+                     result_host[n2*(pdf_data.nbin+2) + n]);
       }
       std::fprintf(pfile,"\n"); // terminate line
     }
@@ -0,0 +1,184 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file probe.cpp
+//  \brief writes time series of output variables interpolated to fixed points.
+//
+//  Points are given in the <output> block as
+//    point_0 = x1 x2 x3
+//    line_0  = x1 x2 x3  y1 y2 y3  n    # n equally spaced points from x to y
+//  (numbered from 0, for any number of points and lines).  The stencils of all points
+//  are built with the batched LagrangeInterpolator when the output is constructed and
+//  again only after the mesh changes, and all variables are interpolated to all points
+//  with one kernel and one reduction over ranks per output, so probes can be sampled
+//  every cycle at little cost.
+//
+//  All samples are appended to a single binary file "probe/basename.id.probe", which
+//  starts with a text header ending with a line "# end_header".  Each sample is then a
+//  record of (1 + npoints*nvars) Reals: time, then the values of each variable at each
+//  point (variable index fastest).  Values at points outside the Mesh are NaN.
+
+#include <sys/stat.h>  // mkdir
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "utils/lagrange_interpolator.hpp"
+#include "outputs.hpp"
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+ProbeOutput::ProbeOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op), nregrid_(-1) {
+  if (!(pm->three_d)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Probe outputs are only supported for 3D calculations"
+        << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // stencils extend into ghost zones, which are not filled for derived variables
+  if (out_params.contains_derived) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Derived variable '" << op.variable << "' cannot be used in "
+        << "probe output block '" << op.block_name << "'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // read points, then lines
+  for (int n=0; pin->DoesParameterExist(op.block_name, "point_"+std::to_string(n)); ++n) {
+    std::stringstream pt(pin->GetString(op.block_name, "point_"+std::to_string(n)));
+    Real x[3];
+    if (!(pt >> x[0] >> x[1] >> x[2])) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "point_" << n << " in output block '" << op.block_name
+          << "' must be given as three coordinates 'x1 x2 x3'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    coords_.insert(coords_.end(), x, x+3);
+  }
+  for (int n=0; pin->DoesParameterExist(op.block_name, "line_"+std::to_string(n)); ++n) {
+    std::stringstream ln(pin->GetString(op.block_name, "line_"+std::to_string(n)));
+    Real x[3], y[3];
+    int npts;
+    if (!(ln >> x[0] >> x[1] >> x[2] >> y[0] >> y[1] >> y[2] >> npts) || npts < 1) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "line_" << n << " in output block '" << op.block_name
+          << "' must be given as 'x1 x2 x3 y1 y2 y3 n' with n >= 1" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    for (int p=0; p<npts; ++p) {
+      Real f = (npts > 1)? static_cast<Real>(p)/static_cast<Real>(npts-1) : 0.0;
+      for (int d=0; d<3; ++d) {coords_.push_back(x[d] + f*(y[d] - x[d]));}
+    }
+  }
+  if (coords_.empty()) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Probe output block '" << op.block_name << "' contains no "
+        << "point_N or line_N parameters" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  pinterp_ = std::make_unique<LagrangeInterpolator>(pm->pmb_pack);
+  record_.resize(1 + (coords_.size()/3)*outvars.size());
+
+  // create directories for outputs. Comments in binary.cpp constructor explain why
+  mkdir("probe",0775);
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor: defined here, where LagrangeInterpolator is a complete type
+
+ProbeOutput::~ProbeOutput() {}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProbeOutput::LoadOutputData()
+//  \brief Interpolates all variables to all points.  Stencils are rebuilt only if
+//  MeshBlocks have been refined or redistributed since they were last built.
+
+void ProbeOutput::LoadOutputData(Mesh *pm) {
+  int npts = static_cast<int>(coords_.size()/3);
+  if (nregrid_ != pm->nregrid) {
+    pinterp_->SetPoints(npts, coords_.data());
+    nregrid_ = pm->nregrid;
+  }
+  pinterp_->ClearVariables();
+  for (auto &var : outvars) {
+    pinterp_->AddVariable(*(var.data_ptr), var.data_index);
+  }
+  pinterp_->InterpolateAll();
+
+  int nvar = static_cast<int>(outvars.size());
+  auto &vals = pinterp_->vals;
+  record_[0] = pm->time;
+  for (int p=0; p<npts; ++p) {
+    for (int v=0; v<nvar; ++v) {
+      record_[1 + p*nvar + v] = (pinterp_->nfound(p) > 0)? vals(p,v) :
+                                std::numeric_limits<Real>::quiet_NaN();
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void ProbeOutput::WriteOutputFile()
+//  \brief Appends one record to the time series file.  The header is written only when
+//  the file is created, so that restarted runs continue the same file.
+
+void ProbeOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  if (global_variable::my_rank == 0) {
+    // create filename: "probe/file_basename" + "." + "file_id" + ".probe"
+    std::string fname;
+    fname.assign("probe/");
+    fname.append(out_params.file_basename);
+    fname.append(".");
+    fname.append(out_params.file_id);
+    fname.append(".probe");
+
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(),"ab")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+      exit(EXIT_FAILURE);
+    }
+    std::fseek(pfile, 0, SEEK_END);
+    if (std::ftell(pfile) == 0) {
+      int npts = static_cast<int>(coords_.size()/3);
+      std::fprintf(pfile, "# Athena probe time series\n");
+      std::fprintf(pfile, "# npoints=%d nvars=%d real_size=%d\n", npts,
+                   static_cast<int>(outvars.size()), static_cast<int>(sizeof(Real)));
+      std::fprintf(pfile, "# variables:");
+      for (auto &var : outvars) {std::fprintf(pfile, " %s", var.label.c_str());}
+      std::fprintf(pfile, "\n");
+      for (int p=0; p<npts; ++p) {
+        std::fprintf(pfile, "# point %d:", p);
+        for (int d=0; d<3; ++d) {
+          std::fprintf(pfile, out_params.data_format.c_str(), coords_[3*p + d]);
+        }
+        std::fprintf(pfile, "\n");
+      }
+      std::fprintf(pfile, "# end_header\n");
+    }
+    std::fwrite(record_.data(), sizeof(Real), record_.size(), pfile);
+    std::fclose(pfile);
+  }
+
+  // increment counters
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
@@ -5,17 +5,52 @@
 //========================================================================================
 //! \file restart.cpp
 //! \brief writes restart files
+//!
+//! By default all ranks write one shared restart file in rst/.  If <output>/local_dir is
+//! set, restarts are two-tier: every node writes its own file (with the same header as
+//! the shared file, followed by data for MeshBlocks on that node) to node-local storage,
+//! and a background thread copies each file to rst/ while the calculation continues.
+//! Only the last <output>/num_local files are kept on node-local storage.  Restarting
+//! from node-local files (or their copies in rst/) requires the same number of ranks and
+//! ranks per node, see main.cpp.
+//!
+//! If <output>/delta_interval = N > 1, only every Nth restart is full.  The others are
+//! delta restarts, containing only the MeshBlocks whose data differs (by a hash of the
+//! data of each MeshBlock) from the last full restart, which they reference.  Delta files
+//! have the same header as full files, but with data size 0 followed by the true data
+//! size, offset of data and name of the full file, and list of changed gids.  A full
+//! restart is always written after the mesh is refined or redistributed.
+//!
+//! Reduced restarts, e.g. for frequent checkpoints used only for analysis or approximate
+//! restarts, contain only the modules listed in <output>/modules (any of hydro, mhd, rad,
+//! force, z4c, adm; default all), with values stored as float if <output>/precision =
+//! single.  They can be restarted from like full restarts: values are converted back to
+//! Real, and modules that are not in the file are left as initialized (zero).
+//!
+//! With <output>/stream_nmb = N > 0, full restarts are streamed: rather than copying all
+//! data to host before writing, each array is copied from device in chunks of N
+//! MeshBlocks into two pinned host buffers in turn, and the copy of the next chunk
+//! overlaps the writes of the current one.  Host memory needed is then independent of
+//! the number of MeshBlocks per rank.
 
 #include <sys/stat.h>  // mkdir
 
 #include <algorithm>
-#include <cstdio>      // fwrite(), fclose(), fopen(), fnprintf(), snprintf()
+#include <cstdint>
+#include <cstdio>      // fwrite(), fclose(), fopen(), fnprintf(), snprintf(), remove()
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility> // make_pair
+#include <vector>
 
 #include "athena.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -29,8 +64,17 @@
 #include "z4c/z4c.hpp"
 #include "radiation/radiation.hpp"
 #include "srcterms/turb_driver.hpp"
+#include "file_layout.hpp"
 //#include "outputs.hpp"
 
+// structures written as raw bytes must match their copies read by file_reader
+static_assert(sizeof(RegionSize) == sizeof(file_layout::RestartRegionSize<Real>),
+              "RegionSize differs from file_layout::RestartRegionSize");
+static_assert(sizeof(RegionIndcs) == sizeof(file_layout::RestartRegionIndcs),
+              "RegionIndcs differs from file_layout::RestartRegionIndcs");
+static_assert(sizeof(LogicalLocation) == sizeof(file_layout::RestartLocation),
+              "LogicalLocation differs from file_layout::RestartLocation");
+
 //----------------------------------------------------------------------------------------
 // ctor: also calls BaseTypeOutput base class constructor
 
@@ -38,6 +82,138 @@ RestartOutput::RestartOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
   BaseTypeOutput(pin, pm, op) {
   // create directories for outputs. Comments in binary.cpp constructor explain why
   mkdir("rst",0775);
+
+  // node-local (two-tier) restarts
+  local_dir_ = pin->GetOrAddString(op.block_name, "local_dir", "");
+  nkeep_local_ = pin->GetOrAddInteger(op.block_name, "num_local", 2);
+  drain_ = pin->GetOrAddBoolean(op.block_name, "drain", true);
+  delta_interval_ = pin->GetOrAddInteger(op.block_name, "delta_interval", 1);
+  stream_nmb_ = pin->GetOrAddInteger(op.block_name, "stream_nmb", 0);
+  // reduced restarts: subset of modules and/or single precision
+  std::string prec = pin->GetOrAddString(op.block_name, "precision", "double");
+  single_ = (prec.compare("single") == 0);
+  if (!single_ && prec.compare("double") != 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "precision='" << prec << "' in output block '" << op.block_name
+        << "' must be 'double' or 'single'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (single_ && sizeof(Real) == sizeof(float)) {single_ = false;}
+  std::stringstream mods(pin->GetOrAddString(op.block_name, "modules", "all"));
+  std::string mod;
+  modules_ = 0;
+  while (mods >> mod) {
+    if (mod.compare("all") == 0) {
+      modules_ |= file_layout::kRestartAll;
+    } else if (mod.compare("hydro") == 0) {
+      modules_ |= file_layout::kRestartHydro;
+    } else if (mod.compare("mhd") == 0) {
+      modules_ |= file_layout::kRestartMHD;
+    } else if (mod.compare("rad") == 0) {
+      modules_ |= file_layout::kRestartRad;
+    } else if (mod.compare("force") == 0) {
+      modules_ |= file_layout::kRestartForce;
+    } else if (mod.compare("z4c") == 0) {
+      modules_ |= file_layout::kRestartZ4c;
+    } else if (mod.compare("adm") == 0) {
+      modules_ |= file_layout::kRestartADM;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Unknown module '" << mod << "' in modules of output block '"
+          << op.block_name << "', must be all, hydro, mhd, rad, force, z4c or adm"
+          << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  if ((single_ || modules_ != file_layout::kRestartAll) && delta_interval_ > 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "delta_interval > 1 cannot be used with precision or modules in "
+        << "output block '" << op.block_name << "'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // delta and reduced restarts pack all MeshBlocks on host, so cannot be streamed
+  if (stream_nmb_ > 0 && (single_ || modules_ != file_layout::kRestartAll ||
+                          delta_interval_ > 1)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "stream_nmb cannot be used with delta_interval > 1, precision or "
+        << "modules in output block '" << op.block_name << "'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (delta_interval_ > 1 && !local_dir_.empty()) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "delta_interval > 1 cannot be used with local_dir in output "
+        << "block '" << op.block_name << "'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  node_id_ = 0;
+  hdr_rank_ = (global_variable::my_rank == 0);
+  if (!local_dir_.empty()) {
+    if (nkeep_local_ < 1) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "num_local=" << nkeep_local_ << " in output block '"
+          << op.block_name << "' must be at least 1" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+#if MPI_PARALLEL_ENABLED
+    NodeCommunicator(&node_comm_, &node_id_);
+    int node_rank;
+    MPI_Comm_rank(node_comm_, &node_rank);
+    hdr_rank_ = (node_rank == 0);
+#endif
+    mkdir(local_dir_.c_str(),0775);
+    // only one rank per node copies and deletes files
+    if (hdr_rank_) {
+      drain_thread_ = std::thread(&RestartOutput::DrainLoop, this);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+// destructor: waits for all node-local files to be copied to rst/
+
+RestartOutput::~RestartOutput() {
+  if (drain_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(drain_mutex_);
+      drain_stop_ = true;
+    }
+    drain_cv_.notify_all();
+    drain_thread_.join();
+  }
+#if MPI_PARALLEL_ENABLED
+  if (node_comm_ != MPI_COMM_NULL) {MPI_Comm_free(&node_comm_);}
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::DrainLoop()
+//! \brief Runs in background thread on one rank per node.  Copies node-local restart
+//! files to rst/, and deletes old node-local files, in the order the jobs were queued.
+//! Uses only POSIX file I/O, so no MPI calls are made from this thread.
+
+void RestartOutput::DrainLoop() {
+  while (true) {
+    DrainJob job;
+    {
+      std::unique_lock<std::mutex> lock(drain_mutex_);
+      drain_cv_.wait(lock, [this]{return drain_stop_ || !drain_queue_.empty();});
+      if (drain_queue_.empty()) {return;}
+      job = drain_queue_.front();
+      drain_queue_.pop_front();
+    }
+    if (job.dst.empty()) {
+      std::remove(job.src.c_str());
+    } else {
+      std::ifstream src(job.src, std::ios::binary);
+      std::ofstream dst(job.dst, std::ios::binary | std::ios::trunc);
+      dst << src.rdbuf();
+      if (!src.good() || !dst.good()) {
+        std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+            << std::endl << "Node-local restart file '" << job.src
+            << "' could not be copied to '" << job.dst << "'" << std::endl;
+      }
+    }
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -46,6 +222,16 @@ RestartOutput::RestartOutput(ParameterInput *pin, Mesh *pm, OutputParameters op)
 // variables, including ghost zones.
 
 void RestartOutput::LoadOutputData(Mesh *pm) {
+  // calculate max/min number of MeshBlocks across all ranks
+  noutmbs_max = pm->nmb_eachrank[0];
+  noutmbs_min = pm->nmb_eachrank[0];
+  for (int i=0; i<(global_variable::nranks); ++i) {
+    noutmbs_max = std::max(noutmbs_max,pm->nmb_eachrank[i]);
+    noutmbs_min = std::min(noutmbs_min,pm->nmb_eachrank[i]);
+  }
+  // streamed restarts copy data from device while it is written
+  if (stream_nmb_ > 0) {return;}
+
   // get spatial dimensions of arrays, including ghost zones
   auto &indcs = pm->pmb_pack->pmesh->mb_indcs;
   int nout1 = indcs.nx1 + 2*(indcs.ng);
@@ -74,7 +260,7 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
   }
   // if the spacetime is evolved, we do not need to checkpoint/recover the ADM variables
   if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
+    nrad = prad->nvar;
   }
 
   // Note for restarts, outarrays are dimensioned (m,n,k,j,i)
@@ -116,13 +302,57 @@ void RestartOutput::LoadOutputData(Mesh *pm) {
     Kokkos::deep_copy(outarray_adm, Kokkos::subview(padm->u_adm, std::make_pair(0,nmb),
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL));
   }
+}
 
-  // calculate max/min number of MeshBlocks across all ranks
-  noutmbs_max = pm->nmb_eachrank[0];
-  noutmbs_min = pm->nmb_eachrank[0];
-  for (int i=0; i<(global_variable::nranks); ++i) {
-    noutmbs_max = std::max(noutmbs_max,pm->nmb_eachrank[i]);
-    noutmbs_min = std::min(noutmbs_min,pm->nmb_eachrank[i]);
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::PackMeshBlock()
+//! \brief Copies all data of MeshBlock m (on this rank) into pdata, in the order it is
+//! stored in restart files.  Used to compute hashes, and to write delta restarts.  For
+//! reduced restarts only the given modules (file_layout::RestartModule flags) are copied,
+//! optionally converted to float.
+
+void RestartOutput::PackMeshBlock(Mesh *pm, int m, char *pdata, int modules,
+                                  bool single) {
+  auto copy = [&pdata, single](const Real *src, std::size_t cnt) {
+    if (single) {
+      for (std::size_t n=0; n<cnt; ++n) {
+        float val = static_cast<float>(src[n]);
+        std::memcpy(pdata, &val, sizeof(float));
+        pdata += sizeof(float);
+      }
+    } else {
+      std::memcpy(pdata, src, cnt*sizeof(Real));
+      pdata += cnt*sizeof(Real);
+    }
+  };
+  auto mbpack = [&copy, m](const HostArray5D<Real> &a) {
+    auto mbptr = Kokkos::subview(a, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
+                                 Kokkos::ALL);
+    copy(mbptr.data(), mbptr.size());
+  };
+  auto &pack = pm->pmb_pack;
+  if (pack->phydro != nullptr && (modules & file_layout::kRestartHydro)) {
+    mbpack(outarray_hyd);
+  }
+  if (pack->pmhd != nullptr && (modules & file_layout::kRestartMHD)) {
+    mbpack(outarray_mhd);
+    auto x1fptr = Kokkos::subview(outfield.x1f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+    copy(x1fptr.data(), x1fptr.size());
+    auto x2fptr = Kokkos::subview(outfield.x2f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+    copy(x2fptr.data(), x2fptr.size());
+    auto x3fptr = Kokkos::subview(outfield.x3f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
+    copy(x3fptr.data(), x3fptr.size());
+  }
+  if (pack->prad != nullptr && (modules & file_layout::kRestartRad)) {
+    mbpack(outarray_rad);
+  }
+  if (pack->pturb != nullptr && (modules & file_layout::kRestartForce)) {
+    mbpack(outarray_force);
+  }
+  if (pack->pz4c != nullptr) {
+    if (modules & file_layout::kRestartZ4c) {mbpack(outarray_z4c);}
+  } else if (pack->padm != nullptr && (modules & file_layout::kRestartADM)) {
+    mbpack(outarray_adm);
   }
 }
 
@@ -150,7 +380,7 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     nmhd = pmhd->nmhd + pmhd->nscalars;
   }
   if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
+    nrad = prad->nvar;
   }
   if (pz4c != nullptr) {
     nz4c = pz4c->nz4c;
@@ -159,16 +389,23 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
     nadm = padm->nadm;
   }
   // create filename: "rst/file_basename" + "." + XXXXX + ".rst"
-  // where XXXXX = 5-digit file_number
-  std::string fname;
+  // where XXXXX = 5-digit file_number.  Node-local files are written to local_dir, with
+  // the name returned by NodeLocalFileName()
+  std::string fname, rname;
   char number[6];
   std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
 
-  fname.assign("rst/");
-  fname.append(out_params.file_basename);
-  fname.append(".");
-  fname.append(number);
-  fname.append(".rst");
+  rname.assign(out_params.file_basename);
+  rname.append(".");
+  rname.append(number);
+  rname.append(".rst");
+  bool node_local = !local_dir_.empty();
+  if (node_local) {
+    rname = NodeLocalFileName(rname, node_id_);
+    fname = local_dir_ + "/" + rname;
+  } else {
+    fname = "rst/" + rname;
+  }
 
   // increment counters now so values for *next* dump are stored in restart file
   out_params.file_number++;
@@ -189,10 +426,14 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // Input file data is read by ParameterInput on restart, and the remaining header
   // variables are read in Mesh::BuildTreeFromRestart()
 
-  // open file and  write the header; this part is serial
+  // open file and  write the header; this part is serial.  Header is written to every
+  // node-local file.
   IOWrapper resfile;
+#if MPI_PARALLEL_ENABLED
+  if (node_local) {resfile.SetCommunicator(node_comm_);}
+#endif
   resfile.Open(fname.c_str(), IOWrapper::FileMode::write);
-  if (global_variable::my_rank == 0) {
+  if (hdr_rank_) {
     // output the input parameters (input file)
     resfile.Write_any_type(sbuf.c_str(),sbuf.size(),"byte");
 
@@ -210,14 +451,14 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   //--- STEP 2.  Root process writes list of logical locations and cost of MeshBlocks
   // This data read in Mesh::BuildTreeFromRestart()
 
-  if (global_variable::my_rank == 0) {
+  if (hdr_rank_) {
     resfile.Write_any_type(&(pm->lloc_eachmb[0]),(pm->nmb_total)*sizeof(LogicalLocation),
                            "byte");
     resfile.Write_any_type(&(pm->cost_eachmb[0]), (pm->nmb_total)*sizeof(float),"byte");
   }
 
   //--- STEP 3.  Root process writes internal state of objects that require it
-  if (global_variable::my_rank == 0) {
+  if (hdr_rank_) {
     // store z4c information
     if (pz4c != nullptr) {
       resfile.Write_any_type(&(pz4c->last_output_time), sizeof(Real), "byte");
@@ -260,24 +501,219 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   } else if (padm != nullptr) {
     data_size += nout1*nout2*nout3*nadm*sizeof(Real);   // adm u_adm
   }
-  if (global_variable::my_rank == 0) {
-    resfile.Write_any_type(&(data_size), sizeof(IOWrapperSizeT), "byte");
-  }
 
   // calculate size of data written in Steps 1-2 above
-  IOWrapperSizeT step1size = sbuf.size()*sizeof(char) + 3*sizeof(int) + 2*sizeof(Real) +
-                             sizeof(RegionSize) + 2*sizeof(RegionIndcs);
+  IOWrapperSizeT step1size = sbuf.size()*sizeof(char) +
+                             file_layout::RestartMeshHeaderSize<Real>();
   IOWrapperSizeT step2size = (pm->nmb_total)*(sizeof(LogicalLocation) + sizeof(float));
 
   IOWrapperSizeT step3size = 3*nco*sizeof(Real);
   if (pz4c != nullptr) step3size += sizeof(Real);
   if (pturb != nullptr) step3size += sizeof(RNG_State);
 
-  // write cell-centered variables in parallel
+  // Reduced restarts: pack the selected modules of all MeshBlocks on this rank (as float
+  // with precision=single), and write them in parallel after an extended header.
+  if (single_ || modules_ != file_layout::kRestartAll) {
+    IOWrapperSizeT ncells = nout1*nout2*nout3;
+    IOWrapperSizeT nvals = 0;
+    std::int32_t mods = 0;
+    if (phydro != nullptr && (modules_ & file_layout::kRestartHydro)) {
+      nvals += ncells*nhydro;
+      mods |= file_layout::kRestartHydro;
+    }
+    if (pmhd != nullptr && (modules_ & file_layout::kRestartMHD)) {
+      nvals += ncells*nmhd + (nout1+1)*nout2*nout3 + nout1*(nout2+1)*nout3 +
+               nout1*nout2*(nout3+1);
+      mods |= file_layout::kRestartMHD;
+    }
+    if (prad != nullptr && (modules_ & file_layout::kRestartRad)) {
+      nvals += ncells*nrad;
+      mods |= file_layout::kRestartRad;
+    }
+    if (pturb != nullptr && (modules_ & file_layout::kRestartForce)) {
+      nvals += ncells*nforce;
+      mods |= file_layout::kRestartForce;
+    }
+    if (pz4c != nullptr) {
+      if (modules_ & file_layout::kRestartZ4c) {
+        nvals += ncells*nz4c;
+        mods |= file_layout::kRestartZ4c;
+      }
+    } else if (padm != nullptr && (modules_ & file_layout::kRestartADM)) {
+      nvals += ncells*nadm;
+      mods |= file_layout::kRestartADM;
+    }
+    std::int32_t vsize = (single_)? sizeof(float) : sizeof(Real);
+    IOWrapperSizeT soft_size = nvals*vsize;
+    if (hdr_rank_) {
+      std::uint64_t sizes[2] = {file_layout::kRestartSoftMarker, soft_size};
+      resfile.Write_any_type(sizes, sizeof(sizes), "byte");
+      resfile.Write_any_type(&(vsize), sizeof(std::int32_t), "byte");
+      resfile.Write_any_type(&(mods), sizeof(std::int32_t), "byte");
+    }
+
+    int nmb = pm->nmb_thisrank;
+    std::vector<char> data(soft_size*nmb);
+    for (int m=0; m<nmb; ++m) {
+      PackMeshBlock(pm, m, &(data[soft_size*m]), mods, single_);
+    }
+    int gid0 = 0;
+#if MPI_PARALLEL_ENABLED
+    if (node_local) {
+      gid0 = pm->gids_eachrank[global_variable::my_rank];
+      MPI_Allreduce(MPI_IN_PLACE, &gid0, 1, MPI_INT, MPI_MIN, node_comm_);
+    }
+#endif
+    IOWrapperSizeT myoffset = step1size + step2size + step3size +
+        file_layout::kRestartSoftHeaderSize +
+        soft_size*(pm->gids_eachrank[global_variable::my_rank] - gid0);
+    IOWrapperSizeT nbytes = data.size();
+    const IOWrapperSizeT max_write = (static_cast<IOWrapperSizeT>(1) << 30);
+    int nwrites = static_cast<int>((nbytes + max_write - 1)/max_write);
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &nwrites, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    for (int n=0; n<nwrites; ++n) {
+      IOWrapperSizeT os = std::min(nbytes, n*max_write);
+      IOWrapperSizeT cnt = std::min(max_write, nbytes - os);
+      if (resfile.Write_any_type_at_all(data.data() + os, cnt, myoffset + os, "byte")
+          != cnt) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "MeshBlock data not written correctly to reduced rst file, "
+        << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+    resfile.Close();
+    if (node_local && hdr_rank_) {QueueLocalFile(fname, rname);}
+    return;
+  }
+
+  // For delta restarts, hash data of each MeshBlock, and compare to last full restart.
+  // FNV-1a hash of packed data is used, so any change in any bit is detected.
+  int nmb = pm->nmb_thisrank;
+  std::vector<std::uint64_t> mbhash;
+  std::vector<char> mbdata;
+  if (delta_interval_ > 1) {
+    mbhash.resize(nmb);
+    mbdata.resize(data_size);
+    for (int m=0; m<nmb; ++m) {
+      PackMeshBlock(pm, m, mbdata.data());
+      std::uint64_t h = 14695981039346656037ULL;
+      for (IOWrapperSizeT n=0; n<data_size; ++n) {
+        h = (h ^ static_cast<unsigned char>(mbdata[n]))*1099511628211ULL;
+      }
+      mbhash[m] = h;
+    }
+  }
+  bool delta = (delta_interval_ > 1) && !base_fname_.empty() &&
+               (ndelta_ < delta_interval_-1) && (pm->nregrid == base_nregrid_);
+
+  if (delta) {
+    // gids of changed MeshBlocks over all ranks, in order
+    std::vector<int> delta_gids;
+    int mygids = pm->gids_eachrank[global_variable::my_rank];
+    for (int m=0; m<nmb; ++m) {
+      if (mbhash[m] != base_hash_[m]) {delta_gids.push_back(mygids + m);}
+    }
+    int nchanged = delta_gids.size();
+    std::vector<int> nchanged_eachrank(global_variable::nranks, 0);
+    nchanged_eachrank[global_variable::my_rank] = nchanged;
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, nchanged_eachrank.data(), global_variable::nranks,
+                  MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+    std::vector<int> displ(global_variable::nranks, 0);
+    std::partial_sum(nchanged_eachrank.begin(), std::prev(nchanged_eachrank.end()),
+                     std::next(displ.begin()));
+    int ndelta_total = displ.back() + nchanged_eachrank.back();
+#if MPI_PARALLEL_ENABLED
+    std::vector<int> all_gids(ndelta_total);
+    MPI_Allgatherv(delta_gids.data(), nchanged, MPI_INT, all_gids.data(),
+                   nchanged_eachrank.data(), displ.data(), MPI_INT, MPI_COMM_WORLD);
+    delta_gids = all_gids;
+#endif
+
+    // data size 0 marks delta file, followed by extended header
+    if (hdr_rank_) {
+      IOWrapperSizeT zero = 0;
+      int len = base_fname_.size();
+      resfile.Write_any_type(&(zero), sizeof(IOWrapperSizeT), "byte");
+      resfile.Write_any_type(&(data_size), sizeof(IOWrapperSizeT), "byte");
+      resfile.Write_any_type(&(base_offset_), sizeof(IOWrapperSizeT), "byte");
+      resfile.Write_any_type(&(len), sizeof(int), "byte");
+      resfile.Write_any_type(base_fname_.c_str(), len, "byte");
+      resfile.Write_any_type(&(ndelta_total), sizeof(int), "byte");
+      resfile.Write_any_type(delta_gids.data(), ndelta_total*sizeof(int), "byte");
+    }
+    IOWrapperSizeT hdrsize = step1size + step2size + step3size +
+      3*sizeof(IOWrapperSizeT) + 2*sizeof(int) + base_fname_.size() +
+      ndelta_total*sizeof(int);
+
+    // pack changed MeshBlocks on this rank, and write them in parallel in pieces of at
+    // most 2^30 bytes
+    std::vector<char> data(data_size*nchanged);
+    for (int n=0, m=0; m<nmb; ++m) {
+      if (mbhash[m] != base_hash_[m]) {
+        PackMeshBlock(pm, m, &(data[data_size*(n++)]));
+      }
+    }
+    IOWrapperSizeT nbytes = data.size();
+    const IOWrapperSizeT max_write = (static_cast<IOWrapperSizeT>(1) << 30);
+    int nwrites = static_cast<int>((nbytes + max_write - 1)/max_write);
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &nwrites, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    IOWrapperSizeT myoffset = hdrsize + data_size*displ[global_variable::my_rank];
+    for (int n=0; n<nwrites; ++n) {
+      IOWrapperSizeT os = std::min(nbytes, n*max_write);
+      IOWrapperSizeT cnt = std::min(max_write, nbytes - os);
+      if (resfile.Write_any_type_at_all(data.data() + os, cnt, myoffset + os, "byte")
+          != cnt) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "MeshBlock data not written correctly to delta rst file, "
+        << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+    resfile.Close();
+    ndelta_++;
+    return;
+  }
+
+  if (hdr_rank_) {
+    resfile.Write_any_type(&(data_size), sizeof(IOWrapperSizeT), "byte");
+  }
+
+  // store information about this full restart, referenced by later delta restarts
+  if (delta_interval_ > 1) {
+    base_fname_ = fname;
+    base_offset_ = step1size + step2size + step3size + sizeof(IOWrapperSizeT);
+    base_nregrid_ = pm->nregrid;
+    base_hash_ = mbhash;
+    ndelta_ = 0;
+  }
+
+  // write cell-centered variables in parallel.  Data in node-local files starts with the
+  // lowest gid on the node.
+  int gid0 = 0;
+#if MPI_PARALLEL_ENABLED
+  if (node_local) {
+    gid0 = pm->gids_eachrank[global_variable::my_rank];
+    MPI_Allreduce(MPI_IN_PLACE, &gid0, 1, MPI_INT, MPI_MIN, node_comm_);
+  }
+#endif
   IOWrapperSizeT offset_myrank  = step1size + step2size + step3size +
-        sizeof(IOWrapperSizeT) + data_size*(pm->gids_eachrank[global_variable::my_rank]);
+    sizeof(IOWrapperSizeT) + data_size*(pm->gids_eachrank[global_variable::my_rank]-gid0);
   IOWrapperSizeT myoffset = offset_myrank;
 
+  if (stream_nmb_ > 0) {
+    WriteStreamed(pm, resfile, offset_myrank, data_size);
+    resfile.Close();
+    if (node_local && hdr_rank_) {QueueLocalFile(fname, rname);}
+    return;
+  }
+
   // write cell-centered variables, one MeshBlock at a time (but parallelized over all
   // ranks). MeshBlocks are written seperately to reduce number of data elements per write
   // call, to avoid exceeding 2^31 limit for very large grids per MPI rank.
@@ -572,5 +1008,114 @@ void RestartOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
   // close file, clean up
   resfile.Close();
 
+  if (node_local && hdr_rank_) {QueueLocalFile(fname, rname);}
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::WriteStreamed()
+//! \brief Writes data of all MeshBlocks on this rank in full restarts directly from the
+//! device arrays, in the same order and at the same offsets as WriteOutputFile().  For
+//! each array, chunks of stream_nmb_ MeshBlocks are copied into the two pinned buffers
+//! in turn on separate execution space instances, so that the copy of the next chunk
+//! overlaps writing the current one.  Writes are collective while all ranks have data.
+
+void RestartOutput::WriteStreamed(Mesh *pm, IOWrapper &resfile,
+                                  IOWrapperSizeT offset_myrank,
+                                  IOWrapperSizeT data_size) {
+  // data of each MeshBlock is contiguous in all arrays, so they are viewed as (m, n)
+  using FlatView = Kokkos::View<Real**, LayoutWrapper, DevMemSpace,
+                                Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+  using PinnedFlatView = Kokkos::View<Real**, LayoutWrapper, PinnedMemSpace,
+                                      Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+  std::vector<std::pair<FlatView, std::string>> arrays;
+  auto add = [&arrays](const auto &a, const std::string &name) {
+    int cnt = static_cast<int>(a.size()/a.extent(0));
+    arrays.push_back(std::make_pair(FlatView(a.data(), a.extent(0), cnt), name));
+  };
+  auto &pack = pm->pmb_pack;
+  if (pack->phydro != nullptr) {add(pack->phydro->u0, "cell-centered hydro");}
+  if (pack->pmhd != nullptr) {
+    add(pack->pmhd->u0, "cell-centered mhd");
+    add(pack->pmhd->b0.x1f, "b0.x1f");
+    add(pack->pmhd->b0.x2f, "b0.x2f");
+    add(pack->pmhd->b0.x3f, "b0.x3f");
+  }
+  if (pack->prad != nullptr) {add(pack->prad->i0, "cell-centered rad");}
+  if (pack->pturb != nullptr) {add(pack->pturb->force, "cell-centered force");}
+  if (pack->pz4c != nullptr) {
+    add(pack->pz4c->u0, "cell-centered z4c");
+  } else if (pack->padm != nullptr) {
+    add(pack->padm->u_adm, "cell-centered adm");
+  }
+
+  // (re)allocate pinned buffers large enough for a chunk of any array
+  std::size_t bufsize = 1;
+  for (auto &arr : arrays) {
+    bufsize = std::max(bufsize, stream_nmb_*arr.first.extent(1));
+  }
+  for (auto &buf : stream_buf_) {
+    if (buf.size() < bufsize) {Kokkos::realloc(buf, bufsize);}
+  }
+  auto exec = Kokkos::Experimental::partition_space(DevExeSpace(), 1, 1);
+  // copies are made on other instances, so wait for all updates of data to finish
+  DevExeSpace().fence();
+
+  int nmb = pm->nmb_thisrank;
+  int nchunk = (noutmbs_max + stream_nmb_ - 1)/stream_nmb_;
+  for (auto &arr : arrays) {
+    int cnt = arr.first.extent_int(1);
+    // starts copy of MeshBlocks in chunk c on this rank (if any) into buffer c%2
+    auto stage = [&](const int c) {
+      int m0 = std::min(c*stream_nmb_, nmb);
+      int m1 = std::min((c+1)*stream_nmb_, nmb);
+      if (m1 > m0) {
+        PinnedFlatView dst(stream_buf_[c%2].data(), m1-m0, cnt);
+        auto src = Kokkos::subview(arr.first, std::make_pair(m0,m1), Kokkos::ALL);
+        Kokkos::deep_copy(exec[c%2], dst, src);
+      }
+    };
+    stage(0);
+    for (int c=0; c<nchunk; ++c) {
+      if (c+1 < nchunk) {stage(c+1);}
+      exec[c%2].fence();
+      int mend = std::min((c+1)*stream_nmb_, noutmbs_max);
+      for (int m=c*stream_nmb_; m<mend; ++m) {
+        const Real *pdata = stream_buf_[c%2].data() +
+                            static_cast<std::size_t>(m - c*stream_nmb_)*cnt;
+        IOWrapperSizeT myoffset = offset_myrank + m*data_size;
+        std::size_t nwritten = cnt;
+        if (m < noutmbs_min) {
+          // every rank has a MB to write, so write collectively
+          nwritten = resfile.Write_any_type_at_all(pdata, cnt, myoffset, "Real");
+        } else if (m < nmb) {
+          // some ranks are finished writing, so use non-collective write
+          nwritten = resfile.Write_any_type_at(pdata, cnt, myoffset, "Real");
+        }
+        if (nwritten != static_cast<std::size_t>(cnt)) {
+          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << arr.second << " data not written correctly to rst file, "
+          << "restart file is broken." << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      }
+    }
+    offset_myrank += cnt*sizeof(Real);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void RestartOutput::QueueLocalFile()
+//! \brief queues copy of node-local file fname to rst/rname, and deletion of oldest
+//! node-local files
+
+void RestartOutput::QueueLocalFile(const std::string &fname, const std::string &rname) {
+  std::lock_guard<std::mutex> lock(drain_mutex_);
+  if (drain_) {drain_queue_.push_back({fname, "rst/" + rname});}
+  local_files_.push_back(fname);
+  while (local_files_.size() > static_cast<std::size_t>(nkeep_local_)) {
+    drain_queue_.push_back({local_files_.front(), ""});
+    local_files_.pop_front();
+  }
+  drain_cv_.notify_all();
+}
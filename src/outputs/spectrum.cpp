@@ -0,0 +1,348 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file spectrum.cpp
+//  \brief writes shell-averaged power spectra of the density, velocity and (for MHD)
+//  magnetic field, computed in-situ on uniform (single level) meshes.
+//
+//  Fourier coefficients f(k) = (1/N) sum_x f(x) exp(-i k.x) of each field are computed
+//  for all integer wavenumbers |kx|,|ky|,|kz| <= kmax (in units of 2pi/L in each
+//  direction) by a separable direct transform: each MeshBlock is transformed in x1, then
+//  x2, and the transforms in x3 of all MeshBlocks on a rank are summed into one array of
+//  coefficients.  These are then summed over ranks.  The cost per output is
+//  O(N_cells*kmax) on each rank, and O(kmax^3) memory and communication, so kmax should
+//  be kept well below the number of cells for large meshes.  Since fields are real, only
+//  kx >= 0 is computed.  The mesh is assumed periodic.
+//
+//  Power is binned in shells of width 2pi/L_x1 in |k|, and normalized so that the sum
+//  over all shells is the volume average of f^2 (over modes with |k| <= kmax).  With
+//  helmholtz=true the velocity spectrum is also split into compressive (parallel to k)
+//  and solenoidal parts.  Each output is written to its own file in the "spec"
+//  directory, as text, or (with binary=true) as a short text header followed by the
+//  table of values as raw Reals.
+
+#include <sys/stat.h>  // mkdir
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
+#include "outputs.hpp"
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+SpectrumOutput::SpectrumOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+  if (op.variable.compare("hydro_w") != 0 && op.variable.compare("mhd_w") != 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Spectrum output block '" << op.block_name << "' requires "
+        << "variable = hydro_w or mhd_w" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (pm->multilevel) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Spectrum outputs are only supported on uniform meshes, "
+        << "without SMR or AMR" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (op.spec_kmax < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "kmax=" << op.spec_kmax << " in output block '"
+        << op.block_name << "' must be at least 1" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  ncomp_ = (op.variable.compare("mhd_w") == 0)? 7 : 4;
+
+  // largest wavenumbers in each direction, limited by Nyquist wavenumber of Mesh
+  nx_[0] = pm->mesh_indcs.nx1;
+  nx_[1] = pm->mesh_indcs.nx2;
+  nx_[2] = pm->mesh_indcs.nx3;
+  len_[0] = pm->mesh_size.x1max - pm->mesh_size.x1min;
+  len_[1] = pm->mesh_size.x2max - pm->mesh_size.x2min;
+  len_[2] = pm->mesh_size.x3max - pm->mesh_size.x3min;
+  for (int d=0; d<3; ++d) {
+    kmax_[d] = std::min(op.spec_kmax, nx_[d]/2);
+  }
+
+  // tables of cos(2 pi k g/N) and sin(2 pi k g/N) for each wavenumber k and global cell
+  // index g.  Wavenumbers are stored from -kmax in x2 and x3, and from 0 in x1.
+  for (int d=0; d<3; ++d) {
+    int nk = (d == 0)? (kmax_[0] + 1) : (2*kmax_[d] + 1);
+    int kshift = (d == 0)? 0 : kmax_[d];
+    cos_[d] = DvceArray2D<Real>("spec_cos", nk, nx_[d]);
+    sin_[d] = DvceArray2D<Real>("spec_sin", nk, nx_[d]);
+    auto cos_h = Kokkos::create_mirror_view(cos_[d]);
+    auto sin_h = Kokkos::create_mirror_view(sin_[d]);
+    for (int n=0; n<nk; ++n) {
+      for (int g=0; g<nx_[d]; ++g) {
+        // reduce k*g modulo N first, to keep argument small
+        int kg = ((n - kshift)*g) % nx_[d];
+        Real theta = 2.0*M_PI*static_cast<Real>(kg)/static_cast<Real>(nx_[d]);
+        cos_h(n,g) = std::cos(theta);
+        sin_h(n,g) = std::sin(theta);
+      }
+    }
+    Kokkos::deep_copy(cos_[d], cos_h);
+    Kokkos::deep_copy(sin_[d], sin_h);
+  }
+  f_re_ = DvceArray4D<Real>("spec_fre", ncomp_, 2*kmax_[2]+1, 2*kmax_[1]+1, kmax_[0]+1);
+  f_im_ = DvceArray4D<Real>("spec_fim", ncomp_, 2*kmax_[2]+1, 2*kmax_[1]+1, kmax_[0]+1);
+
+  // create directories for outputs. Comments in binary.cpp constructor explain why
+  mkdir("spec",0775);
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor: completes any reduction of the last output still in flight
+
+SpectrumOutput::~SpectrumOutput() {
+#if MPI_PARALLEL_ENABLED
+  if (reduce_req_ != MPI_REQUEST_NULL) {
+    MPI_Wait(&reduce_req_, MPI_STATUS_IGNORE);
+  }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SpectrumOutput::LoadOutputData()
+//  \brief Computes Fourier coefficients of each field summed over MeshBlocks on this
+//  rank, then starts a non-blocking sum over ranks to the master rank (as in PDFOutput).
+
+void SpectrumOutput::LoadOutputData(Mesh *pm) {
+  // complete the reduction of the previous output, before its buffers are reused
+#if MPI_PARALLEL_ENABLED
+  if (reduce_req_ != MPI_REQUEST_NULL) {
+    MPI_Wait(&reduce_req_, MPI_STATUS_IGNORE);
+  }
+#endif
+
+  auto &indcs = pm->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int nmb = pm->pmb_pack->nmb_thispack;
+  int nkx = kmax_[0] + 1, nky = 2*kmax_[1] + 1, nkz = 2*kmax_[2] + 1;
+
+  // number of MeshBlocks may change with load balancing
+  if (a1_re_.extent_int(0) != nmb) {
+    Kokkos::realloc(a1_re_, nmb, nx3, nx2, nkx);
+    Kokkos::realloc(a1_im_, nmb, nx3, nx2, nkx);
+    Kokkos::realloc(a2_re_, nmb, nx3, nky, nkx);
+    Kokkos::realloc(a2_im_, nmb, nx3, nky, nkx);
+  }
+
+  // existence of the physics module was checked in BaseTypeOutput constructor
+  DvceArray5D<Real> w0, bcc;
+  if (ncomp_ == 7) {
+    w0 = pm->pmb_pack->pmhd->w0;
+    bcc = pm->pmb_pack->pmhd->bcc0;
+  } else {
+    w0 = pm->pmb_pack->phydro->w0;
+  }
+
+  auto &size = pm->pmb_pack->pmb->mb_size;
+  Real x1min = pm->mesh_size.x1min, x2min = pm->mesh_size.x2min;
+  Real x3min = pm->mesh_size.x3min;
+  auto cx = cos_[0], sx = sin_[0];
+  auto cy = cos_[1], sy = sin_[1];
+  auto cz = cos_[2], sz = sin_[2];
+  auto a1re = a1_re_, a1im = a1_im_;
+  auto a2re = a2_re_, a2im = a2_im_;
+  auto fre = f_re_, fim = f_im_;
+  Real norm = 1.0/(static_cast<Real>(nx_[0])*nx_[1]*nx_[2]);
+
+  for (int n=0; n<ncomp_; ++n) {
+    auto f = (n < 4)? w0 : bcc;
+    int nv = (n == 0)? IDN : ((n < 4)? (IVX + n - 1) : (IBX + n - 4));
+
+    // transform in x1 of each row of cells
+    par_for("spec_x1", DevExeSpace(), 0, nmb-1, ks, ke, js, je, 0, nkx-1,
+    KOKKOS_LAMBDA(int m, int k, int j, int kx) {
+      int ox = static_cast<int>((size.d_view(m).x1min - x1min)/size.d_view(m).dx1 + 0.5);
+      Real re = 0.0, im = 0.0;
+      for (int i=is; i<=ie; ++i) {
+        int g = ox + i - is;
+        re += f(m,nv,k,j,i)*cx(kx,g);
+        im -= f(m,nv,k,j,i)*sx(kx,g);
+      }
+      a1re(m,k-ks,j-js,kx) = re;
+      a1im(m,k-ks,j-js,kx) = im;
+    });
+
+    // transform in x2
+    par_for("spec_x2", DevExeSpace(), 0, nmb-1, 0, nx3-1, 0, nky-1, 0, nkx-1,
+    KOKKOS_LAMBDA(int m, int k, int ky, int kx) {
+      int oy = static_cast<int>((size.d_view(m).x2min - x2min)/size.d_view(m).dx2 + 0.5);
+      Real re = 0.0, im = 0.0;
+      for (int j=0; j<nx2; ++j) {
+        Real c = cy(ky,oy+j), s = sy(ky,oy+j);
+        re += a1re(m,k,j,kx)*c + a1im(m,k,j,kx)*s;
+        im += a1im(m,k,j,kx)*c - a1re(m,k,j,kx)*s;
+      }
+      a2re(m,k,ky,kx) = re;
+      a2im(m,k,ky,kx) = im;
+    });
+
+    // transform in x3, summed over MeshBlocks
+    par_for("spec_x3", DevExeSpace(), 0, nkz-1, 0, nky-1, 0, nkx-1,
+    KOKKOS_LAMBDA(int kz, int ky, int kx) {
+      Real re = 0.0, im = 0.0;
+      for (int m=0; m<nmb; ++m) {
+        int oz = static_cast<int>((size.d_view(m).x3min - x3min)/size.d_view(m).dx3+0.5);
+        for (int k=0; k<nx3; ++k) {
+          Real c = cz(kz,oz+k), s = sz(kz,oz+k);
+          re += a2re(m,k,ky,kx)*c + a2im(m,k,ky,kx)*s;
+          im += a2im(m,k,ky,kx)*c - a2re(m,k,ky,kx)*s;
+        }
+      }
+      fre(n,kz,ky,kx) = norm*re;
+      fim(n,kz,ky,kx) = norm*im;
+    });
+  }
+
+  // copy to host, real parts followed by imaginary parts
+  auto fre_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), f_re_);
+  auto fim_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), f_im_);
+  send_buf_.assign(fre_h.data(), fre_h.data() + fre_h.size());
+  send_buf_.insert(send_buf_.end(), fim_h.data(), fim_h.data() + fim_h.size());
+
+  // Now (start to) reduce over ranks
+  recv_buf_.resize(send_buf_.size());
+#if MPI_PARALLEL_ENABLED
+  MPI_Ireduce(send_buf_.data(), recv_buf_.data(), send_buf_.size(), MPI_ATHENA_REAL,
+              MPI_SUM, 0, MPI_COMM_WORLD, &reduce_req_);
+#else
+  recv_buf_ = send_buf_;
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void SpectrumOutput::WriteOutputFile()
+//  \brief Bins power of reduced Fourier coefficients in shells of |k|, and writes one
+//  line per shell.  Only the master rank writes the file.
+
+void SpectrumOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  if (global_variable::my_rank == 0) {
+#if MPI_PARALLEL_ENABLED
+    MPI_Wait(&reduce_req_, MPI_STATUS_IGNORE);
+#endif
+    int nkx = kmax_[0] + 1, nky = 2*kmax_[1] + 1, nkz = 2*kmax_[2] + 1;
+    int nshell = out_params.spec_kmax + 1;
+    bool mhd = (ncomp_ == 7);
+    bool helm = out_params.helmholtz;
+    // columns: k, number of modes, dens, vel, [vel_sol, vel_comp], [bfield]
+    int ncol = 4 + (helm? 2 : 0) + (mhd? 1 : 0);
+    std::vector<Real> table(nshell*ncol, 0.0);
+    for (int n=0; n<nshell; ++n) {table[n*ncol] = static_cast<Real>(n);}
+
+    std::size_t nre = recv_buf_.size()/2;
+    auto idx = [&](int n, int kz, int ky, int kx) -> std::size_t {
+      return ((static_cast<std::size_t>(n)*nkz + kz)*nky + ky)*nkx + kx;
+    };
+    for (int kz=0; kz<nkz; ++kz) {
+      for (int ky=0; ky<nky; ++ky) {
+        for (int kx=0; kx<nkx; ++kx) {
+          // physical wavenumber, in units of 2pi
+          Real kv[3] = {kx/len_[0], (ky - kmax_[1])/len_[1], (kz - kmax_[2])/len_[2]};
+          Real k2 = kv[0]*kv[0] + kv[1]*kv[1] + kv[2]*kv[2];
+          int shell = static_cast<int>(std::sqrt(k2)*len_[0] + 0.5);
+          if (shell >= nshell) {continue;}
+          // modes with kx>0 also represent their complex conjugate at -kx
+          Real w = (kx == 0 || 2*kx == nx_[0])? 1.0 : 2.0;
+          Real pow[7];
+          for (int n=0; n<ncomp_; ++n) {
+            Real re = recv_buf_[idx(n,kz,ky,kx)];
+            Real im = recv_buf_[nre + idx(n,kz,ky,kx)];
+            pow[n] = w*(re*re + im*im);
+          }
+          Real *row = &table[shell*ncol];
+          row[1] += w;
+          row[2] += pow[0];
+          row[3] += pow[1] + pow[2] + pow[3];
+          int col = 4;
+          if (helm) {
+            Real comp = 0.0;
+            if (k2 > 0.0) {
+              Real kdv_re = 0.0, kdv_im = 0.0;
+              for (int d=0; d<3; ++d) {
+                kdv_re += kv[d]*recv_buf_[idx(d+1,kz,ky,kx)];
+                kdv_im += kv[d]*recv_buf_[nre + idx(d+1,kz,ky,kx)];
+              }
+              comp = w*(kdv_re*kdv_re + kdv_im*kdv_im)/k2;
+            }
+            row[col++] += pow[1] + pow[2] + pow[3] - comp;
+            row[col++] += comp;
+          }
+          if (mhd) {row[col++] += pow[4] + pow[5] + pow[6];}
+        }
+      }
+    }
+
+    // create filename: "spec/file_basename" + "." + "file_id" + "." + XXXXX + ".spec"
+    // where XXXXX = 5-digit file_number
+    std::string fname;
+    char number[6];
+    std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+    fname.assign("spec/");
+    fname.append(out_params.file_basename);
+    fname.append(".");
+    fname.append(out_params.file_id);
+    fname.append(".");
+    fname.append(number);
+    fname.append(".spec");
+
+    FILE *pfile;
+    if ((pfile = std::fopen(fname.c_str(),"w")) == nullptr) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" <<std::endl;
+      exit(EXIT_FAILURE);
+    }
+    std::fprintf(pfile, "# Athena power spectra at time=%e  cycle=%d\n", pm->time,
+                 pm->ncycle);
+    std::fprintf(pfile, "# [1]=k  [2]=nmodes  [3]=dens  [4]=vel");
+    int col = 5;
+    if (helm) {
+      std::fprintf(pfile, "  [%d]=vel_sol  [%d]=vel_comp", col, col+1);
+      col += 2;
+    }
+    if (mhd) {std::fprintf(pfile, "  [%d]=bfield", col);}
+    std::fprintf(pfile, "\n");
+    if (out_params.spec_binary) {
+      std::fprintf(pfile, "# binary nrow=%d ncol=%d real_size=%d\n", nshell, ncol,
+                   static_cast<int>(sizeof(Real)));
+      std::fwrite(table.data(), sizeof(Real), table.size(), pfile);
+    } else {
+      for (int n=0; n<nshell; ++n) {
+        for (int c=0; c<ncol; ++c) {
+          std::fprintf(pfile, out_params.data_format.c_str(), table[n*ncol + c]);
+        }
+        std::fprintf(pfile, "\n");
+      }
+    }
+    std::fclose(pfile);
+  }
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = pm->time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+  return;
+}
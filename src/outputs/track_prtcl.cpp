@@ -10,8 +10,10 @@
 #include <vector>
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdio>      // fwrite(), fclose(), fopen(), fnprintf(), snprintf()
 #include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -43,16 +45,19 @@ TrackedParticleOutput::TrackedParticleOutput(ParameterInput *pin, Mesh *pm,
 // Copies data for tracked particles on this rank to host outpart array
 
 void TrackedParticleOutput::LoadOutputData(Mesh *pm) {
+  out_time = pm->time;
+  out_cycle = pm->ncycle;
   // Load data for tracked particles on this rank into new device array
   DualArray1D<TrackedParticleData> tracked_prtcl("d_trked",ntrack_thisrank);
   int npart = pm->nprtcl_thisrank;
   auto &pr = pm->pmb_pack->ppart->prtcl_rdata;
   auto &pi = pm->pmb_pack->ppart->prtcl_idata;
-  int counter=0;
-  int *pcounter = &counter;
+  // counter must be in device memory, since it is incremented inside kernel
+  DvceArray1D<int> counter("trk_counter",1);
+  int ntrk = ntrack;
   par_for("part_update",DevExeSpace(),0,(npart-1), KOKKOS_LAMBDA(const int p) {
-    if (pi(PTAG,p) < ntrack) {
-      int index = Kokkos::atomic_fetch_add(pcounter,1);
+    if (pi(PTAG,p) < ntrk) {
+      int index = Kokkos::atomic_fetch_add(&counter(0),1);
       tracked_prtcl.d_view(index).tag = pi(PTAG,p);
       tracked_prtcl.d_view(index).x   = pr(IPX,p);
       tracked_prtcl.d_view(index).y   = pr(IPY,p);
@@ -62,7 +67,8 @@ void TrackedParticleOutput::LoadOutputData(Mesh *pm) {
       tracked_prtcl.d_view(index).vz  = pr(IPVZ,p);
     }
   });
-  npout = counter;
+  auto h_counter = Kokkos::create_mirror_view_and_copy(HostMemSpace(), counter);
+  npout = h_counter(0);
   // share number of tracked particles to be output across all ranks
   npout_eachrank[global_variable::my_rank] = npout;
 #if MPI_PARALLEL_ENABLED
@@ -73,32 +79,65 @@ void TrackedParticleOutput::LoadOutputData(Mesh *pm) {
   tracked_prtcl.template modify<DevExeSpace>();
   tracked_prtcl.template sync<HostMemSpace>();
 
-  // copy host view into host outpart array
+  // copy host view into host outpart array, sorted by tag so that records of each rank
+  // can be searched by tag
   Kokkos::realloc(outpart, npout);
   Kokkos::deep_copy(outpart, tracked_prtcl.h_view);
+  std::sort(outpart.data(), outpart.data() + npout,
+            [](const TrackedParticleData &a, const TrackedParticleData &b) {
+              return a.tag < b.tag;
+            });
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn BaseTypeOutput* TrackedParticleOutput::Clone()
+//! \brief Returns copy of this output to be written asynchronously.  The records are
+//! copied, since outpart may be reused by the next LoadOutputData().
+
+BaseTypeOutput* TrackedParticleOutput::Clone() {
+  TrackedParticleOutput *pcopy = new TrackedParticleOutput(*this);
+  pcopy->outpart = HostArray1D<TrackedParticleData>("outpart", npout);
+  Kokkos::deep_copy(pcopy->outpart, outpart);
+  return pcopy;
 }
 
 //----------------------------------------------------------------------------------------
 //! \fn void TrackedParticleOutput:::WriteOutputFile(Mesh *pm)
-//! \brief Cycles over all tracked particles on this rank and writes ouput data
-//! With MPI, all particles are written to the same file.
+//! \brief Writes data for all tracked particles.  Each output appends a text header
+//! followed by one record per particle of [int32 tag][6 x float32 x,y,z,vx,vy,vz], so
+//! that all outputs are stored in one persistent file.  Each rank writes its records
+//! (sorted by tag) as one contiguous block in order of rank, at an offset computed with
+//! a prefix sum over the number of particles on each rank, in one collective write.
 
 void TrackedParticleOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
-  int big_end = IsBigEndian(); // =1 on big endian machine
-
   // create filename: "trk/file_basename".trk
   std::string fname;
   fname.assign("trk/");
   fname.append(out_params.file_basename);
   fname.append(".trk");
 
+  // offset of this rank's block, in number of particles, and total written
+  std::size_t record_size = sizeof(int32_t) + 6*sizeof(float);
+  int64_t np_offset = 0;
+  int64_t np_total = 0;
+  for (int n=0; n<global_variable::nranks; ++n) {
+    np_total += npout_eachrank[n];
+  }
+#if MPI_PARALLEL_ENABLED
+  int64_t np_this = npout;
+  MPI_Exscan(&np_this, &np_offset, 1, MPI_INT64_T, MPI_SUM, io_comm);
+  if (global_variable::my_rank == 0) {np_offset = 0;}
+#endif
+
   // Root process opens/creates file and appends string
   if (global_variable::my_rank == 0) {
     std::stringstream msg;
-    msg << std::endl << "# AthenaK tracked particle data at time= " << pm->time
+    msg << std::endl << "# AthenaK tracked particle data at time= " << out_time
         << "  nranks= " << global_variable::nranks
-        << "  cycle=" << pm->ncycle
-        << "  ntracked_prtcls=" << ntrack << std::endl;
+        << "  cycle=" << out_cycle
+        << "  ntracked_prtcls=" << ntrack
+        << "  nrecords=" << np_total
+        << "  record=int32_tag,float32_x_y_z_vx_vy_vz" << std::endl;
     FILE *pfile;
     if ((pfile = std::fopen(fname.c_str(),"a")) == nullptr) {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
@@ -111,52 +150,34 @@ void TrackedParticleOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
 
   // Now all ranks open file and append data
   IOWrapper partfile;
+#if MPI_PARALLEL_ENABLED
+  partfile.SetCommunicator(io_comm);
+#endif
   partfile.Open(fname.c_str(), IOWrapper::FileMode::append);
   std::size_t header_offset = partfile.GetPosition();
-//  std::size_t header_offset = 0;
 
-  // allocate 1D vector of floats used to convert and output particle data
-  float *data = new float[6*npout];
-  // Loop over particles, load positions into data[]
+  // pack records of all particles on this rank into contiguous buffer
+  std::size_t nbytes = npout*record_size;
+  char *data = new char[std::max(nbytes, record_size)];
+  char *pdata = data;
   for (int p=0; p<npout; ++p) {
-    data[ 6*p   ] = static_cast<float>(outpart(p).x);
-    data[(6*p)+1] = static_cast<float>(outpart(p).y);
-    data[(6*p)+2] = static_cast<float>(outpart(p).z);
-    data[(6*p)+3] = static_cast<float>(outpart(p).vx);
-    data[(6*p)+4] = static_cast<float>(outpart(p).vy);
-    data[(6*p)+5] = static_cast<float>(outpart(p).vz);
-  }
-  // calculate local data offset
-  std::vector<int> rank_offset(global_variable::nranks, 0);
-  int npout_min = pm->nprtcl_eachrank[0];
-  for (int n=1; n<global_variable::nranks; ++n) {
-    rank_offset[n] = rank_offset[n-1] + npout_eachrank[n-1];
-    npout_min = std::min(npout_min, npout_eachrank[n]);
+    int32_t tag = outpart(p).tag;
+    float rec[6] = {static_cast<float>(outpart(p).x), static_cast<float>(outpart(p).y),
+                    static_cast<float>(outpart(p).z), static_cast<float>(outpart(p).vx),
+                    static_cast<float>(outpart(p).vy), static_cast<float>(outpart(p).vz)};
+    std::memcpy(pdata, &tag, sizeof(tag));
+    pdata += sizeof(tag);
+    std::memcpy(pdata, rec, sizeof(rec));
+    pdata += sizeof(rec);
   }
 
-  // Write tracked particle data collectively over minimum shared number of prtcls
-  for (int p=0; p<npout_min; ++p) {
-    // offset computed assuming tags run 0...(ntrack-1) sequentially
-    std::size_t myoffset = header_offset + 6*outpart(p).tag;
-    // Write particle positions collectively for minimum number of particles across ranks
-    if (partfile.Write_any_type_at_all(&(data[0]),6,myoffset,"float") != 6) {
-      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "particle data not written correctly to tracked particle file"
-          << std::endl;
-      exit(EXIT_FAILURE);
-    }
-  }
-  // Write particle positions individually for remaining particles on each rank
-  for (int p=npout_min; p<npout; ++p) {
-    // offset computed assuming tags run 0...(ntrack-1) sequentially
-    std::size_t myoffset = header_offset + 6*outpart(p).tag;
-    // Write particle positions collectively for minimum number of particles across ranks
-    if (partfile.Write_any_type_at(&(data[0]),6,myoffset,"float") != 6) {
-      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-          << std::endl << "particle data not written correctly to tracked particle file"
-          << std::endl;
-      exit(EXIT_FAILURE);
-    }
+  // Write all particles on this rank collectively in one block
+  std::size_t myoffset = header_offset + np_offset*record_size;
+  if (partfile.Write_any_type_at_all(data, nbytes, myoffset, "byte") != nbytes) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "particle data not written correctly to tracked particle file"
+        << std::endl;
+    exit(EXIT_FAILURE);
   }
 
   // close the output file and clean up
@@ -165,7 +186,7 @@ void TrackedParticleOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
 
   // increment counters
   if (out_params.last_time < 0.0) {
-    out_params.last_time = pm->time;
+    out_params.last_time = out_time;
   } else {
     out_params.last_time += out_params.dt;
   }
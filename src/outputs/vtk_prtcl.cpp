@@ -18,6 +18,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
 
 #include "athena.hpp"
 #include "coordinates/cell_locations.hpp"
@@ -42,6 +43,7 @@ ParticleVTKOutput::ParticleVTKOutput(ParameterInput *pin, Mesh *pm, OutputParame
 
 void ParticleVTKOutput::LoadOutputData(Mesh *pm) {
   particles::Particles *pp = pm->pmb_pack->ppart;
+  pm->GatherParticleCounts();
   npout_thisrank = pm->nprtcl_thisrank;
   npout_total = pm->nprtcl_total;
   Kokkos::realloc(outpart_rdata, pp->nrdata, npout_thisrank);
@@ -52,9 +54,13 @@ void ParticleVTKOutput::LoadOutputData(Mesh *pm) {
                                                     outpart_rdata);
   auto d_outpart_idata = Kokkos::create_mirror_view(Kokkos::DefaultHostExecutionSpace(),
                                                     outpart_idata);
-  // Copy particle positions into device mirrors
-  Kokkos::deep_copy(d_outpart_rdata, pp->prtcl_rdata);
-  Kokkos::deep_copy(d_outpart_idata, pp->prtcl_idata);
+  // Copy particle positions into device mirrors.  Particle arrays may have capacity
+  // larger than the number of particles, so only copy those in use.
+  std::pair<int,int> prange = std::make_pair(0, npout_thisrank);
+  Kokkos::deep_copy(d_outpart_rdata,
+                    Kokkos::subview(pp->prtcl_rdata, Kokkos::ALL, prange));
+  Kokkos::deep_copy(d_outpart_idata,
+                    Kokkos::subview(pp->prtcl_idata, Kokkos::ALL, prange));
   // Copy particle positions from device mirror to host output array
   Kokkos::deep_copy(outpart_rdata, d_outpart_rdata);
   Kokkos::deep_copy(outpart_idata, d_outpart_idata);
@@ -0,0 +1,263 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file vtkhdf.cpp
+//! \brief writes output data in the VTKHDF "OverlappingAMR" format, which can be opened
+//! directly (and read in parallel) by ParaView/VTK >= 9.3.  Unlike legacy vtk outputs,
+//! all MeshBlocks and variables are written to one file with the refinement hierarchy
+//! preserved, in native byte order, collectively over all ranks using parallel HDF5.
+//!
+//! The file contains one group /VTKHDF/LevelN for each level N of the Mesh (relative to
+//! the root grid), holding the "AMRBox" (imin,imax,jmin,jmax,kmin,kmax) of every
+//! MeshBlock in cell indices of that level, and one dataset in "CellData" for each
+//! variable storing the cells of all MeshBlocks of that level in the order of AMRBox
+//! (x1 index fastest), in single precision.
+
+#include <sys/stat.h>  // mkdir
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs.hpp"
+
+#if HDF5_OUTPUT_ENABLED
+
+#include <hdf5.h>
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void WriteVTKAttribute()
+//! \brief writes a 1D array attribute of n elements of given type to group
+
+void WriteVTKAttribute(hid_t group, const char *name, hid_t type, int n,
+                       const void *data) {
+  hsize_t dims = n;
+  hid_t space = H5Screate_simple(1, &dims, nullptr);
+  hid_t attr = H5Acreate2(group, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(attr, type, data);
+  H5Aclose(attr);
+  H5Sclose(space);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteVTKStringAttribute()
+//! \brief writes a scalar fixed length ASCII string attribute to group
+
+void WriteVTKStringAttribute(hid_t group, const char *name, const std::string &str) {
+  hid_t type = H5Tcopy(H5T_C_S1);
+  H5Tset_size(type, str.size());
+  H5Tset_strpad(type, H5T_STR_NULLPAD);
+  hid_t space = H5Screate(H5S_SCALAR);
+  hid_t attr = H5Acreate2(group, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  H5Awrite(attr, type, str.c_str());
+  H5Aclose(attr);
+  H5Sclose(space);
+  H5Tclose(type);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteBlockDataset()
+//! \brief creates dataset of ntotal rows (of ncol elements each if ncol > 0, or a 1D
+//! dataset if ncol = 0), and writes nlocal rows of this rank starting at row offset.
+//! Every rank must call this function, even if it has no data.
+
+void WriteBlockDataset(hid_t group, hid_t dxpl, const char *name, hid_t ftype,
+                       hid_t mtype, hsize_t ntotal, hsize_t nlocal, hsize_t offset,
+                       hsize_t ncol, const void *data) {
+  int ndim = (ncol > 0)? 2 : 1;
+  hsize_t gdims[2] = {ntotal, ncol};
+  hsize_t ldims[2] = {nlocal, ncol};
+  hsize_t start[2] = {offset, 0};
+  hid_t fspace = H5Screate_simple(ndim, gdims, nullptr);
+  hid_t dset = H5Dcreate2(group, name, ftype, fspace, H5P_DEFAULT, H5P_DEFAULT,
+                          H5P_DEFAULT);
+  hid_t mspace = H5Screate_simple(ndim, ldims, nullptr);
+  if (nlocal > 0) {
+    H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, nullptr, ldims, nullptr);
+  } else {
+    H5Sselect_none(fspace);
+    H5Sselect_none(mspace);
+  }
+  H5Dwrite(dset, mtype, mspace, fspace, dxpl, data);
+  H5Sclose(mspace);
+  H5Dclose(dset);
+  H5Sclose(fspace);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+// Constructor: also calls BaseTypeOutput base class constructor
+
+MeshVTKHDFOutput::MeshVTKHDFOutput(ParameterInput *pin, Mesh *pm, OutputParameters op) :
+  BaseTypeOutput(pin, pm, op) {
+  // AMR boxes must cover whole MeshBlocks
+  if (out_params.include_gzs || out_params.slice1 || out_params.slice2 ||
+      out_params.slice3 || out_params.gid >= 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "vtkhdf output block '" << op.block_name << "' cannot include "
+        << "ghost zones, slices, or a single MeshBlock" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  mkdir("vtkhdf",0775);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void MeshVTKHDFOutput:::WriteOutputFile(Mesh *pm)
+//! \brief Writes all output MeshBlocks to one VTKHDF file, grouped by level.
+
+void MeshVTKHDFOutput::WriteOutputFile(Mesh *pm, ParameterInput *pin) {
+  // create filename: "vtkhdf/file_basename" + "." + "file_id" + "." + XXXXX + ".vtkhdf"
+  // where XXXXX = 5-digit file_number
+  std::string fname;
+  char number[6];
+  std::snprintf(number, sizeof(number), "%05d", out_params.file_number);
+
+  fname.assign("vtkhdf/");
+  fname.append(out_params.file_basename);
+  fname.append(".");
+  fname.append(out_params.file_id);
+  fname.append(".");
+  fname.append(number);
+  fname.append(".vtkhdf");
+
+  auto &indcs = pm->mb_indcs;
+  int nout_vars = outvars.size();
+  int nout_mbs = outmbs.size();
+  int cells = indcs.nx1*indcs.nx2*indcs.nx3;
+
+  // number of output MBs on each level on this rank, offset of MBs of this rank in
+  // each level, and total number of MBs on each level
+  int nlevels = pm->max_level - pm->root_level + 1;
+  std::vector<int> nmb_level(nlevels, 0), off_level(nlevels, 0);
+  for (int m=0; m<nout_mbs; ++m) {
+    nmb_level[pm->lloc_eachmb[outmbs[m].mb_gid].level - pm->root_level]++;
+  }
+  std::vector<int> ntot_level(nmb_level);
+#if MPI_PARALLEL_ENABLED
+  MPI_Exscan(nmb_level.data(), off_level.data(), nlevels, MPI_INT, MPI_SUM, io_comm);
+  if (global_variable::my_rank == io_root) {
+    for (auto &off : off_level) {off = 0;}
+  }
+  MPI_Allreduce(MPI_IN_PLACE, ntot_level.data(), nlevels, MPI_INT, MPI_SUM, io_comm);
+#endif
+
+  // open file, using MPI-IO over io_comm with parallel HDF5
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+#if MPI_PARALLEL_ENABLED
+  MPI_Info info = IOWrapper::CreateFileInfo(io_comm);
+  H5Pset_fapl_mpio(fapl, io_comm, info);
+  if (info != MPI_INFO_NULL) {MPI_Info_free(&info);}
+  H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+#endif
+  hid_t file = H5Fcreate(fname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  if (file < 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Output file '" << fname << "' could not be opened" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Attributes of root group.  Identical on all ranks, and written collectively.
+  hid_t root = H5Gcreate2(file, "VTKHDF", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  int version[2] = {2, 0};
+  WriteVTKAttribute(root, "Version", H5T_NATIVE_INT, 2, version);
+  WriteVTKStringAttribute(root, "Type", "OverlappingAMR");
+  WriteVTKStringAttribute(root, "GridDescription",
+                          (pm->three_d)? "XYZ" : ((pm->two_d)? "XY" : "X"));
+  double origin[3] = {pm->mesh_size.x1min, pm->mesh_size.x2min, pm->mesh_size.x3min};
+  WriteVTKAttribute(root, "Origin", H5T_NATIVE_DOUBLE, 3, origin);
+  double time = out_time;
+  WriteVTKAttribute(root, "Time", H5T_NATIVE_DOUBLE, 1, &time);
+  WriteVTKAttribute(root, "NumCycles", H5T_NATIVE_INT, 1, &out_cycle);
+
+  // root grid spacing
+  double dx[3] = {
+    (pm->mesh_size.x1max - pm->mesh_size.x1min)/static_cast<double>(pm->mesh_indcs.nx1),
+    (pm->mesh_size.x2max - pm->mesh_size.x2min)/static_cast<double>(pm->mesh_indcs.nx2),
+    (pm->mesh_size.x3max - pm->mesh_size.x3min)/static_cast<double>(pm->mesh_indcs.nx3)};
+
+  std::vector<int> boxes;
+  std::vector<float> single_data;
+  for (int l=0; l<nlevels; ++l) {
+    char gname[16];
+    std::snprintf(gname, sizeof(gname), "Level%d", l);
+    hid_t level = H5Gcreate2(root, gname, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    double spacing[3];
+    for (int d=0; d<3; ++d) {
+      spacing[d] = dx[d]/static_cast<double>(1 << l);
+    }
+    WriteVTKAttribute(level, "Spacing", H5T_NATIVE_DOUBLE, 3, spacing);
+
+    // AMR boxes of MBs on this level, in cell indices of this level
+    boxes.resize(6*nmb_level[l]);
+    int nb = 0;
+    for (int m=0; m<nout_mbs; ++m) {
+      LogicalLocation loc = pm->lloc_eachmb[outmbs[m].mb_gid];
+      if (loc.level - pm->root_level != l) {continue;}
+      int *box = &(boxes[6*nb++]);
+      box[0] = static_cast<int>(loc.lx1)*indcs.nx1;  box[1] = box[0] + indcs.nx1 - 1;
+      box[2] = static_cast<int>(loc.lx2)*indcs.nx2;  box[3] = box[2] + indcs.nx2 - 1;
+      box[4] = static_cast<int>(loc.lx3)*indcs.nx3;  box[5] = box[4] + indcs.nx3 - 1;
+    }
+    WriteBlockDataset(level, dxpl, "AMRBox", H5T_NATIVE_INT, H5T_NATIVE_INT,
+                      ntot_level[l], nmb_level[l], off_level[l], 6, boxes.data());
+
+    // variables of MBs on this level, in native single precision
+    hid_t celldata = H5Gcreate2(level, "CellData", H5P_DEFAULT, H5P_DEFAULT,
+                                H5P_DEFAULT);
+    single_data.resize(static_cast<std::size_t>(nmb_level[l])*cells);
+    for (int n=0; n<nout_vars; ++n) {
+      std::size_t cnt = 0;
+      for (int m=0; m<nout_mbs; ++m) {
+        if (pm->lloc_eachmb[outmbs[m].mb_gid].level - pm->root_level != l) {continue;}
+        for (int k=0; k<indcs.nx3; ++k) {
+          for (int j=0; j<indcs.nx2; ++j) {
+            for (int i=0; i<indcs.nx1; ++i) {
+              single_data[cnt++] = static_cast<float>(outarray(n,m,k,j,i));
+            }
+          }
+        }
+      }
+      WriteBlockDataset(celldata, dxpl, outvars[n].label.c_str(), H5T_NATIVE_FLOAT,
+                        H5T_NATIVE_FLOAT, static_cast<hsize_t>(ntot_level[l])*cells,
+                        static_cast<hsize_t>(nmb_level[l])*cells,
+                        static_cast<hsize_t>(off_level[l])*cells, 0,
+                        single_data.data());
+    }
+    H5Gclose(celldata);
+    hid_t pointdata = H5Gcreate2(level, "PointData", H5P_DEFAULT, H5P_DEFAULT,
+                                 H5P_DEFAULT);
+    H5Gclose(pointdata);
+    H5Gclose(level);
+  }
+
+  // close the output file
+  H5Gclose(root);
+  H5Fclose(file);
+  H5Pclose(dxpl);
+  H5Pclose(fapl);
+
+  // increment counters
+  out_params.file_number++;
+  if (out_params.last_time < 0.0) {
+    out_params.last_time = out_time;
+  } else {
+    out_params.last_time += out_params.dt;
+  }
+  pin->SetInteger(out_params.block_name, "file_number", out_params.file_number);
+  pin->SetReal(out_params.block_name, "last_time", out_params.last_time);
+
+  return;
+}
+
+#endif // HDF5_OUTPUT_ENABLED
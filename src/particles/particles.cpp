@@ -58,6 +58,10 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     std::string ppush = pin->GetString("particles","pusher");
     if (ppush.compare("drift") == 0) {
       pusher = ParticlesPusher::drift;
+    } else if (ppush.compare("boris") == 0) {
+      pusher = ParticlesPusher::boris;
+    } else if (ppush.compare("lagrangian_mc") == 0) {
+      pusher = ParticlesPusher::lagrangian_mc;
     } else {
       std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
                 << std::endl << "Particle pusher must be specified in <particles> block"
@@ -66,6 +70,22 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     }
   }
 
+  // parameters of boris pusher
+  q_over_m = pin->GetOrAddReal("particles","q_over_m",1.0);
+  {
+    std::string interp = pin->GetOrAddString("particles","interpolation","tsc");
+    if (interp.compare("tsc") == 0) {
+      tsc_interp = true;
+    } else if (interp.compare("cic") == 0) {
+      tsc_interp = false;
+    } else {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Particle interpolation = '" << interp << "' must be "
+                << "one of [tsc, cic]" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
   // set dimensions of particle arrays. Note particles only work in 2D/3D
   if (pmy_pack->pmesh->one_d) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
@@ -76,7 +96,8 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
     case ParticleType::cosmic_ray:
       {
         int ndim=4;
-        if (pmy_pack->pmesh->three_d) {ndim+=2;}
+        // boris pusher evolves all three components of velocity
+        if (pmy_pack->pmesh->three_d || pusher == ParticlesPusher::boris) {ndim+=2;}
         nrdata = ndim;
         nidata = 2;
         break;
@@ -87,14 +108,49 @@ Particles::Particles(MeshBlockPack *ppack, ParameterInput *pin) :
   Kokkos::realloc(prtcl_rdata, nrdata, nprtcl_thispack);
   Kokkos::realloc(prtcl_idata, nidata, nprtcl_thispack);
 
+  // cadence of sorting particles by cell
+  sort_interval = pin->GetOrAddInteger("particles","sort_interval",0);
+  sorted = false;
+
   // allocate boundary object
   pbval_part = new ParticlesBoundaryValues(this, pin);
+
+  // allocate moments deposited on mesh, and boundary object to sum them across
+  // MeshBlocks, if requested
+  deposit_moments = pin->GetOrAddBoolean("particles","deposit_moments",false);
+  if (deposit_moments) {
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    // sized like evolved variables, since MeshBlocks on this rank can change
+    int nmb = std::max((pmy_pack->nmb_thispack), (pmy_pack->pmesh->nmb_maxperrank));
+    Kokkos::realloc(moments, nmb, NPRTCL_MOMENTS, ncells3, ncells2, ncells1);
+    pbval_mom = new MeshBoundaryValuesCC(pmy_pack, pin, false);
+    pbval_mom->sum_mode = true;
+    pbval_mom->InitializeBuffers(NPRTCL_MOMENTS);
+  }
 }
 
 //----------------------------------------------------------------------------------------
 // destructor
 
 Particles::~Particles() {
+  if (pbval_mom != nullptr) {delete pbval_mom;}
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Particles::ReserveCapacity()
+//! \brief Ensures particle arrays can store at least npart particles.  Arrays grow by at
+//! least a factor of 1.5, and existing data are preserved, so that the arrays are only
+//! reallocated a logarithmic number of times as particles arrive.
+
+void Particles::ReserveCapacity(int npart) {
+  int capacity = prtcl_rdata.extent_int(1);
+  if (npart <= capacity) {return;}
+  int new_capacity = std::max(npart, capacity + capacity/2);
+  Kokkos::resize(prtcl_rdata, nrdata, new_capacity);
+  Kokkos::resize(prtcl_idata, nidata, new_capacity);
+  return;
 }
 
 //----------------------------------------------------------------------------------------
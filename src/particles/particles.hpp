@@ -20,11 +20,14 @@
 // forward declarations
 
 // constants that enumerate ParticlesPusher options
-enum class ParticlesPusher {drift, leap_frog, lagrangian_tracer, lagrangian_mc};
+enum class ParticlesPusher {drift, leap_frog, lagrangian_tracer, lagrangian_mc, boris};
 
 // constants that enumerate ParticleTypes
 enum class ParticleType {cosmic_ray};
 
+// number of moments of particles deposited on the mesh: n, n*v_i, n*v_i*v_j
+#define NPRTCL_MOMENTS 10
+
 //----------------------------------------------------------------------------------------
 //! \struct ParticlesTaskIDs
 //  \brief container to hold TaskIDs of all particles tasks
@@ -38,6 +41,13 @@ struct ParticlesTaskIDs {
   TaskID recvp;
   TaskID csend;
   TaskID crecv;
+  TaskID sort;
+  TaskID mirecv;
+  TaskID deposit;
+  TaskID msend;
+  TaskID mrecv;
+  TaskID mcsend;
+  TaskID mcrecv;
 };
 
 namespace particles {
@@ -54,6 +64,8 @@ class Particles {
   // data
   ParticleType particle_type;
   int nprtcl_thispack;             // number of particles this MeshBlockPack
+  // Particle arrays are allocated with capacity >= nprtcl_thispack, and particles are
+  // stored contiguously in [0,nprtcl_thispack).  Capacity only grows, geometrically.
   int nrdata, nidata;
 //  DvceArray1D<int>  prtcl_gid;     // GID of MeshBlock containing each par
 //  DvceArray2D<Real> prtcl_pos;     // positions
@@ -62,18 +74,37 @@ class Particles {
   DvceArray2D<int>  prtcl_idata;   // integer properties each particle (gid, tag, etc.)
   Real dtnew;
 
+  // sorting of particles by MeshBlock and cell
+  int sort_interval;               // cycles between sorts (<= 0 disables sorting)
+  bool sorted;                     // true if particles sorted since last push
+  DvceArray1D<int> cell_offset;    // index of first particle in each cell when sorted
+  DvceArray1D<int> prtcl_key;      // cell index of each particle used in sort
+
   ParticlesPusher pusher;
+  Real q_over_m;                   // charge-to-mass ratio used by boris pusher
+  bool tsc_interp;                 // TSC (true) or CIC (false) interpolation of fields
 
   // Boundary communication buffers and functions for particles
   ParticlesBoundaryValues *pbval_part;
 
+  // moments of particles deposited on the mesh (including ghost zones), and boundary
+  // values object (in sum mode) used to add deposits in ghost zones to neighbors
+  bool deposit_moments;
+  DvceArray5D<Real> moments;
+  MeshBoundaryValuesCC *pbval_mom = nullptr;
+
   // container to hold names of TaskIDs
   ParticlesTaskIDs id;
 
   // functions...
   void CreateParticleTags(ParameterInput *pin);
+  void ReserveCapacity(int npart);
+  void Migrate();
   void AssembleTasks(std::map<std::string, std::shared_ptr<TaskList>> tl);
   TaskStatus Push(Driver *pdriver, int stage);
+  void BorisPush();
+  void MonteCarloTracers(const DvceFaceFld5D<Real> &flx, const DvceArray5D<Real> &u0,
+                         const Real dt);
   TaskStatus NewGID(Driver *pdriver, int stage);
   TaskStatus SendCnt(Driver *pdriver, int stage);
   TaskStatus InitRecv(Driver *pdriver, int stage);
@@ -81,6 +112,14 @@ class Particles {
   TaskStatus RecvP(Driver *pdriver, int stage);
   TaskStatus ClearSend(Driver *pdriver, int stage);
   TaskStatus ClearRecv(Driver *pdriver, int stage);
+  TaskStatus Sort(Driver *pdriver, int stage);
+  TaskStatus InitMomentRecv(Driver *pdriver, int stage);
+  TaskStatus DepositMoments(Driver *pdriver, int stage);
+  TaskStatus SendMoments(Driver *pdriver, int stage);
+  TaskStatus RecvMoments(Driver *pdriver, int stage);
+  TaskStatus ClearMomentSend(Driver *pdriver, int stage);
+  TaskStatus ClearMomentRecv(Driver *pdriver, int stage);
+  void SortParticles();
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Particles
@@ -0,0 +1,246 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file particles_deposit.cpp
+//! \brief functions to deposit moments of the particle distribution onto the mesh:
+//! number density n, flux n*v (3 components), and n*v_i*v_j (6 components xx, xy, xz,
+//! yy, yz, zz), using the same CIC/TSC weights as the interpolation in the pushers.
+//! Enabled with deposit_moments=true in the <particles> block, and computed once per
+//! cycle after particles have moved (and are sorted), since particles are only pushed in
+//! the "before_timeintegrator" task list.
+//!
+//! Deposits that fall into ghost zones are added to the active cells of neighboring
+//! MeshBlocks using a MeshBoundaryValuesCC in sum mode, so moments are conservative.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "particles.hpp"
+
+namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn void DepositWeights()
+//! \brief Weights of cells (i-1,i,i+1) for particle at offset d in [-0.5,0.5] from center
+//! of cell i, in units of the cell size.  Same as InterpWeights() in the pushers.
+
+KOKKOS_INLINE_FUNCTION
+void DepositWeights(const Real d, const bool tsc, Real w[3]) {
+  if (tsc) {
+    w[0] = 0.5*(0.5 - d)*(0.5 - d);
+    w[1] = 0.75 - d*d;
+    w[2] = 0.5*(0.5 + d)*(0.5 + d);
+  } else {
+    w[0] = fmax(-d, 0.0);
+    w[1] = 1.0 - fabs(d);
+    w[2] = fmax(d, 0.0);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int DepositCell()
+//! \brief Returns index (measured from first active cell) of cell containing position
+//! x, and offset d of x from center of that cell in units of the cell size.
+
+KOKKOS_INLINE_FUNCTION
+int DepositCell(const Real x, const Real xmin, const Real dx, const int nx, Real &d) {
+  int i = static_cast<int>((x - xmin)/dx);
+  i = (i < 0)? 0 : ((i >= nx)? nx-1 : i);
+  d = (x - (xmin + (i + 0.5)*dx))/dx;
+  return i;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void DepositValues()
+//! \brief Computes the moments carried by one particle with velocity v.
+
+KOKKOS_INLINE_FUNCTION
+void DepositValues(const Real v[3], Real q[NPRTCL_MOMENTS]) {
+  q[0] = 1.0;
+  q[1] = v[0];
+  q[2] = v[1];
+  q[3] = v[2];
+  q[4] = v[0]*v[0];
+  q[5] = v[0]*v[1];
+  q[6] = v[0]*v[2];
+  q[7] = v[1]*v[1];
+  q[8] = v[1]*v[2];
+  q[9] = v[2]*v[2];
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Particles::DepositMoments
+//! \brief Deposits moments of particles into the moments array (including ghost zones).
+//! When particles are sorted by cell, one team per (m,k,j) row of cells accumulates the
+//! deposits of particles in that row into a private buffer in scratch memory covering
+//! rows j-1..j+1 and k-1..k+1, which is then added to the global array once.  Otherwise
+//! each particle adds its deposit to the global array with atomics.
+
+TaskStatus Particles::DepositMoments(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int ncells1 = nx1 + 2*(indcs.ng);
+  bool three_d = pmy_pack->pmesh->three_d;
+  int nmb = pmy_pack->nmb_thispack;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+  auto gids = pmy_pack->gids;
+  const bool tsc = tsc_interp;
+  const bool has_vz = (nrdata > IPVZ);
+  const int dkl = (three_d)? -1 : 0;
+  const int dku = (three_d)?  1 : 0;
+  auto &mom = moments;
+  Kokkos::deep_copy(DevExeSpace(), mom, 0.0);
+
+  if (sorted && cell_offset.extent_int(0) == (nmb*nx1*nx2*nx3 + 1)) {
+    auto &offset = cell_offset;
+    int nk3 = (three_d)? 3 : 1;
+    size_t scr_size = ScrArray4D<Real>::shmem_size(NPRTCL_MOMENTS, nk3, 3, ncells1);
+    int scr_level = 1;
+    par_for_outer("pdeposit_sorted", DevExeSpace(), scr_size, scr_level, 0, (nmb-1),
+                  ks, ke, js, je,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray4D<Real> buf(member.team_scratch(scr_level), NPRTCL_MOMENTS, nk3, 3,
+                           ncells1);
+      for (int n=0; n<NPRTCL_MOMENTS; ++n) {
+        for (int kk=0; kk<nk3; ++kk) {
+          for (int jj=0; jj<3; ++jj) {
+            par_for_inner(member, 0, (ncells1-1), [&](const int i) {
+              buf(n,kk,jj,i) = 0.0;
+            });
+          }
+        }
+      }
+      member.team_barrier();
+
+      // deposit all particles in this row of cells into private buffer
+      int n0 = ((m*nx3 + (k-ks))*nx2 + (j-js))*nx1;
+      Real vol = mbsize.d_view(m).dx1*mbsize.d_view(m).dx2*mbsize.d_view(m).dx3;
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, offset(n0),
+                                                   offset(n0 + nx1)),
+      [&](const int p) {
+        Real d1, d2, d3 = 0.0;
+        int ip = DepositCell(pr(IPX,p), mbsize.d_view(m).x1min, mbsize.d_view(m).dx1,
+                             nx1, d1) + is;
+        DepositCell(pr(IPY,p), mbsize.d_view(m).x2min, mbsize.d_view(m).dx2, nx2, d2);
+        if (three_d) {
+          DepositCell(pr(IPZ,p), mbsize.d_view(m).x3min, mbsize.d_view(m).dx3, nx3, d3);
+        }
+        Real w1[3], w2[3], w3[3];
+        DepositWeights(d1, tsc, w1);
+        DepositWeights(d2, tsc, w2);
+        DepositWeights(d3, tsc, w3);
+        Real v[3] = {pr(IPVX,p), pr(IPVY,p), (has_vz)? pr(IPVZ,p) : 0.0};
+        Real q[NPRTCL_MOMENTS];
+        DepositValues(v, q);
+        for (int dk=dkl; dk<=dku; ++dk) {
+          for (int dj=-1; dj<=1; ++dj) {
+            for (int di=-1; di<=1; ++di) {
+              Real w = w3[dk+1]*w2[dj+1]*w1[di+1]/vol;
+              if (w == 0.0) continue;
+              for (int n=0; n<NPRTCL_MOMENTS; ++n) {
+                Kokkos::atomic_add(&buf(n,dk-dkl,dj+1,ip+di), w*q[n]);
+              }
+            }
+          }
+        }
+      });
+      member.team_barrier();
+
+      // add private buffer to global array (rows overlap with those of other teams)
+      for (int n=0; n<NPRTCL_MOMENTS; ++n) {
+        for (int dk=dkl; dk<=dku; ++dk) {
+          for (int dj=-1; dj<=1; ++dj) {
+            par_for_inner(member, is-1, ie+1, [&](const int i) {
+              Real val = buf(n,dk-dkl,dj+1,i);
+              if (val != 0.0) {Kokkos::atomic_add(&mom(m,n,k+dk,j+dj,i), val);}
+            });
+          }
+        }
+      }
+    });
+  } else {
+    par_for("pdeposit",DevExeSpace(),0,(nprtcl_thispack-1),
+    KOKKOS_LAMBDA(const int p) {
+      int m = pi(PGID,p) - gids;
+      Real d1, d2, d3 = 0.0;
+      int ip = DepositCell(pr(IPX,p), mbsize.d_view(m).x1min, mbsize.d_view(m).dx1, nx1,
+                           d1) + is;
+      int jp = DepositCell(pr(IPY,p), mbsize.d_view(m).x2min, mbsize.d_view(m).dx2, nx2,
+                           d2) + js;
+      int kp = ks;
+      if (three_d) {
+        kp = DepositCell(pr(IPZ,p), mbsize.d_view(m).x3min, mbsize.d_view(m).dx3, nx3,
+                         d3) + ks;
+      }
+      Real w1[3], w2[3], w3[3];
+      DepositWeights(d1, tsc, w1);
+      DepositWeights(d2, tsc, w2);
+      DepositWeights(d3, tsc, w3);
+      Real vol = mbsize.d_view(m).dx1*mbsize.d_view(m).dx2*mbsize.d_view(m).dx3;
+      Real v[3] = {pr(IPVX,p), pr(IPVY,p), (has_vz)? pr(IPVZ,p) : 0.0};
+      Real q[NPRTCL_MOMENTS];
+      DepositValues(v, q);
+      for (int dk=dkl; dk<=dku; ++dk) {
+        for (int dj=-1; dj<=1; ++dj) {
+          for (int di=-1; di<=1; ++di) {
+            Real w = w3[dk+1]*w2[dj+1]*w1[di+1]/vol;
+            if (w == 0.0) continue;
+            for (int n=0; n<NPRTCL_MOMENTS; ++n) {
+              Kokkos::atomic_add(&mom(m,n,kp+dk,jp+dj,ip+di), w*q[n]);
+            }
+          }
+        }
+      }
+    });
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Particles::InitMomentRecv
+//! \brief Wrapper task list function to post receives of deposits in ghost zones
+
+TaskStatus Particles::InitMomentRecv(Driver *pdriver, int stage) {
+  return pbval_mom->InitRecv(NPRTCL_MOMENTS);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Particles::SendMoments
+//! \brief Wrapper task list function to send deposits in ghost zones to neighbors
+
+TaskStatus Particles::SendMoments(Driver *pdriver, int stage) {
+  return pbval_mom->PackAndSendCC(moments, moments);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Particles::RecvMoments
+//! \brief Wrapper task list function to add deposits in ghost zones of neighbors to the
+//! active cells of this MeshBlock
+
+TaskStatus Particles::RecvMoments(Driver *pdriver, int stage) {
+  return pbval_mom->RecvAndUnpackCC(moments, moments);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Particles::ClearMomentSend
+//! \brief Wrapper task list function that checks all MPI sends of deposits have completed
+
+TaskStatus Particles::ClearMomentSend(Driver *pdriver, int stage) {
+  return pbval_mom->ClearSend();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Particles::ClearMomentRecv
+//! \brief Wrapper task list function that checks all MPI recvs of deposits have completed
+
+TaskStatus Particles::ClearMomentRecv(Driver *pdriver, int stage) {
+  return pbval_mom->ClearRecv();
+}
+
+} // namespace particles
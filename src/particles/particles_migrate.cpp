@@ -0,0 +1,113 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file particles_migrate.cpp
+//! \brief functions to move particles to the rank that owns their MeshBlock after the
+//! MeshBlocks have been redistributed by load balancing.  Unlike communication of
+//! particles crossing MeshBlock boundaries, destinations can be any rank, so counts and
+//! data are exchanged with MPI_Alltoall(v).  This is only done when the mesh is
+//! rebalanced, which is rare.
+
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "particles.hpp"
+
+namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn void Particles::Migrate
+//! \brief Sends every particle to the rank given by Mesh::rank_eachmb of its MeshBlock.
+//! Must be called after the MeshBlocks have been redistributed (with unchanged gids), and
+//! before particles are used in the new MeshBlockPack.
+
+void Particles::Migrate() {
+#if MPI_PARALLEL_ENABLED
+  Mesh *pm = pmy_pack->pmesh;
+  int nranks = global_variable::nranks;
+  int npart = nprtcl_thispack;
+  int nr = nrdata, ni = nidata;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+
+  // rank of every MeshBlock on device
+  DualArray1D<int> rank_eachmb("rank_eachmb", pm->nmb_total);
+  for (int n=0; n<pm->nmb_total; ++n) {rank_eachmb.h_view(n) = pm->rank_eachmb[n];}
+  rank_eachmb.template modify<HostMemSpace>();
+  rank_eachmb.template sync<DevExeSpace>();
+
+  // count particles sent to each rank (including this one)
+  DvceArray1D<int> npart_eachrank("npart_eachrank", nranks);
+  DvceArray1D<int> dest("prtcl_dest", npart);
+  par_for("prtcl_dest",DevExeSpace(),0,(npart-1),
+  KOKKOS_LAMBDA(const int p) {
+    int r = rank_eachmb.d_view(pi(PGID,p));
+    dest(p) = r;
+    Kokkos::atomic_increment(&npart_eachrank(r));
+  });
+  auto nsend_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), npart_eachrank);
+  std::vector<int> nsend(nranks), nrecv(nranks);
+  for (int r=0; r<nranks; ++r) {nsend[r] = nsend_h(r);}
+  MPI_Alltoall(nsend.data(), 1, MPI_INT, nrecv.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+  // offsets of data sent to/received from each rank, in particles
+  std::vector<int> soff(nranks, 0), roff(nranks, 0);
+  for (int r=1; r<nranks; ++r) {
+    soff[r] = soff[r-1] + nsend[r-1];
+    roff[r] = roff[r-1] + nrecv[r-1];
+  }
+  int nrecv_total = roff[nranks-1] + nrecv[nranks-1];
+
+  // pack particles in order of destination rank, particle-major
+  DvceArray1D<int> cursor("prtcl_cursor", nranks);
+  auto cursor_h = Kokkos::create_mirror_view(cursor);
+  for (int r=0; r<nranks; ++r) {cursor_h(r) = soff[r];}
+  Kokkos::deep_copy(cursor, cursor_h);
+  DvceArray1D<Real> rsend("prtcl_rsend", npart*nr);
+  DvceArray1D<int>  isend("prtcl_isend", npart*ni);
+  par_for("prtcl_mpack",DevExeSpace(),0,(npart-1),
+  KOKKOS_LAMBDA(const int p) {
+    int q = Kokkos::atomic_fetch_add(&cursor(dest(p)), 1);
+    for (int n=0; n<nr; ++n) {rsend(q*nr + n) = pr(n,p);}
+    for (int n=0; n<ni; ++n) {isend(q*ni + n) = pi(n,p);}
+  });
+  Kokkos::fence();
+
+  // exchange real and integer data
+  DvceArray1D<Real> rrecv("prtcl_rrecv", nrecv_total*nr);
+  DvceArray1D<int>  irecv("prtcl_irecv", nrecv_total*ni);
+  std::vector<int> scnt(nranks), sdsp(nranks), rcnt(nranks), rdsp(nranks);
+  for (int r=0; r<nranks; ++r) {
+    scnt[r] = nsend[r]*nr;  sdsp[r] = soff[r]*nr;
+    rcnt[r] = nrecv[r]*nr;  rdsp[r] = roff[r]*nr;
+  }
+  MPI_Alltoallv(rsend.data(), scnt.data(), sdsp.data(), MPI_ATHENA_REAL,
+                rrecv.data(), rcnt.data(), rdsp.data(), MPI_ATHENA_REAL, MPI_COMM_WORLD);
+  for (int r=0; r<nranks; ++r) {
+    scnt[r] = nsend[r]*ni;  sdsp[r] = soff[r]*ni;
+    rcnt[r] = nrecv[r]*ni;  rdsp[r] = roff[r]*ni;
+  }
+  MPI_Alltoallv(isend.data(), scnt.data(), sdsp.data(), MPI_INT,
+                irecv.data(), rcnt.data(), rdsp.data(), MPI_INT, MPI_COMM_WORLD);
+
+  // unpack into particle arrays, which keep (at least) their current capacity
+  nprtcl_thispack = nrecv_total;
+  ReserveCapacity(nrecv_total);
+  par_for("prtcl_munpack",DevExeSpace(),0,(nrecv_total-1),
+  KOKKOS_LAMBDA(const int p) {
+    for (int n=0; n<nr; ++n) {pr(n,p) = rrecv(p*nr + n);}
+    for (int n=0; n<ni; ++n) {pi(n,p) = irecv(p*ni + n);}
+  });
+  sorted = false;
+
+  // update particle counts stored in Mesh
+  pm->nprtcl_thisrank = nprtcl_thispack;
+  pm->GatherParticleCounts();
+#endif
+  return;
+}
+
+} // namespace particles
@@ -4,14 +4,77 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file particle_pushers.cpp
-//  \brief
+//! \brief functions to integrate particle positions and velocities.  The "boris" pusher
+//! integrates charged particles in the electric and magnetic fields of the MHD fluid,
+//! E = -(v x B), interpolated to the particle position with CIC or TSC weights over the
+//! 3^d cells surrounding the cell containing each particle.
+
+#include <cstdlib>
+#include <iostream>
 
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
+#include "mhd/mhd.hpp"
+#include "utils/random.hpp"
 #include "particles.hpp"
 
 namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn void InterpWeights()
+//! \brief Weights of cells (i-1,i,i+1) for a particle at offset d in [-0.5,0.5] from
+//! center of cell i, in units of the cell size.  CIC weights use at most two cells.
+
+KOKKOS_INLINE_FUNCTION
+void InterpWeights(const Real d, const bool tsc, Real w[3]) {
+  if (tsc) {
+    w[0] = 0.5*(0.5 - d)*(0.5 - d);
+    w[1] = 0.75 - d*d;
+    w[2] = 0.5*(0.5 + d)*(0.5 + d);
+  } else {
+    w[0] = fmax(-d, 0.0);
+    w[1] = 1.0 - fabs(d);
+    w[2] = fmax(d, 0.0);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void BorisVelocity()
+//! \brief Updates velocity v over timestep with Boris algorithm, given E and B at the
+//! particle position, and qmdt2 = (q/m)*dt/2.
+
+KOKKOS_INLINE_FUNCTION
+void BorisVelocity(const Real qmdt2, const Real e[3], const Real b[3], Real v[3]) {
+  // half acceleration by E
+  Real vm[3] = {v[0] + qmdt2*e[0], v[1] + qmdt2*e[1], v[2] + qmdt2*e[2]};
+  // rotation by B
+  Real t[3] = {qmdt2*b[0], qmdt2*b[1], qmdt2*b[2]};
+  Real sfac = 2.0/(1.0 + t[0]*t[0] + t[1]*t[1] + t[2]*t[2]);
+  Real vp[3] = {vm[0] + (vm[1]*t[2] - vm[2]*t[1]),
+                vm[1] + (vm[2]*t[0] - vm[0]*t[2]),
+                vm[2] + (vm[0]*t[1] - vm[1]*t[0])};
+  Real vr[3] = {vm[0] + sfac*(vp[1]*t[2] - vp[2]*t[1]),
+                vm[1] + sfac*(vp[2]*t[0] - vp[0]*t[2]),
+                vm[2] + sfac*(vp[0]*t[1] - vp[1]*t[0])};
+  // second half acceleration by E
+  for (int n=0; n<3; ++n) {
+    v[n] = vr[n] + qmdt2*e[n];
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void CellOffset()
+//! \brief Returns index (measured from first active cell) of cell containing position
+//! x, and offset d of x from center of that cell in units of the cell size.
+
+KOKKOS_INLINE_FUNCTION
+int CellOffset(const Real x, const Real xmin, const Real dx, const int nx, Real &d) {
+  int i = static_cast<int>((x - xmin)/dx);
+  i = (i < 0)? 0 : ((i >= nx)? nx-1 : i);
+  d = (x - (xmin + (i + 0.5)*dx))/dx;
+  return i;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn  void Particles::ParticlesPush
 //  \brief
@@ -49,11 +112,256 @@ TaskStatus Particles::Push(Driver *pdriver, int stage) {
         }
       });
 
+    break;
+  case ParticlesPusher::boris:
+    BorisPush();
     break;
   default:
     break;
   }
+  // particles have moved, so any previous sort by cell is no longer valid
+  sorted = false;
 
   return TaskStatus::complete;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Particles::BorisPush
+//! \brief Boris integrator for charged particles in the fields of the MHD fluid.
+//! When particles are sorted by cell, one team per (m,k,j) row of cells loads the field
+//! stencil (B and E over rows j-1..j+1 and k-1..k+1) into scratch memory once, and then
+//! pushes all particles in that row, which are contiguous.  Otherwise each particle reads
+//! the fields from global memory.
+
+void Particles::BorisPush() {
+  if (pmy_pack->pmhd == nullptr) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Boris particle pusher requires MHD" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, ie = indcs.ie;
+  int js = indcs.js, je = indcs.je;
+  int ks = indcs.ks, ke = indcs.ke;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  int ncells1 = nx1 + 2*(indcs.ng);
+  bool three_d = pmy_pack->pmesh->three_d;
+  int nmb = pmy_pack->nmb_thispack;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+  auto &bcc = pmy_pack->pmhd->bcc0;
+  auto &w0 = pmy_pack->pmhd->w0;
+  auto gids = pmy_pack->gids;
+  const Real dt = pmy_pack->pmesh->dt;
+  const Real qmdt2 = 0.5*q_over_m*dt;
+  const bool tsc = tsc_interp;
+  const int dkl = (three_d)? -1 : 0;
+  const int dku = (three_d)?  1 : 0;
+
+  // offsets are only valid if particles were sorted with current MeshBlocks in pack
+  if (sorted && cell_offset.extent_int(0) == (nmb*nx1*nx2*nx3 + 1)) {
+    auto &offset = cell_offset;
+    int nk3 = (three_d)? 3 : 1;
+    size_t scr_size = ScrArray4D<Real>::shmem_size(6, nk3, 3, ncells1);
+    int scr_level = 1;
+    par_for_outer("boris_sorted", DevExeSpace(), scr_size, scr_level, 0, (nmb-1), ks, ke,
+                  js, je,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray4D<Real> fld(member.team_scratch(scr_level), 6, nk3, 3, ncells1);
+      // load B and E = -(v x B) in stencil around this row of cells
+      for (int dk=dkl; dk<=dku; ++dk) {
+        for (int dj=-1; dj<=1; ++dj) {
+          par_for_inner(member, is-1, ie+1, [&](const int i) {
+            Real bx = bcc(m,IBX,k+dk,j+dj,i);
+            Real by = bcc(m,IBY,k+dk,j+dj,i);
+            Real bz = bcc(m,IBZ,k+dk,j+dj,i);
+            Real vx = w0(m,IVX,k+dk,j+dj,i);
+            Real vy = w0(m,IVY,k+dk,j+dj,i);
+            Real vz = w0(m,IVZ,k+dk,j+dj,i);
+            int kk = dk - dkl;
+            fld(0,kk,dj+1,i) = bx;
+            fld(1,kk,dj+1,i) = by;
+            fld(2,kk,dj+1,i) = bz;
+            fld(3,kk,dj+1,i) = -(vy*bz - vz*by);
+            fld(4,kk,dj+1,i) = -(vz*bx - vx*bz);
+            fld(5,kk,dj+1,i) = -(vx*by - vy*bx);
+          });
+        }
+      }
+      member.team_barrier();
+
+      // push all particles in this row of cells
+      int n0 = ((m*nx3 + (k-ks))*nx2 + (j-js))*nx1;
+      int pstart = offset(n0);
+      int pend = offset(n0 + nx1);
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, pstart, pend),
+      [&](const int p) {
+        Real d1, d2, d3 = 0.0;
+        int ip = CellOffset(pr(IPX,p), mbsize.d_view(m).x1min, mbsize.d_view(m).dx1, nx1,
+                            d1) + is;
+        CellOffset(pr(IPY,p), mbsize.d_view(m).x2min, mbsize.d_view(m).dx2, nx2, d2);
+        if (three_d) {
+          CellOffset(pr(IPZ,p), mbsize.d_view(m).x3min, mbsize.d_view(m).dx3, nx3, d3);
+        }
+        Real w1[3], w2[3], w3[3];
+        InterpWeights(d1, tsc, w1);
+        InterpWeights(d2, tsc, w2);
+        InterpWeights(d3, tsc, w3);
+        Real f[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        for (int dk=dkl; dk<=dku; ++dk) {
+          for (int dj=-1; dj<=1; ++dj) {
+            for (int di=-1; di<=1; ++di) {
+              Real w = w3[dk+1]*w2[dj+1]*w1[di+1];
+              for (int n=0; n<6; ++n) {
+                f[n] += w*fld(n,dk-dkl,dj+1,ip+di);
+              }
+            }
+          }
+        }
+        Real v[3] = {pr(IPVX,p), pr(IPVY,p), pr(IPVZ,p)};
+        BorisVelocity(qmdt2, &(f[3]), &(f[0]), v);
+        pr(IPVX,p) = v[0];
+        pr(IPVY,p) = v[1];
+        pr(IPVZ,p) = v[2];
+        pr(IPX,p) += dt*v[0];
+        pr(IPY,p) += dt*v[1];
+        if (three_d) {pr(IPZ,p) += dt*v[2];}
+      });
+    });
+  } else {
+    par_for("boris",DevExeSpace(),0,(nprtcl_thispack-1),
+    KOKKOS_LAMBDA(const int p) {
+      int m = pi(PGID,p) - gids;
+      Real d1, d2, d3 = 0.0;
+      int ip = CellOffset(pr(IPX,p), mbsize.d_view(m).x1min, mbsize.d_view(m).dx1, nx1,
+                          d1) + is;
+      int jp = CellOffset(pr(IPY,p), mbsize.d_view(m).x2min, mbsize.d_view(m).dx2, nx2,
+                          d2) + js;
+      int kp = ks;
+      if (three_d) {
+        kp = CellOffset(pr(IPZ,p), mbsize.d_view(m).x3min, mbsize.d_view(m).dx3, nx3,
+                        d3) + ks;
+      }
+      Real w1[3], w2[3], w3[3];
+      InterpWeights(d1, tsc, w1);
+      InterpWeights(d2, tsc, w2);
+      InterpWeights(d3, tsc, w3);
+      Real b[3] = {0.0, 0.0, 0.0};
+      Real e[3] = {0.0, 0.0, 0.0};
+      for (int dk=dkl; dk<=dku; ++dk) {
+        for (int dj=-1; dj<=1; ++dj) {
+          for (int di=-1; di<=1; ++di) {
+            Real w = w3[dk+1]*w2[dj+1]*w1[di+1];
+            if (w == 0.0) continue;
+            int k = kp+dk, j = jp+dj, i = ip+di;
+            Real bx = bcc(m,IBX,k,j,i), by = bcc(m,IBY,k,j,i), bz = bcc(m,IBZ,k,j,i);
+            Real vx = w0(m,IVX,k,j,i), vy = w0(m,IVY,k,j,i), vz = w0(m,IVZ,k,j,i);
+            b[0] += w*bx;
+            b[1] += w*by;
+            b[2] += w*bz;
+            e[0] -= w*(vy*bz - vz*by);
+            e[1] -= w*(vz*bx - vx*bz);
+            e[2] -= w*(vx*by - vy*bx);
+          }
+        }
+      }
+      Real v[3] = {pr(IPVX,p), pr(IPVY,p), pr(IPVZ,p)};
+      BorisVelocity(qmdt2, e, b, v);
+      pr(IPVX,p) = v[0];
+      pr(IPVY,p) = v[1];
+      pr(IPVZ,p) = v[2];
+      pr(IPX,p) += dt*v[0];
+      pr(IPY,p) += dt*v[1];
+      if (three_d) {pr(IPZ,p) += dt*v[2];}
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Particles::MonteCarloTracers
+//! \brief Lagrangian Monte Carlo tracers (Genel et al. 2013).  Called at the end of the
+//! RK update on the last stage, while the mass fluxes flx(IDN) are still available, so
+//! only the six faces of cells containing tracers are read.  Each tracer leaves its
+//! cell through face f with probability dt*A_f*max(F_f,0)/M, where M is the mass of the
+//! cell at the start of the step, and is then moved by one cell in that direction.  The
+//! random deviate is a hash of the tag and cycle number, so no RNG state is stored.
+
+void Particles::MonteCarloTracers(const DvceFaceFld5D<Real> &flx,
+                                  const DvceArray5D<Real> &u0, const Real dt) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+  auto gids = pmy_pack->gids;
+  auto flx1 = flx.x1f;
+  auto flx2 = flx.x2f;
+  auto flx3 = flx.x3f;
+  uint64_t cycle = static_cast<uint64_t>(pmy_pack->pmesh->ncycle);
+
+  par_for("part_mctracer",DevExeSpace(),0,(nprtcl_thispack-1),
+  KOKKOS_LAMBDA(const int p) {
+    int m = pi(PGID,p) - gids;
+    Real d;
+    int i = CellOffset(pr(IPX,p), mbsize.d_view(m).x1min, mbsize.d_view(m).dx1, nx1, d)
+            + is;
+    int j = CellOffset(pr(IPY,p), mbsize.d_view(m).x2min, mbsize.d_view(m).dx2, nx2, d)
+            + js;
+    int k = ks;
+    if (three_d) {
+      k = CellOffset(pr(IPZ,p), mbsize.d_view(m).x3min, mbsize.d_view(m).dx3, nx3, d)
+          + ks;
+    }
+
+    // mass fractions leaving (fout) and entering (fin) through faces (-x1,+x1,-x2,...)
+    Real fout[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    Real fin = 0.0;
+    Real dtdx = dt/mbsize.d_view(m).dx1;
+    fout[0] = fmax(-flx1(m,IDN,k,j,i  ), 0.0)*dtdx;
+    fout[1] = fmax( flx1(m,IDN,k,j,i+1), 0.0)*dtdx;
+    fin += (fmax(flx1(m,IDN,k,j,i), 0.0) + fmax(-flx1(m,IDN,k,j,i+1), 0.0))*dtdx;
+    if (multi_d) {
+      dtdx = dt/mbsize.d_view(m).dx2;
+      fout[2] = fmax(-flx2(m,IDN,k,j  ,i), 0.0)*dtdx;
+      fout[3] = fmax( flx2(m,IDN,k,j+1,i), 0.0)*dtdx;
+      fin += (fmax(flx2(m,IDN,k,j,i), 0.0) + fmax(-flx2(m,IDN,k,j+1,i), 0.0))*dtdx;
+    }
+    if (three_d) {
+      dtdx = dt/mbsize.d_view(m).dx3;
+      fout[4] = fmax(-flx3(m,IDN,k  ,j,i), 0.0)*dtdx;
+      fout[5] = fmax( flx3(m,IDN,k+1,j,i), 0.0)*dtdx;
+      fin += (fmax(flx3(m,IDN,k,j,i), 0.0) + fmax(-flx3(m,IDN,k+1,j,i), 0.0))*dtdx;
+    }
+    Real out = fout[0] + fout[1] + fout[2] + fout[3] + fout[4] + fout[5];
+    if (out <= 0.0) return;
+
+    // mass at start of step reconstructed from updated density; probabilities sum to <= 1
+    Real mass = fmax(u0(m,IDN,k,j,i) + out - fin, out);
+    uint64_t key = (static_cast<uint64_t>(pi(PTAG,p)) << 32) ^ cycle;
+    Real r = RanHash(key)*mass;
+    Real cum = 0.0;
+    for (int f=0; f<6; ++f) {
+      cum += fout[f];
+      if (r < cum) {
+        Real sgn = (f % 2 == 0)? -1.0 : 1.0;
+        if (f < 2) {
+          pr(IPX,p) += sgn*mbsize.d_view(m).dx1;
+        } else if (f < 4) {
+          pr(IPY,p) += sgn*mbsize.d_view(m).dx2;
+        } else {
+          pr(IPZ,p) += sgn*mbsize.d_view(m).dx3;
+        }
+        break;
+      }
+    }
+  });
+  // tracers have moved, so any previous sort by cell is no longer valid
+  sorted = false;
+  return;
+}
 } // namespace particles
@@ -0,0 +1,111 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file particles_sort.cpp
+//! \brief functions to sort particles on the device by MeshBlock and cell, so that
+//! particles in the same cell are contiguous in memory.  A counting sort is used since
+//! the range of keys (number of cells in the pack) is known.  Offsets of the first
+//! particle in each cell are stored in cell_offset, so that deposits onto the mesh can
+//! be computed as reductions over contiguous segments, without atomics.
+//!
+//! Sorting is performed every sort_interval cycles (set in the <particles> block, the
+//! default 0 disables sorting), after particles have been communicated.
+
+#include <utility>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "particles.hpp"
+
+namespace particles {
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Particles::Sort
+//! \brief Wrapper task list function that sorts particles every sort_interval cycles.
+
+TaskStatus Particles::Sort(Driver *pdriver, int stage) {
+  if (sort_interval > 0 && (pmy_pack->pmesh->ncycle % sort_interval) == 0) {
+    SortParticles();
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Particles::SortParticles
+//! \brief Sorts prtcl_rdata and prtcl_idata by key ((m*nx3 + k)*nx2 + j)*nx1 + i, where
+//! m is the index of the MeshBlock in this pack and (i,j,k) the active cell containing
+//! the particle (measured from is,js,ks).  On return particles in cell with key n are
+//! stored in [cell_offset(n), cell_offset(n+1)).
+
+void Particles::SortParticles() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int nx1 = indcs.nx1, nx2 = indcs.nx2, nx3 = indcs.nx3;
+  bool &three_d = pmy_pack->pmesh->three_d;
+  auto &mbsize = pmy_pack->pmb->mb_size;
+  int nmb = pmy_pack->nmb_thispack;
+  int ncell = nmb*nx1*nx2*nx3;
+  int npart = nprtcl_thispack;
+  auto gids = pmy_pack->gids;
+  auto &pi = prtcl_idata;
+  auto &pr = prtcl_rdata;
+
+  // compute key of each particle, and count particles in each cell
+  if (cell_offset.extent_int(0) != (ncell + 1)) {
+    Kokkos::realloc(cell_offset, ncell + 1);
+  }
+  if (prtcl_key.extent_int(0) != npart) {
+    Kokkos::realloc(prtcl_key, npart);
+  }
+  auto &offset = cell_offset;
+  auto &key = prtcl_key;
+  Kokkos::deep_copy(DevExeSpace(), offset, 0);
+  par_for("prtcl_key",DevExeSpace(),0,(npart-1),
+  KOKKOS_LAMBDA(const int p) {
+    int m = pi(PGID,p) - gids;
+    int ip = static_cast<int>((pr(IPX,p) - mbsize.d_view(m).x1min)/mbsize.d_view(m).dx1);
+    int jp = static_cast<int>((pr(IPY,p) - mbsize.d_view(m).x2min)/mbsize.d_view(m).dx2);
+    int kp = 0;
+    if (three_d) {
+      kp = static_cast<int>((pr(IPZ,p) - mbsize.d_view(m).x3min)/mbsize.d_view(m).dx3);
+    }
+    // guard against round-off for particles exactly on the upper MeshBlock face
+    ip = (ip < 0)? 0 : ((ip >= nx1)? nx1-1 : ip);
+    jp = (jp < 0)? 0 : ((jp >= nx2)? nx2-1 : jp);
+    kp = (kp < 0)? 0 : ((kp >= nx3)? nx3-1 : kp);
+    int n = ((m*nx3 + kp)*nx2 + jp)*nx1 + ip;
+    key(p) = n;
+    Kokkos::atomic_increment(&offset(n+1));
+  });
+
+  // exclusive scan of counts gives the offset of the first particle in each cell
+  Kokkos::parallel_scan("prtcl_offset", Kokkos::RangePolicy<>(DevExeSpace(), 1,
+                        ncell+1),
+  KOKKOS_LAMBDA(const int n, int &psum, const bool final) {
+    psum += offset(n);
+    if (final) {offset(n) = psum;}
+  });
+
+  // scatter particles into sorted arrays.  Order within each cell is arbitrary.
+  DvceArray1D<int> cursor("prtcl_cursor", ncell);
+  Kokkos::deep_copy(DevExeSpace(), cursor,
+                    Kokkos::subview(offset, std::make_pair(0, ncell)));
+  // sorted arrays keep the capacity of the current arrays
+  int capacity = prtcl_rdata.extent_int(1);
+  DvceArray2D<Real> new_rdata("prtcl_rdata", nrdata, capacity);
+  DvceArray2D<int>  new_idata("prtcl_idata", nidata, capacity);
+  int nr = nrdata, ni = nidata;
+  par_for("prtcl_sort",DevExeSpace(),0,(npart-1),
+  KOKKOS_LAMBDA(const int p) {
+    int q = Kokkos::atomic_fetch_add(&cursor(key(p)), 1);
+    for (int n=0; n<nr; ++n) {new_rdata(n,q) = pr(n,p);}
+    for (int n=0; n<ni; ++n) {new_idata(n,q) = pi(n,p);}
+  });
+  prtcl_rdata = new_rdata;
+  prtcl_idata = new_idata;
+  sorted = true;
+  return;
+}
+
+} // namespace particles
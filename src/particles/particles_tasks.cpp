@@ -37,6 +37,18 @@ void Particles::AssembleTasks(std::map<std::string, std::shared_ptr<TaskList>> t
   id.recvp  = tl["before_timeintegrator"]->AddTask(&Particles::RecvP, this, id.sendp);
   id.crecv  = tl["before_timeintegrator"]->AddTask(&Particles::ClearRecv, this, id.recvp);
   id.csend  = tl["before_timeintegrator"]->AddTask(&Particles::ClearSend, this, id.crecv);
+  id.sort   = tl["before_timeintegrator"]->AddTask(&Particles::Sort, this, id.csend);
+
+  // deposit moments on mesh, and add deposits in ghost zones to neighbors
+  if (deposit_moments) {
+    auto &tlb = tl["before_timeintegrator"];
+    id.mirecv  = tlb->AddTask(&Particles::InitMomentRecv, this, none);
+    id.deposit = tlb->AddTask(&Particles::DepositMoments, this, id.sort);
+    id.msend   = tlb->AddTask(&Particles::SendMoments, this, (id.deposit | id.mirecv));
+    id.mrecv   = tlb->AddTask(&Particles::RecvMoments, this, id.msend);
+    id.mcsend  = tlb->AddTask(&Particles::ClearMomentSend, this, id.mrecv);
+    id.mcrecv  = tlb->AddTask(&Particles::ClearMomentRecv, this, id.mcsend);
+  }
 
   return;
 }
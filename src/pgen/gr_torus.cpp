@@ -43,6 +43,7 @@
 #include "hydro/hydro.hpp"
 #include "mhd/mhd.hpp"
 #include "radiation/radiation.hpp"
+#include "radiation/radiation_opacities.hpp"
 #include "dyn_grmhd/dyn_grmhd.hpp"
 
 #include <Kokkos_Random.hpp>
@@ -192,12 +193,15 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   }
 
   // Extract radiation parameters if enabled
-  int nangles_;
+  int nangles_, ngroups_;
   DualArray2D<Real> nh_c_;
+  DualArray1D<Real> nu_edge_;
   DvceArray6D<Real> norm_to_tet_, tet_c_, tetcov_c_;
   DvceArray5D<Real> i0_;
   if (is_radiation_enabled) {
     nangles_ = pmbp->prad->prgeo->nangles;
+    ngroups_ = pmbp->prad->ngroups;
+    nu_edge_ = pmbp->prad->nu_edge;
     nh_c_ = pmbp->prad->nh_c;
     norm_to_tet_ = pmbp->prad->norm_to_tet;
     tet_c_ = pmbp->prad->tet_c;
@@ -379,6 +383,7 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
     Real uu2 = 0.0;
     Real uu3 = 0.0;
     Real urad = 0.0;
+    Real trad = 0.0;
 
     Real perturbation = 0.0;
     // Overwrite primitives inside torus
@@ -396,7 +401,10 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
       pgas = temp * rho;
 
       // Calculate radiation variables (if radiation enabled)
-      if (is_radiation_enabled) urad = trs.arad * SQR(SQR(temp));
+      if (is_radiation_enabled) {
+        urad = trs.arad * SQR(SQR(temp));
+        trad = temp;
+      }
 
       // Calculate velocities in Boyer-Lindquist coordinates
       Real u0_bl, u1_bl, u2_bl, u3_bl;
@@ -453,7 +461,14 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
         // Calculate intensity in tetrad frame
         Real n0 = tet_c_(m,0,0,k,j,i); Real n_0 = 0.0;
         for (int d=0; d<4; ++d) {  n_0 += tetcov_c_(m,d,0,k,j,i)*nh_c_.d_view(n,d);  }
-        i0_(m,n,k,j,i) = n0*n_0*(urad/(4.0*M_PI))/SQR(SQR(n0_f));
+        // split thermal radiation between frequency groups
+        for (int g=0; g<ngroups_; ++g) {
+          Real frac = 1.0;
+          if (ngroups_ > 1 && trad > 0.0) {
+            frac = PlanckGroupFraction(nu_edge_.d_view(g), nu_edge_.d_view(g+1), trad);
+          }
+          i0_(m,n*ngroups_+g,k,j,i) = n0*n_0*(frac*urad/(4.0*M_PI))/SQR(SQR(n0_f));
+        }
       }
     }
 
@@ -1483,7 +1498,7 @@ void NoInflowTorus(Mesh *pm) {
   DvceArray5D<Real> i0_; int nang1;
   if (is_radiation_enabled) {
     i0_ = pm->pmb_pack->prad->i0;
-    nang1 = pm->pmb_pack->prad->prgeo->nangles - 1;
+    nang1 = pm->pmb_pack->prad->nvar - 1;
   }
 
   // X1-Boundary
@@ -95,40 +95,24 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   std::cout << "Allocated coordinates of size " << width << std::endl;
 
-  // Populate coordinates for LORENE
-  // TODO(JMF): Replace with a Kokkos loop on Kokkos::DefaultHostExecutionSpace() to
-  // improve performance.
-  int idx = 0;
-  for (int m = 0; m < nmb; m++) {
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    int nx1 = indcs.nx1;
-
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    int nx2 = indcs.nx2;
-
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
-    int nx3 = indcs.nx3;
-
-    for (int k = 0; k < ncells3; k++) {
-      Real z = CellCenterX(k - ks, nx3, x3min, x3max);
-      for (int j = 0; j < ncells2; j++) {
-        Real y = CellCenterX(j - js, nx2, x2min, x2max);
-        for (int i = 0; i < ncells1; i++) {
-          Real x = CellCenterX(i - is, nx1, x1min, x1max);
-
-          x_coords[idx] = coord_unit*x;
-          y_coords[idx] = coord_unit*y;
-          z_coords[idx] = coord_unit*z;
-
-          // Increment flat index
-          idx++;
-        }
-      }
-    }
-  }
+  // Populate coordinates for LORENE, in parallel on the host.  Points are ordered with i
+  // fastest, and LORENE interpolates all of them in a single batched call below.
+  const int nkji = ncells3*ncells2*ncells1;
+  const int nji  = ncells2*ncells1;
+  Kokkos::parallel_for("lorene_coords",
+  Kokkos::RangePolicy<>(Kokkos::DefaultHostExecutionSpace(), 0, width),
+  [&](const int idx) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/ncells1;
+    int i = (idx - m*nkji - k*nji - j*ncells1);
+    Real x = CellCenterX(i - is, indcs.nx1, size.h_view(m).x1min, size.h_view(m).x1max);
+    Real y = CellCenterX(j - js, indcs.nx2, size.h_view(m).x2min, size.h_view(m).x2max);
+    Real z = CellCenterX(k - ks, indcs.nx3, size.h_view(m).x3min, size.h_view(m).x3max);
+    x_coords[idx] = coord_unit*x;
+    y_coords[idx] = coord_unit*y;
+    z_coords[idx] = coord_unit*z;
+  });
 
   // Interpolate the data
   std::cout << "Coordinates assigned." << std::endl;
@@ -176,88 +160,70 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 
   std::cout << "Host mirrors created." << std::endl;
 
-  // TODO(JMF): Replace with a Kokkos loop on Kokkos::DefaultHostExecutionSpace() to
-  // improve performance.
-  idx = 0;
-  for (int m = 0; m < nmb; m++) {
-    for (int k = 0; k < ncells3; k++) {
-      for (int j = 0; j < ncells2; j++) {
-        for (int i = 0; i < ncells1; i++) {
-  /*const int nn = nmb;
-  const int nk = ncells3;
-  const int nj = ncells2;
-  const int ni = ncells1;
-  const int nnkji = nn * nk * nj * ni;
-  const int nkji = nk * nj * ni;
-  const int nji = nj * ni;
-  Kokkos::parallel_for("pgen_lorene",
-  Kokkos::RangePolicy<>(HostExeSpace(), 0, nnkji),
-  KOKKOS_LAMBDA(const int &idx) {
-          int m = (idx)/nkji;
-          int k = (idx - m*nkji)/nji;
-          int j = (idx - m*nkji - k*nji)/ni;
-          int i = (idx - m*nkji - k*nji - j*ni);*/
-          // Extract metric quantities
-          host_adm.alpha(m, k, j, i) = bns->nnn[idx];
-          host_adm.beta_u(m, 0, k, j, i) = bns->beta_x[idx];
-          host_adm.beta_u(m, 1, k, j, i) = bns->beta_y[idx];
-          host_adm.beta_u(m, 2, k, j, i) = bns->beta_z[idx];
-
-          Real g3d[NSPMETRIC];
-          host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = bns->g_xx[idx];
-          host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = bns->g_xy[idx];
-          host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = bns->g_xz[idx];
-          host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = bns->g_yy[idx];
-          host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = bns->g_yz[idx];
-          host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = bns->g_zz[idx];
-
-          host_adm.vK_dd(m, 0, 0, k, j, i) = coord_unit * bns->k_xx[idx];
-          host_adm.vK_dd(m, 0, 1, k, j, i) = coord_unit * bns->k_xy[idx];
-          host_adm.vK_dd(m, 0, 2, k, j, i) = coord_unit * bns->k_xz[idx];
-          host_adm.vK_dd(m, 1, 1, k, j, i) = coord_unit * bns->k_yy[idx];
-          host_adm.vK_dd(m, 1, 2, k, j, i) = coord_unit * bns->k_yz[idx];
-          host_adm.vK_dd(m, 2, 2, k, j, i) = coord_unit * bns->k_zz[idx];
-
-          // Extract hydro quantities
-          host_w0(m, IDN, k, j, i) = bns->nbar[idx] / rho_unit;
-          // Lorene only gives the specific internal energy, but PrimitiveSolver needs
-          // pressure. Because PrimitiveSolver is templated, it's difficult to call it
-          // directly. Thus, the easiest way is to save the internal energy density, IEN,
-          // whose index overlaps the pressure, IPR, move the data to the GPU, then
-          // make a call to a virtual DynGRMHD EOS function that will call the appropriate
-          // template function.
-          Real egas = host_w0(m, IDN, k, j, i) * bns->ener_spec[idx] / ener_unit;
-          host_w0(m, IEN, k, j, i) = egas;
-          Real vu[3] = {bns->u_euler_x[idx] / vel_unit,
-                        bns->u_euler_y[idx] / vel_unit,
-                        bns->u_euler_z[idx] / vel_unit};
-
-          // Before we store the velocity, we need to make sure it's physical and
-          // calculate the Lorentz factor. If the velocity is superluminal, we make a
-          // last-ditch attempt to salvage the solution by rescaling it to
-          // vsq = 1.0 - 1e-15
-          Real vsq = Primitive::SquareVector(vu, g3d);
-          if (1.0 - vsq <= 0) {
-            std::cout << "The velocity is superluminal!" << std::endl
-                      << "Attempting to adjust..." << std::endl;
-            Real fac = sqrt((1.0 - 1e-15)/vsq);
-            vu[0] *= fac;
-            vu[1] *= fac;
-            vu[2] *= fac;
-            vsq = 1.0 - 1.0e-15;
-          }
-          Real W = sqrt(1.0 / (1.0 - vsq));
-
-          host_w0(m, IVX, k, j, i) = W*vu[0];
-          host_w0(m, IVY, k, j, i) = W*vu[1];
-          host_w0(m, IVZ, k, j, i) = W*vu[2];
-
-          idx++;
-  //});
-        }
-      }
+  // Scatter interpolated data into host mirrors, in parallel on the host.  All data is
+  // then moved to the device with a single deep copy of each array below.
+  Kokkos::parallel_for("lorene_scatter",
+  Kokkos::RangePolicy<>(Kokkos::DefaultHostExecutionSpace(), 0, width),
+  [&](const int idx) {
+    int m = (idx)/nkji;
+    int k = (idx - m*nkji)/nji;
+    int j = (idx - m*nkji - k*nji)/ncells1;
+    int i = (idx - m*nkji - k*nji - j*ncells1);
+    // Extract metric quantities
+    host_adm.alpha(m, k, j, i) = bns->nnn[idx];
+    host_adm.beta_u(m, 0, k, j, i) = bns->beta_x[idx];
+    host_adm.beta_u(m, 1, k, j, i) = bns->beta_y[idx];
+    host_adm.beta_u(m, 2, k, j, i) = bns->beta_z[idx];
+
+    Real g3d[NSPMETRIC];
+    host_adm.g_dd(m, 0, 0, k, j, i) = g3d[S11] = bns->g_xx[idx];
+    host_adm.g_dd(m, 0, 1, k, j, i) = g3d[S12] = bns->g_xy[idx];
+    host_adm.g_dd(m, 0, 2, k, j, i) = g3d[S13] = bns->g_xz[idx];
+    host_adm.g_dd(m, 1, 1, k, j, i) = g3d[S22] = bns->g_yy[idx];
+    host_adm.g_dd(m, 1, 2, k, j, i) = g3d[S23] = bns->g_yz[idx];
+    host_adm.g_dd(m, 2, 2, k, j, i) = g3d[S33] = bns->g_zz[idx];
+
+    host_adm.vK_dd(m, 0, 0, k, j, i) = coord_unit * bns->k_xx[idx];
+    host_adm.vK_dd(m, 0, 1, k, j, i) = coord_unit * bns->k_xy[idx];
+    host_adm.vK_dd(m, 0, 2, k, j, i) = coord_unit * bns->k_xz[idx];
+    host_adm.vK_dd(m, 1, 1, k, j, i) = coord_unit * bns->k_yy[idx];
+    host_adm.vK_dd(m, 1, 2, k, j, i) = coord_unit * bns->k_yz[idx];
+    host_adm.vK_dd(m, 2, 2, k, j, i) = coord_unit * bns->k_zz[idx];
+
+    // Extract hydro quantities
+    host_w0(m, IDN, k, j, i) = bns->nbar[idx] / rho_unit;
+    // Lorene only gives the specific internal energy, but PrimitiveSolver needs
+    // pressure. Because PrimitiveSolver is templated, it's difficult to call it
+    // directly. Thus, the easiest way is to save the internal energy density, IEN,
+    // whose index overlaps the pressure, IPR, move the data to the GPU, then
+    // make a call to a virtual DynGRMHD EOS function that will call the appropriate
+    // template function.
+    Real egas = host_w0(m, IDN, k, j, i) * bns->ener_spec[idx] / ener_unit;
+    host_w0(m, IEN, k, j, i) = egas;
+    Real vu[3] = {bns->u_euler_x[idx] / vel_unit,
+                  bns->u_euler_y[idx] / vel_unit,
+                  bns->u_euler_z[idx] / vel_unit};
+
+    // Before we store the velocity, we need to make sure it's physical and
+    // calculate the Lorentz factor. If the velocity is superluminal, we make a
+    // last-ditch attempt to salvage the solution by rescaling it to
+    // vsq = 1.0 - 1e-15
+    Real vsq = Primitive::SquareVector(vu, g3d);
+    if (1.0 - vsq <= 0) {
+      std::cout << "The velocity is superluminal!" << std::endl
+                << "Attempting to adjust..." << std::endl;
+      Real fac = sqrt((1.0 - 1e-15)/vsq);
+      vu[0] *= fac;
+      vu[1] *= fac;
+      vu[2] *= fac;
+      vsq = 1.0 - 1.0e-15;
     }
-  }
+    Real W = sqrt(1.0 / (1.0 - vsq));
+
+    host_w0(m, IVX, k, j, i) = W*vu[0];
+    host_w0(m, IVY, k, j, i) = W*vu[1];
+    host_w0(m, IVZ, k, j, i) = W*vu[2];
+  });
 
   std::cout << "Host mirrors filled." << std::endl;
 
@@ -8,10 +8,13 @@
 //! Default constructor calls problem generator function, while  constructor for restarts
 //! reads data from restart file, as well as re-initializing problem-specific data.
 
+#include <cstring>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <utility>
 #include <algorithm>
+#include <vector>
 
 #include "athena.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
@@ -25,6 +28,7 @@
 #include "z4c/z4c.hpp"
 #include "radiation/radiation.hpp"
 #include "srcterms/turb_driver.hpp"
+#include "outputs/file_layout.hpp"
 #include "pgen.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -165,7 +169,7 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     nmhd = pmhd->nmhd + pmhd->nscalars;
   }
   if (prad != nullptr) {
-    nrad = prad->prgeo->nangles;
+    nrad = prad->nvar;
   }
   if (pz4c != nullptr) {
     nz4c = pz4c->nz4c;
@@ -243,6 +247,99 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
 #endif
   IOWrapperSizeT data_size;
   std::memcpy(&data_size, &(variabledata[0]), sizeof(IOWrapperSizeT));
+  delete [] variabledata;
+
+  // Data size of 0 marks a delta restart file (see restart.cpp).  Root process reads
+  // true data size, offset of data and name of full restart file it references, and
+  // list of gids of MeshBlocks stored in delta file, and broadcasts them.
+  bool delta = (data_size == 0);
+  IOWrapperSizeT base_offset = 0;
+  std::string base_fname;
+  std::vector<int> delta_gids;
+  if (delta) {
+    int len = 0, ndelta = 0;
+    if (global_variable::my_rank == 0) {
+      IOWrapperSizeT sizes[2];
+      if (resfile.Read_bytes(sizes, sizeof(IOWrapperSizeT), 2) != 2 ||
+          resfile.Read_bytes(&len, sizeof(int), 1) != 1) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Delta restart header not read correctly, restart "
+                  << "file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      data_size = sizes[0];
+      base_offset = sizes[1];
+      base_fname.resize(len);
+      resfile.Read_bytes(&(base_fname[0]), 1, len);
+      resfile.Read_bytes(&ndelta, sizeof(int), 1);
+      delta_gids.resize(ndelta);
+      if (resfile.Read_bytes(delta_gids.data(), sizeof(int), ndelta) !=
+          static_cast<std::size_t>(ndelta)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Delta restart header not read correctly, restart "
+                  << "file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+#if MPI_PARALLEL_ENABLED
+    MPI_Bcast(&data_size, sizeof(IOWrapperSizeT), MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&base_offset, sizeof(IOWrapperSizeT), MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&ndelta, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    base_fname.resize(len);
+    delta_gids.resize(ndelta);
+    MPI_Bcast(&(base_fname[0]), len, MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Bcast(delta_gids.data(), ndelta, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+  }
+
+  // Reduced restart files (see restart.cpp) contain a subset of modules, possibly stored
+  // as float.  Root process reads true data size, size of values, and modules in file.
+  bool soft = (data_size == file_layout::kRestartSoftMarker);
+  std::int32_t vsize = sizeof(Real), mods = file_layout::kRestartAll;
+  if (soft) {
+    if (global_variable::my_rank == 0) {
+      if (resfile.Read_bytes(&data_size, sizeof(IOWrapperSizeT), 1) != 1 ||
+          resfile.Read_bytes(&vsize, sizeof(std::int32_t), 1) != 1 ||
+          resfile.Read_bytes(&mods, sizeof(std::int32_t), 1) != 1) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "Reduced restart header not read correctly, restart "
+                  << "file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+#if MPI_PARALLEL_ENABLED
+    MPI_Bcast(&data_size, sizeof(IOWrapperSizeT), MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&vsize, 1, MPI_INT32_T, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&mods, 1, MPI_INT32_T, 0, MPI_COMM_WORLD);
+#endif
+    if (vsize != sizeof(float) && vsize != sizeof(Real)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Size of values in reduced restart file (" << vsize
+                << " bytes) is not supported" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  bool in_hydro = (phydro != nullptr) && (mods & file_layout::kRestartHydro);
+  bool in_mhd = (pmhd != nullptr) && (mods & file_layout::kRestartMHD);
+  bool in_rad = (prad != nullptr) && (mods & file_layout::kRestartRad);
+  bool in_force = (pturb != nullptr) && (mods & file_layout::kRestartForce);
+  bool in_z4c = (pz4c != nullptr) && (mods & file_layout::kRestartZ4c);
+  bool in_adm = (pz4c == nullptr) && (padm != nullptr) &&
+                (mods & file_layout::kRestartADM);
+  if (soft && global_variable::my_rank == 0) {
+    std::string missing;
+    if (phydro != nullptr && !in_hydro) {missing += " hydro";}
+    if (pmhd != nullptr && !in_mhd) {missing += " mhd";}
+    if (prad != nullptr && !in_rad) {missing += " rad";}
+    if (pturb != nullptr && !in_force) {missing += " force";}
+    if (pz4c != nullptr && !in_z4c) {missing += " z4c";}
+    if (pz4c == nullptr && padm != nullptr && !in_adm) {missing += " adm";}
+    std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+              << "Restarting from reduced restart file with " << vsize << "-byte values"
+              << ((missing.empty())? "" : ", modules not in file:") << missing
+              << std::endl;
+  }
 
   // calculate total number of CC variables
   IOWrapperSizeT headeroffset;
@@ -255,26 +352,26 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
   MPI_Bcast(&headeroffset, sizeof(IOWrapperSizeT), MPI_CHAR, 0, MPI_COMM_WORLD);
 #endif
 
-  IOWrapperSizeT data_size_ = 0;
-  if (phydro != nullptr) {
-    data_size_ += nout1*nout2*nout3*nhydro*sizeof(Real); // hydro u0
+  IOWrapperSizeT data_size_ = 0, vbytes = vsize;
+  if (in_hydro) {
+    data_size_ += nout1*nout2*nout3*nhydro*vbytes; // hydro u0
   }
-  if (pmhd != nullptr) {
-    data_size_ += nout1*nout2*nout3*nmhd*sizeof(Real);   // mhd u0
-    data_size_ += (nout1+1)*nout2*nout3*sizeof(Real);    // mhd b0.x1f
-    data_size_ += nout1*(nout2+1)*nout3*sizeof(Real);    // mhd b0.x2f
-    data_size_ += nout1*nout2*(nout3+1)*sizeof(Real);    // mhd b0.x3f
+  if (in_mhd) {
+    data_size_ += nout1*nout2*nout3*nmhd*vbytes;   // mhd u0
+    data_size_ += (nout1+1)*nout2*nout3*vbytes;    // mhd b0.x1f
+    data_size_ += nout1*(nout2+1)*nout3*vbytes;    // mhd b0.x2f
+    data_size_ += nout1*nout2*(nout3+1)*vbytes;    // mhd b0.x3f
   }
-  if (prad != nullptr) {
-    data_size_ += nout1*nout2*nout3*nrad*sizeof(Real);   // rad i0
+  if (in_rad) {
+    data_size_ += nout1*nout2*nout3*nrad*vbytes;   // rad i0
   }
-  if (pturb != nullptr) {
-    data_size_ += nout1*nout2*nout3*nforce*sizeof(Real); // forcing
+  if (in_force) {
+    data_size_ += nout1*nout2*nout3*nforce*vbytes; // forcing
   }
-  if (pz4c != nullptr) {
-    data_size_ += nout1*nout2*nout3*nz4c*sizeof(Real);   // z4c u0
-  } else if (padm != nullptr) {
-    data_size_ += nout1*nout2*nout3*nadm*sizeof(Real);   // adm u_adm
+  if (in_z4c) {
+    data_size_ += nout1*nout2*nout3*nz4c*vbytes;   // z4c u0
+  } else if (in_adm) {
+    data_size_ += nout1*nout2*nout3*nadm*vbytes;   // adm u_adm
   }
 
   if (data_size_ != data_size) {
@@ -285,343 +382,162 @@ ProblemGenerator::ProblemGenerator(ParameterInput *pin, Mesh *pm, IOWrapper resf
     exit(EXIT_FAILURE);
   }
 
-  // read CC data into host array
+  // read CC data into host array.  Data in node-local restart files starts with the
+  // lowest gid of the ranks sharing the file.
   int mygids = pm->gids_eachrank[global_variable::my_rank];
-  IOWrapperSizeT offset_myrank = headeroffset + data_size_*mygids;
-  IOWrapperSizeT myoffset = offset_myrank;
+  int gid0 = mygids;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &gid0, 1, MPI_INT, MPI_MIN, resfile.GetCommunicator());
+#else
+  gid0 = 0;
+#endif
+  IOWrapperSizeT offset_myrank = headeroffset + data_size_*(mygids - gid0);
+
+  // Read data of all MeshBlocks on this rank, which is contiguous in the file, into a
+  // host buffer using a few large collective reads.  This lets MPI-IO aggregate requests
+  // over ranks (two-phase collective I/O) rather than making one small read per
+  // variable and MeshBlock.  Number of aggregators can be set with
+  // <job>/rst_read_aggregators (default 0 uses the MPI-IO default).  Reads are split
+  // into pieces of at most 2^30 bytes to stay below the 2^31 limit on counts.
+  int naggr = pin->GetOrAddInteger("job","rst_read_aggregators",0);
+  auto read_all = [](IOWrapper &file, char *pdata, IOWrapperSizeT nbytes,
+                     IOWrapperSizeT offset) {
+    const IOWrapperSizeT max_read = (static_cast<IOWrapperSizeT>(1) << 30);
+    int nreads = static_cast<int>((nbytes + max_read - 1)/max_read);
+#if MPI_PARALLEL_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &nreads, 1, MPI_INT, MPI_MAX, file.GetCommunicator());
+#endif
+    for (int n=0; n<nreads; ++n) {
+      IOWrapperSizeT os = std::min(nbytes, n*max_read);
+      IOWrapperSizeT cnt = std::min(max_read, nbytes - os);
+      if (file.Read_bytes_at_all(pdata + os, 1, cnt, offset + os) != cnt) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "MeshBlock data not read correctly from rst file, "
+                  << "restart file is broken." << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+  };
+  std::vector<char> rstdata(data_size*nmb);
+  if (!delta) {
+#if MPI_PARALLEL_ENABLED
+    resfile.SetCollectiveReadHints(naggr);
+#endif
+    read_all(resfile, rstdata.data(), rstdata.size(), offset_myrank);
+  } else {
+    // For delta restarts, read all MeshBlocks from full restart file, then overwrite
+    // those stored in delta file.  Changed MeshBlocks on this rank are contiguous in the
+    // delta file, since gids of MeshBlocks on each rank are contiguous.
+    IOWrapper basefile;
+    basefile.Open(base_fname.c_str(), IOWrapper::FileMode::read);
+#if MPI_PARALLEL_ENABLED
+    basefile.SetCollectiveReadHints(naggr);
+    resfile.SetCollectiveReadHints(naggr);
+#endif
+    read_all(basefile, rstdata.data(), rstdata.size(), base_offset + data_size*mygids);
+    basefile.Close();
+
+    auto first = std::lower_bound(delta_gids.begin(), delta_gids.end(), mygids);
+    auto last = std::lower_bound(delta_gids.begin(), delta_gids.end(), mygids + nmb);
+    int nchanged = std::distance(first, last);
+    std::vector<char> deltadata(data_size*nchanged);
+    read_all(resfile, deltadata.data(), deltadata.size(),
+             headeroffset + data_size*std::distance(delta_gids.begin(), first));
+    for (int n=0; n<nchanged; ++n) {
+      int m = *(first + n) - mygids;
+      std::memcpy(&(rstdata[m*data_size]), &(deltadata[n*data_size]), data_size);
+    }
+  }
+
+  // Unpack each variable from buffer into host arrays (one MeshBlock at a time, starting
+  // at byte offset "mboffset" within data of each MeshBlock), then copy to device.
+  // Values stored as float in reduced restarts are converted to Real.
+  IOWrapperSizeT mboffset = 0;
+  auto load = [vsize](Real *pdst, const char *psrc, IOWrapperSizeT cnt) {
+    if (vsize == sizeof(Real)) {
+      std::memcpy(pdst, psrc, cnt*sizeof(Real));
+    } else {
+      for (IOWrapperSizeT n=0; n<cnt; ++n) {
+        float val;
+        std::memcpy(&val, psrc + n*sizeof(float), sizeof(float));
+        pdst[n] = static_cast<Real>(val);
+      }
+    }
+  };
+  auto unpack = [&](Real *pdata, IOWrapperSizeT mbcnt) {
+    for (int m=0; m<nmb; ++m) {
+      load(pdata + m*mbcnt, &(rstdata[m*data_size + mboffset]), mbcnt);
+    }
+    mboffset += mbcnt*vsize;
+  };
 
   HostArray5D<Real> ccin("rst-cc-in", 1, 1, 1, 1, 1);
   HostFaceFld4D<Real> fcin("rst-fc-in", 1, 1, 1, 1);
 
-  // calculate max/min number of MeshBlocks across all ranks
-  int noutmbs_max = pm->nmb_eachrank[0];
-  int noutmbs_min = pm->nmb_eachrank[0];
-  for (int i=0; i<(global_variable::nranks); ++i) {
-    noutmbs_max = std::max(noutmbs_max,pm->nmb_eachrank[i]);
-    noutmbs_min = std::min(noutmbs_min,pm->nmb_eachrank[i]);
-  }
-
-  if (phydro != nullptr) {
+  if (in_hydro) {
     Kokkos::realloc(ccin, nmb, nhydro, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC hydro data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC hydro data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
+    unpack(ccin.data(), nout1*nout2*nout3*nhydro);
     Kokkos::deep_copy(Kokkos::subview(phydro->u0, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nhydro*sizeof(Real); // hydro u0
-    myoffset = offset_myrank;
   }
 
-  if (pmhd != nullptr) {
+  if (in_mhd) {
     Kokkos::realloc(ccin, nmb, nmhd, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                   Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC mhd data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC mhd data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
+    unpack(ccin.data(), nout1*nout2*nout3*nmhd);
     Kokkos::deep_copy(Kokkos::subview(pmhd->u0, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nmhd*sizeof(Real);   // mhd u0
-    myoffset = offset_myrank;
 
+    // x1f, x2f, x3f fields are stored one after another within each MeshBlock
     Kokkos::realloc(fcin.x1f, nmb, nout3, nout2, nout1+1);
     Kokkos::realloc(fcin.x2f, nmb, nout3, nout2+1, nout1);
     Kokkos::realloc(fcin.x3f, nmb, nout3+1, nout2, nout1);
-    // read FC data into host array, again one MeshBlock at a time
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to write, so write collectively
-      if (m < noutmbs_min) {
-        // get ptr to x1-face field
-        auto x1fptr = Kokkos::subview(fcin.x1f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        int fldcnt = x1fptr.size();
-
-        if (resfile.Read_Reals_at_all(x1fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x1f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x2-face field
-        auto x2fptr = Kokkos::subview(fcin.x2f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x2fptr.size();
-
-        if (resfile.Read_Reals_at_all(x2fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x2f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x3-face field
-        auto x3fptr = Kokkos::subview(fcin.x3f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x3fptr.size();
-
-        if (resfile.Read_Reals_at_all(x3fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x3f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        myoffset += data_size-(x1fptr.size()+x2fptr.size()+x3fptr.size())*sizeof(Real);
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to x1-face field
-        auto x1fptr = Kokkos::subview(fcin.x1f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        int fldcnt = x1fptr.size();
-
-        if (resfile.Read_Reals_at(x1fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x1f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x2-face field
-        auto x2fptr = Kokkos::subview(fcin.x2f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x2fptr.size();
-
-        if (resfile.Read_Reals_at(x2fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x2f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        // get ptr to x3-face field
-        auto x3fptr = Kokkos::subview(fcin.x3f, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL);
-        fldcnt = x3fptr.size();
-
-        if (resfile.Read_Reals_at(x3fptr.data(), fldcnt, myoffset) != fldcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                << std::endl << "Input b0.x3f field not read correctly from rst file, "
-                << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += fldcnt*sizeof(Real);
-
-        myoffset += data_size-(x1fptr.size()+x2fptr.size()+x3fptr.size())*sizeof(Real);
-      }
+    IOWrapperSizeT cnt1 = (nout1+1)*nout2*nout3;
+    IOWrapperSizeT cnt2 = nout1*(nout2+1)*nout3;
+    IOWrapperSizeT cnt3 = nout1*nout2*(nout3+1);
+    for (int m=0; m<nmb; ++m) {
+      char *pmb = &(rstdata[m*data_size + mboffset]);
+      load(fcin.x1f.data() + m*cnt1, pmb, cnt1);
+      pmb += cnt1*vsize;
+      load(fcin.x2f.data() + m*cnt2, pmb, cnt2);
+      pmb += cnt2*vsize;
+      load(fcin.x3f.data() + m*cnt3, pmb, cnt3);
     }
+    mboffset += (cnt1 + cnt2 + cnt3)*vsize;
     Kokkos::deep_copy(Kokkos::subview(pmhd->b0.x1f, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL), fcin.x1f);
     Kokkos::deep_copy(Kokkos::subview(pmhd->b0.x2f, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL), fcin.x2f);
     Kokkos::deep_copy(Kokkos::subview(pmhd->b0.x3f, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL), fcin.x3f);
-    offset_myrank += (nout1+1)*nout2*nout3*sizeof(Real);    // mhd b0.x1f
-    offset_myrank += nout1*(nout2+1)*nout3*sizeof(Real);    // mhd b0.x2f
-    offset_myrank += nout1*nout2*(nout3+1)*sizeof(Real);    // mhd b0.x3f
-    myoffset = offset_myrank;
   }
 
-  if (prad != nullptr) {
+  if (in_rad) {
     Kokkos::realloc(ccin, nmb, nrad, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC rad data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC rad data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
+    unpack(ccin.data(), nout1*nout2*nout3*nrad);
     Kokkos::deep_copy(Kokkos::subview(prad->i0, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nrad*sizeof(Real);   // radiation i0
-    myoffset = offset_myrank;
   }
 
-  if (pturb != nullptr) {
+  if (in_force) {
     Kokkos::realloc(ccin, nmb, nforce, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC turb data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC turb data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
+    unpack(ccin.data(), nout1*nout2*nout3*nforce);
     Kokkos::deep_copy(Kokkos::subview(pturb->force, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nforce*sizeof(Real); // forcing
-    myoffset = offset_myrank;
   }
 
-  if (pz4c != nullptr) {
+  if (in_z4c) {
     Kokkos::realloc(ccin, nmb, nz4c, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC z4c data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC z4c data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
+    unpack(ccin.data(), nout1*nout2*nout3*nz4c);
     Kokkos::deep_copy(Kokkos::subview(pz4c->u0, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nz4c*sizeof(Real);   // z4c u0
-    myoffset = offset_myrank;
 
     // We also need to reinitialize the ADM data.
     pz4c->Z4cToADM(pmy_mesh_->pmb_pack);
-  } else if (padm != nullptr) {
+  } else if (in_adm) {
     Kokkos::realloc(ccin, nmb, nadm, nout3, nout2, nout1);
-    for (int m=0;  m<noutmbs_max; ++m) {
-      // every rank has a MB to read, so read collectively
-      if (m < noutmbs_min) {
-        // get ptr to cell-centered MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at_all(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC adm data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-
-      // some ranks are finished writing, so use non-collective write
-      } else if (m < pm->nmb_thisrank) {
-        // get ptr to MeshBlock data
-        auto mbptr = Kokkos::subview(ccin, m, Kokkos::ALL, Kokkos::ALL, Kokkos::ALL,
-                                     Kokkos::ALL);
-        int mbcnt = mbptr.size();
-        if (resfile.Read_Reals_at(mbptr.data(), mbcnt, myoffset) != mbcnt) {
-          std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-                    << std::endl << "CC adm data not read correctly from rst file, "
-                    << "restart file is broken." << std::endl;
-          exit(EXIT_FAILURE);
-        }
-        myoffset += data_size;
-      }
-    }
+    unpack(ccin.data(), nout1*nout2*nout3*nadm);
     Kokkos::deep_copy(Kokkos::subview(padm->u_adm, std::make_pair(0,nmb), Kokkos::ALL,
                       Kokkos::ALL, Kokkos::ALL, Kokkos::ALL), ccin);
-    offset_myrank += nout1*nout2*nout3*nadm*sizeof(Real);   // adm u_adm
-    myoffset = offset_myrank;
   }
 
   // call problem generator again to re-initialize data, fn ptrs, as needed
@@ -20,6 +20,7 @@ using UserBoundaryFnPtr = void (*)(Mesh* pm);
 using UserSrctermFnPtr = void (*)(Mesh* pm, const Real bdt);
 using UserRefinementFnPtr = void (*)(MeshBlockPack* pmbp);
 using UserHistoryFnPtr = void (*)(HistoryData *pdata, Mesh *pm);
+using UserStaticFnPtr = void (*)(Mesh *pm, const int pass);
 
 //----------------------------------------------------------------------------------------
 //! \class ProblemGenerator
@@ -52,6 +53,9 @@ class ProblemGenerator {
   UserSrctermFnPtr user_srcs_func=nullptr;
   UserRefinementFnPtr user_ref_func=nullptr;
   UserHistoryFnPtr user_hist_func=nullptr;
+  // function pointer for work on frozen data with <time>/evolution=static.  Called by
+  // Driver::Execute() once per pass, after the "static" TaskList
+  UserStaticFnPtr user_static_func=nullptr;
 
   // predefined problem generator functions (default test suite)
   void Advection(ParameterInput *pin, const bool restart);
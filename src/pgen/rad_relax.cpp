@@ -17,6 +17,7 @@
 #include "hydro/hydro.hpp"
 #include "driver/driver.hpp"
 #include "radiation/radiation.hpp"
+#include "radiation/radiation_opacities.hpp"
 
 //----------------------------------------------------------------------------------------
 //! \fn void MeshBlock::UserProblem(ParameterInput *pin)
@@ -63,6 +64,34 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   auto &u0 = pmbp->phydro->u0;
   pmbp->phydro->peos->PrimToCons(w0, u0, 0, (n1-1), 0, (n2-1), 0, (n3-1));
 
+  // With M1, set E and F from fluid frame energy density erad and zero flux.  Groups
+  // are initialized with the Planck spectrum at the radiation temperature.
+  if (pmbp->prad->is_m1_enabled) {
+    auto &i0 = pmbp->prad->i0;
+    int ngroups = pmbp->prad->ngroups;
+    auto &nu_edge_ = pmbp->prad->nu_edge;
+    Real trad = sqrt(sqrt(erad/pmbp->prad->arad));
+    par_for("rad_relax_m1",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+    KOKKOS_LAMBDA(int m, int k, int j, int i) {
+      Real uu[4];
+      uu[1] = w0(m,IVX,k,j,i);
+      uu[2] = w0(m,IVY,k,j,i);
+      uu[3] = w0(m,IVZ,k,j,i);
+      uu[0] = sqrt(1.0 + SQR(uu[1]) + SQR(uu[2]) + SQR(uu[3]));
+      for (int g=0; g<ngroups; ++g) {
+        Real jr = erad;
+        if (ngroups > 1) {
+          jr *= PlanckGroupFraction(nu_edge_.d_view(g), nu_edge_.d_view(g+1), trad);
+        }
+        i0(m,IRE*ngroups+g,k,j,i) = jr*(4.0*SQR(uu[0]) - 1.0)/3.0;
+        i0(m,IRF1*ngroups+g,k,j,i) = (4.0/3.0)*jr*uu[0]*uu[1];
+        i0(m,IRF2*ngroups+g,k,j,i) = (4.0/3.0)*jr*uu[0]*uu[2];
+        i0(m,IRF3*ngroups+g,k,j,i) = (4.0/3.0)*jr*uu[0]*uu[3];
+      }
+    });
+    return;
+  }
+
   auto &norm_to_tet_ = pmbp->prad->norm_to_tet;
   auto &nh_c_ = pmbp->prad->nh_c;
   auto &tet_c_ = pmbp->prad->tet_c;
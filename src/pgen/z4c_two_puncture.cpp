@@ -24,7 +24,7 @@
 
 static ini_data *data;
 
-void ADMTwoPunctures(MeshBlockPack *pmbp, ini_data *data);
+void ADMTwoPunctures(MeshBlockPack *pmbp, ini_data *data, bool threaded);
 void RefinementCondition(MeshBlockPack* pmbp);
 
 //----------------------------------------------------------------------------------------
@@ -166,7 +166,7 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
     const_cast<char *>("swap_xz"),
     pin->GetOrAddBoolean(set_name, "swap_xz", 0));
   data = TwoPunctures_make_initial_data();
-  ADMTwoPunctures(pmbp, data);
+  ADMTwoPunctures(pmbp, data, pin->GetOrAddBoolean(set_name, "threaded_interp", false));
   pmbp->pz4c->GaugePreCollapsedLapse(pmbp, pin);
   switch (indcs.ng) {
     case 2:
@@ -194,7 +194,7 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
   return;
 }
 
-//! \fn void ADMTwoPunctures(MeshBlockPack *pmbp, ini_data *data)
+//! \fn void ADMTwoPunctures(MeshBlockPack *pmbp, ini_data *data, bool threaded)
 //! \brief Interpolate two puncture initial data in cartesian grid
 //
 // p  = detgbar^(-1/3)
@@ -209,7 +209,7 @@ void ProblemGenerator::UserProblem(ParameterInput *pin, const bool restart) {
 //
 // G^i = - del_j gtildeinv^ji
 //
-void ADMTwoPunctures(MeshBlockPack *pmbp, ini_data *data) {
+void ADMTwoPunctures(MeshBlockPack *pmbp, ini_data *data, bool threaded) {
   // capture variables for the kernel
   auto &u_adm = pmbp->padm->u_adm;
 
@@ -240,7 +240,8 @@ void ADMTwoPunctures(MeshBlockPack *pmbp, ini_data *data) {
   int ncells2 = indcs.nx2 + 2 * (indcs.ng);
   int ncells3 = indcs.nx3 + 2 * (indcs.ng);
   int nmb     = pmbp->nmb_thispack;
-  for (int m = 0; m < nmb; ++m) {
+  // evaluate spectral solution at all cells of MeshBlock m
+  auto eval_mb = [&](const int m) {
     int imin[3] = {0, 0, 0};
 
     int n[3] = {ncells1, ncells2, ncells3};
@@ -363,6 +364,20 @@ void ADMTwoPunctures(MeshBlockPack *pmbp, ini_data *data) {
     delete[] x;
     delete[] y;
     delete[] z;
+  };
+
+  // Evaluating the expansion at every cell dominates the setup time on large grids (each
+  // rank only evaluates its own MeshBlocks).  With threaded_interp, MeshBlocks are
+  // evaluated concurrently by the threads of the host execution space, which requires
+  // TwoPunctures_Cartesian_interpolation() to be thread-safe.
+  if (threaded) {
+    Kokkos::parallel_for("TwoPuncturesInterp",
+      Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, nmb), eval_mb);
+    Kokkos::DefaultHostExecutionSpace().fence();
+  } else {
+    for (int m = 0; m < nmb; ++m) {
+      eval_mb(m);
+    }
   }
   Kokkos::deep_copy(u_adm, host_u_adm);
   return;
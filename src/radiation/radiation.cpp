@@ -8,6 +8,8 @@
 
 #include <float.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <string>
 
@@ -20,6 +22,8 @@
 #include "coordinates/coordinates.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "units/units.hpp"
+#include "hydro/hydro.hpp"
+#include "mhd/mhd.hpp"
 #include "radiation/radiation.hpp"
 
 namespace radiation {
@@ -32,6 +36,8 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     i1("i1",1,1,1,1,1),
     iflx("iflx",1,1,1,1,1),
     divfa("divfa",1,1,1,1,1),
+    nu_edge("nu_edge",1),
+    group_kappa("group_kappa",1,1),
     nh_c("nh_c",1,1),
     nh_f("nh_f",1,1,1),
     tet_c("tet_c",1,1,1,1,1,1),
@@ -41,6 +47,8 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     tet_d3_x3f("tet_d3_x3f",1,1,1,1,1),
     na("na",1,1,1,1,1,1),
     norm_to_tet("norm_to_tet",1,1,1,1,1,1),
+    nface("nface",1,1,1,1,1),
+    inv_n0("inv_n0",1,1,1,1),
     beam_mask("beam_mask",1,1,1,1,1) {
   // Check for general relativity
   if (!(pmy_pack->pcoord->is_general_relativistic)) {
@@ -82,7 +90,16 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   if (rad_source) {
     kappa_s = pin->GetReal("radiation","kappa_s");
     power_opacity = pin->GetOrAddBoolean("radiation","power_opacity",false);
-    if (!(power_opacity)) {
+    table_opacity = pin->DoesParameterExist("radiation","opacity_table");
+    if (table_opacity) {
+      if (power_opacity) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "<radiation>/power_opacity and <radiation>/opacity_table "
+          << "cannot both be used" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      ReadOpacityTable(pin->GetString("radiation","opacity_table"));
+    } else if (!(power_opacity)) {
       kappa_a = pin->GetReal("radiation","kappa_a");
       kappa_p = pin->GetReal("radiation","kappa_p");
     }
@@ -105,20 +122,127 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   // Check for fluid evolution
   fixed_fluid = pin->GetOrAddBoolean("radiation","fixed_fluid",false);
 
+  // Reduced speed of light
+  c_hat = pin->GetOrAddReal("radiation","c_hat",1.0);
+  if (c_hat <= 0.0 || c_hat > 1.0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<radiation>/c_hat must be in (0,1]" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  if (c_hat < 1.0 && rad_source && is_compton_enabled) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "Compton scattering requires <radiation>/c_hat=1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // Select method: discrete ordinates (default), or two-moment (M1) closure which
+  // evolves only the energy density and flux of each group in flat spacetime
+  {std::string method = pin->GetOrAddString("radiation","method","ordinates");
+  if (method.compare("ordinates") == 0) {
+    is_m1_enabled = false;
+  } else if (method.compare("m1") == 0) {
+    is_m1_enabled = true;
+  } else {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<radiation> method = '" << method << "' not implemented"
+      << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  }
+
   // Other rad source terms (constructor parses input file to init only srcterms needed)
   beam_source = pin->GetOrAddBoolean("radiation","beam_source",false);
   psrc = new SourceTerms("radiation", ppack, pin);
 
-  // Setup angular mesh and radiation geometry data
-  int nlevel = pin->GetInteger("radiation", "nlevel");
+  if (is_m1_enabled) {
+    if (!(pmy_pack->pcoord->coord_data.is_minkowski)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "M1 radiation requires flat spacetime (<coord>/minkowski=true)"
+        << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (beam_source || (rad_source && is_compton_enabled)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Beam source and Compton scattering require "
+        << "<radiation>/method=ordinates" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    m1_efloor = pin->GetOrAddReal("radiation","m1_efloor",1.0e-20);
+  }
+
+  // Setup angular mesh and radiation geometry data.  With M1 the angular mesh is not
+  // used to evolve the radiation, and defaults to one angle per octant.
+  int nlevel = (is_m1_enabled)? pin->GetOrAddInteger("radiation","nlevel",0) :
+                                pin->GetInteger("radiation", "nlevel");
   rotate_geo = pin->GetOrAddBoolean("radiation","rotate_geo",true);
   angular_fluxes = pin->GetOrAddBoolean("radiation","angular_fluxes",true);
+  if (is_m1_enabled) {angular_fluxes = false;}
   n_0_floor = pin->GetOrAddReal("radiation","n_0_floor",0.1);
   prgeo = new GeodesicGrid(nlevel, rotate_geo, angular_fluxes);
 
+  // Frequency groups (default one, i.e. grey radiation).  Interior group edges are
+  // log-spaced between nu_min and nu_max (h nu/k in temperature units), with the first
+  // group extending to zero and the last to infinite frequency.  Opacities of group g
+  // default to the grey values, and can be set with kappa_a_<g>, kappa_s_<g>, and
+  // kappa_p_<g>.
+  ngroups = pin->GetOrAddInteger("radiation","ngroups",1);
+  if (ngroups < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "<radiation>/ngroups must be >= 1" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  nvar = (is_m1_enabled)? 4*ngroups : prgeo->nangles*ngroups;
+  Kokkos::realloc(nu_edge, ngroups+1);
+  Kokkos::realloc(group_kappa, ngroups, 3);
+  nu_edge.h_view(0) = 0.0;
+  nu_edge.h_view(ngroups) = FLT_MAX;
+  if (ngroups > 1) {
+    Real nu_min = pin->GetReal("radiation","nu_min");
+    Real nu_max = (ngroups > 2)? pin->GetReal("radiation","nu_max") : nu_min;
+    if (nu_min <= 0.0 || nu_max < nu_min) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "<radiation>/nu_min and nu_max must satisfy "
+        << "0 < nu_min <= nu_max" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    for (int g=1; g<ngroups; ++g) {
+      Real frac = (ngroups > 2)? static_cast<Real>(g-1)/(ngroups-2) : 0.0;
+      nu_edge.h_view(g) = nu_min*std::pow(nu_max/nu_min, frac);
+    }
+    if (rad_source && is_compton_enabled) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Compton scattering requires <radiation>/ngroups=1" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (beam_source) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Beam source requires <radiation>/ngroups=1" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  for (int g=0; g<ngroups; ++g) {
+    Real k_a = 0.0, k_s = 0.0, k_p = 0.0;
+    if (rad_source) {
+      std::string gs = std::to_string(g);
+      k_s = pin->GetOrAddReal("radiation","kappa_s_"+gs,kappa_s);
+      if (!(power_opacity) && !(table_opacity)) {
+        k_a = pin->GetOrAddReal("radiation","kappa_a_"+gs,kappa_a);
+        k_p = pin->GetOrAddReal("radiation","kappa_p_"+gs,kappa_p);
+      }
+    }
+    group_kappa.h_view(g,0) = k_a;
+    group_kappa.h_view(g,1) = k_s;
+    group_kappa.h_view(g,2) = k_p;
+  }
+  nu_edge.template modify<HostMemSpace>();
+  nu_edge.template sync<DevExeSpace>();
+  group_kappa.template modify<HostMemSpace>();
+  group_kappa.template sync<DevExeSpace>();
+
   int nmb = ppack->nmb_thispack;
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  {
+  // tetrads are trivial in the flat spacetime required by M1, and are not stored
+  if (!(is_m1_enabled)) {
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
   int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
   int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
@@ -129,12 +253,36 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   Kokkos::realloc(tet_d1_x1f,nmb,4,ncells3,ncells2,ncells1+1);
   Kokkos::realloc(tet_d2_x2f,nmb,4,ncells3,ncells2+1,ncells1);
   Kokkos::realloc(tet_d3_x3f,nmb,4,ncells3+1,ncells2,ncells1);
-  if (angular_fluxes) {Kokkos::realloc(na,nmb,prgeo->nangles,ncells3,ncells2,ncells1,6);}
+  // n^a is the largest geometric array (6 per angle per cell).  With store_na=false it
+  // is recomputed from the analytic metric in the angular flux kernel instead.
+  store_na = pin->GetOrAddBoolean("radiation","store_na",true);
+  if (angular_fluxes && store_na) {
+    Kokkos::realloc(na,nmb,prgeo->nangles,ncells3,ncells2,ncells1,6);
+  }
   if (is_hydro_enabled || is_mhd_enabled) {
     Kokkos::realloc(norm_to_tet,nmb,4,4,ncells3,ncells2,ncells1);
   }
-  }
   SetOrthonormalTetrad();
+  }
+
+  // Optionally cache n^i at faces and 1/n_0 (the metric is stationary, so these only
+  // change with the mesh), at the cost of storage equal to that of the fluxes
+  cache_face_normals = pin->GetOrAddBoolean("radiation","cache_face_normals",false);
+  if (is_m1_enabled) {cache_face_normals = false;}
+  if (cache_face_normals) {
+    int ncells1 = indcs.nx1 + 2*(indcs.ng);
+    int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
+    int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
+    Kokkos::realloc(nface.x1f,nmb,prgeo->nangles,ncells3,ncells2,ncells1+1);
+    if (pmy_pack->pmesh->multi_d) {
+      Kokkos::realloc(nface.x2f,nmb,prgeo->nangles,ncells3,ncells2+1,ncells1);
+    }
+    if (pmy_pack->pmesh->three_d) {
+      Kokkos::realloc(nface.x3f,nmb,prgeo->nangles,ncells3+1,ncells2,ncells1);
+    }
+    Kokkos::realloc(inv_n0,nmb,ncells3,ncells2,ncells1);
+    SetFaceNormals();
+  }
 
   // (3) read time-evolution option [already error checked in driver constructor]
   // Then initialize memory and algorithms for reconstruction and Riemann solvers
@@ -145,7 +293,7 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
   int ncells1 = indcs.nx1 + 2*(indcs.ng);
   int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
   int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-  Kokkos::realloc(i0,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+  Kokkos::realloc(i0,nmb,nvar,ncells3,ncells2,ncells1);
   }
 
   // allocate memory for conserved variables on coarse mesh
@@ -154,12 +302,36 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     int nccells1 = indcs.cnx1 + 2*(indcs.ng);
     int nccells2 = (indcs.cnx2 > 1)? (indcs.cnx2 + 2*(indcs.ng)) : 1;
     int nccells3 = (indcs.cnx3 > 1)? (indcs.cnx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(coarse_i0,nmb,prgeo->nangles,nccells3,nccells2,nccells1);
+    Kokkos::realloc(coarse_i0,nmb,nvar,nccells3,nccells2,nccells1);
   }
 
   // allocate boundary buffers for conserved (cell-centered) variables
+  // With coalesce_halo, conserved fluid variables are appended to intensities in the
+  // same buffers, so that both are packed in one kernel and sent in one message.
+  coalesce_halo = pin->GetOrAddBoolean("radiation", "coalesce_halo", false);
+  if (fixed_fluid || (!(is_hydro_enabled) && !(is_mhd_enabled))) {coalesce_halo = false;}
+  nvar_halo = nvar;
+  if (coalesce_halo) {
+    if (ppack->pmhd != nullptr) {
+      nvar_halo += ppack->pmhd->u0.extent_int(1);
+      ppack->pmhd->coalesced_u = true;
+    } else {
+      nvar_halo += ppack->phydro->u0.extent_int(1);
+      ppack->phydro->coalesced_u = true;
+    }
+  }
   pbval_i = new MeshBoundaryValuesCC(ppack, pin, false);
-  pbval_i->InitializeBuffers(prgeo->nangles);
+  pbval_i->lowp_vars = pin->GetOrAddBoolean("radiation", "lowp_halo", false);
+  if (pin->GetOrAddBoolean("radiation", "trim_halo", false)) {
+    // fluid variables sent in same buffers need ghost zones of fluid stencil
+    int depth = pbval_i->StencilHaloDepth(pin, "radiation");
+    if (coalesce_halo) {
+      std::string fblock = (ppack->pmhd != nullptr) ? "mhd" : "hydro";
+      depth = std::max(depth, pbval_i->StencilHaloDepth(pin, fblock));
+    }
+    pbval_i->halo_depth = depth;
+  }
+  pbval_i->InitializeBuffers(nvar_halo);
 
   // for time-evolving problems, continue to construct methods, allocate arrays
   if (evolution_t.compare("stationary") != 0) {
@@ -194,16 +366,37 @@ Radiation::Radiation(MeshBlockPack *ppack, ParameterInput *pin) :
     }
     }
 
+    // Intensities that only flow out of a MeshBlock across a face are not upwinded from
+    // its ghost zones there, so fewer ghost zones of these can be sent (uniform grids)
+    if (pin->GetOrAddBoolean("radiation","upwind_halo",false) && !(is_m1_enabled)) {
+      SetUpwindHalo();
+    }
+
+    // Fuse x1-flux, angular flux, and update kernels.  Only possible when the update of
+    // each MB depends only on its own fluxes (no flux correction at fine/coarse
+    // boundaries), and when n^a is stored (rather than recomputed for every angle).
+    if (pin->GetOrAddBoolean("radiation","fused_update",false)) {
+      fused_update = !(is_m1_enabled) && !(pmy_pack->pmesh->multilevel) &&
+                     (!(angular_fluxes) || store_na);
+    }
+
     // allocate second registers, fluxes, masks
     int ncells1 = indcs.nx1 + 2*(indcs.ng);
     int ncells2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*(indcs.ng)) : 1;
     int ncells3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*(indcs.ng)) : 1;
-    Kokkos::realloc(i1,      nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x1f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x2f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    Kokkos::realloc(iflx.x3f,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
-    if (angular_fluxes) {
-      Kokkos::realloc(divfa,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
+    Kokkos::realloc(i1,      nmb,nvar,ncells3,ncells2,ncells1);
+    if (!(fused_update)) {
+      Kokkos::realloc(iflx.x1f,nmb,nvar,ncells3,ncells2,ncells1);
+    }
+    // x2/x3-fluxes are only computed and used in multi-D and 3D respectively
+    if (pmy_pack->pmesh->multi_d) {
+      Kokkos::realloc(iflx.x2f,nmb,nvar,ncells3,ncells2,ncells1);
+    }
+    if (pmy_pack->pmesh->three_d) {
+      Kokkos::realloc(iflx.x3f,nmb,nvar,ncells3,ncells2,ncells1);
+    }
+    if (angular_fluxes && !(fused_update)) {
+      Kokkos::realloc(divfa,nmb,nvar,ncells3,ncells2,ncells1);
     }
     if (beam_source) {
       Kokkos::realloc(beam_mask,nmb,prgeo->nangles,ncells3,ncells2,ncells1);
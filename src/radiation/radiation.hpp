@@ -16,6 +16,7 @@
 #include "parameter_input.hpp"
 #include "tasklist/task_list.hpp"
 #include "bvals/bvals.hpp"
+#include "radiation_opacities.hpp"
 
 // forward declarations
 class EquationOfState;
@@ -66,7 +67,9 @@ struct RadiationTaskIDs {
   TaskID rad_prol;
   TaskID mhd_prol;
   TaskID hyd_prol;
+  TaskID mhd_c2pa;
   TaskID mhd_c2p;
+  TaskID hyd_c2pa;
   TaskID hyd_c2p;
   TaskID rad_csend;
   TaskID mhd_csend;
@@ -100,12 +103,34 @@ class Radiation {
   Real kappa_s;             // constant scattering coefficient
   Real kappa_p;             // Planck - Rosseland mean coefficient
   bool power_opacity;       // flag to enable Kramer's law opacity for kappa_a
+  bool table_opacity;       // flag to enable tabulated Rosseland/Planck opacities
+  OpacityTable opacity_table;  // tabulated opacities, if enabled
+  void ReadOpacityTable(std::string fname);
   bool is_compton_enabled;  // flag to enable/disable compton
 
+  // reduced speed of light (in units of c) for non-relativistic radiation hydrodynamics.
+  // Radiation transport and coupling proceed at c_hat, which increases the radiation
+  // timestep by 1/c_hat and rescales the exchange with the fluid (1 for no reduction).
+  Real c_hat;
+
+  // Two-moment (M1) method, selected with <radiation>/method=m1 instead of discrete
+  // ordinates.  The variables of group g are stored at index c*ngroups + g of i0, where
+  // c is one of IRE, IRF1, IRF2, IRF3 (radiation energy density and flux).
+  bool is_m1_enabled;
+  Real m1_efloor;           // floor on radiation energy density with M1
+
   // Extra physics (i.e., other srcterms)
   bool beam_source;
   SourceTerms *psrc = nullptr;
 
+  // Frequency groups.  The intensity of group g in angle n is stored at index
+  // n*ngroups + g of i0, so that all groups of an angle are adjacent.
+  int ngroups;                        // number of frequency groups (1 for grey)
+  int nvar;                           // number of intensities per cell (nangles*ngroups)
+                                      // (or of M1 variables, 4*ngroups)
+  DualArray1D<Real> nu_edge;          // group edges h nu/k, in units of temperature
+  DualArray2D<Real> group_kappa;      // kappa_a, kappa_s, kappa_p in each group
+
   // Angular mesh
   bool rotate_geo;                    // rotate geodesic mesh
   bool angular_fluxes;                // flag to enable/disable angular fluxes
@@ -120,16 +145,35 @@ class Radiation {
   DvceArray5D<Real> tet_d1_x1f;       // tetrad components (subset) at x1f
   DvceArray5D<Real> tet_d2_x2f;       // tetrad components (subset) at x2f
   DvceArray5D<Real> tet_d3_x3f;       // tetrad components (subset) at x3f
-  DvceArray6D<Real> na;               // n^a
+  DvceArray6D<Real> na;               // n^a (only allocated when store_na)
+  bool store_na;                      // false to recompute n^a from metric in kernels
   DvceArray6D<Real> norm_to_tet;      // used in transform b/w normal frame and tet frame
   void SetOrthonormalTetrad();
 
+  // n^i at faces for all angles, and 1/n_0 at cell centers, cached for static metrics
+  bool cache_face_normals;
+  DvceFaceFld5D<Real> nface;
+  DvceArray4D<Real> inv_n0;
+  void SetFaceNormals();
+
+  // restriction and prolongation of intensities in angle, to/from a coarser angular grid
+  void RestrictAngles(GeodesicGrid *pcoarse, const DvceArray5D<Real> &ifine,
+                      DvceArray5D<Real> &icoarse);
+  void ProlongAngles(GeodesicGrid *pcoarse, const DvceArray5D<Real> &icoarse,
+                     DvceArray5D<Real> &ifine);
+
   // intensity arrays
   DvceArray5D<Real> i0;         // intensities
   DvceArray5D<Real> coarse_i0;  // intensities on 2x coarser grid (for SMR/AMR)
 
   // Boundary communication buffers and functions for i
   MeshBoundaryValuesCC *pbval_i;
+  // flag to send conserved fluid variables in same buffers (and messages) as i
+  bool coalesce_halo;
+  int nvar_halo;       // number of variables in pbval_i buffers
+  // send intensities leaving neighbors across faces with fewer ghost zones
+  void SetUpwindHalo();
+  CCFieldList HaloFields();
 
   // following only used for time-evolving flow
   DvceArray5D<Real> i1;         // intensity at intermediate step
@@ -137,6 +181,9 @@ class Radiation {
   DvceArray5D<Real> divfa;      // angular flux divergence
   DvceArray5D<bool> beam_mask;  // boolean mask used for beam source term
   Real dtnew;
+  // x1-flux, angular flux, and RK update computed in one kernel (within CalculateFluxes),
+  // so x1-fluxes and angular flux divergences are not stored
+  bool fused_update = false;
 
   // reconstruction method
   ReconstructionMethod recon_method;
@@ -165,6 +212,12 @@ class Radiation {
   TaskStatus ClearSend(Driver *d, int stage);
   TaskStatus ClearRecv(Driver *d, int stage);
 
+  // M1 versions of stagen_tl tasks, called from CalculateFluxes, RKUpdate, and
+  // AddRadiationSourceTerm when is_m1_enabled
+  TaskStatus M1Fluxes(Driver *d, int stage);
+  TaskStatus M1RKUpdate(Driver *d, int stage);
+  TaskStatus M1SourceTerm(Driver *d, int stage);
+
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Radiation
 };
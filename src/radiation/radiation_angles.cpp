@@ -0,0 +1,98 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file radiation_angles.cpp
+//! \brief transfer of intensities between the angular grid of Radiation (prgeo) and a
+//! coarser GeodesicGrid, i.e. restriction and prolongation in angle.  Both operate on
+//! the tetrad-frame intensity I = i0/(n^0 n_0) and conserve sum(I*solid_angle) over each
+//! coarse angle and the fine angles mapped onto it by GeodesicGrid::AngleTransferMap().
+//! All frequency groups are transferred.  These are the building blocks for changing
+//! angular resolution between MeshBlocks; both arrays must have the same spatial size.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "radiation.hpp"
+
+namespace radiation {
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::RestrictAngles
+//! \brief Sets intensities icoarse on angles of pcoarse from intensities ifine on angles
+//! of prgeo, as the solid-angle weighted sum of the fine angles in each coarse angle.
+
+void Radiation::RestrictAngles(GeodesicGrid *pcoarse, const DvceArray5D<Real> &ifine,
+                               DvceArray5D<Real> &icoarse) {
+  DualArray1D<int> parent, offset, child;
+  prgeo->AngleTransferMap(pcoarse, parent, offset, child);
+  int nmb1 = ifine.extent_int(0) - 1;
+  int n3 = ifine.extent_int(2), n2 = ifine.extent_int(3), n1 = ifine.extent_int(4);
+  int nvc1 = pcoarse->nangles*ngroups - 1;
+  int ngroups_ = ngroups;
+  auto &tt = tet_c;
+  auto &tc = tetcov_c;
+  auto &nh_c_ = nh_c;
+  auto &omega_f = prgeo->solid_angles;
+  auto &omega_c = pcoarse->solid_angles;
+  auto &pos_c = pcoarse->cart_pos;
+  par_for("rad_restrict_ang",DevExeSpace(),0,nmb1,0,nvc1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    int c = n/ngroups_;
+    int g = n - c*ngroups_;
+    Real n0 = tt(m,0,0,k,j,i);
+    Real sum = 0.0;
+    for (int l=offset.d_view(c); l<offset.d_view(c+1); ++l) {
+      int f = child.d_view(l);
+      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(f,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(f,1) +
+                 tc(m,2,0,k,j,i)*nh_c_.d_view(f,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(f,3);
+      sum += ifine(m,f*ngroups_+g,k,j,i)/(n0*n_0)*omega_f.d_view(f);
+    }
+    Real n_0c = tc(m,0,0,k,j,i) + tc(m,1,0,k,j,i)*pos_c.d_view(c,0) +
+                tc(m,2,0,k,j,i)*pos_c.d_view(c,1) + tc(m,3,0,k,j,i)*pos_c.d_view(c,2);
+    icoarse(m,n,k,j,i) = n0*n_0c*sum/omega_c.d_view(c);
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::ProlongAngles
+//! \brief Sets intensities ifine on angles of prgeo from intensities icoarse on angles of
+//! pcoarse.  The intensity of each coarse angle is copied to the fine angles mapped onto
+//! it, rescaled so that the solid-angle weighted sum is unchanged.
+
+void Radiation::ProlongAngles(GeodesicGrid *pcoarse, const DvceArray5D<Real> &icoarse,
+                              DvceArray5D<Real> &ifine) {
+  DualArray1D<int> parent, offset, child;
+  prgeo->AngleTransferMap(pcoarse, parent, offset, child);
+  int nmb1 = ifine.extent_int(0) - 1;
+  int n3 = ifine.extent_int(2), n2 = ifine.extent_int(3), n1 = ifine.extent_int(4);
+  int nvar1 = nvar - 1;
+  int ngroups_ = ngroups;
+  auto &tt = tet_c;
+  auto &tc = tetcov_c;
+  auto &nh_c_ = nh_c;
+  auto &omega_f = prgeo->solid_angles;
+  auto &omega_c = pcoarse->solid_angles;
+  auto &pos_c = pcoarse->cart_pos;
+  par_for("rad_prolong_ang",DevExeSpace(),0,nmb1,0,nvar1,0,(n3-1),0,(n2-1),0,(n1-1),
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    int f = n/ngroups_;
+    int g = n - f*ngroups_;
+    int c = parent.d_view(f);
+    Real omega_sum = 0.0;
+    for (int l=offset.d_view(c); l<offset.d_view(c+1); ++l) {
+      omega_sum += omega_f.d_view(child.d_view(l));
+    }
+    Real n0 = tt(m,0,0,k,j,i);
+    Real n_0c = tc(m,0,0,k,j,i) + tc(m,1,0,k,j,i)*pos_c.d_view(c,0) +
+                tc(m,2,0,k,j,i)*pos_c.d_view(c,1) + tc(m,3,0,k,j,i)*pos_c.d_view(c,2);
+    Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(f,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(f,1) +
+               tc(m,2,0,k,j,i)*nh_c_.d_view(f,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(f,3);
+    Real ic = icoarse(m,c*ngroups_+g,k,j,i)/(n0*n_0c);
+    ifine(m,n,k,j,i) = n0*n_0*ic*omega_c.d_view(c)/omega_sum;
+  });
+  return;
+}
+
+} // namespace radiation
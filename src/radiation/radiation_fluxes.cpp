@@ -10,21 +10,75 @@
 
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
+#include "coordinates/cartesian_ks.hpp"
 #include "coordinates/coordinates.hpp"
+#include "coordinates/cell_locations.hpp"
+#include "driver/driver.hpp"
 #include "eos/eos.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "radiation.hpp"
+#include "radiation_tetrad.hpp"
 #include "reconstruct/dc.hpp"
 #include "reconstruct/plm.hpp"
 #include "reconstruct/ppm.hpp"
 #include "reconstruct/wenoz.hpp"
 
 namespace radiation {
+//----------------------------------------------------------------------------------------
+//! \fn Real PrimIntensity()
+//! \brief Returns primitive intensity n_0 I = i0/n_0 in cell (m,n,k,j,i), using cached
+//! 1/n_0 when available.
+
+KOKKOS_INLINE_FUNCTION
+Real PrimIntensity(const DvceArray5D<Real> &i0, const DvceArray6D<Real> &tet_c,
+                   const DvceArray4D<Real> &inv_n0, const bool cached,
+                   const int m, const int n, const int k, const int j, const int i) {
+  return (cached)? i0(m,n,k,j,i)*inv_n0(m,k,j,i) : i0(m,n,k,j,i)/tet_c(m,0,0,k,j,i);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real UpwindIntensity()
+//! \brief Returns primitive intensity reconstructed at a face on the upwind side, given
+//! the sign of the normal component nf of the direction and the stencil iim3..iip2.
+
+KOKKOS_INLINE_FUNCTION
+Real UpwindIntensity(const int recon, const Real nf, const Real iim3, const Real iim2,
+                     const Real iim1, const Real iicc, const Real iip1, const Real iip2) {
+  Real iiu, scr;
+  switch (recon) {
+    case ReconstructionMethod::dc:
+      if (nf > 0.0) iiu = iim1;
+      else          iiu = iicc;
+      break;
+    case ReconstructionMethod::plm:
+      if (nf > 0.0) PLM(iim2, iim1, iicc, iiu, scr);
+      else          PLM(iim1, iicc, iip1, scr, iiu);
+      break;
+    case ReconstructionMethod::ppm4:
+      if (nf > 0.0) PPM4(iim3, iim2, iim1, iicc, iip1, iiu, scr);
+      else          PPM4(iim2, iim1, iicc, iip1, iip2, scr, iiu);
+      break;
+    case ReconstructionMethod::ppmx:
+      if (nf > 0.0) PPMX(iim3, iim2, iim1, iicc, iip1, iiu, scr);
+      else          PPMX(iim2, iim1, iicc, iip1, iip2, scr, iiu);
+      break;
+    case ReconstructionMethod::wenoz:
+      if (nf > 0.0) WENOZ(iim3, iim2, iim1, iicc, iip1, iiu, scr);
+      else          WENOZ(iim2, iim1, iicc, iip1, iip2, scr, iiu);
+      break;
+    default:
+      iiu = 0.0;
+      break;
+  }
+  return iiu;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn  void Radiation::CalculateFluxes
 //! \brief Compute radiation fluxes
 
 TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
+  if (is_m1_enabled) {return M1Fluxes(pdriver, stage);}
   RegionIndcs &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &ie = indcs.ie;
   int &js = indcs.js, &je = indcs.je;
@@ -37,180 +91,192 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
   auto &i0_ = i0;
   auto &nh_c_ = nh_c;
   auto &tet_c_ = tet_c;
+  // with cached face normals and 1/n_0 the flux kernels are a pure stencil over i0
+  const bool cached = cache_face_normals;
+  auto &inv_n0_ = inv_n0;
 
   //--------------------------------------------------------------------------------------
-  // i-direction
+  // Fluxes in each direction are computed with one team per (m,k,j) pencil of faces.
+  // Tetrad components on the faces and 1/n_0 in the cells of the stencil (which do not
+  // depend on angle) are loaded into scratch once per pencil, then teams loop over
+  // angles with vector lanes over i, so they are not reloaded nangles times per cell.
+  // Team threads run over all intensities n (angle n/ngroups, group n%ngroups), so that
+  // threads handling groups of the same angle share its direction and face normals.
+  int nvar_ = nvar;
+  int ngroups_ = ngroups;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+  // number of cells in the stencil on each side of a face
+  int nst = (recon_method_ > 1)? 3 : ((recon_method_ > 0)? 2 : 1);
+  int scr_level = global_variable::scratch_level;
+
+  //--------------------------------------------------------------------------------------
+  // i-direction (with fused_update, computed together with the update at the end)
 
   auto &t1d1 = tet_d1_x1f;
+  auto &nf1 = nface.x1f;
   auto &flx1 = iflx.x1f;
-  par_for("rflux_x1",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie+1,
-  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-    // calculate n^1 (hence determining upwinding direction)
-    Real n1 = t1d1(m,0,k,j,i)*nh_c_.d_view(n,0) + t1d1(m,1,k,j,i)*nh_c_.d_view(n,1)
-            + t1d1(m,2,k,j,i)*nh_c_.d_view(n,2) + t1d1(m,3,k,j,i)*nh_c_.d_view(n,3);
-
-    // convert to primitive n_0 I
-    Real iim1, iicc, iim2, iip1, iim3, iip2;
-    iim1 = i0_(m,n,k,j,i-1)/tet_c_(m,0,0,k,j,i-1);
-    iicc = i0_(m,n,k,j,i  )/tet_c_(m,0,0,k,j,i  );
-    if (recon_method_ > 0) {
-      iim2 = i0_(m,n,k,j,i-2)/tet_c_(m,0,0,k,j,i-2);
-      iip1 = i0_(m,n,k,j,i+1)/tet_c_(m,0,0,k,j,i+1);
-    }
-    if (recon_method_ > 1) {
-      iim3 = i0_(m,n,k,j,i-3)/tet_c_(m,0,0,k,j,i-3);
-      iip2 = i0_(m,n,k,j,i+2)/tet_c_(m,0,0,k,j,i+2);
-    }
+  size_t scr_size = ScrArray2D<Real>::shmem_size(4, ncells1+1)
+                  + ScrArray1D<Real>::shmem_size(ncells1);
+  if (!(fused_update)) {
+    par_for_outer("rflux_x1",DevExeSpace(),scr_size,scr_level,0,nmb1,ks,ke,js,je,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray2D<Real> tet(member.team_scratch(scr_level), 4, ncells1+1);
+      ScrArray1D<Real> rn0(member.team_scratch(scr_level), ncells1);
+      par_for_inner(member, 0, ncells1, [&](const int i) {
+        if (!(cached)) {
+          for (int d=0; d<4; ++d) {tet(d,i) = t1d1(m,d,k,j,i);}
+        }
+        if (i < ncells1) {
+          rn0(i) = (cached)? inv_n0_(m,k,j,i) : 1.0/tet_c_(m,0,0,k,j,i);
+        }
+      });
+      member.team_barrier();
 
-    // reconstruct primitive intensity
-    Real iiu, scr;
-    switch (recon_method_) {
-      case ReconstructionMethod::dc:
-        if (n1 > 0.0) iiu = iim1;
-        else          iiu = iicc;
-        break;
-      case ReconstructionMethod::plm:
-        if (n1 > 0.0) PLM(iim2, iim1, iicc, iiu, scr);
-        else          PLM(iim1, iicc, iip1, scr, iiu);
-        break;
-      case ReconstructionMethod::ppm4:
-        if (n1 > 0.0) PPM4(iim3, iim2, iim1, iicc, iip1, iiu, scr);
-        else          PPM4(iim2, iim1, iicc, iip1, iip2, scr, iiu);
-        break;
-      case ReconstructionMethod::ppmx:
-        if (n1 > 0.0) PPMX(iim3, iim2, iim1, iicc, iip1, iiu, scr);
-        else          PPMX(iim2, iim1, iicc, iip1, iip2, scr, iiu);
-        break;
-      case ReconstructionMethod::wenoz:
-        if (n1 > 0.0) WENOZ(iim3, iim2, iim1, iicc, iip1, iiu, scr);
-        else          WENOZ(iim2, iim1, iicc, iip1, iip2, scr, iiu);
-        break;
-      default:
-        break;
-    }
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nvar_), [&](const int n) {
+        const int a = n/ngroups_;
+        Real nh0 = nh_c_.d_view(a,0), nh1 = nh_c_.d_view(a,1);
+        Real nh2 = nh_c_.d_view(a,2), nh3 = nh_c_.d_view(a,3);
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(member, is, ie+2),
+        [&](const int i) {
+          // calculate n^1 (hence determining upwinding direction)
+          Real n1 = (cached)? nf1(m,a,k,j,i) :
+                    (tet(0,i)*nh0 + tet(1,i)*nh1 + tet(2,i)*nh2 + tet(3,i)*nh3);
+
+          // convert to primitive n_0 I
+          Real iim3 = 0.0, iim2 = 0.0, iip1 = 0.0, iip2 = 0.0;
+          Real iim1 = i0_(m,n,k,j,i-1)*rn0(i-1);
+          Real iicc = i0_(m,n,k,j,i  )*rn0(i  );
+          if (nst > 1) {
+            iim2 = i0_(m,n,k,j,i-2)*rn0(i-2);
+            iip1 = i0_(m,n,k,j,i+1)*rn0(i+1);
+          }
+          if (nst > 2) {
+            iim3 = i0_(m,n,k,j,i-3)*rn0(i-3);
+            iip2 = i0_(m,n,k,j,i+2)*rn0(i+2);
+          }
 
-    // compute x1flux
-    flx1(m,n,k,j,i) = n1*iiu;
-  });
+          // reconstruct primitive intensity and compute x1flux
+          flx1(m,n,k,j,i) = n1*UpwindIntensity(recon_method_, n1, iim3, iim2, iim1, iicc,
+                                               iip1, iip2);
+        });
+      });
+    });
+  }
 
   //--------------------------------------------------------------------------------------
-  // j-direction
+  // j-direction.  Scratch holds 1/n_0 in rows j-nst..j+nst-1 of the stencil.
 
   if (pmy_pack->pmesh->multi_d) {
     auto &t2d2 = tet_d2_x2f;
+    auto &nf2 = nface.x2f;
     auto &flx2 = iflx.x2f;
-    par_for("rflux_x2",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je+1,is,ie,
-    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-      // calculate n^2 (hence determining upwinding direction)
-      Real n2 = t2d2(m,0,k,j,i)*nh_c_.d_view(n,0) + t2d2(m,1,k,j,i)*nh_c_.d_view(n,1)
-              + t2d2(m,2,k,j,i)*nh_c_.d_view(n,2) + t2d2(m,3,k,j,i)*nh_c_.d_view(n,3);
-
-      // convert to primitive n_0 I
-      Real iim1, iicc, iim2, iip1, iim3, iip2;
-      iim1 = i0_(m,n,k,j-1,i)/tet_c_(m,0,0,k,j-1,i);
-      iicc = i0_(m,n,k,j  ,i)/tet_c_(m,0,0,k,j  ,i);
-      if (recon_method_ > 0) {
-        iim2 = i0_(m,n,k,j-2,i)/tet_c_(m,0,0,k,j-2,i);
-        iip1 = i0_(m,n,k,j+1,i)/tet_c_(m,0,0,k,j+1,i);
-      }
-      if (recon_method_ > 1) {
-        iim3 = i0_(m,n,k,j-3,i)/tet_c_(m,0,0,k,j-3,i);
-        iip2 = i0_(m,n,k,j+2,i)/tet_c_(m,0,0,k,j+2,i);
-      }
-
-      // reconstruct primitive intensity
-      Real iiu, scr;
-      switch (recon_method_) {
-        case ReconstructionMethod::dc:
-          if (n2 > 0.0) iiu = iim1;
-          else          iiu = iicc;
-          break;
-        case ReconstructionMethod::plm:
-          if (n2 > 0.0) PLM(iim2, iim1, iicc, iiu, scr);
-          else          PLM(iim1, iicc, iip1, scr, iiu);
-          break;
-        case ReconstructionMethod::ppm4:
-          if (n2 > 0.0) PPM4(iim3, iim2, iim1, iicc, iip1, iiu, scr);
-          else          PPM4(iim2, iim1, iicc, iip1, iip2, scr, iiu);
-          break;
-        case ReconstructionMethod::ppmx:
-          if (n2 > 0.0) PPMX(iim3, iim2, iim1, iicc, iip1, iiu, scr);
-          else          PPMX(iim2, iim1, iicc, iip1, iip2, scr, iiu);
-          break;
-        case ReconstructionMethod::wenoz:
-          if (n2 > 0.0) WENOZ(iim3, iim2, iim1, iicc, iip1, iiu, scr);
-          else          WENOZ(iim2, iim1, iicc, iip1, iip2, scr, iiu);
-          break;
-        default:
-          break;
-      }
-
-      // compute x2flux
-      flx2(m,n,k,j,i) = n2*iiu;
+    scr_size = ScrArray2D<Real>::shmem_size(4, ncells1)
+             + ScrArray2D<Real>::shmem_size(2*nst, ncells1);
+    par_for_outer("rflux_x2",DevExeSpace(),scr_size,scr_level,0,nmb1,ks,ke,js,je+1,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray2D<Real> tet(member.team_scratch(scr_level), 4, ncells1);
+      ScrArray2D<Real> rn0(member.team_scratch(scr_level), 2*nst, ncells1);
+      par_for_inner(member, is, ie, [&](const int i) {
+        if (!(cached)) {
+          for (int d=0; d<4; ++d) {tet(d,i) = t2d2(m,d,k,j,i);}
+        }
+        for (int s=0; s<2*nst; ++s) {
+          int jj = j - nst + s;
+          rn0(s,i) = (cached)? inv_n0_(m,k,jj,i) : 1.0/tet_c_(m,0,0,k,jj,i);
+        }
+      });
+      member.team_barrier();
+
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nvar_), [&](const int n) {
+        const int a = n/ngroups_;
+        Real nh0 = nh_c_.d_view(a,0), nh1 = nh_c_.d_view(a,1);
+        Real nh2 = nh_c_.d_view(a,2), nh3 = nh_c_.d_view(a,3);
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(member, is, ie+1),
+        [&](const int i) {
+          // calculate n^2 (hence determining upwinding direction)
+          Real n2 = (cached)? nf2(m,a,k,j,i) :
+                    (tet(0,i)*nh0 + tet(1,i)*nh1 + tet(2,i)*nh2 + tet(3,i)*nh3);
+
+          // convert to primitive n_0 I (row s of scratch is j-nst+s)
+          Real iim3 = 0.0, iim2 = 0.0, iip1 = 0.0, iip2 = 0.0;
+          Real iim1 = i0_(m,n,k,j-1,i)*rn0(nst-1,i);
+          Real iicc = i0_(m,n,k,j  ,i)*rn0(nst  ,i);
+          if (nst > 1) {
+            iim2 = i0_(m,n,k,j-2,i)*rn0(nst-2,i);
+            iip1 = i0_(m,n,k,j+1,i)*rn0(nst+1,i);
+          }
+          if (nst > 2) {
+            iim3 = i0_(m,n,k,j-3,i)*rn0(nst-3,i);
+            iip2 = i0_(m,n,k,j+2,i)*rn0(nst+2,i);
+          }
+
+          // reconstruct primitive intensity and compute x2flux
+          flx2(m,n,k,j,i) = n2*UpwindIntensity(recon_method_, n2, iim3, iim2, iim1, iicc,
+                                               iip1, iip2);
+        });
+      });
     });
   }
 
   //--------------------------------------------------------------------------------------
-  // k-direction. Note order of k,j loops switched
+  // k-direction.  Scratch holds 1/n_0 in planes k-nst..k+nst-1 of the stencil.
 
   if (pmy_pack->pmesh->three_d) {
     auto &t3d3 = tet_d3_x3f;
+    auto &nf3 = nface.x3f;
     auto &flx3 = iflx.x3f;
-    par_for("rflux_x3",DevExeSpace(),0,nmb1,0,nang1,ks,ke+1,js,je,is,ie,
-    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-      // calculate n^3 (hence determining upwinding direction)
-      Real n3 = t3d3(m,0,k,j,i)*nh_c_.d_view(n,0) + t3d3(m,1,k,j,i)*nh_c_.d_view(n,1)
-              + t3d3(m,2,k,j,i)*nh_c_.d_view(n,2) + t3d3(m,3,k,j,i)*nh_c_.d_view(n,3);
-
-      // convert to primitive n_0 I
-      Real iim1, iicc, iim2, iip1, iim3, iip2;
-      iim1 = i0_(m,n,k-1,j,i)/tet_c_(m,0,0,k-1,j,i);
-      iicc = i0_(m,n,k  ,j,i)/tet_c_(m,0,0,k  ,j,i);
-      if (recon_method_ > 0) {
-        iim2 = i0_(m,n,k-2,j,i)/tet_c_(m,0,0,k-2,j,i);
-        iip1 = i0_(m,n,k+1,j,i)/tet_c_(m,0,0,k+1,j,i);
-      }
-      if (recon_method_ > 1) {
-        iim3 = i0_(m,n,k-3,j,i)/tet_c_(m,0,0,k-3,j,i);
-        iip2 = i0_(m,n,k+2,j,i)/tet_c_(m,0,0,k+2,j,i);
-      }
-
-      // reconstruct primitive intensity
-      Real iiu, scr;
-      switch (recon_method_) {
-        case ReconstructionMethod::dc:
-          if (n3 > 0.0) iiu = iim1;
-          else          iiu = iicc;
-          break;
-        case ReconstructionMethod::plm:
-          if (n3 > 0.0) PLM(iim2, iim1, iicc, iiu, scr);
-          else          PLM(iim1, iicc, iip1, scr, iiu);
-          break;
-        case ReconstructionMethod::ppm4:
-          if (n3 > 0.0) PPM4(iim3, iim2, iim1, iicc, iip1, iiu, scr);
-          else          PPM4(iim2, iim1, iicc, iip1, iip2, scr, iiu);
-          break;
-        case ReconstructionMethod::ppmx:
-          if (n3 > 0.0) PPMX(iim3, iim2, iim1, iicc, iip1, iiu, scr);
-          else          PPMX(iim2, iim1, iicc, iip1, iip2, scr, iiu);
-          break;
-        case ReconstructionMethod::wenoz:
-          if (n3 > 0.0) WENOZ(iim3, iim2, iim1, iicc, iip1, iiu, scr);
-          else          WENOZ(iim2, iim1, iicc, iip1, iip2, scr, iiu);
-          break;
-        default:
-          break;
-      }
-
-      // compute x3flux
-      flx3(m,n,k,j,i) = n3*iiu;
+    scr_size = ScrArray2D<Real>::shmem_size(4, ncells1)
+             + ScrArray2D<Real>::shmem_size(2*nst, ncells1);
+    par_for_outer("rflux_x3",DevExeSpace(),scr_size,scr_level,0,nmb1,ks,ke+1,js,je,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray2D<Real> tet(member.team_scratch(scr_level), 4, ncells1);
+      ScrArray2D<Real> rn0(member.team_scratch(scr_level), 2*nst, ncells1);
+      par_for_inner(member, is, ie, [&](const int i) {
+        if (!(cached)) {
+          for (int d=0; d<4; ++d) {tet(d,i) = t3d3(m,d,k,j,i);}
+        }
+        for (int s=0; s<2*nst; ++s) {
+          int kk = k - nst + s;
+          rn0(s,i) = (cached)? inv_n0_(m,kk,j,i) : 1.0/tet_c_(m,0,0,kk,j,i);
+        }
+      });
+      member.team_barrier();
+
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nvar_), [&](const int n) {
+        const int a = n/ngroups_;
+        Real nh0 = nh_c_.d_view(a,0), nh1 = nh_c_.d_view(a,1);
+        Real nh2 = nh_c_.d_view(a,2), nh3 = nh_c_.d_view(a,3);
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(member, is, ie+1),
+        [&](const int i) {
+          // calculate n^3 (hence determining upwinding direction)
+          Real n3 = (cached)? nf3(m,a,k,j,i) :
+                    (tet(0,i)*nh0 + tet(1,i)*nh1 + tet(2,i)*nh2 + tet(3,i)*nh3);
+
+          // convert to primitive n_0 I (plane s of scratch is k-nst+s)
+          Real iim3 = 0.0, iim2 = 0.0, iip1 = 0.0, iip2 = 0.0;
+          Real iim1 = i0_(m,n,k-1,j,i)*rn0(nst-1,i);
+          Real iicc = i0_(m,n,k  ,j,i)*rn0(nst  ,i);
+          if (nst > 1) {
+            iim2 = i0_(m,n,k-2,j,i)*rn0(nst-2,i);
+            iip1 = i0_(m,n,k+1,j,i)*rn0(nst+1,i);
+          }
+          if (nst > 2) {
+            iim3 = i0_(m,n,k-3,j,i)*rn0(nst-3,i);
+            iip2 = i0_(m,n,k+2,j,i)*rn0(nst+2,i);
+          }
+
+          // reconstruct primitive intensity and compute x3flux
+          flx3(m,n,k,j,i) = n3*UpwindIntensity(recon_method_, n3, iim3, iim2, iim1, iicc,
+                                               iip1, iip2);
+        });
+      });
     });
   }
 
   //--------------------------------------------------------------------------------------
-  // Angular Fluxes
+  // Angular Fluxes (with fused_update, computed together with the update at the end)
 
-  if (angular_fluxes) {
+  if (angular_fluxes && !(fused_update)) {
     auto &numn = prgeo->num_neighbors;
     auto &indn = prgeo->ind_neighbors;
     auto &arcl = prgeo->arc_lengths;
@@ -219,16 +285,179 @@ TaskStatus Radiation::CalculateFluxes(Driver *pdriver, int stage) {
     auto &na_ = na;
     auto &divfa_ = divfa;
 
-    par_for("rflux_angular",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
-    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-      divfa_(m,n,k,j,i) = 0.0;
-      for (int nb=0; nb<numn.d_view(n); ++nb) {
-        Real flx_edge = na_(m,n,k,j,i,nb) *
-                        ((na_(m,n,k,j,i,nb) < 0.0) ?
-                         i0_(m,indn.d_view(n,nb),k,j,i)/tet_c_(m,0,0,k,j,i) :
-                         i0_(m,n,k,j,i)/tet_c_(m,0,0,k,j,i));
-        divfa_(m,n,k,j,i) += (arcl.d_view(n,nb)*flx_edge/solid_angles_.d_view(n));
-      }
+    if (store_na) {
+      par_for("rflux_angular",DevExeSpace(),0,nmb1,0,(nvar_-1),ks,ke,js,je,is,ie,
+      KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+        // angle a and group g of intensity n; fluxes only couple angles of same group
+        int a = n/ngroups_;
+        int g = n - a*ngroups_;
+        divfa_(m,n,k,j,i) = 0.0;
+        for (int nb=0; nb<numn.d_view(a); ++nb) {
+          int nup = (na_(m,a,k,j,i,nb) < 0.0)? indn.d_view(a,nb) : a;
+          Real flx_edge = na_(m,a,k,j,i,nb) *
+                          PrimIntensity(i0_,tet_c_,inv_n0_,cached,m,nup*ngroups_+g,k,j,i);
+          divfa_(m,n,k,j,i) += (arcl.d_view(a,nb)*flx_edge/solid_angles_.d_view(a));
+        }
+      });
+    } else {
+      // recompute Ricci rotation coefficients from the analytic metric once per cell,
+      // then n^a for every angle and edge
+      auto &size = pmy_pack->pmb->mb_size;
+      auto &coord = pmy_pack->pcoord->coord_data;
+      bool flat = coord.is_minkowski;
+      Real spin = coord.bh_spin;
+      auto uflux = prgeo->unit_flux;
+      auto nh_f_ = nh_f;
+      par_for("rflux_angular",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
+      KOKKOS_LAMBDA(int m, int k, int j, int i) {
+        Real &x1min = size.d_view(m).x1min;
+        Real &x1max = size.d_view(m).x1max;
+        Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
+
+        Real &x2min = size.d_view(m).x2min;
+        Real &x2max = size.d_view(m).x2max;
+        Real x2v = CellCenterX(j-js, indcs.nx2, x2min, x2max);
+
+        Real &x3min = size.d_view(m).x3min;
+        Real &x3max = size.d_view(m).x3max;
+        Real x3v = CellCenterX(k-ks, indcs.nx3, x3min, x3max);
+
+
+        Real glower[4][4], gupper[4][4];
+        ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+        Real dgx[4][4], dgy[4][4], dgz[4][4];
+        ComputeMetricDerivatives(x1v,x2v,x3v,flat,spin,dgx,dgy,dgz);
+        Real e[4][4], e_cov[4][4], omega[4][4][4];
+        ComputeTetrad(x1v,x2v,x3v,flat,spin,glower,gupper,dgx,dgy,dgz,e,e_cov,omega);
+        for (int n=0; n<=nang1; ++n) {
+          for (int g=0; g<ngroups_; ++g) {
+            divfa_(m,n*ngroups_+g,k,j,i) = 0.0;
+          }
+          for (int nb=0; nb<numn.d_view(n); ++nb) {
+            Real na_nb = AngularFluxNormal(nh_f_, uflux, n, nb, omega);
+            int nup = (na_nb < 0.0)? indn.d_view(n,nb) : n;
+            Real fac = na_nb*arcl.d_view(n,nb)/solid_angles_.d_view(n);
+            for (int g=0; g<ngroups_; ++g) {
+              Real iup = PrimIntensity(i0_,tet_c_,inv_n0_,cached,m,nup*ngroups_+g,k,j,i);
+              divfa_(m,n*ngroups_+g,k,j,i) += fac*iup;
+            }
+          }
+        }
+      });
+    }
+  }
+
+  //--------------------------------------------------------------------------------------
+  // Fused x1-flux, angular flux, and RK update.  One team per (m,k,j) pencil computes the
+  // x1-fluxes on both faces of each cell (so they are never stored), adds the divergence
+  // of the x2- and x3-fluxes computed above and the angular flux divergence, and stores
+  // the updated intensities in scratch.  These are copied into i0 after a barrier, since
+  // the x1-stencil and the angular neighbors of each cell are read from the old i0 by
+  // other lanes and threads of the same team.
+
+  if (fused_update) {
+    auto &mbsize = pmy_pack->pmb->mb_size;
+    bool &multi_d = pmy_pack->pmesh->multi_d;
+    bool &three_d = pmy_pack->pmesh->three_d;
+    Real &gam0 = pdriver->gam0[stage-1];
+    Real &gam1 = pdriver->gam1[stage-1];
+    // radiation propagates at the (possibly reduced) speed of light c_hat
+    Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt)*c_hat;
+
+    auto &i1_ = i1;
+    auto &flx2 = iflx.x2f;
+    auto &flx3 = iflx.x3f;
+    auto &tc = tetcov_c;
+    bool angular_fluxes_ = angular_fluxes;
+    auto &numn = prgeo->num_neighbors;
+    auto &indn = prgeo->ind_neighbors;
+    auto &arcl = prgeo->arc_lengths;
+    auto &solid_angles_ = prgeo->solid_angles;
+    auto &na_ = na;
+
+    auto &excise = pmy_pack->pcoord->coord_data.bh_excise;
+    auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
+    Real &n_0_floor_ = n_0_floor;
+
+    int scr_lvl = 1;
+    size_t scr_size1 = ScrArray2D<Real>::shmem_size(nvar_, ncells1);
+    par_for_outer("rflux_x1_upd",DevExeSpace(),scr_size1,scr_lvl,0,nmb1,ks,ke,js,je,
+    KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+      ScrArray2D<Real> inew(member.team_scratch(scr_lvl), nvar_, ncells1);
+
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nvar_), [&](const int n) {
+        const int a = n/ngroups_;
+        const int g = n - a*ngroups_;
+        Real nh0 = nh_c_.d_view(a,0), nh1 = nh_c_.d_view(a,1);
+        Real nh2 = nh_c_.d_view(a,2), nh3 = nh_c_.d_view(a,3);
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(member, is, ie+1),
+        [&](const int i) {
+          // x1-fluxes on faces i and i+1 of the cell
+          Real flxf[2];
+          for (int f=0; f<2; ++f) {
+            int ii = i + f;
+            Real n1 = (cached)? nf1(m,a,k,j,ii) :
+                      (t1d1(m,0,k,j,ii)*nh0 + t1d1(m,1,k,j,ii)*nh1 +
+                       t1d1(m,2,k,j,ii)*nh2 + t1d1(m,3,k,j,ii)*nh3);
+            Real iim3 = 0.0, iim2 = 0.0, iip1 = 0.0, iip2 = 0.0;
+            Real iim1 = PrimIntensity(i0_,tet_c_,inv_n0_,cached,m,n,k,j,ii-1);
+            Real iicc = PrimIntensity(i0_,tet_c_,inv_n0_,cached,m,n,k,j,ii  );
+            if (nst > 1) {
+              iim2 = PrimIntensity(i0_,tet_c_,inv_n0_,cached,m,n,k,j,ii-2);
+              iip1 = PrimIntensity(i0_,tet_c_,inv_n0_,cached,m,n,k,j,ii+1);
+            }
+            if (nst > 2) {
+              iim3 = PrimIntensity(i0_,tet_c_,inv_n0_,cached,m,n,k,j,ii-3);
+              iip2 = PrimIntensity(i0_,tet_c_,inv_n0_,cached,m,n,k,j,ii+2);
+            }
+            flxf[f] = n1*UpwindIntensity(recon_method_, n1, iim3, iim2, iim1, iicc,
+                                         iip1, iip2);
+          }
+
+          // spatial fluxes
+          Real divf_s = (flxf[1] - flxf[0])/mbsize.d_view(m).dx1;
+          if (multi_d) {
+            divf_s += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+          }
+          if (three_d) {
+            divf_s += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+          }
+          Real iupd = gam0*i0_(m,n,k,j,i) + gam1*i1_(m,n,k,j,i) - beta_dt*divf_s;
+
+          // angular fluxes (n^a is always stored with fused_update)
+          if (angular_fluxes_) {
+            Real divfa_c = 0.0;
+            for (int nb=0; nb<numn.d_view(a); ++nb) {
+              int nup = (na_(m,a,k,j,i,nb) < 0.0)? indn.d_view(a,nb) : a;
+              Real flx_edge = na_(m,a,k,j,i,nb) *
+                              PrimIntensity(i0_,tet_c_,inv_n0_,cached,m,nup*ngroups_+g,
+                                            k,j,i);
+              divfa_c += (arcl.d_view(a,nb)*flx_edge/solid_angles_.d_view(a));
+            }
+            iupd -= beta_dt*divfa_c;
+          }
+
+          // zero intensity if negative
+          Real n0  = tet_c_(m,0,0,k,j,i);
+          Real n_0 = tc(m,0,0,k,j,i)*nh0 + tc(m,1,0,k,j,i)*nh1 +
+                     tc(m,2,0,k,j,i)*nh2 + tc(m,3,0,k,j,i)*nh3;
+          iupd = n0*n_0*fmax((iupd/(n0*n_0)), 0.0);
+
+          // handle excision (see RKUpdate)
+          if (excise) {
+            if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { iupd = 0.0; }
+          }
+          inew(n,i) = iupd;
+        });
+      });
+      member.team_barrier();
+
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(member, nvar_), [&](const int n) {
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(member, is, ie+1),
+        [&](const int i) {
+          i0_(m,n,k,j,i) = inew(n,i);
+        });
+      });
     });
   }
 
@@ -0,0 +1,210 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file radiation_m1.cpp
+//! \brief fluxes and RK update of the two-moment (M1) radiation method, selected with
+//! <radiation>/method=m1.  The energy density E and flux F^i of each frequency group are
+//! evolved in flat spacetime with
+//!   dE/dt + d_i F^i = S^0,   dF^j/dt + d_i P^{ij} = S^j
+//! where P^{ij} is given by the M1 closure (see radiation_m1.hpp), and S^mu are the
+//! implicit source terms in radiation_source.cpp.  Variables are stored in i0, so that
+//! the boundary communication, physical BCs, restriction/prolongation, and task list of
+//! the discrete ordinates method are shared.
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "driver/driver.hpp"
+#include "radiation.hpp"
+#include "radiation_m1.hpp"
+#include "reconstruct/plm.hpp"
+#include "reconstruct/ppm.hpp"
+#include "reconstruct/wenoz.hpp"
+
+namespace radiation {
+//----------------------------------------------------------------------------------------
+//! \fn void M1FaceStates()
+//! \brief Reconstructs left and right states at the face between cells q[2] and q[3] of
+//! the stencil q[0..5] (cells i-3..i+2 of a face at i-1/2).
+
+KOKKOS_INLINE_FUNCTION
+void M1FaceStates(const int recon, const Real q[6], Real &ql, Real &qr) {
+  Real scr;
+  switch (recon) {
+    case ReconstructionMethod::dc:
+      ql = q[2];
+      qr = q[3];
+      break;
+    case ReconstructionMethod::plm:
+      PLM(q[1], q[2], q[3], ql, scr);
+      PLM(q[2], q[3], q[4], scr, qr);
+      break;
+    case ReconstructionMethod::ppm4:
+      PPM4(q[0], q[1], q[2], q[3], q[4], ql, scr);
+      PPM4(q[1], q[2], q[3], q[4], q[5], scr, qr);
+      break;
+    case ReconstructionMethod::ppmx:
+      PPMX(q[0], q[1], q[2], q[3], q[4], ql, scr);
+      PPMX(q[1], q[2], q[3], q[4], q[5], scr, qr);
+      break;
+    case ReconstructionMethod::wenoz:
+      WENOZ(q[0], q[1], q[2], q[3], q[4], ql, scr);
+      WENOZ(q[1], q[2], q[3], q[4], q[5], scr, qr);
+      break;
+    default:
+      ql = q[2];
+      qr = q[3];
+      break;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void M1FaceFlux()
+//! \brief Computes flux of (E,F^1,F^2,F^3) of group g in direction dir (0,1,2) at the
+//! face between cells (k,j,i) and the previous cell in that direction, using the local
+//! Lax-Friedrichs (LLF) flux with the maximum signal speed (the speed of light).
+
+KOKKOS_INLINE_FUNCTION
+void M1FaceFlux(const int recon, const int nst, const int dir, const Real efloor,
+                const DvceArray5D<Real> &i0, const int ngroups, const int m, const int g,
+                const int k, const int j, const int i, Real flx[4]) {
+  const int di = (dir == 0)? 1 : 0;
+  const int dj = (dir == 1)? 1 : 0;
+  const int dk = (dir == 2)? 1 : 0;
+
+  // reconstruct each variable at the face
+  Real ul[4], ur[4];
+  for (int c=0; c<4; ++c) {
+    int n = c*ngroups + g;
+    Real q[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    for (int s=-nst; s<nst; ++s) {
+      q[s+3] = i0(m,n,k+s*dk,j+s*dj,i+s*di);
+    }
+    M1FaceStates(recon, q, ul[c], ur[c]);
+  }
+
+  // limit reconstructed states, and compute pressure tensor on each side
+  Real fl[3] = {ul[1], ul[2], ul[3]};
+  Real fr[3] = {ur[1], ur[2], ur[3]};
+  M1Limit(efloor, ul[0], fl);
+  M1Limit(efloor, ur[0], fr);
+  Real pl[3][3], pr[3][3];
+  M1Closure(ul[0], fl, pl);
+  M1Closure(ur[0], fr, pr);
+
+  // LLF flux
+  flx[0] = 0.5*(fl[dir] + fr[dir]) - 0.5*(ur[0] - ul[0]);
+  for (int b=0; b<3; ++b) {
+    flx[b+1] = 0.5*(pl[dir][b] + pr[dir][b]) - 0.5*(fr[b] - fl[b]);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Radiation::M1Fluxes
+//! \brief Compute fluxes of M1 variables on all faces
+
+TaskStatus Radiation::M1Fluxes(Driver *pdriver, int stage) {
+  RegionIndcs &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int ngroups_ = ngroups;
+  int ng1 = ngroups - 1;
+  const int recon_method_ = recon_method;
+  // number of cells in the stencil on each side of a face
+  const int nst = (recon_method_ > 1)? 3 : ((recon_method_ > 0)? 2 : 1);
+  Real efloor = m1_efloor;
+  auto &i0_ = i0;
+
+  // i-direction
+  auto &flx1 = iflx.x1f;
+  par_for("m1flux_x1",DevExeSpace(),0,nmb1,0,ng1,ks,ke,js,je,is,ie+1,
+  KOKKOS_LAMBDA(int m, int g, int k, int j, int i) {
+    Real f[4];
+    M1FaceFlux(recon_method_, nst, 0, efloor, i0_, ngroups_, m, g, k, j, i, f);
+    for (int c=0; c<4; ++c) {flx1(m,c*ngroups_+g,k,j,i) = f[c];}
+  });
+
+  // j-direction
+  if (pmy_pack->pmesh->multi_d) {
+    auto &flx2 = iflx.x2f;
+    par_for("m1flux_x2",DevExeSpace(),0,nmb1,0,ng1,ks,ke,js,je+1,is,ie,
+    KOKKOS_LAMBDA(int m, int g, int k, int j, int i) {
+      Real f[4];
+      M1FaceFlux(recon_method_, nst, 1, efloor, i0_, ngroups_, m, g, k, j, i, f);
+      for (int c=0; c<4; ++c) {flx2(m,c*ngroups_+g,k,j,i) = f[c];}
+    });
+  }
+
+  // k-direction
+  if (pmy_pack->pmesh->three_d) {
+    auto &flx3 = iflx.x3f;
+    par_for("m1flux_x3",DevExeSpace(),0,nmb1,0,ng1,ks,ke+1,js,je,is,ie,
+    KOKKOS_LAMBDA(int m, int g, int k, int j, int i) {
+      Real f[4];
+      M1FaceFlux(recon_method_, nst, 2, efloor, i0_, ngroups_, m, g, k, j, i, f);
+      for (int c=0; c<4; ++c) {flx3(m,c*ngroups_+g,k,j,i) = f[c];}
+    });
+  }
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Radiation::M1RKUpdate
+//! \brief Explicit RK update of flux divergence of M1 variables.  The floor on E and
+//! the limit |F| <= E replace the positivity of intensities in the ordinates update.
+
+TaskStatus Radiation::M1RKUpdate(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int ngroups_ = ngroups;
+  int ng1 = ngroups - 1;
+  Real efloor = m1_efloor;
+
+  auto &mbsize  = pmy_pack->pmb->mb_size;
+  bool &multi_d = pmy_pack->pmesh->multi_d;
+  bool &three_d = pmy_pack->pmesh->three_d;
+
+  Real &gam0 = pdriver->gam0[stage-1];
+  Real &gam1 = pdriver->gam1[stage-1];
+  // radiation propagates at the (possibly reduced) speed of light c_hat
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt)*c_hat;
+
+  auto &i0_ = i0;
+  auto &i1_ = i1;
+  auto &flx1 = iflx.x1f;
+  auto &flx2 = iflx.x2f;
+  auto &flx3 = iflx.x3f;
+
+  par_for("m1_update",DevExeSpace(),0,nmb1,0,ng1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int g, int k, int j, int i) {
+    Real u[4];
+    for (int c=0; c<4; ++c) {
+      int n = c*ngroups_ + g;
+      Real divf = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
+      if (multi_d) {
+        divf += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+      }
+      if (three_d) {
+        divf += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+      }
+      u[c] = gam0*i0_(m,n,k,j,i) + gam1*i1_(m,n,k,j,i) - beta_dt*divf;
+    }
+    Real f[3] = {u[1], u[2], u[3]};
+    M1Limit(efloor, u[0], f);
+    i0_(m,IRE*ngroups_+g,k,j,i) = u[0];
+    i0_(m,IRF1*ngroups_+g,k,j,i) = f[0];
+    i0_(m,IRF2*ngroups_+g,k,j,i) = f[1];
+    i0_(m,IRF3*ngroups_+g,k,j,i) = f[2];
+  });
+
+  return TaskStatus::complete;
+}
+
+} // namespace radiation
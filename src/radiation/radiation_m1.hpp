@@ -0,0 +1,82 @@
+#ifndef RADIATION_RADIATION_M1_HPP_
+#define RADIATION_RADIATION_M1_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file radiation_m1.hpp
+//! \brief closure and limiter of the two-moment (M1) radiation method
+
+#include "athena.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void M1Closure()
+//! \brief Radiation pressure tensor P^{ij} given energy density e and flux f^i, using the
+//! Levermore (1984) closure P^{ij} = e[(1-chi)/2 delta^{ij} + (3chi-1)/2 n^i n^j], with
+//! n^i = f^i/|f| and Eddington factor chi = (3 + 4f^2)/(5 + 2 sqrt(4 - 3f^2)) for
+//! reduced flux f = |f|/e.  This reduces to P = e/3 delta in the diffusion limit (f=0)
+//! and P = e n n for free streaming (f=1).
+
+KOKKOS_INLINE_FUNCTION
+void M1Closure(const Real e, const Real f[3], Real p[3][3]) {
+  Real fmag = sqrt(SQR(f[0]) + SQR(f[1]) + SQR(f[2]));
+  Real ff = (e > 0.0)? fmin(fmag/e, 1.0) : 0.0;
+  Real chi = (3.0 + 4.0*SQR(ff))/(5.0 + 2.0*sqrt(4.0 - 3.0*SQR(ff)));
+  Real cthin = 0.5*(3.0*chi - 1.0);
+  Real cthick = 0.5*(1.0 - chi);
+  Real nhat[3] = {0.0, 0.0, 0.0};
+  if (fmag > 0.0) {
+    for (int d=0; d<3; ++d) {nhat[d] = f[d]/fmag;}
+  }
+  for (int a=0; a<3; ++a) {
+    for (int b=0; b<3; ++b) {
+      p[a][b] = e*(cthin*nhat[a]*nhat[b] + ((a == b)? cthick : 0.0));
+    }
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void M1Limit()
+//! \brief Applies floor to energy density, and limits flux so that |f| <= e (radiation
+//! cannot propagate faster than light).
+
+KOKKOS_INLINE_FUNCTION
+void M1Limit(const Real efloor, Real &e, Real f[3]) {
+  e = fmax(e, efloor);
+  Real fmag = sqrt(SQR(f[0]) + SQR(f[1]) + SQR(f[2]));
+  if (fmag > e) {
+    for (int d=0; d<3; ++d) {f[d] *= e/fmag;}
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void M1FluidFrame()
+//! \brief Fluid frame energy density J = u_mu u_nu R^{mu nu} and (covariant) flux
+//! H_a = -h_a^mu u^nu R_{mu nu} in flat spacetime, given E, F^i, and fluid four-velocity
+//! u^mu, with R^{mu nu} = J u^mu u^nu + H^mu u^nu + u^mu H^nu + K^{mu nu}.
+
+KOKKOS_INLINE_FUNCTION
+void M1FluidFrame(const Real e, const Real f[3], const Real uu[4], Real &jr,
+                  Real hl[4]) {
+  Real p[3][3];
+  M1Closure(e, f, p);
+  // covariant R_{mu nu} with metric diag(-1,1,1,1)
+  Real rl[4][4];
+  rl[0][0] = e;
+  for (int a=0; a<3; ++a) {
+    rl[0][a+1] = -f[a];
+    rl[a+1][0] = -f[a];
+    for (int b=0; b<3; ++b) {rl[a+1][b+1] = p[a][b];}
+  }
+  Real ul[4] = {-uu[0], uu[1], uu[2], uu[3]};
+  Real ql[4];
+  for (int a=0; a<4; ++a) {
+    ql[a] = 0.0;
+    for (int b=0; b<4; ++b) {ql[a] -= rl[a][b]*uu[b];}
+  }
+  jr = -(uu[0]*ql[0] + uu[1]*ql[1] + uu[2]*ql[2] + uu[3]*ql[3]);
+  for (int a=0; a<4; ++a) {hl[a] = ql[a] - jr*ul[a];}
+}
+
+#endif // RADIATION_RADIATION_M1_HPP_
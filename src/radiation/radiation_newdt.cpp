@@ -16,6 +16,7 @@
 
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
+#include "coordinates/cartesian_ks.hpp"
 #include "coordinates/coordinates.hpp"
 #include "coordinates/cell_locations.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
@@ -57,6 +58,13 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
   auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
   auto &numn = prgeo->num_neighbors;
   auto &indn = prgeo->ind_neighbors;
+  // without stored n^a, it is recomputed from the analytic metric as in the fluxes
+  bool store_na_ = store_na;
+  auto &coord = pmy_pack->pcoord->coord_data;
+  bool flat = coord.is_minkowski;
+  Real spin = coord.bh_spin;
+  auto uflux = prgeo->unit_flux;
+  auto nh_f_ = nh_f;
 
   // find smallest (dx/c) and (dangle/na) in each direction for radiation problems
   Kokkos::parallel_reduce("RadiationNudt",Kokkos::RangePolicy<>(DevExeSpace(), 0, nmkji),
@@ -71,6 +79,18 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
 
     Real tmp_min_dta = (FLT_MAX);
     if (angular_fluxes_) {
+      Real omega[4][4][4];
+      if (!(store_na_)) {
+        Real x1v = CellCenterX(i-is, nx1, size.d_view(m).x1min, size.d_view(m).x1max);
+        Real x2v = CellCenterX(j-js, nx2, size.d_view(m).x2min, size.d_view(m).x2max);
+        Real x3v = CellCenterX(k-ks, nx3, size.d_view(m).x3min, size.d_view(m).x3max);
+        Real glower[4][4], gupper[4][4];
+        ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+        Real dgx[4][4], dgy[4][4], dgz[4][4];
+        ComputeMetricDerivatives(x1v,x2v,x3v,flat,spin,dgx,dgy,dgz);
+        Real e[4][4], e_cov[4][4];
+        ComputeTetrad(x1v,x2v,x3v,flat,spin,glower,gupper,dgx,dgy,dgz,e,e_cov,omega);
+      }
       for (int n=0; n<=nang1; ++n) {
         // find position at angle center
         Real x = nh_c_.d_view(n,1);
@@ -83,7 +103,9 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
           Real zn = nh_c_.d_view(indn.d_view(n,nb),3);
           // compute timestep limitation
           Real n0 = tet_c_(m,0,0,k,j,i);
-          Real adt = fmin(tmp_min_dta,(acos(x*xn+y*yn+z*zn)/fabs(na_(m,n,k,j,i,nb)/n0)));
+          Real na_nb = (store_na_)? na_(m,n,k,j,i,nb) :
+                       AngularFluxNormal(nh_f_, uflux, n, nb, omega);
+          Real adt = fmin(tmp_min_dta,(acos(x*xn+y*yn+z*zn)/fabs(na_nb/n0)));
           // set timestep limitation if not excising this cell
           if (excise) {
             if (!(rad_mask_(m,k,j,i))) { tmp_min_dta = adt; }
@@ -106,6 +128,9 @@ TaskStatus Radiation::NewTimeStep(Driver *pdriver, int stage) {
   if (pmy_pack->pmesh->three_d) { dtnew = std::min(dtnew, dt3); }
   if (angular_fluxes_) { dtnew = std::min(dtnew, dta); }
 
+  // signal speed is the reduced speed of light c_hat
+  dtnew /= c_hat;
+
   return TaskStatus::complete;
 }
 } // namespace radiation
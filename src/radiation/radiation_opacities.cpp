@@ -0,0 +1,107 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file radiation_opacities.cpp
+//! \brief reads tables of Rosseland and Planck mean opacities, set with
+//! <radiation>/opacity_table.  Tables use the format of utils/tr_table.hpp, with points
+//! "rho" and "T" (in that order, with T varying fastest in the fields), and fields
+//! "kappa_r" and "kappa_p" (opacities per unit mass).  With units enabled, all values are
+//! in cgs; otherwise they are in code units.  Points must be uniformly spaced in log10.
+
+#include <math.h>
+
+#include <iostream>
+#include <string>
+
+#include "athena.hpp"
+#include "utils/tr_table.hpp"
+#include "radiation.hpp"
+
+namespace radiation {
+//----------------------------------------------------------------------------------------
+//! \fn void Radiation::ReadOpacityTable
+//! \brief Reads table of opacities into opacity_table, storing log10 of the Rosseland and
+//! Planck means at each point adjacent in memory.
+
+void Radiation::ReadOpacityTable(std::string fname) {
+  TableReader::Table table;
+  auto read_result = table.ReadTable(fname);
+  if (read_result.error != TableReader::ReadResult::SUCCESS) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "Opacity table '" << fname << "' could not be read:" << std::endl
+      << read_result.message << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  auto &point_info = table.GetPointInfo();
+  if (table.GetNDimensions() != 2 || point_info[0].first.compare("rho") != 0 ||
+      point_info[1].first.compare("T") != 0 ||
+      !(table.HasField("kappa_r")) || !(table.HasField("kappa_p"))) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "Opacity table '" << fname << "' must have points 'rho' and 'T' "
+      << "and fields 'kappa_r' and 'kappa_p'" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  int nr = point_info[0].second;
+  int nt = point_info[1].second;
+  if (nr < 2 || nt < 2) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "Opacity table '" << fname << "' needs at least two points in "
+      << "each dimension" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // spacing in log10 of density and temperature, which must be uniform so that lookups
+  // do not need to search the table
+  double *rho = table["rho"];
+  double *temp = table["T"];
+  Real dlogr = (log10(rho[nr-1]) - log10(rho[0]))/static_cast<Real>(nr - 1);
+  Real dlogt = (log10(temp[nt-1]) - log10(temp[0]))/static_cast<Real>(nt - 1);
+  bool uniform = (dlogr > 0.0) && (dlogt > 0.0);
+  for (int ir=1; ir<nr && uniform; ++ir) {
+    Real d = log10(rho[ir]) - log10(rho[ir-1]);
+    uniform = (fabs(d - dlogr) <= 1.0e-6*dlogr);
+  }
+  for (int it=1; it<nt && uniform; ++it) {
+    Real d = log10(temp[it]) - log10(temp[it-1]);
+    uniform = (fabs(d - dlogt) <= 1.0e-6*dlogt);
+  }
+  if (!(uniform)) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+      << std::endl << "Points of opacity table '" << fname << "' must be increasing "
+      << "and uniformly spaced in log10" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  opacity_table.nrho = nr;
+  opacity_table.ntemp = nt;
+  opacity_table.logrho_min = log10(rho[0]);
+  opacity_table.logt_min = log10(temp[0]);
+  opacity_table.idlogrho = 1.0/dlogr;
+  opacity_table.idlogt = 1.0/dlogt;
+
+  // copy log10 of opacities to device
+  DvceArray3D<Real> data("opacity_table", nr, nt, 2);
+  auto data_h = Kokkos::create_mirror_view(data);
+  double *kap_r = table["kappa_r"];
+  double *kap_p = table["kappa_p"];
+  for (int ir=0; ir<nr; ++ir) {
+    for (int it=0; it<nt; ++it) {
+      int iflat = it + nt*ir;
+      if (kap_r[iflat] <= 0.0 || kap_p[iflat] <= 0.0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Opacities in table '" << fname << "' must be positive"
+          << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      data_h(ir,it,0) = log10(kap_r[iflat]);
+      data_h(ir,it,1) = log10(kap_p[iflat]);
+    }
+  }
+  Kokkos::deep_copy(data, data_h);
+  opacity_table.data = data;
+  return;
+}
+
+} // namespace radiation
@@ -12,6 +12,53 @@
 
 #include "athena.hpp"
 
+//----------------------------------------------------------------------------------------
+//! \struct OpacityTable
+//! \brief Rosseland and Planck mean opacities tabulated on a grid uniformly spaced in
+//! (log10 rho, log10 T), read with <radiation>/opacity_table (see ReadOpacityTable()).
+//! The log10 of both opacities at each point are adjacent in memory, so that each of the
+//! four corners of a lookup is one contiguous load, and the table is accessed through a
+//! RandomAccess (read-only, texture cached on GPUs) view.
+
+struct OpacityTable {
+  int nrho = 0, ntemp = 0;         // number of points in density and temperature
+  Real logrho_min = 0.0, logt_min = 0.0;  // log10 of first density and temperature
+  Real idlogrho = 0.0, idlogt = 0.0;      // inverse spacing in log10 rho and T
+  Kokkos::View<const Real ***, LayoutWrapper, DevMemSpace,
+               Kokkos::MemoryTraits<Kokkos::RandomAccess>> data;  // (nrho, ntemp, 2)
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn void TabularOpacity
+//! \brief Rosseland kap_r and Planck kap_p mean opacities at density rho and temperature
+//! temp (all in the units of the table), by bilinear interpolation of log10 kappa in
+//! (log10 rho, log10 T).  Values outside the table are taken from the nearest edge.
+
+KOKKOS_INLINE_FUNCTION
+void TabularOpacity(const OpacityTable &tab, const Real rho, const Real temp,
+                    Real &kap_r, Real &kap_p) {
+  Real xr = (log10(rho) - tab.logrho_min)*tab.idlogrho;
+  Real xt = (log10(temp) - tab.logt_min)*tab.idlogt;
+  xr = fmin(fmax(xr, 0.0), static_cast<Real>(tab.nrho - 1));
+  xt = fmin(fmax(xt, 0.0), static_cast<Real>(tab.ntemp - 1));
+  int ir = static_cast<int>(xr);
+  int it = static_cast<int>(xt);
+  ir = (ir < tab.nrho - 1)? ir : tab.nrho - 2;
+  it = (it < tab.ntemp - 1)? it : tab.ntemp - 2;
+  Real wr = xr - ir;
+  Real wt = xt - it;
+  Real w00 = (1.0 - wr)*(1.0 - wt), w01 = (1.0 - wr)*wt;
+  Real w10 = wr*(1.0 - wt),         w11 = wr*wt;
+  Real logk[2];
+  for (int f=0; f<2; ++f) {
+    logk[f] = (w00*tab.data(ir,it,f)   + w01*tab.data(ir,it+1,f) +
+               w10*tab.data(ir+1,it,f) + w11*tab.data(ir+1,it+1,f));
+  }
+  kap_r = pow(10.0, logk[0]);
+  kap_p = pow(10.0, logk[1]);
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void OpacityFunction
 //! \brief sets sigma_a, sigma_s, sigma_p in the comoving frame
@@ -26,11 +73,19 @@ void OpacityFunction(// density and density scale
                      // power law opacities
                      const bool pow_opacity,
                      const Real rosseland_coef, const Real planck_minus_rosseland_coef,
+                     // tabulated opacities
+                     const bool tab_opacity, const OpacityTable &tab,
                      // spatially and temporally constant opacities
                      const Real k_a, const Real k_s, const Real k_p,
                      // output sigma
                      Real& sigma_a, Real& sigma_s, Real& sigma_p) {
-  if (pow_opacity) {  // power law opacity (accounting for diff b/w Ross & Planck)
+  if (tab_opacity) {  // tabulated Rosseland and Planck means
+    Real k_a_r, k_a_p;
+    TabularOpacity(tab, dens*density_scale, temp*temperature_scale, k_a_r, k_a_p);
+    sigma_a = dens*k_a_r*density_scale*length_scale;
+    sigma_p = dens*(k_a_p - k_a_r)*density_scale*length_scale;
+    sigma_s = dens*k_s  *density_scale*length_scale;
+  } else if (pow_opacity) {  // power law opacity (accounting for diff b/w Ross & Planck)
     Real power_law = (dens*density_scale)*pow(gm1*mu/(temp*temperature_scale), 3.5);
     Real k_a_r = rosseland_coef * power_law;
     Real k_a_p = planck_minus_rosseland_coef * power_law;
@@ -45,4 +100,40 @@ void OpacityFunction(// density and density scale
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn Real PlanckIntegral
+//! \brief fraction (15/pi^4) int_0^x t^3/(e^t - 1) dt of the frequency-integrated Planck
+//! function below x = h nu/kT.  Uses the series expansion about x=0 for small x, and the
+//! exponentially convergent series for x >= 1.
+
+KOKKOS_INLINE_FUNCTION
+Real PlanckIntegral(const Real x) {
+  const Real norm = 15.0/SQR(SQR(M_PI));
+  if (x <= 0.0) {
+    return 0.0;
+  } else if (x < 1.0) {
+    Real x2 = x*x;
+    return norm*x2*x*(1.0/3.0 - x/8.0 + x2/60.0 - x2*x2/5040.0 + x2*x2*x2/272160.0
+                      - x2*x2*x2*x2/13305600.0);
+  } else if (x > 50.0) {
+    return 1.0;
+  }
+  Real sum = 0.0;
+  for (int k=1; k<=12; ++k) {
+    Real rk = 1.0/static_cast<Real>(k);
+    sum += exp(-k*x)*rk*(x*x*x + rk*(3.0*x*x + rk*(6.0*x + rk*6.0)));
+  }
+  return 1.0 - norm*sum;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Real PlanckGroupFraction
+//! \brief fraction of the Planck function at temperature temp emitted in the frequency
+//! group with edges nu_lo < nu_hi, given in temperature units (h nu/k).
+
+KOKKOS_INLINE_FUNCTION
+Real PlanckGroupFraction(const Real nu_lo, const Real nu_hi, const Real temp) {
+  return PlanckIntegral(nu_hi/temp) - PlanckIntegral(nu_lo/temp);
+}
+
 #endif // RADIATION_RADIATION_OPACITIES_HPP_
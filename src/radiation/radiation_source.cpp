@@ -5,6 +5,8 @@
 //========================================================================================
 //! \file radiation_source.cpp
 
+#include <algorithm>
+
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "driver/driver.hpp"
@@ -20,11 +22,28 @@
 
 #include "radiation/radiation_tetrad.hpp"
 #include "radiation/radiation_opacities.hpp"
+#include "radiation/radiation_m1.hpp"
+
+namespace radiation {
+// sums over angles computed with vector reductions in the implicit source term
+typedef array_sum::array_type<Real,4> AngleSum;
+} // namespace radiation
+
+namespace Kokkos { //reduction identity must be defined in Kokkos namespace
+template<>
+struct reduction_identity< radiation::AngleSum > {
+  KOKKOS_FORCEINLINE_FUNCTION static radiation::AngleSum sum() {
+    return radiation::AngleSum();
+  }
+};
+} // namespace Kokkos
 
 namespace radiation {
 
 KOKKOS_INLINE_FUNCTION
 bool FourthPolyRoot(const Real coef4, const Real tconst, Real &root);
+KOKKOS_INLINE_FUNCTION
+bool FourthPolyNewton(const Real coef4, const Real tconst, Real &root, int &niter);
 
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage)
@@ -36,6 +55,7 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   if (!(rad_source)) {
     return TaskStatus::complete;
   }
+  if (is_m1_enabled) {return M1SourceTerm(pdriver, stage);}
 
   // Extract indices, size data, hydro/mhd/units flags, and coupling flags
   auto &indcs = pmy_pack->pmesh->mb_indcs;
@@ -54,8 +74,6 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
 
   // Extract coordinate/excision data
   auto &coord = pmy_pack->pcoord->coord_data;
-  bool &flat = coord.is_minkowski;
-  Real &spin = coord.bh_spin;
   bool &excise = pmy_pack->pcoord->coord_data.bh_excise;
   auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
   Real &n_0_floor_ = n_0_floor;
@@ -90,6 +108,11 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
   Real &kappa_s_ = kappa_s;
   Real &kappa_p_ = kappa_p;
   bool &power_opacity_ = power_opacity;
+  bool &table_opacity_ = table_opacity;
+  auto &opacity_table_ = opacity_table;
+  int ngroups_ = ngroups;
+  auto &nu_edge_ = nu_edge;
+  auto &gkappa_ = group_kappa;
   auto &nh_c_ = nh_c;
   auto &tt = tet_c;
   auto &tc = tetcov_c;
@@ -106,8 +129,11 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     w0_ = pmy_pack->pmhd->w0;
   }
 
-  // Extract timestep
-  Real dt_ = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  // Extract timestep.  With a reduced speed of light c_hat, radiation evolves over
+  // c_hat*dt, while the fluid (which exchanges energy and momentum at the true speed of
+  // light) receives 1/c_hat times the change of the radiation moments.
+  Real dt_ = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt)*c_hat;
+  Real inv_chat = 1.0/c_hat;
 
   // Call ConsToPrim over active zones prior to source term application
   if (!(fixed_fluid_)) {
@@ -120,9 +146,25 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     }
   }
 
-  // compute implicit source term
-  par_for("radiation_source",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+  // Counters of cells solved by Newton iteration (when the exact quartic root fails),
+  // cells that failed entirely, and maximum number of Newton iterations
+  DvceArray1D<int> nstat("rad_src_stats", 3);
+  Kokkos::deep_copy(nstat, 0);
+
+  // compute implicit source term.  One team per (m,k,j) pencil, with team threads over
+  // cells in the pencil and vector lanes over angles for the angular sums (moments and
+  // coefficients of the implicit update).
+  int ncellkj = (nmb1 + 1)*(ke - ks + 1)*(je - js + 1);
+  int nkj = (ke - ks + 1)*(je - js + 1);
+  int nj = je - js + 1;
+  int vlen = std::min(32, Kokkos::TeamPolicy<>::vector_length_max());
+  Kokkos::TeamPolicy<> policy(DevExeSpace(), ncellkj, Kokkos::AUTO, vlen);
+  Kokkos::parallel_for("radiation_source", policy,
+  KOKKOS_LAMBDA(TeamMember_t member) {
+    const int m = member.league_rank()/nkj;
+    const int k = (member.league_rank() - m*nkj)/nj + ks;
+    const int j = (member.league_rank() - m*nkj)%nj + js;
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(member, is, ie+1), [&](const int i) {
     Real &x1min = size.d_view(m).x1min;
     Real &x1max = size.d_view(m).x1max;
     Real x1v = CellCenterX(i-is, indcs.nx1, x1min, x1max);
@@ -137,7 +179,7 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
 
     // compute metric and inverse
     Real glower[4][4], gupper[4][4];
-    ComputeMetricAndInverse(x1v,x2v,x3v,flat,spin,glower,gupper);
+    CellMetricAndInverse(coord,m,k,j,i,x1v,x2v,x3v,glower,gupper);
     Real alpha = sqrt(-1.0/gupper[0][0]);
 
     // fluid state
@@ -162,14 +204,13 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
                     tgas, temperature_scale_,
                     length_scale_, gm1, mean_mol_weight_,
                     power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
+                    table_opacity_, opacity_table_,
                     kappa_a_, kappa_s_, kappa_p_,
                     sigma_a, sigma_s, sigma_p);
     Real dtcsiga = dt_*sigma_a;
     Real dtcsigs = dt_*sigma_s;
     Real dtcsigp = dt_*sigma_p;
-    Real dtaucsiga = dtcsiga/u0;
     Real dtaucsigs = dtcsigs/u0;
-    Real dtaucsigp = dtcsigp/u0;
 
     // compute fluid velocity in tetrad frame
     Real u_tet[4];
@@ -185,39 +226,69 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
     // coordinate component n^0
     Real n0 = tt(m,0,0,k,j,i);
 
-    // Calculate polynomial coefficients
-    Real wght_sum = 0.0;
-    Real suma1 = 0.0;
-    Real suma2 = 0.0;
-    for (int n=0; n<=nang1; ++n) {
-      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
-                 tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-      Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
-                    u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
-      Real omega_cm = solid_angles_.d_view(n)/SQR(n0_cm);
-      Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
-      Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
-      Real vncsigma2 = n0_cm*vncsigma;
-      Real ir_weight = intensity_cm*omega_cm;
-      wght_sum += omega_cm;
-      suma1 += omega_cm*vncsigma2;
-      suma2 += ir_weight*n0*vncsigma;
-    }
-    suma1 /= wght_sum;
-    suma2 /= wght_sum;
-    Real suma3 = suma1*(dtcsigs - dtcsigp);
-    suma1 *= (dtcsiga + dtcsigp);
-
-    // compute coefficients
+    // Calculate polynomial coefficients, summed over frequency groups.  Groups are
+    // coupled only through the gas temperature, with the fraction of emission in each
+    // group evaluated at the old temperature.  Sums over angles for group g are taken
+    // over intensities n*ngroups_ + g.
     Real coef[2];
-    coef[1] = (dtaucsiga+dtaucsigp-(dtaucsiga+dtaucsigp)*suma1/(1.0-suma3))*arad_*gm1/wdn;
-    coef[0] = -tgas-(dtaucsiga+dtaucsigp)*suma2*gm1/(wdn*(1.0-suma3));
+    coef[1] = 0.0;
+    coef[0] = -tgas;
+    Real wght_sum, suma1, suma2, suma3;
+    for (int g=0; g<ngroups_; ++g) {
+      Real dtcsiga_g = dtcsiga, dtcsigs_g = dtcsigs, dtcsigp_g = dtcsigp;
+      Real frac_g = 1.0;
+      if (ngroups_ > 1) {
+        OpacityFunction(wdn, density_scale_,
+                        tgas, temperature_scale_,
+                        length_scale_, gm1, mean_mol_weight_,
+                        power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
+                        table_opacity_, opacity_table_,
+                        gkappa_.d_view(g,0), gkappa_.d_view(g,1), gkappa_.d_view(g,2),
+                        sigma_a, sigma_s, sigma_p);
+        dtcsiga_g = dt_*sigma_a;
+        dtcsigs_g = dt_*sigma_s;
+        dtcsigp_g = dt_*sigma_p;
+        frac_g = PlanckGroupFraction(nu_edge_.d_view(g), nu_edge_.d_view(g+1), tgas);
+      }
+      AngleSum sa;
+      Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(member, nang1+1),
+      [&](const int n, AngleSum &s) {
+        int nv = n*ngroups_ + g;
+        Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
+                   tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+        Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
+                      u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
+        Real omega_cm = solid_angles_.d_view(n)/SQR(n0_cm);
+        Real intensity_cm = 4.0*M_PI*(i0_(m,nv,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
+        Real vncsigma = 1.0/(n0 + (dtcsiga_g + dtcsigs_g)*n0_cm);
+        Real vncsigma2 = n0_cm*vncsigma;
+        Real ir_weight = intensity_cm*omega_cm;
+        s.the_array[0] += omega_cm;
+        s.the_array[1] += omega_cm*vncsigma2;
+        s.the_array[2] += ir_weight*n0*vncsigma;
+      }, Kokkos::Sum<AngleSum>(sa));
+      wght_sum = sa.the_array[0];
+      suma1 = sa.the_array[1]/wght_sum;
+      suma2 = sa.the_array[2]/wght_sum;
+      suma3 = suma1*(dtcsigs_g - dtcsigp_g);
+      suma1 *= (dtcsiga_g + dtcsigp_g);
+
+      // add contribution of group to coefficients
+      Real dtaucsigap_g = (dtcsiga_g + dtcsigp_g)/u0;
+      coef[1] += ((dtaucsigap_g - dtaucsigap_g*suma1/(1.0-suma3))*frac_g*arad_*
+                  gm1*inv_chat/wdn);
+      coef[0] -= dtaucsigap_g*suma2*gm1*inv_chat/(wdn*(1.0-suma3));
+    }
 
-    // Calculate new gas temperature
+    // Calculate new gas temperature, with Newton iteration if the exact root fails
     Real tgasnew = tgas;
     bool badcell = false;
+    int nit_newton = 0;
     if (fabs(coef[1]) > 1.0e-20) {
       bool flag = FourthPolyRoot(coef[1], coef[0], tgasnew);
+      if (!(flag) || !(isfinite(tgasnew))) {
+        flag = FourthPolyNewton(coef[1], coef[0], tgasnew, nit_newton);
+      }
       if (!(flag) || !(isfinite(tgasnew))) {
         badcell = true;
         tgasnew = tgas;
@@ -226,76 +297,119 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
       tgasnew = -coef[0];
     }
 
-    // Update the specific intensity
+    // Update the specific intensity of each group
     if (!(badcell)) {
-      // Calculate emission coefficient and updated jr_cm
-      Real emission = arad_*SQR(SQR(tgasnew));
-      Real jr_cm = (suma1*emission + suma2)/(1.0 - suma3);
-      Real m_old[4] = {0.0}; Real m_new[4] = {0.0};
-      for (int n=0; n<=nang1; ++n) {
-        // compute coordinate normal components
-        Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-        Real n_1 = tc(m,0,1,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,1,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,1,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,1,k,j,i)*nh_c_.d_view(n,3);
-        Real n_2 = tc(m,0,2,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,2,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,2,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,2,k,j,i)*nh_c_.d_view(n,3);
-        Real n_3 = tc(m,0,3,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,3,k,j,i)*nh_c_.d_view(n,1)
-                 + tc(m,2,3,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,3,k,j,i)*nh_c_.d_view(n,3);
-
-        // compute moments before coupling
-        m_old[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-        m_old[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_old[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_old[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-
-        // update intensity
-        Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
-                      u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
-        Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
-        Real vncsigma = 1.0/(n0 + (dtcsiga + dtcsigs)*n0_cm);
-        Real vncsigma2 = n0_cm*vncsigma;
-        Real di_cm = ( ((dtcsigs-dtcsigp)*jr_cm
-                      + (dtcsiga+dtcsigp)*emission
-                      - (dtcsigs+dtcsiga)*intensity_cm)*vncsigma2 );
-        i0_(m,n,k,j,i) = n0*n_0*fmax(i0_(m,n,k,j,i)/(n0*n_0) +
-                                     di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
-
-        // compute moments after coupling
-        m_new[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-        m_new[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_new[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-        m_new[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-
-        // handle excision
-        // NOTE(@pdmullen): The below zeroes all intensities within rks <= r_excision and
-        // zeroes intensities within angles where n_0 is about zero. When Compton is
-        // enabled, we delay the n_0_floor excision so that intensites updated via
-        // absorption and scattering inform the Compton update
-        if (excise) {
-          bool apply_excision = (rad_mask_(m,k,j,i) ||
-                                 (!(is_compton_enabled_) && fabs(n_0) < n_0_floor_));
-          if (apply_excision) { i0_(m,n,k,j,i) = 0.0; }
+      // change in moments (before minus after coupling), summed over angles and groups
+      Real dmom[4] = {0.0};
+      for (int g=0; g<ngroups_; ++g) {
+        Real dtcsiga_g = dtcsiga, dtcsigs_g = dtcsigs, dtcsigp_g = dtcsigp;
+        Real frac_g = 1.0;
+        if (ngroups_ > 1) {
+          // recompute sums of group (with one group, they are kept from above)
+          OpacityFunction(wdn, density_scale_,
+                          tgas, temperature_scale_,
+                          length_scale_, gm1, mean_mol_weight_,
+                          power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
+                          table_opacity_, opacity_table_,
+                          gkappa_.d_view(g,0), gkappa_.d_view(g,1), gkappa_.d_view(g,2),
+                          sigma_a, sigma_s, sigma_p);
+          dtcsiga_g = dt_*sigma_a;
+          dtcsigs_g = dt_*sigma_s;
+          dtcsigp_g = dt_*sigma_p;
+          frac_g = PlanckGroupFraction(nu_edge_.d_view(g), nu_edge_.d_view(g+1), tgas);
+          AngleSum sa;
+          Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(member, nang1+1),
+          [&](const int n, AngleSum &s) {
+            int nv = n*ngroups_ + g;
+            Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0)+
+                       tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)+
+                       tc(m,2,0,k,j,i)*nh_c_.d_view(n,2)+
+                       tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+            Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
+                          u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
+            Real omega_cm = solid_angles_.d_view(n)/SQR(n0_cm);
+            Real intensity_cm = 4.0*M_PI*(i0_(m,nv,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
+            Real vncsigma = 1.0/(n0 + (dtcsiga_g + dtcsigs_g)*n0_cm);
+            s.the_array[1] += omega_cm*n0_cm*vncsigma;
+            s.the_array[2] += intensity_cm*omega_cm*n0*vncsigma;
+          }, Kokkos::Sum<AngleSum>(sa));
+          suma1 = sa.the_array[1]/wght_sum;
+          suma2 = sa.the_array[2]/wght_sum;
+          suma3 = suma1*(dtcsigs_g - dtcsigp_g);
+          suma1 *= (dtcsiga_g + dtcsigp_g);
         }
+
+        // Calculate emission coefficient and updated jr_cm of group
+        Real emission = frac_g*arad_*SQR(SQR(tgasnew));
+        Real jr_cm = (suma1*emission + suma2)/(1.0 - suma3);
+        AngleSum dm;
+        Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(member, nang1+1),
+        [&](const int n, AngleSum &s) {
+          int nv = n*ngroups_ + g;
+          // compute coordinate normal components
+          Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0)+tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)
+                   + tc(m,2,0,k,j,i)*nh_c_.d_view(n,2)+tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
+          Real n_1 = tc(m,0,1,k,j,i)*nh_c_.d_view(n,0)+tc(m,1,1,k,j,i)*nh_c_.d_view(n,1)
+                   + tc(m,2,1,k,j,i)*nh_c_.d_view(n,2)+tc(m,3,1,k,j,i)*nh_c_.d_view(n,3);
+          Real n_2 = tc(m,0,2,k,j,i)*nh_c_.d_view(n,0)+tc(m,1,2,k,j,i)*nh_c_.d_view(n,1)
+                   + tc(m,2,2,k,j,i)*nh_c_.d_view(n,2)+tc(m,3,2,k,j,i)*nh_c_.d_view(n,3);
+          Real n_3 = tc(m,0,3,k,j,i)*nh_c_.d_view(n,0)+tc(m,1,3,k,j,i)*nh_c_.d_view(n,1)
+                   + tc(m,2,3,k,j,i)*nh_c_.d_view(n,2)+tc(m,3,3,k,j,i)*nh_c_.d_view(n,3);
+
+          // update intensity
+          Real iold = i0_(m,nv,k,j,i);
+          Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
+                        u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
+          Real intensity_cm = 4.0*M_PI*(iold/(n0*n_0))*SQR(SQR(n0_cm));
+          Real vncsigma = 1.0/(n0 + (dtcsiga_g + dtcsigs_g)*n0_cm);
+          Real vncsigma2 = n0_cm*vncsigma;
+          Real di_cm = ( ((dtcsigs_g-dtcsigp_g)*jr_cm
+                        + (dtcsiga_g+dtcsigp_g)*emission
+                        - (dtcsigs_g+dtcsiga_g)*intensity_cm)*vncsigma2 );
+          Real inew = n0*n_0*fmax(iold/(n0*n_0) + di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
+          i0_(m,nv,k,j,i) = inew;
+
+          // change in moments due to coupling
+          Real di = (iold - inew)*solid_angles_.d_view(n);
+          s.the_array[0] += di;
+          s.the_array[1] += n_1*di/n_0;
+          s.the_array[2] += n_2*di/n_0;
+          s.the_array[3] += n_3*di/n_0;
+
+          // handle excision
+          // NOTE(@pdmullen): The below zeroes all intensities within rks <= r_excision
+          // and zeroes intensities within angles where n_0 is about zero. When Compton is
+          // enabled, we delay the n_0_floor excision so that intensites updated via
+          // absorption and scattering inform the Compton update
+          if (excise) {
+            bool apply_excision = (rad_mask_(m,k,j,i) ||
+                                   (!(is_compton_enabled_) && fabs(n_0) < n_0_floor_));
+            if (apply_excision) { i0_(m,nv,k,j,i) = 0.0; }
+          }
+        }, Kokkos::Sum<AngleSum>(dm));
+        for (int c=0; c<4; ++c) {dmom[c] += dm.the_array[c];}
       }
       // update conserved fluid variables
       if (affect_fluid_) {
-        u0_(m,IEN,k,j,i) += (m_old[0] - m_new[0]);
-        u0_(m,IM1,k,j,i) += (m_old[1] - m_new[1]);
-        u0_(m,IM2,k,j,i) += (m_old[2] - m_new[2]);
-        u0_(m,IM3,k,j,i) += (m_old[3] - m_new[3]);
+        Kokkos::single(Kokkos::PerThread(member), [&]() {
+          u0_(m,IEN,k,j,i) += dmom[0]*inv_chat;
+          u0_(m,IM1,k,j,i) += dmom[1]*inv_chat;
+          u0_(m,IM2,k,j,i) += dmom[2]*inv_chat;
+          u0_(m,IM3,k,j,i) += dmom[3]*inv_chat;
+        });
       }
     }
 
-    // compton scattering
+    // compton scattering (only with one frequency group, so angles index intensities)
+    bool anybad = badcell;
     if (is_compton_enabled_) {
       // use partially updated gas temperature
       tgas = tgasnew;
 
       // compute polynomial coefficients using partially updated gas temp and intensity
-      suma1 = 0.0;
-      Real jr_cm = 0.0;
-      for (int n=0; n<=nang1; ++n) {
+      AngleSum sc;
+      Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(member, nang1+1),
+      [&](const int n, AngleSum &s) {
         Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
                    tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
         Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
@@ -303,9 +417,11 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
         Real wght_cm = solid_angles_.d_view(n)/SQR(n0_cm)/wght_sum;
         Real intensity_cm = 4.0*M_PI*(i0_(m,n,k,j,i)/(n0*n_0))*SQR(SQR(n0_cm));
         Real ir_weight = intensity_cm*wght_cm;
-        jr_cm += ir_weight;
-        suma1 += (n0_cm/n0)*4.0*dtcsigs*inv_t_electron_*wght_cm;
-      }
+        s.the_array[0] += ir_weight;
+        s.the_array[1] += (n0_cm/n0)*4.0*dtcsigs*inv_t_electron_*wght_cm;
+      }, Kokkos::Sum<AngleSum>(sc));
+      Real jr_cm = sc.the_array[0];
+      suma1 = sc.the_array[1];
       suma2 = 4.0*dtaucsigs*inv_t_electron_*gm1/wdn;
 
       // compute partially updated radiation temperature
@@ -319,8 +435,14 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
         coef[1] = (1.0 + suma2*jr_cm)/(suma1*jr_cm)*arad_;
         coef[0] = -(1.0 + suma2*jr_cm)/suma1 - tgas;
         bool flag = FourthPolyRoot(coef[1], coef[0], tradnew);
+        if (!(flag) || !(isfinite(tradnew))) {
+          int nit = 0;
+          flag = FourthPolyNewton(coef[1], coef[0], tradnew, nit);
+          nit_newton = (nit > nit_newton)? nit : nit_newton;
+        }
         if (!(flag) || !(isfinite(tradnew))) {
           badcell = true;
+          anybad = true;
         }
       }
 
@@ -328,8 +450,9 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
       if (!(badcell) && !(temp_equil)) {
         // Compute updated gas temperature
         tgasnew = (arad_*SQR(SQR(tradnew)) - jr_cm)/(suma1*jr_cm) + tradnew;
-        Real m_old[4] = {0.0}; Real m_new[4] = {0.0};
-        for (int n=0; n<=nang1; ++n) {
+        AngleSum dm;
+        Kokkos::parallel_reduce(Kokkos::ThreadVectorRange(member, nang1+1),
+        [&](const int n, AngleSum &s) {
           // compute coordinate normal components
           Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0)+tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)
                    + tc(m,2,0,k,j,i)*nh_c_.d_view(n,2)+tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
@@ -340,55 +463,285 @@ TaskStatus Radiation::AddRadiationSourceTerm(Driver *pdriver, int stage) {
           Real n_3 = tc(m,0,3,k,j,i)*nh_c_.d_view(n,0)+tc(m,1,3,k,j,i)*nh_c_.d_view(n,1)
                    + tc(m,2,3,k,j,i)*nh_c_.d_view(n,2)+tc(m,3,3,k,j,i)*nh_c_.d_view(n,3);
 
-          // compute moments before coupling
-          m_old[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-          m_old[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-          m_old[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-          m_old[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-
           // update intensity
+          Real iold = i0_(m,n,k,j,i);
           Real n0_cm = (u_tet[0]*nh_c_.d_view(n,0) - u_tet[1]*nh_c_.d_view(n,1) -
                         u_tet[2]*nh_c_.d_view(n,2) - u_tet[3]*nh_c_.d_view(n,3));
           Real di_cm = (n0_cm/n0)*dtcsigs*4.0*jr_cm*inv_t_electron_*(tgasnew - tradnew);
-          i0_(m,n,k,j,i) = n0*n_0*fmax(i0_(m,n,k,j,i)/(n0*n_0) +
-                                       di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
+          Real inew = n0*n_0*fmax(iold/(n0*n_0) + di_cm/(4.0*M_PI*SQR(SQR(n0_cm))), 0.0);
+          i0_(m,n,k,j,i) = inew;
 
-          // compute moments after coupling
-          m_new[0] += (    i0_(m,n,k,j,i)    *solid_angles_.d_view(n));
-          m_new[1] += (n_1*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-          m_new[2] += (n_2*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
-          m_new[3] += (n_3*i0_(m,n,k,j,i)/n_0*solid_angles_.d_view(n));
+          // change in moments due to coupling
+          Real di = (iold - inew)*solid_angles_.d_view(n);
+          s.the_array[0] += di;
+          s.the_array[1] += n_1*di/n_0;
+          s.the_array[2] += n_2*di/n_0;
+          s.the_array[3] += n_3*di/n_0;
 
           // handle excision (see notes above)
           if (excise) {
             if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { i0_(m,n,k,j,i) = 0.0; }
           }
-        }
+        }, Kokkos::Sum<AngleSum>(dm));
 
         // feedback on fluid
         if (affect_fluid_) {
-          u0_(m,IEN,k,j,i) += (m_old[0] - m_new[0]);
-          u0_(m,IM1,k,j,i) += (m_old[1] - m_new[1]);
-          u0_(m,IM2,k,j,i) += (m_old[2] - m_new[2]);
-          u0_(m,IM3,k,j,i) += (m_old[3] - m_new[3]);
+          Kokkos::single(Kokkos::PerThread(member), [&]() {
+            u0_(m,IEN,k,j,i) += dm.the_array[0];
+            u0_(m,IM1,k,j,i) += dm.the_array[1];
+            u0_(m,IM2,k,j,i) += dm.the_array[2];
+            u0_(m,IM3,k,j,i) += dm.the_array[3];
+          });
         }
       } else {
         // NOTE(@pdmullen): At this point, it is possible that excision has not been
         // entirely applied if Compton is enabled and a badcell or temperature equilibrium
         // was encountered.. apply excision
         if (excise) {
-          for (int n=0; n<=nang1; ++n) {
+          Kokkos::parallel_for(Kokkos::ThreadVectorRange(member, nang1+1),
+          [&](const int n) {
             Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0)+
                        tc(m,1,0,k,j,i)*nh_c_.d_view(n,1)+
                        tc(m,2,0,k,j,i)*nh_c_.d_view(n,2)+
                        tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
             if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { i0_(m,n,k,j,i) = 0.0; }
-          }
+          });
+        }
+      }
+    }
+
+    // convergence statistics
+    if (nit_newton > 0 || anybad) {
+      Kokkos::single(Kokkos::PerThread(member), [&]() {
+        if (nit_newton > 0) {
+          Kokkos::atomic_add(&nstat(0), 1);
+          Kokkos::atomic_max(&nstat(2), nit_newton);
+        }
+        if (anybad) {Kokkos::atomic_add(&nstat(1), 1);}
+      });
+    }
+    });
+  });
+
+  // store convergence statistics in event counters
+  auto nstat_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), nstat);
+  auto &ecounter = pmy_pack->pmesh->ecounter;
+  ecounter.nrad_newton += nstat_h(0);
+  ecounter.nrad_fail += nstat_h(1);
+  ecounter.maxit_rad = std::max(ecounter.maxit_rad, nstat_h(2));
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn TaskStatus Radiation::M1SourceTerm(Driver *pdriver, int stage)
+//! \brief Implicit source term of the M1 method.  In the fluid frame, the energy density
+//! J and flux H of each group are updated over the proper time dtau = dt/u^0 with
+//!   J' = J + dtau (sigma_a+sigma_p)(f_g a T'^4 - J')
+//!   H' = H - dtau (sigma_a+sigma_s) H'
+//! where T' is the root of the quartic for energy conservation in the fluid frame, and
+//! f_g the fraction of Planck emission in group g.  Changes are transformed back to E,F
+//! assuming an Eddington tensor 1/3 for the change in J, and the opposite changes are
+//! applied to the fluid so that total energy and momentum are conserved.
+
+TaskStatus Radiation::M1SourceTerm(Driver *pdriver, int stage) {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int &is = indcs.is, &ie = indcs.ie;
+  int &js = indcs.js, &je = indcs.je;
+  int &ks = indcs.ks, &ke = indcs.ke;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  bool &is_hydro_enabled_ = is_hydro_enabled;
+  bool &is_mhd_enabled_ = is_mhd_enabled;
+  bool &are_units_enabled_ = are_units_enabled;
+  bool &fixed_fluid_ = fixed_fluid;
+  bool &affect_fluid_ = affect_fluid;
+
+  // Extract radiation constant and units
+  Real &arad_ = arad;
+  Real density_scale_ = 1.0, temperature_scale_ = 1.0, length_scale_ = 1.0;
+  Real mean_mol_weight_ = 1.0;
+  Real rosseland_coef_ = 1.0, planck_minus_rosseland_coef_ = 0.0;
+  if (are_units_enabled_) {
+    density_scale_ = pmy_pack->punit->density_cgs();
+    temperature_scale_ = pmy_pack->punit->temperature_cgs();
+    length_scale_ = pmy_pack->punit->length_cgs();
+    mean_mol_weight_ = pmy_pack->punit->mu();
+    rosseland_coef_ = pmy_pack->punit->rosseland_coef_cgs;
+    planck_minus_rosseland_coef_ = pmy_pack->punit->planck_minus_rosseland_coef_cgs;
+  }
+
+  // Extract adiabatic index
+  Real gm1;
+  if (is_hydro_enabled_) {
+    gm1 = pmy_pack->phydro->peos->eos_data.gamma - 1.0;
+  } else if (is_mhd_enabled_) {
+    gm1 = pmy_pack->pmhd->peos->eos_data.gamma - 1.0;
+  }
+
+  // Extract radiation data (opacities of each group default to grey values)
+  auto &i0_ = i0;
+  bool &power_opacity_ = power_opacity;
+  bool &table_opacity_ = table_opacity;
+  auto &opacity_table_ = opacity_table;
+  int ngroups_ = ngroups;
+  auto &nu_edge_ = nu_edge;
+  auto &gkappa_ = group_kappa;
+  Real efloor = m1_efloor;
+
+  // Extract hydro/mhd quantities
+  DvceArray5D<Real> u0_, w0_;
+  if (is_hydro_enabled_) {
+    u0_ = pmy_pack->phydro->u0;
+    w0_ = pmy_pack->phydro->w0;
+  } else if (is_mhd_enabled_) {
+    u0_ = pmy_pack->pmhd->u0;
+    w0_ = pmy_pack->pmhd->w0;
+  }
+
+  // Extract timestep.  With a reduced speed of light c_hat, radiation evolves over
+  // c_hat*dt, while the fluid (which exchanges energy and momentum at the true speed of
+  // light) receives 1/c_hat times the change of the radiation moments.
+  Real dt_ = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt)*c_hat;
+  Real inv_chat = 1.0/c_hat;
+
+  // Call ConsToPrim over active zones prior to source term application
+  if (!(fixed_fluid_)) {
+    if (is_hydro_enabled_) {
+      pmy_pack->phydro->peos->ConsToPrim(u0_,w0_,false,is,ie,js,je,ks,ke);
+    } else if (is_mhd_enabled_) {
+      auto &b0_ = pmy_pack->pmhd->b0;
+      auto &bcc0_ = pmy_pack->pmhd->bcc0;
+      pmy_pack->pmhd->peos->ConsToPrim(u0_,b0_,w0_,bcc0_,false,is,ie,js,je,ks,ke);
+    }
+  }
+
+  // Counters of cells solved by Newton iteration, cells that failed, and maximum number
+  // of Newton iterations (as for discrete ordinates)
+  DvceArray1D<int> nstat("rad_src_stats", 3);
+  Kokkos::deep_copy(nstat, 0);
+
+  par_for("m1_source",DevExeSpace(),0,nmb1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    // fluid state
+    Real &wdn = w0_(m,IDN,k,j,i);
+    Real &wen = w0_(m,IEN,k,j,i);
+    Real tgas = gm1*wen/wdn;
+    Real uu[4];
+    uu[1] = w0_(m,IVX,k,j,i);
+    uu[2] = w0_(m,IVY,k,j,i);
+    uu[3] = w0_(m,IVZ,k,j,i);
+    uu[0] = sqrt(1.0 + SQR(uu[1]) + SQR(uu[2]) + SQR(uu[3]));
+
+    // Calculate polynomial coefficients, summed over frequency groups
+    Real coef[2];
+    coef[1] = 0.0;
+    coef[0] = -tgas;
+    for (int g=0; g<ngroups_; ++g) {
+      Real e = i0_(m,IRE*ngroups_+g,k,j,i);
+      Real f[3] = {i0_(m,IRF1*ngroups_+g,k,j,i), i0_(m,IRF2*ngroups_+g,k,j,i),
+                   i0_(m,IRF3*ngroups_+g,k,j,i)};
+      Real jr, hl[4];
+      M1FluidFrame(e, f, uu, jr, hl);
+      Real sigma_a, sigma_s, sigma_p;
+      OpacityFunction(wdn, density_scale_,
+                      tgas, temperature_scale_,
+                      length_scale_, gm1, mean_mol_weight_,
+                      power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
+                      table_opacity_, opacity_table_,
+                      gkappa_.d_view(g,0), gkappa_.d_view(g,1), gkappa_.d_view(g,2),
+                      sigma_a, sigma_s, sigma_p);
+      Real frac_g = (ngroups_ > 1)?
+          PlanckGroupFraction(nu_edge_.d_view(g), nu_edge_.d_view(g+1), tgas) : 1.0;
+      Real sj = dt_*(sigma_a + sigma_p)/uu[0];
+      coef[1] += sj*frac_g*arad_*gm1*inv_chat/(wdn*(1.0 + sj));
+      coef[0] -= sj*jr*gm1*inv_chat/(wdn*(1.0 + sj));
+    }
+
+    // Calculate new gas temperature, with Newton iteration if the exact root fails
+    Real tgasnew = tgas;
+    bool badcell = false;
+    int nit_newton = 0;
+    if (fabs(coef[1]) > 1.0e-20) {
+      bool flag = FourthPolyRoot(coef[1], coef[0], tgasnew);
+      if (!(flag) || !(isfinite(tgasnew))) {
+        flag = FourthPolyNewton(coef[1], coef[0], tgasnew, nit_newton);
+      }
+      if (!(flag) || !(isfinite(tgasnew))) {
+        badcell = true;
+      }
+    } else {
+      tgasnew = -coef[0];
+    }
+
+    // Update E and F of each group
+    if (!(badcell)) {
+      Real dmom[4] = {0.0};
+      for (int g=0; g<ngroups_; ++g) {
+        Real e = i0_(m,IRE*ngroups_+g,k,j,i);
+        Real f[3] = {i0_(m,IRF1*ngroups_+g,k,j,i), i0_(m,IRF2*ngroups_+g,k,j,i),
+                     i0_(m,IRF3*ngroups_+g,k,j,i)};
+        Real jr, hl[4];
+        M1FluidFrame(e, f, uu, jr, hl);
+        Real sigma_a, sigma_s, sigma_p;
+        OpacityFunction(wdn, density_scale_,
+                        tgas, temperature_scale_,
+                        length_scale_, gm1, mean_mol_weight_,
+                        power_opacity_, rosseland_coef_, planck_minus_rosseland_coef_,
+                        table_opacity_, opacity_table_,
+                        gkappa_.d_view(g,0), gkappa_.d_view(g,1), gkappa_.d_view(g,2),
+                        sigma_a, sigma_s, sigma_p);
+        Real frac_g = (ngroups_ > 1)?
+            PlanckGroupFraction(nu_edge_.d_view(g), nu_edge_.d_view(g+1), tgas) : 1.0;
+        Real sj = dt_*(sigma_a + sigma_p)/uu[0];
+        Real sh = dt_*(sigma_a + sigma_s)/uu[0];
+
+        // change in fluid frame quantities, and contravariant dH
+        Real djr = sj*(frac_g*arad_*SQR(SQR(tgasnew)) - jr)/(1.0 + sj);
+        Real dhu[4];
+        dhu[0] = hl[0]*sh/(1.0 + sh);
+        for (int d=1; d<4; ++d) {dhu[d] = -hl[d]*sh/(1.0 + sh);}
+
+        // change in E and F from dR = dJ(u u + h/3) + u dH + dH u
+        Real enew = e + djr*(SQR(uu[0]) + (SQR(uu[0]) - 1.0)/3.0) + 2.0*uu[0]*dhu[0];
+        Real fnew[3];
+        for (int d=0; d<3; ++d) {
+          fnew[d] = f[d] + (4.0/3.0)*djr*uu[0]*uu[d+1] + uu[0]*dhu[d+1]
+                  + uu[d+1]*dhu[0];
         }
+        M1Limit(efloor, enew, fnew);
+        i0_(m,IRE*ngroups_+g,k,j,i) = enew;
+        i0_(m,IRF1*ngroups_+g,k,j,i) = fnew[0];
+        i0_(m,IRF2*ngroups_+g,k,j,i) = fnew[1];
+        i0_(m,IRF3*ngroups_+g,k,j,i) = fnew[2];
+
+        // change in moments R^0_mu (before minus after coupling)
+        dmom[0] += enew - e;
+        for (int d=0; d<3; ++d) {dmom[d+1] += f[d] - fnew[d];}
+      }
+      // update conserved fluid variables
+      if (affect_fluid_) {
+        u0_(m,IEN,k,j,i) += dmom[0]*inv_chat;
+        u0_(m,IM1,k,j,i) += dmom[1]*inv_chat;
+        u0_(m,IM2,k,j,i) += dmom[2]*inv_chat;
+        u0_(m,IM3,k,j,i) += dmom[3]*inv_chat;
       }
     }
+
+    // convergence statistics
+    if (nit_newton > 0) {
+      Kokkos::atomic_add(&nstat(0), 1);
+      Kokkos::atomic_max(&nstat(2), nit_newton);
+    }
+    if (badcell) {Kokkos::atomic_add(&nstat(1), 1);}
   });
 
+  // store convergence statistics in event counters
+  auto nstat_h = Kokkos::create_mirror_view_and_copy(HostMemSpace(), nstat);
+  auto &ecounter = pmy_pack->pmesh->ecounter;
+  ecounter.nrad_newton += nstat_h(0);
+  ecounter.nrad_fail += nstat_h(1);
+  ecounter.maxit_rad = std::max(ecounter.maxit_rad, nstat_h(2));
+
   return TaskStatus::complete;
 }
 
@@ -434,4 +787,32 @@ bool FourthPolyRoot(const Real coef4, const Real tconst, Real &root) {
   return true;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn  bool FourthPolyNewton
+//  \brief Newton iteration for the positive root of coef4 * x^4 + x + tconst = 0, used
+//  when the exact solution in FourthPolyRoot fails due to round-off.  For coef4 > 0 and
+//  tconst < 0 the function is convex and increasing for x > 0, so iteration started at
+//  x = -tconst (where the function is positive) converges monotonically.  Returns the
+//  number of iterations in niter.
+
+KOKKOS_INLINE_FUNCTION
+bool FourthPolyNewton(const Real coef4, const Real tconst, Real &root, int &niter) {
+  constexpr int maxit = 50;
+  niter = 0;
+  if (!(coef4 > 0.0) || !(tconst < 0.0)) {
+    return false;
+  }
+  Real x = -tconst;
+  for (niter=1; niter<=maxit; ++niter) {
+    Real x3 = x*x*x;
+    Real dx = (coef4*x3*x + x + tconst)/(4.0*coef4*x3 + 1.0);
+    x -= dx;
+    if (fabs(dx) <= 1.0e-12*x) {
+      root = x;
+      return (x > 0.0);
+    }
+  }
+  return false;
+}
+
 } // namespace radiation
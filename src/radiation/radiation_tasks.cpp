@@ -56,20 +56,54 @@ void Radiation::AssembleRadTasks(std::map<std::string, std::shared_ptr<TaskList>
     id.mhd_ct    = tl["stagen"]->AddTask(&mhd::MHD::CT, pmhd, id.mhd_recve);
     id.rad_src   = tl["stagen"]->AddTask(
                                     &Radiation::AddRadiationSourceTerm,this,id.mhd_ct);
-    id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src);
-    id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
-    id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi);
-    id.mhd_restu = tl["stagen"]->AddTask(&mhd::MHD::RestrictU, pmhd, id.rad_recvi);
-    id.mhd_sendu = tl["stagen"]->AddTask(&mhd::MHD::SendU, pmhd, id.mhd_restu);
-    id.mhd_recvu = tl["stagen"]->AddTask(&mhd::MHD::RecvU, pmhd, id.mhd_sendu);
-    id.mhd_restb = tl["stagen"]->AddTask(&mhd::MHD::RestrictB, pmhd, id.mhd_recvu);
-    id.mhd_sendb = tl["stagen"]->AddTask(&mhd::MHD::SendB, pmhd, id.mhd_restb);
-    id.mhd_recvb = tl["stagen"]->AddTask(&mhd::MHD::RecvB, pmhd, id.mhd_sendb);
+    if (coalesce_halo) {
+      // U is restricted, packed, and sent with I, so only B is communicated separately
+      id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src);
+      id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
+      id.mhd_restb = tl["stagen"]->AddTask(&mhd::MHD::RestrictB, pmhd, id.rad_sendi);
+      id.mhd_sendb = tl["stagen"]->AddTask(&mhd::MHD::SendB, pmhd, id.mhd_restb);
+      if (pmhd->split_c2p) {
+        id.mhd_c2pa  = tl["stagen"]->AddTask(
+                                       &mhd::MHD::ConToPrimActive, pmhd, id.mhd_sendb);
+        id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.mhd_c2pa);
+      } else {
+        id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.mhd_sendb);
+      }
+      id.mhd_recvb = tl["stagen"]->AddTask(&mhd::MHD::RecvB, pmhd, id.rad_recvi);
+    } else if (pmhd->split_c2p) {
+      // fluid is not modified after radiation source terms, so communication of U, B,
+      // and I overlap with each other and with C2P of fluid in active cells
+      id.mhd_restu = tl["stagen"]->AddTask(&mhd::MHD::RestrictU, pmhd, id.rad_src);
+      id.mhd_sendu = tl["stagen"]->AddTask(&mhd::MHD::SendU, pmhd, id.mhd_restu);
+      id.mhd_restb = tl["stagen"]->AddTask(&mhd::MHD::RestrictB, pmhd, id.mhd_sendu);
+      id.mhd_sendb = tl["stagen"]->AddTask(&mhd::MHD::SendB, pmhd, id.mhd_restb);
+      id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.mhd_sendb);
+      id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
+      id.mhd_c2pa  = tl["stagen"]->AddTask(
+                                     &mhd::MHD::ConToPrimActive, pmhd, id.rad_sendi);
+      id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.mhd_c2pa);
+      id.mhd_recvu = tl["stagen"]->AddTask(&mhd::MHD::RecvU, pmhd, id.rad_recvi);
+      id.mhd_recvb = tl["stagen"]->AddTask(&mhd::MHD::RecvB, pmhd, id.mhd_recvu);
+    } else {
+      id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src);
+      id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
+      id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi);
+      id.mhd_restu = tl["stagen"]->AddTask(&mhd::MHD::RestrictU, pmhd, id.rad_recvi);
+      id.mhd_sendu = tl["stagen"]->AddTask(&mhd::MHD::SendU, pmhd, id.mhd_restu);
+      id.mhd_recvu = tl["stagen"]->AddTask(&mhd::MHD::RecvU, pmhd, id.mhd_sendu);
+      id.mhd_restb = tl["stagen"]->AddTask(&mhd::MHD::RestrictB, pmhd, id.mhd_recvu);
+      id.mhd_sendb = tl["stagen"]->AddTask(&mhd::MHD::SendB, pmhd, id.mhd_restb);
+      id.mhd_recvb = tl["stagen"]->AddTask(&mhd::MHD::RecvB, pmhd, id.mhd_sendb);
+    }
     id.bcs       = tl["stagen"]->AddTask(
                                     &Radiation::ApplyPhysicalBCs, this, id.mhd_recvb);
     id.rad_prol  = tl["stagen"]->AddTask(&Radiation::Prolongate, this, id.bcs);
     id.mhd_prol  = tl["stagen"]->AddTask(&mhd::MHD::Prolongate, pmhd, id.rad_prol);
-    id.mhd_c2p   = tl["stagen"]->AddTask(&mhd::MHD::ConToPrim, pmhd, id.mhd_prol);
+    if (pmhd->split_c2p) {
+      id.mhd_c2p = tl["stagen"]->AddTask(&mhd::MHD::ConToPrimGhost, pmhd, id.mhd_prol);
+    } else {
+      id.mhd_c2p = tl["stagen"]->AddTask(&mhd::MHD::ConToPrim, pmhd, id.mhd_prol);
+    }
 
     // assemble "after_stagen" task list
     id.rad_csend = tl["after_stagen"]->AddTask(&Radiation::ClearSend, this, none);
@@ -97,17 +131,46 @@ void Radiation::AssembleRadTasks(std::map<std::string, std::shared_ptr<TaskList>
     id.hyd_rkupdt= tl["stagen"]->AddTask(&hydro::Hydro::RKUpdate,phyd,id.hyd_recvf);
     id.rad_src   = tl["stagen"]->AddTask(
                                    &Radiation::AddRadiationSourceTerm,this,id.hyd_rkupdt);
-    id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src);
-    id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
-    id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi);
-    id.hyd_restu = tl["stagen"]->AddTask(&hydro::Hydro::RestrictU, phyd, id.rad_recvi);
-    id.hyd_sendu = tl["stagen"]->AddTask(&hydro::Hydro::SendU, phyd, id.hyd_restu);
-    id.hyd_recvu = tl["stagen"]->AddTask(&hydro::Hydro::RecvU, phyd, id.hyd_sendu);
-    id.bcs       = tl["stagen"]->AddTask(
-                                    &Radiation::ApplyPhysicalBCs, this, id.hyd_recvu);
+    if (coalesce_halo) {
+      // U is restricted, packed, and sent with I
+      id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src);
+      id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
+      if (phyd->split_c2p) {
+        id.hyd_c2pa  = tl["stagen"]->AddTask(
+                                     &hydro::Hydro::ConToPrimActive, phyd, id.rad_sendi);
+        id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.hyd_c2pa);
+      } else {
+        id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi);
+      }
+    } else if (phyd->split_c2p) {
+      // fluid is not modified after radiation source terms, so communication of U and I
+      // overlap with each other and with C2P of fluid in active cells
+      id.hyd_restu = tl["stagen"]->AddTask(&hydro::Hydro::RestrictU, phyd, id.rad_src);
+      id.hyd_sendu = tl["stagen"]->AddTask(&hydro::Hydro::SendU, phyd, id.hyd_restu);
+      id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.hyd_sendu);
+      id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
+      id.hyd_c2pa  = tl["stagen"]->AddTask(
+                                   &hydro::Hydro::ConToPrimActive, phyd, id.rad_sendi);
+      id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.hyd_c2pa);
+      id.hyd_recvu = tl["stagen"]->AddTask(&hydro::Hydro::RecvU, phyd, id.rad_recvi);
+    } else {
+      id.rad_resti = tl["stagen"]->AddTask(&Radiation::RestrictI, this, id.rad_src);
+      id.rad_sendi = tl["stagen"]->AddTask(&Radiation::SendI, this, id.rad_resti);
+      id.rad_recvi = tl["stagen"]->AddTask(&Radiation::RecvI, this, id.rad_sendi);
+      id.hyd_restu = tl["stagen"]->AddTask(&hydro::Hydro::RestrictU, phyd, id.rad_recvi);
+      id.hyd_sendu = tl["stagen"]->AddTask(&hydro::Hydro::SendU, phyd, id.hyd_restu);
+      id.hyd_recvu = tl["stagen"]->AddTask(&hydro::Hydro::RecvU, phyd, id.hyd_sendu);
+    }
+    TaskID recvu = (coalesce_halo)? id.rad_recvi : id.hyd_recvu;
+    id.bcs       = tl["stagen"]->AddTask(&Radiation::ApplyPhysicalBCs, this, recvu);
     id.rad_prol  = tl["stagen"]->AddTask(&Radiation::Prolongate, this, id.bcs);
     id.hyd_prol  = tl["stagen"]->AddTask(&hydro::Hydro::Prolongate, phyd, id.rad_prol);
-    id.hyd_c2p   = tl["stagen"]->AddTask(&hydro::Hydro::ConToPrim, phyd, id.hyd_prol);
+    if (phyd->split_c2p) {
+      id.hyd_c2p = tl["stagen"]->AddTask(
+                                     &hydro::Hydro::ConToPrimGhost, phyd, id.hyd_prol);
+    } else {
+      id.hyd_c2p = tl["stagen"]->AddTask(&hydro::Hydro::ConToPrim, phyd, id.hyd_prol);
+    }
 
     // assemble "after_stagen" task list
     // assemble end task list
@@ -155,14 +218,14 @@ void Radiation::AssembleRadTasks(std::map<std::string, std::shared_ptr<TaskList>
 
 TaskStatus Radiation::InitRecv(Driver *pdrive, int stage) {
   // post receives for I
-  TaskStatus tstat = pbval_i->InitRecv(prgeo->nangles);
+  TaskStatus tstat = pbval_i->InitRecv(nvar_halo);
   if (tstat != TaskStatus::complete) return tstat;
 
   // do not post receives for fluxes when stage < 0 (i.e. ICs)
   if (stage >= 0) {
     // with SMR/AMR, post receives for fluxes of I
     if (pmy_pack->pmesh->multilevel) {
-      tstat = pbval_i->InitFluxRecv(prgeo->nangles);
+      tstat = pbval_i->InitFluxRecv(nvar);
       if (tstat != TaskStatus::complete) return tstat;
     }
   }
@@ -190,6 +253,28 @@ TaskStatus Radiation::CopyCons(Driver *pdrive, int stage) {
     } else if (phyd != nullptr) {
       Kokkos::deep_copy(DevExeSpace(), phyd->u1, phyd->u0);
     }
+  } else if (pdrive->low_storage && pdrive->delta[stage-1] != 0.0) {
+    // later stages of low-storage (2S) integrators: radiation updated here, fluid
+    // updated by CopyCons of hydro or MHD
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    int is = indcs.is, ie = indcs.ie;
+    int js = indcs.js, je = indcs.je;
+    int ks = indcs.ks, ke = indcs.ke;
+    int nmb1 = pmy_pack->nmb_thispack - 1;
+    auto &i0_ = i0;
+    auto &i1_ = i1;
+    Real delta = pdrive->delta[stage-1];
+    par_for("rad_copy_cons_2s", DevExeSpace(),0, nmb1, 0, nvar-1, ks, ke, js, je, is, ie,
+    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      i1_(m,n,k,j,i) += delta*i0_(m,n,k,j,i);
+    });
+    hydro::Hydro *phyd = pmy_pack->phydro;
+    mhd::MHD *pmhd = pmy_pack->pmhd;
+    if (pmhd != nullptr) {
+      (void) pmhd->CopyCons(pdrive, stage);
+    } else if (phyd != nullptr) {
+      (void) phyd->CopyCons(pdrive, stage);
+    }
   }
   return TaskStatus::complete;
 }
@@ -230,16 +315,44 @@ TaskStatus Radiation::RestrictI(Driver *pdrive, int stage) {
   // Only execute Mesh function with SMR/AMR
   if (pmy_pack->pmesh->multilevel) {
     pmy_pack->pmesh->pmr->RestrictCC(i0, coarse_i0);
+    // fluid variables sent with I must also be restricted
+    if (coalesce_halo) {
+      if (pmy_pack->pmhd != nullptr) {
+        pmy_pack->pmesh->pmr->RestrictCC(pmy_pack->pmhd->u0, pmy_pack->pmhd->coarse_u0);
+      } else {
+        pmy_pack->pmesh->pmr->RestrictCC(pmy_pack->phydro->u0,
+                                         pmy_pack->phydro->coarse_u0);
+      }
+    }
   }
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn CCFieldList Radiation::HaloFields
+//! \brief Returns list of arrays communicated in pbval_i buffers: intensities, followed
+//! by conserved fluid variables with coalesce_halo
+
+CCFieldList Radiation::HaloFields() {
+  CCFieldList flds;
+  flds.Add(i0, coarse_i0);
+  if (coalesce_halo) {
+    if (pmy_pack->pmhd != nullptr) {
+      flds.Add(pmy_pack->pmhd->u0, pmy_pack->pmhd->coarse_u0);
+    } else {
+      flds.Add(pmy_pack->phydro->u0, pmy_pack->phydro->coarse_u0);
+    }
+  }
+  return flds;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn TaskStatus Radiation::SendI
 //! \brief Wrapper task list function to pack/send cell-centered conserved variables
+//! With coalesce_halo, conserved fluid variables are sent in the same messages.
 
 TaskStatus Radiation::SendI(Driver *pdrive, int stage) {
-  TaskStatus tstat = pbval_i->PackAndSendCC(i0, coarse_i0);
+  TaskStatus tstat = pbval_i->PackAndSendCC(HaloFields());
   return tstat;
 }
 
@@ -248,7 +361,7 @@ TaskStatus Radiation::SendI(Driver *pdrive, int stage) {
 //! \brief Wrapper task list function to receive/unpack cell-centered conserved variables
 
 TaskStatus Radiation::RecvI(Driver *pdrive, int stage) {
-  TaskStatus tstat = pbval_i->RecvAndUnpackCC(i0, coarse_i0);
+  TaskStatus tstat = pbval_i->RecvAndUnpackCC(HaloFields());
   return tstat;
 }
 
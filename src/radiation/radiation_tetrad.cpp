@@ -9,6 +9,8 @@
 #include <math.h>
 #include <float.h>
 
+#include <vector>
+
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "coordinates/cartesian_ks.hpp"
@@ -175,8 +177,8 @@ void Radiation::SetOrthonormalTetrad() {
     for (int d=0; d<4; ++d) { tet_d3_x3f_(m,d,k,j,i) = e[d][3]; }
   });
 
-  // Calculate n^angle
-  if (angular_fluxes) {
+  // Calculate n^angle (unless it is recomputed in the flux kernel)
+  if (angular_fluxes && store_na) {
     auto uflux = prgeo->unit_flux;
     auto nh_f_ = nh_f;
     auto na_ = na;
@@ -202,18 +204,7 @@ void Radiation::SetOrthonormalTetrad() {
       ComputeTetrad(x1v,x2v,x3v,flat,spin,glower,gupper,dgx,dgy,dgz,e,e_cov,omega);
       for (int n=0; n<=nang1; ++n) {
         for (int nb=0; nb<num_neighbors_.d_view(n); ++nb) {
-          Real iszetaf = 1.0/sqrt(1.0 - SQR(nh_f_.d_view(n,nb,3)));
-          Real na1 = 0.0; Real na2 = 0.0;
-          for (int q=0; q<4; ++q) {
-            for (int p=0; p<4; ++p) {
-              Real nhfqp = nh_f_.d_view(n,nb,q)*nh_f_.d_view(n,nb,p);
-              na1 += (nhfqp*(nh_f_.d_view(n,nb,0)*omega[3][q][p] -
-                             nh_f_.d_view(n,nb,3)*omega[0][q][p]));
-              na2 += (nhfqp*(nh_f_.d_view(n,nb,2)*omega[1][q][p] -
-                             nh_f_.d_view(n,nb,1)*omega[2][q][p]));
-            }
-          }
-          na_(m,n,k,j,i,nb) = iszetaf*na1*uflux.d_view(n,nb,0)+na2*uflux.d_view(n,nb,1);
+          na_(m,n,k,j,i,nb) = AngularFluxNormal(nh_f_, uflux, n, nb, omega);
         }
       }
     });
@@ -277,4 +268,135 @@ void Radiation::SetOrthonormalTetrad() {
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn  void Radiation::SetFaceNormals()
+//! \brief Caches n^i = (tetrad)^i_a nh^a on faces in each direction for every angle,
+//! and 1/n_0 at cell centers, from the tetrads set in SetOrthonormalTetrad().  Must be
+//! called again whenever the tetrads change.
+
+void Radiation::SetFaceNormals() {
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  int nang1 = prgeo->nangles - 1;
+  auto &nh_c_ = nh_c;
+
+  auto &t1d1 = tet_d1_x1f;
+  auto &nf1 = nface.x1f;
+  par_for("rad_nface1",DevExeSpace(),0,nmb1,0,nang1,0,(t1d1.extent_int(2)-1),
+          0,(t1d1.extent_int(3)-1),0,(t1d1.extent_int(4)-1),
+  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+    nf1(m,n,k,j,i) = t1d1(m,0,k,j,i)*nh_c_.d_view(n,0)
+                   + t1d1(m,1,k,j,i)*nh_c_.d_view(n,1)
+                   + t1d1(m,2,k,j,i)*nh_c_.d_view(n,2)
+                   + t1d1(m,3,k,j,i)*nh_c_.d_view(n,3);
+  });
+
+  if (pmy_pack->pmesh->multi_d) {
+    auto &t2d2 = tet_d2_x2f;
+    auto &nf2 = nface.x2f;
+    par_for("rad_nface2",DevExeSpace(),0,nmb1,0,nang1,0,(t2d2.extent_int(2)-1),
+            0,(t2d2.extent_int(3)-1),0,(t2d2.extent_int(4)-1),
+    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      nf2(m,n,k,j,i) = t2d2(m,0,k,j,i)*nh_c_.d_view(n,0)
+                     + t2d2(m,1,k,j,i)*nh_c_.d_view(n,1)
+                     + t2d2(m,2,k,j,i)*nh_c_.d_view(n,2)
+                     + t2d2(m,3,k,j,i)*nh_c_.d_view(n,3);
+    });
+  }
+
+  if (pmy_pack->pmesh->three_d) {
+    auto &t3d3 = tet_d3_x3f;
+    auto &nf3 = nface.x3f;
+    par_for("rad_nface3",DevExeSpace(),0,nmb1,0,nang1,0,(t3d3.extent_int(2)-1),
+            0,(t3d3.extent_int(3)-1),0,(t3d3.extent_int(4)-1),
+    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      nf3(m,n,k,j,i) = t3d3(m,0,k,j,i)*nh_c_.d_view(n,0)
+                     + t3d3(m,1,k,j,i)*nh_c_.d_view(n,1)
+                     + t3d3(m,2,k,j,i)*nh_c_.d_view(n,2)
+                     + t3d3(m,3,k,j,i)*nh_c_.d_view(n,3);
+    });
+  }
+
+  auto &tet_c_ = tet_c;
+  auto &inv_n0_ = inv_n0;
+  par_for("rad_inv_n0",DevExeSpace(),0,nmb1,0,(inv_n0_.extent_int(1)-1),
+          0,(inv_n0_.extent_int(2)-1),0,(inv_n0_.extent_int(3)-1),
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    inv_n0_(m,k,j,i) = 1.0/tet_c_(m,0,0,k,j,i);
+  });
+
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn  void Radiation::SetUpwindHalo()
+//! \brief Fluxes at a face upwind intensities from the side the direction n^i points
+//! from, and the reconstruction on the downwind side reads one fewer cell.  So a
+//! MeshBlock only needs (nst-1) layers of ghost zones across a face for intensities
+//! whose direction points out of it through that face (nst = cells in stencil on each
+//! side of face).  Angles are classified by the sign of n^i on all faces of the Mesh,
+//! so that all ranks agree, and intensities of angles with n^i < 0 (n^i > 0) everywhere
+//! are sent with fewer ghost zones in buffers travelling in the +x_i (-x_i) direction.
+//! In flat spacetime this is half of all angles in each direction.
+
+void Radiation::SetUpwindHalo() {
+  if (pmy_pack->pmesh->multilevel) {return;}
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int nmb = pmy_pack->nmb_thispack;
+  int nang = prgeo->nangles;
+  auto &nh_c_ = nh_c;
+
+  // range of n^i over faces normal to x_i, for each angle
+  std::vector<Real> nfmin(3*nang, 0.0), nfmax(3*nang, 0.0);
+  for (int d=0; d<3; ++d) {
+    if ((d == 1 && !(pmy_pack->pmesh->multi_d)) ||
+        (d == 2 && !(pmy_pack->pmesh->three_d))) continue;
+    auto &tet = (d == 0)? tet_d1_x1f : ((d == 1)? tet_d2_x2f : tet_d3_x3f);
+    const int nx1 = indcs.nx1 + ((d == 0)? 1 : 0);
+    const int nx2 = indcs.nx2 + ((d == 1)? 1 : 0);
+    const int nx3 = indcs.nx3 + ((d == 2)? 1 : 0);
+    const int nkji = nx3*nx2*nx1;
+    const int nji  = nx2*nx1;
+    for (int a=0; a<nang; ++a) {
+      Real amin = FLT_MAX, amax = -FLT_MAX;
+      Kokkos::parallel_reduce("rad_nf_range",
+                              Kokkos::RangePolicy<>(DevExeSpace(), 0, nmb*nkji),
+      KOKKOS_LAMBDA(const int &idx, Real &min_nf, Real &max_nf) {
+        int m = (idx)/nkji;
+        int k = (idx - m*nkji)/nji;
+        int j = (idx - m*nkji - k*nji)/nx1;
+        int i = (idx - m*nkji - k*nji - j*nx1) + is;
+        k += ks;
+        j += js;
+        Real nf = tet(m,0,k,j,i)*nh_c_.d_view(a,0) + tet(m,1,k,j,i)*nh_c_.d_view(a,1)
+                + tet(m,2,k,j,i)*nh_c_.d_view(a,2) + tet(m,3,k,j,i)*nh_c_.d_view(a,3);
+        min_nf = fmin(nf, min_nf);
+        max_nf = fmax(nf, max_nf);
+      }, Kokkos::Min<Real>(amin), Kokkos::Max<Real>(amax));
+      nfmin[d*nang + a] = amin;
+      nfmax[d*nang + a] = amax;
+    }
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, nfmin.data(), 3*nang, MPI_ATHENA_REAL, MPI_MIN,
+                MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, nfmax.data(), 3*nang, MPI_ATHENA_REAL, MPI_MAX,
+                MPI_COMM_WORLD);
+#endif
+
+  // flag intensities (but not fluid variables coalesced into same buffers) for each
+  // direction of travel (+x1,-x1,...,-x3) of data
+  std::vector<int> flags(6*nvar_halo, 0);
+  for (int t=0; t<6; ++t) {
+    for (int n=0; n<nvar; ++n) {
+      int a = (t/2)*nang + n/ngroups;
+      bool out = (t % 2 == 0)? (nfmax[a] < 0.0) : (nfmin[a] > 0.0);
+      flags[t*nvar_halo + n] = out? 1 : 0;
+    }
+  }
+  int nst = (recon_method > 1)? 3 : ((recon_method > 0)? 2 : 1);
+  pbval_i->SetDirectionalHalo(flags, nst-1);
+  return;
+}
+
 } // namespace radiation
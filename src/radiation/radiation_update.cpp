@@ -26,11 +26,13 @@ namespace radiation {
 //  \brief Explicit RK update of flux divergence and physical source terms
 
 TaskStatus Radiation::RKUpdate(Driver *pdriver, int stage) {
+  if (is_m1_enabled) {return M1RKUpdate(pdriver, stage);}
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int &is = indcs.is, &ie = indcs.ie;
   int &js = indcs.js, &je = indcs.je;
   int &ks = indcs.ks, &ke = indcs.ke;
-  int nang1 = prgeo->nangles - 1;
+  int nvar1 = nvar - 1;
+  int ngroups_ = ngroups;
   int nmb1 = pmy_pack->nmb_thispack - 1;
 
   auto &mbsize  = pmy_pack->pmb->mb_size;
@@ -40,7 +42,8 @@ TaskStatus Radiation::RKUpdate(Driver *pdriver, int stage) {
 
   Real &gam0 = pdriver->gam0[stage-1];
   Real &gam1 = pdriver->gam1[stage-1];
-  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt);
+  // radiation propagates at the (possibly reduced) speed of light c_hat
+  Real beta_dt = (pdriver->beta[stage-1])*(pmy_pack->pmesh->dt)*c_hat;
 
   auto &i0_ = i0;
   auto &i1_ = i1;
@@ -59,35 +62,40 @@ TaskStatus Radiation::RKUpdate(Driver *pdriver, int stage) {
   auto &rad_mask_ = pmy_pack->pcoord->excision_floor;
   Real &n_0_floor_ = n_0_floor;
 
-  par_for("r_update",DevExeSpace(),0,nmb1,0,nang1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-    // spatial fluxes
-    Real divf_s = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
-    if (multi_d) {
-      divf_s += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
-    }
-    if (three_d) {
-      divf_s += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
-    }
-    i0_(m,n,k,j,i) = gam0*i0_(m,n,k,j,i)+gam1*i1_(m,n,k,j,i)-beta_dt*divf_s;
-
-    // angular fluxes
-    if (angular_fluxes_) { i0_(m,n,k,j,i) -= beta_dt*divfa_(m,n,k,j,i); }
-
-    // zero intensity if negative
-    Real n0  = tt(m,0,0,k,j,i);
-    Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(n,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(n,1) +
-               tc(m,2,0,k,j,i)*nh_c_.d_view(n,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(n,3);
-    i0_(m,n,k,j,i) = n0*n_0*fmax((i0_(m,n,k,j,i)/(n0*n_0)), 0.0);
-
-    // handle excision
-    // NOTE(@pdmullen): exicision criterion are not finalized.  The below zeroes all
-    // intensities within rks <= 1.0 and zeroes intensities within angles where n_0
-    // is about zero.  This needs future attention.
-    if (excise) {
-      if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { i0_(m,n,k,j,i) = 0.0; }
-    }
-  });
+  // with fused flux and update kernels the update has already been done in
+  // CalculateFluxes()
+  if (!(fused_update)) {
+    par_for("r_update",DevExeSpace(),0,nmb1,0,nvar1,ks,ke,js,je,is,ie,
+    KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
+      // spatial fluxes
+      Real divf_s = (flx1(m,n,k,j,i+1) - flx1(m,n,k,j,i))/mbsize.d_view(m).dx1;
+      if (multi_d) {
+        divf_s += (flx2(m,n,k,j+1,i) - flx2(m,n,k,j,i))/mbsize.d_view(m).dx2;
+      }
+      if (three_d) {
+        divf_s += (flx3(m,n,k+1,j,i) - flx3(m,n,k,j,i))/mbsize.d_view(m).dx3;
+      }
+      i0_(m,n,k,j,i) = gam0*i0_(m,n,k,j,i)+gam1*i1_(m,n,k,j,i)-beta_dt*divf_s;
+
+      // angular fluxes
+      if (angular_fluxes_) { i0_(m,n,k,j,i) -= beta_dt*divfa_(m,n,k,j,i); }
+
+      // zero intensity if negative (a is the angle of intensity n)
+      int a = n/ngroups_;
+      Real n0  = tt(m,0,0,k,j,i);
+      Real n_0 = tc(m,0,0,k,j,i)*nh_c_.d_view(a,0) + tc(m,1,0,k,j,i)*nh_c_.d_view(a,1) +
+                 tc(m,2,0,k,j,i)*nh_c_.d_view(a,2) + tc(m,3,0,k,j,i)*nh_c_.d_view(a,3);
+      i0_(m,n,k,j,i) = n0*n_0*fmax((i0_(m,n,k,j,i)/(n0*n_0)), 0.0);
+
+      // handle excision
+      // NOTE(@pdmullen): exicision criterion are not finalized.  The below zeroes all
+      // intensities within rks <= 1.0 and zeroes intensities within angles where n_0
+      // is about zero.  This needs future attention.
+      if (excise) {
+        if (rad_mask_(m,k,j,i) || fabs(n_0) < n_0_floor_) { i0_(m,n,k,j,i) = 0.0; }
+      }
+    });
+  }
 
   // add beam source term, if any
   if (psrc->beam)  psrc->BeamSource(i0_, beta_dt);
@@ -0,0 +1,318 @@
+#ifndef RECONSTRUCT_CHARACTERISTIC_HPP_
+#define RECONSTRUCT_CHARACTERISTIC_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file characteristic.hpp
+//! \brief Reconstruction in characteristic variables for nonrelativistic hydrodynamics
+//! and MHD with an ideal gas EOS, enabled with <hydro>/characteristic=true or
+//! <mhd>/characteristic=true.
+//!
+//! For each cell i the eigenvectors of the primitive-variable system are computed once
+//! from w(i), the stencil of the method around w(i) is projected onto the left
+//! eigenvectors, each characteristic field is reconstructed with the PLM/PPM/WENOZ/MP5
+//! functions used for primitives, and the L/R states at both faces of the cell are
+//! projected back with the right eigenvectors.  The projection is fused into the
+//! reconstruction so no extra scratch arrays are needed, and as with primitive
+//! reconstruction the WENO-Z smoothness indicators of each cell are shared by both of its
+//! faces.  Passive scalars are already characteristic fields and are reconstructed
+//! componentwise, as is the normal component of the cell-centered field in MHD.
+//!
+//! REFERENCES:
+//! Stone J.M. et al., "Athena: a new code for astrophysical MHD", ApJS, 178, 137 (2008)
+
+#include <math.h>
+
+#include "athena.hpp"
+#include "reconstruct/plm.hpp"
+#include "reconstruct/ppm.hpp"
+#include "reconstruct/wenoz.hpp"
+#include "reconstruct/mp5.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn CharacteristicPoint()
+//! \brief Reconstructs L/R states at the faces of the central cell of the 5-point stencil
+//! q[0..4] (only q[1..3] are used by PLM, and only q[2] by DC).
+
+template <ReconstructionMethod recon_method_>
+KOKKOS_INLINE_FUNCTION
+void CharacteristicPoint(const Real q[5], Real &ql_ip1, Real &qr_i) {
+  if constexpr (recon_method_ == ReconstructionMethod::dc) {
+    ql_ip1 = q[2];
+    qr_i   = q[2];
+  } else if constexpr (recon_method_ == ReconstructionMethod::plm) {
+    PLM(q[1], q[2], q[3], ql_ip1, qr_i);
+  } else if constexpr (recon_method_ == ReconstructionMethod::ppm4) {
+    PPM4(q[0], q[1], q[2], q[3], q[4], ql_ip1, qr_i);
+  } else if constexpr (recon_method_ == ReconstructionMethod::ppmx) {
+    PPMX(q[0], q[1], q[2], q[3], q[4], ql_ip1, qr_i);
+  } else if constexpr (recon_method_ == ReconstructionMethod::wenoz) {
+    WENOZ(q[0], q[1], q[2], q[3], q[4], ql_ip1, qr_i);
+  } else if constexpr (recon_method_ == ReconstructionMethod::mp5) {
+    MP5(q[0], q[1], q[2], q[3], q[4], ql_ip1, qr_i);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn CharacteristicRecon()
+//! \brief Reconstructs L/R states of cells [il,iu] in direction (di,dj,dk) with normal
+//! velocity ivn, storing ql(n,i+di) and qr(n,i).  Note primitive IEN is the internal
+//! energy e=p/(gamma-1), so eigenvectors are written in terms of e.
+
+template <ReconstructionMethod recon_method_, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void CharacteristicRecon(TeamMember_t const &member, const EOS_Data &eos,
+     const int ivn, const int di, const int dj, const int dk,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
+  int nvar = q.extent_int(1);
+  const Real gm1 = eos.gamma - 1.0;
+  const Real dfloor_ = eos.dfloor;
+  Real efloor_ = eos.pfloor/gm1;
+  // tangential velocities, whose eigenvectors are the unit vectors
+  const int ivt1 = (ivn == IVX)? IVY : IVX;
+  const int ivt2 = (ivn == IVZ)? IVY : IVZ;
+  // half-width of stencil
+  constexpr int ns = (recon_method_ == ReconstructionMethod::dc)? 0 :
+                     ((recon_method_ == ReconstructionMethod::plm)? 1 : 2);
+  par_for_inner(member, il, iu, [&](const int i) {
+    // eigenvectors from w(i): waves (u-c, entropy, shear, shear, u+c)
+    Real d = q(m,IDN,k,j,i);
+    Real c2 = eos.gamma*gm1*q(m,IEN,k,j,i)/d;
+    Real c = sqrt(c2);
+
+    // project stencil onto left eigenvectors (only cells within stencil of method)
+    Real w[5][5];
+    for (int s=(2-ns); s<=(2+ns); ++s) {
+      int kk = k + (s-2)*dk, jj = j + (s-2)*dj, ii = i + (s-2)*di;
+      Real dd = q(m,IDN,kk,jj,ii), vn = q(m,ivn,kk,jj,ii), ee = q(m,IEN,kk,jj,ii);
+      w[0][s] = 0.5*(gm1*ee/c2 - d*vn/c);
+      w[1][s] = dd - gm1*ee/c2;
+      w[2][s] = q(m,ivt1,kk,jj,ii);
+      w[3][s] = q(m,ivt2,kk,jj,ii);
+      w[4][s] = 0.5*(gm1*ee/c2 + d*vn/c);
+    }
+
+    // reconstruct each characteristic field
+    Real wl[5], wr[5];
+    for (int n=0; n<5; ++n) {
+      CharacteristicPoint<recon_method_>(w[n], wl[n], wr[n]);
+    }
+
+    // project back with right eigenvectors, and apply floors
+    ql(IDN,i+di) = fmax(wl[0] + wl[1] + wl[4], dfloor_);
+    qr(IDN,i   ) = fmax(wr[0] + wr[1] + wr[4], dfloor_);
+    ql(ivn,i+di) = c*(wl[4] - wl[0])/d;
+    qr(ivn,i   ) = c*(wr[4] - wr[0])/d;
+    ql(ivt1,i+di) = wl[2];
+    qr(ivt1,i   ) = wr[2];
+    ql(ivt2,i+di) = wl[3];
+    qr(ivt2,i   ) = wr[3];
+    ql(IEN,i+di) = fmax(c2*(wl[0] + wl[4])/gm1, efloor_);
+    qr(IEN,i   ) = fmax(c2*(wr[0] + wr[4])/gm1, efloor_);
+
+    // passive scalars
+    for (int n=(IEN+1); n<nvar; ++n) {
+      Real qs[5];
+      for (int s=(2-ns); s<=(2+ns); ++s) {
+        qs[s] = q(m,n,k+(s-2)*dk,j+(s-2)*dj,i+(s-2)*di);
+      }
+      CharacteristicPoint<recon_method_>(qs, ql(n,i+di), qr(n,i));
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn CharacteristicX1(), CharacteristicX2(), CharacteristicX3()
+//! \brief Wrapper functions for characteristic reconstruction in each direction, called
+//! over the same ranges as the corresponding primitive reconstruction functions.
+
+template <ReconstructionMethod recon_method_, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void CharacteristicX1(TeamMember_t const &member, const EOS_Data &eos,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
+  CharacteristicRecon<recon_method_>(member, eos, IVX, 1, 0, 0, m, k, j, il, iu, q,
+                                     ql, qr);
+}
+
+template <ReconstructionMethod recon_method_, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void CharacteristicX2(TeamMember_t const &member, const EOS_Data &eos,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
+  CharacteristicRecon<recon_method_>(member, eos, IVY, 0, 1, 0, m, k, j, il, iu, q,
+                                     ql_jp1, qr_j);
+}
+
+template <ReconstructionMethod recon_method_, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void CharacteristicX3(TeamMember_t const &member, const EOS_Data &eos,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
+  CharacteristicRecon<recon_method_>(member, eos, IVZ, 0, 0, 1, m, k, j, il, iu, q,
+                                     ql_kp1, qr_k);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn CharacteristicReconMHD()
+//! \brief Reconstructs L/R states of primitives q and cell-centered fields b of cells
+//! [il,iu] in direction (di,dj,dk) with normal velocity ivx, storing ql(n,i+di), qr(n,i),
+//! bl(n,i+di) and br(n,i).  Eigenvectors of the primitive-variable system (d,vx,vy,vz,
+//! p,by,bz) are eqs. (A12) and (A18) of Stone et al. (2008), with the same choices of
+//! alpha_f, alpha_s and beta as in that paper in degenerate cases.  Transverse
+//! components are ordered cyclically as in the MHD Riemann solvers.
+
+template <ReconstructionMethod recon_method_, typename QArray, typename BArray>
+KOKKOS_INLINE_FUNCTION
+void CharacteristicReconMHD(TeamMember_t const &member, const EOS_Data &eos,
+     const int ivx, const int di, const int dj, const int dk,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, const BArray &b, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr,
+     ScrArray2D<Real> &bl, ScrArray2D<Real> &br) {
+  int nvar = q.extent_int(1);
+  const Real gm1 = eos.gamma - 1.0;
+  const Real dfloor_ = eos.dfloor;
+  Real efloor_ = eos.pfloor/gm1;
+  const int ivy = IVX + ((ivx-IVX) + 1)%3;
+  const int ivz = IVX + ((ivx-IVX) + 2)%3;
+  const int ibx = ivx - IVX;
+  const int iby = ((ivx-IVX) + 1)%3;
+  const int ibz = ((ivx-IVX) + 2)%3;
+  // half-width of stencil
+  constexpr int ns = (recon_method_ == ReconstructionMethod::dc)? 0 :
+                     ((recon_method_ == ReconstructionMethod::plm)? 1 : 2);
+  par_for_inner(member, il, iu, [&](const int i) {
+    // wave speeds and eigenvectors from w(i) and bcc(i):
+    // waves (u-cf, u-ca, u-cs, entropy, u+cs, u+ca, u+cf)
+    Real d = q(m,IDN,k,j,i);
+    Real bx = b(m,ibx,k,j,i);
+    Real bt2 = SQR(b(m,iby,k,j,i)) + SQR(b(m,ibz,k,j,i));
+    Real a2 = eos.gamma*gm1*q(m,IEN,k,j,i)/d;
+    Real vax2 = bx*bx/d;
+    Real ct2 = bt2/d;
+    Real tdif = vax2 + ct2 - a2;
+    Real cf2 = 0.5*(vax2 + ct2 + a2 + sqrt(tdif*tdif + 4.0*a2*ct2));
+    Real cs2 = a2*vax2/cf2;
+    Real a = sqrt(a2), cf = sqrt(cf2), cs = sqrt(cs2);
+
+    Real bet2 = 1.0/sqrt(2.0), bet3 = 1.0/sqrt(2.0);
+    if (bt2 > 0.0) {
+      Real bt = sqrt(bt2);
+      bet2 = b(m,iby,k,j,i)/bt;
+      bet3 = b(m,ibz,k,j,i)/bt;
+    }
+    Real alpf = 1.0, alps = 0.0;
+    if ((cf2 - cs2) > 0.0) {
+      if ((a2 - cs2) <= 0.0) {
+        alpf = 0.0;
+        alps = 1.0;
+      } else if ((cf2 - a2) > 0.0) {
+        alpf = sqrt((a2 - cs2)/(cf2 - cs2));
+        alps = sqrt((cf2 - a2)/(cf2 - cs2));
+      }
+    }
+    Real sqrtd = sqrt(d);
+    Real sgn = (bx >= 0.0)? 1.0 : -1.0;
+    Real qf = cf*alpf*sgn, qs = cs*alps*sgn;
+    Real af = a*alpf*sqrtd, as = a*alps*sqrtd;
+    Real norm = 0.5/a2;
+
+    // project stencil onto left eigenvectors (only cells within stencil of method)
+    Real w[7][5];
+    for (int s=(2-ns); s<=(2+ns); ++s) {
+      int kk = k + (s-2)*dk, jj = j + (s-2)*dj, ii = i + (s-2)*di;
+      Real vn = q(m,ivx,kk,jj,ii), pp = gm1*q(m,IEN,kk,jj,ii);
+      Real vy = q(m,ivy,kk,jj,ii), vz = q(m,ivz,kk,jj,ii);
+      Real by = b(m,iby,kk,jj,ii), bz = b(m,ibz,kk,jj,ii);
+      Real vtb = bet2*vy + bet3*vz, btb = bet2*by + bet3*bz;
+      Real vtc = bet2*vz - bet3*vy, btc = bet2*bz - bet3*by;
+      w[0][s] = norm*(-cf*alpf*vn + qs*vtb + (alpf*pp + as*btb)/d);
+      w[1][s] = 0.5*( vtc + sgn*btc/sqrtd);
+      w[2][s] = norm*(-cs*alps*vn - qf*vtb + (alps*pp - af*btb)/d);
+      w[3][s] = q(m,IDN,kk,jj,ii) - pp/a2;
+      w[4][s] = norm*( cs*alps*vn + qf*vtb + (alps*pp - af*btb)/d);
+      w[5][s] = 0.5*(-vtc + sgn*btc/sqrtd);
+      w[6][s] = norm*( cf*alpf*vn - qs*vtb + (alpf*pp + as*btb)/d);
+    }
+
+    // reconstruct each characteristic field
+    Real wl[7], wr[7];
+    for (int n=0; n<7; ++n) {
+      CharacteristicPoint<recon_method_>(w[n], wl[n], wr[n]);
+    }
+
+    // project back with right eigenvectors, and apply floors
+    ql(IDN,i+di) = fmax(d*(alpf*(wl[0] + wl[6]) + alps*(wl[2] + wl[4])) + wl[3],
+                        dfloor_);
+    qr(IDN,i   ) = fmax(d*(alpf*(wr[0] + wr[6]) + alps*(wr[2] + wr[4])) + wr[3],
+                        dfloor_);
+    ql(ivx,i+di) = cf*alpf*(wl[6] - wl[0]) + cs*alps*(wl[4] - wl[2]);
+    qr(ivx,i   ) = cf*alpf*(wr[6] - wr[0]) + cs*alps*(wr[4] - wr[2]);
+    ql(ivy,i+di) = bet2*(qs*(wl[0] - wl[6]) + qf*(wl[4] - wl[2])) + bet3*(wl[5] - wl[1]);
+    qr(ivy,i   ) = bet2*(qs*(wr[0] - wr[6]) + qf*(wr[4] - wr[2])) + bet3*(wr[5] - wr[1]);
+    ql(ivz,i+di) = bet3*(qs*(wl[0] - wl[6]) + qf*(wl[4] - wl[2])) + bet2*(wl[1] - wl[5]);
+    qr(ivz,i   ) = bet3*(qs*(wr[0] - wr[6]) + qf*(wr[4] - wr[2])) + bet2*(wr[1] - wr[5]);
+    ql(IEN,i+di) = fmax(d*a2*(alpf*(wl[0] + wl[6]) + alps*(wl[2] + wl[4]))/gm1, efloor_);
+    qr(IEN,i   ) = fmax(d*a2*(alpf*(wr[0] + wr[6]) + alps*(wr[2] + wr[4]))/gm1, efloor_);
+    Real btl = as*(wl[0] + wl[6]) - af*(wl[2] + wl[4]);
+    Real btr = as*(wr[0] + wr[6]) - af*(wr[2] + wr[4]);
+    bl(iby,i+di) = bet2*btl - bet3*sgn*sqrtd*(wl[1] + wl[5]);
+    br(iby,i   ) = bet2*btr - bet3*sgn*sqrtd*(wr[1] + wr[5]);
+    bl(ibz,i+di) = bet3*btl + bet2*sgn*sqrtd*(wl[1] + wl[5]);
+    br(ibz,i   ) = bet3*btr + bet2*sgn*sqrtd*(wr[1] + wr[5]);
+
+    // normal component of cell-centered field, and passive scalars
+    Real qs5[5];
+    for (int s=(2-ns); s<=(2+ns); ++s) {
+      qs5[s] = b(m,ibx,k+(s-2)*dk,j+(s-2)*dj,i+(s-2)*di);
+    }
+    CharacteristicPoint<recon_method_>(qs5, bl(ibx,i+di), br(ibx,i));
+    for (int n=(IEN+1); n<nvar; ++n) {
+      for (int s=(2-ns); s<=(2+ns); ++s) {
+        qs5[s] = q(m,n,k+(s-2)*dk,j+(s-2)*dj,i+(s-2)*di);
+      }
+      CharacteristicPoint<recon_method_>(qs5, ql(n,i+di), qr(n,i));
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn CharacteristicMHDX1(), CharacteristicMHDX2(), CharacteristicMHDX3()
+//! \brief Wrapper functions for characteristic reconstruction of W and Bcc in each
+//! direction, called over the same ranges as the corresponding primitive reconstruction.
+
+template <ReconstructionMethod recon_method_, typename QArray, typename BArray>
+KOKKOS_INLINE_FUNCTION
+void CharacteristicMHDX1(TeamMember_t const &member, const EOS_Data &eos,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, const BArray &b, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr,
+     ScrArray2D<Real> &bl, ScrArray2D<Real> &br) {
+  CharacteristicReconMHD<recon_method_>(member, eos, IVX, 1, 0, 0, m, k, j, il, iu, q, b,
+                                        ql, qr, bl, br);
+}
+
+template <ReconstructionMethod recon_method_, typename QArray, typename BArray>
+KOKKOS_INLINE_FUNCTION
+void CharacteristicMHDX2(TeamMember_t const &member, const EOS_Data &eos,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, const BArray &b, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j,
+     ScrArray2D<Real> &bl_jp1, ScrArray2D<Real> &br_j) {
+  CharacteristicReconMHD<recon_method_>(member, eos, IVY, 0, 1, 0, m, k, j, il, iu, q, b,
+                                        ql_jp1, qr_j, bl_jp1, br_j);
+}
+
+template <ReconstructionMethod recon_method_, typename QArray, typename BArray>
+KOKKOS_INLINE_FUNCTION
+void CharacteristicMHDX3(TeamMember_t const &member, const EOS_Data &eos,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, const BArray &b, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k,
+     ScrArray2D<Real> &bl_kp1, ScrArray2D<Real> &br_k) {
+  CharacteristicReconMHD<recon_method_>(member, eos, IVZ, 0, 0, 1, m, k, j, il, iu, q, b,
+                                        ql_kp1, qr_k, bl_kp1, br_k);
+}
+#endif // RECONSTRUCT_CHARACTERISTIC_HPP_
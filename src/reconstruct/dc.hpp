@@ -16,9 +16,10 @@
 //! Therefore range of indices for which BOTH L/R states returned is il+1 to il-1
 //! This function should be called over [is-1,ie+1] to get BOTH L/R states over [is,ie]
 
+template <typename QArray>
 KOKKOS_INLINE_FUNCTION
 void DonorCellX1(TeamMember_t const &member, const int m, const int k, const int j,
-     const int il, const int iu, const DvceArray5D<Real> &q,
+     const int il, const int iu, const QArray &q,
      ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
   int nvar = q.extent_int(1);
   for (int n=0; n<nvar; ++n) {
@@ -35,9 +36,10 @@ void DonorCellX1(TeamMember_t const &member, const int m, const int k, const int
 //! \brief For each cell-centered value q(j), returns ql(j+1) and qr(j) over il to iu.
 //! This function should be called over [js-1,je+1] to get BOTH L/R states over [js,je]
 
+template <typename QArray>
 KOKKOS_INLINE_FUNCTION
 void DonorCellX2(TeamMember_t const &member, const int m, const int k, const int j,
-     const int il, const int iu, const DvceArray5D<Real> &q,
+     const int il, const int iu, const QArray &q,
      ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
   int nvar = q.extent_int(1);
   for (int n=0; n<nvar; ++n) {
@@ -54,9 +56,10 @@ void DonorCellX2(TeamMember_t const &member, const int m, const int k, const int
 //! \brief For each cell-centered value q(k), returns ql(k+1) and qr(k) over il to iu.
 //! This function should be called over [ks-1,ke+1] to get BOTH L/R states over [ks,ke]
 
+template <typename QArray>
 KOKKOS_INLINE_FUNCTION
 void DonorCellX3(TeamMember_t const &member, const int m, const int k, const int j,
-     const int il, const int iu, const DvceArray5D<Real> &q,
+     const int il, const int iu, const QArray &q,
      ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
   int nvar = q.extent_int(1);
   for (int n=0; n<nvar; ++n) {
@@ -0,0 +1,177 @@
+#ifndef RECONSTRUCT_MP5_HPP_
+#define RECONSTRUCT_MP5_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file mp5.hpp
+//! \brief Fifth-order monotonicity-preserving (MP5) reconstruction for a Cartesian-like
+//! coordinate with uniform spacing.
+//!
+//! REFERENCES:
+//! Suresh A., Huynh H.T., "Accurate monotonicity-preserving schemes with Runge-Kutta
+//! time stepping", JCP, 136, 83 (1997)
+
+#include <math.h>
+#include <algorithm>    // max(), min()
+
+#include "athena.hpp"
+
+namespace mp5 {
+//----------------------------------------------------------------------------------------
+//! \fn Minmod(), Minmod4()
+//! \brief minmod functions of two and four arguments
+
+KOKKOS_INLINE_FUNCTION
+Real Minmod(const Real x, const Real y) {
+  return 0.5*(copysign(1.0, x) + copysign(1.0, y))*fmin(fabs(x), fabs(y));
+}
+
+KOKKOS_INLINE_FUNCTION
+Real Minmod4(const Real w, const Real x, const Real y, const Real z) {
+  Real s1 = 0.125*(copysign(1.0, w) + copysign(1.0, x));
+  Real s2 = fabs((copysign(1.0, w) + copysign(1.0, y))*
+                 (copysign(1.0, w) + copysign(1.0, z)));
+  return s1*s2*fmin(fmin(fabs(w), fabs(x)), fmin(fabs(y), fabs(z)));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Face()
+//! \brief Returns MP5 value at the face between q_i and q_ip1, biased towards q_i.
+
+KOKKOS_INLINE_FUNCTION
+Real Face(const Real q_im2, const Real q_im1, const Real q_i, const Real q_ip1,
+          const Real q_ip2) {
+  const Real alpha = 4.0;
+  // unlimited fifth-order interpolant, eq. (2.1)
+  Real f = (2.0*q_im2 - 13.0*q_im1 + 47.0*q_i + 27.0*q_ip1 - 3.0*q_ip2)/60.0;
+  // monotonicity-preserving bound, eq. (2.12).  No limiting when f lies within it.
+  Real f_mp = q_i + Minmod(q_ip1 - q_i, alpha*(q_i - q_im1));
+  if ((f - q_i)*(f - f_mp) <= 0.0) {return f;}
+
+  // curvatures and limits that allow smooth extrema, eqs. (2.19)-(2.27)
+  Real d_im1 = q_im2 + q_i - 2.0*q_im1;
+  Real d_i   = q_im1 + q_ip1 - 2.0*q_i;
+  Real d_ip1 = q_i + q_ip2 - 2.0*q_ip1;
+  Real dm4_iph = Minmod4(4.0*d_i - d_ip1, 4.0*d_ip1 - d_i, d_i, d_ip1);
+  Real dm4_imh = Minmod4(4.0*d_i - d_im1, 4.0*d_im1 - d_i, d_i, d_im1);
+  Real f_ul = q_i + alpha*(q_i - q_im1);
+  Real f_md = 0.5*(q_i + q_ip1) - 0.5*dm4_iph;
+  Real f_lc = q_i + 0.5*(q_i - q_im1) + (4.0/3.0)*dm4_imh;
+  Real f_min = fmax(fmin(fmin(q_i, q_ip1), f_md), fmin(fmin(q_i, f_ul), f_lc));
+  Real f_max = fmin(fmax(fmax(q_i, q_ip1), f_md), fmax(fmax(q_i, f_ul), f_lc));
+  // median(f, f_min, f_max)
+  return f + Minmod(f_min - f, f_max - f);
+}
+} // namespace mp5
+
+//----------------------------------------------------------------------------------------
+//! \fn MP5()
+//! \brief Reconstructs L/R states at faces of cell i to compute ql(i+1) and qr(i).
+//! Works for any dimension by passing in the appropriate q_im2,...,q _ip2.
+
+KOKKOS_INLINE_FUNCTION
+void MP5(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_ip1,
+         const Real &q_ip2, Real &ql_ip1, Real &qr_i) noexcept {
+  ql_ip1 = mp5::Face(q_im2, q_im1, q_i, q_ip1, q_ip2);
+  qr_i   = mp5::Face(q_ip2, q_ip1, q_i, q_im1, q_im2);
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn MP5X1
+//! \brief Wrapper function for MP5 reconstruction in x1-direction.
+//! This function should be called over [is-1,ie+1] to get BOTH L/R states over [is,ie]
+
+template <typename QArray>
+KOKKOS_INLINE_FUNCTION
+void MP5X1(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
+  int nvar = q.extent_int(1);
+  const Real &dfloor_ = eos.dfloor;
+  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  for (int n=0; n<nvar; ++n) {
+    par_for_inner(member, il, iu, [&](const int i) {
+      MP5(q(m,n,k,j,i-2), q(m,n,k,j,i-1), q(m,n,k,j,i), q(m,n,k,j,i+1), q(m,n,k,j,i+2),
+          ql(n,i+1), qr(n,i));
+      if (apply_floors) {
+        if (n==IDN) {
+          ql(IDN,i+1) = fmax(ql(IDN,i+1), dfloor_);
+          qr(IDN,i  ) = fmax(qr(IDN,i  ), dfloor_);
+        }
+        if (n==IEN) {
+          ql(IEN,i+1) = fmax(ql(IEN,i+1), efloor_);
+          qr(IEN,i  ) = fmax(qr(IEN,i  ), efloor_);
+        }
+      }
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn MP5X2
+//! \brief Wrapper function for MP5 reconstruction in x2-direction.
+//! This function should be called over [js-1,je+1] to get BOTH L/R states over [js,je]
+
+template <typename QArray>
+KOKKOS_INLINE_FUNCTION
+void MP5X2(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
+  int nvar = q.extent_int(1);
+  const Real &dfloor_ = eos.dfloor;
+  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  for (int n=0; n<nvar; ++n) {
+    par_for_inner(member, il, iu, [&](const int i) {
+      MP5(q(m,n,k,j-2,i), q(m,n,k,j-1,i), q(m,n,k,j,i), q(m,n,k,j+1,i), q(m,n,k,j+2,i),
+          ql_jp1(n,i), qr_j(n,i));
+      if (apply_floors) {
+        if (n==IDN) {
+          ql_jp1(IDN,i) = fmax(ql_jp1(IDN,i), dfloor_);
+          qr_j  (IDN,i) = fmax(qr_j  (IDN,i), dfloor_);
+        }
+        if (n==IEN) {
+          ql_jp1(IEN,i) = fmax(ql_jp1(IEN,i), efloor_);
+          qr_j  (IEN,i) = fmax(qr_j  (IEN,i), efloor_);
+        }
+      }
+    });
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn MP5X3
+//! \brief Wrapper function for MP5 reconstruction in x3-direction.
+//! This function should be called over [ks-1,ke+1] to get BOTH L/R states over [ks,ke]
+
+template <typename QArray>
+KOKKOS_INLINE_FUNCTION
+void MP5X3(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
+     const int m, const int k, const int j, const int il, const int iu,
+     const QArray &q, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
+  int nvar = q.extent_int(1);
+  const Real &dfloor_ = eos.dfloor;
+  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  for (int n=0; n<nvar; ++n) {
+    par_for_inner(member, il, iu, [&](const int i) {
+      MP5(q(m,n,k-2,j,i), q(m,n,k-1,j,i), q(m,n,k,j,i), q(m,n,k+1,j,i), q(m,n,k+2,j,i),
+          ql_kp1(n,i), qr_k(n,i));
+      if (apply_floors) {
+        if (n==IDN) {
+          ql_kp1(IDN,i) = fmax(ql_kp1(IDN,i), dfloor_);
+          qr_k  (IDN,i) = fmax(qr_k  (IDN,i), dfloor_);
+        }
+        if (n==IEN) {
+          ql_kp1(IEN,i) = fmax(ql_kp1(IEN,i), efloor_);
+          qr_k  (IEN,i) = fmax(qr_k  (IEN,i), efloor_);
+        }
+      }
+    });
+  }
+  return;
+}
+#endif // RECONSTRUCT_MP5_HPP_
@@ -11,7 +11,11 @@
 //! REFERENCES:
 //! Borges R., Carmona M., Costa B., Don W.S. , "An improved weighted essentially
 //! non-oscillatory scheme for hyperbolic conservation laws" , JCP, 227, 3191 (2008)
+//!
+//! Jameson A., Schmidt W., Turkel E., "Numerical solution of the Euler equations by
+//! finite volume methods using Runge-Kutta time-stepping schemes", AIAA 81-1259 (1981)
 
+#include <float.h>      // FLT_MIN
 #include <math.h>
 #include <algorithm>    // max()
 
@@ -86,10 +90,11 @@ void WENOZ(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_
 //! \brief Wrapper function for WENOZ reconstruction in x1-direction.
 //! This function should be called over [is-1,ie+1] to get BOTH L/R states over [is,ie]
 
+template <typename QArray>
 KOKKOS_INLINE_FUNCTION
 void WENOZX1(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
+     const QArray &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
   int nvar = q.extent_int(1);
   const Real &dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
@@ -122,10 +127,11 @@ void WENOZX1(TeamMember_t const &member, const EOS_Data &eos, const bool apply_f
 //! \brief Wrapper function for WENOZ reconstruction in x1-direction.
 //! This function should be called over [js-1,je+1] to get BOTH L/R states over [js,je]
 
+template <typename QArray>
 KOKKOS_INLINE_FUNCTION
 void WENOZX2(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
+     const QArray &q, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
   int nvar = q.extent_int(1);
   const Real &dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
@@ -158,10 +164,11 @@ void WENOZX2(TeamMember_t const &member, const EOS_Data &eos, const bool apply_f
 //! \brief Wrapper function for WENOZ reconstruction in x1-direction.
 //! This function should be called over [ks-1,ke+1] to get BOTH L/R states over [ks,ke]
 
+template <typename QArray>
 KOKKOS_INLINE_FUNCTION
 void WENOZX3(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
      const int m, const int k, const int j, const int il, const int iu,
-     const DvceArray5D<Real> &q, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
+     const QArray &q, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
   int nvar = q.extent_int(1);
   const Real &dfloor_ = eos.dfloor;
   // TODO(jmstone): ideal gas only for now
@@ -188,4 +195,201 @@ void WENOZX3(TeamMember_t const &member, const EOS_Data &eos, const bool apply_f
   }
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn Linear5()
+//! \brief Linear 5th-order reconstruction of ql(i+1) and qr(i), i.e. WENOZ() with the
+//! optimal weights of smooth data (d0,d1,d2) = (0.1,0.6,0.3).
+
+KOKKOS_INLINE_FUNCTION
+void Linear5(const Real &q_im2, const Real &q_im1, const Real &q_i, const Real &q_ip1,
+             const Real &q_ip2, Real &ql_ip1, Real &qr_i) noexcept  {
+  constexpr Real c60 = 1.0/60.0;
+  ql_ip1 = c60*(2.0*q_im2 - 13.0*q_im1 + 47.0*q_i + 27.0*q_ip1 - 3.0*q_ip2);
+  qr_i   = c60*(2.0*q_ip2 - 13.0*q_ip1 + 47.0*q_i + 27.0*q_im1 - 3.0*q_im2);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn JumpSensor()
+//! \brief Normalized second difference |q+ - 2q + q-|/(q+ + 2q + q-) of a positive
+//! quantity (Jameson et al. 1981), of order (dx/L)^2 for smooth data and O(1) at jumps.
+
+KOKKOS_INLINE_FUNCTION
+Real JumpSensor(const Real &q_m, const Real &q_0, const Real &q_p) noexcept {
+  return fabs(q_p - 2.0*q_0 + q_m)/(fabs(q_p + 2.0*q_0 + q_m) + FLT_MIN);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn WENOZHybrid
+//! \brief Hybrid reconstruction in direction dir (1,2,3): cells whose 5-point stencil
+//! contains a jump in density, in magnetic pressure (if mhd), or in gas pressure in
+//! compressive flow (v(i+1) < v(i-1)), as measured by JumpSensor() of the primitives w
+//! and cell-centered fields b exceeding thresh, are reconstructed with WENOZ(), all
+//! other (smooth) cells with the cheaper Linear5().  The reconstructed variables q may
+//! be w, b, or passive scalars.  The sensor is computed once per cell for all variables.
+//! Called over the same range, and storing states in the same way, as WENOZX1/X2/X3,
+//! which are used unchanged if thresh <= 0.
+
+template <int dir, bool mhd, typename WArray, typename BArray, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void WENOZHybrid(TeamMember_t const &member, const EOS_Data &eos, const bool apply_floors,
+     const Real thresh, const int m, const int k, const int j, const int il, const int iu,
+     const WArray &w, const BArray &b, const QArray &q, ScrArray2D<Real> &ql,
+     ScrArray2D<Real> &qr) {
+  int nvar = q.extent_int(1);
+  const Real &dfloor_ = eos.dfloor;
+  // TODO(jmstone): ideal gas only for now
+  Real efloor_ = eos.pfloor/(eos.gamma - 1.0);
+  const bool ideal = eos.is_ideal;
+  constexpr int di = (dir == 1)? 1 : 0;
+  constexpr int dj = (dir == 2)? 1 : 0;
+  constexpr int dk = (dir == 3)? 1 : 0;
+  constexpr int ivn = IVX + dir - 1;
+  par_for_inner(member, il, iu, [&](const int i) {
+    // left state at face i+1 in x1, otherwise at face j+1 (k+1) stored at index i
+    const int il1 = i + di;
+    // cheap shock sensor over stencil
+    bool shock = false;
+    for (int s=-1; s<=1; ++s) {
+      Real sd = JumpSensor(w(m,IDN,k+(s-1)*dk,j+(s-1)*dj,i+(s-1)*di),
+                           w(m,IDN,k+s*dk,j+s*dj,i+s*di),
+                           w(m,IDN,k+(s+1)*dk,j+(s+1)*dj,i+(s+1)*di));
+      shock = shock || (sd > thresh);
+    }
+    if constexpr (mhd) {
+      Real b2[5];
+      for (int s=-2; s<=2; ++s) {
+        b2[s+2] = SQR(b(m,IBX,k+s*dk,j+s*dj,i+s*di)) + SQR(b(m,IBY,k+s*dk,j+s*dj,i+s*di))
+                + SQR(b(m,IBZ,k+s*dk,j+s*dj,i+s*di));
+      }
+      for (int s=1; s<=3; ++s) {
+        shock = shock || (JumpSensor(b2[s-1], b2[s], b2[s+1]) > thresh);
+      }
+    }
+    if (ideal && !(shock) &&
+        w(m,ivn,k+dk,j+dj,i+di) < w(m,ivn,k-dk,j-dj,i-di)) {
+      for (int s=-1; s<=1; ++s) {
+        Real sp = JumpSensor(w(m,IEN,k+(s-1)*dk,j+(s-1)*dj,i+(s-1)*di),
+                             w(m,IEN,k+s*dk,j+s*dj,i+s*di),
+                             w(m,IEN,k+(s+1)*dk,j+(s+1)*dj,i+(s+1)*di));
+        shock = shock || (sp > thresh);
+      }
+    }
+    for (int n=0; n<nvar; ++n) {
+      const Real &qm2 = q(m,n,k-2*dk,j-2*dj,i-2*di);
+      const Real &qm1 = q(m,n,k-dk,j-dj,i-di);
+      const Real &q0  = q(m,n,k,j,i);
+      const Real &qp1 = q(m,n,k+dk,j+dj,i+di);
+      const Real &qp2 = q(m,n,k+2*dk,j+2*dj,i+2*di);
+      if (shock) {
+        WENOZ(qm2, qm1, q0, qp1, qp2, ql(n,il1), qr(n,i));
+      } else {
+        Linear5(qm2, qm1, q0, qp1, qp2, ql(n,il1), qr(n,i));
+      }
+      if (apply_floors) {
+        if (n==IDN) {
+          ql(IDN,il1) = fmax(ql(IDN,il1), dfloor_);
+          qr(IDN,i  ) = fmax(qr(IDN,i  ), dfloor_);
+        }
+        if (n==IEN) {
+          ql(IEN,il1) = fmax(ql(IEN,il1), efloor_);
+          qr(IEN,i  ) = fmax(qr(IEN,i  ), efloor_);
+        }
+      }
+    }
+  });
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn WENOZHybridX1, WENOZHybridX2, WENOZHybridX3
+//! \brief Wrapper functions for hybrid reconstruction in each direction, calling
+//! WENOZX1/X2/X3 if hybrid reconstruction is disabled (thresh <= 0).  The overloads with
+//! cell-centered magnetic fields b (MHD) also use the magnetic pressure in the sensor.
+
+template <typename WArray, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void WENOZHybridX1(TeamMember_t const &member, const EOS_Data &eos,
+     const bool apply_floors, const Real thresh,
+     const int m, const int k, const int j, const int il, const int iu,
+     const WArray &w, const QArray &q, ScrArray2D<Real> &ql, ScrArray2D<Real> &qr) {
+  if (thresh <= 0.0) {
+    WENOZX1(member, eos, apply_floors, m, k, j, il, iu, q, ql, qr);
+  } else {
+    WENOZHybrid<1,false>(member, eos, apply_floors, thresh, m, k, j, il, iu, w, w, q,
+                         ql, qr);
+  }
+}
+
+template <typename WArray, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void WENOZHybridX2(TeamMember_t const &member, const EOS_Data &eos,
+     const bool apply_floors, const Real thresh,
+     const int m, const int k, const int j, const int il, const int iu,
+     const WArray &w, const QArray &q, ScrArray2D<Real> &ql_jp1, ScrArray2D<Real> &qr_j) {
+  if (thresh <= 0.0) {
+    WENOZX2(member, eos, apply_floors, m, k, j, il, iu, q, ql_jp1, qr_j);
+  } else {
+    WENOZHybrid<2,false>(member, eos, apply_floors, thresh, m, k, j, il, iu, w, w, q,
+                         ql_jp1, qr_j);
+  }
+}
+
+template <typename WArray, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void WENOZHybridX3(TeamMember_t const &member, const EOS_Data &eos,
+     const bool apply_floors, const Real thresh,
+     const int m, const int k, const int j, const int il, const int iu,
+     const WArray &w, const QArray &q, ScrArray2D<Real> &ql_kp1, ScrArray2D<Real> &qr_k) {
+  if (thresh <= 0.0) {
+    WENOZX3(member, eos, apply_floors, m, k, j, il, iu, q, ql_kp1, qr_k);
+  } else {
+    WENOZHybrid<3,false>(member, eos, apply_floors, thresh, m, k, j, il, iu, w, w, q,
+                         ql_kp1, qr_k);
+  }
+}
+template <typename WArray, typename BArray, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void WENOZHybridX1(TeamMember_t const &member, const EOS_Data &eos,
+     const bool apply_floors, const Real thresh,
+     const int m, const int k, const int j, const int il, const int iu,
+     const WArray &w, const BArray &b, const QArray &q, ScrArray2D<Real> &ql,
+     ScrArray2D<Real> &qr) {
+  if (thresh <= 0.0) {
+    WENOZX1(member, eos, apply_floors, m, k, j, il, iu, q, ql, qr);
+  } else {
+    WENOZHybrid<1,true>(member, eos, apply_floors, thresh, m, k, j, il, iu, w, b, q,
+                        ql, qr);
+  }
+}
+
+template <typename WArray, typename BArray, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void WENOZHybridX2(TeamMember_t const &member, const EOS_Data &eos,
+     const bool apply_floors, const Real thresh,
+     const int m, const int k, const int j, const int il, const int iu,
+     const WArray &w, const BArray &b, const QArray &q, ScrArray2D<Real> &ql_jp1,
+     ScrArray2D<Real> &qr_j) {
+  if (thresh <= 0.0) {
+    WENOZX2(member, eos, apply_floors, m, k, j, il, iu, q, ql_jp1, qr_j);
+  } else {
+    WENOZHybrid<2,true>(member, eos, apply_floors, thresh, m, k, j, il, iu, w, b, q,
+                        ql_jp1, qr_j);
+  }
+}
+
+template <typename WArray, typename BArray, typename QArray>
+KOKKOS_INLINE_FUNCTION
+void WENOZHybridX3(TeamMember_t const &member, const EOS_Data &eos,
+     const bool apply_floors, const Real thresh,
+     const int m, const int k, const int j, const int il, const int iu,
+     const WArray &w, const BArray &b, const QArray &q, ScrArray2D<Real> &ql_kp1,
+     ScrArray2D<Real> &qr_k) {
+  if (thresh <= 0.0) {
+    WENOZX3(member, eos, apply_floors, m, k, j, il, iu, q, ql_kp1, qr_k);
+  } else {
+    WENOZHybrid<3,true>(member, eos, apply_floors, thresh, m, k, j, il, iu, w, b, q,
+                        ql_kp1, qr_k);
+  }
+}
 #endif // RECONSTRUCT_WENOZ_HPP_
@@ -25,12 +25,20 @@
 
 OrbitalAdvection::OrbitalAdvection(MeshBlockPack *ppack, ParameterInput *pin) :
     maxjshift(1),
+    skip_subcell(false),
+    dt_oa(0.0),
+    remap_now(true),
     pmy_pack(ppack) {
   // estimate maximum integer shift in x2-direction for orbital advection
   Real xmin = fabs(ppack->pmesh->mesh_size.x1min);
   Real xmax = fabs(ppack->pmesh->mesh_size.x1max);
   maxjshift = static_cast<int>((ppack->pmesh->cfl_no)*std::max(xmin,xmax)) + 1;
 
+  // optionally accumulate shifts smaller than one cell, in which case the shift applied
+  // in one remap can exceed that of a single step by up to one cell
+  skip_subcell = pin->GetOrAddBoolean("shearing_box","oa_skip_subcell",false);
+  if (skip_subcell) {maxjshift += 1;}
+
 #if MPI_PARALLEL_ENABLED
   // For orbital advection, communication is only with x2-face neighbors
   // initialize vectors of MPI request in 2 elements of fixed length arrays
@@ -50,6 +50,8 @@ OrbitalAdvectionCC::OrbitalAdvectionCC(MeshBlockPack *pp, ParameterInput *pin, i
 //! Input arrays must be 5D Kokkos View dimensioned (nmb, nvar, nx3, nx2, nx1)
 
 TaskStatus OrbitalAdvectionCC::PackAndSendCC(DvceArray5D<Real> &a) {
+  // nothing to send if remap is skipped in this cycle
+  if (!(remap_now)) {return TaskStatus::complete;}
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   int nvar = a.extent_int(1);  // TODO(@user): 2nd index from L of in array must be NVAR
@@ -128,7 +130,7 @@ TaskStatus OrbitalAdvectionCC::PackAndSendCC(DvceArray5D<Real> &a) {
 
 #if MPI_PARALLEL_ENABLED
   // Send boundary buffer to neighboring MeshBlocks using MPI
-  Kokkos::fence();
+  DevExeSpace().fence();
   bool no_errors=true;
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<2; ++n) {
@@ -174,6 +176,7 @@ TaskStatus OrbitalAdvectionCC::PackAndSendCC(DvceArray5D<Real> &a) {
 
 TaskStatus OrbitalAdvectionCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
                                                ReconstructionMethod rcon, Real qom) {
+  if (!(remap_now)) {return TaskStatus::complete;}
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
   auto &rbuf = recvbuf;
@@ -226,16 +229,19 @@ TaskStatus OrbitalAdvectionCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
 
   auto &mbsize = pmy_pack->pmb->mb_size;
   auto &mesh_size = pmy_pack->pmesh->mesh_size;
-  Real &dt = pmy_pack->pmesh->dt;
+  // shift by the time since the last remap (more than dt with skip_subcell)
+  Real dt = dt_oa;
   Real ly = (mesh_size.x2max - mesh_size.x2min);
 
+  // One team per pencil in x2 shifts all variables, so the shift and offsets are
+  // computed once per pencil.  "Fluxes" are computed in the same pass as the update.
+  const bool use_plm = (rcon == ReconstructionMethod::plm);
+  const int nj = indcs.nx2;
   int scr_lvl=0;
-  size_t scr_size = ScrArray1D<Real>::shmem_size(nfx) * 3;
-  par_for_outer("oa-unpk",DevExeSpace(),scr_size,scr_lvl,0,(nmb-1),0,(nvar-1),ks,ke,is,ie,
-  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int n, const int k, const int i) {
-    ScrArray1D<Real> a_(member.team_scratch(scr_lvl), nfx); // 1D slice of data
-    ScrArray1D<Real> flx(member.team_scratch(scr_lvl), nfx); // "flux" at faces
-    ScrArray1D<Real> q1_(member.team_scratch(scr_lvl), nfx); // scratch array
+  size_t scr_size = ScrArray2D<Real>::shmem_size(nvar, nfx);
+  par_for_outer("oa-unpk",DevExeSpace(),scr_size,scr_lvl,0,(nmb-1),ks,ke,is,ie,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int i) {
+    ScrArray2D<Real> a_(member.team_scratch(scr_lvl), nvar, nfx); // 1D slices of data
 
     Real &x1min = mbsize.d_view(m).x1min;
     Real &x1max = mbsize.d_view(m).x1max;
@@ -246,44 +252,42 @@ TaskStatus OrbitalAdvectionCC::RecvAndUnpackCC(DvceArray5D<Real> &a,
     int joffset = static_cast<int>(yshear/(mbsize.d_view(m).dx2));
 
     // Load scratch array with no shift
-    par_for_inner(member, 0, (nfx-1), [&](const int jf) {
+    par_for_inner(member, 0, (nvar*nfx-1), [&](const int idx) {
+      int n = idx/nfx;
+      int jf = idx - n*nfx;
       if (jf < jfs) {
         // Load from L boundary buffer
-        a_(jf) = rbuf[0].vars(m,n,(k-ks),jf,(i-is));
+        a_(n,jf) = rbuf[0].vars(m,n,(k-ks),jf,(i-is));
       } else if (jf <= jfe) {
         // Load from conserved variables themselves (addressed with j=jf-jfs+js)
-        a_(jf) = a(m,n,k,jf-jfs+js,i);
+        a_(n,jf) = a(m,n,k,jf-jfs+js,i);
       } else {
         // Load from R boundary buffer
-        a_(jf) = rbuf[1].vars(m,n,(k-ks),jf-(jfe+1),(i-is));
+        a_(n,jf) = rbuf[1].vars(m,n,(k-ks),jf-(jfe+1),(i-is));
       }
     });
     member.team_barrier();
 
-    // Compute "fluxes" at shifted cell faces
-    Real epsi = fmod(yshear,(mbsize.d_view(m).dx2))/(mbsize.d_view(m).dx2);
-    switch (rcon) {
-      case ReconstructionMethod::dc:
-        DCRemapFlx(member, (jfs-joffset), (jfe+1-joffset), epsi, a_, q1_, flx);
-        break;
-      case ReconstructionMethod::plm:
-        PLMRemapFlx(member, (jfs-joffset), (jfe+1-joffset), epsi, a_, q1_, flx);
-        break;
-//      case ReconstructionMethod::ppm4:
-//      case ReconstructionMethod::ppmx:
-//          PPMRemapFlx(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_jp1, wr);
-//        break;
-      default:
-        break;
-    }
-
     // Update CC variables with both integer shift (from a_) and a conservative remap
-    // for the remaining fraction of a cell using upwind "fluxes"
-    par_for_inner(member, js, je, [&](const int j) {
-      int jf = j-js + jfs;
-      a(m,n,k,j,i) = a_(jf-joffset) - (flx(jf+1-joffset) - flx(jf-joffset));
+    // for the remaining fraction of a cell using upwind "fluxes" at shifted cell faces
+    Real epsi = fmod(yshear,(mbsize.d_view(m).dx2))/(mbsize.d_view(m).dx2);
+    par_for_inner(member, 0, (nvar*nj-1), [&](const int idx) {
+      int n = idx/nj;
+      int jf = (idx - n*nj) + jfs;
+      auto u = Kokkos::subview(a_, n, Kokkos::ALL);
+      Real fl, fr;
+      if (use_plm) {
+        fl = PLMRemapFlxPt(u, (jf-joffset), epsi);
+        fr = PLMRemapFlxPt(u, (jf+1-joffset), epsi);
+      } else {
+        fl = DCRemapFlxPt(u, (jf-joffset), epsi);
+        fr = DCRemapFlxPt(u, (jf+1-joffset), epsi);
+      }
+      a(m,n,k,jf-jfs+js,i) = u(jf-joffset) - (fr - fl);
     });
   });
 
+  // accumulated shift has been applied
+  dt_oa = 0.0;
   return TaskStatus::complete;
 }
@@ -47,6 +47,8 @@ OrbitalAdvectionFC::OrbitalAdvectionFC(MeshBlockPack *pp, ParameterInput *pin) :
 //! Note only B3 and B1 need be passed.
 
 TaskStatus OrbitalAdvectionFC::PackAndSendFC(DvceFaceFld4D<Real> &b) {
+  // nothing to send if remap is skipped in this cycle
+  if (!(remap_now)) {return TaskStatus::complete;}
   // create local references for variables in kernel
   int nmb = pmy_pack->nmb_thispack;
 
@@ -124,7 +126,7 @@ TaskStatus OrbitalAdvectionFC::PackAndSendFC(DvceFaceFld4D<Real> &b) {
 
 #if MPI_PARALLEL_ENABLED
   // Send boundary buffer to neighboring MeshBlocks using MPI
-  Kokkos::fence();
+  DevExeSpace().fence();
   bool no_errors=true;
   for (int m=0; m<nmb; ++m) {
     for (int n=0; n<2; ++n) {
@@ -173,6 +175,7 @@ TaskStatus OrbitalAdvectionFC::PackAndSendFC(DvceFaceFld4D<Real> &b) {
 
 TaskStatus OrbitalAdvectionFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b0,
                                              ReconstructionMethod rcon, Real qom) {
+  if (!(remap_now)) {return TaskStatus::complete;}
   int nmb = pmy_pack->nmb_thispack;
   auto &rbuf = recvbuf;
 #if MPI_PARALLEL_ENABLED
@@ -222,11 +225,14 @@ TaskStatus OrbitalAdvectionFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b0,
 
   auto &mbsize = pmy_pack->pmb->mb_size;
   auto &mesh_size = pmy_pack->pmesh->mesh_size;
-  Real &dt = pmy_pack->pmesh->dt;
+  // shift by the time since the last remap (more than dt with skip_subcell)
+  Real dt = dt_oa;
   Real ly = (mesh_size.x2max - mesh_size.x2min);
 
+  // "fluxes" are computed in the same pass as the effective EMFs
+  const bool use_plm = (rcon == ReconstructionMethod::plm);
   int scr_lvl=0;
-  size_t scr_size = ScrArray1D<Real>::shmem_size(nfx) * 3;
+  size_t scr_size = ScrArray1D<Real>::shmem_size(nfx);
   DvceArray4D<Real> emfx, emfz;
     int ncells1 = indcs.nx1 + 2*(indcs.ng);
     int ncells2 = indcs.nx2 + 2*(indcs.ng);
@@ -236,8 +242,6 @@ TaskStatus OrbitalAdvectionFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b0,
   par_for_outer("oa-unB",DevExeSpace(),scr_size,scr_lvl,0,(nmb-1),0,1,ks,ke+1,is,ie+1,
   KOKKOS_LAMBDA(TeamMember_t member, const int m, const int v, const int k, const int i) {
     ScrArray1D<Real> b0_(member.team_scratch(scr_lvl), nfx); // 1D slice of data
-    ScrArray1D<Real> flx(member.team_scratch(scr_lvl), nfx); // "flux" at faces
-    ScrArray1D<Real> q1_(member.team_scratch(scr_lvl), nfx); // scratch array
 
     Real &x1min = mbsize.d_view(m).x1min;
     Real &x1max = mbsize.d_view(m).x1max;
@@ -273,28 +277,16 @@ TaskStatus OrbitalAdvectionFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b0,
     });
     member.team_barrier();
 
-    // Compute x2-fluxes at shifted cell faces
+    // fractional offset for x2-fluxes at shifted cell faces
     Real epsi = fmod(yshear,(mbsize.d_view(m).dx2))/(mbsize.d_view(m).dx2);
-    switch (rcon) {
-      case ReconstructionMethod::dc:
-        DCRemapFlx(member, (jfs-joffset), (jfe+1-joffset), epsi, b0_, q1_, flx);
-        break;
-      case ReconstructionMethod::plm:
-        PLMRemapFlx(member, (jfs-joffset), (jfe+1-joffset), epsi, b0_, q1_, flx);
-        break;
-//      case ReconstructionMethod::ppm4:
-//      case ReconstructionMethod::ppmx:
-//          PPMRemapFlx(member,eos_,extrema,true,m,k,j,il,iu, w0_, wl_jp1, wr);
-//        break;
-      default:
-        break;
-    }
 
     // Compute emfx = -VyBz, which is at cell-center in x1-direction
     if (v==0) {
       par_for_inner(member, js, je+1, [&](const int j) {
         int jf = j-js + jfs;
-        emfx(m,k,j,i) = -flx(jf-joffset);
+        Real flx = use_plm? PLMRemapFlxPt(b0_, (jf-joffset), epsi) :
+                            DCRemapFlxPt(b0_, (jf-joffset), epsi);
+        emfx(m,k,j,i) = -flx;
         // Sum integer offsets into effective EMFs
         for (int jj=1; jj<=joffset; jj++) {
           emfx(m,k,j,i) -= b0_(jf-jj);
@@ -309,7 +301,9 @@ TaskStatus OrbitalAdvectionFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b0,
     } else if (v==1) {
       par_for_inner(member, js, je+1, [&](const int j) {
         int jf = j-js + jfs;
-        emfz(m,k,j,i) = flx(jf-joffset);
+        Real flx = use_plm? PLMRemapFlxPt(b0_, (jf-joffset), epsi) :
+                            DCRemapFlxPt(b0_, (jf-joffset), epsi);
+        emfz(m,k,j,i) = flx;
         // Sum integer offsets into effective EMFs
         for (int jj=1; jj<=joffset; jj++) {
           emfz(m,k,j,i) += b0_(jf-jj);
@@ -351,5 +345,7 @@ TaskStatus OrbitalAdvectionFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b0,
     });
   }
 
+  // accumulated shift has been applied
+  dt_oa = 0.0;
   return TaskStatus::complete;
 }
@@ -62,4 +62,36 @@ void PLMRemapFlx(TeamMember_t const &tmember, const int jl, const int ju, const
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn DCRemapFlxPt()
+//! \brief Donor-cell "flux" at face j only, as in DCRemapFlx(). Used when the fluxes are
+//! computed in the same pass as the update, without storing them in scratch arrays.
+
+template <typename ViewType>
+KOKKOS_INLINE_FUNCTION
+Real DCRemapFlxPt(const ViewType &u, const int j, const Real eps) {
+  return (eps > 0.0)? eps*u(j-1) : eps*u(j);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn PLMRemapFlxPt()
+//! \brief Piecewise-linear "flux" at face j only, as in PLMRemapFlx(). The limited slope
+//! in the upwind cell is recomputed from u.
+
+template <typename ViewType>
+KOKKOS_INLINE_FUNCTION
+Real PLMRemapFlxPt(const ViewType &u, const int j, const Real eps) {
+  // upwind cell
+  const int ju = (eps > 0.0)? (j-1) : j;
+  Real dql = u(ju  ) - u(ju-1);
+  Real dqr = u(ju+1) - u(ju  );
+  // Apply limiter
+  Real dq2 = dql*dqr;
+  Real q1 = (dq2 > 0.0)? dq2/(dql + dqr) : 0.0;
+  if (eps > 0.0) {
+    return eps*(u(ju) + 0.5*(1.0 - eps)*q1);
+  }
+  return eps*(u(ju) - 0.5*(1.0 + eps)*q1);
+}
+
 #endif // SHEARING_BOX_REMAP_FLUXES_HPP_
@@ -22,6 +22,10 @@
 ShearingBoxBoundary::ShearingBoxBoundary(MeshBlockPack *ppack, ParameterInput *pin) :
     nmb_x1bndry("nmbx1",2),
     x1bndry_mbgid("x1gid",1,1),
+    nshr_exch("nshrx",1,1),
+    shr_tgid("shrtgid",1,1,1),
+    shr_trank("shrtrank",1,1,1),
+    shr_srank("shrsrank",1,1,1),
     pmy_pack(ppack) {
   // Create vector with GID of every MBs on this rank at ix1/ox1 shearing-box boundaries
   std::vector<int> tmp_ix1bndry_gid, tmp_ox1bndry_gid;
@@ -57,6 +61,12 @@ ShearingBoxBoundary::ShearingBoxBoundary(MeshBlockPack *ppack, ParameterInput *p
   x1bndry_mbgid.template modify<HostMemSpace>();
   x1bndry_mbgid.template sync<DevExeSpace>();
 
+  // allocate arrays of MBs exchanging data, set each stage by SetShearTargets()
+  Kokkos::realloc(nshr_exch, 2, nmb);
+  Kokkos::realloc(shr_tgid, 2, nmb, 3);
+  Kokkos::realloc(shr_trank, 2, nmb, 3);
+  Kokkos::realloc(shr_srank, 2, nmb, 3);
+
 
 #if MPI_PARALLEL_ENABLED
   // initialize vectors of MPI requests for ix1/ox1 boundaries in fixed length arrays
@@ -65,7 +75,7 @@ ShearingBoxBoundary::ShearingBoxBoundary(MeshBlockPack *ppack, ParameterInput *p
     if (nmb_x1bndry(n) > 0) {
       sendbuf[n].vars_req = new MPI_Request[3*nmb_x1bndry(n)];
       recvbuf[n].vars_req = new MPI_Request[3*nmb_x1bndry(n)];
-      for (int m=0; m<nmb_x1bndry(0); ++m) {
+      for (int m=0; m<nmb_x1bndry(n); ++m) {
         for (int l=0; l<3; ++l) {
           sendbuf[n].vars_req[3*m + l] = MPI_REQUEST_NULL;
           recvbuf[n].vars_req[3*m + l] = MPI_REQUEST_NULL;
@@ -104,9 +114,55 @@ void ShearingBoxBoundary::FindTargetMB(const int igid, const int jshift, int &gi
   // find number of MBs in x2 direction at this level
   std::int32_t nmbx2 = pm->nmb_rootx2 << (lloc.level - pm->root_level);
   // apply shift by input number of blocks
-  lloc.lx2 = static_cast<std::int32_t>((lloc.lx2 + jshift) % nmbx2);
+  lloc.lx2 = static_cast<std::int32_t>(((lloc.lx2 + jshift) % nmbx2 + nmbx2) % nmbx2);
   // find target GID and rank
   gid = (pm->ptree->FindMeshBlock(lloc))->GetGID();
   rank = pm->rank_eachmb[gid];
   return;
 }
+
+//----------------------------------------------------------------------------------------
+//! \fn void ShearingBoxBoundary::SetShearTargets()
+//! \brief Finds the number, GIDs and ranks of the MBs that each MB at the x1 boundaries
+//! sends data to and receives data from, for the current value of yshear.  See the
+//! three cases in ShearingBoxBoundaryCC::PackAndSendCC().
+
+void ShearingBoxBoundary::SetShearTargets() {
+  const int &ng = pmy_pack->pmesh->mb_indcs.ng;
+  const int &nx2 = pmy_pack->pmesh->mb_indcs.nx2;
+  for (int n=0; n<2; ++n) {
+    for (int m=0; m<nmb_x1bndry(n); ++m) {
+      int gid = x1bndry_mbgid.h_view(n,m);
+      int mm = gid - pmy_pack->gids;
+      // Find integer and fractional number of grids over which offset extends.
+      // This assumes every grid has same number of cells in x2-direction!
+      int joffset  = static_cast<int>(yshear/(pmy_pack->pmb->mb_size.h_view(mm).dx2));
+      int ji = joffset/nx2;
+      int jr = joffset - ji*nx2;
+
+      // offset of first target MB, and number of target MBs
+      int jshift0;
+      if (jr < ng) {               //--- CASE 1
+        nshr_exch(n,m) = 3;
+        jshift0 = (n==0)? (ji-1) : (-1-ji);
+      } else if (jr < (nx2-ng)) {  //--- CASE 2
+        nshr_exch(n,m) = 2;
+        jshift0 = (n==0)? ji : (-1-ji);
+      } else {                     //--- CASE 3
+        nshr_exch(n,m) = 3;
+        jshift0 = (n==0)? ji : (-2-ji);
+      }
+      // data is sent to MBs offset by jshift, and received from MBs offset by -jshift
+      for (int l=0; l<nshr_exch(n,m); ++l) {
+        int jshift = jshift0 + l;
+        int tgid, trank, sgid, srank;
+        FindTargetMB(gid,jshift,tgid,trank);
+        FindTargetMB(gid,-jshift,sgid,srank);
+        shr_tgid(n,m,l) = tgid;
+        shr_trank(n,m,l) = trank;
+        shr_srank(n,m,l) = srank;
+      }
+    }
+  }
+  return;
+}
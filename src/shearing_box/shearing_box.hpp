@@ -56,6 +56,11 @@ class OrbitalAdvection {
 
   // data
   int maxjshift;            // maximum integer shift of any cell in orbital advection
+  // With <shearing_box>/oa_skip_subcell, the remap is skipped (without communication)
+  // until the accumulated shift at the largest |x1| in the mesh reaches one cell.
+  bool skip_subcell;
+  Real dt_oa;               // time since data was last remapped
+  bool remap_now;           // remap is performed in this cycle
 
   // data buffers for orbital advection. Only two x2-faces communicate
   ShearingBoxBoundaryBuffer sendbuf[2], recvbuf[2];
@@ -66,7 +71,7 @@ class OrbitalAdvection {
 #endif
 
   // functions
-  TaskStatus InitRecv();
+  TaskStatus InitRecv(Real qom);
   TaskStatus ClearRecv();
   TaskStatus ClearSend();
 
@@ -113,6 +118,12 @@ class ShearingBoxBoundary {
   HostArray1D<int> nmb_x1bndry;    // number of MBs that touch x1 boundaries
   DualArray2D<int> x1bndry_mbgid;  // GIDs of MBs at x1 boundaries
   Real yshear;                     // x2-distance x1-boundaries have sheared
+  // MBs exchanging data with each MB at x1 boundaries for the current yshear, found once
+  // per stage by SetShearTargets() rather than in every send/recv/clear function
+  HostArray2D<int> nshr_exch;      // number of MBs exchanged with (2 or 3)
+  HostArray3D<int> shr_tgid;       // GIDs of MBs data is sent to
+  HostArray3D<int> shr_trank;      // ranks of MBs data is sent to
+  HostArray3D<int> shr_srank;      // ranks of MBs data is received from
 
   // data buffers for shearing box BCs.  Only two x1-faces get sheared
   // Use seperate variables for ix1/ox1 since number of MBs on each face can be different
@@ -129,6 +140,8 @@ class ShearingBoxBoundary {
   TaskStatus ClearSend();
   // function to find target MB offset by shear.  Returns GID and rank
   void FindTargetMB(const int igid, const int jshift, int &gid, int &rank);
+  // function to find MBs exchanging data with MBs at x1 boundaries for current yshear
+  void SetShearTargets();
   // function to find index in x1bndry array of MB with input GID
   int TargetIndex(const int n, const int tgid) {
     for (int m=0; m<nmb_x1bndry(n); ++m) {
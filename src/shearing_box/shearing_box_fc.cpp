@@ -146,7 +146,7 @@ TaskStatus ShearingBoxBoundaryFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
   //  * Case2 is when the sending MB straddles the boundary between MBs, and so requires
   //    copy/send to only two target MBs.
   // Use deep copy if target MB on same rank, or MPI sends if not
-  Kokkos::fence();
+  DevExeSpace().fence();
   const int &nx2 = indcs.nx2;
   bool no_errors=true;
   for (int n=0; n<2; ++n) {
@@ -180,9 +180,8 @@ TaskStatus ShearingBoxBoundaryFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
         // ix1 boundary: send to (target-1) through (target+1)
         // ox1 boundary: send to (target-1) through (target+1)
         for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = ji+l-1;} else {jshift = l-1-ji;} // offset of target
-          FindTargetMB(gid,jshift,tgid,trank);
+          tgid = shr_tgid(n,m,l);
+          trank = shr_trank(n,m,l);
           if (trank == global_variable::my_rank) {
             int tm = TargetIndex(n,tgid);
             using Kokkos::ALL;
@@ -219,9 +218,8 @@ TaskStatus ShearingBoxBoundaryFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
         // ix1 boundary: send to (target  ) through (target+1)
         // ox1 boundary: send to (target-1) through (target  )
         for (int l=0; l<2; ++l) {
-          int jshift;
-          if (n==0) {jshift = ji+l;} else {jshift = l-1-ji;}
-          FindTargetMB(gid,jshift,tgid,trank);
+          tgid = shr_tgid(n,m,l);
+          trank = shr_trank(n,m,l);
           if (trank == global_variable::my_rank) {
             int tm = TargetIndex(n,tgid);
             using Kokkos::ALL;
@@ -262,9 +260,8 @@ TaskStatus ShearingBoxBoundaryFC::PackAndSendFC(DvceFaceFld4D<Real> &b,
         // ix1 boundary: send to (target  ) through (target+2)
         // ox1 boundary: send to (target-2) through (target  )
         for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = ji+l;} else {jshift = l-2-ji;}
-          FindTargetMB(gid,jshift,tgid,trank);
+          tgid = shr_tgid(n,m,l);
+          trank = shr_trank(n,m,l);
           if (trank == global_variable::my_rank) {
             int tm = TargetIndex(n,tgid);
             using Kokkos::ALL;
@@ -306,63 +303,16 @@ TaskStatus ShearingBoxBoundaryFC::RecvAndUnpackFC(DvceFaceFld4D<Real> &b) {
   const int &ng = indcs.ng;
 #if MPI_PARALLEL_ENABLED
   //----- STEP 1: check that recv boundary buffer communications have all completed
-  const int &nx2 = indcs.nx2;
   bool bflag = false;
   bool no_errors=true;
   for (int n=0; n<2; ++n) {
     for (int m=0; m<nmb_x1bndry(n); ++m) {
-      int gid = x1bndry_mbgid.h_view(n,m);
-      int mm = gid - pmy_pack->gids;
-      // Find integer and fractional number of grids over which offset extends.
-      // This assumes every grid has same number of cells in x2-direction!
-      int joffset  = static_cast<int>(yshear/(pmy_pack->pmb->mb_size.h_view(mm).dx2));
-      int ji = joffset/nx2;
-      int jr = joffset - ji*nx2;
-
-      if (jr < ng) {               //--- CASE 1 (in my nomenclature)
-        // ix1 boundary: receive from (target+1) through (target-1)
-        // ox1 boundary: receive from (target+1) through (target-1)
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l-1);} else {jshift = -(l-1-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
-          if (srank != global_variable::my_rank) {
-            int test;
-            int ierr = MPI_Test(&(recvbuf[n].vars_req[3*m + l]),&test,MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-            if (!(static_cast<bool>(test))) {bflag = true;}
-          }
-        }
-      } else if (jr < (nx2-ng)) {  //--- CASE 2
-        // ix1 boundary: receive from (target  ) through (target-1)
-        // ox1 boundary: receive from (target+1) through (target  )
-        for (int l=0; l<2; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l);} else {jshift = -(l-1-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
-          if (srank != global_variable::my_rank) {
-            int test;
-            int ierr = MPI_Test(&(recvbuf[n].vars_req[3*m + l]),&test,MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-            if (!(static_cast<bool>(test))) {bflag = true;}
-          }
-        }
-      } else {                     //--- CASE 3
-        // ix1 boundary: send to (target  ) through (target+2)
-        // ox1 boundary: send to (target-2) through (target  )
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l);} else {jshift = -(l-2-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
-          if (srank != global_variable::my_rank) {
-            int test;
-            int ierr = MPI_Test(&(recvbuf[n].vars_req[3*m + l]),&test,MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-            if (!(static_cast<bool>(test))) {bflag = true;}
-          }
+      for (int l=0; l<nshr_exch(n,m); ++l) {
+        if (shr_srank(n,m,l) != global_variable::my_rank) {
+          int test;
+          int ierr = MPI_Test(&(recvbuf[n].vars_req[3*m + l]),&test,MPI_STATUS_IGNORE);
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
+          if (!(static_cast<bool>(test))) {bflag = true;}
         }
       }
     }
@@ -8,6 +8,7 @@
 //! orbital advection, shearing box, and flux correction steps with shearing box
 //! boundaries.
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <utility>
@@ -21,9 +22,20 @@
 //----------------------------------------------------------------------------------------
 //! \fn void OrbitalAdvection::InitRecv
 //! \brief Posts non-blocking receives (with MPI) for boundary communications with
-//! orbital advection
+//! orbital advection.  Also decides whether the remap is performed in this cycle, which
+//! with skip_subcell requires the accumulated shift at the largest |x1| in the mesh to
+//! reach one cell.  The decision is the same on every rank.
+
+TaskStatus OrbitalAdvection::InitRecv(Real qom) {
+  dt_oa += pmy_pack->pmesh->dt;
+  remap_now = true;
+  if (skip_subcell) {
+    const auto &mesh_size = pmy_pack->pmesh->mesh_size;
+    Real xmax = std::max(fabs(mesh_size.x1min), fabs(mesh_size.x1max));
+    remap_now = (fabs(qom)*xmax*dt_oa >= mesh_size.dx2);
+  }
+  if (!(remap_now)) {return TaskStatus::complete;}
 
-TaskStatus OrbitalAdvection::InitRecv() {
 #if MPI_PARALLEL_ENABLED
   const int &nmb = pmy_pack->nmb_thispack;
   const auto &nghbr = pmy_pack->pmb->nghbr;
@@ -73,6 +85,7 @@ TaskStatus OrbitalAdvection::InitRecv() {
 //! advection to complete before allowing execution to continue
 
 TaskStatus OrbitalAdvection::ClearRecv() {
+  if (!(remap_now)) {return TaskStatus::complete;}
 #if MPI_PARALLEL_ENABLED
   bool no_errors=true;
   int &nmb = pmy_pack->nmb_thispack;
@@ -107,6 +120,7 @@ TaskStatus OrbitalAdvection::ClearRecv() {
 //! to complete before allowing execution to continue
 
 TaskStatus OrbitalAdvection::ClearSend() {
+  if (!(remap_now)) {return TaskStatus::complete;}
 #if MPI_PARALLEL_ENABLED
   bool no_errors=true;
   int &nmb = pmy_pack->nmb_thispack;
@@ -145,6 +159,7 @@ TaskStatus ShearingBoxBoundary::InitRecv(Real qom, Real time) {
   const auto &mesh_size = pmy_pack->pmesh->mesh_size;
   Real lx = (mesh_size.x1max - mesh_size.x1min);
   yshear = qom*lx*time;
+  SetShearTargets();
 
 #if MPI_PARALLEL_ENABLED
   // post non-blocking receives
@@ -177,10 +192,7 @@ TaskStatus ShearingBoxBoundary::InitRecv(Real qom, Real time) {
         // ix1 boundary: receive from (target+1) through (target-1)
         // ox1 boundary: receive from (target+1) through (target-1)
         for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l-1);} else {jshift = -(l-1-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
+          int srank = shr_srank(n,m,l);
           if (srank != global_variable::my_rank) {
             // create tag using local ID of *receiving* MeshBlock
             int tag = CreateBvals_MPI_Tag(gid, ((n<<2) | l));
@@ -208,10 +220,7 @@ TaskStatus ShearingBoxBoundary::InitRecv(Real qom, Real time) {
         // ix1 boundary: receive from (target  ) through (target-1)
         // ox1 boundary: receive from (target+1) through (target  )
         for (int l=0; l<2; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l);} else {jshift = -(l-1-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
+          int srank = shr_srank(n,m,l);
           if (srank != global_variable::my_rank) {
             // create tag using local ID of *receiving* MeshBlock
             int tag = CreateBvals_MPI_Tag(gid, ((n<<2) | l));
@@ -241,10 +250,7 @@ TaskStatus ShearingBoxBoundary::InitRecv(Real qom, Real time) {
         // ix1 boundary: send to (target  ) through (target+2)
         // ox1 boundary: send to (target-2) through (target  )
         for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l);} else {jshift = -(l-2-ji);}
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
+          int srank = shr_srank(n,m,l);
           if (srank != global_variable::my_rank) {
             // create tag using local ID of *receiving* MeshBlock
             int tag = CreateBvals_MPI_Tag(gid, ((n<<2) | l));
@@ -281,57 +287,13 @@ TaskStatus ShearingBoxBoundary::InitRecv(Real qom, Real time) {
 TaskStatus ShearingBoxBoundary::ClearRecv() {
 #if MPI_PARALLEL_ENABLED
   bool no_errors=true;
-  const int &ng = pmy_pack->pmesh->mb_indcs.ng;
-  const int &nx2 = pmy_pack->pmesh->mb_indcs.nx2;
   // wait for all non-blocking receives for vars to finish before continuing
   for (int n=0; n<2; ++n) {
     for (int m=0; m<nmb_x1bndry(n); ++m) {
-      int gid = x1bndry_mbgid.h_view(n,m);
-      int mm = gid - pmy_pack->gids;
-      // Find integer and fractional number of grids over which offset extends.
-      // This assumes every grid has same number of cells in x2-direction!
-      int joffset  = static_cast<int>(yshear/(pmy_pack->pmb->mb_size.h_view(mm).dx2));
-      int ji = joffset/nx2;
-      int jr = joffset - ji*nx2;
-
-      if (jr < ng) {               //--- CASE 1 (in my nomenclature)
-        // ix1 boundary: receive from (target+1) through (target-1)
-        // ox1 boundary: receive from (target+1) through (target-1)
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l-1);} else {jshift = -(l-1-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
-          if (srank != global_variable::my_rank) {
-            int ierr = MPI_Wait(&(recvbuf[n].vars_req[3*m + l]), MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-          }
-        }
-      } else if (jr < (nx2-ng)) {  //--- CASE 2
-        // ix1 boundary: receive from (target  ) through (target-1)
-        // ox1 boundary: receive from (target+1) through (target  )
-        for (int l=0; l<2; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l);} else {jshift = -(l-1-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
-          if (srank != global_variable::my_rank) {
-            int ierr = MPI_Wait(&(recvbuf[n].vars_req[3*m + l]), MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-          }
-        }
-      } else {                     //--- CASE 3
-        // ix1 boundary: send to (target  ) through (target+2)
-        // ox1 boundary: send to (target-2) through (target  )
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = -(ji+l);} else {jshift = -(l-2-ji);} // offset of sender
-          int sgid, srank;
-          FindTargetMB(gid,jshift,sgid,srank);
-          if (srank != global_variable::my_rank) {
-            int ierr = MPI_Wait(&(recvbuf[n].vars_req[3*m + l]), MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-          }
+      for (int l=0; l<nshr_exch(n,m); ++l) {
+        if (shr_srank(n,m,l) != global_variable::my_rank) {
+          int ierr = MPI_Wait(&(recvbuf[n].vars_req[3*m + l]), MPI_STATUS_IGNORE);
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
         }
       }
     }
@@ -354,57 +316,13 @@ TaskStatus ShearingBoxBoundary::ClearRecv() {
 TaskStatus ShearingBoxBoundary::ClearSend() {
 #if MPI_PARALLEL_ENABLED
   bool no_errors=true;
-  const int &ng = pmy_pack->pmesh->mb_indcs.ng;
-  const int &nx2 = pmy_pack->pmesh->mb_indcs.nx2;
   // wait for all non-blocking sends for vars to finish before continuing
   for (int n=0; n<2; ++n) {
     for (int m=0; m<nmb_x1bndry(n); ++m) {
-      int gid = x1bndry_mbgid.h_view(n,m);
-      int mm = gid - pmy_pack->gids;
-      // Find integer and fractional number of grids over which offset extends.
-      // This assumes every grid has same number of cells in x2-direction!
-      int joffset  = static_cast<int>(yshear/(pmy_pack->pmb->mb_size.h_view(mm).dx2));
-      int ji = joffset/nx2;
-      int jr = joffset - ji*nx2;
-
-      if (jr < ng) {               //--- CASE 1 (in my nomenclature)
-        // ix1 boundary: send to (target-1) through (target+1)
-        // ox1 boundary: send to (target-1) through (target+1)
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = ji+l-1;} else {jshift = l-1-ji;} // offset of target
-          int tgid, trank;
-          FindTargetMB(gid,jshift,tgid,trank);
-          if (trank != global_variable::my_rank) {
-            int ierr = MPI_Wait(&(sendbuf[n].vars_req[3*m + l]), MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-          }
-        }
-      } else if (jr < (nx2-ng)) {  //--- CASE 2
-        // ix1 boundary: send to (target  ) through (target+1)
-        // ox1 boundary: send to (target-1) through (target  )
-        for (int l=0; l<2; ++l) {
-          int jshift;
-          if (n==0) {jshift = ji+l;} else {jshift = l-1-ji;}
-          int tgid, trank;
-          FindTargetMB(gid,jshift,tgid,trank);
-          if (trank != global_variable::my_rank) {
-            int ierr = MPI_Wait(&(sendbuf[n].vars_req[3*m + l]), MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-          }
-        }
-      } else {                     //--- CASE 3
-        // ix1 boundary: send to (target  ) through (target+2)
-        // ox1 boundary: send to (target-2) through (target  )
-        for (int l=0; l<3; ++l) {
-          int jshift;
-          if (n==0) {jshift = ji+l;} else {jshift = l-2-ji;}
-          int tgid, trank;
-          FindTargetMB(gid,jshift,tgid,trank);
-          if (trank != global_variable::my_rank) {
-            int ierr = MPI_Wait(&(sendbuf[n].vars_req[3*m + l]), MPI_STATUS_IGNORE);
-            if (ierr != MPI_SUCCESS) {no_errors=false;}
-          }
+      for (int l=0; l<nshr_exch(n,m); ++l) {
+        if (shr_trank(n,m,l) != global_variable::my_rank) {
+          int ierr = MPI_Wait(&(sendbuf[n].vars_req[3*m + l]), MPI_STATUS_IGNORE);
+          if (ierr != MPI_SUCCESS) {no_errors=false;}
         }
       }
     }
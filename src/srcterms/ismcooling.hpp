@@ -6,7 +6,8 @@
 // Licensed under the 3-clause BSD License (the "LICENSE")
 //========================================================================================
 //! \file ismcooling.hpp
-//! \brief function to implement ISM cooling
+//! \brief functions to implement ISM cooling, either directly from the fitted cooling
+//! curve, or by lookup in a table uniformly spaced in log10(T)
 
 // Athena++ headers
 #include "athena.hpp"
@@ -55,4 +56,37 @@ Real ISMCoolFn(Real temp) {
   Real logcool = (lhd[ipps+1]*dx - lhd[ipps]*(dx - 0.04))*25.0;
   return pow(10.0,logcool);
 }
+
+//----------------------------------------------------------------------------------------
+//! \struct ISMCoolingTable
+//! \brief log10 of the cooling function Lambda(T) [erg cm^3 s^-1] tabulated uniformly in
+//! log10(T) [K], so that a lookup needs no search and no branches.  By default built by
+//! sampling ISMCoolFn(), or read from <block>/ism_cooling_table (see
+//! SourceTerms::InitISMCoolingTable()).  Accessed through a RandomAccess (read-only,
+//! texture cached on GPUs) view.
+
+struct ISMCoolingTable {
+  int ntemp = 0;                        // number of points in temperature
+  Real logt_min = 0.0, idlogt = 0.0;    // log10 of first temperature, inverse spacing
+  Kokkos::View<const Real *, LayoutWrapper, DevMemSpace,
+               Kokkos::MemoryTraits<Kokkos::RandomAccess>> loglambda;  // (ntemp)
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn Real TabularISMCoolFn()
+//! \brief Cooling function at temperature temp [K], by linear interpolation of
+//! log10(Lambda) in log10(T).  Outside the table log10(Lambda) is extrapolated linearly
+//! from the nearest interval, so a table whose cooling rises steeply at its lowest
+//! temperature gives Lambda -> 0 as T -> 0 (as required by implicit cooling).
+
+KOKKOS_INLINE_FUNCTION
+Real TabularISMCoolFn(const ISMCoolingTable &tab, const Real temp) {
+  Real xt = (log10(temp) - tab.logt_min)*tab.idlogt;
+  xt = fmin(fmax(xt, -1.0e6), 1.0e6);   // also maps T=0 (and NaN) to a finite index
+  int it = static_cast<int>(fmin(fmax(xt, 0.0), static_cast<Real>(tab.ntemp - 2)));
+  Real wt = xt - static_cast<Real>(it);
+  Real loglam = tab.loglambda(it) + wt*(tab.loglambda(it+1) - tab.loglambda(it));
+  return pow(10.0, loglam);
+}
+
 #endif // SRCTERMS_ISMCOOLING_HPP_
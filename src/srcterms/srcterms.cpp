@@ -10,12 +10,14 @@
 
 #include "srcterms.hpp"
 
+#include <cmath>
 #include <iostream>
 #include <string> // string
 
 #include "athena.hpp"
 #include "coordinates/cartesian_ks.hpp"
 #include "coordinates/cell_locations.hpp"
+#include "driver/driver.hpp"
 #include "eos/eos.hpp"
 #include "geodesic-grid/geodesic_grid.hpp"
 #include "hydro/hydro.hpp"
@@ -26,6 +28,7 @@
 #include "radiation/radiation.hpp"
 #include "turb_driver.hpp"
 #include "units/units.hpp"
+#include "utils/tr_table.hpp"
 
 //----------------------------------------------------------------------------------------
 // constructor, parses input file and initializes data structures and parameters
@@ -33,7 +36,8 @@
 
 SourceTerms::SourceTerms(std::string block, MeshBlockPack *pp, ParameterInput *pin) :
   pmy_pack(pp),
-  shearing_box_r_phi(false) {
+  shearing_box_r_phi(false),
+  ism_cooling_tab(false) {
   // (1) (constant) gravitational acceleration
   const_accel = pin->GetOrAddBoolean(block, "const_accel", false);
   if (const_accel) {
@@ -48,8 +52,29 @@ SourceTerms::SourceTerms(std::string block, MeshBlockPack *pp, ParameterInput *p
 
   // (2) Optically thin (ISM) cooling
   ism_cooling = pin->GetOrAddBoolean(block, "ism_cooling", false);
+  ism_cooling_imex = false;
   if (ism_cooling) {
     hrate = pin->GetReal(block, "hrate");
+    // With ism_cooling_method=implicit, cooling is integrated as a stiff source term in
+    // the implicit stages of ImEx integrators, and does not limit the timestep
+    std::string method = pin->GetOrAddString(block, "ism_cooling_method", "explicit");
+    if (method.compare("implicit") == 0) {
+      ism_cooling_imex = true;
+      if (block.compare("hydro") != 0) {
+        std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__
+                  << std::endl << "ism_cooling_method=implicit only implemented for "
+                  << "<hydro>" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    } else if (method.compare("explicit") != 0) {
+      std::cout << "### FATAL ERROR in "<< __FILE__ <<" at line " << __LINE__ << std::endl
+                << "ism_cooling_method=" << method << " not implemented, must be "
+                << "explicit or implicit" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    // By default the cooling function is evaluated from a table uniform in log10(T)
+    ism_cooling_tab = pin->GetOrAddBoolean(block, "ism_cooling_tabulated", true);
+    if (ism_cooling_tab) {InitISMCoolingTable(pin, block);}
   }
 
   // (3) beam source (radiation)
@@ -81,6 +106,115 @@ SourceTerms::SourceTerms(std::string block, MeshBlockPack *pp, ParameterInput *p
 SourceTerms::~SourceTerms() {
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void SourceTerms::InitISMCoolingTable()
+//! \brief Fills ism_cool_tab with log10 of the cooling function on a grid uniformly
+//! spaced in log10(T).  By default ISMCoolFn() is sampled at 10 < T < 1e9 K, with a
+//! spacing of 0.004 dex that contains every point of the SPEX table in ISMCoolFn(), so
+//! the table reproduces it exactly between 10^4.12 and 10^8.16 K.
+//!
+//! Alternatively a table may be read from <block>/ism_cooling_table, in the format of
+//! utils/tr_table.hpp.  It must have the field 'Lambda' [erg cm^3 s^-1], and either a
+//! single point 'T' [K], or points 'Z' and 'T' (in that order) for metallicity-dependent
+//! cooling (e.g. Wiersma et al. 2009 or CLOUDY grids).  In the latter case the table is
+//! interpolated linearly in Z to <block>/metallicity (in the units of the table) once
+//! here, so that only a 1D lookup is done on the device.  Temperatures must be uniformly
+//! spaced in log10(T), while metallicities may be arbitrary but increasing.
+
+void SourceTerms::InitISMCoolingTable(ParameterInput *pin, std::string block) {
+  HostArray1D<Real> loglam_h;
+  if (pin->DoesParameterExist(block, "ism_cooling_table")) {
+    std::string fname = pin->GetString(block, "ism_cooling_table");
+    TableReader::Table table;
+    auto read_result = table.ReadTable(fname);
+    if (read_result.error != TableReader::ReadResult::SUCCESS) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Cooling table '" << fname << "' could not be read:" << std::endl
+        << read_result.message << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    auto &point_info = table.GetPointInfo();
+    int ndim = table.GetNDimensions();
+    bool valid = table.HasField("Lambda") && (ndim == 1 || ndim == 2) &&
+                 (point_info[ndim-1].first.compare("T") == 0) &&
+                 (ndim == 1 || point_info[0].first.compare("Z") == 0);
+    if (!(valid)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Cooling table '" << fname << "' must have points 'T' or "
+        << "'Z','T', and field 'Lambda'" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    int nz = (ndim == 2)? point_info[0].second : 1;
+    int nt = point_info[ndim-1].second;
+    if (nt < 2) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Cooling table '" << fname << "' needs at least two "
+        << "temperatures" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // spacing in log10(T), which must be uniform so that lookups need no search
+    double *temp = table["T"];
+    Real dlogt = (log10(temp[nt-1]) - log10(temp[0]))/static_cast<Real>(nt - 1);
+    bool uniform = (dlogt > 0.0);
+    for (int it=1; it<nt && uniform; ++it) {
+      Real d = log10(temp[it]) - log10(temp[it-1]);
+      uniform = (fabs(d - dlogt) <= 1.0e-6*dlogt);
+    }
+    if (!(uniform)) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+        << std::endl << "Temperatures of cooling table '" << fname << "' must be "
+        << "increasing and uniformly spaced in log10" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    // pair of metallicities bracketing <block>/metallicity, and weight of upper one
+    int iz = 0;
+    Real wz = 0.0;
+    if (ndim == 2) {
+      double *zmet = table["Z"];
+      Real metal = pin->GetReal(block, "metallicity");
+      while (iz < nz-2 && zmet[iz+1] <= metal) {++iz;}
+      if (nz > 1) {
+        wz = (metal - zmet[iz])/(zmet[iz+1] - zmet[iz]);
+        wz = fmin(fmax(wz, 0.0), 1.0);
+      }
+    }
+
+    double *lambda = table["Lambda"];
+    Kokkos::realloc(loglam_h, nt);
+    for (int it=0; it<nt; ++it) {
+      int iz1 = (iz + 1 < nz)? iz + 1 : iz;
+      if (lambda[it + nt*iz] <= 0.0 || lambda[it + nt*iz1] <= 0.0) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+          << std::endl << "Cooling rates in table '" << fname << "' must be positive"
+          << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      loglam_h(it) = (1.0 - wz)*log10(lambda[it + nt*iz]) + wz*log10(lambda[it + nt*iz1]);
+    }
+    ism_cool_tab.ntemp = nt;
+    ism_cool_tab.logt_min = log10(temp[0]);
+    ism_cool_tab.idlogt = 1.0/dlogt;
+  } else {
+    const int nt = 2001;
+    const Real logt_min = 1.0, dlogt = 0.004;
+    Kokkos::realloc(loglam_h, nt);
+    for (int it=0; it<nt; ++it) {
+      loglam_h(it) = log10(ISMCoolFn(pow(10.0, logt_min + dlogt*it)));
+    }
+    ism_cool_tab.ntemp = nt;
+    ism_cool_tab.logt_min = logt_min;
+    ism_cool_tab.idlogt = 1.0/dlogt;
+  }
+
+  // copy to device
+  DvceArray1D<Real> loglam("ism_cool_tab", ism_cool_tab.ntemp);
+  Kokkos::deep_copy(loglam, loglam_h);
+  ism_cool_tab.loglambda = loglam;
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn
 // Add constant acceleration
@@ -129,6 +263,8 @@ void SourceTerms::ISMCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
   Real cooling_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()
                       /n_unit/n_unit;
   Real heating_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()/n_unit;
+  const bool tabulated = ism_cooling_tab;
+  auto tab = ism_cool_tab;
 
   par_for("cooling", DevExeSpace(), 0, nmb1, ks, ke, js, je, is, ie,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
@@ -140,7 +276,8 @@ void SourceTerms::ISMCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
       temp = temp_unit*w0(m,ITM,k,j,i);
     }
 
-    Real lambda_cooling = ISMCoolFn(temp)/cooling_unit;
+    Real lambda_cooling = ((tabulated)? TabularISMCoolFn(tab, temp) : ISMCoolFn(temp))
+                          /cooling_unit;
     Real gamma_heating = heating_rate/heating_unit;
 
     u0(m,IEN,k,j,i) -= bdt * w0(m,IDN,k,j,i) *
@@ -150,6 +287,122 @@ void SourceTerms::ISMCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos_da
   return;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn void SourceTerms::ISMCoolingImEx()
+//! \brief Implicit update of ISM cooling and heating in the energy equation, as a stiff
+//! source term in ImEx integrators (see IonNeutral::ImpRKUpdate()).  estage is the
+//! explicit stage, with estage <= 0 corresponding to the first two implicit stages.
+//! Each cell solves the backward Euler equation for the internal energy, which is
+//! always bracketed since cooling vanishes as T->0, so cooling never limits dt.
+// NOTE stiff source terms are stored in impl_src(s,m,0,k,j,i), and are computed using
+// only conserved variables (u0), since w0 is not updated until the end of the stage.
+
+void SourceTerms::ISMCoolingImEx(Driver *pdriver, const int estage,
+                                 const EOS_Data &eos_data, DvceArray5D<Real> &u0) {
+  // # of implicit stage (1,2,3,4,[5]).  Note estage=(# of explicit stage)=(1,2,[3])
+  int istage = estage + 2;
+
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int n1 = indcs.nx1 + 2*indcs.ng;
+  int n2 = (indcs.nx2 > 1)? (indcs.nx2 + 2*indcs.ng) : 1;
+  int n3 = (indcs.nx3 > 1)? (indcs.nx3 + 2*indcs.ng) : 1;
+  int nmb1 = pmy_pack->nmb_thispack - 1;
+  Real dt = pmy_pack->pmesh->dt;
+  auto ru_ = pdriver->impl_src;
+
+  // Add cooling evaluated in previous stages, i.e. the R(U^1), R(U^2), etc. terms,
+  // to partially updated energy.  Only required for istage = (2,3,4,[5])
+  if (istage > 1) {
+    auto &a_twid = pdriver->a_twid;
+    par_for("cool_imex_exp",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      for (int s=0; s<=(istage-2); ++s) {
+        u0(m,IEN,k,j,i) += a_twid[istage-2][s]*dt*ru_(s,m,0,k,j,i);
+      }
+    });
+  }
+
+  // With error control, estimate error of stiff source term after last stage as the
+  // change in R over the step, normalized by tolerances (see Driver::ImExStepControl())
+  if (pdriver->imex_adaptive && estage == pdriver->nexp_stages) {
+    int is = indcs.is, nx1 = indcs.nx1;
+    int js = indcs.js, nx2 = indcs.nx2;
+    int ks = indcs.ks, nx3 = indcs.nx3;
+    const int nmkji = (pmy_pack->nmb_thispack)*nx3*nx2*nx1;
+    const int nkji = nx3*nx2*nx1;
+    const int nji  = nx2*nx1;
+    int sl = pdriver->nimp_stages - 1;
+    Real rtol = pdriver->imex_rtol, atol = pdriver->imex_atol;
+    Real err = 0.0;
+    Kokkos::parallel_reduce("cool_imex_err",Kokkos::RangePolicy<>(DevExeSpace(),0,nmkji),
+    KOKKOS_LAMBDA(const int &idx, Real &max_err) {
+      int m = (idx)/nkji;
+      int k = (idx - m*nkji)/nji;
+      int j = (idx - m*nkji - k*nji)/nx1;
+      int i = (idx - m*nkji - k*nji - j*nx1) + is;
+      k += ks;
+      j += js;
+      Real e = dt*fabs(ru_(sl,m,0,k,j,i) - ru_(0,m,0,k,j,i))/
+               (atol + rtol*fabs(u0(m,IEN,k,j,i)));
+      max_err = fmax(e, max_err);
+    }, Kokkos::Max<Real>(err));
+    pdriver->imex_err = fmax(pdriver->imex_err, err);
+  }
+
+  // Solve implicit equation e = e* + a_impl*dt*R(e) for internal energy in each cell,
+  // and store R(e) for use in later stages.  Only required for istage = (1,2,3,[4])
+  if (estage < pdriver->nexp_stages) {
+    int s = istage-1;
+    Real adt = (pdriver->a_impl)*dt;
+    Real gm1 = eos_data.gamma - 1.0;
+    Real temp_unit = pmy_pack->punit->temperature_cgs();
+    Real n_unit = pmy_pack->punit->density_cgs()/pmy_pack->punit->mu()
+                  /pmy_pack->punit->atomic_mass_unit_cgs;
+    Real cooling_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()
+                        /n_unit/n_unit;
+    Real heating_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()
+                        /n_unit;
+    Real gamma_heating = hrate/heating_unit;
+    const bool tabulated = ism_cooling_tab;
+    auto tab = ism_cool_tab;
+
+    par_for("cool_imex_imp",DevExeSpace(),0,nmb1,0,(n3-1),0,(n2-1),0,(n1-1),
+    KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+      Real &d = u0(m,IDN,k,j,i);
+      Real ke = 0.5*(SQR(u0(m,IM1,k,j,i)) + SQR(u0(m,IM2,k,j,i)) +
+                     SQR(u0(m,IM3,k,j,i)))/d;
+      Real e_star = u0(m,IEN,k,j,i) - ke;
+
+      // root of f(e) = e - e* - adt*d*(Gamma - d*Lambda(T(e))) lies in (0, e_hi], with
+      // f(0) < 0 and f(e_hi) >= 0.  Bisect in log(e) to reach cells with T << T*.
+      Real e_hi = e_star + adt*d*gamma_heating;
+      if (e_hi <= 0.0) {
+        ru_(s,m,0,k,j,i) = 0.0;   // leave cell for floors in conversion to primitives
+        return;
+      }
+      Real e_lo = 1.0e-10*e_hi;
+      for (int n=0; n<64 && (e_hi > (1.0 + 1.0e-10)*e_lo); ++n) {
+        Real e_mid = sqrt(e_lo*e_hi);
+        Real temp = temp_unit*gm1*e_mid/d;
+        Real lambda = (tabulated)? TabularISMCoolFn(tab, temp) : ISMCoolFn(temp);
+        Real f = e_mid - e_star - adt*d*(gamma_heating - d*lambda/cooling_unit);
+        if (f > 0.0) {
+          e_hi = e_mid;
+        } else {
+          e_lo = e_mid;
+        }
+      }
+      Real e_new = sqrt(e_lo*e_hi);
+
+      // source term R(e) consistent with implicit update, and updated total energy
+      ru_(s,m,0,k,j,i) = (e_new - e_star)/adt;
+      u0(m,IEN,k,j,i) = e_new + ke;
+    });
+  }
+
+  return;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn void SourceTerms::RelCooling()
 //! \brief Add explict relativistic cooling in the energy and momentum equations.
@@ -11,6 +11,7 @@
 //!  (1) constant (gravitational) acceleration - for RTI
 //!  (2) shearing box in 2D (x-z), for both hydro and MHD
 //!  (3) random forcing to drive turbulence - implemented in TurbulenceDriver class
+//!  (4) optically thin ISM cooling, either explicit or implicit with ImEx integrators
 
 #include <map>
 #include <string>
@@ -18,6 +19,7 @@
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
+#include "ismcooling.hpp"
 
 // forward declarations
 class TurbulenceDriver;
@@ -36,6 +38,7 @@ class SourceTerms {
   // flags for various source terms
   bool const_accel;
   bool ism_cooling;
+  bool ism_cooling_imex;   // ISM cooling integrated implicitly with ImEx integrators
   bool rel_cooling;
   bool beam;
   bool shearing_box, shearing_box_r_phi;
@@ -49,6 +52,9 @@ class SourceTerms {
 
   // heating rate used with ISM cooling
   Real hrate;
+  // tabulated ISM cooling function (used unless ism_cooling_tabulated=false)
+  bool ism_cooling_tab;
+  ISMCoolingTable ism_cool_tab;
 
   // cooling rate used with relativistic cooling
   Real crate_rel;
@@ -61,10 +67,13 @@ class SourceTerms {
   Real qshear, omega0;
 
   // functions
+  void InitISMCoolingTable(ParameterInput *pin, std::string block);
   void ConstantAccel(const DvceArray5D<Real> &w0, const EOS_Data &eos,
                      const Real dt, DvceArray5D<Real> &u0);
   void ISMCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos,
                   const Real dt, DvceArray5D<Real> &u0);
+  void ISMCoolingImEx(Driver *pdriver, const int estage, const EOS_Data &eos,
+                      DvceArray5D<Real> &u0);
   void RelCooling(const DvceArray5D<Real> &w0, const EOS_Data &eos,
                   const Real dt, DvceArray5D<Real> &u0);
   void BeamSource(DvceArray5D<Real> &i0, const Real dt);
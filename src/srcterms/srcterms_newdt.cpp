@@ -32,7 +32,8 @@ void SourceTerms::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_d
   const int nji  = nx2*nx1;
   dtnew = static_cast<Real>(std::numeric_limits<float>::max());
 
-  if (ism_cooling) {
+  // cooling integrated implicitly with ImEx integrators does not limit timestep
+  if (ism_cooling && !(ism_cooling_imex)) {
     Real use_e = eos_data.use_e;
     Real gamma = eos_data.gamma;
     Real gm1 = gamma - 1.0;
@@ -44,6 +45,8 @@ void SourceTerms::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_d
                         / n_unit/n_unit;
     Real heating_unit = pmy_pack->punit->pressure_cgs()/pmy_pack->punit->time_cgs()
                         / n_unit;
+    const bool tabulated = ism_cooling_tab;
+    auto tab = ism_cool_tab;
 
     // find smallest (e/cooling_rate) in each cell
     Kokkos::parallel_reduce("srcterms_cooling_newdt",
@@ -68,7 +71,8 @@ void SourceTerms::NewTimeStep(const DvceArray5D<Real> &w0, const EOS_Data &eos_d
         eint = w0(m,ITM,k,j,i)*w0(m,IDN,k,j,i)/gm1;
       }
 
-      Real lambda_cooling = ISMCoolFn(temp)/cooling_unit;
+      Real lambda_cooling = ((tabulated)? TabularISMCoolFn(tab, temp) : ISMCoolFn(temp))
+                            /cooling_unit;
       Real gamma_heating = heating_rate/heating_unit;
 
       // add a tiny number
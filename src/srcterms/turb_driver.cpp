@@ -64,6 +64,8 @@ TurbulenceDriver::TurbulenceDriver(MeshBlockPack *pp, ParameterInput *pin) :
   dedt = pin->GetOrAddReal("turb_driving", "dedt", 0.0);
   // correlation time
   tcorr = pin->GetOrAddReal("turb_driving", "tcorr", 0.0);
+  // seed of random amplitudes
+  seed = pin->GetOrAddInteger("turb_driving", "seed", 1);
 
   Real nlow_sqr = nlow*nlow;
   Real nhigh_sqr = nhigh*nhigh;
@@ -314,8 +316,8 @@ void TurbulenceDriver::IncludeAddForcingTask(std::shared_ptr<TaskList> tl, TaskI
 
 //----------------------------------------------------------------------------------------
 //! \fn InitializeModes()
-// \brief Initializes driving, and so is only executed once at start of calc.
-// Cannot be included in constructor since (it seems) Kokkos::par_for not allowed in cons.
+// \brief Generates new random amplitudes of all modes and computes the new (normalized)
+// force from them.  Executed every cycle in the before_timeintegrator task list.
 
 TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   Mesh *pm = pmy_pack->pmesh;
@@ -333,16 +335,10 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
 
   // Now compute new force using new random amplitudes and phases
 
-  // Zero out new force array
+  // New force array is overwritten (not accumulated) in force_compute kernel below
   auto force_tmp_ = force_tmp;
   int &nmb = pmy_pack->nmb_thispack;
-  par_for("force_init", DevExeSpace(),0,nmb-1,0,2,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int n, int k, int j, int i) {
-    force_tmp_(m,n,k,j,i) = 0.0;
-  });
 
-  int nlow_sqr = SQR(nlow);
-  int nhigh_sqr = SQR(nhigh);
   auto mode_count_ = mode_count;
 
   auto xccc_ = xccc;
@@ -372,293 +368,115 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   auto zssc_ = zssc;
   auto zsss_ = zsss;
 
-  Real dkx, dky, dkz, kx, ky, kz;
-  Real iky, ikz;
-  Real lx = pm->mesh_size.x1max - pm->mesh_size.x1min;
-  Real ly = pm->mesh_size.x2max - pm->mesh_size.x2min;
-  Real lz = pm->mesh_size.x3max - pm->mesh_size.x3min;
-  dkx = 2.0*M_PI/lx;
-  dky = 2.0*M_PI/ly;
-  dkz = 2.0*M_PI/lz;
-
-  Real &ex = expo;
-  Real &ex_prp = exp_prp;
-  Real &ex_prl = exp_prl;
-  Real norm, kprl, kprp, kiso;
-
-  int nmode = 0;
-  int nkx, nky, nkz, nsqr;
-  for (nkx = 0; nkx <= nhigh; nkx++) {
-    for (nky = 0; nky <= nhigh; nky++) {
-      for (nkz = 0; nkz <= nhigh; nkz++) {
-        if (nkx == 0 && nky == 0 && nkz == 0) continue;
-        norm = 0.0;
-        nsqr = 0.0;
-        bool flag_prl = true;
-        if (driving_type == 0) {
-          nsqr = SQR(nkx) + SQR(nky) + SQR(nkz);
-        } else if (driving_type == 1) {
-          nsqr = SQR(nkx) + SQR(nky);
-          Real nprlsqr = SQR(nkz);
-          if (nprlsqr >= nlow_sqr && nprlsqr <= nhigh_sqr) {
-            flag_prl = true;
-          } else {
-            flag_prl = false;
-          }
+  auto kx_mode_ = kx_mode;
+  auto ky_mode_ = ky_mode;
+  auto kz_mode_ = kz_mode;
+  int driving_type_ = driving_type;
+  Real ex = expo, ex_prp = exp_prp, ex_prl = exp_prl;
+
+  // Generate random Fourier amplitudes of all modes on the device, one thread per mode.
+  // Deviates come from the counter-based Philox generator with counter (mode, deviate
+  // pair) and key (seed, cycle), so every rank computes identical amplitudes for any
+  // number of ranks or threads, and restarts continue the same sequence.  Each deviate of a
+  // mode is always used for the same amplitude, whether or not others are zero.
+  uint64_t key = (static_cast<uint64_t>(seed) << 32) ^ static_cast<uint64_t>(pm->ncycle);
+  par_for("force_modes", DevExeSpace(), 0, mode_count_-1,
+  KOKKOS_LAMBDA(int n) {
+    Real g[16];
+    for (int p=0; p<8; ++p) {
+      RanGaussianPhilox(static_cast<uint64_t>(n), static_cast<uint64_t>(p), key,
+                        g[2*p], g[2*p+1]);
+    }
+    Real kx = kx_mode_.d_view(n);
+    Real ky = ky_mode_.d_view(n);
+    Real kz = kz_mode_.d_view(n);
+    bool nkx0 = (kx == 0.0), nky0 = (ky == 0.0), nkz0 = (kz == 0.0);
+    Real norm = 0.0;
+    // amplitudes (ccc, ccs, csc, css, scc, scs, ssc, sss) of each force component
+    Real ax[8], ay[8], az[8];
+    for (int l=0; l<8; ++l) {
+      ax[l] = 0.0;
+      ay[l] = 0.0;
+      az[l] = 0.0;
+    }
+    if (driving_type_ == 0) {
+      Real kiso = sqrt(SQR(kx) + SQR(ky) + SQR(kz));
+      if (kiso > 1e-16) {
+        norm = 1.0/pow(kiso,(ex+2.0)/2.0);
+      }
+      if (!(nkz0)) {
+        Real ikz = 1.0/kz;
+        for (int l=0; l<8; ++l) {
+          bool sx = (l >= 4), sy = ((l/2)%2 == 1);
+          bool zero = (sx && nkx0) || (sy && nky0);
+          ax[l] = zero? 0.0 : g[l];
+          ay[l] = zero? 0.0 : g[8+l];
         }
-        if (nsqr >= nlow_sqr && nsqr <= nhigh_sqr && flag_prl) {
-          kx = dkx*nkx;
-          ky = dky*nky;
-          kz = dkz*nkz;
-
-          // Generate Fourier amplitudes
-          if (driving_type == 0) {
-            kiso = sqrt(SQR(kx) + SQR(ky) + SQR(kz));
-            if (kiso > 1e-16) {
-              norm = 1.0/pow(kiso,(ex+2.0)/2.0);
-            } else {
-              norm = 0.0;
-            }
-            if (nkz != 0) {
-              ikz = 1.0/(dkz*((Real) nkz));
-
-              xccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xccs_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcsc_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xcss_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xscc_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xscs_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              xssc_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xsss_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-
-              yccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              yccs_.h_view(nmode) = RanGaussianSt(&(rstate));
-              ycsc_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              ycss_.h_view(nmode) = (nky==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              yscc_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              yscs_.h_view(nmode) = (nkx==0)           ? 0.0 : RanGaussianSt(&(rstate));
-              yssc_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-              ysss_.h_view(nmode) = (nkx==0 || nky==0) ? 0.0 : RanGaussianSt(&(rstate));
-
-              // imcompressibility
-              zccc_.h_view(nmode) =  ikz*( kx*xscs_.h_view(nmode)+ky*ycss_.h_view(nmode));
-              zccs_.h_view(nmode) = -ikz*( kx*xscc_.h_view(nmode)+ky*ycsc_.h_view(nmode));
-              zcsc_.h_view(nmode) =  ikz*( kx*xsss_.h_view(nmode)-ky*yccs_.h_view(nmode));
-              zcss_.h_view(nmode) =  ikz*(-kx*xssc_.h_view(nmode)+ky*yccc_.h_view(nmode));
-              zscc_.h_view(nmode) =  ikz*(-kx*xccs_.h_view(nmode)+ky*ysss_.h_view(nmode));
-              zscs_.h_view(nmode) =  ikz*( kx*xccc_.h_view(nmode)-ky*yssc_.h_view(nmode));
-              zssc_.h_view(nmode) = -ikz*( kx*xcss_.h_view(nmode)+ky*yscs_.h_view(nmode));
-              zsss_.h_view(nmode) =  ikz*( kx*xcsc_.h_view(nmode)+ky*yscc_.h_view(nmode));
-            } else if (nky != 0) {  // kz == 0
-              iky = 1.0/(dky*((Real) nky));
-
-              xccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcsc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xscc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xssc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xccs_.h_view(nmode) = 0.0;
-              xscs_.h_view(nmode) = 0.0;
-              xcss_.h_view(nmode) = 0.0;
-              xsss_.h_view(nmode) = 0.0;
-
-              zccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zcsc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zscc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              zssc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              zccs_.h_view(nmode) = 0.0;
-              zcss_.h_view(nmode) = 0.0;
-              zscs_.h_view(nmode) = 0.0;
-              zsss_.h_view(nmode) = 0.0;
-
-              // incompressibility
-              yccc_.h_view(nmode) =  iky*kx*xssc_.h_view(nmode);
-              ycsc_.h_view(nmode) = -iky*kx*xscc_.h_view(nmode);
-              yscc_.h_view(nmode) = -iky*kx*xcsc_.h_view(nmode);
-              yssc_.h_view(nmode) =  iky*kx*xccc_.h_view(nmode);
-              yccs_.h_view(nmode) = 0.0;
-              ycss_.h_view(nmode) = 0.0;
-              yscs_.h_view(nmode) = 0.0;
-              ysss_.h_view(nmode) = 0.0;
-            } else {  // kz == ky == 0, kx != 0 by initial if statement
-              zccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zscc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              zcsc_.h_view(nmode) = 0.0;
-              zssc_.h_view(nmode) = 0.0;
-              zccs_.h_view(nmode) = 0.0;
-              zcss_.h_view(nmode) = 0.0;
-              zscs_.h_view(nmode) = 0.0;
-              zsss_.h_view(nmode) = 0.0;
-
-              yccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              yscc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              ycsc_.h_view(nmode) = 0.0;
-              yssc_.h_view(nmode) = 0.0;
-              yccs_.h_view(nmode) = 0.0;
-              ycss_.h_view(nmode) = 0.0;
-              yscs_.h_view(nmode) = 0.0;
-              ysss_.h_view(nmode) = 0.0;
-
-              // incompressibility
-              xccc_.h_view(nmode) = 0.0;
-              xscc_.h_view(nmode) = 0.0;
-              xcsc_.h_view(nmode) = 0.0;
-              xssc_.h_view(nmode) = 0.0;
-              xccs_.h_view(nmode) = 0.0;
-              xscs_.h_view(nmode) = 0.0;
-              xcss_.h_view(nmode) = 0.0;
-              xsss_.h_view(nmode) = 0.0;
-            }
-          } else if (driving_type == 1) {
-            kprl = sqrt(SQR(kx));
-            kprp = sqrt(SQR(ky) + SQR(kz));
-            if (kprl > 1e-16 && kprp > 1e-16) {
-              norm = 1.0/pow(kprp,(ex_prp+1.0)/2.0)/pow(kprl,ex_prl/2.0);
-            } else {
-              norm = 0.0;
-            }
-
-            if (nky != 0) {
-              iky = 1.0/(dky*((Real) nky));
-
-              xccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xccs_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcsc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xcss_.h_view(nmode) = RanGaussianSt(&(rstate));
-              xscc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xscs_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xssc_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-              xsss_.h_view(nmode) = (nkx==0) ? 0.0 : RanGaussianSt(&(rstate));
-
-              // incompressibility
-              yccc_.h_view(nmode) =  iky*(kx*xssc_.h_view(nmode));
-              yccs_.h_view(nmode) =  iky*(kx*xsss_.h_view(nmode));
-              ycsc_.h_view(nmode) = -iky*(kx*xscc_.h_view(nmode));
-              ycss_.h_view(nmode) = -iky*(kx*xscs_.h_view(nmode));
-              yscc_.h_view(nmode) = -iky*(kx*xcsc_.h_view(nmode));
-              yscs_.h_view(nmode) = -iky*(kx*xcss_.h_view(nmode));
-              yssc_.h_view(nmode) =  iky*(kx*xccc_.h_view(nmode));
-              ysss_.h_view(nmode) =  iky*(kx*xccs_.h_view(nmode));
-
-              zccc_.h_view(nmode) = 0.0;
-              zccs_.h_view(nmode) = 0.0;
-              zcsc_.h_view(nmode) = 0.0;
-              zcss_.h_view(nmode) = 0.0;
-              zscc_.h_view(nmode) = 0.0;
-              zscs_.h_view(nmode) = 0.0;
-              zssc_.h_view(nmode) = 0.0;
-              zsss_.h_view(nmode) = 0.0;
-            } else {  // ky == 0
-              yccc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              yscc_.h_view(nmode) = RanGaussianSt(&(rstate));
-              ycsc_.h_view(nmode) = 0.0;
-              yssc_.h_view(nmode) = 0.0;
-              yccs_.h_view(nmode) = 0.0;
-              ycss_.h_view(nmode) = 0.0;
-              yscs_.h_view(nmode) = 0.0;
-              ysss_.h_view(nmode) = 0.0;
-
-              // incompressibility
-              xccc_.h_view(nmode) = 0.0;
-              xscc_.h_view(nmode) = 0.0;
-              xcsc_.h_view(nmode) = 0.0;
-              xssc_.h_view(nmode) = 0.0;
-              xccs_.h_view(nmode) = 0.0;
-              xscs_.h_view(nmode) = 0.0;
-              xcss_.h_view(nmode) = 0.0;
-              xsss_.h_view(nmode) = 0.0;
-
-              zccc_.h_view(nmode) = 0.0;
-              zscc_.h_view(nmode) = 0.0;
-              zcsc_.h_view(nmode) = 0.0;
-              zssc_.h_view(nmode) = 0.0;
-              zccs_.h_view(nmode) = 0.0;
-              zcss_.h_view(nmode) = 0.0;
-              zscs_.h_view(nmode) = 0.0;
-              zsss_.h_view(nmode) = 0.0;
-            }
-          }
-          // normalization
-          xccc_.h_view(nmode) *= norm;
-          xscc_.h_view(nmode) *= norm;
-          xcsc_.h_view(nmode) *= norm;
-          xssc_.h_view(nmode) *= norm;
-          xccs_.h_view(nmode) *= norm;
-          xscs_.h_view(nmode) *= norm;
-          xcss_.h_view(nmode) *= norm;
-          xsss_.h_view(nmode) *= norm;
-          yccc_.h_view(nmode) *= norm;
-          yscc_.h_view(nmode) *= norm;
-          ycsc_.h_view(nmode) *= norm;
-          yssc_.h_view(nmode) *= norm;
-          yccs_.h_view(nmode) *= norm;
-          yscs_.h_view(nmode) *= norm;
-          ycss_.h_view(nmode) *= norm;
-          ysss_.h_view(nmode) *= norm;
-          zccc_.h_view(nmode) *= norm;
-          zscc_.h_view(nmode) *= norm;
-          zcsc_.h_view(nmode) *= norm;
-          zssc_.h_view(nmode) *= norm;
-          zccs_.h_view(nmode) *= norm;
-          zscs_.h_view(nmode) *= norm;
-          zcss_.h_view(nmode) *= norm;
-          zsss_.h_view(nmode) *= norm;
-
-          nmode++;
+        // imcompressibility
+        az[0] =  ikz*( kx*ax[5]+ky*ay[3]);
+        az[1] = -ikz*( kx*ax[4]+ky*ay[2]);
+        az[2] =  ikz*( kx*ax[7]-ky*ay[1]);
+        az[3] =  ikz*(-kx*ax[6]+ky*ay[0]);
+        az[4] =  ikz*(-kx*ax[1]+ky*ay[7]);
+        az[5] =  ikz*( kx*ax[0]-ky*ay[6]);
+        az[6] = -ikz*( kx*ax[3]+ky*ay[5]);
+        az[7] =  ikz*( kx*ax[2]+ky*ay[4]);
+      } else if (!(nky0)) {  // kz == 0
+        Real iky = 1.0/ky;
+        ax[0] = g[0];
+        ax[2] = g[1];
+        ax[4] = nkx0? 0.0 : g[2];
+        ax[6] = nkx0? 0.0 : g[3];
+        az[0] = g[4];
+        az[2] = g[5];
+        az[4] = nkx0? 0.0 : g[6];
+        az[6] = nkx0? 0.0 : g[7];
+        // incompressibility
+        ay[0] =  iky*kx*ax[6];
+        ay[2] = -iky*kx*ax[4];
+        ay[4] = -iky*kx*ax[2];
+        ay[6] =  iky*kx*ax[0];
+      } else {  // kz == ky == 0, kx != 0 by construction of modes
+        az[0] = g[0];
+        az[4] = g[1];
+        ay[0] = g[2];
+        ay[4] = g[3];
+      }
+    } else if (driving_type_ == 1) {
+      Real kprl = sqrt(SQR(kx));
+      Real kprp = sqrt(SQR(ky) + SQR(kz));
+      if (kprl > 1e-16 && kprp > 1e-16) {
+        norm = 1.0/pow(kprp,(ex_prp+1.0)/2.0)/pow(kprl,ex_prl/2.0);
+      }
+      if (!(nky0)) {
+        Real iky = 1.0/ky;
+        for (int l=0; l<8; ++l) {
+          ax[l] = ((l >= 4) && nkx0)? 0.0 : g[l];
         }
+        // incompressibility
+        ay[0] =  iky*(kx*ax[6]);
+        ay[1] =  iky*(kx*ax[7]);
+        ay[2] = -iky*(kx*ax[4]);
+        ay[3] = -iky*(kx*ax[5]);
+        ay[4] = -iky*(kx*ax[2]);
+        ay[5] = -iky*(kx*ax[3]);
+        ay[6] =  iky*(kx*ax[0]);
+        ay[7] =  iky*(kx*ax[1]);
+      } else {  // ky == 0
+        ay[0] = g[0];
+        ay[4] = g[1];
       }
     }
-  }
-
-  xccc_.template modify<HostMemSpace>();
-  xccc_.template sync<DevExeSpace>();
-  xccs_.template modify<HostMemSpace>();
-  xccs_.template sync<DevExeSpace>();
-  xcsc_.template modify<HostMemSpace>();
-  xcsc_.template sync<DevExeSpace>();
-  xcss_.template modify<HostMemSpace>();
-  xcss_.template sync<DevExeSpace>();
-  xscc_.template modify<HostMemSpace>();
-  xscc_.template sync<DevExeSpace>();
-  xscs_.template modify<HostMemSpace>();
-  xscs_.template sync<DevExeSpace>();
-  xssc_.template modify<HostMemSpace>();
-  xssc_.template sync<DevExeSpace>();
-  xsss_.template modify<HostMemSpace>();
-  xsss_.template sync<DevExeSpace>();
-
-  yccc_.template modify<HostMemSpace>();
-  yccc_.template sync<DevExeSpace>();
-  yccs_.template modify<HostMemSpace>();
-  yccs_.template sync<DevExeSpace>();
-  ycsc_.template modify<HostMemSpace>();
-  ycsc_.template sync<DevExeSpace>();
-  ycss_.template modify<HostMemSpace>();
-  ycss_.template sync<DevExeSpace>();
-  yscc_.template modify<HostMemSpace>();
-  yscc_.template sync<DevExeSpace>();
-  yscs_.template modify<HostMemSpace>();
-  yscs_.template sync<DevExeSpace>();
-  yssc_.template modify<HostMemSpace>();
-  yssc_.template sync<DevExeSpace>();
-  ysss_.template modify<HostMemSpace>();
-  ysss_.template sync<DevExeSpace>();
-
-  zccc_.template modify<HostMemSpace>();
-  zccc_.template sync<DevExeSpace>();
-  zccs_.template modify<HostMemSpace>();
-  zccs_.template sync<DevExeSpace>();
-  zcsc_.template modify<HostMemSpace>();
-  zcsc_.template sync<DevExeSpace>();
-  zcss_.template modify<HostMemSpace>();
-  zcss_.template sync<DevExeSpace>();
-  zscc_.template modify<HostMemSpace>();
-  zscc_.template sync<DevExeSpace>();
-  zscs_.template modify<HostMemSpace>();
-  zscs_.template sync<DevExeSpace>();
-  zssc_.template modify<HostMemSpace>();
-  zssc_.template sync<DevExeSpace>();
-  zsss_.template modify<HostMemSpace>();
-  zsss_.template sync<DevExeSpace>();
+    // normalization
+    xccc_(n) = norm*ax[0];  yccc_(n) = norm*ay[0];  zccc_(n) = norm*az[0];
+    xccs_(n) = norm*ax[1];  yccs_(n) = norm*ay[1];  zccs_(n) = norm*az[1];
+    xcsc_(n) = norm*ax[2];  ycsc_(n) = norm*ay[2];  zcsc_(n) = norm*az[2];
+    xcss_(n) = norm*ax[3];  ycss_(n) = norm*ay[3];  zcss_(n) = norm*az[3];
+    xscc_(n) = norm*ax[4];  yscc_(n) = norm*ay[4];  zscc_(n) = norm*az[4];
+    xscs_(n) = norm*ax[5];  yscs_(n) = norm*ay[5];  zscs_(n) = norm*az[5];
+    xssc_(n) = norm*ax[6];  yssc_(n) = norm*ay[6];  zssc_(n) = norm*az[6];
+    xsss_(n) = norm*ax[7];  ysss_(n) = norm*ay[7];  zsss_(n) = norm*az[7];
+  });
 
   auto xcos_ = xcos;
   auto xsin_ = xsin;
@@ -667,37 +485,32 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   auto zcos_ = zcos;
   auto zsin_ = zsin;
 
-  for (int n=0; n<mode_count_; n++) {
-    par_for("force_compute", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-    KOKKOS_LAMBDA(int m, int k, int j, int i) {
-      force_tmp_(m,0,k,j,i) += xccc_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xccs_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xcsc_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xcss_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xscc_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xscs_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xssc_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,0,k,j,i) += xsss_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-
-      force_tmp_(m,1,k,j,i) += yccc_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yccs_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,1,k,j,i) += ycsc_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += ycss_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yscc_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yscs_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,1,k,j,i) += yssc_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,1,k,j,i) += ysss_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-
-      force_tmp_(m,2,k,j,i) += zccc_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zccs_.d_view(n)*xcos_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zcsc_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zcss_.d_view(n)*xcos_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zscc_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zscs_.d_view(n)*xsin_(m,n,i)*ycos_(m,n,j)*zsin_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zssc_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zcos_(m,n,k);
-      force_tmp_(m,2,k,j,i) += zsss_.d_view(n)*xsin_(m,n,i)*ysin_(m,n,j)*zsin_(m,n,k);
-    });
-  }
+  // Sum all modes in a single kernel, accumulating the force in registers.  The eight
+  // products of sin/cos in each direction are shared by all three force components.
+  par_for("force_compute", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
+  KOKKOS_LAMBDA(int m, int k, int j, int i) {
+    Real f1 = 0.0, f2 = 0.0, f3 = 0.0;
+    for (int n=0; n<mode_count_; n++) {
+      Real cx = xcos_(m,n,i), sx = xsin_(m,n,i);
+      Real cy = ycos_(m,n,j), sy = ysin_(m,n,j);
+      Real cz = zcos_(m,n,k), sz = zsin_(m,n,k);
+      Real ccc = cx*cy*cz, ccs = cx*cy*sz, csc = cx*sy*cz, css = cx*sy*sz;
+      Real scc = sx*cy*cz, scs = sx*cy*sz, ssc = sx*sy*cz, sss = sx*sy*sz;
+
+      f1 += xccc_(n)*ccc + xccs_(n)*ccs + xcsc_(n)*csc +
+            xcss_(n)*css + xscc_(n)*scc + xscs_(n)*scs +
+            xssc_(n)*ssc + xsss_(n)*sss;
+      f2 += yccc_(n)*ccc + yccs_(n)*ccs + ycsc_(n)*csc +
+            ycss_(n)*css + yscc_(n)*scc + yscs_(n)*scs +
+            yssc_(n)*ssc + ysss_(n)*sss;
+      f3 += zccc_(n)*ccc + zccs_(n)*ccs + zcsc_(n)*csc +
+            zcss_(n)*css + zscc_(n)*scc + zscs_(n)*scs +
+            zssc_(n)*ssc + zsss_(n)*sss;
+    }
+    force_tmp_(m,0,k,j,i) = f1;
+    force_tmp_(m,1,k,j,i) = f2;
+    force_tmp_(m,2,k,j,i) = f3;
+  });
 
   DvceArray5D<Real> u0, u0_;
   if (pmy_pack->phydro != nullptr) u0 = (pmy_pack->phydro->u0);
@@ -712,48 +525,16 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   const int nmkji = nmb*nx3*nx2*nx1;
   const int nkji = nx3*nx2*nx1;
   const int nji  = nx2*nx1;
-  Real t0 = 0.0, t1 = 0.0, t2 = 0.0, t3 = 0.0;
-
-  Kokkos::parallel_reduce("net_mom_1", Kokkos::RangePolicy<>(DevExeSpace(),0,nmkji),
-  KOKKOS_LAMBDA(const int &idx, Real &sum_t0, Real &sum_t1,
-                                Real &sum_t2, Real &sum_t3) {
-    // compute n,k,j,i indices of thread
-    int m = (idx)/nkji;
-    int k = (idx - m*nkji)/nji;
-    int j = (idx - m*nkji - k*nji)/nx1;
-    int i = (idx - m*nkji - k*nji - j*nx1) + is;
-    k += ks;
-    j += js;
-    Real den = u0(m,IDN,k,j,i);
-    if (flag_twofl) {
-      den += u0_(m,IDN,k,j,i);
-    }
-    sum_t0 += den;
-    sum_t1 += den*force_tmp_(m,0,k,j,i);
-    sum_t2 += den*force_tmp_(m,1,k,j,i);
-    sum_t3 += den*force_tmp_(m,2,k,j,i);
-  }, Kokkos::Sum<Real>(t0), Kokkos::Sum<Real>(t1),
-     Kokkos::Sum<Real>(t2), Kokkos::Sum<Real>(t3));
-
-
-#if MPI_PARALLEL_ENABLED
-  Real m[4], gm[4];
-  m[0] = t0; m[1] = t1; m[2] = t2; m[3] = t3;
-  MPI_Allreduce(m, gm, 4, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  t0 = gm[0]; t1 = gm[1]; t2 = gm[2]; t3 = gm[3];
-#endif
 
-  par_for("force_remove_net_mom", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    force_tmp_(m,0,k,j,i) -= t1/t0;
-    force_tmp_(m,1,k,j,i) -= t2/t0;
-    force_tmp_(m,2,k,j,i) -= t3/t0;
-  });
-
-  t0 = 0.0;
-  t1 = 0.0;
-  Kokkos::parallel_reduce("net_mom_2", Kokkos::RangePolicy<>(DevExeSpace(),0,nmkji),
-  KOKKOS_LAMBDA(const int &idx, Real &sum_t0, Real &sum_t1) {
+  // Compute all sums needed to remove the net momentum of the force and normalize it
+  // to the energy injection rate in one reduction (and one MPI_Allreduce).  Since the
+  // net momentum is removed by subtracting a constant c = sum(den*f)/sum(den), sums
+  // over the corrected force are found from those over the uncorrected force using
+  //   sum(den*(f-c)^2) = sum(den*f^2) - c.sum(den*f)
+  //   sum(mom.(f-c))   = sum(mom.f)   - c.sum(mom)
+  array_sum::GlobalSum fsum;
+  Kokkos::parallel_reduce("force_sums", Kokkos::RangePolicy<>(DevExeSpace(),0,nmkji),
+  KOKKOS_LAMBDA(const int &idx, array_sum::GlobalSum &mb_sum) {
     // compute n,k,j,i indices of thread
     int m = (idx)/nkji;
     int k = (idx - m*nkji)/nji;
@@ -776,16 +557,33 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
     Real v2 = force_tmp_(m,1,k,j,i);
     Real v3 = force_tmp_(m,2,k,j,i);
 
-    sum_t0 += den*(v1*v1+v2*v2+v3*v3);
-    sum_t1 += mom1*v1+mom2*v2+mom3*v3;
-  }, Kokkos::Sum<Real>(t0), Kokkos::Sum<Real>(t1));
+    array_sum::GlobalSum fvars;
+    fvars.the_array[0] = den;
+    fvars.the_array[1] = den*v1;
+    fvars.the_array[2] = den*v2;
+    fvars.the_array[3] = den*v3;
+    fvars.the_array[4] = den*(v1*v1 + v2*v2 + v3*v3);
+    fvars.the_array[5] = mom1*v1 + mom2*v2 + mom3*v3;
+    fvars.the_array[6] = mom1;
+    fvars.the_array[7] = mom2;
+    fvars.the_array[8] = mom3;
+    mb_sum += fvars;
+  }, Kokkos::Sum<array_sum::GlobalSum>(fsum));
 
 #if MPI_PARALLEL_ENABLED
-  m[0] = t0; m[1] = t1;
-  MPI_Allreduce(m, gm, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  t0 = gm[0]; t1 = gm[1];
+  MPI_Allreduce(MPI_IN_PLACE, fsum.the_array, 9, MPI_ATHENA_REAL, MPI_SUM,
+                MPI_COMM_WORLD);
 #endif
 
+  Real &sden = fsum.the_array[0];
+  Real c1 = fsum.the_array[1]/sden;
+  Real c2 = fsum.the_array[2]/sden;
+  Real c3 = fsum.the_array[3]/sden;
+  Real t0 = fsum.the_array[4] - (c1*fsum.the_array[1] + c2*fsum.the_array[2] +
+                                 c3*fsum.the_array[3]);
+  Real t1 = fsum.the_array[5] - (c1*fsum.the_array[6] + c2*fsum.the_array[7] +
+                                 c3*fsum.the_array[8]);
+
   t0 = std::max(t0, 1.0e-20);
   t1 = std::max(t1, 1.0e-20);
 
@@ -803,11 +601,12 @@ TaskStatus TurbulenceDriver::InitializeModes(Driver *pdrive, int stage) {
   }
   if (m0 == 0.0) s = 0.0;
 
+  // remove net momentum and normalize force in one kernel
   par_for("force_norm", DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
   KOKKOS_LAMBDA(int m, int k, int j, int i) {
-    force_tmp_(m,0,k,j,i) *= s;
-    force_tmp_(m,1,k,j,i) *= s;
-    force_tmp_(m,2,k,j,i) *= s;
+    force_tmp_(m,0,k,j,i) = s*(force_tmp_(m,0,k,j,i) - c1);
+    force_tmp_(m,1,k,j,i) = s*(force_tmp_(m,1,k,j,i) - c2);
+    force_tmp_(m,2,k,j,i) = s*(force_tmp_(m,2,k,j,i) - c3);
   });
 
   return TaskStatus::complete;
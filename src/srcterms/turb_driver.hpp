@@ -25,11 +25,12 @@ class TurbulenceDriver {
   ~TurbulenceDriver();
 
   DvceArray5D<Real> force, force_tmp;  // arrays used for turb forcing
-  RNG_State rstate;                    // random state
+  RNG_State rstate;  // random state (unused, kept for format of restart files)
 
-  DualArray1D<Real> xccc, xccs, xcsc, xcss, xscc, xscs, xssc, xsss;
-  DualArray1D<Real> yccc, yccs, ycsc, ycss, yscc, yscs, yssc, ysss;
-  DualArray1D<Real> zccc, zccs, zcsc, zcss, zscc, zscs, zssc, zsss;
+  // random amplitudes of each mode, generated on device
+  DvceArray1D<Real> xccc, xccs, xcsc, xcss, xscc, xscs, xssc, xsss;
+  DvceArray1D<Real> yccc, yccs, ycsc, ycss, yscc, yscs, yssc, ysss;
+  DvceArray1D<Real> zccc, zccs, zcsc, zcss, zscc, zscs, zssc, zsss;
   DualArray1D<Real> kx_mode, ky_mode, kz_mode;
   DvceArray3D<Real> xcos, xsin, ycos, ysin, zcos, zsin;
 
@@ -39,6 +40,7 @@ class TurbulenceDriver {
   Real tcorr, dedt;
   Real expo, exp_prl, exp_prp;
   int driving_type;
+  int seed;          // key of counter-based RNG used for amplitudes (with cycle number)
 
   // functions
   void IncludeInitializeModesTask(std::shared_ptr<TaskList> tl, TaskID start);
@@ -62,6 +62,7 @@ enum TaskName {
   Z4c_SomBC,
   Z4c_ExplRK,
   Z4c_SendU,
+  Z4c_RHSInt,
   Z4c_RestU,
   Z4c_RecvU,
   Z4c_Newdt,
@@ -13,17 +13,20 @@
 // This version includes improvements due to Josh Dolence and the Parthenon dev team, and
 // extensions by J.M.Stone.
 
-#include <iostream>
+#include <algorithm>
 #include <bitset>
+#include <cstdint>
+#include <iostream>
 #include <functional>
 #include <vector>
 #include <list>
 #include <iterator>
+#include <queue>
+#include <string>
 
-class Driver;
+#include <Kokkos_Core.hpp>
 
-// Maximum size of TL
-#define NUMBER_TASKID_BITS 64
+class Driver;
 
 // constants = return codes for functions working on individual Tasks and TaskList
 enum class TaskStatus {fail, complete, incomplete};
@@ -31,52 +34,72 @@ enum class TaskListStatus {running, stuck, complete, nothing_to_do};
 
 //----------------------------------------------------------------------------------------
 //! \class TaskID
-//  \brief container class for bit fields (used to encode Task IDs) and access functions
+//  \brief container class for bit fields (used to encode Task IDs) and access functions.
+//  Bits are stored in 64-bit words that are added as needed, so the number of tasks in a
+//  TaskList is unbounded.  Missing words are treated as zero.
 
 class TaskID {
  public:
   TaskID() = default;
   // ctor, default id = 0.
   explicit TaskID(unsigned int id) {
-    if (id == 0) {
-      bitfld_.reset();      // set all bits to zero
-    } else {
-      bitfld_.set((--id));  // set [id-1] bit to one
+    if (id != 0) {
+      --id;
+      bitfld_.assign(id/64 + 1, 0);
+      bitfld_[id/64] = (std::uint64_t(1) << (id % 64));  // set [id-1] bit to one
     }
   }
 
   // functions (all implemented here)
-  void Clear() { bitfld_.reset(); }  // set all bits to zero
+  void Clear() { bitfld_.clear(); }  // set all bits to zero
   // return true if input dependencies are clear
   bool CheckDependencies(const TaskID &dep) const {
-    return ((bitfld_ & dep.bitfld_) == dep.bitfld_);
+    for (std::size_t n=0; n<dep.bitfld_.size(); ++n) {
+      if ((Word(n) & dep.bitfld_[n]) != dep.bitfld_[n]) {return false;}
+    }
+    return true;
   }
   // output ID (useful for debugging)
-  void PrintID() {std::cout << "TaskID = " << bitfld_.to_string() << std::endl;}
+  void PrintID() {
+    std::cout << "TaskID = ";
+    for (auto n=bitfld_.size(); n>0; --n) {std::cout << std::bitset<64>(bitfld_[n-1]);}
+    std::cout << std::endl;
+  }
   // mark task with input TaskID as complete
-  void SetComplete(const TaskID &rhs) { bitfld_ |= rhs.bitfld_; }
+  void SetComplete(const TaskID &rhs) { *this = (*this | rhs); }
 
   // overload some operators
-  bool operator== (const TaskID &rhs) const {return (bitfld_ == rhs.bitfld_); }
-  bool operator!= (const TaskID &rhs) const {return (bitfld_ != rhs.bitfld_); }
+  bool operator== (const TaskID &rhs) const {
+    std::size_t nw = std::max(bitfld_.size(), rhs.bitfld_.size());
+    for (std::size_t n=0; n<nw; ++n) {
+      if (Word(n) != rhs.Word(n)) {return false;}
+    }
+    return true;
+  }
+  bool operator!= (const TaskID &rhs) const {return !(*this == rhs); }
   TaskID operator| (const TaskID &rhs) const {
-    TaskID ret;
-    ret.bitfld_ = (bitfld_ | rhs.bitfld_);
-    return ret;
+    return Combine(rhs, [](std::uint64_t a, std::uint64_t b) {return a | b;});
   }
   TaskID operator^ (const TaskID &rhs) const {
-    TaskID ret;
-    ret.bitfld_ = (bitfld_ ^ rhs.bitfld_);
-    return ret;
+    return Combine(rhs, [](std::uint64_t a, std::uint64_t b) {return a ^ b;});
   }
   TaskID operator& (const TaskID &rhs) const {
-    TaskID ret;
-    ret.bitfld_ = (bitfld_ & rhs.bitfld_);
-    return ret;
+    return Combine(rhs, [](std::uint64_t a, std::uint64_t b) {return a & b;});
   }
 
  private:
-  std::bitset<NUMBER_TASKID_BITS> bitfld_;
+  std::vector<std::uint64_t> bitfld_;
+  std::uint64_t Word(std::size_t n) const {
+    return (n < bitfld_.size())? bitfld_[n] : 0;
+  }
+  template <class Op>
+  TaskID Combine(const TaskID &rhs, Op op) const {
+    TaskID ret;
+    std::size_t nw = std::max(bitfld_.size(), rhs.bitfld_.size());
+    ret.bitfld_.resize(nw);
+    for (std::size_t n=0; n<nw; ++n) {ret.bitfld_[n] = op(Word(n), rhs.Word(n));}
+    return ret;
+  }
 };
 
 //----------------------------------------------------------------------------------------
@@ -86,12 +109,14 @@ class TaskID {
 
 class Task {
  public:
-  Task(TaskID id, TaskID dep, std::function<TaskStatus(Driver*, int)> func) :
-  myid_(id), dep_(dep), func_(func) {}
+  Task(TaskID id, TaskID dep, std::function<TaskStatus(Driver*, int)> func,
+       std::string name) :
+  myid_(id), dep_(dep), func_(func), name_(name) {}
   // overloaded operator() calls task function
   TaskStatus operator()(Driver *d, int s) {return func_(d,s);}
   TaskID GetID() {return myid_;}
   TaskID GetDependency() {return dep_;}
+  const std::string &GetName() const {return name_;}
   void SetComplete() {complete_ = true;}
   void SetIncomplete() {complete_ = false;}
   bool IsComplete() {return complete_;}
@@ -99,6 +124,12 @@ class Task {
   void ChangeDependency(TaskID id, TaskID newdep) {
     if ((dep_ & id) == id) {dep_ = ((dep_ ^ id) | newdep);}
   }
+  // accumulate/reset timers of this task (host time of call, and time to fence device)
+  void AddTime(double thost, double tdvce) {ncall_++; thost_ += thost; tdvce_ += tdvce;}
+  void ResetTime() {ncall_ = 0; thost_ = 0.0; tdvce_ = 0.0;}
+  int NumCalls() const {return ncall_;}
+  double HostTime() const {return thost_;}
+  double DeviceTime() const {return tdvce_;}
 
  private:
   TaskID myid_;    // encodes task ID in bitfld_
@@ -106,6 +137,9 @@ class Task {
   // bool lb_time_;   // flag to include this task in timing for automatic load balancing
   bool complete_ = false;
   std::function<TaskStatus(Driver*, int)> func_;  // ptr to Task function
+  std::string name_;  // name of task used in timer reports and profiling regions
+  int ncall_ = 0;
+  double thost_ = 0.0, tdvce_ = 0.0;
 };
 
 //----------------------------------------------------------------------------------------
@@ -119,6 +153,7 @@ class TaskList {
 
   // functions (all implemented here)
   bool IsComplete() {
+    if (graph_built_) {return (ncomplete_ == static_cast<int>(tasks_.size()));}
     // cycle through task list and check if each task completed
     for (auto &it : task_list_) {
       auto id = it.GetID();
@@ -135,79 +170,144 @@ class TaskList {
   void PrintIDs() { for (auto &it : task_list_) {it.GetID().PrintID();} }
   void PrintDependencies() { for (auto &it : task_list_) {it.GetDependency().PrintID();} }
 
-  //
+  // Reset all tasks to incomplete, and initialize counters of pending dependencies and
+  // queue of ready tasks.  Dependency graph is (re)built if tasks were added/inserted.
   void Reset() {
     tasks_completed_.Clear();  // TaskID Clear() fn
     for (auto &it : task_list_) { it.SetIncomplete(); }
+    if (!graph_built_) {BuildGraph();}
+    ready_ = std::priority_queue<int, std::vector<int>, std::greater<int>>();
+    for (int i=0; i<static_cast<int>(tasks_.size()); ++i) {
+      npending_[i] = ndep_[i];
+      if (npending_[i] == 0) {ready_.push(i);}
+    }
+    ncomplete_ = 0;
   }
 
-  // cycle through task list once, do any tasks whose dependencies are clear
+  // enable/disable timing of tasks.  When enabled, the device is fenced after each task
+  // and the time spent in tasks which complete is accumulated. Time spent in tasks that
+  // return incomplete (e.g. polling for MPI messages) is not included.
+  void SetTiming(bool flag) {timed_ = flag;}
+  double BusyTime() const {return busy_time_;}
+  void ResetBusyTime() {busy_time_ = 0.0;}
+
+  // enable/disable per-task timers.  When enabled both the host time of each call to a
+  // task and the time until the device is fenced are accumulated for every call
+  // (including incomplete calls).  Each call is always wrapped in a Kokkos profiling
+  // region named after the task.
+  void SetTaskTimers(bool flag) {task_timers_ = flag;}
+  const std::list<Task> &Tasks() const {return task_list_;}
+  void ResetTaskTimers() { for (auto &it : task_list_) {it.ResetTime();} }
+
+  // make one pass through the queue of ready tasks (those with no pending dependencies)
+  // in the order they were added to list.  Tasks that become ready during the pass are
+  // run in the same pass if they follow the current task in the list, and tasks that
+  // return incomplete are retried in the next pass. Returns stuck if no task completed
+  // during this pass (e.g. all are waiting on MPI messages)
   TaskListStatus DoAvailable(Driver *d, int s) {
-    for (auto &task : task_list_) {
-      auto dep = task.GetDependency();
-      if ( tasks_completed_.CheckDependencies(dep) && !(task.IsComplete()) ) {
-        TaskStatus status = task(d,s);  // calls Task function using overloaded operator()
-        if (status == TaskStatus::complete) {
-          task.SetComplete();              // set bool flag in task
-          MarkTaskComplete(task.GetID());  // add TaskID to tasks_completed_
+    bool progress = false;
+    retry_.clear();
+    while (!ready_.empty()) {
+      int i = ready_.top();
+      ready_.pop();
+      Task &task = *(tasks_[i]);
+      if (timed_ || task_timers_) {timer_.reset();}
+      // profiling regions are no-ops unless a Kokkos tool (or kernel profiler) is active
+      Kokkos::Profiling::pushRegion(task.GetName());
+      TaskStatus status = task(d,s);  // calls Task function using overloaded operator()
+      if (task_timers_) {
+        double thost = timer_.seconds();
+        Kokkos::fence();
+        task.AddTime(thost, timer_.seconds());
+      } else if (timed_ && status == TaskStatus::complete) {
+        Kokkos::fence();
+      }
+      Kokkos::Profiling::popRegion();
+      if (timed_ && status == TaskStatus::complete) {busy_time_ += timer_.seconds();}
+      if (status == TaskStatus::complete) {
+        task.SetComplete();              // set bool flag in task
+        MarkTaskComplete(task.GetID());  // add TaskID to tasks_completed_
+        ncomplete_++;
+        progress = true;
+        for (auto n : dependents_[i]) {
+          if (--npending_[n] == 0) {
+            if (n > i) {
+              ready_.push(n);
+            } else {
+              retry_.push_back(n);
+            }
+          }
         }
+      } else {
+        retry_.push_back(i);
       }
     }
+    for (auto n : retry_) {ready_.push(n);}
     if (IsComplete()) return TaskListStatus::complete;
+    if (!progress) return TaskListStatus::stuck;
     return TaskListStatus::running;
   }
 
   // ADD new Task with ID, given dependency, and a pointer to a static or non-member
   // function to the end of task list.  Returns ID of new task. Task function must have
-  // arguments (Driver*, int). Usage:
+  // arguments (Driver*, int). Optional name is used in timer reports. Usage:
   //     taskid = tl.AddTask(DoSomething, dependency, name);
   template <class F>
-  TaskID AddTask(F func, TaskID &dep) {
+  TaskID AddTask(F func, TaskID &dep, const std::string &name = "") {
+    graph_built_ = false;
     auto size = task_list_.size();
     TaskID id(size+1);
     task_list_.push_back(
-      Task(id, dep, [=](Driver *d, int s) mutable -> TaskStatus {return func(d,s);}));
+      Task(id, dep, [=](Driver *d, int s) mutable -> TaskStatus {return func(d,s);},
+           DefaultName(name, size)));
     return id;
   }
 
   // ADD new Task with ID, given dependency, and a pointer to a member function of
   // class T to the end of task list.  Returns ID of new task. Task function must have
   // arguments (Driver*, int).  Usage:
-  //     taskid = tl.AddTask(&T::DoSomething, T, dependency);
+  //     taskid = tl.AddTask(&T::DoSomething, T, dependency, name);
   template <class F, class T>
-  TaskID AddTask(F func, T *obj, TaskID &dep) {
+  TaskID AddTask(F func, T *obj, TaskID &dep, const std::string &name = "") {
+    graph_built_ = false;
     auto size = task_list_.size();
     TaskID id(size+1);
     task_list_.push_back( Task(id, dep,
-       [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s);}) );
+       [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s);},
+       DefaultName(name, size)) );
     return id;
   }
 
   // ADD new Task with ID, given dependency, and a std::function to the end of task
   // list. Returns ID of new task. Task function must have arguments (Driver*, int).
   // Usage:
-  //      taskid = tl.AddTask(DoSomething, dependency);
-  TaskID AddTask(std::function<TaskStatus(Driver*, int)> func, TaskID &dep) {
+  //      taskid = tl.AddTask(DoSomething, dependency, name);
+  TaskID AddTask(std::function<TaskStatus(Driver*, int)> func, TaskID &dep,
+                 const std::string &name = "") {
+    graph_built_ = false;
     auto size = task_list_.size();
     TaskID id(size+1);
-    task_list_.push_back(Task(id, dep, func));
+    task_list_.push_back(Task(id, dep, func, DefaultName(name, size)));
     return id;
   }
 
   // INSERT new Task with ID, given dependency, and a pointer to a member function of
   // class T in a position BEFORE the task with ID 'location'.  Returns ID of new task,
   // or taskID(0) if location not found. Usage:
-  //     taskid = tl.InsertTask(&T::DoSomething, T, dependency, location);
+  //     taskid = tl.InsertTask(&T::DoSomething, T, dependency, location, name);
   template <class F, class T>
-  TaskID InsertTask(F func, T *obj, TaskID &dep, TaskID &loc) {
+  TaskID InsertTask(F func, T *obj, TaskID &dep, TaskID &loc,
+                    const std::string &name = "") {
     std::list<Task>::iterator it;
     for (it=task_list_.begin(); it!=task_list_.end(); ++it) {
       if (it->GetID() == loc) {
+        graph_built_ = false;
         auto size = task_list_.size();
         TaskID id(size+1);
         auto old_dep = it->GetDependency();
         task_list_.insert(it, Task(id, dep,
-           [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s); }));
+           [=](Driver *d, int s) mutable -> TaskStatus {return (obj->*func)(d,s); },
+           DefaultName(name, size)));
         // now change dependencies for all but this newly added Task
         for (auto it2=task_list_.begin(); it2!=task_list_.end(); ++it2) {
           if (it2->GetID() != id) {
@@ -223,6 +323,51 @@ class TaskList {
  protected:
   std::list<Task> task_list_;
   TaskID tasks_completed_;
+  bool timed_ = false;       // flag to enable timing of tasks
+  bool task_timers_ = false; // flag to enable per-task timers and profiling regions
+  double busy_time_ = 0.0;   // accumulated time spent in completed tasks
+  Kokkos::Timer timer_;
+
+  // data for dependency-counting scheduler. Tasks are indexed by position in list.
+  bool graph_built_ = false;
+  std::vector<Task*> tasks_;                    // ptrs to tasks in order of list
+  std::vector<int> ndep_;                       // number of dependencies of each task
+  std::vector<int> npending_;                   // number of dependencies not yet done
+  std::vector<std::vector<int>> dependents_;    // tasks that depend on each task
+  std::priority_queue<int, std::vector<int>, std::greater<int>> ready_;
+  std::vector<int> retry_;
+  int ncomplete_ = 0;
+
+  // name of task if none is given: position in list when added
+  static std::string DefaultName(const std::string &name, std::size_t size) {
+    if (!name.empty()) {return name;}
+    return "Task" + std::to_string(size+1);
+  }
+
+  // build dependency graph from TaskID bit fields. Dependencies on tasks that are not in
+  // this list can never be satisfied, so are counted as one extra pending dependency.
+  void BuildGraph() {
+    int ntask = task_list_.size();
+    tasks_.clear();
+    for (auto &it : task_list_) {tasks_.push_back(&it);}
+    ndep_.assign(ntask, 0);
+    npending_.assign(ntask, 0);
+    dependents_.assign(ntask, std::vector<int>());
+    for (int i=0; i<ntask; ++i) {
+      TaskID dep = tasks_[i]->GetDependency();
+      TaskID found(0);
+      for (int j=0; j<ntask; ++j) {
+        TaskID jid = tasks_[j]->GetID();
+        if (j != i && (dep & jid) == jid) {
+          ndep_[i]++;
+          dependents_[j].push_back(i);
+          found = (found | jid);
+        }
+      }
+      if (found != dep) {ndep_[i]++;}
+    }
+    graph_built_ = true;
+  }
 };
 
 #endif  // TASKLIST_TASK_LIST_HPP_
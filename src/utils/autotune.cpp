@@ -0,0 +1,197 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file autotune.cpp
+//! \brief implements tuning mode, enabled with <job>/autotune=true.  Instead of running
+//! the problem, a short benchmark of the problem is run with candidate MeshBlock sizes,
+//! team sizes of par_for_outer kernels, and scratch levels of flux kernels, and the
+//! fastest configuration is printed as an input file snippet.
+//!
+//! Parameters are tuned one at a time: first the MeshBlock size (with default team size
+//! and scratch level), then the team size, then the scratch level.  Each candidate is
+//! run for <job>/autotune_ncycle cycles (default 10) after two warm-up cycles, with all
+//! outputs disabled.  Team sizes and scratch level 1 are only tried on devices.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "driver/driver.hpp"
+#include "pgen/pgen.hpp"
+#include "utils/utils.hpp"
+
+namespace {
+struct TuneCandidate {
+  int nx1, nx2, nx3, team_size, scratch_level;
+  double zcps;   // zone-cycles per second (or < 0 if not run)
+};
+
+//----------------------------------------------------------------------------------------
+//! \fn double RunCandidate()
+//! \brief runs problem with parameters read from string pars and overridden by candidate
+//! c, and returns zone-cycles per second of the timed cycles (slowest rank)
+
+double RunCandidate(const std::string &pars, const TuneCandidate &c, const int ncycle) {
+  ParameterInput pin;
+  std::stringstream ss(pars);
+  pin.LoadFromStream(ss);
+  pin.SetInteger("meshblock", "nx1", c.nx1);
+  pin.SetInteger("meshblock", "nx2", c.nx2);
+  pin.SetInteger("meshblock", "nx3", c.nx3);
+  // disable all outputs (only outputs with dt>0 or dcycle>0 are created)
+  for (auto &blk : pin.block) {
+    if (blk.block_name.compare(0, 6, "output") == 0) {
+      if (pin.DoesParameterExist(blk.block_name, "dcycle")) {
+        pin.SetInteger(blk.block_name, "dcycle", 0);
+      }
+      pin.SetReal(blk.block_name, "dt", 0.0);
+    }
+  }
+  global_variable::team_size = c.team_size;
+  global_variable::scratch_level = c.scratch_level;
+
+  Mesh *pmesh = new Mesh(&pin);
+  pmesh->BuildTreeFromScratch(&pin);
+  pmesh->AddCoordinatesAndPhysics(&pin);
+  pmesh->pgen = std::make_unique<ProblemGenerator>(&pin, pmesh);
+  Kokkos::Timer wall_clock;
+  Driver *pdriver = new Driver(&pin, pmesh, 0.0, &wall_clock);
+  Outputs *pout = new Outputs(&pin, pmesh);
+  pdriver->Initialize(pmesh, &pin, pout, false);
+
+  // warm-up cycles, then timed cycles
+  pdriver->nlim = pmesh->ncycle + 2;
+  pdriver->Execute(pmesh, &pin, pout);
+  int ncycle0 = pmesh->ncycle;
+  pdriver->nlim = ncycle0 + ncycle;
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  pdriver->Execute(pmesh, &pin, pout);
+  Kokkos::fence();
+  double time = timer.seconds();
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  double zones = static_cast<double>(pmesh->ncycle - ncycle0)*
+                 static_cast<double>(pmesh->nmb_total)*
+                 static_cast<double>(pmesh->NumberOfMeshBlockCells());
+
+  delete pout;
+  delete pdriver;
+  delete pmesh;
+  return (time > 0.0)? zones/time : 0.0;
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void Autotune()
+//! \brief runs tuning mode using parameters in pin, and prints best configuration
+
+void Autotune(ParameterInput *pin) {
+  int ncycle = pin->GetOrAddInteger("job", "autotune_ncycle", 10);
+  int mesh_nx[3] = {pin->GetInteger("mesh", "nx1"), pin->GetInteger("mesh", "nx2"),
+                    pin->GetInteger("mesh", "nx3")};
+  int nghost = pin->GetOrAddInteger("mesh", "nghost", 2);
+  TuneCandidate best = {pin->GetOrAddInteger("meshblock", "nx1", mesh_nx[0]),
+                        pin->GetOrAddInteger("meshblock", "nx2", mesh_nx[1]),
+                        pin->GetOrAddInteger("meshblock", "nx3", mesh_nx[2]),
+                        global_variable::team_size, global_variable::scratch_level, -1.0};
+  std::stringstream dump;
+  pin->ParameterDump(dump);
+  std::string pars = dump.str();
+
+  // candidate MeshBlock sizes: cubes (squares in 2D) that evenly divide the Mesh, with
+  // at least one MeshBlock per rank.  Current size is always a candidate.
+  std::vector<TuneCandidate> sizes = {best};
+  for (int n : {8, 16, 24, 32, 48, 64, 96, 128, 192, 256}) {
+    TuneCandidate c = best;
+    int *cnx[3] = {&c.nx1, &c.nx2, &c.nx3};
+    int nmb = 1;
+    bool valid = true;
+    for (int d=0; d<3; ++d) {
+      if (mesh_nx[d] > 1) {
+        if ((mesh_nx[d] % n != 0) || (n < 2*nghost)) {valid = false;}
+        *cnx[d] = n;
+        nmb *= mesh_nx[d]/n;
+      }
+    }
+    bool is_best = (c.nx1 == best.nx1 && c.nx2 == best.nx2 && c.nx3 == best.nx3);
+    if (valid && !is_best && nmb >= global_variable::nranks) {sizes.push_back(c);}
+  }
+  std::vector<int> team_sizes = {0}, scratch_levels = {0};
+  if (!(std::is_same<DevExeSpace, Kokkos::DefaultHostExecutionSpace>::value)) {
+    team_sizes = {0, 64, 128, 256};
+    scratch_levels = {0, 1};
+  }
+
+  // tune one parameter at a time, keeping best value of those already tuned
+  std::vector<TuneCandidate> results;
+  auto run = [&](TuneCandidate c) {
+    if (global_variable::my_rank == 0) {
+      std::cout << std::endl << "Autotune: meshblock " << c.nx1 << "x" << c.nx2 << "x"
+                << c.nx3 << ", team_size=" << c.team_size << ", scratch_level="
+                << c.scratch_level << std::endl;
+    }
+    c.zcps = RunCandidate(pars, c, ncycle);
+    results.push_back(c);
+    if (c.zcps > best.zcps) {best = c;}
+  };
+  for (auto &c : sizes) {run(c);}
+  TuneCandidate base = best;
+  for (int t : team_sizes) {
+    if (t != base.team_size) {
+      TuneCandidate c = base;
+      c.team_size = t;
+      run(c);
+    }
+  }
+  base = best;
+  for (int s : scratch_levels) {
+    if (s != base.scratch_level) {
+      TuneCandidate c = base;
+      c.scratch_level = s;
+      run(c);
+    }
+  }
+
+  if (global_variable::my_rank == 0) {
+    std::cout << std::endl << "Autotune results (" << ncycle << " cycles each, "
+              << global_variable::nranks << " ranks):" << std::endl
+              << std::setw(16) << "meshblock" << std::setw(11) << "team_size"
+              << std::setw(15) << "scratch_level" << std::setw(16) << "zone-cycles/s"
+              << std::endl;
+    for (auto &r : results) {
+      std::string mb = std::to_string(r.nx1) + "x" + std::to_string(r.nx2) + "x" +
+                       std::to_string(r.nx3);
+      std::cout << std::setw(16) << mb << std::setw(11) << r.team_size << std::setw(15)
+                << r.scratch_level << std::setw(16) << std::scientific
+                << std::setprecision(4) << r.zcps << std::endl;
+    }
+    int nmb = (mesh_nx[0]/best.nx1)*(mesh_nx[1]/best.nx2)*(mesh_nx[2]/best.nx3);
+    std::cout << std::endl << "# Best configuration for this hardware ("
+              << std::scientific << std::setprecision(4) << best.zcps
+              << " zone-cycles/s, " << nmb << " MeshBlocks on " << global_variable::nranks
+              << " ranks)" << std::endl
+              << "<meshblock>" << std::endl
+              << "nx1 = " << best.nx1 << std::endl
+              << "nx2 = " << best.nx2 << std::endl
+              << "nx3 = " << best.nx3 << std::endl << std::endl
+              << "<job>" << std::endl
+              << "team_size     = " << best.team_size << "    # 0 for Kokkos::AUTO"
+              << std::endl
+              << "scratch_level = " << best.scratch_level << std::endl;
+  }
+  return;
+}
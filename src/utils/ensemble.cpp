@@ -0,0 +1,119 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file ensemble.cpp
+//! \brief implements ensemble mode, enabled with <job>/ensemble=true.  Runs nmember
+//! independent copies of the problem in one process, each with its own values of the
+//! parameters listed in the <ensemble> block, and writes the outputs of member n into
+//! directory member_n.  Each parameter in the block is "block/name" with one value per
+//! member, e.g.
+//!   <ensemble>
+//!   nmember       = 3
+//!   problem/amp   = 0.01 0.02 0.05
+//!   problem/vflow = 0.5  0.5  1.0
+//! Each member has its own Mesh, time step and stopping criteria.  Members are run one
+//! after another, so Kokkos and MPI initialization, and device memory allocations (reused
+//! by the memory pool of the device), are shared by all members.
+
+#include <unistd.h>    // chdir
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+#include "driver/driver.hpp"
+#include "pgen/pgen.hpp"
+#include "utils/utils.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn void RunEnsemble()
+//! \brief runs each member of ensemble with parameters in pin, overridden by the values
+//! for that member in the <ensemble> block.  Wall clock limit wtlim (if > 0) applies to
+//! the ensemble as a whole.
+
+void RunEnsemble(ParameterInput *pin, double wtlim, Kokkos::Timer *ptimer) {
+  int nmember = pin->GetInteger("ensemble", "nmember");
+  // values of each overridden parameter for all members
+  std::vector<std::pair<std::string, std::vector<std::string>>> overrides;
+  for (auto &blk : pin->block) {
+    if (blk.block_name.compare("ensemble") != 0) {continue;}
+    for (auto &ln : blk.line) {
+      if (ln.param_name.compare("nmember") == 0) {continue;}
+      std::istringstream is(ln.param_value);
+      std::vector<std::string> vals;
+      std::string v;
+      while (is >> v) {vals.push_back(v);}
+      std::size_t slash = ln.param_name.find('/');
+      if ((slash == std::string::npos) || (static_cast<int>(vals.size()) != nmember)) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<ensemble>/" << ln.param_name << " must be of the "
+                  << "form block/name with nmember=" << nmember << " values" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      overrides.emplace_back(ln.param_name, vals);
+    }
+  }
+  std::stringstream dump;
+  pin->ParameterDump(dump);
+  std::string pars = dump.str();
+
+  for (int n=0; n<nmember; ++n) {
+    ParameterInput mpin;
+    std::stringstream ss(pars);
+    mpin.LoadFromStream(ss);
+    for (auto &o : overrides) {
+      std::size_t slash = o.first.find('/');
+      mpin.SetString(o.first.substr(0, slash), o.first.substr(slash+1), o.second[n]);
+    }
+    if (global_variable::my_rank == 0) {
+      std::cout << std::endl << "Ensemble member " << n << " of " << nmember << ":";
+      for (auto &o : overrides) {std::cout << " " << o.first << "=" << o.second[n];}
+      std::cout << std::endl;
+    }
+
+    std::string dir = "member_" + std::to_string(n);
+    ChangeRunDir(dir);
+    Mesh *pmesh = new Mesh(&mpin);
+    pmesh->BuildTreeFromScratch(&mpin);
+    pmesh->AddCoordinatesAndPhysics(&mpin);
+    pmesh->pgen = std::make_unique<ProblemGenerator>(&mpin, pmesh);
+    Driver *pdriver = new Driver(&mpin, pmesh, wtlim, ptimer);
+    Outputs *pout = new Outputs(&mpin, pmesh);
+    pdriver->Initialize(pmesh, &mpin, pout, false);
+    pdriver->Execute(pmesh, &mpin, pout);
+    pdriver->Finalize(pmesh, &mpin, pout);
+    delete pout;
+    delete pdriver;
+    delete pmesh;
+    if (chdir("..")) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Cannot return from directory '" << dir << "'"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    // stop remaining members once the wall clock limit is reached (time of rank 0)
+    double tnow = ptimer->seconds();
+#if MPI_PARALLEL_ENABLED
+    MPI_Bcast(&tnow, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
+    if ((wtlim > 0.0) && (tnow >= wtlim)) {
+      if (global_variable::my_rank == 0) {
+        std::cout << std::endl << "Wall clock limit reached after " << (n+1) << " of "
+                  << nmember << " ensemble members" << std::endl;
+      }
+      break;
+    }
+  }
+  return;
+}
@@ -0,0 +1,100 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file id_cache.cpp
+//! \brief functions implementing the initial-data cache.  When an <id_cache> block exists
+//! in the input file, the state after the ProblemGenerator is written once as a restart
+//! file "rst/id_cache.XXXXXXXXXXXXXXXX.00000.rst" in the directory from which the code is
+//! launched, where the X's are a hash of all parameters in the <mesh>, <meshblock>,
+//! <mesh_refinement>, <refinementN>, <coord>, and <problem> blocks.  Later runs with the
+//! same values of these parameters find this file and restart from it (with the input
+//! file overriding all other parameters) instead of calling the ProblemGenerator.  This
+//! is useful for parameter scans over e.g. gauge, dissipation or floors with expensive
+//! initial data.
+
+#include <unistd.h>    // getpid()
+#include <cstdint>
+#include <cstdio>      // rename(), snprintf()
+#include <iostream>
+#include <string>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "mesh/mesh.hpp"
+#include "outputs/outputs.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \fn std::string InitialDataCacheName(ParameterInput *pin)
+//! \brief returns basename "id_cache.XXXXXXXXXXXXXXXX" of the initial-data cache file,
+//! using a 64-bit FNV-1a hash of the names and values of the parameters that determine
+//! the initial data.
+
+std::string InitialDataCacheName(ParameterInput *pin) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash](const std::string &s) {
+    for (unsigned char c : s) {
+      hash ^= static_cast<std::uint64_t>(c);
+      hash *= 1099511628211ULL;
+    }
+  };
+  for (auto &blk : pin->block) {
+    const std::string &name = blk.block_name;
+    if (name.compare("mesh") == 0 || name.compare("meshblock") == 0 ||
+        name.compare("coord") == 0 || name.compare("problem") == 0 ||
+        name.compare(0, 15, "mesh_refinement") == 0 ||
+        name.compare(0, 10, "refinement") == 0) {
+      add("<" + name + ">\n");
+      for (auto &ln : blk.line) {
+        add(ln.param_name + "=" + ln.param_value + "\n");
+      }
+    }
+  }
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+  return std::string("id_cache.") + key;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void WriteInitialDataCache()
+//! \brief writes the state after the ProblemGenerator as restart file
+//! rst/<name>.00000.rst.  The file is first written under a temporary name and then
+//! renamed, so that runs started at the same time never read a partial cache file.
+
+void WriteInitialDataCache(ParameterInput *pin, Mesh *pm, const std::string &name) {
+  // temporary name is unique to this run
+  int pid = static_cast<int>(getpid());
+#if MPI_PARALLEL_ENABLED
+  MPI_Bcast(&pid, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+  OutputParameters opar;
+  opar.block_name = "id_cache";
+  opar.file_type = "rst";
+  opar.file_basename = name + ".tmp" + std::to_string(pid);
+  opar.file_number = 0;
+  opar.last_time = -1.0;
+  opar.dt = 0.0;
+  opar.dcycle = 0;
+  {
+    RestartOutput rst(pin, pm, opar);
+    rst.LoadOutputData(pm);
+    rst.WriteOutputFile(pm, pin);
+  }
+  if (global_variable::my_rank == 0) {
+    std::string tmpname = "rst/" + opar.file_basename + ".00000.rst";
+    std::string fname = "rst/" + name + ".00000.rst";
+    if (std::rename(tmpname.c_str(), fname.c_str()) != 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__ << std::endl
+                << "Could not rename initial-data cache file '" << tmpname << "'"
+                << std::endl;
+    } else {
+      std::cout << "Initial data written to cache file '" << fname << "'" << std::endl;
+    }
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Barrier(MPI_COMM_WORLD);
+#endif
+  return;
+}
@@ -0,0 +1,157 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file kernel_profiler.cpp
+//! \brief implements built-in Kokkos Tools connector.  Callbacks for the begin/end of
+//! parallel_for/reduce/scan fence the device, so that the measured time is the execution
+//! time of each kernel.  This serializes kernels, so the profiler should only be enabled
+//! in profiling runs.
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "kernel_profiler.hpp"
+
+namespace kernel_profiler {
+
+bool enabled = false;
+std::uint64_t next_iterations = 0;
+
+namespace {
+struct KernelData {
+  std::string name;
+  std::uint64_t ncall = 0, niter = 0;
+  double time = 0.0;
+};
+std::vector<KernelData> kernels;             // indexed by kernel ID passed to callbacks
+std::map<std::string, std::uint64_t> kid;    // kernel ID for each kernel name
+std::map<std::string, double> bytes_per_iter;
+std::map<std::string, double> region_time;   // kernel time in each region
+std::vector<std::string> regions;            // full paths of stack of active regions
+double peak_bandwidth = 0.0;                 // GB/s, used for % of peak (if > 0)
+Kokkos::Timer timer;
+
+void BeginKernel(const char *name, const std::uint32_t, std::uint64_t *kernid) {
+  Kokkos::fence();
+  auto it = kid.find(name);
+  if (it == kid.end()) {
+    it = kid.emplace(name, kernels.size()).first;
+    kernels.emplace_back();
+    kernels.back().name = name;
+  }
+  *kernid = it->second;
+  kernels[it->second].ncall++;
+  kernels[it->second].niter += next_iterations;
+  next_iterations = 0;
+  timer.reset();
+}
+
+void EndKernel(const std::uint64_t kernid) {
+  Kokkos::fence();
+  double dt = timer.seconds();
+  kernels[kernid].time += dt;
+  region_time[regions.empty()? std::string("(none)") : regions.back()] += dt;
+}
+
+void PushRegion(const char *name) {
+  regions.emplace_back(regions.empty()? std::string(name) : regions.back() + "/" + name);
+}
+void PopRegion() {if (!(regions.empty())) {regions.pop_back();}}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn void SetBytesPerIteration()
+//! \brief stores estimated bytes moved per iteration of kernel with given name
+
+void SetBytesPerIteration(const std::string &name, double nbytes) {
+  bytes_per_iter[name] = nbytes;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Enable()
+//! \brief registers Kokkos Tools callbacks.  Argument is peak memory bandwidth in GB/s of
+//! the device, used to compute fraction of peak achieved by each kernel (if > 0).
+
+void Enable(double peak_bw) {
+  namespace kt = Kokkos::Tools::Experimental;
+  enabled = true;
+  peak_bandwidth = peak_bw;
+  kt::set_begin_parallel_for_callback(BeginKernel);
+  kt::set_end_parallel_for_callback(EndKernel);
+  kt::set_begin_parallel_reduce_callback(BeginKernel);
+  kt::set_end_parallel_reduce_callback(EndKernel);
+  kt::set_begin_parallel_scan_callback(BeginKernel);
+  kt::set_end_parallel_scan_callback(EndKernel);
+  kt::set_push_region_callback(PushRegion);
+  kt::set_pop_region_callback(PopRegion);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Report()
+//! \brief prints roofline-style summary of kernels on rank 0, sorted by time: launches,
+//! time, iterations, time per iteration, and (for kernels with registered bytes per
+//! iteration) estimated bytes moved and achieved bandwidth.  Then kernel time in each
+//! region, where nested regions (e.g. tasks within TaskLists) are separated by "/".
+
+void Report() {
+  if (!enabled || global_variable::my_rank != 0) {return;}
+  std::vector<const KernelData*> sorted;
+  double ttot = 0.0;
+  for (auto &k : kernels) {
+    sorted.push_back(&k);
+    ttot += k.time;
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const KernelData *a, const KernelData *b) {return a->time > b->time;});
+
+  std::cout << std::endl << "Kernel profile on rank 0, total kernel time="
+            << std::scientific << std::setprecision(3) << ttot << " s" << std::endl
+            << std::left << std::setw(28) << "kernel" << std::right << std::setw(9)
+            << "calls" << std::setw(11) << "time" << std::setw(7) << "%"
+            << std::setw(11) << "iters" << std::setw(11) << "ns/iter" << std::setw(11)
+            << "GB" << std::setw(11) << "GB/s" << std::setw(7) << "%peak" << std::endl;
+  for (auto k : sorted) {
+    std::cout << std::left << std::setw(28) << k->name.substr(0, 27) << std::right
+              << std::setw(9) << k->ncall << std::scientific << std::setprecision(3)
+              << std::setw(11) << k->time << std::fixed << std::setprecision(1)
+              << std::setw(7) << 100.0*k->time/std::max(ttot, 1.0e-30);
+    if (k->niter > 0) {
+      std::cout << std::scientific << std::setprecision(3) << std::setw(11)
+                << static_cast<double>(k->niter) << std::setw(11)
+                << 1.0e9*k->time/static_cast<double>(k->niter);
+    } else {
+      std::cout << std::setw(11) << "-" << std::setw(11) << "-";
+    }
+    auto it = bytes_per_iter.find(k->name);
+    if (k->niter > 0 && it != bytes_per_iter.end() && k->time > 0.0) {
+      double gb = 1.0e-9*it->second*static_cast<double>(k->niter);
+      std::cout << std::setw(11) << gb << std::setw(11) << gb/k->time;
+      if (peak_bandwidth > 0.0) {
+        std::cout << std::fixed << std::setprecision(1) << std::setw(7)
+                  << 100.0*gb/k->time/peak_bandwidth;
+      }
+    }
+    std::cout << std::endl;
+  }
+
+  std::cout << std::endl << std::left << std::setw(50) << "region" << std::right
+            << std::setw(11) << "time" << std::setw(7) << "%" << std::endl;
+  for (auto &r : region_time) {
+    std::cout << std::left << std::setw(50) << r.first.substr(0, 49) << std::right
+              << std::scientific << std::setprecision(3) << std::setw(11) << r.second
+              << std::fixed << std::setprecision(1) << std::setw(7)
+              << 100.0*r.second/std::max(ttot, 1.0e-30) << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+} // namespace kernel_profiler
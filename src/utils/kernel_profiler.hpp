@@ -0,0 +1,40 @@
+#ifndef UTILS_KERNEL_PROFILER_HPP_
+#define UTILS_KERNEL_PROFILER_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file kernel_profiler.hpp
+//! \brief Built-in Kokkos Tools connector that records the time, number of launches and
+//! iterations of every kernel, and the kernel time spent in each profiling region (task).
+//! Enabled with <job>/kernel_profiler=true.  Summary printed at end of run with
+//! estimated memory bandwidth of kernels for which bytes per iteration are registered.
+//!
+//! Since only one set of Kokkos Tools callbacks can be active, the profiler cannot be
+//! used together with an external tool loaded through KOKKOS_TOOLS_LIBS.
+
+#include <cstdint>
+#include <string>
+
+namespace kernel_profiler {
+
+extern bool enabled;
+extern std::uint64_t next_iterations;
+
+// called by par_for wrappers with the number of iterations of the next kernel launched
+inline void SetIterations(const int n) {
+  if (enabled && n > 0) {next_iterations = n;}
+}
+
+// Registers compulsory memory traffic (bytes per iteration) of a kernel, estimated from
+// the extents of the arrays it reads and writes.  Cache reuse of stencil neighbors is
+// assumed to be perfect, so achieved bandwidth is a lower bound.
+void SetBytesPerIteration(const std::string &name, double nbytes);
+
+void Enable(double peak_bw);
+void Report();
+
+} // namespace kernel_profiler
+
+#endif // UTILS_KERNEL_PROFILER_HPP_
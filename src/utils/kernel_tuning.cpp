@@ -0,0 +1,78 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file kernel_tuning.cpp
+//! \brief reads per-kernel overrides of execution policies from <kernel_tuning> block
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "parameter_input.hpp"
+#include "kernel_tuning.hpp"
+
+namespace kernel_tuning {
+
+bool enabled = false;
+
+namespace {
+std::unordered_map<std::string, KernelConfig> configs;
+const KernelConfig *default_config = nullptr;
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn const KernelConfig *Find()
+//! \brief returns overrides of kernel with given name, or default overrides if kernel has
+//! no entry in <kernel_tuning> (nullptr if neither exist)
+
+const KernelConfig *Find(const std::string &name) {
+  if (!enabled) {return nullptr;}
+  auto it = configs.find(name);
+  return (it != configs.end())? &(it->second) : default_config;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Initialize()
+//! \brief parses <kernel_tuning> block of input file
+
+void Initialize(ParameterInput *pin) {
+  if (!(pin->DoesBlockExist("kernel_tuning"))) {return;}
+  for (auto &blk : pin->block) {
+    if (blk.block_name.compare("kernel_tuning") != 0) {continue;}
+    for (auto &ln : blk.line) {
+      std::istringstream is(ln.param_value);
+      std::string kind;
+      is >> kind;
+      KernelConfig &kc = configs[ln.param_name];
+      bool ok = false;
+      if (kind.compare("tile") == 0) {
+        ok = static_cast<bool>(is >> kc.tile[0] >> kc.tile[1] >> kc.tile[2]) &&
+             (kc.tile[0] > 0) && (kc.tile[1] > 0) && (kc.tile[2] > 0);
+      } else if (kind.compare("team") == 0) {
+        ok = static_cast<bool>(is >> kc.team_size) && (kc.team_size > 0);
+      }
+      if (!ok) {
+        std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                  << std::endl << "<kernel_tuning>/" << ln.param_name << " = '"
+                  << ln.param_value << "' must be 'tile tk tj ti' or 'team n' with "
+                  << "positive integers" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+    }
+  }
+  auto it = configs.find("default");
+  if (it != configs.end()) {default_config = &(it->second);}
+  enabled = !(configs.empty());
+  if (enabled && global_variable::my_rank == 0) {
+    std::cout << "Kernel tuning overrides read for " << configs.size() << " kernel(s)"
+              << std::endl;
+  }
+}
+
+} // namespace kernel_tuning
@@ -0,0 +1,43 @@
+#ifndef UTILS_KERNEL_TUNING_HPP_
+#define UTILS_KERNEL_TUNING_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file kernel_tuning.hpp
+//! \brief Per-kernel overrides of the execution policy used by the par_for and
+//! par_for_outer wrappers in athena.hpp, read from the <kernel_tuning> block of the input
+//! file.  Each parameter is the name of a kernel (or "default", applied to all kernels
+//! without their own entry), with value either
+//!   tile tk tj ti   3D/4D/5D par_for uses a MDRangePolicy over (k,j,i) with this tile
+//!   team n          par_for_outer uses team size n instead of <job>/team_size
+//! e.g.
+//!   <kernel_tuning>
+//!   default   = tile 1 4 64
+//!   h_update  = tile 2 8 32
+//!   mhd_flux1 = team 128
+//! Hot kernels can then be tuned per platform without code changes.  Without a
+//! <kernel_tuning> block all kernels use the default 1D RangePolicy / AUTO team size.
+
+#include <string>
+
+class ParameterInput;
+
+namespace kernel_tuning {
+
+struct KernelConfig {
+  int tile[3] = {0, 0, 0};  // tile sizes in (k,j,i), or 0 if not tiled
+  int team_size = 0;        // team size of outer loops, or 0 if not set
+  bool Tiled() const {return (tile[0] > 0);}
+};
+
+extern bool enabled;
+
+// returns overrides for kernel with given name, or nullptr if there are none
+const KernelConfig *Find(const std::string &name);
+void Initialize(ParameterInput *pin);
+
+} // namespace kernel_tuning
+
+#endif // UTILS_KERNEL_TUNING_HPP_
@@ -8,6 +8,11 @@
 #include <cmath>
 #include <iostream>
 #include <list>
+#include <vector>
+
+#if MPI_PARALLEL_ENABLED
+#include <mpi.h>
+#endif
 
 #include "lagrange_interpolator.hpp"
 #include "athena.hpp"
@@ -39,6 +44,166 @@ LagrangeInterpolator::LagrangeInterpolator(
   CalculateWeight();
 }
 
+LagrangeInterpolator::LagrangeInterpolator(MeshBlockPack *pmy_pack):
+              pmy_pack(pmy_pack),
+              rcoord("rccord", 1), interp_indcs("interp_indcs", 1),
+              interp_wghts("interp_wghts", 1, 1), point_exist(false),
+              vals("lagr_vals", 1, 1), nfound("lagr_nfound", 1),
+              batch_indcs("batch_indcs", 1, 1), batch_wghts("batch_wghts", 1, 1, 1),
+              batch_vals("batch_vals", 1, 1) {
+  int &ng = pmy_pack->pmesh->mb_indcs.ng;
+  Kokkos::realloc(rcoord, 3);
+  Kokkos::realloc(interp_wghts, 2 * ng, 3);
+  Kokkos::realloc(interp_indcs, 4);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LagrangeInterpolator::SetPoints
+//! \brief set points of batched interpolation, computing the stencil of each point on
+//! the host (with the same functions as for a single point) and copying them to device
+
+void LagrangeInterpolator::SetPoints(int npts, const Real *rcoords) {
+  int &ng = pmy_pack->pmesh->mb_indcs.ng;
+  if (npts != npoints) {
+    npoints = npts;
+    Kokkos::realloc(batch_indcs, npoints, 4);
+    Kokkos::realloc(batch_wghts, npoints, 2 * ng, 3);
+    Kokkos::realloc(nfound, npoints);
+  }
+  for (int p = 0; p < npoints; ++p) {
+    for (int i = 0; i < 3; ++i) {
+      rcoord(i) = rcoords[3 * p + i];
+    }
+    SetInterpolationIndices();
+    CalculateWeight();
+    for (int i = 0; i < 4; ++i) {
+      batch_indcs.h_view(p, i) = interp_indcs(i);
+    }
+    for (int i = 0; i < 2 * ng; ++i) {
+      for (int d = 0; d < 3; ++d) {
+        batch_wghts.h_view(p, i, d) = interp_wghts(i, d);
+      }
+    }
+  }
+  batch_indcs.template modify<HostMemSpace>();
+  batch_indcs.template sync<DevExeSpace>();
+  batch_wghts.template modify<HostMemSpace>();
+  batch_wghts.template sync<DevExeSpace>();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LagrangeInterpolator::ClearVariables
+//! \brief remove all variables of batched interpolation
+
+void LagrangeInterpolator::ClearVariables() {
+  narrays = 0;
+  nvars_batch = 0;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn int LagrangeInterpolator::AddVariable
+//! \brief add variable n of array val to batched interpolation, returns index of the
+//! variable in vals
+
+int LagrangeInterpolator::AddVariable(DvceArray5D<Real> &val, int n) {
+  int a = 0;
+  while (a < narrays && batch_arrays[a].data() != val.data()) {a++;}
+  if (a == narrays) {
+    if (narrays == kMaxArrays) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Too many arrays in batched Lagrange interpolation"
+                << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    batch_arrays[narrays++] = val;
+  }
+  if (nvars_batch == kMaxVars) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Too many variables in batched Lagrange interpolation"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  var_array[nvars_batch] = a;
+  var_index[nvars_batch] = n;
+  return nvars_batch++;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void LagrangeInterpolator::InterpolateAll
+//! \brief interpolate all variables to all points, with one team per (point, variable)
+//! summing over the stencil, and then sum over ranks with one reduction
+
+void LagrangeInterpolator::InterpolateAll() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  int is = indcs.is, js = indcs.js, ks = indcs.ks;
+  int ng = indcs.ng;
+  const int nst = 2 * ng;
+  const int nst3 = nst * nst * nst;
+  int nvar = nvars_batch;
+  if (npoints == 0 || nvar == 0) {return;}
+  if (batch_vals.extent_int(0) != npoints || batch_vals.extent_int(1) != nvar) {
+    Kokkos::realloc(batch_vals, npoints, nvar);
+    Kokkos::realloc(vals, npoints, nvar);
+  }
+
+  // capture arrays and variable lists by value
+  DvceArray5D<Real> a0 = batch_arrays[0], a1 = batch_arrays[1];
+  DvceArray5D<Real> a2 = batch_arrays[2], a3 = batch_arrays[3];
+  int varr[kMaxVars], vidx[kMaxVars];
+  for (int v = 0; v < nvar; ++v) {
+    varr[v] = var_array[v];
+    vidx[v] = var_index[v];
+  }
+  auto &bindcs = batch_indcs;
+  auto &bwghts = batch_wghts;
+  auto &bvals = batch_vals;
+  par_for_outer("lagr_interp", DevExeSpace(), 0, 0, 0, (npoints - 1), 0, (nvar - 1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int p, const int v) {
+    int ii0 = bindcs.d_view(p, 0);
+    int ii1 = bindcs.d_view(p, 1);
+    int ii2 = bindcs.d_view(p, 2);
+    int ii3 = bindcs.d_view(p, 3);
+    Real int_value = 0.0;
+    if (ii0 != -1) {  // point on this rank
+      int n = vidx[v];
+      auto val = (varr[v] == 0) ? a0 : ((varr[v] == 1) ? a1 : ((varr[v] == 2) ? a2 : a3));
+      Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nst3),
+      [=](const int idx, Real &sum) {
+        int k = idx / (nst * nst);
+        int j = (idx - k * nst * nst) / nst;
+        int i = idx - k * nst * nst - j * nst;
+        Real iwght = bwghts.d_view(p, i, 0) * bwghts.d_view(p, j, 1) *
+                     bwghts.d_view(p, k, 2);
+        sum += iwght * val(ii0, n, ii3 - (ng - k - ks) + 1, ii2 - (ng - j - js) + 1,
+                           ii1 - (ng - i - is) + 1);
+      }, int_value);
+    }
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {bvals.d_view(p, v) = int_value;});
+  });
+  batch_vals.template modify<DevExeSpace>();
+  batch_vals.template sync<HostMemSpace>();
+
+  // sum values and number of ranks on which each point was found over ranks
+  std::vector<Real> buf(npoints * (nvar + 1));
+  for (int p = 0; p < npoints; ++p) {
+    for (int v = 0; v < nvar; ++v) {
+      buf[p * (nvar + 1) + v] = batch_vals.h_view(p, v);
+    }
+    buf[p * (nvar + 1) + nvar] = (batch_indcs.h_view(p, 0) == -1) ? 0.0 : 1.0;
+  }
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, buf.data(), npoints * (nvar + 1), MPI_ATHENA_REAL,
+                MPI_SUM, MPI_COMM_WORLD);
+#endif
+  for (int p = 0; p < npoints; ++p) {
+    Real nf = buf[p * (nvar + 1) + nvar];
+    nfound(p) = static_cast<int>(nf + 0.5);
+    for (int v = 0; v < nvar; ++v) {
+      vals(p, v) = (nf > 0.5) ? buf[p * (nvar + 1) + v] / nf : 0.0;
+    }
+  }
+}
+
 Real LagrangeInterpolator::Interpolate(DvceArray5D<Real> &val, int nvars) {
   Real ivals    = 0.;
   int &ng       = pmy_pack->pmesh->mb_indcs.ng;
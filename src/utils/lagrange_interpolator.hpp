@@ -19,6 +19,8 @@
 class LagrangeInterpolator {
  public:
   LagrangeInterpolator(MeshBlockPack *pmy_pack, Real rcoords[3]);
+  // constructor for batched interpolation with SetPoints/AddVariable/InterpolateAll
+  explicit LagrangeInterpolator(MeshBlockPack *pmy_pack);
   ~LagrangeInterpolator() = default;
 
   void SetInterpolationIndices();
@@ -29,7 +31,29 @@ class LagrangeInterpolator {
   Real ResetPointAndInterpolate(
     DvceArray5D<Real> &val, int nvars, Real rcoords2[3]);
   bool point_exist; // point exist on this rank (meshblock pack)
+
+  // Batched interpolation of many variables to many points in one kernel, followed by
+  // one reduction over ranks.  After InterpolateAll(), vals(p,v) is variable v at point
+  // p on all ranks, and nfound(p) is the number of ranks on which point p was found.
+  void SetPoints(int npts, const Real *rcoords);  // rcoords[3*p+i]
+  void ClearVariables();
+  int AddVariable(DvceArray5D<Real> &val, int n);
+  void InterpolateAll();
+  int npoints = 0;
+  int nvars_batch = 0;
+  HostArray2D<Real> vals;
+  HostArray1D<int> nfound;
+
  private:
+  static constexpr int kMaxArrays = 4;   // max number of distinct arrays in a batch
+  static constexpr int kMaxVars = 16;    // max number of variables in a batch
+  int narrays = 0;
+  DvceArray5D<Real> batch_arrays[kMaxArrays];
+  int var_array[kMaxVars], var_index[kMaxVars];  // array and index of each variable
+  DualArray2D<int> batch_indcs;   // indices of MeshBlock and zones for each point
+  DualArray3D<Real> batch_wghts;  // weights for each point
+  DualArray2D<Real> batch_vals;   // values interpolated on this rank
+
   HostArray1D<Real> rcoord; // xyz coordinate for interpolated value
 
   int nvars;               // index of the variable for interpolation
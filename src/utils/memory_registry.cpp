@@ -0,0 +1,148 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file memory_registry.cpp
+//! \brief implements registry of device memory allocations using Kokkos Tools callbacks.
+//! Allocations made before the registry is enabled are not included.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "memory_registry.hpp"
+
+namespace memory_registry {
+
+bool enabled = false;
+
+namespace {
+struct ModuleData {
+  std::uint64_t bytes = 0, hwm = 0;            // current and high-water-mark bytes
+  int narrays = 0;                             // number of live allocations
+  std::map<std::string, std::uint64_t> label;  // current bytes of each View label
+};
+struct Allocation {
+  std::string module, label;
+  std::uint64_t size;
+};
+std::map<std::string, ModuleData> modules;
+std::unordered_map<const void*, Allocation> live;
+std::vector<std::string> scopes;               // full names of stack of active scopes
+std::uint64_t total_bytes = 0, total_hwm = 0;
+
+void Allocate(const Kokkos::Profiling::SpaceHandle handle, const char *label,
+              const void *ptr, const std::uint64_t size) {
+  if (std::strcmp(handle.name, DevMemSpace::name()) != 0) {return;}
+  std::string mod = scopes.empty()? std::string("(untagged)") : scopes.back();
+  auto &md = modules[mod];
+  md.bytes += size;
+  md.hwm = std::max(md.hwm, md.bytes);
+  md.narrays++;
+  md.label[label] += size;
+  total_bytes += size;
+  total_hwm = std::max(total_hwm, total_bytes);
+  live[ptr] = {mod, label, size};
+}
+
+void Deallocate(const Kokkos::Profiling::SpaceHandle handle, const char *,
+                const void *ptr, const std::uint64_t) {
+  if (std::strcmp(handle.name, DevMemSpace::name()) != 0) {return;}
+  auto it = live.find(ptr);
+  if (it == live.end()) {return;}
+  auto &md = modules[it->second.module];
+  md.bytes -= it->second.size;
+  md.narrays--;
+  auto il = md.label.find(it->second.label);
+  il->second -= it->second.size;
+  if (il->second == 0) {md.label.erase(il);}
+  total_bytes -= it->second.size;
+  live.erase(it);
+}
+} // namespace
+
+//----------------------------------------------------------------------------------------
+//! \fn Scope::Scope()
+//! \brief pushes module name onto stack of scopes, nested inside any enclosing scope
+
+Scope::Scope(const char *module) {
+  if (!enabled) {return;}
+  scopes.emplace_back(scopes.empty()? std::string(module) : scopes.back() + "/" + module);
+}
+
+Scope::~Scope() {
+  if (enabled && !(scopes.empty())) {scopes.pop_back();}
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Enable()
+//! \brief registers Kokkos Tools allocate/deallocate callbacks.  Must be called before
+//! the Mesh is constructed so that all allocations are recorded.
+
+void Enable() {
+  enabled = true;
+  Kokkos::Tools::Experimental::set_allocate_data_callback(Allocate);
+  Kokkos::Tools::Experimental::set_deallocate_data_callback(Deallocate);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Report()
+//! \brief prints current and high-water-mark device memory of each module on rank 0,
+//! bytes per MeshBlock (given the number nmb of MeshBlocks on the rank), and the largest
+//! array of each module.  If the memory of the device (in GB) is given, also prints the
+//! maximum number of MeshBlocks per device implied by the current bytes per MeshBlock.
+
+void Report(const std::string &when, const int nmb, const double device_mem_gb) {
+  if (!enabled || global_variable::my_rank != 0) {return;}
+  std::vector<std::pair<std::string, const ModuleData*>> sorted;
+  for (auto &m : modules) {sorted.emplace_back(m.first, &(m.second));}
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    return a.second->bytes > b.second->bytes;
+  });
+
+  double mb = 1.0/(1024.0*1024.0);
+  double per_mb = 1.0/static_cast<double>(std::max(nmb, 1));
+  std::cout << std::endl << "Device memory on rank 0 " << when << " (" << nmb
+            << " MeshBlocks), in MiB" << std::endl << std::left << std::setw(28)
+            << "module" << std::right << std::setw(8) << "arrays" << std::setw(11)
+            << "current" << std::setw(11) << "hwm" << std::setw(11) << "per MB"
+            << "  largest array" << std::endl;
+  for (auto &m : sorted) {
+    const ModuleData &md = *(m.second);
+    if (md.hwm == 0) {continue;}
+    std::string largest;
+    std::uint64_t nlargest = 0;
+    for (auto &l : md.label) {
+      if (l.second > nlargest) {
+        largest = l.first;
+        nlargest = l.second;
+      }
+    }
+    std::cout << std::left << std::setw(28) << m.first.substr(0, 27) << std::right
+              << std::setw(8) << md.narrays << std::fixed << std::setprecision(2)
+              << std::setw(11) << md.bytes*mb << std::setw(11) << md.hwm*mb
+              << std::setw(11) << md.bytes*mb*per_mb << "  " << largest << std::endl;
+  }
+  std::cout << std::left << std::setw(28) << "total" << std::right << std::setw(8)
+            << live.size() << std::setw(11) << total_bytes*mb << std::setw(11)
+            << total_hwm*mb << std::setw(11) << total_bytes*mb*per_mb << std::endl;
+  if (device_mem_gb > 0.0 && total_bytes > 0) {
+    double bytes_per_mb = static_cast<double>(total_bytes)*per_mb;
+    std::cout << "Estimated maximum MeshBlocks per device = "
+              << static_cast<std::int64_t>(1.0e9*device_mem_gb/bytes_per_mb)
+              << std::endl;
+  }
+  std::cout << std::endl;
+}
+
+} // namespace memory_registry
@@ -0,0 +1,39 @@
+#ifndef UTILS_MEMORY_REGISTRY_HPP_
+#define UTILS_MEMORY_REGISTRY_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file memory_registry.hpp
+//! \brief Registry of device memory allocations, enabled with <job>/memory_registry=true.
+//! Every allocation in the memory space of the default execution space is recorded
+//! through the Kokkos Tools allocate/deallocate callbacks, and tagged with the module
+//! (set by the innermost memory_registry::Scope) and the label of the View (its purpose).
+//! Nested scopes are joined with "/", e.g. "hydro/bvals".  Totals per module, and bytes
+//! per MeshBlock, are printed at startup and after each regrid.
+
+#include <string>
+
+namespace memory_registry {
+
+extern bool enabled;
+
+//----------------------------------------------------------------------------------------
+//! \class Scope
+//! \brief tags all allocations made during its lifetime with the given module name
+
+class Scope {
+ public:
+  explicit Scope(const char *module);
+  ~Scope();
+  Scope(const Scope&) = delete;
+  Scope &operator=(const Scope&) = delete;
+};
+
+void Enable();
+void Report(const std::string &when, const int nmb, const double device_mem_gb);
+
+} // namespace memory_registry
+
+#endif // UTILS_MEMORY_REGISTRY_HPP_
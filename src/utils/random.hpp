@@ -8,6 +8,8 @@
 //! \file random.cpp
 //  \brief Random number generators (that can be included in Kokkos parallel for regions)
 
+#include <math.h>
+
 #include "athena.hpp"
 
 //----------------------------------------------------------------------------------------
@@ -189,4 +191,65 @@ static Real RanGaussian(int64_t *idum) {
   }
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn RanHash
+//! \brief Stateless counter-based generator: returns a uniform deviate in (0,1) that is
+//! a hash (splitmix64 finalizer) of the 64-bit key.  Since no state is shared, it can be
+//! called from any number of device threads without contention, and the same key always
+//! gives the same deviate (e.g. key built from particle tag and cycle number).
+
+KOKKOS_INLINE_FUNCTION
+static Real RanHash(uint64_t key) {
+  uint64_t z = key + 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+  z = z ^ (z >> 31);
+  // top 53 bits, offset by half a unit so result is never exactly 0 or 1
+  return static_cast<Real>((static_cast<double>(z >> 11) + 0.5)*(1.0/9007199254740992.0));
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn Philox4x32
+//! \brief Philox-4x32-10 counter-based generator of Salmon et al. (2011), "Parallel
+//! random numbers: as easy as 1, 2, 3".  Replaces the 128-bit counter ctr by its hash
+//! under the 64-bit key (k0,k1).  Each (counter, key) gives the same four random words
+//! on any device and in any thread, so streams can be indexed by e.g. (mode, cycle).
+
+KOKKOS_INLINE_FUNCTION
+static void Philox4x32(uint32_t ctr[4], uint32_t k0, uint32_t k1) {
+  for (int r=0; r<10; ++r) {
+    uint64_t p0 = static_cast<uint64_t>(0xD2511F53U)*ctr[0];
+    uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57U)*ctr[2];
+    uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+    uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+    ctr[0] = hi1^ctr[1]^k0;
+    ctr[1] = lo1;
+    ctr[2] = hi0^ctr[3]^k1;
+    ctr[3] = lo0;
+    k0 += 0x9E3779B9U;
+    k1 += 0xBB67AE85U;
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn RanGaussianPhilox
+//! \brief Returns two independent Gaussian deviates (Box-Muller) from one call of
+//! Philox4x32 with counter (c0,c1) and key, using 53-bit uniform deviates.
+
+KOKKOS_INLINE_FUNCTION
+static void RanGaussianPhilox(uint64_t c0, uint64_t c1, uint64_t key, Real &g0,
+                              Real &g1) {
+  uint32_t ctr[4] = {static_cast<uint32_t>(c0), static_cast<uint32_t>(c0 >> 32),
+                     static_cast<uint32_t>(c1), static_cast<uint32_t>(c1 >> 32)};
+  Philox4x32(ctr, static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32));
+  uint64_t z0 = (static_cast<uint64_t>(ctr[0]) << 32) | ctr[1];
+  uint64_t z1 = (static_cast<uint64_t>(ctr[2]) << 32) | ctr[3];
+  // uniform deviates in (0,1), never exactly 0 or 1
+  double u0 = (static_cast<double>(z0 >> 11) + 0.5)*(1.0/9007199254740992.0);
+  double u1 = (static_cast<double>(z1 >> 11) + 0.5)*(1.0/9007199254740992.0);
+  double r = sqrt(-2.0*log(u0));
+  g0 = static_cast<Real>(r*cos(2.0*M_PI*u1));
+  g1 = static_cast<Real>(r*sin(2.0*M_PI*u1));
+}
+
 #endif // UTILS_RANDOM_HPP_
@@ -0,0 +1,69 @@
+#ifndef UTILS_SCRATCH_ARENA_HPP_
+#define UTILS_SCRATCH_ARENA_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file scratch_arena.hpp
+//! \brief Declares and implements ScratchArena class, a pool of device memory from which
+//! tasks take full-size temporary arrays that are only needed within a single task.
+
+#include <array>
+#include <cstddef>
+
+#include "athena.hpp"
+
+//----------------------------------------------------------------------------------------
+//! \class ScratchArena
+//! \brief Pool of device memory stored in the MeshBlockPack, divided into a small number
+//! of independent slots.  Get4D()/Get5D() return unmanaged views of the requested shape
+//! into the memory of a slot, which is grown (but never shrunk) as needed, so the memory
+//! of each slot is the largest temporary requested from it by any physics module.
+//!
+//! A view is only valid until the same slot is requested again, so a task that needs n
+//! temporaries at the same time takes them from n different slots, and must not keep
+//! the views beyond the end of the task.  Since tasks on a MeshBlockPack execute one at
+//! a time (and kernels in order), temporaries of different tasks (e.g. the FOFC arrays
+//! of Hydro and MHD, and the cell-centered E-fields in MHD::CornerE) share memory.
+
+class ScratchArena {
+ public:
+  static constexpr int nslots = 4;
+
+  ScratchArena() {
+    for (auto &p : pool_) {p = DvceArray1D<Real>("scratch_arena", 0);}
+  }
+
+  DvceArray4D<Real> Get4D(const int slot, const int n0, const int n1, const int n2,
+                          const int n3) {
+    Reserve(slot, static_cast<size_t>(n0)*n1*n2*n3);
+    return DvceArray4D<Real>(pool_[slot].data(), n0, n1, n2, n3);
+  }
+  DvceArray5D<Real> Get5D(const int slot, const int n0, const int n1, const int n2,
+                          const int n3, const int n4) {
+    Reserve(slot, static_cast<size_t>(n0)*n1*n2*n3*n4);
+    return DvceArray5D<Real>(pool_[slot].data(), n0, n1, n2, n3, n4);
+  }
+
+  // total memory held by the arena (in bytes)
+  size_t MemorySize() const {
+    size_t nbytes = 0;
+    for (auto &p : pool_) {nbytes += p.extent(0)*sizeof(Real);}
+    return nbytes;
+  }
+
+  // release all memory, e.g. after the number of MeshBlocks in the pack has decreased
+  void Free() {
+    for (auto &p : pool_) {Kokkos::realloc(p, 0);}
+  }
+
+ private:
+  std::array<DvceArray1D<Real>, nslots> pool_;
+
+  void Reserve(const int slot, const size_t n) {
+    if (pool_[slot].extent(0) < n) {Kokkos::realloc(pool_[slot], n);}
+  }
+};
+
+#endif // UTILS_SCRATCH_ARENA_HPP_
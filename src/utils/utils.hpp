@@ -11,8 +11,17 @@
 
 #include <string>
 
+// forward declarations
+class ParameterInput;
+class Mesh;
+namespace Kokkos {class Timer;}
+
 void ShowConfig();
 void ChangeRunDir(const std::string dir);
 int CreateMPITag(int lid, int buff_id, int phys_id);
+std::string InitialDataCacheName(ParameterInput *pin);
+void WriteInitialDataCache(ParameterInput *pin, Mesh *pm, const std::string &name);
+void Autotune(ParameterInput *pin);
+void RunEnsemble(ParameterInput *pin, double wtlim, Kokkos::Timer *ptimer);
 
 #endif // UTILS_UTILS_HPP_
@@ -7,16 +7,15 @@
 #include <assert.h>
 #include <unistd.h>
 
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
-
-#if MPI_PARALLEL_ENABLED
-#include <mpi.h>
-#endif
+#include <vector>
 
 #include "compact_object_tracker.hpp"
 
@@ -26,6 +25,7 @@
 #include "parameter_input.hpp"
 #include "utils/lagrange_interpolator.hpp"
 #include "coordinates/adm.hpp"
+#include "driver/host_tasks.hpp"
 #include "mhd/mhd.hpp"
 #include "z4c/z4c.hpp"
 
@@ -79,106 +79,111 @@ CompactObjectTracker::CompactObjectTracker(Mesh *pmesh, ParameterInput *pin, int
 CompactObjectTracker::~CompactObjectTracker() { }
 
 //----------------------------------------------------------------------------------------
-void CompactObjectTracker::InterpolateVelocity(MeshBlockPack *pmbp) {
+void CompactObjectTracker::InterpolateVelocities(MeshBlockPack *pmbp,
+    std::list<CompactObjectTracker> &trackers, LagrangeInterpolator &interp) {
   auto &padm = pmbp->padm;
   auto &pmhd = pmbp->pmhd;
   auto &pz4c = pmbp->pz4c;
-  auto *S    = new LagrangeInterpolator(pmbp, pos);
-
-  if (S->point_exist) {
-    owns_compact_object = true;
-
-    Real betax = S->Interpolate(pz4c->u0, pz4c->I_Z4C_BETAX);
-    Real betay = S->Interpolate(pz4c->u0, pz4c->I_Z4C_BETAY);
-    Real betaz = S->Interpolate(pz4c->u0, pz4c->I_Z4C_BETAZ);
-    vel[0] = - betax;
-    vel[1] = - betay;
-    vel[2] = - betaz;
-    if (type == NeutronStar) {
-      Real alp = S->Interpolate(pz4c->u0, pz4c->I_Z4C_ALPHA);
-
-      Real zx = S->Interpolate(pmhd->w0, IVX);
-      Real zy = S->Interpolate(pmhd->w0, IVY);
-      Real zz = S->Interpolate(pmhd->w0, IVZ);
-
-      Real gxx = S->Interpolate(padm->u_adm, padm->I_ADM_GXX);
-      Real gxy = S->Interpolate(padm->u_adm, padm->I_ADM_GXY);
-      Real gxz = S->Interpolate(padm->u_adm, padm->I_ADM_GXZ);
-      Real gyy = S->Interpolate(padm->u_adm, padm->I_ADM_GYY);
-      Real gyz = S->Interpolate(padm->u_adm, padm->I_ADM_GYZ);
-      Real gzz = S->Interpolate(padm->u_adm, padm->I_ADM_GZZ);
-
-      Real z_x = gxx*zx + gxy*zy + gxz*zz;
-      Real z_y = gxy*zx + gyy*zy + gyz*zz;
-      Real z_z = gxz*zx + gyz*zy + gzz*zz;
-      Real W = std::sqrt(z_x*zx + z_y*zy + z_z*zz + 1);
 
-      vel[0] += alp*zx/W;
-      vel[1] += alp*zy/W;
-      vel[2] += alp*zz/W;
+  // positions of all compact objects
+  int npts = trackers.size();
+  std::vector<Real> coords(3*npts);
+  bool any_ns = false;
+  int p = 0;
+  for (auto &pt : trackers) {
+    for (int a = 0; a < NDIM; ++a) {
+      coords[3*p + a] = pt.pos[a];
     }
-  } else {
-    owns_compact_object = false;
+    any_ns = any_ns || (pt.type == NeutronStar);
+    ++p;
+  }
+  interp.SetPoints(npts, coords.data());
+
+  // shift, and for neutron stars lapse, fluid velocity and metric
+  interp.ClearVariables();
+  int ibetax = interp.AddVariable(pz4c->u0, pz4c->I_Z4C_BETAX);
+  int ibetay = interp.AddVariable(pz4c->u0, pz4c->I_Z4C_BETAY);
+  int ibetaz = interp.AddVariable(pz4c->u0, pz4c->I_Z4C_BETAZ);
+  int ialp = -1, izx = -1, izy = -1, izz = -1;
+  int igxx = -1, igxy = -1, igxz = -1, igyy = -1, igyz = -1, igzz = -1;
+  if (any_ns) {
+    pz4c->UpdateADM();
+    ialp = interp.AddVariable(pz4c->u0, pz4c->I_Z4C_ALPHA);
+    izx = interp.AddVariable(pmhd->w0, IVX);
+    izy = interp.AddVariable(pmhd->w0, IVY);
+    izz = interp.AddVariable(pmhd->w0, IVZ);
+    igxx = interp.AddVariable(padm->u_adm, padm->I_ADM_GXX);
+    igxy = interp.AddVariable(padm->u_adm, padm->I_ADM_GXY);
+    igxz = interp.AddVariable(padm->u_adm, padm->I_ADM_GXZ);
+    igyy = interp.AddVariable(padm->u_adm, padm->I_ADM_GYY);
+    igyz = interp.AddVariable(padm->u_adm, padm->I_ADM_GYZ);
+    igzz = interp.AddVariable(padm->u_adm, padm->I_ADM_GZZ);
   }
+  interp.InterpolateAll();
+
+  // values are known on all ranks, so every rank sets the velocity of every tracker
+  auto &v = interp.vals;
+  p = 0;
+  for (auto &pt : trackers) {
+    pt.owns_compact_object = (interp.nfound(p) > 0);
+    pt.vel[0] = - v(p,ibetax);
+    pt.vel[1] = - v(p,ibetay);
+    pt.vel[2] = - v(p,ibetaz);
+    if (pt.type == NeutronStar) {
+      Real alp = v(p,ialp);
+      Real zx = v(p,izx);
+      Real zy = v(p,izy);
+      Real zz = v(p,izz);
+
+      Real z_x = v(p,igxx)*zx + v(p,igxy)*zy + v(p,igxz)*zz;
+      Real z_y = v(p,igxy)*zx + v(p,igyy)*zy + v(p,igyz)*zz;
+      Real z_z = v(p,igxz)*zx + v(p,igyz)*zy + v(p,igzz)*zz;
+      Real W = std::sqrt(z_x*zx + z_y*zy + z_z*zz + 1);
 
-  delete S;
+      pt.vel[0] += alp*zx/W;
+      pt.vel[1] += alp*zy/W;
+      pt.vel[2] += alp*zz/W;
+    }
+    ++p;
+  }
 }
 
 //----------------------------------------------------------------------------------------
 void CompactObjectTracker::EvolveTracker() {
-  if (owns_compact_object) {
-    for (int a = 0; a < NDIM; ++a) {
-      pos[a] += pmesh->dt * vel[a];
-    }
-#if !(MPI_PARALLEL_ENABLED)
-  } else {
-    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
-              << std::endl;
-    std::cout << "couldn't find the compact object!" << std::endl;
-    std::exit(EXIT_FAILURE);
-  }
-#else
-  }
-  Real buf[2 * NDIM + 1] = {0., 0., 0., 0., 0., 0., 0.};
-  if (owns_compact_object) {
-    buf[0] = pos[0];
-    buf[1] = pos[1];
-    buf[2] = pos[2];
-    buf[3] = vel[0];
-    buf[4] = vel[1];
-    buf[5] = vel[2];
-    buf[6] = 1.0;
-  }
-  MPI_Allreduce(
-    MPI_IN_PLACE, buf, 2 * NDIM + 1, MPI_ATHENA_REAL, MPI_SUM, MPI_COMM_WORLD);
-  if (buf[6] < 0.5) {
+  // velocities were set on all ranks by InterpolateVelocities()
+  if (!(owns_compact_object)) {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
               << std::endl;
     std::cout << "The compact object has left the grid" << std::endl;
     std::exit(EXIT_FAILURE);
   }
-  pos[0] = buf[0] / buf[6];
-  pos[1] = buf[1] / buf[6];
-  pos[2] = buf[2] / buf[6];
-  vel[0] = buf[3] / buf[6];
-  vel[1] = buf[4] / buf[6];
-  vel[2] = buf[5] / buf[6];
-#endif // MPI_PARALLEL_ENABLED
+  for (int a = 0; a < NDIM; ++a) {
+    pos[a] += pmesh->dt * vel[a];
+  }
 
   // After the compact object has moved it might have changed ownership
   owns_compact_object = false;
 }
 
 //----------------------------------------------------------------------------------------
-void CompactObjectTracker::WriteTracker() {
+//! \brief Queues formatting and writing of the current position and velocity (copied
+//! into the task) on the host task queue of the Driver, so they overlap with kernels.
+void CompactObjectTracker::WriteTracker(HostTaskQueue &tasks) {
   if (0 == global_variable::my_rank && 0 == pmesh->ncycle % out_every) {
-    ofile << pmesh->ncycle << " "
-          << pmesh->time << " "
-          << pos[0] << " "
-          << pos[1] << " "
-          << pos[2] << " "
-          << vel[0] << " "
-          << vel[1] << " "
-          << vel[2] << std::endl << std::flush;
+    int ncycle = pmesh->ncycle;
+    Real time = pmesh->time;
+    std::array<Real, 2*NDIM> posvel;
+    std::memcpy(&posvel[0], pos, NDIM*sizeof(Real));
+    std::memcpy(&posvel[NDIM], vel, NDIM*sizeof(Real));
+    tasks.Enqueue([this, ncycle, time, posvel]() {
+      ofile << ncycle << " "
+            << time << " "
+            << posvel[0] << " "
+            << posvel[1] << " "
+            << posvel[2] << " "
+            << posvel[3] << " "
+            << posvel[4] << " "
+            << posvel[5] << std::endl << std::flush;
+    });
   }
 }
@@ -9,6 +9,7 @@
 
 #include <cstdio>
 #include <fstream>
+#include <list>
 #include <string>
 
 #include "athena.hpp"
@@ -18,6 +19,8 @@
 // Forward declaration
 class Mesh;
 class ParameterInput;
+class LagrangeInterpolator;
+class HostTaskQueue;
 
 //! \class CompactObjectTracker
 //! \brief Tracks a single puncture
@@ -29,12 +32,15 @@ class CompactObjectTracker {
   CompactObjectTracker(Mesh *pmesh, ParameterInput *pin, int n);
   //! Destructor (will close output file)
   ~CompactObjectTracker();
-  //! Interpolate the shift vector to the puncture position
-  void InterpolateVelocity(MeshBlockPack *pmbp);
-  //! Update and broadcast the puncture position
+  //! Interpolate the velocities of all trackers to their positions, with one kernel
+  //! and one reduction over ranks
+  static void InterpolateVelocities(MeshBlockPack *pmbp,
+                                    std::list<CompactObjectTracker> &trackers,
+                                    LagrangeInterpolator &interp);
+  //! Update the puncture position
   void EvolveTracker();
-  //! Write data to file
-  void WriteTracker();
+  //! Write data to file (asynchronously, if host task queue is running)
+  void WriteTracker(HostTaskQueue &tasks);
   //! Get position array
   inline Real * GetPos() {
     return &pos[0];
@@ -57,7 +63,7 @@ class CompactObjectTracker {
   }
 
  private:
-  bool owns_compact_object;
+  bool owns_compact_object;  // true if object was found on any rank in interpolation
   CompactObjectType type;
   Real pos[NDIM];
   Real vel[NDIM];
@@ -0,0 +1,404 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file horizon_finder.cpp
+//! \brief implementation of the apparent horizon finder.  With the level set
+//! F = |x - center| - h(theta,phi), unit normal s^i = g^{ij} d_j F / |dF|, and projector
+//! m^{ij} = g^{ij} - s^i s^j, the expansion of outgoing null rays is
+//!   Theta = m^{ij} (d_i d_j F - Gamma^k_{ij} d_k F) / |dF| - m^{ij} K_{ij}.
+//! Derivatives of F are computed by finite differences of h (which is known everywhere
+//! from its expansion), and derivatives of the metric by finite differences of its
+//! values interpolated to points displaced along the coordinate axes.  The fast flow
+//!   a_lm -> a_lm - A/(1 + B l(l+1)) (rho Theta)_lm,   rho = h^2/|dF|
+//! with A = alpha/(lmax(lmax+1)) + beta and B = beta/alpha is iterated until h changes
+//! by less than tol times its mean.
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "z4c/horizon_finder.hpp"
+
+#include "athena.hpp"
+#include "globals.hpp"
+#include "mesh/mesh.hpp"
+#include "parameter_input.hpp"
+#include "coordinates/adm.hpp"
+#include "geodesic-grid/geodesic_grid.hpp"
+#include "utils/lagrange_interpolator.hpp"
+#include "z4c/compact_object_tracker.hpp"
+#include "z4c/z4c.hpp"
+
+namespace {
+//----------------------------------------------------------------------------------------
+//! \fn void RealSphHarm()
+//! \brief real spherical harmonics Y_lm(theta,phi), orthonormal on the unit sphere, for
+//! all l <= lmax, stored in ylm[l*l + l + m].  Uses the recursion for the normalized
+//! associated Legendre functions.
+
+void RealSphHarm(int lmax, Real theta, Real phi, Real *ylm) {
+  Real x = std::cos(theta);
+  Real s = std::sin(theta);
+  Real pmm = 1.0/std::sqrt(4.0*M_PI);
+  for (int m = 0; m <= lmax; ++m) {
+    if (m > 0) {
+      pmm *= std::sqrt((2.0*m + 1.0)/(2.0*m))*s;
+    }
+    Real plm1 = pmm, plm2 = 0.0, aprev = 0.0;
+    for (int l = m; l <= lmax; ++l) {
+      Real plm = pmm;
+      if (l > m) {
+        Real a = std::sqrt((4.0*l*l - 1.0)/static_cast<Real>(l*l - m*m));
+        plm = a*(x*plm1 - ((l > m + 1)? plm2/aprev : 0.0));
+        aprev = a;
+        plm2 = plm1;
+        plm1 = plm;
+      }
+      if (m == 0) {
+        ylm[l*l + l] = plm;
+      } else {
+        ylm[l*l + l + m] = std::sqrt(2.0)*plm*std::cos(m*phi);
+        ylm[l*l + l - m] = std::sqrt(2.0)*plm*std::sin(m*phi);
+      }
+    }
+  }
+}
+
+// index of symmetric tensor components in the order XX, XY, XZ, YY, YZ, ZZ
+const int kSym[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+} // namespace
+
+//----------------------------------------------------------------------------------------
+HorizonFinder::HorizonFinder(MeshBlockPack *pmbp, ParameterInput *pin, int n):
+    found{false}, center{0.0, 0.0, 0.0}, rmin{0.0}, rmax{0.0}, area{0.0}, mass{0.0},
+    pmy_pack{pmbp}, niter{0}, theta_max{0.0} {
+  std::string nstr = "ahf_" + std::to_string(n) + "_";
+  Mesh *pm = pmbp->pmesh;
+
+  // parameters shared by all horizons
+  int nlev = pin->GetOrAddInteger("z4c", "ahf_nlev", 5);
+  lmax = pin->GetOrAddInteger("z4c", "ahf_lmax", 6);
+  find_every = pin->GetOrAddInteger("z4c", "ahf_every", 10);
+  max_iter = pin->GetOrAddInteger("z4c", "ahf_max_iter", 200);
+  tol = pin->GetOrAddReal("z4c", "ahf_tol", 1.0e-8);
+  flow_alpha = pin->GetOrAddReal("z4c", "ahf_flow_alpha", 1.0);
+  flow_beta = pin->GetOrAddReal("z4c", "ahf_flow_beta", 0.5);
+  // default step is the cell size on the finest level
+  Real dx_fine = pm->mesh_size.dx1/static_cast<Real>(1 << (pm->max_level -
+                                                            pm->root_level));
+  deriv_step = pin->GetOrAddReal("z4c", "ahf_deriv_step", dx_fine);
+
+  // parameters of this horizon
+  ntracker = pin->GetOrAddInteger("z4c", nstr + "tracker", -1);
+  center[0] = pin->GetOrAddReal("z4c", nstr + "x", 0.0);
+  center[1] = pin->GetOrAddReal("z4c", nstr + "y", 0.0);
+  center[2] = pin->GetOrAddReal("z4c", nstr + "z", 0.0);
+  rguess = pin->GetReal("z4c", nstr + "rguess");
+  reflevel = pin->GetOrAddInteger("z4c", nstr + "reflevel", -1);
+  ref_factor = pin->GetOrAddReal("z4c", nstr + "ref_factor", 1.5);
+
+  if (lmax < 1 || find_every < 1 || rguess <= 0.0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "Horizon finder needs ahf_lmax >= 1, ahf_every >= 1, and "
+              << nstr << "rguess > 0" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  // spherical harmonics at the angles of the geodesic grid
+  pgrid = std::make_unique<GeodesicGrid>(nlev, false, false);
+  nangles = pgrid->nangles;
+  nlm = (lmax + 1)*(lmax + 1);
+  ylm.resize(nangles*nlm);
+  for (int ip = 0; ip < nangles; ++ip) {
+    auto &pos = pgrid->cart_pos;
+    RealSphHarm(lmax, std::acos(fmin(fmax(pos.h_view(ip,2), -1.0), 1.0)),
+                std::atan2(pos.h_view(ip,1), pos.h_view(ip,0)), &ylm[ip*nlm]);
+  }
+  a_lm.resize(nlm);
+  hpts.resize(nangles);
+  ResetSurface();
+
+  if (0 == global_variable::my_rank) {
+    std::string ofname = pin->GetString("job", "basename") + ".horizon_";
+    ofname += std::to_string(n) + ".txt";
+    ofile.open(ofname.c_str());
+    ofile << "# Apparent horizon" << std::endl;
+    ofile << "# 1:iter 2:time 3:found 4:x 5:y 6:z 7:rmin 8:rmax 9:area 10:mass "
+          << "11:max|Theta*h| 12:niter" << std::endl;
+    ofile << std::setprecision(15);
+  }
+}
+
+//----------------------------------------------------------------------------------------
+HorizonFinder::~HorizonFinder() {
+  if (0 == global_variable::my_rank) {
+    ofile.close();
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::ResetSurface()
+//! \brief reset the surface to a sphere of radius rguess about the center
+
+void HorizonFinder::ResetSurface() {
+  std::fill(a_lm.begin(), a_lm.end(), 0.0);
+  a_lm[0] = rguess*std::sqrt(4.0*M_PI);
+}
+
+//----------------------------------------------------------------------------------------
+Real HorizonFinder::EvalH(Real x, Real y, Real z) const {
+  std::vector<Real> y_lm(nlm);
+  Real r = std::sqrt(x*x + y*y + z*z);
+  RealSphHarm(lmax, std::acos(fmin(fmax(z/r, -1.0), 1.0)), std::atan2(y, x),
+              y_lm.data());
+  Real h = 0.0;
+  for (int lm = 0; lm < nlm; ++lm) {
+    h += a_lm[lm]*y_lm[lm];
+  }
+  return h;
+}
+
+//----------------------------------------------------------------------------------------
+Real HorizonFinder::EvalF(Real x, Real y, Real z) const {
+  return std::sqrt(x*x + y*y + z*z) - EvalH(x, y, z);
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::Find()
+//! \brief search for the horizon every find_every cycles, starting from the surface
+//! found in the previous search (or from a sphere of radius rguess).  Each iteration
+//! interpolates the ADM variables to all points of the surface in one batch.
+
+void HorizonFinder::Find(std::list<CompactObjectTracker> &trackers,
+                         LagrangeInterpolator &interp) {
+  Mesh *pm = pmy_pack->pmesh;
+  if (pm->ncycle % find_every != 0) {
+    return;
+  }
+  auto &padm = pmy_pack->padm;
+  pmy_pack->pz4c->UpdateADM();
+
+  // seed the center with the position of the compact object
+  if (ntracker >= 0) {
+    if (ntracker >= static_cast<int>(trackers.size())) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "Horizon finder centered on tracker " << ntracker
+                << " which does not exist" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    auto pt = std::next(trackers.begin(), ntracker);
+    for (int a = 0; a < 3; ++a) {
+      center[a] = pt->GetPos(a);
+    }
+  }
+  if (!(found)) {
+    ResetSurface();
+  }
+  std::vector<Real> a_old = a_lm;
+
+  const int npts = 7*nangles;
+  std::vector<Real> coords(3*npts);
+  std::vector<Real> rho_theta(nangles);
+  const Real fac_a = flow_alpha/static_cast<Real>(lmax*(lmax + 1)) + flow_beta;
+  const Real fac_b = flow_beta/flow_alpha;
+  const Real step = deriv_step;
+  bool converged = false, failed = false;
+  niter = 0;
+  while (niter < max_iter && !(converged) && !(failed)) {
+    niter++;
+    // h at the angles of the grid
+    Real hmean = a_lm[0]/std::sqrt(4.0*M_PI);
+    for (int ip = 0; ip < nangles; ++ip) {
+      Real h = 0.0;
+      for (int lm = 0; lm < nlm; ++lm) {
+        h += a_lm[lm]*ylm[ip*nlm + lm];
+      }
+      hpts[ip] = h;
+      failed = failed || (h <= 0.0);
+    }
+    if (failed) {break;}
+
+    // points on the surface (s=0), and displaced by +/- step along each axis (s=1..6)
+    for (int s = 0; s < 7; ++s) {
+      int dir = (s - 1)/2;
+      Real disp = (s == 0)? 0.0 : ((s % 2 == 1)? step : -step);
+      for (int ip = 0; ip < nangles; ++ip) {
+        int p = s*nangles + ip;
+        for (int a = 0; a < 3; ++a) {
+          coords[3*p + a] = center[a] + hpts[ip]*pgrid->cart_pos.h_view(ip,a);
+        }
+        if (s > 0) {coords[3*p + dir] += disp;}
+      }
+    }
+    interp.SetPoints(npts, coords.data());
+    interp.ClearVariables();
+    int ig[6], ik[6];
+    for (int c = 0; c < 6; ++c) {
+      ig[c] = interp.AddVariable(padm->u_adm, padm->I_ADM_GXX + c);
+    }
+    for (int c = 0; c < 6; ++c) {
+      ik[c] = interp.AddVariable(padm->u_adm, padm->I_ADM_KXX + c);
+    }
+    interp.InterpolateAll();
+    for (int p = 0; p < npts; ++p) {
+      failed = failed || (interp.nfound(p) == 0);
+    }
+    if (failed) {break;}
+
+    // expansion at each point of the surface
+    auto &v = interp.vals;
+    Real eps = 1.0e-4*hmean;
+    area = 0.0;
+    theta_max = 0.0;
+    for (int ip = 0; ip < nangles; ++ip) {
+      Real g[3][3], kk[3][3], dg[3][3][3];
+      for (int a = 0; a < 3; ++a) {
+        for (int b = 0; b < 3; ++b) {
+          g[a][b] = v(ip, ig[kSym[a][b]]);
+          kk[a][b] = v(ip, ik[kSym[a][b]]);
+          for (int c = 0; c < 3; ++c) {
+            dg[c][a][b] = (v((2*c + 1)*nangles + ip, ig[kSym[a][b]]) -
+                           v((2*c + 2)*nangles + ip, ig[kSym[a][b]]))/(2.0*step);
+          }
+        }
+      }
+      Real detg = g[0][0]*(g[1][1]*g[2][2] - g[1][2]*g[2][1])
+                - g[0][1]*(g[1][0]*g[2][2] - g[1][2]*g[2][0])
+                + g[0][2]*(g[1][0]*g[2][1] - g[1][1]*g[2][0]);
+      Real gu[3][3];
+      for (int a = 0; a < 3; ++a) {
+        for (int b = 0; b < 3; ++b) {
+          int a1 = (a + 1) % 3, a2 = (a + 2) % 3;
+          int b1 = (b + 1) % 3, b2 = (b + 2) % 3;
+          gu[b][a] = (g[a1][b1]*g[a2][b2] - g[a1][b2]*g[a2][b1])/detg;
+        }
+      }
+
+      // derivatives of level set by finite differences of h
+      Real xr[3];
+      for (int a = 0; a < 3; ++a) {
+        xr[a] = hpts[ip]*pgrid->cart_pos.h_view(ip,a);
+      }
+      Real f0 = EvalF(xr[0], xr[1], xr[2]);
+      Real df[3], ddf[3][3];
+      for (int a = 0; a < 3; ++a) {
+        Real xp[3] = {xr[0], xr[1], xr[2]};
+        Real xm[3] = {xr[0], xr[1], xr[2]};
+        xp[a] += eps;
+        xm[a] -= eps;
+        Real fp = EvalF(xp[0], xp[1], xp[2]);
+        Real fm = EvalF(xm[0], xm[1], xm[2]);
+        df[a] = (fp - fm)/(2.0*eps);
+        ddf[a][a] = (fp - 2.0*f0 + fm)/(eps*eps);
+      }
+      for (int a = 0; a < 3; ++a) {
+        for (int b = a + 1; b < 3; ++b) {
+          Real fs[4];
+          for (int q = 0; q < 4; ++q) {
+            Real xq[3] = {xr[0], xr[1], xr[2]};
+            xq[a] += (q < 2)? eps : -eps;
+            xq[b] += (q % 2 == 0)? eps : -eps;
+            fs[q] = EvalF(xq[0], xq[1], xq[2]);
+          }
+          ddf[a][b] = (fs[0] - fs[1] - fs[2] + fs[3])/(4.0*eps*eps);
+          ddf[b][a] = ddf[a][b];
+        }
+      }
+
+      // normal, projector, and expansion
+      Real nrm2 = 0.0;
+      for (int a = 0; a < 3; ++a) {
+        for (int b = 0; b < 3; ++b) {
+          nrm2 += gu[a][b]*df[a]*df[b];
+        }
+      }
+      Real nrm = std::sqrt(nrm2);
+      Real su[3];
+      for (int a = 0; a < 3; ++a) {
+        su[a] = (gu[a][0]*df[0] + gu[a][1]*df[1] + gu[a][2]*df[2])/nrm;
+      }
+      Real theta = 0.0;
+      for (int a = 0; a < 3; ++a) {
+        for (int b = 0; b < 3; ++b) {
+          Real mab = gu[a][b] - su[a]*su[b];
+          // Gamma^k_ab d_k F
+          Real gam_df = 0.0;
+          for (int k = 0; k < 3; ++k) {
+            for (int l = 0; l < 3; ++l) {
+              gam_df += 0.5*gu[k][l]*(dg[a][b][l] + dg[b][a][l] - dg[l][a][b])*df[k];
+            }
+          }
+          theta += mab*((ddf[a][b] - gam_df)/nrm - kk[a][b]);
+        }
+      }
+      Real h = hpts[ip];
+      Real w = pgrid->solid_angles.h_view(ip);
+      rho_theta[ip] = h*h*theta/nrm;
+      area += w*std::sqrt(detg)*nrm*h*h;
+      theta_max = std::max(theta_max, std::abs(theta*h));
+    }
+
+    // fast flow of the coefficients of h
+    std::vector<Real> da(nlm);
+    for (int lm = 0; lm < nlm; ++lm) {
+      int l = static_cast<int>(std::sqrt(static_cast<Real>(lm)) + 1.0e-8);
+      Real proj = 0.0;
+      for (int ip = 0; ip < nangles; ++ip) {
+        proj += pgrid->solid_angles.h_view(ip)*rho_theta[ip]*ylm[ip*nlm + lm];
+      }
+      da[lm] = -fac_a/(1.0 + fac_b*l*(l + 1))*proj;
+      a_lm[lm] += da[lm];
+    }
+    Real dh_max = 0.0;
+    for (int ip = 0; ip < nangles; ++ip) {
+      Real dh = 0.0;
+      for (int lm = 0; lm < nlm; ++lm) {
+        dh += da[lm]*ylm[ip*nlm + lm];
+      }
+      dh_max = std::max(dh_max, std::abs(dh));
+    }
+    converged = (dh_max < tol*hmean);
+  }
+
+  found = converged && !(failed);
+  if (found) {
+    rmin = *std::min_element(hpts.begin(), hpts.end());
+    rmax = *std::max_element(hpts.begin(), hpts.end());
+    mass = std::sqrt(area/(16.0*M_PI));
+  } else {
+    // keep the previous surface as the initial guess of the next search
+    a_lm = a_old;
+  }
+  WriteHorizon();
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void HorizonFinder::WriteHorizon()
+//! \brief write the result of the last search.  The position is the centroid of the
+//! surface, given by the l = 1 coefficients of h.
+
+void HorizonFinder::WriteHorizon() {
+  if (0 == global_variable::my_rank) {
+    Real fac = 1.0/std::sqrt(4.0*M_PI/3.0);
+    ofile << pmy_pack->pmesh->ncycle << " "
+          << pmy_pack->pmesh->time << " "
+          << static_cast<int>(found) << " "
+          << center[0] + fac*a_lm[3] << " "
+          << center[1] + fac*a_lm[1] << " "
+          << center[2] + fac*a_lm[2] << " "
+          << rmin << " "
+          << rmax << " "
+          << area << " "
+          << mass << " "
+          << theta_max << " "
+          << niter << std::endl << std::flush;
+  }
+}
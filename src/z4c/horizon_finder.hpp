@@ -0,0 +1,75 @@
+#ifndef Z4C_HORIZON_FINDER_HPP_
+#define Z4C_HORIZON_FINDER_HPP_
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file horizon_finder.hpp
+//! \brief in-situ apparent horizon finder.  The horizon is a star-shaped surface
+//! r = h(theta,phi) about a center (optionally the position of a CompactObjectTracker),
+//! with h expanded in real spherical harmonics up to l = lmax and sampled on the angles
+//! of a geodesic grid.  The expansion Theta of the surface is computed from the ADM
+//! metric and extrinsic curvature interpolated with the batched LagrangeInterpolator,
+//! and the coefficients of h are updated with the fast flow of Gundlach (1998).
+
+#include <fstream>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "athena.hpp"
+
+// Forward declaration
+class MeshBlockPack;
+class ParameterInput;
+class GeodesicGrid;
+class LagrangeInterpolator;
+class CompactObjectTracker;
+
+//! \class HorizonFinder
+//! \brief Finds a single apparent horizon
+class HorizonFinder {
+ public:
+  //! Initialize a horizon finder, with parameters ahf_<n>_* in <z4c>
+  HorizonFinder(MeshBlockPack *pmbp, ParameterInput *pin, int n);
+  //! Destructor (will close output file)
+  ~HorizonFinder();
+  //! Find the horizon, if this is a cycle in which the finder runs
+  void Find(std::list<CompactObjectTracker> &trackers, LagrangeInterpolator &interp);
+  //! Write data to file
+  void WriteHorizon();
+
+  bool found;          // true if the horizon was found in the last search
+  Real center[3];      // center about which h is expanded
+  Real rmin, rmax;     // minimum and maximum of h over the surface
+  Real area;           // area of the horizon
+  Real mass;           // irreducible mass sqrt(area/(16 pi))
+  int reflevel;        // minimum refinement level within ref_factor*rmax (or -1)
+  Real ref_factor;
+
+ private:
+  MeshBlockPack *pmy_pack;
+  std::unique_ptr<GeodesicGrid> pgrid;  // angles of the points on the surface
+  int nangles;
+  int lmax, nlm;
+  int ntracker;        // index of tracker at the center (or -1 for a fixed center)
+  Real rguess;         // radius of initial sphere
+  int find_every;      // cycles between searches
+  int max_iter;        // maximum number of flow iterations
+  Real tol;            // tolerance on the change of h relative to its mean
+  Real flow_alpha, flow_beta;  // parameters of fast flow
+  Real deriv_step;     // step for finite differences of the metric
+  int niter;           // number of iterations of last search
+  Real theta_max;      // max |Theta h| on the surface at the end of last search
+  std::vector<Real> a_lm;     // coefficients of h
+  std::vector<Real> ylm;      // Y_lm at the angles of the grid (nangles,nlm)
+  std::vector<Real> hpts;     // h at the angles of the grid
+  std::ofstream ofile;
+
+  void ResetSurface();
+  Real EvalH(Real x, Real y, Real z) const;  // h at direction of (x,y,z) from center
+  Real EvalF(Real x, Real y, Real z) const;  // level set F = r - h at (x,y,z)
+};
+
+#endif // Z4C_HORIZON_FINDER_HPP_
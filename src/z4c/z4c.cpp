@@ -17,12 +17,16 @@
 #include <Kokkos_Core.hpp>
 
 #include "athena.hpp"
+#include "globals.hpp"
 #include "parameter_input.hpp"
 #include "mesh/mesh.hpp"
 #include "bvals/bvals.hpp"
+#include "mhd/mhd.hpp"
 #include "z4c/compact_object_tracker.hpp"
+#include "z4c/horizon_finder.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/z4c_amr.hpp"
+#include "utils/lagrange_interpolator.hpp"
 #include "coordinates/adm.hpp"
 
 namespace z4c {
@@ -85,6 +89,8 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   Kokkos::realloc(u1,    nmb, (nz4c), ncells3, ncells2, ncells1);
   Kokkos::realloc(u_rhs, nmb, (nz4c), ncells3, ncells2, ncells1);
   Kokkos::realloc(u_weyl,    nmb, (2), ncells3, ncells2, ncells1);
+  // compulsory memory traffic per cell of RHS kernel (reads u0, writes u_rhs)
+  kernel_profiler::SetBytesPerIteration("z4c rhs loop", 2.0*nz4c*sizeof(Real));
 
   con.C.InitWithShallowSlice(u_con, I_CON_C);
   con.H.InitWithShallowSlice(u_con, I_CON_H);
@@ -144,6 +150,45 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   opt.extrap_order = fmax(2,fmin(indcs.ng,fmin(4,
       pin->GetOrAddInteger("z4c", "extrap_order", 2))));
 
+  opt.staged_rhs = pin->GetOrAddBoolean("z4c", "staged_rhs", false);
+  opt.fused_diss = pin->GetOrAddBoolean("z4c", "fused_diss", false);
+  // the Sommerfeld condition overwrites the RHS (including dissipation) of boundary
+  // cells, so it is fused into the RHS kernel only when dissipation is added there too
+  sbc_in_rhs = (opt.fused_diss && !(opt.staged_rhs));
+  if (sbc_in_rhs) {sbc_faces = DualArray1D<int>("sbc_faces", 1);}
+  opt.rhs_fp32_level = pin->GetOrAddInteger("z4c", "rhs_fp32_level", -1);
+  if (opt.staged_rhs && opt.rhs_fp32_level >= 0) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<z4c>/rhs_fp32_level cannot be used with staged_rhs"
+              << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  // the interior of the next stage is computed from u0 right after it is sent, which
+  // requires that u0 in active cells is not changed afterwards (true in vacuum, where
+  // the algebraic constraints are only enforced in the last stage)
+  opt.overlap_rhs = pin->GetOrAddBoolean("z4c", "overlap_rhs", false);
+  if (opt.overlap_rhs) {
+    if (opt.staged_rhs || pin->DoesBlockExist("mhd")) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<z4c>/overlap_rhs cannot be used with staged_rhs or "
+                << "with matter" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    if (indcs.nx1 <= 2*indcs.ng || indcs.nx2 <= 2*indcs.ng || indcs.nx3 <= 2*indcs.ng) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<z4c>/overlap_rhs needs MeshBlocks with more than "
+                << "2*nghost cells in each direction" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
+  opt.constraints_every = pin->GetOrAddInteger("z4c", "constraints_every", 1);
+  if (opt.constraints_every < 1) {
+    std::cout << "### FATAL ERROR in " << __FILE__ << " at line " << __LINE__
+              << std::endl << "<z4c>/constraints_every must be positive" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
   diss = opt.diss*pow(2., -2.*indcs.ng)*(indcs.ng % 2 == 0 ? -1. : 1.);
   }
 
@@ -160,8 +205,28 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
 
   // allocate boundary buffers for conserved (cell-centered) variables
   Kokkos::Profiling::pushRegion("Buffers");
+  // With coalesce_halo, conserved MHD variables of DynGRMHD are appended to the Z4c
+  // variables in the same buffers, so that both are packed in one kernel and sent in one
+  // message per neighbor. Only implemented for uniform meshes, since Z4c and MHD use
+  // different prolongation at fine/coarse boundaries.
+  coalesce_halo = pin->GetOrAddBoolean("z4c", "coalesce_halo", false);
+  if (coalesce_halo && ppack->pmesh->multilevel) {
+    if (global_variable::my_rank == 0) {
+      std::cout << "### WARNING in " << __FILE__ << " at line " << __LINE__
+                << std::endl << "<z4c>/coalesce_halo is not implemented with SMR/AMR, "
+                << "MHD variables are communicated separately" << std::endl;
+    }
+    coalesce_halo = false;
+  }
+  if (ppack->pmhd == nullptr) {coalesce_halo = false;}
+  nvar_halo = nz4c;
+  if (coalesce_halo) {
+    nvar_halo += ppack->pmhd->u0.extent_int(1);
+    ppack->pmhd->coalesced_u = true;
+  }
   pbval_u = new MeshBoundaryValuesCC(ppack, pin, true);
-  pbval_u->InitializeBuffers((nz4c));
+  pbval_u->lowp_vars = pin->GetOrAddBoolean("z4c", "lowp_halo", false);
+  pbval_u->InitializeBuffers(nvar_halo);
   pbval_weyl = new MeshBoundaryValuesCC(ppack, pin, true);
   pbval_weyl->InitializeBuffers((2));
   Kokkos::Profiling::popRegion();
@@ -178,10 +243,24 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
   }
   // TODO(@dur566): Why is the size of psi_out hardcoded?
   psi_out = new Real[nrad*77*2];
+  if (nrad > 0) {
+    SetSWSHWeights();
+    weyl_mb = DualArray1D<int>("weyl_mb", 1);
+  }
+  // compute Weyl scalars only near extraction spheres (set false to output them in all
+  // MeshBlocks)
+  weyl_shells_only = pin->GetOrAddBoolean("z4c", "weyl_shells_only", true);
   mkdir("waveforms",0775);
   waveform_dt = pin->GetOrAddReal("z4c", "waveform_dt", 1);
   last_output_time = 0;
 
+  // storage for derivatives of ADM variables shared by constraints and Weyl scalars
+  share_adm_drv = (nrad > 0) &&
+                  pin->GetOrAddBoolean("z4c", "share_adm_derivatives", false);
+  if (share_adm_drv) {
+    Kokkos::realloc(adm_drv, nmb, NADM_DRV, indcs.nx3, indcs.nx2, indcs.nx1);
+  }
+
   // Construct the compact object trackers
   int n = 0;
   while (true) {
@@ -192,6 +271,13 @@ Z4c::Z4c(MeshBlockPack *ppack, ParameterInput *pin) :
       break;
     }
   }
+
+  // Construct the apparent horizon finders
+  n = 0;
+  while (pin->DoesParameterExist("z4c", "ahf_" + std::to_string(n) + "_rguess")) {
+    phorizons.emplace_back(pmy_pack, pin, n);
+    n++;
+  }
 }
 
 //----------------------------------------------------------------------------------------
@@ -26,6 +26,22 @@
 class Coordinates;
 class Driver;
 class CompactObjectTracker;
+class LagrangeInterpolator;
+class HorizonFinder;
+
+//----------------------------------------------------------------------------------------
+//! \fn int SymIdx()
+//! \brief index (0..5) of symmetric pair (a,b) in the order xx, xy, xz, yy, yz, zz
+
+KOKKOS_INLINE_FUNCTION
+int SymIdx(const int a, const int b) {
+  return (a <= b)? (a*(5 - a))/2 + b : (b*(5 - b))/2 + a;
+}
+
+// Components of the derivatives of the ADM metric and extrinsic curvature shared by
+// ADMConstraints() and Z4cWeyl(): d_c g_ab and d_c K_ab at 6*c + SymIdx(a,b), and
+// d_ab g_cd at 6*SymIdx(c,d) + SymIdx(a,b)
+enum ADMDerivIndex {IADM_DG=0, IADM_DK=18, IADM_DDG=36, NADM_DRV=72};
 
 //----------------------------------------------------------------------------------------
 //! \struct Z4cTaskIDs
@@ -195,12 +211,36 @@ class Z4c {
     bool user_Sbc;
     // Boundary extrapolation order
     int extrap_order;
+    // Compute RHS in stages with one team per pencil (see z4c_calcrhs_staged.cpp)
+    bool staged_rhs;
+    // Add Kreiss-Oliger dissipation in the RHS kernel rather than in a separate kernel
+    bool fused_diss;
+    // Compute RHS in single precision in MeshBlocks on physical levels <= this value
+    int rhs_fp32_level;
+    // Compute RHS of the next stage in the interior of MeshBlocks while u0 is exchanged
+    bool overlap_rhs;
+    // Cycles between computations of the constraints
+    int constraints_every;
   };
   Options opt;
   Real diss;              // Dissipation parameter
+  bool rhs_interior_ready = false;  // RHS in interior computed by CalcRHSInterior()
+  // Sommerfeld condition applied in RHS kernel (rather than by Z4cBoundaryRHS()), and
+  // mask of faces on which it is applied for each MeshBlock (see SetSommerfeldFaces())
+  bool sbc_in_rhs = false;
+  DualArray1D<int> sbc_faces;
+  int sbc_nregrid = -1;   // value of Mesh::nregrid when sbc_faces was set
+  // ADM variables are computed from u0 only when they are read (see UpdateADM()), so
+  // they are current only if u0 has not changed since then
+  bool adm_current = false;
+  int adm_nregrid = -1;   // value of Mesh::nregrid when ADM variables were computed
 
   // Boundary communication buffers and functions for u
   MeshBoundaryValuesCC *pbval_u;
+  // flag to send conserved MHD variables in same buffers (and messages) as u
+  bool coalesce_halo;
+  int nvar_halo;       // number of variables in pbval_u buffers
+  CCFieldList HaloFields();
 
   // Boundary communication buffers for the weyl scalar
   MeshBoundaryValuesCC *pbval_weyl;
@@ -217,6 +257,23 @@ class Z4c {
   Real waveform_dt;
   Real last_output_time;
   int nrad; // number of radii to perform wave extraction
+  // flags of MeshBlocks within an interpolation stencil of an extraction sphere, the
+  // only ones in which Weyl scalars are computed (see SetWeylBlocks())
+  DualArray1D<int> weyl_mb;
+  bool weyl_shells_only;
+  int weyl_nregrid = -1;  // value of Mesh::nregrid when weyl_mb was set
+  // spin-weighted spherical harmonics Y_lm (l <= 8, s=-2) times solid angles at the
+  // angles of the wave extraction spheres (nlm,nangles,2), and projections of psi4 onto
+  // them (nrad,nlm,2), computed on the device for all radii together
+  DvceArray3D<Real> swsh_wghts;
+  DualArray3D<Real> psi4_lm;
+  std::unique_ptr<SphericalGridBatch> wave_batch;  // interpolates psi4 to all spheres
+
+  // derivatives of ADM g_dd and K_dd in active cells, stored by ADMConstraints() in
+  // cycles in which Weyl scalars are computed, so that Z4cWeyl() does not recompute them
+  bool share_adm_drv;
+  bool adm_drv_ready = false;
+  DvceArray5D<Real> adm_drv;
 
   // functions
   void QueueZ4cTasks();
@@ -242,6 +299,7 @@ class Z4c {
   TaskStatus UpdateExcisionMasks(Driver *d, int stage);
   TaskStatus ADMConstraints_(Driver *d, int stage);
   TaskStatus Z4cBoundaryRHS(Driver *d, int stage);
+  void SetSommerfeldFaces();
   TaskStatus RestrictU(Driver *d, int stage);
   TaskStatus RestrictWeyl(Driver *d, int stage);
   TaskStatus TrackCompactObjects(Driver *d, int stage);
@@ -251,18 +309,35 @@ class Z4c {
   template <int NGHOST>
   TaskStatus CalcRHS(Driver *d, int stage);
   template <int NGHOST>
+  TaskStatus CalcRHSInterior(Driver *d, int stage);
+  template <int NGHOST>
+  void CalcRHSRegion(const int il, const int iu, const int jl, const int ju,
+                     const int kl, const int ku);
+  template <int NGHOST>
+  void CalcRHSStaged();
+  template <int NGHOST, typename RTYPE>
+  void CalcRHSCells(const bool fp32_blocks, const int il, const int iu,
+                    const int jl, const int ju, const int kl, const int ku);
+  template <int NGHOST>
   void ADMToZ4c(MeshBlockPack *pmbp, ParameterInput *pin);
   void GaugePreCollapsedLapse(MeshBlockPack *pmbp, ParameterInput *pin);
   void Z4cToADM(MeshBlockPack *pmbp);
+  void UpdateADM();
   template <int NGHOST>
   void ADMConstraints(MeshBlockPack *pmbp);
   template <int NGHOST>
   void Z4cWeyl(MeshBlockPack *pmbp);
+  void SetWeylBlocks();
   void WaveExtr(MeshBlockPack *pmbp);
+  void SetSWSHWeights();
   void AlgConstr(MeshBlockPack *pmbp);
 
   Z4c_AMR *pamr;
   std::list<CompactObjectTracker> ptracker;
+  // interpolates variables to positions of all trackers together
+  std::unique_ptr<LagrangeInterpolator> ptracker_interp;
+  // apparent horizon finders (seeded from the trackers)
+  std::list<HorizonFinder> phorizons;
 
  private:
   MeshBlockPack* pmy_pack;  // ptr to MeshBlockPack containing this Z4c
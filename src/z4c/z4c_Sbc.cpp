@@ -14,117 +14,45 @@
 #include "athena.hpp"
 #include "mesh/mesh.hpp"
 #include "z4c/z4c.hpp"
+#include "z4c/z4c_Sbc.hpp"
 #include "coordinates/cell_locations.hpp"
 
 namespace z4c {
 
 //----------------------------------------------------------------------------------------
-//! \fn void Z4c::Z4cSommerfeld
-//! \brief apply Sommerfeld BCs to the given set of points
-KOKKOS_INLINE_FUNCTION
-static void Z4cSommerfeld(const Z4c::Z4c_vars& z4c, const Z4c::Z4c_vars& rhs,
-    const RegionIndcs &indcs, const DualArray1D<RegionSize> &size,
-    const int m, const int k, const int j, const int i) {
-  // -------------------------------------------------------------------------------------
-  // Scratch data
-  //
-
-  // First derivatives
-  // Scalars
-  AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> dKhat_d;
-  AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> dTheta_d;
-
-  // Vectors
-  AthenaScratchTensor<Real, TensorSymm::NONE, 3, 2> dGam_du;
-
-  // Tensors
-  AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 3> dA_ddd;
-
-
-  // Psuedoradial vector
-  AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> s_u;
-
-  Real idx[] = {1./size.d_view(m).dx1, 1./size.d_view(m).dx2, 1./size.d_view(m).dx3};
-
-  // -------------------------------------------------------------------------------------
-  // First derivatives
-  // We force all derivatives to be calculated at second-order, as this was found to
-  // be necessary for stability in Athena++.
-  //
-  for (int a = 0; a < 3; a++) {
-    dKhat_d(a) = Dx<2>(a, idx, z4c.vKhat, m, k, j, i);
-    dTheta_d(a) = Dx<2>(a, idx, z4c.vTheta, m, k, j, i);
-  }
-  for (int a = 0; a < 3; a++) {
-    for (int b = 0; b < 3; b++) {
-      dGam_du(b,a) = Dx<2>(b, idx, z4c.vGam_u, m, a, k, j, i);
-    }
-  }
-  for (int a = 0; a < 3; a++) {
-    for (int b = a; b < 3; b++) {
-      for (int c = 0; c < 3; c++) {
-        dA_ddd(c, a, b) = Dx<2>(c, idx, z4c.vA_dd, m, a, b, k, j, i);
-      }
-    }
-  }
-
-  // -------------------------------------------------------------------------------------
-  // Compute psuedo-radial vector
-  //
-  Real &x1min = size.d_view(m).x1min;
-  Real &x1max = size.d_view(m).x1max;
-  Real &x2min = size.d_view(m).x2min;
-  Real &x2max = size.d_view(m).x2max;
-  Real &x3min = size.d_view(m).x3min;
-  Real &x3max = size.d_view(m).x3max;
-
-  Real x1v = CellCenterX(i-indcs.is, indcs.nx1, x1min, x1max);
-  Real x2v = CellCenterX(j-indcs.js, indcs.nx2, x2min, x2max);
-  Real x3v = CellCenterX(k-indcs.ks, indcs.nx3, x3min, x3max);
-
-  Real r = sqrt(SQR(x1v) + SQR(x2v) + SQR(x3v));
-  s_u(0) = x1v/r;
-  s_u(1) = x2v/r;
-  s_u(2) = x3v/r;
-
-  // -------------------------------------------------------------------------------------
-  // Boundary RHS for scalars
-  //
-  rhs.vTheta(m,k,j,i) = - z4c.vTheta(m,k,j,i)/r;
-  rhs.vKhat(m,k,j,i) = - sqrt(2.) * z4c.vKhat(m,k,j,i)/r;
-  for (int a = 0; a < 3; a++) {
-    rhs.vTheta(m,k,j,i) -= s_u(a) * dTheta_d(a);
-    rhs.vKhat(m,k,j,i) -= sqrt(2.) * s_u(a) * dKhat_d(a);
-  }
-
-  // -------------------------------------------------------------------------------------
-  // Boundary RHS for Gamma
-  //
-  for (int a = 0; a < 3; a++) {
-    rhs.vGam_u(m,a,k,j,i) = - z4c.vGam_u(m, a, k, j, i)/r;
-    for (int b = 0; b < 3; b++) {
-      rhs.vGam_u(m,a,k,j,i) -= s_u(b) * dGam_du(b,a);
-    }
-  }
-
-  // -------------------------------------------------------------------------------------
-  // Boundary RHS for A_ab
-  //
-  for (int a = 0; a < 3; a++) {
-    for (int b = a; b < 3; b++) {
-      rhs.vA_dd(m,a,b,k,j,i) = - z4c.vA_dd(m,a,b,k,j,i)/r;
-      for (int c = 0; c < 3; c++) {
-        rhs.vA_dd(m,a,b,k,j,i) -= s_u(c) * dA_ddd(c,a,b);
+//! \fn void Z4c::SetSommerfeldFaces
+//! \brief Stores for each MeshBlock a mask of the faces (bit f for BoundaryFace f) on
+//! which the Sommerfeld condition is applied, used when it is applied in the RHS kernel.
+//! Rebuilt only when the Mesh has changed.
+void Z4c::SetSommerfeldFaces() {
+  if (sbc_nregrid == pmy_pack->pmesh->nregrid) return;
+  auto &mb_bcs = pmy_pack->pmb->mb_bcs;
+  int nmb = pmy_pack->nmb_thispack;
+  if (sbc_faces.extent_int(0) < nmb) {Kokkos::realloc(sbc_faces, nmb);}
+  for (int m=0; m<nmb; ++m) {
+    int faces = 0;
+    for (int f=0; f<6; ++f) {
+      BoundaryFlag bc = mb_bcs.h_view(m,f);
+      if (bc == BoundaryFlag::outflow || bc == BoundaryFlag::diode ||
+          (bc == BoundaryFlag::user && opt.user_Sbc)) {
+        faces |= (1 << f);
       }
     }
+    sbc_faces.h_view(m) = faces;
   }
+  sbc_faces.template modify<HostMemSpace>();
+  sbc_faces.template sync<DevExeSpace>();
+  sbc_nregrid = pmy_pack->pmesh->nregrid;
 }
 
-
 //---------------------------------------------------------------------------------------
 //! \fn TaskStatus Z4c::Z4cBoundaryRHS
 //! \brief placeholder for the Sommerfield Boundary conditions for z4c
+//! With opt.fused_diss (and not opt.staged_rhs) the condition is applied by the RHS
+//! kernel during the time integration, so this is only needed on initialization.
 TaskStatus Z4c::Z4cBoundaryRHS(Driver *pdriver, int stage) {
+  if (sbc_in_rhs && stage > 0) return TaskStatus::complete;
+
   auto &pm = pmy_pack->pmesh;
   auto &mb_bcs = pmy_pack->pmb->mb_bcs;
   auto &indcs = pmy_pack->pmesh->mb_indcs;
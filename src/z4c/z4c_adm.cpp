@@ -20,6 +20,7 @@
 #include "coordinates/adm.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/tmunu.hpp"
+#include "dyn_grmhd/dyn_grmhd.hpp"
 #include "coordinates/cell_locations.hpp"
 
 namespace z4c {
@@ -232,6 +233,23 @@ void Z4c::Z4cToADM(MeshBlockPack *pmbp) {
         (1./3.) * (z4c.vKhat(m,k,j,i) + 2.*z4c.vTheta(m,k,j,i)) * adm.g_dd(m,a,b,k,j,i);
     }
   });
+  pmbp->pz4c->adm_current = true;
+  pmbp->pz4c->adm_nregrid = pmbp->pmesh->nregrid;
+  if (pmbp->pdyngr != nullptr) {
+    pmbp->pdyngr->face_metric_current = false;
+  }
+  return;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::UpdateADM()
+//! \brief Compute ADM variables from Z4c variables, unless they are already current.
+//! Must be called before ADM variables are read.
+
+void Z4c::UpdateADM() {
+  if (!(adm_current) || adm_nregrid != pmy_pack->pmesh->nregrid) {
+    Z4cToADM(pmy_pack);
+  }
   return;
 }
 //----------------------------------------------------------------------------------------
@@ -268,6 +286,12 @@ void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
   Tmunu::Tmunu_vars tmunu;
   if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
 
+  // store derivatives of g and K for Z4cWeyl() if Weyl scalars are computed this cycle
+  Z4c *pz4c = pmbp->pz4c;
+  bool store_drv = pz4c->share_adm_drv &&
+      (pz4c->last_output_time == static_cast<float>(pmbp->pmesh->time));
+  auto &adm_drv = pz4c->adm_drv;
+
   Kokkos::deep_copy(u_con, 0.);
   auto &con = pmbp->pz4c->con;
   par_for("ADM constraints loop",DevExeSpace(),
@@ -326,6 +350,19 @@ void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
       }
     }
 
+    if (store_drv) {
+      for(int c = 0; c < 3; ++c)
+      for(int a = 0; a < 3; ++a)
+      for(int b = a; b < 3; ++b) {
+        adm_drv(m,IADM_DG+6*c+SymIdx(a,b),k-ks,j-js,i-is) = dg_ddd(c,a,b);
+        adm_drv(m,IADM_DK+6*c+SymIdx(a,b),k-ks,j-js,i-is) = dK_ddd(c,a,b);
+        for(int d = c; d < 3; ++d) {
+          adm_drv(m,IADM_DDG+6*SymIdx(a,b)+SymIdx(c,d),k-ks,j-js,i-is) =
+              ddg_dddd(c,d,a,b);
+        }
+      }
+    }
+
     // -----------------------------------------------------------------------------------
     // inverse metric
     //
@@ -515,6 +552,7 @@ void Z4c::ADMConstraints(MeshBlockPack *pmbp) {
     con.C(m,k,j,i) = SQR(con.H(m,k,j,i)) + con.M(m,k,j,i) +
                      SQR(z4c.vTheta(m,k,j,i)) + 4.0*con.Z(m,k,j,i);
 });
+  pz4c->adm_drv_ready = store_drv;
 }
 template void Z4c::ADMConstraints<2>(MeshBlockPack *pmbp);
 template void Z4c::ADMConstraints<3>(MeshBlockPack *pmbp);
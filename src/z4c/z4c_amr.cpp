@@ -5,10 +5,13 @@
 //========================================================================================
 
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "z4c/z4c_amr.hpp"
@@ -17,6 +20,7 @@
 #include "mesh/mesh.hpp"
 #include "parameter_input.hpp"
 #include "z4c/compact_object_tracker.hpp"
+#include "z4c/horizon_finder.hpp"
 #include "z4c/z4c.hpp"
 
 #define SQ(X) ((X)*(X))
@@ -36,6 +40,16 @@ Z4c_AMR::Z4c_AMR(ParameterInput *pin) {
   } else if (ref_method == "dchi") {
     method = dChi;
     dchi_thresh = pin->GetOrAddReal("z4c_amr", "dchi_max", 0.1);
+  } else if (ref_method == "moving_box") {
+    method = MovingBox;
+    box_width = pin->GetOrAddInteger("z4c_amr", "box_width", 1);
+    if (box_width < 1) {
+      std::cout << "### FATAL ERROR in " << __FILE__ << " at line "
+                << __LINE__ << std::endl;
+      std::cout << "<z4c_amr>/box_width must be at least 1 for proper nesting of "
+                << "moving boxes" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
   } else {
     std::cout << "### FATAL ERROR in " << __FILE__ << " at line "
               << __LINE__ << std::endl;
@@ -55,220 +69,273 @@ Z4c_AMR::Z4c_AMR(ParameterInput *pin) {
   }
 }
 
-// 1: refines, -1: de-refines, 0: does nothing
-void Z4c_AMR::Refine(MeshBlockPack *pmy_pack) {
-  if (method == Tracker) {
-    RefineTracker(pmy_pack);
-  } else if (method == Chi) {
-    RefineChiMin(pmy_pack);
-  } else if (method == dChi) {
-    RefineDchiMax(pmy_pack);
-  }
-  RefineRadii(pmy_pack);
-}
-
-// refine region within a certain distance from each compact object
-void Z4c_AMR::RefineTracker(MeshBlockPack *pmbp) {
+// Sets refine_flag of MBs on this rank, 1: refines, -1: de-refines, 0: does nothing.
+// Called (as user refinement function) after the generic criteria kernel, whose flags
+// on the device are combined with the Z4c criteria in one team kernel per MeshBlock:
+// the trackers (with method tracker) overwrite the flag, min{chi} or max{dchi} refine
+// or derefine beyond their thresholds, and the radii and horizons enforce a minimum
+// level.  Positions and radii of all spheres are computed on the host and passed to the
+// kernel, which then only needs the MeshBlock bounds and levels already on the device.
+void Z4c_AMR::Refine(MeshBlockPack *pmbp) {
   Mesh *pmesh       = pmbp->pmesh;
   auto &refine_flag = pmesh->pmr->refine_flag;
-  auto &size        = pmbp->pmb->mb_size;
   int nmb           = pmbp->nmb_thispack;
   int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
+  auto flag_range = std::make_pair(mbs, mbs + nmb);
+  auto d_flag = Kokkos::subview(refine_flag.d_view, flag_range);
+  auto h_flag = Kokkos::subview(refine_flag.h_view, flag_range);
 
-  std::vector<int> flag;
-  flag.reserve(pmbp->pz4c->ptracker.size());
+  // flags of moving boxes are computed on the host from logical locations
+  if (method == MovingBox) {
+    RefineMovingBox(pmbp);
+    Kokkos::deep_copy(d_flag, h_flag);
+  }
 
-  for (int m = 0; m < nmb; ++m) {
-    // current refinement level
-    int level = pmesh->lloc_eachmb[m + mbs].level - pmesh->root_level;
+  // collect trackers, radii and horizons
+  std::vector<RefineSphere> sph;
+  if (method == Tracker) {
+    for (auto & pt : pmbp->pz4c->ptracker) {
+      sph.push_back({pt.GetPos(0), pt.GetPos(1), pt.GetPos(2), pt.GetRadius(),
+                     pt.GetReflevel(), true, false});
+    }
+  }
+  for (int ir = 0; ir < static_cast<int>(radius.size()); ++ir) {
+    sph.push_back({0.0, 0.0, 0.0, radius[ir], reflevel[ir], false, false});
+  }
+  // minimum refinement level within ref_factor times the radius of each horizon
+  for (auto & ph : pmbp->pz4c->phorizons) {
+    if (!(ph.found) || ph.reflevel < 0) continue;
+    sph.push_back({ph.center[0], ph.center[1], ph.center[2], ph.ref_factor*ph.rmax,
+                   ph.reflevel, false, true});
+  }
+  int nsph = static_cast<int>(sph.size());
+  bool use_chi = (method == Chi), use_dchi = (method == dChi);
 
-    // extract MeshBlock bounds
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
+  if (nsph > 0 || use_chi || use_dchi) {
+    if (spheres_.extent_int(0) < nsph) {Kokkos::realloc(spheres_, nsph);}
+    for (int n = 0; n < nsph; ++n) {spheres_.h_view(n) = sph[n];}
+    spheres_.template modify<HostMemSpace>();
+    spheres_.template sync<DevExeSpace>();
 
-    flag.clear();
-    for (auto & pt : pmbp->pz4c->ptracker) {
-      Real d2[8] = {
-        SQ(x1min - pt.GetPos(0)) + SQ(x2min - pt.GetPos(1)) + SQ(x3min - pt.GetPos(2)),
-        SQ(x1max - pt.GetPos(0)) + SQ(x2min - pt.GetPos(1)) + SQ(x3min - pt.GetPos(2)),
-        SQ(x1min - pt.GetPos(0)) + SQ(x2max - pt.GetPos(1)) + SQ(x3min - pt.GetPos(2)),
-        SQ(x1max - pt.GetPos(0)) + SQ(x2max - pt.GetPos(1)) + SQ(x3min - pt.GetPos(2)),
-        SQ(x1min - pt.GetPos(0)) + SQ(x2min - pt.GetPos(1)) + SQ(x3max - pt.GetPos(2)),
-        SQ(x1max - pt.GetPos(0)) + SQ(x2min - pt.GetPos(1)) + SQ(x3max - pt.GetPos(2)),
-        SQ(x1min - pt.GetPos(0)) + SQ(x2max - pt.GetPos(1)) + SQ(x3max - pt.GetPos(2)),
-        SQ(x1max - pt.GetPos(0)) + SQ(x2max - pt.GetPos(1)) + SQ(x3max - pt.GetPos(2)),
-      };
-      Real dmin2 = *std::min_element(&d2[0], &d2[8]);
-      bool iscontained =
-        (pt.GetPos(0) >= x1min && pt.GetPos(0) <= x1max) &&
-        (pt.GetPos(1) >= x2min && pt.GetPos(1) <= x2max) &&
-        (pt.GetPos(2) >= x3min && pt.GetPos(2) <= x3max);
+    auto &indcs = pmesh->mb_indcs;
+    int &is = indcs.is, nx1 = indcs.nx1;
+    int &js = indcs.js, nx2 = indcs.nx2;
+    int &ks = indcs.ks, nx3 = indcs.nx3;
+    const int nkji = nx3 * nx2 * nx1;
+    const int nji  = nx2 * nx1;
+    auto &u0       = pmbp->pz4c->u0;
+    int I_Z4C_CHI  = pmbp->pz4c->I_Z4C_CHI;
+    auto &size     = pmbp->pmb->mb_size;
+    auto &mblev    = pmbp->pmb->mb_lev;
+    int root_level = pmesh->root_level;
+    auto &sph_     = spheres_;
+    // note: we need this to prevent capture by this in the lambda expr.
+    Real chi_thresh  = (use_chi)? this->chi_thresh : 0.0;
+    Real dchi_thresh = (use_dchi)? this->dchi_thresh : 0.0;
+    bool set_tracker = (method == Tracker) && !(pmbp->pz4c->ptracker.empty());
+
+    par_for_outer(
+      "Z4c_AMR::Refine", DevExeSpace(), 0, 0, 0, (nmb - 1),
+      KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
+        int flag = refine_flag.d_view(m + mbs);
+        int level = mblev.d_view(m) - root_level;
 
-      if (dmin2 < SQ(pt.GetRadius()) || iscontained) {
-        if (pt.GetReflevel() < 0 || level < pt.GetReflevel()) {
-          flag.push_back(1);
-        } else if (level == pt.GetReflevel()) {
-          flag.push_back(0);
-        } else {
-          flag.push_back(-1);
+        // min{chi} or max{dchi} over the MeshBlock
+        if (use_chi) {
+          Real team_dmin;
+          Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange(tmember, nkji),
+            [=](const int idx, Real &dmin) {
+              int k = (idx) / nji;
+              int j = (idx - k * nji) / nx1;
+              int i = (idx - k * nji - j * nx1) + is;
+              j += js;
+              k += ks;
+              dmin = fmin(u0(m, I_Z4C_CHI, k, j, i), dmin);
+            },
+            Kokkos::Min<Real>(team_dmin));
+          if (team_dmin < chi_thresh) {flag = 1;}
+          if (team_dmin > 1.25 * chi_thresh) {flag = -1;}
+        } else if (use_dchi) {
+          Real team_dmax;
+          Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange(tmember, nkji),
+            [=](const int idx, Real &dmax) {
+              int k = (idx) / nji;
+              int j = (idx - k * nji) / nx1;
+              int i = (idx - k * nji - j * nx1) + is;
+              j += js;
+              k += ks;
+              Real d2 = SQR(u0(m,I_Z4C_CHI,k,j,i+1) - u0(m,I_Z4C_CHI,k,j,i-1));
+              d2 += SQR(u0(m,I_Z4C_CHI,k,j+1,i) - u0(m,I_Z4C_CHI,k,j-1,i));
+              d2 += SQR(u0(m,I_Z4C_CHI,k+1,j,i) - u0(m,I_Z4C_CHI,k-1,j,i));
+              dmax = fmax((sqrt(d2)), dmax);
+            },
+            Kokkos::Max<Real>(team_dmax));
+          if (team_dmax > dchi_thresh) {flag = 1;}
+          if (team_dmax < 0.5 * dchi_thresh) {flag = -1;}
         }
-      } else {
-        flag.push_back(-1);
-      }
-    }
-    refine_flag.h_view(m + mbs) = *std::max_element(flag.begin(), flag.end());
-  }
 
-  // sync host and device
-  refine_flag.template modify<HostMemSpace>();
-  refine_flag.template sync<DevExeSpace>();
-}
+        // squared distances from each sphere center to the nearest corner of the
+        // MeshBlock (separable in each direction), and to the MeshBlock itself
+        Real xmin[3] = {size.d_view(m).x1min, size.d_view(m).x2min, size.d_view(m).x3min};
+        Real xmax[3] = {size.d_view(m).x1max, size.d_view(m).x2max, size.d_view(m).x3max};
+        auto dist2 = [&](const RefineSphere &s, Real &dc2, Real &db2) {
+          Real c[3] = {s.x1, s.x2, s.x3};
+          dc2 = 0.0, db2 = 0.0;
+          for (int d = 0; d < 3; ++d) {
+            dc2 += fmin(SQ(xmin[d] - c[d]), SQ(xmax[d] - c[d]));
+            db2 += SQ(fmax(fmax(xmin[d] - c[d], c[d] - xmax[d]), 0.0));
+          }
+        };
 
-// refine based on min{chi}
-void Z4c_AMR::RefineChiMin(MeshBlockPack *pmbp) {
-  Mesh *pmesh       = pmbp->pmesh;
-  int nmb           = pmbp->nmb_thispack;
-  int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
-  auto &refine_flag = pmesh->pmr->refine_flag;
-  auto &indcs       = pmesh->mb_indcs;
-  int &is = indcs.is, nx1 = indcs.nx1;
-  int &js = indcs.js, nx2 = indcs.nx2;
-  int &ks = indcs.ks, nx3 = indcs.nx3;
-  const int nkji = nx3 * nx2 * nx1;
-  const int nji  = nx2 * nx1;
-  auto &u0       = pmbp->pz4c->u0;
-  int I_Z4C_CHI  = pmbp->pz4c->I_Z4C_CHI;
-  // note: we need this to prevent capture by this in the lambda expr.
-  auto chi_thresh = this->chi_thresh;
+        // trackers overwrite flag with maximum over trackers
+        if (set_tracker) {
+          flag = -1;
+          for (int n = 0; n < nsph; ++n) {
+            const RefineSphere &s = sph_.d_view(n);
+            if (!(s.tracker)) continue;
+            Real dc2, db2;
+            dist2(s, dc2, db2);
+            // tracker inside MeshBlock, or a corner inside its sphere
+            if (dc2 < SQ(s.rad) || db2 == 0.0) {
+              if (s.reflevel < 0 || level < s.reflevel) {
+                flag = 1;
+              } else if (level == s.reflevel) {
+                flag = (flag > 0)? flag : 0;
+              }
+            }
+          }
+        }
 
-  par_for_outer(
-    "Z4c_AMR::ChiMin", DevExeSpace(), 0, 0, 0, (nmb - 1),
-    KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
-      Real team_dmin;
-      Kokkos::parallel_reduce(
-        Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real &dmin) {
-          int k = (idx) / nji;
-          int j = (idx - k * nji) / nx1;
-          int i = (idx - k * nji - j * nx1) + is;
-          j += js;
-          k += ks;
-          dmin = fmin(u0(m, I_Z4C_CHI, k, j, i), dmin);
-        },
-        Kokkos::Min<Real>(team_dmin));
+        // minimum refinement level within radii and horizons
+        for (int n = 0; n < nsph; ++n) {
+          const RefineSphere &s = sph_.d_view(n);
+          if (s.tracker) continue;
+          Real dc2, db2;
+          dist2(s, dc2, db2);
+          if (((s.box_dist)? db2 : dc2) < SQ(s.rad)) {
+            if (level < s.reflevel) {
+              flag = 1;
+            } else if (level == s.reflevel && flag == -1) {
+              flag = 0;
+            }
+          }
+        }
+        refine_flag.d_view(m + mbs) = flag;
+      });
+  }
 
-      if (team_dmin < chi_thresh) {
-        refine_flag.d_view(m + mbs) = 1;
-      }
-      if (team_dmin > 1.25 * chi_thresh) {
-        refine_flag.d_view(m + mbs) = -1;
-      }
-    });
+  // copy flags of MBs on this rank to host, where they are checked by CheckForRefinement
+  Kokkos::deep_copy(h_flag, d_flag);
 
-  // sync host and device
-  refine_flag.template modify<DevExeSpace>();
-  refine_flag.template sync<HostMemSpace>();
+  // count MBs still to be changed, to find when mesh matches the moving boxes
+  if (method == MovingBox) {
+    nbox_flags_ = 0;
+    for (int m = 0; m < nmb; ++m) {
+      if (refine_flag.h_view(m + mbs) != 0) nbox_flags_++;
+    }
+  }
 }
 
-// refine based on max{dchi}
-void Z4c_AMR::RefineDchiMax(MeshBlockPack *pmbp) {
-  Mesh *pmesh       = pmbp->pmesh;
-  int nmb           = pmbp->nmb_thispack;
-  int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
-  auto &refine_flag = pmesh->pmr->refine_flag;
-  auto &indcs       = pmesh->mb_indcs;
-  int &is = indcs.is, nx1 = indcs.nx1;
-  int &js = indcs.js, nx2 = indcs.nx2;
-  int &ks = indcs.ks, nx3 = indcs.nx3;
-  const int nkji = nx3 * nx2 * nx1;
-  const int nji  = nx2 * nx1;
-  auto &u0       = pmbp->pz4c->u0;
-  int I_Z4C_CHI  = pmbp->pz4c->I_Z4C_CHI;
-  // note: we need this to prevent capture by this in the lambda expr.
-  auto dchi_thresh = this->dchi_thresh;
+//----------------------------------------------------------------------------------------
+// Moving boxes: at each physical level L below the refinement level of a tracker, the
+// MeshBlocks within box_width blocks (in each direction) of the block containing the
+// tracker are refined.  Nested boxes therefore only move when a tracker crosses a
+// MeshBlock boundary, and flags are computed from logical locations without kernels.
 
-  par_for_outer(
-    "Z4c_AMR::ChiMin", DevExeSpace(), 0, 0, 0, (nmb - 1),
-    KOKKOS_LAMBDA(TeamMember_t tmember, const int m) {
-      Real team_dmax;
-      Kokkos::parallel_reduce(
-        Kokkos::TeamThreadRange(tmember, nkji),
-        [=](const int idx, Real &dmax) {
-          int k = (idx) / nji;
-          int j = (idx - k * nji) / nx1;
-          int i = (idx - k * nji - j * nx1) + is;
-          j += js;
-          k += ks;
-          Real d2 = SQR(u0(m,I_Z4C_CHI,k,j,i+1) - u0(m,I_Z4C_CHI,k,j,i-1));
-          d2 += SQR(u0(m,I_Z4C_CHI,k,j+1,i) - u0(m,I_Z4C_CHI,k,j-1,i));
-          d2 += SQR(u0(m,I_Z4C_CHI,k+1,j,i) - u0(m,I_Z4C_CHI,k-1,j,i));
-          dmax = fmax((sqrt(d2)), dmax);
-        },
-        Kokkos::Max<Real>(team_dmax));
+namespace {
+// index of MeshBlock at physical level L containing position x in direction d
+int BoxIndex(Mesh *pmesh, int d, int level, Real x) {
+  Real xmin = (d == 0)? pmesh->mesh_size.x1min :
+              ((d == 1)? pmesh->mesh_size.x2min : pmesh->mesh_size.x3min);
+  Real xmax = (d == 0)? pmesh->mesh_size.x1max :
+              ((d == 1)? pmesh->mesh_size.x2max : pmesh->mesh_size.x3max);
+  int nroot = (d == 0)? pmesh->nmb_rootx1 :
+              ((d == 1)? pmesh->nmb_rootx2 : pmesh->nmb_rootx3);
+  int nblock = nroot << level;
+  int idx = static_cast<int>(std::floor((x - xmin)/(xmax - xmin)*nblock));
+  return std::min(std::max(idx, 0), nblock - 1);
+}
 
-      if (team_dmax > dchi_thresh) {
-        refine_flag.d_view(m + mbs) = 1;
-      }
-      if (team_dmax < 0.5 * dchi_thresh) {
-        refine_flag.d_view(m + mbs) = -1;
-      }
-    });
+// level up to which boxes around a tracker are refined
+int BoxLevel(Mesh *pmesh, const CompactObjectTracker &pt) {
+  int maxlev = pmesh->max_level - pmesh->root_level;
+  return (pt.GetReflevel() < 0)? maxlev : std::min(pt.GetReflevel(), maxlev);
+}
+} // namespace
 
-  // sync host and device
-  refine_flag.template modify<DevExeSpace>();
-  refine_flag.template sync<HostMemSpace>();
+// true if MeshBlock at physical level L and logical location lx1,lx2,lx3 is in the box
+// around position pos at that level
+bool Z4c_AMR::BoxContains(Mesh *pmesh, int level, int lx1, int lx2, int lx3,
+                          const Real *pos) {
+  int lx[3] = {lx1, lx2, lx3};
+  int ndim = (pmesh->three_d)? 3 : ((pmesh->two_d)? 2 : 1);
+  for (int d = 0; d < ndim; ++d) {
+    if (std::abs(lx[d] - BoxIndex(pmesh, d, level, pos[d])) > box_width) return false;
+  }
+  return true;
 }
 
-// Enforce some minimum resolution within a certain spherical region
-void Z4c_AMR::RefineRadii(MeshBlockPack *pmbp) {
+// refine nested boxes around each compact object.  MBs are derefined when their parent
+// is outside all boxes, so siblings are always flagged together.  Flags are only set on
+// the host, Refine() copies them to the device.
+void Z4c_AMR::RefineMovingBox(MeshBlockPack *pmbp) {
   Mesh *pmesh       = pmbp->pmesh;
   auto &refine_flag = pmesh->pmr->refine_flag;
-  auto &size        = pmbp->pmb->mb_size;
   int nmb           = pmbp->nmb_thispack;
   int mbs           = pmesh->gids_eachrank[global_variable::my_rank];
 
   for (int m = 0; m < nmb; ++m) {
-    // current refinement level
-    int level = pmesh->lloc_eachmb[m + mbs].level - pmesh->root_level;
-
-    // extract MeshBlock bounds
-    Real &x1min = size.h_view(m).x1min;
-    Real &x1max = size.h_view(m).x1max;
-    Real &x2min = size.h_view(m).x2min;
-    Real &x2max = size.h_view(m).x2max;
-    Real &x3min = size.h_view(m).x3min;
-    Real &x3max = size.h_view(m).x3max;
-
-    Real r2[8] = {
-      SQ(x1min) + SQ(x2min) + SQ(x3min),
-      SQ(x1max) + SQ(x2min) + SQ(x3min),
-      SQ(x1min) + SQ(x2max) + SQ(x3min),
-      SQ(x1max) + SQ(x2max) + SQ(x3min),
-      SQ(x1min) + SQ(x2min) + SQ(x3max),
-      SQ(x1max) + SQ(x2min) + SQ(x3max),
-      SQ(x1min) + SQ(x2max) + SQ(x3max),
-      SQ(x1max) + SQ(x2max) + SQ(x3max),
-    };
-    Real rmin2 = *std::min_element(&r2[0], &r2[8]);
-
-    for (int ir = 0; ir < radius.size(); ++ir) {
-      if (rmin2 < SQ(radius[ir])) {
-        if (level < reflevel[ir]) {
-          refine_flag.h_view(m + mbs) = 1;
-        } else if (level == reflevel[ir] && refine_flag.h_view(m + mbs) == -1) {
-          refine_flag.h_view(m + mbs) = 0;
-        }
+    LogicalLocation &lloc = pmesh->lloc_eachmb[m + mbs];
+    int level = lloc.level - pmesh->root_level;
+    int flag = (level > 0)? -1 : 0;
+    for (auto & pt : pmbp->pz4c->ptracker) {
+      int tlev = BoxLevel(pmesh, pt);
+      Real pos[3] = {pt.GetPos(0), pt.GetPos(1), pt.GetPos(2)};
+      if (level < tlev && BoxContains(pmesh, level, lloc.lx1, lloc.lx2, lloc.lx3, pos)) {
+        flag = 1;
+      } else if (level > 0 && level <= tlev &&
+                 BoxContains(pmesh, level - 1, lloc.lx1 >> 1, lloc.lx2 >> 1,
+                             lloc.lx3 >> 1, pos)) {
+        flag = std::max(flag, 0);
       }
     }
+    refine_flag.h_view(m + mbs) = flag;
+  }
+}
+
+// Called on cycles at which refinement is checked.  Boxes only move when a tracker
+// crosses a MeshBlock boundary on the finest level of its boxes (which are also the
+// boundaries on all coarser levels).  Positions of trackers are the same on all ranks,
+// so all ranks agree without communication.
+bool Z4c_AMR::BoxCheckNeeded(Mesh *pmesh) {
+  std::vector<int> index;
+  for (auto & pt : pmesh->pmb_pack->pz4c->ptracker) {
+    int tlev = BoxLevel(pmesh, pt);
+    for (int d = 0; d < 3; ++d) {
+      index.push_back((tlev > 0)? BoxIndex(pmesh, d, tlev - 1, pt.GetPos(d)) : 0);
+    }
   }
+  if (index != box_index_) {
+    box_index_ = index;
+    box_pending_ = true;
+  }
+  return box_pending_;
+}
 
-  // sync host and device
-  refine_flag.template modify<HostMemSpace>();
-  refine_flag.template sync<DevExeSpace>();
+// Checks continue until mesh matches boxes, since (de)refinement of some MBs may be
+// deferred by <mesh_refinement>/refinement_interval or by proper nesting
+void Z4c_AMR::BoxCheckDone(bool changed) {
+  if (changed) {
+    box_pending_ = true;
+    return;
+  }
+  int nflag = nbox_flags_;
+#if MPI_PARALLEL_ENABLED
+  MPI_Allreduce(MPI_IN_PLACE, &nflag, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  box_pending_ = (nflag > 0);
 }
 
 } // namespace z4c
@@ -13,6 +13,7 @@
 #include "athena.hpp"
 
 class ParameterInput;
+class Mesh;
 class MeshBlockPack;
 
 namespace z4c {
@@ -21,17 +22,22 @@ class Z4c;
 //! \class Z4c_AMR
 //  \brief managing AMR for Z4c simulations
 class Z4c_AMR {
-  enum RefinementMethod { Trivial, Tracker, Chi, dChi };
+  enum RefinementMethod { Trivial, Tracker, Chi, dChi, MovingBox };
 
  public:
   explicit Z4c_AMR(ParameterInput *pin);
   ~Z4c_AMR() noexcept = default;
 
-  void Refine(MeshBlockPack *pmbp);             // call the AMR method
-  void RefineTracker(MeshBlockPack *pmbp);      // Refine based on the trackers
-  void RefineChiMin(MeshBlockPack *pmbp);       // Refine based on min{chi}
-  void RefineDchiMax(MeshBlockPack *pmbp);      // Refine based on max{dchi}
-  void RefineRadii(MeshBlockPack *pmbp);        // Refine based on the radii
+  // Evaluates all criteria (trackers, min{chi}, max{dchi}, radii and horizons) in one
+  // kernel over MeshBlocks, which writes refine_flag on the device
+  void Refine(MeshBlockPack *pmbp);
+  void RefineMovingBox(MeshBlockPack *pmbp);    // Refine boxes around the trackers
+
+  // With moving boxes the mesh only needs to change after a tracker crosses a MeshBlock
+  // boundary, so MeshRefinement skips checks of the refinement criteria otherwise
+  bool MovingBoxes() const {return method == MovingBox;}
+  bool BoxCheckNeeded(Mesh *pmesh);   // true if boxes moved since last complete check
+  void BoxCheckDone(bool changed);    // call after check, with true if mesh changed
 
   RefinementMethod method;
 
@@ -41,6 +47,23 @@ class Z4c_AMR {
 
   Real chi_thresh;     // chi threshold for chi refinement method
   Real dchi_thresh;    // dchi threshold for dchi refinement method
+  int box_width;       // MeshBlocks refined on each side of tracker with moving boxes
+
+ private:
+  // sphere about a tracker, horizon or the origin, copied to the device in Refine()
+  struct RefineSphere {
+    Real x1, x2, x3;    // center
+    Real rad;
+    int reflevel;       // refinement level required inside sphere (-1: max level)
+    bool tracker;       // tracker: sets flag, else only enforces minimum level
+    bool box_dist;      // measure distance to MeshBlock, else to its nearest corner
+  };
+  DualArray1D<RefineSphere> spheres_;
+
+  bool BoxContains(Mesh *pmesh, int level, int lx1, int lx2, int lx3, const Real *pos);
+  std::vector<int> box_index_;  // MeshBlock containing each tracker on finest box level
+  bool box_pending_ = true;     // true until a check finds the mesh matches the boxes
+  int nbox_flags_ = 0;          // # of MBs on this rank flagged at last check
 };
 
 } // namespace z4c
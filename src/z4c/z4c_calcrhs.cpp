@@ -18,6 +18,7 @@
 #include "coordinates/adm.hpp"
 #include "z4c/z4c.hpp"
 #include "z4c/tmunu.hpp"
+#include "z4c/z4c_Sbc.hpp"
 #include "coordinates/cell_locations.hpp"
 
 namespace z4c {
@@ -27,133 +28,306 @@ template <int NGHOST>
 //! \brief compute rhs of the z4c equations
 TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  auto &size = pmy_pack->pmb->mb_size;
   int &is = indcs.is; int &ie = indcs.ie;
   int &js = indcs.js; int &je = indcs.je;
   int &ks = indcs.ks; int &ke = indcs.ke;
 
+  if (rhs_interior_ready) {
+    // RHS of cells further than NGHOST from the faces of the MeshBlock was computed by
+    // CalcRHSInterior() in the previous stage, so only the six slabs next to the faces
+    // (whose stencils reach the ghost zones) remain
+    int isi = is + NGHOST, iei = ie - NGHOST;
+    int jsi = js + NGHOST, jei = je - NGHOST;
+    int ksi = ks + NGHOST, kei = ke - NGHOST;
+    CalcRHSRegion<NGHOST>(is, isi-1, js, je, ks, ke);
+    CalcRHSRegion<NGHOST>(iei+1, ie, js, je, ks, ke);
+    CalcRHSRegion<NGHOST>(isi, iei, js, jsi-1, ks, ke);
+    CalcRHSRegion<NGHOST>(isi, iei, jei+1, je, ks, ke);
+    CalcRHSRegion<NGHOST>(isi, iei, jsi, jei, ks, ksi-1);
+    CalcRHSRegion<NGHOST>(isi, iei, jsi, jei, kei+1, ke);
+    rhs_interior_ready = false;
+  } else {
+    CalcRHSRegion<NGHOST>(is, ie, js, je, ks, ke);
+  }
+
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::CalcRHSInterior(Driver *pdriver, int stage)
+//! \brief with <z4c>/overlap_rhs, computes the rhs of the next stage in cells further
+//! than NGHOST from the faces of the MeshBlock.  u0 in active cells does not change
+//! after it is sent (in vacuum), and the stencils of these cells do not reach the ghost
+//! zones, so this overlaps with the communication of u0.  The last stage is excluded,
+//! since the Mesh may be refined or outputs made before the next step.
+
+template <int NGHOST>
+TaskStatus Z4c::CalcRHSInterior(Driver *pdriver, int stage) {
+  if (opt.overlap_rhs && stage < pdriver->nexp_stages) {
+    auto &indcs = pmy_pack->pmesh->mb_indcs;
+    CalcRHSRegion<NGHOST>(indcs.is + NGHOST, indcs.ie - NGHOST,
+                          indcs.js + NGHOST, indcs.je - NGHOST,
+                          indcs.ks + NGHOST, indcs.ke - NGHOST);
+    rhs_interior_ready = true;
+  }
+  return TaskStatus::complete;
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::CalcRHSRegion()
+//! \brief computes the rhs of the z4c equations (including dissipation) in the cells
+//! [il,iu]x[jl,ju]x[kl,ku] of every MeshBlock.  The staged RHS is always computed over
+//! all active cells.
+
+template <int NGHOST>
+void Z4c::CalcRHSRegion(const int il, const int iu, const int jl, const int ju,
+                        const int kl, const int ku) {
+  auto &size = pmy_pack->pmb->mb_size;
+  int nmb = pmy_pack->nmb_thispack;
+  auto &opt = pmy_pack->pz4c->opt;
+
+  // Kreiss-Oliger dissipation, added in the RHS kernel with opt.fused_diss
+  Real &diss = pmy_pack->pz4c->diss;
+  auto &u0 = pmy_pack->pz4c->u0;
+  auto &u_rhs = pmy_pack->pz4c->u_rhs;
+  bool fused_diss = opt.fused_diss;
+
+  // ===================================================================================
+  // Main RHS calculation
+  //
+  if (opt.staged_rhs) {
+    CalcRHSStaged<NGHOST>();
+  } else {
+    if (sbc_in_rhs) {SetSommerfeldFaces();}
+    // MeshBlocks on physical levels <= opt.rhs_fp32_level (e.g. in the wave zone) have
+    // their RHS computed in single precision, all others in Real
+    auto &mb_lev = pmy_pack->pmb->mb_lev;
+    int root_level = pmy_pack->pmesh->root_level;
+    bool any_fp32 = false, any_real = false;
+    for (int m=0; m<nmb; ++m) {
+      if (mb_lev.h_view(m) - root_level <= opt.rhs_fp32_level) {
+        any_fp32 = true;
+      } else {
+        any_real = true;
+      }
+    }
+    if (any_real) CalcRHSCells<NGHOST, Real>(false, il, iu, jl, ju, kl, ku);
+    if (any_fp32) CalcRHSCells<NGHOST, float>(true, il, iu, jl, ju, kl, ku);
+  }
+
+  // ===================================================================================
+  // Add dissipation for stability (unless already added in the RHS kernel)
+  //
+  if (!(fused_diss)) {
+    par_for("K-O Dissipation",
+    DevExeSpace(),0,nmb-1,0,nz4c-1,kl,ku,jl,ju,il,iu,
+    KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
+      Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+      for(int a = 0; a < 3; ++a) {
+        u_rhs(m,n,k,j,i) += Diss<NGHOST>(a, idx, u0, m, n, k, j, i)*diss;
+      }
+    });
+  }
+}
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::CalcRHSCells()
+//! \brief computes the rhs of the z4c equations with one thread per cell of
+//! [il,iu]x[jl,ju]x[kl,ku], in MeshBlocks whose RHS is computed in single precision
+//! (fp32_blocks=true) or in Real (false).
+//! Derivatives are computed in Real from the state (which is always Real), and then all
+//! of the algebra combining them is done in RTYPE.  The RHS is stored in Real, so that
+//! the RK update in ExpRKUpdate() is always done in Real.
+//! With sbc_in_rhs, the Sommerfeld condition then overwrites the RHS of cells on the
+//! faces of MeshBlocks flagged in sbc_faces (computed in Real, as in Z4cBoundaryRHS()).
+
+template <int NGHOST, typename RTYPE>
+void Z4c::CalcRHSCells(const bool fp32_blocks, const int il, const int iu,
+                       const int jl, const int ju, const int kl, const int ku) {
+  auto &size = pmy_pack->pmb->mb_size;
+
   int nmb = pmy_pack->nmb_thispack;
+  auto &mb_lev = pmy_pack->pmb->mb_lev;
+  int root_level = pmy_pack->pmesh->root_level;
+  int fp32_level = opt.rhs_fp32_level;
 
   auto &z4c = pmy_pack->pz4c->z4c;
   auto &rhs = pmy_pack->pz4c->rhs;
-  auto &opt = pmy_pack->pz4c->opt;
 
   bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
   Tmunu::Tmunu_vars tmunu;
   if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
 
-  // ===================================================================================
-  // Main RHS calculation
-  //
-  par_for("z4c rhs loop",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
+  Real &diss = pmy_pack->pz4c->diss;
+  auto &u0 = pmy_pack->pz4c->u0;
+  auto &u_rhs = pmy_pack->pz4c->u_rhs;
+  bool fused_diss = opt.fused_diss;
+  bool fused_sbc = sbc_in_rhs;
+  auto &sbc_faces_ = sbc_faces;
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+
+  // parameters and constants in RTYPE, so that no arithmetic is promoted to Real
+  const RTYPE chi_psi_power = opt.chi_psi_power;
+  const RTYPE chi_div_floor = opt.chi_div_floor;
+  const RTYPE damp_kappa1 = opt.damp_kappa1;
+  const RTYPE damp_kappa2 = opt.damp_kappa2;
+  const RTYPE lapse_oplog = opt.lapse_oplog;
+  const RTYPE lapse_harmonicf = opt.lapse_harmonicf;
+  const RTYPE lapse_harmonic = opt.lapse_harmonic;
+  const RTYPE lapse_advect = opt.lapse_advect;
+  const RTYPE shift_ggamma = opt.shift_ggamma;
+  const RTYPE shift_alpha2ggamma = opt.shift_alpha2ggamma;
+  const RTYPE shift_hh = opt.shift_hh;
+  const RTYPE shift_advect = opt.shift_advect;
+  const RTYPE shift_eta = opt.shift_eta;
+  const bool use_z4c = opt.use_z4c;
+  const RTYPE half = 0.5, third = 1.0/3.0, two_thirds = 2.0/3.0, three_halves = 1.5,
+              sixth = 1.0/6.0, pi = M_PI;
+
+  par_for("z4c rhs loop",DevExeSpace(),0,nmb-1,kl,ku,jl,ju,il,iu,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    // skip MeshBlocks whose RHS is computed in the other precision
+    if ((mb_lev.d_view(m) - root_level <= fp32_level) != fp32_blocks) return;
+
     // Define scratch arrays to be used in the following calculations
 
     // Gamma computed from the metric
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> Gamma_u;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> Gamma_u;
     // Covariant derivative of A
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> DA_u;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> DA_u;
 
     // inverse of conf. metric
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> g_uu;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> g_uu;
     // inverse of A
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> A_uu;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> A_uu;
     // g^cd A_ac A_db
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> AA_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> AA_dd;
     // Ricci tensor
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> R_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> R_dd;
     // Ricci tensor, conformal contribution
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> Rphi_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> Rphi_dd;
     // 2nd differential of the lapse
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> Ddalpha_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> Ddalpha_dd;
     // 2nd differential of phi
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> Ddphi_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> Ddphi_dd;
 
     // Christoffel symbols of 1st kind
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_ddd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 3> Gamma_ddd;
     // Christoffel symbols of 2nd kind
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_udd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 3> Gamma_udd;
 
     // auxiliary derivatives
 
     // lapse 1st drvts
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> dalpha_d;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> dalpha_d;
     // 2nd "divergence" of beta
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> ddbeta_d;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> ddbeta_d;
     // chi 1st drvts
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> dchi_d;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> dchi_d;
     // phi 1st drvts
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> dphi_d;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> dphi_d;
     // Khat 1st drvts
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> dKhat_d;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> dKhat_d;
     // Theta 1st drvts
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> dTheta_d;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> dTheta_d;
 
     // lapse 2nd drvts
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> ddalpha_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> ddalpha_dd;
     // shift 1st drvts
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 2> dbeta_du;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 2> dbeta_du;
     // chi 2nd drvts
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> ddchi_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> ddchi_dd;
     // Gamma 1st drvts
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 2> dGam_du;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 2> dGam_du;
 
     // metric 1st drvts
-    AthenaScratchTensor<Real, TensorSymm::SYM2,  3, 3> dg_ddd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2,  3, 3> dg_ddd;
     // shift 2nd drvts
-    AthenaScratchTensor<Real, TensorSymm::ISYM2, 3, 3> ddbeta_ddu;
+    AthenaScratchTensor<RTYPE, TensorSymm::ISYM2, 3, 3> ddbeta_ddu;
 
     // metric 2nd drvts
-    AthenaScratchTensor<Real, TensorSymm::SYM22, 3, 4> ddg_dddd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM22, 3, 4> ddg_dddd;
 
     // Lie derivative of Gamma
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> LGam_u;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> LGam_u;
     // Lie derivative of the shift
-    AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> Lbeta_u;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> Lbeta_u;
 
     // Lie derivative of conf. 3-metric
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> Lg_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> Lg_dd;
     // Lie derivative of A
-    AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> LA_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> LA_dd;
 
     Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
+    // State and matter variables at this cell, converted to RTYPE
+    //
+    RTYPE alpha = z4c.alpha(m,k,j,i);
+    RTYPE chi = z4c.chi(m,k,j,i);
+    RTYPE Khat = z4c.vKhat(m,k,j,i);
+    RTYPE Theta = z4c.vTheta(m,k,j,i);
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> Gam_u;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> beta_u;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> g_dd;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> A_dd;
+    for (int a = 0; a < 3; ++a) {
+      Gam_u(a) = z4c.vGam_u(m,a,k,j,i);
+      beta_u(a) = z4c.beta_u(m,a,k,j,i);
+      for (int b = a; b < 3; ++b) {
+        g_dd(a,b) = z4c.g_dd(m,a,b,k,j,i);
+        A_dd(a,b) = z4c.vA_dd(m,a,b,k,j,i);
+      }
+    }
+    RTYPE mat_E = 0.0;
+    AthenaScratchTensor<RTYPE, TensorSymm::NONE, 3, 1> mat_S_d;
+    AthenaScratchTensor<RTYPE, TensorSymm::SYM2, 3, 2> mat_S_dd;
+    if (!is_vacuum) {
+      mat_E = tmunu.E(m,k,j,i);
+      for (int a = 0; a < 3; ++a) {
+        mat_S_d(a) = tmunu.S_d(m,a,k,j,i);
+        for (int b = a; b < 3; ++b) {
+          mat_S_dd(a,b) = tmunu.S_dd(m,a,b,k,j,i);
+        }
+      }
+    }
+
+    // ---------------------------------------------------------------------------------
     // Initialize everything to zero
     //
     // Scalars
 
     // auxiliary Lie derivatives along the shift vector
     // Lie derivative of the lapse
-    Real Lalpha = 0.0;
+    RTYPE Lalpha = 0.0;
     // Lie derivative of chi
-    Real Lchi = 0.0;
+    RTYPE Lchi = 0.0;
     // Lie derivative of Khat
-    Real LKhat = 0.0;
+    RTYPE LKhat = 0.0;
     // Lie derivative of Theta
-    Real LTheta = 0.0;
+    RTYPE LTheta = 0.0;
 
     // determinant of three metric
     Real detg = 0.0;
     // bounded version of chi
-    Real chi_guarded = 0.0;
+    RTYPE chi_guarded = 0.0;
     // 1/psi4
-    Real oopsi4 = 0.0;
+    RTYPE oopsi4 = 0.0;
     // trace of A
-    Real AA = 0.0;
+    RTYPE AA = 0.0;
     // Ricci scalar
-    Real R = 0.0;
+    RTYPE R = 0.0;
     // tilde H
-    Real Ht = 0.0;
+    RTYPE Ht = 0.0;
     // trace of extrinsic curvature
-    Real K = 0.0;
+    RTYPE K = 0.0;
     // Trace of S_ik
-    Real S = 0.0;
+    RTYPE S = 0.0;
     // Trace of Ddalpha_dd
-    Real Ddalpha = 0.0;
+    RTYPE Ddalpha = 0.0;
 
     // d_a beta^a
-    Real dbeta = 0.0;
+    RTYPE dbeta = 0.0;
 
     //
     // Vectors
@@ -179,7 +353,7 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       }
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // 1st derivatives
     //
     // Scalars
@@ -204,7 +378,7 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       dg_ddd(c,a,b) = Dx<NGHOST>(c, idx, z4c.g_dd, m,a,b,k,j,i);
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // 2nd derivatives
     //
     // Scalars
@@ -237,7 +411,7 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       }
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Advective derivatives
     //
 
@@ -267,30 +441,32 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       LA_dd(a,b) += Lx<NGHOST>(c, idx, z4c.beta_u, z4c.vA_dd, m,c,a,b,k,j,i);
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Get K from Khat
     //
-    K = z4c.vKhat(m,k,j,i) + 2.*z4c.vTheta(m,k,j,i);
-
-    // -----------------------------------------------------------------------------------
-    // Inverse metric
+    K = Khat + 2*Theta;
 
+    // ---------------------------------------------------------------------------------
+    // Inverse metric (computed in Real, then converted to RTYPE)
+    //
+    Real uxx, uxy, uxz, uyy, uyz, uzz;
     detg = adm::SpatialDet(z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i),
                               z4c.g_dd(m,0,2,k,j,i), z4c.g_dd(m,1,1,k,j,i),
                               z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i));
     adm::SpatialInv(1.0/detg,
                z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i), z4c.g_dd(m,0,2,k,j,i),
                z4c.g_dd(m,1,1,k,j,i), z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i),
-               &g_uu(0,0), &g_uu(0,1), &g_uu(0,2),
-               &g_uu(1,1), &g_uu(1,2), &g_uu(2,2));
+               &uxx, &uxy, &uxz, &uyy, &uyz, &uzz);
+    g_uu(0,0) = uxx; g_uu(0,1) = uxy; g_uu(0,2) = uxz;
+    g_uu(1,1) = uyy; g_uu(1,2) = uyz; g_uu(2,2) = uzz;
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Christoffel symbols
 
     for(int c = 0; c < 3; ++c)
     for(int a = 0; a < 3; ++a)
     for(int b = a; b < 3; ++b) {
-      Gamma_ddd(c,a,b) = 0.5*(dg_ddd(a,b,c) + dg_ddd(b,a,c) - dg_ddd(c,a,b));
+      Gamma_ddd(c,a,b) = half*(dg_ddd(a,b,c) + dg_ddd(b,a,c) - dg_ddd(c,a,b));
     }
     for(int c = 0; c < 3; ++c)
     for(int a = 0; a < 3; ++a)
@@ -305,19 +481,19 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       Gamma_u(a) += g_uu(b,c)*Gamma_udd(a,b,c);
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Curvature of conformal metric
     //
     for(int a = 0; a < 3; ++a)
     for(int b = a; b < 3; ++b) {
       for(int c = 0; c < 3; ++c) {
-        R_dd(a,b) += 0.5*(z4c.g_dd(m,c,a,k,j,i)*dGam_du(b,c) +
-                          z4c.g_dd(m,c,b,k,j,i)*dGam_du(a,c) +
+        R_dd(a,b) += half*(g_dd(c,a)*dGam_du(b,c) +
+                          g_dd(c,b)*dGam_du(a,c) +
                           Gamma_u(c)*(Gamma_ddd(a,b,c) + Gamma_ddd(b,a,c)));
       }
       for(int c = 0; c < 3; ++c)
       for(int d = 0; d < 3; ++d) {
-        R_dd(a,b) -= 0.5*g_uu(c,d)*ddg_dddd(c,d,a,b);
+        R_dd(a,b) -= half*g_uu(c,d)*ddg_dddd(c,d,a,b);
       }
       for(int c = 0; c < 3; ++c)
       for(int d = 0; d < 3; ++d)
@@ -329,39 +505,38 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       }
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Derivatives of conformal factor phi
     //
-    chi_guarded = (z4c.chi(m,k,j,i)>opt.chi_div_floor)
-                    ? z4c.chi(m,k,j,i) : opt.chi_div_floor;
-    oopsi4 = pow(chi_guarded, -4./opt.chi_psi_power);
+    chi_guarded = (chi>chi_div_floor) ? chi : chi_div_floor;
+    oopsi4 = pow(chi_guarded, -4/chi_psi_power);
     for(int a = 0; a < 3; ++a) {
-      dphi_d(a) = dchi_d(a)/(chi_guarded * opt.chi_psi_power);
+      dphi_d(a) = dchi_d(a)/(chi_guarded * chi_psi_power);
     }
     for(int a = 0; a < 3; ++a)
     for(int b = a; b < 3; ++b) {
-      Ddphi_dd(a,b) = ddchi_dd(a,b)/(chi_guarded * opt.chi_psi_power) -
-        opt.chi_psi_power * dphi_d(a) * dphi_d(b);
+      Ddphi_dd(a,b) = ddchi_dd(a,b)/(chi_guarded * chi_psi_power) -
+        chi_psi_power * dphi_d(a) * dphi_d(b);
       for(int c = 0; c < 3; ++c) {
         Ddphi_dd(a,b) -= Gamma_udd(c,a,b)*dphi_d(c);
       }
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Curvature contribution from conformal factor
     //
     for(int a = 0; a < 3; ++a)
     for(int b = a; b < 3; ++b) {
-      Rphi_dd(a,b) = 4.*dphi_d(a)*dphi_d(b) - 2.*Ddphi_dd(a,b);
+      Rphi_dd(a,b) = 4*dphi_d(a)*dphi_d(b) - 2*Ddphi_dd(a,b);
       for(int c = 0; c < 3; ++c)
       for(int d = 0; d < 3; ++d) {
-        Rphi_dd(a,b) -= 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)*(Ddphi_dd(c,d) +
-            2.*dphi_d(c)*dphi_d(d));
+        Rphi_dd(a,b) -= 2*g_dd(a,b) * g_uu(c,d)*(Ddphi_dd(c,d) +
+            2*dphi_d(c)*dphi_d(d));
       }
     }
 
     // TODO(JMF): Update with Tmunu terms.
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Trace of the matter stress tensor
     //
     // Matter commented out
@@ -376,22 +551,22 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
     if(!is_vacuum) {
       for (int a = 0; a < 3; ++a)
       for (int b = 0; b < 3; ++b) {
-        S += oopsi4 * g_uu(a,b) * tmunu.S_dd(m,a,b,k,j,i);
+        S += oopsi4 * g_uu(a,b) * mat_S_dd(a,b);
       }
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // 2nd covariant derivative of the lapse
     // TODO(JMF): This could potentially be sped up by calculating d_i phi d^i alpha
     // beforehand.
     for(int a = 0; a < 3; ++a)
     for(int b = 0; b < 3; ++b) {
       Ddalpha_dd(a,b) = ddalpha_dd(a,b)
-                       - 2.*(dphi_d(a)*dalpha_d(b) + dphi_d(b)*dalpha_d(a));
+                       - 2*(dphi_d(a)*dalpha_d(b) + dphi_d(b)*dalpha_d(a));
       for(int c = 0; c < 3; ++c) {
         Ddalpha_dd(a,b) -= Gamma_udd(c,a,b)*dalpha_d(c);
         for(int d = 0; d < 3; ++d) {
-            Ddalpha_dd(a,b) += 2.*z4c.g_dd(m,a,b,k,j,i) * g_uu(c,d)
+            Ddalpha_dd(a,b) += 2*g_dd(a,b) * g_uu(c,d)
             * dphi_d(c) * dalpha_d(d);
         }
       }
@@ -402,14 +577,14 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       Ddalpha += oopsi4 * g_uu(a,b) * Ddalpha_dd(a,b);
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Contractions of A_ab, inverse, and derivatives
     //
     for(int a = 0; a < 3; ++a)
     for(int b = a; b < 3; ++b)
     for(int c = 0; c < 3; ++c)
     for(int d = 0; d < 3; ++d) {
-      AA_dd(a,b) += g_uu(c,d) * z4c.vA_dd(m,a,c,k,j,i) * z4c.vA_dd(m,d,b,k,j,i);
+      AA_dd(a,b) += g_uu(c,d) * A_dd(a,c) * A_dd(d,b);
     }
     for(int a = 0; a < 3; ++a)
     for(int b = 0; b < 3; ++b) {
@@ -419,13 +594,13 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
     for(int b = a; b < 3; ++b)
     for(int c = 0; c < 3; ++c)
     for(int d = 0; d < 3; ++d) {
-      A_uu(a,b) += g_uu(a,c) * g_uu(b,d) * z4c.vA_dd(m,c,d,k,j,i);
+      A_uu(a,b) += g_uu(a,c) * g_uu(b,d) * A_dd(c,d);
     }
-    // TODO(JMF): dchi_d/chi_guarded is opt.chi_psi_power * dphi_d.
+    // TODO(JMF): dchi_d/chi_guarded is chi_psi_power * dphi_d.
     for(int a = 0; a < 3; ++a) {
       for(int b = 0; b < 3; ++b) {
-          DA_u(a) -= (3./2.) * A_uu(a,b) * dchi_d(b) / chi_guarded;
-          DA_u(a) -= (1./3.) * g_uu(a,b) * (2.*dKhat_d(b) + dTheta_d(b));
+          DA_u(a) -= three_halves * A_uu(a,b) * dchi_d(b) / chi_guarded;
+          DA_u(a) -= third * g_uu(a,b) * (2*dKhat_d(b) + dTheta_d(b));
       }
       for(int b = 0; b < 3; ++b)
       for(int c = 0; c < 3; ++c) {
@@ -433,7 +608,7 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       }
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Ricci scalar
     //
     for(int a = 0; a < 3; ++a)
@@ -441,12 +616,12 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
       R += oopsi4 * g_uu(a,b) * (R_dd(a,b) + Rphi_dd(a,b));
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Hamiltonian constraint
     //
-    Ht = R + (2./3.)*SQR(K) - AA;// - 16.*M_PI*tmunu.E(m,k,j,i);
+    Ht = R + two_thirds*SQR(K) - AA;// - 16.*M_PI*tmunu.E(m,k,j,i);
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Finalize advective (Lie) derivatives
     //
     // Shift vector contractions
@@ -455,15 +630,15 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
     }
     for(int a = 0; a < 3; ++a)
     for(int b = 0; b < 3; ++b) {
-      ddbeta_d(a) += (1./3.) * ddbeta_ddu(a,b,b);
+      ddbeta_d(a) += third * ddbeta_ddu(a,b,b);
     }
 
     // Finalize Lchi
-    Lchi += (1./6.) * opt.chi_psi_power * chi_guarded * dbeta;
+    Lchi += sixth * chi_psi_power * chi_guarded * dbeta;
 
     // Finalize LGam_u (note that this is not a real Lie derivative)
     for(int a = 0; a < 3; ++a) {
-      LGam_u(a) += (2./3.) * Gamma_u(a) * dbeta;
+      LGam_u(a) += two_thirds * Gamma_u(a) * dbeta;
       for(int b = 0; b < 3; ++b) {
         LGam_u(a) += g_uu(a,b) * ddbeta_d(b) - Gamma_u(b) * dbeta_du(b,a);
         for(int c = 0; c < 3; ++c) {
@@ -475,54 +650,54 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
     // Finalize Lg_dd and LA_dd
     for(int a = 0; a < 3; ++a)
     for(int b = a; b < 3; ++b) {
-      Lg_dd(a,b) -= (2./3.) * z4c.g_dd(m,a,b,k,j,i) * dbeta;
+      Lg_dd(a,b) -= two_thirds * g_dd(a,b) * dbeta;
       for(int c = 0; c < 3; ++c) {
-        Lg_dd(a,b) += dbeta_du(a,c) * z4c.g_dd(m,b,c,k,j,i);
-        Lg_dd(a,b) += dbeta_du(b,c) * z4c.g_dd(m,a,c,k,j,i);
+        Lg_dd(a,b) += dbeta_du(a,c) * g_dd(b,c);
+        Lg_dd(a,b) += dbeta_du(b,c) * g_dd(a,c);
       }
     }
     for(int a = 0; a < 3; ++a)
     for(int b = a; b < 3; ++b) {
-      LA_dd(a,b) -= (2./3.) * z4c.vA_dd(m,a,b,k,j,i) * dbeta;
+      LA_dd(a,b) -= two_thirds * A_dd(a,b) * dbeta;
       for(int c = 0; c < 3; ++c) {
-        LA_dd(a,b) += dbeta_du(b,c) * z4c.vA_dd(m,a,c,k,j,i);
-        LA_dd(a,b) += dbeta_du(a,c) * z4c.vA_dd(m,b,c,k,j,i);
+        LA_dd(a,b) += dbeta_du(b,c) * A_dd(a,c);
+        LA_dd(a,b) += dbeta_du(a,c) * A_dd(b,c);
       }
     }
 
-    // -----------------------------------------------------------------------------------
+    // ---------------------------------------------------------------------------------
     // Assemble RHS
     //
     // Khat, chi, and Theta
-    rhs.vKhat(m,k,j,i) = - Ddalpha + z4c.alpha(m,k,j,i)
-      * (AA + (1./3.)*SQR(K)) +
-      LKhat + opt.damp_kappa1*(1 - opt.damp_kappa2)
-      * z4c.alpha(m,k,j,i) * z4c.vTheta(m,k,j,i);
+    rhs.vKhat(m,k,j,i) = - Ddalpha + alpha
+      * (AA + third*SQR(K)) +
+      LKhat + damp_kappa1*(1 - damp_kappa2)
+      * alpha * Theta;
     // Matter term
     if(!is_vacuum) {
-      rhs.vKhat(m,k,j,i) += 4.*M_PI * z4c.alpha(m,k,j,i) * (S + tmunu.E(m,k,j,i));
+      rhs.vKhat(m,k,j,i) += 4*pi * alpha * (S + mat_E);
     }
-    rhs.chi(m,k,j,i) = Lchi - (1./6.) * opt.chi_psi_power *
-      chi_guarded * z4c.alpha(m,k,j,i) * K;
-    rhs.vTheta(m,k,j,i) = LTheta + z4c.alpha(m,k,j,i) * (
-        0.5*Ht - (2. + opt.damp_kappa2) * opt.damp_kappa1 * z4c.vTheta(m,k,j,i));
+    rhs.chi(m,k,j,i) = Lchi - sixth * chi_psi_power *
+      chi_guarded * alpha * K;
+    rhs.vTheta(m,k,j,i) = LTheta + alpha * (
+        half*Ht - (2 + damp_kappa2) * damp_kappa1 * Theta);
     // Matter term
     if(!is_vacuum) {
-      rhs.vTheta(m,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) * tmunu.E(m,k,j,i);
+      rhs.vTheta(m,k,j,i) -= 8*pi * alpha * mat_E;
     }
     // If BSSN is enabled, theta is disabled.
-    rhs.vTheta(m,k,j,i) *= opt.use_z4c;
+    rhs.vTheta(m,k,j,i) *= use_z4c;
     // Gamma's
     for(int a = 0; a < 3; ++a) {
-      rhs.vGam_u(m,a,k,j,i) = 2.*z4c.alpha(m,k,j,i)*DA_u(a) + LGam_u(a);
-      rhs.vGam_u(m,a,k,j,i) -= 2.*z4c.alpha(m,k,j,i) * opt.damp_kappa1 *
-          (z4c.vGam_u(m,a,k,j,i) - Gamma_u(a));
+      rhs.vGam_u(m,a,k,j,i) = 2*alpha*DA_u(a) + LGam_u(a);
+      rhs.vGam_u(m,a,k,j,i) -= 2*alpha * damp_kappa1 *
+          (Gam_u(a) - Gamma_u(a));
       for(int b = 0; b < 3; ++b) {
-        rhs.vGam_u(m,a,k,j,i) -= 2. * A_uu(a,b) * dalpha_d(b);
+        rhs.vGam_u(m,a,k,j,i) -= 2 * A_uu(a,b) * dalpha_d(b);
         // Matter term
         if(!is_vacuum) {
-          rhs.vGam_u(m,a,k,j,i) -= 16.*M_PI * z4c.alpha(m,k,j,i)
-                              * g_uu(a,b) * tmunu.S_d(m,b,k,j,i);
+          rhs.vGam_u(m,a,k,j,i) -= 16*pi * alpha
+                              * g_uu(a,b) * mat_S_d(b);
         }
       }
     }
@@ -530,66 +705,86 @@ TaskStatus Z4c::CalcRHS(Driver *pdriver, int stage) {
     // g and A
     for(int a = 0; a < 3; ++a)
     for(int b = a; b < 3; ++b) {
-      rhs.g_dd(m,a,b,k,j,i) = - 2. * z4c.alpha(m,k,j,i) * z4c.vA_dd(m,a,b,k,j,i)
+      rhs.g_dd(m,a,b,k,j,i) = - 2 * alpha * A_dd(a,b)
                       + Lg_dd(a,b);
       rhs.vA_dd(m,a,b,k,j,i) = oopsi4 *
-          (-Ddalpha_dd(a,b) + z4c.alpha(m,k,j,i) * (R_dd(a,b) + Rphi_dd(a,b)));
-      rhs.vA_dd(m,a,b,k,j,i) -= (1./3.) * z4c.g_dd(m,a,b,k,j,i)
-                             * (-Ddalpha + z4c.alpha(m,k,j,i)*R);
-      rhs.vA_dd(m,a,b,k,j,i) += z4c.alpha(m,k,j,i) * (K*z4c.vA_dd(m,a,b,k,j,i)
-                             - 2.*AA_dd(a,b));
+          (-Ddalpha_dd(a,b) + alpha * (R_dd(a,b) + Rphi_dd(a,b)));
+      rhs.vA_dd(m,a,b,k,j,i) -= third * g_dd(a,b)
+                             * (-Ddalpha + alpha*R);
+      rhs.vA_dd(m,a,b,k,j,i) += alpha * (K*A_dd(a,b)
+                             - 2*AA_dd(a,b));
       rhs.vA_dd(m,a,b,k,j,i) += LA_dd(a,b);
       // Matter term
       if(!is_vacuum) {
-        rhs.vA_dd(m,a,b,k,j,i) -= 8.*M_PI * z4c.alpha(m,k,j,i) *
-                (oopsi4*tmunu.S_dd(m,a,b,k,j,i) - (1./3.)*S*z4c.g_dd(m,a,b,k,j,i));
+        rhs.vA_dd(m,a,b,k,j,i) -= 8*pi * alpha *
+                (oopsi4*mat_S_dd(a,b) - third*S*g_dd(a,b));
       }
     }
     // lapse function
-    Real const f = opt.lapse_oplog * opt.lapse_harmonicf
-                 + opt.lapse_harmonic * z4c.alpha(m,k,j,i);
-    rhs.alpha(m,k,j,i) = opt.lapse_advect * Lalpha
-                       - f * z4c.alpha(m,k,j,i) * z4c.vKhat(m,k,j,i);
+    RTYPE const f = lapse_oplog * lapse_harmonicf
+                 + lapse_harmonic * alpha;
+    rhs.alpha(m,k,j,i) = lapse_advect * Lalpha
+                       - f * alpha * Khat;
 
     // shift vector
     for(int a = 0; a < 3; ++a) {
-      rhs.beta_u(m,a,k,j,i) = opt.shift_ggamma * z4c.vGam_u(m,a,k,j,i)
-                            + opt.shift_advect * Lbeta_u(a);
-      rhs.beta_u(m,a,k,j,i) -= opt.shift_eta * z4c.beta_u(m,a,k,j,i);
+      rhs.beta_u(m,a,k,j,i) = shift_ggamma * Gam_u(a)
+                            + shift_advect * Lbeta_u(a);
+      rhs.beta_u(m,a,k,j,i) -= shift_eta * beta_u(a);
       // FORCE beta = 0
       //rhs.beta_u(m,a,k,j,i) = 0;
     }
 
     // harmonic gauge terms
     for(int a = 0; a < 3; ++a) {
-      rhs.beta_u(m,a,k,j,i) += opt.shift_alpha2ggamma *
-                          SQR(z4c.alpha(m,k,j,i)) * z4c.vGam_u(m,a,k,j,i);
+      rhs.beta_u(m,a,k,j,i) += shift_alpha2ggamma *
+                          SQR(alpha) * Gam_u(a);
       for(int b = 0; b < 3; ++b) {
-        rhs.beta_u(m,a,k,j,i) += opt.shift_hh * z4c.alpha(m,k,j,i) *
-          chi_guarded * (0.5 * z4c.alpha(m,k,j,i) * dchi_d(b) - dalpha_d(b)) * g_uu(a,b);
+        rhs.beta_u(m,a,k,j,i) += shift_hh * alpha * chi_guarded *
+          (half * alpha * dchi_d(b) - dalpha_d(b)) * g_uu(a,b);
       }
     }
-  });
 
-  // ===================================================================================
-  // Add dissipation for stability
-  //
-  Real &diss = pmy_pack->pz4c->diss;
-  auto &u0 = pmy_pack->pz4c->u0;
-  auto &u_rhs = pmy_pack->pz4c->u_rhs;
-  par_for("K-O Dissipation",
-  DevExeSpace(),0,nmb-1,0,nz4c-1,ks,ke,js,je,is,ie,
-  KOKKOS_LAMBDA(const int m, const int n, const int k, const int j, const int i) {
-    Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
-    for(int a = 0; a < 3; ++a) {
-      u_rhs(m,n,k,j,i) += Diss<NGHOST>(a, idx, u0, m, n, k, j, i)*diss;
+    // Add dissipation for stability, while RHS of this cell and stencil of u0 are
+    // still in cache
+    if (fused_diss) {
+      for (int n = 0; n < nz4c; ++n) {
+        Real dterm = 0.0;
+        for(int a = 0; a < 3; ++a) {
+          dterm += Diss<NGHOST>(a, idx, u0, m, n, k, j, i);
+        }
+        u_rhs(m,n,k,j,i) += dterm*diss;
+      }
+    }
+
+    // Sommerfeld condition on outflow/user faces of the Mesh, while the stencil of u0 is
+    // still in cache
+    if (fused_sbc && IsSommerfeldCell(sbc_faces_.d_view(m), indcs, k, j, i)) {
+      Z4cSommerfeld(z4c, rhs, indcs, size, m, k, j, i);
     }
   });
 
-  return TaskStatus::complete;
+  return;
 }
 
 template TaskStatus Z4c::CalcRHS<2>(Driver *pdriver, int stage);
 template TaskStatus Z4c::CalcRHS<3>(Driver *pdriver, int stage);
 template TaskStatus Z4c::CalcRHS<4>(Driver *pdriver, int stage);
+template TaskStatus Z4c::CalcRHSInterior<2>(Driver *pdriver, int stage);
+template TaskStatus Z4c::CalcRHSInterior<3>(Driver *pdriver, int stage);
+template TaskStatus Z4c::CalcRHSInterior<4>(Driver *pdriver, int stage);
+template void Z4c::CalcRHSCells<2, Real>(const bool fp32_blocks, const int il,
+    const int iu, const int jl, const int ju, const int kl, const int ku);
+template void Z4c::CalcRHSCells<3, Real>(const bool fp32_blocks, const int il,
+    const int iu, const int jl, const int ju, const int kl, const int ku);
+template void Z4c::CalcRHSCells<4, Real>(const bool fp32_blocks, const int il,
+    const int iu, const int jl, const int ju, const int kl, const int ku);
+#if !(SINGLE_PRECISION_ENABLED)
+template void Z4c::CalcRHSCells<2, float>(const bool fp32_blocks, const int il,
+    const int iu, const int jl, const int ju, const int kl, const int ku);
+template void Z4c::CalcRHSCells<3, float>(const bool fp32_blocks, const int il,
+    const int iu, const int jl, const int ju, const int kl, const int ku);
+template void Z4c::CalcRHSCells<4, float>(const bool fp32_blocks, const int il,
+    const int iu, const int jl, const int ju, const int kl, const int ku);
+#endif
 } // namespace z4c
@@ -0,0 +1,477 @@
+//========================================================================================
+// AthenaXXX astrophysical plasma code
+// Copyright(C) 2020 James M. Stone <jmstone@ias.edu> and the Athena code team
+// Licensed under the 3-clause BSD License (the "LICENSE")
+//========================================================================================
+//! \file z4c_calcrhs_staged.cpp
+//! \brief Staged evaluation of the z4c RHS, enabled with <z4c>/staged_rhs=true.  The
+//! equations are identical to those in z4c_calcrhs.cpp, but instead of one lambda per
+//! cell holding every derivative and intermediate tensor at once, one team per (m,k,j)
+//! pencil runs a sequence of smaller stages (first, second, and advective derivatives;
+//! conformal Ricci tensor; gauge and RHS assembly), which exchange results through a
+//! table in team scratch.  Each stage only keeps its own inputs and outputs live, which
+//! reduces register pressure (and spilling) on GPUs.
+
+#include <math.h>
+
+#include "athena.hpp"
+#include "mesh/mesh.hpp"
+#include "coordinates/adm.hpp"
+#include "z4c/z4c.hpp"
+#include "z4c/tmunu.hpp"
+
+namespace z4c {
+
+// Offsets of quantities in the scratch table of each pencil.  Symmetric pairs (a,b) are
+// stored in the 6 components given by SymIdx(a,b) (see z4c.hpp).
+//   first derivatives (d_a of scalars, d_b of beta^a and Gam^a at 3*b+a, d_c g_ab)
+constexpr int SCR_DALPHA = 0, SCR_DCHI = 3, SCR_DKHAT = 6, SCR_DTHETA = 9;
+constexpr int SCR_DBETA = 12, SCR_DGAM = 21, SCR_DG = 30;
+//   second derivatives (d_ab of scalars, d_ab beta^c at 6*c+ab, d_ab g_cd at 6*cd+ab)
+constexpr int SCR_DDALPHA = 48, SCR_DDCHI = 54, SCR_DDBETA = 60, SCR_DDG = 78;
+//   advective derivatives beta^c d_c
+constexpr int SCR_LALPHA = 114, SCR_LCHI = 115, SCR_LKHAT = 116, SCR_LTHETA = 117;
+constexpr int SCR_LBETA = 118, SCR_LGAM = 121, SCR_LG = 124, SCR_LA = 130;
+//   geometry (g^ab, Gamma^c_ab at 6*c+ab, Gamma^a, R_ab + R^phi_ab, d_a phi, guarded
+//   chi, and 1/psi^4)
+constexpr int SCR_GUU = 136, SCR_GAMUDD = 142, SCR_GAMU = 160, SCR_RTOT = 163;
+constexpr int SCR_DPHI = 169, SCR_CHIG = 172, SCR_OOPSI4 = 173;
+constexpr int SCR_NVAR = 174;
+
+//----------------------------------------------------------------------------------------
+//! \fn void Z4c::CalcRHSStaged()
+//! \brief computes the rhs of the z4c equations in stages with one team per pencil.
+//! Dissipation is added in a last stage with opt.fused_diss, otherwise in CalcRHS().
+
+template <int NGHOST>
+void Z4c::CalcRHSStaged() {
+  auto &indcs = pmy_pack->pmesh->mb_indcs;
+  auto &size = pmy_pack->pmb->mb_size;
+  int &is = indcs.is; int &ie = indcs.ie;
+  int &js = indcs.js; int &je = indcs.je;
+  int &ks = indcs.ks; int &ke = indcs.ke;
+  int ncells1 = indcs.nx1 + 2*(indcs.ng);
+
+  int nmb = pmy_pack->nmb_thispack;
+
+  auto &z4c = pmy_pack->pz4c->z4c;
+  auto &rhs = pmy_pack->pz4c->rhs;
+  auto &opt = pmy_pack->pz4c->opt;
+
+  bool is_vacuum = (pmy_pack->ptmunu == nullptr) ? true : false;
+  Tmunu::Tmunu_vars tmunu;
+  if (!is_vacuum) tmunu = pmy_pack->ptmunu->tmunu;
+
+  Real &diss = pmy_pack->pz4c->diss;
+  auto &u0 = pmy_pack->pz4c->u0;
+  auto &u_rhs = pmy_pack->pz4c->u_rhs;
+  bool fused_diss = opt.fused_diss;
+
+  int scr_level = 1;
+  size_t scr_size = ScrArray2D<Real>::shmem_size(SCR_NVAR, ncells1);
+  par_for_outer("z4c rhs staged",DevExeSpace(),scr_size,scr_level,0,(nmb-1),ks,ke,js,je,
+  KOKKOS_LAMBDA(TeamMember_t member, const int m, const int k, const int j) {
+    ScrArray2D<Real> s(member.team_scratch(scr_level), SCR_NVAR, ncells1);
+    Real idx[] = {1/size.d_view(m).dx1, 1/size.d_view(m).dx2, 1/size.d_view(m).dx3};
+
+    // ---------------------------------------------------------------------------------
+    // Stage 1: 1st derivatives
+    //
+    par_for_inner(member, is, ie, [&](const int i) {
+      for (int a = 0; a < 3; ++a) {
+        s(SCR_DALPHA+a,i) = Dx<NGHOST>(a, idx, z4c.alpha,  m,k,j,i);
+        s(SCR_DCHI  +a,i) = Dx<NGHOST>(a, idx, z4c.chi,    m,k,j,i);
+        s(SCR_DKHAT +a,i) = Dx<NGHOST>(a, idx, z4c.vKhat,  m,k,j,i);
+        s(SCR_DTHETA+a,i) = Dx<NGHOST>(a, idx, z4c.vTheta, m,k,j,i);
+      }
+      for (int a = 0; a < 3; ++a)
+      for (int b = 0; b < 3; ++b) {
+        s(SCR_DBETA+3*b+a,i) = Dx<NGHOST>(b, idx, z4c.beta_u, m,a,k,j,i);
+        s(SCR_DGAM +3*b+a,i) = Dx<NGHOST>(b, idx, z4c.vGam_u, m,a,k,j,i);
+      }
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b)
+      for (int c = 0; c < 3; ++c) {
+        s(SCR_DG+6*c+SymIdx(a,b),i) = Dx<NGHOST>(c, idx, z4c.g_dd, m,a,b,k,j,i);
+      }
+    });
+
+    // ---------------------------------------------------------------------------------
+    // Stage 2: 2nd derivatives
+    //
+    par_for_inner(member, is, ie, [&](const int i) {
+      for (int a = 0; a < 3; ++a) {
+        s(SCR_DDALPHA+SymIdx(a,a),i) = Dxx<NGHOST>(a, idx, z4c.alpha, m,k,j,i);
+        s(SCR_DDCHI  +SymIdx(a,a),i) = Dxx<NGHOST>(a, idx, z4c.chi,   m,k,j,i);
+        for (int b = a + 1; b < 3; ++b) {
+          s(SCR_DDALPHA+SymIdx(a,b),i) = Dxy<NGHOST>(a, b, idx, z4c.alpha, m,k,j,i);
+          s(SCR_DDCHI  +SymIdx(a,b),i) = Dxy<NGHOST>(a, b, idx, z4c.chi,   m,k,j,i);
+        }
+      }
+      for (int c = 0; c < 3; ++c)
+      for (int a = 0; a < 3; ++a) {
+        s(SCR_DDBETA+6*c+SymIdx(a,a),i) = Dxx<NGHOST>(a, idx, z4c.beta_u, m,c,k,j,i);
+        for (int b = a + 1; b < 3; ++b) {
+          s(SCR_DDBETA+6*c+SymIdx(a,b),i) = Dxy<NGHOST>(a, b, idx, z4c.beta_u, m,c,k,j,i);
+        }
+      }
+      for (int c = 0; c < 3; ++c)
+      for (int d = c; d < 3; ++d)
+      for (int a = 0; a < 3; ++a) {
+        int cd = 6*SymIdx(c,d);
+        s(SCR_DDG+cd+SymIdx(a,a),i) = Dxx<NGHOST>(a, idx, z4c.g_dd, m,c,d,k,j,i);
+        for (int b = a + 1; b < 3; ++b) {
+          s(SCR_DDG+cd+SymIdx(a,b),i) = Dxy<NGHOST>(a, b, idx, z4c.g_dd, m,c,d,k,j,i);
+        }
+      }
+    });
+
+    // ---------------------------------------------------------------------------------
+    // Stage 3: advective derivatives
+    //
+    par_for_inner(member, is, ie, [&](const int i) {
+      Real Lalpha = 0.0, Lchi = 0.0, LKhat = 0.0, LTheta = 0.0;
+      for (int a = 0; a < 3; ++a) {
+        Lalpha += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.alpha,  m,a,k,j,i);
+        Lchi   += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.chi,    m,a,k,j,i);
+        LKhat  += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.vKhat,  m,a,k,j,i);
+        LTheta += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.vTheta, m,a,k,j,i);
+      }
+      s(SCR_LALPHA,i) = Lalpha;
+      s(SCR_LCHI,  i) = Lchi;
+      s(SCR_LKHAT, i) = LKhat;
+      s(SCR_LTHETA,i) = LTheta;
+      for (int b = 0; b < 3; ++b) {
+        Real Lbeta = 0.0, LGam = 0.0;
+        for (int a = 0; a < 3; ++a) {
+          Lbeta += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.beta_u, m,a,b,k,j,i);
+          LGam  += Lx<NGHOST>(a, idx, z4c.beta_u, z4c.vGam_u, m,a,b,k,j,i);
+        }
+        s(SCR_LBETA+b,i) = Lbeta;
+        s(SCR_LGAM +b,i) = LGam;
+      }
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        Real Lg = 0.0, LA = 0.0;
+        for (int c = 0; c < 3; ++c) {
+          Lg += Lx<NGHOST>(c, idx, z4c.beta_u, z4c.g_dd,  m,c,a,b,k,j,i);
+          LA += Lx<NGHOST>(c, idx, z4c.beta_u, z4c.vA_dd, m,c,a,b,k,j,i);
+        }
+        s(SCR_LG+SymIdx(a,b),i) = Lg;
+        s(SCR_LA+SymIdx(a,b),i) = LA;
+      }
+    });
+    member.team_barrier();
+
+    // ---------------------------------------------------------------------------------
+    // Stage 4: inverse metric, Christoffel symbols, and Ricci tensor (including the
+    // contribution of the conformal factor)
+    //
+    par_for_inner(member, is, ie, [&](const int i) {
+      AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> g_uu;
+      AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_ddd;
+      AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 3> Gamma_udd;
+      AthenaScratchTensor<Real, TensorSymm::NONE, 3, 1> Gamma_u;
+
+      Real detg = adm::SpatialDet(z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i),
+                                  z4c.g_dd(m,0,2,k,j,i), z4c.g_dd(m,1,1,k,j,i),
+                                  z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i));
+      adm::SpatialInv(1.0/detg,
+                 z4c.g_dd(m,0,0,k,j,i), z4c.g_dd(m,0,1,k,j,i), z4c.g_dd(m,0,2,k,j,i),
+                 z4c.g_dd(m,1,1,k,j,i), z4c.g_dd(m,1,2,k,j,i), z4c.g_dd(m,2,2,k,j,i),
+                 &g_uu(0,0), &g_uu(0,1), &g_uu(0,2),
+                 &g_uu(1,1), &g_uu(1,2), &g_uu(2,2));
+
+      // Christoffel symbols
+      for (int c = 0; c < 3; ++c)
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        Gamma_ddd(c,a,b) = 0.5*(s(SCR_DG+6*a+SymIdx(b,c),i) +
+                                s(SCR_DG+6*b+SymIdx(a,c),i) -
+                                s(SCR_DG+6*c+SymIdx(a,b),i));
+      }
+      for (int c = 0; c < 3; ++c)
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        Gamma_udd(c,a,b) = 0.0;
+        for (int d = 0; d < 3; ++d) {
+          Gamma_udd(c,a,b) += g_uu(c,d)*Gamma_ddd(d,a,b);
+        }
+      }
+      for (int a = 0; a < 3; ++a) {
+        Gamma_u(a) = 0.0;
+        for (int b = 0; b < 3; ++b)
+        for (int c = 0; c < 3; ++c) {
+          Gamma_u(a) += g_uu(b,c)*Gamma_udd(a,b,c);
+        }
+      }
+
+      // derivatives of conformal factor phi
+      Real chi_guarded = (z4c.chi(m,k,j,i)>opt.chi_div_floor)
+                         ? z4c.chi(m,k,j,i) : opt.chi_div_floor;
+      Real dphi_d[3];
+      for (int a = 0; a < 3; ++a) {
+        dphi_d[a] = s(SCR_DCHI+a,i)/(chi_guarded * opt.chi_psi_power);
+      }
+      AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> Ddphi_dd;
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        Ddphi_dd(a,b) = s(SCR_DDCHI+SymIdx(a,b),i)/(chi_guarded * opt.chi_psi_power) -
+          opt.chi_psi_power * dphi_d[a] * dphi_d[b];
+        for (int c = 0; c < 3; ++c) {
+          Ddphi_dd(a,b) -= Gamma_udd(c,a,b)*dphi_d[c];
+        }
+      }
+      Real trDdphi = 0.0;
+      for (int c = 0; c < 3; ++c)
+      for (int d = 0; d < 3; ++d) {
+        trDdphi += g_uu(c,d)*(Ddphi_dd(c,d) + 2.*dphi_d[c]*dphi_d[d]);
+      }
+
+      // Ricci tensor of conformal metric plus conformal factor contribution
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        Real R_ab = 0.0;
+        for (int c = 0; c < 3; ++c) {
+          R_ab += 0.5*(z4c.g_dd(m,c,a,k,j,i)*s(SCR_DGAM+3*b+c,i) +
+                       z4c.g_dd(m,c,b,k,j,i)*s(SCR_DGAM+3*a+c,i) +
+                       Gamma_u(c)*(Gamma_ddd(a,b,c) + Gamma_ddd(b,a,c)));
+        }
+        for (int c = 0; c < 3; ++c)
+        for (int d = 0; d < 3; ++d) {
+          R_ab -= 0.5*g_uu(c,d)*s(SCR_DDG+6*SymIdx(a,b)+SymIdx(c,d),i);
+        }
+        for (int c = 0; c < 3; ++c)
+        for (int d = 0; d < 3; ++d)
+        for (int e = 0; e < 3; ++e) {
+          R_ab += g_uu(c,d)*(
+              Gamma_udd(e,c,a)*Gamma_ddd(b,e,d) +
+              Gamma_udd(e,c,b)*Gamma_ddd(a,e,d) +
+              Gamma_udd(e,a,d)*Gamma_ddd(e,c,b));
+        }
+        R_ab += 4.*dphi_d[a]*dphi_d[b] - 2.*Ddphi_dd(a,b)
+              - 2.*z4c.g_dd(m,a,b,k,j,i)*trDdphi;
+        s(SCR_RTOT+SymIdx(a,b),i) = R_ab;
+      }
+
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        s(SCR_GUU+SymIdx(a,b),i) = g_uu(a,b);
+        for (int c = 0; c < 3; ++c) {
+          s(SCR_GAMUDD+6*c+SymIdx(a,b),i) = Gamma_udd(c,a,b);
+        }
+      }
+      for (int a = 0; a < 3; ++a) {
+        s(SCR_GAMU+a,i) = Gamma_u(a);
+        s(SCR_DPHI+a,i) = dphi_d[a];
+      }
+      s(SCR_CHIG,i) = chi_guarded;
+      s(SCR_OOPSI4,i) = pow(chi_guarded, -4./opt.chi_psi_power);
+    });
+    member.team_barrier();
+
+    // ---------------------------------------------------------------------------------
+    // Stage 5: lapse and curvature terms, RHS of Khat, chi, Theta, g, and A
+    //
+    par_for_inner(member, is, ie, [&](const int i) {
+      AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> Ddalpha_dd;
+      AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> AA_dd;
+      Real chi_guarded = s(SCR_CHIG,i);
+      Real oopsi4 = s(SCR_OOPSI4,i);
+      Real alpha = z4c.alpha(m,k,j,i);
+      Real K = z4c.vKhat(m,k,j,i) + 2.*z4c.vTheta(m,k,j,i);
+
+      // 2nd covariant derivative of the lapse, and its trace
+      Real dphi_dalpha = 0.0;
+      for (int c = 0; c < 3; ++c)
+      for (int d = 0; d < 3; ++d) {
+        dphi_dalpha += s(SCR_GUU+SymIdx(c,d),i)*s(SCR_DPHI+c,i)*s(SCR_DALPHA+d,i);
+      }
+      Real Ddalpha = 0.0;
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        Ddalpha_dd(a,b) = s(SCR_DDALPHA+SymIdx(a,b),i)
+                        - 2.*(s(SCR_DPHI+a,i)*s(SCR_DALPHA+b,i) +
+                              s(SCR_DPHI+b,i)*s(SCR_DALPHA+a,i))
+                        + 2.*z4c.g_dd(m,a,b,k,j,i)*dphi_dalpha;
+        for (int c = 0; c < 3; ++c) {
+          Ddalpha_dd(a,b) -= s(SCR_GAMUDD+6*c+SymIdx(a,b),i)*s(SCR_DALPHA+c,i);
+        }
+      }
+      for (int a = 0; a < 3; ++a)
+      for (int b = 0; b < 3; ++b) {
+        Ddalpha += oopsi4 * s(SCR_GUU+SymIdx(a,b),i) * Ddalpha_dd(a,b);
+      }
+
+      // contractions of A_ab, Ricci scalar, trace of matter stress tensor
+      Real AA = 0.0, R = 0.0, S = 0.0;
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        AA_dd(a,b) = 0.0;
+        for (int c = 0; c < 3; ++c)
+        for (int d = 0; d < 3; ++d) {
+          AA_dd(a,b) += s(SCR_GUU+SymIdx(c,d),i) * z4c.vA_dd(m,a,c,k,j,i)
+                      * z4c.vA_dd(m,d,b,k,j,i);
+        }
+      }
+      for (int a = 0; a < 3; ++a)
+      for (int b = 0; b < 3; ++b) {
+        AA += s(SCR_GUU+SymIdx(a,b),i) * AA_dd(a,b);
+        R += oopsi4 * s(SCR_GUU+SymIdx(a,b),i) * s(SCR_RTOT+SymIdx(a,b),i);
+        if (!is_vacuum) {
+          S += oopsi4 * s(SCR_GUU+SymIdx(a,b),i) * tmunu.S_dd(m,a,b,k,j,i);
+        }
+      }
+      Real Ht = R + (2./3.)*SQR(K) - AA;
+
+      Real dbeta = s(SCR_DBETA,i) + s(SCR_DBETA+4,i) + s(SCR_DBETA+8,i);
+
+      // Khat, chi, and Theta
+      rhs.vKhat(m,k,j,i) = - Ddalpha + alpha * (AA + (1./3.)*SQR(K)) +
+        s(SCR_LKHAT,i) + opt.damp_kappa1*(1 - opt.damp_kappa2)
+        * alpha * z4c.vTheta(m,k,j,i);
+      if (!is_vacuum) {
+        rhs.vKhat(m,k,j,i) += 4.*M_PI * alpha * (S + tmunu.E(m,k,j,i));
+      }
+      rhs.chi(m,k,j,i) = s(SCR_LCHI,i) + (1./6.) * opt.chi_psi_power * chi_guarded * dbeta
+                       - (1./6.) * opt.chi_psi_power * chi_guarded * alpha * K;
+      rhs.vTheta(m,k,j,i) = s(SCR_LTHETA,i) + alpha * (
+          0.5*Ht - (2. + opt.damp_kappa2) * opt.damp_kappa1 * z4c.vTheta(m,k,j,i));
+      if (!is_vacuum) {
+        rhs.vTheta(m,k,j,i) -= 8.*M_PI * alpha * tmunu.E(m,k,j,i);
+      }
+      rhs.vTheta(m,k,j,i) *= opt.use_z4c;
+
+      // g and A
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        Real Lg = s(SCR_LG+SymIdx(a,b),i) - (2./3.) * z4c.g_dd(m,a,b,k,j,i) * dbeta;
+        Real LA = s(SCR_LA+SymIdx(a,b),i) - (2./3.) * z4c.vA_dd(m,a,b,k,j,i) * dbeta;
+        for (int c = 0; c < 3; ++c) {
+          Lg += s(SCR_DBETA+3*a+c,i) * z4c.g_dd(m,b,c,k,j,i);
+          Lg += s(SCR_DBETA+3*b+c,i) * z4c.g_dd(m,a,c,k,j,i);
+          LA += s(SCR_DBETA+3*b+c,i) * z4c.vA_dd(m,a,c,k,j,i);
+          LA += s(SCR_DBETA+3*a+c,i) * z4c.vA_dd(m,b,c,k,j,i);
+        }
+        rhs.g_dd(m,a,b,k,j,i) = - 2. * alpha * z4c.vA_dd(m,a,b,k,j,i) + Lg;
+        rhs.vA_dd(m,a,b,k,j,i) = oopsi4 *
+            (-Ddalpha_dd(a,b) + alpha * s(SCR_RTOT+SymIdx(a,b),i));
+        rhs.vA_dd(m,a,b,k,j,i) -= (1./3.) * z4c.g_dd(m,a,b,k,j,i)
+                               * (-Ddalpha + alpha*R);
+        rhs.vA_dd(m,a,b,k,j,i) += alpha * (K*z4c.vA_dd(m,a,b,k,j,i) - 2.*AA_dd(a,b));
+        rhs.vA_dd(m,a,b,k,j,i) += LA;
+        if (!is_vacuum) {
+          rhs.vA_dd(m,a,b,k,j,i) -= 8.*M_PI * alpha *
+                  (oopsi4*tmunu.S_dd(m,a,b,k,j,i) - (1./3.)*S*z4c.g_dd(m,a,b,k,j,i));
+        }
+      }
+    });
+
+    // ---------------------------------------------------------------------------------
+    // Stage 6: RHS of Gamma's and gauge (lapse and shift)
+    //
+    par_for_inner(member, is, ie, [&](const int i) {
+      Real chi_guarded = s(SCR_CHIG,i);
+      Real alpha = z4c.alpha(m,k,j,i);
+      Real dbeta = s(SCR_DBETA,i) + s(SCR_DBETA+4,i) + s(SCR_DBETA+8,i);
+
+      // A^ab
+      AthenaScratchTensor<Real, TensorSymm::SYM2, 3, 2> A_uu;
+      for (int a = 0; a < 3; ++a)
+      for (int b = a; b < 3; ++b) {
+        A_uu(a,b) = 0.0;
+        for (int c = 0; c < 3; ++c)
+        for (int d = 0; d < 3; ++d) {
+          A_uu(a,b) += s(SCR_GUU+SymIdx(a,c),i) * s(SCR_GUU+SymIdx(b,d),i)
+                     * z4c.vA_dd(m,c,d,k,j,i);
+        }
+      }
+
+      // 2nd "divergence" of beta
+      Real ddbeta_d[3];
+      for (int a = 0; a < 3; ++a) {
+        ddbeta_d[a] = 0.0;
+        for (int b = 0; b < 3; ++b) {
+          ddbeta_d[a] += (1./3.) * s(SCR_DDBETA+6*b+SymIdx(a,b),i);
+        }
+      }
+
+      for (int a = 0; a < 3; ++a) {
+        // covariant derivative of A
+        Real DA_u = 0.0;
+        for (int b = 0; b < 3; ++b) {
+          DA_u -= (3./2.) * A_uu(a,b) * s(SCR_DCHI+b,i) / chi_guarded;
+          DA_u -= (1./3.) * s(SCR_GUU+SymIdx(a,b),i) *
+                  (2.*s(SCR_DKHAT+b,i) + s(SCR_DTHETA+b,i));
+        }
+        for (int b = 0; b < 3; ++b)
+        for (int c = 0; c < 3; ++c) {
+          DA_u += s(SCR_GAMUDD+6*a+SymIdx(b,c),i) * A_uu(b,c);
+        }
+
+        // Lie derivative of Gamma (note that this is not a real Lie derivative)
+        Real LGam_u = s(SCR_LGAM+a,i) + (2./3.) * s(SCR_GAMU+a,i) * dbeta;
+        for (int b = 0; b < 3; ++b) {
+          LGam_u += s(SCR_GUU+SymIdx(a,b),i) * ddbeta_d[b]
+                  - s(SCR_GAMU+b,i) * s(SCR_DBETA+3*b+a,i);
+          for (int c = 0; c < 3; ++c) {
+            LGam_u += s(SCR_GUU+SymIdx(b,c),i) * s(SCR_DDBETA+6*a+SymIdx(b,c),i);
+          }
+        }
+
+        rhs.vGam_u(m,a,k,j,i) = 2.*alpha*DA_u + LGam_u;
+        rhs.vGam_u(m,a,k,j,i) -= 2.*alpha * opt.damp_kappa1 *
+            (z4c.vGam_u(m,a,k,j,i) - s(SCR_GAMU+a,i));
+        for (int b = 0; b < 3; ++b) {
+          rhs.vGam_u(m,a,k,j,i) -= 2. * A_uu(a,b) * s(SCR_DALPHA+b,i);
+          if (!is_vacuum) {
+            rhs.vGam_u(m,a,k,j,i) -= 16.*M_PI * alpha
+                                * s(SCR_GUU+SymIdx(a,b),i) * tmunu.S_d(m,b,k,j,i);
+          }
+        }
+      }
+
+      // lapse function
+      Real const f = opt.lapse_oplog * opt.lapse_harmonicf
+                   + opt.lapse_harmonic * alpha;
+      rhs.alpha(m,k,j,i) = opt.lapse_advect * s(SCR_LALPHA,i)
+                         - f * alpha * z4c.vKhat(m,k,j,i);
+
+      // shift vector, including harmonic gauge terms
+      for (int a = 0; a < 3; ++a) {
+        rhs.beta_u(m,a,k,j,i) = opt.shift_ggamma * z4c.vGam_u(m,a,k,j,i)
+                              + opt.shift_advect * s(SCR_LBETA+a,i);
+        rhs.beta_u(m,a,k,j,i) -= opt.shift_eta * z4c.beta_u(m,a,k,j,i);
+        rhs.beta_u(m,a,k,j,i) += opt.shift_alpha2ggamma *
+                            SQR(alpha) * z4c.vGam_u(m,a,k,j,i);
+        for (int b = 0; b < 3; ++b) {
+          rhs.beta_u(m,a,k,j,i) += opt.shift_hh * alpha * chi_guarded *
+            (0.5 * alpha * s(SCR_DCHI+b,i) - s(SCR_DALPHA+b,i)) *
+            s(SCR_GUU+SymIdx(a,b),i);
+        }
+      }
+    });
+
+    // ---------------------------------------------------------------------------------
+    // Stage 7: Kreiss-Oliger dissipation (with opt.fused_diss)
+    //
+    if (fused_diss) {
+      member.team_barrier();
+      par_for_inner(member, is, ie, [&](const int i) {
+        for (int n = 0; n < nz4c; ++n) {
+          Real dterm = 0.0;
+          for (int a = 0; a < 3; ++a) {
+            dterm += Diss<NGHOST>(a, idx, u0, m, n, k, j, i);
+          }
+          u_rhs(m,n,k,j,i) += dterm*diss;
+        }
+      });
+    }
+  });
+  return;
+}
+
+template void Z4c::CalcRHSStaged<2>();
+template void Z4c::CalcRHSStaged<3>();
+template void Z4c::CalcRHSStaged<4>();
+} // namespace z4c
@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include <algorithm>
 #include <cinttypes>
+#include <cmath>
 #include <iostream>
 #include <limits>
 
@@ -22,11 +23,52 @@
 #include "coordinates/cell_locations.hpp"
 
 namespace z4c {
+//----------------------------------------------------------------------------------------
+// \!fn void Z4c::SetWeylBlocks()
+// \brief flags the MeshBlocks whose bounding box, widened by 2*ng+1 of its cells, meets
+// the shell of any extraction sphere.  Only values in these MeshBlocks (and ghost zones
+// filled from them, including across one change in level) are read when interpolating
+// psi4 to the spheres.  With <z4c>/weyl_shells_only=false all MeshBlocks are flagged.
+// Rebuilt only when the Mesh has changed.
+void Z4c::SetWeylBlocks() {
+  if (weyl_nregrid == pmy_pack->pmesh->nregrid) return;
+  auto &size = pmy_pack->pmb->mb_size;
+  int ng = pmy_pack->pmesh->mb_indcs.ng;
+  int nmb = pmy_pack->nmb_thispack;
+  if (weyl_mb.extent_int(0) < nmb) {Kokkos::realloc(weyl_mb, nmb);}
+  for (int m=0; m<nmb; ++m) {
+    auto &s = size.h_view(m);
+    Real xmin[3] = {s.x1min, s.x2min, s.x3min};
+    Real xmax[3] = {s.x1max, s.x2max, s.x3max};
+    Real margin = (2*ng + 1)*std::max(s.dx1, std::max(s.dx2, s.dx3));
+    int flag = (weyl_shells_only)? 0 : 1;
+    for (auto &grid : spherical_grids) {
+      // nearest and farthest distance from center of sphere to MeshBlock
+      Real dmin2 = 0.0, dmax2 = 0.0;
+      for (int d=0; d<3; ++d) {
+        Real lo = xmin[d] - grid->center[d], hi = xmax[d] - grid->center[d];
+        Real near = (lo > 0.0)? lo : ((hi < 0.0)? -hi : 0.0);
+        dmin2 += SQR(near);
+        dmax2 += SQR(std::max(std::abs(lo), std::abs(hi)));
+      }
+      if ((std::sqrt(dmin2) <= grid->radius + margin) &&
+          (std::sqrt(dmax2) >= grid->radius - margin)) {
+        flag = 1;
+      }
+    }
+    weyl_mb.h_view(m) = flag;
+  }
+  weyl_mb.template modify<HostMemSpace>();
+  weyl_mb.template sync<DevExeSpace>();
+  weyl_nregrid = pmy_pack->pmesh->nregrid;
+}
+
 //----------------------------------------------------------------------------------------
 // \!fn void Z4c::Z4cWeyl(MeshBlockPack *pmbp)
 // \brief compute the weyl scalars given the adm variables and matter state
 //
-// This function operates only on the interior points of the MeshBlock
+// This function operates only on the interior points of the MeshBlock, and only in
+// MeshBlocks flagged by SetWeylBlocks() (the scalars are zero in all others)
 template <int NGHOST>
 void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
   // capture variables for the kernel
@@ -41,9 +83,16 @@ void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
   auto &weyl = pmbp->pz4c->weyl;
   auto &u_weyl = pmbp->pz4c->u_weyl;
   Kokkos::deep_copy(u_weyl, 0.);
+  auto &weyl_mb = pmbp->pz4c->weyl_mb;
+
+  // derivatives of g and K are read from those stored by ADMConstraints() this cycle,
+  // when available
+  bool use_drv = pmbp->pz4c->adm_drv_ready;
+  auto &adm_drv = pmbp->pz4c->adm_drv;
 
   par_for("z4c_weyl_scalar",DevExeSpace(),0,nmb-1,ks,ke,js,je,is,ie,
   KOKKOS_LAMBDA(const int m, const int k, const int j, const int i) {
+    if (weyl_mb.d_view(m) == 0) return;
     // Simplify constants (2 & sqrt 2 factors) featured in re/im[psi4]
     const Real FR4 = 0.25;
     Real &x1min = size.d_view(m).x1min;
@@ -138,22 +187,35 @@ void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
     // -----------------------------------------------------------------------------------
     // derivatives
     //
-    // first derivatives of g and K
-    for(int c = 0; c < 3; ++c)
-    for(int a = 0; a < 3; ++a)
-    for(int b = 0; b < 3; ++b) {
-      dg_ddd(c,a,b) = Dx<NGHOST>(c, idx, adm.g_dd, m,a,b,k,j,i);
-      dK_ddd(c,a,b) = Dx<NGHOST>(c, idx, adm.vK_dd, m,a,b,k,j,i);
-    }
-    // second derivatives of g
-    for(int a = 0; a < 3; ++a)
-    for(int b = a; b < 3; ++b)
-    for(int c = 0; c < 3; ++c)
-    for(int d = c; d < 3; ++d) {
-      if(a == b) {
-        ddg_dddd(a,b,c,d) = Dxx<NGHOST>(a, idx, adm.g_dd, m,c,d,k,j,i);
-      } else {
-        ddg_dddd(a,b,c,d) = Dxy<NGHOST>(a, b, idx, adm.g_dd, m,c,d,k,j,i);
+    if (use_drv) {
+      for(int c = 0; c < 3; ++c)
+      for(int a = 0; a < 3; ++a)
+      for(int b = a; b < 3; ++b) {
+        dg_ddd(c,a,b) = adm_drv(m,IADM_DG+6*c+SymIdx(a,b),k-ks,j-js,i-is);
+        dK_ddd(c,a,b) = adm_drv(m,IADM_DK+6*c+SymIdx(a,b),k-ks,j-js,i-is);
+        for(int d = c; d < 3; ++d) {
+          ddg_dddd(c,d,a,b) =
+              adm_drv(m,IADM_DDG+6*SymIdx(a,b)+SymIdx(c,d),k-ks,j-js,i-is);
+        }
+      }
+    } else {
+      // first derivatives of g and K
+      for(int c = 0; c < 3; ++c)
+      for(int a = 0; a < 3; ++a)
+      for(int b = 0; b < 3; ++b) {
+        dg_ddd(c,a,b) = Dx<NGHOST>(c, idx, adm.g_dd, m,a,b,k,j,i);
+        dK_ddd(c,a,b) = Dx<NGHOST>(c, idx, adm.vK_dd, m,a,b,k,j,i);
+      }
+      // second derivatives of g
+      for(int a = 0; a < 3; ++a)
+      for(int b = a; b < 3; ++b)
+      for(int c = 0; c < 3; ++c)
+      for(int d = c; d < 3; ++d) {
+        if(a == b) {
+          ddg_dddd(a,b,c,d) = Dxx<NGHOST>(a, idx, adm.g_dd, m,c,d,k,j,i);
+        } else {
+          ddg_dddd(a,b,c,d) = Dxy<NGHOST>(a, b, idx, adm.g_dd, m,c,d,k,j,i);
+        }
       }
     }
 
@@ -405,6 +467,7 @@ void Z4c::Z4cWeyl(MeshBlockPack *pmbp) {
     weyl.rpsi4(m,k,j,i) *= r;
     weyl.ipsi4(m,k,j,i) *= r;
   });
+  pmbp->pz4c->adm_drv_ready = false;
 }
 
 template void Z4c::Z4cWeyl<2>(MeshBlockPack *pmbp);
@@ -18,9 +18,13 @@
 #include "tasklist/task_list.hpp"
 #include "mesh/mesh.hpp"
 #include "bvals/bvals.hpp"
+#include "mhd/mhd.hpp"
 #include "z4c/compact_object_tracker.hpp"
+#include "z4c/horizon_finder.hpp"
+#include "utils/lagrange_interpolator.hpp"
 #include "z4c/z4c.hpp"
 #include "tasklist/numerical_relativity.hpp"
+#include "coordinates/coordinates.hpp"
 
 namespace z4c {
 
@@ -56,17 +60,54 @@ void Z4c::QueueZ4cTasks() {
   }
   pnr->QueueTask(&Z4c::Z4cBoundaryRHS, this, Z4c_SomBC, "Z4c_SomBC", Task_Run,
                  {Z4c_CalcRHS});
-  pnr->QueueTask(&Z4c::ExpRKUpdate, this, Z4c_ExplRK, "Z4c_ExplRK", Task_Run,
-                 {Z4c_SomBC},{MHD_EField});
-  pnr->QueueTask(&Z4c::RestrictU, this, Z4c_RestU, "Z4c_RestU", Task_Run, {Z4c_ExplRK});
-  pnr->QueueTask(&Z4c::SendU, this, Z4c_SendU, "Z4c_SendU", Task_Run, {Z4c_RestU});
-  pnr->QueueTask(&Z4c::RecvU, this, Z4c_RecvU, "Z4c_RecvU", Task_Run, {Z4c_SendU});
+  if (coalesce_halo) {
+    // Conserved MHD variables are sent with u, so u is sent once the MHD update is done.
+    // Since MHD_EField now waits for Z4c_RecvU, the ordering between the MHD tasks and
+    // the metric update is instead enforced by Z4c_Z4c2ADM below.
+    pnr->QueueTask(&Z4c::ExpRKUpdate, this, Z4c_ExplRK, "Z4c_ExplRK", Task_Run,
+                   {Z4c_SomBC});
+    pnr->QueueTask(&Z4c::RestrictU, this, Z4c_RestU, "Z4c_RestU", Task_Run,
+                   {Z4c_ExplRK});
+    pnr->QueueTask(&Z4c::SendU, this, Z4c_SendU, "Z4c_SendU", Task_Run,
+                   {Z4c_RestU, MHD_RestU});
+  } else {
+    pnr->QueueTask(&Z4c::ExpRKUpdate, this, Z4c_ExplRK, "Z4c_ExplRK", Task_Run,
+                   {Z4c_SomBC},{MHD_EField});
+    pnr->QueueTask(&Z4c::RestrictU, this, Z4c_RestU, "Z4c_RestU", Task_Run,
+                   {Z4c_ExplRK});
+    pnr->QueueTask(&Z4c::SendU, this, Z4c_SendU, "Z4c_SendU", Task_Run, {Z4c_RestU});
+  }
+  if (opt.overlap_rhs) {
+    // RHS of the next stage in the interior of MeshBlocks overlaps the ghost exchange
+    switch (indcs.ng) {
+      case 2:
+        pnr->QueueTask(&Z4c::CalcRHSInterior<2>, this, Z4c_RHSInt, "Z4c_RHSInt",
+                       Task_Run, {Z4c_SendU});
+        break;
+      case 3:
+        pnr->QueueTask(&Z4c::CalcRHSInterior<3>, this, Z4c_RHSInt, "Z4c_RHSInt",
+                       Task_Run, {Z4c_SendU});
+        break;
+      case 4:
+        pnr->QueueTask(&Z4c::CalcRHSInterior<4>, this, Z4c_RHSInt, "Z4c_RHSInt",
+                       Task_Run, {Z4c_SendU});
+        break;
+    }
+    pnr->QueueTask(&Z4c::RecvU, this, Z4c_RecvU, "Z4c_RecvU", Task_Run, {Z4c_RHSInt});
+  } else {
+    pnr->QueueTask(&Z4c::RecvU, this, Z4c_RecvU, "Z4c_RecvU", Task_Run, {Z4c_SendU});
+  }
   pnr->QueueTask(&Z4c::ApplyPhysicalBCs, this, Z4c_BCS, "Z4c_BCS", Task_Run, {Z4c_RecvU});
   pnr->QueueTask(&Z4c::Prolongate, this, Z4c_Prolong, "Z4c_Prolong", Task_Run, {Z4c_BCS});
   pnr->QueueTask(&Z4c::EnforceAlgConstr, this, Z4c_AlgC, "Z4c_AlgC", Task_Run,
                  {Z4c_Prolong});
-  pnr->QueueTask(&Z4c::ConvertZ4cToADM, this, Z4c_Z4c2ADM, "Z4c_Z4c2ADM",
-                 Task_Run, {Z4c_AlgC});
+  if (coalesce_halo) {
+    pnr->QueueTask(&Z4c::ConvertZ4cToADM, this, Z4c_Z4c2ADM, "Z4c_Z4c2ADM",
+                   Task_Run, {Z4c_AlgC, MHD_EField});
+  } else {
+    pnr->QueueTask(&Z4c::ConvertZ4cToADM, this, Z4c_Z4c2ADM, "Z4c_Z4c2ADM",
+                   Task_Run, {Z4c_AlgC});
+  }
   if (pmy_pack->pdyngr != nullptr) {
     pnr->QueueTask(&Z4c::UpdateExcisionMasks, this, Z4c_Excise, "Z4c_Excise", Task_Run,
                    {Z4c_Z4c2ADM});
@@ -103,7 +144,7 @@ void Z4c::QueueZ4cTasks() {
 //  receive status flags to waiting (with or without MPI) for Wave variables.
 
 TaskStatus Z4c::InitRecv(Driver *pdrive, int stage) {
-  TaskStatus tstat = pbval_u->InitRecv(nz4c);
+  TaskStatus tstat = pbval_u->InitRecv(nvar_halo);
   if (tstat != TaskStatus::complete) return tstat;
   return tstat;
 }
@@ -133,8 +174,6 @@ TaskStatus Z4c::ClearSend(Driver *pdrive, int stage) {
 //! \brief  copy u0 --> u1 in first stage
 
 TaskStatus Z4c::CopyU(Driver *pdrive, int stage) {
-  auto integrator = pdrive->integrator;
-
   auto &indcs = pmy_pack->pmesh->mb_indcs;
   int is = indcs.is, ie = indcs.ie;
   int js = indcs.js, je = indcs.je;
@@ -147,11 +186,11 @@ TaskStatus Z4c::CopyU(Driver *pdrive, int stage) {
   // hierarchical parallel loop that updates conserved variables to intermediate step
   // using weights and fractional time step appropriate to stages of time-integrator.
   // Important to use vector inner loop for good performance on cpus
-  if (integrator == "rk4") {
+  if (pdrive->low_storage) {
     Real &delta = pdrive->delta[stage-1];
     if (stage == 1) {
       Kokkos::deep_copy(DevExeSpace(), u1, u0);
-    } else {
+    } else if (delta != 0.0) {
       par_for("CopyCons", DevExeSpace(),0, nmb1, 0, nvar-1, ks, ke, js, je, is, ie,
       KOKKOS_LAMBDA(int m, int n, int k, int j, int i){
         u1(m,n,k,j,i) += delta*u0(m,n,k,j,i);
@@ -165,12 +204,27 @@ TaskStatus Z4c::CopyU(Driver *pdrive, int stage) {
   return TaskStatus::complete;
 }
 
+//----------------------------------------------------------------------------------------
+//! \fn CCFieldList Z4c::HaloFields
+//! \brief Returns list of arrays communicated in pbval_u buffers: Z4c variables, followed
+//! by conserved MHD variables with coalesce_halo
+
+CCFieldList Z4c::HaloFields() {
+  CCFieldList flds;
+  flds.Add(u0, coarse_u0);
+  if (coalesce_halo) {
+    flds.Add(pmy_pack->pmhd->u0, pmy_pack->pmhd->coarse_u0);
+  }
+  return flds;
+}
+
 //----------------------------------------------------------------------------------------
 //! \fn  void Z4c::SendU
 //! \brief sends cell-centered conserved variables
+//! With coalesce_halo, conserved MHD variables are sent in the same messages.
 
 TaskStatus Z4c::SendU(Driver *pdrive, int stage) {
-  TaskStatus tstat = pbval_u->PackAndSendCC(u0, coarse_u0);
+  TaskStatus tstat = pbval_u->PackAndSendCC(HaloFields());
   return tstat;
 }
 
@@ -179,7 +233,7 @@ TaskStatus Z4c::SendU(Driver *pdrive, int stage) {
 //! \brief receives cell-centered conserved variables
 
 TaskStatus Z4c::RecvU(Driver *pdrive, int stage) {
-  TaskStatus tstat = pbval_u->RecvAndUnpackCC(u0, coarse_u0);
+  TaskStatus tstat = pbval_u->RecvAndUnpackCC(HaloFields());
   return tstat;
 }
 
@@ -195,12 +249,16 @@ TaskStatus Z4c::EnforceAlgConstr(Driver *pdrive, int stage) {
 }
 
 //----------------------------------------------------------------------------------------
-//! \fn  void Z4c::ADMToZ4c_
-//! \brief
+//! \fn  void Z4c::ConvertZ4cToADM
+//! \brief With matter, ADM variables are needed by DynGRMHD in every stage and are
+//! computed here.  In vacuum they are only marked as out of date, and are computed by
+//! UpdateADM() when constraints, trackers, horizon finders or outputs read them.
 
 TaskStatus Z4c::ConvertZ4cToADM(Driver *pdrive, int stage) {
-  if (pmy_pack->pdyngr != nullptr || stage == pdrive->nexp_stages) {
+  if (pmy_pack->pdyngr != nullptr) {
     Z4cToADM(pmy_pack);
+  } else {
+    adm_current = false;
   }
   return TaskStatus::complete;
 }
@@ -222,7 +280,9 @@ TaskStatus Z4c::UpdateExcisionMasks(Driver *pdrive, int stage) {
 
 TaskStatus Z4c::ADMConstraints_(Driver *pdrive, int stage) {
   auto &indcs = pmy_pack->pmesh->mb_indcs;
-  if (stage == pdrive->nexp_stages) {
+  if (stage == pdrive->nexp_stages &&
+      pmy_pack->pmesh->ncycle % opt.constraints_every == 0) {
+    UpdateADM();
     switch (indcs.ng) {
       case 2: ADMConstraints<2>(pmy_pack);
               break;
@@ -242,7 +302,7 @@ TaskStatus Z4c::ADMConstraints_(Driver *pdrive, int stage) {
 TaskStatus Z4c::RestrictU(Driver *pdrive, int stage) {
   // Only execute Mesh function with SMR/SMR
   if (pmy_pack->pmesh->multilevel) {
-    pmy_pack->pmesh->pmr->RestrictCC(u0, coarse_u0, true);
+    pmy_pack->pmesh->pmr->RestrictCCBndry(u0, coarse_u0, true);
   }
   return TaskStatus::complete;
 }
@@ -279,11 +339,37 @@ TaskStatus Z4c::ApplyPhysicalBCs(Driver *pdrive, int stage) {
 }
 
 TaskStatus Z4c::TrackCompactObjects(Driver *pdrive, int stage) {
-  if (stage == pdrive->nexp_stages) {
+  if (stage != pdrive->nexp_stages || (ptracker.empty() && phorizons.empty())) {
+    return TaskStatus::complete;
+  }
+  if (ptracker_interp == nullptr) {
+    ptracker_interp = std::make_unique<LagrangeInterpolator>(pmy_pack);
+  }
+  if (!(ptracker.empty())) {
+    CompactObjectTracker::InterpolateVelocities(pmy_pack, ptracker, *ptracker_interp);
     for (auto & pt : ptracker) {
-      pt.InterpolateVelocity(pmy_pack);
       pt.EvolveTracker();
-      pt.WriteTracker();
+      pt.WriteTracker(pdrive->host_tasks);
+    }
+  }
+  if (!(phorizons.empty())) {
+    for (auto & ph : phorizons) {
+      ph.Find(ptracker, *ptracker_interp);
+    }
+    // excise a fraction of the minimum radius of each horizon found
+    Coordinates *pcoord = pmy_pack->pcoord;
+    if (pcoord != nullptr && pcoord->coord_data.bh_excise &&
+        pcoord->coord_data.excision_scheme == ExcisionScheme::horizon) {
+      pcoord->excision_spheres.clear();
+      for (auto & ph : phorizons) {
+        if (ph.found) {
+          pcoord->excision_spheres.push_back(ph.center[0]);
+          pcoord->excision_spheres.push_back(ph.center[1]);
+          pcoord->excision_spheres.push_back(ph.center[2]);
+          pcoord->excision_spheres.push_back(pcoord->coord_data.excise_horizon_frac*
+                                             ph.rmin);
+        }
+      }
     }
   }
   return TaskStatus::complete;
@@ -301,6 +387,8 @@ TaskStatus Z4c::CalcWeylScalar(Driver *pdrive, int stage) {
     float time_32 = static_cast<float>(pmy_pack->pmesh->time);
     if (last_output_time==time_32 && stage == pdrive->nexp_stages) {
       auto &indcs = pmy_pack->pmesh->mb_indcs;
+      UpdateADM();
+      SetWeylBlocks();
       switch (indcs.ng) {
         case 2: Z4cWeyl<2>(pmy_pack);
                 break;
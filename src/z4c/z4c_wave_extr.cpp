@@ -17,6 +17,8 @@
 #include <fstream>
 #include <algorithm>
 #include <string>
+#include <memory>
+#include <vector>
 
 #ifdef MPI_PARALLEL
 #include <mpi.h>
@@ -60,6 +62,40 @@ void swsh(Real * ylmR, Real * ylmI, int l, int m, Real theta, Real phi) {
 int LmIndex(int l,int m) {
     return l*l+m+l-4;
 }
+//----------------------------------------------------------------------------------------
+// \!fn void Z4c::SetSWSHWeights()
+// \brief precompute spin-weighted spherical harmonics times solid angles at the angles
+// of the wave extraction spheres, which are the same for all radii
+
+void Z4c::SetSWSHWeights() {
+  auto &grids = spherical_grids;
+  int lmax = 8;
+  int nlm = (lmax+1)*(lmax+1) - 4;
+  int nangles = grids[0]->nangles;
+  Kokkos::realloc(swsh_wghts, nlm, nangles, 2);
+  Kokkos::realloc(psi4_lm, grids.size(), nlm, 2);
+
+  auto wghts_h = Kokkos::create_mirror_view(swsh_wghts);
+  Real ylmR,ylmI;
+  for (int l = 2; l < lmax+1; ++l) {
+    for (int m = -l; m < l+1 ; ++m) {
+      for (int ip = 0; ip < nangles; ++ip) {
+        Real theta = grids[0]->polar_pos.h_view(ip,0);
+        Real phi = grids[0]->polar_pos.h_view(ip,1);
+        Real weight = grids[0]->solid_angles.h_view(ip);
+        swsh(&ylmR,&ylmI,l,m,theta,phi);
+        wghts_h(LmIndex(l,m),ip,0) = weight*ylmR;
+        wghts_h(LmIndex(l,m),ip,1) = weight*ylmI;
+      }
+    }
+  }
+  Kokkos::deep_copy(swsh_wghts, wghts_h);
+
+  std::vector<SphericalGrid*> pgrids;
+  for (auto &grid : grids) {pgrids.push_back(grid.get());}
+  wave_batch = std::make_unique<SphericalGridBatch>(pmy_pack, pgrids);
+}
+
 //----------------------------------------------------------------------------------------
 // \!fn void Z4c::Z4cWeyl(MeshBlockPack *pmbp)
 // \brief compute the weyl scalars given the adm variables and matter state
@@ -76,38 +112,54 @@ void Z4c::WaveExtr(MeshBlockPack *pmbp) {
 
   // maximum l; TODO(@hzhu): read in from input file
   int lmax = 8;
+  int nlm = (lmax+1)*(lmax+1) - 4;
+  int nangles = grids[0]->nangles;
   // bool bitant = false;
 
-  Real ylmR,ylmI;
+  // Interpolate Weyl scalars to the surfaces of all spheres (points of sphere g start at
+  // g*nangles)
+  wave_batch->InterpolateToSpheres(2, u_weyl);
+
+  // Project onto spin-weighted spherical harmonics, for all radii and (l,m) in one
+  // kernel with one team per (radius, mode) reducing over angles.
+  // The spherical harmonics transform as
+  // Y^s_{l m}( Pi-th, ph ) = (-1)^{l+s} Y^s_{l -m}(th, ph)
+  // but the PoisitionPolar function returns theta \in [0,\pi],
+  // so these are correct for bitant.
+  // With bitant, under reflection the imaginary part of
+  // the weyl scalar should pick a - sign,
+  // which is accounted for here.
+  // Real bitant_z_fac = (bitant && theta > M_PI/2) ? -1 : 1;
+  auto &wghts = swsh_wghts;
+  auto &vals = wave_batch->interp_vals.d_view;
+  auto &psi_lm = psi4_lm;
+  par_for_outer("wave_proj",DevExeSpace(),0,0,0,(nradii-1),0,(nlm-1),
+  KOKKOS_LAMBDA(TeamMember_t tmember, const int g, const int lm) {
+    Real psilmR = 0.0;
+    Real psilmI = 0.0;
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nangles),
+    [=](const int ip, Real &sum) {
+      int n = g*nangles + ip;
+      sum += vals(n,0)*wghts(lm,ip,0) + vals(n,1)*wghts(lm,ip,1);
+    }, psilmR);
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(tmember, nangles),
+    [=](const int ip, Real &sum) {
+      int n = g*nangles + ip;
+      sum += vals(n,1)*wghts(lm,ip,0) - vals(n,0)*wghts(lm,ip,1);
+    }, psilmI);
+    Kokkos::single(Kokkos::PerTeam(tmember), [&]() {
+      psi_lm.d_view(g,lm,0) = psilmR;
+      psi_lm.d_view(g,lm,1) = psilmI;
+    });
+  });
+  psi4_lm.template modify<DevExeSpace>();
+  psi4_lm.template sync<HostMemSpace>();
+
   int count = 0;
   for (int g=0; g<nradii; ++g) {
-    // Interpolate Weyl scalars to the surface
-    grids[g]->InterpolateToSphere(2, u_weyl);
-    for (int l = 2; l < lmax+1; ++l) {
-      for (int m = -l; m < l+1 ; ++m) {
-        Real psilmR = 0.0;
-        Real psilmI = 0.0;
-          for (int ip = 0; ip < grids[g]->nangles; ++ip) {
-            Real theta = grids[g]->polar_pos.h_view(ip,0);
-            Real phi = grids[g]->polar_pos.h_view(ip,1);
-            Real datareal = grids[g]->interp_vals.h_view(ip,0);
-            Real dataim = grids[g]->interp_vals.h_view(ip,1);
-            Real weight = grids[g]->solid_angles.h_view(ip);
-            swsh(&ylmR,&ylmI,l,m,theta,phi);
-            // The spherical harmonics transform as
-            // Y^s_{l m}( Pi-th, ph ) = (-1)^{l+s} Y^s_{l -m}(th, ph)
-            // but the PoisitionPolar function returns theta \in [0,\pi],
-            // so these are correct for bitant.
-            // With bitant, under reflection the imaginary part of
-            // the weyl scalar should pick a - sign,
-            // which is accounted for here.
-            // Real bitant_z_fac = (bitant && theta > M_PI/2) ? -1 : 1;
-            psilmR += weight*(datareal*ylmR + dataim*ylmI);
-            psilmI += weight*(dataim*ylmR - datareal*ylmI);
-          }
-        psi_out[count++] = psilmR;
-        psi_out[count++] = psilmI;
-      }
+    for (int lm = 0; lm < nlm; ++lm) {
+      psi_out[count++] = psi4_lm.h_view(g,lm,0);
+      psi_out[count++] = psi4_lm.h_view(g,lm,1);
     }
   }
 
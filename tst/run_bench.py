@@ -0,0 +1,163 @@
+#!/usr/bin/env python
+
+# Benchmark script.
+
+# Usage: From this directory, call this script with python:
+#        python run_bench.py [benchmark names] [--mpi N] [--cmake=...]
+#        or from a build directory: make bench
+
+# Runs the standard benchmark problems in inputs/bench, and collects the JSON summary
+# written by each run (see <time>/benchmark_file) into a single results file, together
+# with information about the build and the machine.  Compare results files across
+# releases and GPU generations to track performance regressions.
+
+# Notes:
+#   - Requires Python 3+.
+#   - Each benchmark requires an executable built with its problem generator.  Without
+#     --exe, one executable per problem generator is built in bench_build/.  With --exe
+#     (used by 'make bench'), only benchmarks for the problem generator of that
+#     executable (--problem) are run.
+
+# Modules
+import argparse
+import datetime
+import json
+import os
+import platform
+import subprocess
+import sys
+
+# Benchmark problems: name, input file (in inputs/bench), problem generator file
+# (-D PROBLEM=...), and list of variants, each a (suffix, command line overrides) tuple
+BENCHMARKS = [
+    ('hydro_linwave', 'hydro_linwave.athinput', 'built_in_pgens',
+     [('mb{0}'.format(n), ['meshblock/nx1={0}'.format(n), 'meshblock/nx2={0}'.format(n),
+                           'meshblock/nx3={0}'.format(n)]) for n in (16, 32, 64, 128)]),
+    ('mhd_linwave', 'mhd_linwave.athinput', 'built_in_pgens',
+     [('mb{0}'.format(n), ['meshblock/nx1={0}'.format(n), 'meshblock/nx2={0}'.format(n),
+                           'meshblock/nx3={0}'.format(n)]) for n in (16, 32, 64, 128)]),
+    ('gr_torus', 'gr_torus.athinput', 'gr_torus', [('', [])]),
+    ('z4c_onepuncture', 'z4c_onepuncture.athinput', 'z4c_one_puncture', [('', [])]),
+    ('rad_beam', 'rad_beam.athinput', 'rad_beam', [('', [])]),
+    ('particles', 'particles.athinput', 'part_random', [('', [])]),
+    ('blast_hydro_amr', 'blast_hydro_amr.athinput', 'blast', [('', [])]),
+]
+
+athena_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
+
+
+# Function for building an executable with the given problem generator
+def build(problem, build_dir, cmake_args):
+    if not os.path.isdir(build_dir):
+        os.makedirs(build_dir)
+    subprocess.check_call(['cmake', athena_dir, '-D', 'PROBLEM=' + problem]
+                          + cmake_args, cwd=build_dir)
+    subprocess.check_call(['cmake', '--build', '.', '-j8'], cwd=build_dir)
+    return os.path.join(build_dir, 'src', 'athena')
+
+
+# Function for running one benchmark, returns dict read from its JSON summary
+def run(exe, input_file, overrides, run_dir, nproc):
+    if not os.path.isdir(run_dir):
+        os.makedirs(run_dir)
+    json_file = os.path.join(run_dir, 'bench.json')
+    cmd = [exe, '-i', os.path.join(athena_dir, 'inputs', 'bench', input_file),
+           '-d', run_dir, 'time/benchmark_file=' + json_file] + overrides
+    if nproc > 1:
+        cmd = ['mpiexec', '-n', str(nproc)] + cmd
+    with open(os.path.join(run_dir, 'athena.log'), 'w') as log:
+        subprocess.check_call(cmd, stdout=log, stderr=subprocess.STDOUT)
+    with open(json_file) as f:
+        return json.load(f)
+
+
+# Main function
+def main(**kwargs):
+    names = kwargs['benchmarks']
+    outdir = os.path.abspath(kwargs['outdir'])
+    cmake_args = kwargs['cmake']
+    unknown = set(names) - set(b[0] for b in BENCHMARKS)
+    if unknown:
+        raise ValueError('Unknown benchmark(s): ' + ', '.join(sorted(unknown)))
+
+    results = {'date': datetime.datetime.now().isoformat(),
+               'host': platform.node(),
+               'machine': platform.machine(),
+               'nproc': kwargs['mpi'],
+               'cmake_args': cmake_args,
+               'runs': []}
+    executables = {}
+    if kwargs['exe'] is not None:
+        executables[kwargs['problem']] = os.path.abspath(kwargs['exe'])
+    failed = []
+    for name, input_file, problem, variants in BENCHMARKS:
+        if names and name not in names:
+            continue
+        if problem not in executables:
+            if kwargs['exe'] is not None:
+                print('Skipping {0}: requires PROBLEM={1}'.format(name, problem))
+                continue
+            executables[problem] = build(problem,
+                                         os.path.join(outdir, 'build_' + problem),
+                                         cmake_args)
+        for suffix, overrides in variants:
+            run_name = name + ('_' + suffix if suffix else '')
+            print('Running benchmark ' + run_name, flush=True)
+            try:
+                res = run(executables[problem], input_file, overrides,
+                          os.path.join(outdir, run_name), kwargs['mpi'])
+            except (subprocess.CalledProcessError, OSError, ValueError) as err:
+                print('  FAILED: {0}'.format(err))
+                failed.append(run_name)
+                continue
+            res['name'] = run_name
+            results['runs'].append(res)
+            print('  zone-cycles/s = {0:.4e}, run time = {1:.3f} s'.format(
+                res['zone_cycles_per_second'], res['run_time']))
+
+    results_file = os.path.join(outdir, kwargs['results'])
+    with open(results_file, 'w') as f:
+        json.dump(results, f, indent=2)
+    print('Results of {0} run(s) written to {1}'.format(len(results['runs']),
+                                                        results_file))
+    if failed:
+        print('Failed benchmarks: ' + ', '.join(failed))
+        return 1
+    return 0
+
+
+# Execute main function
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('benchmarks',
+                        type=str,
+                        default=None,
+                        nargs='*',
+                        help='names of benchmarks to run (all by default)')
+    parser.add_argument('--exe',
+                        type=str,
+                        default=None,
+                        help='prebuilt executable (only its --problem is run)')
+    parser.add_argument('--problem',
+                        type=str,
+                        default='built_in_pgens',
+                        help='problem generator of executable given by --exe')
+    parser.add_argument('--outdir',
+                        type=str,
+                        default='bench_build',
+                        help='directory for builds, runs, and results')
+    parser.add_argument('--results',
+                        type=str,
+                        default='bench_results.json',
+                        help='name of results file (in outdir)')
+    parser.add_argument('--mpi',
+                        type=int,
+                        default=1,
+                        help='number of MPI ranks used for each run')
+    parser.add_argument('--cmake',
+                        default=[],
+                        action='append',
+                        help='architecture specific args to pass to cmake, e.g. '
+                        '--cmake=-DKokkos_ENABLE_CUDA=On')
+    args = parser.parse_args()
+    sys.exit(main(**vars(args)))
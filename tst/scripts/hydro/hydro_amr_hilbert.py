@@ -0,0 +1,63 @@
+# Regression test for AMR with MeshBlocks ordered along a Hilbert curve
+#
+# Runs a 2D hydro linear wave with adaptive mesh refinement following the density peak,
+# so that MeshBlocks are both refined and derefined as the wave moves, once with Morton
+# and once with Hilbert ordering of MeshBlocks.  The ordering only changes the gids of
+# MeshBlocks, so the history data of both runs must agree to roundoff.  A Hilbert run
+# that moved or restricted data into the wrong MeshBlocks on derefinement would not.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_order = ['morton', 'hilbert']
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for ov in _order:
+        arguments = ['job/basename=AMR_' + ov,
+                     'time/tlim=1.0',
+                     'time/cycle_log=true',
+                     'mesh/nx1=128',
+                     'mesh/nx2=64',
+                     'load_balancing/ordering=' + ov,
+                     'output1/dt=-1.0',
+                     'output2/dt=-1.0',
+                     'output3/dt=0.05']
+        athena.run('tests/linear_wave_hydro_amr.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+
+    # check that MeshBlocks were derefined in the Hilbert run
+    ndeleted = 0
+    with open('build/src/AMR_hilbert.cycle.log', 'r') as log_file:
+        for line in log_file:
+            if not line.startswith('#'):
+                ndeleted += int(line.split()[-2])
+    if ndeleted == 0:
+        logger.warning('no MeshBlocks were derefined, test is not meaningful')
+        analyze_status = False
+
+    ref = athena_read.hst('build/src/AMR_morton.hydro.hst')
+    hil = athena_read.hst('build/src/AMR_hilbert.hydro.hst')
+    for key in ref:
+        if len(ref[key]) != len(hil[key]):
+            logger.warning('history files have different lengths')
+            return False
+        err = max(abs(a - b) for a, b in zip(ref[key], hil[key]))
+        scale = max(max(abs(a) for a in ref[key]), 1.0e-10)
+        if err > 1.0e-10*scale:
+            logger.warning('history variable %s differs with Hilbert ordering by %g',
+                           key, err)
+            analyze_status = False
+    return analyze_status
@@ -4,6 +4,10 @@
 # are computed by the executable automatically and stored in the temporary file
 # hydro_lin_wave-errs.dat).  We test both L-/R-going sound waves and
 # the entropy wave; shear waves are not tested in this regression script.
+# Fourth-order fluxes are checked for convergence separately, and configurations
+# with wide stencils are also run with <hydro>/trim_halo=true, which must give
+# the same errors as exchanging all ghost zones.  Reconstruction in characteristic
+# variables is tested with PLM and PPM4.
 
 # Modules
 import logging
@@ -13,10 +17,17 @@ sys.path.insert(0, '../vis/python')
 import athena_read  # noqa
 athena_read.check_nan_flag = True
 logger = logging.getLogger('athena' + __name__[7:])  # set logger name
-_int = ['rk2', 'rk3']
-_recon = ['plm', 'ppmx', 'wenoz']
+_int = ['rk2', 'rk3', 'ssprk104']
+_recon = ['plm', 'ppmx', 'wenoz', 'mp5']
 _flux = ['llf', 'hlle', 'hllc', 'roe']
 _wave = ['L-sound', 'R-sound', 'entropy']
+# configurations run with and without trim_halo
+_trim = {'mp5': ['hydro/reconstruct=mp5'],
+         'wenoz_hybrid': ['hydro/reconstruct=wenoz_hybrid'],
+         'fourth_order': ['hydro/reconstruct=ppm4', 'hydro/fourth_order=true',
+                          'mesh/nghost=4', 'time/integrator=rk4']}
+# reconstruction methods run with <hydro>/characteristic=true
+_char = ['plm', 'ppm4']
 
 
 # Run AthenaK
@@ -56,6 +67,62 @@ def run(**kwargs):
                     args_entr = arguments + ['problem/wave_flag=3',
                                              'problem/vflow=1.0']
                     athena.run('tests/linear_wave_hydro.athinput', args_entr)
+    # L-going sound wave with and without trimmed ghost-zone exchange
+    for tv in _trim:
+        for trim in ('false', 'true'):
+            for res in (16, 32):
+                arguments = ['job/basename=' + _trim_basename(tv, trim),
+                             'time/tlim=1.0',
+                             'time/nlim=1000',
+                             'time/integrator=rk3',
+                             'mesh/nghost=3',
+                             'mesh/nx1=' + repr(res),
+                             'mesh/nx2=' + repr(res/2),
+                             'mesh/nx3=' + repr(res/2),
+                             'meshblock/nx1=' + repr(res/4),
+                             'meshblock/nx2=' + repr(res/4),
+                             'meshblock/nx3=' + repr(res/4),
+                             'hydro/rsolver=hllc',
+                             'hydro/trim_halo=' + trim,
+                             'problem/amp=1.0e-6',
+                             'problem/wave_flag=0',
+                             'problem/vflow=0.0',
+                             'output1/dt=-1.0',
+                             'output2/dt=-1.0',
+                             'output3/dt=-1.0']
+                # later arguments override earlier ones
+                athena.run('tests/linear_wave_hydro.athinput', arguments + _trim[tv])
+    # all waves with reconstruction in characteristic variables
+    for rv in _char:
+        for res in (16, 32):
+            arguments = ['job/basename=hydro_lin_wave_char',
+                         'time/tlim=1.0',
+                         'time/nlim=1000',
+                         'time/integrator=rk3',
+                         'mesh/nghost=3',
+                         'mesh/nx1=' + repr(res),
+                         'mesh/nx2=' + repr(res/2),
+                         'mesh/nx3=' + repr(res/2),
+                         'meshblock/nx1=' + repr(res/4),
+                         'meshblock/nx2=' + repr(res/4),
+                         'meshblock/nx3=' + repr(res/4),
+                         'hydro/reconstruct=' + rv,
+                         'hydro/rsolver=hllc',
+                         'hydro/characteristic=true',
+                         'problem/amp=1.0e-6',
+                         'output1/dt=-1.0',
+                         'output2/dt=-1.0',
+                         'output3/dt=-1.0']
+            athena.run('tests/linear_wave_hydro.athinput',
+                       arguments + ['problem/wave_flag=0', 'problem/vflow=0.0'])
+            athena.run('tests/linear_wave_hydro.athinput',
+                       arguments + ['problem/wave_flag=4', 'problem/vflow=0.0'])
+            athena.run('tests/linear_wave_hydro.athinput',
+                       arguments + ['problem/wave_flag=3', 'problem/vflow=1.0'])
+
+
+def _trim_basename(tv, trim):
+    return 'hydro_lin_wave_' + tv + ('_trim' if trim == 'true' else '')
 
 
 # Analyze outputs
@@ -77,7 +144,7 @@ def analyze():
         for ri, rv in enumerate(_recon):
             error_threshold = [0.0]*len(_wave)
             conv_threshold = [0.0]*len(_wave)
-            if (iv == 'rk3' and (rv == 'ppmx' or rv == 'wenoz')):
+            if (iv in ('rk3', 'ssprk104') and (rv == 'ppmx' or rv == 'wenoz')):
                 error_threshold[0] = error_threshold[1] = 6.0e-9  # sound
                 error_threshold[2] = 4.5e-9  # entropy
                 conv_threshold[0] = conv_threshold[1] = 0.07  # sound
@@ -118,4 +185,37 @@ def analyze():
                                               l1_rms_l, l1_rms_r))
                         analyze_status = False
 
+    # trimming the ghost-zone exchange to the stencil depth must not change results
+    for tv in _trim:
+        full = athena_read.error_dat('build/src/' + _trim_basename(tv, 'false')
+                                     + '-errs.dat')
+        trim = athena_read.error_dat('build/src/' + _trim_basename(tv, 'true')
+                                     + '-errs.dat')
+        for ni in range(2):
+            if full[ni][4] != trim[ni][4]:
+                logger.warning("Errors with and without trim_halo not equal for "
+                               "{0} configuration, {1:g} {2:g}".
+                               format(tv, full[ni][4], trim[ni][4]))
+                analyze_status = False
+        # fourth-order fluxes should converge at (nearly) fourth order
+        if tv == 'fourth_order' and full[1][4]/full[0][4] > 0.15:
+            logger.warning("L-sound wave not converging for fourth_order "
+                           "configuration, conv: {0:g} threshold: {1:g}".
+                           format(full[1][4]/full[0][4], 0.15))
+            analyze_status = False
+
+    # characteristic reconstruction, with the thresholds used for RK2 and PLM above
+    data = athena_read.error_dat('build/src/hydro_lin_wave_char-errs.dat')
+    data = data.reshape([len(_char), 2, len(_wave), data.shape[-1]])
+    for ri, rv in enumerate(_char):
+        for wi, wv in enumerate(_wave):
+            l1_rms_n16 = data[ri][0][wi][4]
+            l1_rms_n32 = data[ri][1][wi][4]
+            if l1_rms_n32 > 2.5e-7 or l1_rms_n32/l1_rms_n16 > 0.3:
+                logger.warning("{0} wave error too large or not converging for "
+                               "characteristic {1} reconstruction, "
+                               "error: {2:g} conv: {3:g}".
+                               format(wv, rv, l1_rms_n32, l1_rms_n32/l1_rms_n16))
+                analyze_status = False
+
     return analyze_status
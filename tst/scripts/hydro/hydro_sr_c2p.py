@@ -0,0 +1,67 @@
+# Regression test for Newton iterations in the SR hydro conserved-to-primitive inversion
+#
+# Runs a relativistic blast wave shock tube (problem 1 of Marti & Muller 2003) once with
+# the default bracketing root finder and once with <hydro>/c2p_strategy=newton.  Both
+# converge to the same tolerance, so the final primitives must agree to that tolerance.
+# Errors in the derivative used by Newton iterations (e.g. from cancellation in the
+# specific internal energy) would show up as a different state or as NaNs.
+
+# Modules
+import glob
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_c2p = ['bracket', 'newton']
+_vars = ['dens', 'velx', 'eint']
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for cv in _c2p:
+        arguments = ['job/basename=SRHyd_' + cv,
+                     'coord/special_rel=true',
+                     'time/integrator=rk3',
+                     'time/cfl_number=0.4',
+                     'time/tlim=0.4',
+                     'mesh/nghost=3',
+                     'mesh/nx1=400',
+                     'meshblock/nx1=100',
+                     'hydro/gamma=1.6666666666666667',
+                     'hydro/reconstruct=ppmx',
+                     'hydro/rsolver=hlle',
+                     'hydro/c2p_strategy=' + cv,
+                     'problem/dl=10.0',
+                     'problem/pl=13.33',
+                     'problem/dr=1.0',
+                     'problem/pr=1.0e-6',
+                     'output1/data_format=%.17e',
+                     'output1/dt=0.4',
+                     'output2/dt=-1.0']
+        athena.run('hydro/sod.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    data = []
+    for cv in _c2p:
+        fname = sorted(glob.glob('build/src/tab/SRHyd_' + cv + '.hydro_w.*.tab'))[-1]
+        data.append(athena_read.tab(fname))
+    analyze_status = True
+    if data[0]['cycle'] != data[1]['cycle']:
+        logger.warning('number of cycles differs with c2p_strategy=newton: %d %d',
+                       data[0]['cycle'], data[1]['cycle'])
+        analyze_status = False
+    for var in _vars:
+        err = (max(abs(a - b) for a, b in zip(data[0][var], data[1][var]))
+               / max(abs(a) for a in data[0][var]))
+        if err > 1.0e-8:
+            logger.warning('variable %s differs with c2p_strategy=newton by %g '
+                           '(relative)', var, err)
+            analyze_status = False
+    return analyze_status
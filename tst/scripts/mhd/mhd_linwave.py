@@ -3,7 +3,8 @@
 # Runs a linear wave convergence test in 3D and checks L1 errors (which
 # are computed by the executable automatically and stored in the temporary file
 # mhd_lin_wave-errs.dat).  We test L-/R- fast, L-/R-Alfven, L-/R- slow waves
-# and the entropy wave.
+# and the entropy wave.  Reconstruction in characteristic variables is tested with
+# PLM and PPM4.
 
 # Modules
 import logging
@@ -13,11 +14,14 @@ sys.path.insert(0, '../vis/python')
 import athena_read  # noqa
 athena_read.check_nan_flag = True
 logger = logging.getLogger('athena' + __name__[7:])  # set logger name
-_int = ['rk2', 'rk3']
+_int = ['rk2', 'rk3', 'ssprk104']
 _recon = ['plm', 'ppmx', 'wenoz']
 _flux = ['llf', 'hlle', 'hlld']
 _wave = ['L-fast', 'R-fast', 'L-Alfven', 'R-Alfven',
          'L-slow', 'R-slow', 'entropy']
+_wave_flag = [0, 6, 1, 5, 2, 4, 3]
+# reconstruction methods run with <mhd>/characteristic=true
+_char = ['plm', 'ppm4']
 
 
 # Run AthenaK
@@ -75,6 +79,34 @@ def run(**kwargs):
                     args_entr = arguments + ['problem/wave_flag=3',
                                              'problem/vflow=1.0']
                     athena.run('tests/linear_wave_mhd.athinput', args_entr)
+    # all waves with reconstruction in characteristic variables
+    for rv in _char:
+        for res in (16, 32):
+            arguments = ['job/basename=mhd_lin_wave_char',
+                         'time/tlim=1.0',
+                         'time/nlim=1000',
+                         'time/integrator=rk3',
+                         'mesh/nghost=3',
+                         'mesh/nx1=' + repr(res),
+                         'mesh/nx2=' + repr(res/2),
+                         'mesh/nx3=' + repr(res/2),
+                         'meshblock/nx1=' + repr(res/4),
+                         'meshblock/nx2=' + repr(res/4),
+                         'meshblock/nx3=' + repr(res/4),
+                         'mhd/reconstruct=' + rv,
+                         'mhd/rsolver=hlld',
+                         'mhd/characteristic=true',
+                         'problem/amp=1.0e-6',
+                         'output1/dt=-1.0',
+                         'output2/dt=-1.0',
+                         'output3/dt=-1.0',
+                         'output4/dt=-1.0',
+                         'output5/dt=-1.0']
+            for wv, flag in zip(_wave, _wave_flag):
+                vflow = '1.0' if wv == 'entropy' else '0.0'
+                athena.run('tests/linear_wave_mhd.athinput',
+                           arguments + ['problem/wave_flag=' + repr(flag),
+                                        'problem/vflow=' + vflow])
 
 
 # Analyze outputs
@@ -98,7 +130,7 @@ def analyze():
         for ri, rv in enumerate(_recon):
             error_threshold = [0.0]*len(_wave)
             conv_threshold = [0.0]*len(_wave)
-            if (iv == 'rk3' and (rv == 'ppmx' or rv == 'wenoz')):
+            if (iv in ('rk3', 'ssprk104') and (rv == 'ppmx' or rv == 'wenoz')):
                 error_threshold[0] = error_threshold[1] = 2.0e-8  # fast
                 error_threshold[2] = error_threshold[3] = 5.0e-8  # Alfven
                 error_threshold[4] = error_threshold[5] = 2.0e-7  # slow
@@ -147,4 +179,21 @@ def analyze():
                                               l1_rms_lf, l1_rms_rf))
                         analyze_status = False
 
+    # characteristic reconstruction, with the thresholds used for RK2 and PLM above
+    error_threshold = [3.0e-7, 3.0e-7, 2.5e-7, 2.5e-7, 5.0e-7, 5.0e-7, 3.5e-7]
+    conv_threshold = [0.29, 0.29, 0.34, 0.34, 0.50, 0.50, 0.38]
+    data = athena_read.error_dat('build/src/mhd_lin_wave_char-errs.dat')
+    data = data.reshape([len(_char), 2, len(_wave), data.shape[-1]])
+    for ri, rv in enumerate(_char):
+        for wi, wv in enumerate(_wave):
+            l1_rms_n16 = data[ri][0][wi][4]
+            l1_rms_n32 = data[ri][1][wi][4]
+            if (l1_rms_n32 > error_threshold[wi] or
+                    l1_rms_n32/l1_rms_n16 > conv_threshold[wi]):
+                logger.warning("{0} wave error too large or not converging for "
+                               "characteristic {1} reconstruction, "
+                               "error: {2:g} conv: {3:g}".
+                               format(wv, rv, l1_rms_n32, l1_rms_n32/l1_rms_n16))
+                analyze_status = False
+
     return analyze_status
@@ -0,0 +1,56 @@
+# Regression test for Newton iterations in the SR MHD conserved-to-primitive inversion
+#
+# Runs the relativistic MHD shock tube of Mignone, Ugliano & Bodo (2009, problem 1) once
+# with the default bracketing root finder and once with <mhd>/c2p_strategy=newton.  Both
+# converge to the same tolerance, so the final primitives must agree to that tolerance.
+# Errors in the derivative used by Newton iterations (e.g. from cancellation in the
+# specific internal energy) would show up as a different state or as NaNs.
+
+# Modules
+import glob
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_c2p = ['bracket', 'newton']
+_vars = ['dens', 'velx', 'eint']
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for cv in _c2p:
+        arguments = ['job/basename=SRMHD_' + cv,
+                     'mesh/nx1=400',
+                     'meshblock/nx1=100',
+                     'mhd/c2p_strategy=' + cv,
+                     'output1/data_format=%.17e',
+                     'output1/dt=0.4',
+                     'output2/dt=-1.0',
+                     'output3/dt=-1.0']
+        athena.run('srmhd/mub1.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    data = []
+    for cv in _c2p:
+        fname = sorted(glob.glob('build/src/tab/SRMHD_' + cv + '.mhd_w.*.tab'))[-1]
+        data.append(athena_read.tab(fname))
+    analyze_status = True
+    if data[0]['cycle'] != data[1]['cycle']:
+        logger.warning('number of cycles differs with c2p_strategy=newton: %d %d',
+                       data[0]['cycle'], data[1]['cycle'])
+        analyze_status = False
+    for var in _vars:
+        err = (max(abs(a - b) for a, b in zip(data[0][var], data[1][var]))
+               / max(abs(a) for a in data[0][var]))
+        if err > 1.0e-8:
+            logger.warning('variable %s differs with c2p_strategy=newton by %g '
+                           '(relative)', var, err)
+            analyze_status = False
+    return analyze_status
@@ -0,0 +1,64 @@
+# Regression test for error-bounded compression of bin outputs
+#
+# Writes the initial state of a 1D hydro linear wave both as a tab file with full
+# double-precision formatting (the reference) and as a compressed bin file, then
+# reads the bin file back with bin_convert.py and checks that every variable is within
+# its compression tolerance of the reference.  The tolerance for eint is chosen so small
+# that its quantization code would need more than 32 bits, which exercises the path
+# that stores such variables unquantized.
+
+# Modules
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+import bin_convert  # noqa
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_tol = {'dens': 1.0e-3, 'velx': 1.0e-6, 'vely': 1.0e-3, 'velz': 1.0e-3,
+        'eint': 1.0e-14}
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=compressed_bin',
+                 'time/nlim=0',
+                 'mesh/nx1=64',
+                 'mesh/nx2=1',
+                 'mesh/nx3=1',
+                 'meshblock/nx1=64',
+                 'meshblock/nx2=1',
+                 'meshblock/nx3=1',
+                 'problem/along_x1=true',
+                 'output1/data_format=%.17e',
+                 'output2/file_type=bin',
+                 'output2/compress=true',
+                 'output2/tolerance=' + repr(_tol['dens']),
+                 'output2/tolerance_velx=' + repr(_tol['velx']),
+                 'output2/tolerance_eint=' + repr(_tol['eint']),
+                 'output3/dt=-1.0']
+    athena.run('tests/linear_wave_hydro.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    ref = athena_read.tab('build/src/tab/compressed_bin.hydro_w.00000.tab')
+    data = bin_convert.read_binary('build/src/bin/compressed_bin.hydro_w.00000.bin')
+    analyze_status = True
+    for var, tol in _tol.items():
+        values = data['mb_data'][var][0][0, 0, :]
+        if len(values) != len(ref[var]):
+            logger.warning('variable %s has %d cells in bin file but %d in tab file',
+                           var, len(values), len(ref[var]))
+            analyze_status = False
+            continue
+        # allow a few ulps of double-precision roundoff on top of the tolerance
+        err = max(abs(c - r) - 8.0*2.2e-16*max(abs(r), 1.0)
+                  for c, r in zip(values, ref[var]))
+        if err > tol:
+            logger.warning('variable %s exceeds compression tolerance %g by %g',
+                           var, tol, err - tol)
+            analyze_status = False
+    return analyze_status
@@ -0,0 +1,62 @@
+# Regression test for delta restart files
+#
+# Runs Sod's shock tube on 16 MeshBlocks with restarts every 0.01 and
+# delta_interval=10, so that the first restart file is full and later ones are delta
+# files containing only MeshBlocks that the shock has reached.  The run is then restarted
+# from the second delta file, and the final state is compared to that of the straight
+# run, which it must reproduce to roundoff.
+
+# Modules
+import glob
+import logging
+import os
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_vars = ['dens', 'velx', 'eint']
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=DeltaRst',
+                 'time/tlim=0.05',
+                 'meshblock/nx1=16',
+                 'output1/data_format=%.17e',
+                 'output1/dt=0.01',
+                 'output2/file_type=rst',
+                 'output2/dt=0.01',
+                 'output2/delta_interval=10']
+    athena.run('hydro/sod.athinput', arguments)
+    athena.restart('rst/DeltaRst.00002.rst', ['job/basename=DeltaRstRestart'])
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    # delta file must be smaller than the full file it references
+    size_full = os.path.getsize('build/src/rst/DeltaRst.00000.rst')
+    size_delta = os.path.getsize('build/src/rst/DeltaRst.00002.rst')
+    if size_delta >= size_full:
+        logger.warning('delta restart file (%d bytes) is not smaller than full restart '
+                       'file (%d bytes)', size_delta, size_full)
+        return False
+    fname_ref = sorted(glob.glob('build/src/tab/DeltaRst.hydro_w.*.tab'))[-1]
+    fname_rst = sorted(glob.glob('build/src/tab/DeltaRstRestart.hydro_w.*.tab'))[-1]
+    if fname_ref.split('.')[-2] != fname_rst.split('.')[-2]:
+        logger.warning('final outputs of straight and restarted runs differ: %s, %s',
+                       fname_ref, fname_rst)
+        return False
+    ref = athena_read.tab(fname_ref)
+    rst = athena_read.tab(fname_rst)
+    analyze_status = True
+    for var in _vars:
+        err = max(abs(a - b) for a, b in zip(ref[var], rst[var]))
+        if err > 1.0e-12:
+            logger.warning('variable %s differs after restart from delta file by %g',
+                           var, err)
+            analyze_status = False
+    return analyze_status
@@ -0,0 +1,65 @@
+# Regression test for reduced restart files
+#
+# Runs a 1D hydro linear wave with white-noise turbulent forcing, writing restart files
+# with precision=single and modules=hydro, so that the forcing is not stored.  The run is
+# then restarted from the second restart file.  Values are converted back to Real when
+# the file is read, and with tcorr=0 the force is regenerated each cycle before it is
+# used, so the final state must agree with that of the straight run to about the
+# precision of a float.
+
+# Modules
+import glob
+import logging
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_vars = ['dens', 'velx', 'vely', 'velz', 'eint']
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    arguments = ['job/basename=ReducedRst',
+                 'time/tlim=0.2',
+                 'mesh/nx1=64',
+                 'mesh/nx2=1',
+                 'mesh/nx3=1',
+                 'meshblock/nx1=16',
+                 'meshblock/nx2=1',
+                 'meshblock/nx3=1',
+                 'problem/along_x1=true',
+                 'turb_driving/tcorr=0.0',
+                 'turb_driving/dedt=0.01',
+                 'output1/data_format=%.17e',
+                 'output1/dt=0.05',
+                 'output2/file_type=rst',
+                 'output2/dt=0.05',
+                 'output2/precision=single',
+                 'output2/modules=hydro',
+                 'output3/dt=-1.0']
+    athena.run('tests/linear_wave_hydro.athinput', arguments)
+    athena.restart('rst/ReducedRst.00001.rst', ['job/basename=ReducedRstRestart'])
+
+
+# Analyze outputs
+def analyze():
+    logger.debug('Analyzing test ' + __name__)
+    fname_ref = sorted(glob.glob('build/src/tab/ReducedRst.hydro_w.*.tab'))[-1]
+    fname_rst = sorted(glob.glob('build/src/tab/ReducedRstRestart.hydro_w.*.tab'))[-1]
+    if fname_ref.split('.')[-2] != fname_rst.split('.')[-2]:
+        logger.warning('final outputs of straight and restarted runs differ: %s, %s',
+                       fname_ref, fname_rst)
+        return False
+    ref = athena_read.tab(fname_ref)
+    rst = athena_read.tab(fname_rst)
+    analyze_status = True
+    for var in _vars:
+        err = max(abs(a - b) for a, b in zip(ref[var], rst[var]))
+        if err > 1.0e-6:
+            logger.warning('variable %s differs after restart from reduced file by %g',
+                           var, err)
+            analyze_status = False
+    return analyze_status
@@ -0,0 +1,80 @@
+# Regression test of the single precision z4c RHS (<z4c>/rhs_fp32_level)
+#
+# Runs the z4c linear wave problem with the RHS computed in Real and in single
+# precision, and compares both the L1 errors of the wave (which are computed by
+# the executable automatically and stored in the temporary files
+# z4c_rhs_*-errs.dat) and the norms of the constraints computed by
+# ADMConstraints() (stored in the history files z4c_rhs_*.hst).
+
+# Modules
+import glob
+import logging
+import numpy as np
+import scripts.utils.athena as athena
+import sys
+sys.path.insert(0, '../vis/python')
+import athena_read  # noqa
+athena_read.check_nan_flag = True
+logger = logging.getLogger('athena' + __name__[7:])  # set logger name
+_prec = {'fp64': '-1', 'fp32': '0'}
+
+
+# Run AthenaK
+def run(**kwargs):
+    logger.debug('Runnning test ' + __name__)
+    for name, level in _prec.items():
+        arguments = ['job/basename=z4c_rhs_' + name,
+                     'time/tlim=1.0',
+                     'time/nlim=-1',
+                     'time/integrator=rk4',
+                     'mesh/nghost=3',
+                     'mesh/nx1=32',
+                     'mesh/nx2=32',
+                     'mesh/nx3=32',
+                     'meshblock/nx1=32',
+                     'meshblock/nx2=32',
+                     'meshblock/nx3=32',
+                     'z4c/diss=1.0',
+                     'z4c/rhs_fp32_level=' + level,
+                     'problem/amp=1.0e-6',
+                     'pgen_name=z4c_linear_wave',
+                     'output1/dt=-1.0',
+                     'output2/dt=-1.0',
+                     'output3/dt=0.1']
+        athena.run('tests/linear_wave_z4c.athinput', arguments)
+
+
+# Analyze outputs
+def analyze():
+    # The errors of the wave and the constraint violations in single precision must
+    # stay close to those in Real, since derivatives are always computed in Real.
+    logger.debug('Analyzing test ' + __name__)
+    analyze_status = True
+
+    err = {}
+    for name in _prec:
+        data = athena_read.error_dat('build/src/z4c_rhs_' + name + '-errs.dat')
+        err[name] = np.atleast_2d(data)[-1][4]
+    error_threshold = 1.1
+    if err['fp32'] > error_threshold*err['fp64']:
+        logger.warning("z4c wave error with fp32 RHS too large, "
+                       "error: {0:g} fp64 error: {1:g}".
+                       format(err['fp32'], err['fp64']))
+        analyze_status = False
+
+    con = {}
+    for name in _prec:
+        fname = glob.glob('build/src/z4c_rhs_' + name + '.z4c*.hst')[0]
+        con[name] = athena_read.hst(fname)['C-norm2']
+    # absolute floor relative to the largest constraint violation in Real, so that
+    # roundoff-level constraint violations are not compared
+    floor = 1.0e-6*np.max(con['fp64'])
+    con_threshold = 2.0
+    ratio = np.max((con['fp32'] + floor)/(con['fp64'] + floor))
+    if ratio > con_threshold:
+        logger.warning("z4c constraint violation with fp32 RHS too large, "
+                       "ratio to fp64: {0:g} threshold: {1:g}".
+                       format(ratio, con_threshold))
+        analyze_status = False
+
+    return analyze_status
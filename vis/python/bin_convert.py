@@ -89,6 +89,176 @@ import h5py
 import os
 
 
+def read_compressed_variables(fp, n_vars, ncells):
+    """
+    Reads and decodes the error-bounded (quantized and bit-packed) data of all
+    variables on one MeshBlock, as written in version 1.2 bin and cbin files
+    with compress=true.  Each variable is stored as [double vmin][double step]
+    [int32 nbits][(nbits*ncells+7)//8 bytes], with the quantized integers q
+    packed least-significant-bit first, so that values are vmin + q*step.
+    Variables that would need more than 32 bits are stored unquantized as
+    doubles, flagged by nbits = 64.
+
+    args:
+      fp - file object, positioned at start of the variable data
+      n_vars - int, number of variables
+      ncells - int, number of cells in each variable on the MeshBlock
+
+    returns:
+      data - array with shape [n_vars, ncells]
+    """
+    data = np.empty((n_vars, ncells), dtype=np.float64)
+    for vari in range(n_vars):
+        vmin, step, nbits = struct.unpack("=ddi", fp.read(20))
+        if nbits == 0:
+            data[vari] = vmin
+            continue
+        if nbits == 64:
+            data[vari] = np.frombuffer(fp.read(8 * ncells), dtype="=f8")
+            continue
+        packed = np.frombuffer(fp.read((nbits * ncells + 7) // 8), dtype=np.uint8)
+        bits = np.unpackbits(packed, bitorder="little")[: nbits * ncells]
+        bits = bits.reshape(ncells, nbits).astype(np.uint64)
+        q = bits @ (np.uint64(1) << np.arange(nbits, dtype=np.uint64))
+        data[vari] = vmin + q.astype(np.float64) * step
+    return data
+
+
+def read_index_trailer(fp):
+    """
+    Reads the trailer at the end of a version 1.3 bin file with an index of
+    MeshBlocks (written with block_index=true), and restores the file position.
+
+    returns:
+      (index_offset, n_mbs, entry_size) - ints
+    """
+    pos = fp.tell()
+    fp.seek(-32, 2)
+    index_offset, n_mbs, entry_size = struct.unpack("=3Q", fp.read(24))
+    if fp.read(8) != b"ATHINDEX":
+        raise TypeError("file has no valid index of MeshBlocks")
+    fp.seek(pos, 0)
+    return index_offset, n_mbs, entry_size
+
+
+def read_binary_index(filename):
+    """
+    Reads the index of MeshBlocks of a bin file written with block_index=true,
+    without reading any MeshBlock data.
+
+    args:
+      filename - string
+          filename of bin file to read
+
+    returns:
+      index - dict
+          'var_names', 'compressed', 'time', 'cycle', and arrays over MeshBlocks
+          'gid', 'level', 'logical' [n_mbs,3], 'geometry' [n_mbs,6] (x1min, x1max,
+          x2min, x2max, x3min, x3max), 'mb_offset' [n_mbs] and 'var_offset'
+          [n_mbs,nvars] (byte offsets in file)
+    """
+    with open(filename, "rb") as fp:
+        code_header = fp.readline().split()
+        if len(code_header) < 1 or code_header[0] != b"Athena":
+            raise TypeError("unknown file format")
+        pheader_count = int(fp.readline().split(b"=")[-1])
+        pheader = {}
+        for _ in range(pheader_count - 1):
+            key, val = [x.strip() for x in fp.readline().decode("utf-8").split("=")]
+            pheader[key] = val
+        if pheader.get("block index", "none") != "footer":
+            raise TypeError(f"{filename} has no index of MeshBlocks")
+        nvars = int(fp.readline().split(b"=")[-1])
+        var_list = [v.decode("utf-8") for v in fp.readline().split()[1:]]
+        locfmt = "f8" if int(pheader["size of location"]) == 8 else "f4"
+
+        index_offset, n_mbs, entry_size = read_index_trailer(fp)
+        entry = np.dtype(
+            [
+                ("ids", "=i4", (6,)),
+                ("geometry", "=" + locfmt, (6,)),
+                ("mb_offset", "=u8"),
+                ("var_offset", "=u8", (nvars,)),
+            ]
+        )
+        if entry.itemsize != entry_size:
+            raise TypeError("size of index entries does not match variables")
+        fp.seek(index_offset, 0)
+        table = np.frombuffer(fp.read(n_mbs * entry_size), dtype=entry)
+
+    index = {}
+    index["var_names"] = var_list
+    index["compressed"] = pheader.get("compression", "none") == "quantized"
+    index["size of variable"] = int(pheader["size of variable"])
+    index["time"] = float(pheader["time"])
+    index["cycle"] = int(pheader["cycle"])
+    index["gid"] = table["ids"][:, 0].copy()
+    index["level"] = table["ids"][:, 1].copy()
+    index["logical"] = table["ids"][:, 2:5].copy()
+    index["geometry"] = table["geometry"].copy()
+    index["mb_offset"] = table["mb_offset"].copy()
+    index["var_offset"] = table["var_offset"].copy()
+    return index
+
+
+def read_binary_blocks(filename, variables=None, bounds=None):
+    """
+    Reads only the requested variables on MeshBlocks that overlap a region, from a
+    bin file written with block_index=true.  Uncompressed data is memory mapped, so
+    only the pages holding the requested data are read from disk.
+
+    args:
+      filename - string
+          filename of bin file to read
+      variables - list of strings, or None for all variables
+      bounds - ((x1min, x1max), (x2min, x2max), (x3min, x3max)), or None for all
+          MeshBlocks
+
+    returns:
+      blocks - dict
+          'index' (as returned by read_binary_index), 'mbs' (indices of selected
+          MeshBlocks in index), 'mb_index' [n,6] (ois, oie, ojs, oje, oks, oke) and
+          'mb_data' = {'var': list of arrays with shape [nx3_out, nx2_out, nx1_out]}
+    """
+    index = read_binary_index(filename)
+    var_list = index["var_names"]
+    if variables is None:
+        variables = var_list
+    geom = index["geometry"]
+    select = np.ones(len(geom), dtype=bool)
+    if bounds is not None:
+        for d, (lo, hi) in enumerate(bounds):
+            select &= (geom[:, 2 * d + 1] >= lo) & (geom[:, 2 * d] <= hi)
+    mbs = np.nonzero(select)[0]
+
+    varfmt = "=f8" if index["size of variable"] == 8 else "=f4"
+    mm = np.memmap(filename, dtype=np.uint8, mode="r")
+    mb_index = []
+    mb_data = {var: [] for var in variables}
+    with open(filename, "rb") as fp:
+        for m in mbs:
+            off = int(index["mb_offset"][m])
+            idx = np.frombuffer(mm, dtype="=i4", count=6, offset=off).copy()
+            mb_index.append(idx)
+            shape = (idx[5] - idx[4] + 1, idx[3] - idx[2] + 1, idx[1] - idx[0] + 1)
+            ncells = shape[0] * shape[1] * shape[2]
+            for var in variables:
+                voff = int(index["var_offset"][m, var_list.index(var)])
+                if index["compressed"]:
+                    fp.seek(voff, 0)
+                    data = read_compressed_variables(fp, 1, ncells)[0]
+                else:
+                    data = np.frombuffer(mm, dtype=varfmt, count=ncells, offset=voff)
+                mb_data[var].append(np.array(data).reshape(shape))
+
+    blocks = {}
+    blocks["index"] = index
+    blocks["mbs"] = mbs
+    blocks["mb_index"] = np.array(mb_index)
+    blocks["mb_data"] = mb_data
+    return blocks
+
+
 def read_binary(filename):
     """
     Reads a bin file from filename to dictionary.
@@ -123,7 +293,7 @@ def read_binary(filename):
             + '(should be "Athena")'
         )
     version = code_header[-1].split(b"=")[-1]
-    if version != b"1.1":
+    if version not in [b"1.1", b"1.2", b"1.3"]:
         raise TypeError(f"unsupported file format version {version.decode('utf-8')}")
 
     pheader_count = int(fp.readline().split(b"=")[-1])
@@ -135,6 +305,10 @@ def read_binary(filename):
     cycle = int(pheader["cycle"])
     locsizebytes = int(pheader["size of location"])
     varsizebytes = int(pheader["size of variable"])
+    compressed = pheader.get("compression", "none") == "quantized"
+    # MeshBlock data ends at the index of MeshBlocks (if any)
+    if pheader.get("block index", "none") == "footer":
+        filesize = read_index_trailer(fp)[0]
 
     nvars = int(fp.readline().split(b"=")[-1])
     var_list = [v.decode("utf-8") for v in fp.readline().split()[1:]]
@@ -210,12 +384,15 @@ def read_binary(filename):
             np.array(struct.unpack("=6" + locfmt, fp.read(6 * locsizebytes)))
         )
 
-        data = np.array(
-            struct.unpack(
-                f"={nx1_out*nx2_out*nx3_out*n_vars}" + varfmt,
-                fp.read(varsizebytes * nx1_out * nx2_out * nx3_out * n_vars),
+        if compressed:
+            data = read_compressed_variables(fp, n_vars, nx1_out * nx2_out * nx3_out)
+        else:
+            data = np.array(
+                struct.unpack(
+                    f"={nx1_out*nx2_out*nx3_out*n_vars}" + varfmt,
+                    fp.read(varsizebytes * nx1_out * nx2_out * nx3_out * n_vars),
+                )
             )
-        )
         data = data.reshape(nvars, nx3_out, nx2_out, nx1_out)
         for vari, var in enumerate(var_list):
             mb_data[var].append(data[vari])
@@ -290,7 +467,7 @@ def read_coarsened_binary(filename):
             + '(should be "Athena")'
         )
     version = code_header[-1].split(b"=")[-1]
-    if version != b"1.1":
+    if version not in [b"1.1", b"1.2"]:
         raise TypeError(f"unsupported file format version {version.decode('utf-8')}")
 
     pheader_count = int(fp.readline().split(b"=")[-1])
@@ -302,6 +479,7 @@ def read_coarsened_binary(filename):
     cycle = int(pheader["cycle"])
     locsizebytes = int(pheader["size of location"])
     varsizebytes = int(pheader["size of variable"])
+    compressed = pheader.get("compression", "none") == "quantized"
     coarsen_factor = int(pheader["coarsening factor"])
 
     nvars = int(fp.readline().split(b"=")[-1])
@@ -378,12 +556,15 @@ def read_coarsened_binary(filename):
             np.array(struct.unpack("=6" + locfmt, fp.read(6 * locsizebytes)))
         )
 
-        data = np.array(
-            struct.unpack(
-                f"={nx1_out*nx2_out*nx3_out*n_vars}" + varfmt,
-                fp.read(varsizebytes * nx1_out * nx2_out * nx3_out * n_vars),
+        if compressed:
+            data = read_compressed_variables(fp, n_vars, nx1_out * nx2_out * nx3_out)
+        else:
+            data = np.array(
+                struct.unpack(
+                    f"={nx1_out*nx2_out*nx3_out*n_vars}" + varfmt,
+                    fp.read(varsizebytes * nx1_out * nx2_out * nx3_out * n_vars),
+                )
             )
-        )
         data = data.reshape(nvars, nx3_out, nx2_out, nx1_out)
         for vari, var in enumerate(var_list):
             mb_data[var].append(data[vari])